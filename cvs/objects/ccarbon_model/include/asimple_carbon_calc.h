@@ -45,6 +45,7 @@
  * \author James Blackwood
  */
 #include <xercesc/dom/DOMNode.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/flyweight.hpp>
 #include <boost/flyweight/key_value.hpp>
 #include <boost/flyweight/no_tracking.hpp>
@@ -117,13 +118,14 @@ protected:
     DEFINE_DATA_WITH_PARENT(
         ICarbonCalc,
         
-        //! Total emissions by year.
+        //! Total emissions by year from the model start year, earlier years
+        //! are kept in mHistoricEmissions.
         DEFINE_VARIABLE( ARRAY, "land-use-change-emissions", mTotalEmissions, objects::YearVector<double> ),
         
-        //! Above ground total emissions by year
+        //! Above ground total emissions by year from the model start year
         DEFINE_VARIABLE( ARRAY, "above-ground-land-use-change-emissions", mTotalEmissionsAbove, objects::YearVector<double> ),
         
-        //! Below ground total emissions by year
+        //! Below ground total emissions by year from the model start year
         DEFINE_VARIABLE( ARRAY, "below-ground-land-use-change-emissions", mTotalEmissionsBelow, objects::YearVector<double> ),
         
         //! Above ground carbon stock
@@ -165,6 +167,9 @@ protected:
         precalc_sigmoid_helper( const int aMatureAge );
         std::vector<double> mData;
         
+        //! The above ground carbon subsidy discount factor for this mature age.
+        double mSubsidyDiscountFactor;
+        
         const double& operator[]( const size_t aPos ) const {
             return mData[ aPos ];
         }
@@ -178,6 +183,74 @@ protected:
     //! expensive operations during calc.
     precalc_sigmoid_type precalc_sigmoid_diff;
     
+    // Similar boiler plate to share the precalc soil carbon curve between
+    // instances that have the same soil time scale
+    struct precalc_soil_helper {
+        precalc_soil_helper( const int aSoilTimeScale );
+        std::vector<double> mData;
+        
+        //! The exponential decay rate implied by this soil time scale.
+        double mDecayRate;
+        
+        const double& operator[]( const size_t aPos ) const {
+            return mData[ aPos ];
+        }
+    };
+    using precalc_soil_type = boost::flyweights::flyweight<
+        boost::flyweights::key_value<int, precalc_soil_helper>,
+        boost::flyweights::no_tracking>;
+    
+    //! The cumulative fraction of a change in soil carbon which has occurred by
+    //! year offset.  This value gets precomputed when the soil time scale is set
+    //! to avoid doing the exp during calc.
+    precalc_soil_type precalc_soil_cum;
+    
+    // Boiler plate to share the emissions in the years before the model start
+    // year, which are fixed once the land use history has been calculated,
+    // between instances that have identical histories.  Leading years with no
+    // emissions are not stored so that leaves without any historical land
+    // change all share a single empty instance.
+    struct historic_emiss_helper {
+        historic_emiss_helper();
+        historic_emiss_helper( const objects::YearVector<double>& aAbove,
+                               const objects::YearVector<double>& aBelow,
+                               const int aLastYear );
+        
+        //! The first year stored, all earlier years have zero emissions.
+        int mFirstYear;
+        
+        //! Above ground emissions by year starting from mFirstYear.
+        std::vector<double> mAbove;
+        
+        //! Below ground emissions by year starting from mFirstYear.
+        std::vector<double> mBelow;
+        
+        double getAbove( const int aYear ) const {
+            return aYear >= mFirstYear ? mAbove[ aYear - mFirstYear ] : 0.0;
+        }
+        
+        double getBelow( const int aYear ) const {
+            return aYear >= mFirstYear ? mBelow[ aYear - mFirstYear ] : 0.0;
+        }
+        
+        bool operator==( const historic_emiss_helper& aOther ) const {
+            return mFirstYear == aOther.mFirstYear && mAbove == aOther.mAbove && mBelow == aOther.mBelow;
+        }
+        
+        friend std::size_t hash_value( const historic_emiss_helper& aHelper ) {
+            std::size_t seed = boost::hash_range( aHelper.mAbove.begin(), aHelper.mAbove.end() );
+            boost::hash_combine( seed, aHelper.mFirstYear );
+            boost::hash_range( seed, aHelper.mBelow.begin(), aHelper.mBelow.end() );
+            return seed;
+        }
+    };
+    using historic_emiss_type = boost::flyweights::flyweight<
+        historic_emiss_helper,
+        boost::flyweights::no_tracking>;
+    
+    //! The emissions in the years before the model start year.
+    historic_emiss_type mHistoricEmissions;
+    
     //! Flag to ensure historical emissions are only calculated a single time
     //! since they can not be reset.
     bool mHasCalculatedHistoricEmiss;
@@ -194,7 +267,13 @@ protected:
                                         const int aYear,
                                         const int aEndYear,
                                         objects::YearVector<double>& aEmissVector);
+
+    void setHistoricEmissions( const objects::YearVector<double>& aAbove,
+                               const objects::YearVector<double>& aBelow,
+                               const objects::YearVector<double>& aTotal );
 private:
+    static double calcAboveGroundCarbonSubsidyDiscountFactor( const int aMatureAge );
+    
     void calcSigmoidCurve( const double aCarbonDiff,
                            const int aYear,
                            const int aEndYear,
@@ -56,9 +56,9 @@ using namespace objects;
 extern Scenario* scenario;
 
 ASimpleCarbonCalc::ASimpleCarbonCalc():
-mTotalEmissions( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
-mTotalEmissionsAbove( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
-mTotalEmissionsBelow( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
+mTotalEmissions( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() ),
+mTotalEmissionsAbove( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() ),
+mTotalEmissionsBelow( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() ),
 mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() )
 {
     int endYear = CarbonModelUtils::getEndYear();
@@ -66,7 +66,7 @@ mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEnd
     
     mLandUseHistory = 0;
     mLandLeaf = 0;
-    mSoilTimeScale = CarbonModelUtils::getSoilTimeScale();
+    setSoilTimeScale( CarbonModelUtils::getSoilTimeScale() );
     mHasCalculatedHistoricEmiss = false;
 }
 
@@ -102,18 +102,26 @@ double ASimpleCarbonCalc::calc( const int aPeriod, const int aEndYear, const Car
             const double aboveGroundCarbonDensity = mLandUseHistory->getHistoricAboveGroundCarbonDensity();
             const double belowGroundCarbonDensity = mLandUseHistory->getHistoricBelowGroundCarbonDensity();
             
+            // The historical emissions are calculated over the full carbon model
+            // time horizon and then split into the shared historical store and
+            // the dense vectors which are updated in future model periods.
+            YearVector<double> histEmissionsAbove( CarbonModelUtils::getStartYear(), aEndYear, 0.0 );
+            YearVector<double> histEmissionsBelow( CarbonModelUtils::getStartYear(), aEndYear, 0.0 );
+            YearVector<double> histEmissions( CarbonModelUtils::getStartYear(), aEndYear, 0.0 );
+            
             double currCarbonStock = aboveGroundCarbonDensity * mLandUseHistory->getAllocation( CarbonModelUtils::getStartYear() );
             
             double prevLand = mLandUseHistory->getAllocation( CarbonModelUtils::getStartYear() - 1 );
             for( int year = CarbonModelUtils::getStartYear(); year <= mLandUseHistory->getMaxYear(); ++year ) {
                 double currLand = mLandUseHistory->getAllocation( year );
                 double landDifference = prevLand - currLand;
-                calcAboveGroundCarbonEmission( currCarbonStock, prevLand, currLand, aboveGroundCarbonDensity, year, aEndYear, mTotalEmissionsAbove );
-                calcBelowGroundCarbonEmission( landDifference * belowGroundCarbonDensity, year, aEndYear, mTotalEmissionsBelow );
+                calcAboveGroundCarbonEmission( currCarbonStock, prevLand, currLand, aboveGroundCarbonDensity, year, aEndYear, histEmissionsAbove );
+                calcBelowGroundCarbonEmission( landDifference * belowGroundCarbonDensity, year, aEndYear, histEmissionsBelow );
                 prevLand = currLand;
-                currCarbonStock -= mTotalEmissionsAbove[ year ];
-                mTotalEmissions[year] = mTotalEmissionsAbove[year] + mTotalEmissionsBelow[year];
+                currCarbonStock -= histEmissionsAbove[ year ];
+                histEmissions[year] = histEmissionsAbove[year] + histEmissionsBelow[year];
             }
+            setHistoricEmissions( histEmissionsAbove, histEmissionsBelow, histEmissions );
             mHasCalculatedHistoricEmiss = true;
             mCarbonStock[ modeltime->getStartYear() ] = currCarbonStock;
         }
@@ -276,17 +284,21 @@ void ASimpleCarbonCalc::calcBelowGroundCarbonEmission( const double aCarbonDiff,
     // Note also that the aCarbonDiff is passed here as previous carbon minus current carbon
     // so a positive difference means that emissions will occur and a negative means uptake.
     
-    const double halfLife = mSoilTimeScale / 10.0;
-    const double log2 = log( 2.0 );
-    const double lambda = log2 / halfLife;
-    int yearCounter = 0;
-    double cumStockDiff_t1, cumStockDiff_t2;
-    cumStockDiff_t1 = 0.0;
-    for( int currYear = aYear; currYear <= aEndYear; ++currYear ) {
-        yearCounter += 1;
-        cumStockDiff_t2 = aCarbonDiff * ( 1.0 - exp( -1.0 * lambda * yearCounter ) );
-        aEmissVector[ currYear ] += cumStockDiff_t2 - cumStockDiff_t1;
-        cumStockDiff_t1 = cumStockDiff_t2;
+    // The cumulative fraction by year offset is precomputed in precalc_soil_cum.
+    // Note the fraction at offset zero is zero so that each year can be computed
+    // independently of the previous one.
+    assert( precalc_soil_cum.get_key() == mSoilTimeScale );
+    if( aEndYear < aYear ) {
+        return;
+    }
+    // Work directly on the contiguous storage to avoid the virtual
+    // YearVector::operator[] each year so that the loop can be vectorized.
+    const double* cumFraction = &precalc_soil_cum.get().mData[ 0 ];
+    double* emiss = &aEmissVector[ aYear ];
+    const int numYears = aEndYear - aYear + 1;
+    for( int yearCounter = 0; yearCounter < numYears; ++yearCounter ) {
+        emiss[ yearCounter ] += aCarbonDiff * cumFraction[ yearCounter + 1 ]
+            - aCarbonDiff * cumFraction[ yearCounter ];
     }
 }
 
@@ -309,23 +321,41 @@ void ASimpleCarbonCalc::calcSigmoidCurve( const double aCarbonDiff,
      *      year.
      */
     assert( getMatureAge() > 1 );
+    if( aEndYear < aYear ) {
+        return;
+    }
     
-    for( int currYear = aYear; currYear <= aEndYear; ++currYear ){
-        // To avoid expensive calculations the difference in the sigmoid curve
-        // has already been precomputed.
-        aEmissVector[ currYear ] += precalc_sigmoid_diff.get()[ currYear - aYear ] * aCarbonDiff;
+    // To avoid expensive calculations the difference in the sigmoid curve
+    // has already been precomputed.  Work directly on the contiguous storage
+    // to avoid the virtual YearVector::operator[] each year so that the loop
+    // can be vectorized.
+    const double* sigmoidDiff = &precalc_sigmoid_diff.get().mData[ 0 ];
+    double* emiss = &aEmissVector[ aYear ];
+    const int numYears = aEndYear - aYear + 1;
+    for( int yearOffset = 0; yearOffset < numYears; ++yearOffset ) {
+        emiss[ yearOffset ] += sigmoidDiff[ yearOffset ] * aCarbonDiff;
     }
 }
 
 double ASimpleCarbonCalc::getNetLandUseChangeEmission( const int aYear ) const {
+    if( aYear < static_cast<int>( mTotalEmissions.getStartYear() ) ) {
+        const historic_emiss_helper& historicEmiss = mHistoricEmissions.get();
+        return historicEmiss.getAbove( aYear ) + historicEmiss.getBelow( aYear );
+    }
     return mTotalEmissions[ aYear ];
 }
 
 double ASimpleCarbonCalc::getNetLandUseChangeEmissionAbove( const int aYear ) const {
+    if( aYear < static_cast<int>( mTotalEmissionsAbove.getStartYear() ) ) {
+        return mHistoricEmissions.get().getAbove( aYear );
+    }
     return mTotalEmissionsAbove[ aYear ];
 }
 
 double ASimpleCarbonCalc::getNetLandUseChangeEmissionBelow( const int aYear ) const {
+    if( aYear < static_cast<int>( mTotalEmissionsBelow.getStartYear() ) ) {
+        return mHistoricEmissions.get().getBelow( aYear );
+    }
     return mTotalEmissionsBelow[ aYear ];
 }
 
@@ -357,9 +387,9 @@ double ASimpleCarbonCalc::getBelowGroundCarbonSubsidyDiscountFactor( ){
     }
 
     // Exponential soil carbon with a fixed discount rate set here/
-    const double halfLife = mSoilTimeScale / 10.0;
-    const double log2 = log( 2.0 );
-    const double lambda = log2 / halfLife;
+    // The decay rate only depends on the soil time scale so has been precomputed.
+    assert( precalc_soil_cum.get_key() == mSoilTimeScale );
+    const double lambda = precalc_soil_cum.get().mDecayRate;
     return 1.0 - mPrivateDiscountRate / ( mPrivateDiscountRate + lambda );
         
 }
@@ -378,6 +408,20 @@ double ASimpleCarbonCalc::getAboveGroundCarbonSubsidyDiscountFactor( ){
     if ( getMatureAge() == 1 ) {
         return 1.0;
     }
+    // The factor only depends on the mature age so has been precomputed
+    // along with the sigmoid curve.
+    assert( precalc_sigmoid_diff.get_key() == getMatureAge() );
+    return precalc_sigmoid_diff.get().mSubsidyDiscountFactor;
+}
+
+/*!
+* \brief Computes the above ground carbon subsidy discount factor for a mature age.
+* \details See getAboveGroundCarbonSubsidyDiscountFactor.  This is only called when
+*          precomputing the sigmoid curve for a mature age greater than one.
+* \param aMatureAge The mature age.
+* \return above ground carbon subsidy discount factor
+*/
+double ASimpleCarbonCalc::calcAboveGroundCarbonSubsidyDiscountFactor( const int aMatureAge ) {
     // We are approximating this curve as a polynomial with an offset of
     // 250 (If the mature age is 250, all carbon uptake occurs far enough
     // in the future that you wouldn't base decisions on it. So, for a
@@ -390,11 +434,87 @@ double ASimpleCarbonCalc::getAboveGroundCarbonSubsidyDiscountFactor( ){
     // the read in social discount rate used elsewhere in the land model.
     const double COEF = -8.57e-13;
     const int MAXMATUREAGE = 250; // Mature age where carbon subsidy is zero
-    return COEF * pow( double( getMatureAge() - MAXMATUREAGE ), 5);
+    return COEF * pow( double( aMatureAge - MAXMATUREAGE ), 5);
 }
 
 void ASimpleCarbonCalc::setSoilTimeScale( const int aTimeScale ) {
     mSoilTimeScale = aTimeScale;
+    // Precompute the soil carbon curve to avoid doing it during calc.
+    precalc_soil_cum = precalc_soil_type( mSoilTimeScale );
+}
+
+/*!
+ * \brief The boost fly weight will only actually construct one helper for each unique
+ *        soil time scale.  Any other time will just get the shared instance.
+ * \details The entry at year offset k is the fraction of a change in soil carbon
+ *          which has occurred k years after the change.  Offset zero is never
+ *          used by calcBelowGroundCarbonEmission and is left at zero.
+ */
+ASimpleCarbonCalc::precalc_soil_helper::precalc_soil_helper( const int aSoilTimeScale ):
+mData( CarbonModelUtils::getEndYear() - CarbonModelUtils::getStartYear() + 2, 0.0 )
+{
+    const double halfLife = aSoilTimeScale / 10.0;
+    const double log2 = log( 2.0 );
+    mDecayRate = log2 / halfLife;
+    for( size_t yearCounter = 1; yearCounter < mData.size(); ++yearCounter ) {
+        mData[ yearCounter ] = 1.0 - exp( -1.0 * mDecayRate * yearCounter );
+    }
+}
+
+/*!
+ * \brief Store the emissions calculated from the land use history.
+ * \details The years before the model start year will not change again and are
+ *          kept in the shared historical store.  The remaining years are copied
+ *          into the dense vectors which future model periods add to.
+ * \param aAbove The above ground emissions calculated from the land use history.
+ * \param aBelow The below ground emissions calculated from the land use history.
+ * \param aTotal The total emissions calculated from the land use history.
+ */
+void ASimpleCarbonCalc::setHistoricEmissions( const YearVector<double>& aAbove,
+                                              const YearVector<double>& aBelow,
+                                              const YearVector<double>& aTotal )
+{
+    const int denseStartYear = mTotalEmissions.getStartYear();
+    mHistoricEmissions = historic_emiss_type( historic_emiss_helper( aAbove, aBelow, denseStartYear - 1 ) );
+    const int startYear = max( denseStartYear, static_cast<int>( aTotal.getStartYear() ) );
+    const int endYear = min( mTotalEmissions.getEndYear(), aTotal.getEndYear() );
+    for( int year = startYear; year <= endYear; ++year ) {
+        mTotalEmissionsAbove[ year ] = aAbove[ year ];
+        mTotalEmissionsBelow[ year ] = aBelow[ year ];
+        mTotalEmissions[ year ] = aTotal[ year ];
+    }
+}
+
+//! Constructor for an empty history, all years have zero emissions.
+ASimpleCarbonCalc::historic_emiss_helper::historic_emiss_helper():
+mFirstYear( 0 )
+{
+}
+
+/*!
+ * \brief Constructor which copies the historical years of the given emissions.
+ * \param aAbove The above ground emissions.
+ * \param aBelow The below ground emissions.
+ * \param aLastYear The last historical year to store.
+ */
+ASimpleCarbonCalc::historic_emiss_helper::historic_emiss_helper( const YearVector<double>& aAbove,
+                                                                 const YearVector<double>& aBelow,
+                                                                 const int aLastYear ):
+mFirstYear( 0 )
+{
+    int firstYear = aAbove.getStartYear();
+    while( firstYear <= aLastYear && aAbove[ firstYear ] == 0.0 && aBelow[ firstYear ] == 0.0 ) {
+        ++firstYear;
+    }
+    if( firstYear <= aLastYear ) {
+        mFirstYear = firstYear;
+        mAbove.reserve( aLastYear - firstYear + 1 );
+        mBelow.reserve( aLastYear - firstYear + 1 );
+        for( int year = firstYear; year <= aLastYear; ++year ) {
+            mAbove.push_back( aAbove[ year ] );
+            mBelow.push_back( aBelow[ year ] );
+        }
+    }
 }
 
 double ASimpleCarbonCalc::getAboveGroundCarbonStock( const int aYear ) const {
@@ -116,9 +116,10 @@ double CarbonModelUtils::getLandUse( const unsigned int aYear,
  * \return The start year.
  */
 int CarbonModelUtils::getStartYear(){
-    const static int START_YEAR = scenario->getModeltime()->getCarbonModelStartYear() != -1
-        ? scenario->getModeltime()->getCarbonModelStartYear() : scenario->getModeltime()->getStartYear();
-    return START_YEAR;
+    // Not cached in a static since it belongs to the current scenario.
+    const Modeltime* modeltime = scenario->getModeltime();
+    return modeltime->getCarbonModelStartYear() != -1
+        ? modeltime->getCarbonModelStartYear() : modeltime->getStartYear();
 }
 
 /*!
@@ -127,8 +128,7 @@ int CarbonModelUtils::getStartYear(){
  * \return The last year of the climate calculation.
  */
 int CarbonModelUtils::getEndYear(){
-    const static int END_YEAR = scenario->getModeltime()->getEndYear();
-    return END_YEAR;
+    return scenario->getModeltime()->getEndYear();
 }
 
 /*
@@ -178,7 +178,8 @@ void LandCarbonDensities::setMatureAge( const int aMatureAge )
  *        mature age.  Any other time will just get the shared instance.
  */
 ASimpleCarbonCalc::precalc_sigmoid_helper::precalc_sigmoid_helper( const int aMatureAge ):
-mData( CarbonModelUtils::getEndYear() - CarbonModelUtils::getStartYear() + 1 )
+mData( CarbonModelUtils::getEndYear() - CarbonModelUtils::getStartYear() + 1 ),
+mSubsidyDiscountFactor( ASimpleCarbonCalc::calcAboveGroundCarbonSubsidyDiscountFactor( aMatureAge ) )
 {
     double prevSigmoid = pow( 1 - exp( ( -3.0 * 0 ) / aMatureAge ), 2.0 );
     for ( int i = CarbonModelUtils::getStartYear(); i <= CarbonModelUtils::getEndYear(); ++i ){
@@ -189,6 +189,17 @@ void NodeCarbonCalc::calcLandUseHistory()
         prevLandTotal += land;
         carbonStock[ i ] = land * aboveGroundCarbonDensity[ i ];
     }
+    // The historical emissions are calculated over the full carbon model time horizon
+    // and then handed to each carbon calc to split into the shared historical store
+    // and the dense vectors which are updated in future model periods.
+    vector<YearVector<double>*> histEmissionsAbove( mCarbonCalcs.size() );
+    vector<YearVector<double>*> histEmissionsBelow( mCarbonCalcs.size() );
+    vector<YearVector<double>*> histEmissions( mCarbonCalcs.size() );
+    for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
+        histEmissionsAbove[ i ] = new YearVector<double>( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear(), 0.0 );
+        histEmissionsBelow[ i ] = new YearVector<double>( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear(), 0.0 );
+        histEmissions[ i ] = new YearVector<double>( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear(), 0.0 );
+    }
     // Calculated emissions over the entire historical period.
     for( int year = CarbonModelUtils::getStartYear(); year <= mCarbonCalcs[ 0 ]->mLandUseHistory->getMaxYear(); ++year ) {
         // compute changes in land area
@@ -215,12 +226,12 @@ void NodeCarbonCalc::calcLandUseHistory()
                 assert( diffLand[ i ] == 0 || diffLandTotal == 0 );
                 mCarbonCalcs[ i ]->calcAboveGroundCarbonEmission( carbonStock[ i ], prevLand[ i ], prevLand[ i ] + newDiff,
                                                                   aboveGroundCarbonDensity[ i ], year,
-                                                                  CarbonModelUtils::getEndYear(), mCarbonCalcs[ i ]->mTotalEmissionsAbove );
+                                                                  CarbonModelUtils::getEndYear(), *histEmissionsAbove[ i ] );
                 mCarbonCalcs[ i ]->calcBelowGroundCarbonEmission( -1 * newDiff * belowGroundCarbonDensity[ i ], year,
-                                                                  CarbonModelUtils::getEndYear(), mCarbonCalcs[ i ]->mTotalEmissionsBelow );
+                                                                  CarbonModelUtils::getEndYear(), *histEmissionsBelow[ i ] );
             }
             // Adjust carbon stock for any emissions that occurred from this change.
-            carbonStock[ i ] -= mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ];
+            carbonStock[ i ] -= (*histEmissionsAbove[ i ])[ year ];
         }
         // The difference in total land area change should have all been allocated
         // across the various land types.
@@ -261,7 +272,7 @@ void NodeCarbonCalc::calcLandUseHistory()
         // options that increased in land.
         for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
             if( diffLand[ i ] > 0 ) {
-                double emissBeforeMove = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ];
+                double emissBeforeMove = (*histEmissionsAbove[ i ])[ year ];
                 // Calculate the difference in carbon densities which would drive any
                 // emissions or uptake.
                 double fractionOfGain = diffLand[ i ] / totalLandGain;
@@ -269,14 +280,14 @@ void NodeCarbonCalc::calcLandUseHistory()
                 double carbonDiffAboveDensity = -1 * ( currCarbonMove / diffLand[ i ] - aboveGroundCarbonDensity[ i ] );
                 double carbonDiffBelow = -1 * ( diffLand[ i ] * belowGroundCarbonDensity[ i ] - fractionOfGain * carbonPrevBelow );
                 mCarbonCalcs[ i ]->calcAboveGroundCarbonEmission( 0, 0, diffLand[ i ], carbonDiffAboveDensity, year,
-                                                                  CarbonModelUtils::getEndYear(), mCarbonCalcs[ i ]->mTotalEmissionsAbove );
+                                                                  CarbonModelUtils::getEndYear(), *histEmissionsAbove[ i ] );
                 mCarbonCalcs[ i ]->calcBelowGroundCarbonEmission( carbonDiffBelow, year, CarbonModelUtils::getEndYear(),
-                                                                  mCarbonCalcs[ i ]->mTotalEmissionsBelow );
+                                                                  *histEmissionsBelow[ i ] );
                 // Adjust carbon stock to include the carbon being moved in minus any emissions because of moving
                 // the carbon.
-                carbonStock[ i ] += currCarbonMove - ( mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] - emissBeforeMove );
+                carbonStock[ i ] += currCarbonMove - ( (*histEmissionsAbove[ i ])[ year ] - emissBeforeMove );
             }
-            mCarbonCalcs[ i ]->mTotalEmissions[ year ] = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] + mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ];
+            (*histEmissions[ i ])[ year ] = (*histEmissionsAbove[ i ])[ year ] + (*histEmissionsBelow[ i ])[ year ];
         }
         
         prevLand = currLand;
@@ -286,6 +297,10 @@ void NodeCarbonCalc::calcLandUseHistory()
     // Make sure future year calculations start from the correct historical carbon stock.
     for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
         mCarbonCalcs[ i ]->mCarbonStock[ mCarbonCalcs[ i ]->mLandUseHistory->getMaxYear() ] = carbonStock[ i ];
+        mCarbonCalcs[ i ]->setHistoricEmissions( *histEmissionsAbove[ i ], *histEmissionsBelow[ i ], *histEmissions[ i ] );
+        delete histEmissionsAbove[ i ];
+        delete histEmissionsBelow[ i ];
+        delete histEmissions[ i ];
     }
 
     mHasCalculatedHistoricEmiss = true;
@@ -304,18 +319,8 @@ void NodeCarbonCalc::calc( const int aPeriod, const int aEndYear, const ICarbonC
         const int modelYear = modeltime->getper_to_yr( aPeriod );
         const int modelTimestep = modeltime->gettimestep( aPeriod );
         const int prevModelYear = modelYear - modelTimestep;
-        int year = prevModelYear + 1;
-
-        // clear the previously calculated emissions first
-        vector<YearVector<double>*> currEmissionsAbove( mCarbonCalcs.size() );
-        vector<YearVector<double>*> currEmissionsBelow( mCarbonCalcs.size() );
-        for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
-            currEmissionsAbove[ i ] = new YearVector<double>( year, aEndYear, 0.0 );
-            currEmissionsBelow[ i ] = new YearVector<double>( year, aEndYear, 0.0 );
-        }
-        
         // stash carbon densities for quick access
-        year = prevModelYear;
+        int year = prevModelYear;
         vector<double> aboveGroundCarbonDensity( mCarbonCalcs.size() );
         vector<double> belowGroundCarbonDensity( mCarbonCalcs.size() );
         for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
@@ -408,43 +413,52 @@ void NodeCarbonCalc::calc( const int aPeriod, const int aEndYear, const ICarbonC
         // change in land internal to the node should be zero.
         assert( util::isEqual( diffLandInternalCheck, 0.0 ) );
 
-        vector<double> prevLand( prevLandByTimestep );
-        vector<double> currLand( mCarbonCalcs.size() );
-        for( year = prevModelYear + 1; year <= modelYear; ++year ) {
-            // Initialize the carbon stock in this year to the carbon stock of the previous year minus
-            // any emissions that have already been allocated in this year from earlier year land decisions.
-            if( aCalcMode != ICarbonCalc::eReverseCalc ) {
-                for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
-                    mCarbonCalcs[ i ]->mCarbonStock[ year ] = mCarbonCalcs[ i ]->mCarbonStock[ year - 1 ] -
-                        ( mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] + (*currEmissionsAbove[ i ])[ year ] );
-                }
+        // Once the changes in land are split into those from outside and inside
+        // the node the carbon of each option evolves on its own, so each is
+        // calculated over all of the years before moving on to the next.  This
+        // reuses one set of emissions vectors and keeps the data of the option
+        // being calculated together.
+        YearVector<double> currEmissionsAbove( prevModelYear + 1, aEndYear, 0.0 );
+        YearVector<double> currEmissionsBelow( prevModelYear + 1, aEndYear, 0.0 );
+        for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
+            NoEmissCarbonCalc* carbonCalc = mCarbonCalcs[ i ];
+            // clear the emissions calculated for the previous option
+            if( i > 0 ) {
+                currEmissionsAbove.assign( currEmissionsAbove.size(), 0.0 );
+                currEmissionsBelow.assign( currEmissionsBelow.size(), 0.0 );
             }
-            // Calculate emissions from changes in land that was removed/added from outside of this node.
-            for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
-                currLand[ i ] = prevLand[ i ] + diffLandFromExternalByYear[ i ];
+            double prevLand = prevLandByTimestep[ i ];
+            for( year = prevModelYear + 1; year <= modelYear; ++year ) {
+                // Initialize the carbon stock in this year to the carbon stock of the previous year minus
+                // any emissions that have already been allocated in this year from earlier year land decisions.
+                if( aCalcMode != ICarbonCalc::eReverseCalc ) {
+                    carbonCalc->mCarbonStock[ year ] = carbonCalc->mCarbonStock[ year - 1 ] -
+                        ( carbonCalc->mTotalEmissionsAbove[ year ] + currEmissionsAbove[ year ] );
+                }
+                // Calculate emissions from changes in land that was removed/added from outside of this node.
+                double currLand = prevLand + diffLandFromExternalByYear[ i ];
                 double carbonDiffBelowPerYear = -1 * diffLandFromExternalByYear[ i ] * belowGroundCarbonDensity[ i ];
-                double prevEmiss = (*currEmissionsAbove[ i ])[ year ];
+                double prevEmiss = currEmissionsAbove[ year ];
                 // we need to be careful about accessing the carbon stock from a previous timestep
                 // when we are intending to calculate in eReverseCalc as the previous timestep may have
                 // already calculated in eStoreResults
-                mCarbonCalcs[ i ]->calcAboveGroundCarbonEmission( aCalcMode == ICarbonCalc::eReverseCalc && (year - 1) == prevModelYear ?
-                                                                        mCarbonCalcs[ i ]->mSavedCarbonStock[ aPeriod - 1 ] :
-                                                                        mCarbonCalcs[ i ]->mCarbonStock[ year - 1 ],
-                                                                  prevLand[ i ], currLand[ i ], aboveGroundCarbonDensity[ i ], year, aEndYear,
-                                                                  *currEmissionsAbove[ i ] );
-                mCarbonCalcs[ i ]->calcBelowGroundCarbonEmission( carbonDiffBelowPerYear, year, aEndYear, *currEmissionsBelow[ i ] );
+                carbonCalc->calcAboveGroundCarbonEmission( aCalcMode == ICarbonCalc::eReverseCalc && (year - 1) == prevModelYear ?
+                                                                carbonCalc->mSavedCarbonStock[ aPeriod - 1 ] :
+                                                                carbonCalc->mCarbonStock[ year - 1 ],
+                                                           prevLand, currLand, aboveGroundCarbonDensity[ i ], year, aEndYear,
+                                                           currEmissionsAbove );
+                carbonCalc->calcBelowGroundCarbonEmission( carbonDiffBelowPerYear, year, aEndYear, currEmissionsBelow );
                 if( aCalcMode != ICarbonCalc::eReverseCalc ) {
-                    mCarbonCalcs[ i ]->mCarbonStock[ year ] -= (*currEmissionsAbove[ i ])[ year ] - prevEmiss;
+                    carbonCalc->mCarbonStock[ year ] -= currEmissionsAbove[ year ] - prevEmiss;
                 }
-            }
-            // Calculate emissions from changes in land internal to this node.  Carbon can move internally
-            // to the node with out emissions however if there is a difference in carbon densities then
-            // emissions/uptake may still occur.  These emissions/uptake get accounted for in the options
-            // that gain land.
-            for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
-                currLand[ i ] += diffLandFromInternalByYear[ i ];
+                
+                // Calculate emissions from changes in land internal to this node.  Carbon can move internally
+                // to the node with out emissions however if there is a difference in carbon densities then
+                // emissions/uptake may still occur.  These emissions/uptake get accounted for in the options
+                // that gain land.
+                currLand += diffLandFromInternalByYear[ i ];
                 if( diffLandFromInternalByYear[ i ] > 0 ) {
-                    double emissBeforeMove = (*currEmissionsAbove[ i ])[ year ];
+                    double emissBeforeMove = currEmissionsAbove[ year ];
                     // Calculate the difference in carbon densities which would drive any
                     // emissions or uptake.
                     double fractionOfGain = diffLandFromInternalByYear[ i ] / totalInternalLandGainByYear;
@@ -452,54 +466,49 @@ void NodeCarbonCalc::calc( const int aPeriod, const int aEndYear, const ICarbonC
                     double carbonDiffAboveDensity = -1 * ( currCarbonMove / diffLandFromInternalByYear[ i ] - aboveGroundCarbonDensity[ i ] );
                     double carbonDiffBelow = -1 * ( diffLandFromInternalByYear[ i ] * belowGroundCarbonDensity[ i ] -
                         fractionOfGain * totalInternalCarbonBelowMovedByYear );
-                    mCarbonCalcs[ i ]->calcAboveGroundCarbonEmission( 0, 0, diffLandFromInternalByYear[ i ], carbonDiffAboveDensity,
-                                                                      year, aEndYear, *currEmissionsAbove[ i ] );
-                    mCarbonCalcs[ i ]->calcBelowGroundCarbonEmission( carbonDiffBelow, year, aEndYear, *currEmissionsBelow[ i ] );
+                    carbonCalc->calcAboveGroundCarbonEmission( 0, 0, diffLandFromInternalByYear[ i ], carbonDiffAboveDensity,
+                                                               year, aEndYear, currEmissionsAbove );
+                    carbonCalc->calcBelowGroundCarbonEmission( carbonDiffBelow, year, aEndYear, currEmissionsBelow );
                     // Adjust carbon stock to include the carbon being moved in minus any emissions because of moving
                     // the carbon.
                     if( aCalcMode != ICarbonCalc::eReverseCalc ) {
-                        mCarbonCalcs[ i ]->mCarbonStock[ year ] += currCarbonMove - ( (*currEmissionsAbove[ i ])[ year ] - emissBeforeMove );
+                        carbonCalc->mCarbonStock[ year ] += currCarbonMove - ( currEmissionsAbove[ year ] - emissBeforeMove );
                     }
                 }
                 else {
                     // Remove the carbon that is changing land type from the carbon stock without
                     // emissions.
                     if( aCalcMode != ICarbonCalc::eReverseCalc ) {
-                        mCarbonCalcs[ i ]->mCarbonStock[ year ] -= internalCarbonAboveMovedByYear[ i ];
+                        carbonCalc->mCarbonStock[ year ] -= internalCarbonAboveMovedByYear[ i ];
                     }
                 }
-                prevLand[ i ] = currLand[ i ];
+                prevLand = currLand;
             }
-        }
 
-        // add current emissions to the total
-        for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
+            // add current emissions to the total
             if( aCalcMode == ICarbonCalc::eStoreResults ) {
                 for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                    mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] += (*currEmissionsAbove[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ] += (*currEmissionsBelow[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissions[ year ] = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] +
-                        mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ];
-                    mCarbonCalcs[ i ]->mSavedCarbonStock[ aPeriod - 1 ] = mCarbonCalcs[ i ]->mCarbonStock[ prevModelYear ];
-                    mCarbonCalcs[ i ]->mSavedLandAllocation[ aPeriod - 1 ] = mCarbonCalcs[ i ]->mLandLeaf->getLandAllocation( mCarbonCalcs[ i ]->mLandLeaf->getName(), aPeriod - 1 );
+                    carbonCalc->mTotalEmissionsAbove[ year ] += currEmissionsAbove[ year ];
+                    carbonCalc->mTotalEmissionsBelow[ year ] += currEmissionsBelow[ year ];
+                    carbonCalc->mTotalEmissions[ year ] = carbonCalc->mTotalEmissionsAbove[ year ] +
+                        carbonCalc->mTotalEmissionsBelow[ year ];
                 }
+                carbonCalc->mSavedCarbonStock[ aPeriod - 1 ] = carbonCalc->mCarbonStock[ prevModelYear ];
+                carbonCalc->mSavedLandAllocation[ aPeriod - 1 ] = carbonCalc->mLandLeaf->getLandAllocation( carbonCalc->mLandLeaf->getName(), aPeriod - 1 );
             }
             else if( aCalcMode == ICarbonCalc::eReverseCalc ) {
                 for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                    mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] -= (*currEmissionsAbove[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ] -= (*currEmissionsBelow[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissions[ year ] = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] +
-                        mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ];
+                    carbonCalc->mTotalEmissionsAbove[ year ] -= currEmissionsAbove[ year ];
+                    carbonCalc->mTotalEmissionsBelow[ year ] -= currEmissionsBelow[ year ];
+                    carbonCalc->mTotalEmissions[ year ] = carbonCalc->mTotalEmissionsAbove[ year ] +
+                        carbonCalc->mTotalEmissionsBelow[ year ];
                 }
             }
             else if( aCalcMode == ICarbonCalc::eReturnTotal ) {
-                mCarbonCalcs[ i ]->mStoredEmissions = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ aEndYear ] +
-                    mCarbonCalcs[ i ]->mTotalEmissionsBelow[ aEndYear ] +
-                    (*currEmissionsAbove[ i ])[ aEndYear ] + (*currEmissionsBelow[ i ])[ aEndYear ];
+                carbonCalc->mStoredEmissions = carbonCalc->mTotalEmissionsAbove[ aEndYear ] +
+                    carbonCalc->mTotalEmissionsBelow[ aEndYear ] +
+                    currEmissionsAbove[ aEndYear ] + currEmissionsBelow[ aEndYear ];
             }
-            // clean up memory now that we are done with it
-            delete currEmissionsAbove[ i ];
-            delete currEmissionsBelow[ i ];
         }
     }
 }
@@ -55,7 +55,7 @@ class magicc_array {
     float* data;
     char name[ MA_NAMELEN ];
 private:
-    int computepos( int, int );
+    int computepos( int, int ) const;
     void copy( const magicc_array& array );
 public:
     magicc_array();
@@ -65,7 +65,7 @@ public:
 
     void init( const char*, int, int, int=0, int=0 );
     void setval( float, int, int=0 );
-    float getval( int, int=0 );    
+    float getval( int, int=0 ) const;    
     float* getptr( int, int=0 );    
     void print();
 };
@@ -329,22 +329,65 @@ typedef struct {
     int KEYDW;
 } VARW_block;
 
+typedef struct {
+    // Local variables which the Fortran code SAVEs between calls.
+    // tslcalc
+    float TCUM, TBASE, XX, GS1990, B19901, B19902, B19903, B19904;
+    float BZERO1, BZERO2, BZERO3, BZERO4;
+    float GSPREV1, GSPREV2, GSPREV3, GSPREV4;
+    float VZ1, VZ2, VZ3, VZ4;
+    // deltaq
+    float T00LO, T00MID, T00HI, T00USER;
+    float DQOZ, QOZ1, TX, DELT90, DELT00;
+    // carbon
+    float DELC;
+} SAVE_block;
+
+/*!
+ * \brief The MAGICC state which persists between calls into MAGICC.
+ * \details These are the blocks which the routines used to get and set
+ *          values from MAGICC need access to along with the SAVE'd local
+ *          variables.  Each MagiccModel owns its own state so that more
+ *          than one instance of MAGICC can be used in the same process.
+ *          The state may simply be copied to clone a MAGICC instance.
+ */
+struct MAGICC_state {
+    MAGICC_state();
+    CARB_block CARB;
+    TANDSL_block TANDSL;
+    CONCS_block CONCS;
+    NEWCONCS_block NEWCONCS;
+    STOREDVALS_block STOREDVALS;
+    METH1_block METH1;
+    CAR_block CAR;
+    FORCE_block FORCE;
+    JSTART_block JSTART;
+    QADD_block QADD;
+    HALOF_block HALOF;
+    NEWPARAMS_block NEWPARAMS;
+    BCOC_block BCOC;
+    SAVE_block SAVE;
+    std::string GAS_EMK_DATA;
+};
+
 // Function prototypes
-void CLIMAT();
+void CLIMAT( MAGICC_state* STATE );
 void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_block* CARB,
              TANDSL_block* TANDSL, VARW_block* VARW, QSPLIT_block* QSPLIT, ICE_block* ICE, 
-             NSIM_block* NSIM, std::ofstream* outfile8 );
+             NSIM_block* NSIM, SAVE_block* SAVE, std::ofstream* outfile8 );
 void init( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, TANDSL_block* TANDSL, FORCE_block* FORCE, 
           Sulph_block* Sulph, VARW_block* VARW, ICE_block* ICE, AREAS_block* AREAS, NSIM_block* NSIM,
           OZ_block* OZ, NEWCONCS_block* NEWCONCS, CARB_block* CARB, CAR_block* CAR, METH1_block* METH1,
           METH2_block* METH2, METH3_block* METH3, METH4_block* METH4, CO2READ_block* CO2READ, JSTART_block* JSTART,
-          CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, TauNitr_block* TauNitr, QADD_block* QADD );
+          CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, TauNitr_block* TauNitr, QADD_block* QADD,
+          SAVE_block* SAVE );
 void interp( int NVAL, int ISTART, int IY[], float X[], magicc_array* Y, int KEND );
 void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block* CONCS,
             NEWCONCS_block* NEWCONCS, CARB_block* CARB, TANDSL_block* TANDSL, CAR_block* CAR,
             METH1_block* METH1, FORCE_block* FORCE, METH2_block* METH2, METH3_block* METH3,
             METH4_block* METH4, TauNitr_block* TauNitr, Sulph_block* Sulph, NSIM_block* NSIM, 
-            CO2READ_block* CO2READ, JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS );
+            CO2READ_block* CO2READ, JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS,
+            SAVE_block* SAVE );
 void initcar( const int NN, const float D80, const float F80, COBS_block* COBS, 
              CARB_block* CARB, CAR_block* CAR );
 void halocarb( const int N, float C0, float E, float* C1, float* Q, float TAU00, float TAUCH4 );
@@ -359,7 +402,7 @@ void carbon( const int MM, float TEM, float EFOSS, float ENETDEF, float CPP, flo
             float PL, float HU, float SO, float REGRO, float ETOT,
             float* PL1, float* HU1, float* SO1, float* REGRO1, float* ETOT1,
             float* SUMEM, float* FLUX, float* DELM, float* EGROSSD, float* C1,
-            CAR_block* CAR ); 
+            CAR_block* CAR, SAVE_block* SAVE ); 
 void sulphate( const int JY, float ESO2, float ESO21, float ECO, float* QSO2, 
               float* QDIR, float* QFOC, float* QMN, Sulph_block* Sulph );
 void lamcalc( float Q, float FNHL, float FSHL, float XK, float XKH, float DT2X, 
@@ -369,29 +412,29 @@ void runmod( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_bl
             AREAS_block* AREAS, QADD_block* QADD, BCOC_block* BCOC, FORCE_block* FORCE, NSIM_block* NSIM,
             OZ_block* OZ, NEWCONCS_block* NEWCONCS, CAR_block* CAR, METH1_block* METH1, METH2_block* METH2, 
             METH3_block* METH3, METH4_block* METH4, TauNitr_block* TauNitr,
-            JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, ICE_block* ICE, std::ofstream* outfile8 );
+            JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, ICE_block* ICE, SAVE_block* SAVE, std::ofstream* outfile8 );
 void split( const float QGLOBE, const float A, const float BN, const float BS, float* QNO, float* QNL, 
            float* QSO, float* QSL, AREAS_block* AREAS );
 
-void setGlobals( CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
+void setGlobals( MAGICC_state* STATE, CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
                 STOREDVALS_block* STOREDVALS, NEWPARAMS_block* NEWPARAMS, BCOC_block* BCOC, 
                 METH1_block* METH1, CAR_block* CAR, FORCE_block* FORCE, JSTART_block* JSTART,
                 QADD_block* QADD, HALOF_block* HALOF, std::string& GAS_EMK_DATA );
-void setLocals( CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
+void setLocals( const MAGICC_state* STATE, CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
                 STOREDVALS_block* STOREDVALS, NEWPARAMS_block* NEWPARAMS, BCOC_block* BCOC, 
                 METH1_block* METH1, CAR_block* CAR, FORCE_block* FORCE, JSTART_block* JSTART,
                 QADD_block* QADD, HALOF_block* HALOF, std::string& GAS_EMK_DATA );
 
 // Externally called methods
 
-float getSLR( const int inYear );
-float GETFORCING( const int iGasNumber, const int inYear );
-float GETGHGCONC(int, int);
-float GETGMTEMP(int);
-float GETCARBONRESULTS(int, int);
-void SETPARAMETERVALUES(int, float);
+float getSLR( const MAGICC_state* STATE, const int inYear );
+float GETFORCING( const MAGICC_state* STATE, const int iGasNumber, const int inYear );
+float GETGHGCONC( const MAGICC_state* STATE, int, int );
+float GETGMTEMP( const MAGICC_state* STATE, int );
+float GETCARBONRESULTS( const MAGICC_state* STATE, int, int );
+void SETPARAMETERVALUES( MAGICC_state* STATE, int, float );
 void overrideParameters( NEWPARAMS_block* NEWPARAMS, CAR_block* CAR, METH1_block* METH1, BCOC_block* BCOC );
-void SET_GAS_EMK( const std::string& GAS_EMK_DATA );
+void SET_GAS_EMK( MAGICC_state* STATE, const std::string& GAS_EMK_DATA );
 
 // Internal helper methods
 
@@ -79,6 +79,14 @@ class IVisitor;
  *          the beginning of each new scenario) or in a stabilization
  *          run (where we might have to run each stabilization period
  *          many times to find the right GHG tax).
+ *
+ *          Climate parameter uncertainty can be explored by adding
+ *          ensemble-member elements, each of which sets some of Hector's
+ *          parameters.  At the end of the scenario each member is run
+ *          in its own Hector core on the same emissions, concurrently
+ *          when GCAM is built with TBB, and the yearly concentrations,
+ *          forcings and temperature of every member are written to the
+ *          file hectorEnsembleFileName.
  */
 class HectorModel: public IClimateModel {
 public:
@@ -176,6 +184,63 @@ private:
     //! units (multiply GCAM's value by this to get the hector value)
     std::map<std::string, double> mUnitConvFac;
 
+    //! A set of Hector parameters to run on the final emissions.
+    struct EnsembleMember {
+        //! The name of the member used in the output.
+        std::string mName;
+
+        //! The Hector parameters to set as (message, unit, value).
+        std::vector<std::pair<std::pair<std::string, int>, double> > mParameters;
+    };
+
+    //! The climate parameter ensemble to run at the end of the scenario.
+    std::vector<EnsembleMember> mEnsemble;
+
+    //! The results retrieved from Hector each year the model is run.
+    enum YearlyResult {
+        eConcCH4,
+        eConcN2O,
+        eConcO3,
+        eConcCO2,
+        eRFTotal,
+        eRFCO2,
+        eRFCH4,
+        eRFN2O,
+        eRFBC,
+        eRFOC,
+        eRFSO2,
+        eGlobalTemp,
+        eLandFlux,
+        eOceanFlux,
+        eNumYearlyResults
+    };
+
+    //! How to retrieve a yearly result and where to store it.
+    struct YearlyResultInfo {
+        //! The name of the result used in the ensemble output.
+        std::string mName;
+
+        //! The Hector message to request the value.
+        std::string mMessage;
+
+        //! Whether the value must be requested for the run year.
+        bool mByDate;
+
+        //! The table in which to store the value.  This points into
+        //! one of the tables above so that no string lookups are needed
+        //! each year.
+        std::vector<double>* mTable;
+    };
+
+    //! The yearly results indexed by YearlyResult.
+    YearlyResultInfo mYearlyResults[ eNumYearlyResults ];
+
+    //! The first year whose results are affected by emissions that have
+    //! changed since Hector was last run.  This lets us avoid resetting
+    //! Hector when a rerun does not change any emissions up to the year
+    //! requested.
+    int mFirstChangedYear;
+
     //! Hector core object
     std::auto_ptr<Hector::Core> mHcore;
 
@@ -190,17 +255,24 @@ private:
     //! reset the Hector GCAM component and the Hector model for a new run
     void reset( const int aPeriod );
 
+    //! send the stored emissions through a period to a Hector core
+    void replayEmissions( Hector::Core* aCore, const int aPeriod );
+
     //! worker routine for setting emissions
-    bool setEmissionsByYear( const std::string& aGasName, const int aYear, double aEmissions );
+    bool setEmissionsByYear( Hector::Core* aCore, const std::string& aGasName,
+                             const int aYear, double aEmissions );
+
+    void parseEnsembleMember( const xercesc::DOMNode* aNode );
+
+    void runEnsemble( const int aEndYear );
 
-    //! subroutines for getting data from Hector and storing it in the tables
-    void storeConc( const int aYear, const bool aHadError );
-    void storeRF( const int aYear, const bool aHadError );
-    void storeGlobals( const int aYear, const bool aHadError );
+    //! subroutine for getting data from Hector and storing it in the tables
+    void storeYearlyResults( const int aYear, const bool aHadError );
 
-    //! set up the tables used by the functions in the previous block
+    //! set up the tables used by the function in the previous block
     void setupConcTbl();
     void setupRFTbl();
+    void setupYearlyResults();
 
     int yearlyDataIndex( const int aYear ) const;
 };
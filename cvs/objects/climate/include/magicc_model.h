@@ -48,9 +48,11 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <memory>
 #include "climate/include/iclimate_model.h"
 
 class IVisitor;
+struct MAGICC_state;
 
 /*! 
 * \ingroup Objects
@@ -75,6 +77,7 @@ class IVisitor;
 class MagiccModel: public IClimateModel {
 public:
     MagiccModel();
+    virtual ~MagiccModel();
 
     virtual void completeInit( const std::string& aScenarioName );
     
@@ -208,6 +211,9 @@ private:
     
     //! MAGICC critcal start year in gas.emk that must be present
     static const int GAS_EMK_CRIT_YEAR;
+
+    //! The state of this instance of MAGICC.
+    std::auto_ptr<MAGICC_state> mState;
 };
 
 #endif // _MAGICC_MODEL_H_
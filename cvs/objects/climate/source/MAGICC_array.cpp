@@ -101,7 +101,7 @@ void magicc_array::init( const char* s, int l1, int h1, int l2, int h2 )
     }
 }
 
-int magicc_array::computepos( int i1, int i2 )
+int magicc_array::computepos( int i1, int i2 ) const
 {
     return i1-low1 + ( i2-low2 )*( high1-low1+1 );
 }
@@ -118,7 +118,7 @@ void magicc_array::setval( float v, int i1, int i2 )
 //    cout << name << ": writing " << v << " to " << i1 << " " << i2 << endl;
 }
 
-float magicc_array::getval( int i1, int i2 )
+float magicc_array::getval( int i1, int i2 ) const
 {
     if( !initialized || i1 < low1 || i1 > high1 || i2 < low2 || i2 > high2 )
     {
@@ -49,8 +49,9 @@ using namespace std;
 
 
 // The climat() function is up here so as to encapsulate all these stinking variables;
-// we're not going to allow any globals in the C++ code
-void CLIMAT()
+// we're not going to allow any globals in the C++ code.  The values which need to
+// persist between calls are kept in the given state.
+void CLIMAT( MAGICC_state* STATE )
 {
     // Get input and output file directories from the configuration.  Opening files
     // will be done relative to these paths.
@@ -388,8 +389,8 @@ void CLIMAT()
     // Input gas data will be read out of this string rather than through an actual file.
     string GAS_EMK_DATA;
 
-    // The MAGICC routines need access to these data structures, so set some global references
-    setLocals( &CARB, &TANDSL, &CONCS, &NEWCONCS, 
+    // Get the parameters and gas data which have been set in the state
+    setLocals( STATE, &CARB, &TANDSL, &CONCS, &NEWCONCS, 
                 &STOREDVALS, &NEWPARAMS, &BCOC, 
                 &METH1, &CAR, &FORCE, &JSTART,
                 &QADD, &HALOF, GAS_EMK_DATA );
@@ -2101,7 +2102,7 @@ void CLIMAT()
     //F1202       CALL INIT
     init( &Limits, &CLIM, &CONCS, &TANDSL, &FORCE, &Sulph, &VARW, &ICE, &AREAS, &NSIM,
          &OZ, &NEWCONCS, &CARB, &CAR, &METH1, &METH2, &METH3, &METH4, &CO2READ, &JSTART,
-         &CORREN, &HALOF, &COBS, &TauNitr, &QADD );
+         &CORREN, &HALOF, &COBS, &TauNitr, &QADD, &STATE->SAVE );
     //F1203 !
     //F1204 !  LINEARLY EXTRAPOLATE LAST ESO2 VALUES FOR ONE YEAR
     //F1205 !
@@ -2357,7 +2358,7 @@ void CLIMAT()
              &Sulph, &VARW, &ICE, &AREAS, &NSIM,
              &OZ, &NEWCONCS, &CARB, &CAR, &METH1,
              &METH2, &METH3, &METH4, &CO2READ, &JSTART,
-             &CORREN, &HALOF, &COBS, &TauNitr, &QADD );     
+             &CORREN, &HALOF, &COBS, &TauNitr, &QADD, &STATE->SAVE );
          //F1372 !
         //F1373       IF(NESO2.EQ.1)THEN
         if( NESO2 == 1 ) {
@@ -2458,7 +2459,7 @@ void CLIMAT()
                &CO2READ, &Sulph, &DSENS, &VARW, &QSPLIT,
                &AREAS, &QADD, &BCOC, &FORCE, &NSIM,
                &OZ, &NEWCONCS, &CAR, &METH1, &METH2, &METH3, &METH4, &TauNitr,
-               &JSTART, &CORREN, &HALOF, &COBS, &ICE, &outfile8 );
+               &JSTART, &CORREN, &HALOF, &COBS, &ICE, &STATE->SAVE, &outfile8 );
         //F1423 !
         //F1424 !  EXTRA CALL TO RUNMOD TO GET FINAL FORCING VALUES FOR K=KEND
         //F1425 !   WHEN DT=1.0
@@ -3826,8 +3827,8 @@ void CLIMAT()
         //F2237 
         //F2238 	OPEN (UNIT=9, file='./outputs/MAGOUT.CSV')
 
-        // GetForcing now relies on globals, and these need to be set
-        setGlobals( &CARB, &TANDSL, &CONCS, &NEWCONCS, 
+        // GetForcing now relies on the state, and it needs to be set
+        setGlobals( STATE, &CARB, &TANDSL, &CONCS, &NEWCONCS, 
                    &STOREDVALS, &NEWPARAMS, &BCOC, 
                    &METH1, &CAR, &FORCE, &JSTART,
                    &QADD, &HALOF, GAS_EMK_DATA );
@@ -3874,26 +3875,26 @@ void CLIMAT()
 
             // RADIATIVE FORCING
             //F2273 	 MAGICCCResults(13,(K-1990)/IIPRT+1) = GETFORCING( 0, K ) ! Total antro forcing
-            MAGICCCResults[ 4 ][ yrindex ] = GETFORCING( 0, K );
+            MAGICCCResults[ 4 ][ yrindex ] = GETFORCING( STATE, 0, K );
             //F2282 	 MAGICCCResults(22,(K-1990)/IIPRT+1) = & !Kyoto Forcing
             //F2283 	    GETFORCING( 1, K ) + GETFORCING( 2, K )  + GETFORCING( 3, K ) + & ! CO2, CH4, and N2O
             //F2284 	    GETFORCING( 4, K ) + GETFORCING( 9, K ) + GETFORCING( 10, K ) + &! Long-lived F-gases
             //F2285 	    GETFORCING( 5, K ) + GETFORCING( 6, K ) + GETFORCING( 7, K ) + &
             //F2286 	    GETFORCING( 8, K ) + GETFORCING( 11, K ) + GETFORCING( 12, K ) ! Shorter-lived F-gases
-            MAGICCCResults[ 5 ][ yrindex ] = GETFORCING( 1, K ) + GETFORCING( 2, K ) + GETFORCING( 3, K ) +
-                GETFORCING( 4, K ) + GETFORCING( 9, K ) + GETFORCING( 10, K ) +
-                GETFORCING( 5, K ) + GETFORCING( 6, K ) + GETFORCING( 7, K ) +
-                GETFORCING( 8, K ) + GETFORCING( 11, K ) + GETFORCING( 12, K );
+            MAGICCCResults[ 5 ][ yrindex ] = GETFORCING( STATE, 1, K ) + GETFORCING( STATE, 2, K ) + GETFORCING( STATE, 3, K ) +
+                GETFORCING( STATE, 4, K ) + GETFORCING( STATE, 9, K ) + GETFORCING( STATE, 10, K ) +
+                GETFORCING( STATE, 5, K ) + GETFORCING( STATE, 6, K ) + GETFORCING( STATE, 7, K ) +
+                GETFORCING( STATE, 8, K ) + GETFORCING( STATE, 11, K ) + GETFORCING( STATE, 12, K );
             //F2262 	 MAGICCCResults(5,(K-1990)/IIPRT+1) = GETFORCING( 1, K ) ! CO2
-            MAGICCCResults[ 6 ][ yrindex ] = GETFORCING( 1, K );
+            MAGICCCResults[ 6 ][ yrindex ] = GETFORCING( STATE, 1, K );
             //F2263 	 MAGICCCResults(6,(K-1990)/IIPRT+1) = GETFORCING( 2, K ) ! CH4 (no indirect components)
-            MAGICCCResults[ 7 ][ yrindex ] = GETFORCING( 2, K );
+            MAGICCCResults[ 7 ][ yrindex ] = GETFORCING( STATE, 2, K );
             //F2264 	 MAGICCCResults(7,(K-1990)/IIPRT+1) = GETFORCING( 3, K ) ! N2O
-            MAGICCCResults[ 8 ][ yrindex ] = GETFORCING( 3, K );
+            MAGICCCResults[ 8 ][ yrindex ] = GETFORCING( STATE, 3, K );
             //F2270 	 MAGICCCResults(10,(K-1990)/IIPRT+1) = GETFORCING( 14, K ) ! SO2 direct only
-            MAGICCCResults[ 9 ][ yrindex ] = GETFORCING( 14, K );
+            MAGICCCResults[ 9 ][ yrindex ] = GETFORCING( STATE, 14, K );
             //F2271 	 MAGICCCResults(11,(K-1990)/IIPRT+1) = GETFORCING( 13, K ) - GETFORCING( 14, K ) ! indirect only
-            MAGICCCResults[ 10 ][ yrindex ] = GETFORCING( 13, K ) - GETFORCING( 14, K );
+            MAGICCCResults[ 10 ][ yrindex ] = GETFORCING( STATE, 13, K ) - GETFORCING( STATE, 14, K );
 
             // EMISSIONS
             //F2274 	 MAGICCCResults(14,(K-1990)/IIPRT+1) = EF(IYR)
@@ -3915,7 +3916,7 @@ void CLIMAT()
             //F2258 	 MAGICCCResults(1,(K-1990)/IIPRT+1) = TEMUSER(IYR)+TGAV(226)
             MAGICCCResults[ 18 ][ yrindex ] = STOREDVALS.TEMUSER[ IYR ] + TANDSL.TGAV[ 226 ];
             //F2281 	 MAGICCCResults(21,(K-1990)/IIPRT+1) = getSLR( IYR ) ! getSLR is external fn with acutal year as argument
-            MAGICCCResults[ 19 ][ yrindex ] = getSLR( K );
+            MAGICCCResults[ 19 ][ yrindex ] = getSLR( STATE, K );
 
             // BC/OC FORCING
             //F2293 	 MAGICCCResults(26,(K-1990)/IIPRT+1) = GETFORCING( 24, K )	! BC forcing 
@@ -3923,9 +3924,9 @@ void CLIMAT()
             //F2294 	 MAGICCCResults(27,(K-1990)/IIPRT+1) = GETFORCING( 25, K )	! OC forcing 
          //   MAGICCCResults[ 21 ][ yrindex ] = GETFORCING( 25, K );
             // Fossil BC/OC Forcing
-            MAGICCCResults[ 20 ][ yrindex ] = GETFORCING( 28, K );
+            MAGICCCResults[ 20 ][ yrindex ] = GETFORCING( STATE, 28, K );
             // Biomass Burning Aerosol Forcing
-            MAGICCCResults[ 21 ][ yrindex ] = GETFORCING( 20, K );
+            MAGICCCResults[ 21 ][ yrindex ] = GETFORCING( STATE, 20, K );
             
             //F2295 
             //F2296 ! now we can write stuff out
@@ -4998,7 +4999,7 @@ void CLIMAT()
     //F3057         end
     outfile8.close();
 
-    setGlobals( &CARB, &TANDSL, &CONCS, &NEWCONCS, 
+    setGlobals( STATE, &CARB, &TANDSL, &CONCS, &NEWCONCS, 
               &STOREDVALS, &NEWPARAMS, &BCOC, 
               &METH1, &CAR, &FORCE, &JSTART,
               &QADD, &HALOF, GAS_EMK_DATA );
@@ -92,7 +92,8 @@ void init( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, TANDSL_bl
           Sulph_block* Sulph, VARW_block* VARW, ICE_block* ICE, AREAS_block* AREAS, NSIM_block* NSIM,
           OZ_block* OZ, NEWCONCS_block* NEWCONCS, CARB_block* CARB, CAR_block* CAR, METH1_block* METH1,
           METH2_block* METH2, METH3_block* METH3, METH4_block* METH4, CO2READ_block* CO2READ, JSTART_block* JSTART,
-          CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, TauNitr_block* TauNitr, QADD_block* QADD )
+          CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, TauNitr_block* TauNitr, QADD_block* QADD,
+          SAVE_block* SAVE )
 {
     //    std::cout << "SUBROUTINE INIT" << endl;
     f_enter( __func__ );
@@ -361,7 +362,7 @@ void init( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, TANDSL_bl
                NEWCONCS, CARB, TANDSL, CAR,
                METH1, FORCE, METH2, METH3,
                METH4, TauNitr, Sulph, NSIM, CO2READ, JSTART,
-               CORREN, HALOF, COBS );
+               CORREN, HALOF, COBS, SAVE );
         //F3218 !
         //F3219 !  INITIALISE QTOT ETC AT START OF 1765.
         //F3220 !  THIS ENSURES THAT ALL FORCINGS ARE ZERO AT THE MIDPOINT OF 1765.
@@ -403,7 +404,7 @@ void init( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, TANDSL_bl
 //F3241       SUBROUTINE TSLCALC(N)
 void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_block* CARB,
              TANDSL_block* TANDSL, VARW_block* VARW, QSPLIT_block* QSPLIT, ICE_block* ICE, 
-             NSIM_block* NSIM, std::ofstream* outfile8 )
+             NSIM_block* NSIM, SAVE_block* SAVE, std::ofstream* outfile8 )
 {
     //    std::cout << "SUBROUTINE TSLCALC" << endl;
     f_enter( __func__ );
@@ -548,38 +549,34 @@ void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS,
     //F3343 !
     //F3344       IF(N.LE.226)THEN
     float TBAR = 0.0;
-    static float TCUM = 0.0;
+    // These SAVE'd variables are kept in the SAVE block.
     if( N <= 226 ) {
         //F3345         TBAR = 0.0
         //F3346         TCUM = 0.0
-        TBAR = TCUM = 0.0;
+        TBAR = SAVE->TCUM = 0.0;
         //F3347         SLT(N)=EX(N)
         TANDSL->SLT[ N ] = TANDSL->EX[ N ];
         //F3348       ENDIF
     }
     //F3349 !
-    static float TBASE = 0.0, XX = 0.0, GS1990 = 0.0, B19901 = 0.0, B19902 = 0.0, B19903 = 0.0, B19904 = 0.0;
-    static float BZERO1 = 0.0, BZERO2 = 0.0, BZERO3 = 0.0, BZERO4 = 0.0;
-    static float GSPREV1 = 0.0, GSPREV2 = 0.0, GSPREV3 = 0.0, GSPREV4 = 0.0;
-    static float VZ1 = 0.0, VZ2 = 0.0, VZ3 = 0.0, VZ4 = 0.0;
     float GS, GS1, GS2, GS3, GS4;
     GS = GS1 = GS2 = GS3 = GS4 = 0.0;
     //F3350       IF(N.EQ.226)THEN
     if( N == 226 ) {
         //F3351         TBASE=TGAV(N)
-        TBASE = TANDSL->TGAV[ N ];
+        SAVE->TBASE = TANDSL->TGAV[ N ];
         //F3352         XX=G1990
-        XX = ICE->G1990;
+        SAVE->XX = ICE->G1990;
         //F3353         GS1990=0.934*XX-0.01165*XX*XX        ! CM
-        GS1990 = 0.934 * XX - 0.01165 * XX * XX;
+        SAVE->GS1990 = 0.934 * SAVE->XX - 0.01165 * SAVE->XX * SAVE->XX;
         //F3354         B19901=(0.934-0.0233*XX)*SEN*0.6                 ! NEW CODE
-        B19901 = ( 0.934 - 0.0233 * XX ) * ICE->SEN * 0.6;
+        SAVE->B19901 = ( 0.934 - 0.0233 * SAVE->XX ) * ICE->SEN * 0.6;
         //F3355         B19902=(0.934-0.0233*XX)*SEN                     ! NEW CODE
-        B19902 = ( 0.934 - 0.0233 * XX ) * ICE->SEN;
+        SAVE->B19902 = ( 0.934 - 0.0233 * SAVE->XX ) * ICE->SEN;
         //F3356         B19903=(0.934-0.0233*XX)*SEN*1.4                 ! NEW CODE
-        B19903 = ( 0.934 - 0.0233 * XX ) * ICE->SEN * 1.4;
+        SAVE->B19903 = ( 0.934 - 0.0233 * SAVE->XX ) * ICE->SEN * 1.4;
         //F3357         B19904=(0.934-0.0233*XX)*SEN*(1.0+(ICE-2)*0.4)   ! NEW CODE
-        B19904 = ( 0.934 - 0.0233 * XX ) * ICE->SEN * ( 1.0 + ( ICE->ICE - 2 ) * 0.4 );
+        SAVE->B19904 = ( 0.934 - 0.0233 * SAVE->XX ) * ICE->SEN * ( 1.0 + ( ICE->ICE - 2 ) * 0.4 );
         //F3358 !
         //F3359 !  YG IS TO ALLOW BZERO SCALING TO BE TURNED OFF
         //F3360 !
@@ -591,36 +588,36 @@ void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS,
         //F3364 !  ERROR BOUNDS ON VZERO CHANGED FROM +/-10 TO FOLLOW AR4 (JUNE 2008)
         //F3365 !
         //F3366         VZ1=VZERO-11.                                    ! NEW CODE
-        VZ1 = ICE->VZERO - 11.0;
+        SAVE->VZ1 = ICE->VZERO - 11.0;
         //F3367         VZ2=VZERO                                        ! NEW CODE
-        VZ2 = ICE->VZERO;
+        SAVE->VZ2 = ICE->VZERO;
         //F3368         VZ3=VZERO+15.                                    ! NEW CODE
-        VZ3 = ICE->VZERO + 15.0;
+        SAVE->VZ3 = ICE->VZERO + 15.0;
         //F3369         VZ4=VZERO+(ICE-2)*11.                            ! NEW CODE
-        VZ4 = ICE->VZERO + ( ICE->ICE - 2 ) * 11.0;
+        SAVE->VZ4 = ICE->VZERO + ( ICE->ICE - 2 ) * 11.0;
         //F3370         IF(ICE.EQ.3)VZ4=VZ4+4.
-        if( ICE->ICE == 3 ) VZ4 += 4.0;
+        if( ICE->ICE == 3 ) SAVE->VZ4 += 4.0;
         //F3371         BZERO1=B19901/((1.0-GS1990/VZ1)**YG)             ! NEW CODE
-        BZERO1 = B19901 / pow ( static_cast<float> (1.0) - GS1990 / VZ1, YG );
+        SAVE->BZERO1 = SAVE->B19901 / pow ( static_cast<float> (1.0) - SAVE->GS1990 / SAVE->VZ1, YG );
         //F3372         BZERO2=B19902/((1.0-GS1990/VZ2)**YG)             ! NEW CODE
-        BZERO2 = B19902 / pow ( static_cast<float> (1.0) - GS1990 / VZ2, YG );
+        SAVE->BZERO2 = SAVE->B19902 / pow ( static_cast<float> (1.0) - SAVE->GS1990 / SAVE->VZ2, YG );
         //F3373         BZERO3=B19903/((1.0-GS1990/VZ3)**YG)             ! NEW CODE
-        BZERO3 = B19903 / pow ( static_cast<float> (1.0) - GS1990 / VZ3, YG );
+        SAVE->BZERO3 = SAVE->B19903 / pow ( static_cast<float> (1.0) - SAVE->GS1990 / SAVE->VZ3, YG );
         //F3374         BZERO4=B19904/((1.0-GS1990/VZ4)**YG)             ! NEW CODE
-        BZERO4 = B19904 / pow ( static_cast<float> (1.0) - GS1990 / VZ4, YG );
+        SAVE->BZERO4 = SAVE->B19904 / pow ( static_cast<float> (1.0) - SAVE->GS1990 / SAVE->VZ4, YG );
         //F3375         GSPREV1=GS1990                                   ! NEW CODE
-        GSPREV1 = GS1990;
+        SAVE->GSPREV1 = SAVE->GS1990;
         //F3376         GSPREV2=GS1990                                   ! NEW CODE
-        GSPREV2 = GS1990;
+        SAVE->GSPREV2 = SAVE->GS1990;
         //F3377         GSPREV3=GS1990                                   ! NEW CODE
-        GSPREV3 = GS1990;
+        SAVE->GSPREV3 = SAVE->GS1990;
         //F3378         GSPREV4=GS1990                                   ! NEW CODE
-        GSPREV4 = GS1990;
+        SAVE->GSPREV4 = SAVE->GS1990;
         //F3379 !        WRITE(8,*)SEN,VZ4,B19904,BZERO4,GSPREV4
         //F3380       ENDIF
     }
     //F3381       IF(MODEL.EQ.0)T1990=TBASE
-    if( ICE->MODEL == 0 ) ICE->T1990 = TBASE;
+    if( ICE->MODEL == 0 ) ICE->T1990 = SAVE->TBASE;
     //F3382 !
     //F3383 !  NEED TCUM = INTEGRAL OF TEMP CHANGE FROM MID 1990
     //F3384 !
@@ -632,15 +629,15 @@ void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS,
         //F3388         IF(N.EQ.226)TBAR=0.0
         if( N == 226 ) TBAR = 0.0;
         //F3389         TCUM=TCUM+TBAR
-        TCUM += TBAR;
+        SAVE->TCUM += TBAR;
         //F3390         DTB=0.15
         const float DTB = 0.15;
         //F3391         AAA=T1990-TBASE
-        const float AAA = ICE->T1990 - TBASE;
+        const float AAA = ICE->T1990 - SAVE->TBASE;
         //F3392         DYR=FLOAT(N-226)
         const float DYR = float( N - 226 );
         //F3393         BBB=AAA*DYR+TCUM
-        const float BBB = AAA * DYR + TCUM;
+        const float BBB = AAA * DYR + SAVE->TCUM;
         //F3394 !
         //F3395 !  NEW GSIC. NOTE THAT LO, MID, HIGH AND USER CASES MUST ALL BE
         //F3396 !   CARRIED THRU TOGETHER SINCE THEY CANNOT BE CALCULATED BY
@@ -650,46 +647,46 @@ void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS,
         if( ICE->NEWGSIC == 1 ) {
             //F3400 !
             //F3401           FF1=BZERO1*(DTB+AAA+TGAV(N))                           ! NEW CODE
-            const float FF1 = BZERO1 * ( DTB + AAA + TANDSL->TGAV[ N ] );
+            const float FF1 = SAVE->BZERO1 * ( DTB + AAA + TANDSL->TGAV[ N ] );
             //F3402           FF2=BZERO2*(DTB+AAA+TGAV(N))                           ! NEW CODE
-            const float FF2 = BZERO2 * ( DTB + AAA + TANDSL->TGAV[ N ] );
+            const float FF2 = SAVE->BZERO2 * ( DTB + AAA + TANDSL->TGAV[ N ] );
             //F3403           FF3=BZERO3*(DTB+AAA+TGAV(N))                           ! NEW CODE
-            const float FF3 = BZERO3 * ( DTB + AAA + TANDSL->TGAV[ N ] );
+            const float FF3 = SAVE->BZERO3 * ( DTB + AAA + TANDSL->TGAV[ N ] );
             //F3404           FF4=BZERO4*(DTB+AAA+TGAV(N))                           ! NEW CODE
-            const float FF4 = BZERO4 * ( DTB + AAA + TANDSL->TGAV[ N ] );
+            const float FF4 = SAVE->BZERO4 * ( DTB + AAA + TANDSL->TGAV[ N ] );
             //F3405           X1=1.0-GSPREV1/VZ1                                     ! NEW CODE
-            const float X1 = 1.0 - GSPREV1 / VZ1;
+            const float X1 = 1.0 - SAVE->GSPREV1 / SAVE->VZ1;
             //F3406           X2=1.0-GSPREV2/VZ2                                     ! NEW CODE
-            const float X2 = 1.0 - GSPREV2 / VZ2;
+            const float X2 = 1.0 - SAVE->GSPREV2 / SAVE->VZ2;
             //F3407           X3=1.0-GSPREV3/VZ3                                     ! NEW CODE
-            const float X3 = 1.0 - GSPREV3 / VZ3;
+            const float X3 = 1.0 - SAVE->GSPREV3 / SAVE->VZ3;
             //F3408           X4=1.0-GSPREV4/VZ4                                     ! NEW CODE
-            const float X4 = 1.0 - GSPREV4 / VZ4;
+            const float X4 = 1.0 - SAVE->GSPREV4 / SAVE->VZ4;
             //F3409           DEL1=FF1*(X1**XG)/(1.0+0.5*FF1*XG*(X1**(XG-1.0))/VZ1)  ! NEW CODE
-            const float DEL1 = FF1 * pow( X1, ICE->XG ) / ( 1.0 + 0.5 * FF1 * ICE->XG * ( pow( X1, ICE->XG- static_cast<float> (1.0) ) ) / VZ1 ); 
+            const float DEL1 = FF1 * pow( X1, ICE->XG ) / ( 1.0 + 0.5 * FF1 * ICE->XG * ( pow( X1, ICE->XG- static_cast<float> (1.0) ) ) / SAVE->VZ1 ); 
             //F3410           DEL2=FF2*(X2**XG)/(1.0+0.5*FF2*XG*(X2**(XG-1.0))/VZ2)  ! NEW CODE
-            const float DEL2 = FF2 * pow( X2, ICE->XG ) / ( 1.0 + 0.5 * FF2 * ICE->XG * ( pow( X2, ICE->XG- static_cast<float> (1.0) ) ) / VZ2 ); 
+            const float DEL2 = FF2 * pow( X2, ICE->XG ) / ( 1.0 + 0.5 * FF2 * ICE->XG * ( pow( X2, ICE->XG- static_cast<float> (1.0) ) ) / SAVE->VZ2 ); 
             //F3411           DEL3=FF3*(X3**XG)/(1.0+0.5*FF3*XG*(X3**(XG-1.0))/VZ3)  ! NEW CODE
-            const float DEL3 = FF3 * pow( X3, ICE->XG ) / ( 1.0 + 0.5 * FF3 * ICE->XG * ( pow( X3, ICE->XG- static_cast<float> (1.0) ) ) / VZ3 ); 
+            const float DEL3 = FF3 * pow( X3, ICE->XG ) / ( 1.0 + 0.5 * FF3 * ICE->XG * ( pow( X3, ICE->XG- static_cast<float> (1.0) ) ) / SAVE->VZ3 ); 
             //F3412           DEL4=FF4*(X4**XG)/(1.0+0.5*FF4*XG*(X4**(XG-1.0))/VZ4)  ! NEW CODE
-            const float DEL4 = FF4 * pow( X4, ICE->XG ) / ( 1.0 + 0.5 * FF4 * ICE->XG * ( pow( X4, ICE->XG- static_cast<float> (1.0) ) ) / VZ4 ); 
+            const float DEL4 = FF4 * pow( X4, ICE->XG ) / ( 1.0 + 0.5 * FF4 * ICE->XG * ( pow( X4, ICE->XG- static_cast<float> (1.0) ) ) / SAVE->VZ4 ); 
             //F3413           GS1=GSPREV1+DEL1                                       ! NEW CODE
-            GS1 = GSPREV1 + DEL1;
+            GS1 = SAVE->GSPREV1 + DEL1;
             //F3414           GS2=GSPREV2+DEL2                                       ! NEW CODE
-            GS2 = GSPREV2 + DEL2;
+            GS2 = SAVE->GSPREV2 + DEL2;
             //F3415           GS3=GSPREV3+DEL3                                       ! NEW CODE
-            GS3 = GSPREV3 + DEL3;
+            GS3 = SAVE->GSPREV3 + DEL3;
             //F3416           GS4=GSPREV4+DEL4                                       ! NEW CODE
-            GS4 = GSPREV4 + DEL4;
+            GS4 = SAVE->GSPREV4 + DEL4;
             //F3417 !
             //F3418           GSPREV1=GS1                                            ! NEW CODE
-            GSPREV1 = GS1;
+            SAVE->GSPREV1 = GS1;
             //F3419           GSPREV2=GS2                                            ! NEW CODE
-            GSPREV2 = GS2;
+            SAVE->GSPREV2 = GS2;
             //F3420           GSPREV3=GS3                                            ! NEW CODE
-            GSPREV3 = GS3;
+            SAVE->GSPREV3 = GS3;
             //F3421           GSPREV4=GS4                                            ! NEW CODE
-            GSPREV4 = GS4;
+            SAVE->GSPREV4 = GS4;
             //F3422         ELSE                                                     ! NEW CODE
         } else {
             //F3423 !
@@ -716,7 +713,7 @@ void tslcalc( int N, Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS,
         }
         //F3439 !
         //F3440         GREF=GS-GS1990
-        const float GREF = GS - GS1990;
+        const float GREF = GS - SAVE->GS1990;
         //F3441         DGS=0.40*GREF
         float DGS = 0.40 * GREF;
         //F3442         IF(NEWGSIC.EQ.1)DGS=(GS3-GS1)/2.0                        ! NEW CODE
@@ -1060,7 +1057,7 @@ void runmod( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_bl
             AREAS_block* AREAS, QADD_block* QADD, BCOC_block* BCOC, FORCE_block* FORCE, NSIM_block* NSIM,
             OZ_block* OZ, NEWCONCS_block* NEWCONCS, CAR_block* CAR, METH1_block* METH1, METH2_block* METH2, 
             METH3_block* METH3, METH4_block* METH4, TauNitr_block* TauNitr,
-            JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, ICE_block* ICE, std::ofstream* outfile8 )
+            JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS, ICE_block* ICE, SAVE_block* SAVE, std::ofstream* outfile8 )
 {
     //    std::cout << "SUBROUTINE RUNMOD" << endl;    
     f_enter( __func__ );
@@ -1173,7 +1170,7 @@ void runmod( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_bl
                                          NEWCONCS, CARB, TANDSL, CAR,
                                          METH1, FORCE, METH2, METH3,
                                          METH4, TauNitr, Sulph, NSIM, 
-                                         CO2READ, JSTART, CORREN, HALOF, COBS );
+                                         CO2READ, JSTART, CORREN, HALOF, COBS, SAVE );
         //F3738 !
         //F3739 !      ENDIF
         //F3740 !
@@ -2044,7 +2041,7 @@ void runmod( Limits_block* Limits, CLIM_block* CLIM, CONCS_block* CONCS, CARB_bl
         CLIM->KC = int( CLIM->T + 1.01 );
         //F4264       IF(KC.GT.KP)CALL TSLCALC(KC)
         if( CLIM->KC > KP ) tslcalc( CLIM->KC, Limits, CLIM, CONCS, CARB,
-                                    TANDSL, VARW, QSPLIT, ICE, NSIM, outfile8 );
+                                    TANDSL, VARW, QSPLIT, ICE, NSIM, SAVE, outfile8 );
         //F4265 !
         //F4266       IF(T.GE.TEND)RETURN
         //F4267       GO TO  11
@@ -2060,7 +2057,8 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             NEWCONCS_block* NEWCONCS, CARB_block* CARB, TANDSL_block* TANDSL, CAR_block* CAR,
             METH1_block* METH1, FORCE_block* FORCE, METH2_block* METH2, METH3_block* METH3,
             METH4_block* METH4, TauNitr_block* TauNitr, Sulph_block* Sulph, NSIM_block* NSIM, 
-            CO2READ_block* CO2READ, JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS )
+            CO2READ_block* CO2READ, JSTART_block* JSTART, CORREN_block* CORREN, HALOF_block* HALOF, COBS_block* COBS,
+            SAVE_block* SAVE )
 {
     f_enter( __func__ );
     //F4273       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
@@ -2134,7 +2132,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
     //F4341 !
     //F4342       SAVE T00LO,T00MID,T00HI,T00USER
     //F4343 ! sjs -- change to make MAGICC  work. need to save these vars
-    static float T00LO, T00MID, T00HI, T00USER;
+    // These SAVE'd variables are kept in the SAVE block.
     //F4344 
     //F4345 ! sjs -- add storage for halocarbon variables
     //F4346       COMMON /HALOF/QCF4_ar(0:iTp),QC2F6_ar(0:iTp),qSF6_ar(0:iTp), &
@@ -2143,8 +2141,6 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
     //F4349 
     //F4350 ! sjs-- g95 seems to have optomized away these local variables, so put them in common block
     //F4351      COMMON /TEMPSTOR/DQOZPP, DQOZ
-    static float /* DQOZPP,*/ DQOZ = 0.0; // DQOZPP unused
-    static float QOZ1 = 0.0;
     const float fffrac = 0.18;
     float TAUCH4 = 0.0;
     
@@ -2158,7 +2154,6 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
     //F4359 !
     //F4360       QLAND90=-0.2
     const float QLAND90 = -0.2;
-    static float TX=0.0, DELT90=0.0, DELT00=0.0;
     //F4361 !
     //F4362       DO 10 J=IP+1,IC
     for( int J=CLIM->IP+1; J<=CLIM->IC; J++ ) {
@@ -2290,11 +2285,11 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
         //F4448       IF(J.GE.226)THEN
         if( J >= 226 ) {
             //F4449         TX=2.0*TGAV(J-1)-TGAV(J-2)
-            TX = 2.0 * TANDSL->TGAV[ J-1 ] - TANDSL->TGAV[ J-2 ];
+            SAVE->TX = 2.0 * TANDSL->TGAV[ J-1 ] - TANDSL->TGAV[ J-2 ];
             //F4450         IF(J.EQ.226)DELT90=TX
-            if( J == 226 ) DELT90 = TX;
+            if( J == 226 ) SAVE->DELT90 = SAVE->TX;
             //F4451         IF(J.EQ.236)DELT00=TX
-            if( J == 236 ) DELT00 = TX;
+            if( J == 236 ) SAVE->DELT00 = SAVE->TX;
             //F4452       ENDIF
         }
         //F4453 !
@@ -2306,19 +2301,19 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4458         IF(j.eq.jstart+1) then
             if( J == JSTART->JSTART+1 ) {
                 //F4459           t00lo=TAUINIT-DELTAU
-                T00LO = METH3->TAUINIT - METH3->DELTAU;
+                SAVE->T00LO = METH3->TAUINIT - METH3->DELTAU;
                 //F4460           t00mid=TAUINIT
-                T00MID = METH3->TAUINIT;
+                SAVE->T00MID = METH3->TAUINIT;
                 //F4461           t00hi=TAUINIT+DELTAU
-                T00HI = METH3->TAUINIT + METH3->DELTAU;
+                SAVE->T00HI = METH3->TAUINIT + METH3->DELTAU;
                 //F4462           if(LEVCH4.eq.1)t00user=t00lo
-                if( METH2->LEVCH4 == 1 ) T00USER = T00LO;
+                if( METH2->LEVCH4 == 1 ) SAVE->T00USER = SAVE->T00LO;
                 //F4463           if(LEVCH4.eq.2)t00user=t00mid
-                if( METH2->LEVCH4 == 2 ) T00USER = T00MID;
+                if( METH2->LEVCH4 == 2 ) SAVE->T00USER = SAVE->T00MID;
                 //F4464           if(LEVCH4.eq.3)t00user=t00hi
-                if( METH2->LEVCH4 == 3 ) T00USER = T00HI;
+                if( METH2->LEVCH4 == 3 ) SAVE->T00USER = SAVE->T00HI;
                 //F4465           if(LEVCH4.eq.4)t00user=TCH4CON
-                if( METH2->LEVCH4 == 4 ) T00USER = METH3->TCH4CON;
+                if( METH2->LEVCH4 == 4 ) SAVE->T00USER = METH3->TCH4CON;
                 //F4466         ENDIF
             }
             //F4467 !
@@ -2343,7 +2338,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4483 !  ESTIMATED TEMPERATURE CHANGE FROM 2000
             //F4484 !
             //F4485         DELTAT=TX-DELT00
-            const float DELTAT = TX - DELT00;
+            const float DELTAT = SAVE->TX - SAVE->DELT00;
             //F4486 !
             //F4487 !  LOW LIFETIME
             //F4488 !
@@ -2363,7 +2358,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4497         T00LO,TAULO,SSLO,ANOXLO,ACOLO,AVOCLO,DELTAT)
             float TAULO = 0.0;
             methane( METH3->ICH4FEED, METH1->ch4l.getval( J-1 ), EECH4, DENOX, DECO, DEVOC, METH1->ch4l.getptr( J ),
-                    T00LO, &TAULO, SSLO, ANOXLO, ACOLO, AVOCLO, DELTAT, METH4 );
+                    SAVE->T00LO, &TAULO, SSLO, ANOXLO, ACOLO, AVOCLO, DELTAT, METH4 );
             // Note that TAULO has a value return in it, but is never used
             //F4498 !
             //F4499 !  MID (BEST) LIFETIME
@@ -2375,7 +2370,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4504         T00MID,TAUBEST,SCH4,ANOX,ACO,AVOC,DELTAT)
             float TAUBEST = 0.0;
             methane( METH3->ICH4FEED, METH1->ch4b.getval( J-1 ), EECH4, DENOX, DECO, DEVOC, METH1->ch4b.getptr( J ),
-                    T00MID, &TAUBEST, METH3->SCH4, METH3->ANOX, METH3->ACO, METH3->AVOC, DELTAT, METH4 );
+                    SAVE->T00MID, &TAUBEST, METH3->SCH4, METH3->ANOX, METH3->ACO, METH3->AVOC, DELTAT, METH4 );
             // Note that TAUBEST has a value return in it, but is never used
             //F4505 !
             //F4506 !  HIGH LIFETIME
@@ -2396,7 +2391,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4516         T00HI,TAUHI,SSHI,ANOXHI,ACOHI,AVOCHI,DELTAT)
             float TAUHI = 0.0;
             methane( METH3->ICH4FEED, METH1->ch4h.getval( J-1 ), EECH4, DENOX, DECO, DEVOC, METH1->ch4h.getptr( J ),
-                    T00HI, &TAUHI, SSHI, ANOXHI, ACOHI, AVOCHI, DELTAT, METH4 );
+                    SAVE->T00HI, &TAUHI, SSHI, ANOXHI, ACOHI, AVOCHI, DELTAT, METH4 );
             // Note that TAUHI has a value return in it, but is never used
             //F4517 !
             //F4518 !  USER LIFETIME (ONE OF ABOVE, OR CONSTANT AT SPECIFIED 1990 VALUE)
@@ -2460,7 +2455,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4553         T00USER,TAUCH4,SSUSER,ANOXUSER,ACOUSER,AVOCUSER,DELTAT)
             TAUCH4 = 0.0;
             methane( METH3->ICH4FEED, CONCS->CH4[ J-1 ], EECH4, DENOX, DECO, DEVOC, &CONCS->CH4[ J ],
-                    T00USER, &TAUCH4, SSUSER, ANOXUSER, ACOUSER, AVOCUSER, DELTAT, METH4 );
+                    SAVE->T00USER, &TAUCH4, SSUSER, ANOXUSER, ACOUSER, AVOCUSER, DELTAT, METH4 );
             //F4554 !
             //F4555 !  SAVE USER-MODEL METHANE LIFETIME. TCH4(J) = CHEMICAL (OH)
             //F4556 !   LIFETIME. THIS IS THE SAME AS ......
@@ -2664,7 +2659,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
                 //F4694 !  Note: this also applies to the methane model.
                 //F4695 !
                 //F4696         TEMP=TX-DELT90
-                const float TEMP = TX - DELT90;
+                const float TEMP = SAVE->TX - SAVE->DELT90;
                 //F4697 !
                 //F4698         CALL CARBON(NC,TEMP,EF4(J),EDNET(J),CCO2(NC,J-3),CCO2(NC,J-2), &
                 //F4699         CCO2(NC,J-1), &
@@ -2676,7 +2671,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
                        CARB->PL.getval( NC, J-1 ), CARB->HL.getval( NC, J-1 ), CARB->SOIL.getval( NC, J-1 ),  CARB->REGROW.getval( NC, J-1 ),  CARB->ETOT.getval( NC, J-1 ),
                        CARB->PL.getptr( NC, J ), CARB->HL.getptr( NC, J ), CARB->SOIL.getptr( NC, J ),  CARB->REGROW.getptr( NC, J ),  CARB->ETOT.getptr( NC, J ),
                        CARB->ESUM.getptr( J ), CARB->FOC.getptr( NC, J ), CAR->DELMASS.getptr( NC, J ), CARB->EDGROSS.getptr( NC, J ), CARB->CCO2.getptr( NC, J ),
-                       CAR );
+                       CAR, SAVE );
                 //F4703 !
                 //F4704   444   CONTINUE
             } // for
@@ -2840,9 +2835,9 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             //F4823         QOZ(J)=QREF*(FOSSHIST(J)-FOSS0)/(FOSSHIST(235)-FOSS0)
             TANDSL->QOZ[ J ] = QREF * ( JSTART->FOSSHIST[ J ] - FOSS0 ) / ( JSTART->FOSSHIST[ 235 ] - FOSS0 );
             //F4824         IF(J.EQ.234)QOZ1=QOZ(J)
-            if( J == 234 ) QOZ1 = TANDSL->QOZ[ J ];
+            if( J == 234 ) SAVE->QOZ1 = TANDSL->QOZ[ J ];
             //F4825         IF(J.EQ.235)DQOZ=QOZ(J)-QOZ1
-            if( J == 235 ) DQOZ = TANDSL->QOZ[ J ] - QOZ1;
+            if( J == 235 ) SAVE->DQOZ = TANDSL->QOZ[ J ] - SAVE->QOZ1;
             //F4826       ELSE
         } else {
             //F4827         DDEN=ENOX(J)-ENOX(236)
@@ -2853,7 +2848,7 @@ void deltaq( Limits_block* Limits, OZ_block* OZ, CLIM_block* CLIM, CONCS_block*
             const float DDEV = CONCS->EVOC.getval( J ) - CONCS->EVOC.getval( 236 );
             //F4830         QOZ(J)=QREF+DQOZ &
             //F4831         +TROZSENS*(OZNOX*DDEN+OZCO*DDEC+OZVOC*DDEV)
-            TANDSL->QOZ[ J ] = QREF + DQOZ + JSTART->TROZSENS * ( OZ->OZNOX * DDEN + OZ->OZCO * DDEC + OZ->OZVOC * DDEV );
+            TANDSL->QOZ[ J ] = QREF + SAVE->DQOZ + JSTART->TROZSENS * ( OZ->OZNOX * DDEN + OZ->OZCO * DDEC + OZ->OZVOC * DDEV );
             //F4832       ENDIF
         }
         //F4833 !
@@ -3511,7 +3506,7 @@ void carbon( const int MM, float TEM, float EFOSS, float ENETDEF, float CPP, flo
             float PL, float HU, float SO, float REGRO, float ETOT,
             float* PL1, float* HU1, float* SO1, float* REGRO1, float* ETOT1,
             float* SUMEM1, float* FLUX, float* DELM, float* EGROSSD, float* C1,
-            CAR_block* CAR )
+            CAR_block* CAR, SAVE_block* SAVE )
 {
     f_enter( __func__ );
     //F5283       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
@@ -3699,8 +3694,8 @@ void carbon( const int MM, float TEM, float EFOSS, float ENETDEF, float CPP, flo
     //F5406       SUMEM1=EFOSS-DELB
     *SUMEM1 = EFOSS - DELB;
     //F5407       FLUX=SUMEM1-FACTOR*DELC
-    static float DELC = 0.0;    // this is exceedingly weird -- a static var -- see note in documentation
-    *FLUX = *SUMEM1 - CAR->FACTOR * DELC;
+    // These SAVE'd variables are kept in the SAVE block.
+    *FLUX = *SUMEM1 - CAR->FACTOR * SAVE->DELC;
     //F5408       IF(TOTEM.EQ.1)ETOT1=ETOT+SUMEM1
     if( CAR->TOTEM == 1 ) *ETOT1 = ETOT + *SUMEM1;
     //F5409       IF(TOTEM.NE.1)ETOT1=ETOT+EFOSS+EGROSSD
@@ -3874,7 +3869,7 @@ void carbon( const int MM, float TEM, float EFOSS, float ENETDEF, float CPP, flo
     //F5506 !  CALCULATE NEW PARTIAL CONCS AND NEW CONCENTRATION.
     //F5507 !
     //F5508       DELC=0.0
-    DELC = 0.0;
+    SAVE->DELC = 0.0;
     //F5509       DO J=1,5
     for( int J=1; J<=5; J++ ) {
         //F5510       DELA=A1(MM,J)-AA(MM,J)
@@ -3888,15 +3883,15 @@ void carbon( const int MM, float TEM, float EFOSS, float ENETDEF, float CPP, flo
         //F5514       CPART(MM,J)=CPART(MM,J)+DEL
         CAR->CPART[ MM ][ J ] += DEL;
         //F5515       DELC=DELC+DEL
-        DELC += DEL;
+        SAVE->DELC += DEL;
         //F5516       FLUX=SUMEM1-FACTOR*DELC
-        *FLUX = *SUMEM1 - CAR->FACTOR * DELC;
+        *FLUX = *SUMEM1 - CAR->FACTOR * SAVE->DELC;
         //F5517       AA(MM,J)=A1(MM,J)
         CAR->AA.setval( A1[ MM ][ J ], MM, J );
         //F5518       END DO
     }
     //F5519       C1=C+DELC
-    *C1 = C + DELC;
+    *C1 = C + SAVE->DELC;
     //F5520       CBAR=(C1+C)/2.0
     CBAR = ( *C1 + C ) / 2.0;
     //F5521 !
@@ -4791,84 +4786,60 @@ void lamcalc( float Q, float FNHL, float FSHL, float XK, float XKH, float DT2X,
 //F6117 
 
 /*  These functions are called by MAGICC and need a way to extract values from data structures.
- For now, we use some globals that are initialized with a call from CLIMAT.
+ These are kept in the MAGICC_state which is filled in with a call from CLIMAT.
  */
 
 /* Fundamental difference from Fortran: we're going to get call by GCAM w/o
- CLIMAT having initialized things first. So take care of it here. */
-CARB_block* G_CARB = new CARB_block;
-TANDSL_block* G_TANDSL = new TANDSL_block;
-CONCS_block* G_CONCS = new CONCS_block;
-NEWCONCS_block* G_NEWCONCS = new NEWCONCS_block;
-STOREDVALS_block* G_STOREDVALS = new STOREDVALS_block;
-METH1_block* G_METH1 = new METH1_block;
-CAR_block* G_CAR = new CAR_block;
-FORCE_block* G_FORCE = new FORCE_block;
-JSTART_block* G_JSTART = new JSTART_block;
-QADD_block* G_QADD = new QADD_block;
-HALOF_block* G_HALOF = new HALOF_block;
-NEWPARAMS_block* G_NEWPARAMS = new NEWPARAMS_block;
-BCOC_block* G_BCOC = new BCOC_block;
-string G_GAS_EMK_DATA;
+ CLIMAT having initialized things first. So the state owner creates it up front. */
+MAGICC_state::MAGICC_state():
+SAVE()
+{
+}
 
 
 
 
-void setLocals( CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
+void setLocals( const MAGICC_state* STATE, CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
                 STOREDVALS_block* STOREDVALS, NEWPARAMS_block* NEWPARAMS, BCOC_block* BCOC, 
                 METH1_block* METH1, CAR_block* CAR, FORCE_block* FORCE, JSTART_block* JSTART,
                 QADD_block* QADD, HALOF_block* HALOF, string& GAS_EMK_DATA )
 {
     f_enter( __func__ );
-/*    G_CARB = CARB;
-    G_TANDSL = TANDSL;
-    G_CONCS = CONCS;
-    G_NEWCONCS = NEWCONCS;
-    G_STOREDVALS = STOREDVALS; */
-    *NEWPARAMS = *G_NEWPARAMS;
-    *BCOC = *G_BCOC;
-/*    G_METH1 = METH1;
-    G_CAR = CAR;
-    G_FORCE = FORCE;
-    G_JSTART = JSTART;
-    G_QADD = QADD;
-    G_HALOF = HALOF; */
-    GAS_EMK_DATA = G_GAS_EMK_DATA;
+    *NEWPARAMS = STATE->NEWPARAMS;
+    *BCOC = STATE->BCOC;
+    GAS_EMK_DATA = STATE->GAS_EMK_DATA;
     f_exit( __func__ );
 }
 
-void setGlobals( CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
+void setGlobals( MAGICC_state* STATE, CARB_block* CARB, TANDSL_block* TANDSL, CONCS_block* CONCS, NEWCONCS_block* NEWCONCS, 
                STOREDVALS_block* STOREDVALS, NEWPARAMS_block* NEWPARAMS, BCOC_block* BCOC, 
                METH1_block* METH1, CAR_block* CAR, FORCE_block* FORCE, JSTART_block* JSTART,
                QADD_block* QADD, HALOF_block* HALOF, string& GAS_EMK_DATA )
 {
     f_enter( __func__ );
-    *G_CARB = *CARB;
-     *G_TANDSL = *TANDSL;
-     *G_CONCS = *CONCS;
-     *G_NEWCONCS = *NEWCONCS;
-     *G_STOREDVALS = *STOREDVALS;
-    *G_NEWPARAMS = *NEWPARAMS;
-    *G_BCOC = *BCOC;
-    *G_METH1 = *METH1;
-     *G_CAR = *CAR;
-     *G_FORCE = *FORCE;
-     *G_JSTART = *JSTART;
-     *G_QADD = *QADD;
-     *G_HALOF = *HALOF;
-     G_GAS_EMK_DATA = GAS_EMK_DATA;
+    STATE->CARB = *CARB;
+     STATE->TANDSL = *TANDSL;
+     STATE->CONCS = *CONCS;
+     STATE->NEWCONCS = *NEWCONCS;
+     STATE->STOREDVALS = *STOREDVALS;
+    STATE->NEWPARAMS = *NEWPARAMS;
+    STATE->BCOC = *BCOC;
+    STATE->METH1 = *METH1;
+     STATE->CAR = *CAR;
+     STATE->FORCE = *FORCE;
+     STATE->JSTART = *JSTART;
+     STATE->QADD = *QADD;
+     STATE->HALOF = *HALOF;
+     STATE->GAS_EMK_DATA = GAS_EMK_DATA;
     f_exit( __func__ );
 }
 
 
 //F6118       FUNCTION getCO2Conc( inYear )
-float getCO2Conc( int inYear )
+float getCO2Conc( const MAGICC_state* STATE, int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     //F6119       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6120 ! Expose subroutine co2Conc to users of this DLL
     //F6121 !DEC$ATTRIBUTES DLLEXPORT::getCO2Conc
@@ -4886,7 +4857,7 @@ float getCO2Conc( int inYear )
     const int IYR = inYear - 1990 + 226;
     //F6133 
     //F6134       getCO2Conc = CO2( IYR )
-    return( G_CARB->CO2[ IYR ] );
+    return( STATE->CARB.CO2[ IYR ] );
     //F6135 
     //F6136       RETURN 
     //F6137 	  END
@@ -4894,13 +4865,10 @@ float getCO2Conc( int inYear )
 }
 //F6138 	    
 //F6139       FUNCTION getSLR( inYear )
-float getSLR( const int inYear )
+float getSLR( const MAGICC_state* STATE, const int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     //F6140       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6141 ! Expose subroutine co2Conc to users of this DLL
     //F6142 !DEC$ATTRIBUTES DLLEXPORT::getCO2Conc
@@ -4919,9 +4887,9 @@ float getSLR( const int inYear )
     //F6155       IYR = inYear-1990+226
     const int IYR = inYear - 1990 + 226;
     //F6156       ST1=SLT(IYR)
-    const float ST1 = G_TANDSL->SLT[ IYR ];
+    const float ST1 = STATE->TANDSL.SLT[ IYR ];
     //F6157       SO1=SLO(IYR)
-    const float SO1 = G_TANDSL->SLO[ IYR ];
+    const float SO1 = STATE->TANDSL.SLO[ IYR ];
     //F6158       SLRAW1=ST1-SO1
     const float SLRAW1 = ST1 - SO1;
     //F6159 
@@ -4934,13 +4902,10 @@ float getSLR( const int inYear )
 }
 //F6164 
 //F6165       FUNCTION getGHGConc( ghgNumber, inYear )
-float GETGHGCONC( int ghgNumber, int inYear )
+float GETGHGCONC( const MAGICC_state* STATE, int ghgNumber, int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     //F6166       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6167 ! Expose subroutine ghgConc to users of this DLL
     //F6168 !DEC$ATTRIBUTES DLLEXPORT::getGHGConc
@@ -4974,27 +4939,27 @@ float GETGHGCONC( int ghgNumber, int inYear )
     //F6194       select case (ghgNumber)
     switch( ghgNumber ) {
             //F6195       case(1); getGHGConc = CO2( IYR )
-        case 1: returnValue = G_CARB->CO2[ IYR ]; break;
+        case 1: returnValue = STATE->CARB.CO2[ IYR ]; break;
             //F6196       case(2); getGHGConc = CH4( IYR )
-        case 2: returnValue = G_CONCS->CH4[ IYR ]; break;
+        case 2: returnValue = STATE->CONCS.CH4[ IYR ]; break;
             //F6197       case(3); getGHGConc = CN2O( IYR )
-        case 3: returnValue = G_CONCS->CN2O[ IYR ]; break;
+        case 3: returnValue = STATE->CONCS.CN2O[ IYR ]; break;
             //F6198       case(4); getGHGConc = C2F6( IYR )
-        case 4: returnValue = G_NEWCONCS->C2F6[ IYR ]; break;
+        case 4: returnValue = STATE->NEWCONCS.C2F6[ IYR ]; break;
             //F6199       case(5); getGHGConc = C125( IYR )
-        case 5: returnValue = G_NEWCONCS->C125[ IYR ]; break;
+        case 5: returnValue = STATE->NEWCONCS.C125[ IYR ]; break;
             //F6200       case(6); getGHGConc = C134A( IYR )
-        case 6: returnValue = G_NEWCONCS->C134A[ IYR ]; break;
+        case 6: returnValue = STATE->NEWCONCS.C134A[ IYR ]; break;
             //F6201       case(7); getGHGConc = C143A( IYR )
-        case 7: returnValue = G_NEWCONCS->C143A[ IYR ]; break;
+        case 7: returnValue = STATE->NEWCONCS.C143A[ IYR ]; break;
             //F6202       case(8); getGHGConc = C245( IYR )
-        case 8: returnValue = G_NEWCONCS->C245[ IYR ]; break;
+        case 8: returnValue = STATE->NEWCONCS.C245[ IYR ]; break;
             //F6203       case(9); getGHGConc = CSF6( IYR )
-        case 9: returnValue = G_NEWCONCS->CSF6[ IYR ]; break;
+        case 9: returnValue = STATE->NEWCONCS.CSF6[ IYR ]; break;
             //F6204       case(10); getGHGConc = CF4( IYR )
-        case 10: returnValue = G_NEWCONCS->CF4[ IYR ]; break;
+        case 10: returnValue = STATE->NEWCONCS.CF4[ IYR ]; break;
             //F6205       case(11); getGHGConc = C227( IYR )
-        case 11: returnValue = G_NEWCONCS->C227[ IYR ]; break;
+        case 11: returnValue = STATE->NEWCONCS.C227[ IYR ]; break;
             //F6206       case default; getGHGConc = -1.0
         default: returnValue = std::numeric_limits<float>::max();
                 cerr << __func__ << " undefined gas " << ghgNumber << flush;
@@ -5010,13 +4975,10 @@ float GETGHGCONC( int ghgNumber, int inYear )
 //F6212 	  
 //F6213 ! Returns mid-year forcing for a given gas
 //F6214       FUNCTION getForcing( iGasNumber, inYear )
-float GETFORCING( const int iGasNumber, const int inYear )
+float GETFORCING( const MAGICC_state* STATE, const int iGasNumber, const int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     //F6215       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6216 ! Expose subroutine getForcing to users of this DLL
     //F6217 !DEC$ATTRIBUTES DLLEXPORT::getForcing
@@ -5068,17 +5030,17 @@ float GETFORCING( const int iGasNumber, const int inYear )
     //F6258       
     //F6259 ! Calculate mid-year forcing components
     //F6260         QQQCO2 = (QCO2(IYR)+QCO2(IYRP))/2.
-    const float QQQCO2 = ( G_FORCE->QCO2[ IYR ] + G_FORCE->QCO2[ IYRP ] ) / 2.0;
+    const float QQQCO2 = ( STATE->FORCE.QCO2[ IYR ] + STATE->FORCE.QCO2[ IYRP ] ) / 2.0;
     //F6261         QQQM   = (QM(IYR)+QM(IYRP))/2.
-    /* const */ float QQQM = ( G_FORCE->QM[ IYR ] + G_FORCE->QM[ IYRP ] ) / 2.0;
+    /* const */ float QQQM = ( STATE->FORCE.QM[ IYR ] + STATE->FORCE.QM[ IYRP ] ) / 2.0;
     //F6262         QQQN   = (QN(IYR)+QN(IYRP))/2.
-    const float QQQN = ( G_FORCE->QN[ IYR ] + G_FORCE->QN[ IYRP ] ) / 2.0;
+    const float QQQN = ( STATE->FORCE.QN[ IYR ] + STATE->FORCE.QN[ IYRP ] ) / 2.0;
     //F6263         QQQCFC = (QCFC(IYR)+QCFC(IYRP))/2.
-    const float QQQCFC = ( G_FORCE->QCFC[ IYR ] + G_FORCE->QCFC[ IYRP ] ) / 2.0;
+    const float QQQCFC = ( STATE->FORCE.QCFC[ IYR ] + STATE->FORCE.QCFC[ IYRP ] ) / 2.0;
     //F6264         QQQOZ  = (QOZ(IYR)+QOZ(IYRP))/2.
-    /* const */ float QQQOZ = ( G_TANDSL->QOZ[ IYR ] + G_TANDSL->QOZ[ IYRP ] ) / 2.0;
+    /* const */ float QQQOZ = ( STATE->TANDSL.QOZ[ IYR ] + STATE->TANDSL.QOZ[ IYRP ] ) / 2.0;
     //F6265         QQQFOCR  = (QFOC(IYR)     +QFOC(IYRP))     /2.
-    const float QQQFOCR = ( G_JSTART->QFOC[ IYR ] + G_JSTART->QFOC[ IYRP ] ) / 2.0;
+    const float QQQFOCR = ( STATE->JSTART.QFOC[ IYR ] + STATE->JSTART.QFOC[ IYRP ] ) / 2.0;
     //F6266 
     //F6267         QQQSO2 = 0.0
     float QQQSO2 = 0.0;
@@ -5087,15 +5049,15 @@ float GETFORCING( const int iGasNumber, const int inYear )
     //F6269         IF(inYear.GT.1860)THEN
     if( inYear > 1860 ) {
         //F6270           QQQSO2 = (QSO2SAVE(IYR)+QSO2SAVE(IYRP))/2.
-        QQQSO2 = ( G_STOREDVALS->QSO2SAVE[ IYR ] + G_STOREDVALS->QSO2SAVE[ IYRP ] ) / 2.0;
+        QQQSO2 = ( STATE->STOREDVALS.QSO2SAVE[ IYR ] + STATE->STOREDVALS.QSO2SAVE[ IYRP ] ) / 2.0;
         //F6271           QQQDIR = (QDIRSAVE(IYR)+QDIRSAVE(IYRP))/2.
-        QQQDIR = ( G_STOREDVALS->QDIRSAVE[ IYR ] + G_STOREDVALS->QDIRSAVE[ IYRP ] ) / 2.0;
+        QQQDIR = ( STATE->STOREDVALS.QDIRSAVE[ IYR ] + STATE->STOREDVALS.QDIRSAVE[ IYRP ] ) / 2.0;
         //F6272         ENDIF
     }
     //F6273          QQQIND = QQQSO2-QQQDIR
     //UNUSED const float QQQIND = QQQSO2 - QQQDIR;
     //F6274          DELQFOC = (QFOC(IYR)+QFOC(IYRP))/2.-QQQFOCR
-    const float DELQFOC = ( G_JSTART->QFOC[ IYR ] + G_JSTART->QFOC[ IYRP ] ) / 2.0;
+    const float DELQFOC = ( STATE->JSTART.QFOC[ IYR ] + STATE->JSTART.QFOC[ IYRP ] ) / 2.0;
     //F6275 !
     //F6276          QQQCO2 = (QCO2(IYR)+QCO2(IYRP))/2.
     //UNNECESSARY const float QQQCO2 = ( FORCE->QCO2[ IYR ] + FORCE->QCO2[ IYRP ] ) / 2.0;
@@ -5110,28 +5072,28 @@ float GETFORCING( const int iGasNumber, const int inYear )
     //F6281          QQQFOC = (QFOC(IYR)+QFOC(IYRP))/2.
     //UNNECESSARY const float QQQFOC = ( JSTART->QFOC[ M00 ] + JSTART->QFOC[ M01 ] ) / 2.0;
     //F6282          QQQMN  = (QMN(IYR)+QMN(IYRP))/2.
-    const float QQQMN = ( G_TANDSL->QMN[ IYR ] + G_TANDSL->QMN[ IYRP ] ) / 2.0;
+    const float QQQMN = ( STATE->TANDSL.QMN[ IYR ] + STATE->TANDSL.QMN[ IYRP ] ) / 2.0;
     //F6283          
     //F6284          QQQEXTRA = ( QEXNH(IYR)+QEXSH(IYR)+QEXNHO(IYR)+QEXNHL(IYR) + &
     //F6285                       QEXNH(IYRP)+QEXSH(IYRP)+QEXNHO(IYRP)+QEXNHL(IYRP) )/2.
-    float QQQEXTRA = ( G_QADD->QEXNH[ IYR ] + G_QADD->QEXSH[ IYR ] + G_QADD->QEXNHO[ IYR ] + G_QADD->QEXNHL[ IYR ] + 
-                      G_QADD->QEXNH[ IYRP ] + G_QADD->QEXSH[ IYRP ] + G_QADD->QEXNHO[ IYRP ] + G_QADD->QEXNHL[ IYRP ]  ) / 2.0;
+    float QQQEXTRA = ( STATE->QADD.QEXNH[ IYR ] + STATE->QADD.QEXSH[ IYR ] + STATE->QADD.QEXNHO[ IYR ] + STATE->QADD.QEXNHL[ IYR ] + 
+                      STATE->QADD.QEXNH[ IYRP ] + STATE->QADD.QEXSH[ IYRP ] + STATE->QADD.QEXNHO[ IYRP ] + STATE->QADD.QEXNHL[ IYRP ]  ) / 2.0;
     //F6286 !
     //F6287 ! NOTE SPECIAL CASE FOR QOZ BECAUSE OF NONLINEAR CHANGE OVER 1990
     //F6288 !
     //F6289          IF(IYR.EQ.226)QQQOZ=QOZ(IYR)
-    if( IYR == 226 ) QQQOZ = G_TANDSL->QOZ[ IYR ];
+    if( IYR == 226 ) QQQOZ = STATE->TANDSL.QOZ[ IYR ];
     //F6290 !
     //F6291          QQQLAND= (QLAND(IYR)+QLAND(IYRP))/2.
-    const float QQQLAND = ( G_TANDSL->QLAND[ IYR ] + G_TANDSL->QLAND[ IYRP ] ) / 2.0;
+    const float QQQLAND = ( STATE->TANDSL.QLAND[ IYR ] + STATE->TANDSL.QLAND[ IYRP ] ) / 2.0;
     //F6292          QQQBIO = (QBIO(IYR)+QBIO(IYRP))/2.
-    const float QQQBIO = ( G_TANDSL->QBIO[ IYR ] + G_TANDSL->QBIO[ IYRP ] ) / 2.0;
+    const float QQQBIO = ( STATE->TANDSL.QBIO[ IYR ] + STATE->TANDSL.QBIO[ IYRP ] ) / 2.0;
     //F6293          QQQTOT = QQQCO2+QQQM+QQQN+QQQCFC+QQQSO2+QQQBIO+QQQOZ+QQQLAND &
     //F6294          +QQQMN
     float QQQTOT = QQQCO2 + QQQM + QQQN + QQQCFC + QQQSO2 + QQQBIO + QQQOZ + QQQLAND + QQQMN;
     //F6295 !
     //F6296          QQCH4O3= (QCH4O3(IYR)+QCH4O3(IYRP))/2.
-    const float QQCH4O3 = ( G_FORCE->QCH4O3[ IYR ] + G_FORCE->QCH4O3[ IYRP ] ) / 2.0;
+    const float QQCH4O3 = ( STATE->FORCE.QCH4O3[ IYR ] + STATE->FORCE.QCH4O3[ IYRP ] ) / 2.0;
     //F6297          QQQM   = QQQM-QQCH4O3
     QQQM -= QQCH4O3;
     //F6298          QQQOZ  = QQQOZ+QQCH4O3
@@ -5140,26 +5102,26 @@ float GETFORCING( const int iGasNumber, const int inYear )
     //UNUSED const float QQQD = QQQDIR - QQQFOCR;    //CHANGE since QQQFOC = QQQFOCR
     //F6300  
     //F6301          QQQSTROZ= (QSTRATOZ(IYR)+QSTRATOZ(IYRP))/2.
-    float QQQSTROZ = ( G_FORCE->QSTRATOZ[ IYR ] + G_FORCE->QSTRATOZ[ IYRP ] ) / 2.0;
+    float QQQSTROZ = ( STATE->FORCE.QSTRATOZ[ IYR ] + STATE->FORCE.QSTRATOZ[ IYRP ] ) / 2.0;
     //F6302          IF(IO3FEED.EQ.0)QQQSTROZ=0.0 
-    if( G_METH1->IO3FEED == 0 ) QQQSTROZ = 0.0;
+    if( STATE->METH1.IO3FEED == 0 ) QQQSTROZ = 0.0;
     //F6303 !
     //F6304          QQQKYMAG = (QKYMAG(IYR)+QKYMAG(IYRP))/2.
     //UNUSED const float QQQKYMAG = ( JSTART->QKYMAG[ IYR ] + JSTART->QKYMAG[ IYRP ] ) / 2.0;
     //F6305          QQQMONT  = (QMONT(IYR) +QMONT(IYRP)) /2.
-    const float QQQMONT = ( G_FORCE->QMONT[ IYR ] + G_FORCE->QMONT[ IYRP ] ) / 2.0;
+    const float QQQMONT = ( STATE->FORCE.QMONT[ IYR ] + STATE->FORCE.QMONT[ IYRP ] ) / 2.0;
     //F6306          QQQOTHER = (QOTHER(IYR)+QOTHER(IYRP))/2.
-    const float QQQOTHER = ( G_FORCE->QOTHER[ IYR ] + G_FORCE->QOTHER[ IYRP ] ) / 2.0;
+    const float QQQOTHER = ( STATE->FORCE.QOTHER[ IYR ] + STATE->FORCE.QOTHER[ IYRP ] ) / 2.0;
     //F6307          QQQKYOTO = QQQKYMAG+QQQOTHER
     //UNUSED const float QQQKYOTO = QQQKYMAG + QQQOTHER;
     //F6308 !
     //F6309          QQQStratCH4H2O = (QCH4H2O(IYR)+QCH4H2O(IYRP))/2.	! Strat H2O forcing from CH4
-    const float QQQStratCH4H2O = ( G_FORCE->QCH4H2O[ IYR ] + G_FORCE->QCH4H2O[ IYRP ] ) / 2.0;
+    const float QQQStratCH4H2O = ( STATE->FORCE.QCH4H2O[ IYR ] + STATE->FORCE.QCH4H2O[ IYRP ] ) / 2.0;
     //F6310 
     //F6311          QQQBC = ( QBC(IYR) + QBC(IYRP) )/2.
-    const float QQQBC = ( G_FORCE->QBC[ IYR ] + G_FORCE->QBC[ IYRP ] ) / 2.0;
+    const float QQQBC = ( STATE->FORCE.QBC[ IYR ] + STATE->FORCE.QBC[ IYRP ] ) / 2.0;
     //F6312          QQQOC = ( QOC(IYR) + QOC(IYRP) )/2.
-    const float QQQOC = ( G_FORCE->QOC[ IYR ] + G_FORCE->QOC[ IYRP ] ) / 2.0;
+    const float QQQOC = ( STATE->FORCE.QOC[ IYR ] + STATE->FORCE.QOC[ IYRP ] ) / 2.0;
     //F6313  
     //F6314  	     QQQTOT = QQQTOT + QQQBC + QQQOC
     QQQTOT += ( QQQBC + QQQOC );
@@ -5175,25 +5137,25 @@ float GETFORCING( const int iGasNumber, const int inYear )
             //F6320       case(1); getForcing = (QCO2(IYR)+QCO2(IYRP))/2.
         case 1: returnValue = QQQCO2;  break; //CHANGE  why recalculate this?
             //F6321       case(2); getForcing = (qm(IYR)+qm(IYRP))/2. - QQQStratCH4H2O - QQCH4O3! CH4 forcing, subtract indirect components so are just reporting just CH4 forcing
-        case 2: returnValue = ( G_FORCE->QM[ IYR ] + G_FORCE->QM[ IYRP ] ) / 2.0 - QQQStratCH4H2O - QQCH4O3;  break;
+        case 2: returnValue = ( STATE->FORCE.QM[ IYR ] + STATE->FORCE.QM[ IYRP ] ) / 2.0 - QQQStratCH4H2O - QQCH4O3;  break;
             //F6322       case(3); getForcing = (qn(IYR)+qn(IYRP))/2.  ! N2O forcing
         case 3: returnValue = QQQN; break; //CHANGE  why recalculate this?
             //F6323       case(4); getForcing = (QC2F6_ar(IYR)+QC2F6_ar(IYRP))/2.
-        case 4: returnValue = ( G_HALOF->QC2F6_ar[ IYR ] + G_HALOF->QC2F6_ar[ IYRP ] ) / 2.0; break;
+        case 4: returnValue = ( STATE->HALOF.QC2F6_ar[ IYR ] + STATE->HALOF.QC2F6_ar[ IYRP ] ) / 2.0; break;
             //F6324       case(5); getForcing = (Q125_ar(IYR)+Q125_ar(IYRP))/2.
-        case 5: returnValue = ( G_HALOF->Q125_ar[ IYR ] + G_HALOF->Q125_ar[ IYRP ] ) / 2.0; break;
+        case 5: returnValue = ( STATE->HALOF.Q125_ar[ IYR ] + STATE->HALOF.Q125_ar[ IYRP ] ) / 2.0; break;
             //F6325       case(6); getForcing = (Q134A_ar(IYR)+Q134A_ar(IYRP))/2.
-        case 6: returnValue = ( G_HALOF->Q134A_ar[ IYR ] + G_HALOF->Q134A_ar[ IYRP ] ) / 2.0; break;
+        case 6: returnValue = ( STATE->HALOF.Q134A_ar[ IYR ] + STATE->HALOF.Q134A_ar[ IYRP ] ) / 2.0; break;
             //F6326       case(7); getForcing = (Q143A_ar(IYR)+Q143A_ar(IYRP))/2.
-        case 7: returnValue = ( G_HALOF->Q143A_ar[ IYR ] + G_HALOF->Q143A_ar[ IYRP ] ) / 2.0; break;
+        case 7: returnValue = ( STATE->HALOF.Q143A_ar[ IYR ] + STATE->HALOF.Q143A_ar[ IYRP ] ) / 2.0; break;
             //F6327       case(8); getForcing = (Q245_ar(IYR)+Q245_ar(IYRP))/2.
-        case 8: returnValue = ( G_HALOF->Q245_ar[ IYR ] + G_HALOF->Q245_ar[ IYRP ] ) / 2.0; break;
+        case 8: returnValue = ( STATE->HALOF.Q245_ar[ IYR ] + STATE->HALOF.Q245_ar[ IYRP ] ) / 2.0; break;
             //F6328       case(9); getForcing = (qSF6_ar(IYR)+qSF6_ar(IYRP))/2.
-        case 9: returnValue = ( G_HALOF->qSF6_ar[ IYR ] + G_HALOF->qSF6_ar[ IYRP ] ) / 2.0; break;
+        case 9: returnValue = ( STATE->HALOF.qSF6_ar[ IYR ] + STATE->HALOF.qSF6_ar[ IYRP ] ) / 2.0; break;
             //F6329       case(10); getForcing = (QCF4_ar(IYR)+QCF4_ar(IYRP))/2.
-        case 10: returnValue = ( G_HALOF->QCF4_ar[ IYR ] + G_HALOF->QCF4_ar[ IYRP ] ) / 2.0; break;
+        case 10: returnValue = ( STATE->HALOF.QCF4_ar[ IYR ] + STATE->HALOF.QCF4_ar[ IYRP ] ) / 2.0; break;
             //F6330       case(11); getForcing = (Q227_ar(IYR)+Q227_ar(IYRP))/2.
-        case 11: returnValue = ( G_HALOF->Q227_ar[ IYR ] + G_HALOF->Q227_ar[ IYRP ] ) / 2.0; break;
+        case 11: returnValue = ( STATE->HALOF.Q227_ar[ IYR ] + STATE->HALOF.Q227_ar[ IYRP ] ) / 2.0; break;
             //F6331       case(12); getForcing = (QOTHER(IYR)+QOTHER(IYRP))/2.	! Other halo forcing (exogenous input)
         case 12: returnValue = QQQOTHER; break; //CHANGE  why recalculate this?
             //F6332       case(13); getForcing = QQQSO2 - DELQFOC ! Total SO2 forcing. Note QSO2 and QDIR includes FOC
@@ -5213,7 +5175,7 @@ float GETFORCING( const int iGasNumber, const int inYear )
             //F6339       case(20); getForcing = QQQBIO  ! MAGICC biomass burning aerosol forcing
         case 20: returnValue = QQQBIO; break;
             //F6340       case(21); getForcing = (QFOC(IYR)+QFOC(IYRP))/2. ! MAGICC internal fossil BC+OC
-        case 21: returnValue = ( G_JSTART->QFOC[ IYR ] + G_JSTART->QFOC[ IYRP ] ) / 2.0; break;
+        case 21: returnValue = ( STATE->JSTART.QFOC[ IYR ] + STATE->JSTART.QFOC[ IYRP ] ) / 2.0; break;
             //F6341       case(22); getForcing = QQQLAND ! Land Surface Albedo forcing
         case 22: returnValue = QQQLAND; break;
             //F6342       case(23); getForcing = QQQMN	! Mineral and nitrous oxide aerosol forcing
@@ -5243,13 +5205,10 @@ float GETFORCING( const int iGasNumber, const int inYear )
 }
 //F6354 	  
 //F6355       FUNCTION getGMTemp( inYear )
-float GETGMTEMP( int inYear )
+float GETGMTEMP( const MAGICC_state* STATE, int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     //F6356       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6357 ! Expose subroutine gmTemp to users of this DLL
     //F6358 !DEC$ATTRIBUTES DLLEXPORT::gmTemp
@@ -5269,11 +5228,11 @@ float GETGMTEMP( int inYear )
     //F6372 	  REAL*4 getGMTemp
     //F6373 
     //F6374       KREF  = KYRREF-1764
-    const int KREF = G_STOREDVALS->KYRREF - 1764;
+    const int KREF = STATE->STOREDVALS.KYRREF - 1764;
     //F6375       IYR = inYear-1990+226
     const int IYR = inYear - 1990 + 226;
     //F6376       getGMTemp = TEMUSER(IYR)+TGAV(226)
-    return( G_STOREDVALS->TEMUSER[ IYR ] + G_TANDSL->TGAV[ 226 ] );
+    return( STATE->STOREDVALS.TEMUSER[ IYR ] + STATE->TANDSL.TGAV[ 226 ] );
     //F6377 
     //F6378       RETURN 
     //F6379 	  END
@@ -5282,14 +5241,11 @@ float GETGMTEMP( int inYear )
 //F6380 
 //F6381 ! Routine to pass in new values of parameters from calling program (e.g. ObjECTS) - sjs	  
 //F6382     SUBROUTINE setParameterValues( index, value )
-void SETPARAMETERVALUES( int index, float value )
+void SETPARAMETERVALUES( MAGICC_state* STATE, int index, float value )
 {
     f_enter( __func__ );
     
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
+    assert( STATE );
     
     //F6383       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6384 ! Expose subroutine co2Conc to users of this DLL
@@ -5308,25 +5264,25 @@ void SETPARAMETERVALUES( int index, float value )
     //F6397       select case (index)
     switch( index ) {
             //F6398       case(1); aNewClimSens = value
-        case 1: G_NEWPARAMS->aNewClimSens = value; break;
+        case 1: STATE->NEWPARAMS.aNewClimSens = value; break;
             //F6399       case(2); aNewBTsoil = value
-        case 2: G_NEWPARAMS->aNewBTsoil = value; break;
+        case 2: STATE->NEWPARAMS.aNewBTsoil = value; break;
             //F6400       case(3); aNewBTHumus = value
-        case 3: G_NEWPARAMS->aNewBTHumus = value; break;
+        case 3: STATE->NEWPARAMS.aNewBTHumus = value; break;
             //F6401       case(4); aNewBTGPP = value
-        case 4: G_NEWPARAMS->aNewBTGPP = value; break;
+        case 4: STATE->NEWPARAMS.aNewBTGPP = value; break;
             //F6402       case(5); aNewDUSER = value
-        case 5: G_NEWPARAMS->aNewDUSER = value; break;
+        case 5: STATE->NEWPARAMS.aNewDUSER = value; break;
             //F6403       case(6); aNewFUSER = value
-        case 6: G_NEWPARAMS->aNewFUSER = value; break;
+        case 6: STATE->NEWPARAMS.aNewFUSER = value; break;
             //F6404       case(7); aNewSO2dir1990 = value
-        case 7: G_NEWPARAMS->aNewSO2dir1990 = value; break;
+        case 7: STATE->NEWPARAMS.aNewSO2dir1990 = value; break;
             //F6405       case(8); aNewSO2ind1990 = value
-        case 8: G_NEWPARAMS->aNewSO2ind1990 = value; break;
+        case 8: STATE->NEWPARAMS.aNewSO2ind1990 = value; break;
             //F6406       case(9); aBCUnitForcing = value
-        case 9: G_BCOC->aBCUnitForcing = value; break;
+        case 9: STATE->BCOC.aBCUnitForcing = value; break;
             //F6407       case(10); aOCUnitForcing = value
-        case 10: G_BCOC->aOCUnitForcing = value; break;
+        case 10: STATE->BCOC.aOCUnitForcing = value; break;
             //F6408       case default; 
             //F6409       end select;
     }
@@ -5341,10 +5297,6 @@ void SETPARAMETERVALUES( int index, float value )
 void overrideParameters( NEWPARAMS_block* NEWPARAMS, CAR_block* CAR, METH1_block* METH1, BCOC_block* BCOC )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
     //F6416       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6417 
     //F6418       parameter (iTp=740)
@@ -5416,13 +5368,9 @@ void overrideParameters( NEWPARAMS_block* NEWPARAMS, CAR_block* CAR, METH1_block
 //F6474 	    
 //F6475 ! Returns climate results forcing for a given gas
 //F6476       FUNCTION getCarbonResults( iResultNumber, inYear )
-float GETCARBONRESULTS( int iResultNumber, int inYear )
+float GETCARBONRESULTS( const MAGICC_state* STATE, int iResultNumber, int inYear )
 {
     f_enter( __func__ );
-    assert( G_CARB != NULL && G_TANDSL != NULL && G_CONCS != NULL && G_NEWCONCS != NULL &&
-           G_STOREDVALS != NULL && G_NEWPARAMS != NULL && G_BCOC != NULL && 
-           G_METH1 != NULL && G_CAR != NULL && G_FORCE != NULL && G_JSTART != NULL && 
-           G_QADD != NULL && G_HALOF != NULL );
     //F6477       IMPLICIT REAL*4 (a-h,o-z), Integer (I-N)
     //F6478 ! Expose subroutine getCarbonResults to users of this DLL
     //F6479 !DEC$ATTRIBUTES DLLEXPORT::getCarbonResults
@@ -5458,18 +5406,18 @@ float GETCARBONRESULTS( int iResultNumber, int inYear )
     //F6507       IF ( inYear .ge. 1990 ) THEN
     if( inYear >= 1990 ) {
         //F6508       IF(IMETH.EQ.0)THEN
-        if( G_METH1->IMETH == 0.0 )
+        if( STATE->METH1.IMETH == 0.0 )
             //F6509         TOTE=EF(IYR)+EDNET(IYR)
-            TOTE = G_CARB->EF.getval( IYR ) + G_METH1->ednet.getval( IYR );
+            TOTE = STATE->CARB.EF.getval( IYR ) + STATE->METH1.ednet.getval( IYR );
         //F6510       ELSE
         //F6511         TOTE=EF(IYR)+EDNET(IYR)+EMETH(IYR)
         else 
-            TOTE = G_CARB->EF.getval( IYR ) + G_METH1->ednet.getval( IYR ) + G_METH1->emeth.getval( IYR );
+            TOTE = STATE->CARB.EF.getval( IYR ) + STATE->METH1.ednet.getval( IYR ) + STATE->METH1.emeth.getval( IYR );
         //F6512       ENDIF
         //F6513 	    NetDef = EDNET(IYR)
-        NetDef = G_METH1->ednet.getval( IYR );
+        NetDef = STATE->METH1.ednet.getval( IYR );
         //F6514 	    GrossDef = EDGROSS(4,IYR)
-        GrossDef = G_CARB->EDGROSS.getval( 4, IYR );
+        GrossDef = STATE->CARB.EDGROSS.getval( 4, IYR );
     } else {
         //F6515 	  ELSE
         //F6516         TOTE = -1.0
@@ -5480,9 +5428,9 @@ float GETCARBONRESULTS( int iResultNumber, int inYear )
     }
     //F6520 !
     //F6521       ECH4OX=EMETH(IYR)
-    float ECH4OX = G_METH1->emeth.getval( IYR );
+    float ECH4OX = STATE->METH1.emeth.getval( IYR );
     //F6522       IF(IMETH.EQ.0)ECH4OX=0.0
-    if( G_METH1->IMETH == 0.0 ) ECH4OX = 0.0;
+    if( STATE->METH1.IMETH == 0.0 ) ECH4OX = 0.0;
     //F6523       
     //F6524       getCarbonResults = - 1.0
     float returnValue=0.0f;
@@ -5492,25 +5440,25 @@ float GETCARBONRESULTS( int iResultNumber, int inYear )
             //F6527       case(0); getCarbonResults = TOTE    ! Total emissions (fossil + netDef + Oxidation)
         case 0: returnValue = TOTE; break;
             //F6528       case(1); getCarbonResults = EF(IYR) ! Fossil Emissions as used by MAGICC
-        case 1: returnValue = G_CARB->EF.getval( IYR ); break;
+        case 1: returnValue = STATE->CARB.EF.getval( IYR ); break;
             //F6529       case(2); getCarbonResults = NetDef  ! Net Deforestation
         case 2: returnValue = NetDef; break;
             //F6530       case(3); getCarbonResults = GrossDef  ! Gross Deforestation
         case 3: returnValue = GrossDef; break;
             //F6531       case(4); getCarbonResults = FOC(4,IYR)  ! Ocean Flux
-        case 4: returnValue = G_CARB->FOC.getval( 4, IYR ); break;
+        case 4: returnValue = STATE->CARB.FOC.getval( 4, IYR ); break;
             //F6532       case(5); getCarbonResults = PL(4,IYR) ! Plant Carbon
-        case 5: returnValue = G_CARB->PL.getval( 4, IYR ); break;
+        case 5: returnValue = STATE->CARB.PL.getval( 4, IYR ); break;
             //F6533       case(6); getCarbonResults = HL(4,IYR) ! Carbon in Litter
-        case 6: returnValue = G_CARB->HL.getval( 4, IYR ); break;
+        case 6: returnValue = STATE->CARB.HL.getval( 4, IYR ); break;
             //F6534       case(7); getCarbonResults = SOIL(4,IYR) ! Carbon in Soils
-        case 7: returnValue = G_CARB->SOIL.getval( 4, IYR ); break;
+        case 7: returnValue = STATE->CARB.SOIL.getval( 4, IYR ); break;
             //F6535       case(8); getCarbonResults = DELMASS(4,IYR)  ! Atmospheric Increase
-        case 8: returnValue = G_CAR->DELMASS.getval( 4, IYR ); break;
+        case 8: returnValue = STATE->CAR.DELMASS.getval( 4, IYR ); break;
             //F6536       case(9); getCarbonResults = ECH4OX  ! Oxidation Addition to Atmosphere
         case 9: returnValue = ECH4OX; break;
             //F6537       case(10); IF(inYear .ge. 1990 ) getCarbonResults = EF(IYR)+ECH4OX-(FOC(4,IYR)+DELMASS(4,IYR)) ! Net Terrestrial Uptake
-        case 10: if( inYear >= 1990 ) returnValue = G_CARB->EF.getval( IYR ) + ECH4OX - (G_CARB->FOC.getval( 4, IYR ) + G_CAR->DELMASS.getval( 4, IYR )); break;
+        case 10: if( inYear >= 1990 ) returnValue = STATE->CARB.EF.getval( IYR ) + ECH4OX - (STATE->CARB.FOC.getval( 4, IYR ) + STATE->CAR.DELMASS.getval( 4, IYR )); break;
             //F6538       case default; getCarbonResults = -1.0
         default: returnValue = std::numeric_limits<float>::max();
                 cerr << __func__ << " undefined result " << iResultNumber << flush;;
@@ -5525,7 +5473,7 @@ float GETCARBONRESULTS( int iResultNumber, int inYear )
 //F6543 
 
 // A method to set the gas.emk data from GCAM.
-void SET_GAS_EMK( const string& GAS_EMK_DATA ) {
-    G_GAS_EMK_DATA = GAS_EMK_DATA;
+void SET_GAS_EMK( MAGICC_state* STATE, const string& GAS_EMK_DATA ) {
+    STATE->GAS_EMK_DATA = GAS_EMK_DATA;
 }
 
@@ -63,6 +63,10 @@
 #include "climate/source/hector/inst/include/h_exception.hpp"
 #include "climate/source/hector/inst/include/csv_outputstream_visitor.hpp"
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 using namespace xercesc;
 
@@ -98,6 +102,8 @@ HectorModel::HectorModel()
     mEmissionsSwitchYear = def_switch_year;
     // Hector config location.  
     mHectorIniFile = def_ini_file; 
+
+    mFirstChangedYear = numeric_limits<int>::max();
 }
 
 
@@ -113,6 +119,7 @@ void HectorModel::XMLParse( const DOMNode* node ) {
      * hector-end-year
      * hector-ini-file
      * emissions-switch-year
+     * ensemble-member
      *
      */
 
@@ -137,6 +144,9 @@ void HectorModel::XMLParse( const DOMNode* node ) {
         else if( chname == "hector-ini-file" ) {
             mHectorIniFile = XMLHelper<string>::getValue( chnode );
         }
+        else if( chname == "ensemble-member" ) {
+            parseEnsembleMember( chnode );
+        }
         else {
             ILogger& mainLog = ILogger::getLogger( "main_log" );
             mainLog.setLevel( ILogger::ERROR );
@@ -171,11 +181,13 @@ void HectorModel::completeInit( const string& aScenarioName ) {
     climatelog.setLevel( ILogger::NOTICE );
     
     mLastYear = 0;
+    mFirstChangedYear = numeric_limits<int>::max();
 
     climatelog << "Climate model is Hector.  Configuration:"
                << endl << "\thector-end-year = " << mHectorEndYear
                << endl << "\temissions-switch-year = " << mEmissionsSwitchYear
                << endl << "\thector-ini-file = " << mHectorIniFile
+               << endl << "\tensemble members = " << mEnsemble.size()
                << endl;
 
     try {
@@ -285,6 +297,7 @@ void HectorModel::completeInit( const string& aScenarioName ) {
     // set up the other results tables
     setupConcTbl();
     setupRFTbl();
+    setupYearlyResults();
     
     // Set conversion factors for gasses that require them
     mUnitConvFac["SO2tot"] = TG_TO_GG / S_TO_SO2; // GCAM in Tg-SO2; Hector in Tg-S
@@ -356,6 +369,22 @@ void HectorModel::reset( const int aPeriod ) {
     mHcore->addVisitor( mHosv.get() ); 
     mHcore->prepareToRun();
 
+    replayEmissions( mHcore.get(), aPeriod );
+
+    // Hector is now ready to run up to the year associated with aPeriod.
+    // For now catch us up to the GCAM start year and let runModel catch
+    // us up the rest of the way since it will ensure that it gets any
+    // updated output we would like to report from hector along the way.
+    mLastYear = scenario->getModeltime()->getStartYear();
+    mHcore->run( static_cast<double>( mLastYear ) );
+}
+
+/*!
+ * \brief Send the emissions stored from GCAM to a Hector core.
+ * \param aCore The core, which must have been prepared to run.
+ * \param aPeriod The last period whose emissions to send.
+ */
+void HectorModel::replayEmissions( Hector::Core* aCore, const int aPeriod ) {
     const Modeltime* modeltime = scenario->getModeltime();
 
     // loop over all gasses
@@ -368,7 +397,7 @@ void HectorModel::reset( const int aPeriod ) {
             // Note: We also skip period 0, since it's not a "real" period.
             for( int i = 1; i <= aPeriod; ++i ) {
                 if( util::isValidNumber( emissions[ i ] ) ) {
-                    setEmissions( gas, i, emissions[ i ] );
+                    setEmissionsByYear( aCore, gas, modeltime->getper_to_yr( i ), emissions[ i ] );
                 }
             }
         }
@@ -380,17 +409,11 @@ void HectorModel::reset( const int aPeriod ) {
             for( int yr = ymin; yr <= ymax; ++yr ) {
                 int i = yearlyDataIndex( yr );
                 if( util::isValidNumber( emissions[ i ] ) ) {
-                    setLUCEmissions( gas, yr, emissions[ i ] );
+                    setEmissionsByYear( aCore, gas, yr, emissions[ i ] );
                 }
             }
         }
     } 
-    // Hector is now ready to run up to the year associated with aPeriod.
-    // For now catch us up to the GCAM start year and let runModel catch
-    // us up the rest of the way since it will ensure that it gets any
-    // updated output we would like to report from hector along the way.
-    mLastYear = modeltime->getStartYear();
-    mHcore->run( static_cast<double>( mLastYear ) );
 }
 
 /*! \brief Set emissions for hector model 
@@ -401,7 +424,7 @@ void HectorModel::reset( const int aPeriod ) {
  *  \return flag indicating whether the gas was valid, irrespective of
  *          w whether we were able to set the emissions.
  */
-bool HectorModel::setEmissionsByYear( const string& aGasName,
+bool HectorModel::setEmissionsByYear( Hector::Core* aCore, const string& aGasName,
                                       const int aYear, double aEmissions )
 {
     ILogger& climatelog = ILogger::getLogger( "climate-log" );
@@ -441,7 +464,7 @@ bool HectorModel::setEmissionsByYear( const string& aGasName,
     climatelog << "Setting emissions for gas= " << aGasName
                << "  year= " << aYear
                << "  emissions= " << emiss << " " << mHectorUnits[aGasName] << endl;
-    mHcore->sendMessage( M_SETDATA, nameit->second,
+    aCore->sendMessage( M_SETDATA, nameit->second,
                          Hector::message_data( static_cast<double>( aYear ),
                          Hector::unitval( emiss,
                          static_cast<Hector::unit_types>( mHectorUnits[ aGasName ] ) ) ) ); 
@@ -453,9 +476,16 @@ bool HectorModel::setEmissions( const string& aGasName, const int aPeriod,
                                 double aEmissions )
 {
     int year = scenario->getModeltime()->getper_to_yr( aPeriod ); 
-    bool valid = setEmissionsByYear( aGasName, year, aEmissions );
+    bool valid = setEmissionsByYear( mHcore.get(), aGasName, year, aEmissions );
     if( valid ) {
-        mEmissionsTable[ aGasName ][ aPeriod ] = aEmissions;
+        double& storedEmissions = mEmissionsTable[ aGasName ][ aPeriod ];
+        if( storedEmissions != aEmissions && year > mEmissionsSwitchYear ) {
+            // Hector interpolates between the period years so the change
+            // takes effect starting just after the previous period.
+            const int prevYear = aPeriod > 0 ? scenario->getModeltime()->getper_to_yr( aPeriod - 1 ) : year - 1;
+            mFirstChangedYear = min( mFirstChangedYear, prevYear + 1 );
+        }
+        storedEmissions = aEmissions;
     }
     return valid;
 }
@@ -478,10 +508,14 @@ bool HectorModel::setLUCEmissions( const string& aGasName,
         return false;
     }
     
-    bool valid = setEmissionsByYear( aGasName, aYear, aEmissions );
+    bool valid = setEmissionsByYear( mHcore.get(), aGasName, aYear, aEmissions );
 
     if( valid ) {
-        mEmissionsTable[ aGasName ] [ yearlyDataIndex( aYear ) ] = aEmissions;
+        double& storedEmissions = mEmissionsTable[ aGasName ] [ yearlyDataIndex( aYear ) ];
+        if( storedEmissions != aEmissions && aYear > mEmissionsSwitchYear ) {
+            mFirstChangedYear = min( mFirstChangedYear, aYear );
+        }
+        storedEmissions = aEmissions;
     }
     return valid;
 }
@@ -490,7 +524,20 @@ bool HectorModel::setLUCEmissions( const string& aGasName,
  */
 IClimateModel::runModelStatus HectorModel::runModel( const int aYear ) {
     const Modeltime* modeltime = scenario->getModeltime();
-    if( aYear <= mLastYear ) {
+    if( aYear <= mLastYear && aYear < mFirstChangedYear ) {
+        // None of the emissions that affect the results up to aYear have
+        // changed since they were calculated (such as when a target trial
+        // only changes emissions after some year) so the stored results are
+        // still valid and there is no need to reset and rerun Hector.
+        ILogger& climatelog = ILogger::getLogger( "climate-log" );
+        climatelog.setLevel( ILogger::DEBUG );
+        climatelog << "Emissions unchanged through year= " << aYear
+                   << ", keeping results run through year= " << mLastYear << endl;
+        return SUCCESS;
+    }
+    // Note that if emissions have changed for a year that has already been
+    // run we must also reset even if we are being asked to run further.
+    if( aYear <= mLastYear || mFirstChangedYear <= mLastYear ) {
         int period;
         if( aYear <= modeltime->getper_to_yr( 1 )) {
             // before the first valid period.
@@ -534,11 +581,11 @@ IClimateModel::runModelStatus HectorModel::runModel( const int aYear ) {
                 hadError = true;
             }
         }
-        storeConc( year, hadError );
-        storeRF( year, hadError );
-        storeGlobals( year, hadError );
+        storeYearlyResults( year, hadError );
     }
     mLastYear = lastSuccessYear;
+    // All of the emissions that have been set are now accounted for.
+    mFirstChangedYear = numeric_limits<int>::max();
     return hadError ? EXCEPTION : SUCCESS;
 }
 
@@ -563,9 +610,171 @@ IClimateModel::runModelStatus HectorModel::runModel() {
                << "\tRFtot= " << getTotalForcing( year )
                << "\tTemperature= " << getTemperature( year )
                << endl;
+    if( !mEnsemble.empty() ) {
+        runEnsemble( year );
+    }
     return stat;
 }
 
+/*!
+ * \brief Parse a member of the climate parameter ensemble.
+ * \details The parameters which may be set are climate-sensitivity (degC
+ *          per doubling of CO2), ocean-diffusivity (cm2/s), aerosol-scale
+ *          and volcanic-scale.  Those not given keep the values from the
+ *          Hector ini file.
+ * \param aNode The ensemble-member node.
+ */
+void HectorModel::parseEnsembleMember( const DOMNode* aNode ) {
+    EnsembleMember member;
+    member.mName = XMLHelper<string>::getAttr( aNode, "name" );
+    if( member.mName.empty() ) {
+        member.mName = "member-" + util::toString( mEnsemble.size() + 1 );
+    }
+
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+        DOMNode* chnode = nodeList->item( i );
+        string chname = XMLHelper<std::string>::safeTranscode( chnode->getNodeName() );
+        if( chname == XMLHelper<void>::text() ) {
+            continue;
+        }
+
+        const double value = XMLHelper<double>::getValue( chnode );
+        if( chname == "climate-sensitivity" ) {
+            member.mParameters.push_back( make_pair( make_pair( string( D_ECS ), static_cast<int>( Hector::U_DEGC ) ), value ) );
+        }
+        else if( chname == "ocean-diffusivity" ) {
+            member.mParameters.push_back( make_pair( make_pair( string( D_DIFFUSIVITY ), static_cast<int>( Hector::U_CM2_S ) ), value ) );
+        }
+        else if( chname == "aerosol-scale" ) {
+            member.mParameters.push_back( make_pair( make_pair( string( D_AERO_SCALE ), static_cast<int>( Hector::U_UNITLESS ) ), value ) );
+        }
+        else if( chname == "volcanic-scale" ) {
+            member.mParameters.push_back( make_pair( make_pair( string( D_VOLCANIC_SCALE ), static_cast<int>( Hector::U_UNITLESS ) ), value ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Unrecognized text string: " << chname << " found while parsing ensemble-member" << endl;
+        }
+    }
+    mEnsemble.push_back( member );
+}
+
+/*!
+ * \brief Run each member of the ensemble on the emissions of the scenario
+ *        and write out their results.
+ * \details Each member gets its own Hector core so that they can run
+ *          concurrently.  The cores are set up one at a time since that
+ *          reads the ini file and logs, and only the runs themselves, which
+ *          touch nothing but their own core, are done in parallel.  A
+ *          member in which Hector fails has NaN for the years it did not
+ *          reach, as in the main run.
+ * \param aEndYear The year to run the members to.
+ */
+void HectorModel::runEnsemble( const int aEndYear ) {
+    ILogger& climatelog = ILogger::getLogger( "climate-log" );
+    climatelog.setLevel( ILogger::NOTICE );
+    climatelog << "Running " << mEnsemble.size() << " Hector ensemble members through year= "
+               << aEndYear << endl;
+
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int startYear = modeltime->getStartYear();
+    const int endYear = min( aEndYear, mHectorEndYear );
+    const size_t numMembers = mEnsemble.size();
+    vector<unique_ptr<Hector::Core> > cores( numMembers );
+    for( size_t m = 0; m < numMembers; ++m ) {
+        try {
+            cores[ m ].reset( new Hector::Core( Hector::Logger::WARNING, false, false ) );
+            cores[ m ]->init();
+            Hector::INIToCoreReader coreParser( cores[ m ].get() );
+            coreParser.parse( mHectorIniFile );
+            const EnsembleMember& member = mEnsemble[ m ];
+            for( size_t p = 0; p < member.mParameters.size(); ++p ) {
+                cores[ m ]->sendMessage( M_SETDATA, member.mParameters[ p ].first.first,
+                                         Hector::message_data( Hector::unitval( member.mParameters[ p ].second,
+                                             static_cast<Hector::unit_types>( member.mParameters[ p ].first.second ) ) ) );
+            }
+            cores[ m ]->prepareToRun();
+            replayEmissions( cores[ m ].get(), modeltime->getmaxper() - 1 );
+        }
+        catch( const h_exception& e ) {
+            climatelog.setLevel( ILogger::ERROR );
+            climatelog << "Could not set up ensemble member " << mEnsemble[ m ].mName << ": " << e << endl;
+            cores[ m ].reset();
+        }
+    }
+
+    // results[ member ][ result ][ year index ]
+    const int nrslt = yearlyDataIndex( mHectorEndYear ) + 1;
+    vector<vector<vector<double> > > results( numMembers,
+        vector<vector<double> >( eNumYearlyResults, vector<double>( nrslt, numeric_limits<double>::quiet_NaN() ) ) );
+    auto runMember = [&]( size_t m ) {
+        Hector::Core* core = cores[ m ].get();
+        if( !core ) {
+            return;
+        }
+        try {
+            core->run( static_cast<double>( startYear ) );
+            for( int year = startYear + 1; year <= endYear; ++year ) {
+                core->run( static_cast<double>( year ) );
+                Hector::message_data date( year );
+                const int i = yearlyDataIndex( year );
+                for( int result = 0; result < eNumYearlyResults; ++result ) {
+                    const YearlyResultInfo& info = mYearlyResults[ result ];
+                    results[ m ][ result ][ i ] = info.mByDate ? core->sendMessage( M_GETDATA, info.mMessage, date ) :
+                                                                 core->sendMessage( M_GETDATA, info.mMessage );
+                }
+            }
+        }
+        catch( const h_exception& ) {
+            // the remaining years are left as NaN
+        }
+        core->shutDown();
+    };
+#if GCAM_PARALLEL_ENABLED
+    tbb::parallel_for( size_t( 0 ), numMembers, runMember );
+#else
+    for( size_t m = 0; m < numMembers; ++m ) {
+        runMember( m );
+    }
+#endif
+    cores.clear();
+
+    Configuration* conf = Configuration::getInstance();
+    if( !conf->shouldWriteFile( "hectorEnsembleFileName", true, false ) ) {
+        return;
+    }
+    string fileName = conf->getFile( "hectorEnsembleFileName", "hector-ensemble.csv", false );
+    if( conf->shouldAppendScnToFile( "hectorEnsembleFileName" ) ) {
+        fileName = util::appendScenarioToFileName( fileName );
+    }
+    ofstream out( fileName.c_str() );
+    if( !out ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open " << fileName << " to write the Hector ensemble." << endl;
+        return;
+    }
+    out.precision( numeric_limits<double>::digits10 );
+    out << "scenario,member,variable";
+    for( int year = startYear + 1; year <= endYear; ++year ) {
+        out << ',' << year;
+    }
+    out << '\n';
+    for( size_t m = 0; m < numMembers; ++m ) {
+        for( int result = 0; result < eNumYearlyResults; ++result ) {
+            out << scenario->getName() << ',' << mEnsemble[ m ].mName << ',' << mYearlyResults[ result ].mName;
+            for( int year = startYear + 1; year <= endYear; ++year ) {
+                out << ',' << results[ m ][ result ][ yearlyDataIndex( year ) ];
+            }
+            out << '\n';
+        }
+    }
+    climatelog.setLevel( ILogger::NOTICE );
+    climatelog << "Wrote the Hector ensemble to " << fileName << endl;
+}
+
 /* \brief return the atmospheric concentration for a gas 
  * \details Note that not all gasses have concentrations available.
  *
@@ -683,35 +892,41 @@ int HectorModel::yearlyDataIndex( const int year ) const {
     return year - scenario->getModeltime()->getStartYear();
 }
 
-void HectorModel::storeConc( const int aYear, const bool aHadError ) {
-    ILogger& climatelog = ILogger::getLogger( "climate-log" );
-
+/*!
+ * \brief Get the yearly results from Hector and store them in the tables.
+ * \details The values to retrieve and the tables they go in were resolved
+ *          once in setupYearlyResults so that each year is just a pass
+ *          over the dense list of results.
+ * \param aYear The year Hector was just run to.
+ * \param aHadError Whether Hector failed to run to this year in which case
+ *                  the results are recorded as NaN.
+ */
+void HectorModel::storeYearlyResults( const int aYear, const bool aHadError ) {
     // No need to check the index because we checked it in runModel
     int i = yearlyDataIndex( aYear );
 
-    // These are all of the atmospheric concentrations that Hector is
-    // set up to provide.
     Hector::message_data date( aYear );
-    mConcTable["CH4"][i]   = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_ATMOSPHERIC_CH4,date );
-    mConcTable["N2O"][i]   = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_ATMOSPHERIC_N2O,date );
-    mConcTable["O3"][i]    = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_ATMOSPHERIC_O3, date );
-    mConcTable["CO2"][i]   = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_ATMOSPHERIC_CO2 );
-
-    // Hector doesn't actually compute concentrations for these
-    // gasses. (we use their emissions to compute O3 concentration,
-    // but don't compute the concentrations of the original gasses.) 
-    // mConcTable["CO"][i]    = mHcore->sendMessage(M_GETDATA, D_ATMOSPHERIC_CO);
-    // mConcTable["NOX"][i]   = mHcore->sendMessage(M_GETDATA, D_ATMOSPHERIC_NOX);
-    // mConcTable["NMVOC"][i] = mHcore->sendMessage(M_GETDATA, D_ATMOSPHERIC_NMVOC);
-
-    // Log the concentrations we are seeing here
+    for( int result = 0; result < eNumYearlyResults; ++result ) {
+        const YearlyResultInfo& info = mYearlyResults[ result ];
+        ( *info.mTable )[ i ] = aHadError ? numeric_limits<double>::quiet_NaN() :
+            info.mByDate ? mHcore->sendMessage( M_GETDATA, info.mMessage, date ) :
+                           mHcore->sendMessage( M_GETDATA, info.mMessage );
+    }
+
+    // Log what we saw here in the debugging log
+    ILogger& climatelog = ILogger::getLogger( "climate-log" );
     climatelog.setLevel( ILogger::DEBUG );
-    climatelog << "\tstoreConc: year= " << aYear << "  index= " << i << endl
-               << "\t\tCO2 = " << mConcTable["CO2"][i] << endl
-               << "\t\tCH4 = " << mConcTable["CH4"][i] << endl
-               << "\t\tN2O = " << mConcTable["N2O"][i] << endl
-               << "\t\tO3  = " << mConcTable["O3"][i] << endl;
-    
+    climatelog << "\tstoreYearlyResults: year= " << aYear << "  index= " << i << endl
+               << "\t\tCO2 = " << ( *mYearlyResults[ eConcCO2 ].mTable )[ i ] << endl
+               << "\t\tCH4 = " << ( *mYearlyResults[ eConcCH4 ].mTable )[ i ] << endl
+               << "\t\tN2O = " << ( *mYearlyResults[ eConcN2O ].mTable )[ i ] << endl
+               << "\t\tO3  = " << ( *mYearlyResults[ eConcO3 ].mTable )[ i ] << endl
+               << "\t\ttotal RF  = " << ( *mYearlyResults[ eRFTotal ].mTable )[ i ] << endl
+               << "\t\t     CO2  = " << ( *mYearlyResults[ eRFCO2 ].mTable )[ i ] << endl
+               << "\t\t     CH4  = " << ( *mYearlyResults[ eRFCH4 ].mTable )[ i ] << endl
+               << "\t\t     N2O  = " << ( *mYearlyResults[ eRFN2O ].mTable )[ i ] << endl
+               << "\t\t      BC  = " << ( *mYearlyResults[ eRFBC ].mTable )[ i ] << endl
+               << "\t\t      OC  = " << ( *mYearlyResults[ eRFOC ].mTable )[ i ] << endl;
 }
 
 void HectorModel::setupConcTbl() {
@@ -726,53 +941,6 @@ void HectorModel::setupConcTbl() {
     //mConcTable["NMVOC"].resize( size ); 
 }    
 
-// Be sure to keep this in sync with setupRFTbl.  If you add a gas
-// here, you need to add it there too!
-void HectorModel::storeRF(const int aYear, const bool aHadError ) {
-    ILogger& climatelog = ILogger::getLogger( "climate-log" );
-    int i = yearlyDataIndex( aYear );
-    
-    // total
-    mTotRFTable[i]             = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_TOTAL );
-
-    // misc gases requested by GCAM
-    mGasRFTable["CO2"][i]      = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_CO2 );
-    mGasRFTable["CH4"][i]      = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_CH4 );
-    mGasRFTable["N2O"][i]      = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_N2O );
-    mGasRFTable["BC"][i]       = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_BC );
-    mGasRFTable["OC"][i]       = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_OC );
-    mGasRFTable["SO2"][i]       = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_RF_SO2 );
-
-#if 0
-    // Forcings that hector can provide, but which are not currently
-    // requested by GCAM.  In the interests of keeping memory usage
-    // down, we won't actually store these unless someone wants them.
-    // Remember, if you enable them here, then you also have to add
-    // them in setupRFTbl below.
-
-    // Water vapor
-    mGasRFTable["H2O"][i]   = mHcore->sendMessage( M_GETDATA, D_RF_H2O );
-    // SO2: direct and indirect
-    mGasRFTable["SO2d"][i]   = mHcore->sendMessage( M_GETDATA, D_RF_SO2d );
-    mGasRFTable["SO2i"][i]   = mHcore->sendMessage( M_GETDATA, D_RF_SO2i );
-    // Ozone
-    mGasRFTable["O3"][i]    = mHcore->sendMessage( M_GETDATA, D_RF_O3 );
-
-    // Volcanoes!  <- ?
-    mGasRFTable["HFC125"][i]   = mHcore->sendMessage( M_GETDATA, D_RF_HFC125 );
-    
-#endif
-
-    // Log what we saw here in the debugging log
-    climatelog << "\tstoreRF:  year= " << aYear << "\tindex= " << i << endl
-               << "\t\ttotal RF  = " << mTotRFTable[i] << endl
-               << "\t\t     CO2  = " << mGasRFTable["CO2"][i] << endl
-               << "\t\t     CH4  = " << mGasRFTable["CH4"][i] << endl
-               << "\t\t     N2O  = " << mGasRFTable["N2O"][i] << endl
-               << "\t\t      BC  = " << mGasRFTable["BC"][i] << endl
-               << "\t\t      OC  = " << mGasRFTable["OC"][i] << endl;
-}
-
 void HectorModel::setupRFTbl() {
     int size = yearlyDataIndex( mHectorEndYear ) + 1;
 
@@ -784,16 +952,42 @@ void HectorModel::setupRFTbl() {
     mGasRFTable["SO2"].resize( size );
 }
 
-//! Store the global quantities retrieved from Hector, except total
-//! forcing, which gets stored in storeRF()
-void HectorModel::storeGlobals( const int aYear, const bool aHadError ) {
-    int idx = yearlyDataIndex( aYear );
-
-    mTemperatureTable[idx] = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_GLOBAL_TEMP );
-    mLandFlux[idx]         = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_LAND_CFLUX );
-    mOceanFlux[idx]        = aHadError ? numeric_limits<double>::quiet_NaN() : mHcore->sendMessage( M_GETDATA, D_OCEAN_CFLUX );
-} 
-    
+/*!
+ * \brief Set up the list of results retrieved from Hector each year.
+ * \details This must be called after the results tables have been set up
+ *          as we hold on to pointers to them.  If you add a result here
+ *          be sure the table it goes into is sized by setupConcTbl,
+ *          setupRFTbl, or completeInit.
+ */
+void HectorModel::setupYearlyResults() {
+    // These are all of the atmospheric concentrations that Hector is
+    // set up to provide.  Note that Hector doesn't actually compute
+    // concentrations for CO, NOX or NMVOC. (we use their emissions to
+    // compute O3 concentration, but don't compute the concentrations
+    // of the original gasses.)
+    mYearlyResults[ eConcCH4 ] = { "concentration-CH4", D_ATMOSPHERIC_CH4, true, &mConcTable[ "CH4" ] };
+    mYearlyResults[ eConcN2O ] = { "concentration-N2O", D_ATMOSPHERIC_N2O, true, &mConcTable[ "N2O" ] };
+    mYearlyResults[ eConcO3 ] = { "concentration-O3", D_ATMOSPHERIC_O3, true, &mConcTable[ "O3" ] };
+    mYearlyResults[ eConcCO2 ] = { "concentration-CO2", D_ATMOSPHERIC_CO2, false, &mConcTable[ "CO2" ] };
+
+    // Total forcing and the forcing of misc gases requested by GCAM.
+    // Hector can also provide forcing for water vapor, for SO2 split
+    // into direct and indirect, and for ozone but these are not currently
+    // requested by GCAM.  In the interests of keeping memory usage
+    // down, we won't actually store these unless someone wants them.
+    mYearlyResults[ eRFTotal ] = { "forcing-total", D_RF_TOTAL, false, &mTotRFTable };
+    mYearlyResults[ eRFCO2 ] = { "forcing-CO2", D_RF_CO2, false, &mGasRFTable[ "CO2" ] };
+    mYearlyResults[ eRFCH4 ] = { "forcing-CH4", D_RF_CH4, false, &mGasRFTable[ "CH4" ] };
+    mYearlyResults[ eRFN2O ] = { "forcing-N2O", D_RF_N2O, false, &mGasRFTable[ "N2O" ] };
+    mYearlyResults[ eRFBC ] = { "forcing-BC", D_RF_BC, false, &mGasRFTable[ "BC" ] };
+    mYearlyResults[ eRFOC ] = { "forcing-OC", D_RF_OC, false, &mGasRFTable[ "OC" ] };
+    mYearlyResults[ eRFSO2 ] = { "forcing-SO2", D_RF_SO2, false, &mGasRFTable[ "SO2" ] };
+
+    // The global quantities.
+    mYearlyResults[ eGlobalTemp ] = { "global-temperature", D_GLOBAL_TEMP, false, &mTemperatureTable };
+    mYearlyResults[ eLandFlux ] = { "land-flux", D_LAND_CFLUX, false, &mLandFlux };
+    mYearlyResults[ eOceanFlux ] = { "ocean-flux", D_OCEAN_CFLUX, false, &mOceanFlux };
+}
 
 double HectorModel::getNetTerrestrialUptake( const int aYear ) const {
     // Is this the same as land flux?
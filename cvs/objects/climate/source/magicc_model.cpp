@@ -112,7 +112,8 @@ const string MagiccModel::sInputGasUnits[] = { "(Pg C)",
 /*! \brief Constructor
 * \param aModeltime Pointer to the global modeltime object.
 */
-MagiccModel::MagiccModel()
+MagiccModel::MagiccModel():
+mState( new MAGICC_state )
 {
     mGHGInputFileName = "";
     mIsValid = false;
@@ -130,6 +131,10 @@ MagiccModel::MagiccModel()
     mNumberHistoricalDataPoints = 0; // internal counter
 }
 
+//! Destructor
+MagiccModel::~MagiccModel() {
+}
+
 /*! \brief Complete the initialization of the MagiccModel.
 * \details This function first resizes the internal vectors which store
 *          emissions by gas and period. It then reads in the default set of data
@@ -200,25 +205,25 @@ void MagiccModel::completeInit( const string& aScenarioName ){
 void MagiccModel::overwriteMAGICCParameters( ){
     // Override parameters in MAGICC if necessary
     int varIndex = 1;
-    SETPARAMETERVALUES( varIndex, mClimateSensitivity );
+    SETPARAMETERVALUES( mState.get(), varIndex, mClimateSensitivity );
     varIndex = 2;
-    SETPARAMETERVALUES( varIndex, mSoilTempFeedback );
+    SETPARAMETERVALUES( mState.get(), varIndex, mSoilTempFeedback );
     varIndex = 3;
-    SETPARAMETERVALUES( varIndex, mHumusTempFeedback );
+    SETPARAMETERVALUES( mState.get(), varIndex, mHumusTempFeedback );
     varIndex = 4;
-    SETPARAMETERVALUES( varIndex, mGPPTempFeedback );
+    SETPARAMETERVALUES( mState.get(), varIndex, mGPPTempFeedback );
     varIndex = 5;
-    SETPARAMETERVALUES( varIndex, mNetDeforestCarbFlux80s );
+    SETPARAMETERVALUES( mState.get(), varIndex, mNetDeforestCarbFlux80s );
     varIndex = 6;
-    SETPARAMETERVALUES( varIndex, mOceanCarbFlux80s );
+    SETPARAMETERVALUES( mState.get(), varIndex, mOceanCarbFlux80s );
     varIndex = 7;
-    SETPARAMETERVALUES( varIndex, mSO2Dir1990 );
+    SETPARAMETERVALUES( mState.get(), varIndex, mSO2Dir1990 );
     varIndex = 8;
-    SETPARAMETERVALUES( varIndex, mSO2Ind1990 );
+    SETPARAMETERVALUES( mState.get(), varIndex, mSO2Ind1990 );
     varIndex = 9;
-    SETPARAMETERVALUES( varIndex, mBCUnitForcing );
+    SETPARAMETERVALUES( mState.get(), varIndex, mBCUnitForcing );
     varIndex = 10;
-    SETPARAMETERVALUES( varIndex, mOCUnitForcing );
+    SETPARAMETERVALUES( mState.get(), varIndex, mOCUnitForcing );
 }
 
 //! parse MAGICC xml object
@@ -650,7 +655,7 @@ void MagiccModel::writeMAGICCEmissionsFile(){
     gasStream << gasFileData.str(); 
     
     // Set the gas data into MAGICC.
-    SET_GAS_EMK( gasStream.str() );
+    SET_GAS_EMK( mState.get(), gasStream.str() );
     
     // Check if the users still wants the gas data saved as a file which may be
     // useful for debugging or to use as input for a stand alone MAGICC run.
@@ -700,7 +705,7 @@ enum MagiccModel::runModelStatus MagiccModel::runModel(){
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
     mainLog << "Calling the climate model..."<< endl;
-    CLIMAT();
+    CLIMAT( mState.get() );
     mainLog.setLevel( ILogger::DEBUG );
     mainLog << "Finished with CLIMAT()" << endl;
     mIsValid = true;
@@ -730,7 +735,7 @@ double MagiccModel::getConcentration( const string& aGasName,
     int year = aYear;
     int gasNumber = util::searchForValue( mOutputGasNameMap, aGasName );
     if ( gasNumber != 0 ) {
-        return GETGHGCONC( gasNumber, year );
+        return GETGHGCONC( mState.get(), gasNumber, year );
     }
     return -1;
 }
@@ -743,7 +748,7 @@ double MagiccModel::getTemperature( const int aYear ) const {
 
     // Need to store the year locally so it can be passed by reference.
     int year = aYear;
-    return GETGMTEMP( year );
+    return GETGMTEMP( mState.get(), year );
 }
 
 double MagiccModel::getForcing( const string& aGasName, const int aYear ) const {
@@ -755,7 +760,7 @@ double MagiccModel::getForcing( const string& aGasName, const int aYear ) const
     int year = aYear;
     int gasNumber = util::searchForValue( mOutputGasNameMap, aGasName );
     if ( gasNumber != 0 ) {
-        return GETFORCING( gasNumber, year );
+        return GETFORCING( mState.get(), gasNumber, year );
     }
     return -1;
 }
@@ -774,7 +779,7 @@ double MagiccModel::getNetTerrestrialUptake( const int aYear ) const {
 
     int year = aYear;
     int itemNumber = 10;
-    return GETCARBONRESULTS( itemNumber, year );
+    return GETCARBONRESULTS( mState.get(), itemNumber, year );
 }
 
 double MagiccModel::getNetOceanUptake( const int aYear ) const {
@@ -791,7 +796,7 @@ double MagiccModel::getNetOceanUptake( const int aYear ) const {
 
     int year = aYear;
     int itemNumber = 4;
-    return GETCARBONRESULTS( itemNumber, year );
+    return GETCARBONRESULTS( mState.get(), itemNumber, year );
 }
 
 double MagiccModel::getNetLandUseChangeEmission( const int aYear ) const {
@@ -808,7 +813,7 @@ double MagiccModel::getNetLandUseChangeEmission( const int aYear ) const {
 
     int itemNumber = 2;
     int year = aYear;
-    return GETCARBONRESULTS( itemNumber, year );
+    return GETCARBONRESULTS( mState.get(), itemNumber, year );
 }
 
 double MagiccModel::getTotalForcing( const int aYear ) const {
@@ -820,7 +825,7 @@ double MagiccModel::getTotalForcing( const int aYear ) const {
     // Need to store the year and gas number locally so it can be passed by reference.
     int year = aYear;
     int gasNumber = 0; // global forcing
-    return GETFORCING( gasNumber, year );
+    return GETFORCING( mState.get(), gasNumber, year );
 }
 
 /*! \brief Updates a visitor with information from the the climate model.
@@ -46,10 +46,16 @@
 
 #include <string>
 #include <list>
+#include <vector>
+#include <map>
 #include <memory>
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/iscenario_runner.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#endif
 class Timer;
+class InputPrefetcher;
 
 /*! 
  * \ingroup Objects
@@ -74,7 +80,16 @@ class Timer;
  *          
  *          The batch runner is turned on using the boolean configuration value
  *          "BatchMode". The name of the configuration file is determined by the
- *          file configuration value "BatchFileName".
+ *          file configuration value "BatchFileName". If the boolean
+ *          configuration value "batch-share-inputs" is set the input files
+ *          common to all scenarios are read only once for the whole batch.
+ *          If the boolean configuration value "batch-prefetch-inputs" is set
+ *          the varying input files of the next scenario are read on a
+ *          background thread while the current scenario is solved.
+ *          If the file configuration value "batch-queue-dir" is set the
+ *          scenarios are instead taken from a queue in that directory which
+ *          may be shared by several processes on one or more nodes, see
+ *          runQueuedScenarios.
  *
  *          <b>XML specification for BatchRunner</b>
  *          - XML name: \c BatchRunner
@@ -107,6 +122,7 @@ class Timer;
  */
 class BatchRunner: public IScenarioRunner {
 	friend class ScenarioRunnerFactory;
+	friend class ModelServer;
 public:
     virtual ~BatchRunner();
 
@@ -178,11 +194,43 @@ protected:
     //! The current scenario runner.
     IScenarioRunner* mInternalRunner;
 
+    //! Reads the inputs of the next scenario ahead, if enabled.
+    std::auto_ptr<InputPrefetcher> mPrefetcher;
+
 	BatchRunner();
 	bool runSingleScenario( IScenarioRunner* aScenarioRunner,
                             const Component& aCurrComponent,
                             const int aSinglePeriod,
-                            Timer& aTimer );
+                            Timer& aTimer,
+                            const Component* aNextComponent = 0 );
+
+    void prefetchInputs( const Component& aComponent );
+
+    std::vector<Component> getCombinations();
+
+    bool runQueuedScenarios( const std::vector<Component>& aCombinations,
+                             const std::string& aQueueDir,
+                             const int aSinglePeriod,
+                             Timer& aTimer );
+
+    bool runJob( IScenarioRunner* aScenarioRunner,
+                 const Component& aComponent,
+                 const std::string& aJobPath,
+                 const int aSinglePeriod,
+                 Timer& aTimer );
+
+#if defined(__unix__) || defined(__APPLE__)
+    bool waitForJob( std::map<pid_t, size_t>& aRunning,
+                     const std::vector<Component>& aCombinations,
+                     const size_t aNumRunners,
+                     const std::string& aQueueDir );
+#endif
+
+    void mergeQueuedResults( const std::vector<Component>& aCombinations,
+                             const size_t aNumRunners,
+                             const std::string& aQueueDir ) const;
+
+    void shareCommonInputs() const;
 
     bool XMLParseComponentSet( const xercesc::DOMNode* aNode );
 
@@ -0,0 +1,207 @@
+#ifndef _ENSEMBLE_RUNNER_H_
+#define _ENSEMBLE_RUNNER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file ensemble_runner.h
+ * \ingroup Objects
+ * \brief The EnsembleRunner class header file.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include "containers/include/iscenario_runner.h"
+
+class Timer;
+class SingleScenarioRunner;
+class Value;
+
+/*! 
+ * \ingroup Objects
+ * \brief A scenario runner which runs an ensemble of variations of a single
+ *        scenario, each with a few parameters changed.
+ * \details The scenario is read in and initialized only once. Each member of
+ *          the ensemble then changes the parameters it lists, runs the
+ *          scenario, and records the same results as the BatchCSVOutputter.
+ *          Where a ProcessPool is available each member runs in a child
+ *          process forked from the initialized scenario, so the members share
+ *          its memory copy-on-write and no startup is repeated, and the results
+ *          are sent back over a pipe. Otherwise the members run one after the
+ *          other in this process and the parameters are put back after each.
+ *          The results of all members are written to the file configured by
+ *          "batchCSVOutputFile".
+ *
+ *          Parameters are found with a GCAMFusion search path, as understood
+ *          by parseFilterString, from the Scenario and may be any Value or
+ *          double Data it matches. Since the scenario has already been
+ *          initialized only parameters which are used after completeInit, for
+ *          instance in initCalc or calc, take effect.
+ *
+ *          The ensemble runner is turned on using the boolean configuration
+ *          value "ensemble-mode" and reads the ensemble from the file given by
+ *          the file configuration value "ensemble-file".
+ *
+ *          <b>XML specification for EnsembleRunner</b>
+ *          - XML name: \c ensemble-runner
+ *          - Contained by: None or BatchRunner.
+ *          - Parsing inherited from class: None.
+ *          - Attributes:
+ *              - \c name EnsembleRunner::mName
+ *          - Elements:
+ *              - \c workers EnsembleRunner::mNumWorkers
+ *                   (optional) The number of members to run at once. The
+ *                   default is 1.
+ *              - \c member EnsembleRunner::Member
+ *                  - Attributes:
+ *                      - \c name Member::mName
+ *                  - Elements:
+ *                      - \c parameter Perturbation
+ *                          - Attributes:
+ *                              - \c path Perturbation::mPath
+ *                              - \c operation Perturbation::mOperation
+ *                                   (optional) One of set, multiply or add.
+ *                                   The default is set.
+ *                          - Value: Perturbation::mValue
+ */
+class EnsembleRunner: public IScenarioRunner {
+    friend class ScenarioRunnerFactory;
+    friend class ModelServer;
+public:
+    // IParsable interface
+    virtual bool XMLParse( const xercesc::DOMNode* aRoot );
+
+    virtual ~EnsembleRunner();
+
+    virtual const std::string& getName() const;
+
+    virtual bool setupScenarios( Timer& aTimer,
+        const std::string aName = "",
+        const std::list<std::string> aScenComponents =
+            std::list<std::string>() );
+
+    virtual bool runScenarios( const int aSinglePeriod,
+                               const bool aPrintDebugging,
+                               Timer& aTimer );
+
+    virtual void printOutput( Timer& aTimer ) const;
+
+    virtual void cleanup();
+
+    virtual Scenario* getInternalScenario();
+    virtual const Scenario* getInternalScenario() const;
+protected:
+    EnsembleRunner();
+    static const std::string& getXMLNameStatic();
+private:
+    //! A change to a parameter of the scenario.
+    struct Perturbation {
+        //! The ways in which a parameter may be changed.
+        enum Operation {
+            //! Replace the parameter with the value.
+            eSet,
+
+            //! Multiply the parameter by the value.
+            eMultiply,
+
+            //! Add the value to the parameter.
+            eAdd
+        };
+
+        //! The GCAMFusion search path to the parameter.
+        std::string mPath;
+
+        //! How to change the parameter.
+        Operation mOperation;
+
+        //! The value to change the parameter by.
+        double mValue;
+    };
+
+    //! A member of the ensemble.
+    struct Member {
+        //! The name of the member, which becomes part of the scenario name.
+        std::string mName;
+
+        //! The changes to the scenario.
+        std::vector<Perturbation> mPerturbations;
+    };
+
+    //! The original values of the parameters changed by a member.
+    struct OriginalValues {
+        std::vector<std::pair<Value*, double> > mValues;
+        std::vector<std::pair<double*, double> > mDoubles;
+    };
+
+    //! The scenario runner which runs the scenario for each member.
+    std::auto_ptr<SingleScenarioRunner> mSingleScenario;
+
+    //! The name of the ensemble.
+    std::string mName;
+
+    //! The members of the ensemble.
+    std::vector<Member> mMembers;
+
+    //! The number of members to run at once.
+    int mNumWorkers;
+
+    //! Whether the ensemble has already been parsed.
+    bool mHasParsedConfig;
+
+    //! The results of each member as written by the BatchCSVOutputter, empty
+    //! if the member did not complete.
+    std::vector<std::string> mResults;
+
+    //! The names of the members which did not solve.
+    std::vector<std::string> mUnsolvedNames;
+
+    bool XMLParseMember( const xercesc::DOMNode* aNode );
+
+    bool runMember( const Member& aMember,
+                    const int aSinglePeriod,
+                    Timer& aTimer,
+                    std::string& aResults,
+                    OriginalValues& aOriginalValues );
+
+    bool applyPerturbations( const Member& aMember, OriginalValues& aOriginalValues );
+
+    void restoreValues( const OriginalValues& aOriginalValues );
+};
+
+#endif // _ENSEMBLE_RUNNER_H_
@@ -0,0 +1,108 @@
+#ifndef _GCAM_C_API_H_
+#define _GCAM_C_API_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file gcam_c_api.h
+ * \ingroup Objects
+ * \brief A C interface for embedding the model in another program.
+ * \details The interface lets another model or an optimization loop drive
+ *          GCAM in process: set up a scenario from a configuration file, set
+ *          prices and parameters, run periods, and read results back without
+ *          going through the XML database.  Only plain C types are used so
+ *          that the functions may be called from C or loaded from a shared
+ *          library with a foreign function interface such as Python's ctypes.
+ *
+ *          Results are returned as pointers to contiguous arrays of doubles
+ *          owned by the session which the caller may read, or wrap with
+ *          numpy.frombuffer, without copying them.  An array stays valid until
+ *          the next call on the same session which returns an array.
+ *
+ *          Markets are referred to by handles returned by gcam_find_market.
+ *          Parameters and results in the model are found by GCAM Fusion search
+ *          strings, for example
+ *          "world/region[NamedFilter,StringEquals,USA]/sector/subsector/technology/period[YearFilter,IntEquals,2020]/share-weight".
+ *          The searches are cached by the session so repeating a query is
+ *          proportional to the number of matches.
+ *
+ *          Only a single session may exist at a time since the configuration
+ *          and the loggers are shared by the process.  Functions returning an
+ *          int return a negative value on failure.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! An embedded model session.
+typedef struct GcamSession GcamSession;
+
+//! The market values which may be read with gcam_get_market_values.
+enum GcamMarketValue {
+    GCAM_MARKET_PRICE = 0,
+    GCAM_MARKET_SUPPLY = 1,
+    GCAM_MARKET_DEMAND = 2
+};
+
+GcamSession* gcam_create( const char* aConfigurationFile, const char* aLogConfFile );
+
+void gcam_destroy( GcamSession* aSession );
+
+int gcam_get_num_periods( const GcamSession* aSession );
+
+int gcam_get_period_year( const GcamSession* aSession, int aPeriod );
+
+int gcam_run_period( GcamSession* aSession, int aPeriod );
+
+int gcam_write_outputs( GcamSession* aSession );
+
+int gcam_find_market( GcamSession* aSession, const char* aGoodName, const char* aRegionName );
+
+int gcam_set_price( GcamSession* aSession, int aMarket, int aPeriod, double aPrice );
+
+const double* gcam_get_market_values( GcamSession* aSession, int aMarket, int aValueType, int* aLength );
+
+int gcam_set_parameter( GcamSession* aSession, const char* aSearchString, double aValue );
+
+const double* gcam_query( GcamSession* aSession, const char* aSearchString, int aPeriod, int* aLength );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _GCAM_C_API_H_
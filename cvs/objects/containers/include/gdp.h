@@ -165,6 +165,21 @@ protected:
     double getTotalLaborProductivity( const int period ) const;
     double getLaborForce( const int per ) const;
     int findNextPeriodWithValue( const int aStartPeriod, const std::vector<Value>& aValueVector ) const;
+    void updateScaledGDP( const int aPeriod );
+
+    /*! \brief Approximate GDP per capita relative to the base period.
+     *  \details This and the other scaled values are updated whenever the GDP
+     *           for a period is written, in initialGDPcalc and the energy price
+     *           feedback in adjustGDP, so the accessors used during the
+     *           calculation only read them.
+     */
+    std::vector<double> mApproxScaledGDPperCap;
+
+    //! Approximate GDP relative to the base period.
+    std::vector<double> mApproxScaledGDP;
+
+    //! Adjusted GDP per capita relative to the base period.
+    std::vector<double> mScaledGDPperCap;
  };
 
 #endif // _GDP_H_
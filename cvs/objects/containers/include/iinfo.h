@@ -48,6 +48,9 @@
 #include <iosfwd>
 
 class Tabs;
+namespace objects {
+    class Atom;
+}
 
 /*!
 * \ingroup Objects
@@ -137,6 +140,16 @@ public:
     */
     virtual double getDouble( const std::string& aStringKey,
                                     const bool aMustExist ) const = 0;
+
+    /*! \brief Get a double value from the IInfo with the key given by an Atom.
+    * \details The same as getDouble for the Atom's string but the search uses
+    *          the hash code precomputed by the Atom instead of hashing the key.
+    * \param aKey The Atom of the key for which to search the IInfo object.
+    * \param aMustExist Whether the value should exist in the IInfo.
+    * \return The double associated with the key or zero if it does not exist.
+    */
+    virtual double getDouble( const objects::Atom* aKey,
+                              const bool aMustExist ) const = 0;
     
     /*! \brief Get a string from the IInfo with a specified key.
     * \details Searches the key set for the given key and returns the associated
@@ -180,6 +193,15 @@ public:
     */
     virtual double getDoubleHelper( const std::string& aStringKey, bool& aFound ) const = 0;
 
+    /*! \brief Get a double value from the IInfo with the key given by an Atom.
+    * \details The same as getDoubleHelper for the Atom's string but the search
+    *          uses the hash code precomputed by the Atom.
+    * \param aKey The Atom of the key for which to search the IInfo object.
+    * \param aFound Whether the value is found or not.
+    * \return The double associated with the key or zero if it does not exist.
+    */
+    virtual double getDoubleHelper( const objects::Atom* aKey, bool& aFound ) const = 0;
+
     /*! \brief Get a string from the IInfo with a specified key.
     * \details Searches the key set for the given key and returns the associated
     *          value. If the value does not exist the default value will be
@@ -57,7 +57,10 @@
 #include "util/base/include/configuration.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <atomic>
+#include <set>
 #include <tbb/queuing_rw_mutex.h>
+#include <tbb/spin_mutex.h>
 #endif
 
 class Tabs;
@@ -66,6 +69,15 @@ class Tabs;
 * \ingroup Objects
 * \brief This class contains a set of properties which can be accessed by their
 *        unique identifier.
+* \details Almost all properties are set during completeInit and initCalc and
+*          are then only read while the model is calculated.  In parallel
+*          builds every read would need to take a read lock on the Info's map,
+*          so once initCalc is complete all Info objects are frozen with
+*          InfoFactory::freezeInfos.  The map of a frozen Info is immutable
+*          and is read without any locking.  Setting a value on a frozen Info
+*          is still permitted: the Info is thawed by moving the frozen map
+*          aside, where readers which found it frozen may still safely use it,
+*          and writing to a copy which is again protected by the lock.
 * \author Josh Lurz
 * \todo Add longevity to properties.
 */
@@ -90,6 +102,8 @@ public:
 
     double getDouble( const std::string& aStringKey, const bool aMustExist ) const;
 
+    double getDouble( const objects::Atom* aKey, const bool aMustExist ) const;
+
     const std::string& getString( const std::string& aStringKey, const bool aMustExist ) const;
 
     bool getBooleanHelper( const std::string& aStringKey, bool& aFound ) const;
@@ -98,6 +112,8 @@ public:
 
     double getDoubleHelper( const std::string& aStringKey, bool& aFound ) const;
 
+    double getDoubleHelper( const objects::Atom* aKey, bool& aFound ) const;
+
     const std::string& getStringHelper( const std::string& aStringKey, bool& aFound ) const;
 
     bool hasValue( const std::string& aStringKey ) const;
@@ -106,6 +122,8 @@ public:
 protected:
     Info( const IInfo* aParentInfo, const std::string& aOwnerName );
 
+    static void freezeAll();
+
 private:
 
     std::string mOwnerName;
@@ -133,6 +151,10 @@ private:
 
     template<class T> const T& getItemValueLocal( const std::string& aStringKey, bool& aExists ) const;
 
+    template<class T> const T& getItemValueLocal( const std::string& aStringKey,
+                                                  const size_t aHash,
+                                                  bool& aExists ) const;
+
     size_t getInitialSize() const;
 
     void printItemNotFoundWarning( const std::string& aStringKey ) const;
@@ -141,6 +163,16 @@ private:
 
     void printShadowWarning( const std::string& aStringKey ) const;
 
+#if GCAM_PARALLEL_ENABLED
+    void freeze();
+
+    void thaw();
+
+    static std::set<Info*>& getAllInfos();
+
+    static tbb::spin_mutex& getAllInfosMutex();
+#endif
+
     template<class T> void printItem( const boost::any& aValue,
                                       std::ostream& aOut,
                                       Tabs* aTabs ) const;
@@ -155,8 +187,17 @@ private:
     std::auto_ptr<InfoMap> mInfoMap;
 #if GCAM_PARALLEL_ENABLED
     // actions that modify mInfoMap MUST obtain a write lock on the info map.
-    // Those that merely read it MUST obtain a read lock
+    // Those that merely read it MUST obtain a read lock unless the map is
+    // frozen.
     mutable tbb::queuing_rw_mutex mInfoMapMutex;
+
+    //! The immutable map which may be read without locking while the Info is
+    //! frozen, null otherwise.
+    std::atomic<const InfoMap*> mFrozenMap;
+
+    //! A frozen map replaced by a write to the Info, kept until the next
+    //! freeze since readers which found the Info frozen may still be using it.
+    std::auto_ptr<InfoMap> mThawedMap;
 #endif
 
     //! A pointer to the parent of this Info object which can be null.
@@ -208,6 +249,11 @@ template<class T> bool Info::setItemValueLocal( const std::string& aStringKey,
 #if GCAM_PARALLEL_ENABLED
     // acquire a write lock for updating the infomap
     tbb::queuing_rw_mutex::scoped_lock writelock(mInfoMapMutex, true);
+    
+    // The frozen map can't be modified as it is read without locking.
+    if( mFrozenMap.load( std::memory_order_acquire ) ){
+        thaw();
+    }
 #endif
     // Add the value regardless of whether a warning was printed.
     mInfoMap->insert( std::make_pair( aStringKey, std::make_pair( aType, boost::any( aValue ) ) ) );
@@ -224,8 +270,11 @@ template<class T> bool Info::setItemValueLocal( const std::string& aStringKey,
 *         otherwise. 
 * \warning This function returns a reference to an item stored in a map.  If
 *          the map entry is deleted or overwritten, we will wind up with a
-*          dangling reference.  We could return by value, but for string values
-*          that involves making several string temporaries (as this function is
+*          dangling reference.  The HashMap never moves its entries, so
+*          inserting other keys does not invalidate the reference, and a
+*          frozen map which is thawed is kept until the next freeze.  We could
+*          return by value, but for string values that involves making several
+*          string temporaries (as this function is
 *          normally called indirectly through getString), which can be very
 *          painful in multithreaded code because of the synchronization buried
 *          in the string object's malloc call.
@@ -233,17 +282,44 @@ template<class T> bool Info::setItemValueLocal( const std::string& aStringKey,
 template<class T>
 const T& Info::getItemValueLocal( const std::string& aStringKey,
                                  bool& aExists ) const
+{
+    return getItemValueLocal<T>( aStringKey, InfoMap::getHash( aStringKey ), aExists );
+}
+
+/*!
+ * \brief Get the value of an item from the local map given the precomputed
+ *        hash of the key.
+ * \details The same as getItemValueLocal without the hash, this allows callers
+ *          which have an Atom for the key to skip hashing the string.
+ * \param aStringKey The key of the item.
+ * \param aHash The hash of the key, which must be InfoMap::getHash( aStringKey ).
+ * \param aExists Returns whether the item exists.
+ * \return The value of the item or the default value if it does not exist.
+ */
+template<class T>
+const T& Info::getItemValueLocal( const std::string& aStringKey,
+                                 const size_t aHash,
+                                 bool& aExists ) const
 {
     /*! \pre A valid key was passed. */
     assert( !aStringKey.empty() );
+    assert( aHash == InfoMap::getHash( aStringKey ) );
 
 #if GCAM_PARALLEL_ENABLED
-    // read lock for reading the map
-    tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex, false);
+    // A frozen map is immutable and can be read without a lock, otherwise
+    // obtain a read lock for reading the map.
+    const InfoMap* infoMap = mFrozenMap.load( std::memory_order_acquire );
+    tbb::queuing_rw_mutex::scoped_lock readlock;
+    if( !infoMap ){
+        readlock.acquire( mInfoMapMutex, false );
+        infoMap = mInfoMap.get();
+    }
+#else
+    const InfoMap* infoMap = mInfoMap.get();
 #endif
     // Check for the value.
-    InfoMap::const_iterator curr = mInfoMap->find( aStringKey );
-    if( curr != mInfoMap->end() ){
+    InfoMap::const_iterator curr = infoMap->find( aStringKey, aHash );
+    if( curr != infoMap->end() ){
         aExists = true;
         // Attempt to set the return value to the found value. This requires
         // converting the data from the actual type to the requested type.
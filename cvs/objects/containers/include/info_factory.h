@@ -57,6 +57,8 @@ class IInfo;
 class InfoFactory {
 public:
     static IInfo* constructInfo( const IInfo* aParent, const std::string& aOwnerName );
+
+    static void freezeInfos();
 };
 
 #endif // _INFO_FACTORY_H_
@@ -98,6 +98,11 @@ public:
 
 #if GCAM_PARALLEL_ENABLED
     GcamFlowGraph* getFlowGraph( const int aMarketNumber = -1 );
+    
+    //! Whether the flow graphs for all markets were created along with the global one.
+    bool hasPartialFlowGraphs() const {
+        return mHasPartialFlowGraphs;
+    }
 #endif
 
     void resolveActivityToDependency( const std::string& aRegionName, 
@@ -116,7 +121,7 @@ public:
      */
     struct CalcVertex {
         CalcVertex( IActivity* aCalcItem, DependencyItem* aDepItem, const int aUID )
-        :mCalcItem( aCalcItem ), mDepItem( aDepItem ), mUID( aUID ), mIndex( -1 ), mLowLink( -1 ) {}
+        :mCalcItem( aCalcItem ), mDepItem( aDepItem ), mUID( aUID ) {}
         ~CalcVertex();
         
         //! The object which does the calculations for this vertex.
@@ -130,16 +135,10 @@ public:
         DependencyItem* mDepItem;
 
         //! A unique ID for all CalcVertex to be able to consistently compare
-        //! between runs
+        //! between runs.  These are assigned sequentially from zero so they
+        //! are also used to index vertices while creating the ordering.
         int mUID;
 
-        //! A sequential unique identifier for use in a Tarjan's algorithm.
-        int mIndex;
-
-        //! A identifier for use in a Tarjan's algorithm that represents the
-        //! the smallest index of a vertex know to be reachable from this vertex.
-        int mLowLink;
-
         //! Some implied verticies to calculate (special case for the land-allocator)
         std::set<CalcVertex*> mImpliedInEdges;
     };
@@ -157,7 +156,6 @@ public:
     typedef std::vector<CalcVertex*> VertexList;
     typedef VertexList::iterator VertexIterator;
     typedef VertexList::const_iterator CVertexIterator;
-    typedef std::map<CalcVertex*, int, CalcVertexComp> CalcVertexCountMap;
     
     // DependencyItem and related declarations
     
@@ -332,16 +330,85 @@ public:
     //! A UID counter to able to compare CalcVertex uniquely between runs
     int mCalcVertexUIDCount;
 
+    /*!
+     * \brief The working state of the topological sort and cycle breaking in
+     *        createOrdering.
+     * \details All per vertex data is kept in vectors indexed by the vertex
+     *          mUID so that every lookup is constant time.  The vertices which
+     *          are not yet ordered, and the number of their dependencies which
+     *          are not yet ordered, take the place of a map from vertex to count;
+     *          vertices whose count drops to zero are noted as they do so that
+     *          each pass of the sort only needs to look at those.
+     */
+    struct OrderingState {
+        OrderingState( const int aNumVertices );
+
+        void setNumDependencies( CalcVertex* aVertex, const int aNumDependencies );
+        void addDependency( CalcVertex* aVertex );
+        void removeDependency( CalcVertex* aVertex );
+
+        //! Whether a vertex has not yet been added to the global ordering.
+        bool isUnordered( const CalcVertex* aVertex ) const {
+            return mIsUnordered[ aVertex->mUID ];
+        }
+
+        //! All vertices by UID.
+        VertexList mVertices;
+
+        //! The number of dependencies of each vertex which are not yet ordered.
+        std::vector<int> mNumDependencies;
+
+        //! Whether each vertex has not yet been ordered.
+        std::vector<bool> mIsUnordered;
+
+        //! The number of vertices which have not yet been ordered.
+        size_t mNumUnordered;
+
+        //! The UIDs of vertices whose dependency count has reached zero since
+        //! the last pass of the sort, possibly with duplicates.
+        std::vector<int> mReadyCandidates;
+
+        //! For each vertex the demand vertices which had an out edge to it
+        //! when the graph was connected.
+        std::vector<VertexList> mDemandInEdges;
+
+        //! The Tarjan's algorithm index of each vertex, -1 if not yet visited.
+        std::vector<int> mIndex;
+
+        //! The Tarjan's algorithm low link of each vertex, the smallest index
+        //! of a vertex known to be reachable from it.
+        std::vector<int> mLowLink;
+
+        //! Whether each vertex is on the Tarjan's algorithm stack, or during
+        //! markCycles on the current search path.
+        std::vector<bool> mIsOnStack;
+
+        //! The number of times markCycles found each vertex in a cycle, or -1
+        //! if it is not a candidate to break a cycle.
+        std::vector<int> mCycleVisits;
+
+        //! The UIDs of the candidates to break a cycle, in increasing order.
+        std::vector<int> mCycleVertices;
+    };
+
 #if GCAM_PARALLEL_ENABLED
     //! The global flow graph to calculate the full model in parallel
     GcamFlowGraph* mTBBGraphGlobal;
+    
+    //! Whether the flow graphs for all markets in mMarketsToDep were created
+    //! along with mTBBGraphGlobal.
+    bool mHasPartialFlowGraphs;
+    
+    void createFlowGraphs();
+    
+    size_t hashDependencies() const;
 #endif
     
     void findVerticesToCalculate( CalcVertex* aVertex, std::set<IActivity*>& aVisited ) const;
-    void findStronglyConnected( CalcVertex* aCurrVertex, int& aMaxIndex,std::list<CalcVertex*>& aHasVisited,
-                                CalcVertexCountMap& aTotalVisits ) const;
-    int markCycles( CalcVertex* aCurrVertex, std::list<CalcVertex*>& aHasVisited, CalcVertexCountMap& aTotalVisits ) const;
-    void createTrialsForItem( CItemIterator aItemToReset, CalcVertexCountMap& aNumDependencies );
+    void findStronglyConnected( CalcVertex* aRootVertex, int& aMaxIndex, OrderingState& aState ) const;
+    int markCycles( CalcVertex* aCurrVertex, OrderingState& aState ) const;
+    void createTrialsForItem( DependencyItem* aItemToReset, OrderingState& aState );
+    std::vector<DependencyItem*> findMinimalTrialItems( const OrderingState& aState ) const;
 };
 
 #endif // _MARKET_DEPENDENCY_FINDER_H_
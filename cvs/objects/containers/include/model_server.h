@@ -0,0 +1,102 @@
+#ifndef _MODEL_SERVER_H_
+#define _MODEL_SERVER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file model_server.h
+ * \ingroup Objects
+ * \brief The ModelServer class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <iosfwd>
+
+class Timer;
+class IScenarioRunner;
+
+/*! 
+ * \ingroup Objects
+ * \brief Keeps the reference inputs resident and runs scenarios on request.
+ * \details The server is started by running gcam with --server.  The base
+ *          input file and the scenario components in the configuration are
+ *          read once into the shared input image.  Requests are then read one
+ *          per line and each builds a new scenario from the image, adds any
+ *          add-on files given, and runs it with the scenario runner from the
+ *          configuration.  Each request therefore starts from the same
+ *          pristine reference inputs without reading their XML again.  The
+ *          supported requests are:
+ *
+ *          - run <scenario-name> <stop-period> [<add-on file> ...]
+ *            A stop-period of -1 uses the stop period of the configuration.
+ *            The scenario name is appended to the configured scenarioName.
+ *          - quit
+ *
+ *          A response line is written for each request, either
+ *          "done <scenario-name> solved|unsolved <seconds>" or
+ *          "error <message>", once all of the configured outputs of the run
+ *          have been written.  Requests are read from standard input and
+ *          responses written to standard output so that the server may sit
+ *          behind any socket or process front end.
+ *
+ *          The image holds the parsed inputs, not the initialized model, so
+ *          completeInit and the model's dependency analysis still happen for
+ *          each request.  Batch and ensemble runners, which run their own
+ *          sets of scenarios, are not used by the server.
+ */
+class ModelServer {
+public:
+    ModelServer();
+    ~ModelServer();
+
+    bool run( std::istream& aRequests, std::ostream& aResponses, Timer& aTimer );
+
+private:
+    //! The scenario runner used for each request.
+    std::auto_ptr<IScenarioRunner> mRunner;
+
+    void loadReferenceInputs() const;
+
+    bool runRequest( const std::vector<std::string>& aRequest,
+                     std::ostream& aResponses,
+                     Timer& aTimer );
+};
+
+#endif // _MODEL_SERVER_H_
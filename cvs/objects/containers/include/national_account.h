@@ -148,8 +148,9 @@ public:
 private:
     const std::string& enumToName( const AccountType aType ) const;
     const std::string& enumToXMLName( const AccountType aType ) const;
-    //! Vector to hold national account values
-    std::vector<double> mAccounts;
+    //! Dense array of the national account values indexed by AccountType.
+    //! The number of accounts is fixed so the values are stored inline.
+    double mAccounts[ END ];
 };
 
 #endif // _NATIONAL_ACCOUNT_H_
@@ -93,8 +93,27 @@ public:
     virtual void initCalc( const int period );
     
     virtual void postCalc( const int aPeriod );
+    
+    /*!
+     * \brief The part of initCalc which only changes objects owned by this
+     *        region so that it may be run for all regions at once.
+     * \details Called for every region after initCalc.  See
+     *          World::calcRegionLocalPhase for what it may touch.
+     * \param aPeriod The model period.
+     */
+    virtual void initCalcLocal( const int aPeriod ) {}
+    
+    /*!
+     * \brief The part of postCalc which only changes objects owned by this
+     *        region so that it may be run for all regions at once.
+     * \details Called for every region after postCalc.  See
+     *          World::calcRegionLocalPhase for what it may touch.
+     * \param aPeriod The model period.
+     */
+    virtual void postCalcLocal( const int aPeriod ) {}
 
     void setTax( const GHGPolicy* aTax );
+    bool updateFixedTaxes( const std::string& aTaxName, const std::vector<double>& aFixedTaxes );
     const Curve* getEmissionsQuantityCurve( const std::string& ghgName ) const;
     const Curve* getEmissionsPriceCurve( const std::string& ghgName ) const;
 
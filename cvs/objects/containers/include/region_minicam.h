@@ -101,6 +101,10 @@ public:
     virtual void initCalc( const int period );
 
     virtual void postCalc( const int aPeriod );
+    
+    virtual void initCalcLocal( const int aPeriod );
+    
+    virtual void postCalcLocal( const int aPeriod );
 
     virtual bool isAllCalibrated( const int period, double calAccuracy, const bool printWarnings ) const;
     virtual void accept( IVisitor* aVisitor, const int aPeriod ) const;
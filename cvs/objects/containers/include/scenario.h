@@ -67,6 +67,10 @@ class OutputMetaData;
 class SolutionInfoParamParser;
 class IModelFeedbackCalc;
 class ManageStateVariables;
+class BackgroundTaskQueue;
+class SolverTuner;
+class SensitivityAnalyzer;
+class ISolutionInfoFilter;
 
 /*!
 * \ingroup Objects
@@ -103,15 +107,18 @@ public:
     const std::string& getName() const;
     bool run( const int aSinglePeriod, const bool aPrintDebugging, const std::string& aFilenameEnding = "" );
     void setTax( const GHGPolicy* aTax );
+    bool updateFixedTaxes( const std::string& aTaxName, const std::vector<double>& aFixedTaxes );
     std::map<std::string, const Curve*> getEmissionsQuantityCurves( const std::string& ghgName ) const;
     std::map<std::string, const Curve*> getEmissionsPriceCurves( const std::string& ghgName ) const;
     void writeOutputFiles() const;
     void accept( IVisitor* aVisitor, const int aPeriod ) const;
     const IClimateModel* getClimateModel() const;
+    IClimateModel* getClimateModel();
     static const std::string& getXMLNameStatic();
     const std::vector<int>& getUnsolvedPeriods() const;
     void invalidatePeriod( const int aPeriod );
     ManageStateVariables* getManageStateVariables() const;
+    void notifySolveProgress( const int aPeriod, const double aMaxRelativeED );
 
     //! Constant which when passed to the run method indicates the run period could not be determined  yet and will generate a warning..
     const static int UNINITIALIZED_RUN_PERIODS = -2;
@@ -153,18 +160,66 @@ protected:
     //! necessary
     std::vector<boost::shared_ptr<Solver> > mSolvers;
     
+    //! Alternate solution mechanisms by period, read from the configuration file
+    //! retry-solver-config, with which to retry a period that mSolvers failed
+    //! to solve.  A period without one is not retried.
+    std::vector<boost::shared_ptr<Solver> > mRetrySolvers;
+    
+    //! The markets of the reduced problem solved ahead of each period if the
+    //! configuration multilevel-solve-filter is set, otherwise null.
+    boost::shared_ptr<ISolutionInfoFilter> mMultilevelFilter;
+    
+    //! Solution mechanisms by period for the reduced problem, read from the
+    //! configuration file coarse-solver-config.  A period without one uses
+    //! mSolvers for the reduced problem too.
+    std::vector<boost::shared_ptr<Solver> > mCoarseSolvers;
+    
+    //! Searches for better solver settings in selected periods if the
+    //! configuration solver-tuning-config is set.
+    boost::shared_ptr<SolverTuner> mSolverTuner;
+    
+    //! Calculates the sensitivities of the solution to tagged parameters in
+    //! solved periods if the configuration sensitivity-config is set.
+    boost::shared_ptr<SensitivityAnalyzer> mSensitivityAnalyzer;
+    
     //! Objects that may take model results and provide some sort of feedback as
     //! the scenario progresses through the model periods.
     std::vector<IModelFeedbackCalc*> mModelFeedbacks;
     
     ManageStateVariables* mManageStateVars;
 
+    //! The last period of the current run which a speculative solve may be
+    //! started for, or -1 if none may be.
+    int mLastSpeculativePeriod;
+
+    //! The period being solved by the speculative solve process, or -1 if
+    //! there is none.
+    int mSpeculativePeriod;
+
+    //! The process id of the speculative solve.
+    long mSpeculativeProcess;
+
+    //! The file descriptor from which the prices of the speculative solve are read.
+    int mSpeculativePipe;
+
+    //! Whether this is the process of a speculative solve.
+    bool mIsSpeculative;
+
     bool solve( const int period );
 
+    void startSpeculativeSolve( const int aPeriod );
+
+    void applySpeculativePrices( const int aPeriod );
+
+    void discardSpeculativeSolve();
+
+    bool hasTooManyUnsolvedPeriods() const;
+
     bool calculatePeriod( const int aPeriod,
         std::ostream& aXMLDebugFile,
         Tabs* aTabs,
-        const bool aPrintDebugging );
+        const bool aPrintDebugging,
+        BackgroundTaskQueue* aOutputQueue );
 
     void printGraphs( const int aPeriod ) const;
     void printLandAllocatorGraph( const int aPeriod, const bool aPrintValues ) const;
@@ -173,11 +228,21 @@ protected:
     void logPeriodBeginning( const int aPeriod ) const;
     void logPeriodEnding( const int aPeriod ) const;
     void logRunEnding() const;
+    void logMemoryUsage( const std::string& aWhen ) const;
 
     void writeDebuggingFiles( std::ostream& aXMLDebugFile,
         Tabs* aTabs,
         const int aPeriod ) const;
 
+    void queueDebuggingFiles( std::ostream& aXMLDebugFile,
+        Tabs* aTabs,
+        const int aPeriod,
+        BackgroundTaskQueue* aOutputQueue ) const;
+
+    static bool isLazyDebugXML();
+
+    void releaseFinishedPeriod( const int aPeriod );
+
     void initSolvers();
 };
 
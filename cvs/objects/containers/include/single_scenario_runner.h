@@ -46,11 +46,15 @@
 
 #include <memory>
 #include <list>
+#include <vector>
+#include <string>
 #include "containers/include/iscenario_runner.h"
 
 class Timer;
 class Scenario;
 class XMLDBOutputter;
+class ResultCache;
+class ValidationCache;
 
 /*! 
  * \ingroup Object
@@ -81,6 +85,16 @@ class XMLDBOutputter;
  *          The getInternalScenarios functions only return a valid scenario
  *          after setupScenarios is called.
  *
+ *          When the configuration file names a result-cache-dir, a runner
+ *          which is not contained by another runner keys the run by the
+ *          contents of its input files and its settings. If a previous run
+ *          with the same key stored its outputs in the cache they are copied
+ *          back and the scenario is not solved again, otherwise the outputs of
+ *          a successful run are stored when it is cleaned up. The outputs are
+ *          the XML database, columnar output and restart files. A contained
+ *          runner always runs since the containing runner reads the results
+ *          from the solved scenario.
+ *
  * \todo What should be documented here vs. the IScenarioRunner interface.
  *
  * \author Josh Lurz
@@ -115,6 +129,16 @@ public:
 protected:    
     SingleScenarioRunner();
     static const std::string& getXMLNameStatic();
+
+    void setupResultCache( const std::list<std::string>& aInputFiles );
+
+    std::vector<std::string> getCachedOutputs() const;
+
+#if GCAM_PARALLEL_ENABLED
+    bool parseComponentsConcurrently( const std::list<std::string>& aScenComponents,
+                                      ValidationCache& aValidationCache );
+#endif
+
     //! The scenario which will be run.
     std::auto_ptr<Scenario> mScenario;
 
@@ -122,5 +146,19 @@ protected:
     //! it around in case we want to do additional processing once GCAM
     //! is done running.
     mutable XMLDBOutputter* mXMLDBOutputter;
+
+    //! Whether the outputs may be restored from and stored to a result cache,
+    //! which is only set for a runner not contained by another runner.
+    bool mUseResultCache;
+
+    //! The result cache keyed for the current scenario if one is in use.
+    std::auto_ptr<ResultCache> mResultCache;
+
+    //! Whether the outputs of the current scenario were restored from the
+    //! result cache instead of running it.
+    bool mRestoredResults;
+
+    //! Whether the last run of the current scenario succeeded.
+    bool mRunSucceeded;
 };
 #endif // _SINGLE_SCENARIO_RUNNER_H_
@@ -48,6 +48,7 @@
 #include <map>
 #include <memory>
 #include <vector>
+#include <iosfwd>
 
 class SingleScenarioRunner;
 class Curve;
@@ -112,6 +113,11 @@ private:
     RegionCurves mRegionalCostCurves;
 
     bool runTrials();
+    bool runTrialsInProcess( const std::vector<int>& aPoints );
+    bool runTrial( const int aPoint );
+    bool runTrialsInProcesses( const int aNumWorkers );
+    static void writeCurves( std::ostream& aOut, const RegionCurves& aCurves );
+    static bool readCurves( std::istream& aIn, RegionCurves& aCurves );
     void createCostCurvesByPeriod();
     void createRegionalCostCurves();
     const std::string createXMLOutputString() const;
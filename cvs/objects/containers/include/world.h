@@ -60,6 +60,8 @@ class Region;
 class ILogger;
 class Curve;
 class CalcCounter;
+class ActivityProfiler;
+class CalcTrace;
 class IClimateModel;
 class GHGPolicy;
 class GlobalTechnologyDatabase;
@@ -87,6 +89,21 @@ class GcamFlowGraph;
 class World: public IVisitable, private boost::noncopyable
 {
 public:
+    /*!
+     * \brief The accuracy with which calc evaluates the model.
+     * \details Solvers may ask for a reduced accuracy while they are far from
+     *          a solution, in which case activities may skip or approximate
+     *          refinements which are expensive to calculate.  A solution must
+     *          always be confirmed at full accuracy.
+     */
+    enum EvalAccuracy {
+        //! Every activity is calculated exactly.
+        FULL_ACCURACY,
+        
+        //! Activities may approximate expensive refinements.
+        REDUCED_ACCURACY
+    };
+    
     World();
     ~World();
     void XMLParse( const xercesc::DOMNode* node );
@@ -99,17 +116,28 @@ public:
 
     void calc( const int period );
     void calc( const int period, const std::vector<IActivity*>& aRegionsToCalc );
-    void setEmissions( int period );
+    void setEmissions( const int aStartPeriod, const int aEndPeriod );
     void runClimateModel();
     void runClimateModel( int period );
     const std::map<std::string,int> getOutputRegionMap() const;
     bool isAllCalibrated( const int period, double calAccuracy, const bool printWarnings ) const;
     void setTax( const GHGPolicy* aTax );
+    bool updateFixedTaxes( const std::string& aTaxName, const std::vector<double>& aFixedTaxes );
     const IClimateModel* getClimateModel() const;
+    IClimateModel* getClimateModel();
     std::map<std::string, const Curve*> getEmissionsQuantityCurves( const std::string& ghgName ) const;
     std::map<std::string, const Curve*> getEmissionsPriceCurves( const std::string& ghgName ) const;
     CalcCounter* getCalcCounter() const;
+    ActivityProfiler* getActivityProfiler() const;
+    void startCalcTrace( const int aPeriod );
+    void stopCalcTrace();
+    CalcTrace* getCalcTrace() const;
+    void setEvalAccuracy( const EvalAccuracy aAccuracy );
+    
+    //! Get the accuracy with which calc currently evaluates the model.
+    EvalAccuracy getEvalAccuracy() const {return mEvalAccuracy;}
     int getGlobalOrderingSize() const {return mGlobalOrdering.size();}
+    const std::vector<IActivity*>& getGlobalOrdering() const {return mGlobalOrdering;}
     
     const GlobalTechnologyDatabase* getGlobalTechnologyDatabase() const;
 
@@ -160,7 +188,18 @@ protected:
     //! The global ordering of activities which can be used to calculate the model.
     std::vector<IActivity*> mGlobalOrdering;
 
+    //! Measures the calculation of each activity, or null if not profiling.
+    ActivityProfiler* mActivityProfiler;
+
+    //! Records the calls to calc, or null if not tracing.
+    CalcTrace* mCalcTrace;
+    
+    //! The accuracy with which calc evaluates the model.
+    EvalAccuracy mEvalAccuracy;
+
     void clear();
+    
+    void calcRegionLocalPhase( void (Region::*aPhase)( const int ), const int aPeriod );
 };
 
 #endif // _WORLD_H_
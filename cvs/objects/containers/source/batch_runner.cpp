@@ -43,6 +43,23 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define GCAM_BATCH_FORK 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#define GCAM_BATCH_FORK 0
+#include <fcntl.h>
+#include <io.h>
+#include <direct.h>
+#endif
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "containers/include/batch_runner.h"
@@ -53,6 +70,11 @@
 #include "util/logger/include/ilogger.h"
 #include "containers/include/scenario.h"
 #include "reporting/include/batch_csv_outputter.h"
+#include "util/base/include/input_image.h"
+#include "util/base/include/input_prefetcher.h"
+#include "util/base/include/validation_cache.h"
+#include "util/base/include/auto_file.h"
+#include "util/logger/include/logger_factory.h"
 
 using namespace std;
 using namespace xercesc;
@@ -61,6 +83,71 @@ extern Scenario* scenario;
 
 typedef list<IScenarioRunner*>::iterator RunnerIterator;
 
+namespace {
+    /*!
+     * \brief Create a file only if it does not already exist.
+     * \details The check and the creation are a single operation so that only
+     *          one of several processes sharing the directory can succeed.
+     * \param aFileName The name of the file to create.
+     * \return Whether the file was created by this call.
+     */
+    bool createExclusive( const string& aFileName ){
+#if GCAM_BATCH_FORK
+        const int fd = open( aFileName.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644 );
+        if( fd < 0 ){
+            return false;
+        }
+        close( fd );
+#else
+        const int fd = _open( aFileName.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL, _S_IREAD | _S_IWRITE );
+        if( fd < 0 ){
+            return false;
+        }
+        _close( fd );
+#endif
+        return true;
+    }
+
+    //! Create a directory, if it does not already exist.
+    void createDirectory( const string& aDirName ){
+#if GCAM_BATCH_FORK
+        mkdir( aDirName.c_str(), 0755 );
+#else
+        _mkdir( aDirName.c_str() );
+#endif
+    }
+
+    //! The path, without extension, of the files for the given job in the queue.
+    string getJobPath( const string& aQueueDir, const size_t aJob ){
+        return aQueueDir + "/job-" + util::toString( aJob );
+    }
+
+    /*!
+     * \brief Read the status recorded for a job when it finished.
+     * \return The status, or an empty string if the job has not finished.
+     */
+    string readJobStatus( const string& aJobPath ){
+        ifstream statusFile( ( aJobPath + ".done" ).c_str() );
+        string status;
+        getline( statusFile, status );
+        return status;
+    }
+
+    /*!
+     * \brief Record that a job has finished.
+     * \details The status is written to a temporary file which is then renamed
+     *          so that other processes never see a partially written status.
+     */
+    void writeJobStatus( const string& aJobPath, const string& aStatus ){
+        const string tempName = aJobPath + ".done.tmp";
+        {
+            ofstream statusFile( tempName.c_str() );
+            statusFile << aStatus << endl;
+        }
+        rename( tempName.c_str(), ( aJobPath + ".done" ).c_str() );
+    }
+}
+
 /*!
  * \brief Constructor
  */
@@ -111,32 +198,80 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
         return false;
     }
 
+    if( Configuration::getInstance()->getBool( "batch-share-inputs", false, false ) ){
+        shareCommonInputs();
+    }
+
+    const vector<Component> combinations = getCombinations();
+    const string queueDir = Configuration::getInstance()->getFile( "batch-queue-dir", "", false );
+    bool success = true;
+    if( !queueDir.empty() ){
+        success = runQueuedScenarios( combinations, queueDir, aSinglePeriod, aTimer );
+    }
+    else {
+        // The inputs of the next scenario may be read while the current one
+        // solves, unless they are streamed in rather than read as documents.
+        const Configuration* conf = Configuration::getInstance();
+        if( conf->getBool( "batch-prefetch-inputs", false, false ) &&
+            !conf->getBool( "stream-xml-input", false, false ) )
+        {
+            mPrefetcher.reset( new InputPrefetcher() );
+        }
+        // All generated scenarios are run with each scenario runner in the
+        // order in which the scenario runners were read.
+        BatchCSVOutputter csvOutputter;
+        for( vector<Component>::const_iterator fileSetsToRun = combinations.begin(); fileSetsToRun != combinations.end(); ++fileSetsToRun ){
+            // Run it using each possible type of IScenarioRunner.
+            for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
+                RunnerIterator nextRunner = runner;
+                ++nextRunner;
+                const Component* nextFileSets = nextRunner != mScenarioRunners.end() ? &*fileSetsToRun :
+                    fileSetsToRun + 1 != combinations.end() ? &*( fileSetsToRun + 1 ) : 0;
+                bool scenarioSuccess = runSingleScenario( *runner, *fileSetsToRun, aSinglePeriod, aTimer,
+                                                          nextFileSets );
+                success &= scenarioSuccess;
+                (*runner)->getInternalScenario()->accept( &csvOutputter, -1 );
+                csvOutputter.writeDidScenarioSolve( scenarioSuccess );
+                // Clean up the current scenario runner before we move on to the next
+                // so that we do not accumulate a large amount of idle memory.
+                (*runner)->cleanup();
+            }
+        }
+        mPrefetcher.reset();
+    }
+    InputImage::releaseShared();
+    return success;
+}
+
+/*!
+ * \brief Create all combinations of the file sets in the order they are run.
+ * \details The scenarios are created by determining all possible combinations
+ *          of file sets. The algorithm operates as follows:
+ *          1) Set the current file set in each component to the initial position.
+ *          2) Add the scenario.
+ *          3) Set the current component to the first.
+ *          4) Increment the current file set in the current component.
+ *          5a) If this is a valid position in the current component and go to 2.
+ *          5b) Otherwise, reset the current file set in the current component to
+ *              the first position.
+ *          6a) If the current component is the last component exit the algorithm.
+ *          6b) Otherwise, increment the current component and go to 4.
+ *
+ *          Example: assume there are two components A and B. A has two file
+ *          sets named 1 and 2, and B has two file sets named 3 and 4. The
+ *          scenarios would be run in the order: [A1, B1], [A2, B1], [A1, B2],
+ *          [A2, B2]
+ * \return The combinations of file sets, each named by the names of its file
+ *         sets.
+ */
+vector<BatchRunner::Component> BatchRunner::getCombinations() {
     // Initialize each components iterator to the beginning of the vector. 
     for( ComponentSet::iterator currSet = mComponentSet.begin(); currSet != mComponentSet.end(); ++currSet ){
         currSet->mFileSetIterator = currSet->mFileSets.begin();
     }
-    
-    // The scenarios are created by determining all possible combinations of
-    // file sets. The algorithm operates as follows:
-    // 1) Set the current file set in each component to the initial position.
-    // 2) Run the scenario.
-    // 3) Set the current component to the first.
-    // 4) Increment the current file set in the current component.
-    // 5a) If this is a valid position in the current component and go to 2.
-    // 5b) Otherwise, reset the current file set in the current component to
-    //     the first position.
-    // 6a) If the current component is the last component exit the algorithm.
-    // 6b) Otherwise, increment the current component and go to 4.
-    //
-    // Example: assume there are two components A and B. A has two file sets
-    // named 1 and 2, and B has two file sets named 3 and 4. The scenarios would
-    // be run in the order: [A1, B1], [A2, B1], [A1, B2], [A2, B2]
-    //
-    // All generated scenarios are run with each scenario runner in the order in
-    // which the scenario runners were read.
+
+    vector<Component> combinations;
     bool shouldExit = false;
-    bool success = true;
-    BatchCSVOutputter csvOutputter;
     while( !shouldExit ){
         // The data structure containing the current run.
         Component fileSetsToRun;
@@ -146,17 +281,7 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             fileSetsToRun.mFileSets.push_back( *( currSet->mFileSetIterator ) );
             fileSetsToRun.mName += currSet->mFileSetIterator->mName;
         }
-
-        // Run it using each possible type of IScenarioRunner.
-        for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
-            bool scenarioSuccess = runSingleScenario( *runner, fileSetsToRun, aSinglePeriod, aTimer );
-            success &= scenarioSuccess;
-            (*runner)->getInternalScenario()->accept( &csvOutputter, -1 );
-            csvOutputter.writeDidScenarioSolve( scenarioSuccess );
-            // Clean up the current scenario runner before we move on to the next
-            // so that we do not accumulate a large amount of idle memory.
-            (*runner)->cleanup();
-        }
+        combinations.push_back( fileSetsToRun );
 
         // Loop forward to find a position to increment.
         for( ComponentSet::iterator outPos = mComponentSet.begin(); outPos != mComponentSet.end(); ++outPos ){
@@ -175,9 +300,321 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             }
         }
     }
+    return combinations;
+}
+
+/*!
+ * \brief Run the scenarios from a job queue shared with other processes.
+ * \details Each combination of file sets and scenario runner is a job, numbered
+ *          in the order in which the scenarios would be run by a single
+ *          process. The queue is a directory, which may be on a file system
+ *          shared by several nodes, and any number of GCAM processes using the
+ *          same batch file and queue directory may work on it at once, for
+ *          instance started by mpirun or a job scheduler. A process takes a
+ *          job by creating the file job-N.claim, which only one process can
+ *          do, writes the results of the scenario to job-N.csv and then
+ *          records whether it solved in job-N.done.
+ *
+ *          Unless the integer configuration value "batch-workers" is zero each
+ *          job is run in a separate child process, and that many jobs are run
+ *          at once, so that a scenario which crashes does not stop the rest of
+ *          the batch. Such a scenario is recorded as crashed and reported as
+ *          not solved. This is only possible on POSIX systems, elsewhere jobs
+ *          are run in this process.
+ *
+ *          The process which finishes the last job merges the results of all
+ *          jobs, in order, into the batch CSV file. The queue directory must
+ *          be empty when the batch is started. If a process is killed its
+ *          claimed jobs are never finished, their claim files must be removed
+ *          and a process started to run them again.
+ * \param aCombinations The combinations of file sets to run.
+ * \param aQueueDir The directory containing the queue.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether all the scenarios run by this process solved.
+ */
+bool BatchRunner::runQueuedScenarios( const vector<Component>& aCombinations,
+                                      const string& aQueueDir,
+                                      const int aSinglePeriod,
+                                      Timer& aTimer )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    int numWorkers = Configuration::getInstance()->getInt( "batch-workers", 1, false );
+#if !GCAM_BATCH_FORK
+    if( numWorkers > 0 ){
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Scenarios can only be run in separate processes on POSIX systems." << endl;
+        numWorkers = 0;
+    }
+#endif
+    createDirectory( aQueueDir );
+
+    const vector<IScenarioRunner*> runners( mScenarioRunners.begin(), mScenarioRunners.end() );
+    const size_t numJobs = aCombinations.size() * runners.size();
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running scenarios from the queue in " << aQueueDir << " which has "
+            << numJobs << " scenarios." << endl;
+
+    bool success = true;
+#if GCAM_BATCH_FORK
+    // The running child processes and the job each is running.
+    map<pid_t, size_t> running;
+#endif
+    for( size_t job = 0; job < numJobs; ++job ){
+        const string jobPath = getJobPath( aQueueDir, job );
+        if( !createExclusive( jobPath + ".claim" ) ){
+            // Another process has taken this job.
+            continue;
+        }
+        const Component& fileSetsToRun = aCombinations[ job / runners.size() ];
+        IScenarioRunner* runner = runners[ job % runners.size() ];
+        if( numWorkers <= 0 ){
+            success &= runJob( runner, fileSetsToRun, jobPath, aSinglePeriod, aTimer );
+            continue;
+        }
+#if GCAM_BATCH_FORK
+        while( running.size() >= static_cast<size_t>( numWorkers ) ){
+            success &= waitForJob( running, aCombinations, runners.size(), aQueueDir );
+        }
+        LoggerFactory::beforeFork();
+        const pid_t pid = fork();
+        if( pid == 0 ){
+            LoggerFactory::afterFork( "job-" + util::toString( job ) );
+            const bool solved = runJob( runner, fileSetsToRun, jobPath, aSinglePeriod, aTimer );
+            LoggerFactory::cleanUp();
+            cout.flush();
+            _exit( solved ? 0 : 1 );
+        }
+        LoggerFactory::afterFork( "" );
+        if( pid < 0 ){
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Could not start a process to run scenario " << fileSetsToRun.mName << "." << endl;
+            writeJobStatus( jobPath, "crashed" );
+            mUnsolvedNames.push_back( fileSetsToRun.mName );
+            success = false;
+            continue;
+        }
+        running[ pid ] = job;
+#endif
+    }
+#if GCAM_BATCH_FORK
+    while( !running.empty() ){
+        success &= waitForJob( running, aCombinations, runners.size(), aQueueDir );
+    }
+#endif
+    mergeQueuedResults( aCombinations, runners.size(), aQueueDir );
     return success;
 }
 
+/*!
+ * \brief Run a single job from the queue and record its results.
+ * \param aScenarioRunner The scenario runner to use for the scenario.
+ * \param aComponent The file sets of the scenario.
+ * \param aJobPath The path of the files for the job.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether the scenario solved.
+ */
+bool BatchRunner::runJob( IScenarioRunner* aScenarioRunner,
+                          const Component& aComponent,
+                          const string& aJobPath,
+                          const int aSinglePeriod,
+                          Timer& aTimer )
+{
+    const bool solved = runSingleScenario( aScenarioRunner, aComponent, aSinglePeriod, aTimer );
+    {
+        BatchCSVOutputter csvOutputter( aJobPath + ".csv" );
+        aScenarioRunner->getInternalScenario()->accept( &csvOutputter, -1 );
+        csvOutputter.writeDidScenarioSolve( solved );
+    }
+    aScenarioRunner->cleanup();
+    writeJobStatus( aJobPath, solved ? "solved" : "failed" );
+    return solved;
+}
+
+#if GCAM_BATCH_FORK
+/*!
+ * \brief Wait for one of the child processes running a job to exit.
+ * \details If the child exited without recording the status of its job it is
+ *          recorded as crashed.
+ * \param aRunning The running child processes and their jobs, from which the
+ *        exited child is removed.
+ * \param aCombinations The combinations of file sets being run.
+ * \param aNumRunners The number of scenario runners.
+ * \param aQueueDir The directory containing the queue.
+ * \return Whether the job solved.
+ */
+bool BatchRunner::waitForJob( map<pid_t, size_t>& aRunning,
+                              const vector<Component>& aCombinations,
+                              const size_t aNumRunners,
+                              const string& aQueueDir )
+{
+    int exitStatus = 0;
+    const pid_t pid = waitpid( -1, &exitStatus, 0 );
+    map<pid_t, size_t>::iterator child = aRunning.find( pid );
+    if( child == aRunning.end() ){
+        if( pid < 0 ){
+            // There are no children left to wait for.
+            aRunning.clear();
+        }
+        return true;
+    }
+    const size_t job = child->second;
+    aRunning.erase( child );
+
+    const string& name = aCombinations[ job / aNumRunners ].mName;
+    const string jobPath = getJobPath( aQueueDir, job );
+    string status = readJobStatus( jobPath );
+    if( status.empty() ){
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Scenario " << name << " crashed";
+        if( WIFSIGNALED( exitStatus ) ){
+            mainLog << " with signal " << WTERMSIG( exitStatus );
+        }
+        mainLog << "." << endl;
+        status = "crashed";
+        writeJobStatus( jobPath, status );
+    }
+    if( status != "solved" ){
+        mUnsolvedNames.push_back( name );
+        return false;
+    }
+    return true;
+}
+#endif
+
+/*!
+ * \brief Merge the results of all jobs into the batch CSV file once all have
+ *        finished.
+ * \details Does nothing if any job is unfinished, since the process which
+ *          finishes it will do the merge, or if another process has already
+ *          started the merge. Jobs without results, such as those which
+ *          crashed, are written as a row with only the scenario name and
+ *          whether it solved. If batch-delta-output is set the rows are delta
+ *          encoded against the first job as described for BatchCSVOutputter.
+ * \param aCombinations The combinations of file sets being run.
+ * \param aNumRunners The number of scenario runners.
+ * \param aQueueDir The directory containing the queue.
+ */
+void BatchRunner::mergeQueuedResults( const vector<Component>& aCombinations,
+                                      const size_t aNumRunners,
+                                      const string& aQueueDir ) const
+{
+    const size_t numJobs = aCombinations.size() * aNumRunners;
+    for( size_t job = 0; job < numJobs; ++job ){
+        if( readJobStatus( getJobPath( aQueueDir, job ) ).empty() ){
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Scenarios are still running in other processes which will write the batch results." << endl;
+            return;
+        }
+    }
+    if( !createExclusive( aQueueDir + "/merge.claim" ) ){
+        return;
+    }
+
+    // Read the results of each job, the header is the same for all of them.
+    string header;
+    vector<string> results( numJobs );
+    for( size_t job = 0; job < numJobs; ++job ){
+        ifstream jobResults( ( getJobPath( aQueueDir, job ) + ".csv" ).c_str() );
+        string line;
+        if( getline( jobResults, line ) && header.empty() ){
+            header = line;
+        }
+        while( getline( jobResults, line ) ){
+            results[ job ] += line;
+            results[ job ] += '\n';
+        }
+    }
+    if( header.empty() ){
+        header = "Scenario,Solved";
+    }
+    const size_t numColumns = count( header.begin(), header.end(), ',' ) + 1;
+
+    // When delta encoding each job wrote its row in full, so encode them here
+    // against the first job. Jobs without results are written with NA values
+    // so that they are not reconstructed as the reference values.
+    const bool isDeltaOutput = BatchCSVOutputter::isDeltaOutput();
+    const double deltaTolerance = Configuration::getInstance()->getDouble( "batch-delta-tolerance", 0, false );
+    string referenceRow;
+
+    AutoOutputFile batchFile( "batchCSVOutputFile", "batch-csv-out.csv" );
+    batchFile << header << '\n';
+    for( size_t job = 0; job < numJobs; ++job ){
+        string row;
+        if( !results[ job ].empty() ){
+            row = results[ job ].substr( 0, results[ job ].find( '\n' ) );
+        }
+        else {
+            row = aCombinations[ job / aNumRunners ].mName;
+            for( size_t column = 1; column < numColumns - 1; ++column ){
+                row += isDeltaOutput ? ",NA" : ",";
+            }
+            row += ",0";
+        }
+        if( isDeltaOutput ){
+            if( job == 0 ){
+                referenceRow = row;
+            }
+            else {
+                row = BatchCSVOutputter::encodeDeltaRow( referenceRow, row, deltaTolerance );
+            }
+        }
+        batchFile << row << '\n';
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Merged the results of " << numJobs << " scenarios." << endl;
+}
+
+/*!
+ * \brief Read the input files which are the same for every scenario once.
+ * \details The common inputs are the base input file, the scenario components
+ *          from the configuration and the files of any leading components
+ *          which have only a single file set. These are compiled into an
+ *          input image in memory from which each scenario is then parsed
+ *          without reading the XML again. Only the file sets which vary
+ *          between scenarios are read as XML for each scenario. If the inputs
+ *          could not be read they are simply read for each scenario instead.
+ *          With share-inputs-across-processes the image is kept in shared
+ *          memory for all of the processes on the node.
+ */
+void BatchRunner::shareCommonInputs() const {
+    const Configuration* conf = Configuration::getInstance();
+    vector<string> commonFiles( 1, conf->getFile( "xmlInputFileName" ) );
+    const list<string>& scenComponents = conf->getScenarioComponents();
+    commonFiles.insert( commonFiles.end(), scenComponents.begin(), scenComponents.end() );
+    for( ComponentSet::const_iterator currSet = mComponentSet.begin(); currSet != mComponentSet.end(); ++currSet ){
+        if( currSet->mFileSets.size() != 1 ){
+            break;
+        }
+        const FileSet& fileSet = currSet->mFileSets.front();
+        for( list<File>::const_iterator currFile = fileSet.mFiles.begin(); currFile != fileSet.mFiles.end(); ++currFile ){
+            commonFiles.push_back( currFile->mPath );
+        }
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Reading " << commonFiles.size() << " input files shared by all scenarios." << endl;
+    // The batches run by the processes on a node may also share one copy.
+    const bool validate = conf->getBool( "validate-xml-input", true, false );
+    const bool shared = conf->getBool( "share-inputs-across-processes", false, false ) ?
+        InputImage::attachNodeShared( commonFiles, validate ) :
+        InputImage::compileShared( commonFiles, validate );
+    if( !shared ){
+        InputImage::releaseShared();
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not read the shared inputs, they will be read for each scenario." << endl;
+    }
+    XMLHelper<void>::cleanupParser();
+}
+
 void BatchRunner::printOutput( Timer& aTimer ) const {
     // Print out any scenarios that did not solve.
     ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -213,12 +650,15 @@ void BatchRunner::cleanup() {
  * \param aSinglePeriod The model period to run.
  * \param aTimer The timer used to print out the amount of time spent performing
  *        operations.
+ * \param aNextComponent The file sets of the scenario which will be run next,
+ *        whose inputs are read ahead if enabled, or null if there is none.
  * \return Whether the model run solved successfully.
  */
 bool BatchRunner::runSingleScenario( IScenarioRunner* aScenarioRunner,
                                      const Component& aComponent,
                                      const int aSinglePeriod,
-                                     Timer& aTimer )
+                                     Timer& aTimer,
+                                     const Component* aNextComponent )
 {
     // Set the current scenario runner.
     mInternalRunner = aScenarioRunner;
@@ -240,7 +680,10 @@ bool BatchRunner::runSingleScenario( IScenarioRunner* aScenarioRunner,
             << " with scenario runner " << aScenarioRunner->getName()
             << "." << endl;
 
-    // Setup the scenario.
+    // Setup the scenario, once any of its inputs being read ahead are ready.
+    if( mPrefetcher.get() ){
+        mPrefetcher->wait();
+    }
     const string runName = aComponent.mName;
     bool success = mInternalRunner->setupScenarios( aTimer, runName, components );
     // Check if setting up the scenario, which often includes parsing,
@@ -254,6 +697,11 @@ bool BatchRunner::runSingleScenario( IScenarioRunner* aScenarioRunner,
     
     // Cleanup parser and associated memory now to save space while the scenario is running.
     XMLHelper<void>::cleanupParser();
+
+    // Read the inputs of the next scenario while this one runs.
+    if( mPrefetcher.get() && aNextComponent ){
+        prefetchInputs( *aNextComponent );
+    }
     
     // the value for aSinglePeriod may not have been properly set because in batch mode
     // the model time may not have been available
@@ -274,6 +722,37 @@ bool BatchRunner::runSingleScenario( IScenarioRunner* aScenarioRunner,
     return success;
 }
 
+/*!
+ * \brief Start reading the inputs of a scenario ahead of running it.
+ * \details Only the files of the components which have more than one file set
+ *          are read since those of the others are the same for every scenario
+ *          and may already be shared.  Whether to validate each file is
+ *          decided the same way as it will be when the scenario is set up.
+ * \param aComponent The file sets of the scenario.
+ */
+void BatchRunner::prefetchInputs( const Component& aComponent ) {
+    const Configuration* conf = Configuration::getInstance();
+    ValidationCache validationCache( conf->getBool( "validate-xml-input", true, false ),
+                                     conf->getFile( "xml-validation-cache", "", false ),
+                                     conf->getString( "xml-schema-version", "", false ),
+                                     conf->getBool( "force-xml-validation", false, false ) );
+    vector<string> files;
+    vector<bool> validate;
+    ComponentSet::const_iterator currSet = mComponentSet.begin();
+    for( list<FileSet>::const_iterator currFileSet = aComponent.mFileSets.begin();
+         currFileSet != aComponent.mFileSets.end(); ++currFileSet, ++currSet )
+    {
+        if( currSet->mFileSets.size() == 1 ){
+            continue;
+        }
+        for( list<File>::const_iterator currFile = currFileSet->mFiles.begin(); currFile != currFileSet->mFiles.end(); ++currFile ){
+            files.push_back( currFile->mPath );
+            validate.push_back( validationCache.shouldValidate( currFile->mPath ) );
+        }
+    }
+    mPrefetcher->start( files, validate );
+}
+
 bool BatchRunner::XMLParse( const DOMNode* aRoot ){
     // assume we were passed a valid node.
     assert( aRoot );
@@ -0,0 +1,419 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file ensemble_runner.cpp
+ * \ingroup Objects
+ * \brief EnsembleRunner class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+#include "containers/include/ensemble_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "containers/include/single_scenario_runner.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/auto_file.h"
+#include "util/base/include/process_pool.h"
+#include "util/base/include/value.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+#include "util/logger/include/ilogger.h"
+#include "reporting/include/batch_csv_outputter.h"
+
+using namespace std;
+using namespace xercesc;
+
+//! Constructor
+EnsembleRunner::EnsembleRunner():
+mNumWorkers( 1 ),
+mHasParsedConfig( false )
+{
+}
+
+//! Destructor
+EnsembleRunner::~EnsembleRunner(){
+}
+
+const string& EnsembleRunner::getName() const {
+    return mName;
+}
+
+const string& EnsembleRunner::getXMLNameStatic(){
+    static const string XML_NAME = "ensemble-runner";
+    return XML_NAME;
+}
+
+bool EnsembleRunner::XMLParse( const DOMNode* aRoot ){
+    // Check for double initialization.
+    assert( !mHasParsedConfig );
+    mHasParsedConfig = true;
+
+    // assume we were passed a valid node.
+    assert( aRoot );
+
+    mName = XMLHelper<string>::getAttr( aRoot, XMLHelper<void>::name() );
+
+    DOMNodeList* nodeList = aRoot->getChildNodes();
+    bool success = true;
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        const DOMNode* curr = nodeList->item( i );
+        const string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+
+        if( nodeName == XMLHelper<void>::text() ){
+            continue;
+        }
+        else if( nodeName == "workers" ){
+            mNumWorkers = max( XMLHelper<int>::getValue( curr ), 1 );
+        }
+        else if( nodeName == "member" ){
+            success &= XMLParseMember( curr );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized string: " << nodeName
+                    << " found while parsing " << getXMLNameStatic() << "." << endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+/*!
+ * \brief Parse a single member of the ensemble.
+ * \param aNode The member node.
+ * \return Whether the member was parsed successfully.
+ */
+bool EnsembleRunner::XMLParseMember( const DOMNode* aNode ){
+    Member newMember;
+    newMember.mName = XMLHelper<string>::getAttr( aNode, XMLHelper<void>::name() );
+
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    bool success = true;
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        const DOMNode* curr = nodeList->item( i );
+        const string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+
+        if( nodeName == XMLHelper<void>::text() ){
+            continue;
+        }
+        else if( nodeName == "parameter" ){
+            Perturbation perturbation;
+            perturbation.mPath = XMLHelper<string>::getAttr( curr, "path" );
+            perturbation.mValue = XMLHelper<double>::getValue( curr );
+            const string operation = XMLHelper<string>::getAttr( curr, "operation" );
+            if( operation.empty() || operation == "set" ){
+                perturbation.mOperation = Perturbation::eSet;
+            }
+            else if( operation == "multiply" ){
+                perturbation.mOperation = Perturbation::eMultiply;
+            }
+            else if( operation == "add" ){
+                perturbation.mOperation = Perturbation::eAdd;
+            }
+            else {
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::ERROR );
+                mainLog << "Unknown operation " << operation << " for a parameter of ensemble member "
+                        << newMember.mName << "." << endl;
+                success = false;
+                continue;
+            }
+            newMember.mPerturbations.push_back( perturbation );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized string: " << nodeName
+                    << " found while parsing an ensemble member." << endl;
+            success = false;
+        }
+    }
+    mMembers.push_back( newMember );
+    return success;
+}
+
+bool EnsembleRunner::setupScenarios( Timer& aTimer,
+                                     const string aName,
+                                     const list<string> aScenComponents )
+{
+    // Read in and initialize the scenario which all members start from.
+    mSingleScenario = ScenarioRunnerFactory::createSingleScenarioRunner();
+    bool success = mSingleScenario->setupScenarios( aTimer, aName, aScenComponents );
+
+    // Only read from the configuration file if the ensemble has not already
+    // been parsed from the BatchRunner configuration file.
+    if( !mHasParsedConfig ){
+        const string fileName = Configuration::getInstance()->getFile( "ensemble-file" );
+        if( fileName.empty() ){
+            return false;
+        }
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Reading ensemble configuration file " << fileName << endl;
+        success &= XMLHelper<void>::parseXML( fileName, this );
+    }
+
+    if( mMembers.empty() ){
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The ensemble does not have any members." << endl;
+        return false;
+    }
+    return success;
+}
+
+bool EnsembleRunner::runScenarios( const int aSinglePeriod,
+                                   const bool aPrintDebugging,
+                                   Timer& aTimer )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running an ensemble of " << mMembers.size() << " members." << endl;
+
+    mResults.assign( mMembers.size(), string() );
+    mUnsolvedNames.clear();
+    bool success = true;
+    if( ProcessPool::isAvailable() ){
+        // The parameters do not need to be put back since each member runs in
+        // its own copy of the scenario.
+        ProcessPool::Task task = [&]( const int aMember, string& aResults ) {
+            OriginalValues originalValues;
+            return runMember( mMembers[ aMember ], aSinglePeriod, aTimer, aResults, originalValues );
+        };
+        const vector<ProcessPool::Result> results = ProcessPool::run( mMembers.size(), mNumWorkers,
+                                                                      "ensemble", task );
+        for( size_t member = 0; member < mMembers.size(); ++member ){
+            if( results[ member ].mCompleted ){
+                mResults[ member ] = results[ member ].mOutput;
+            }
+            if( !results[ member ].mCompleted || !results[ member ].mSuccess ){
+                mUnsolvedNames.push_back( mMembers[ member ].mName );
+                success = false;
+            }
+        }
+    }
+    else {
+        const string scenarioName = getInternalScenario()->getName();
+        for( size_t member = 0; member < mMembers.size(); ++member ){
+            OriginalValues originalValues;
+            if( !runMember( mMembers[ member ], aSinglePeriod, aTimer, mResults[ member ], originalValues ) ){
+                mUnsolvedNames.push_back( mMembers[ member ].mName );
+                success = false;
+            }
+            restoreValues( originalValues );
+        }
+        getInternalScenario()->setName( scenarioName );
+    }
+    return success;
+}
+
+/*!
+ * \brief Change the parameters of a member, run the scenario and record the
+ *        results.
+ * \param aMember The member to run.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \param aResults The results as written by the BatchCSVOutputter.
+ * \param aOriginalValues The values of the parameters before they were changed.
+ * \return Whether the scenario solved.
+ */
+bool EnsembleRunner::runMember( const Member& aMember,
+                                const int aSinglePeriod,
+                                Timer& aTimer,
+                                string& aResults,
+                                OriginalValues& aOriginalValues )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running ensemble member " << aMember.mName << "." << endl;
+
+    Scenario* currScenario = getInternalScenario();
+    currScenario->setName( aMember.mName );
+    bool success = applyPerturbations( aMember, aOriginalValues );
+    success &= mSingleScenario->runScenarios( aSinglePeriod, false, aTimer );
+
+    ostringstream results;
+    {
+        BatchCSVOutputter csvOutputter( results );
+        currScenario->accept( &csvOutputter, -1 );
+        csvOutputter.writeDidScenarioSolve( success );
+    }
+    aResults = results.str();
+    return success;
+}
+
+namespace {
+    /*!
+     * \brief Change a single parameter and remember its original value.
+     * \param aParameter The parameter to change.
+     * \param aOperation How to change it.
+     * \param aValue The value to change it by.
+     * \param aOriginalValues The list to add the original value to.
+     */
+    template<typename T, typename OperationType>
+    void perturb( T* aParameter, const OperationType aOperation, const double aValue,
+                  vector<pair<T*, double> >& aOriginalValues )
+    {
+        const double original = *aParameter;
+        aOriginalValues.push_back( make_pair( aParameter, original ) );
+        switch( aOperation ){
+            case OperationType::eSet:
+                *aParameter = aValue;
+                break;
+            case OperationType::eMultiply:
+                *aParameter = original * aValue;
+                break;
+            case OperationType::eAdd:
+                *aParameter = original + aValue;
+                break;
+        }
+    }
+}
+
+/*!
+ * \brief Change the parameters of a member in the scenario.
+ * \param aMember The member to change the parameters of.
+ * \param aOriginalValues The values of the parameters before they were changed.
+ * \return Whether every parameter was found.
+ */
+bool EnsembleRunner::applyPerturbations( const Member& aMember, OriginalValues& aOriginalValues ) {
+    Scenario* currScenario = getInternalScenario();
+    bool success = true;
+    for( vector<Perturbation>::const_iterator perturbation = aMember.mPerturbations.begin();
+         perturbation != aMember.mPerturbations.end(); ++perturbation )
+    {
+        GCAMFusionQuery<Value> valueQuery( perturbation->mPath );
+        GCAMFusionQuery<double> doubleQuery( perturbation->mPath );
+        const vector<Value*>& values = valueQuery.find( currScenario );
+        const vector<double*>& doubles = doubleQuery.find( currScenario );
+        for( Value* value : values ){
+            perturb( value, perturbation->mOperation, perturbation->mValue, aOriginalValues.mValues );
+        }
+        for( double* value : doubles ){
+            perturb( value, perturbation->mOperation, perturbation->mValue, aOriginalValues.mDoubles );
+        }
+        if( values.empty() && doubles.empty() ){
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "No parameters found for " << perturbation->mPath << " in ensemble member "
+                    << aMember.mName << "." << endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+/*!
+ * \brief Put back the parameters changed by applyPerturbations.
+ * \details The values are put back in the reverse order in which they were
+ *          changed so that a parameter changed more than once gets its
+ *          first value.
+ * \param aOriginalValues The values of the parameters before they were changed.
+ */
+void EnsembleRunner::restoreValues( const OriginalValues& aOriginalValues ) {
+    for( auto value = aOriginalValues.mValues.rbegin(); value != aOriginalValues.mValues.rend(); ++value ){
+        *value->first = value->second;
+    }
+    for( auto value = aOriginalValues.mDoubles.rbegin(); value != aOriginalValues.mDoubles.rend(); ++value ){
+        *value->first = value->second;
+    }
+}
+
+void EnsembleRunner::printOutput( Timer& aTimer ) const {
+    // The header is the same for all members.
+    string header;
+    vector<string> rows( mResults.size() );
+    for( size_t member = 0; member < mResults.size(); ++member ){
+        istringstream results( mResults[ member ] );
+        string line;
+        if( getline( results, line ) && header.empty() ){
+            header = line;
+        }
+        while( getline( results, line ) ){
+            rows[ member ] += line;
+            rows[ member ] += '\n';
+        }
+    }
+    if( header.empty() ){
+        header = "Scenario,Solved";
+    }
+    const size_t numColumns = count( header.begin(), header.end(), ',' ) + 1;
+
+    AutoOutputFile csvFile( "batchCSVOutputFile", "batch-csv-out.csv" );
+    csvFile << header << '\n';
+    for( size_t member = 0; member < rows.size(); ++member ){
+        if( !rows[ member ].empty() ){
+            csvFile << rows[ member ];
+        }
+        else {
+            csvFile << mMembers[ member ].mName << string( numColumns - 1, ',' ) << 0 << '\n';
+        }
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    if( mUnsolvedNames.empty() ){
+        mainLog << "All ensemble members completed successfully." << endl;
+    }
+    else {
+        mainLog << "Ensemble members that did not solve correctly: " << endl;
+        for( vector<string>::const_iterator name = mUnsolvedNames.begin(); name != mUnsolvedNames.end(); ++name ){
+            mainLog << *name << endl;
+        }
+    }
+}
+
+void EnsembleRunner::cleanup() {
+    if( mSingleScenario.get() ){
+        mSingleScenario->cleanup();
+    }
+}
+
+Scenario* EnsembleRunner::getInternalScenario(){
+    return mSingleScenario.get() ? mSingleScenario->getInternalScenario() : 0;
+}
+
+const Scenario* EnsembleRunner::getInternalScenario() const {
+    return mSingleScenario.get() ? mSingleScenario->getInternalScenario() : 0;
+}
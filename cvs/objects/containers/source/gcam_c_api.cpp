@@ -0,0 +1,351 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file gcam_c_api.cpp
+ * \ingroup Objects
+ * \brief The implementation of the C interface for embedding the model.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include "containers/include/gcam_c_api.h"
+#include "containers/include/single_scenario_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "containers/include/scenario.h"
+#include "marketplace/include/marketplace.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/value.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+#include "util/logger/include/ilogger.h"
+#include "util/logger/include/logger_factory.h"
+
+using namespace std;
+
+namespace {
+    /*!
+     * \brief The cached searches for a single search string.
+     * \details A search string may match Values, doubles, or whole vectors of
+     *          Values depending on whether it selects a period.
+     */
+    struct Query {
+        Query( const string& aSearchString ):mValues( aSearchString ),
+        mDoubles( aSearchString ), mVectors( aSearchString ) {}
+
+        GCAMFusionQuery<Value> mValues;
+        GCAMFusionQuery<double> mDoubles;
+        GCAMFusionQuery<objects::PeriodVector<Value> > mVectors;
+    };
+}
+
+/*!
+ * \brief The state of an embedded model.
+ */
+struct GcamSession {
+    GcamSession() {}
+
+    ~GcamSession() {
+        for( map<string, Query*>::iterator query = mQueries.begin(); query != mQueries.end(); ++query ) {
+            delete query->second;
+        }
+        if( mRunner.get() ) {
+            mRunner->cleanup();
+        }
+        XMLHelper<void>::cleanupParser();
+    }
+
+    Scenario* getScenario() const {
+        return mRunner->getInternalScenario();
+    }
+
+    bool isValidMarket( const int aMarket ) const {
+        return aMarket >= 0 && aMarket < static_cast<int>( mMarkets.size() );
+    }
+
+    bool isValidPeriod( const int aPeriod ) const {
+        return aPeriod >= 0 && aPeriod < getScenario()->getModeltime()->getmaxper();
+    }
+
+    Query& getQuery( const string& aSearchString ) {
+        Query*& query = mQueries[ aSearchString ];
+        if( !query ) {
+            query = new Query( aSearchString );
+        }
+        return *query;
+    }
+
+    const double* setResult( int* aLength ) {
+        if( aLength ) {
+            *aLength = static_cast<int>( mResult.size() );
+        }
+        return mResult.empty() ? 0 : &mResult[ 0 ];
+    }
+
+    //! The loggers which are cleaned up with the session.
+    LoggerFactoryWrapper mLoggerFactory;
+
+    //! The timer passed to the scenario runner.
+    Timer mTimer;
+
+    //! The scenario runner which owns the scenario.
+    auto_ptr<SingleScenarioRunner> mRunner;
+
+    //! The good and region names of each market handle.
+    vector<pair<string, string> > mMarkets;
+
+    //! The cached searches by search string.
+    map<string, Query*> mQueries;
+
+    //! The values of the last array returned.
+    vector<double> mResult;
+
+private:
+    // Sessions are not copyable.
+    GcamSession( const GcamSession& );
+    GcamSession& operator=( const GcamSession& );
+};
+
+/*!
+ * \brief Create a session by reading a configuration and setting up its scenario.
+ * \details All of the inputs of the scenario are read and initialized, but no
+ *          periods are run.
+ * \param aConfigurationFile The configuration file to read.
+ * \param aLogConfFile The logger configuration file to read.
+ * \return The new session or null if it could not be set up.
+ */
+GcamSession* gcam_create( const char* aConfigurationFile, const char* aLogConfFile ) {
+    auto_ptr<GcamSession> session( new GcamSession );
+    session->mTimer.start();
+    if( !XMLHelper<void>::parseXML( aLogConfFile, &session->mLoggerFactory ) ||
+        !XMLHelper<void>::parseXML( aConfigurationFile, Configuration::getInstance() ) )
+    {
+        return 0;
+    }
+
+    session->mRunner = ScenarioRunnerFactory::createSingleScenarioRunner();
+    if( !session->mRunner->setupScenarios( session->mTimer ) || !session->getScenario() ) {
+        return 0;
+    }
+    XMLHelper<void>::cleanupParser();
+    return session.release();
+}
+
+/*!
+ * \brief Destroy a session and its scenario.
+ * \param aSession The session to destroy, this may be null.
+ */
+void gcam_destroy( GcamSession* aSession ) {
+    delete aSession;
+}
+
+/*!
+ * \brief Get the number of model periods.
+ * \param aSession The session.
+ * \return The number of model periods.
+ */
+int gcam_get_num_periods( const GcamSession* aSession ) {
+    return aSession->getScenario()->getModeltime()->getmaxper();
+}
+
+/*!
+ * \brief Get the year of a model period.
+ * \param aSession The session.
+ * \param aPeriod The model period.
+ * \return The year of the period or -1 if the period is not valid.
+ */
+int gcam_get_period_year( const GcamSession* aSession, int aPeriod ) {
+    if( !aSession->isValidPeriod( aPeriod ) ) {
+        return -1;
+    }
+    return aSession->getScenario()->getModeltime()->getper_to_yr( aPeriod );
+}
+
+/*!
+ * \brief Run a period of the model.
+ * \details Any earlier periods which have not been run are run first.  All of
+ *          the periods after aPeriod must be run again after this call.  A
+ *          period may be run repeatedly, for instance after changing
+ *          parameters in a coupling iteration.
+ * \param aSession The session.
+ * \param aPeriod The model period to run.
+ * \return 1 if the period solved, 0 if it did not, or -1 if the period is not
+ *         valid.
+ */
+int gcam_run_period( GcamSession* aSession, int aPeriod ) {
+    if( !aSession->isValidPeriod( aPeriod ) ) {
+        return -1;
+    }
+    return aSession->mRunner->runScenarios( aPeriod, false, aSession->mTimer ) ? 1 : 0;
+}
+
+/*!
+ * \brief Write the configured outputs, such as the XML database, of the periods
+ *        which have been run.
+ * \param aSession The session.
+ * \return 0.
+ */
+int gcam_write_outputs( GcamSession* aSession ) {
+    aSession->mRunner->printOutput( aSession->mTimer );
+    return 0;
+}
+
+/*!
+ * \brief Get a handle to a market.
+ * \param aSession The session.
+ * \param aGoodName The name of the good of the market.
+ * \param aRegionName The name of any region contained in the market.
+ * \return The handle of the market or -1 if there is no such market.
+ */
+int gcam_find_market( GcamSession* aSession, const char* aGoodName, const char* aRegionName ) {
+    const pair<string, string> market( aGoodName, aRegionName );
+    for( size_t i = 0; i < aSession->mMarkets.size(); ++i ) {
+        if( aSession->mMarkets[ i ] == market ) {
+            return static_cast<int>( i );
+        }
+    }
+    if( aSession->getScenario()->getMarketplace()->getPrice( market.first, market.second, 0, false )
+        == Marketplace::NO_MARKET_PRICE )
+    {
+        return -1;
+    }
+    aSession->mMarkets.push_back( market );
+    return static_cast<int>( aSession->mMarkets.size() - 1 );
+}
+
+/*!
+ * \brief Set the price of a market.
+ * \details The solver will change the price of a market which it solves when
+ *          the period is run, so this is usually used for markets which are
+ *          not solved such as a fixed carbon tax.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \param aPrice The new price.
+ * \return 0 or -1 if the market or period is not valid.
+ */
+int gcam_set_price( GcamSession* aSession, int aMarket, int aPeriod, double aPrice ) {
+    if( !aSession->isValidMarket( aMarket ) || !aSession->isValidPeriod( aPeriod ) ) {
+        return -1;
+    }
+    const pair<string, string>& market = aSession->mMarkets[ aMarket ];
+    aSession->getScenario()->getMarketplace()->setPrice( market.first, market.second, aPrice, aPeriod );
+    return 0;
+}
+
+/*!
+ * \brief Get the prices, supplies, or demands of a market in every period.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aValueType The GcamMarketValue to get.
+ * \param aLength [out] The length of the array, which is the number of periods.
+ * \return The values by period or null if the market or type is not valid.
+ */
+const double* gcam_get_market_values( GcamSession* aSession, int aMarket, int aValueType, int* aLength ) {
+    aSession->mResult.clear();
+    if( !aSession->isValidMarket( aMarket ) || aValueType < GCAM_MARKET_PRICE || aValueType > GCAM_MARKET_DEMAND ) {
+        return aSession->setResult( aLength );
+    }
+    const pair<string, string>& market = aSession->mMarkets[ aMarket ];
+    const Marketplace* marketplace = aSession->getScenario()->getMarketplace();
+    const int numPeriods = gcam_get_num_periods( aSession );
+    aSession->mResult.reserve( numPeriods );
+    for( int period = 0; period < numPeriods; ++period ) {
+        aSession->mResult.push_back(
+            aValueType == GCAM_MARKET_PRICE ? marketplace->getPrice( market.first, market.second, period ) :
+            aValueType == GCAM_MARKET_SUPPLY ? marketplace->getSupply( market.first, market.second, period ) :
+            marketplace->getDemand( market.first, market.second, period ) );
+    }
+    return aSession->setResult( aLength );
+}
+
+/*!
+ * \brief Set every parameter matched by a search string.
+ * \details Only scalar parameters are set, so the search string must select a
+ *          period of any parameters which vary by period.
+ * \param aSession The session.
+ * \param aSearchString The GCAM Fusion search string of the parameters.
+ * \param aValue The value to set.
+ * \return The number of parameters set.
+ */
+int gcam_set_parameter( GcamSession* aSession, const char* aSearchString, double aValue ) {
+    Query& query = aSession->getQuery( aSearchString );
+    const vector<Value*>& values = query.mValues.find( aSession->getScenario() );
+    const vector<double*>& doubles = query.mDoubles.find( aSession->getScenario() );
+    for( vector<Value*>::const_iterator value = values.begin(); value != values.end(); ++value ) {
+        **value = aValue;
+    }
+    for( vector<double*>::const_iterator value = doubles.begin(); value != doubles.end(); ++value ) {
+        **value = aValue;
+    }
+    return static_cast<int>( values.size() + doubles.size() );
+}
+
+/*!
+ * \brief Get the values matched by a search string.
+ * \details Scalar matches are returned in the order they were found.  Matches
+ *          which are vectors by period, such as emissions or land allocation,
+ *          contribute their value in aPeriod.
+ * \param aSession The session.
+ * \param aSearchString The GCAM Fusion search string of the values.
+ * \param aPeriod The model period to read from vectors by period.
+ * \param aLength [out] The number of values.
+ * \return The values or null if nothing matched.
+ */
+const double* gcam_query( GcamSession* aSession, const char* aSearchString, int aPeriod, int* aLength ) {
+    aSession->mResult.clear();
+    Query& query = aSession->getQuery( aSearchString );
+    const vector<Value*>& values = query.mValues.find( aSession->getScenario() );
+    const vector<double*>& doubles = query.mDoubles.find( aSession->getScenario() );
+    const vector<objects::PeriodVector<Value>*>& vectors = query.mVectors.find( aSession->getScenario() );
+    aSession->mResult.reserve( values.size() + doubles.size() + vectors.size() );
+    for( vector<Value*>::const_iterator value = values.begin(); value != values.end(); ++value ) {
+        aSession->mResult.push_back( **value );
+    }
+    for( vector<double*>::const_iterator value = doubles.begin(); value != doubles.end(); ++value ) {
+        aSession->mResult.push_back( **value );
+    }
+    if( !vectors.empty() && aSession->isValidPeriod( aPeriod ) ) {
+        for( vector<objects::PeriodVector<Value>*>::const_iterator vec = vectors.begin(); vec != vectors.end(); ++vec ) {
+            aSession->mResult.push_back( (**vec)[ aPeriod ] );
+        }
+    }
+    return aSession->setResult( aLength );
+}
@@ -80,6 +80,9 @@ GDP::GDP() {
     calibrationGDPs.resize( maxper );
     gdpValueNotAdjusted.resize( maxper );
     gdpPerCapitaNotAdjusted.resize( maxper );
+    mApproxScaledGDPperCap.resize( maxper );
+    mApproxScaledGDP.resize( maxper );
+    mScaledGDPperCap.resize( maxper );
     baseGDP = 0;
     mEnergyGDPElasticity = 0;
     PPPConversionFact = 1;
@@ -358,6 +361,7 @@ void GDP::initialGDPcalc( const int period, const double population ) {
     // Determine approximate PPP-based GDP per capita
     gdpPerCapitaApproxPPP[ period ] = calculatePPPPerCap( period, gdpPerCapita[ period ] );
 
+    updateScaledGDP( period );
 }
 
 /*! Adjust regional gdp for energy service price effect
@@ -384,10 +388,31 @@ void GDP::adjustGDP( const int period, const double priceRatio ) {
         }
         gdpPerCapitaAdjusted[ period ] = gdpPerCapita[ period ] * gdpValueAdjusted[ period ] / gdpValue[ period ];
         gdpAdjustedFlag[ period ] = true;
+        updateScaledGDP( period );
     }
     gdpPerCapitaAdjustedPPP[ period ] = calculatePPPPerCap( period, gdpPerCapitaAdjusted[ period ] );
 }
 
+/*!
+ * \brief Update the GDP values scaled to the base period after the GDP for a
+ *        period has changed.
+ * \details If the base period changed the scaled values for every period are
+ *          updated since they are all relative to it.
+ * \param aPeriod Model period for which GDP was calculated.
+ */
+void GDP::updateScaledGDP( const int aPeriod ) {
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int basePer = modeltime->getBasePeriod();
+    const int startPer = aPeriod == basePer ? 0 : aPeriod;
+    const int endPer = aPeriod == basePer ? modeltime->getmaxper() : aPeriod + 1;
+    for( int per = startPer; per < endPer; ++per ) {
+        mApproxScaledGDPperCap[ per ] = gdpPerCapita[ basePer ] > 0 ?
+            gdpPerCapita[ per ] / gdpPerCapita[ basePer ] : gdpPerCapita[ per ];
+        mApproxScaledGDP[ per ] = gdpValue[ per ] / gdpValue[ basePer ];
+        mScaledGDPperCap[ per ] = gdpPerCapitaAdjusted[ per ] / gdpPerCapitaAdjusted[ basePer ];
+    }
+}
+
 /*! Calculate GDP on a PPP basis
 * 
 * This uses the conversion factor from getPPPMERRatio to convert Market Exchange Rate basis GDP values into PPP values
@@ -475,15 +500,13 @@ double GDP::getPPPMERRatio( const int period, const double marketGDPperCap ) {
 */
 double GDP::getApproxScaledGDPperCap( const int period ) const {
     const Modeltime* modeltime = scenario->getModeltime();
-    if( gdpPerCapita[ modeltime->getBasePeriod() ] > 0 ){
-        return gdpPerCapita[ period ] / gdpPerCapita[ modeltime->getBasePeriod() ];
+    if( !( gdpPerCapita[ modeltime->getBasePeriod() ] > 0 ) ){
+        // Report an error that there was not a base year GDP per capita.
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "No base year GDP per capita was available. Returning unscaled GDP per capita." << endl;
     }
-
-    // Report an error that there was not a base year GDP per capita.
-    ILogger& mainLog = ILogger::getLogger( "main_log" );
-    mainLog.setLevel( ILogger::ERROR );
-    mainLog << "No base year GDP per capita was available. Returning unscaled GDP per capita." << endl;
-    return gdpPerCapita[ period ];
+    return mApproxScaledGDPperCap[ period ];
 }
 
 /*! Return approximate PPP per capita
@@ -508,7 +531,7 @@ double GDP::getApproxPPPperCap( const int period ) const {
 double GDP::getApproxScaledGDP( const int period ) const {
     const Modeltime* modeltime = scenario->getModeltime();
     assert( gdpValue[ modeltime->getBasePeriod() ] );
-    return gdpValue[ period ] / gdpValue[ modeltime->getBasePeriod() ];
+    return mApproxScaledGDP[ period ];
 }
 
 /*! Return approximate GDP per capita (1000's of dollars/cap)
@@ -537,7 +560,7 @@ double GDP::getScaledGDPperCap( const int period ) const {
     }
     const Modeltime* modeltime = scenario->getModeltime();
     assert( gdpPerCapitaAdjusted[ modeltime->getBasePeriod() ] > 0 );
-    return gdpPerCapitaAdjusted[ period ] / gdpPerCapitaAdjusted[ modeltime->getBasePeriod() ];
+    return mScaledGDPperCap[ period ];
 }
 
 /*! Return GDP per capita (in $1000's of dollars)
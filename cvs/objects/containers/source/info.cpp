@@ -43,8 +43,10 @@
 #include "containers/include/info.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/xml_helper.h"
+#include "util/base/include/atom.h"
 
 using namespace std;
+using namespace objects;
 
 /*! \brief Constructor
 * \details Constructs the Info object by allocating a hashmap to store the
@@ -58,8 +60,15 @@ using namespace std;
 Info::Info( const IInfo* aParentInfo, const string& aOwnerName ) :
 mOwnerName( aOwnerName ),
 mInfoMap( new InfoMap( getInitialSize() ) ),
+#if GCAM_PARALLEL_ENABLED
+mFrozenMap( 0 ),
+#endif
 mParentInfo( aParentInfo )
 {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( getAllInfosMutex() );
+    getAllInfos().insert( this );
+#endif
 }
 
 /*! \brief Destructor
@@ -69,6 +78,10 @@ mParentInfo( aParentInfo )
 *          here.
 */
 Info::~Info(){
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( getAllInfosMutex() );
+    getAllInfos().erase( this );
+#endif
 }
 
 bool Info::setBoolean( const string& aStringKey, const bool aValue ){
@@ -144,6 +157,33 @@ double Info::getDouble( const string& aStringKey, const bool aMustExist ) const
     return value;
 }
 
+/*!
+ * \brief Get a double value with a key given by an Atom.
+ * \details Searches with the hash code precomputed by the Atom, otherwise the
+ *          same as getDouble for the Atom's string.
+ * \param aKey Atom of the key for which to search.
+ * \param aMustExist Whether the value should exist.
+ * \return The double associated with the key or zero if it does not exist.
+ */
+double Info::getDouble( const Atom* aKey, const bool aMustExist ) const
+{
+    // Perform a local search.
+    bool found = false;
+    double value = getItemValueLocal<double>( aKey->getID(), aKey->getHashCode(), found );
+
+    // If the item wasn't found search the parent info.
+    if( !found ){
+        if( mParentInfo ){
+            value = mParentInfo->getDoubleHelper( aKey, found );
+        }
+        // The item must exist and was not found or there was no parent to search.
+        if( aMustExist && !found ){
+            printItemNotFoundWarning( aKey->getID() );
+        }
+    }
+    return value;
+}
+
 const string& Info::getString( const string& aStringKey, const bool aMustExist ) const
 {
     // Perform a local search.
@@ -200,6 +240,18 @@ double Info::getDoubleHelper( const string& aStringKey, bool& aFound ) const
     return value;
 }
 
+double Info::getDoubleHelper( const Atom* aKey, bool& aFound ) const
+{
+    // Perform a local search.
+    double value = getItemValueLocal<double>( aKey->getID(), aKey->getHashCode(), aFound );
+    
+    // If the item wasn't found and parent exists, search the parent info.
+    if( !aFound && mParentInfo ){
+        value = mParentInfo->getDoubleHelper( aKey, aFound );
+    }
+    return value;
+}
+
 const string& Info::getStringHelper( const string& aStringKey, bool& aFound ) const
 {
     // Perform a local search.
@@ -214,16 +266,26 @@ const string& Info::getStringHelper( const string& aStringKey, bool& aFound ) co
 
 bool Info::hasValue( const string& aStringKey ) const {
 #if GCAM_PARALLEL_ENABLED
-    // get a read lock on the info map
-    tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex,false);
+    // get a read lock on the info map unless it is frozen
+    const InfoMap* infoMap = mFrozenMap.load( std::memory_order_acquire );
+    const bool isLocked = !infoMap;
+    tbb::queuing_rw_mutex::scoped_lock readlock;
+    if( isLocked ){
+        readlock.acquire( mInfoMapMutex, false );
+        infoMap = mInfoMap.get();
+    }
+#else
+    const InfoMap* infoMap = mInfoMap.get();
 #endif
     // Check the local store. 
-    bool currHasValue = ( mInfoMap->find( aStringKey ) != mInfoMap->end() );
+    bool currHasValue = ( infoMap->find( aStringKey ) != infoMap->end() );
 
 #if GCAM_PARALLEL_ENABLED
     // the lock on our local map is no longer needed.  Release before
     // recursing into parent structures
-    readlock.release();
+    if( isLocked ){
+        readlock.release();
+    }
 #endif
     // If the value was not found, check the parent.
     if( !currHasValue && mParentInfo ){
@@ -261,17 +323,76 @@ void Info::toDebugXML( const int aperiod, Tabs* aTabs, ostream& aOut ) const {
     XMLWriteClosingTag( "Info", aOut, aTabs );
 }
 
+#if GCAM_PARALLEL_ENABLED
+/*! \brief Freeze all Info objects so that they can be read without locking.
+* \details This should be called once initCalc is complete, when no other
+*          thread is using any Info.
+*/
+void Info::freezeAll(){
+    tbb::spin_mutex::scoped_lock lock( getAllInfosMutex() );
+    const set<Info*>& allInfos = getAllInfos();
+    for( set<Info*>::const_iterator it = allInfos.begin(); it != allInfos.end(); ++it ){
+        (*it)->freeze();
+    }
+}
+
+/*! \brief Freeze the Info so that its map is read without locking.
+* \details Any map left from a previous thaw is no longer in use by a reader
+*          and is deleted.
+*/
+void Info::freeze(){
+    mThawedMap.reset();
+    mFrozenMap.store( mInfoMap.get(), std::memory_order_release );
+}
+
+/*! \brief Thaw a frozen Info so that its map can be modified.
+* \details Readers which found the Info frozen may still be reading the
+*          frozen map, so it is moved aside untouched and the Info continues
+*          with a copy of it.  The caller must hold the write lock.
+*/
+void Info::thaw(){
+    assert( mFrozenMap.load() == mInfoMap.get() );
+    mThawedMap = mInfoMap;
+    mInfoMap.reset( new InfoMap( *mThawedMap ) );
+    mFrozenMap.store( 0, std::memory_order_release );
+}
+
+/*! \brief Get the set of all existing Info objects.
+* \details The set is never deleted so that Info objects destroyed during
+*          static destruction can still remove themselves.
+* \return The set of all Info objects.
+*/
+set<Info*>& Info::getAllInfos(){
+    static set<Info*>* allInfos = new set<Info*>();
+    return *allInfos;
+}
+
+/*! \brief Get the mutex which protects the set of all Info objects.
+* \return The mutex for the set of all Info objects.
+*/
+tbb::spin_mutex& Info::getAllInfosMutex(){
+    static tbb::spin_mutex* allInfosMutex = new tbb::spin_mutex();
+    return *allInfosMutex;
+}
+#else
+/*! \brief Freeze all Info objects so that they can be read without locking.
+* \details Reads are not locked when not built in parallel so there is
+*          nothing to do.
+*/
+void Info::freezeAll(){
+}
+#endif
+
 /*! \brief Return the initial size for the underlying hashmap.
 * \details Returns how many slots to allocate initially for the hashmap. The
-*          hashmap will increase in size if it gets too full, but the resize
-*          operation is slow and so should be avoided if possible. This number
-*          should also be prime to reduce the number of collisions in the
-*          hashmap.
+*          hashmap will increase in size if it gets too full, which requires
+*          placing all of the existing entries again and so should be avoided
+*          if possible.
 * \return The initial size of the underlying hashmap.
 */
 size_t Info::getInitialSize() const {
-    // Medium size prime number.
-    const size_t INITIAL_SIZE = 29;
+    // Enough for most technology and sector level Info objects.
+    const size_t INITIAL_SIZE = 24;
     return INITIAL_SIZE;
 }
 
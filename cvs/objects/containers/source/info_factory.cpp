@@ -52,3 +52,13 @@ using namespace std;
 IInfo* InfoFactory::constructInfo( const IInfo* aParentInfo, const string& aOwnerName ){
     return new Info( aParentInfo, aOwnerName );
 }
+
+/*! \brief Freeze all Info objects so that they can be read without locking.
+* \details Values are mostly set during completeInit and initCalc, so this
+*          should be called once initCalc is complete and before the model is
+*          calculated. Setting a value afterwards is still allowed but the Info
+*          will have to lock its reads again until the next freeze.
+*/
+void InfoFactory::freezeInfos(){
+    Info::freezeAll();
+}
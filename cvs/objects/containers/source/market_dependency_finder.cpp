@@ -40,6 +40,8 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <algorithm>
+#include <cmath>
 #include <boost/algorithm/string/predicate.hpp>
 #include "containers/include/market_dependency_finder.h"
 #include "util/logger/include/ilogger.h"
@@ -49,8 +51,11 @@
 #include "marketplace/include/market.h"
 #include "marketplace/include/linked_market.h"
 #include "containers/include/iactivity.h"
+#include "util/base/include/configuration.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#include <boost/functional/hash.hpp>
 #include "parallel/include/gcam_parallel.hpp"
 #endif
 
@@ -63,7 +68,8 @@ using namespace std;
 MarketDependencyFinder::MarketDependencyFinder( Marketplace* aMarketplace ):
 mMarketplace( aMarketplace ), mCalcVertexUIDCount( 0 )
 #if GCAM_PARALLEL_ENABLED
-,mTBBGraphGlobal( 0 )
+,mTBBGraphGlobal( 0 ),
+mHasPartialFlowGraphs( false )
 #endif
 {
 }
@@ -272,27 +278,10 @@ const vector<IActivity*> MarketDependencyFinder::getOrdering( const int aMarketN
  *         Note the caller is not responsible for the returned memory.
  */
 GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
+    if( !mTBBGraphGlobal ) {
+        createFlowGraphs();
+    }
     if( aMarketNumber == -1 ) {
-        if( !mTBBGraphGlobal ) {
-            // reads parameters from the global configuration
-            GcamParallel config;
-            GcamParallel::FlowGraph gcamFlowGraph;
-            GcamParallel::FlowGraph grainGraph;
-
-            // convert dependency table to flow graph 
-            config.makeGCAMFlowGraph( *this, gcamFlowGraph );
-            // parse flow graph
-            config.graphParseGrainCollect( gcamFlowGraph, grainGraph ); 
-            if( !gcamFlowGraph.topology_valid() ) {
-                ILogger& mainLog = ILogger::getLogger( "main_log" );
-                mainLog.setLevel( ILogger::ERROR );
-                mainLog << "Topological indices not computed." << endl;
-                abort();
-            }
-            // build the tbb graph structure
-            mTBBGraphGlobal = new GcamFlowGraph();
-            config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *mTBBGraphGlobal ); 
-        }
         return mTBBGraphGlobal;
     }
     else {
@@ -313,7 +302,8 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
             return (*mrktIter)->mFlowGraph;
         }
 
-        // We must generate the flow graph following the same procedure as the global graph.
+        // The partial flow graphs were not created with the global one so we must
+        // generate the flow graph following the same procedure as the global graph.
         // It may be a good idea to make some of these tempararies members to avoid recalculating
         // them over and over.
         GcamParallel config;
@@ -333,10 +323,145 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
         }
         // build the tbb graph structure
         (*mrktIter)->mFlowGraph = new GcamFlowGraph();
-        config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *(*mrktIter)->mFlowGraph );
+        config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, mGlobalOrdering, *(*mrktIter)->mFlowGraph );
         return (*mrktIter)->mFlowGraph;
     }
 }
+
+/*!
+ * \brief Create the global flow graph and, if the configuration
+ *        parallel-partial-graphs is set, the flow graphs for all markets.
+ * \details Parsing the flow graphs into grains is the bulk of the cost of
+ *          setting up a parallel calculation.  The grains only depend on the
+ *          dependency structure and the grain settings so when the configuration
+ *          parallelGrainCacheFileName is set they are saved to that file and
+ *          read back in later runs with the same structure instead of parsing
+ *          the graphs again.  When they do need to be parsed the partial graphs
+ *          are independent of each other and so are parsed concurrently.
+ */
+void MarketDependencyFinder::createFlowGraphs() {
+    // reads parameters from the global configuration
+    GcamParallel config;
+    const Configuration* conf = Configuration::getInstance();
+    mHasPartialFlowGraphs = conf->getBool( "parallel-partial-graphs", false, false );
+    const string cacheFileName = conf->getFile( "parallelGrainCacheFileName", "", false );
+    
+    // Get the ordering for each market up front as they are cached on first use
+    // and so can not be generated concurrently.
+    vector<int> markets;
+    vector<vector<IActivity*> > marketOrderings;
+    if( mHasPartialFlowGraphs ) {
+        for( CMarketToDepIterator it = mMarketsToDep.begin(); it != mMarketsToDep.end(); ++it ) {
+            markets.push_back( (*it)->mMarket );
+            marketOrderings.push_back( getOrdering( (*it)->mMarket ) );
+        }
+    }
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    const size_t hash = config.hashSettings( hashDependencies() );
+    map<int, GcamParallel::GrainList> grainLists;
+    bool isCached = !cacheFileName.empty() && GcamParallel::readGrainLists( cacheFileName, hash, grainLists )
+        && grainLists.count( -1 ) > 0;
+    for( vector<int>::const_iterator it = markets.begin(); isCached && it != markets.end(); ++it ) {
+        isCached = grainLists.count( *it ) > 0;
+    }
+    
+    if( isCached ) {
+        mainLog << "Using the flow graph grains cached in " << cacheFileName << "." << endl;
+    }
+    else {
+        grainLists.clear();
+        GcamParallel::FlowGraph gcamFlowGraph;
+        GcamParallel::FlowGraph grainGraph;
+        
+        // convert dependency table to flow graph
+        config.makeGCAMFlowGraph( *this, gcamFlowGraph );
+        // parse flow graph
+        config.graphParseGrainCollect( gcamFlowGraph, grainGraph );
+        if( !gcamFlowGraph.topology_valid() ) {
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Topological indices not computed." << endl;
+            abort();
+        }
+        config.makeGrainList( grainGraph, gcamFlowGraph, mGlobalOrdering, grainLists[ -1 ] );
+        
+        // Parse the flow graph subsetting for only the activities effected by each market.
+        vector<GcamParallel::GrainList> marketGrainLists( markets.size() );
+        tbb::parallel_for( size_t( 0 ), markets.size(), [&]( size_t i ) {
+            GcamParallel::FlowGraph marketGrainGraph;
+            config.collectGrains( gcamFlowGraph, marketGrainGraph, &marketOrderings[ i ] );
+            config.makeGrainList( marketGrainGraph, gcamFlowGraph, mGlobalOrdering, marketGrainLists[ i ] );
+        } );
+        for( size_t i = 0; i < markets.size(); ++i ) {
+            grainLists[ markets[ i ] ].mGrains.swap( marketGrainLists[ i ].mGrains );
+            grainLists[ markets[ i ] ].mSuccessors.swap( marketGrainLists[ i ].mSuccessors );
+        }
+        
+        if( !cacheFileName.empty() ) {
+            GcamParallel::writeGrainLists( cacheFileName, hash, grainLists );
+        }
+    }
+    
+    // build the tbb graph structures
+    mTBBGraphGlobal = new GcamFlowGraph();
+    config.makeTBBFlowGraph( grainLists[ -1 ], mGlobalOrdering, *mTBBGraphGlobal );
+    // time the activities for the first model calculations if requested
+    config.startActivityProfiling( *mTBBGraphGlobal, mGlobalOrdering.size() );
+    if( mHasPartialFlowGraphs ) {
+        for( CMarketToDepIterator it = mMarketsToDep.begin(); it != mMarketsToDep.end(); ++it ) {
+            (*it)->mFlowGraph = new GcamFlowGraph();
+            config.makeTBBFlowGraph( grainLists[ (*it)->mMarket ], mGlobalOrdering, *(*it)->mFlowGraph );
+        }
+    }
+}
+
+/*!
+ * \brief Calculate a hash of the dependency structure which can be compared
+ *        between runs.
+ * \details Activities are identified by their index in the global ordering and
+ *          their description rather than their address.  Included are the
+ *          dependencies between the calc vertices and the vertices implied by a
+ *          change in the price of each market.
+ * \return The hash of the dependency structure.
+ */
+size_t MarketDependencyFinder::hashDependencies() const {
+    size_t hash = 0;
+    map<IActivity*, int> globalIndex;
+    for( size_t i = 0; i < mGlobalOrdering.size(); ++i ) {
+        globalIndex[ mGlobalOrdering[ i ] ] = i;
+        boost::hash_combine( hash, mGlobalOrdering[ i ]->getDescription() );
+    }
+    
+    for( CItemIterator itemIter = mDependencyItems.begin(); itemIter != mDependencyItems.end(); ++itemIter ) {
+        for( int priceOrDemand = 0; priceOrDemand <= 1; ++priceOrDemand ) {
+            const VertexList& vertices = priceOrDemand ? (*itemIter)->mPriceVertices : (*itemIter)->mDemandVertices;
+            for( CVertexIterator vertexIter = vertices.begin(); vertexIter != vertices.end(); ++vertexIter ) {
+                boost::hash_combine( hash, globalIndex[ (*vertexIter)->mCalcItem ] );
+                boost::hash_combine( hash, (*vertexIter)->mOutEdges.size() );
+                for( CVertexIterator edgeIter = (*vertexIter)->mOutEdges.begin();
+                     edgeIter != (*vertexIter)->mOutEdges.end(); ++edgeIter )
+                {
+                    boost::hash_combine( hash, globalIndex[ (*edgeIter)->mCalcItem ] );
+                }
+            }
+        }
+    }
+    
+    for( CMarketToDepIterator mrktIter = mMarketsToDep.begin(); mrktIter != mMarketsToDep.end(); ++mrktIter ) {
+        // The implied vertices are not kept in a repeatable order so sort them.
+        vector<int> implied;
+        for( set<CalcVertex*>::const_iterator it = (*mrktIter)->mImpliedVertices.begin();
+             it != (*mrktIter)->mImpliedVertices.end(); ++it )
+        {
+            implied.push_back( globalIndex[ (*it)->mCalcItem ] );
+        }
+        sort( implied.begin(), implied.end() );
+        boost::hash_combine( hash, (*mrktIter)->mMarket );
+        boost::hash_range( hash, implied.begin(), implied.end() );
+    }
+    return hash;
+}
 #endif
 
 /*!
@@ -443,14 +568,16 @@ void MarketDependencyFinder::createOrdering() {
     }
     
     // Initialize vertices in the graph.
-    CalcVertexCountMap numDependencies;
+    OrderingState state( mCalcVertexUIDCount );
     for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
         // Initialize dependency counts which will be used to do the topological sort.
         for( CVertexIterator vertexIter = (*it)->mPriceVertices.begin(); vertexIter != (*it)->mPriceVertices.end(); ++vertexIter ) {
-            numDependencies[ (*vertexIter) ] = 0;
+            state.mVertices[ (*vertexIter)->mUID ] = *vertexIter;
+            state.setNumDependencies( *vertexIter, 0 );
         }
         for( CVertexIterator vertexIter = (*it)->mDemandVertices.begin(); vertexIter != (*it)->mDemandVertices.end(); ++vertexIter ) {
-            numDependencies[ (*vertexIter) ] = 0;
+            state.mVertices[ (*vertexIter)->mUID ] = *vertexIter;
+            state.setNumDependencies( *vertexIter, 0 );
         }
         
         // Should this dependency item have multiple activities then we will just
@@ -460,13 +587,13 @@ void MarketDependencyFinder::createOrdering() {
         if( (*it)->mPriceVertices.size() > 1 ) {
             for( vector<CalcVertex*>::iterator vertexIter = (*it)->mPriceVertices.begin() + 1; vertexIter != (*it)->mPriceVertices.end(); ++vertexIter ) {
                 (*(vertexIter - 1))->mOutEdges.push_back( *vertexIter );
-                ++numDependencies[ *vertexIter ];
+                state.addDependency( *vertexIter );
             }
         }
         if( (*it)->mDemandVertices.size() > 1 ) {
             for( vector<CalcVertex*>::reverse_iterator vertexIter = (*it)->mDemandVertices.rbegin() + 1; vertexIter != (*it)->mDemandVertices.rend(); ++vertexIter ) {
                 (*(vertexIter - 1))->mOutEdges.push_back( *vertexIter );
-                ++numDependencies[ *vertexIter ];
+                state.addDependency( *vertexIter );
             }
         }
     }
@@ -498,9 +625,9 @@ void MarketDependencyFinder::createOrdering() {
                     // all of the items which directly depend on it must also be recalculated.
                     if( !(*it)->mPriceVertices.empty() ) {
                         (*it)->getLastPriceVertex()->mOutEdges.push_back( (*dependIt)->getFirstDemandVertex() );
-                        ++numDependencies[ (*dependIt)->getFirstDemandVertex() ];
+                        state.addDependency( (*dependIt)->getFirstDemandVertex() );
                         (*dependIt)->getLastDemandVertex()->mOutEdges.push_back( (*it)->getFirstDemandVertex() );
-                        ++numDependencies[ (*it)->getFirstDemandVertex() ];
+                        state.addDependency( (*it)->getFirstDemandVertex() );
                     }
                     else {
                         // These implied in edges will be added to the list of verticies to calculate
@@ -534,7 +661,7 @@ void MarketDependencyFinder::createOrdering() {
             // This is the fold back point, or final demand, so loop back on self
             // by linking the final price calculation to it's demand calculation.
             (*it)->getLastPriceVertex()->mOutEdges.push_back( (*it)->getFirstDemandVertex() );
-            ++numDependencies[ (*it)->getFirstDemandVertex() ];
+            state.addDependency( (*it)->getFirstDemandVertex() );
         }
         else {
             for( CItemIterator dependIt = (*it)->mDependentList.begin(); dependIt != (*it)->mDependentList.end(); ++dependIt ) {
@@ -547,19 +674,34 @@ void MarketDependencyFinder::createOrdering() {
                         if( !(*dependIt)->mDemandVertices.empty() ) {
                         // Could get here for instance if a resource has dependencies
                         (*it)->getLastPriceVertex()->mOutEdges.push_back( (*dependIt)->getFirstDemandVertex() );
-                            ++numDependencies[ (*dependIt)->getFirstDemandVertex() ];
+                            state.addDependency( (*dependIt)->getFirstDemandVertex() );
                         }
                         // else would get here if we had dependencies between two items which do
                         // not have anything to calculate yet are unsolved such as linked markets.
                     }
                     else {
                         (*it)->getLastPriceVertex()->mOutEdges.push_back( (*dependIt)->getFirstPriceVertex() );
-                        ++numDependencies[ (*dependIt)->getFirstPriceVertex() ];
+                        state.addDependency( (*dependIt)->getFirstPriceVertex() );
                     }
                 }
                 if( !(*dependIt)->mDemandVertices.empty()) {
                     (*dependIt)->getLastDemandVertex()->mOutEdges.push_back( (*it)->getFirstDemandVertex() );
-                    ++numDependencies[ (*it)->getFirstDemandVertex() ];
+                    state.addDependency( (*it)->getFirstDemandVertex() );
+                }
+            }
+        }
+    }
+
+    // Note which demand vertices depend on each vertex so that the dependencies
+    // on a demand vertex can be found without searching the whole graph when
+    // creating trial markets for it.
+    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+        for( CVertexIterator vertexIter = (*it)->mDemandVertices.begin(); vertexIter != (*it)->mDemandVertices.end(); ++vertexIter ) {
+            for( CVertexIterator edgeIter = (*vertexIter)->mOutEdges.begin(); edgeIter != (*vertexIter)->mOutEdges.end(); ++edgeIter ) {
+                // A vertex may have more than one edge to the same dependent.
+                VertexList& inEdges = state.mDemandInEdges[ (*edgeIter)->mUID ];
+                if( find( inEdges.begin(), inEdges.end(), *vertexIter ) == inEdges.end() ) {
+                    inEdges.push_back( *vertexIter );
                 }
             }
         }
@@ -568,44 +710,58 @@ void MarketDependencyFinder::createOrdering() {
     // Before we can create an ordering we must take care of any item which have a
     // self dependence by converting them to solved via trial markets
     ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
+    int numSelfTrials = 0;
     for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
         if( (*it)->mHasSelfDependence ) {
             depLog.setLevel( ILogger::WARNING );
             depLog << "Creating trial markets for " << (*it)->mName << " in " << (*it)->mLocatedInRegion
                    << " due to self dependency." << endl;
-            createTrialsForItem( it, numDependencies );
+            createTrialsForItem( *it, state );
+            ++numSelfTrials;
         }
     }
-    
-    // A map which will be populated with vertices in cycles the first time one is
-    // found and can be used there after to break cycles as needed while
-    // performing the topological sort.
-    CalcVertexCountMap totalVisits;
+
+    // Optionally break all of the cycles up front with as few trial markets as
+    // we can find rather than one at a time as the sort gets stuck.
+    int numMinimalTrials = 0;
+    if( Configuration::getInstance()->getBool( "minimize-trial-markets", false, false ) ) {
+        const vector<DependencyItem*> trialItems = findMinimalTrialItems( state );
+        for( vector<DependencyItem*>::const_iterator it = trialItems.begin(); it != trialItems.end(); ++it ) {
+            depLog.setLevel( ILogger::WARNING );
+            depLog << "Creating trial markets for " << (*it)->mName << " in " << (*it)->mLocatedInRegion
+                   << " to break cycles." << endl;
+            createTrialsForItem( *it, state );
+        }
+        numMinimalTrials = trialItems.size();
+    }
+    int numCycleTrials = 0;
 
     // Create a global ordering by performing a topological sort on the graph.
-    // Cycles will be broken when they are no longer possible to avoid.
-    while( !numDependencies.empty() ) {
+    // Cycles will be broken when they are no longer possible to avoid.  The
+    // candidates to break a cycle in state.mCycleVertices are populated with
+    // vertices in cycles the first time one is found and can be used there after
+    // to break cycles as needed.
+    while( state.mNumUnordered > 0 ) {
         // We can clear a vertex and add it to the ordering list if the number of
-        // dependencies on it is equal to zero.
+        // dependencies on it is equal to zero.  These are taken in UID order so
+        // the ordering is repeatable.
         vector<CalcVertex*> justRemoved;
-        typedef CalcVertexCountMap::iterator NumDepIterator;
-        for( NumDepIterator it = numDependencies.begin(); it != numDependencies.end(); ) {
-            if( (*it).second == 0 ) {
-                justRemoved.push_back( (*it).first );
-                numDependencies.erase( it++ );
-            }
-            else {
-                ++it;
+        vector<int>& candidates = state.mReadyCandidates;
+        sort( candidates.begin(), candidates.end() );
+        candidates.erase( unique( candidates.begin(), candidates.end() ), candidates.end() );
+        for( vector<int>::const_iterator it = candidates.begin(); it != candidates.end(); ++it ) {
+            if( state.mIsUnordered[ *it ] && state.mNumDependencies[ *it ] == 0 ) {
+                justRemoved.push_back( state.mVertices[ *it ] );
+                state.mIsUnordered[ *it ] = false;
+                --state.mNumUnordered;
             }
         }
+        candidates.clear();
         for( VertexIterator removedIter = justRemoved.begin(); removedIter != justRemoved.end(); ++removedIter ) {
             // When a vertex is cleared we can reduce the number of remaining
             // dependencies from it's direct dependents.
             for( VertexIterator depIter = (*removedIter)->mOutEdges.begin(); depIter != (*removedIter)->mOutEdges.end(); ++ depIter ) {
-                NumDepIterator dependCountIter = numDependencies.find( *depIter );
-                if( dependCountIter != numDependencies.end() ) {
-                    --(*dependCountIter).second;
-                }
+                state.removeDependency( *depIter );
             }
             mGlobalOrdering.push_back( (*removedIter)->mCalcItem );
         }
@@ -613,12 +769,12 @@ void MarketDependencyFinder::createOrdering() {
         // We are no longer able to find any vertices without any dependencies and
         // all vertices have not yet been cleared.  This means we are now forced
         // to break a cycle.
-        if( justRemoved.empty() && !numDependencies.empty() ) {
+        if( justRemoved.empty() && state.mNumUnordered > 0 ) {
             depLog.setLevel( ILogger::WARNING );
             depLog << "Cycle detected attempting to break it." << endl;
 
-            list<CalcVertex*> hasVisited;
-            if( totalVisits.empty() ) {
+            vector<int>& cycleVertices = state.mCycleVertices;
+            if( cycleVertices.empty() ) {
                 // We will need to create the list of possible vertices to use to break the
                 // cycle.  We will do this by finding the strongly coupled components of the
                 // graph that we have left, or put another way the vertices that are part of
@@ -626,43 +782,45 @@ void MarketDependencyFinder::createOrdering() {
                 // the cycle without having to search through a potentially large number of
                 // extraneous vertices.
                 int index = 0;
-                for( NumDepIterator it = numDependencies.begin(); it != numDependencies.end(); ++it ) {
-                    if( (*it).first->mIndex == -1 ) {
-                        findStronglyConnected( (*it).first, index, hasVisited, totalVisits );
+                for( size_t i = 0; i < state.mVertices.size(); ++i ) {
+                    if( state.mIsUnordered[ i ] && state.mIndex[ i ] == -1 ) {
+                        findStronglyConnected( state.mVertices[ i ], index, state );
                     }
                 }
+                sort( cycleVertices.begin(), cycleVertices.end() );
             }
             else {
                 // Since we have already determined which vertices are in a cycle we 
                 // can just use them again.  We just need to update the list to remove
                 // vertices which have been cleared since the last time it was used.
-                for( NumDepIterator it = totalVisits.begin(); it != totalVisits.end(); ) {
-                    if( numDependencies.find( (*it).first ) == numDependencies.end() ) {
-                        totalVisits.erase( it++ );
+                vector<int>::iterator keepIter = cycleVertices.begin();
+                for( vector<int>::const_iterator it = cycleVertices.begin(); it != cycleVertices.end(); ++it ) {
+                    if( state.mIsUnordered[ *it ] ) {
+                        state.mCycleVisits[ *it ] = 0;
+                        *keepIter++ = *it;
                     }
                     else {
-                        (*it).second = 0;
-                        ++it;
+                        state.mCycleVisits[ *it ] = -1;
                     }
                 }
+                cycleVertices.erase( keepIter, cycleVertices.end() );
             }
 
             // The vertex chosen to break the cycle will be the one most visited
             // when searching the graph from all of the vertices which are part of
             // a strongly connected component.
-            for( NumDepIterator it = totalVisits.begin(); it != totalVisits.end(); ++it ) {
-                hasVisited.clear();
-                markCycles( (*it).first, hasVisited, totalVisits );
+            for( vector<int>::const_iterator it = cycleVertices.begin(); it != cycleVertices.end(); ++it ) {
+                markCycles( state.mVertices[ *it ], state );
             }
 
             // We will choose the vertex with the most visits to break a cycle unless
             // it has a dependency which can not be broken when creating trial markets.
             int max = 0;
             CalcVertex* maxVertex = 0;
-            for( NumDepIterator it = totalVisits.begin(); it != totalVisits.end(); ++it ) {            
-                if( (*it).first->mDepItem->mCanBreakCycle && (*it).second > max ) {
-                    maxVertex = (*it).first;
-                    max = (*it).second;
+            for( vector<int>::const_iterator it = cycleVertices.begin(); it != cycleVertices.end(); ++it ) {
+                if( state.mVertices[ *it ]->mDepItem->mCanBreakCycle && state.mCycleVisits[ *it ] > max ) {
+                    maxVertex = state.mVertices[ *it ];
+                    max = state.mCycleVisits[ *it ];
                 }
             }
             if( !maxVertex ) {
@@ -674,42 +832,34 @@ void MarketDependencyFinder::createOrdering() {
             depLog << "The following activity has been chosen to break the cycle: "
                    << maxVertex->mCalcItem->getDescription() << endl;
             
-            // Now that we identified the best vertex to remove we must find the
-            // corresponding dependency item since the current strategy for breaking
-            // cycles requires that we solve the price and demand together.
-            CItemIterator maxItem = mDependencyItems.end();
-            for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end() && maxItem == mDependencyItems.end(); ++it ) {
-                // The max vertex could be either a price or demand vertex so we
-                // must check both vectors.
-                for( VertexIterator vertexIter = (*it)->mPriceVertices.begin(); vertexIter != (*it)->mPriceVertices.end() && maxItem == mDependencyItems.end(); ++vertexIter ) {
-                    if( *vertexIter == maxVertex ) {
-                        maxItem = it;
-                    }
-                }
-                for( VertexIterator vertexIter = (*it)->mDemandVertices.begin(); vertexIter != (*it)->mDemandVertices.end() && maxItem == mDependencyItems.end(); ++vertexIter ) {
-                    if( *vertexIter == maxVertex ) {
-                        maxItem = it;
-                    }
-                }
-            }
-            
-            // Reset this item to be solved via trials and adjust the depenencies accordingly.
-            createTrialsForItem( maxItem, numDependencies );
+            // Reset the dependency item of the chosen vertex to be solved via trials
+            // and adjust the depenencies accordingly.  The current strategy for
+            // breaking cycles requires that we solve the price and demand together.
+            DependencyItem* maxItem = maxVertex->mDepItem;
+            createTrialsForItem( maxItem, state );
+            ++numCycleTrials;
 
-            // Remove both the price and demand vertex from totalVisits since they can not be
-            // used again to try to break a dependency.
-            NumDepIterator delIt = totalVisits.find( (*maxItem)->getFirstDemandVertex() );
-            if( delIt != totalVisits.end() ) {
-                totalVisits.erase( delIt );
-            }
-            delIt = totalVisits.find( (*maxItem)->getFirstPriceVertex() );
-            if( delIt != totalVisits.end() ) {
-                totalVisits.erase( delIt );
+            // Remove both the price and demand vertex from the candidates since they
+            // can not be used again to try to break a dependency.
+            state.mCycleVisits[ maxItem->getFirstDemandVertex()->mUID ] = -1;
+            state.mCycleVisits[ maxItem->getFirstPriceVertex()->mUID ] = -1;
+            vector<int>::iterator keepIter = cycleVertices.begin();
+            for( vector<int>::const_iterator it = cycleVertices.begin(); it != cycleVertices.end(); ++it ) {
+                if( state.mCycleVisits[ *it ] != -1 ) {
+                    *keepIter++ = *it;
+                }
             }
+            cycleVertices.erase( keepIter, cycleVertices.end() );
         }
     }
     
     // All vertices are now cleared and we have a global ordering.
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Created " << ( numSelfTrials + numMinimalTrials + numCycleTrials )
+            << " trial markets: " << numSelfTrials << " for self dependencies, "
+            << numMinimalTrials << " chosen up front to break cycles and "
+            << numCycleTrials << " while ordering." << endl;
     depLog.setLevel( ILogger::DEBUG );
     depLog << "Global Ordering:" << endl;
     for( vector<IActivity*>::iterator it = mGlobalOrdering.begin(); it != mGlobalOrdering.end(); ++it ) {
@@ -717,61 +867,402 @@ void MarketDependencyFinder::createOrdering() {
     }
 }
 
+namespace {
+    /*!
+     * \brief Find the strongly connected components of a graph given by UID.
+     * \details An iterative Tarjan's algorithm as in
+     *          MarketDependencyFinder::findStronglyConnected.
+     * \param aGraph The out edges of each vertex.
+     * \param aComponents The component number of each vertex.
+     * \param aIsCyclic For each component whether it contains a cycle, that is it
+     *                  has more than one vertex or a vertex with an edge to itself.
+     */
+    void findComponents( const vector<vector<int> >& aGraph, vector<int>& aComponents,
+                         vector<bool>& aIsCyclic )
+    {
+        const int numVertices = aGraph.size();
+        vector<int> index( numVertices, -1 );
+        vector<int> lowLink( numVertices, -1 );
+        vector<bool> isOnStack( numVertices, false );
+        vector<int> visitStack;
+        vector<pair<int, size_t> > searchPath;
+        aComponents.assign( numVertices, -1 );
+        aIsCyclic.clear();
+        int maxIndex = 0;
+        for( int root = 0; root < numVertices; ++root ) {
+            if( index[ root ] != -1 ) {
+                continue;
+            }
+            index[ root ] = lowLink[ root ] = maxIndex++;
+            isOnStack[ root ] = true;
+            visitStack.push_back( root );
+            searchPath.push_back( make_pair( root, size_t( 0 ) ) );
+            while( !searchPath.empty() ) {
+                const int curr = searchPath.back().first;
+                if( searchPath.back().second < aGraph[ curr ].size() ) {
+                    const int next = aGraph[ curr ][ searchPath.back().second++ ];
+                    if( index[ next ] == -1 ) {
+                        index[ next ] = lowLink[ next ] = maxIndex++;
+                        isOnStack[ next ] = true;
+                        visitStack.push_back( next );
+                        searchPath.push_back( make_pair( next, size_t( 0 ) ) );
+                    }
+                    else if( isOnStack[ next ] ) {
+                        lowLink[ curr ] = min( lowLink[ curr ], index[ next ] );
+                    }
+                    continue;
+                }
+                if( index[ curr ] == lowLink[ curr ] ) {
+                    const int component = aIsCyclic.size();
+                    bool isCyclic = visitStack.back() != curr ||
+                        find( aGraph[ curr ].begin(), aGraph[ curr ].end(), curr ) != aGraph[ curr ].end();
+                    int member;
+                    do {
+                        member = visitStack.back();
+                        visitStack.pop_back();
+                        isOnStack[ member ] = false;
+                        aComponents[ member ] = component;
+                    } while( member != curr );
+                    aIsCyclic.push_back( isCyclic );
+                }
+                searchPath.pop_back();
+                if( !searchPath.empty() ) {
+                    const int prev = searchPath.back().first;
+                    lowLink[ prev ] = min( lowLink[ prev ], lowLink[ curr ] );
+                }
+            }
+        }
+    }
+
+    /*!
+     * \brief Check if a graph given by UID has no cycles.
+     * \param aGraph The out edges of each vertex.
+     * \return Whether all vertices can be topologically sorted.
+     */
+    bool isAcyclic( const vector<vector<int> >& aGraph ) {
+        vector<int> numDependencies( aGraph.size(), 0 );
+        for( size_t i = 0; i < aGraph.size(); ++i ) {
+            for( vector<int>::const_iterator it = aGraph[ i ].begin(); it != aGraph[ i ].end(); ++it ) {
+                ++numDependencies[ *it ];
+            }
+        }
+        vector<int> ready;
+        for( size_t i = 0; i < aGraph.size(); ++i ) {
+            if( numDependencies[ i ] == 0 ) {
+                ready.push_back( i );
+            }
+        }
+        size_t numSorted = 0;
+        while( !ready.empty() ) {
+            const int curr = ready.back();
+            ready.pop_back();
+            ++numSorted;
+            for( vector<int>::const_iterator it = aGraph[ curr ].begin(); it != aGraph[ curr ].end(); ++it ) {
+                if( --numDependencies[ *it ] == 0 ) {
+                    ready.push_back( *it );
+                }
+            }
+        }
+        return numSorted == aGraph.size();
+    }
+}
+
+/*!
+ * \brief Choose a small set of items for which to create trial markets so that
+ *        the dependency graph has no cycles.
+ * \details Each trial market adds a price and a demand market to the solved
+ *          system, so where the cycles are found one at a time while sorting
+ *          can create more than are needed this instead searches for a small
+ *          feedback vertex set of the whole graph.  The effect on the graph of
+ *          a trial market for an item is the same as in createTrialsForItem: the
+ *          edges into its demand vertex, other than from fixed output, and out
+ *          of its price vertex are removed leaving only the edge from the price
+ *          to the demand vertex.
+ *
+ *          Items are chosen greedily by the number of edges within a strongly
+ *          connected component the trial market would remove, divided by the
+ *          expected cost of solving it.  The cost grows with the number of
+ *          activities which depend on the price since each must be recalculated
+ *          in the partial derivative with respect to the trial price.  Once the
+ *          graph has no cycles any chosen item which is not needed to keep it
+ *          that way, checked in the reverse order they were chosen, is dropped.
+ *          Only items which could break a cycle, are not already solved, and
+ *          whose market is a normal market not shared with an item already
+ *          chosen are considered.
+ * \param aState The ordering state with the graph connected.
+ * \return The items to create trial markets for, in the order they were chosen.
+ */
+vector<MarketDependencyFinder::DependencyItem*> MarketDependencyFinder::findMinimalTrialItems( const OrderingState& aState ) const {
+    // The graph by UID, and for each vertex whether it is a demand vertex whose
+    // edges to a trial demand vertex must be kept.
+    const int numVertices = aState.mVertices.size();
+    vector<vector<int> > graph( numVertices );
+    vector<bool> isFixedOutput( numVertices, false );
+    for( int i = 0; i < numVertices; ++i ) {
+        if( aState.mVertices[ i ] ) {
+            for( CVertexIterator it = aState.mVertices[ i ]->mOutEdges.begin(); it != aState.mVertices[ i ]->mOutEdges.end(); ++it ) {
+                graph[ i ].push_back( (*it)->mUID );
+            }
+            isFixedOutput[ i ] = boost::algorithm::ends_with( aState.mVertices[ i ]->mCalcItem->getDescription(), "-fixed-output" );
+        }
+    }
+
+    // The items which could be given trial markets.
+    struct Candidate {
+        DependencyItem* mItem;
+        int mPriceVertex;
+        int mDemandVertex;
+        double mCost;
+    };
+    vector<Candidate> candidates;
+    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+        if( (*it)->mCanBreakCycle && !(*it)->mIsSolved && (*it)->mLinkedMarket != -1 &&
+            !(*it)->mPriceVertices.empty() && !(*it)->mDemandVertices.empty() &&
+            mMarketplace->mMarkets[ (*it)->mLinkedMarket ]->getMarket( 0 )->getType() == IMarketType::NORMAL )
+        {
+            Candidate candidate;
+            candidate.mItem = *it;
+            candidate.mPriceVertex = (*it)->getLastPriceVertex()->mUID;
+            candidate.mDemandVertex = (*it)->getFirstDemandVertex()->mUID;
+            candidate.mCost = 1.0 + log( 1.0 + graph[ candidate.mPriceVertex ].size() );
+            candidates.push_back( candidate );
+        }
+    }
+
+    // Remove the edges a trial market for a candidate would remove.
+    auto breakCycles = [&]( vector<vector<int> >& aGraph, const Candidate& aCandidate ) {
+        const VertexList& inEdges = aState.mDemandInEdges[ aCandidate.mDemandVertex ];
+        for( CVertexIterator it = inEdges.begin(); it != inEdges.end(); ++it ) {
+            vector<int>& outEdges = aGraph[ (*it)->mUID ];
+            vector<int>::iterator edgeIter = find( outEdges.begin(), outEdges.end(), aCandidate.mDemandVertex );
+            if( edgeIter != outEdges.end() && !isFixedOutput[ (*it)->mUID ] ) {
+                outEdges.erase( edgeIter );
+            }
+        }
+        aGraph[ aCandidate.mPriceVertex ].assign( 1, aCandidate.mDemandVertex );
+    };
+
+    vector<vector<int> > brokenGraph = graph;
+    vector<int> chosen;
+    set<int> chosenMarkets;
+    vector<int> components;
+    vector<bool> isCyclic;
+    while( true ) {
+        findComponents( brokenGraph, components, isCyclic );
+        int best = -1;
+        double bestScore = 0;
+        for( size_t i = 0; i < candidates.size(); ++i ) {
+            const Candidate& candidate = candidates[ i ];
+            if( chosenMarkets.count( candidate.mItem->mLinkedMarket ) ) {
+                continue;
+            }
+            // Count the edges in a cycle the trial market would remove.
+            int numRemoved = 0;
+            const int demandComponent = components[ candidate.mDemandVertex ];
+            if( isCyclic[ demandComponent ] ) {
+                const VertexList& inEdges = aState.mDemandInEdges[ candidate.mDemandVertex ];
+                for( CVertexIterator it = inEdges.begin(); it != inEdges.end(); ++it ) {
+                    const vector<int>& outEdges = brokenGraph[ (*it)->mUID ];
+                    if( components[ (*it)->mUID ] == demandComponent && !isFixedOutput[ (*it)->mUID ] &&
+                        find( outEdges.begin(), outEdges.end(), candidate.mDemandVertex ) != outEdges.end() )
+                    {
+                        ++numRemoved;
+                    }
+                }
+            }
+            const int priceComponent = components[ candidate.mPriceVertex ];
+            if( isCyclic[ priceComponent ] ) {
+                const vector<int>& outEdges = brokenGraph[ candidate.mPriceVertex ];
+                for( vector<int>::const_iterator it = outEdges.begin(); it != outEdges.end(); ++it ) {
+                    if( components[ *it ] == priceComponent && *it != candidate.mDemandVertex ) {
+                        ++numRemoved;
+                    }
+                }
+            }
+            if( numRemoved / candidate.mCost > bestScore ) {
+                best = i;
+                bestScore = numRemoved / candidate.mCost;
+            }
+        }
+        if( best == -1 ) {
+            break;
+        }
+        chosen.push_back( best );
+        chosenMarkets.insert( candidates[ best ].mItem->mLinkedMarket );
+        breakCycles( brokenGraph, candidates[ best ] );
+    }
+
+    ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
+    depLog.setLevel( ILogger::NOTICE );
+    depLog << "Found " << chosen.size() << " trial markets to break cycles";
+    if( isAcyclic( brokenGraph ) ) {
+        // Drop any trial market which is not needed.
+        for( int i = chosen.size() - 1; i >= 0; --i ) {
+            vector<vector<int> > testGraph = graph;
+            for( size_t j = 0; j < chosen.size(); ++j ) {
+                if( static_cast<int>( j ) != i ) {
+                    breakCycles( testGraph, candidates[ chosen[ j ] ] );
+                }
+            }
+            if( isAcyclic( testGraph ) ) {
+                chosen.erase( chosen.begin() + i );
+            }
+        }
+        depLog << ", reduced to " << chosen.size() << " by removing those not needed." << endl;
+    }
+    else {
+        depLog << " but cycles remain which will be broken while ordering." << endl;
+    }
+
+    vector<DependencyItem*> trialItems;
+    for( vector<int>::const_iterator it = chosen.begin(); it != chosen.end(); ++it ) {
+        trialItems.push_back( candidates[ *it ].mItem );
+    }
+    return trialItems;
+}
+
+/*!
+ * \brief Constructor which sizes the per vertex data.
+ * \details No vertices are unordered until their number of dependencies is set.
+ * \param aNumVertices The number of vertices, which is one more than the largest UID.
+ */
+MarketDependencyFinder::OrderingState::OrderingState( const int aNumVertices ):
+mVertices( aNumVertices, static_cast<CalcVertex*>( 0 ) ),
+mNumDependencies( aNumVertices, 0 ),
+mIsUnordered( aNumVertices, false ),
+mNumUnordered( 0 ),
+mDemandInEdges( aNumVertices ),
+mIndex( aNumVertices, -1 ),
+mLowLink( aNumVertices, -1 ),
+mIsOnStack( aNumVertices, false ),
+mCycleVisits( aNumVertices, -1 )
+{
+}
+
+/*!
+ * \brief Set the number of unordered dependencies of a vertex, marking it as
+ *        unordered if it was not already.
+ * \param aVertex The vertex.
+ * \param aNumDependencies The number of dependencies.
+ */
+void MarketDependencyFinder::OrderingState::setNumDependencies( CalcVertex* aVertex, const int aNumDependencies ) {
+    if( !mIsUnordered[ aVertex->mUID ] ) {
+        mIsUnordered[ aVertex->mUID ] = true;
+        ++mNumUnordered;
+    }
+    mNumDependencies[ aVertex->mUID ] = aNumDependencies;
+    if( aNumDependencies == 0 ) {
+        mReadyCandidates.push_back( aVertex->mUID );
+    }
+}
+
+/*!
+ * \brief Add a dependency to a vertex, marking it as unordered if it was not
+ *        already.
+ * \param aVertex The vertex.
+ */
+void MarketDependencyFinder::OrderingState::addDependency( CalcVertex* aVertex ) {
+    if( !mIsUnordered[ aVertex->mUID ] ) {
+        mIsUnordered[ aVertex->mUID ] = true;
+        mNumDependencies[ aVertex->mUID ] = 0;
+        ++mNumUnordered;
+    }
+    ++mNumDependencies[ aVertex->mUID ];
+}
+
+/*!
+ * \brief Remove a dependency from a vertex if it is not yet ordered.
+ * \param aVertex The vertex.
+ */
+void MarketDependencyFinder::OrderingState::removeDependency( CalcVertex* aVertex ) {
+    if( mIsUnordered[ aVertex->mUID ] && --mNumDependencies[ aVertex->mUID ] == 0 ) {
+        mReadyCandidates.push_back( aVertex->mUID );
+    }
+}
+
 /*!
  * \brief An implementation of Tarjan's strongly connected components algorithm which
  *        is used to identify vertices that are part of a cycle.
  * \details This is an efficient algorithm to quickly identify activities that are
  *          part of a cycle and can give us a small subset of vertices to run
  *          markCycles on to figure out which is the best to use to break the cycles.
- * \param aCurrVertex The current vertex being visited.
+ *          The depth first search is done with an explicit stack rather than by
+ *          recursion so that long dependency chains can not overflow the call stack.
+ * \param aRootVertex The vertex to start the search from.
  * \param aMaxIndex The current max index which can be used to give an index to an 
  *                  unprocessed vertex.
- * \param aHasVisited The list of vertices which make up the current search path.
- * \param aTotalVisits The map of vertices to the total number of times that node
- *                      has been visited to be used in markCycles but will be
- *                      initialized here.
+ * \param aState The ordering state in which the Tarjan's algorithm indices are kept
+ *               and to which the members of strongly connected components are
+ *               added as candidates to break a cycle.
  */
-void MarketDependencyFinder::findStronglyConnected( CalcVertex* aCurrVertex, int& aMaxIndex,
-                                                    list<CalcVertex*>& aHasVisited,
-                                                    CalcVertexCountMap& aTotalVisits ) const
+void MarketDependencyFinder::findStronglyConnected( CalcVertex* aRootVertex, int& aMaxIndex,
+                                                    OrderingState& aState ) const
 {
+    // The vertices which make up the current search path along with the next
+    // out edge of each to follow.
+    vector<pair<CalcVertex*, size_t> > searchPath;
+    // The vertices which have been visited but not yet assigned to a component.
+    VertexList visitStack;
+
     // Initialize the newly found vertex with an index, increase the max count,
-    // and add it to the current search patch.
-    aCurrVertex->mIndex = aCurrVertex->mLowLink = aMaxIndex++;
-    aHasVisited.push_back( aCurrVertex );
-
-    for( VertexIterator it = aCurrVertex->mOutEdges.begin(); it != aCurrVertex->mOutEdges.end(); ++it ) {
-        if( (*it)->mIndex == -1 ) {
-            // This successor has not been processed recurse on it.
-            findStronglyConnected( *it, aMaxIndex, aHasVisited, aTotalVisits );
-            aCurrVertex->mLowLink = min( aCurrVertex->mLowLink, (*it)->mLowLink );
-        }
-        else if( find( aHasVisited.begin(), aHasVisited.end(), *it ) != aHasVisited.end() ) {
-            // This successor is in the path thus we have found a cycle.
-            aCurrVertex->mLowLink = min( aCurrVertex->mLowLink, (*it)->mIndex );
-        }
-    }
-
-    // If the current vertex was part of a cycle then initialize aTotalVisits
-    // with the members of the strongly connected component.
-    /*
-     * \note We are not currently keeping track of each set of strongly connected
-     *       components and instead are just interested in any vertex that is part
-     *       of a set of strongly connected components.  This is because we use
-     *       markCycles to perform searches on this set to understand how they relate
-     *       however if we want replace markCycles with a method that does not require
-     *       searching this information may be valuable.
-     */
-    if( aCurrVertex->mIndex == aCurrVertex->mLowLink ) {
-        if( aHasVisited.back() != aCurrVertex ) {
-            aTotalVisits[ aCurrVertex ] = 0;
+    // and add it to the current search path.
+    aState.mIndex[ aRootVertex->mUID ] = aState.mLowLink[ aRootVertex->mUID ] = aMaxIndex++;
+    aState.mIsOnStack[ aRootVertex->mUID ] = true;
+    visitStack.push_back( aRootVertex );
+    searchPath.push_back( make_pair( aRootVertex, size_t( 0 ) ) );
+    while( !searchPath.empty() ) {
+        CalcVertex* currVertex = searchPath.back().first;
+        const int curr = currVertex->mUID;
+        if( searchPath.back().second < currVertex->mOutEdges.size() ) {
+            CalcVertex* nextVertex = currVertex->mOutEdges[ searchPath.back().second++ ];
+            const int next = nextVertex->mUID;
+            if( aState.mIndex[ next ] == -1 ) {
+                // This successor has not been processed so continue the search from it.
+                aState.mIndex[ next ] = aState.mLowLink[ next ] = aMaxIndex++;
+                aState.mIsOnStack[ next ] = true;
+                visitStack.push_back( nextVertex );
+                searchPath.push_back( make_pair( nextVertex, size_t( 0 ) ) );
+            }
+            else if( aState.mIsOnStack[ next ] ) {
+                // This successor is in the path thus we have found a cycle.
+                aState.mLowLink[ curr ] = min( aState.mLowLink[ curr ], aState.mIndex[ next ] );
+            }
+            continue;
         }
-        while( aHasVisited.back() != aCurrVertex ) {
-            CalcVertex* w = aHasVisited.back();
-            aTotalVisits[ w ] = 0;
-            aHasVisited.pop_back();
+
+        // All successors have been processed.  If the current vertex was part of
+        // a cycle then add the members of the strongly connected component to
+        // the candidates to break a cycle.
+        /*
+         * \note We are not currently keeping track of each set of strongly connected
+         *       components and instead are just interested in any vertex that is part
+         *       of a set of strongly connected components.  This is because we use
+         *       markCycles to perform searches on this set to understand how they relate
+         *       however if we want replace markCycles with a method that does not require
+         *       searching this information may be valuable.
+         */
+        if( aState.mIndex[ curr ] == aState.mLowLink[ curr ] ) {
+            if( visitStack.back() != currVertex ) {
+                aState.mCycleVisits[ curr ] = 0;
+                aState.mCycleVertices.push_back( curr );
+            }
+            while( visitStack.back() != currVertex ) {
+                const int member = visitStack.back()->mUID;
+                aState.mCycleVisits[ member ] = 0;
+                aState.mCycleVertices.push_back( member );
+                aState.mIsOnStack[ member ] = false;
+                visitStack.pop_back();
+            }
+            aState.mIsOnStack[ curr ] = false;
+            visitStack.pop_back();
+        }
+
+        // Return to the previous vertex in the search path.
+        searchPath.pop_back();
+        if( !searchPath.empty() ) {
+            const int prev = searchPath.back().first->mUID;
+            aState.mLowLink[ prev ] = min( aState.mLowLink[ prev ], aState.mLowLink[ curr ] );
         }
-        aHasVisited.pop_back();
     }
 }
 
@@ -782,62 +1273,48 @@ void MarketDependencyFinder::findStronglyConnected( CalcVertex* aCurrVertex, int
  *          when the current search path has returned to a vertex that is already
  *          in the search path.  Note an arbitrary threshold is placed on the number
  *          of times a vertex can be found to be in a cycle to avoid excessive searching
- *          when a good vertex to break a cycle has already been found.
+ *          when a good vertex to break a cycle has already been found.  The search
+ *          is confined to the candidates to break a cycle.
  * \param aCurrVertex The current vertex being visited.
- * \param aHasVisited The list of vertices which make up the current search path.
- * \param aTotalVisits The map of vertices to the total number of times that node
- *                      has been visited.
+ * \param aState The ordering state which flags the vertices in the current search
+ *               path and holds the total number of times each candidate has been
+ *               visited.
  * \return The maximum number of cycle-visits so far.
  */
-int MarketDependencyFinder::markCycles( CalcVertex* aCurrVertex, list<CalcVertex*>& aHasVisited,
-                                        CalcVertexCountMap& aTotalVisits ) const
-{
-    if( aTotalVisits.find( aCurrVertex ) == aTotalVisits.end() ) {
+int MarketDependencyFinder::markCycles( CalcVertex* aCurrVertex, OrderingState& aState ) const {
+    const int curr = aCurrVertex->mUID;
+    if( aState.mCycleVisits[ curr ] == -1 ) {
         return 0;
     }
-    typedef CalcVertexCountMap::iterator NumDepIterator;
-    if( find( aHasVisited.begin(), aHasVisited.end(), aCurrVertex ) != aHasVisited.end() ) {
+    if( aState.mIsOnStack[ curr ] ) {
         // This search path has just formed a cycle, increase the visit count and
         // indicate that this path leads to a cycle.
-        NumDepIterator it = aTotalVisits.find( aCurrVertex );
-        if( it == aTotalVisits.end() ) {
-            aTotalVisits[ aCurrVertex ] = 1;
-        }
-        else {
-            ++aTotalVisits[ aCurrVertex ];
-        }
-        return aTotalVisits[ aCurrVertex ];
+        return ++aState.mCycleVisits[ curr ];
     }
     else {
         // Have not yet created a cycle so add this vertex to the search path and
         // keep searching.
-        aHasVisited.push_back( aCurrVertex );
+        aState.mIsOnStack[ curr ] = true;
         const int MAX_CYCLE_VISITS = 1000;
         int cycleVisits = 0;
         for( VertexIterator it = aCurrVertex->mOutEdges.begin(); it != aCurrVertex->mOutEdges.end() && cycleVisits < MAX_CYCLE_VISITS; ++it ) {
-            int currCycleVisits = markCycles( *it, aHasVisited, aTotalVisits );
+            int currCycleVisits = markCycles( *it, aState );
             cycleVisits = max( cycleVisits, currCycleVisits );
         }
-        aHasVisited.pop_back();
+        aState.mIsOnStack[ curr ] = false;
 
         // If any searches from this vertex eventually leads to a cycle then we
         // must increase the visit count for this vertex.
         if( cycleVisits ) {
-            NumDepIterator it = aTotalVisits.find( aCurrVertex );
-            if( it == aTotalVisits.end() ) {
-                aTotalVisits[ aCurrVertex ] = 1;
-            }
-            else {
-                ++aTotalVisits[ aCurrVertex ];
-            }
+            ++aState.mCycleVisits[ curr ];
         }
         return cycleVisits;
     }
 }
 
 /*!
- * \brief Reset a market identified by it's iterator into the dependency items to a solved
- *        market by using trial price/demand markets.
+ * \brief Reset a market identified by it's dependency item to a solved market by
+ *        using trial price/demand markets.
  * \details We instruct the marketplace to the the heavy lifting to restructure the markets.
  *          However the dependencies still need to be adjusted now that this market is solved.
  *          Namely:
@@ -845,73 +1322,71 @@ int MarketDependencyFinder::markCycles( CalcVertex* aCurrVertex, list<CalcVertex
  *               the solver changes the price).
  *            - All dependencies into the demand vertex are removed.
  *            - A direct dependency between the price vertex and the demand must be added back.
- * \param aItemToReset An iterator into the dependency items that identifies which market to reset.
- * \param aNumDependencies The current count of dependencies on each activity which is used in
- *                         createOrdering.  This will need to be updated to reflect the changed
- *                         dependencies since the market is now solved.
+ * \param aItemToReset The dependency item that identifies which market to reset.
+ * \param aState The ordering state used in createOrdering.  The count of dependencies
+ *               on each activity will need to be updated to reflect the changed
+ *               dependencies since the market is now solved.
  */
-void MarketDependencyFinder::createTrialsForItem( CItemIterator aItemToReset, CalcVertexCountMap& aNumDependencies ) {
+void MarketDependencyFinder::createTrialsForItem( DependencyItem* aItemToReset, OrderingState& aState ) {
     // Instruct the marketplace to go ahead and create solved trial price and demand
     // markets for this good.
-    const int demandMrkt = mMarketplace->resetToPriceMarket( (*aItemToReset)->mLinkedMarket );
+    const int demandMrkt = mMarketplace->resetToPriceMarket( aItemToReset->mLinkedMarket );
     if( demandMrkt < 0 ) {
         ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
         depLog.setLevel( ILogger::SEVERE );
         depLog << "Unable to break the cycle." << endl;
         abort();
     }
-    (*aItemToReset)->mIsSolved = true;
+    aItemToReset->mIsSolved = true;
 
     // Remove dependencies on the demand vertex now that it is solved.
     // Dependencies on the price vertex must remain since it is responsible
     // for setting it's actual price into the marketplace.
+    CalcVertex* demandVertex = aItemToReset->getFirstDemandVertex();
+    const VertexList& demandInEdges = aState.mDemandInEdges[ demandVertex->mUID ];
     vector<CalcVertex*> fixedOutputVertices;
-    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
-        for( VertexIterator vertexIter = (*it)->mDemandVertices.begin(); vertexIter != (*it)->mDemandVertices.end(); ++vertexIter ) {
-            VertexIterator dependIter = find( (*vertexIter)->mOutEdges.begin(), (*vertexIter)->mOutEdges.end(), (*aItemToReset)->getFirstDemandVertex() );
-            if( dependIter != (*vertexIter)->mOutEdges.end() ) {
-                if( boost::algorithm::ends_with( (*vertexIter)->mCalcItem->getDescription(), "-fixed-output" ) ) {
-                    fixedOutputVertices.push_back( *vertexIter );
-                }
-                else {
-                    (*vertexIter)->mOutEdges.erase( dependIter );
-                }
+    for( CVertexIterator vertexIter = demandInEdges.begin(); vertexIter != demandInEdges.end(); ++vertexIter ) {
+        VertexIterator dependIter = find( (*vertexIter)->mOutEdges.begin(), (*vertexIter)->mOutEdges.end(), demandVertex );
+        if( dependIter != (*vertexIter)->mOutEdges.end() ) {
+            if( boost::algorithm::ends_with( (*vertexIter)->mCalcItem->getDescription(), "-fixed-output" ) ) {
+                fixedOutputVertices.push_back( *vertexIter );
+            }
+            else {
+                (*vertexIter)->mOutEdges.erase( dependIter );
             }
         }
     }
-    aNumDependencies[ (*aItemToReset)->getFirstDemandVertex() ] = fixedOutputVertices.size();
+    aState.setNumDependencies( demandVertex, fixedOutputVertices.size() );
 
     // Lookup/create the associated market linkages to the price and demand
     // vertices.
-    auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( (*aItemToReset)->mLinkedMarket ) );
+    auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( aItemToReset->mLinkedMarket ) );
     MarketToDepIterator priceMrktIter = mMarketsToDep.find( marketToDep.get() );
     assert( priceMrktIter != mMarketsToDep.end() );
     MarketToDepIterator demandMrktIter = mMarketsToDep.insert( new MarketToDependencyItem( demandMrkt ) ).first;
 
     // The price/demand vertices are obviously implied when the it's corresponding
     // price/demand trial price changes.
-    (*priceMrktIter)->mImpliedVertices.insert( (*aItemToReset)->getFirstPriceVertex() );
-    (*demandMrktIter)->mImpliedVertices.insert( (*aItemToReset)->getFirstDemandVertex() );
+    (*priceMrktIter)->mImpliedVertices.insert( aItemToReset->getFirstPriceVertex() );
+    (*demandMrktIter)->mImpliedVertices.insert( demandVertex );
     
     for( VertexIterator fixedVertexIt = fixedOutputVertices.begin(); fixedVertexIt != fixedOutputVertices.end(); ++fixedVertexIt ) {
         (*demandMrktIter)->mImpliedVertices.insert( *fixedVertexIt );
     }
 
     // Make dependencies from these price vertices implied only.
-    for( VertexIterator dependIter = (*aItemToReset)->getLastPriceVertex()->mOutEdges.begin(); dependIter != (*aItemToReset)->getLastPriceVertex()->mOutEdges.end(); ) {
-        CalcVertexCountMap::iterator dependCountIter = aNumDependencies.find( *dependIter );
-        if( dependCountIter != aNumDependencies.end() ) {
-            --(*dependCountIter).second;
-        }
+    VertexList& priceOutEdges = aItemToReset->getLastPriceVertex()->mOutEdges;
+    for( CVertexIterator dependIter = priceOutEdges.begin(); dependIter != priceOutEdges.end(); ++dependIter ) {
+        aState.removeDependency( *dependIter );
         (*priceMrktIter)->mImpliedVertices.insert( *dependIter );
-        dependIter = (*aItemToReset)->getLastPriceVertex()->mOutEdges.erase( dependIter );
     }
+    priceOutEdges.clear();
 
     // The price vertex still must be calculated before the demand vertex
     // so add that dependency back in.
-    (*aItemToReset)->getLastPriceVertex()->mOutEdges.push_back( (*aItemToReset)->getFirstDemandVertex() );
-    if( aNumDependencies.find( (*aItemToReset)->getFirstPriceVertex() ) != aNumDependencies.end() ) {
-        ++aNumDependencies[ (*aItemToReset)->getFirstDemandVertex() ];
+    priceOutEdges.push_back( demandVertex );
+    if( aState.isUnordered( aItemToReset->getFirstPriceVertex() ) ) {
+        aState.addDependency( demandVertex );
     }
 }
 
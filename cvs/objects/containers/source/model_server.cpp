@@ -0,0 +1,191 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file model_server.cpp
+ * \ingroup Objects
+ * \brief ModelServer class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+
+#include "containers/include/model_server.h"
+#include "containers/include/iscenario_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "containers/include/batch_runner.h"
+#include "containers/include/ensemble_runner.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/input_image.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+ModelServer::ModelServer(){
+}
+
+ModelServer::~ModelServer(){
+}
+
+/*!
+ * \brief Serve requests until a quit request or the end of the requests.
+ * \param aRequests The stream to read requests from.
+ * \param aResponses The stream to write responses to.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether all of the requests succeeded.
+ */
+bool ModelServer::run( istream& aRequests, ostream& aResponses, Timer& aTimer ){
+    // The server runs each scenario itself so it can not contain a runner which
+    // runs its own set of scenarios.
+    list<string> exclusionList;
+    exclusionList.push_back( BatchRunner::getXMLNameStatic() );
+    exclusionList.push_back( EnsembleRunner::getXMLNameStatic() );
+    mRunner = ScenarioRunnerFactory::createDefault( exclusionList );
+
+    loadReferenceInputs();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Waiting for requests." << endl;
+
+    bool success = true;
+    string line;
+    while( getline( aRequests, line ) ){
+        // Split the request into its space separated parts.
+        vector<string> request;
+        istringstream lineStream( line );
+        string token;
+        while( lineStream >> token ){
+            request.push_back( token );
+        }
+
+        if( request.empty() ){
+            continue;
+        }
+        else if( request[ 0 ] == "quit" ){
+            break;
+        }
+        else if( request[ 0 ] == "run" ){
+            success &= runRequest( request, aResponses, aTimer );
+        }
+        else {
+            aResponses << "error unknown request " << request[ 0 ] << '\n';
+            success = false;
+        }
+        aResponses.flush();
+    }
+
+    InputImage::releaseShared();
+    XMLHelper<void>::cleanupParser();
+    return success;
+}
+
+/*!
+ * \brief Read the inputs shared by all requests into the shared input image.
+ * \details If the inputs could not be read they are simply read for each
+ *          request instead.
+ */
+void ModelServer::loadReferenceInputs() const {
+    const Configuration* conf = Configuration::getInstance();
+    vector<string> referenceFiles( 1, conf->getFile( "xmlInputFileName" ) );
+    const list<string>& scenComponents = conf->getScenarioComponents();
+    referenceFiles.insert( referenceFiles.end(), scenComponents.begin(), scenComponents.end() );
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Reading " << referenceFiles.size() << " reference input files." << endl;
+    if( !InputImage::compileShared( referenceFiles, conf->getBool( "validate-xml-input", true, false ) ) ){
+        InputImage::releaseShared();
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not read the reference inputs, they will be read for each request." << endl;
+    }
+    XMLHelper<void>::cleanupParser();
+}
+
+/*!
+ * \brief Set up, run, and write the outputs of the scenario of a run request.
+ * \param aRequest The parts of the request.
+ * \param aResponses The stream to write the response to.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether the scenario solved.
+ */
+bool ModelServer::runRequest( const vector<string>& aRequest, ostream& aResponses, Timer& aTimer ){
+    if( aRequest.size() < 3 ){
+        aResponses << "error expected: run <scenario-name> <stop-period> [<add-on file> ...]" << '\n';
+        return false;
+    }
+    const string& name = aRequest[ 1 ];
+    char* end = 0;
+    const int stopPeriod = static_cast<int>( strtol( aRequest[ 2 ].c_str(), &end, 10 ) );
+    if( *end != '\0' ){
+        aResponses << "error invalid stop period " << aRequest[ 2 ] << '\n';
+        return false;
+    }
+    const list<string> addOns( aRequest.begin() + 3, aRequest.end() );
+
+    Timer requestTimer;
+    requestTimer.start();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Running scenario " << name << " for a request." << endl;
+
+    bool success = mRunner->setupScenarios( aTimer, name, addOns );
+    XMLHelper<void>::cleanupParser();
+    if( !success ){
+        mRunner->cleanup();
+        aResponses << "error could not set up scenario " << name << '\n';
+        return false;
+    }
+
+    success = mRunner->runScenarios( stopPeriod == -1 ? util::getConfigRunPeriod( "stop" ) : stopPeriod,
+                                     false, aTimer );
+    mRunner->printOutput( aTimer );
+
+    // Cleaning up finishes writing the outputs and releases the scenario so
+    // that the next request starts from the reference inputs.
+    mRunner->cleanup();
+
+    requestTimer.stop();
+    aResponses << "done " << name << ( success ? " solved " : " unsolved " )
+               << requestTimer.getTotalTimeDifference() << '\n';
+    return success;
+}
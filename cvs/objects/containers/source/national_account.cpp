@@ -41,6 +41,7 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -54,11 +55,9 @@ using namespace std;
 using namespace xercesc;
 
 //! Default Constructor
-NationalAccount::NationalAccount():
-// Size the accounts to one after the last valid value in the vector,
-// represented by END.
-mAccounts( END )
+NationalAccount::NationalAccount()
 {
+    std::fill( mAccounts, mAccounts + END, 0.0 );
 }
 
 /*! \brief Get the XML node name in static form for comparison when parsing XML.
@@ -136,6 +135,7 @@ void NationalAccount::toDebugXML( const int period, ostream& out, Tabs* tabs ) c
  * \param aValue The value which will be added to account aType.
  */
 void NationalAccount::addToAccount( const AccountType aType, const double aValue ){
+    assert( aType < END );
     mAccounts[ aType ]+= aValue;
 }
 
@@ -145,6 +145,7 @@ void NationalAccount::addToAccount( const AccountType aType, const double aValue
  * \param aValue The value which wil be set to account aType.
  */
 void NationalAccount::setAccount( const AccountType aType, const double aValue ){
+    assert( aType < END );
     mAccounts[ aType ] = aValue;
 }
 
@@ -170,8 +171,7 @@ void NationalAccount::reset() {
     double tempInvTaxCreditRate = mAccounts[ INVESTMENT_TAX_CREDIT ];
     
     // Clear the values.
-    mAccounts.clear();
-    mAccounts.resize( END );
+    std::fill( mAccounts, mAccounts + END, 0.0 );
 
     // Restore the two values that were saved.
     mAccounts[ TRANSFERS ] = tempTransfers;
@@ -362,6 +362,21 @@ void Region::setTax( const GHGPolicy* aTax ){
     insertedTax->completeInit( mName );
 }
 
+/*! \brief Update the fixed taxes of an existing policy without replacing it.
+* \param aTaxName The name of the policy to update.
+* \param aFixedTaxes The new fixed taxes by period.
+* \return Whether a policy was found and updated in place.
+* \sa GHGPolicy::updateFixedTaxes
+*/
+bool Region::updateFixedTaxes( const string& aTaxName, const vector<double>& aFixedTaxes ){
+    for( unsigned int i = 0; i < mGhgPolicies.size(); i++ ){
+        if( mGhgPolicies[ i ]->getName() == aTaxName ){
+            return mGhgPolicies[ i ]->updateFixedTaxes( mName, aFixedTaxes );
+        }
+    }
+    return false;
+}
+
 /*! \brief A function to generate a ghg emissions quantity curve based on an
 *          already performed model run.
 * \details This function used the information stored in it to create a curve,
@@ -486,15 +486,18 @@ void RegionMiniCAM::initCalc( const int period )
     for( SectorIterator currSector = mSupplySector.begin(); currSector != mSupplySector.end(); ++currSector ){
         (*currSector)->initCalc( 0, mDemographic, period );
     }
-    for ( FinalDemandIterator currSector = mFinalDemands.begin(); currSector != mFinalDemands.end(); ++currSector ) {
-        (*currSector)->initCalc( mName, mGDP, mDemographic, period  );
-    }
     for( ResourceIterator currResource = mResources.begin(); currResource != mResources.end(); ++currResource ){
         (*currResource)->initCalc( mName, period );
     }
 
     calcGDP( period );
     mGDP->adjustGDP( period, 1.0 );
+
+    // The final demands cache their income drivers so GDP must be calculated
+    // for the period first.
+    for ( FinalDemandIterator currSector = mFinalDemands.begin(); currSector != mFinalDemands.end(); ++currSector ) {
+        (*currSector)->initCalc( mName, mGDP, mDemographic, period  );
+    }
     
     for( ConsumerIterator currConsumer = mConsumers.begin(); currConsumer != mConsumers.end(); ++currConsumer ) {
         NationalAccount nationalAccount;
@@ -502,11 +505,18 @@ void RegionMiniCAM::initCalc( const int period )
         // gdp price feedbacks will be ignored.
         (*currConsumer)->initCalc( 0, mName, "", nationalAccount, mDemographic, mGDP->getGDP( period ), period );
     }
+}
 
-    // Call initCalc for land allocator last. It needs profit from the ag sectors
-    // before it can calculate share weights
+/*!
+ * \brief Initialize the land allocator for the period.
+ * \details This is called after initCalc for all regions.  The land allocator
+ *          needs profit from the ag sectors before it can calculate share weights
+ *          and only changes land owned by this region.
+ * \param aPeriod The model period.
+ */
+void RegionMiniCAM::initCalcLocal( const int aPeriod ) {
     if ( mLandAllocator ) {
-        mLandAllocator->initCalc( mName, period );
+        mLandAllocator->initCalc( mName, aPeriod );
     }
 }
 
@@ -551,7 +561,17 @@ void RegionMiniCAM::postCalc( const int aPeriod ) {
     for( CConsumerIterator consumerIter = mConsumers.begin(); consumerIter != mConsumers.end(); ++consumerIter ) {
         (*consumerIter)->postCalc( mName, "", aPeriod );
     }
-    
+}
+
+/*!
+ * \brief Finalize the land allocator for the period.
+ * \details This is called after postCalc for all regions.  It includes the
+ *          calculation of land use change emissions for the entire model
+ *          time horizon by the carbon calculators, which only changes land
+ *          owned by this region.
+ * \param aPeriod The model period.
+ */
+void RegionMiniCAM::postCalcLocal( const int aPeriod ) {
     if( mLandAllocator ) {
         mLandAllocator->postCalc( mName, aPeriod );
     }
@@ -41,9 +41,14 @@
 #include "util/base/include/definitions.h"
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <cassert>
 #include <ctime>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <boost/algorithm/string.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -51,27 +56,56 @@
 #include "util/base/include/model_time.h"
 #include "marketplace/include/marketplace.h"
 #include "containers/include/world.h"
+#include "containers/include/info_factory.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
 #include "util/logger/include/ilogger.h"
 #include "util/curves/include/curve.h"
 #include "solution/solvers/include/solver.h"
 #include "util/base/include/auto_file.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/background_task_queue.h"
 #include "reporting/include/graph_printer.h"
 #include "reporting/include/land_allocator_printer.h"
+#include "reporting/include/memory_usage_reporter.h"
 #include "solution/solvers/include/solver_factory.h"
 #include "solution/solvers/include/bisection_nr_solver.h"
+#include "solution/solvers/include/solver_component.h"
+#include "solution/solvers/include/logbroyden.hpp"
 #include "solution/util/include/solution_info_param_parser.h" 
 #include "containers/include/imodel_feedback_calc.h"
 #include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/state_snapshot.h"
+#include "util/base/include/gcam_fusion.hpp"
 #include "util/base/include/supply_demand_curve_saver.h"
+#include "parallel/include/parallel_benchmark.hpp"
+#include "solution/util/include/calc_trace.h"
+#include "solution/solvers/include/solver_tuner.h"
+#include "solution/util/include/sensitivity_analyzer.h"
+#include "reporting/include/performance_report.h"
+#include "solution/util/include/calc_counter.h"
+#include "solution/util/include/isolution_info_filter.h"
+#include "solution/util/include/solution_info_filter_factory.h"
+#include "solution/util/include/solve_budget.h"
 
 #if GCAM_PARALLEL_ENABLED && PARALLEL_DEBUG
 #include <stdlib.h>
 #include <tbb/tick_count.h>
 #endif
 
+// A speculative solve of the next period runs in a forked copy of the model,
+// which is not possible on all platforms nor once TBB has started threads.
+#if ( defined(__unix__) || defined(__APPLE__) ) && !GCAM_PARALLEL_ENABLED
+#define GCAM_SPECULATIVE_SOLVE 1
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include "util/logger/include/logger_factory.h"
+#else
+#define GCAM_SPECULATIVE_SOLVE 0
+#endif
+
 using namespace std;
 using namespace xercesc;
 using namespace boost;
@@ -90,14 +124,22 @@ Scenario::Scenario() {
     mSolutionInfoParamParser = 0;
     
     mManageStateVars = 0;
+    mLastSpeculativePeriod = -1;
+    mSpeculativePeriod = -1;
+    mSpeculativeProcess = 0;
+    mSpeculativePipe = -1;
+    mIsSpeculative = false;
 }
 
 //! Destructor
 Scenario::~Scenario() {
+    discardSpeculativeSolve();
     delete mMarketplace;
     delete mWorld;
     delete mSolutionInfoParamParser;
     delete mManageStateVars;
+    ManageStateVariables::finishRestartFiles();
+    ManageStateVariables::clearStateIndex();
     // model time is really a singleton and so don't
     // try to delete it
 }
@@ -250,6 +292,7 @@ void Scenario::completeInit() {
     // Complete the init of the world object.
     if( mWorld ){
         mWorld->completeInit();
+        markFusionTreeChanged();
 
         // initialize solvers
         initSolvers();
@@ -263,6 +306,8 @@ void Scenario::completeInit() {
     // Set the valid period vector to false.
     mIsValidPeriod.clear();
     mIsValidPeriod.resize( mModeltime->getmaxper(), false );
+
+    logMemoryUsage( "after completeInit" );
 }
 
 //! Return scenario name.
@@ -296,6 +341,11 @@ bool Scenario::run( const int aSinglePeriod,
         tabs.increaseIndent();
     }
 
+    // Debugging output for each period is written to the file in the
+    // background while the next period is calculated.  This is declared after
+    // the file so that it finishes writing before the file is closed.
+    BackgroundTaskQueue outputQueue;
+
     Timer& fullScenarioTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::FULLSCENARIO );
     fullScenarioTimer.start();
     
@@ -304,11 +354,17 @@ bool Scenario::run( const int aSinglePeriod,
 
     bool success = true;
 
+    // Speculative solves may be started for any period this run calculates.
+    mLastSpeculativePeriod = aSinglePeriod == RUN_ALL_PERIODS ? mModeltime->getmaxper() - 1 : aSinglePeriod;
+
     // If the single period is RUN_ALL_PERIODS that means to calculate all periods. Loop over
     // time steps and operate model.
+    // The run is stopped early if too many periods fail to solve.
+    bool stopped = false;
     if( aSinglePeriod == RUN_ALL_PERIODS ){
-        for( int per = 0; per < mModeltime->getmaxper(); per++ ){
-            success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging );
+        for( int per = 0; per < mModeltime->getmaxper() && !stopped; per++ ){
+            success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging, &outputQueue );
+            stopped = hasTooManyUnsolvedPeriods();
         }
     }
     // Check if the single period is invalid.
@@ -320,9 +376,10 @@ bool Scenario::run( const int aSinglePeriod,
     } 
     else {
         // Run all periods up to the single period which are invalid.
-        for( int per = 0; per < aSinglePeriod; per++ ){
+        for( int per = 0; per < aSinglePeriod && !stopped; per++ ){
             if( !mIsValidPeriod[ per ] ){
-                success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging );
+                success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging, &outputQueue );
+                stopped = hasTooManyUnsolvedPeriods();
             }
         }
         
@@ -333,8 +390,13 @@ bool Scenario::run( const int aSinglePeriod,
 
         // Now run the requested period. Results past this period will no longer
         // be valid. Do not attempt to use them!
-        success &= calculatePeriod( aSinglePeriod, *XMLDebugFile, &tabs, aPrintDebugging );
+        if( !stopped ) {
+            success &= calculatePeriod( aSinglePeriod, *XMLDebugFile, &tabs, aPrintDebugging, &outputQueue );
+        }
     }
+    // A speculative solve is left over if the run was stopped early.
+    discardSpeculativeSolve();
+    mLastSpeculativePeriod = -1;
     
     // Print any unsolved periods.
     // TODO: This should be added to the db.
@@ -353,6 +415,10 @@ bool Scenario::run( const int aSinglePeriod,
         }
         mainLog << endl;
     }
+    if( stopped ) {
+        mainLog << "The run was stopped after " << mUnsolvedPeriods.size()
+                << " periods did not solve, later periods were not calculated." << endl;
+    }
 
     mainLog.setLevel( ILogger::DEBUG );
     fullScenarioTimer.stop();
@@ -361,7 +427,27 @@ bool Scenario::run( const int aSinglePeriod,
     // Run the climate model.
     mWorld->runClimateModel();
 
-    // Close the debugging files.
+    // When only requested periods are written to the debugging file, write
+    // those which solved now.  The model keeps the results of each period so
+    // there is no need to have written them as the periods were calculated.
+    if( aPrintDebugging && isLazyDebugXML() ){
+        vector<string> debugPeriods;
+        const string debugPeriodsStr = Configuration::getInstance()->getString( "debug-xml-periods", "", false );
+        if( !debugPeriodsStr.empty() ) {
+            boost::split( debugPeriods, debugPeriodsStr, boost::is_any_of( "," ) );
+        }
+        for( vector<string>::const_iterator it = debugPeriods.begin(); it != debugPeriods.end(); ++it ) {
+            const int period = atoi( it->c_str() );
+            if( period >= 0 && period < mModeltime->getmaxper() && mIsValidPeriod[ period ] &&
+                find( mUnsolvedPeriods.begin(), mUnsolvedPeriods.end(), period ) == mUnsolvedPeriods.end() )
+            {
+                queueDebuggingFiles( *XMLDebugFile, &tabs, period, &outputQueue );
+            }
+        }
+    }
+
+    // Close the debugging files once all periods have been written.
+    outputQueue.wait();
     if( aPrintDebugging ){
         XMLWriteClosingTag( getXMLNameStatic(), *XMLDebugFile, &tabs );
     }
@@ -377,13 +463,19 @@ bool Scenario::run( const int aSinglePeriod,
 * \param aXMLDebugFile XML debugging file.
 * \param aTabs Tabs formatting object.
 * \param aPrintDebugging Whether to print debugging information.
+* \param aOutputQueue The queue to write the debugging information to
+*        aXMLDebugFile from, which may then overlap with the next period.
 * \return Whether the period was calculated successfully.
 */
 bool Scenario::calculatePeriod( const int aPeriod,
                                 ostream& aXMLDebugFile,
                                 Tabs* aTabs,
-                                bool aPrintDebugging )
+                                bool aPrintDebugging,
+                                BackgroundTaskQueue* aOutputQueue )
 {
+    const chrono::steady_clock::time_point periodStart = chrono::steady_clock::now();
+    const int periodStartEvaluations = mWorld->getCalcCounter()->getTotalCount();
+    const int periodStartIterations = PerformanceReport::getInstance().getNumSolverIterations();
     logPeriodBeginning( aPeriod );
 
     // If this is period 0 initialize market price.
@@ -394,7 +486,11 @@ bool Scenario::calculatePeriod( const int aPeriod,
     // Run the iteration of the model.
     mMarketplace->nullSuppliesAndDemands( aPeriod ); // initialize market demand to null
     mMarketplace->init_to_last( aPeriod ); // initialize to last period's info
+    if( mSpeculativePeriod == aPeriod ) {
+        applySpeculativePrices( aPeriod ); // start from a speculative solve of the period
+    }
     mWorld->initCalc( aPeriod ); // call to initialize anything that won't change during calc
+    markFusionTreeChanged(); // initCalc may have created objects, such as emissions in new vintages
     mMarketplace->assignMarketSerialNumbers( aPeriod ); // give the markets their serial numbers for this period.
     
     // Call any model feedback objects before we begin solving this period but after
@@ -403,6 +499,9 @@ bool Scenario::calculatePeriod( const int aPeriod,
         modelFeedback->calcFeedbacksBeforePeriod( this, mWorld->getClimateModel(), aPeriod );
     }
     
+    // Information values are now set and will mostly just be read during calc.
+    InfoFactory::freezeInfos();
+    
     // Set up the state data for the current period.
     delete mManageStateVars;
     mManageStateVars = new ManageStateVariables( aPeriod );
@@ -411,6 +510,19 @@ bool Scenario::calculatePeriod( const int aPeriod,
     // initial call to world.calc.  There may already be values in there if for instance
     // they got set from a restart file.
     mMarketplace->nullSuppliesAndDemands( aPeriod );
+    
+    // Time the model calculations at increasing numbers of threads if this is
+    // the period to benchmark.  The state is restored when complete.
+    if( Configuration::getInstance()->getInt( "benchmark-period", -1, false ) == aPeriod ) {
+        ParallelBenchmark benchmark( mWorld, mMarketplace );
+        benchmark.run( aPeriod, mSolutionInfoParamParser );
+    }
+    
+    // Search for better solver settings if this is a period to tune.  The
+    // state is restored when complete.
+    if( mSolverTuner.get() && mSolverTuner->shouldTune( aPeriod ) ) {
+        mSolverTuner->run( aPeriod, mSolutionInfoParamParser );
+    }
 
 #if GCAM_PARALLEL_ENABLED && PARALLEL_DEBUG
     mWorld->calc( aPeriod );       // get rid of transient bad data
@@ -471,6 +583,16 @@ bool Scenario::calculatePeriod( const int aPeriod,
     
     
     bool success = solve( aPeriod ); // solution uses Bisect and NR routine to clear markets
+    if( success ) {
+        // keep the solved prices as the reference to forecast from in later runs
+        mMarketplace->storeForecastReference( aPeriod );
+        
+        // Calculate the sensitivities of the solution while the period's
+        // state is available.  The state is left as it was solved.
+        if( mSensitivityAnalyzer.get() && mSensitivityAnalyzer->shouldAnalyze( aPeriod ) ) {
+            mSensitivityAnalyzer->run( aPeriod, mSolutionInfoParamParser );
+        }
+    }
 
     mWorld->postCalc( aPeriod );
         
@@ -495,14 +617,24 @@ bool Scenario::calculatePeriod( const int aPeriod,
     }
 
     logPeriodEnding( aPeriod );
+    logMemoryUsage( "at the end of period " + util::toString( aPeriod ) );
     
-    // Write out the results for debugging.
-    if( aPrintDebugging ){
-        writeDebuggingFiles( aXMLDebugFile, aTabs, aPeriod );
+    // Write out the results for debugging.  When only requested periods are
+    // written a period which failed to solve is still written now while the
+    // state it failed in is available.
+    if( aPrintDebugging && ( !isLazyDebugXML() || !success ) ){
+        queueDebuggingFiles( aXMLDebugFile, aTabs, aPeriod, aOutputQueue );
     }
 
     delete mManageStateVars;
     mManageStateVars = 0;
+
+    releaseFinishedPeriod( aPeriod );
+
+    PerformanceReport& performanceReport = PerformanceReport::getInstance();
+    performanceReport.recordPhase( "period", aPeriod, periodStart,
+                                   mWorld->getCalcCounter()->getTotalCount() - periodStartEvaluations,
+                                   performanceReport.getNumSolverIterations() - periodStartIterations );
     
     return success;
 }
@@ -540,6 +672,31 @@ void Scenario::logRunBeginning() const {
     mainLog << "Model run beginning." << endl;
 }
 
+/*!
+ * \brief Log an estimate of the memory used by each part of the model if
+ *        log-memory-usage is set.
+ * \param aWhen A description of when the memory usage is logged.
+ */
+void Scenario::logMemoryUsage( const string& aWhen ) const {
+    if( !MemoryUsageReporter::isEnabled() ) {
+        return;
+    }
+    Timer& memoryTimer = TimerRegistry::getInstance().getTimer( "memory-usage" );
+    memoryTimer.start();
+    MemoryUsageReporter reporter;
+    accept( &reporter, -1 );
+    if( mMarketplace ) {
+        mMarketplace->accept( &reporter, -1 );
+    }
+    reporter.setStateBytes( mManageStateVars ? mManageStateVars->getNumBytes() : 0 );
+    memoryTimer.stop();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    reporter.printReport( mainLog, aWhen );
+    memoryTimer.print( mainLog, "Total time reporting memory usage:" );
+}
+
 /*! \brief Perform any logging that should occur when the scenario run ends.*/
 void Scenario::logRunEnding() const {
     ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -560,6 +717,59 @@ void Scenario::writeDebuggingFiles( ostream& aXMLDebugFile,
     mWorld->toDebugXML( aPeriod, aXMLDebugFile, aTabs );
 }
 
+/*!
+ * \brief Write the debugging information for a period to the debugging file
+ *        in the background.
+ * \details The next period will change the model so the output is created
+ *          here and only the writing to the file, which does not affect the
+ *          model, is left to the queue.
+ * \param aXMLDebugFile The debugging file.
+ * \param aTabs Tabs formatting object.
+ * \param aPeriod The period to write.
+ * \param aOutputQueue The queue to write to the file from.
+ */
+void Scenario::queueDebuggingFiles( ostream& aXMLDebugFile,
+                                    Tabs* aTabs,
+                                    const int aPeriod,
+                                    BackgroundTaskQueue* aOutputQueue ) const
+{
+    boost::shared_ptr<ostringstream> periodXML( new ostringstream() );
+    writeDebuggingFiles( *periodXML, aTabs, aPeriod );
+    aOutputQueue->push( [periodXML, &aXMLDebugFile]() {
+        aXMLDebugFile << periodXML->str();
+    } );
+}
+
+/*!
+ * \brief Whether the debugging file only includes requested periods.
+ * \details If the configuration lazy-debug-xml is set then instead of every
+ *          period the debugging file only includes periods which failed to
+ *          solve, written as they fail, and the periods in the comma separated
+ *          list debug-xml-periods, written at the end of the run.
+ * \return Whether only requested periods are written.
+ */
+bool Scenario::isLazyDebugXML() {
+    const static bool lazyDebugXML = Configuration::getInstance()->getBool( "lazy-debug-xml", false, false );
+    return lazyDebugXML;
+}
+
+/*!
+ * \brief Free the solver data which no later period will read.
+ * \details Only done with the configuration release-finished-periods.  The
+ *          reporting data of the period, including retired vintages, must be
+ *          kept for the output written at the end of the run.
+ * \param aPeriod The period which has just finished.
+ */
+void Scenario::releaseFinishedPeriod( const int aPeriod ) {
+    const static bool releaseFinishedPeriods =
+        Configuration::getInstance()->getBool( "release-finished-periods", false, false );
+    if( !releaseFinishedPeriods ) {
+        return;
+    }
+
+    LogBroyden::releaseCachedJacobians( aPeriod );
+}
+
 /*! \brief Update a visitor for the Scenario.
 * \param aVisitor Visitor to update.
 * \param aPeriod Period to update.
@@ -620,6 +830,9 @@ void Scenario::printLandAllocatorGraph( const int aPeriod, const bool aPrintValu
     // Create the land allocator printer.
     LandAllocatorPrinter landAllocatorPrinter( regionToGraph, *landAllocatorStream,
                                                aPrintValues, true );
+    // Optionally only print the subtree under a single land node.
+    landAllocatorPrinter.setNodeToPrint( Configuration::getInstance()->getString(
+        "land-allocator-graph-node", "", false ) );
 
     // Update the land allocator printer with information from the model.
     accept( &landAllocatorPrinter, aPeriod );
@@ -636,6 +849,16 @@ void Scenario::setTax( const GHGPolicy* aTax ){
     mWorld->setTax( aTax );
 }
 
+/*! \brief Update a fixed tax in all regions without replacing the policies.
+* \param aTaxName The name of the policy to update.
+* \param aFixedTaxes The new fixed taxes by period.
+* \return Whether the taxes were updated in place.
+* \sa World::updateFixedTaxes
+*/
+bool Scenario::updateFixedTaxes( const string& aTaxName, const vector<double>& aFixedTaxes ){
+    return mWorld->updateFixedTaxes( aTaxName, aFixedTaxes );
+}
+
 /*! \brief Get the climate model.
 * \return The climate model.
 */
@@ -643,6 +866,13 @@ const IClimateModel* Scenario::getClimateModel() const {
     return mWorld->getClimateModel();
 }
 
+/*! \brief Get the climate model so that it may be run on its own.
+* \return The climate model.
+*/
+IClimateModel* Scenario::getClimateModel() {
+    return mWorld->getClimateModel();
+}
+
 /*! \brief A function to generate a series of ghg emissions quantity curves
 *          based on an already performed model run.
 * \details This function used the information stored in it to create a series of
@@ -683,7 +913,9 @@ map<string, const Curve*> Scenario::getEmissionsPriceCurves( const string& ghgNa
 * \details The solve method calls the solve method of the instance of the Solver
 *          object that was created in the constructor. This method then checks
 *          for any errors that occurred while solving and reports the errors if
-*          it is the last period. 
+*          it is the last period.  The solvers are bound by the SolveBudget of
+*          the period, of which the retry solver, if any, is given at least a
+*          quarter. 
 * \return Whether the model period solved successfully.
 * \param period Period of the model to solve.
 */
@@ -692,17 +924,244 @@ bool Scenario::solve( const int period ){
     /*! \pre The solver must be instantiated. */
     assert( mSolvers[ period ].get() );
 
+    // Keep the state the period starts from if there is an alternate solver to
+    // retry with from the same point.
+    const bool canRetry = static_cast<int>( mRetrySolvers.size() ) > period && mRetrySolvers[ period ].get();
+    StateSnapshot initialState;
+    if( canRetry ) {
+        mManageStateVars->saveState( initialState, false );
+    }
+
+    PerformanceReport& performanceReport = PerformanceReport::getInstance();
+    const chrono::steady_clock::time_point solveStart = chrono::steady_clock::now();
+    const int startEvaluations = mWorld->getCalcCounter()->getTotalCount();
+    const int startIterations = performanceReport.getNumSolverIterations();
+
+    // Bound the time and evaluations spent on the period, holding back a share
+    // of the budget for the retry solver if there is one.
+    const double RETRY_BUDGET_SHARE = 0.25;
+    SolveBudget& budget = SolveBudget::getInstance();
+    budget.startPeriod( mWorld->getCalcCounter(), canRetry ? 1 - RETRY_BUDGET_SHARE : 1 );
+
+    // Record the model evaluations of the solvers for offline replay if this
+    // is the period to trace.
+    const bool isTracing = CalcTrace::isTracePeriod( period );
+    if( isTracing ) {
+        mWorld->startCalcTrace( period );
+    }
+
+    // Solve the reduced problem first if asked to so that the full solve
+    // starts from prices at which its markets are already cleared.  Whether it
+    // solves does not matter as the full solve follows regardless.
+    if( mMultilevelFilter.get() ) {
+        const bool hasCoarseSolver = static_cast<int>( mCoarseSolvers.size() ) > period && mCoarseSolvers[ period ].get();
+        Solver* coarseSolver = hasCoarseSolver ? mCoarseSolvers[ period ].get() : mSolvers[ period ].get();
+        mMarketplace->setSolveRestriction( mMultilevelFilter.get() );
+        bool coarseSuccess = false;
+        try {
+            coarseSuccess = coarseSolver->solve( period, mSolutionInfoParamParser );
+        }
+        catch( ... ) {
+            mMarketplace->setSolveRestriction( 0 );
+            throw;
+        }
+        mMarketplace->setSolveRestriction( 0 );
+        ILogger& solverLog = ILogger::getLogger( "solver_log" );
+        solverLog.setLevel( ILogger::NOTICE );
+        solverLog << "Reduced problem for period " << period << ( coarseSuccess ? " solved" : " did not solve" )
+                  << ", continuing with the full solve." << endl;
+    }
+
     // Solve the marketplace. If the return code is false than the model did not
     // solve for the period. Add the period to the scenario list of unsolved
     // periods. 
-    const bool success = mSolvers[ period ]->solve( period, mSolutionInfoParamParser );
+    bool success = mSolvers[ period ]->solve( period, mSolutionInfoParamParser );
+    if( !success && canRetry ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Period " << period << " did not solve, retrying with the alternate solver from retry-solver-config." << endl;
+        mManageStateVars->restoreState( initialState );
+        if( mWorld->getCalcTrace() ) {
+            mWorld->getCalcTrace()->recordRestore();
+        }
+        budget.extendPeriod( 1 );
+        success = mRetrySolvers[ period ]->solve( period, mSolutionInfoParamParser );
+    }
     if( !success ) {
         mUnsolvedPeriods.push_back( period );
     }
+    if( isTracing ) {
+        mWorld->stopCalcTrace();
+    }
+
+    performanceReport.recordPhase( "solve", period, solveStart,
+                                   mWorld->getCalcCounter()->getTotalCount() - startEvaluations,
+                                   performanceReport.getNumSolverIterations() - startIterations );
     
     return success;
 }
 
+/*!
+ * \brief Called by the solver as it makes progress solving a period.
+ * \details If speculative-period-solve is set, then once the worst relative
+ *          excess demand falls below speculative-solve-tolerance a copy of the
+ *          model is forked which finishes the period from its nearly solved
+ *          state and solves the next period from there.  This runs alongside
+ *          the rest of the solve of the period, and the next period then
+ *          starts from the prices the copy found instead of forecast prices.
+ *          Only a single speculative solve is run at a time.
+ * \param aPeriod The period being solved.
+ * \param aMaxRelativeED The worst relative excess demand of the solved markets.
+ */
+void Scenario::notifySolveProgress( const int aPeriod, const double aMaxRelativeED ) {
+    const static bool speculate = Configuration::getInstance()->getBool( "speculative-period-solve", false, false );
+    const static double tolerance = Configuration::getInstance()->getDouble( "speculative-solve-tolerance", 0.01, false );
+    // The trial solves of the solver tuner do not leave the period solved.
+    const bool isTuning = mSolverTuner.get() && mSolverTuner->isRunning();
+    if( speculate && !mIsSpeculative && !isTuning && mSpeculativePeriod == -1 && aPeriod < mLastSpeculativePeriod &&
+        aMaxRelativeED <= tolerance )
+    {
+        startSpeculativeSolve( aPeriod );
+    }
+}
+
+/*!
+ * \brief Fork a process which speculatively solves the period after aPeriod.
+ * \details The process treats the current state of aPeriod as solved, runs
+ *          the end of period calculations, then calculates the next period and
+ *          writes its prices to a pipe for applySpeculativePrices to read.  The
+ *          process never returns to the caller.
+ * \param aPeriod The period being solved.
+ */
+void Scenario::startSpeculativeSolve( const int aPeriod ) {
+#if GCAM_SPECULATIVE_SOLVE
+    const int nextPeriod = aPeriod + 1;
+    int fds[ 2 ];
+    if( pipe( fds ) != 0 ) {
+        return;
+    }
+    LoggerFactory::beforeFork();
+    const pid_t pid = fork();
+    if( pid == 0 ) {
+        LoggerFactory::afterFork( "speculative-period-" + util::toString( nextPeriod ) );
+        close( fds[ 0 ] );
+        mIsSpeculative = true;
+
+        // Finish aPeriod as calculatePeriod would once it is solved.
+        mWorld->postCalc( aPeriod );
+        mIsValidPeriod[ aPeriod ] = true;
+        mWorld->runClimateModel( aPeriod );
+        for( auto modelFeedback : mModelFeedbacks ) {
+            modelFeedback->calcFeedbacksAfterPeriod( this, mWorld->getClimateModel(), aPeriod );
+        }
+
+        // The prices are useful as a starting point even if they did not
+        // completely solve.
+        ostringstream unusedDebugFile;
+        calculatePeriod( nextPeriod, unusedDebugFile, 0, false, 0 );
+        const vector<double> prices = mMarketplace->getRawPrices( nextPeriod );
+        const char* data = reinterpret_cast<const char*>( &prices[ 0 ] );
+        size_t remaining = prices.size() * sizeof( double );
+        while( remaining > 0 ) {
+            const ssize_t written = write( fds[ 1 ], data, remaining );
+            if( written <= 0 ) {
+                break;
+            }
+            data += written;
+            remaining -= written;
+        }
+        close( fds[ 1 ] );
+        LoggerFactory::cleanUp();
+        _exit( remaining == 0 ? 0 : 1 );
+    }
+    LoggerFactory::afterFork( "" );
+    close( fds[ 1 ] );
+    if( pid < 0 ) {
+        close( fds[ 0 ] );
+        return;
+    }
+    mSpeculativePeriod = nextPeriod;
+    mSpeculativeProcess = pid;
+    mSpeculativePipe = fds[ 0 ];
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Started a speculative solve of period " << nextPeriod << "." << endl;
+#endif
+}
+
+/*!
+ * \brief Wait for the speculative solve of a period and start the period from
+ *        its prices.
+ * \details The prices are not used if the speculative solve failed.
+ * \param aPeriod The period about to be solved.
+ */
+void Scenario::applySpeculativePrices( const int aPeriod ) {
+#if GCAM_SPECULATIVE_SOLVE
+    assert( mSpeculativePeriod == aPeriod );
+    vector<double> prices;
+    double buffer[ 512 ];
+    size_t partial = 0;
+    ssize_t count;
+    while( ( count = read( mSpeculativePipe, reinterpret_cast<char*>( buffer ) + partial,
+                           sizeof( buffer ) - partial ) ) > 0 )
+    {
+        partial += count;
+        const size_t complete = partial / sizeof( double );
+        prices.insert( prices.end(), buffer, buffer + complete );
+        partial -= complete * sizeof( double );
+        memmove( buffer, buffer + complete, partial );
+    }
+    close( mSpeculativePipe );
+    int status = 0;
+    const bool succeeded = waitpid( static_cast<pid_t>( mSpeculativeProcess ), &status, 0 ) > 0 &&
+                           WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+    mSpeculativePeriod = -1;
+    mSpeculativeProcess = 0;
+    mSpeculativePipe = -1;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( succeeded && mMarketplace->setSolvedMarketPrices( aPeriod, prices ) ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Starting period " << aPeriod << " from the prices of its speculative solve." << endl;
+    }
+    else {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The speculative solve of period " << aPeriod << " failed, its prices were not used." << endl;
+    }
+#endif
+}
+
+//! Stop any speculative solve which is no longer needed.
+void Scenario::discardSpeculativeSolve() {
+#if GCAM_SPECULATIVE_SOLVE
+    if( mSpeculativePeriod != -1 ) {
+        kill( static_cast<pid_t>( mSpeculativeProcess ), SIGTERM );
+        close( mSpeculativePipe );
+        int status = 0;
+        waitpid( static_cast<pid_t>( mSpeculativeProcess ), &status, 0 );
+        mSpeculativePeriod = -1;
+        mSpeculativeProcess = 0;
+        mSpeculativePipe = -1;
+    }
+#endif
+}
+
+/*!
+ * \brief Whether enough periods have failed to solve in the current run that
+ *        the rest of the run should be skipped.
+ * \details The limit is set by the configuration value max-unsolved-periods.
+ *          Once a period fails later periods often fail as well, each only
+ *          after the solver runs out of iterations, so stopping early avoids
+ *          spending a long time on a run whose results will not be used.  There
+ *          is no limit if it is not set or is less than one.
+ * \return Whether the run should stop.
+ */
+bool Scenario::hasTooManyUnsolvedPeriods() const {
+    const int maxUnsolved = Configuration::getInstance()->getInt( "max-unsolved-periods", 0, false );
+    return maxUnsolved > 0 && static_cast<int>( mUnsolvedPeriods.size() ) >= maxUnsolved;
+}
+
 //! Output Scenario members to a CSV file.
 // I don't really like this function being hard-coded to an output file, but its very hard-coded.
 void Scenario::writeOutputFiles() const {
@@ -728,7 +1187,8 @@ void Scenario::writeOutputFiles() const {
  *          each period to make sure we have a solver for that period, if
  *          not we will set it to the default solver.  The default solver
  *          is currently BisectionNRSolver.  Finally we call init for
- *          each solver.
+ *          each solver.  Alternate solvers to retry unsolved periods with
+ *          may be given in the same form in a retry-solver-config file.
  */
 void Scenario::initSolvers() {
     // check the config file for a solver config file
@@ -754,6 +1214,67 @@ void Scenario::initSolvers() {
         // Complete the init of the solution object.
         (*solverIt)->init();
     }
+    
+    // parse the alternate solvers to retry unsolved periods with if the user
+    // specified them, periods not given one will not be retried
+    const string retrySolverConfigFile = Configuration::getInstance()->getFile( "retry-solver-config", "", false );
+    mRetrySolvers.clear();
+    if( retrySolverConfigFile != "" ) {
+        // solvers are always parsed into mSolvers so set the primary solvers
+        // aside while reading the alternates
+        vector<boost::shared_ptr<Solver> > primarySolvers( mSolvers.size() );
+        primarySolvers.swap( mSolvers );
+        XMLHelper<void>::parseXML( retrySolverConfigFile, this );
+        mRetrySolvers.swap( mSolvers );
+        mSolvers.swap( primarySolvers );
+        
+        for(vector<boost::shared_ptr<Solver> >::iterator solverIt = mRetrySolvers.begin(); solverIt != mRetrySolvers.end(); ++solverIt ) {
+            if( (*solverIt).get() ) {
+                (*solverIt)->init();
+            }
+        }
+    }
+    
+    // set up the reduced problem to solve ahead of each period if the user
+    // asked for one, along with the solvers to use for it if given
+    const string multilevelFilter = Configuration::getInstance()->getString( "multilevel-solve-filter", "", false );
+    mMultilevelFilter.reset();
+    if( multilevelFilter != "" ) {
+        mMultilevelFilter.reset( SolutionInfoFilterFactory::createSolutionInfoFilterFromString( multilevelFilter ) );
+    }
+    const string coarseSolverConfigFile = Configuration::getInstance()->getFile( "coarse-solver-config", "", false );
+    mCoarseSolvers.clear();
+    if( mMultilevelFilter.get() && coarseSolverConfigFile != "" ) {
+        vector<boost::shared_ptr<Solver> > primarySolvers( mSolvers.size() );
+        primarySolvers.swap( mSolvers );
+        XMLHelper<void>::parseXML( coarseSolverConfigFile, this );
+        mCoarseSolvers.swap( mSolvers );
+        mSolvers.swap( primarySolvers );
+        
+        for(vector<boost::shared_ptr<Solver> >::iterator solverIt = mCoarseSolvers.begin(); solverIt != mCoarseSolvers.end(); ++solverIt ) {
+            if( (*solverIt).get() ) {
+                (*solverIt)->init();
+            }
+        }
+    }
+    
+    // set up the solver tuner if the user asked for one
+    const string solverTuningConfigFile = Configuration::getInstance()->getFile( "solver-tuning-config", "", false );
+    mSolverTuner.reset();
+    if( solverTuningConfigFile != "" ) {
+        mSolverTuner.reset( new SolverTuner( mWorld, mMarketplace ) );
+        XMLHelper<void>::parseXML( solverTuningConfigFile, mSolverTuner.get() );
+        mSolverTuner->init( mModeltime );
+    }
+    
+    // set up the sensitivity analysis if the user asked for one
+    const string sensitivityConfigFile = Configuration::getInstance()->getFile( "sensitivity-config", "", false );
+    mSensitivityAnalyzer.reset();
+    if( sensitivityConfigFile != "" ) {
+        mSensitivityAnalyzer.reset( new SensitivityAnalyzer( mWorld, mMarketplace ) );
+        XMLHelper<void>::parseXML( sensitivityConfigFile, mSensitivityAnalyzer.get() );
+        mSensitivityAnalyzer->init( mModeltime );
+    }
 }
 
 /*!
@@ -48,6 +48,7 @@
 // Add new types here.
 #include "containers/include/single_scenario_runner.h"
 #include "containers/include/batch_runner.h"
+#include "containers/include/ensemble_runner.h"
 #include "containers/include/mac_generator_scenario_runner.h"
 #include "target_finder/include/policy_target_runner.h"
 #include "target_finder/include/simple_policy_target_runner.h"
@@ -65,6 +66,7 @@ bool ScenarioRunnerFactory::isOfType( const string& aType ) {
     return ( ( aType == SingleScenarioRunner::getXMLNameStatic() )
         || ( aType == MACGeneratorScenarioRunner::getXMLNameStatic() )
         || ( aType == BatchRunner::getXMLNameStatic() )
+        || ( aType == EnsembleRunner::getXMLNameStatic() )
         || ( aType == PolicyTargetRunner::getXMLNameStatic() )
         || ( aType == SimplePolicyTargetRunner::getXMLNameStatic() ) );
 }
@@ -86,6 +88,9 @@ auto_ptr<IScenarioRunner> ScenarioRunnerFactory::create( const string& aType ) {
     if( aType == BatchRunner::getXMLNameStatic() ){
         return auto_ptr<IScenarioRunner>( new BatchRunner );
     }
+    if( aType == EnsembleRunner::getXMLNameStatic() ){
+        return auto_ptr<IScenarioRunner>( new EnsembleRunner );
+    }
     if( aType == PolicyTargetRunner::getXMLNameStatic() ){
         return auto_ptr<IScenarioRunner>( new PolicyTargetRunner );
     }
@@ -130,6 +135,11 @@ auto_ptr<IScenarioRunner> ScenarioRunnerFactory::createDefault( const list<strin
     {
         defaultRunner.reset( new BatchRunner );
     }
+    else if( conf->getBool( "ensemble-mode", false, false )
+        && !isExcluded( aExcludedTypes, EnsembleRunner::getXMLNameStatic() ) )
+    {
+        defaultRunner.reset( new EnsembleRunner );
+    }
     else if( conf->getBool( "find-path", false, false )
         && !isExcluded( aExcludedTypes, PolicyTargetRunner::getXMLNameStatic() ) )
     {
@@ -147,7 +157,11 @@ auto_ptr<IScenarioRunner> ScenarioRunnerFactory::createDefault( const list<strin
     }
     // Create the standard IScenarioRunner. This type cannot be excluded.
     else {
-        defaultRunner.reset( new SingleScenarioRunner );
+        auto_ptr<SingleScenarioRunner> singleRunner( new SingleScenarioRunner );
+        // Only a runner created with nothing excluded is not contained by
+        // another runner and so may restore its outputs from a result cache.
+        singleRunner->mUseResultCache = aExcludedTypes.empty();
+        defaultRunner.reset( singleRunner.release() );
     }
     return defaultRunner;
 }
@@ -40,17 +40,41 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <set>
+#include <vector>
+#include <sstream>
+#include <chrono>
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/single_scenario_runner.h"
 #include "containers/include/scenario.h"
+#include "containers/include/world.h"
 #include "util/base/include/xml_helper.h"
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/input_image.h"
+#include "util/base/include/input_prefetcher.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/auto_file.h"
+#include "util/base/include/result_cache.h"
+#include "util/base/include/validation_cache.h"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/model_time.h"
+#include "util/base/include/util.h"
+#include "util/base/include/version.h"
+#include "util/base/include/object_pool.h"
 #include "util/logger/include/ilogger.h"
 #include "util/logger/include/logger_factory.h"
 #include "reporting/include/xml_db_outputter.h"
+#include "reporting/include/columnar_outputter.h"
+#include "reporting/include/performance_report.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <algorithm>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/task_arena.h>
+#endif
 
 using namespace std;
 using namespace xercesc;
@@ -67,6 +91,9 @@ extern void createDBout();
 /*! \brief Constructor */
 SingleScenarioRunner::SingleScenarioRunner(){
     mXMLDBOutputter = 0;
+    mUseResultCache = false;
+    mRestoredResults = false;
+    mRunSucceeded = false;
 }
 
 //! Destructor.
@@ -91,6 +118,7 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
                                            const string aName,
                                            const list<string> aScenComponents )
 {
+    const chrono::steady_clock::time_point parseStart = chrono::steady_clock::now();
     const Configuration* conf = Configuration::getInstance();
     // before we do anything make sure we will be able to write
     // database results if we need to do so
@@ -107,16 +135,6 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
     // TODO: Remove global scenario pointer.
     scenario = mScenario.get();
 
-    // Parse the input file.
-    bool success =
-        XMLHelper<void>::parseXML( conf->getFile( "xmlInputFileName" ),
-                                   mScenario.get() );
-    
-    // Check if parsing succeeded.
-    if( !success ){
-        return false;
-    }
-
     // Fetch the listing of Scenario Components.
     list<string> scenComponents = conf->getScenarioComponents();
 
@@ -126,7 +144,77 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
 	{
         scenComponents.push_back( *curr );
     }
+    list<string> inputFiles = scenComponents;
+    inputFiles.push_front( conf->getFile( "xmlInputFileName" ) );
+    
+    // Scenario components may be streamed in one region at a time rather
+    // than loading each as a full DOM, optionally without validation.
+    const bool streamInput = conf->getBool( "stream-xml-input", false, false );
+    const bool validateInput = conf->getBool( "validate-xml-input", true, false );
+    // Files which have already passed validation, unchanged, need not be
+    // validated again.
+    ValidationCache validationCache( validateInput, conf->getFile( "xml-validation-cache", "", false ),
+                                     conf->getString( "xml-schema-version", "", false ),
+                                     conf->getBool( "force-xml-validation", false, false ) );
+    set<string> streamContainers;
+    streamContainers.insert( World::getXMLNameStatic() );
+
+    // Load as many of the input files as possible from a pre-compiled image,
+    // or from the image of the inputs shared by a batch of scenarios.  A
+    // single scenario may also share the image of its inputs with the other
+    // processes on the node, which is then only needed while parsing.
+    bool success = true;
+    size_t numLoaded = 0;
+    const string imageFile = conf->getFile( "input-image", "", false );
+    const bool shareInputs = imageFile.empty() && !InputImage::hasShared() &&
+        conf->getBool( "share-inputs-across-processes", false, false );
+    if( !imageFile.empty() || InputImage::hasShared() || shareInputs ) {
+        vector<string> inputFiles( 1, conf->getFile( "xmlInputFileName" ) );
+        inputFiles.insert( inputFiles.end(), scenComponents.begin(), scenComponents.end() );
+        if( shareInputs ) {
+            InputImage::attachNodeShared( inputFiles, validateInput );
+        }
+        success = InputImage::hasShared() ?
+            InputImage::loadShared( inputFiles, mScenario.get(), streamContainers, numLoaded ) :
+            InputImage::load( imageFile, inputFiles, mScenario.get(), streamContainers, numLoaded );
+        if( shareInputs ) {
+            InputImage::releaseShared();
+        }
+        if( !success ){
+            return false;
+        }
+        for( size_t i = 1; i < numLoaded; ++i ) {
+            scenComponents.pop_front();
+        }
+    }
+
+    // Parse the input file.
+    if( numLoaded == 0 ) {
+        const string inputFile = conf->getFile( "xmlInputFileName" );
+        success = XMLHelper<void>::parseXML( inputFile, mScenario.get(),
+                                             validationCache.shouldValidate( inputFile ) );
+        if( success ) {
+            validationCache.setValidated( inputFile );
+        }
+    }
     
+    // Check if parsing succeeded.
+    if( !success ){
+        return false;
+    }
+
+#if GCAM_PARALLEL_ENABLED
+    // The scenario components may instead be read concurrently and merged
+    // into the scenario in order.
+    if( !streamInput && conf->getBool( "parallel-parse-input", false, false ) ) {
+        success = parseComponentsConcurrently( scenComponents, validationCache );
+        scenComponents.clear();
+        if( !success ){
+            return false;
+        }
+    }
+#endif
+
     // Iterate over the vector.
     typedef list<string>::const_iterator ScenCompIter;
     ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -135,12 +223,28 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
 	{
         mainLog.setLevel( ILogger::NOTICE );
         mainLog << "Parsing " << *currComp << " scenario component." << endl;
-        success = XMLHelper<void>::parseXML( *currComp, mScenario.get() );
+        const bool validate = validationCache.shouldValidate( *currComp );
+        if( streamInput ) {
+            success = XMLStreamParser::parseXML( *currComp, mScenario.get(),
+                                                 streamContainers, validate );
+        }
+        else {
+            // The file may have been read ahead by the BatchRunner.
+            DOMDocument* document = InputPrefetcher::takeDocument( *currComp, validate );
+            if( document ) {
+                success = mScenario->XMLParse( document->getDocumentElement() );
+                document->release();
+            }
+            else {
+                success = XMLHelper<void>::parseXML( *currComp, mScenario.get(), validate );
+            }
+        }
         
         // Check if parsing succeeded.
         if( !success ){
             return false;
         }
+        validationCache.setValidated( *currComp );
     }
     
     // Override scenario name from data file with that from configuration file
@@ -160,10 +264,16 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
     mainLog.setLevel( ILogger::DEBUG );
     timer.print( mainLog, "XML Readin Time:" );
 
+    PerformanceReport::getInstance().recordPhase( "parse", -1, parseStart, 0, 0 );
+
     // Finish initialization.
     if( mScenario.get() ){
+        const chrono::steady_clock::time_point initStart = chrono::steady_clock::now();
         mScenario->completeInit();
+        PerformanceReport::getInstance().recordPhase( "complete-init", -1, initStart, 0, 0 );
     }
+
+    setupResultCache( inputFiles );
     return true;
 }
 
@@ -190,6 +300,21 @@ bool SingleScenarioRunner::runScenarios( const int aSinglePeriod,
     mainLog << endl;
 
     aTimer.start();             // ensure timer is running.
+
+    // Use the outputs of an identical previous run if they were stored.
+    if( mResultCache.get() && mResultCache->isStored() ) {
+        mRestoredResults = mResultCache->restore();
+        if( mRestoredResults ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Restored the outputs of a previous run with key " << mResultCache->getKey()
+                    << " from the result cache, skipping the model run." << endl;
+            mRunSucceeded = true;
+            return true;
+        }
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not restore the outputs with key " << mResultCache->getKey()
+                << " from the result cache, running the model." << endl;
+    }
     
 	bool success = false;
 	if( mScenario.get() ){
@@ -208,16 +333,25 @@ bool SingleScenarioRunner::runScenarios( const int aSinglePeriod,
 	}
 
     // Return whether the scenario ran correctly. 
+    mRunSucceeded = success;
     return success;
 }
 
 void SingleScenarioRunner::printOutput( Timer& aTimer ) const {
     ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( mRestoredResults ) {
+        // The outputs were already restored from the result cache.
+        aTimer.stop();
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Model run completed." << endl;
+        return;
+    }
     mainLog.setLevel( ILogger::NOTICE );
     mainLog << "Printing output" << endl;
 
     Timer &writeTimer = TimerRegistry::getInstance().getTimer(TimerRegistry::WRITE_DATA);
     writeTimer.start();
+    const chrono::steady_clock::time_point outputStart = chrono::steady_clock::now();
 
     if( Configuration::getInstance()->shouldWriteFile( "xmldb-location" ) ) {
         mainLog.setLevel( ILogger::NOTICE );
@@ -234,7 +368,17 @@ void SingleScenarioRunner::printOutput( Timer& aTimer ) const {
         // Print the output.
         mXMLDBOutputter->finish();
     }
+
+    if( Configuration::getInstance()->shouldWriteFile( "columnar-output", false ) ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Starting columnar output." << endl;
+        // Write the results as typed column arrays for direct analysis.
+        ColumnarOutputter columnarOutputter;
+        mScenario->accept( &columnarOutputter, -1 );
+        columnarOutputter.finish();
+    }
     writeTimer.stop();
+    PerformanceReport::getInstance().recordPhase( "output", -1, outputStart, 0, 0 );
     
     // Print the timestamps.
     aTimer.stop();
@@ -246,11 +390,26 @@ void SingleScenarioRunner::printOutput( Timer& aTimer ) const {
 }
 
 void SingleScenarioRunner::cleanup() {
+    // Find the outputs to store in the result cache while the scenario, which
+    // names some of them, is still available.
+    vector<string> cachedOutputs;
+    if( mResultCache.get() && !mRestoredResults && mRunSucceeded ) {
+        cachedOutputs = getCachedOutputs();
+    }
+
     // The current scenario is no longer needed since a new scenario run will be
     // created from scratch the next time a scenario is setup and run.
     mScenario.reset( 0 );
     scenario = 0;
 
+    // With the scenario gone the objects which made up the model tree have
+    // been returned to the pool so its memory can be released all at once.
+    if( !ObjectPool::getInstance().releaseIfUnused() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        mainLog << "Some pooled objects outlived the scenario, keeping the object pool." << endl;
+    }
+
     // If the XML database was opened then we should close it.
     if( mXMLDBOutputter ) {
         // Now that the scenario memory is cleared out we can have the XML DB
@@ -259,6 +418,22 @@ void SingleScenarioRunner::cleanup() {
         delete mXMLDBOutputter;
         mXMLDBOutputter = 0;
     }
+
+    // The outputs are complete once the XML database is closed.
+    if( !cachedOutputs.empty() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        if( mResultCache->publish( cachedOutputs ) ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Stored the outputs in the result cache with key " << mResultCache->getKey() << "." << endl;
+        }
+        else {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not store the outputs in the result cache with key " << mResultCache->getKey() << "." << endl;
+        }
+    }
+    mResultCache.reset( 0 );
+    mRestoredResults = false;
+    mRunSucceeded = false;
 }
 
 Scenario* SingleScenarioRunner::getInternalScenario(){
@@ -269,6 +444,94 @@ const Scenario* SingleScenarioRunner::getInternalScenario() const {
 	return mScenario.get();
 }
 
+/*!
+ * \brief Key the run for the result cache if one is configured.
+ * \details The key covers the model version, the scenario name, the settings
+ *          in the configuration file and the contents of the input files,
+ *          the XML database output specification, the solver configuration and
+ *          any restart files which will be read. The names of the files are
+ *          not included so that moving the inputs does not change the key.
+ * \param aInputFiles The input and scenario component files, in the order read.
+ */
+void SingleScenarioRunner::setupResultCache( const list<string>& aInputFiles ) {
+    mResultCache.reset( 0 );
+    mRestoredResults = false;
+    mRunSucceeded = false;
+
+    const Configuration* conf = Configuration::getInstance();
+    const string cacheDir = conf->getFile( "result-cache-dir", "", false );
+    if( !mUseResultCache || cacheDir.empty() ) {
+        return;
+    }
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( !ResultCache::isAvailable() ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The result cache is not available on this platform." << endl;
+        return;
+    }
+    if( conf->shouldWriteFile( "xmldb-location" ) && !conf->shouldAppendScnToFile( "xmldb-location" ) ) {
+        // A database shared between scenarios holds the results of other runs
+        // which would be overwritten by restoring it.
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The result cache requires append-scenario-name for xmldb-location, it will not be used." << endl;
+        return;
+    }
+
+    auto_ptr<ResultCache> cache( new ResultCache( cacheDir ) );
+    cache->addValue( string( __ObjECTS_VER__ ) + "_" + __REVISION_NUMBER__ );
+    cache->addValue( mScenario->getName() );
+    ostringstream settings;
+    conf->writeSettings( settings );
+    cache->addValue( settings.str() );
+
+    list<string> keyFiles = aInputFiles;
+    if( conf->shouldWriteFile( "xmldb-output-spec", false ) ) {
+        keyFiles.push_back( conf->getFile( "xmldb-output-spec" ) );
+    }
+    const string solverConfigFile = conf->getFile( "solver-config", "", false );
+    if( !solverConfigFile.empty() ) {
+        keyFiles.push_back( solverConfigFile );
+    }
+    const int restartPeriod = util::getConfigRunPeriod( "restart" );
+    for( int period = 0; period < restartPeriod; ++period ) {
+        keyFiles.push_back( ManageStateVariables::getRestartFileName( period ) );
+    }
+    for( list<string>::const_iterator currFile = keyFiles.begin(); currFile != keyFiles.end(); ++currFile ) {
+        if( !cache->addFile( *currFile ) ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not read " << *currFile << " to key the result cache, it will not be used." << endl;
+            return;
+        }
+    }
+    mResultCache = cache;
+}
+
+/*!
+ * \brief Get the outputs of the current scenario to store in the result cache.
+ * \details These must be found while the scenario is still set.
+ * \return The paths of the output files and directories.
+ */
+vector<string> SingleScenarioRunner::getCachedOutputs() const {
+    const Configuration* conf = Configuration::getInstance();
+    vector<string> outputs;
+    if( conf->shouldWriteFile( "xmldb-location" ) ) {
+        outputs.push_back( conf->getFile( "xmldb-location", "database_basexdb" ) + mScenario->getName() );
+    }
+    if( conf->shouldWriteFile( "columnar-output", false ) ) {
+        const vector<string> columnarFiles = ColumnarOutputter().getFileNames();
+        outputs.insert( outputs.end(), columnarFiles.begin(), columnarFiles.end() );
+    }
+    if( conf->shouldWriteFile( "restart", false, false ) ) {
+        // Make sure the last restart file is written before storing it.
+        ManageStateVariables::finishRestartFiles();
+        const Modeltime* modeltime = mScenario->getModeltime();
+        for( int period = 0; period < modeltime->getmaxper(); ++period ) {
+            outputs.push_back( ManageStateVariables::getRestartFileName( period ) );
+        }
+    }
+    return outputs;
+}
+
 /*!
  * \brief Get the refernce to the XMLDBOutputter.
  * \return The XMLDBOutputter.
@@ -285,3 +548,67 @@ const string& SingleScenarioRunner::getXMLNameStatic(){
 	static const string XML_NAME = "single-scenario-runner";
 	return XML_NAME;
 }
+
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief Read the scenario components concurrently and parse them into the
+ *        scenario in the order given.
+ * \details Reading and validating the files is most of the cost of parsing
+ *          and the files are independent until they are merged into the
+ *          scenario, so a batch of files, one per thread, is read into DOM
+ *          documents at once.  The documents are then parsed into the scenario
+ *          one at a time in the original order so the result is the same as
+ *          when parsing them serially.  Only one batch of documents is kept in
+ *          memory at a time.
+ * \param aScenComponents The scenario component files in the order to apply them.
+ * \param aValidationCache Decides which files to validate against their schema.
+ * \return Whether all of the files were parsed successfully.
+ */
+bool SingleScenarioRunner::parseComponentsConcurrently( const list<string>& aScenComponents,
+                                                        ValidationCache& aValidationCache )
+{
+    const vector<string> files( aScenComponents.begin(), aScenComponents.end() );
+    const size_t batchSize = max( tbb::this_task_arena::max_concurrency(), 1 );
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    for( size_t batchStart = 0; batchStart < files.size(); batchStart += batchSize ) {
+        const size_t batchEnd = min( batchStart + batchSize, files.size() );
+        vector<DOMDocument*> documents( batchEnd - batchStart, 0 );
+        // Decide which to validate up front as the cache is not thread safe.
+        vector<char> validate( batchEnd - batchStart );
+        // Any which were read ahead by the BatchRunner are not read again.
+        for( size_t i = batchStart; i < batchEnd; ++i ) {
+            validate[ i - batchStart ] = aValidationCache.shouldValidate( files[ i ] );
+            documents[ i - batchStart ] = InputPrefetcher::takeDocument( files[ i ], validate[ i - batchStart ] != 0 );
+        }
+        tbb::parallel_for( tbb::blocked_range<size_t>( batchStart, batchEnd, 1 ),
+                           [&files, &documents, &validate, batchStart]( const tbb::blocked_range<size_t>& aRange )
+        {
+            for( size_t i = aRange.begin(); i != aRange.end(); ++i ) {
+                if( !documents[ i - batchStart ] ) {
+                    documents[ i - batchStart ] = XMLHelper<void>::readDocument( files[ i ], validate[ i - batchStart ] != 0 );
+                }
+            }
+        } );
+        
+        bool success = true;
+        for( size_t i = batchStart; i < batchEnd; ++i ) {
+            DOMDocument* document = documents[ i - batchStart ];
+            if( success ) {
+                mainLog.setLevel( ILogger::NOTICE );
+                mainLog << "Parsing " << files[ i ] << " scenario component." << endl;
+                success = document && mScenario->XMLParse( document->getDocumentElement() );
+                if( success ) {
+                    aValidationCache.setValidated( files[ i ] );
+                }
+            }
+            if( document ) {
+                document->release();
+            }
+        }
+        if( !success ) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
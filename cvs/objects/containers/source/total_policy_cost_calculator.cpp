@@ -42,6 +42,9 @@
 #include <cassert>
 #include <vector>
 #include <string>
+#include <sstream>
+#include <iomanip>
+#include <limits>
 #include "containers/include/scenario.h"
 #include "containers/include/world.h"
 #include "util/base/include/util.h"
@@ -50,6 +53,7 @@
 #include "util/curves/include/point_set.h"
 #include "util/curves/include/xy_data_point.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/configuration_setting.h"
 #include "util/base/include/model_time.h"
 #include "marketplace/include/marketplace.h"
 #include "containers/include/iinfo.h"
@@ -57,6 +61,7 @@
 #include "util/curves/include/explicit_point_set.h"
 #include "util/base/include/auto_file.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/process_pool.h"
 #include "containers/include/total_policy_cost_calculator.h"
 #include "containers/include/single_scenario_runner.h"
 #include "policy/include/policy_ghg.h"
@@ -67,6 +72,15 @@
 using namespace std;
 using namespace xercesc;
 
+namespace {
+    //! The number of processes to run cost curve trials in.
+    const ConfigurationSetting<int> gCostCurveWorkers( "cost-curve-workers", 0 );
+    //! Whether each cost curve trial starts from the solution of the previous one.
+    const ConfigurationSetting<bool> gCostCurveWarmStart( "cost-curve-warm-start", false );
+    //! The restart period, -1 if not restarting.
+    const ConfigurationSetting<int> gRestartPeriod( "restart-period", -1, true );
+}
+
 /*! \brief Constructor.
 * \param aSingleScenario The single scenario runner.
 */
@@ -169,67 +183,222 @@ bool TotalPolicyCostCalculator::calculateAbatementCostCurve() {
 * distributed from 0 to the full carbon tax for each period. It then calculates and 
 * sets the fixed tax for each year. The scenario is then run, and the emissions and 
 * tax curves are stored for each region.
+*
+* If the integer configuration value "cost-curve-workers" is greater than zero
+* that many trials are run at once, each in a separate process which starts
+* from the solved state of the policy scenario. This is only possible on POSIX
+* systems when GCAM is not built with GCAM_PARALLEL_ENABLED, since the threads
+* used by a parallel build can not be copied into a new process.
 * \return Whether all model runs completed successfully.
 * \author Josh Lurz
 */
 bool TotalPolicyCostCalculator::runTrials(){
-    // Get the number of max periods.
-    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
-    const int maxPeriod = modeltime->getmaxper();
+    const int numWorkers = gCostCurveWorkers.get();
+    if( numWorkers > 0 ){
+        if( ProcessPool::isAvailable() ){
+            return runTrialsInProcesses( numWorkers );
+        }
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Cost curve points can not be run in separate processes in this build of GCAM." << endl;
+    }
+
+    vector<int> points;
+    for( int currPoint = mNumPoints - 1; currPoint >= 0; currPoint-- ){
+        points.push_back( currPoint );
+    }
+    return runTrialsInProcess( points );
+}
 
+/*! \brief Run the trials for the given points one after another.
+* \details The solved market prices of the policy scenario are restored after
+*          each trial so that every trial starts from the same prices. If the
+*          boolean configuration value "cost-curve-warm-start" is set they are
+*          instead only restored after the last trial, so that each trial
+*          starts from the solution of the one before it, which has the
+*          nearest tax fraction of those already solved. Solvers which use a
+*          Jacobian cache will likewise start each period from the Jacobian of
+*          the previous trial.
+* \param aPoints The points to run in the order to run them.
+* \return Whether all model runs completed successfully.
+*/
+bool TotalPolicyCostCalculator::runTrialsInProcess( const vector<int>& aPoints ){
     bool success = true;
-    const static bool usingRestartPeriod = Configuration::getInstance()->getInt(
-        "restart-period", -1 ) != -1;
+    const bool usingRestartPeriod = gRestartPeriod.get() != -1;
+    const bool warmStart = gCostCurveWarmStart.get();
     // Store original solved market prices before looping.
     if( !usingRestartPeriod ) {
         mSingleScenario->getInternalScenario()->getMarketplace()->store_prices_for_cost_calculation();
     }
     // Loop through for each point.
-    for( int currPoint = mNumPoints - 1; currPoint >= 0; currPoint-- ){
-        // Determine the fraction of the full tax this tax will be.
-        const double fraction = static_cast<double>( currPoint ) / static_cast<double>( mNumPoints );
-        // Iterate through the regions to set different taxes for each if necessary.
-        // Currently this will set the same for all of them.
-        for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
-            // Vector which will contain taxes for this trial.
-            vector<double> currTaxes( maxPeriod );
-
-            // Set the tax for each year. 
-            for( int per = 0; per < maxPeriod; per++ ){
-                const int year = modeltime->getper_to_yr( per );
-                double origTax = rIter->second->getY( year );
-                currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
-                    origTax * fraction;
-            }
-            // Set the fixed taxes into the world.
-            GHGPolicy tax( mGHGName, rIter->first, currTaxes );
-            mSingleScenario->getInternalScenario()->setTax( &tax );
+    for( vector<int>::const_iterator currPoint = aPoints.begin(); currPoint != aPoints.end(); ++currPoint ){
+        success &= runTrial( *currPoint );
+
+        // Restore original solved market prices after each cost iteration to ensure same
+        // starting prices for each iteration.  This is necessary due to changing initial prices.
+        const bool isLastPoint = currPoint + 1 == aPoints.end();
+        if( usingRestartPeriod ? ( *currPoint - 1 ) == 0 : !warmStart || isLastPoint ) {
+            mSingleScenario->getInternalScenario()->getMarketplace()->restore_prices_for_cost_calculation();
         }
+    }
+    return success;
+}
 
-        // Create an ending for the output files using the run number.
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Starting cost curve point run number " << currPoint << "." << endl;
+/*! \brief Run the scenario with the fixed taxes for a single point and store
+*          the abatement curves.
+* \param aPoint The point to run.
+* \return Whether the model run completed successfully.
+*/
+bool TotalPolicyCostCalculator::runTrial( const int aPoint ){
+    // Get the number of max periods.
+    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
+    const int maxPeriod = modeltime->getmaxper();
 
-        // Run the scenario with the add-on extension to the output file names
-        // as the point number. This allows the output file to be named debug +
-        // point number.
-        success &= mSingleScenario->getInternalScenario()->run( Scenario::RUN_ALL_PERIODS, true,
-                                                                util::toString( currPoint ) );
+    // Determine the fraction of the full tax this tax will be.
+    const double fraction = static_cast<double>( aPoint ) / static_cast<double>( mNumPoints );
+    // Iterate through the regions to set different taxes for each if necessary.
+    // Currently this will set the same for all of them.
+    for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
+        // Vector which will contain taxes for this trial.
+        vector<double> currTaxes( maxPeriod );
 
-        // Save information.
-        mEmissionsQCurves[ currPoint ] = getEmissionsQuantityCurve();
-        mEmissionsTCurves[ currPoint ] = mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName );
+        // Set the tax for each year. 
+        for( int per = 0; per < maxPeriod; per++ ){
+            const int year = modeltime->getper_to_yr( per );
+            double origTax = rIter->second->getY( year );
+            currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
+                origTax * fraction;
+        }
+        // Set the fixed taxes into the world.
+        GHGPolicy tax( mGHGName, rIter->first, currTaxes );
+        mSingleScenario->getInternalScenario()->setTax( &tax );
+    }
 
-        // Restore original solved market prices after each cost iteration to ensure same
-        // starting prices for each iteration.  This is necessary due to changing initial prices.
-        if( !usingRestartPeriod || ( currPoint - 1 ) == 0 ) {
-            mSingleScenario->getInternalScenario()->getMarketplace()->restore_prices_for_cost_calculation();
+    // Create an ending for the output files using the run number.
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Starting cost curve point run number " << aPoint << "." << endl;
+
+    // Run the scenario with the add-on extension to the output file names
+    // as the point number. This allows the output file to be named debug +
+    // point number.
+    const bool success = mSingleScenario->getInternalScenario()->run( Scenario::RUN_ALL_PERIODS, true,
+                                                                      util::toString( aPoint ) );
+
+    // Save information.
+    mEmissionsQCurves[ aPoint ] = getEmissionsQuantityCurve();
+    mEmissionsTCurves[ aPoint ] = mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName );
+    return success;
+}
+
+/*! \brief Run the trials in separate processes.
+* \details Each trial is run in a child process forked from this one, so that
+*          it starts from the solved state of the policy scenario, which this
+*          process keeps. The child sends back the abatement curves of its
+*          trial. Any trial for which no curves were received, for instance
+*          because its process crashed, is run again in this process once the
+*          others have finished.
+* \param aNumWorkers The maximum number of trials to run at once.
+* \return Whether all model runs completed successfully.
+*/
+bool TotalPolicyCostCalculator::runTrialsInProcesses( const int aNumWorkers ){
+    const vector<ProcessPool::Result> results = ProcessPool::run( mNumPoints, aNumWorkers, "cost-point",
+        [this]( const int aPoint, string& aOutput ) {
+            const bool success = runTrial( aPoint );
+            stringstream curves;
+            curves << setprecision( numeric_limits<double>::digits10 + 2 );
+            writeCurves( curves, mEmissionsQCurves[ aPoint ] );
+            writeCurves( curves, mEmissionsTCurves[ aPoint ] );
+            aOutput = curves.str();
+            return success;
+        } );
+
+    bool success = true;
+    vector<int> failedPoints;
+    for( int point = mNumPoints - 1; point >= 0; --point ){
+        istringstream curves( results[ point ].mOutput );
+        if( results[ point ].mCompleted &&
+            readCurves( curves, mEmissionsQCurves[ point ] ) &&
+            readCurves( curves, mEmissionsTCurves[ point ] ) )
+        {
+            success &= results[ point ].mSuccess;
+            continue;
         }
+
+        // Discard any curves which were read.
+        for( int curveSet = 0; curveSet < 2; ++curveSet ){
+            RegionCurves& partialCurves = curveSet == 0 ? mEmissionsQCurves[ point ] : mEmissionsTCurves[ point ];
+            for( RegionCurvesIterator del = partialCurves.begin(); del != partialCurves.end(); ++del ){
+                delete del->second;
+            }
+            partialCurves.clear();
+        }
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Cost curve point run number " << point << " did not complete, it will be run again." << endl;
+        failedPoints.push_back( point );
+    }
+
+    // Run any trials which failed in this process.
+    if( !failedPoints.empty() ){
+        success &= runTrialsInProcess( failedPoints );
     }
     return success;
 }
 
+/*! \brief Write curves by region to a stream so they can be read by readCurves.
+* \param aOut The stream to write to.
+* \param aCurves The curves by region.
+*/
+void TotalPolicyCostCalculator::writeCurves( ostream& aOut, const RegionCurves& aCurves ){
+    aOut << aCurves.size() << '\n';
+    for( CRegionCurvesIterator rIter = aCurves.begin(); rIter != aCurves.end(); ++rIter ){
+        const Curve::SortedPairVector pairs = rIter->second->getSortedPairs();
+        aOut << rIter->first << '\n' << pairs.size();
+        for( Curve::SortedPairVector::const_iterator currPair = pairs.begin(); currPair != pairs.end(); ++currPair ){
+            aOut << ' ' << currPair->first << ' ' << currPair->second;
+        }
+        aOut << '\n';
+    }
+}
+
+/*! \brief Read curves by region written by writeCurves.
+* \param aIn The stream to read from.
+* \param aCurves The curves by region which will be filled in. The caller owns
+*        the curves.
+* \return Whether the curves were read successfully.
+*/
+bool TotalPolicyCostCalculator::readCurves( istream& aIn, RegionCurves& aCurves ){
+    size_t numRegions = 0;
+    if( !( aIn >> numRegions ) ){
+        return false;
+    }
+    aIn.ignore( numeric_limits<streamsize>::max(), '\n' );
+    for( size_t region = 0; region < numRegions; ++region ){
+        string regionName;
+        size_t numPairs = 0;
+        if( !getline( aIn, regionName ) || !( aIn >> numPairs ) ){
+            return false;
+        }
+        ExplicitPointSet* points = new ExplicitPointSet();
+        for( size_t currPair = 0; currPair < numPairs; ++currPair ){
+            double x = 0;
+            double y = 0;
+            aIn >> x >> y;
+            points->addPoint( new XYDataPoint( x, y ) );
+        }
+        aIn.ignore( numeric_limits<streamsize>::max(), '\n' );
+        const Curve* curve = new PointSetCurve( points );
+        if( !aIn ){
+            delete curve;
+            return false;
+        }
+        delete aCurves[ regionName ];
+        aCurves[ regionName ] = curve;
+    }
+    return true;
+}
+
 /*! \brief Create a cost curve for each period and region.
 * \details Using the cost curves generated by the trials, generate and stored a set of cost
 * curves by period and region.
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/tracepoints.h"
 
 #include <string>
 #include <cassert>
@@ -64,6 +65,8 @@
 #include "util/curves/include/explicit_point_set.h"
 #include "util/curves/include/xy_data_point.h"
 #include "solution/util/include/calc_counter.h"
+#include "solution/util/include/activity_profiler.h"
+#include "solution/util/include/calc_trace.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/ivisitor.h"
 #include "climate/include/iclimate_model.h"
@@ -80,7 +83,9 @@
 #include "containers/include/iactivity.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
 #include "parallel/include/gcam_parallel.hpp"
+#include "util/base/include/manage_state_variables.hpp"
 #endif
 
 // Uncommenting the following two lines will turn on floating-point exceptions within World::calc(),
@@ -100,6 +105,9 @@ World::World()
 {
     mClimateModel = 0;
     mCalcCounter = new CalcCounter();
+    mActivityProfiler = 0;
+    mCalcTrace = 0;
+    mEvalAccuracy = FULL_ACCURACY;
     mGlobalTechDB = new GlobalTechnologyDatabase();
 }
 
@@ -115,6 +123,8 @@ void World::clear(){
     }
     delete mClimateModel;
     delete mCalcCounter;
+    delete mActivityProfiler;
+    delete mCalcTrace;
     delete mGlobalTechDB;
 }
 
@@ -190,6 +200,17 @@ void World::completeInit() {
     MarketDependencyFinder* depFinder = scenario->getMarketplace()->getDependencyFinder();
     depFinder->createOrdering();
     mGlobalOrdering = depFinder->getOrdering();
+#if GCAM_TRACEPOINTS_ENABLED
+    // Let tracing tools name the activity ids in the activity_calc tracepoints.
+    for( size_t i = 0; i < mGlobalOrdering.size(); ++i ) {
+        GCAM_TRACE_LABEL( activity_label, GCAM_TRACE_ID( mGlobalOrdering[ i ] ), i,
+                          mGlobalOrdering[ i ]->getDescription().c_str() );
+    }
+#endif
+    if( ActivityProfiler::isEnabled() ) {
+        delete mActivityProfiler;
+        mActivityProfiler = new ActivityProfiler( mGlobalOrdering );
+    }
 #if GCAM_PARALLEL_ENABLED
     Timer &totalgraphtimer = TimerRegistry::getInstance().getTimer("total-graph");
     totalgraphtimer.start();
@@ -275,6 +296,7 @@ void World::initCalc( const int period ) {
         }
         ( *i )->initCalc( period );
     }
+    calcRegionLocalPhase( &Region::initCalcLocal, period );
     
     Configuration* conf = Configuration::getInstance();
     if( conf->getBool( "CalibrationActive" ) ){
@@ -315,6 +337,11 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
      */
     assert( aItemsToCalc.size() <= mGlobalOrdering.size() );
 
+    if( mCalcTrace ) {
+        // A calc list is in global order so one as long is the whole model.
+        mCalcTrace->recordCalc( aItemsToCalc.size() == mGlobalOrdering.size() ? 0 : &aItemsToCalc, false );
+    }
+
 #ifdef GNU_SOURCE
     int except = feenableexcept(FE_DIVBYZERO | FE_INVALID);
 #endif
@@ -323,8 +350,19 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
     mCalcCounter->incrementCount( static_cast<double>( aItemsToCalc.size() ) / static_cast<double>( mGlobalOrdering.size() ) );
     
     // Perform calculation on each item to calculate. 
-    for( vector<IActivity*>::const_iterator it = aItemsToCalc.begin(); it != aItemsToCalc.end(); ++it ) {
-        (*it)->calc( aPeriod );
+    if( mActivityProfiler ) {
+        for( vector<IActivity*>::const_iterator it = aItemsToCalc.begin(); it != aItemsToCalc.end(); ++it ) {
+            GCAM_TRACE_BEGIN( activity_calc, GCAM_TRACE_ID( *it ), aPeriod );
+            mActivityProfiler->calc( *it, mActivityProfiler->getActivityIndex( *it ), aPeriod );
+            GCAM_TRACE_END( activity_calc, GCAM_TRACE_ID( *it ), aPeriod );
+        }
+    }
+    else {
+        for( vector<IActivity*>::const_iterator it = aItemsToCalc.begin(); it != aItemsToCalc.end(); ++it ) {
+            GCAM_TRACE_BEGIN( activity_calc, GCAM_TRACE_ID( *it ), aPeriod );
+            (*it)->calc( aPeriod );
+            GCAM_TRACE_END( activity_calc, GCAM_TRACE_ID( *it ), aPeriod );
+        }
     }
 #ifdef GNU_SOURCE
     feenableexcept(except);
@@ -333,8 +371,10 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
 
 #if GCAM_PARALLEL_ENABLED
 /*! Calculate supply, demand, and emissions for a single time period
- * \details This version of calc uses the TBB Flow Graph to do the calculation in
- *          parallel.  Correct ordering of the calculations is ensured by the graph.
+ * \details This version of calc uses the TBB Flow Graph, or the grain schedule
+ *          if the configuration parallel-executor is "schedule", to do the
+ *          calculation in parallel.  Correct ordering of the calculations is
+ *          ensured by the graph.
  * \param aPeriod Time period to calculate
  * \param aWorkGraph Structure containing the TBB flow graph.  It can be the graph
  *          for the whole model, or for a desired subset.  If null is provided the
@@ -346,6 +386,10 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
  */
 void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IActivity*>* aCalcList )
 {
+    if( mCalcTrace ) {
+        mCalcTrace->recordCalc( aCalcList, true );
+    }
+
 #ifdef GNU_SOURCE
     int except = feenableexcept(FE_DIVBYZERO | FE_INVALID);
 #endif
@@ -358,17 +402,38 @@ void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IAc
         // calc list which is used to skip uncessary activities that are not contained in
         // the given calc list.
         aWorkGraph = mTBBGraphGlobal;
-        aWorkGraph->mCalcList = aCalcList;
+        GcamParallel::setCalcList( *aWorkGraph, aCalcList, mGlobalOrdering );
     }
     else {
         // When a work graph is provided we assume all items in that graph should be
         // calculated.
-        aWorkGraph->mCalcList = 0;
+        GcamParallel::setCalcList( *aWorkGraph, 0, mGlobalOrdering );
     }
     aWorkGraph->mPeriod = aPeriod;
-    // do the model calculation
-    aWorkGraph->mHead.try_put( tbb::flow::continue_msg() );
-    aWorkGraph->mTBBFlowGraph.wait_for_all();
+    aWorkGraph->mProfiler = mActivityProfiler;
+    // only full model calculations are profiled so that the costs are comparable
+    const bool isProfiling = !aWorkGraph->mCalcList && aWorkGraph->mNumCalcsToProfile > 0;
+    aWorkGraph->mIsProfiling = isProfiling;
+    // do the model calculation accumulating the additions to each market in
+    // the order of the global ordering rather than locking them
+    Marketplace* marketplace = scenario->getMarketplace();
+    marketplace->startParallelAccumulation( aPeriod );
+    if( aWorkGraph->mUseSchedule ) {
+        GcamParallel::calcSchedule( *aWorkGraph );
+    }
+    else {
+        aWorkGraph->mHead.try_put( tbb::flow::continue_msg() );
+        aWorkGraph->mTBBFlowGraph.wait_for_all();
+    }
+    marketplace->finishParallelAccumulation();
+    
+    if( isProfiling ) {
+        aWorkGraph->mIsProfiling = false;
+        ++aWorkGraph->mNumCalcsProfiled;
+        if( --aWorkGraph->mNumCalcsToProfile == 0 ) {
+            GcamParallel::writeActivityCosts( *aWorkGraph, mGlobalOrdering );
+        }
+    }
 
 #ifdef GNU_SOURCE
     feenableexcept(except);
@@ -377,9 +442,13 @@ void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IAc
 #endif
 
 
-/*! Calculates the global emissions.
+/*! \brief Calculates the global emissions and passes them to the climate model.
+ * \details The emissions for all of the periods in the range are summed in a
+ *          single visit of the model.
+ * \param aStartPeriod The first period for which to set emissions.
+ * \param aEndPeriod The last period for which to set emissions.
  */
-void World::setEmissions( int period ) {
+void World::setEmissions( const int aStartPeriod, const int aEndPeriod ) {
     // Declare visitors which will aggregate emissions by period.
     EmissionsSummer co2Summer( "CO2" );
     LUCEmissionsSummer co2LandUseSummer( "CO2NetLandUse" );
@@ -426,7 +495,7 @@ void World::setEmissions( int period ) {
     EmissionsSummer ocawbSummer( "OC_AWB" );
     
     // Group the EmissionsSummer together for improved performance.
-    GroupedEmissionsSummer allSummer;
+    GroupedEmissionsSummer allSummer( aStartPeriod );
     allSummer.addEmissionsSummer( &co2Summer );
     allSummer.addEmissionsSummer( &ch4Summer );
     allSummer.addEmissionsSummer( &ch4agrSummer );
@@ -469,6 +538,7 @@ void World::setEmissions( int period ) {
     allSummer.addEmissionsSummer( &ocSummer );
     allSummer.addEmissionsSummer( &bcawbSummer );
     allSummer.addEmissionsSummer( &ocawbSummer );
+    allSummer.addLUCEmissionsSummer( &co2LandUseSummer );
 
    const double TG_TO_PG = 1000;
    const double N_TO_N2O = 1.571132; 
@@ -483,183 +553,182 @@ void World::setEmissions( int period ) {
     const double HFC43_TO_134 = ( 1640.0 / 1430.0 );
     
     // Update all emissions values.
-    accept( &allSummer, period );
-    accept( &co2LandUseSummer, period );
-        
-    // Only set emissions if they are valid. If these are not set
-    // MAGICC will use the default values.
-    if( co2Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CO2", period,
-                                     co2Summer.getEmissions( period )
-                                     / TG_TO_PG );
-    }
-    
-    const int currYear = scenario->getModeltime()->getper_to_yr( period );
-    const int startYear = currYear - scenario->getModeltime()->gettimestep( period ) + 1;
-    for ( int i = startYear; i <= currYear; i++ ) {
-        if( co2LandUseSummer.areEmissionsSet( i ) ){
-            mClimateModel->setLUCEmissions( "CO2NetLandUse", i,
-                                            co2LandUseSummer.getEmissions( i )
-                                            / TG_TO_PG );
+    accept( &allSummer, aEndPeriod );
+
+    for( int period = aStartPeriod; period <= aEndPeriod; ++period ) {
+        // Only set emissions if they are valid. If these are not set
+        // MAGICC will use the default values.
+        if( co2Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CO2", period,
+                                         co2Summer.getEmissions( period )
+                                         / TG_TO_PG );
+        }
+
+        const int currYear = scenario->getModeltime()->getper_to_yr( period );
+        const int startYear = currYear - scenario->getModeltime()->gettimestep( period ) + 1;
+        for ( int i = startYear; i <= currYear; i++ ) {
+            if( co2LandUseSummer.areEmissionsSet( i ) ){
+                mClimateModel->setLUCEmissions( "CO2NetLandUse", i,
+                                                co2LandUseSummer.getEmissions( i )
+                                                / TG_TO_PG );
+            }
+        }
+
+        if( ch4Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CH4", period,
+                                         ch4Summer.getEmissions( period ) +
+                                         ch4agrSummer.getEmissions( period ) + 
+                                         ch4awbSummer.getEmissions( period ));
+        }
+
+        if( coSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CO", period,
+                                         coSummer.getEmissions( period ) +
+                                         coagrSummer.getEmissions( period ) +
+                                         coawbSummer.getEmissions( period ));
+        }
+
+        // MAGICC wants N2O emissions in Tg N, but miniCAM calculates Tg N2O
+        if( n2oSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "N2O", period,
+                                         ( n2oSummer.getEmissions( period ) +
+                                           n2oawbSummer.getEmissions( period ) +
+                                           n2oagrSummer.getEmissions( period )  )
+                                         / N_TO_N2O );
+        }
+
+        // MAGICC wants NOx emissions in Tg N, but miniCAM calculates Tg NOx
+        // FORTRAN code uses the conversion for NO2
+        if( noxSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "NOx", period,
+                                         ( noxSummer.getEmissions( period ) +
+                                           noxagrSummer.getEmissions( period ) +
+                                           noxawbSummer.getEmissions( period ))
+                                         / N_TO_NO2 );
+        }
+
+        double so2total=0.0;
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        // Region 1 includes SO21 and 60% of SO24 (FSU)
+        if( so21Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
+            double so21 = so21Summer.getEmissions( period ) +
+                so21awbSummer.getEmissions( period )
+                + 0.6*so24Summer.getEmissions( period ) 
+                + 0.6*so24awbSummer.getEmissions( period ); 
+
+            mClimateModel->setEmissions( "SOXreg1", period, so21/S_TO_SO2);
+            so2total += so21;
+        }
+
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        // Region 2 includes SO22 and 40% of SO24 (FSU)
+        if( so22Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
+            double so22 = so22Summer.getEmissions( period ) +
+                so22awbSummer.getEmissions( period )
+                + 0.4*so24Summer.getEmissions( period ) 
+                + 0.4*so24awbSummer.getEmissions( period );
+
+            mClimateModel->setEmissions( "SOXreg2", period, so22 / S_TO_SO2);
+            so2total += so22;
+        }
+
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        if( so23Summer.areEmissionsSet( period ) ){
+            double so23 = so23Summer.getEmissions( period ) +
+                so23awbSummer.getEmissions( period );
+
+            mClimateModel->setEmissions( "SOXreg3", period, so23 / S_TO_SO2 );
+            so2total += so23;
+        }
+
+        // set total SO2 emissions for those models that want it.
+        // Emissions are in Tg SO2; it is up to models that want
+        // something different to make their own conversion.
+        mClimateModel->setEmissions("SO2tot", period, so2total);
+
+        if( cf4Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CF4", period,
+                                         cf4Summer.getEmissions( period ) );
+        }
+
+        if( c2f6Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "C2F6", period,
+                                         c2f6Summer.getEmissions( period ) );
+        }
+
+        if( sf6Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "SF6", period,
+                                         sf6Summer.getEmissions( period ) );
+        }
+
+        if( hfc125Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC125", period,
+                                         hfc125Summer.getEmissions( period ) );
+        } 
+
+        if( hfc134aSummer.areEmissionsSet( period ) && hfc43Summer.areEmissionsSet( period )  ){
+            mClimateModel->setEmissions( "HFC134a", period,
+                                         hfc134aSummer.getEmissions( period ) +
+                                         hfc43Summer.getEmissions( period ) * HFC43_TO_134);
+        }
+
+        if( hfc245faSummer.areEmissionsSet( period ) && hfc32Summer.areEmissionsSet( period ) && hfc365mfcSummer.areEmissionsSet( period ) && hfc152aSummer.areEmissionsSet( period ) ){
+            // MAGICC needs HFC245fa in kton of HFC245ca
+            mClimateModel->setEmissions( "HFC245ca", period,
+                                         hfc245faSummer.getEmissions( period ) / HFC_CA_TO_FA +
+                                         hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
+                                         hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
+                                         hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
+            // For models that need ktonnes of HFC245fa (no single model should implement both of these):
+            mClimateModel->setEmissions("HFC245fa", period,
+                                        hfc245faSummer.getEmissions(period)+
+                                        hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
+                                        hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
+                                        hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
+        }
+
+        // MAGICC needs this in tons of VOC. Input is in TgC
+        if( vocSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "NMVOCs", period,
+                                         ( vocSummer.getEmissions( period ) +
+                                           vocagrSummer.getEmissions( period ) +
+                                           vocawbSummer.getEmissions( period ) ));
+        }
+
+        // MAGICC needs this in GgC. Model output is in TgC
+        if( bcSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "BC", period,
+                                         ( bcSummer.getEmissions( period ) +
+                                           bcawbSummer.getEmissions( period ) )
+                                         * TG_TO_PG );
+        }
+
+        // MAGICC needs this in GgC. Model output is in TgC
+        if( ocSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "OC", period,
+                                         ( ocSummer.getEmissions( period ) +
+                                           ocawbSummer.getEmissions( period ) )
+                                         * TG_TO_PG );
+        }
+
+
+        if( hfc227eaSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC227ea", period,
+                                         hfc227eaSummer.getEmissions( period ) );
+        }
+
+        if( hfc143aSummer.areEmissionsSet( period ) && hfc23Summer.areEmissionsSet( period ) && hfc236faSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC143a", period,
+                                         hfc143aSummer.getEmissions( period ) +
+                                         hfc23Summer.getEmissions( period ) * HFC23_TO_143 +
+                                         hfc236faSummer.getEmissions( period ) * HFC236_TO_143);
         }
-    }
-    
-    if( ch4Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CH4", period,
-                                     ch4Summer.getEmissions( period ) +
-                                     ch4agrSummer.getEmissions( period ) + 
-                                     ch4awbSummer.getEmissions( period ));
-    }
-    
-    if( coSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CO", period,
-                                     coSummer.getEmissions( period ) +
-                                     coagrSummer.getEmissions( period ) +
-                                     coawbSummer.getEmissions( period ));
-    }
-    
-    // MAGICC wants N2O emissions in Tg N, but miniCAM calculates Tg N2O
-    if( n2oSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "N2O", period,
-                                     ( n2oSummer.getEmissions( period ) +
-                                       n2oawbSummer.getEmissions( period ) +
-                                       n2oagrSummer.getEmissions( period )  )
-                                     / N_TO_N2O );
-    }
-    
-    // MAGICC wants NOx emissions in Tg N, but miniCAM calculates Tg NOx
-    // FORTRAN code uses the conversion for NO2
-    if( noxSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "NOx", period,
-                                     ( noxSummer.getEmissions( period ) +
-                                       noxagrSummer.getEmissions( period ) +
-                                       noxawbSummer.getEmissions( period ))
-                                     / N_TO_NO2 );
-    }
-    
-    double so2total=0.0;
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    // Region 1 includes SO21 and 60% of SO24 (FSU)
-    if( so21Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
-        double so21 = so21Summer.getEmissions( period ) +
-            so21awbSummer.getEmissions( period )
-            + 0.6*so24Summer.getEmissions( period ) 
-            + 0.6*so24awbSummer.getEmissions( period ); 
-        
-        mClimateModel->setEmissions( "SOXreg1", period, so21/S_TO_SO2);
-        so2total += so21;
-    }
-    
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    // Region 2 includes SO22 and 40% of SO24 (FSU)
-    if( so22Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
-        double so22 = so22Summer.getEmissions( period ) +
-            so22awbSummer.getEmissions( period )
-            + 0.4*so24Summer.getEmissions( period ) 
-            + 0.4*so24awbSummer.getEmissions( period );
-        
-        mClimateModel->setEmissions( "SOXreg2", period, so22 / S_TO_SO2);
-        so2total += so22;
-    }
-    
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    if( so23Summer.areEmissionsSet( period ) ){
-        double so23 = so23Summer.getEmissions( period ) +
-            so23awbSummer.getEmissions( period );
-        
-        mClimateModel->setEmissions( "SOXreg3", period, so23 / S_TO_SO2 );
-        so2total += so23;
-    }
-    
-    // set total SO2 emissions for those models that want it.
-    // Emissions are in Tg SO2; it is up to models that want
-    // something different to make their own conversion.
-    mClimateModel->setEmissions("SO2tot", period, so2total);
-    
-    if( cf4Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CF4", period,
-                                     cf4Summer.getEmissions( period ) );
-    }
-    
-    if( c2f6Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "C2F6", period,
-                                     c2f6Summer.getEmissions( period ) );
-    }
-    
-    if( sf6Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "SF6", period,
-                                     sf6Summer.getEmissions( period ) );
-    }
-    
-    if( hfc125Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC125", period,
-                                     hfc125Summer.getEmissions( period ) );
-    } 
-    
-    if( hfc134aSummer.areEmissionsSet( period ) && hfc43Summer.areEmissionsSet( period )  ){
-        mClimateModel->setEmissions( "HFC134a", period,
-                                     hfc134aSummer.getEmissions( period ) +
-                                     hfc43Summer.getEmissions( period ) * HFC43_TO_134);
-    }
-
-    if( hfc245faSummer.areEmissionsSet( period ) && hfc32Summer.areEmissionsSet( period ) && hfc365mfcSummer.areEmissionsSet( period ) && hfc152aSummer.areEmissionsSet( period ) ){
-        // MAGICC needs HFC245fa in kton of HFC245ca
-        mClimateModel->setEmissions( "HFC245ca", period,
-                                     hfc245faSummer.getEmissions( period ) / HFC_CA_TO_FA +
-                                     hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
-                                     hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
-                                     hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
-        // For models that need ktonnes of HFC245fa (no single model should implement both of these):
-        mClimateModel->setEmissions("HFC245fa", period,
-                                    hfc245faSummer.getEmissions(period)+
-                                    hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
-                                    hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
-                                    hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
-    }
-    
-    // MAGICC needs this in tons of VOC. Input is in TgC
-    if( vocSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "NMVOCs", period,
-                                     ( vocSummer.getEmissions( period ) +
-                                       vocagrSummer.getEmissions( period ) +
-                                       vocawbSummer.getEmissions( period ) ));
-    }
-    
-    // MAGICC needs this in GgC. Model output is in TgC
-    if( bcSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "BC", period,
-                                     ( bcSummer.getEmissions( period ) +
-                                       bcawbSummer.getEmissions( period ) )
-                                     * TG_TO_PG );
-    }
-    
-    // MAGICC needs this in GgC. Model output is in TgC
-    if( ocSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "OC", period,
-                                     ( ocSummer.getEmissions( period ) +
-                                       ocawbSummer.getEmissions( period ) )
-                                     * TG_TO_PG );
-    }
-    
-    
-    if( hfc227eaSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC227ea", period,
-                                     hfc227eaSummer.getEmissions( period ) );
-    }
-    
-    if( hfc143aSummer.areEmissionsSet( period ) && hfc23Summer.areEmissionsSet( period ) && hfc236faSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC143a", period,
-                                     hfc143aSummer.getEmissions( period ) +
-                                     hfc23Summer.getEmissions( period ) * HFC23_TO_143 +
-                                     hfc236faSummer.getEmissions( period ) * HFC236_TO_143);
     }
 }
     
 void World::runClimateModel() {
     // The Climate model reads in data for the base period, so skip passing it in.
-    for( int period = 1; period < scenario->getModeltime()->getmaxper(); ++period ) {
-        setEmissions( period );
-    }
+    setEmissions( 1, scenario->getModeltime()->getmaxper() - 1 );
     
     // Run the model.
     mClimateModel->runModel();
@@ -667,7 +736,7 @@ void World::runClimateModel() {
 
 void World::runClimateModel( int aPeriod ) {
     if( aPeriod > 0 ) {
-        setEmissions( aPeriod );
+        setEmissions( aPeriod, aPeriod );
         mClimateModel->runModel( scenario->getModeltime()->getper_to_yr( aPeriod ) );
     }
 }
@@ -684,11 +753,34 @@ void World::runClimateModel( int aPeriod ) {
 * \return Boolean true if calibration is ok.
 */
 bool World::isAllCalibrated( const int period, double calAccuracy, const bool printWarnings ) const {
+    // Check the regions without warnings first, concurrently if allowed, so that
+    // only those which are not calibrated are checked again to report on them.
+    vector<char> isRegionCalibrated( mRegions.size(), 1 );
+#if GCAM_PARALLEL_ENABLED
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    if( stateVars && Configuration::getInstance()->getBool( "parallel-region-phases", false, false ) ) {
+        stateVars->mThreadPool.execute( [this, period, calAccuracy, &isRegionCalibrated]() {
+            tbb::parallel_for( size_t( 0 ), mRegions.size(), [this, period, calAccuracy, &isRegionCalibrated]( size_t i ) {
+                isRegionCalibrated[ i ] = mRegions[ i ]->isAllCalibrated( period, calAccuracy, false );
+            } );
+        } );
+    }
+    else
+#endif
+    {
+        for( size_t i = 0; i < mRegions.size(); ++i ) {
+            isRegionCalibrated[ i ] = mRegions[ i ]->isAllCalibrated( period, calAccuracy, false );
+        }
+    }
+    
     bool isAllCalibrated = true;
     ILogger& calLog = ILogger::getLogger( "calibration_log" );
     calLog.setLevel( ILogger::DEBUG );
     for( CRegionIterator i = mRegions.begin(); i != mRegions.end(); i++ ){
-        bool currRegionCalibrated = ( *i )->isAllCalibrated( period, calAccuracy, printWarnings );
+        bool currRegionCalibrated = isRegionCalibrated[ i - mRegions.begin() ] != 0;
+        if( !currRegionCalibrated && printWarnings ) {
+            ( *i )->isAllCalibrated( period, calAccuracy, printWarnings );
+        }
         isAllCalibrated &= currRegionCalibrated;
         // if we did not calibrate this region correctly and we are printing warnings then give the
         // user some I/O tables to help them understand what was inconsistent
@@ -741,6 +833,23 @@ void World::setTax( const GHGPolicy* aTax ){
     }
 }
 
+/*! \brief Update a fixed tax in all regions without replacing the policies.
+* \details Every region must already have the policy initialized as a fixed
+*          tax.  If any region could not be updated the caller should use setTax
+*          instead which replaces the policy in all regions.
+* \param aTaxName The name of the policy to update.
+* \param aFixedTaxes The new fixed taxes by period.
+* \return Whether the taxes were updated in place.
+*/
+bool World::updateFixedTaxes( const string& aTaxName, const vector<double>& aFixedTaxes ){
+    for( RegionIterator iter = mRegions.begin(); iter != mRegions.end(); ++iter ){
+        if( !(*iter)->updateFixedTaxes( aTaxName, aFixedTaxes ) ){
+            return false;
+        }
+    }
+    return true;
+}
+
 /*! \brief Get the climate model.
 * \return The climate model.
 */
@@ -748,6 +857,13 @@ const IClimateModel* World::getClimateModel() const {
     return mClimateModel;
 }
 
+/*! \brief Get the climate model so that it may be run on its own.
+* \return The climate model.
+*/
+IClimateModel* World::getClimateModel() {
+    return mClimateModel;
+}
+
 /*! \brief A function to generate a series of ghg emissions quantity curves based on an already performed model run.
 * \details This function used the information stored in it to create a series of curves, one for each region,
 * with each datapoint containing a time period and an amount of gas emissions.
@@ -797,6 +913,53 @@ CalcCounter* World::getCalcCounter() const {
     return mCalcCounter;
 }
 
+/*!
+ * \brief Get the activity profiler.
+ * \details Solvers use this to attribute calculations to their components.
+ * \return The activity profiler, or null if activities are not being profiled.
+ */
+ActivityProfiler* World::getActivityProfiler() const {
+    return mActivityProfiler;
+}
+
+/*!
+ * \brief Start recording the calls to calc for offline replay.
+ * \details Any trace already being recorded is finished first.
+ * \param aPeriod The period being traced.
+ * \sa CalcTrace
+ */
+void World::startCalcTrace( const int aPeriod ) {
+    delete mCalcTrace;
+    mCalcTrace = new CalcTrace( aPeriod, mGlobalOrdering );
+}
+
+//! Finish recording the calls to calc.
+void World::stopCalcTrace() {
+    delete mCalcTrace;
+    mCalcTrace = 0;
+}
+
+/*!
+ * \brief Get the trace of the calls to calc.
+ * \details Solvers use this to record changes to the state made outside of calc.
+ * \return The trace, or null if calc is not being traced.
+ */
+CalcTrace* World::getCalcTrace() const {
+    return mCalcTrace;
+}
+
+/*!
+ * \brief Set the accuracy with which calc evaluates the model.
+ * \details Activities check this with getEvalAccuracy as they calculate.  Note
+ *          that results calculated at one accuracy are not recalculated when
+ *          it changes, so a caller which raises the accuracy must follow with
+ *          a full calc before relying on the state of the model.
+ * \param aAccuracy The accuracy for subsequent calls to calc.
+ */
+void World::setEvalAccuracy( const EvalAccuracy aAccuracy ) {
+    mEvalAccuracy = aAccuracy;
+}
+
 /*! \brief Call any calculations that are only done once per period after
 *          solution is found.
 * \details This function is used to calculate and store variables which are only
@@ -809,6 +972,56 @@ void World::postCalc( const int aPeriod ){
     for( RegionIterator region = mRegions.begin(); region != mRegions.end(); ++region ){
         (*region)->postCalc( aPeriod );
     }
+    calcRegionLocalPhase( &Region::postCalcLocal, aPeriod );
+
+    if( mActivityProfiler ) {
+        mActivityProfiler->endPeriod( aPeriod );
+    }
+}
+
+/*!
+ * \brief Call a region local phase, such as Region::initCalcLocal, for all
+ *        regions.
+ * \details When the configuration parallel-region-phases is set the regions are
+ *          calculated concurrently in the ManageStateVariables thread pool.  To
+ *          be safe to do so a region local phase must follow these rules:
+ *          - Only objects owned by the region may be changed.
+ *          - The Marketplace may only be read, for instance prices and market
+ *            info.  No markets may be created, no supplies or demands added,
+ *            and no market info set as markets are shared between regions.
+ *          - The MarketDependencyFinder and the global technology database may
+ *            not be used.
+ *          - Loggers may be used but messages from different regions may be
+ *            interleaved.
+ *          Everything else, including Region::completeInit which creates markets
+ *          and registers dependencies in an order that determines the market
+ *          numbers and the global ordering, stays in the serial region loops.
+ * \param aPhase The region method to call.
+ * \param aPeriod The model period.
+ */
+void World::calcRegionLocalPhase( void (Region::*aPhase)( const int ), const int aPeriod ) {
+#if GCAM_PARALLEL_ENABLED
+    if( Configuration::getInstance()->getBool( "parallel-region-phases", false, false ) ) {
+        auto regionLoop = [this, aPhase, aPeriod]() {
+            tbb::parallel_for( size_t( 0 ), mRegions.size(), [this, aPhase, aPeriod]( size_t i ) {
+                ( mRegions[ i ]->*aPhase )( aPeriod );
+            } );
+        };
+        // The state variables only exist while a period is being solved, so they
+        // are not available during initCalc, in which case use the default thread pool.
+        ManageStateVariables* stateVars = scenario->getManageStateVariables();
+        if( stateVars ) {
+            stateVars->mThreadPool.execute( regionLoop );
+        }
+        else {
+            regionLoop();
+        }
+        return;
+    }
+#endif
+    for( RegionIterator region = mRegions.begin(); region != mRegions.end(); ++region ){
+        ( (*region)->*aPhase )( aPeriod );
+    }
 }
 
 /*!
@@ -51,6 +51,7 @@
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/ivisitable.h"
+#include "util/base/include/time_vector.h"
 #include "demographics/include/population.h"
 #include "util/base/include/data_definition_util.h"
 
@@ -103,6 +104,23 @@ private:
     //! routines.
     std::map<std::string,int> yearToMapIndex;
 
+    //! Index into the population vector for each model period, or -1 if
+    //! there is no population for the period.  Set in completeInit.
+    objects::PeriodVector<int> mPopulationIndex;
+
+    //! Total population by period, summed once in completeInit since
+    //! population does not change during the calculation.
+    objects::PeriodVector<double> mTotalPop;
+
+    //! Working age population by period.
+    objects::PeriodVector<double> mWorkingAgePop;
+
+    //! Male working age population by period.
+    objects::PeriodVector<double> mWorkingAgePopMale;
+
+    //! Female working age population by period.
+    objects::PeriodVector<double> mWorkingAgePopFemale;
+
     typedef std::map<std::string,int>::const_iterator CYearMapIterator;
     typedef std::vector<Population*>::iterator PopulationIterator;
     typedef std::vector<Population*>::const_iterator CPopulationIterator;
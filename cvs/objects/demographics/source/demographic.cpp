@@ -64,7 +64,13 @@ using namespace xercesc;
 extern Scenario* scenario;
 
 //! Default constructor.
-Demographic::Demographic() {
+Demographic::Demographic():
+mPopulationIndex( -1 ),
+mTotalPop( 0.0 ),
+mWorkingAgePop( 0.0 ),
+mWorkingAgePopMale( 0.0 ),
+mWorkingAgePopFemale( 0.0 )
+{
 }
 
 //! Demographic destructor. 
@@ -115,9 +121,8 @@ void Demographic::XMLParse( const xercesc::DOMNode* node ){
 //! Write out XML for debugging purposes.
 void Demographic::toDebugXML( const int period, ostream& out, Tabs* tabs ) const {
     XMLWriteOpeningTag ( getXMLName(), out, tabs );
-    // Convert the period into an index into the demographics object.
-    int index = convertPeriodToPopulationIndex( period );
-    // Check if the conversion into an index failed.
+    int index = mPopulationIndex[ period ];
+    // Check if there is a population for the period.
     if( index != -1 ){
         population[ index ]->toDebugXML( out, tabs );
     }
@@ -170,6 +175,19 @@ void Demographic::completeInit(){
             ( *popIter )->completeInit( (*(popIter - 1))->getSurvFemalePop(), (*( popIter - 1 ))->getSurvMalePop()  );
         }
     }
+
+    // Population is fixed once initialized so look up the population for each
+    // period and sum the cohorts once rather than every time they are requested.
+    for( int period = 0; period < modeltime->getmaxper(); ++period ) {
+        mPopulationIndex[ period ] = convertPeriodToPopulationIndex( period );
+        if( mPopulationIndex[ period ] != -1 ) {
+            const Population* currPop = population[ mPopulationIndex[ period ] ];
+            mTotalPop[ period ] = currPop->getTotal();
+            mWorkingAgePop[ period ] = currPop->getWorkingAgePop();
+            mWorkingAgePopMale[ period ] = currPop->getWorkingAgePopMale();
+            mWorkingAgePopFemale[ period ] = currPop->getWorkingAgePopFemale();
+        }
+    }
 }
 
 //! initialize anything that won't change during the calcuation
@@ -204,46 +222,22 @@ const string& Demographic::getXMLNameStatic(){
 
 //! return total population
 double Demographic::getTotal( const int per ) const {
-    // Convert the period into an index into the demographics object.
-    int index = convertPeriodToPopulationIndex( per );
-    // Check if the conversion into an index failed.
-    if( index == -1 ){
-        return 0;
-    }
-    return population[ index ]->getTotal();
+    return mTotalPop[ per ];
 }
 
 //! return the male working age population
 double Demographic::getWorkingAgePopulationMales( const int per ) const {
-    // Convert the period into an index into the demographics object.
-    int index = convertPeriodToPopulationIndex( per );
-    // Check if the conversion into an index failed.
-    if( index == -1 ){
-        return 0;
-    }
-    return population[ index ]->getWorkingAgePopMale();
+    return mWorkingAgePopMale[ per ];
 }
 
 //! return the female working age population
 double Demographic::getWorkingAgePopulationFemales( const int per ) const {
-    // Convert the period into an index into the demographics object.
-    int index = convertPeriodToPopulationIndex( per );
-    // Check if the conversion into an index failed.
-    if( index == -1 ){
-        return 0;
-    }
-    return population[ index ]->getWorkingAgePopFemale();
+    return mWorkingAgePopFemale[ per ];
 }
 
 //! return total working age population (male and female)
 double Demographic::getWorkingAgePopulation( const int per ) const {
-    // Convert the period into an index into the demographics object.
-    int index = convertPeriodToPopulationIndex( per );
-    // Check if the conversion into an index failed.
-    if( index == -1 ){
-        return 0;
-    }
-    return population[ index  ]->getWorkingAgePop();
+    return mWorkingAgePop[ per ];
 }
 
 //! Translate a period into the index within the demographic object of the population.
@@ -295,11 +289,7 @@ const vector<double> Demographic::getTotalPopVec() const {
 
     // Fill in the vector with the total population for each period.
     for ( int i = 0; i < modeltime->getmaxper(); ++i ){
-        int index = convertPeriodToPopulationIndex( i );
-        // Check for invalid indices.
-        if( index != -1 ){
-            newTotalVector[ i + 1 ] = population[ index ]->getTotal();
-        }
+        newTotalVector[ i + 1 ] = mTotalPop[ i ];
     }
     return newTotalVector;
 }
@@ -316,7 +306,7 @@ void Demographic::accept( IVisitor* aVisitor, const int aPeriod ) const {
     }
     // Otherwise only update the one for the given period.
     else {
-    int index = convertPeriodToPopulationIndex( aPeriod );
+        int index = mPopulationIndex[ aPeriod ];
         // Check for invalid indices.
         if( index != -1 ){
             population[ index ]->accept( aVisitor, aPeriod );
@@ -168,6 +168,10 @@ protected:
     )
 
 private:
+    //! The period mReduction was last calculated for in the base state, or -1
+    //! if it has not been.
+    int mReductionPeriod;
+    
     void copy( const AEmissionsControl& aOther );
 
 };
@@ -58,6 +58,7 @@
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/object_pool.h"
 
 // Forward declarations
 class GDP;
@@ -83,9 +84,10 @@ class NonCO2Emissions;
  *          The last one of these read in determines the method used.
  * \author Sonny Kim, Marshall Wise, Steve Smith, Nick Fernandez, Jim Naslund
  */
-class AGHG: public INamed, public IParsable, public IVisitable, private boost::noncopyable
+class AGHG: public INamed, public IParsable, public IVisitable, public PooledObject, private boost::noncopyable
 { 
     friend class XMLDBOutputter;
+    friend class ColumnarOutputter;
 
 public:
     //! Virtual Destructor.
@@ -108,6 +110,7 @@ public:
                                const IInfo* aTechIInfo );
 
     virtual void initCalc( const std::string& aRegionName,
+                           const std::vector<IInput*>& aInputs,
                            const IInfo* aLocalInfo,
                            const int aPeriod );
 
@@ -141,6 +144,8 @@ public:
                                 const std::vector<IOutput*>& aOutputs,
                                 const ICaptureComponent* aSequestrationDevice,
                                 const int aPeriod ) const = 0;
+
+    virtual bool isGHGValueSetByPrices() const;
     /*!
      * \brief Calculates emissions of GHG's
      * \details Emissions of these gases are equal to the emissions driver
@@ -48,6 +48,8 @@
 #include "util/base/include/default_visitor.h"
 #include "util/base/include/value.h"
 
+class LUCEmissionsSummer;
+
 /*! 
 * \ingroup Objects
 * \brief A class which sums emissions for a particular gas.
@@ -84,15 +86,20 @@ private:
  *          when a large number of EmissionsSummers need to be updated for all
  *          model periods.  Using this class to visit just once for all gasses
  *          and all periods drastically reducing runtime.
- * \note Unlike the EmissionsSummer visitor this class assumes it is visited with
- *       the aPeriod -1 flag to indicate that it will be updated for all periods.
- *       Although this behavior could easily be changed.
+ *          LUCEmissionsSummers may be added as well so that land use change
+ *          emissions are collected during the same visit.
+ * \note Unlike the EmissionsSummer visitor this class updates all periods from
+ *       the start period given at construction up to the period it is visited
+ *       with, or the last model period if it is visited with the aPeriod -1 flag.
  * \author Pralit Patel
  */
 class GroupedEmissionsSummer : public DefaultVisitor {
 public:
-    GroupedEmissionsSummer(): mCurrTech( 0 ) { }
+    explicit GroupedEmissionsSummer( const int aStartPeriod = 1 ):
+        mCurrTech( 0 ), mStartPeriod( aStartPeriod ) { }
     void addEmissionsSummer( EmissionsSummer* aEmissionsSummer );
+
+    void addLUCEmissionsSummer( LUCEmissionsSummer* aLUCEmissionsSummer );
     
     // DefaultVisitor methods
     virtual void startVisitGHG( const AGHG* aGHG,
@@ -104,8 +111,8 @@ public:
     virtual void endVisitTechnology( const Technology* aTech,
                                     const int aPeriod );
     
-    /*virtual void startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
-                                       const int aPeriod );*/
+    virtual void startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
+                                       const int aPeriod );
     
 private:
     //! A map of emissions summer by GHG name.  The memory for the EmissionsSummer
@@ -114,7 +121,16 @@ private:
     
     typedef std::map<std::string, EmissionsSummer*>::const_iterator CSummerIterator;
     
+    //! The land use change emissions summers.  The memory is not managed by
+    //! this class.
+    std::vector<LUCEmissionsSummer*> mLUCEmissionsSummers;
+
     Technology const* mCurrTech;
+
+    //! The first period to update.
+    const int mStartPeriod;
+
+    int getEndPeriod( const int aPeriod ) const;
 };
 
 #endif // _EMISSIONS_SUMMER_H_
@@ -79,6 +79,18 @@ public:
     virtual double calcEmissionsDriver( const std::vector<IInput*>& aInputs,
                                         const std::vector<IOutput*>& aOutputs,
                                         const int aPeriod ) const = 0;
+
+    /*!
+     * \brief Perform initializations that only need to be done once per period.
+     * \details Drivers may resolve the inputs they read from so that
+     *          calcEmissionsDriver does not need to search for them.  The
+     *          default is to do nothing.
+     * \param aInputs The inputs which will be passed to calcEmissionsDriver.
+     * \param aPeriod Model period.
+     */
+    virtual void initCalc( const std::vector<IInput*>& aInputs,
+                           const int aPeriod ) {}
+
     //! Clone operator.
     virtual IEmissionsDriver* clone() const = 0;
     /*
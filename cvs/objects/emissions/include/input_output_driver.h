@@ -56,9 +56,12 @@
 class InputOutputDriver: public IEmissionsDriver {
 
 public:
+    InputOutputDriver();
     virtual double calcEmissionsDriver( const std::vector<IInput*>& aInputs,
                                         const std::vector<IOutput*>& aOutputs,
                                         const int aPeriod ) const;
+    virtual void initCalc( const std::vector<IInput*>& aInputs,
+                           const int aPeriod );
     virtual InputOutputDriver* clone() const;
     virtual const std::string& getXMLName() const;
     static const std::string& getXMLNameStatic();
@@ -74,6 +77,10 @@ protected:
         //! The name of the input which should be the driver
         DEFINE_VARIABLE( SIMPLE, "input-name", mInputName, std::string )
     )
+
+    //! Index of the driving input in the technology inputs, resolved in
+    //! initCalc or -1 if it must be searched for by name.
+    int mInputIndex;
 };
 
 
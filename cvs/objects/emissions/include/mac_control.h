@@ -45,11 +45,13 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "emissions/include/aemissions_control.h"
 #include "util/base/include/time_vector.h"
 
 class PointSetCurve;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -113,7 +115,37 @@ protected:
     std::shared_ptr<objects::PeriodVector<double> > mTechChange;
 
 private:
+    /*!
+     * \brief The points of a MAC curve compiled so that the curve can be
+     *        evaluated with a binary search.
+     */
+    struct MACPoints {
+        MACPoints(): mCurve( 0 ) {}
+
+        //! The curve the points were compiled from.
+        const PointSetCurve* mCurve;
+
+        //! The x values of the curve sorted in ascending order.
+        std::vector<double> mX;
+
+        //! The y values of the curve corresponding to mX.
+        std::vector<double> mY;
+    };
+
+    //! Owner of mMacCurve.  The curve is not modified once parsing is complete
+    //! so copies of this control for later vintages share it rather than each
+    //! holding a deep copy.
+    std::shared_ptr<PointSetCurve> mMacCurveOwner;
+
+    //! The compiled mMacCurve, shared along with the curve by copies.
+    std::shared_ptr<const MACPoints> mMacPoints;
+
+    //! The market of mPriceMarketName located in initCalc.
+    std::auto_ptr<CachedMarket> mPriceMarket;
+
     void copy( const MACControl& other );
+    void compileMACCurve();
+    double evaluateMACCurve( const double aX ) const;
     double getMACValue( const double aCarbonPrice ) const;
     double adjustForTechChange( const int aPeriod, double reduction );
 };
@@ -78,6 +78,7 @@ public:
                                const IInfo* aTechIInfo );
 
     virtual void initCalc( const std::string& aRegionName,
+                           const std::vector<IInput*>& aInputs,
                            const IInfo* aTechIInfo,
                            const int aPeriod );
 
@@ -87,6 +88,8 @@ public:
                                 const ICaptureComponent* aSequestrationDevice,
                                 const int aPeriod ) const;
 
+    virtual bool isGHGValueSetByPrices() const;
+
 	virtual void calcEmission( const std::string& aRegionName, 
                                const std::vector<IInput*>& aInputs,
                                const std::vector<IOutput*>& aOutputs,
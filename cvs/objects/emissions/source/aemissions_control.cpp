@@ -45,12 +45,16 @@
 #include "emissions/include/aemissions_control.h"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
+#include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 using namespace std;
 using namespace xercesc;
 
 //! Default constructor.
-AEmissionsControl::AEmissionsControl()
+AEmissionsControl::AEmissionsControl():
+mReductionPeriod( -1 )
 {
     mReduction = 0;
 }
@@ -60,7 +64,9 @@ AEmissionsControl::~AEmissionsControl(){
 }
 
 //! Copy constructor.
-AEmissionsControl::AEmissionsControl( const AEmissionsControl& aOther ){
+AEmissionsControl::AEmissionsControl( const AEmissionsControl& aOther ):
+mReductionPeriod( -1 )
+{
     copy( aOther );
 }
 
@@ -133,8 +139,27 @@ const string& AEmissionsControl::getName() const {
     return mName;
 }
 
+/*!
+ * \brief Get the emissions reduction for the period.
+ * \details When the world is evaluated at reduced accuracy the reduction from
+ *          the first calculation in the period is held rather than calculated
+ *          again.  The period is only noted while the base state is active so
+ *          that the held reduction is always the one in the base state, which
+ *          the scratch states are copied from, and so that the threads
+ *          calculating partial derivatives never write it.
+ * \param aRegionName Region name.
+ * \param aPeriod Model period.
+ * \param aGDP The regional GDP.
+ * \return The fraction by which emissions are reduced.
+ */
 double AEmissionsControl::getEmissionsReduction( const std::string& aRegionName, const int aPeriod, const GDP* aGDP ){
-    calcEmissionsReduction( aRegionName, aPeriod, aGDP );
+    if( mReductionPeriod != aPeriod || scenario->getWorld()->getEvalAccuracy() == World::FULL_ACCURACY ) {
+        calcEmissionsReduction( aRegionName, aPeriod, aGDP );
+        const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+        if( !stateVars || !stateVars->isPartialDeriv() ) {
+            mReductionPeriod = aPeriod;
+        }
+    }
     return mReduction;
 }
 
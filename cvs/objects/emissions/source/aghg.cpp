@@ -158,10 +158,13 @@ void AGHG::completeInit( const string& aRegionName, const string& aSectorName,
 /*!
  * \brief Perform initializations that only need to be done once per period.
  * \param aRegionName Region name.
+ * \param aInputs The inputs of the containing technology.
  * \param aLocalInfo The local information object.
  * \param aPeriod Model period.
  */
-void AGHG::initCalc( const string& aRegionName, const IInfo* aLocalInfo, const int aPeriod ) {
+void AGHG::initCalc( const string& aRegionName, const vector<IInput*>& aInputs,
+                     const IInfo* aLocalInfo, const int aPeriod )
+{
     mCachedMarket = scenario->getMarketplace()->locateMarket( getName(), aRegionName, aPeriod );
 }
 
@@ -273,6 +276,19 @@ void AGHG::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->endVisitGHG( this, aPeriod );
 }
 
+/*!
+ * \brief Whether getGHGValue depends only on the market prices it reads and
+ *        parameters which are constant within a period.
+ * \details Technologies only reuse their cost while the prices it was
+ *          calculated from are unchanged if this is true for all of their
+ *          GHGs.  Subclasses whose value depends on other state which changes
+ *          during the iterations of a period should override this.
+ * \return True.
+ */
+bool AGHG::isGHGValueSetByPrices() const {
+    return true;
+}
+
 /*!
  * \brief Hook for a ghg to do interpolations to fill in any data that
  *        should be interpolated to a newly created ghg for the missing
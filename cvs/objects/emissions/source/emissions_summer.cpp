@@ -42,6 +42,7 @@
 #include "util/base/include/definitions.h"
 #include <cassert>
 #include "emissions/include/emissions_summer.h"
+#include "emissions/include/luc_emissions_summer.h"
 #include "emissions/include/aghg.h"
 #include "technologies/include/technology.h"
 
@@ -101,12 +102,32 @@ void GroupedEmissionsSummer::addEmissionsSummer( EmissionsSummer* aEmissionsSumm
     mEmissionsSummers[ aEmissionsSummer->getGHGName() ] = aEmissionsSummer;
 }
 
+/*!
+ * \brief Add a LUCEmissionsSummer to the group.
+ * \details The given LUCEmissionsSummer will be updated for the same periods as
+ *          the EmissionsSummers.  The memory for the given LUCEmissionsSummer
+ *          will not be managed by this object.
+ * \param aLUCEmissionsSummer The LUCEmissionsSummer to update when this group
+ *        is updated.
+ */
+void GroupedEmissionsSummer::addLUCEmissionsSummer( LUCEmissionsSummer* aLUCEmissionsSummer ) {
+    mLUCEmissionsSummers.push_back( aLUCEmissionsSummer );
+}
+
+/*!
+ * \brief Get the last period to update given the period being visited.
+ * \param aPeriod The period being visited or -1 for all periods.
+ * \return The last period to update.
+ */
+int GroupedEmissionsSummer::getEndPeriod( const int aPeriod ) const {
+    return aPeriod == -1 ? scenario->getModeltime()->getmaxper() - 1 : aPeriod;
+}
+
 void GroupedEmissionsSummer::startVisitGHG( const AGHG* aGHG, const int aPeriod ) {
-    // We are currently assuming all periods should be updated.
-    
     CSummerIterator it = mEmissionsSummers.find( aGHG->getName() );
     if( it != mEmissionsSummers.end() ) {
-        for( int period = 1; period < scenario->getModeltime()->getmaxper(); ++period ) {
+        const int endPeriod = getEndPeriod( aPeriod );
+        for( int period = mStartPeriod; period <= endPeriod; ++period ) {
             if( !mCurrTech || mCurrTech->isOperating(period) ) {
                 (*it).second->startVisitGHG( aGHG, period );
             }
@@ -123,3 +144,16 @@ void GroupedEmissionsSummer::startVisitTechnology( const Technology* aTech,
 void GroupedEmissionsSummer::endVisitTechnology(const Technology* aTech, const int aPeriod ) {
     mCurrTech = 0;
 }
+
+void GroupedEmissionsSummer::startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
+                                                   const int aPeriod )
+{
+    const int endPeriod = getEndPeriod( aPeriod );
+    for( vector<LUCEmissionsSummer*>::const_iterator it = mLUCEmissionsSummers.begin();
+         it != mLUCEmissionsSummers.end(); ++it )
+    {
+        for( int period = mStartPeriod; period <= endPeriod; ++period ) {
+            (*it)->startVisitCarbonCalc( aCarbonCalc, period );
+        }
+    }
+}
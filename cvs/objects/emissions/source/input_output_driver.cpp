@@ -54,11 +54,41 @@
 using namespace std;
 using namespace xercesc;
 
+//! Default constructor.
+InputOutputDriver::InputOutputDriver():
+mInputIndex( -1 )
+{
+}
+
+/*!
+ * \brief Resolve the index of the driving input.
+ * \details The inputs of a technology do not change while it is calculated
+ *          so the input can be found once per period rather than each time
+ *          the driver is calculated.
+ * \param aInputs The inputs which will be passed to calcEmissionsDriver.
+ * \param aPeriod Model period.
+ */
+void InputOutputDriver::initCalc( const vector<IInput*>& aInputs,
+                                  const int aPeriod )
+{
+    mInputIndex = -1;
+    for( size_t i = 0; i < aInputs.size(); ++i ) {
+        if( aInputs[ i ]->getName() == mInputName ) {
+            mInputIndex = static_cast<int>( i );
+            break;
+        }
+    }
+}
+
 double InputOutputDriver::calcEmissionsDriver( const vector<IInput*>& aInputs,
                                                const vector<IOutput*>& aOutputs,
                                                const int aPeriod ) const
 {
-    IInput* inputToDrive = FunctionUtils::getInput( aInputs, mInputName );
+    // Use the input resolved in initCalc if it is still valid for these
+    // inputs, otherwise fall back to searching by name.
+    IInput* inputToDrive = mInputIndex >= 0 && mInputIndex < static_cast<int>( aInputs.size() ) &&
+                           aInputs[ mInputIndex ]->getName() == mInputName ?
+        aInputs[ mInputIndex ] : FunctionUtils::getInput( aInputs, mInputName );
     
     // the input name must exist
     if( !inputToDrive ) {
@@ -54,6 +54,8 @@ LUCEmissionsSummer::LUCEmissionsSummer( const string& aGHGName ):
     mGHGName( aGHGName ),
     mEmissionsByYear( scenario->getModeltime()->getStartYear(), scenario->getModeltime()->getEndYear() )
 {
+    // The carbon calcs are all in the land allocator.
+    skipContent( IVisitor::SUBSECTORS | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
 }
 
 void LUCEmissionsSummer::startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
@@ -41,6 +41,7 @@
 #include "util/base/include/definitions.h"
 
 #include <cmath>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -55,6 +56,7 @@
 #include "util/curves/include/point_set_curve.h"
 #include "util/curves/include/explicit_point_set.h"
 #include "util/curves/include/xy_data_point.h"
+#include "marketplace/include/cached_market.h"
 
 using namespace std;
 using namespace xercesc;
@@ -69,19 +71,20 @@ mTechChange( new objects::PeriodVector<double>( 0.0 ) ),
 mZeroCostPhaseInTime( 25 ),
 mCovertPriceValue( 1 ),
 mPriceMarketName( "CO2" ),
-mMacCurve( new PointSetCurve( new ExplicitPointSet() ) )
+mMacCurve( new PointSetCurve( new ExplicitPointSet() ) ),
+mMacPoints( new MACPoints() )
 {
+    mMacCurveOwner.reset( mMacCurve );
 }
 
 //! Default destructor.
 MACControl::~MACControl(){
-    delete mMacCurve;
+    // mMacCurve is deleted by mMacCurveOwner.
 }
 
 //! Copy constructor.
 MACControl::MACControl( const MACControl& aOther )
 : AEmissionsControl( aOther ) {
-    mMacCurve = 0;
     copy( aOther );
 }
 
@@ -93,10 +96,6 @@ MACControl* MACControl::clone() const {
 //! Assignment operator.
 MACControl& MACControl::operator=( const MACControl& aOther ){
     if( this != &aOther ){
-        // Free memory before copying.  Since this is just a single
-        // variable I am just deleting it directly here.
-        delete mMacCurve;
-        mMacCurve = 0;
         AEmissionsControl::operator=( aOther );
         copy( aOther );
     }
@@ -105,11 +104,11 @@ MACControl& MACControl::operator=( const MACControl& aOther ){
 
 //! Copy helper function.
 void MACControl::copy( const MACControl& aOther ){
-    /*!
-     * \pre mMacCurve should be null otherwise we have a memory leak.
-     */
-    assert( !mMacCurve );
-    mMacCurve = aOther.mMacCurve->clone();
+    // Share the read-in curve and its compiled points.  The curve is cloned
+    // before it is modified by XMLDerivedClassParse if it is still shared.
+    mMacCurveOwner = aOther.mMacCurveOwner;
+    mMacCurve = mMacCurveOwner.get();
+    mMacPoints = aOther.mMacPoints;
     mNoZeroCostReductions = aOther.mNoZeroCostReductions;
     mTechChange = aOther.mTechChange;
     mZeroCostPhaseInTime = aOther.mZeroCostPhaseInTime;
@@ -139,8 +138,13 @@ bool MACControl::XMLDerivedClassParse( const string& aNodeName, const DOMNode* a
     if ( aNodeName == "mac-reduction" ){
         double taxVal = XMLHelper<double>::getAttr( aCurrNode, "tax" );
         double reductionVal = XMLHelper<double>::getValue( aCurrNode );
+        if( mMacCurveOwner.use_count() > 1 ) {
+            mMacCurveOwner.reset( mMacCurve->clone() );
+            mMacCurve = mMacCurveOwner.get();
+        }
         XYDataPoint* currPoint = new XYDataPoint( taxVal, reductionVal );
         mMacCurve->getPointSet()->addPoint( currPoint );
+        mMacPoints.reset( new MACPoints() );
     }
     else if ( aNodeName == "no-zero-cost-reductions" ){
         mNoZeroCostReductions = true;
@@ -199,6 +203,82 @@ void MACControl::initCalc( const string& aRegionName,
                            const NonCO2Emissions* aParentGHG,
                            const int aPeriod )
 {
+    compileMACCurve();
+    mPriceMarket = scenario->getMarketplace()->locateMarket( mPriceMarketName, aRegionName, aPeriod );
+}
+
+/*!
+ * \brief Compile the MAC curve into sorted arrays of x and y values.
+ * \details PointSetCurve::getY searches the unsorted point set linearly several
+ *          times per evaluation.  The sorted arrays let evaluateMACCurve find the
+ *          neighbouring points with a binary search instead.  The y values are
+ *          looked up through the curve so that duplicate x values resolve to the
+ *          same point as they would in PointSetCurve.  The curve is only
+ *          compiled once for all of the copies which share it.
+ */
+void MACControl::compileMACCurve() {
+    if( mMacPoints->mCurve == mMacCurve ) {
+        return;
+    }
+
+    MACPoints* macPoints = new MACPoints();
+    const vector<pair<double,double> > pairs = mMacCurve->getSortedPairs();
+    macPoints->mCurve = mMacCurve;
+    macPoints->mX.resize( pairs.size() );
+    macPoints->mY.resize( pairs.size() );
+    for( size_t i = 0; i < pairs.size(); ++i ) {
+        macPoints->mX[ i ] = pairs[ i ].first;
+        macPoints->mY[ i ] = mMacCurve->getY( pairs[ i ].first );
+    }
+    mMacPoints.reset( macPoints );
+}
+
+/*!
+ * \brief Evaluate the compiled MAC curve.
+ * \details Gives the same result as PointSetCurve::getY, including the linear
+ *          extrapolation from the two nearest points when aX is outside of
+ *          the curve.
+ * \param aX The x value at which to evaluate.
+ * \return The y value, or -DBL_MAX if the curve has no points.
+ */
+double MACControl::evaluateMACCurve( const double aX ) const {
+    const vector<double>& macX = mMacPoints->mX;
+    const vector<double>& macY = mMacPoints->mY;
+    const size_t numPoints = macX.size();
+    if( numPoints == 0 || std::isnan( aX ) ) {
+        return -DBL_MAX;
+    }
+
+    // The first point which is not below aX.
+    size_t above = lower_bound( macX.begin(), macX.end(), aX ) - macX.begin();
+    
+    // First check if the point exists.
+    if( above < numPoints && util::isEqual( aX, macX[ above ] ) ) {
+        return macY[ above ];
+    }
+    if( above > 0 && util::isEqual( aX, macX[ above - 1 ] ) ) {
+        return macY[ above - 1 ];
+    }
+    
+    // Otherwise interpolate, or extrapolate using the nearest segment.
+    size_t below = above - 1;
+    if( above == 0 ) {
+        below = upper_bound( macX.begin(), macX.end(), macX[ above ] ) - macX.begin();
+        if( below == numPoints ) {
+            // There is only one valid point.
+            return macY[ above ];
+        }
+    }
+    else if( above == numPoints ) {
+        above = lower_bound( macX.begin(), macX.end(), macX[ below ] ) - macX.begin();
+        if( above == 0 ) {
+            // There is only one valid point.
+            return macY[ below ];
+        }
+        --above;
+    }
+    return ( aX - macX[ below ] ) * ( macY[ above ] - macY[ below ] ) / ( macX[ above ] - macX[ below ] )
+        + macY[ below ];
 }
 
 void MACControl::calcEmissionsReduction( const std::string& aRegionName, const int aPeriod, const GDP* aGDP ) {
@@ -208,8 +288,9 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
         return;
     }
     
-    const Marketplace* marketplace = scenario->getMarketplace();
-    double emissionsPrice = marketplace->getPrice( mPriceMarketName, aRegionName, aPeriod, false );
+    double emissionsPrice = mPriceMarket.get() && mPriceMarket->isForPeriod( aPeriod ) ?
+        mPriceMarket->getPrice( mPriceMarketName, aRegionName, aPeriod, false ) :
+        scenario->getMarketplace()->getPrice( mPriceMarketName, aRegionName, aPeriod, false );
     if( emissionsPrice == Marketplace::NO_MARKET_PRICE ) {
         emissionsPrice = 0;
     }
@@ -241,7 +322,7 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
     if ( ( reduction > 0.0 ) && ( zeroCostReduction > 0.0 ) &&
         ( modelYear <= ( lastCalYear + mZeroCostPhaseInTime ) ) )
     {
-        const double maxEmissionsTax = mMacCurve->getMaxX();
+        const double maxEmissionsTax = mMacPoints->mX.back();
 
 		// Fraction of zero cost that is removed from original reduction value
 		// Equal to 1 at last calibration year and zero at the zero cost phase in time
@@ -265,16 +346,18 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
  * \param aCarbonPrice carbon price
  */
 double MACControl::getMACValue( const double aCarbonPrice ) const {
-    const double maxCO2Tax = mMacCurve->getMaxX();
+    const vector<double>& macX = mMacPoints->mX;
+    const double maxCO2Tax = macX.empty() ? -DBL_MAX : macX.back();
+    const double minCO2Tax = macX.empty() ? DBL_MAX : macX.front();
     
     // so that getY function won't interpolate beyond last value
     double effectiveCarbonPrice = min( aCarbonPrice, maxCO2Tax );
 
-    double reduction = mMacCurve->getY( effectiveCarbonPrice );
+    double reduction = evaluateMACCurve( effectiveCarbonPrice );
 
     // If no mac curve read in then reduction should be zero.
     // This is a legitimate option for a user to remove a mac curve
-    if ( ( mMacCurve->getMinX() == mMacCurve->getMaxX() ) && ( mMacCurve->getMaxX() == 0 ) ) {
+    if ( ( minCO2Tax == maxCO2Tax ) && ( maxCO2Tax == 0 ) ) {
          reduction = 0;
     }
     // Check to see if some other error has occurred
@@ -239,11 +239,20 @@ void NonCO2Emissions::completeInit( const string& aRegionName, const string& aSe
 /*!
  * \brief Perform initializations that only need to be done once per period.
  * \param aRegionName Region name.
+ * \param aInputs The inputs of the containing technology.
  * \param aLocalInfo The local information object.
  * \param aPeriod Model period.
  */
-void NonCO2Emissions::initCalc( const string& aRegionName, const IInfo* aTechInfo, const int aPeriod ) {
-    AGHG::initCalc( aRegionName, aTechInfo, aPeriod );
+void NonCO2Emissions::initCalc( const string& aRegionName, const vector<IInput*>& aInputs,
+                                const IInfo* aTechInfo, const int aPeriod )
+{
+    AGHG::initCalc( aRegionName, aInputs, aTechInfo, aPeriod );
+
+    // Let the driver resolve the input it reads so that it does not need to
+    // be searched for by name each iteration.
+    if( mEmissionsDriver ) {
+        mEmissionsDriver->initCalc( aInputs, aPeriod );
+    }
     
     // Recalibrate the emissions coefficient if we have input emissions and this is
     // the initial vintage year of the technology.
@@ -272,6 +281,15 @@ void NonCO2Emissions::initCalc( const string& aRegionName, const IInfo* aTechInf
     }
 }
 
+/*!
+ * \brief The GHG value is reduced by the emissions controls which depend on
+ *        GDP and other state besides market prices.
+ * \return True if there are no emissions controls.
+ */
+bool NonCO2Emissions::isGHGValueSetByPrices() const {
+    return mEmissionsControls.empty();
+}
+
 double NonCO2Emissions::getGHGValue( const string& aRegionName,
                                      const vector<IInput*>& aInputs,
                                      const vector<IOutput*>& aOutputs,
@@ -91,6 +91,10 @@ public:
 
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const;
+
+    virtual std::pair<double, double> calcShares( const double* aShareWeights, const double* aValues,
+                                                  const double* aLogShareAdjustments, double* aShares,
+                                                  const size_t aNumOptions, const int aPeriod ) const;
     
     virtual double calcAverageValue( const double aUnnormalizedShareSum,
                                      const double aLogShareFac,
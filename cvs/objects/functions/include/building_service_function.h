@@ -139,8 +139,7 @@ private:
 
     double calcServiceDensity( BuildingServiceInput* aBuildingServiceInput,
                                const double aIncome,
-                               const std::string& aRegionName,
-                               const int aPeriod ) const;
+                               const double aServicePrice ) const;
 };
 
 #endif // _BUILDING_SERVICE_FUNCTION_H_
@@ -54,6 +54,7 @@
 class IFunction;
 class BuildingNodeInput;
 class SatiationDemandFunction;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -324,6 +325,10 @@ protected:
         DEFINE_VARIABLE( CONTAINER, "satiation-demand-function", mSatiationDemandFunction, SatiationDemandFunction* )
     )
     
+    //! A pre-located market which has been cached from the marketplace to get
+    //! the price from and add demand to.
+    std::auto_ptr<CachedMarket> mCachedMarket;
+    
     void copy( const BuildingServiceInput& aInput );
 };
 
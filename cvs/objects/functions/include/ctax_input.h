@@ -50,6 +50,7 @@
 #include <memory>
 
 class Tabs;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -160,6 +161,11 @@ protected:
         //! The C coef associated with mFuelName
         DEFINE_VARIABLE( SIMPLE, "fuel-C-coef", mCachedCCoef, double )
     )
+    
+    //! Pre-located markets for the tax fraction and the carbon price which
+    //! have been cached from the marketplace to get the prices from.
+    std::auto_ptr<CachedMarket> mCachedMarket;
+    std::auto_ptr<CachedMarket> mCachedCO2Market;
 };
 
 #endif // _CTAX_INPUT_H_
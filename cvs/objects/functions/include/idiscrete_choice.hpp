@@ -43,6 +43,7 @@
  * \brief IDiscreteChoice class declaration file
  * \author Robert Link
  */
+#include <utility>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
@@ -128,6 +129,28 @@ public:
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Compute the normalized shares of a set of options at once.
+     * \details The shares are the same as calling calcUnnormalizedShare for each
+     *          option, adding any adjustment, and normalizing the result with
+     *          SectorUtils::normalizeLogShares.  The work is done in simple loops
+     *          over contiguous arrays, without a virtual call per option, so that
+     *          the compiler may vectorize it.
+     * \param aShareWeights The share weight of each option, zero for an option
+     *                      which should receive no share.
+     * \param aValues The value of each option.
+     * \param aLogShareAdjustments A term to add to the log of the unnormalized
+     *                             share of each option or null if there is none.
+     * \param aShares The array in which to return the normalized shares.
+     * \param aNumOptions The number of options.
+     * \param aPeriod The current model period.
+     * \return The sum of the unnormalized shares and the log factor that was
+     *         factored out of it as returned by SectorUtils::normalizeLogShares.
+     */
+    virtual std::pair<double, double> calcShares( const double* aShareWeights, const double* aValues,
+                                                  const double* aLogShareAdjustments, double* aShares,
+                                                  const size_t aNumOptions, const int aPeriod ) const = 0;
+
     /*!
      * \brief Compute the mean value according the the discrete choice function's
      *        parameterization.
@@ -51,6 +51,7 @@
 #include "util/base/include/inamed.h"
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/object_pool.h"
 
 class Tabs;
 class ICaptureComponent;
@@ -83,7 +84,7 @@ class CTaxInput;
  * \details
  * \author Josh Lurz
  */
-class IInput: public INamed, public IVisitable, private boost::noncopyable {
+class IInput: public INamed, public IVisitable, public PooledObject, private boost::noncopyable {
 public:
     /*!
      * \brief Define different type attributes of inputs. These are not mutually
@@ -46,6 +46,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include "functions/include/ifunction.h"
 
 class IInput;
@@ -60,6 +61,48 @@ class IInput;
 class MinicamLeontiefProductionFunction : public IFunction {
 public:
 
+    /*!
+     * \brief The inputs of a technology tagged with their concrete type.
+     * \details Most inputs of MiniCAM technologies are EnergyInputs or
+     *          NonEnergyInputs.  Tagging them once when the technology is
+     *          initialized lets the overloads of calcCosts and calcDemand which
+     *          take a TypedInputs call the methods of those types directly rather
+     *          than through IInput.  Inputs of any other type are still called
+     *          through IInput and the order of the inputs is kept so that results
+     *          are the same as for the InputSet.
+     */
+    class TypedInputs {
+    public:
+        void init( const InputSet& aInputs );
+
+        void clear();
+
+        bool isInitFor( const InputSet& aInputs ) const;
+    private:
+        friend class MinicamLeontiefProductionFunction;
+
+        //! The concrete types of inputs which are handled directly.
+        enum InputType {
+            ENERGY,
+            NON_ENERGY,
+            OTHER
+        };
+
+        //! The inputs in their original order along with their type.
+        std::vector<std::pair<InputType, IInput*> > mInputs;
+    };
+
+    double calcCosts( const TypedInputs& aInputs,
+                      const std::string& aRegionName,
+                      const double aAlphaZero,
+                      int aPeriod ) const;
+
+    double calcDemand( const TypedInputs& aInputs,
+                       double aConsumption,
+                       const std::string& aRegionName,
+                       int aPeriod,
+                       double aAlphaZero ) const;
+
     double calcProfits( InputSet& aInputs,
                         const std::string& aRegionName,
                         const std::string& aSectorName,
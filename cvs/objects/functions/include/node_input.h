@@ -362,11 +362,64 @@ protected:
                            
     //! Hack to avoiding excessive levelized cost calcs to help performance.
     bool mNodePriceSet;
+
+    /*!
+     * \brief The nest below the root flattened so that node prices and demands
+     *        can be calculated by loops rather than recursion.
+     * \details The nodes are stored in the order the recursive calcInputDemand
+     *          visits them, so every node comes before the nodes nested in it.
+     *          The direct children of each node are stored contiguously in
+     *          mChildren.  Prices are calculated bottom up by looping over
+     *          the nodes in reverse and demands top down by looping over them
+     *          forward.  Sigmas and coefficients are read from the nodes at the
+     *          time of the calculation since they are adjusted after initCalc.
+     */
+    struct CompiledNest {
+        //! A nested child input.
+        struct Child {
+            //! The child input.
+            IInput* mInput;
+
+            //! Index into mNodes if the child is a node, -1 for a leaf.
+            int mNodeIndex;
+        };
+
+        //! A node along with the range of its children.
+        struct Node {
+            //! The node input.
+            NodeInput* mNode;
+
+            //! Index of the first child in mChildren.
+            size_t mChildBegin;
+
+            //! One past the index of the last child in mChildren.
+            size_t mChildEnd;
+        };
+
+        //! The nodes, each before the nodes nested within it.
+        std::vector<Node> mNodes;
+
+        //! The direct children of each node.
+        std::vector<Child> mChildren;
+    };
+
+    //! The compiled nest, only built for the root and empty if the nest can not be compiled.
+    CompiledNest mCompiledNest;
                            
     typedef std::vector<INestedInput*>::iterator NestedInputIterator;
     typedef std::vector<INestedInput*>::const_iterator CNestedInputIterator;
     
     void copy( const NodeInput& aNodeInput );
+
+    bool canCompile() const;
+
+    void compileNest( CompiledNest& aNest );
+
+    void calcCompiledLevelizedCost( const std::string& aRegionName, const int aPeriod,
+        const double aAlphaZero );
+
+    double calcCompiledInputDemand( const std::string& aRegionName, const int aPeriod,
+        const double aPhysicalOutput, const double aAlphaZero );
 };
 
 #endif // _NODE_INPUT_H_
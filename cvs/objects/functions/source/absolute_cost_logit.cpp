@@ -50,6 +50,8 @@
 #include "functions/include/absolute_cost_logit.hpp"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
+#include "sectors/include/sector_utils.h"
+#include "util/base/include/fast_math.h"
 
 using namespace std;
 using namespace xercesc;
@@ -183,11 +185,58 @@ double AbsoluteCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
 
     // Zero share weight implies no share which is signaled by negative infinity.
     const double minInf = -std::numeric_limits<double>::infinity();
-    double logShareWeight = aShareWeight > 0.0 ? log( aShareWeight ) : minInf; // log(alpha)
+    double logShareWeight = aShareWeight > 0.0 ?
+        ( FastMath::isEnabled() ? FastMath::log( aShareWeight ) : log( aShareWeight ) ) : minInf; // log(alpha)
     //           v--- log(alpha * exp(beta*p/p0))  ---v
     return logShareWeight + mLogitExponent[ aPeriod ] * aValue / mBaseValue;
 }
 
+namespace {
+    /*!
+     * \brief Calculate the logs of the unnormalized absolute cost logit shares.
+     * \details Zero share weights give a log share of negative infinity as in
+     *          AbsoluteCostLogit::calcUnnormalizedShare.
+     * \tparam Math StdMath or FastMath, which supplies the log.
+     */
+    template<class Math>
+    void calcLogShares( const double* aShareWeights, const double* aValues, double* aShares,
+                        const size_t aNumOptions, const double aLogitExponent, const double aBaseValue )
+    {
+        const double minInf = -std::numeric_limits<double>::infinity();
+        for( size_t i = 0; i < aNumOptions; ++i ) {
+            const double logShareWeight = aShareWeights[ i ] > 0.0 ? Math::log( aShareWeights[ i ] ) : minInf;
+            aShares[ i ] = logShareWeight + aLogitExponent * aValues[ i ] / aBaseValue;
+        }
+    }
+}
+
+std::pair<double, double> AbsoluteCostLogit::calcShares( const double* aShareWeights, const double* aValues,
+                                                         const double* aLogShareAdjustments, double* aShares,
+                                                         const size_t aNumOptions, const int aPeriod ) const
+{
+    /*!
+     * \pre A valid base cost has been set.
+     */
+    assert( mBaseValue > 0 );
+
+    // Zero share weight implies no share which is signaled by negative infinity.
+    const bool useFastMath = FastMath::isEnabled();
+    if( useFastMath ) {
+        calcLogShares<FastMath>( aShareWeights, aValues, aShares, aNumOptions,
+                                 mLogitExponent[ aPeriod ], mBaseValue );
+    }
+    else {
+        calcLogShares<StdMath>( aShareWeights, aValues, aShares, aNumOptions,
+                                mLogitExponent[ aPeriod ], mBaseValue );
+    }
+    if( aLogShareAdjustments ) {
+        for( size_t i = 0; i < aNumOptions; ++i ) {
+            aShares[ i ] += aLogShareAdjustments[ i ];
+        }
+    }
+    return SectorUtils::normalizeLogShares( aShares, aNumOptions, useFastMath );
+}
+
 double AbsoluteCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
                                            const double aLogShareFac,
                                            const int aPeriod ) const
@@ -208,7 +257,9 @@ double AbsoluteCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
         ret = -util::getLargeNumber();
     }
     else {
-        ret = ( aLogShareFac + log( aUnnormalizedShareSum ) )
+        const double logShareSum = FastMath::isEnabled() ? FastMath::log( aUnnormalizedShareSum ) :
+            log( aUnnormalizedShareSum );
+        ret = ( aLogShareFac + logShareSum )
               * ( mBaseValue / mLogitExponent[ aPeriod ] ) + mBaseValue;
     }
 
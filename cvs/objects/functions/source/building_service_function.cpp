@@ -74,9 +74,10 @@ double BuildingServiceFunction::calcCoefficient( InputSet& input, double consump
             BuildingServiceInput* buildingServiceInput = static_cast<BuildingServiceInput*>( *inputIter );
             double thermalLoad = buildingServiceInput->calcThermalLoad( buildingParentInput, internalGainsPerSqMeter, period );
             double servicePerFloorspace = buildingServiceInput->getPhysicalDemand( period ) / floorSpace;
-            double servicePrice = max( buildingServiceInput->getPricePaid( regionName, period ), SectorUtils::getDemandPriceThreshold() );
-            buildingServiceInput->getSatiationDemandFunction()->calibrateSatiationImpedance( servicePerFloorspace, income / servicePrice, period );
-            double serviceDensity = calcServiceDensity( buildingServiceInput, income, regionName, period );
+            const double servicePrice = buildingServiceInput->getPricePaid( regionName, period );
+            buildingServiceInput->getSatiationDemandFunction()->calibrateSatiationImpedance( servicePerFloorspace,
+                income / max( servicePrice, SectorUtils::getDemandPriceThreshold() ), period );
+            double serviceDensity = calcServiceDensity( buildingServiceInput, income, servicePrice );
             coefficient =  servicePerFloorspace / ( serviceDensity * thermalLoad );
         }
         (*inputIter)->setCoefficient( coefficient, period );
@@ -105,7 +106,8 @@ double BuildingServiceFunction::calcDemand( InputSet& input, double consumption,
             // calculations for energy service
             BuildingServiceInput* buildingServiceInput = static_cast<BuildingServiceInput*>( *inputIter );
             double thermalLoad = buildingServiceInput->calcThermalLoad( buildingParentInput, internalGainsPerSqMeter, period );
-            double serviceDensity = calcServiceDensity( buildingServiceInput, income, regionName, period );
+            double serviceDensity = calcServiceDensity( buildingServiceInput, income,
+                buildingServiceInput->getPricePaid( regionName, period ) );
             double adjustedServiceDensity = buildingServiceInput->getCoefficient( period ) * thermalLoad * serviceDensity;
             // Set the thermal load adjusted service density back into the input for reporting.
             buildingServiceInput->setServiceDensity( adjustedServiceDensity, period );
@@ -129,9 +131,10 @@ double BuildingServiceFunction::calcLevelizedCost( const InputSet& aInputs, cons
     for( InputSet::const_iterator inputIter = aInputs.begin(); inputIter != aInputs.end(); ++inputIter ) {
         // calculation for energy services
         BuildingServiceInput* buildingServiceInput = static_cast<BuildingServiceInput*>( *inputIter );
-        double serviceDensity = calcServiceDensity( buildingServiceInput, income, aRegionName, aPeriod );
-        double servicePrice = serviceDensity
-            * buildingServiceInput->getPricePaid( aRegionName, aPeriod );
+        // Look up the price once as it is needed for both the density and the cost.
+        const double price = buildingServiceInput->getPricePaid( aRegionName, aPeriod );
+        double serviceDensity = calcServiceDensity( buildingServiceInput, income, price );
+        double servicePrice = serviceDensity * price;
 
         parentPrice += servicePrice;
     }
@@ -142,23 +145,21 @@ double BuildingServiceFunction::calcLevelizedCost( const InputSet& aInputs, cons
  * \brief Calculate the per square meter service density.
  * \param aBuildingServiceInput The service input for which to calculate the service density.
  * \param aIncome The converted 1975$ subregional income.
- * \param aRegionName The GCAM region name.
- * \param aPeriod The model period.
+ * \param aServicePrice The price paid for the service, which callers have
+ *        already looked up.
  * \return Service density.
  */
 double BuildingServiceFunction::calcServiceDensity( BuildingServiceInput* aBuildingServiceInput,
                                                     const double aIncome,
-                                                    const string& aRegionName,
-                                                    const int aPeriod ) const
+                                                    const double aServicePrice ) const
 {
-    const double servicePrice = aBuildingServiceInput->getPricePaid( aRegionName, aPeriod );
-    const double cappedPrice = max( servicePrice, SectorUtils::getDemandPriceThreshold() );
+    const double cappedPrice = max( aServicePrice, SectorUtils::getDemandPriceThreshold() );
 
     const double serviceAffordability = aIncome / cappedPrice;
     double serviceDensity = aBuildingServiceInput->getSatiationDemandFunction()->calcDemand( serviceAffordability );
     // May need to make an adjustment in case of negative prices.
-    if( servicePrice < cappedPrice ) {
-        serviceDensity = SectorUtils::adjustDemandForNegativePrice( serviceDensity, servicePrice );
+    if( aServicePrice < cappedPrice ) {
+        serviceDensity = SectorUtils::adjustDemandForNegativePrice( serviceDensity, aServicePrice );
     }
     return serviceDensity;
 }
@@ -48,6 +48,7 @@
 #include "functions/include/building_service_input.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/ivisitor.h"
 #include "functions/include/satiation_demand_function.h"
@@ -142,6 +143,8 @@ void BuildingServiceInput::initCalc( const string& aRegionName,
 {
     /*! \pre There must be a valid region name. */
     assert( !aRegionName.empty() );
+    
+    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
 }
 
 void BuildingServiceInput::copyParam( const IInput* aInput,
@@ -240,7 +243,7 @@ void BuildingServiceInput::setPhysicalDemand( double aPhysicalDemand, const stri
         mServiceDemand[ aPeriod ].set( aPhysicalDemand );
     }
     
-    scenario->getMarketplace()->addToDemand( mName, aRegionName,
+    mCachedMarket->addToDemand( mName, aRegionName,
         mServiceDemand[ aPeriod ], aPeriod );
 }
 
@@ -269,7 +272,11 @@ void BuildingServiceInput::setCoefficient( const double aCoefficient, const int
  * \return The market or unadjusted price.
  */
 double BuildingServiceInput::getPrice( const string& aRegionName, const int aPeriod ) const {
-    return scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod );
+    // Use the cached market during the calculation of the current period, other
+    // periods (i.e. reporting) need to go through the marketplace.
+    return mCachedMarket.get() && mCachedMarket->isForPeriod( aPeriod ) ?
+        mCachedMarket->getPrice( mName, aRegionName, aPeriod ) :
+        scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod );
 }
 
 void BuildingServiceInput::setPrice( const string& aRegionName,
@@ -76,20 +76,26 @@ double HouseholdDemandFunction::calcDemand( InputSet& input, double personalInco
     const double pricePaidNumeraire = numInput->getPricePaid( regionName, period );
     assert( pricePaidNumeraire > 0 );
 
+    // The real income is the same for every input.
+    const double realIncome = personalIncome / pricePaidNumeraire;
+
     double totalDemand = 0; // total demand used for scaling
 	for ( unsigned int i = 0; i < input.size(); ++i ) {
         if( !input[ i ]->hasTypeFlag( IInput::FACTOR ) ){
-            assert( input[i]->getPricePaid( regionName, period ) > 0 );
-            assert( input[i]->getCoefficient( period ) > 0 );
-            assert( input[i]->getIncomeElasticity( period ) > 0 );
+            // Look up each input parameter once rather than for each use.
+            const double pricePaid = input[ i ]->getPricePaid( regionName, period );
+            const double coefficient = input[ i ]->getCoefficient( period );
+            const double incomeElasticity = input[ i ]->getIncomeElasticity( period );
+            assert( pricePaid > 0 );
+            assert( coefficient > 0 );
+            assert( incomeElasticity > 0 );
 
-            double demand = input[i]->getCoefficient( period ) * 
-                pow( personalIncome / pricePaidNumeraire, input[i]->getIncomeElasticity( period ) ) *
-				pow( input[i]->getPricePaid( regionName, period ) / pricePaidNumeraire, input[i]->getPriceElasticity( period ) );
+            double demand = coefficient * pow( realIncome, incomeElasticity ) *
+				pow( pricePaid / pricePaidNumeraire, input[i]->getPriceElasticity( period ) );
 
             assert( util::isValidNumber( demand ) );
 			input[i]->setPhysicalDemand( demand, regionName, period );
-			totalDemand += demand * input[i]->getPricePaid( regionName, period );
+			totalDemand += demand * pricePaid;
 		}
 	}
 	return totalDemand;
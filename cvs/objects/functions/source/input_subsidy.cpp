@@ -47,6 +47,7 @@
 #include "functions/include/input_subsidy.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "technologies/include/icapture_component.h"
 #include "functions/include/icoefficient.h"
@@ -208,6 +209,8 @@ void InputSubsidy::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+    
+    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
 }
 
 void InputSubsidy::copyParam( const IInput* aInput,
@@ -260,7 +263,7 @@ void InputSubsidy::setPhysicalDemand( double aPhysicalDemand,
     // This is so solver can use the excess demand to determine
     // whether to increase or decrease a subsidy. 
     // Each technology share is additive.
-    marketplace->addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+    mCachedMarket->addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
@@ -285,7 +288,11 @@ double InputSubsidy::getPrice( const string& aRegionName,
     // Return negative of price to reflect subsidy for portfolio
     // standard market.
     // A high subsidy increases supply.
-    return - scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    // Use the cached market during the calculation of the current period, other
+    // periods (i.e. reporting) need to go through the marketplace.
+    return - ( mCachedMarket.get() && mCachedMarket->isForPeriod( aPeriod ) ?
+        mCachedMarket->getPrice( mName, aRegionName, aPeriod, true ) :
+        scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true ) );
 }
 
 void InputSubsidy::setPrice( const string& aRegionName,
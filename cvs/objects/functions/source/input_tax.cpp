@@ -47,6 +47,7 @@
 #include "functions/include/input_tax.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "technologies/include/icapture_component.h"
 #include "functions/include/icoefficient.h"
@@ -208,6 +209,8 @@ void InputTax::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+    
+    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
 }
 
 void InputTax::copyParam( const IInput* aInput,
@@ -257,7 +260,7 @@ void InputTax::setPhysicalDemand( double aPhysicalDemand,
     // mPhysicalDemand can be a share if tax is share based.
     mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
     // Each technology share is additive.
-    marketplace->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+    mCachedMarket->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
@@ -280,7 +283,11 @@ double InputTax::getPrice( const string& aRegionName,
                               const int aPeriod ) const
 {
     // A high tax decreases demand.
-    return scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    // Use the cached market during the calculation of the current period, other
+    // periods (i.e. reporting) need to go through the marketplace.
+    return ( mCachedMarket.get() && mCachedMarket->isForPeriod( aPeriod ) ?
+        mCachedMarket->getPrice( mName, aRegionName, aPeriod, true ) :
+        scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true ) );
 }
 
 void InputTax::setPrice( const string& aRegionName,
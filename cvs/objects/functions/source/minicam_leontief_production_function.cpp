@@ -43,9 +43,12 @@
 #include <vector>
 #include <cmath>
 #include <cassert>
+#include <typeinfo>
 
 #include "functions/include/minicam_leontief_production_function.h"
 #include "functions/include/iinput.h"
+#include "functions/include/energy_input.h"
+#include "functions/include/non_energy_input.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/util.h"
@@ -69,6 +72,46 @@ double MinicamLeontiefProductionFunction::calcCosts( const InputSet& aInputs,
     return totalCost / aAlphaZero;
 }
 
+/*!
+ * \brief Calculate the costs of a set of typed inputs.
+ * \details This is the same as calcCosts for an InputSet but calls
+ *          EnergyInputs and NonEnergyInputs directly.
+ * \param aInputs The typed inputs.
+ * \param aRegionName The region name.
+ * \param aAlphaZero Hicks neutral technical change.
+ * \param aPeriod The model period.
+ * \return The total cost.
+ */
+double MinicamLeontiefProductionFunction::calcCosts( const TypedInputs& aInputs,
+                                                     const string& aRegionName,
+                                                     const double aAlphaZero,
+                                                     int aPeriod ) const
+{
+    double totalCost = 0;
+    typedef vector<pair<TypedInputs::InputType, IInput*> >::const_iterator CTypedInputIterator;
+    for( CTypedInputIterator input = aInputs.mInputs.begin(); input != aInputs.mInputs.end(); ++input ) {
+        switch( ( *input ).first ) {
+            case TypedInputs::ENERGY: {
+                const EnergyInput* energyInput = static_cast<const EnergyInput*>( ( *input ).second );
+                totalCost += energyInput->EnergyInput::getCoefficient( aPeriod )
+                             * energyInput->EnergyInput::getPrice( aRegionName, aPeriod );
+                break;
+            }
+            case TypedInputs::NON_ENERGY: {
+                const NonEnergyInput* nonEnergyInput = static_cast<const NonEnergyInput*>( ( *input ).second );
+                totalCost += nonEnergyInput->NonEnergyInput::getCoefficient( aPeriod )
+                             * nonEnergyInput->NonEnergyInput::getPrice( aRegionName, aPeriod );
+                break;
+            }
+            default:
+                totalCost += ( *input ).second->getCoefficient( aPeriod )
+                             * ( *input ).second->getPrice( aRegionName, aPeriod );
+                break;
+        }
+    }
+    return totalCost / aAlphaZero;
+}
+
 double MinicamLeontiefProductionFunction::calcProfits( InputSet& aInputs,
                                                        const string& aRegionName,
                                                        const string& aSectorName,
@@ -138,6 +181,50 @@ double MinicamLeontiefProductionFunction::calcDemand( InputSet& aInputs,
     return totalDemand;
 }
 
+/*!
+ * \brief Calculate and set the demands of a set of typed inputs.
+ * \details This is the same as calcDemand for an InputSet but calls
+ *          EnergyInputs and NonEnergyInputs directly.
+ * \param aInputs The typed inputs.
+ * \param aConsumption The output of the technology.
+ * \param aRegionName The region name.
+ * \param aPeriod The model period.
+ * \param aAlphaZero Hicks neutral technical change.
+ * \return The total demand.
+ */
+double MinicamLeontiefProductionFunction::calcDemand( const TypedInputs& aInputs,
+                                                      double aConsumption,
+                                                      const string& aRegionName,
+                                                      int aPeriod,
+                                                      double aAlphaZero ) const
+{
+    assert( aAlphaZero >= 1 );
+    double totalDemand = 0;
+    typedef vector<pair<TypedInputs::InputType, IInput*> >::const_iterator CTypedInputIterator;
+    for( CTypedInputIterator input = aInputs.mInputs.begin(); input != aInputs.mInputs.end(); ++input ) {
+        double inputDemand;
+        switch( ( *input ).first ) {
+            case TypedInputs::ENERGY: {
+                EnergyInput* energyInput = static_cast<EnergyInput*>( ( *input ).second );
+                inputDemand = energyInput->EnergyInput::getCoefficient( aPeriod ) * aConsumption / aAlphaZero;
+                energyInput->EnergyInput::setPhysicalDemand( inputDemand, aRegionName, aPeriod );
+                break;
+            }
+            case TypedInputs::NON_ENERGY:
+                // Non-energy inputs do not have a physical demand to set.
+                inputDemand = static_cast<NonEnergyInput*>( ( *input ).second )->NonEnergyInput::getCoefficient( aPeriod )
+                              * aConsumption / aAlphaZero;
+                break;
+            default:
+                inputDemand = ( *input ).second->getCoefficient( aPeriod ) * aConsumption / aAlphaZero;
+                ( *input ).second->setPhysicalDemand( inputDemand, aRegionName, aPeriod );
+                break;
+        }
+        totalDemand += inputDemand;
+    }
+    return totalDemand;
+}
+
 double MinicamLeontiefProductionFunction::calcExpProfitRate( const InputSet& aInputs,
                                                              const string& aRegionName,
                                                              const string& aSectorName,
@@ -218,3 +305,47 @@ double MinicamLeontiefProductionFunction::calcUnscaledProfits( const InputSet& a
     return scenario->getMarketplace()->getPrice( aSectorName, aRegionName, aPeriod )
            - calcLevelizedCost( aInputs, aRegionName, aSectorName, aPeriod, aAlphaZero, aSigma );
 }
+
+/*!
+ * \brief Tag the given inputs with their concrete types.
+ * \param aInputs The inputs of the technology.
+ */
+void MinicamLeontiefProductionFunction::TypedInputs::init( const InputSet& aInputs ) {
+    mInputs.clear();
+    mInputs.reserve( aInputs.size() );
+    for( CInputSetIterator input = aInputs.begin(); input != aInputs.end(); ++input ) {
+        // Only exact types may be called directly, a subclass could override
+        // the methods used.
+        InputType type = OTHER;
+        if( typeid( **input ) == typeid( EnergyInput ) ) {
+            type = ENERGY;
+        }
+        else if( typeid( **input ) == typeid( NonEnergyInput ) ) {
+            type = NON_ENERGY;
+        }
+        mInputs.push_back( make_pair( type, *input ) );
+    }
+}
+
+//! Remove all inputs.
+void MinicamLeontiefProductionFunction::TypedInputs::clear() {
+    mInputs.clear();
+}
+
+/*!
+ * \brief Whether these were initialized from the given inputs and so may be
+ *        used in their place.
+ * \param aInputs The inputs of the technology.
+ * \return True if the typed inputs are the same as aInputs.
+ */
+bool MinicamLeontiefProductionFunction::TypedInputs::isInitFor( const InputSet& aInputs ) const {
+    if( mInputs.size() != aInputs.size() || mInputs.empty() ) {
+        return false;
+    }
+    for( size_t i = 0; i < mInputs.size(); ++i ) {
+        if( mInputs[ i ].second != aInputs[ i ] ) {
+            return false;
+        }
+    }
+    return true;
+}
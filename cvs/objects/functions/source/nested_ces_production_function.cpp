@@ -53,6 +53,7 @@
 #include "util/base/include/model_time.h"
 #include "functions/include/function_utils.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/fast_math.h"
 
 using namespace std;
 
@@ -237,8 +238,8 @@ double NestedCESProductionFunction::calcIORatio( const InputSet::value_type aInp
     // TODO: price paid should be > 0 put the assert back in
     double pricePaid = aInput->getPricePaid( aRegionName, aPeriod );
     //assert( pricePaid >= 0 );
-    double ret = pow( aAlphaZero * aInput->getCoefficient( aPeriod ), aSigma - 1 ) * 
-        pow( aParentPrice / pricePaid, aSigma );
+    double ret = pow1( aAlphaZero * aInput->getCoefficient( aPeriod ), aSigma - 1 ) * 
+        pow1( aParentPrice / pricePaid, aSigma );
     return pricePaid != 0 ? ret : 0;
 }
 
@@ -248,10 +249,14 @@ double NestedCESProductionFunction::calcIORatio( const InputSet::value_type aInp
  *           we end up trying to raise somthing to the power of 1 of which the result
  *           will of course be the same value.  In order to avoid the time costly call
  *           to pow we will just check for the exponent of 1 explicitly before hand.
+ *           The pow is taken from FastMath if it has been enabled.
  * \param base A value to be raised to a power.
  * \param exp The power to raise by.
  * \return base ^ exp.
  */
 inline double NestedCESProductionFunction::pow1( double base, double exp ) const {
-    return exp != 1 ? pow( base, exp ) : base;
+    if( exp == 1 ) {
+        return base;
+    }
+    return FastMath::isEnabled() ? FastMath::pow( base, exp ) : pow( base, exp );
 }
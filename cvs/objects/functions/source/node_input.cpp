@@ -42,6 +42,8 @@
 #include "util/base/include/definitions.h"
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
+#include <cmath>
+#include <typeinfo>
 
 #include "functions/include/node_input.h"
 #include "functions/include/ifunction.h"
@@ -49,6 +51,8 @@
 #include "functions/include/demand_input.h"
 #include "functions/include/trade_input.h"
 #include "functions/include/building_node_input.h"
+#include "functions/include/sgm_input.h"
+#include "functions/include/nested_ces_production_function.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/xml_helper.h"
 #include "functions/include/function_utils.h"
@@ -59,6 +63,7 @@
 // create the utility demand fn markets
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/fast_math.h"
 
 using namespace std;
 using namespace xercesc;
@@ -219,6 +224,65 @@ void NodeInput::initCalc( const string& aRegionName,
     }
     // initialized the hack
     mNodePriceSet = false;
+
+    // Only the root is asked to calculate the nest so it is the only node
+    // which needs to be compiled.
+    mCompiledNest.mNodes.clear();
+    mCompiledNest.mChildren.clear();
+    const static bool compileNests = Configuration::getInstance()->getBool( "compile-nested-inputs", true, false );
+    if( compileNests && mName == "root" && canCompile() ) {
+        compileNest( mCompiledNest );
+    }
+}
+
+/*!
+ * \brief Determine if the nest below this node can be compiled.
+ * \details The compiled calculations are a copy of those in the
+ *          NestedCESProductionFunction so they can only be used if every node
+ *          in the nest is a NodeInput with that function and every leaf is an
+ *          SGMInput which does no calculations of its own.
+ * \return Whether the nest can be compiled.
+ */
+bool NodeInput::canCompile() const {
+    if( typeid( *this ) != typeid( NodeInput ) ||
+        !dynamic_cast<const NestedCESProductionFunction*>( mProdDmdFn ) )
+    {
+        return false;
+    }
+    for( CNestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
+        if( typeid( **it ) == typeid( NodeInput ) ) {
+            if( !static_cast<const NodeInput*>( *it )->canCompile() ) {
+                return false;
+            }
+        }
+        else if( !dynamic_cast<const SGMInput*>( *it ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Append this node and the nest below it to a compiled nest.
+ * \details The node is added before recursing so that each node comes before
+ *          the nodes nested within it, and all of its children are added
+ *          before any grandchildren so that they are contiguous.
+ * \param aNest The compiled nest to add to.
+ */
+void NodeInput::compileNest( CompiledNest& aNest ) {
+    CompiledNest::Node node = { this, aNest.mChildren.size(),
+                                aNest.mChildren.size() + mNestedInputs.size() };
+    aNest.mNodes.push_back( node );
+    for( NestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
+        CompiledNest::Child child = { *it, -1 };
+        aNest.mChildren.push_back( child );
+    }
+    for( size_t i = 0; i < mNestedInputs.size(); ++i ) {
+        if( typeid( *mNestedInputs[ i ] ) == typeid( NodeInput ) ) {
+            aNest.mChildren[ node.mChildBegin + i ].mNodeIndex = static_cast<int>( aNest.mNodes.size() );
+            static_cast<NodeInput*>( mNestedInputs[ i ] )->compileNest( aNest );
+        }
+    }
 }
 
 void NodeInput::copyParam( const IInput* aInput,
@@ -489,6 +553,11 @@ void NodeInput::calcLevelizedCost( const std::string& aRegionName, const std::st
     if( mNodePriceSet ) {
         return;
     }
+    if( !mCompiledNest.mNodes.empty() ) {
+        calcCompiledLevelizedCost( aRegionName, aPeriod, aAlphaZero );
+        mNodePriceSet = true;
+        return;
+    }
     // have children calculate their levelized costs first
     // the leaves are assumed to already have calculated their appropriate price paid
     for( NestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
@@ -559,6 +628,9 @@ double NodeInput::calcInputDemand( const std::string& aRegionName, const std::st
         const int aPeriod, const double aPhysicalOutput, const double aUtilityParameterA,
         const double aAlphaZero )
 {
+    if( !mCompiledNest.mNodes.empty() ) {
+        return calcCompiledInputDemand( aRegionName, aPeriod, aPhysicalOutput, aAlphaZero );
+    }
     // first calculate the demands for the direct children
     double retDemand = mProdDmdFn->calcDemand( mChildInputsCache, aPhysicalOutput, aRegionName, aSectorName, 1,
         aPeriod, aUtilityParameterA, aAlphaZero, mCurrentSigma, mPricePaid );
@@ -574,6 +646,115 @@ double NodeInput::calcInputDemand( const std::string& aRegionName, const std::st
     return retDemand;
 }
 
+namespace {
+    /*!
+     * \brief The same pow as NestedCESProductionFunction::pow1 so that the compiled
+     *        nest gives identical results.
+     * \param aBase A value to be raised to a power.
+     * \param aExponent The power to raise by.
+     * \return aBase ^ aExponent.
+     */
+    inline double cesPow( const double aBase, const double aExponent ) {
+        if( aExponent == 1 ) {
+            return aBase;
+        }
+        return FastMath::isEnabled() ? FastMath::pow( aBase, aExponent ) : pow( aBase, aExponent );
+    }
+}
+
+/*!
+ * \brief Calculate the price of every node in the compiled nest.
+ * \details Performs the same calculation as calcLevelizedCost does recursively
+ *          through NestedCESProductionFunction::calcLevelizedCost, with the
+ *          sums taken in the same order so that the results are identical.
+ * \param aRegionName The region name.
+ * \param aPeriod The model period.
+ * \param aAlphaZero The root's alpha.
+ */
+void NodeInput::calcCompiledLevelizedCost( const string& aRegionName, const int aPeriod,
+                                           const double aAlphaZero )
+{
+    for( size_t nodeIndex = mCompiledNest.mNodes.size(); nodeIndex-- > 0; ) {
+        const CompiledNest::Node& node = mCompiledNest.mNodes[ nodeIndex ];
+        const double r = 1 - node.mNode->mCurrentSigma;
+        double sum = 0.0;
+        for( size_t i = node.mChildBegin; i < node.mChildEnd; ++i ) {
+            const CompiledNest::Child& child = mCompiledNest.mChildren[ i ];
+            double price;
+            double coef;
+            if( child.mNodeIndex != -1 ) {
+                // the child node's price was calculated earlier in this loop
+                const NodeInput* childNode = mCompiledNest.mNodes[ child.mNodeIndex ].mNode;
+                price = childNode->mPricePaid;
+                coef = childNode->mAlphaCoef;
+            }
+            else {
+                price = child.mInput->getPricePaid( aRegionName, aPeriod );
+                coef = child.mInput->getCoefficient( aPeriod );
+            }
+            sum += cesPow( price / coef, r );
+        }
+        const double nodePrice = cesPow( sum, 1 / r ) / aAlphaZero;
+        node.mNode->mPricePaid = nodePrice;
+        if( aPeriod == 0 ) {
+            node.mNode->mBasePricePaid = nodePrice;
+        }
+    }
+}
+
+/*!
+ * \brief Calculate the demand for every input in the compiled nest.
+ * \details Performs the same calculation as calcInputDemand does recursively
+ *          through NestedCESProductionFunction::calcDemand, setting demands in
+ *          the same order.
+ * \param aRegionName The region name.
+ * \param aPeriod The model period.
+ * \param aPhysicalOutput The output of the root.
+ * \param aAlphaZero The root's alpha.
+ * \return The sum of the demands for the root's direct children.
+ */
+double NodeInput::calcCompiledInputDemand( const string& aRegionName, const int aPeriod,
+                                           const double aPhysicalOutput, const double aAlphaZero )
+{
+    double retDemand = 0.0;
+    for( size_t nodeIndex = 0; nodeIndex < mCompiledNest.mNodes.size(); ++nodeIndex ) {
+        const CompiledNest::Node& node = mCompiledNest.mNodes[ nodeIndex ];
+        // the demand for a nested node was set by its parent earlier in this loop
+        const double output = nodeIndex == 0 ? aPhysicalOutput : double( node.mNode->mNodeCurrencyDemand );
+        const double sigma = node.mNode->mCurrentSigma;
+        const double nodePrice = node.mNode->mPricePaid;
+        double totalDemand = 0.0;
+        for( size_t i = node.mChildBegin; i < node.mChildEnd; ++i ) {
+            const CompiledNest::Child& child = mCompiledNest.mChildren[ i ];
+            NodeInput* childNode = child.mNodeIndex != -1 ?
+                mCompiledNest.mNodes[ child.mNodeIndex ].mNode : 0;
+            const double coef = childNode ? double( childNode->mAlphaCoef ) : child.mInput->getCoefficient( aPeriod );
+            double ioRatio;
+            if( sigma == 0 ) {
+                ioRatio = 1 / coef;
+            }
+            else {
+                const double pricePaid = childNode ? double( childNode->mPricePaid ) :
+                    child.mInput->getPricePaid( aRegionName, aPeriod );
+                ioRatio = pricePaid != 0 ?
+                    cesPow( aAlphaZero * coef, sigma - 1 ) * cesPow( nodePrice / pricePaid, sigma ) : 0;
+            }
+            const double demand = ioRatio * output;
+            if( childNode ) {
+                childNode->mNodeCurrencyDemand.set( demand );
+            }
+            else {
+                child.mInput->setPhysicalDemand( demand, aRegionName, aPeriod );
+            }
+            totalDemand += demand;
+        }
+        if( nodeIndex == 0 ) {
+            retDemand = totalDemand;
+        }
+    }
+    return retDemand;
+}
+
 double NodeInput::calcCapitalOutputRatio( const std::string& aRegionName, const std::string& aSectorName,
         const int aPeriod, const double aAlphaZero ) {
     /*
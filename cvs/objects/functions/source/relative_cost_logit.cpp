@@ -48,6 +48,8 @@
 #include "functions/include/relative_cost_logit.hpp"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
+#include "sectors/include/sector_utils.h"
+#include "util/base/include/fast_math.h"
 
 using namespace std;
 using namespace xercesc;
@@ -175,14 +177,60 @@ double RelativeCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
 {
     // Zero share weight implies no share which is signaled by negative infinity.
     const double minInf = -std::numeric_limits<double>::infinity();
-    double logShareWeight = aShareWeight > 0.0 ? log( aShareWeight ) : minInf;
+    const bool useFastMath = FastMath::isEnabled();
+    double logShareWeight = aShareWeight > 0.0 ?
+        ( useFastMath ? FastMath::log( aShareWeight ) : log( aShareWeight ) ) : minInf;
 
     // Negative values are not allowed so they are instead capped at getMinValueThreshold()
     double cappedValue = std::max( aValue, getMinValueThreshold() );
     
-    return logShareWeight + mLogitExponent[ aPeriod ] * log( cappedValue );
-    // This log is the difference between the relative value    --^
+    // This log is the difference between the relative value
     // logit and the absolute value logit.
+    const double logValue = useFastMath ? FastMath::log( cappedValue ) : log( cappedValue );
+    
+    return logShareWeight + mLogitExponent[ aPeriod ] * logValue;
+}
+
+namespace {
+    /*!
+     * \brief Calculate the logs of the unnormalized relative value logit shares.
+     * \details See RelativeCostLogit::calcUnnormalizedShare for the treatment of
+     *          zero share weights and negative values.
+     * \tparam Math StdMath or FastMath, which supplies the log.
+     */
+    template<class Math>
+    void calcLogShares( const double* aShareWeights, const double* aValues, double* aShares,
+                        const size_t aNumOptions, const double aLogitExponent, const double aMinValue )
+    {
+        const double minInf = -std::numeric_limits<double>::infinity();
+        for( size_t i = 0; i < aNumOptions; ++i ) {
+            const double logShareWeight = aShareWeights[ i ] > 0.0 ? Math::log( aShareWeights[ i ] ) : minInf;
+            aShares[ i ] = logShareWeight + aLogitExponent * Math::log( std::max( aValues[ i ], aMinValue ) );
+        }
+    }
+}
+
+std::pair<double, double> RelativeCostLogit::calcShares( const double* aShareWeights, const double* aValues,
+                                                         const double* aLogShareAdjustments, double* aShares,
+                                                         const size_t aNumOptions, const int aPeriod ) const
+{
+    // See calcUnnormalizedShare for the treatment of zero share weights and
+    // negative values.
+    const bool useFastMath = FastMath::isEnabled();
+    if( useFastMath ) {
+        calcLogShares<FastMath>( aShareWeights, aValues, aShares, aNumOptions,
+                                 mLogitExponent[ aPeriod ], getMinValueThreshold() );
+    }
+    else {
+        calcLogShares<StdMath>( aShareWeights, aValues, aShares, aNumOptions,
+                                mLogitExponent[ aPeriod ], getMinValueThreshold() );
+    }
+    if( aLogShareAdjustments ) {
+        for( size_t i = 0; i < aNumOptions; ++i ) {
+            aShares[ i ] += aLogShareAdjustments[ i ];
+        }
+    }
+    return SectorUtils::normalizeLogShares( aShares, aNumOptions, useFastMath );
 }
 
 double RelativeCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
@@ -205,8 +253,14 @@ double RelativeCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
         ret = -util::getLargeNumber();
     }
     else {
-        ret = exp( aLogShareFac / mLogitExponent[ aPeriod ] )
-              * pow( aUnnormalizedShareSum, 1.0 / mLogitExponent[ aPeriod ] );
+        if( FastMath::isEnabled() ) {
+            ret = FastMath::exp( aLogShareFac / mLogitExponent[ aPeriod ] )
+                  * FastMath::pow( aUnnormalizedShareSum, 1.0 / mLogitExponent[ aPeriod ] );
+        }
+        else {
+            ret = exp( aLogShareFac / mLogitExponent[ aPeriod ] )
+                  * pow( aUnnormalizedShareSum, 1.0 / mLogitExponent[ aPeriod ] );
+        }
     }
 
     return ret;
@@ -85,23 +85,26 @@ double UtilityDemandFunction::calcDemand( InputSet& input, double personalIncome
     for( InputSet::iterator it = input.begin(); it != input.end(); ++it ) {
         // TODO: income elasticity is really alpha, price elasticity is really beta,
         //       and getCoefficient is really gamma
-        assert( (*it)->getPricePaid( regionName, period ) > 0 );
+        // Look up each input parameter once rather than for each use, the share
+        // in particular is used for both the demand and the utility.
+        const double pricePaid = (*it)->getPricePaid( regionName, period );
+        const double coefficient = (*it)->getCoefficient( period );
+        assert( pricePaid > 0 );
         assert( (*it)->getPriceElasticity( period ) >= 0 );
         assert( (*it)->getIncomeElasticity( period ) >= 0 );
+        const double inputPhi = phi( (*it), trialUtility );
         
-        double demand = (*it)->getCoefficient( period ) + ( 1 / (*it)->getPricePaid( regionName, period ) )
-            * phi( (*it), trialUtility ) * availablePersonalIncome;
+        double demand = coefficient + ( 1 / pricePaid ) * inputPhi * availablePersonalIncome;
         assert( util::isValidNumber( demand ) );
         (*it)->setPhysicalDemand( demand, regionName, period );
         
         double inputUtility = 0;
-        if ( demand - (*it)->getCoefficient( period ) > 0 ) {
-            // TODO: consider storing this somewhere
-            inputUtility = phi( (*it), trialUtility ) * log( ( demand - (*it)->getCoefficient( period ) )
+        if ( demand - coefficient > 0 ) {
+            inputUtility = inputPhi * log( ( demand - coefficient )
                 / ( A * /*exp(*/ trialUtility /*)*/ ) ); // the solver is working in e^u see the g function
         }
             
-        totalDemand += demand * (*it)->getPricePaid( regionName, period );
+        totalDemand += demand * pricePaid;
         totalUtility += inputUtility;
     }
     
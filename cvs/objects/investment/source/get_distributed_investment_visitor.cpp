@@ -58,6 +58,8 @@ extern Scenario* scenario;
 GetDistributedInvestmentVisitor::GetDistributedInvestmentVisitor( const string& aRegionName )
 :mCurrentRegionName( aRegionName )
 {
+    // Investment is distributed to the subsectors and their base technologies.
+    skipContent( IVisitor::TECHNOLOGY_CONTENTS | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
 }
 
 void GetDistributedInvestmentVisitor::startVisitSector( const Sector* aSector,
@@ -66,6 +66,8 @@ mSubSectorCount( 0 ),
 mTechCount( 0 ),
 mMultipleSubsectors( aInvestableCount > 1 )
 {
+    // Only subsectors and their base technologies are counted.
+    skipContent( IVisitor::TECHNOLOGY_CONTENTS | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
 }
 
 void InvestableCounterVisitor::startVisitSubsector( const Subsector* aSubsector,
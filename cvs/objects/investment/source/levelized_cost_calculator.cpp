@@ -104,6 +104,9 @@ double LevelizedCostCalculator::calcSectorExpectedProfitRate( const vector<IInve
     // TODO: shouldn't there be a way to calculate shares other that rate logit?
     double levelizedCostDenom = 0;
     vector<double> levelizedCosts( aInvestables.size(), 0 );
+    // Store the share weighted logit term for each investable so the shares
+    // below do not need to recompute it.
+    vector<double> logitTerms( aInvestables.size(), 0 );
     int levelizedCostPos = 0;
     
     // beta is equivalent to the share weight of the investable
@@ -121,8 +124,9 @@ double LevelizedCostCalculator::calcSectorExpectedProfitRate( const vector<IInve
                                                                       aPeriod );
         if( currLevelizedCost > 0 ){
             levelizedCosts[ levelizedCostPos ] = currLevelizedCost;
-            levelizedCostDenom += (*currInv)->getShareWeight( aPeriod ) *
+            logitTerms[ levelizedCostPos ] = (*currInv)->getShareWeight( aPeriod ) *
                 pow( currLevelizedCost, aInvestmentLogitExp );
+            levelizedCostDenom += logitTerms[ levelizedCostPos ];
         }
         ++levelizedCostPos;
     }
@@ -133,19 +137,14 @@ double LevelizedCostCalculator::calcSectorExpectedProfitRate( const vector<IInve
         return levelizedCostDenom;
     }
 
-    levelizedCostPos = 0;
     double sectorLevelizedCost = 0;
-    for( InvestmentUtils::CInvestableIterator currInv = aInvestables.begin();
-        currInv != aInvestables.end(); ++currInv )
-    {
-        double currLevelizedCost = levelizedCosts[ levelizedCostPos ];
+    for( unsigned int i = 0; i < levelizedCosts.size(); ++i ) {
+        double currLevelizedCost = levelizedCosts[ i ];
         if( currLevelizedCost > 0 ){
             // maybe put this share calc in a utility
-            double share = (*currInv)->getShareWeight( aPeriod ) *
-                    pow( currLevelizedCost, aInvestmentLogitExp ) / levelizedCostDenom;
+            double share = logitTerms[ i ] / levelizedCostDenom;
             sectorLevelizedCost += share * currLevelizedCost;
         }
-        ++levelizedCostPos;
     }
 
     return sectorLevelizedCost;
@@ -58,6 +58,8 @@ extern Scenario* scenario;
 SetShareWeightVisitor::SetShareWeightVisitor( const string& aRegionName )
 :mCurrentRegionName( aRegionName )
 {
+    // Investment is distributed to the subsectors and their base technologies.
+    skipContent( IVisitor::TECHNOLOGY_CONTENTS | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
 }
 
 void SetShareWeightVisitor::startVisitSector( const Sector* aSector,
@@ -0,0 +1,256 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+
+import java.io.BufferedInputStream;
+import java.io.BufferedOutputStream;
+import java.io.DataInputStream;
+import java.io.DataOutputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.net.InetAddress;
+import java.net.ServerSocket;
+import java.net.Socket;
+import java.util.concurrent.locks.ReentrantLock;
+
+/**
+ * A stand alone process which writes GCAM output to the XML database on
+ * behalf of GCAM processes that connect to it.  GCAM then does not need to
+ * start a JVM itself, and several GCAM processes on a node may share one
+ * writer.  GCAM uses this writer when the xmldb-writer-port configuration
+ * value is set to the port given here.
+ *
+ * Each connection is handled on its own thread.  The document is collected
+ * into a temporary file as it arrives so that every GCAM process can send
+ * its results at the same time.  The documents are then passed to an
+ * XMLDBDriver one at a time since only one may have the database open.
+ * See XMLDBWriterClient in GCAM for the message format.
+ *
+ * Usage: java -cp XMLDBDriver.jar:[jars] XMLDBWriterServer [port]
+ */
+public class XMLDBWriterServer {
+    /**
+     * The default port to listen on.
+     */
+    public static final int DEFAULT_PORT = 7750;
+
+    /**
+     * Only one XMLDBDriver may have the database open at a time.  It is held
+     * from when a document is written until the connection closes the database.
+     */
+    private static final ReentrantLock mDBLock = new ReentrantLock();
+
+    /**
+     * Handles all of the messages from one GCAM process.
+     */
+    private static class Connection implements Runnable {
+        private final Socket mSocket;
+
+        private String mDBLocation = null;
+
+        private String mDocName = null;
+
+        private File mSpoolFile = null;
+
+        private OutputStream mSpool = null;
+
+        private XMLDBDriver mDriver = null;
+
+        public Connection( final Socket aSocket ) {
+            mSocket = aSocket;
+        }
+
+        public void run() {
+            try {
+                DataInputStream in = new DataInputStream( new BufferedInputStream( mSocket.getInputStream() ) );
+                DataOutputStream out = new DataOutputStream( mSocket.getOutputStream() );
+                byte[] buffer = new byte[ XMLDBDriver.BUFFER_SIZE ];
+                while( true ) {
+                    int type = in.read();
+                    if( type == -1 ) {
+                        break;
+                    }
+                    int length = in.readInt();
+                    if( length > buffer.length ) {
+                        buffer = new byte[ length ];
+                    }
+                    in.readFully( buffer, 0, length );
+                    if( type == 'D' ) {
+                        if( mSpool != null ) {
+                            mSpool.write( buffer, 0, length );
+                        }
+                        continue;
+                    }
+                    boolean success = handleMessage( (char)type, buffer, length );
+                    out.write( success ? 1 : 0 );
+                    out.flush();
+                    if( type == 'C' ) {
+                        break;
+                    }
+                }
+            }
+            catch( IOException error ) {
+                error.printStackTrace();
+            }
+            finally {
+                closeDB();
+                try {
+                    if( mSpool != null ) {
+                        mSpool.close();
+                    }
+                    mSocket.close();
+                }
+                catch( IOException error ) {
+                    // ignore
+                }
+                if( mSpoolFile != null ) {
+                    mSpoolFile.delete();
+                }
+            }
+        }
+
+        /**
+         * Handle a message which requires a reply.
+         * @param aType The type of message.
+         * @param aPayload The contents of the message.
+         * @param aLength The length of the contents.
+         * @return Whether the message was handled successfully.
+         */
+        private boolean handleMessage( final char aType, final byte[] aPayload, final int aLength ) throws IOException {
+            if( aType == 'O' ) {
+                String[] args = splitPayload( aPayload, aLength );
+                mDBLocation = args[ 0 ];
+                mDocName = args[ 1 ];
+                mSpoolFile = File.createTempFile( "gcam-xmldb", ".xml" );
+                mSpool = new BufferedOutputStream( new FileOutputStream( mSpoolFile ), XMLDBDriver.BUFFER_SIZE );
+                return true;
+            }
+            else if( aType == 'F' ) {
+                return writeDocument();
+            }
+            else if( aType == 'A' ) {
+                String[] args = splitPayload( aPayload, aLength );
+                return mDriver != null && mDriver.appendData( args[ 1 ], args[ 0 ] );
+            }
+            else if( aType == 'C' ) {
+                return closeDB();
+            }
+            System.err.println( "ERROR: Unknown message type " + aType );
+            return false;
+        }
+
+        /**
+         * Pass the collected document to an XMLDBDriver once the database
+         * is available.  The database is kept open for appendData until the
+         * connection closes it.
+         * @return Whether the document was written.
+         */
+        private boolean writeDocument() throws IOException {
+            if( mSpool == null ) {
+                return false;
+            }
+            mSpool.close();
+            mSpool = null;
+
+            mDBLock.lock();
+            mDriver = new XMLDBDriver( mDBLocation, mDocName );
+            InputStream xmlRead = new FileInputStream( mSpoolFile );
+            byte[] buffer = new byte[ XMLDBDriver.BUFFER_SIZE ];
+            int read = 0;
+            boolean hadError = false;
+            while( !hadError && ( read = xmlRead.read( buffer ) ) != -1 ) {
+                hadError = mDriver.receiveDataFromGCAM( buffer, read );
+            }
+            xmlRead.close();
+            mSpoolFile.delete();
+            mSpoolFile = null;
+            mDriver.finish();
+            return !hadError;
+        }
+
+        /**
+         * Run any final processing and close the database if it was opened
+         * by this connection.
+         * @return Whether the database had been opened by this connection.
+         */
+        private boolean closeDB() {
+            if( mDriver == null ) {
+                return false;
+            }
+            try {
+                mDriver.finalizeAndClose();
+            }
+            finally {
+                mDriver = null;
+                mDBLock.unlock();
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Split a payload of two strings separated by a null character.
+     * @param aPayload The payload.
+     * @param aLength The length of the payload.
+     * @return The two strings.
+     */
+    private static String[] splitPayload( final byte[] aPayload, final int aLength ) throws IOException {
+        int split = 0;
+        while( split < aLength && aPayload[ split ] != 0 ) {
+            ++split;
+        }
+        if( split == aLength ) {
+            throw new IOException( "Malformed message from GCAM." );
+        }
+        String[] ret = new String[ 2 ];
+        ret[ 0 ] = new String( aPayload, 0, split, "UTF-8" );
+        ret[ 1 ] = new String( aPayload, split + 1, aLength - split - 1, "UTF-8" );
+        return ret;
+    }
+
+    /**
+     * Listen for GCAM processes on the loopback interface and write their
+     * output until the process is killed.
+     * @param aArgs Optionally the port to listen on.
+     */
+    public static void main( String[] aArgs ) throws Exception {
+        int port = aArgs.length > 0 ? Integer.parseInt( aArgs[ 0 ] ) : DEFAULT_PORT;
+        ServerSocket server = new ServerSocket( port, 50, InetAddress.getLoopbackAddress() );
+        System.out.println( "Writing XML database output from GCAM received on port " + port );
+        while( true ) {
+            Socket socket = server.accept();
+            new Thread( new Connection( socket ) ).start();
+        }
+    }
+}
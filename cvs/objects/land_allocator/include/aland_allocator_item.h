@@ -56,6 +56,7 @@
 #include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/object_pool.h"
 
 // For LandUsageType enum.
 #include "land_allocator/include/iland_allocator.h"
@@ -114,6 +115,7 @@ class ALandAllocatorItem : public TreeItem<ALandAllocatorItem>,
                            public INamed,
                            public IVisitable,
                            public IParsable,
+                           public PooledObject,
                            private boost::noncopyable
 {
     friend class XMLDBOutputter;
@@ -286,6 +288,12 @@ public:
      */
     double getProfitRate( const int aPeriod ) const;
 
+    bool isProfitRateChanged( const int aPeriod ) const;
+
+    void markProfitRateShared( const int aPeriod );
+
+    void resetSharedProfitRate();
+
     /*!
      * \brief Set the rate at which the carbon price is expected to increase
      * \details This method sets expectations about the carbon price to be
@@ -417,6 +425,8 @@ public:
                    const int aPeriod );
     
     double getShare( const int aPeriod ) const;
+
+    double getShareWeight( const int aPeriod ) const;
         
     const ALandAllocatorItem* getParent() const;
 
@@ -482,7 +492,11 @@ protected:
         //! name of land expansion constraint cost curve
         // TODO: should these be in the leaf?
         DEFINE_VARIABLE( SIMPLE, "landConstraintCurve", mLandExpansionCostName, std::string ),
-        DEFINE_VARIABLE( SIMPLE, "is-land-expansion-cost", mIsLandExpansionCost, bool )
+        DEFINE_VARIABLE( SIMPLE, "is-land-expansion-cost", mIsLandExpansionCost, bool ),
+
+        //! The profit rate with which the parent last calculated the share of this
+        //! item in the current period, NaN if it has not yet.
+        DEFINE_VARIABLE( SIMPLE | STATE, "shared-profit-rate", mSharedProfitRate, Value )
     )
 };
 
@@ -159,6 +159,38 @@ protected:
     )
 
 private:
+    /*!
+     * \brief The land allocation tree flattened so that shares and allocations
+     *        can be calculated by loops rather than recursion.
+     * \details The items are stored in the order the recursive
+     *          calcLandAllocation visits them, so every node comes before the
+     *          items below it.  Shares are calculated bottom up by looping over
+     *          the items in reverse and allocations top down by looping over
+     *          them forward.  Share weights and profit rates are read from the
+     *          items at the time of the calculation.
+     */
+    struct CompiledTree {
+        //! An item of the tree along with its parent.
+        struct Item {
+            //! The land allocator item.
+            ALandAllocatorItem* mItem;
+
+            //! The item as a node, null for a leaf.
+            LandNode* mNode;
+
+            //! Index of the parent in mItems, -1 for the root.
+            int mParent;
+        };
+
+        //! The items, each node before the items below it.
+        std::vector<Item> mItems;
+    };
+
+    //! The compiled land allocation tree, empty if the recursive calculation is used.
+    CompiledTree mCompiledTree;
+
+    void compileTree( ALandAllocatorItem* aItem, const int aParent );
+
     void calibrateLandAllocator( const std::string& aRegionName, const int aPeriod );
 
     void checkLandArea( const std::string& aRegionName, const int aPeriod );
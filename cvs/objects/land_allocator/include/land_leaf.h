@@ -191,6 +191,11 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "negative-emiss-market", mNegEmissMarketName, std::string )
     )
 
+    //! The period whose land-use change emissions to the end of the period
+    //! are in the base state of mLastCalcCO2Value, or -1 if it holds the full
+    //! emissions.
+    int mLUCPeriod;
+
     double getCarbonSubsidy( const std::string& aRegionName,
                            const int aPeriod ) const;
     
@@ -127,6 +127,10 @@ public:
                                    IDiscreteChoice* aChoiceFnAbove,
                                    const int aPeriod );
 
+    void calcChildShares( const int aPeriod );
+
+    bool calcChangedChildShares( const int aPeriod );
+
     virtual void calcLandAllocation( const std::string& aRegionName,
                                      const double aLandAllocationAbove,
                                      const int aPeriod );
@@ -39,6 +39,7 @@
  */
 
 #include "util/base/include/definitions.h"
+#include <limits>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/xml_helper.h"
 #include "land_allocator/include/aland_allocator_item.h"
@@ -100,6 +101,34 @@ double ALandAllocatorItem::getProfitRate( const int aPeriod ) const {
     return mProfitRate[ aPeriod ];
 }
 
+/*!
+ * \brief Whether the profit rate has changed since the parent last calculated
+ *        the share of this item.
+ * \param aPeriod The current model period.
+ * \return True if the share needs to be calculated again.
+ */
+bool ALandAllocatorItem::isProfitRateChanged( const int aPeriod ) const {
+    // Note the comparison is true if the shared profit rate is NaN.
+    return !( static_cast<double>( mProfitRate[ aPeriod ] ) == static_cast<double>( mSharedProfitRate ) );
+}
+
+/*!
+ * \brief Record that the parent has calculated the share of this item with its
+ *        current profit rate.
+ * \param aPeriod The current model period.
+ */
+void ALandAllocatorItem::markProfitRateShared( const int aPeriod ) {
+    mSharedProfitRate = mProfitRate[ aPeriod ];
+}
+
+/*!
+ * \brief Forget the profit rate last shared so that the share is calculated
+ *        again, which must be done at the start of each period.
+ */
+void ALandAllocatorItem::resetSharedProfitRate() {
+    mSharedProfitRate = numeric_limits<double>::quiet_NaN();
+}
+
 /*!
  * \brief Returns the share for the specified period.
  * \param aPeriod The period to get the rate for.
@@ -109,6 +138,15 @@ double ALandAllocatorItem::getShare( const int aPeriod ) const {
     return mShare[ aPeriod ];
 }
 
+/*!
+ * \brief Returns the share weight for the specified period.
+ * \param aPeriod The period to get the share weight for.
+ * \return The share weight of this item for the specified period.
+ */
+double ALandAllocatorItem::getShareWeight( const int aPeriod ) const {
+    return mShareWeight[ aPeriod ];
+}
+
 /*!
  * \brief Returns an enum representing the type of node (node/leaf).
  * \return Enum representing the type of this item.
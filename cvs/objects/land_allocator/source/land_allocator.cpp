@@ -49,6 +49,7 @@
 #include "ccarbon_model/include/carbon_model_utils.h"
 #include "util/base/include/configuration.h"
 #include "functions/include/idiscrete_choice.hpp"
+#include "util/base/include/scratch_array.h"
 
 using namespace std;
 using namespace xercesc;
@@ -127,6 +128,18 @@ void LandAllocator::initCalc( const string& aRegionName, const int aPeriod )
 
     // Call land node's initCalc
     LandNode::initCalc( aRegionName, aPeriod );
+
+    // Flatten the tree for the share and allocation calculations.  This is
+    // redone each period in case items were added since.
+    mCompiledTree.mItems.clear();
+    const static bool useCompiledTree = Configuration::getInstance()->getBool( "compile-land-allocator", true, false );
+    if( useCompiledTree ) {
+        compileTree( this, -1 );
+        // The shares of this period have not been calculated yet.
+        for( size_t i = 0; i < mCompiledTree.mItems.size(); ++i ) {
+            mCompiledTree.mItems[ i ].mItem->resetSharedProfitRate();
+        }
+    }
     
     // Ensure that carbon price increase rate is positive
     if ( mCarbonPriceIncreaseRate[ aPeriod ] < 0 ) {
@@ -272,6 +285,23 @@ void LandAllocator::setCarbonPriceIncreaseRate( const double aCarbonPriceIncreas
     }
 }
 
+/*!
+ * \brief Add an item and all of the items below it to the compiled tree.
+ * \details Items are added in the order calcLandAllocation visits them.
+ * \param aItem The item to add.
+ * \param aParent The index of the parent of the item, -1 for the root.
+ */
+void LandAllocator::compileTree( ALandAllocatorItem* aItem, const int aParent ) {
+    CompiledTree::Item item = { aItem, dynamic_cast<LandNode*>( aItem ), aParent };
+    const int index = static_cast<int>( mCompiledTree.mItems.size() );
+    mCompiledTree.mItems.push_back( item );
+    if( item.mNode ) {
+        for( size_t i = 0; i < aItem->getNumChildren(); ++i ) {
+            compileTree( aItem->getChildAt( i ), index );
+        }
+    }
+}
+
 /*!
 * \brief Set the number of years needed to for soil carbons emissions/uptake
 * \details This method sets the soil time scale into the carbon calculator
@@ -321,7 +351,26 @@ double LandAllocator::calcLandShares( const string& aRegionName,
     // First set value of unmanaged land leaves
     setUnmanagedLandProfitRate( aRegionName, mUnManagedLandValue, aPeriod );
 
-    LandNode::calcLandShares( aRegionName, aChoiceFnAbove, aPeriod );
+    if( !mCompiledTree.mItems.empty() ) {
+        // Outside of calibration, where the share weights are reset each time,
+        // only the nests with a changed profit rate need to be shared again.
+        const static bool incrementalShares = Configuration::getInstance()->getBool( "incremental-land-shares", true, false );
+        const bool onlyChanged = incrementalShares && aPeriod > scenario->getModeltime()->getFinalCalibrationPeriod();
+        // Visit the nodes bottom up so that the profit rates of child nodes are
+        // calculated before they are shared within their parent.
+        for( size_t i = mCompiledTree.mItems.size(); i-- > 0; ) {
+            LandNode* node = mCompiledTree.mItems[ i ].mNode;
+            if( node && onlyChanged ) {
+                node->calcChangedChildShares( aPeriod );
+            }
+            else if( node ) {
+                node->calcChildShares( aPeriod );
+            }
+        }
+    }
+    else {
+        LandNode::calcLandShares( aRegionName, aChoiceFnAbove, aPeriod );
+    }
  
     // This is the root node so its share is 100%.
     mShare[ aPeriod ] = 1;
@@ -331,6 +380,27 @@ double LandAllocator::calcLandShares( const string& aRegionName,
 void LandAllocator::calcLandAllocation( const string& aRegionName,
                                             const double aLandAllocationAbove,
                                             const int aPeriod ){
+    if( !mCompiledTree.mItems.empty() ) {
+        // The land allocation of each node which is passed down to the items
+        // below it.  The root passes its total land allocation to its children.
+        const vector<CompiledTree::Item>& items = mCompiledTree.mItems;
+        ScratchArray nodeLandAllocation( items.size() );
+        nodeLandAllocation[ 0 ] = mLandAllocation[ aPeriod ];
+        for( size_t i = 1; i < items.size(); ++i ) {
+            const double landAllocationAbove = nodeLandAllocation[ items[ i ].mParent ];
+            if( items[ i ].mNode ) {
+                const double share = items[ i ].mNode->getShare( aPeriod );
+                assert( share >= 0.0 && share <= 1.0 );
+                nodeLandAllocation[ i ] = landAllocationAbove > 0.0 && share > 0.0 ?
+                    landAllocationAbove * share : 0.0;
+            }
+            else {
+                items[ i ].mItem->calcLandAllocation( aRegionName, landAllocationAbove, aPeriod );
+            }
+        }
+        return;
+    }
+
     for ( unsigned int i = 0; i < mChildren.size(); ++i ){
         mChildren[ i ]->calcLandAllocation( aRegionName, mLandAllocation[ aPeriod ], aPeriod );
     }
@@ -58,6 +58,8 @@
 #include "util/base/include/configuration.h"
 #include "containers/include/market_dependency_finder.h"
 #include "functions/include/idiscrete_choice.hpp"
+#include "containers/include/world.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 using namespace std;
 using namespace xercesc;
@@ -79,7 +81,8 @@ LandLeaf::LandLeaf( const ALandAllocatorItem* aParent, const std::string &aName
     mLandUseHistory( 0 ),
     mReadinLandAllocation( Value( 0.0 ) ),
     mLastCalcCO2Value( 0.0 ),
-    mLandConstraintPolicy( "" )
+    mLandConstraintPolicy( "" ),
+    mLUCPeriod( -1 )
 {
 }
 
@@ -565,13 +568,26 @@ void LandLeaf::calcLandAllocation( const string& aRegionName,
 * \param aEndYear The year to calculate LUC emissions to.
 * \param aStoreFullEmiss Flag to pass on to the carbon calc used as an optimization
 *                        to avoid store full LUC emissins during World.calc.
+*                        When the world is evaluated at reduced accuracy the
+*                        emissions from the first calculation of the period are
+*                        held rather than calculated again.  The period is
+*                        only noted while the base state is active so that the
+*                        held emissions are always those of the base state.
 */
 void LandLeaf::calcLUCEmissions( const string& aRegionName,
                                  const int aPeriod, const int aEndYear,
                                  const bool aStoreFullEmiss )
 {
     // Calculate the amount of emissions attributed to land use change in the current period
-    mLastCalcCO2Value = mCarbonContentCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
+    if( aStoreFullEmiss || mLUCPeriod != aPeriod ||
+        scenario->getWorld()->getEvalAccuracy() == World::FULL_ACCURACY )
+    {
+        mLastCalcCO2Value = mCarbonContentCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
+        const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+        if( aStoreFullEmiss || !stateVars || !stateVars->isPartialDeriv() ) {
+            mLUCPeriod = aStoreFullEmiss ? -1 : aPeriod;
+        }
+    }
 
     // Add emissions to the carbon market.
     if ( !aStoreFullEmiss ) {
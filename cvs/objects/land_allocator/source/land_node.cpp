@@ -52,6 +52,7 @@
 #include "functions/include/idiscrete_choice.hpp"
 #include "functions/include/discrete_choice_factory.hpp"
 #include "sectors/include/sector_utils.h"
+#include "util/base/include/scratch_array.h"
 #include <numeric>
 #include <utility>
 
@@ -374,6 +375,69 @@ double LandNode::calcLandShares( const string& aRegionName,
     return unnormalizedShareAbove; // the unnormalized share of this node.
 }
 
+/*!
+* \brief Calculate the shares of the children of this node and the node profit
+*        rate without recursing into lower nests.
+* \details This is steps 1 to 3 of calcLandShares for the case where the profit
+*          rates of any child nodes have already been calculated.  The
+*          unnormalized share of each child, whether a node or a leaf, is
+*          calculated with the discrete choice function of this node from the
+*          share weight and profit rate of the child.  It is used by the
+*          LandAllocator to calculate shares by visiting the nodes of the tree
+*          bottom up.
+* \param aPeriod Period.
+*/
+void LandNode::calcChildShares( const int aPeriod ) {
+    // Note these are the log( unnormalized shares )
+    ScratchArray unnormalizedShares( mChildren.size() );
+    for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
+        unnormalizedShares[ i ] = mChoiceFn->calcUnnormalizedShare( mChildren[ i ]->getShareWeight( aPeriod ),
+                                                                    mChildren[ i ]->getProfitRate( aPeriod ),
+                                                                    aPeriod );
+    }
+
+    pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( unnormalizedShares.data(),
+                                                                            mChildren.size() );
+    for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
+        mChildren[ i ]->setShare( unnormalizedShares[ i ], aPeriod );
+    }
+
+    mProfitRate[ aPeriod ] = mChoiceFn->calcAverageValue( unnormalizedSum.first, unnormalizedSum.second, aPeriod );
+}
+
+/*!
+* \brief Calculate the shares of the children of this node and the node profit
+*        rate only if the profit rate of any child changed since they were last
+*        calculated.
+* \details The shares and node profit rate depend only on the share weights and
+*          profit rates of the children, and the share weights do not change
+*          outside of calibration.  Otherwise the shares kept in the state from
+*          the last calculation, such as the base state during a partial
+*          derivative, are still correct and need not be recalculated.  When
+*          visiting the nodes bottom up only the nodes on the path from a leaf
+*          with a changed profit rate to the root are recalculated, along with
+*          the shares of their direct children.
+* \param aPeriod Period.
+* \return Whether the shares were calculated, in which case the node profit rate
+*         may have changed.
+* \sa LandNode::calcChildShares
+*/
+bool LandNode::calcChangedChildShares( const int aPeriod ) {
+    bool isChanged = false;
+    for ( unsigned int i = 0; i < mChildren.size() && !isChanged; i++ ) {
+        isChanged = mChildren[ i ]->isProfitRateChanged( aPeriod );
+    }
+    if( !isChanged ) {
+        return false;
+    }
+
+    calcChildShares( aPeriod );
+    for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
+        mChildren[ i ]->markProfitRateShared( aPeriod );
+    }
+    return true;
+}
+
 void LandNode::calculateShareWeights( const string& aRegionName, 
                                       IDiscreteChoice* aChoiceFnAbove,
                                       const int aPeriod,
@@ -60,6 +60,7 @@
 #include <string>
 #include <memory>
 #include <list>
+#include <vector>
 
 // xerces xml headers
 #include <xercesc/dom/DOMNode.hpp>
@@ -71,11 +72,14 @@
 #include "containers/include/scenario.h"
 #include "containers/include/iscenario_runner.h"
 #include "containers/include/scenario_runner_factory.h"
+#include "containers/include/model_server.h"
 #include "util/logger/include/ilogger.h"
 #include "util/logger/include/logger_factory.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/version.h"
 #include "util/base/include/util.h"
+#include "util/base/include/input_image.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 using namespace std;
 using namespace xercesc;
@@ -88,7 +92,8 @@ ofstream outFile;
 // Declared outside Main to make global.
 Scenario* scenario; // model scenario info
 
-void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg );
+void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg, bool& compileInputs,
+                bool& runServer, bool& resume );
 void printUsageMessage( unsigned int argc, char* argv[] );
 
 //! Main program. 
@@ -97,8 +102,12 @@ int main( int argc, char *argv[] ) {
     // identify default file names for control input and logging controls
     string configurationArg = "configuration.xml";
     string loggerFactoryArg = "log_conf.xml";
+    bool compileInputs = false;
+    bool runServer = false;
+    bool resume = false;
     // Parse any command line arguments.  Can override defaults with command lone args
-    parseArgs( argc, argv, configurationArg, loggerFactoryArg );
+    parseArgs( argc, argv, configurationArg, loggerFactoryArg, compileInputs, runServer, resume );
+    ManageStateVariables::setResume( resume );
 
     // Add OS dependent prefixes to the arguments.
     const string configurationFileName = configurationArg;
@@ -168,6 +177,27 @@ int main( int argc, char *argv[] ) {
         return 1;
     }
 
+    // Save the input files to a binary image for later runs instead of running
+    // the model.
+    if( compileInputs ) {
+        vector<string> inputFiles( 1, conf->getFile( "xmlInputFileName" ) );
+        const list<string> scenComponents = conf->getScenarioComponents();
+        inputFiles.insert( inputFiles.end(), scenComponents.begin(), scenComponents.end() );
+        success = InputImage::compile( conf->getFile( "input-image", "gcam-inputs.img", false ), inputFiles,
+                                       conf->getBool( "validate-xml-input", true, false ) );
+        XMLHelper<void>::cleanupParser();
+        return success ? 0 : 1;
+    }
+
+    // Keep the reference inputs loaded and run scenarios as they are requested.
+    if( runServer ) {
+        ModelServer server;
+        success = server.run( cin, cout, timer );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Model server exiting." << endl;
+        return success ? 0 : 1;
+    }
+
     // Create an empty exclusion list so that any type of IScenarioRunner can be
     // created.
     list<string> exclusionList;
@@ -212,9 +242,16 @@ int main( int argc, char *argv[] ) {
 * \param argv List of arguments.
 * \param confArg [out] Name of the configuration file.
 * \param logFacArg [out] Name of the log configuration file.
+* \param compileInputs [out] Whether to compile the input files into an image
+*                      rather than run the model.
+* \param runServer [out] Whether to run scenarios as they are requested rather
+*                  than a single run.
+* \param resume [out] Whether to resume each scenario from its last checkpoint.
 * \todo Allow a space between the flags and the file names.
 */
-void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg ) {
+void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg, bool& compileInputs,
+                bool& runServer, bool& resume )
+{
     for( unsigned int i = 1; i < argc; ){
         string temp( argv[ i ] );
         if( temp == "-C" ) {
@@ -243,6 +280,18 @@ void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFac
             logFacArg = temp.substr( 2, temp.length() );
             ++i;
         }
+        else if( temp == "--compile-inputs" ) {
+            compileInputs = true;
+            ++i;
+        }
+        else if( temp == "--server" ) {
+            runServer = true;
+            ++i;
+        }
+        else if( temp == "--resume" ) {
+            resume = true;
+            ++i;
+        }
         else if( temp == "--version" ) {
             cout << "GCAM version " << __ObjECTS_VER__ << " Revision: " << __REVISION_NUMBER__ << endl;
             exit( 0 );
@@ -265,7 +314,7 @@ void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFac
  * \param argv List of arguments.
  */
 void printUsageMessage( unsigned int argc, char* argv[] ) {
-    cout << "Usage: " << argv[ 0 ] << " [-CconfigurationFileName ][ -LloggerFactoryFileName ]" << endl;
+    cout << "Usage: " << argv[ 0 ] << " [-CconfigurationFileName ][ -LloggerFactoryFileName ][ --compile-inputs | --server ][ --resume ]" << endl;
     cout << "OR" << endl;
     cout << "Usage: " << argv[ 0 ] << " --version" << endl;
     cout << "OR" << endl;
@@ -0,0 +1,597 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+* \file microbenchmarks.cpp
+* \ingroup Objects
+* \brief Microbenchmarks of the kernels which dominate the model calculation.
+* \details This is the main program of microbench.exe, which is built by
+*          "make microbench" in build/linux separately from gcam.exe and
+*          linked against the same library. Each kernel is run enough times to
+*          take at least the minimum time and this is repeated a number of
+*          times, the median and minimum time per call are reported as CSV so
+*          that they can be compared between commits.
+*
+*          The kernels which need no model data are run on synthetic data
+*          generated from a fixed seed. The land allocation, carbon and state
+*          kernels are run on the scenario given by the configuration, which
+*          is set up and calculated up to the benchmark period first. Their
+*          numbers are only comparable between runs with the same inputs.
+*
+*          Given a trace recorded by gcam.exe with calc-trace-period, the
+*          model evaluations of the traced period are also replayed through
+*          World::calc, in which case the benchmark period is that of the
+*          trace.  This times the model calculation as the solver drives it
+*          without any changes to the solver affecting the result.
+*
+*          Usage: microbench.exe [-C configuration] [-L log configuration]
+*          [-p period] [-f filter] [-o output CSV] [-t minimum seconds]
+*          [-r calc trace]
+*          where only the kernels whose names contain the filter are run.
+*/
+
+#include "util/base/include/definitions.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#if USE_LAPACK
+#include <boost/numeric/bindings/traits/ublas_vector.hpp>
+#include <boost/numeric/bindings/traits/ublas_matrix.hpp>
+#include <boost/numeric/bindings/lapack/gesvd.hpp>
+#include "solution/util/include/svd_invert_solve.hpp"
+#endif
+
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/default_visitor.h"
+#include "util/base/include/hash_map.h"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/timer.h"
+#include "util/base/include/model_time.h"
+#include "util/curves/include/point_set_curve.h"
+#include "util/logger/include/ilogger.h"
+#include "util/logger/include/logger_factory.h"
+#include "containers/include/scenario.h"
+#include "containers/include/single_scenario_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "containers/include/region.h"
+#include "containers/include/info_factory.h"
+#include "containers/include/iinfo.h"
+#include "containers/include/world.h"
+#include "marketplace/include/market_locator.h"
+#include "functions/include/relative_cost_logit.hpp"
+#include "land_allocator/include/land_allocator.h"
+#include "ccarbon_model/include/asimple_carbon_calc.h"
+#include "solution/util/include/linear_solver.hpp"
+#include "solution/util/include/calc_trace.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+namespace ublas = boost::numeric::ublas;
+
+// The output file used by the model, as in gcam.exe.
+ofstream outFile;
+
+namespace {
+    //! Results are accumulated in here so that the kernels are not optimized away.
+    volatile double gSink = 0;
+
+    /*!
+     * \brief Times kernels and collects the results.
+     */
+    class MicroBenchmarkRunner {
+    public:
+        MicroBenchmarkRunner( const string& aFilter, const double aMinSeconds, const int aRepeats ):
+        mFilter( aFilter ),
+        mMinSeconds( aMinSeconds ),
+        mRepeats( aRepeats )
+        {
+        }
+
+        /*!
+         * \brief Whether a kernel is selected by the filter.
+         * \param aName The name of the kernel.
+         * \return Whether the kernel should be run.
+         */
+        bool isSelected( const string& aName ) const {
+            return aName.find( mFilter ) != string::npos;
+        }
+
+        /*!
+         * \brief Time a kernel.
+         * \details The number of calls is doubled until they take at least
+         *          the minimum time, then that many calls are timed the
+         *          configured number of times.
+         * \param aName The name of the kernel.
+         * \param aKernel A function which calls the kernel the number of times
+         *        it is passed.
+         */
+        template<class Kernel>
+        void run( const string& aName, Kernel aKernel ) {
+            if( !isSelected( aName ) ) {
+                return;
+            }
+            size_t numCalls = 1;
+            while( time( aKernel, numCalls ) < mMinSeconds && numCalls < ( size_t( 1 ) << 40 ) ) {
+                numCalls *= 2;
+            }
+            vector<double> nsPerCall;
+            for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+                nsPerCall.push_back( time( aKernel, numCalls ) * 1e9 / numCalls );
+            }
+            sort( nsPerCall.begin(), nsPerCall.end() );
+
+            Result result;
+            result.mName = aName;
+            result.mNumCalls = numCalls;
+            result.mMedianNs = nsPerCall[ nsPerCall.size() / 2 ];
+            result.mMinNs = nsPerCall.front();
+            mResults.push_back( result );
+            cout << result.mName << ": " << result.mMedianNs << " ns" << endl;
+        }
+
+        /*!
+         * \brief Write the results as CSV.
+         * \param aOut The stream to write to.
+         */
+        void write( ostream& aOut ) const {
+            aOut << "kernel,calls,median-ns,min-ns" << '\n';
+            for( vector<Result>::const_iterator result = mResults.begin(); result != mResults.end(); ++result ) {
+                aOut << result->mName << ',' << result->mNumCalls << ','
+                     << result->mMedianNs << ',' << result->mMinNs << '\n';
+            }
+        }
+
+    private:
+        //! The timing of a single kernel.
+        struct Result {
+            //! The name of the kernel.
+            string mName;
+            //! The number of calls in each timing.
+            size_t mNumCalls;
+            //! The median time of a call in nanoseconds.
+            double mMedianNs;
+            //! The minimum time of a call in nanoseconds.
+            double mMinNs;
+        };
+
+        //! Only kernels whose names contain this are run.
+        string mFilter;
+
+        //! The minimum time of each timing in seconds.
+        double mMinSeconds;
+
+        //! The number of timings of each kernel.
+        int mRepeats;
+
+        //! The results so far.
+        vector<Result> mResults;
+
+        template<class Kernel>
+        static double time( Kernel& aKernel, const size_t aNumCalls ) {
+            const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            aKernel( aNumCalls );
+            return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+        }
+    };
+
+    /*!
+     * \brief Collects the objects of a scenario which kernels are run on.
+     * \details The visitor only has const access, the kernels are run on
+     *          the objects as the model calculation would run them.
+     */
+    class KernelObjectFinder : public DefaultVisitor {
+    public:
+        virtual void startVisitRegion( const Region* aRegion, const int aPeriod ) {
+            mCurrentRegion = aRegion->getName();
+        }
+
+        virtual void startVisitLandNode( const LandNode* aLandNode, const int aPeriod ) {
+            const LandAllocator* landAllocator = dynamic_cast<const LandAllocator*>( aLandNode );
+            if( landAllocator ) {
+                mLandAllocators.push_back( make_pair( mCurrentRegion, const_cast<LandAllocator*>( landAllocator ) ) );
+            }
+        }
+
+        virtual void startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc, const int aPeriod ) {
+            const ASimpleCarbonCalc* carbonCalc = dynamic_cast<const ASimpleCarbonCalc*>( aCarbonCalc );
+            if( carbonCalc ) {
+                mCarbonCalcs.push_back( const_cast<ASimpleCarbonCalc*>( carbonCalc ) );
+            }
+        }
+
+        //! The land allocator of each region with the name of the region.
+        vector<pair<string, LandAllocator*> > mLandAllocators;
+
+        //! All simple carbon calculators.
+        vector<ASimpleCarbonCalc*> mCarbonCalcs;
+
+    private:
+        //! The name of the region being visited.
+        string mCurrentRegion;
+    };
+
+    /*!
+     * \brief Generate names such as "region-3".
+     * \param aPrefix The start of each name.
+     * \param aNumNames The number of names.
+     * \return The names.
+     */
+    vector<string> makeNames( const string& aPrefix, const size_t aNumNames ) {
+        vector<string> names;
+        for( size_t i = 0; i < aNumNames; ++i ) {
+            names.push_back( aPrefix + "-" + util::toString( i ) );
+        }
+        return names;
+    }
+
+    /*!
+     * \brief Run the kernels which use synthetic data.
+     * \param aRunner The runner to time the kernels with.
+     */
+    void runSyntheticKernels( MicroBenchmarkRunner& aRunner ) {
+        mt19937 random( 12345 );
+        uniform_real_distribution<double> unit( 0.0, 1.0 );
+        const size_t NUM_LOOKUPS = 4096;
+
+        // Markets of typical counts of regions and goods, looked up in a random
+        // order.
+        {
+            const vector<string> regions = makeNames( "region", 32 );
+            const vector<string> goods = makeNames( "good", 300 );
+            MarketLocator locator;
+            int marketNumber = 0;
+            for( size_t region = 0; region < regions.size(); ++region ) {
+                for( size_t good = 0; good < goods.size(); ++good ) {
+                    // Every tenth good has a global market.
+                    const string& market = good % 10 == 0 ? regions[ 0 ] : regions[ region ];
+                    if( locator.addMarket( market, regions[ region ], goods[ good ], marketNumber )
+                        == marketNumber )
+                    {
+                        ++marketNumber;
+                    }
+                }
+            }
+            vector<pair<const string*, const string*> > lookups;
+            for( size_t i = 0; i < NUM_LOOKUPS; ++i ) {
+                lookups.push_back( make_pair( &regions[ random() % regions.size() ],
+                                              &goods[ random() % goods.size() ] ) );
+            }
+            aRunner.run( "MarketLocator::getMarketNumber", [&]( const size_t aNumCalls ) {
+                int sum = 0;
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    const pair<const string*, const string*>& lookup = lookups[ i % NUM_LOOKUPS ];
+                    sum += locator.getMarketNumber( *lookup.first, *lookup.second );
+                }
+                gSink = sum;
+            } );
+        }
+
+        // A technology info below sector and region infos as in the model, with
+        // keys found at each level.
+        {
+            auto_ptr<IInfo> regionInfo( InfoFactory::constructInfo( 0, "region" ) );
+            auto_ptr<IInfo> sectorInfo( InfoFactory::constructInfo( regionInfo.get(), "sector" ) );
+            auto_ptr<IInfo> techInfo( InfoFactory::constructInfo( sectorInfo.get(), "technology" ) );
+            const vector<string> keys = makeNames( "key", 40 );
+            for( size_t i = 0; i < keys.size(); ++i ) {
+                IInfo* info = i < 20 ? regionInfo.get() : i < 35 ? sectorInfo.get() : techInfo.get();
+                info->setDouble( keys[ i ], unit( random ) );
+            }
+            InfoFactory::freezeInfos();
+            vector<const string*> lookups;
+            for( size_t i = 0; i < NUM_LOOKUPS; ++i ) {
+                lookups.push_back( &keys[ random() % keys.size() ] );
+            }
+            aRunner.run( "Info::getDouble", [&]( const size_t aNumCalls ) {
+                double sum = 0;
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    sum += techInfo->getDouble( *lookups[ i % NUM_LOOKUPS ], false );
+                }
+                gSink = sum;
+            } );
+        }
+
+        // A curve of typical sizes evaluated at random points.
+        const size_t curveSizes[] = { 10, 100 };
+        for( size_t size = 0; size < sizeof( curveSizes ) / sizeof( curveSizes[ 0 ] ); ++size ) {
+            vector<double> yValues;
+            for( size_t i = 0; i < curveSizes[ size ]; ++i ) {
+                yValues.push_back( unit( random ) * i );
+            }
+            PointSetCurve curve( "ExplicitPointSet", "XYDataPoint", yValues, 0, 1 );
+            vector<double> xValues;
+            for( size_t i = 0; i < NUM_LOOKUPS; ++i ) {
+                xValues.push_back( unit( random ) * curveSizes[ size ] );
+            }
+            aRunner.run( "PointSetCurve::getY n=" + util::toString( curveSizes[ size ] ),
+                         [&]( const size_t aNumCalls ) {
+                double sum = 0;
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    sum += curve.getY( xValues[ i % NUM_LOOKUPS ] );
+                }
+                gSink = sum;
+            } );
+        }
+
+        // A map of a typical number of names, filled from empty and searched.
+        {
+            const vector<string> keys = makeNames( "sector", 1000 );
+            aRunner.run( "HashMap::insert 1000 keys", [&]( const size_t aNumCalls ) {
+                size_t sum = 0;
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    HashMap<string, int> map;
+                    for( size_t key = 0; key < keys.size(); ++key ) {
+                        map.insert( make_pair( keys[ key ], static_cast<int>( key ) ) );
+                    }
+                    sum += map.size();
+                }
+                gSink = sum;
+            } );
+
+            HashMap<string, int> map;
+            for( size_t key = 0; key < keys.size(); ++key ) {
+                map.insert( make_pair( keys[ key ], static_cast<int>( key ) ) );
+            }
+            vector<const string*> lookups;
+            for( size_t i = 0; i < NUM_LOOKUPS; ++i ) {
+                lookups.push_back( &keys[ random() % keys.size() ] );
+            }
+            aRunner.run( "HashMap::find", [&]( const size_t aNumCalls ) {
+                int sum = 0;
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    sum += map.find( *lookups[ i % NUM_LOOKUPS ] )->second;
+                }
+                gSink = sum;
+            } );
+        }
+
+        // Diagonally dominant Jacobians of typical numbers of markets.
+        const size_t matrixSizes[] = { 100, 300, 1000 };
+        for( size_t size = 0; size < sizeof( matrixSizes ) / sizeof( matrixSizes[ 0 ] ); ++size ) {
+            const size_t n = matrixSizes[ size ];
+            ublas::matrix<double, ublas::column_major> jacobian( n, n );
+            ublas::vector<double> rhs( n );
+            for( size_t i = 0; i < n; ++i ) {
+                for( size_t j = 0; j < n; ++j ) {
+                    jacobian( i, j ) = unit( random ) - 0.5 + ( i == j ? n : 0 );
+                }
+                rhs[ i ] = unit( random );
+            }
+            aRunner.run( "LinearSolver factorize and solve n=" + util::toString( n ),
+                         [&]( const size_t aNumCalls ) {
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    LinearSolver solver;
+                    solver.factorize( jacobian );
+                    ublas::vector<double> x( rhs );
+                    solver.solve( x );
+                    gSink = x[ 0 ];
+                }
+            } );
+#if USE_LAPACK
+            ublas::matrix<double, ublas::column_major> a( jacobian );
+            ublas::matrix<double, ublas::column_major> u( n, n );
+            ublas::matrix<double, ublas::column_major> vt( n, n );
+            ublas::vector<double> s( n );
+            boost::numeric::bindings::lapack::gesvd( 'O', 'A', 'A', a, s, u, vt );
+            ostream nullLog( 0 );
+            aRunner.run( "svdInvertSolve n=" + util::toString( n ), [&]( const size_t aNumCalls ) {
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    ublas::vector<double> x( rhs );
+                    svdInvertSolve( u, s, vt, x, nullLog );
+                    gSink = x[ 0 ];
+                }
+            } );
+#endif
+        }
+    }
+
+    /*!
+     * \brief Run the kernels which use the objects of the calculated scenario.
+     * \param aRunner The runner to time the kernels with.
+     * \param aPeriod The period which was calculated.
+     * \param aTrace The model evaluations to replay, or null if none.
+     */
+    void runScenarioKernels( MicroBenchmarkRunner& aRunner, const int aPeriod,
+                             const CalcTraceReplay* aTrace )
+    {
+        mt19937 random( 12345 );
+        uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+        // The logit is run on its own as its exponents are sized by the model
+        // time.
+        RelativeCostLogit logit;
+        const size_t numOptions[] = { 2, 8, 32, 128 };
+        for( size_t size = 0; size < sizeof( numOptions ) / sizeof( numOptions[ 0 ] ); ++size ) {
+            const size_t n = numOptions[ size ];
+            vector<double> shareWeights( n );
+            vector<double> values( n );
+            vector<double> shares( n );
+            for( size_t i = 0; i < n; ++i ) {
+                shareWeights[ i ] = 0.5 + unit( random );
+                values[ i ] = 1 + 100 * unit( random );
+            }
+            aRunner.run( "RelativeCostLogit::calcShares n=" + util::toString( n ),
+                         [&]( const size_t aNumCalls ) {
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    gSink = logit.calcShares( &shareWeights[ 0 ], &values[ 0 ], 0, &shares[ 0 ],
+                                              n, aPeriod ).first;
+                }
+            } );
+        }
+
+        KernelObjectFinder finder;
+        scenario->getWorld()->accept( &finder, aPeriod );
+
+        // Calculate with the state set up as it is during World::calc.
+        ManageStateVariables stateVariables( aPeriod );
+
+        aRunner.run( "LandAllocator::calcLandShares all regions", [&]( const size_t aNumCalls ) {
+            for( size_t i = 0; i < aNumCalls; ++i ) {
+                for( size_t region = 0; region < finder.mLandAllocators.size(); ++region ) {
+                    gSink = finder.mLandAllocators[ region ].second->calcLandShares(
+                        finder.mLandAllocators[ region ].first, &logit, aPeriod );
+                }
+            }
+        } );
+
+        const int endYear = scenario->getModeltime()->getper_to_yr( aPeriod );
+        aRunner.run( "ASimpleCarbonCalc::calc all land", [&]( const size_t aNumCalls ) {
+            for( size_t i = 0; i < aNumCalls; ++i ) {
+                double sum = 0;
+                for( size_t calc = 0; calc < finder.mCarbonCalcs.size(); ++calc ) {
+                    sum += finder.mCarbonCalcs[ calc ]->calc( aPeriod, endYear, ICarbonCalc::eReturnTotal );
+                }
+                gSink = sum;
+            }
+        } );
+
+        // This is the cost of resetting the scratch state before each partial
+        // derivative when the previous one changed nothing outside of the
+        // markets.
+        stateVariables.setPartialDeriv( true );
+        stateVariables.copyState();
+        aRunner.run( "ManageStateVariables::copyState unchanged", [&]( const size_t aNumCalls ) {
+            for( size_t i = 0; i < aNumCalls; ++i ) {
+                stateVariables.copyState();
+            }
+        } );
+        stateVariables.setPartialDeriv( false );
+
+        // Each replay starts again from the state the traced solve started from.
+        if( aTrace && aTrace->isCompatible( &stateVariables ) ) {
+            aRunner.run( "World::calc replay of " + util::toString( aTrace->getNumCalcs() ) + " calcs",
+                         [&]( const size_t aNumCalls ) {
+                for( size_t i = 0; i < aNumCalls; ++i ) {
+                    aTrace->replay( &stateVariables );
+                }
+            } );
+        }
+    }
+}
+
+//! Main program of the microbenchmarks.
+int main( int argc, char* argv[] ) {
+    string configurationFileName = "configuration.xml";
+    string loggerFileName = "log_conf.xml";
+    string filter;
+    string outputFileName;
+    string traceFileName;
+    int period = 0;
+    double minSeconds = 0.2;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        const string flag = argv[ i ];
+        if( flag == "-C" ) {
+            configurationFileName = argv[ i + 1 ];
+        }
+        else if( flag == "-L" ) {
+            loggerFileName = argv[ i + 1 ];
+        }
+        else if( flag == "-p" ) {
+            period = atoi( argv[ i + 1 ] );
+        }
+        else if( flag == "-f" ) {
+            filter = argv[ i + 1 ];
+        }
+        else if( flag == "-o" ) {
+            outputFileName = argv[ i + 1 ];
+        }
+        else if( flag == "-t" ) {
+            minSeconds = atof( argv[ i + 1 ] );
+        }
+        else if( flag == "-r" ) {
+            traceFileName = argv[ i + 1 ];
+        }
+        else {
+            cerr << "Usage: " << argv[ 0 ] << " [-C configuration] [-L log configuration] [-p period]"
+                 << " [-f filter] [-o output CSV] [-t minimum seconds] [-r calc trace]" << endl;
+            return 1;
+        }
+    }
+
+    LoggerFactoryWrapper loggerFactoryWrapper;
+    if( !XMLHelper<void>::parseXML( loggerFileName, &loggerFactoryWrapper ) ||
+        !XMLHelper<void>::parseXML( configurationFileName, Configuration::getInstance() ) )
+    {
+        return 1;
+    }
+
+    Timer timer;
+    timer.start();
+    auto_ptr<SingleScenarioRunner> runner = ScenarioRunnerFactory::createSingleScenarioRunner();
+    if( !runner->setupScenarios( timer ) ) {
+        return 1;
+    }
+    XMLHelper<void>::cleanupParser();
+
+    MicroBenchmarkRunner benchmarks( filter, minSeconds, 5 );
+    runSyntheticKernels( benchmarks );
+
+    // Calculate the scenario up to the benchmark period so that the kernels
+    // which use it run on the state they see in the model.
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    auto_ptr<CalcTraceReplay> trace;
+    if( !traceFileName.empty() ) {
+        trace.reset( new CalcTraceReplay() );
+        if( !trace->load( traceFileName, scenario->getWorld() ) ) {
+            return 1;
+        }
+        period = trace->getPeriod();
+    }
+    if( period < 0 || period >= scenario->getModeltime()->getmaxper() ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Invalid benchmark period " << period << "." << endl;
+        return 1;
+    }
+    runner->getInternalScenario()->run( period, false );
+    runScenarioKernels( benchmarks, period, trace.get() );
+
+    benchmarks.write( cout );
+    if( !outputFileName.empty() ) {
+        ofstream outputFile( outputFileName.c_str() );
+        benchmarks.write( outputFile );
+    }
+    runner->cleanup();
+    return 0;
+}
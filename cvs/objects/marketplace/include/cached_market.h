@@ -93,6 +93,18 @@ public:
     
     const IInfo* getMarketInfo( const std::string& aGoodName, const std::string& aRegionName,
                                const int aPeriod, const bool aMustExist ) const;
+
+    /*!
+     * \brief Whether this market was located for the given period.
+     * \details Objects which cache a market in initCalc may also be queried for
+     *          other periods, for instance during reporting, and can use this
+     *          to decide whether to fall back to the Marketplace.
+     * \param aPeriod The period to check.
+     * \return True if the cached market is for aPeriod.
+     */
+    bool isForPeriod( const int aPeriod ) const {
+        return aPeriod == mPeriod;
+    }
     
     IInfo* getMarketInfo( const std::string& aGoodName, const std::string& aRegionName,
                          const int aPeriod, const bool aMustExist );
@@ -104,9 +116,9 @@ private:
     //! The region name used when this market was located.  Used for debugging.
     const std::string mRegionName;
     
-    //! The period used when this market was located.  Used for debugging.
-    const int mPeriod;
 #endif
+    //! The period used when this market was located.
+    const int mPeriod;
     //! The actual market which is cached.
     Market* mCachedMarket;
 };
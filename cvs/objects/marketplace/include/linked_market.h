@@ -46,6 +46,7 @@
  * \author Pralit Patel
  */
 
+#include <vector>
 #include "marketplace/include/market.h"
 
 /*! 
@@ -61,6 +62,7 @@
  */
 class LinkedMarket: public Market {
     friend class MarketDependencyFinder;
+    friend class Marketplace;
 public:
     LinkedMarket( Market* aLinkedMarket, const MarketContainer* aContainer );
     virtual IMarketType::Type getType() const;
@@ -89,6 +91,35 @@ protected:
     //! The pointer to the market linked to.
     Market* mLinkedMarket;
     
+    //! The market at the end of the chain of links which sets the price, or
+    //! null if it has not been found by the Marketplace.
+    Market* mRootMarket;
+    
+    //! The product of the price multipliers along the chain of links to mRootMarket.
+    double mRootPriceMult;
+    
+    /*!
+     * \brief An addition to pass on to a market further down the chain of links.
+     */
+    struct LinkedTransfer {
+        //! The market to add to.
+        Market* mTarget;
+        
+        //! The product of the quantity multipliers from this market to the target.
+        double mQuantityMult;
+        
+        //! Whether the target is itself a linked market.
+        bool mIsTargetLinked;
+    };
+    
+    //! The transfers to every market down the chain of links as found by the
+    //! Marketplace.
+    std::vector<LinkedTransfer> mTransfers;
+    
+    //! Whether the quantities added to this market are passed on with
+    //! mTransfers rather than through each link in turn.
+    bool mIsPlanned;
+    
     // Define data such that introspection utilities can process the data from this
     // subclass together with the data members of the parent classes.
     DEFINE_DATA_WITH_PARENT(
@@ -57,6 +57,7 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include "tbb/spin_rw_mutex.h"
+#include "marketplace/include/market_accumulator.h"
 #endif
 
 class IInfo;
@@ -115,6 +116,10 @@ class Market: public IYeared, public IVisitable, private boost::noncopyable
 {
     friend class XMLDBOutputter;
     friend class PriceMarket;
+    friend class ManageStateVariables;
+#if GCAM_PARALLEL_ENABLED
+    friend class MarketAccumulator;
+#endif
 public:
     Market( const MarketContainer* aContainer );
     virtual ~Market();
@@ -160,6 +165,7 @@ public:
     virtual bool meetsSpecialSolutionCriteria() const = 0;
     virtual bool shouldSolve() const;
     virtual bool shouldSolveNR() const;
+    virtual bool isPriceChangeHidden( const double aPrice, const double aNewPrice ) const;
     bool isSolvable() const;
     
     virtual int getSerialNumber() const;
@@ -227,6 +233,12 @@ protected:
     
     //! A fast lock to protect concurrent adds to supply.
     mutable Mutex mSupplyMutex;
+    
+    double getParallelTotal( const Value& aValue, const MarketAccumulator::Quantity aQuantity,
+                             Mutex& aMutex ) const;
+    
+    void addParallel( Value& aValue, const double aAddition,
+                      const MarketAccumulator::Quantity aQuantity, Mutex& aMutex );
 #endif
     
     //! Object containing information related to the market.
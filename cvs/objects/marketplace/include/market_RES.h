@@ -78,6 +78,7 @@ public:
     virtual bool meetsSpecialSolutionCriteria() const;
     virtual bool shouldSolve() const;
     virtual bool shouldSolveNR() const;
+    virtual bool isPriceChangeHidden( const double aPrice, const double aNewPrice ) const;
 protected:
     
     // Define data such that introspection utilities can process the data from this
@@ -0,0 +1,218 @@
+#ifndef _MARKET_ACCUMULATOR_H_
+#define _MARKET_ACCUMULATOR_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file market_accumulator.h
+ * \ingroup Objects
+ * \brief The MarketAccumulator class header file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <tbb/enumerable_thread_specific.h>
+
+class Market;
+class MarketContainer;
+
+/*!
+ * \brief Collects the additions to market supplies and demands made during a
+ *        parallel World::calc without locking the markets.
+ * \details While active each thread adds to its own buffer, which is dense in
+ *          the market serial number, so that threads calculating activities
+ *          which add to a popular market (electricity, CO2, etc) do not contend
+ *          for it.  Each addition is tagged with the index in the global
+ *          ordering of the activity which made it.  The total for a market is
+ *          then the value before the calculation plus all of the additions
+ *          summed in the order of the global ordering, which is exactly the
+ *          order a serial World::calc would have added them in.  The result is
+ *          therefore the same from run to run regardless of how activities are
+ *          scheduled on threads, and is the same as the serial calculation.
+ *
+ *          Activities which read a supply or demand during the calculation
+ *          (such as a supply sector reading the demand for its good) get the
+ *          total from getTotal.  This relies on the flow graph ordering all of
+ *          the activities which add to a market before any which read it, which
+ *          the model requires in any case.  The total is reduced from the
+ *          buffers the first time it is read and kept until the next addition
+ *          to that market quantity, so repeated reads do not gather and sort the
+ *          additions again.  At the end of the calculation finish reduces the
+ *          buffers into the markets.
+ *
+ *          Threads are assigned a buffer the first time they add while active.
+ *          Should there be more threads than buffers the extra threads get no
+ *          buffer and add fails, in which case the caller must fall back to
+ *          locking the market.
+ */
+class MarketAccumulator
+{
+public:
+    //! The market quantities which may be accumulated.
+    enum Quantity {
+        DEMAND = 0,
+        SUPPLY = 1
+    };
+
+    MarketAccumulator();
+    ~MarketAccumulator();
+
+    bool start( const std::vector<MarketContainer*>& aMarkets, const int aPeriod );
+
+    void finish();
+
+    //! Whether additions are currently being accumulated.
+    bool isActive() const {
+        return mIsActive;
+    }
+
+    /*!
+     * \brief Get the buffer index of a market quantity.
+     * \param aSerialNumber The serial number of the market.
+     * \param aQuantity The quantity.
+     * \return The buffer index.
+     */
+    static int getKey( const int aSerialNumber, const Quantity aQuantity ) {
+        return 2 * ( aSerialNumber - 1 ) + aQuantity;
+    }
+
+    void setCurrentOrder( const int aOrder );
+
+    bool add( const int aKey, const double aValue );
+
+    double getTotal( const int aKey, const double aBase ) const;
+
+private:
+    //! A single addition to a market quantity.
+    struct Record {
+        Record( const int aOrder, const double aValue ):mOrder( aOrder ), mValue( aValue ) {}
+
+        //! The index in the global ordering of the activity which made the addition.
+        int mOrder;
+
+        //! The amount added.
+        double mValue;
+
+        //! Sort by the global ordering.
+        bool operator<( const Record& aOther ) const {
+            return mOrder < aOther.mOrder;
+        }
+    };
+
+    //! The states of a cached total.
+    enum CacheState {
+        //! The total must be reduced from the buffers.
+        INVALID = 0,
+
+        //! A thread is storing the total it reduced.
+        STORING = 1,
+
+        //! The total may be used.
+        VALID = 2
+    };
+
+    //! The last total reduced for a market quantity.
+    struct CachedTotal {
+        CachedTotal():mState( INVALID ), mBase( 0 ), mTotal( 0 ) {}
+
+        //! The CacheState of the total.
+        std::atomic<int> mState;
+
+        //! The value before accumulation the total was reduced onto.
+        double mBase;
+
+        //! The total.
+        double mTotal;
+    };
+
+    //! The additions made by a single thread.
+    struct ThreadBuffer {
+        //! The index in the global ordering of the activity the thread is calculating.
+        int mCurrentOrder;
+
+        //! The additions by market quantity key in the order they were made.
+        std::vector<std::vector<Record> > mRecords;
+
+        //! The keys which have at least one addition.
+        std::vector<int> mTouched;
+    };
+
+    /*!
+     * \brief A helper functor to assign one of mBuffers to each thread the first
+     *        time it accesses mThreadBuffer.
+     */
+    struct AssignBufferFun {
+        AssignBufferFun( MarketAccumulator* aParent ):mParent( aParent ) {}
+
+        ThreadBuffer* operator()() const;
+
+        //! The accumulator which owns the buffers.
+        MarketAccumulator* mParent;
+    };
+
+    size_t getNumBuffersUsed() const;
+
+    //! Whether additions are currently being accumulated.
+    bool mIsActive;
+
+    //! The market in each period indexed by serial number less one.
+    std::vector<Market*> mMarkets;
+
+    //! The buffers which may be assigned to threads.  This is only resized when
+    //! not active so that buffers may be read while other threads are adding.
+    std::vector<ThreadBuffer> mBuffers;
+
+    //! The number of buffers which have been assigned to threads.
+    std::atomic<size_t> mNumAssigned;
+
+    //! The buffer assigned to each thread.
+    tbb::enumerable_thread_specific<ThreadBuffer*> mThreadBuffer;
+
+    //! The cached total of each market quantity by key.
+    mutable std::unique_ptr<CachedTotal[]> mCachedTotals;
+
+    //! The number of entries in mCachedTotals.
+    size_t mNumCachedTotals;
+};
+
+#endif // GCAM_PARALLEL_ENABLED
+
+#endif // _MARKET_ACCUMULATOR_H_
@@ -55,6 +55,7 @@
 #include "util/base/include/data_definition_util.h"
 
 class Market;
+class PriceForecaster;
 namespace objects {
     class Atom;
 }
@@ -104,8 +105,9 @@ public:
 
     typedef double (Market::*getpsd_t)() const; // Can point to Market::getPrice, Market::getRawPrice, Market::getRawDemand, etc.
     double forecastDemand( const int aPeriod );
-    double forecastPrice( const int aPeriod );
-    double extrapolate( const int aPeriod, getpsd_t aDataFn );
+    double forecastPrice( const int aPeriod, const PriceForecaster& aForecaster );
+    double extrapolate( const int aPeriod, getpsd_t aDataFn ) const;
+    double getHistory( const int aPeriod, getpsd_t aDataFn, double aYears[ 3 ], double aValues[ 3 ] ) const;
 protected:
     
     DEFINE_DATA(
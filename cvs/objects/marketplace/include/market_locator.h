@@ -46,9 +46,10 @@
 */
 
 #include <string>
-#include <memory>
-#include <boost/shared_ptr.hpp>
-template <class T, class U> class HashMap;
+#include "util/base/include/hash_map.h"
+namespace objects {
+    class Atom;
+}
 
 #include <boost/functional/hash/hash.hpp>
 
@@ -76,6 +77,10 @@ template <class T, class U> class HashMap;
 *          containing a list of sectors and their market numbers. This is the
 *          list which is used to determine a market number from a region name
 *          and good name throughout the model run.
+*
+*          The market number of each region and good is also stored keyed on
+*          the Atoms of their names, so that callers which have interned the
+*          names can locate a market by comparing pointers rather than strings.
 * \author Josh Lurz
 */
 class MarketLocator
@@ -86,6 +91,7 @@ public:
     int addMarket( const std::string& aMarket, const std::string& aRegion, const std::string& aGoodName,
         const int aUniqueNumber );
     int getMarketNumber( const std::string& aRegion, const std::string& aGoodName ) const;
+    int getMarketNumber( const objects::Atom* aRegion, const objects::Atom* aGoodName ) const;
 
     //! An identifier returned by the various functions if the market does not
     //! exist.
@@ -93,44 +99,63 @@ public:
 private:
     int getMarketNumberInternal( const std::string& aRegion, const std::string& aGoodName ) const;
 
-    /*! \brief A single node in a list of goods which contains the name of the
-    *          good and its market location.
-    */
-    class GoodNode {
-    public:
-        GoodNode( const std::string& aName, int aMarketNumber );
-
-        //! The good name.
-        const std::string mName;
-
-        //! The market number.
-        const int mNumber;
-    };
-
     /*! \brief A single node in a list of Regions or Markets which contains the
     *          name of the Region or Market and a list of good names and market
     *          locations. 
+    * \details Nodes are stored by value in the region and market lists, which
+    *          keep their entries in place, so a pointer to a node stays valid
+    *          as more are added.
     */
     class RegionOrMarketNode {
     public:
         RegionOrMarketNode( const std::string& aName );
-        ~RegionOrMarketNode();
         inline const std::string& getName() const;
         int addGood( const std::string& aGoodName, const int aMarketNumber );
         int getMarketNumber( const std::string& aGoodName ) const;
     private:
-        //! The type of the list that contains the goods.
-        typedef HashMap<std::string, boost::shared_ptr<GoodNode> > SectorNodeList;
+        //! The type of the list that contains the market number of each good.
+        typedef HashMap<std::string, int> SectorNodeList;
 
         //! A list of sectors contained by this market or region.
-        std::auto_ptr<SectorNodeList> mSectorNodeList;
+        SectorNodeList mSectorNodeList;
         
         //! The region or market area name.
-        const std::string mName;
+        std::string mName;
+    };
+
+    /*! \brief The key of a region and good Atom pair, which is hashed and
+    *          compared by the Atom pointers.
+    */
+    struct AtomPair {
+        AtomPair( const objects::Atom* aRegion, const objects::Atom* aGood ):
+        mRegion( aRegion ), mGood( aGood ){}
+
+        bool operator==( const AtomPair& aOther ) const {
+            return mRegion == aOther.mRegion && mGood == aOther.mGood;
+        }
+
+        size_t getHash() const;
+
+        //! Hook for boost::hash, which the HashMap uses for the key.
+        friend size_t hash_value( const AtomPair& aPair ) {
+            return aPair.getHash();
+        }
+
+        //! The region Atom.
+        const objects::Atom* mRegion;
+
+        //! The good Atom.
+        const objects::Atom* mGood;
     };
 
+    //! The type of the list of market numbers by region and good Atoms.
+    typedef HashMap<AtomPair, int> AtomMarketList;
+
+    //! The market number of each region and good pair.
+    AtomMarketList mAtomMarketList;
+
     //! The type of the lists of regions or markets.
-    typedef HashMap<std::string, boost::shared_ptr<RegionOrMarketNode> > RegionMarketList;
+    typedef HashMap<std::string, RegionOrMarketNode> RegionMarketList;
 
     //! A pointer to the last region looked up.
 #if GCAM_PARALLEL_ENABLED
@@ -141,11 +166,11 @@ private:
 
     //! A list of market areas each containing a list of sectors contained by
     //! the market.
-    std::auto_ptr<RegionMarketList> mMarketList;
+    RegionMarketList mMarketList;
 
     //! A list of regions each containing a list of of sectors contained by the
     //! region.
-    std::auto_ptr<RegionMarketList> mRegionList;
+    RegionMarketList mRegionList;
 };
 
 // Inline definitions.
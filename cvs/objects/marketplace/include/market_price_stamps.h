@@ -0,0 +1,145 @@
+#ifndef _MARKET_PRICE_STAMPS_H_
+#define _MARKET_PRICE_STAMPS_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file market_price_stamps.h
+ * \ingroup Objects
+ * \brief The MarketPriceStamps class header file.
+ */
+
+#include <vector>
+#include <utility>
+#include <boost/core/noncopyable.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+class Market;
+
+/*!
+ * \ingroup Objects
+ * \brief A value calculated from market prices along with the prices that were
+ *        read to calculate it.
+ * \details Objects which calculate a value from market prices every iteration,
+ *          such as a technology cost, can keep the result here to skip the
+ *          calculation when none of the prices it read have changed since, as
+ *          happens for most objects while the solver calculates the partial
+ *          derivatives of unrelated markets.  The prices are recorded by
+ *          creating a Recorder around the calculation, during which every price
+ *          returned by Marketplace::getPrice or CachedMarket::getPrice on the
+ *          calling thread is noted along with its market.
+ *
+ *          The recorded price of a market serves as its stamp: the market price
+ *          is held in the active state, which may be copied, reset or restored
+ *          at any time, so a separate version number would have to be kept in
+ *          the state as well and read at the same cost as the price itself.
+ *
+ *          Only values which depend on nothing else that changes during the
+ *          iterations of a period may be kept.  Callers should clear the stamps
+ *          when a new period is initialized.
+ *
+ *          Copies of a MarketPriceStamps are empty, and when parallel
+ *          computation is enabled a thread which finds the stamps in use by
+ *          another thread simply calculates the value again.
+ */
+class MarketPriceStamps {
+public:
+    /*!
+     * \brief Records the market prices read by the calling thread while it is
+     *        in scope.
+     * \details Recorders may be nested, in which case the prices read during
+     *          the inner recorder are also recorded by the outer one.
+     */
+    class Recorder : private boost::noncopyable {
+    public:
+        Recorder();
+        ~Recorder();
+        void store( MarketPriceStamps& aStamps, const int aKey, const double aValue ) const;
+    private:
+        //! The position in the calling thread's recorded reads where this recorder started.
+        size_t mStart;
+    };
+
+    MarketPriceStamps();
+    MarketPriceStamps( const MarketPriceStamps& aOther );
+    MarketPriceStamps& operator=( const MarketPriceStamps& aOther );
+
+    bool getValue( const int aKey, double& aValue ) const;
+
+    void clear();
+
+    /*!
+     * \brief Note a market price which was read by the calling thread.
+     * \param aMarket The market.
+     * \param aPrice The price which was returned.
+     */
+    static void recordRead( const Market* aMarket, const double aPrice ) {
+        if( sNumRecorders > 0 ) {
+            sReads.push_back( Stamp( aMarket, aPrice ) );
+        }
+    }
+
+private:
+    //! A market along with the price read from it.
+    typedef std::pair<const Market*, double> Stamp;
+
+    //! The prices read to calculate mValue.
+    std::vector<Stamp> mStamps;
+
+    //! The key of mValue, such as a period, or -1 if no value is stored.
+    int mKey;
+
+    //! The stored value.
+    double mValue;
+
+#if GCAM_PARALLEL_ENABLED
+    //! A lock to protect the stamps from concurrent use.
+    mutable tbb::spin_mutex mMutex;
+#endif
+
+    //! The number of recorders in scope on the calling thread.
+    static thread_local int sNumRecorders;
+
+    //! The prices read by the calling thread while a recorder is in scope, these
+    //! are kept in a single buffer so that recording does not need to allocate.
+    static thread_local std::vector<Stamp> sReads;
+};
+
+#endif // _MARKET_PRICE_STAMPS_H_
@@ -62,10 +62,15 @@ class IVisitor;
 class IInfo;
 class CachedMarket;
 class MarketDependencyFinder;
+class MarketAccumulator;
+class LinkedMarket;
+class PriceForecaster;
 class Value;
+class ISolutionInfoFilter;
 namespace objects {
     template<typename T>
     class PeriodVector;
+    class Atom;
 }
 
 /*! 
@@ -120,6 +125,10 @@ namespace objects {
  *          the market does not exist. The default value is 0 for supply,
  *          demand, and any info, and NO_MARKET_PRICE for prices.
  *
+ *          The functions most often called during World::calc are also
+ *          available taking the Atoms of the good and region names, which
+ *          locate the market without hashing or comparing the names.
+ *
  * \author Sonny Kim
  * \todo ( re )storeInfo, init_to_last and initPrices should be removed.
  * \todo setPriceVector should be removed, it can be easily implemented using
@@ -137,8 +146,12 @@ class Marketplace: public IVisitable, private boost::noncopyable
     friend class SolverLibrary;
     friend class MarketDependencyFinder;
     friend class LogEDFun;
-#if DEBUG_STATE
     friend class ManageStateVariables;
+    friend class ActivityProfiler;
+    friend class CalcTrace;
+    friend class CalcTraceReplay;
+    friend class Preconditioner;
+#if DEBUG_STATE
     friend class Value;
 #endif
 public:
@@ -164,6 +177,12 @@ public:
                       const int period, bool aMustExist = true );
     double getPrice( const std::string& goodName, const std::string& regionName, const int period,
                      bool aMustExist = true ) const;
+    void addToSupply( const objects::Atom* aGoodName, const objects::Atom* aRegionName, const Value& aValue,
+                      const int aPeriod, bool aMustExist = true );
+    void addToDemand( const objects::Atom* aGoodName, const objects::Atom* aRegionName, const Value& aValue,
+                      const int aPeriod, bool aMustExist = true );
+    double getPrice( const objects::Atom* aGoodName, const objects::Atom* aRegionName, const int aPeriod,
+                     bool aMustExist = true ) const;
     double getSupply( const std::string& goodName, const std::string& regionName,
         const int period ) const;
     double getDemand( const std::string& goodName, const std::string& regionName,
@@ -181,6 +200,12 @@ public:
 
     IInfo* getMarketInfo( const std::string& aGoodName, const std::string& aRegionName,
                          const int aPeriod, const bool aMustExist );
+
+    const IInfo* getMarketInfo( const objects::Atom* aGoodName, const objects::Atom* aRegionName,
+                                const int aPeriod, const bool aMustExist ) const;
+
+    IInfo* getMarketInfo( const objects::Atom* aGoodName, const objects::Atom* aRegionName,
+                          const int aPeriod, const bool aMustExist );
     
     std::auto_ptr<CachedMarket> locateMarket( const std::string& aGoodName, const std::string& aRegionName,
                                                const int aPeriod ) const;
@@ -193,16 +218,37 @@ public:
     //! The price to return if no market exists.
     const static double NO_MARKET_PRICE;
     
+    void storeForecastReference( const int aPeriod );
+    
+    std::vector<double> getRawPrices( const int aPeriod ) const;
+    
+    bool setSolvedMarketPrices( const int aPeriod, const std::vector<double>& aPrices );
+    
     void store_prices_for_cost_calculation();
     void restore_prices_for_cost_calculation();
     
     MarketDependencyFinder* getDependencyFinder() const;
+    
+    void setSolveRestriction( const ISolutionInfoFilter* aRestriction );
+    
+    const ISolutionInfoFilter* getSolveRestriction() const;
+    
+#if GCAM_PARALLEL_ENABLED
+    MarketAccumulator* getMarketAccumulator() const;
+    
+    void startParallelAccumulation( const int aPeriod );
+    
+    void finishParallelAccumulation();
+#endif
 
     // The methods from here down are diagnostics
     std::vector<double> fullstate( int period ) const; //!< Return all supplies and demands in all markets in a single vector
     bool checkstate(int period, const std::vector<double>&, std::ostream *log=0, unsigned tol=0) const;
     void prnmktbl(int period, std::ostream &out) const;
     void logForecastEvaluation( int aPeriod ) const;
+#if MARKETPLACE_PROFILING
+    void logProfile( const int aPeriod ) const;
+#endif
 protected:
     
     DEFINE_DATA(
@@ -223,8 +269,53 @@ protected:
     //! affected by changing the price of a single market.
     std::auto_ptr<MarketDependencyFinder> mDependencyFinder;
     
+    //! Chooses how to forecast the initial guess for the price in each market.
+    std::auto_ptr<PriceForecaster> mPriceForecaster;
+    
+#if GCAM_PARALLEL_ENABLED
+    //! Collects additions to supplies and demands during a parallel World::calc
+    //! so that they may be made without locking and in a reproducible order.
+    std::auto_ptr<MarketAccumulator> mMarketAccumulator;
+#endif
+    
+    //! The linked markets which have had their chain of links flattened by
+    //! the last call to compileLinkedMarketPlan.
+    std::vector<LinkedMarket*> mLinkedSources;
+    
+    //! The offsets into the contiguous demand and supply blocks, in increasing
+    //! order, of the entries which must not be cleared each iteration since the
+    //! market keeps its constraint in them.
+    std::vector<size_t> mPreservedMarketState;
+    
+    //! The period mPreservedMarketState was found for, or -1 if there is none.
+    int mPreservedStatePeriod;
+    
+    //! A filter which, when set, limits the markets any solver may solve to
+    //! those it accepts.  It is not owned by the marketplace.
+    const ISolutionInfoFilter* mSolveRestriction;
+    
     //! Flag indicating whether the next call to world->calc() will be part of a partial derivative calculation 
     static bool mIsDerivativeCalc;
+    
+    void compileLinkedMarketPlan( const int aPeriod );
+    
+    void findPreservedMarketState( const int aPeriod );
+
+    template<class NameType>
+    void addToSupplyInternal( const NameType& aGoodName, const NameType& aRegionName, const Value& aValue,
+                              const int aPeriod, const bool aMustExist );
+
+    template<class NameType>
+    void addToDemandInternal( const NameType& aGoodName, const NameType& aRegionName, const Value& aValue,
+                              const int aPeriod, const bool aMustExist );
+
+    template<class NameType>
+    double getPriceInternal( const NameType& aGoodName, const NameType& aRegionName, const int aPeriod,
+                             const bool aMustExist ) const;
+
+    template<class NameType>
+    IInfo* getMarketInfoInternal( const NameType& aGoodName, const NameType& aRegionName,
+                                  const int aPeriod, const bool aMustExist ) const;
 };
 
 #endif
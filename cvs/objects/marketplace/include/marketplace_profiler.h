@@ -0,0 +1,172 @@
+#ifndef _MARKETPLACE_PROFILER_H_
+#define _MARKETPLACE_PROFILER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file marketplace_profiler.h
+ * \ingroup Objects
+ * \brief The MarketplaceProfiler class header file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#if MARKETPLACE_PROFILING
+#include <vector>
+#include <map>
+#include <string>
+#include <iosfwd>
+#include <chrono>
+#include <boost/core/noncopyable.hpp>
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/enumerable_thread_specific.h>
+#endif
+
+/*!
+ * \brief Counts and times the Marketplace calls which look up markets by good
+ *        and region so that the markets which dominate the traffic can be found.
+ * \details For each market the number of getPrice, addToSupply and addToDemand
+ *          calls and the time spent in them, including finding the market, are
+ *          recorded.  The MarketLocator additionally records how often its
+ *          cached region missed and which good and region pairs were not found
+ *          at all.  Each thread records into its own counters so the profiler
+ *          does not serialize a parallel World::calc.  The counts are written
+ *          and reset once per period by Marketplace::logProfile.
+ *
+ *          All of this is only compiled when MARKETPLACE_PROFILING is set,
+ *          otherwise this header declares nothing and the call sites are
+ *          compiled out.
+ */
+class MarketplaceProfiler : private boost::noncopyable {
+public:
+    //! The Marketplace calls which are profiled.
+    enum Operation {
+        GET_PRICE,
+        ADD_TO_SUPPLY,
+        ADD_TO_DEMAND,
+        NUM_OPERATIONS
+    };
+    
+    /*!
+     * \brief Times a single Marketplace call for the duration of its scope.
+     * \details The market should be set once it has been found, if it never
+     *          is the call is only counted as a lookup which was not found.
+     */
+    class Scope : private boost::noncopyable {
+    public:
+        explicit Scope( const Operation aOperation ):
+        mOperation( aOperation ),
+        mMarketNumber( -1 ),
+        mStart( std::chrono::steady_clock::now() )
+        {
+        }
+        
+        ~Scope() {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+            MarketplaceProfiler::getInstance().recordCall( mOperation, mMarketNumber, elapsed.count() );
+        }
+        
+        //! Set the number of the market the call was for.
+        void setMarket( const int aMarketNumber ) {
+            mMarketNumber = aMarketNumber;
+        }
+    private:
+        //! The call being timed.
+        const Operation mOperation;
+        
+        //! The number of the market or -1 if it was not found.
+        int mMarketNumber;
+        
+        //! The time the call started.
+        const std::chrono::steady_clock::time_point mStart;
+    };
+    
+    static MarketplaceProfiler& getInstance();
+    
+    void recordCall( const Operation aOperation, const int aMarketNumber, const double aTime );
+    
+    void recordRegionLookup( const bool aWasCached );
+    
+    void recordNotFound( const std::string& aRegion, const std::string& aGoodName );
+    
+    void print( std::ostream& aOut, const int aPeriod, const std::vector<std::string>& aMarketNames ) const;
+    
+    void reset();
+    
+private:
+    MarketplaceProfiler();
+    
+    //! The counters recorded by a single thread.
+    struct Counters {
+        Counters();
+        
+        //! The number of calls by market number and operation.
+        std::vector<unsigned long> mCalls;
+        
+        //! The total time in seconds by market number and operation.
+        std::vector<double> mTimes;
+        
+        //! The number of calls by operation for which no market was found.
+        unsigned long mNotFoundCalls[ NUM_OPERATIONS ];
+        
+        //! The number of region lookups which used the cached region.
+        unsigned long mRegionCacheHits;
+        
+        //! The number of region lookups which had to search the region list.
+        unsigned long mRegionCacheMisses;
+        
+        //! The number of times each "region, good" pair was not found.
+        std::map<std::string, unsigned long> mNotFound;
+    };
+    
+    Counters& getCounters();
+    
+    Counters getTotal() const;
+    
+#if GCAM_PARALLEL_ENABLED
+    //! The counters for each thread.
+    mutable tbb::enumerable_thread_specific<Counters> mCounters;
+#else
+    //! The counters for the single thread.
+    Counters mCounters;
+#endif
+};
+
+#endif // MARKETPLACE_PROFILING
+
+#endif // _MARKETPLACE_PROFILER_H_
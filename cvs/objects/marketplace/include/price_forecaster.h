@@ -0,0 +1,183 @@
+#ifndef _PRICE_FORECASTER_H_
+#define _PRICE_FORECASTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file price_forecaster.h
+ * \ingroup Objects
+ * \brief The PriceForecaster class header file.
+ */
+
+#include <vector>
+#include <map>
+#include <string>
+#include <iosfwd>
+#include <boost/core/noncopyable.hpp>
+
+#include "marketplace/include/imarket_type.h"
+
+class MarketContainer;
+
+/*!
+ * \brief An interface to a method of forecasting the price of a market in a
+ *        period from its history.
+ */
+class IPriceExtrapolator {
+public:
+    virtual ~IPriceExtrapolator() {}
+    
+    //! Get the name of the method for logging.
+    virtual const std::string& getName() const = 0;
+    
+    /*!
+     * \brief Forecast the price of a market.
+     * \param aMarket The market to forecast.
+     * \param aPeriod The period to forecast, which must be greater than zero.
+     * \param aForecast The forecasted price.
+     * \return Whether the method could make a forecast for the market.
+     */
+    virtual bool forecast( const MarketContainer* aMarket, const int aPeriod,
+                           double& aForecast ) const = 0;
+};
+
+/*!
+ * \brief The second order extrapolation of the last three periods that
+ *        MarketContainer::extrapolate does.
+ */
+class CurvatureExtrapolator: public IPriceExtrapolator {
+public:
+    virtual const std::string& getName() const;
+    virtual bool forecast( const MarketContainer* aMarket, const int aPeriod, double& aForecast ) const;
+};
+
+/*!
+ * \brief Extrapolate the trend between the last two periods.
+ */
+class LinearExtrapolator: public IPriceExtrapolator {
+public:
+    virtual const std::string& getName() const;
+    virtual bool forecast( const MarketContainer* aMarket, const int aPeriod, double& aForecast ) const;
+};
+
+/*!
+ * \brief Extrapolate the growth rate between the last two periods.
+ * \details This only applies when both prices are positive.
+ */
+class LogLinearExtrapolator: public IPriceExtrapolator {
+public:
+    virtual const std::string& getName() const;
+    virtual bool forecast( const MarketContainer* aMarket, const int aPeriod, double& aForecast ) const;
+};
+
+/*!
+ * \brief Use the price the market solved to in the same period of a previous
+ *        scenario run in this process.
+ * \details This is useful when the same scenario is run repeatedly with small
+ *          changes, for instance by a policy target finder or a batch run.
+ *          It only applies to markets which existed in the previous run.
+ * \see PriceForecaster::storeReferencePrices
+ */
+class ReferenceExtrapolator: public IPriceExtrapolator {
+public:
+    virtual const std::string& getName() const;
+    virtual bool forecast( const MarketContainer* aMarket, const int aPeriod, double& aForecast ) const;
+};
+
+/*!
+ * \brief Forecasts the initial guess for the price of each market in a period.
+ * \details A number of extrapolation methods are available.  At the start of
+ *          each period every method is used to forecast the price the markets
+ *          solved to in the previous period, from the history before it, and
+ *          the error is accumulated by market type.  The forecast for a market
+ *          then uses the method with the least mean error for its type so far,
+ *          falling back to the curvature corrected extrapolation when there is
+ *          no history or the best method does not apply to the market.  Only
+ *          solved markets count towards the errors.
+ *
+ *          The errors are kept for each period so that a period which is
+ *          calculated again after later periods have run, for instance when
+ *          a policy target finder resumes its trials from the period before
+ *          the policy starts, forecasts from exactly the history a run of all
+ *          periods would have had.
+ *
+ *          The reference scenario method is only used when the configuration
+ *          flag forecastFromReference is set.
+ */
+class PriceForecaster : private boost::noncopyable {
+public:
+    PriceForecaster();
+    ~PriceForecaster();
+    
+    void updateErrors( const std::vector<MarketContainer*>& aMarkets, const int aPeriod );
+    
+    double forecastPrice( const MarketContainer* aMarket, const int aPeriod ) const;
+    
+    void print( std::ostream& aOut ) const;
+    
+    static void storeReferencePrices( const std::vector<MarketContainer*>& aMarkets, const int aPeriod );
+    
+    static bool getReferencePrice( const std::string& aMarketName, const int aPeriod, double& aPrice );
+    
+private:
+    //! The available methods, the first is the default.
+    std::vector<IPriceExtrapolator*> mExtrapolators;
+    
+    //! Whether the reference scenario method may be used.
+    bool mUseReference;
+    
+    //! The sum of the relative forecast errors by market type and method.
+    std::vector<std::vector<double> > mErrorSums;
+    
+    //! The number of forecasts in mErrorSums by market type and method.
+    std::vector<std::vector<int> > mErrorCounts;
+    
+    //! The error sums as they were after the update for each period.
+    std::vector<std::vector<std::vector<double> > > mPeriodErrorSums;
+    
+    //! The error counts as they were after the update for each period.
+    std::vector<std::vector<std::vector<int> > > mPeriodErrorCounts;
+    
+    size_t getBestMethod( const IMarketType::Type aType ) const;
+    
+    bool isMethodAvailable( const size_t aMethod ) const;
+    
+    static std::map<std::string, std::vector<double> >& getPricesFromRun( const bool aIsReference );
+};
+
+#endif // _PRICE_FORECASTER_H_
@@ -42,6 +42,7 @@
 #include "marketplace/include/cached_market.h"
 
 #include "marketplace/include/market.h"
+#include "marketplace/include/market_price_stamps.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/util.h"
 #include "marketplace/include/marketplace.h"
@@ -65,8 +66,8 @@ CachedMarket::CachedMarket( const string& aGoodName, const string& aRegionName,
 #ifndef NDEBUG
 mGoodName( aGoodName ),
 mRegionName( aRegionName ),
-mPeriod( aPeriod ),
 #endif
+mPeriod( aPeriod ),
 mCachedMarket( aLocatedMarket )
 {
 }
@@ -248,7 +249,9 @@ double CachedMarket::getPrice( const string& aGoodName, const string& aRegionNam
     assert( aPeriod == mPeriod );
     
     if( mCachedMarket ) {
-        return mCachedMarket->getPrice();
+        const double price = mCachedMarket->getPrice();
+        MarketPriceStamps::recordRead( mCachedMarket, price );
+        return price;
     }
     
     if( aMustExist ) {
@@ -49,7 +49,10 @@ using namespace std;
 ///! Constructor
 LinkedMarket::LinkedMarket( Market* aLinkedMarket, const MarketContainer* aContainer ):
 Market( aContainer ),
-mLinkedMarket( aLinkedMarket )
+mLinkedMarket( aLinkedMarket ),
+mRootMarket( 0 ),
+mRootPriceMult( 1.0 ),
+mIsPlanned( false )
 {
     mPriceMult = 1.0;
     mQuantityMult = 1.0;
@@ -57,6 +60,10 @@ mLinkedMarket( aLinkedMarket )
 
 void LinkedMarket::resetLinkedMarket( Market* aLinkedMarket ) {
     mLinkedMarket = aLinkedMarket;
+    // The chain of links has changed and must be found again.
+    mRootMarket = 0;
+    mTransfers.clear();
+    mIsPlanned = false;
 }
 
 void LinkedMarket::toDebugXMLDerived( ostream& out, Tabs* tabs ) const {
@@ -91,6 +98,11 @@ void LinkedMarket::set_price_to_last( const double aLastPrice ) {
 }
 
 double LinkedMarket::getPrice() const {
+    // Avoid walking the chain of links when the Marketplace has already found
+    // the market which sets the price.
+    if( mRootMarket ) {
+        return mRootMarket->getPrice() * mRootPriceMult;
+    }
     return mLinkedMarket ? mLinkedMarket->getPrice() * mPriceMult
         : Marketplace::NO_MARKET_PRICE;
 }
@@ -105,7 +117,20 @@ double LinkedMarket::getDemand() const {
 
 void LinkedMarket::addToDemand( const double aDemand ) {
     Market::addToDemand( aDemand );
-    if( mLinkedMarket ) {
+    if( mIsPlanned ) {
+        // Add directly to every market down the chain of links.  A linked
+        // target must not forward the addition itself as it is already
+        // included in the transfers.
+        for( const auto& transfer : mTransfers ) {
+            if( transfer.mIsTargetLinked ) {
+                transfer.mTarget->Market::addToDemand( aDemand * transfer.mQuantityMult );
+            }
+            else {
+                transfer.mTarget->addToDemand( aDemand * transfer.mQuantityMult );
+            }
+        }
+    }
+    else if( mLinkedMarket ) {
         mLinkedMarket->addToDemand( aDemand * mQuantityMult );
     }
 }
@@ -120,7 +145,20 @@ double LinkedMarket::getSupply() const {
 
 void LinkedMarket::addToSupply( const double aSupply ) {
     Market::addToSupply( aSupply );
-    if( mLinkedMarket ) {
+    if( mIsPlanned ) {
+        // Add directly to every market down the chain of links.  A linked
+        // target must not forward the addition itself as it is already
+        // included in the transfers.
+        for( const auto& transfer : mTransfers ) {
+            if( transfer.mIsTargetLinked ) {
+                transfer.mTarget->Market::addToSupply( aSupply * transfer.mQuantityMult );
+            }
+            else {
+                transfer.mTarget->addToSupply( aSupply * transfer.mQuantityMult );
+            }
+        }
+    }
+    else if( mLinkedMarket ) {
         mLinkedMarket->addToSupply( aSupply * mQuantityMult );
     }
 }
@@ -328,8 +328,7 @@ void Market::nullDemand() {
 void Market::addToDemand( const double demandIn ) {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock writeLock( mDemandMutex, true );
-        mDemand += demandIn;
+        addParallel( mDemand, demandIn, MarketAccumulator::DEMAND, mDemandMutex );
     }
     else {
         mDemand += demandIn;
@@ -349,8 +348,7 @@ void Market::addToDemand( const double demandIn ) {
 double Market::getRawDemand() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
+        return getParallelTotal( mDemand, MarketAccumulator::DEMAND, mDemandMutex );
     }
     else {
         return mDemand;
@@ -370,8 +368,7 @@ double Market::getRawDemand() const {
 double Market::getSolverDemand() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
+        return getParallelTotal( mDemand, MarketAccumulator::DEMAND, mDemandMutex );
     }
     else {
         return mDemand;
@@ -388,8 +385,7 @@ double Market::getSolverDemand() const {
 double Market::getDemand() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
+        return getParallelTotal( mDemand, MarketAccumulator::DEMAND, mDemandMutex );
     }
     else {
         return mDemand;
@@ -416,8 +412,7 @@ void Market::nullSupply() {
 double Market::getRawSupply() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
+        return getParallelTotal( mSupply, MarketAccumulator::SUPPLY, mSupplyMutex );
     }
     else {
         return mSupply;
@@ -438,8 +433,7 @@ double Market::getRawSupply() const {
 double Market::getSolverSupply() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
+        return getParallelTotal( mSupply, MarketAccumulator::SUPPLY, mSupplyMutex );
     }
     else {
         return mSupply;
@@ -456,8 +450,7 @@ double Market::getSolverSupply() const {
 double Market::getSupply() const {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
+        return getParallelTotal( mSupply, MarketAccumulator::SUPPLY, mSupplyMutex );
     }
     else {
         return mSupply;
@@ -476,8 +469,7 @@ double Market::getSupply() const {
 void Market::addToSupply( const double supplyIn ) {
 #if GCAM_PARALLEL_ENABLED
     if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock writeLock( mSupplyMutex, true );
-        mSupply += supplyIn;
+        addParallel( mSupply, supplyIn, MarketAccumulator::SUPPLY, mSupplyMutex );
     }
     else {
         mSupply += supplyIn;
@@ -487,6 +479,50 @@ void Market::addToSupply( const double supplyIn ) {
 #endif
 }
 
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief Get the value of a supply or demand during a parallel calculation.
+ * \details When the marketplace is accumulating additions in parallel the value
+ *          is the stored value plus the additions so far, otherwise it is simply
+ *          the stored value.
+ * \param aValue The stored supply or demand.
+ * \param aQuantity Which quantity aValue is.
+ * \param aMutex The lock protecting aValue.
+ * \return The current value of the supply or demand.
+ */
+double Market::getParallelTotal( const Value& aValue, const MarketAccumulator::Quantity aQuantity,
+                                 Mutex& aMutex ) const
+{
+    Mutex::scoped_lock readLock( aMutex, false );
+    const MarketAccumulator* accumulator = scenario->getMarketplace()->getMarketAccumulator();
+    return accumulator->isActive() ?
+        accumulator->getTotal( MarketAccumulator::getKey( mContainer->getSerialNumber(), aQuantity ), aValue ) :
+        aValue.get();
+}
+
+/*!
+ * \brief Add to a supply or demand during a parallel calculation.
+ * \details When the marketplace is accumulating additions in parallel the
+ *          addition is recorded by the accumulator without locking, otherwise it
+ *          is added to the stored value under the lock.
+ * \param aValue The stored supply or demand.
+ * \param aAddition The amount to add.
+ * \param aQuantity Which quantity aValue is.
+ * \param aMutex The lock protecting aValue.
+ */
+void Market::addParallel( Value& aValue, const double aAddition,
+                          const MarketAccumulator::Quantity aQuantity, Mutex& aMutex )
+{
+    MarketAccumulator* accumulator = scenario->getMarketplace()->getMarketAccumulator();
+    if( !accumulator->isActive() ||
+        !accumulator->add( MarketAccumulator::getKey( mContainer->getSerialNumber(), aQuantity ), aAddition ) )
+    {
+        Mutex::scoped_lock writeLock( aMutex, true );
+        aValue += aAddition;
+    }
+}
+#endif
+
 /*! \brief Return the market name.
  * \details This function returns the name of the market, as defined by region
  *          name plus good name.
@@ -601,6 +637,20 @@ bool Market::shouldSolveNR() const {
     return mSolveMarket && ( getRawSupply() != 0.0 || getRawDemand() >= util::getVerySmallNumber() );
 }
 
+/*! \brief Determine if changing the solver price between two values is invisible
+*          to the model.
+* \details This is a derivative hint for the solver.  When it returns true the
+*          model sees the same price at both values so none of the supplies or
+*          demands depend on a change between them and the solver may skip the
+*          corresponding model evaluation.  The default is to make no claim.
+* \param aPrice The current solver price.
+* \param aNewPrice The perturbed solver price.
+* \return Whether the model would see no change in price.
+*/
+bool Market::isPriceChangeHidden( const double aPrice, const double aNewPrice ) const {
+    return false;
+}
+
 /*! \brief Return whether a market is solved according to market type specific
 *          conditions.
 * \return Whether the market meets special solution criteria.
@@ -142,6 +142,20 @@ double MarketRES::getPrice() const {
     return std::max( Market::getPrice(), mMinPrice );
 }
 
+/*!
+ * \brief Determine if changing the solver price between two values is invisible
+ *        to the model.
+ * \details Since getPrice caps the price at mMinPrice any change that stays at
+ *          or below that bound, i.e. while the constraint is non-binding, can not
+ *          affect any supply or demand.
+ * \param aPrice The current solver price.
+ * \param aNewPrice The perturbed solver price.
+ * \return Whether the model would see no change in price.
+ */
+bool MarketRES::isPriceChangeHidden( const double aPrice, const double aNewPrice ) const {
+    return aPrice <= mMinPrice && aNewPrice <= mMinPrice;
+}
+
 void MarketRES::addToDemand( const double demandIn ) {
     Market::addToDemand( demandIn );
 }
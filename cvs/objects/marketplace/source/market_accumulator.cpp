@@ -0,0 +1,256 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file market_accumulator.cpp
+ * \ingroup Objects
+ * \brief MarketAccumulator class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <algorithm>
+#include <cassert>
+#include <tbb/task_arena.h>
+
+#include "marketplace/include/market_accumulator.h"
+#include "marketplace/include/market.h"
+#include "marketplace/include/market_container.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+//! Constructor
+MarketAccumulator::MarketAccumulator():
+mIsActive( false ),
+mNumAssigned( 0 ),
+mThreadBuffer( AssignBufferFun( this ) ),
+mNumCachedTotals( 0 )
+{
+}
+
+//! Destructor
+MarketAccumulator::~MarketAccumulator() {
+}
+
+/*!
+ * \brief Assign the next unused buffer to the calling thread.
+ * \return The buffer, or null if all of the buffers have been assigned.
+ */
+MarketAccumulator::ThreadBuffer* MarketAccumulator::AssignBufferFun::operator()() const {
+    const size_t bufferIndex = mParent->mNumAssigned++;
+    if( bufferIndex >= mParent->mBuffers.size() ) {
+        return 0;
+    }
+    ThreadBuffer* buffer = &mParent->mBuffers[ bufferIndex ];
+    buffer->mCurrentOrder = -1;
+    return buffer;
+}
+
+/*!
+ * \brief Begin accumulating additions to the markets for a period.
+ * \details This must be called before the parallel calculation begins.  The
+ *          markets must have been assigned serial numbers for the period, if
+ *          not accumulation is not started and the markets will be locked as
+ *          usual.
+ * \param aMarkets All of the markets in the marketplace.
+ * \param aPeriod The period being calculated.
+ * \return Whether accumulation was started.
+ */
+bool MarketAccumulator::start( const vector<MarketContainer*>& aMarkets, const int aPeriod ) {
+    assert( !mIsActive );
+
+    const size_t numMarkets = aMarkets.size();
+    mMarkets.assign( numMarkets, 0 );
+    for( auto marketContainer : aMarkets ) {
+        const int serialNumber = marketContainer->getSerialNumber();
+        if( serialNumber < 1 || serialNumber > static_cast<int>( numMarkets ) ||
+            mMarkets[ serialNumber - 1 ] )
+        {
+            return false;
+        }
+        mMarkets[ serialNumber - 1 ] = marketContainer->getMarket( aPeriod );
+    }
+
+    // Make sure there is a buffer for every thread which may participate.
+    const size_t numBuffers = max( mBuffers.size(),
+                                   static_cast<size_t>( tbb::this_task_arena::max_concurrency() + 1 ) );
+    mBuffers.resize( numBuffers );
+    for( auto& buffer : mBuffers ) {
+        buffer.mRecords.resize( 2 * numMarkets );
+    }
+    if( mNumCachedTotals != 2 * numMarkets ) {
+        mNumCachedTotals = 2 * numMarkets;
+        mCachedTotals.reset( new CachedTotal[ mNumCachedTotals ] );
+    }
+    for( size_t key = 0; key < mNumCachedTotals; ++key ) {
+        mCachedTotals[ key ].mState.store( INVALID, memory_order_relaxed );
+    }
+
+    // Reassign buffers to threads.
+    mThreadBuffer.clear();
+    mNumAssigned = 0;
+
+    mIsActive = true;
+    return true;
+}
+
+/*!
+ * \brief Stop accumulating and set the totals in the markets.
+ * \details This must be called after the parallel calculation has completed.
+ */
+void MarketAccumulator::finish() {
+    assert( mIsActive );
+    mIsActive = false;
+
+    const size_t numUsed = getNumBuffersUsed();
+    if( mNumAssigned > mBuffers.size() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        mainLog << "More threads than market accumulation buffers, market additions"
+                << " from " << ( mNumAssigned - mBuffers.size() ) << " threads were locked." << endl;
+    }
+
+    // Set the total of each market quantity which was added to.  The totals must
+    // all be taken before any of the buffers are cleared.
+    vector<bool> isReduced( 2 * mMarkets.size(), false );
+    for( size_t bufferIndex = 0; bufferIndex < numUsed; ++bufferIndex ) {
+        for( auto key : mBuffers[ bufferIndex ].mTouched ) {
+            if( !isReduced[ key ] ) {
+                isReduced[ key ] = true;
+                Market* market = mMarkets[ key / 2 ];
+                Value& quantity = key % 2 == DEMAND ? market->mDemand : market->mSupply;
+                quantity = getTotal( key, quantity );
+            }
+        }
+    }
+    for( size_t bufferIndex = 0; bufferIndex < numUsed; ++bufferIndex ) {
+        ThreadBuffer& buffer = mBuffers[ bufferIndex ];
+        for( auto key : buffer.mTouched ) {
+            buffer.mRecords[ key ].clear();
+        }
+        buffer.mTouched.clear();
+    }
+}
+
+/*!
+ * \brief Set the activity the calling thread is about to calculate.
+ * \param aOrder The index of the activity in the global ordering.
+ */
+void MarketAccumulator::setCurrentOrder( const int aOrder ) {
+    ThreadBuffer* buffer = mThreadBuffer.local();
+    if( buffer ) {
+        buffer->mCurrentOrder = aOrder;
+    }
+}
+
+/*!
+ * \brief Add to a market quantity in the calling thread's buffer.
+ * \param aKey The buffer index of the market quantity.
+ * \param aValue The amount to add.
+ * \return True if the addition was recorded, false if the calling thread has
+ *         no buffer and the caller must add to the market directly.
+ * \see getKey
+ */
+bool MarketAccumulator::add( const int aKey, const double aValue ) {
+    ThreadBuffer* buffer = mThreadBuffer.local();
+    if( !buffer ) {
+        return false;
+    }
+    vector<Record>& records = buffer->mRecords[ aKey ];
+    if( records.empty() ) {
+        buffer->mTouched.push_back( aKey );
+    }
+    records.push_back( Record( buffer->mCurrentOrder, aValue ) );
+    // Only write to the shared cache if the total was read, which is rare
+    // while additions are still being made.
+    atomic<int>& cacheState = mCachedTotals[ aKey ].mState;
+    if( cacheState.load( memory_order_relaxed ) != INVALID ) {
+        cacheState.store( INVALID, memory_order_release );
+    }
+    return true;
+}
+
+/*!
+ * \brief Get the total of a market quantity including the additions so far.
+ * \details The additions from all threads are summed onto aBase in the order of
+ *          the activities which made them.  Additions by the same activity are
+ *          all in one buffer in the order they were made, so a stable sort
+ *          leaves them in that order.  The total is cached until the next
+ *          addition to the quantity.  Since all of the additions to a market
+ *          are made before it is read no addition to aKey may be made while
+ *          it is being read.
+ * \param aKey The buffer index of the market quantity.
+ * \param aBase The value of the market quantity before accumulation began.
+ * \return The total.
+ */
+double MarketAccumulator::getTotal( const int aKey, const double aBase ) const {
+    CachedTotal& cache = mCachedTotals[ aKey ];
+    if( cache.mState.load( memory_order_acquire ) == VALID && cache.mBase == aBase ) {
+        return cache.mTotal;
+    }
+
+    const size_t numUsed = getNumBuffersUsed();
+    vector<Record> records;
+    for( size_t bufferIndex = 0; bufferIndex < numUsed; ++bufferIndex ) {
+        const vector<Record>& currRecords = mBuffers[ bufferIndex ].mRecords[ aKey ];
+        records.insert( records.end(), currRecords.begin(), currRecords.end() );
+    }
+    if( !is_sorted( records.begin(), records.end() ) ) {
+        stable_sort( records.begin(), records.end() );
+    }
+
+    double total = aBase;
+    for( auto record : records ) {
+        total += record.mValue;
+    }
+
+    // Only one of the threads reading an invalid total stores it.  The base
+    // only changes if a thread without a buffer added to the market directly,
+    // in which case the total is not cached again until the next addition.
+    int expected = INVALID;
+    if( cache.mState.compare_exchange_strong( expected, STORING, memory_order_acquire ) ) {
+        cache.mBase = aBase;
+        cache.mTotal = total;
+        cache.mState.store( VALID, memory_order_release );
+    }
+    return total;
+}
+
+//! The number of buffers which have been assigned to threads.
+size_t MarketAccumulator::getNumBuffersUsed() const {
+    return min( mNumAssigned.load(), mBuffers.size() );
+}
+
+#endif // GCAM_PARALLEL_ENABLED
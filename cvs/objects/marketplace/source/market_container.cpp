@@ -42,6 +42,7 @@
 #include <cassert>
 
 #include "marketplace/include/market_container.h"
+#include "marketplace/include/price_forecaster.h"
 #include "util/base/include/model_time.h"
 #include "util/base/include/util.h"
 #include "containers/include/scenario.h"
@@ -265,19 +266,9 @@ void MarketContainer::resetToPriceMarket( MarketContainer* aDemandMarkets ) {
  * \param aRegion The name of the region to add.
  */
 void MarketContainer::addRegion( const string& aRegion ) {
-    // Convert the string to an atom.
-    const Atom* regionID = AtomRegistry::getInstance()->findAtom( aRegion );
-    
-    // Could be the first request for this name.  Note the atom registry will
-    // manage this memory.
-    if( !regionID ) {
-        regionID = new Atom( aRegion );
-    }
-    
-    /*! \invariant The ID of the found atom is the same as the name of the
-     *              region, this ensures the lookup was correct.
-     */
-    assert( regionID->getID() == aRegion );
+    // Convert the string to an atom, which could be the first request for
+    // this name.
+    const Atom* regionID = AtomRegistry::getInstance()->getAtom( aRegion );
     
     // Check if the region ID does not already exist in the list.
     if( find( mContainedRegions.begin(), mContainedRegions.end(), regionID ) == mContainedRegions.end() ) {
@@ -337,18 +328,16 @@ int MarketContainer::size() const {
  * \details Rather than setting the initial guess for a period to the
  *          last period value (which is almost certainly wrong for
  *          some markets), we extrapolate using the price history.
- *          Right now we use a crude extrapolation, but in the future
- *          we might adopt something more sophisticated.  To support
- *          that possibility, we record the forecast for the period,
- *          as future forecasting methods might try to estimate
- *          forecast bias or otherwise use the forecast history in
- *          addition to the price history.
+ *          The PriceForecaster chooses the extrapolation method based
+ *          on how well each has forecast markets of the same type.
+ *          We record the forecast for the period so that it may be
+ *          compared against the solved price.
  * \param aPeriod period for which to forecast
+ * \param aForecaster The forecaster which chooses the method.
  */
-double MarketContainer::forecastPrice( const int aPeriod )
+double MarketContainer::forecastPrice( const int aPeriod, const PriceForecaster& aForecaster )
 {
-    
-    double forecastedPrice = extrapolate( aPeriod, &Market::getRawPrice );
+    double forecastedPrice = aForecaster.forecastPrice( this, aPeriod );
     mMarkets[ aPeriod ]->setForecastPrice( forecastedPrice );
     
     return forecastedPrice;
@@ -386,17 +375,25 @@ double MarketContainer::forecastDemand( const int aPeriod )
 }
 
 /*!
- * \brief extrapolate some arbitrary value  using the last three values from the
- *        previous model periods.
- * \param aPeriod The current model period to extrapolate to.
+ * \brief Get the last three values of some arbitrary value from the periods
+ *        before a model period.
+ * \details Where there are fewer than three previous periods the earliest
+ *          value is repeated one year apart.  Values which are zero in a
+ *          period before the last are replaced by the value in the following
+ *          period.
+ * \param aPeriod The model period to get the history before, which must be
+ *        greater than zero.
  * \param aDataFn A function pointer which will be used to look up the actual data
- *                value that we are extrapolating.
- * \return The extrapolated data point for aPeriod.
+ *                value.
+ * \param aYears The year of each value, oldest first.
+ * \param aValues The values, oldest first.
+ * \return The year of aPeriod.
  */
-double MarketContainer::extrapolate( const int aPeriod, getpsd_t aDataFn )
+double MarketContainer::getHistory( const int aPeriod, getpsd_t aDataFn, double aYears[ 3 ],
+                                    double aValues[ 3 ] ) const
 {
-    // for now, just do a simple extrapolation using the last 3 points
-    double x[ 3 ],y[ 3 ];
+    double* x = aYears;
+    double* y = aValues;
     const Modeltime* modeltime = Modeltime::getInstance();
     
     
@@ -429,12 +426,28 @@ double MarketContainer::extrapolate( const int aPeriod, getpsd_t aDataFn )
         }
     }
     
+    return modeltime->getper_to_yr( aPeriod );
+}
+
+/*!
+ * \brief extrapolate some arbitrary value  using the last three values from the
+ *        previous model periods.
+ * \param aPeriod The current model period to extrapolate to.
+ * \param aDataFn A function pointer which will be used to look up the actual data
+ *                value that we are extrapolating.
+ * \return The extrapolated data point for aPeriod.
+ */
+double MarketContainer::extrapolate( const int aPeriod, getpsd_t aDataFn ) const
+{
+    // for now, just do a simple extrapolation using the last 3 points
+    double x[ 3 ],y[ 3 ];
+    const double currYear = getHistory( aPeriod, aDataFn, x, y );
+    
     // second order extrapolation
     double m, m1, m2;
     m1 = ( y[ 1 ] - y[ 0 ] ) / ( x[ 1 ] - x[ 0 ] );
     m2 = ( y[ 2 ] - y[ 1 ] ) / ( x[ 2 ] - x[ 1 ] );
     m = m2 + 2.0 * ( m2 - m1 ) / ( x[ 2 ] - x[ 0 ] );
     
-    double currYear = modeltime->getper_to_yr( aPeriod );
     return y[ 2 ] + m * ( currYear - x[ 2 ] );
 }
@@ -44,6 +44,9 @@
 
 #include "marketplace/include/market_locator.h"
 #include "util/base/include/hash_map.h"
+#include "marketplace/include/marketplace_profiler.h"
+#include "util/base/include/atom.h"
+#include "util/base/include/atom_registry.h"
 
 #define PERFORM_TIMING 0
 #if PERFORM_TIMING
@@ -57,15 +60,20 @@ static int gNumLookups;
 
 using namespace std;
 
+namespace {
+    //! The initial size of the lists of regions and market areas.
+    const unsigned int MARKET_REGION_LIST_SIZE = 71;
 
+    //! The initial size of the list of goods of a region or market area.
+    const unsigned int SECTOR_LIST_SIZE = 51;
+}
 
 /*! \brief Constructor */
 MarketLocator::MarketLocator()
-:mLastRegionLookup( static_cast<const RegionOrMarketNode*>( 0 ) )
+:mLastRegionLookup( static_cast<const RegionOrMarketNode*>( 0 ) ),
+mMarketList( MARKET_REGION_LIST_SIZE ),
+mRegionList( MARKET_REGION_LIST_SIZE )
 {
-    const unsigned int MARKET_REGION_LIST_SIZE = 71;
-    mRegionList.reset( new RegionMarketList( MARKET_REGION_LIST_SIZE ) );
-    mMarketList.reset( new RegionMarketList( MARKET_REGION_LIST_SIZE ) );
 }
 
 //! Destructor
@@ -93,40 +101,34 @@ int MarketLocator::addMarket( const string& aMarket,
                               const int aUniqueNumber )
 {
     // Check if the market area exists in the market area list.
-    RegionMarketList::iterator iter = mMarketList->find( aMarket );
+    RegionMarketList::iterator iter = mMarketList.find( aMarket );
     
-    int goodNumber;
     // The market area does not exist. Create a new entry.
-    if( iter == mMarketList->end() ){
-        boost::shared_ptr<RegionOrMarketNode> newMarketNode( new RegionOrMarketNode( aMarket ) );
-        // Add the node to the hashmap.
-        mMarketList->insert( make_pair( aMarket, newMarketNode ) );
-
-        // Add the item to it.
-        goodNumber = newMarketNode->addGood( aGoodName, aUniqueNumber );
-    }
-    else {
-        // The market area already exists. Add the item to it.
-        goodNumber = iter->second->addGood( aGoodName, aUniqueNumber );
+    if( iter == mMarketList.end() ){
+        iter = mMarketList.insert( make_pair( aMarket, RegionOrMarketNode( aMarket ) ) ).first;
     }
 
+    // Add the item to the market area.
+    const int goodNumber = iter->second.addGood( aGoodName, aUniqueNumber );
+
     // Check if the region exists in the region list.
-    iter = mRegionList->find( aRegion );
+    iter = mRegionList.find( aRegion );
 
     // The region does not exist. Create a new entry.
-    if( iter == mRegionList->end() ){
-        boost::shared_ptr<RegionOrMarketNode> newRegionNode( new RegionOrMarketNode( aRegion ) );
-        // Add the new region to the region list.
-        mRegionList->insert( make_pair( aRegion, newRegionNode ) );
-        
-        // Add the item to the region list.
-        newRegionNode->addGood( aGoodName, goodNumber );
-    }
-    else {
-        // The region already exists. Add the item to it.
-        iter->second->addGood( aGoodName, goodNumber );
+    if( iter == mRegionList.end() ){
+        iter = mRegionList.insert( make_pair( aRegion, RegionOrMarketNode( aRegion ) ) ).first;
     }
 
+    // Add the item to the region list.
+    const int regionGoodNumber = iter->second.addGood( aGoodName, goodNumber );
+
+    // Store the number found through the region list by the interned names
+    // as well.
+    objects::AtomRegistry* atomRegistry = objects::AtomRegistry::getInstance();
+    mAtomMarketList.insert( make_pair( AtomPair( atomRegistry->getAtom( aRegion ),
+                                                  atomRegistry->getAtom( aGoodName ) ),
+                                        regionGoodNumber ) );
+
     // Return the good number used.
     return goodNumber;
 }
@@ -150,11 +152,44 @@ int MarketLocator::getMarketNumber( const string& aRegion, const string& aGoodNa
     gTotalLookupTime += timer.getTimeDifference();
     ++gNumLookups;
     return marketNumber;
+#elif MARKETPLACE_PROFILING
+    const int marketNumber = getMarketNumberInternal( aRegion, aGoodName );
+    if( marketNumber == MARKET_NOT_FOUND ) {
+        MarketplaceProfiler::getInstance().recordNotFound( aRegion, aGoodName );
+    }
+    return marketNumber;
 #else
     return getMarketNumberInternal( aRegion, aGoodName );
 #endif
 }
 
+/*! \brief Find the market number of a region and good given their Atoms.
+* \details The same as getMarketNumber for the names, but the lookup only
+*          compares pointers and uses the precomputed hashes of the Atoms.
+* \param aRegion Atom of the region for which to search.
+* \param aGoodName Atom of the good for which to search.
+* \return The market number or MARKET_NOT_FOUND if it is not present.
+*/
+int MarketLocator::getMarketNumber( const objects::Atom* aRegion, const objects::Atom* aGoodName ) const {
+    AtomMarketList::const_iterator iter = mAtomMarketList.find( AtomPair( aRegion, aGoodName ) );
+    if( iter != mAtomMarketList.end() ) {
+        return iter->second;
+    }
+#if MARKETPLACE_PROFILING
+    MarketplaceProfiler::getInstance().recordNotFound( aRegion->getID(), aGoodName->getID() );
+#endif
+    return MARKET_NOT_FOUND;
+}
+
+/*! \brief Hash the region and good Atom pair.
+* \return The combined precomputed hashes of the Atoms.
+*/
+size_t MarketLocator::AtomPair::getHash() const {
+    size_t seed = mRegion->getHashCode();
+    boost::hash_combine( seed, mGood->getHashCode() );
+    return seed;
+}
+
 /*! \brief Internal calculation which determines the market number from a region
 *          and good name.
 * \details Performs the calculation which determines the market number from a
@@ -173,19 +208,26 @@ int MarketLocator::getMarketNumberInternal( const string& aRegion,
     const RegionOrMarketNode*& localCache = mLastRegionLookup.local();
     if( localCache && localCache->getName() == aRegion ){
         region = localCache;
+#if MARKETPLACE_PROFILING
+        MarketplaceProfiler::getInstance().recordRegionLookup( true );
+#endif
     }
 #else
     if( mLastRegionLookup && mLastRegionLookup->getName() == aRegion ) {
         region = mLastRegionLookup;
+#if MARKETPLACE_PROFILING
+        MarketplaceProfiler::getInstance().recordRegionLookup( true );
+#endif
     }
 #endif
     else {
-        RegionMarketList::const_iterator iter = mRegionList->find( aRegion );
+#if MARKETPLACE_PROFILING
+        MarketplaceProfiler::getInstance().recordRegionLookup( false );
+#endif
+        RegionMarketList::const_iterator iter = mRegionList.find( aRegion );
         // Check if the region was found.
-        if( iter != mRegionList->end() ){
-            /*! \invariant If the key is in the list the node must be non-null. */
-            assert( iter->second.get() );
-            region = iter->second.get();
+        if( iter != mRegionList.end() ){
+            region = &iter->second;
 #if GCAM_PARALLEL_ENABLED
             localCache = region;
 #else
@@ -205,13 +247,9 @@ int MarketLocator::getMarketNumberInternal( const string& aRegion,
 
 //! Constructor
 MarketLocator::RegionOrMarketNode::RegionOrMarketNode( const string& aName ):
-mName( aName ){
-    const unsigned int SECTOR_LIST_SIZE = 51;
-    mSectorNodeList.reset( new SectorNodeList( SECTOR_LIST_SIZE ) );
-}
-
-//! Destructor
-MarketLocator::RegionOrMarketNode::~RegionOrMarketNode(){
+mSectorNodeList( SECTOR_LIST_SIZE ),
+mName( aName )
+{
 }
 
 /*! \brief Add a Good to the RegionOrMarketNode.
@@ -225,22 +263,16 @@ int MarketLocator::RegionOrMarketNode::addGood( const string& aGoodName,
                                                 const int aUniqueNumber )
 {
     // Check if it exists in the good list.
-    SectorNodeList::iterator iter = mSectorNodeList->find( aGoodName );
+    SectorNodeList::iterator iter = mSectorNodeList.find( aGoodName );
 
     // Check if the good was found.
-    if( iter != mSectorNodeList->end() ){
-        /*! \invariant If the key is in the list the node must be non-null. */
-        assert( iter->second.get() );
-
+    if( iter != mSectorNodeList.end() ){
         // Return the good number.
-        return iter->second->mNumber;
+        return iter->second;
     }
 
-    // The good node does not exist. Create a new one.
-    boost::shared_ptr<GoodNode> newGoodNode( new GoodNode( aGoodName, aUniqueNumber ) );
-
-    // Add the new node to the hashmap.
-    mSectorNodeList->insert( make_pair( aGoodName, newGoodNode ) );
+    // The good does not exist. Add it to the hashmap.
+    mSectorNodeList.insert( make_pair( aGoodName, aUniqueNumber ) );
 
     // Return the new index.
     return aUniqueNumber;
@@ -252,18 +284,11 @@ int MarketLocator::RegionOrMarketNode::addGood( const string& aGoodName,
 */
 int MarketLocator::RegionOrMarketNode::getMarketNumber( const string& aGoodName ) const {
     // Check if it exists in the good list.
-    SectorNodeList::const_iterator iter = mSectorNodeList->find( aGoodName );
-    if( iter != mSectorNodeList->end() ){
-        return iter->second->mNumber;
+    SectorNodeList::const_iterator iter = mSectorNodeList.find( aGoodName );
+    if( iter != mSectorNodeList.end() ){
+        return iter->second;
     }
 
     // Return that the market was not found.
     return MARKET_NOT_FOUND;
 }
-
-//! Constructor
-MarketLocator::GoodNode::GoodNode( const string& aName, const int aMarketNumber ):
-mName( aName ),
-mNumber( aMarketNumber )
-{
-}
@@ -0,0 +1,142 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file market_price_stamps.cpp
+ * \ingroup Objects
+ * \brief MarketPriceStamps class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+
+#include "marketplace/include/market_price_stamps.h"
+#include "marketplace/include/market.h"
+
+using namespace std;
+
+thread_local int MarketPriceStamps::sNumRecorders = 0;
+thread_local vector<MarketPriceStamps::Stamp> MarketPriceStamps::sReads;
+
+//! Constructor which starts recording the prices read by the calling thread.
+MarketPriceStamps::Recorder::Recorder():
+mStart( sReads.size() )
+{
+    ++sNumRecorders;
+}
+
+//! Destructor which stops recording, the reads are kept for an outer recorder if there is one.
+MarketPriceStamps::Recorder::~Recorder() {
+    assert( sNumRecorders > 0 );
+    if( --sNumRecorders == 0 ) {
+        sReads.clear();
+    }
+}
+
+/*!
+ * \brief Store a value along with the prices read since this recorder started.
+ * \param aStamps The stamps in which to store the value.
+ * \param aKey The key of the value, such as a period.
+ * \param aValue The value calculated from the prices.
+ */
+void MarketPriceStamps::Recorder::store( MarketPriceStamps& aStamps, const int aKey,
+                                         const double aValue ) const
+{
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock;
+    if( !lock.try_acquire( aStamps.mMutex ) ) {
+        return;
+    }
+#endif
+    aStamps.mStamps.assign( sReads.begin() + mStart, sReads.end() );
+    aStamps.mKey = aKey;
+    aStamps.mValue = aValue;
+}
+
+//! Constructor
+MarketPriceStamps::MarketPriceStamps():
+mKey( -1 ),
+mValue( 0 )
+{
+}
+
+//! Copy constructor, the copy is empty.
+MarketPriceStamps::MarketPriceStamps( const MarketPriceStamps& aOther ):
+mKey( -1 ),
+mValue( 0 )
+{
+}
+
+//! Assignment operator, this clears the stamps.
+MarketPriceStamps& MarketPriceStamps::operator=( const MarketPriceStamps& aOther ) {
+    if( this != &aOther ) {
+        clear();
+    }
+    return *this;
+}
+
+/*!
+ * \brief Get the stored value if none of the prices it was calculated from
+ *        have changed.
+ * \param aKey The key the value must have been stored with.
+ * \param aValue Will be set to the stored value if it is still current.
+ * \return Whether the stored value is current.
+ */
+bool MarketPriceStamps::getValue( const int aKey, double& aValue ) const {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock;
+    if( !lock.try_acquire( mMutex ) ) {
+        return false;
+    }
+#endif
+    if( mKey != aKey || aKey == -1 ) {
+        return false;
+    }
+    for( vector<Stamp>::const_iterator iter = mStamps.begin(); iter != mStamps.end(); ++iter ) {
+        if( !( (*iter).first->getPrice() == (*iter).second ) ) {
+            return false;
+        }
+    }
+    aValue = mValue;
+    return true;
+}
+
+//! Remove the stored value.
+void MarketPriceStamps::clear() {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    mStamps.clear();
+    mKey = -1;
+}
@@ -42,6 +42,7 @@
 
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/parallel_for.h>
@@ -49,6 +50,7 @@
 
 #include "marketplace/include/marketplace.h"
 #include "marketplace/include/market.h"
+#include "marketplace/include/linked_market.h"
 #include "marketplace/include/market_container.h"
 #include "marketplace/include/imarket_type.h"
 #include "containers/include/scenario.h"
@@ -59,16 +61,37 @@
 #include "util/base/include/time_vector.h"
 #include "util/logger/include/ilogger.h"
 #include "marketplace/include/market_locator.h"
+#include "util/base/include/atom.h"
 #include "util/base/include/ivisitor.h"
 #include "containers/include/iinfo.h"
 #include "marketplace/include/cached_market.h"
+#include "marketplace/include/market_price_stamps.h"
 #include "containers/include/market_dependency_finder.h"
 #include "solution/util/include/ublas-helpers.hpp"
+#include "util/base/include/manage_state_variables.hpp"
+#include "marketplace/include/marketplace_profiler.h"
+#include "marketplace/include/price_forecaster.h"
+#if GCAM_PARALLEL_ENABLED
+#include "marketplace/include/market_accumulator.h"
+#endif
 
 using namespace std;
+using namespace objects;
 
 extern Scenario* scenario;
 const double Marketplace::NO_MARKET_PRICE = util::getLargeNumber();
+
+namespace {
+    //! The name to report for a good or region name.
+    inline const string& getName( const string& aName ) {
+        return aName;
+    }
+
+    //! The name to report for a good or region Atom.
+    inline const string& getName( const Atom* aName ) {
+        return aName->getID();
+    }
+}
 bool Marketplace::mIsDerivativeCalc = false;
 
 /*! \brief Default constructor 
@@ -80,7 +103,13 @@ bool Marketplace::mIsDerivativeCalc = false;
 */
 Marketplace::Marketplace():
 mMarketLocator( new MarketLocator() ),
-mDependencyFinder( new MarketDependencyFinder( this ) )
+mDependencyFinder( new MarketDependencyFinder( this ) ),
+mPriceForecaster( new PriceForecaster() ),
+mPreservedStatePeriod( -1 ),
+mSolveRestriction( 0 )
+#if GCAM_PARALLEL_ENABLED
+, mMarketAccumulator( new MarketAccumulator() )
+#endif
 {
 }
 
@@ -421,11 +450,27 @@ void Marketplace::unsetMarketToSolve ( const string& goodName, const string& reg
 /*! \brief Clear all market supplies and demands for the given period.
 * 
 * This function iterates through the markets and nulls the supply and demand 
-* of each market in the given period.
+* of each market in the given period.  When the market state of the period is
+* stored contiguously by ManageStateVariables this is done with sweeps over the
+* demand and supply blocks instead which skip the entries markets keep their
+* constraints in, as found by findPreservedMarketState.
 *
 * \param period Period in which to null the supplies and demands. 
 */
 void Marketplace::nullSuppliesAndDemands( const int period ) {
+    const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    if( stateVars && stateVars->hasMarketState( period ) && period == mPreservedStatePeriod ) {
+        // The supply block immediately follows the demand block.
+        double* demands = stateVars->getMarketState( ManageStateVariables::MARKET_DEMAND );
+        size_t start = 0;
+        for( const size_t preserved : mPreservedMarketState ) {
+            std::fill( demands + start, demands + preserved, 0.0 );
+            start = preserved + 1;
+        }
+        std::fill( demands + start, demands + 2 * stateVars->getNumMarkets(), 0.0 );
+        return;
+    }
+    
 #if GCAM_PARALLEL_ENABLED
     tbb::parallel_for( tbb::blocked_range<int>( 0, mMarkets.size() ), [this, period]( const tbb::blocked_range<int>& aRange) {
         for( int marketIndex = aRange.begin(); marketIndex != aRange.end(); ++marketIndex ) {
@@ -476,6 +521,101 @@ void Marketplace::assignMarketSerialNumbers( int aPeriod )
             id++;
         }
     }
+
+    compileLinkedMarketPlan( aPeriod );
+    findPreservedMarketState( aPeriod );
+}
+
+/*!
+ * \brief Find the demands and supplies which nullSuppliesAndDemands must not
+ *        clear when it sweeps over the contiguous market state.
+ * \details Markets which keep their constraint in the demand or supply override
+ *          nullDemand or nullSupply to do nothing.  These must be kept in step
+ *          with the market types here.  The offsets are found from the serial
+ *          numbers so this must be called once they have been assigned.
+ * \param aPeriod The period to find the entries for.
+ */
+void Marketplace::findPreservedMarketState( const int aPeriod ) {
+    mPreservedMarketState.clear();
+    mPreservedStatePeriod = aPeriod;
+    const size_t numMarkets = mMarkets.size();
+    for( auto marketContainer : mMarkets ) {
+        const size_t index = marketContainer->getSerialNumber() - 1;
+        switch( marketContainer->getMarket( aPeriod )->getType() ) {
+            case IMarketType::CALIBRATION:
+            case IMarketType::SUBSIDY:
+                mPreservedMarketState.push_back( index );
+                break;
+            case IMarketType::INVERSE_CALIBRATION:
+            case IMarketType::TAX:
+            case IMarketType::PRICE:
+            case IMarketType::DEMAND:
+            case IMarketType::TRIAL_VALUE:
+                mPreservedMarketState.push_back( numMarkets + index );
+                break;
+            default:
+                break;
+        }
+    }
+    std::sort( mPreservedMarketState.begin(), mPreservedMarketState.end() );
+}
+
+/*!
+ * \brief Flatten the chains of linked markets in a period into a list of
+ *        transfers from each linked market to every market down its chain.
+ * \details Rather than forwarding every addition through each link in turn, a
+ *          linked market adds directly to every market down its chain, scaled
+ *          by the product of the quantity multipliers along the chain.  The
+ *          additions are still passed on as they are made so the quantities of
+ *          the markets linked to are complete at any point in a World::calc.
+ *          The market at the end of each chain is also saved so that the price
+ *          can be looked up directly.  The transfers for any previous period
+ *          are dropped so that those markets forward their additions as before.
+ * \param aPeriod The period to compile the transfers for.
+ */
+void Marketplace::compileLinkedMarketPlan( const int aPeriod ) {
+    for( auto linkedMarket : mLinkedSources ) {
+        linkedMarket->mTransfers.clear();
+        linkedMarket->mIsPlanned = false;
+    }
+    mLinkedSources.clear();
+
+    for( auto marketContainer : mMarkets ) {
+        Market* market = marketContainer->getMarket( aPeriod );
+        if( market->getType() != IMarketType::LINKED ) {
+            continue;
+        }
+        LinkedMarket* linkedMarket = static_cast<LinkedMarket*>( market );
+        LinkedMarket::LinkedTransfer transfer;
+        transfer.mQuantityMult = linkedMarket->mQuantityMult;
+        double priceMult = linkedMarket->mPriceMult;
+        Market* currMarket = linkedMarket->mLinkedMarket;
+        while( currMarket && linkedMarket->mTransfers.size() <= mMarkets.size() ) {
+            transfer.mTarget = currMarket;
+            transfer.mIsTargetLinked = currMarket->getType() == IMarketType::LINKED;
+            linkedMarket->mTransfers.push_back( transfer );
+            if( !transfer.mIsTargetLinked ) {
+                break;
+            }
+            LinkedMarket* nextMarket = static_cast<LinkedMarket*>( currMarket );
+            transfer.mQuantityMult *= nextMarket->mQuantityMult;
+            priceMult *= nextMarket->mPriceMult;
+            currMarket = nextMarket->mLinkedMarket;
+        }
+        if( linkedMarket->mTransfers.size() > mMarkets.size() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Linked market " << linkedMarket->getName() << " is part of a cycle of links." << endl;
+            linkedMarket->mTransfers.clear();
+            continue;
+        }
+        // If the chain ends in a linked market without a link the price is
+        // left to LinkedMarket::getPrice to work out.
+        linkedMarket->mRootMarket = currMarket;
+        linkedMarket->mRootPriceMult = priceMult;
+        linkedMarket->mIsPlanned = true;
+        mLinkedSources.push_back( linkedMarket );
+    }
 }
 
 /*! \brief Set the market price.
@@ -528,25 +668,57 @@ void Marketplace::setPrice( const string& goodName, const string& regionName, co
 */
 void Marketplace::addToSupply( const string& goodName, const string& regionName, const Value& value,
                                const int per, bool aMustExist )
+{
+    addToSupplyInternal( goodName, regionName, value, per, aMustExist );
+}
+
+/*! \brief Add to the supply for this market given the Atoms of the good and
+*          region names.
+* \details The same as addToSupply for the names, but locating the market only
+*          compares pointers.
+* \param aGoodName Atom of the name of the good for which to add supply.
+* \param aRegionName Atom of the name of the region in which supply should be added.
+* \param aValue Amount of supply to add.
+* \param aPeriod Period in which to add supply.
+* \param aMustExist Whether it is an error for the market not to exist.
+*/
+void Marketplace::addToSupply( const Atom* aGoodName, const Atom* aRegionName, const Value& aValue,
+                               const int aPeriod, bool aMustExist )
+{
+    addToSupplyInternal( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+}
+
+/*! \brief Add to the supply for a market found by either the names or the Atoms
+*          of the names of the good and region, see addToSupply.
+*/
+template<class NameType>
+void Marketplace::addToSupplyInternal( const NameType& goodName, const NameType& regionName, const Value& value,
+                                       const int per, const bool aMustExist )
 {
     // Print a warning message when adding infinity values to the supply.
     if ( !util::isValidNumber( value ) ) {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Error adding to supply in marketplace for: " << goodName << ", region: " << regionName << ", value: " << value << endl;
+        mainLog << "Error adding to supply in marketplace for: " << getName( goodName ) << ", region: " << getName( regionName ) << ", value: " << value << endl;
         return;
     }
 
+#if MARKETPLACE_PROFILING
+    MarketplaceProfiler::Scope profile( MarketplaceProfiler::ADD_TO_SUPPLY );
+#endif
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
 
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+#if MARKETPLACE_PROFILING
+        profile.setMarket( marketNumber );
+#endif
         mMarkets[ marketNumber ]->getMarket( per )->addToSupply( mIsDerivativeCalc ? value.getDiff() : value.get() );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Cannot add to supply for market as it does not exist: " << goodName << " " 
-            << regionName << endl;
+        mainLog << "Cannot add to supply for market as it does not exist: " << getName( goodName ) << " " 
+            << getName( regionName ) << endl;
     }
 }
 
@@ -566,24 +738,56 @@ void Marketplace::addToSupply( const string& goodName, const string& regionName,
 */
 void Marketplace::addToDemand( const string& goodName, const string& regionName, const Value& value,
                                const int per, bool aMustExist )
+{
+    addToDemandInternal( goodName, regionName, value, per, aMustExist );
+}
+
+/*! \brief Add to the demand for this market given the Atoms of the good and
+*          region names.
+* \details The same as addToDemand for the names, but locating the market only
+*          compares pointers.
+* \param aGoodName Atom of the name of the good for which to add demand.
+* \param aRegionName Atom of the name of the region in which demand should be added.
+* \param aValue Amount of demand to add.
+* \param aPeriod Period in which to add demand.
+* \param aMustExist Whether it is an error for the market not to exist.
+*/
+void Marketplace::addToDemand( const Atom* aGoodName, const Atom* aRegionName, const Value& aValue,
+                               const int aPeriod, bool aMustExist )
+{
+    addToDemandInternal( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+}
+
+/*! \brief Add to the demand for a market found by either the names or the Atoms
+*          of the names of the good and region, see addToDemand.
+*/
+template<class NameType>
+void Marketplace::addToDemandInternal( const NameType& goodName, const NameType& regionName, const Value& value,
+                                       const int per, const bool aMustExist )
 {
     // Print a warning message when adding infinity values to the demand
     if ( !util::isValidNumber( value ) ) {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Error adding to demand in marketplace for: " << goodName << ", region: " << regionName << ", value: " << value << endl;
+        mainLog << "Error adding to demand in marketplace for: " << getName( goodName ) << ", region: " << getName( regionName ) << ", value: " << value << endl;
         return;
     }
 
+#if MARKETPLACE_PROFILING
+    MarketplaceProfiler::Scope profile( MarketplaceProfiler::ADD_TO_DEMAND );
+#endif
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+#if MARKETPLACE_PROFILING
+        profile.setMarket( marketNumber );
+#endif
         mMarkets[ marketNumber ]->getMarket( per )->addToDemand( mIsDerivativeCalc ? value.getDiff() : value.get() );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Cannot add to demand for market as it does not exist: " << goodName << " " 
-            << regionName << endl;
+        mainLog << "Cannot add to demand for market as it does not exist: " << getName( goodName ) << " " 
+            << getName( regionName ) << endl;
     }
 }
 
@@ -602,17 +806,51 @@ void Marketplace::addToDemand( const string& goodName, const string& regionName,
 */  
 double Marketplace::getPrice( const string& goodName, const string& regionName, const int per,
                              bool aMustExist ) const {
+    return getPriceInternal( goodName, regionName, per, aMustExist );
+}
+
+/*! \brief Return the market price given the Atoms of the good and region names.
+* \details The same as getPrice for the names, but locating the market only
+*          compares pointers.
+* \param aGoodName Atom of the name of the good for which a price is needed.
+* \param aRegionName Atom of the name of the region for which a price is needed.
+* \param aPeriod The period to return the market price for.
+* \param aMustExist Whether it is an error for the market not to exist.
+* \return The market price.
+*/
+double Marketplace::getPrice( const Atom* aGoodName, const Atom* aRegionName, const int aPeriod,
+                             bool aMustExist ) const
+{
+    return getPriceInternal( aGoodName, aRegionName, aPeriod, aMustExist );
+}
+
+/*! \brief Return the price of a market found by either the names or the Atoms
+*          of the names of the good and region, see getPrice.
+*/
+template<class NameType>
+double Marketplace::getPriceInternal( const NameType& goodName, const NameType& regionName, const int per,
+                                      const bool aMustExist ) const
+{
+#if MARKETPLACE_PROFILING
+    MarketplaceProfiler::Scope profile( MarketplaceProfiler::GET_PRICE );
+#endif
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
     
     if( marketNumber != MarketLocator::MARKET_NOT_FOUND ){
-        return mMarkets[ marketNumber ]->getMarket( per )->getPrice();
+#if MARKETPLACE_PROFILING
+        profile.setMarket( marketNumber );
+#endif
+        const Market* market = mMarkets[ marketNumber ]->getMarket( per );
+        const double price = market->getPrice();
+        MarketPriceStamps::recordRead( market, price );
+        return price;
     }
 
     if( aMustExist ) {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Called for price of non-existant market " << goodName << " in region " 
-            << regionName << endl;
+        mainLog << "Called for price of non-existant market " << getName( goodName ) << " in region " 
+            << getName( regionName ) << endl;
     }
     return NO_MARKET_PRICE;
 }
@@ -668,6 +906,7 @@ double Marketplace::getDemand(  const string& goodName, const string& regionName
 //! Returns a set of pointers to each market for the period.
 vector<Market*> Marketplace::getMarketsToSolve( const int period ) const {
     vector<Market*> toSolve;
+    toSolve.reserve( mMarkets.size() );
     
     // Loop through the markets and add all markets.
     for( unsigned int i = 0; i < mMarkets.size(); ++i ){
@@ -699,15 +938,17 @@ void Marketplace::init_to_last( const int period ) {
         }
     }
     else if ( period > 0 && period <= finalCalPeriod ) {
+        mPriceForecaster->updateErrors( mMarkets, period );
         for ( unsigned int i = 0; i < mMarkets.size(); i++ ) {
-            double forecastedPrice = mMarkets[ i ]->forecastPrice( period );
+            double forecastedPrice = mMarkets[ i ]->forecastPrice( period, *mPriceForecaster );
             mMarkets[ i ]->getMarket( period )->set_price_to_last_if_default( forecastedPrice );
             mMarkets[ i ]->forecastDemand( period );
         }
     }
     else {
+        mPriceForecaster->updateErrors( mMarkets, period );
         for ( unsigned int i = 0; i < mMarkets.size(); i++ ) {
-            double forecastedPrice = mMarkets[ i ]->forecastPrice( period );
+            double forecastedPrice = mMarkets[ i ]->forecastPrice( period, *mPriceForecaster );
             double lastPeriodPrice = mMarkets[ i ]->getMarket( period - 1 )->getPrice();
             // Only use the forecast price if it is reliable.
             if( (forecastedPrice < 0.0 && lastPeriodPrice > 0.0) ||
@@ -725,6 +966,53 @@ void Marketplace::init_to_last( const int period ) {
     }
 }
 
+/*!
+ * \brief Save the solved prices of a period as the reference for forecasting
+ *        the prices in a later run of the scenario.
+ * \param aPeriod The period which was solved.
+ * \see PriceForecaster
+ */
+void Marketplace::storeForecastReference( const int aPeriod ) {
+    PriceForecaster::storeReferencePrices( mMarkets, aPeriod );
+}
+
+/*!
+ * \brief Get the raw price of every market in a period.
+ * \param aPeriod The period.
+ * \return The prices in the order of the markets.
+ * \see setSolvedMarketPrices
+ */
+vector<double> Marketplace::getRawPrices( const int aPeriod ) const {
+    vector<double> prices( mMarkets.size() );
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        prices[ i ] = mMarkets[ i ]->getMarket( aPeriod )->getRawPrice();
+    }
+    return prices;
+}
+
+/*!
+ * \brief Set the prices of the markets which will be solved in a period.
+ * \details The prices of markets which are not solved are left alone since
+ *          they are set by the model rather than found by the solver.
+ * \param aPeriod The period.
+ * \param aPrices The prices in the order of the markets as returned by
+ *        getRawPrices.
+ * \return Whether the prices were set, which they are not if there is not one
+ *         for every market.
+ */
+bool Marketplace::setSolvedMarketPrices( const int aPeriod, const vector<double>& aPrices ) {
+    if( aPrices.size() != mMarkets.size() ) {
+        return false;
+    }
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        Market* market = mMarkets[ i ]->getMarket( aPeriod );
+        if( market->shouldSolve() ) {
+            market->setRawPrice( aPrices[ i ] );
+        }
+    }
+    return true;
+}
+
 /*! \brief Store market prices for policy cost caluclation.
 *
 *
@@ -776,24 +1064,7 @@ void Marketplace::restore_prices_for_cost_calculation()
 const IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string& aRegionName,
                                          const int aPeriod, const bool aMustExist ) const 
 {
-    const int marketNumber = mMarketLocator->getMarketNumber( aRegionName, aGoodName );
-    const IInfo* info = 0;
-    if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
-        info = mMarkets[ marketNumber ]->getMarket( aPeriod )->getMarketInfo();
-        /*! \invariant The market is required to return an information object
-        *              that is non-null. 
-        */
-        assert( info );
-    }
-    
-    // Report the error if requested.
-    if( !info && aMustExist ){
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Market info object cannot be returned because market "
-                << aGoodName << " in " << aRegionName << " does not exist." << endl;
-    }
-    return info;
+    return getMarketInfoInternal( aGoodName, aRegionName, aPeriod, aMustExist );
 }
 
 /*! \brief Get the information object for the specified market and period which
@@ -818,6 +1089,52 @@ const IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string&
 */
 IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string& aRegionName,
                                    const int aPeriod, const bool aMustExist )
+{
+    return getMarketInfoInternal( aGoodName, aRegionName, aPeriod, aMustExist );
+}
+
+/*! \brief Get the constant information object for the specified market and
+*          period given the Atoms of the good and region names.
+* \details The same as getMarketInfo for the names, but locating the market
+*          only compares pointers.
+* \param aGoodName Atom of the good of the market.
+* \param aRegionName Atom of the region used to find the market.
+* \param aPeriod The period to fetch for which the information object.
+* \param aMustExist Whether it is an error for the market not to exist.
+* \return A constant pointer to the market information object, null if the
+*         market does not exist.
+*/
+const IInfo* Marketplace::getMarketInfo( const Atom* aGoodName, const Atom* aRegionName,
+                                         const int aPeriod, const bool aMustExist ) const
+{
+    return getMarketInfoInternal( aGoodName, aRegionName, aPeriod, aMustExist );
+}
+
+/*! \brief Get the mutable information object for the specified market and
+*          period given the Atoms of the good and region names.
+* \details The same as getMarketInfo for the names, but locating the market
+*          only compares pointers.
+* \param aGoodName Atom of the good of the market.
+* \param aRegionName Atom of the region used to find the market.
+* \param aPeriod The period to fetch for which the information object.
+* \param aMustExist Whether it is an error for the market not to exist.
+* \return A mutable pointer to the market information object, null if the
+*         market does not exist.
+*/
+IInfo* Marketplace::getMarketInfo( const Atom* aGoodName, const Atom* aRegionName,
+                                   const int aPeriod, const bool aMustExist )
+{
+    return getMarketInfoInternal( aGoodName, aRegionName, aPeriod, aMustExist );
+}
+
+/*! \brief Get the information object for a market found by either the names or
+*          the Atoms of the names of the good and region, see getMarketInfo.
+* \note This returns a mutable pointer, the public const version returns it as
+*       constant.
+*/
+template<class NameType>
+IInfo* Marketplace::getMarketInfoInternal( const NameType& aGoodName, const NameType& aRegionName,
+                                           const int aPeriod, const bool aMustExist ) const
 {
     const int marketNumber = mMarketLocator->getMarketNumber( aRegionName, aGoodName );
     IInfo* info = 0;
@@ -833,8 +1150,8 @@ IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string& aRegio
     if( !info && aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Market info object cannot be returned because market " 
-                << aGoodName << " in " << aRegionName << " does not exist." << endl;
+        mainLog << "Market info object cannot be returned because market "
+                << getName( aGoodName ) << " in " << getName( aRegionName ) << " does not exist." << endl;
     }
     return info;
 }
@@ -871,16 +1188,18 @@ void Marketplace::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitMarketplace( this, aPeriod );
 
     // Update from the markets.
-    for( unsigned int i = 0; i < mMarkets.size(); i++ ){
-        // If the period is -1 this means to update all periods.
-        if( aPeriod == -1 ){
-            for( unsigned int j = 0; j < mMarkets[ i ]->size(); ++j ){
-                mMarkets[ i ]->getMarket( j )->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::MARKETS ) ) {
+        for( unsigned int i = 0; i < mMarkets.size(); i++ ){
+            // If the period is -1 this means to update all periods.
+            if( aPeriod == -1 ){
+                for( unsigned int j = 0; j < mMarkets[ i ]->size(); ++j ){
+                    mMarkets[ i ]->getMarket( j )->accept( aVisitor, aPeriod );
+                }
+            }
+            // Otherwise only update for the current period.
+            else {
+                mMarkets[ i ]->getMarket( aPeriod )->accept( aVisitor, aPeriod );
             }
-        }
-        // Otherwise only update for the current period.
-        else {
-            mMarkets[ i ]->getMarket( aPeriod )->accept( aVisitor, aPeriod );
         }
     }
 
@@ -897,6 +1216,67 @@ MarketDependencyFinder* Marketplace::getDependencyFinder() const {
     return mDependencyFinder.get();
 }
 
+/*!
+ * \brief Restrict the markets which may be solved.
+ * \details While set, solution sets created for this marketplace only solve
+ *          markets the restriction accepts and the rest are left at their
+ *          current prices.  This is used by Scenario to solve a reduced
+ *          problem ahead of the full one.
+ * \param aRestriction The filter to restrict the solvable markets to, or null
+ *        to remove the restriction.  The caller retains ownership.
+ */
+void Marketplace::setSolveRestriction( const ISolutionInfoFilter* aRestriction ) {
+    mSolveRestriction = aRestriction;
+}
+
+/*!
+ * \brief Get the restriction on the markets which may be solved.
+ * \return The restriction, or null if all markets may be solved.
+ */
+const ISolutionInfoFilter* Marketplace::getSolveRestriction() const {
+    return mSolveRestriction;
+}
+
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief Get the accumulator for additions to supplies and demands made during
+ *        a parallel calculation.
+ * \return The market accumulator.
+ */
+MarketAccumulator* Marketplace::getMarketAccumulator() const {
+    return mMarketAccumulator.get();
+}
+
+/*!
+ * \brief Begin accumulating additions to supplies and demands for a parallel
+ *        World::calc.
+ * \details Until finishParallelAccumulation is called the markets will not be
+ *          locked when added to and supplies and demands will be totaled in the
+ *          order of the global ordering.  Nothing is accumulated during a
+ *          partial derivative calculation since each thread then calculates in
+ *          its own copy of the state, nor if the markets do not have serial
+ *          numbers for this period in which case the markets will be locked as
+ *          usual.
+ * \param aPeriod The period being calculated.
+ * \see MarketAccumulator
+ */
+void Marketplace::startParallelAccumulation( const int aPeriod ) {
+    if( !mIsDerivativeCalc ) {
+        mMarketAccumulator->start( mMarkets, aPeriod );
+    }
+}
+
+/*!
+ * \brief Stop accumulating additions to supplies and demands and set the totals
+ *        in the markets.
+ */
+void Marketplace::finishParallelAccumulation() {
+    if( mMarketAccumulator->isActive() ) {
+        mMarketAccumulator->finish();
+    }
+}
+#endif
+
 /*!
  * \brief Get the full state of the marketplace.
  * \param period The model period.
@@ -906,6 +1286,20 @@ MarketDependencyFinder* Marketplace::getDependencyFinder() const {
 std::vector<double> Marketplace::fullstate( int period ) const
 {
   std::vector<double> state;
+  state.reserve( 3 * mMarkets.size() );
+  const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+  if( stateVars && stateVars->hasMarketState( period ) ) {
+    const double* prices = stateVars->getMarketState( ManageStateVariables::MARKET_PRICE );
+    const double* demands = stateVars->getMarketState( ManageStateVariables::MARKET_DEMAND );
+    const double* supplies = stateVars->getMarketState( ManageStateVariables::MARKET_SUPPLY );
+    for(unsigned i=0; i<mMarkets.size(); ++i) {
+      const int j = mMarkets[i]->getSerialNumber() - 1;
+      state.push_back(prices[j]);
+      state.push_back(demands[j]);
+      state.push_back(supplies[j]);
+    }
+    return state;
+  }
   for(unsigned i=0; i<mMarkets.size(); ++i) {
     state.push_back(mMarkets[i]->getMarket( period )->getRawPrice());
     state.push_back(mMarkets[i]->getMarket( period )->getRawDemand());
@@ -1044,6 +1438,7 @@ void Marketplace::logForecastEvaluation( int aPeriod ) const
     solverlog << "\nlast:     \t" << sqrt(fac*ld2)
               << "\nforecast: \t" << sqrt(fac*fd2)
               << "\n\n";
+    mPriceForecaster->print( solverlog );
 
 
     // Same thing for demand.  Should probably refactor all this crap.  Later.
@@ -1120,3 +1515,25 @@ void Marketplace::logForecastEvaluation( int aPeriod ) const
               << "\nforecast: \t" << sqrt(fac*fd2)
               << "\n\n"; 
 }
+
+#if MARKETPLACE_PROFILING
+/*!
+ * \brief Log the number of getPrice, addToSupply, and addToDemand calls and the
+ *        time spent in them for each market since the last call, then reset
+ *        the counts.
+ * \param aPeriod The period which was calculated.
+ * \see MarketplaceProfiler
+ */
+void Marketplace::logProfile( const int aPeriod ) const
+{
+    vector<string> marketNames( mMarkets.size() );
+    for( unsigned i = 0; i < mMarkets.size(); ++i ) {
+        marketNames[ i ] = mMarkets[ i ]->getName();
+    }
+    ILogger& solverlog = ILogger::getLogger( "solver_log" );
+    solverlog.setLevel( ILogger::DEBUG );
+    MarketplaceProfiler& profiler = MarketplaceProfiler::getInstance();
+    profiler.print( solverlog, aPeriod, marketNames );
+    profiler.reset();
+}
+#endif
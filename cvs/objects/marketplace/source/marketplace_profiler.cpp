@@ -0,0 +1,246 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file marketplace_profiler.cpp
+ * \ingroup Objects
+ * \brief MarketplaceProfiler class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#if MARKETPLACE_PROFILING
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+#include "marketplace/include/marketplace_profiler.h"
+
+using namespace std;
+
+//! Constructor
+MarketplaceProfiler::MarketplaceProfiler() {
+}
+
+//! Constructor
+MarketplaceProfiler::Counters::Counters():
+mRegionCacheHits( 0 ),
+mRegionCacheMisses( 0 )
+{
+    fill( mNotFoundCalls, mNotFoundCalls + NUM_OPERATIONS, 0 );
+}
+
+/*!
+ * \brief Get the single instance of the profiler.
+ * \return The profiler.
+ */
+MarketplaceProfiler& MarketplaceProfiler::getInstance() {
+    static MarketplaceProfiler PROFILER;
+    return PROFILER;
+}
+
+//! Get the counters for the calling thread.
+MarketplaceProfiler::Counters& MarketplaceProfiler::getCounters() {
+#if GCAM_PARALLEL_ENABLED
+    return mCounters.local();
+#else
+    return mCounters;
+#endif
+}
+
+/*!
+ * \brief Record a profiled Marketplace call.
+ * \param aOperation The call which was made.
+ * \param aMarketNumber The number of the market or -1 if it was not found.
+ * \param aTime The time spent in the call in seconds.
+ */
+void MarketplaceProfiler::recordCall( const Operation aOperation, const int aMarketNumber,
+                                      const double aTime )
+{
+    Counters& counters = getCounters();
+    if( aMarketNumber < 0 ) {
+        ++counters.mNotFoundCalls[ aOperation ];
+        return;
+    }
+    const size_t index = aMarketNumber * NUM_OPERATIONS + aOperation;
+    if( index >= counters.mCalls.size() ) {
+        counters.mCalls.resize( ( aMarketNumber + 1 ) * NUM_OPERATIONS, 0 );
+        counters.mTimes.resize( ( aMarketNumber + 1 ) * NUM_OPERATIONS, 0.0 );
+    }
+    ++counters.mCalls[ index ];
+    counters.mTimes[ index ] += aTime;
+}
+
+/*!
+ * \brief Record a lookup of a region in the MarketLocator.
+ * \param aWasCached Whether the region was the cached last region looked up.
+ */
+void MarketplaceProfiler::recordRegionLookup( const bool aWasCached ) {
+    Counters& counters = getCounters();
+    if( aWasCached ) {
+        ++counters.mRegionCacheHits;
+    }
+    else {
+        ++counters.mRegionCacheMisses;
+    }
+}
+
+/*!
+ * \brief Record a lookup in the MarketLocator which did not find a market.
+ * \param aRegion The region which was searched for.
+ * \param aGoodName The good which was searched for.
+ */
+void MarketplaceProfiler::recordNotFound( const string& aRegion, const string& aGoodName ) {
+    ++getCounters().mNotFound[ aRegion + ", " + aGoodName ];
+}
+
+//! Combine the counters from all threads.
+MarketplaceProfiler::Counters MarketplaceProfiler::getTotal() const {
+#if GCAM_PARALLEL_ENABLED
+    Counters total;
+    for( const Counters& counters : mCounters ) {
+        if( counters.mCalls.size() > total.mCalls.size() ) {
+            total.mCalls.resize( counters.mCalls.size(), 0 );
+            total.mTimes.resize( counters.mTimes.size(), 0.0 );
+        }
+        for( size_t i = 0; i < counters.mCalls.size(); ++i ) {
+            total.mCalls[ i ] += counters.mCalls[ i ];
+            total.mTimes[ i ] += counters.mTimes[ i ];
+        }
+        for( int op = 0; op < NUM_OPERATIONS; ++op ) {
+            total.mNotFoundCalls[ op ] += counters.mNotFoundCalls[ op ];
+        }
+        total.mRegionCacheHits += counters.mRegionCacheHits;
+        total.mRegionCacheMisses += counters.mRegionCacheMisses;
+        for( const auto& notFound : counters.mNotFound ) {
+            total.mNotFound[ notFound.first ] += notFound.second;
+        }
+    }
+    return total;
+#else
+    return mCounters;
+#endif
+}
+
+/*!
+ * \brief Write the counts recorded since the last reset.
+ * \details The markets are listed from most to least called along with a
+ *          histogram of the number of markets by the number of calls made to
+ *          them, in powers of two.
+ * \param aOut The stream to write to.
+ * \param aPeriod The period which was calculated.
+ * \param aMarketNames The name of each market by market number.
+ */
+void MarketplaceProfiler::print( ostream& aOut, const int aPeriod,
+                                 const vector<string>& aMarketNames ) const
+{
+    const Counters total = getTotal();
+    const size_t numMarkets = total.mCalls.size() / NUM_OPERATIONS;
+    
+    // Sort the markets by the total number of calls.
+    vector<pair<unsigned long, size_t> > marketCalls;
+    unsigned long totalCalls = 0;
+    double totalTime = 0.0;
+    for( size_t i = 0; i < numMarkets; ++i ) {
+        unsigned long calls = 0;
+        for( int op = 0; op < NUM_OPERATIONS; ++op ) {
+            calls += total.mCalls[ i * NUM_OPERATIONS + op ];
+            totalTime += total.mTimes[ i * NUM_OPERATIONS + op ];
+        }
+        if( calls > 0 ) {
+            marketCalls.push_back( make_pair( calls, i ) );
+            totalCalls += calls;
+        }
+    }
+    sort( marketCalls.begin(), marketCalls.end(),
+          []( const pair<unsigned long, size_t>& aLHS, const pair<unsigned long, size_t>& aRHS ) {
+              return aLHS.first > aRHS.first;
+          } );
+    
+    aOut << "\nPeriod " << aPeriod << " marketplace calls: " << totalCalls
+         << " in " << totalTime << " seconds\n"
+         << "get-price  \tadd-supply \tadd-demand \ttime (s)   \n";
+    for( const auto& entry : marketCalls ) {
+        const size_t i = entry.second;
+        double time = 0.0;
+        for( int op = 0; op < NUM_OPERATIONS; ++op ) {
+            aOut << setw( 11 ) << total.mCalls[ i * NUM_OPERATIONS + op ] << "\t";
+            time += total.mTimes[ i * NUM_OPERATIONS + op ];
+        }
+        aOut << setw( 11 ) << time << "\t> "
+             << ( i < aMarketNames.size() ? aMarketNames[ i ] : "unknown" ) << "\n";
+    }
+    
+    // Histogram of the number of markets by calls, bin k holds [2^k, 2^(k+1)).
+    vector<size_t> histogram;
+    for( const auto& entry : marketCalls ) {
+        size_t bin = 0;
+        for( unsigned long calls = entry.first; calls > 1; calls >>= 1 ) {
+            ++bin;
+        }
+        if( bin >= histogram.size() ) {
+            histogram.resize( bin + 1, 0 );
+        }
+        ++histogram[ bin ];
+    }
+    aOut << "\nNumber of markets by calls:\n";
+    for( size_t bin = 0; bin < histogram.size(); ++bin ) {
+        aOut << setw( 11 ) << ( 1UL << bin ) << "\t" << histogram[ bin ] << "\n";
+    }
+    
+    aOut << "\nCalls with no market: "
+         << total.mNotFoundCalls[ GET_PRICE ] << " get-price, "
+         << total.mNotFoundCalls[ ADD_TO_SUPPLY ] << " add-supply, "
+         << total.mNotFoundCalls[ ADD_TO_DEMAND ] << " add-demand\n"
+         << "Region lookups: " << total.mRegionCacheHits << " cached, "
+         << total.mRegionCacheMisses << " searched\n";
+    for( const auto& notFound : total.mNotFound ) {
+        aOut << setw( 11 ) << notFound.second << "\tnot found > " << notFound.first << "\n";
+    }
+    aOut << endl;
+}
+
+/*!
+ * \brief Clear all of the counters.
+ * \details This must not be called while a World::calc is running.
+ */
+void MarketplaceProfiler::reset() {
+#if GCAM_PARALLEL_ENABLED
+    mCounters.clear();
+#else
+    mCounters = Counters();
+#endif
+}
+
+#endif // MARKETPLACE_PROFILING
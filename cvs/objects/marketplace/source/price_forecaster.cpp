@@ -0,0 +1,319 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file price_forecaster.cpp
+ * \ingroup Objects
+ * \brief PriceForecaster class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include "marketplace/include/price_forecaster.h"
+#include "marketplace/include/market_container.h"
+#include "marketplace/include/market.h"
+#include "util/base/include/configuration.h"
+
+using namespace std;
+
+const string& CurvatureExtrapolator::getName() const {
+    const static string NAME = "curvature";
+    return NAME;
+}
+
+bool CurvatureExtrapolator::forecast( const MarketContainer* aMarket, const int aPeriod,
+                                      double& aForecast ) const
+{
+    aForecast = aMarket->extrapolate( aPeriod, &Market::getRawPrice );
+    return true;
+}
+
+const string& LinearExtrapolator::getName() const {
+    const static string NAME = "linear";
+    return NAME;
+}
+
+bool LinearExtrapolator::forecast( const MarketContainer* aMarket, const int aPeriod,
+                                   double& aForecast ) const
+{
+    double x[ 3 ], y[ 3 ];
+    const double year = aMarket->getHistory( aPeriod, &Market::getRawPrice, x, y );
+    aForecast = y[ 2 ] + ( y[ 2 ] - y[ 1 ] ) / ( x[ 2 ] - x[ 1 ] ) * ( year - x[ 2 ] );
+    return true;
+}
+
+const string& LogLinearExtrapolator::getName() const {
+    const static string NAME = "log-linear";
+    return NAME;
+}
+
+bool LogLinearExtrapolator::forecast( const MarketContainer* aMarket, const int aPeriod,
+                                      double& aForecast ) const
+{
+    double x[ 3 ], y[ 3 ];
+    const double year = aMarket->getHistory( aPeriod, &Market::getRawPrice, x, y );
+    if( y[ 1 ] <= 0.0 || y[ 2 ] <= 0.0 ) {
+        return false;
+    }
+    aForecast = y[ 2 ] * pow( y[ 2 ] / y[ 1 ], ( year - x[ 2 ] ) / ( x[ 2 ] - x[ 1 ] ) );
+    return true;
+}
+
+const string& ReferenceExtrapolator::getName() const {
+    const static string NAME = "reference";
+    return NAME;
+}
+
+bool ReferenceExtrapolator::forecast( const MarketContainer* aMarket, const int aPeriod,
+                                      double& aForecast ) const
+{
+    return PriceForecaster::getReferencePrice( aMarket->getName(), aPeriod, aForecast );
+}
+
+//! Constructor
+PriceForecaster::PriceForecaster():
+mUseReference( false ),
+mErrorSums( IMarketType::END ),
+mErrorCounts( IMarketType::END )
+{
+    mExtrapolators.push_back( new CurvatureExtrapolator() );
+    mExtrapolators.push_back( new LinearExtrapolator() );
+    mExtrapolators.push_back( new LogLinearExtrapolator() );
+    mExtrapolators.push_back( new ReferenceExtrapolator() );
+    for( int type = 0; type < IMarketType::END; ++type ) {
+        mErrorSums[ type ].resize( mExtrapolators.size(), 0.0 );
+        mErrorCounts[ type ].resize( mExtrapolators.size(), 0 );
+    }
+}
+
+//! Destructor
+PriceForecaster::~PriceForecaster() {
+    for( auto extrapolator : mExtrapolators ) {
+        delete extrapolator;
+    }
+}
+
+/*!
+ * \brief Accumulate the error each method would have made forecasting the
+ *        prices of the previous period.
+ * \details This must be called before forecasting the prices of aPeriod.  The
+ *          errors are cleared when the first period with a forecast starts
+ *          so that a scenario which is run again starts over.  When a later
+ *          period is run again the errors are first reset to those saved for
+ *          the period before it, which discards any accumulated by the
+ *          periods past it in the previous run.
+ * \param aMarkets The markets in the marketplace.
+ * \param aPeriod The period which is about to be forecast.
+ */
+void PriceForecaster::updateErrors( const vector<MarketContainer*>& aMarkets, const int aPeriod ) {
+    if( aPeriod <= 1 ) {
+        mUseReference = Configuration::getInstance()->getBool( "forecastFromReference", false, false );
+        // A new scenario run is starting so the prices stored during the last
+        // run become the reference.
+        map<string, vector<double> >& currentPrices = getPricesFromRun( false );
+        map<string, vector<double> >& referencePrices = getPricesFromRun( true );
+        for( auto& prices : currentPrices ) {
+            referencePrices[ prices.first ].swap( prices.second );
+        }
+        currentPrices.clear();
+        for( int type = 0; type < IMarketType::END; ++type ) {
+            fill( mErrorSums[ type ].begin(), mErrorSums[ type ].end(), 0.0 );
+            fill( mErrorCounts[ type ].begin(), mErrorCounts[ type ].end(), 0 );
+        }
+        mPeriodErrorSums.assign( aPeriod + 1, mErrorSums );
+        mPeriodErrorCounts.assign( aPeriod + 1, mErrorCounts );
+        // There is no history to forecast the previous period from.
+        return;
+    }
+    
+    // Start from the errors as of the previous period in case this period has
+    // been run before.
+    if( static_cast<int>( mPeriodErrorSums.size() ) >= aPeriod ) {
+        mErrorSums = mPeriodErrorSums[ aPeriod - 1 ];
+        mErrorCounts = mPeriodErrorCounts[ aPeriod - 1 ];
+    }
+    
+    // The same small value logForecastEvaluation uses for prices near zero.
+    const double SMALL_PRICE = 0.1;
+    const int forecastPeriod = aPeriod - 1;
+    for( auto marketContainer : aMarkets ) {
+        const Market* market = marketContainer->getMarket( forecastPeriod );
+        if( !market->shouldSolve() ) {
+            continue;
+        }
+        const double actual = market->getRawPrice();
+        const IMarketType::Type type = market->getType();
+        for( size_t method = 0; method < mExtrapolators.size(); ++method ) {
+            double forecast;
+            if( isMethodAvailable( method ) &&
+                mExtrapolators[ method ]->forecast( marketContainer, forecastPeriod, forecast ) )
+            {
+                mErrorSums[ type ][ method ] += fabs( forecast - actual ) / ( fabs( actual ) + SMALL_PRICE );
+                ++mErrorCounts[ type ][ method ];
+            }
+        }
+    }
+    
+    mPeriodErrorSums.resize( aPeriod + 1 );
+    mPeriodErrorCounts.resize( aPeriod + 1 );
+    mPeriodErrorSums[ aPeriod ] = mErrorSums;
+    mPeriodErrorCounts[ aPeriod ] = mErrorCounts;
+}
+
+/*!
+ * \brief Forecast the price of a market.
+ * \param aMarket The market to forecast.
+ * \param aPeriod The period to forecast, which must be greater than zero.
+ * \return The forecasted price.
+ */
+double PriceForecaster::forecastPrice( const MarketContainer* aMarket, const int aPeriod ) const {
+    const size_t method = getBestMethod( aMarket->getMarket( aPeriod )->getType() );
+    double forecast;
+    if( method == 0 || !mExtrapolators[ method ]->forecast( aMarket, aPeriod, forecast ) ) {
+        mExtrapolators[ 0 ]->forecast( aMarket, aPeriod, forecast );
+    }
+    return forecast;
+}
+
+/*!
+ * \brief Get the method with the least mean error for a market type.
+ * \param aType The market type.
+ * \return The index of the method, 0 if there are no errors for the type.
+ */
+size_t PriceForecaster::getBestMethod( const IMarketType::Type aType ) const {
+    size_t bestMethod = 0;
+    double bestError = -1.0;
+    for( size_t method = 0; method < mExtrapolators.size(); ++method ) {
+        const int count = mErrorCounts[ aType ][ method ];
+        if( count > 0 ) {
+            const double error = mErrorSums[ aType ][ method ] / count;
+            if( bestError < 0.0 || error < bestError ) {
+                bestError = error;
+                bestMethod = method;
+            }
+        }
+    }
+    return bestMethod;
+}
+
+/*!
+ * \brief Whether a method may be used in this scenario.
+ * \param aMethod The index of the method.
+ * \return False for the reference scenario method unless it is turned on.
+ */
+bool PriceForecaster::isMethodAvailable( const size_t aMethod ) const {
+    return mUseReference || !dynamic_cast<const ReferenceExtrapolator*>( mExtrapolators[ aMethod ] );
+}
+
+/*!
+ * \brief Write the mean error of each method by market type along with the
+ *        method which is used.
+ * \param aOut The stream to write to.
+ */
+void PriceForecaster::print( ostream& aOut ) const {
+    aOut << "\nMean price forecast errors by market type:\n";
+    for( size_t method = 0; method < mExtrapolators.size(); ++method ) {
+        aOut << setw( 11 ) << mExtrapolators[ method ]->getName() << "\t";
+    }
+    aOut << "method used\n";
+    for( int type = 0; type < IMarketType::END; ++type ) {
+        bool hasErrors = false;
+        for( size_t method = 0; method < mExtrapolators.size(); ++method ) {
+            const int count = mErrorCounts[ type ][ method ];
+            hasErrors = hasErrors || count > 0;
+            aOut << setw( 11 ) << ( count > 0 ? mErrorSums[ type ][ method ] / count : 0.0 ) << "\t";
+        }
+        if( hasErrors ) {
+            aOut << mExtrapolators[ getBestMethod( static_cast<IMarketType::Type>( type ) ) ]->getName()
+                 << "  > " << Market::convert_type_to_string( static_cast<IMarketType::Type>( type ) ) << "\n";
+        }
+        else {
+            aOut << "none  > " << Market::convert_type_to_string( static_cast<IMarketType::Type>( type ) ) << "\n";
+        }
+    }
+}
+
+/*!
+ * \brief Save the prices the markets solved to so that they may be used as
+ *        the reference for a later scenario run.
+ * \details The prices only become the reference once the next run starts so
+ *          that the reference method is not scored against its own prices.
+ * \param aMarkets The markets in the marketplace.
+ * \param aPeriod The period which was solved.
+ */
+void PriceForecaster::storeReferencePrices( const vector<MarketContainer*>& aMarkets, const int aPeriod ) {
+    map<string, vector<double> >& currentPrices = getPricesFromRun( false );
+    for( auto marketContainer : aMarkets ) {
+        vector<double>& prices = currentPrices[ marketContainer->getName() ];
+        if( static_cast<int>( prices.size() ) <= aPeriod ) {
+            prices.resize( marketContainer->size(), 0.0 );
+        }
+        prices[ aPeriod ] = marketContainer->getMarket( aPeriod )->getRawPrice();
+    }
+}
+
+/*!
+ * \brief Get the price a market solved to in a previous scenario run.
+ * \param aMarketName The name of the market.
+ * \param aPeriod The period.
+ * \param aPrice The reference price.
+ * \return Whether there was a reference price.
+ */
+bool PriceForecaster::getReferencePrice( const string& aMarketName, const int aPeriod, double& aPrice ) {
+    const map<string, vector<double> >& referencePrices = getPricesFromRun( true );
+    map<string, vector<double> >::const_iterator iter = referencePrices.find( aMarketName );
+    if( iter == referencePrices.end() || static_cast<int>( iter->second.size() ) <= aPeriod ||
+        iter->second[ aPeriod ] == 0.0 )
+    {
+        return false;
+    }
+    aPrice = iter->second[ aPeriod ];
+    return true;
+}
+
+/*!
+ * \brief Get the solved prices by market name and period which are kept
+ *        between scenario runs.
+ * \param aIsReference Whether to get the prices from the previous runs, which
+ *        are the reference, or from the current run.
+ * \return The prices.
+ */
+map<string, vector<double> >& PriceForecaster::getPricesFromRun( const bool aIsReference ) {
+    static map<string, vector<double> > REFERENCE_PRICES;
+    static map<string, vector<double> > CURRENT_PRICES;
+    return aIsReference ? REFERENCE_PRICES : CURRENT_PRICES;
+}
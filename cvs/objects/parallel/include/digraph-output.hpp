@@ -42,11 +42,17 @@
 // nodeid type to have an operator<< defined, so don't include this
 // file unless that is the case.
 
-/*! \brief Write a detailed representation of a graph to a stream
- *! \details Output will be in graphvis dot format
+/*! \brief Write a representation of the part of a graph selected by a filter
+ *! \details Output will be in graphvis dot format.  Only nodes for which
+ *!          aInclude returns true are written along with the edges between
+ *!          them, which keeps the output small enough to be useful for large
+ *!          graphs.
+ *! \param o The output stream to write to.
+ *! \param G The graph to write.
+ *! \param aInclude A predicate on the nodeid which selects the nodes to write.
  */
-template <class nodeid_t>
-void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G)
+template <class nodeid_t, class include_t>
+void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G, include_t aInclude)
 {
   typedef digraph<nodeid_t> graph;
 
@@ -57,6 +63,9 @@ void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G)
   for(typename graph::nodelist_c_iter_t nodeit = G.nodelist().begin();
       nodeit != G.nodelist().end(); ++nodeit) {
     nodeid_t nodeid = nodeit->first;
+    if(!aInclude(nodeid)) {
+      continue;
+    }
     const typename graph::node_t & node = nodeit->second;
 
     // print for all nodes the nodeid with the label
@@ -68,6 +77,9 @@ void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G)
     for(typename std::set<nodeid_t>::const_iterator childit = node.successors.begin();
         childit != node.successors.end(); ++childit) {
       nodeid_t childid = *childit;
+      if(!aInclude(childid)) {
+        continue;
+      }
       
       // output a line defining the edge between node and child
       o << "\t";
@@ -82,6 +94,21 @@ void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G)
   o << "}\n";
 }
 
+/*! \brief Predicate for write_as_dot which selects every node. */
+template <class nodeid_t>
+struct include_all_nodes {
+  bool operator()(const nodeid_t &) const {return true;}
+};
+
+/*! \brief Write a detailed representation of a graph to a stream
+ *! \details Output will be in graphvis dot format
+ */
+template <class nodeid_t>
+void write_as_dot(std::ostream &o, const digraph<nodeid_t> &G)
+{
+  write_as_dot(o, G, include_all_nodes<nodeid_t>());
+}
+
 /*! \brief Write detailed representation of graph to a file
  *! \details This is just a wrapper around write_as_dot()
  *! \sa write_as_dot
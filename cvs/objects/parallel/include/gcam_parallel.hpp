@@ -38,16 +38,22 @@
 /* standard headers */
 #include <list>
 #include <set>
+#include <map>
+#include <vector>
+#include <string>
+#include <atomic>
 
 /* graph analysis headers */
 #include "parallel/include/digraph.hpp"
 
 /* TBB headers */
 #include <tbb/flow_graph.h>
+#include <tbb/task_group.h>
 
 // Forward declare when possible
 class IActivity;
 class MarketDependencyFinder;
+class ActivityProfiler;
 
 /*!
  * \brief Class to package all of the information we need to carry around to use the flow graph
@@ -59,7 +65,8 @@ class GcamFlowGraph {
     friend class MarketDependencyFinder;
 private:
     //! Private constructor to only allow select classes to create flow graphs.
-    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ) {}
+    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ),
+        mIsProfiling( false ), mNumCalcsToProfile( 0 ), mNumCalcsProfiled( 0 ), mProfiler( 0 ), mUseSchedule( false ) {}
     
     //! The TBB calculation flow graph.
     tbb::flow::graph mTBBFlowGraph;
@@ -75,6 +82,51 @@ private:
     //! not be calculated for sub-graphs.  Note when null it implies all activities
     //! will be calculated.
     const std::vector<IActivity*>* mCalcList;
+    
+    //! Flags by index in the global ordering of the activities in mCalcList so
+    //! that the grains can check them without searching the list.
+    std::vector<bool> mIsInCalcList;
+    
+    //! Whether the time spent calculating each activity is currently being
+    //! accumulated into mActivityTimes.
+    bool mIsProfiling;
+    
+    //! The number of full model calculations which remain to be profiled.
+    int mNumCalcsToProfile;
+    
+    //! The number of full model calculations included in mActivityTimes.
+    int mNumCalcsProfiled;
+    
+    //! The total time in seconds spent calculating each activity by index in the
+    //! global ordering.  Each element is only written by the thread calculating
+    //! the grain that contains the activity.
+    mutable std::vector<double> mActivityTimes;
+    
+    //! The profiler which measures each activity calculated, or null if not profiling.
+    ActivityProfiler* mProfiler;
+    
+    //! Whether to calculate using the grain schedule and a TBB task group
+    //! rather than the TBB flow graph.
+    bool mUseSchedule;
+    
+    //! The activities in each grain in the order they are calculated.
+    std::vector<std::vector<IActivity*> > mGrainNodes;
+    
+    //! The index in the global ordering of each activity in mGrainNodes.
+    std::vector<std::vector<int> > mGrainIndices;
+    
+    //! The grains which depend on each grain.
+    std::vector<std::vector<int> > mGrainSuccessors;
+    
+    //! The number of grains each grain depends on.
+    std::vector<int> mNumPredecessors;
+    
+    //! The grains which do not depend on any other grain.
+    std::vector<int> mSourceGrains;
+    
+    //! The number of predecessors of each grain which have not yet been
+    //! calculated in the current schedule run.
+    std::vector<std::atomic<int> > mPendingPredecessors;
 };
 
 /*!
@@ -94,6 +146,23 @@ public:
     //! Flow graph of calc vertex dependencies for parallel analysis
     typedef digraph<FlowGraphNodeType> FlowGraph;
     
+    /*!
+     * \brief The grains of a flow graph in a form which does not depend on the
+     *        addresses of the activities.
+     * \details Activities are identified by their index in the global ordering
+     *          and grains by their index in mGrains so that the grains found in
+     *          one run can be saved and used to build the same flow graph in a
+     *          later one without parsing the graph again.
+     */
+    struct GrainList {
+        //! The index in the global ordering of the activities in each grain in
+        //! the order in which they are calculated.
+        std::vector<std::vector<int> > mGrains;
+        
+        //! The indices in mGrains of the grains which depend on each grain.
+        std::vector<std::vector<int> > mSuccessors;
+    };
+    
     GcamParallel();
     
     /* Graph analysis and parsing methods */
@@ -104,8 +173,41 @@ public:
     void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
                                  const std::vector<FlowGraphNodeType>& aCalcItems );
     
+    void collectGrains( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                        const std::vector<FlowGraphNodeType>* aCalcItems = 0 ) const;
+    
+    void makeGrainList( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
+                        const std::vector<FlowGraphNodeType>& aGlobalOrdering,
+                        GrainList& aGrainList ) const;
+    
     void makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
+                           const std::vector<FlowGraphNodeType>& aGlobalOrdering,
+                           GcamFlowGraph& aTBBGraph );
+    
+    void makeTBBFlowGraph( const GrainList& aGrainList,
+                           const std::vector<FlowGraphNodeType>& aGlobalOrdering,
                            GcamFlowGraph& aTBBGraph );
+    
+    /* Grain cache methods */
+    size_t hashSettings( size_t aHash ) const;
+    
+    static bool readGrainLists( const std::string& aFileName, const size_t aHash,
+                                std::map<int, GrainList>& aGrainLists );
+    
+    static void writeGrainLists( const std::string& aFileName, const size_t aHash,
+                                 const std::map<int, GrainList>& aGrainLists );
+    
+    /* Activity cost profiling methods */
+    void startActivityProfiling( GcamFlowGraph& aTBBGraph, const size_t aNumActivities ) const;
+    
+    static void writeActivityCosts( const GcamFlowGraph& aTBBGraph,
+                                    const std::vector<FlowGraphNodeType>& aGlobalOrdering );
+    
+    /* Calculation methods */
+    static void setCalcList( GcamFlowGraph& aTBBGraph, const std::vector<FlowGraphNodeType>* aCalcList,
+                             const std::vector<FlowGraphNodeType>& aGlobalOrdering );
+    
+    static void calcSchedule( GcamFlowGraph& aTBBGraph );
   
 protected:
     //! Helper class for sorting lists in topological order
@@ -125,27 +227,51 @@ protected:
      *
      * \details This structure defines a grain of work for TBB.  We will
      * place a bunch of these into a tbb::flow::graph structure, and TBB
-     * will take care of the dispatch.  What this structure has to do is
-     * to provide a way to execute the calculation vertices in the
-     * topologically correct order.  We do that by taking in the set of
-     * vertices and the graph structure that defines the topology.  From
-     * that we can create a list that is sorted in topological order.
-     * After that, the body struct no longer needs the graph.
+     * will take care of the dispatch.  The activities of the grain are
+     * kept in the GcamFlowGraph, already sorted in topological order by
+     * makeGrainList, so all this structure has to do is to calculate them
+     * with calcGrain.
      */
     struct TBBFlowGraphBody {
-        TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes, const FlowGraph& aTopology,
-                          const GcamFlowGraph& aGraph );
+        TBBFlowGraphBody( const size_t aGrain, const GcamFlowGraph& aGraph )
+            : mGrain( aGrain ), mGraph( aGraph ) {}
         
         void operator()( tbb::flow::continue_msg aMessage );
 
-        //! The list of activities which will be calculated when TBB calls this class
-        //! to execute.
-        std::list<FlowGraphNodeType> mNodes;
+        //! The index of the grain which will be calculated when TBB calls this
+        //! class to execute.
+        size_t mGrain;
         
         //! A reference to the TBB flow graph to which this node belongs.
         const GcamFlowGraph& mGraph;
     };
     
+    /*!
+     * \brief A task which calculates a grain of the schedule.
+     * \details When the grain is done the pending predecessor count of each
+     *          successor is decremented and those which reach zero are ready.
+     *          One ready successor is calculated by the same task, which saves
+     *          a spawn and keeps its data warm in cache, and the rest are added
+     *          to the task group where idle threads can steal them.
+     */
+    struct ScheduledGrain {
+        ScheduledGrain( const size_t aGrain, GcamFlowGraph& aGraph, tbb::task_group& aGroup )
+            : mGrain( aGrain ), mGraph( aGraph ), mGroup( aGroup ) {}
+        
+        void operator()() const;
+        
+        //! The index of the first grain to calculate.
+        size_t mGrain;
+        
+        //! The flow graph to which the grain belongs.
+        GcamFlowGraph& mGraph;
+        
+        //! The task group running the schedule.
+        tbb::task_group& mGroup;
+    };
+    
+    static void calcGrain( const GcamFlowGraph& aGraph, const size_t aGrain );
+    
     /* data members */
     
     /*!
@@ -161,8 +287,23 @@ protected:
     //! Default grain size
     static const int DEFAULT_GRAIN_SIZE;
     
-    // right now, grain size is the only parameter in the heuristics.
-    // We may add more later.
+    //! Whether flow graphs should be calculated using the grain schedule rather
+    //! than the TBB flow graph, as set by the configuration parallel-executor.
+    bool mUseSchedule;
+    
+    /*!
+     * \brief The measured cost of each activity by description.
+     * \details These are read from the file given by the configuration
+     *          parallelCostInputFileName, as written by writeActivityCosts,
+     *          and are in seconds per calculation.  When available the grain
+     *          collection measures the size of a grain by the cost of its
+     *          activities rather than their number.
+     */
+    std::map<std::string, double> mActivityCosts;
+    
+    void readActivityCosts();
+    
+    bool makeCostWeights( const FlowGraph& aGraph, std::vector<double>& aWeights ) const;
 };
 
   
@@ -37,6 +37,7 @@
 #include "parallel/include/clanid.hpp"
 #include "parallel/include/bitvector.hpp"
 #include <sstream>
+#include <vector>
 
 template<class T> T* unique_nodetitle(T* bestnode, size_t setsize)
 {
@@ -109,12 +110,38 @@ nodeid_t grain_title(const bitvector &nodeset, const digraph<nodeid_t> &topology
 }
 
 
+/* Measure the size of a set of nodes
+ *
+ * Without weights this is just the number of nodes.  With weights
+ * (indexed by topological index, like the bitvectors themselves) it
+ * is the sum of the weights of the nodes, so that a node which is
+ * expensive to compute counts for more than one which isn't.  The
+ * weights should be scaled so that a typical node weighs about 1;
+ * that way the grain size has the same meaning either way.
+ */
+inline double grain_cost(const bitvector &nodeset, const std::vector<double> *weights)
+{
+  if(!weights)
+    return nodeset.count();
+
+  double cost = 0.0;
+  bitvector_iterator nodeit(&nodeset);
+  while(nodeit.next())
+    cost += (*weights)[nodeit.bindex()];
+  return cost;
+}
+
+
 template<class nodeid_t>
 void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
                    const typename digraph<clanid<nodeid_t> >::nodelist_c_iter_t &claniterator,
                    digraph <nodeid_t> &GrainGraph,
-                   unsigned grain_min)
+                   unsigned grain_min,
+                   const std::vector<double> *weights = 0)
 {
+  /* If weights are given, all of the sizes below are measured as the
+     sum of the weights of the nodes (see grain_cost) rather than the
+     number of nodes. */
   // define the clanid type
   typedef clanid<nodeid_t> Clanid;
   // get the topology from the clan struct
@@ -146,10 +173,10 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     {
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
-      unsigned nsub = subclan->nodes().count();
+      double nsub = grain_cost(subclan->nodes(), weights);
       // search large subclans for grains
       if(nsub >= grain_min)
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, weights);
       else
         node_group.setunion(subclan->nodes());
     }
@@ -160,8 +187,8 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     // exactly, since we don't know the distribution of the sizes of
     // the leftover clans.  We'll guess that they're pretty uniform
     // and build heuristics around that.
-    int nnode = node_group.count(); // cache the number of nodes in the group.  Be careful to update whenever we change the group membership!
-    int nbreakup = nnode / grain_min;
+    double nnode = grain_cost(node_group, weights); // cache the size of the group.  Be careful to update whenever we change the group membership!
+    int nbreakup = int(nnode / grain_min);
     if(nbreakup < 2 && nnode >= ind_split_min )
       // fudge the minimum grain size a little for extra parallelism.
       // It was probably just a guess anyhow.
@@ -169,19 +196,24 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
 
     if(nbreakup > 1) {
       // this will be the approximate size of the new grains we will make.
-      unsigned grain_size_thresh = nnode / nbreakup;
+      double grain_size_thresh = nnode / nbreakup;
       node_group.clearall();       // nnode no lonber valid!
+      double group_cost = 0.0;     // the subclans are disjoint, so their costs just add up
       for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
-          subclan != claniterator->second.successors.end(); ++subclan)
-        if(subclan->nodes().count() < grain_min) { // skip the ones that were already processed above
+          subclan != claniterator->second.successors.end(); ++subclan) {
+        double nsub = grain_cost(subclan->nodes(), weights);
+        if(nsub < grain_min) { // skip the ones that were already processed above
           node_group.setunion(subclan->nodes());
-          if(node_group.count() >= grain_size_thresh) {
+          group_cost += nsub;
+          if(group_cost >= grain_size_thresh) {
             // have enough for a grain
             grain_name = grain_title(node_group, topology);
             GrainGraph.collapse_subgraph(topology.convert_to_set(node_group), grain_name);
             node_group.clearall();   // start the next grain
+            group_cost = 0.0;
           }
         }
+      }
     }
     
     if(!node_group.empty()) {
@@ -213,7 +245,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
       if( (subclan->type == independent || subclan->type == pseudoindependent) &&
-          subclan->nodes().count() >= ind_split_min ) {
+          grain_cost(subclan->nodes(), weights) >= ind_split_min ) {
         // only recurse on independent clans that are guaranteed to
         // split (an independent could split with as few as
         // grain_min+1 clans, but it's not guaranteed and rarely
@@ -226,7 +258,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
           node_group.clearall();   // start the next grain
         }
         // then recurse on the subclan
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, weights);
       }
       else {
         // add this clan's nodes to the node group
@@ -0,0 +1,122 @@
+#ifndef _PARALLEL_BENCHMARK_HPP_
+#define _PARALLEL_BENCHMARK_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file parallel_benchmark.hpp
+ * \ingroup Objects
+ * \brief ParallelBenchmark class header file.
+ */
+
+#include <string>
+#include <vector>
+#include "util/base/include/state_snapshot.h"
+
+class World;
+class Marketplace;
+class SolutionInfoParamParser;
+
+/*!
+ * \ingroup Objects
+ * \brief Times the parallel parts of the model calculation at increasing numbers
+ *        of threads.
+ * \details When the configuration benchmark-period is set the Scenario runs this
+ *          once that period is initialized and before it is solved.  Each
+ *          measurement is run at 1, 2, 4, ... threads up to the size of the
+ *          ManageStateVariables thread pool, benchmark-repeats times each, and
+ *          starts from the same state which is restored again when the benchmark
+ *          is done so that the period then solves as it would have otherwise.
+ *          The measurements are:
+ *            - world-calc-ordering: World::calc over the global ordering.
+ *            - world-calc-flow-graph: World::calc using the global flow graph
+ *              (only when GCAM_PARALLEL_ENABLED).
+ *            - fdjac: one finite difference Jacobian of the solvable markets.
+ *            - broyden: LogBroyden limited to a single iteration, which includes
+ *              its initial Jacobian.
+ *
+ *          The wall clock times are written as CSV to the file benchmark-output.
+ *          Without GCAM_PARALLEL_ENABLED only the single thread case is run.
+ */
+class ParallelBenchmark {
+public:
+    ParallelBenchmark( World* aWorld, Marketplace* aMarketplace );
+    
+    void run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser );
+    
+private:
+    //! A single timed run.
+    struct Measurement {
+        //! The name of what was timed.
+        std::string mName;
+        
+        //! The number of threads allowed.
+        int mNumThreads;
+        
+        //! The repetition of this measurement.
+        int mRepeat;
+        
+        //! The wall clock time in seconds.
+        double mSeconds;
+    };
+    
+    //! The world to calculate.
+    World* mWorld;
+    
+    //! The marketplace to calculate.
+    Marketplace* mMarketplace;
+    
+    //! The state at the start of the benchmark which each measurement starts from.
+    StateSnapshot mInitialState;
+    
+    //! The times measured.
+    std::vector<Measurement> mMeasurements;
+    
+    std::vector<int> getThreadCounts() const;
+    
+    void resetState() const;
+    
+    void runMeasurements( const int aPeriod, const int aNumThreads, const int aRepeat,
+                          const SolutionInfoParamParser* aSolutionInfoParamParser );
+    
+    void addMeasurement( const std::string& aName, const int aNumThreads, const int aRepeat,
+                         const double aSeconds );
+    
+    void writeResults( const int aPeriod ) const;
+};
+
+#endif // _PARALLEL_BENCHMARK_HPP_
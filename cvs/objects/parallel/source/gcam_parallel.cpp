@@ -32,6 +32,11 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include <map>
+#include <fstream>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <boost/functional/hash.hpp>
 /* gcam headers */
 #include "parallel/include/gcam_parallel.hpp"
 #include "util/base/include/configuration.h"
@@ -40,7 +45,12 @@
 #include "containers/include/market_dependency_finder.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/tracepoints.h"
 #include "util/base/include/auto_file.h"
+#include "containers/include/scenario.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/market_accumulator.h"
+#include "solution/util/include/activity_profiler.h"
 /* more graph analysis headers */
 #include "parallel/include/clanid.hpp"
 #include "parallel/include/graph-parse.hpp"
@@ -49,6 +59,8 @@
 
 using namespace std;
 
+extern Scenario* scenario;
+
 const int GcamParallel::DEFAULT_GRAIN_SIZE = 30;
 
 /*!
@@ -56,7 +68,9 @@ const int GcamParallel::DEFAULT_GRAIN_SIZE = 30;
  *
  * \details Checks configuration for parallel-grain-size tag.  If so,
  *            uses it to set mGrain_size_tgt; if not, uses the default
- *            value. 
+ *            value.  The parallel-executor tag selects how flow graphs
+ *            are calculated: "flow-graph" (the default) uses the TBB
+ *            flow graph and "schedule" uses calcSchedule.
  * \remark Grain size is currently the only configurable parameter,
  *         but others may be added in the future.  Consider
  *         configuration parameter names starting with "parallel-" to
@@ -64,7 +78,16 @@ const int GcamParallel::DEFAULT_GRAIN_SIZE = 30;
  */
 GcamParallel::GcamParallel()
 {
-    mGrainSizeTarget = Configuration::getInstance()->getInt( "parallel-grain-size", DEFAULT_GRAIN_SIZE );
+    const Configuration* conf = Configuration::getInstance();
+    mGrainSizeTarget = conf->getInt( "parallel-grain-size", DEFAULT_GRAIN_SIZE );
+    const string executor = conf->getString( "parallel-executor", "flow-graph", false );
+    mUseSchedule = executor == "schedule";
+    if( !mUseSchedule && executor != "flow-graph" ) {
+        ILogger& mainlog = ILogger::getLogger( "main_log" );
+        mainlog.setLevel( ILogger::WARNING );
+        mainlog << "Unknown parallel-executor " << executor << ", using flow-graph." << endl;
+    }
+    readActivityCosts();
 }
   
 
@@ -161,40 +184,33 @@ void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyF
  */
 void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph )
 {
-    // some intermediate types involving "clans".  These will hold the
-    // intermediate results of the parsing.
-    typedef clanid<FlowGraphNodeType> ClanidType;
-    typedef digraph<ClanidType> ClanTree;
-
     AutoOutputFile graphFile( "flow-graph", "gcam-flow-graph.dot" );
-    write_as_dot( *graphFile, aGCAMFlowGraph );
+    if( graphFile.shouldWrite() ) {
+        // Optionally only write the activities whose description starts with
+        // the filter, i.e. one region or one region's sector.
+        const string& filter = Configuration::getInstance()->getString( "flow-graph-filter", "", false );
+        if( filter.empty() ) {
+            write_as_dot( *graphFile, aGCAMFlowGraph );
+        }
+        else {
+            write_as_dot( *graphFile, aGCAMFlowGraph, [&filter]( IActivity* aActivity ) {
+                return aActivity->getDescription().compare( 0, filter.size(), filter ) == 0;
+            } );
+        }
+    }
     
     Timer &parsetimer = TimerRegistry::getInstance().getTimer("parse-timer");
-    Timer &graintimer = TimerRegistry::getInstance().getTimer("grain-timer");
     ILogger &mainlog = ILogger::getLogger("main_log");
     mainlog.setLevel(ILogger::DEBUG);
+    if( !mActivityCosts.empty() ) {
+        mainlog << "Grain collection is using measured activity costs." << endl;
+    }
 
     parsetimer.start();
-    FlowGraph gcamFGReduce = aGCAMFlowGraph.treduce(); // find transitive reduction of gcamfg
-    gcamFGReduce.topological_sort();
-    
-    ClanTree parseTree; 
-    graph_parse( gcamFGReduce, 0, parseTree, mGrainSizeTarget );
+    collectGrains( aGCAMFlowGraph, aGrainGraph );
     parsetimer.stop();
-    
-    // Use the parse tree to roll up the node graph into a grain graph.  Start
-    // with a copy of the node graph.
-    graintimer.start();
-    FlowGraph grainGraphTemp = gcamFGReduce;
-    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget );
-    
-    // set the output graph to the transitive reduction of what came out of the
-    // grain collection algorithm.
-    aGrainGraph = grainGraphTemp.treduce();
-    graintimer.stop();
 
-    parsetimer.print(mainlog, "Graph parse in graphParseGrainCollect:  ");
-    graintimer.print(mainlog, "Grain collect in graphParseGrainCollect:  ");
+    parsetimer.print(mainlog, "Graph parse and grain collect in graphParseGrainCollect:  ");
 }
 
 /*!
@@ -219,6 +235,131 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
     graphParseGrainCollect( subFlowGraph, aGrainGraph );
 }
 
+/*!
+ * \brief Parse the GCAM flow graph and collect IActivies into computational grains
+ *        without writing any output.
+ * \details This does the work of graphParseGrainCollect but does not write the
+ *          flow graph, log, or use the timers so that several graphs may be
+ *          collected at the same time from different threads.
+ * \remark graph_parse sets the global primitive_reduce_minsize from the grain
+ *         size target on each call.  Every thread writes the same value.
+ * \param[in] aGCAMFlowGraph: The gcam flow graph generated by makeGCAMFlowGraph
+ * \param[out] aGrainGraph: The graph of computational grains.  On input it
+ *                          should be empty.
+ * \param[in] aCalcItems: The list of items to use to subset aGCAMFlowGraph or
+ *                        null to collect the full graph.
+ */
+void GcamParallel::collectGrains( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                                  const vector<FlowGraphNodeType>* aCalcItems ) const
+{
+    // some intermediate types involving "clans".  These will hold the
+    // intermediate results of the parsing.
+    typedef clanid<FlowGraphNodeType> ClanidType;
+    typedef digraph<ClanidType> ClanTree;
+    
+    FlowGraph gcamFGReduce;
+    if( aCalcItems ) {
+        const FlowGraph::nodelist_t& fullGraph = aGCAMFlowGraph.nodelist();
+        FlowGraph::nodelist_t subGraph;
+        for( vector<FlowGraphNodeType>::const_iterator it = aCalcItems->begin(); it != aCalcItems->end(); ++it ) {
+            FlowGraph::nodelist_c_iter_t nodeIt = fullGraph.find( *it );
+            if( nodeIt != fullGraph.end() ) {
+                subGraph[ *it ] = nodeIt->second;
+            }
+        }
+        gcamFGReduce = FlowGraph( subGraph, aGCAMFlowGraph.title() ).treduce();
+    }
+    else {
+        gcamFGReduce = aGCAMFlowGraph.treduce(); // find transitive reduction of gcamfg
+    }
+    gcamFGReduce.topological_sort();
+    
+    ClanTree parseTree;
+    graph_parse( gcamFGReduce, 0, parseTree, mGrainSizeTarget );
+    
+    // Use the parse tree to roll up the node graph into a grain graph.  Start
+    // with a copy of the node graph.
+    FlowGraph grainGraphTemp = gcamFGReduce;
+    vector<double> weights;
+    const bool hasWeights = makeCostWeights( gcamFGReduce, weights );
+    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget,
+                   hasWeights ? &weights : 0 );
+    
+    // set the output graph to the transitive reduction of what came out of the
+    // grain collection algorithm.
+    aGrainGraph = grainGraphTemp.treduce();
+}
+
+/*!
+ * \brief Convert a grain graph into a GrainList.
+ * \details The activities in each grain are sorted in topological order and
+ *          identified by their index in the global ordering.
+ * \param[in] aGrainGraph: graph of the computational grains
+ * \param[in] aTopology: original gcam flow graph used to order the activities
+ *            in each grain
+ * \param[in] aGlobalOrdering: the global ordering of the activities
+ * \param[out] aGrainList: The grains and their successors.
+ */
+void GcamParallel::makeGrainList( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
+                                  const vector<FlowGraphNodeType>& aGlobalOrdering,
+                                  GrainList& aGrainList ) const
+{
+    if( !aTopology.topology_valid() ) {
+        ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
+        pgLog.setLevel( ILogger::SEVERE );
+        pgLog << "Creating grains with invalid topology." << endl;
+        abort();
+    }
+    
+    // The index of each activity in the global ordering.
+    map<FlowGraphNodeType, int> globalIndex;
+    for( size_t i = 0; i < aGlobalOrdering.size(); ++i ) {
+        globalIndex[ aGlobalOrdering[ i ] ] = i;
+    }
+    
+    // The index of each grain in the list.
+    map<FlowGraphNodeType, int> grainIndex;
+    int numGrains = 0;
+    for( FlowGraph::nodelist_c_iter_t gnodeIt = aGrainGraph.nodelist().begin();
+         gnodeIt != aGrainGraph.nodelist().end(); ++gnodeIt )
+    {
+        grainIndex[ gnodeIt->first ] = numGrains++;
+    }
+    
+    aGrainList.mGrains.assign( numGrains, vector<int>() );
+    aGrainList.mSuccessors.assign( numGrains, vector<int>() );
+    for( FlowGraph::nodelist_c_iter_t gnodeIt = aGrainGraph.nodelist().begin();
+         gnodeIt != aGrainGraph.nodelist().end(); ++gnodeIt )
+    {
+        const int currGrain = grainIndex[ gnodeIt->first ];
+        
+        // Find the nodes from the original graph that are in this node.  We have to
+        // extract them from the subgraph contained in the node and use the topology
+        // to order them.
+        set<FlowGraphNodeType> subGraphNodes;
+        getkeys( gnodeIt->second.subgraph->nodelist(), subGraphNodes );
+        vector<FlowGraphNodeType> nodes( subGraphNodes.begin(), subGraphNodes.end() );
+        sort( nodes.begin(), nodes.end(), TopologicalComparator( aTopology ) );
+        for( vector<FlowGraphNodeType>::const_iterator it = nodes.begin(); it != nodes.end(); ++it ) {
+            map<FlowGraphNodeType, int>::const_iterator indexIt = globalIndex.find( *it );
+            if( indexIt == globalIndex.end() ) {
+                ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
+                pgLog.setLevel( ILogger::SEVERE );
+                pgLog << "Activity " << (*it)->getDescription() << " is not in the global ordering." << endl;
+                abort();
+            }
+            aGrainList.mGrains[ currGrain ].push_back( indexIt->second );
+        }
+        
+        const set<FlowGraphNodeType>& children = gnodeIt->second.successors;
+        for( set<FlowGraphNodeType>::const_iterator cnodeIt = children.begin();
+             cnodeIt != children.end(); ++cnodeIt )
+        {
+            aGrainList.mSuccessors[ currGrain ].push_back( grainIndex[ *cnodeIt ] );
+        }
+    }
+}
+
 /*!
  * \brief Build the TBB flow graph for an input grain structure and topology 
  * \details This function builds a TBB flow graph for the input grain graph and
@@ -236,6 +377,9 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
  * \param[in] aGrainGraph: graph of the computational grains
  *            (produced by graph_parse_grain_collect()) 
  * \param[in] aTopology: original gcam flow graph (see remark) 
+ * \param[in] aGlobalOrdering: the global ordering of the activities, used to
+ *             total market supplies and demands in the same order as a serial
+ *             calculation
  * \param[inout] aTBBGraph: The class that will hold the flow graph nodes as well
  *             as any other required items to run the flow graph including the
  *             broadcast node which serves as the trigger that causes
@@ -248,6 +392,25 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
  *             object.
  */
 void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
+                                     const vector<FlowGraphNodeType>& aGlobalOrdering,
+                                     GcamFlowGraph& aTBBGraph )
+{
+    GrainList grainList;
+    makeGrainList( aGrainGraph, aTopology, aGlobalOrdering, grainList );
+    makeTBBFlowGraph( grainList, aGlobalOrdering, aTBBGraph );
+}
+
+/*!
+ * \brief Build the TBB flow graph for a list of grains.
+ * \details See makeTBBFlowGraph for a grain graph.  The grain list may have
+ *          been made by makeGrainList in this run or read from the grain
+ *          cache of a previous one.
+ * \param[in] aGrainList: The grains and their successors.
+ * \param[in] aGlobalOrdering: the global ordering of the activities
+ * \param[inout] aTBBGraph: The class that will hold the flow graph nodes.
+ */
+void GcamParallel::makeTBBFlowGraph( const GrainList& aGrainList,
+                                     const vector<FlowGraphNodeType>& aGlobalOrdering,
                                      GcamFlowGraph& aTBBGraph )
 {
     using tbb::flow::continue_node;
@@ -259,106 +422,406 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
     ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
     pgLog.setLevel( ILogger::NOTICE );
     
-    // We need a place to stash all of the TBB flow graph nodes, and we need to be
-    // able to find them from the node identifiers.
-    map<FlowGraphNodeType, continue_node<continue_msg>* > nodeTable;
-    map<FlowGraphNodeType, int> nodeSizeTable;
+    // Keep the grains in the graph where they are used by both the TBB flow
+    // graph nodes and the schedule.
+    const size_t numGrains = aGrainList.mGrains.size();
+    aTBBGraph.mUseSchedule = mUseSchedule;
+    aTBBGraph.mGrainIndices = aGrainList.mGrains;
+    aTBBGraph.mGrainSuccessors = aGrainList.mSuccessors;
+    aTBBGraph.mGrainNodes.assign( numGrains, vector<FlowGraphNodeType>() );
+    aTBBGraph.mNumPredecessors.assign( numGrains, 0 );
+    vector<atomic<int> >( numGrains ).swap( aTBBGraph.mPendingPredecessors );
+    for( size_t grain = 0; grain < numGrains; ++grain ) {
+        const vector<int>& indices = aGrainList.mGrains[ grain ];
+        for( vector<int>::const_iterator it = indices.begin(); it != indices.end(); ++it ) {
+            aTBBGraph.mGrainNodes[ grain ].push_back( aGlobalOrdering[ *it ] );
+        }
+        const vector<int>& children = aGrainList.mSuccessors[ grain ];
+        for( vector<int>::const_iterator cnodeIt = children.begin(); cnodeIt != children.end(); ++cnodeIt ) {
+            ++aTBBGraph.mNumPredecessors[ *cnodeIt ];
+        }
+        
+        // log some output to allow us to analyze the parallel grain
+        // structure (this allows us to see what is in the grains, but not
+        // the relationships between grains)
+        pgLog << "\nGrain id: " << grain << "   size:  " << indices.size() << "  Contents:";
+        for( size_t i = 0; i < indices.size(); ++i ) {
+            if( i % 3 == 0 ) {
+                pgLog << "\n\t";
+            }
+            pgLog << aTBBGraph.mGrainNodes[ grain ][ i ]->getDescription() << ", ";
+        }
+        pgLog << endl;
+    }
+    for( size_t grain = 0; grain < numGrains; ++grain ) {
+        if( aTBBGraph.mNumPredecessors[ grain ] == 0 ) {
+            aTBBGraph.mSourceGrains.push_back( grain );
+        }
+    }
+    if( mUseSchedule ) {
+        // The TBB flow graph is not needed.
+        return;
+    }
     
     // The TBB flow graph structures don't automatically create nodes, so we'll do
     // two passes, creating nodes on the first and connecting them on the second.
-    for( FlowGraph::nodelist_c_iter_t gnodeIt = aGrainGraph.nodelist().begin();
-         gnodeIt != aGrainGraph.nodelist().end(); ++gnodeIt )
-    {
-        // Find the nodes from the original graph that are in this node.  We have to
-        // extract them from the subgraph contained in the node, which is a little
-        // ugly.  That subgraph has the information we need to order the nodes
-        // without carrying an otherwise superfluous topology graph down into this
-        // function.  Thus, this should be a prime candidate for refactoring.
-        set<FlowGraphNodeType> subGraphNodes;
-        getkeys( gnodeIt->second.subgraph->nodelist(), subGraphNodes );
-        
-        // create the node for this grain.  Note that the tbbfg_body constructor
-        // uses the topology to order the elements of the grain, but does not store
-        // a reference.
-        size_t nodeSize = subGraphNodes.size();
-        nodeTable[ gnodeIt->first ] = new continue_node<continue_msg>( tbbFlowGraph,
-            TBBFlowGraphBody( subGraphNodes, aTopology, aTBBGraph ) );
-        nodeSizeTable[ gnodeIt->first ] = nodeSize;
-        pgLog << "\tContinue node: " << nodeTable[ gnodeIt->first ] << endl;
+    vector<continue_node<continue_msg>*> nodeTable( numGrains );
+    for( size_t grain = 0; grain < numGrains; ++grain ) {
+        nodeTable[ grain ] = new continue_node<continue_msg>( tbbFlowGraph,
+            TBBFlowGraphBody( grain, aTBBGraph ) );
+        pgLog << "\tContinue node: " << nodeTable[ grain ] << endl;
     }
     
     // In the second pass, connect edges in the nodes we just created.
     // This will make the TBB flow graph isomorphic to the grain graph.
-    for( FlowGraph::nodelist_c_iter_t gnodeIt= aGrainGraph.nodelist().begin();
-         gnodeIt != aGrainGraph.nodelist().end(); ++gnodeIt )
-    {
-        // get the children of each node in the flow graph
-        set<FlowGraphNodeType> children = gnodeIt->second.successors;
-        for( set<FlowGraphNodeType>::const_iterator cnodeIt = children.begin();
-             cnodeIt != children.end(); ++cnodeIt )
-        {
-            // find the TBB flow graph nodes for the grain graph node and
-            // the child node.  Connect them in the TBB flow graph.
-            tbb::flow::make_edge( *nodeTable[ gnodeIt->first ], *nodeTable[ *cnodeIt ] );
-            pgLog << nodeTable[ gnodeIt->first ] << "_" << nodeSizeTable[ gnodeIt->first ]
-                << " -> " << nodeTable[ *cnodeIt ] << "_" << nodeSizeTable[ *cnodeIt ] << endl;
+    for( size_t grain = 0; grain < numGrains; ++grain ) {
+        const vector<int>& children = aGrainList.mSuccessors[ grain ];
+        for( vector<int>::const_iterator cnodeIt = children.begin(); cnodeIt != children.end(); ++cnodeIt ) {
+            tbb::flow::make_edge( *nodeTable[ grain ], *nodeTable[ *cnodeIt ] );
+            pgLog << nodeTable[ grain ] << "_" << aGrainList.mGrains[ grain ].size()
+                << " -> " << nodeTable[ *cnodeIt ] << "_" << aGrainList.mGrains[ *cnodeIt ].size() << endl;
         }
     }
     
     // Find the source nodes and connect the TBB broadcast node to all of them.
-    set<FlowGraphNodeType> sources;
-    aGrainGraph.find_all_sources( sources );
-    for( set<FlowGraphNodeType>::const_iterator srcIt = sources.begin();
-         srcIt != sources.end(); ++srcIt )
+    for( vector<int>::const_iterator srcIt = aTBBGraph.mSourceGrains.begin();
+         srcIt != aTBBGraph.mSourceGrains.end(); ++srcIt )
     {
         tbb::flow::make_edge( head, *nodeTable[ *srcIt ] );
-        pgLog << "start node found:  " << nodeTable[ *srcIt ] << "_" << nodeSizeTable[ *srcIt ] << endl;
+        pgLog << "start node found:  " << nodeTable[ *srcIt ] << "_" << aGrainList.mGrains[ *srcIt ].size() << endl;
     }
     // TBB flow graph is ready to go.
 }
 
-void GcamParallel::TBBFlowGraphBody::operator()( tbb::flow::continue_msg aMessage )
+/*!
+ * \brief Combine the settings which change the grains found into a hash.
+ * \details These are the grain size target and any measured activity costs.
+ * \param aHash The hash of the dependency structure.
+ * \return The combined hash.
+ */
+size_t GcamParallel::hashSettings( size_t aHash ) const {
+    boost::hash_combine( aHash, mGrainSizeTarget );
+    for( map<string, double>::const_iterator it = mActivityCosts.begin(); it != mActivityCosts.end(); ++it ) {
+        boost::hash_combine( aHash, it->first );
+        boost::hash_combine( aHash, it->second );
+    }
+    return aHash;
+}
+
+/*!
+ * \brief Read the grain lists saved by writeGrainLists in a previous run.
+ * \details The lists are only used if the hash in the file matches aHash, that
+ *          is if the dependency structure and settings have not changed.
+ * \param aFileName The name of the grain cache file.
+ * \param aHash The hash of the current dependency structure and settings.
+ * \param aGrainLists The grain lists by market number, or -1 for the global graph.
+ * \return Whether the grain lists could be read.
+ */
+bool GcamParallel::readGrainLists( const string& aFileName, const size_t aHash,
+                                   map<int, GrainList>& aGrainLists )
 {
-    for( list<FlowGraphNodeType>::const_iterator nodeIt = mNodes.begin();
-         nodeIt != mNodes.end(); ++nodeIt )
-    {
-        if( !mGraph.mCalcList ||
-            find( mGraph.mCalcList->begin(), mGraph.mCalcList->end(), *nodeIt ) != mGraph.mCalcList->end() )
-        {
-            (*nodeIt)->calc( mGraph.mPeriod );
+    ifstream cacheFile( aFileName.c_str() );
+    string header;
+    size_t hash = 0;
+    if( !cacheFile || !( cacheFile >> header >> hash ) || header != "gcam-grain-cache" || hash != aHash ) {
+        return false;
+    }
+    
+    int market;
+    size_t numGrains;
+    while( cacheFile >> market >> numGrains ) {
+        GrainList& grainList = aGrainLists[ market ];
+        grainList.mGrains.assign( numGrains, vector<int>() );
+        grainList.mSuccessors.assign( numGrains, vector<int>() );
+        for( size_t grain = 0; grain < numGrains; ++grain ) {
+            for( int list = 0; list <= 1; ++list ) {
+                vector<int>& values = list == 0 ? grainList.mGrains[ grain ] : grainList.mSuccessors[ grain ];
+                size_t numValues = 0;
+                cacheFile >> numValues;
+                values.resize( numValues );
+                for( size_t i = 0; i < numValues; ++i ) {
+                    cacheFile >> values[ i ];
+                }
+            }
+        }
+        if( !cacheFile ) {
+            aGrainLists.clear();
+            return false;
         }
     }
+    return !aGrainLists.empty();
 }
 
-GcamParallel::TBBFlowGraphBody::TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes,
-                                                  const FlowGraph& aTopology,
-                                                  const GcamFlowGraph& aGraph )
-:mGraph( aGraph )
+/*!
+ * \brief Save the grain lists so that later runs with the same dependency
+ *        structure and settings do not need to parse the flow graphs.
+ * \details The file starts with the hash followed by, for each graph, the
+ *          market number and number of grains and then a line per grain with
+ *          the number of activities and their indices and the number of
+ *          successors and their indices.
+ * \param aFileName The name of the grain cache file.
+ * \param aHash The hash of the current dependency structure and settings.
+ * \param aGrainLists The grain lists by market number, or -1 for the global graph.
+ */
+void GcamParallel::writeGrainLists( const string& aFileName, const size_t aHash,
+                                    const map<int, GrainList>& aGrainLists )
 {
-    ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
-    pgLog.setLevel( ILogger::NOTICE );
+    ofstream cacheFile( aFileName.c_str() );
+    if( !cacheFile ) {
+        ILogger& mainlog = ILogger::getLogger( "main_log" );
+        mainlog.setLevel( ILogger::WARNING );
+        mainlog << "Could not write grain cache file " << aFileName << "." << endl;
+        return;
+    }
     
-    if( !aTopology.topology_valid() ) {
-        pgLog.setLevel( ILogger::SEVERE );
-        pgLog << "Creating tbbfg_body with invalid topology." << endl;
-        abort();
+    cacheFile << "gcam-grain-cache " << aHash << endl;
+    for( map<int, GrainList>::const_iterator it = aGrainLists.begin(); it != aGrainLists.end(); ++it ) {
+        const GrainList& grainList = it->second;
+        cacheFile << it->first << " " << grainList.mGrains.size() << endl;
+        for( size_t grain = 0; grain < grainList.mGrains.size(); ++grain ) {
+            for( int list = 0; list <= 1; ++list ) {
+                const vector<int>& values = list == 0 ? grainList.mGrains[ grain ] : grainList.mSuccessors[ grain ];
+                cacheFile << values.size();
+                for( size_t i = 0; i < values.size(); ++i ) {
+                    cacheFile << " " << values[ i ];
+                }
+                cacheFile << ( list == 0 ? "  " : "\n" );
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Set up a flow graph to time each activity for the number of full
+ *        model calculations given by the configuration parallel-profile-calcs.
+ * \details Profiling is off unless parallel-profile-calcs is greater than zero.
+ *          Once the calculations have been profiled World::calc writes the
+ *          costs with writeActivityCosts.
+ * \param aTBBGraph The flow graph to profile.
+ * \param aNumActivities The number of activities in the global ordering.
+ */
+void GcamParallel::startActivityProfiling( GcamFlowGraph& aTBBGraph, const size_t aNumActivities ) const {
+    aTBBGraph.mNumCalcsToProfile = Configuration::getInstance()->getInt( "parallel-profile-calcs", 0, false );
+    aTBBGraph.mNumCalcsProfiled = 0;
+    aTBBGraph.mActivityTimes.assign( aNumActivities, 0.0 );
+}
+
+/*!
+ * \brief Write the mean time spent calculating each activity while profiling.
+ * \details The file is written as CSV with the activity description and the
+ *          cost in seconds per calculation to the file given by the
+ *          configuration parallelCostOutputFileName.  Given as the
+ *          parallelCostInputFileName in a later run the costs are used to
+ *          balance the grains.
+ * \param aTBBGraph The flow graph which was profiled.
+ * \param aGlobalOrdering The global ordering of the activities.
+ */
+void GcamParallel::writeActivityCosts( const GcamFlowGraph& aTBBGraph,
+                                       const vector<FlowGraphNodeType>& aGlobalOrdering )
+{
+    ILogger& mainlog = ILogger::getLogger( "main_log" );
+    mainlog.setLevel( ILogger::NOTICE );
+    mainlog << "Measured activity costs over " << aTBBGraph.mNumCalcsProfiled << " model calculations." << endl;
+    
+    AutoOutputFile costFile( "parallelCostOutputFileName", "gcam-activity-costs.csv" );
+    *costFile << "activity,seconds-per-calc" << endl;
+    for( size_t i = 0; i < aGlobalOrdering.size() && i < aTBBGraph.mActivityTimes.size(); ++i ) {
+        *costFile << aGlobalOrdering[ i ]->getDescription() << ","
+                  << aTBBGraph.mActivityTimes[ i ] / max( aTBBGraph.mNumCalcsProfiled, 1 ) << endl;
+    }
+}
+
+/*!
+ * \brief Read the activity costs written by writeActivityCosts in a previous
+ *        run from the file given by the configuration parallelCostInputFileName.
+ * \details Nothing is read if the configuration is not set.
+ */
+void GcamParallel::readActivityCosts() {
+    const string& fileName = Configuration::getInstance()->getFile( "parallelCostInputFileName", "", false );
+    if( fileName.empty() ) {
+        return;
+    }
+    
+    ifstream costFile( fileName.c_str() );
+    if( !costFile ) {
+        ILogger& mainlog = ILogger::getLogger( "main_log" );
+        mainlog.setLevel( ILogger::WARNING );
+        mainlog << "Could not open activity cost file " << fileName << "." << endl;
+        return;
+    }
+    
+    // Skip the header.
+    string line;
+    getline( costFile, line );
+    while( getline( costFile, line ) ) {
+        // The description could contain a comma but the cost will not.
+        const size_t split = line.rfind( ',' );
+        if( split != string::npos ) {
+            mActivityCosts[ line.substr( 0, split ) ] = atof( line.substr( split + 1 ).c_str() );
+        }
+    }
+}
+
+/*!
+ * \brief Convert the activity costs to weights for grain_collect.
+ * \details The weights are indexed by the topological index of each node in
+ *          aGraph and are scaled so that the mean of the activities which have
+ *          a cost is one, which keeps the meaning of the grain size target.
+ *          Activities without a cost, such as ones added since the costs were
+ *          measured, get a weight of one.
+ * \param aGraph The topologically sorted graph which will be collected.
+ * \param aWeights The weight of each node.
+ * \return Whether there are any costs to use.
+ */
+bool GcamParallel::makeCostWeights( const FlowGraph& aGraph, vector<double>& aWeights ) const {
+    if( mActivityCosts.empty() ) {
+        return false;
     }
     
-    mNodes.insert( mNodes.end(), aNodes.begin(), aNodes.end() );
-    mNodes.sort( TopologicalComparator( aTopology ) );
+    const FlowGraph::nodelist_t& nodes = aGraph.nodelist();
+    aWeights.assign( nodes.size(), -1.0 );
+    double totalCost = 0.0;
+    int numCosts = 0;
+    for( FlowGraph::nodelist_c_iter_t nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt ) {
+        map<string, double>::const_iterator costIt = mActivityCosts.find( nodeIt->first->getDescription() );
+        if( costIt != mActivityCosts.end() ) {
+            aWeights[ aGraph.topological_index( nodeIt->first ) ] = costIt->second;
+            totalCost += costIt->second;
+            ++numCosts;
+        }
+    }
+    if( numCosts == 0 || totalCost <= 0.0 ) {
+        return false;
+    }
     
-    // log some output to allow us to analyze the parallel grain
-    // structure (this allows us to see what is in the grains, but not
-    // the relationships between grains)
-    pgLog << "\nGrain id: " << this << "   size:  " << mNodes.size() << "  Contents:";
-    int i = 0;
-    for( list<FlowGraphNodeType>::const_iterator it = mNodes.begin(); it != mNodes.end(); ++it ) {
-        if( i % 3 == 0 ) {
-            pgLog << "\n\t";
+    const double meanCost = totalCost / numCosts;
+    for( size_t i = 0; i < aWeights.size(); ++i ) {
+        aWeights[ i ] = aWeights[ i ] < 0.0 ? 1.0 : aWeights[ i ] / meanCost;
+    }
+    return true;
+}
+
+/*!
+ * \brief Set the activities which should be calculated the next time the
+ *        flow graph is run.
+ * \param aTBBGraph The flow graph to set the calc list for.
+ * \param aCalcList The activities to calculate or null to calculate all of
+ *                  them.  It is generally in the same order as the global
+ *                  ordering which allows the flags to be set in one pass.
+ * \param aGlobalOrdering The global ordering of the activities.
+ */
+void GcamParallel::setCalcList( GcamFlowGraph& aTBBGraph, const vector<FlowGraphNodeType>* aCalcList,
+                                const vector<FlowGraphNodeType>& aGlobalOrdering )
+{
+    aTBBGraph.mCalcList = aCalcList;
+    if( !aCalcList ) {
+        return;
+    }
+    aTBBGraph.mIsInCalcList.assign( aGlobalOrdering.size(), false );
+    size_t globalIndex = 0;
+    for( vector<FlowGraphNodeType>::const_iterator it = aCalcList->begin(); it != aCalcList->end(); ++it ) {
+        while( globalIndex < aGlobalOrdering.size() && aGlobalOrdering[ globalIndex ] != *it ) {
+            ++globalIndex;
+        }
+        if( globalIndex == aGlobalOrdering.size() ) {
+            // The list is not in the global order so search for the rest.
+            for( ; it != aCalcList->end(); ++it ) {
+                vector<FlowGraphNodeType>::const_iterator globalIt =
+                    find( aGlobalOrdering.begin(), aGlobalOrdering.end(), *it );
+                if( globalIt != aGlobalOrdering.end() ) {
+                    aTBBGraph.mIsInCalcList[ globalIt - aGlobalOrdering.begin() ] = true;
+                }
+            }
+            return;
+        }
+        aTBBGraph.mIsInCalcList[ globalIndex++ ] = true;
+    }
+}
+
+/*!
+ * \brief Calculate a flow graph using the grain schedule.
+ * \details This is an alternative to running the TBB flow graph which avoids
+ *          the overhead of passing messages between flow graph nodes.  Each
+ *          grain has an atomic count of the grains it still waits on and the
+ *          ready grains are run as tasks in a TBB task group, which uses a work
+ *          stealing scheduler to balance them between threads.
+ * \param aTBBGraph The flow graph to calculate.
+ */
+void GcamParallel::calcSchedule( GcamFlowGraph& aTBBGraph ) {
+    for( size_t grain = 0; grain < aTBBGraph.mNumPredecessors.size(); ++grain ) {
+        aTBBGraph.mPendingPredecessors[ grain ].store( aTBBGraph.mNumPredecessors[ grain ], memory_order_relaxed );
+    }
+    tbb::task_group group;
+    for( vector<int>::const_iterator srcIt = aTBBGraph.mSourceGrains.begin();
+         srcIt != aTBBGraph.mSourceGrains.end(); ++srcIt )
+    {
+        group.run( ScheduledGrain( *srcIt, aTBBGraph, group ) );
+    }
+    group.wait();
+}
+
+/*!
+ * \brief Calculate the activities of a grain in order.
+ * \param aGraph The flow graph to which the grain belongs.
+ * \param aGrain The index of the grain to calculate.
+ */
+void GcamParallel::calcGrain( const GcamFlowGraph& aGraph, const size_t aGrain ) {
+    // Let the market accumulator know which activity is adding to the markets
+    // so that the additions can be totaled in the global order.
+    MarketAccumulator* accumulator = scenario->getMarketplace()->getMarketAccumulator();
+    const bool isAccumulating = accumulator->isActive();
+    const vector<FlowGraphNodeType>& nodes = aGraph.mGrainNodes[ aGrain ];
+    const vector<int>& indices = aGraph.mGrainIndices[ aGrain ];
+    GCAM_TRACE_SCOPE( grain_calc, aGrain, aGraph.mPeriod );
+    for( size_t i = 0; i < nodes.size(); ++i ) {
+        if( !aGraph.mCalcList || aGraph.mIsInCalcList[ indices[ i ] ] ) {
+            GCAM_TRACE_SCOPE( activity_calc, GCAM_TRACE_ID( nodes[ i ] ), aGraph.mPeriod );
+            if( isAccumulating ) {
+                accumulator->setCurrentOrder( indices[ i ] );
+            }
+            if( aGraph.mProfiler ) {
+                aGraph.mProfiler->calc( nodes[ i ], indices[ i ], aGraph.mPeriod );
+            }
+            else if( aGraph.mIsProfiling ) {
+                const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                nodes[ i ]->calc( aGraph.mPeriod );
+                const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+                aGraph.mActivityTimes[ indices[ i ] ] += elapsed.count();
+            }
+            else {
+                nodes[ i ]->calc( aGraph.mPeriod );
+            }
+        }
+    }
+}
+
+void GcamParallel::TBBFlowGraphBody::operator()( tbb::flow::continue_msg aMessage )
+{
+    calcGrain( mGraph, mGrain );
+}
+
+void GcamParallel::ScheduledGrain::operator()() const
+{
+    int grain = mGrain;
+    while( grain >= 0 ) {
+        calcGrain( mGraph, grain );
+        
+        // Release the successors, continuing with the first one which is ready
+        // and leaving the others to be stolen.
+        int nextGrain = -1;
+        const vector<int>& successors = mGraph.mGrainSuccessors[ grain ];
+        for( vector<int>::const_iterator it = successors.begin(); it != successors.end(); ++it ) {
+            if( mGraph.mPendingPredecessors[ *it ].fetch_sub( 1, memory_order_acq_rel ) == 1 ) {
+                if( nextGrain < 0 ) {
+                    nextGrain = *it;
+                }
+                else {
+                    mGroup.run( ScheduledGrain( *it, mGraph, mGroup ) );
+                }
+            }
         }
-        pgLog << (*it)->getDescription() << ", ";
+        grain = nextGrain;
     }
-    pgLog << endl;
 }
 
 /*!
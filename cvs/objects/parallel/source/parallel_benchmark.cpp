@@ -0,0 +1,253 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file parallel_benchmark.cpp
+ * \ingroup Objects
+ * \brief ParallelBenchmark class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+// Limiting the number of threads in use is a preview feature in some versions
+// of TBB.
+#define TBB_PREVIEW_GLOBAL_CONTROL 1
+#include <tbb/global_control.h>
+#endif
+
+#include "parallel/include/parallel_benchmark.hpp"
+#include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "marketplace/include/marketplace.h"
+#include "solution/util/include/calc_counter.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/fdjac.hpp"
+#include "solution/solvers/include/solver_component.h"
+#include "solution/solvers/include/logbroyden.hpp"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+namespace {
+    //! The default solution tolerance, as in UserConfigurableSolver.
+    const double DEFAULT_SOLUTION_TOLERANCE = 0.001;
+    
+    //! The default solution floor, as in UserConfigurableSolver.
+    const double DEFAULT_SOLUTION_FLOOR = 0.0001;
+    
+    //! The number of seconds since aStart.
+    double secondsSince( const chrono::steady_clock::time_point& aStart ) {
+        return chrono::duration<double>( chrono::steady_clock::now() - aStart ).count();
+    }
+}
+
+/*!
+ * \brief Constructor.
+ * \param aWorld The world to calculate.
+ * \param aMarketplace The marketplace to calculate.
+ */
+ParallelBenchmark::ParallelBenchmark( World* aWorld, Marketplace* aMarketplace ):
+mWorld( aWorld ),
+mMarketplace( aMarketplace )
+{
+}
+
+/*!
+ * \brief Run all of the measurements at each number of threads and write the
+ *        results.
+ * \details The model must be initialized for aPeriod, including the
+ *          ManageStateVariables, and is left in the same state it was given.
+ * \param aPeriod The model period to calculate.
+ * \param aSolutionInfoParamParser The solution parameters used to set up the
+ *                                 solvable markets.
+ */
+void ParallelBenchmark::run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running parallel benchmark in period " << aPeriod << endl;
+    
+    scenario->getManageStateVariables()->saveState( mInitialState, false );
+    
+    const int numRepeats = max( Configuration::getInstance()->getInt( "benchmark-repeats", 3, false ), 1 );
+    const vector<int> threadCounts = getThreadCounts();
+    for( auto numThreads : threadCounts ) {
+#if GCAM_PARALLEL_ENABLED
+        tbb::global_control limitThreads( tbb::global_control::max_allowed_parallelism, numThreads );
+#endif
+        for( int repeat = 0; repeat < numRepeats; ++repeat ) {
+            runMeasurements( aPeriod, numThreads, repeat, aSolutionInfoParamParser );
+        }
+    }
+    
+    // Leave the model as we found it so the period solves as it would have.
+    resetState();
+    mWorld->getCalcCounter()->startNewPeriod();
+    
+    writeResults( aPeriod );
+}
+
+/*!
+ * \brief The numbers of threads to run each measurement with.
+ * \return Powers of two up to the size of the thread pool, and the size of the
+ *         thread pool itself.
+ */
+vector<int> ParallelBenchmark::getThreadCounts() const {
+    vector<int> threadCounts;
+#if GCAM_PARALLEL_ENABLED
+    const int maxThreads = scenario->getManageStateVariables()->mThreadPool.max_concurrency();
+    for( int numThreads = 1; numThreads < maxThreads; numThreads *= 2 ) {
+        threadCounts.push_back( numThreads );
+    }
+    threadCounts.push_back( maxThreads );
+#else
+    threadCounts.push_back( 1 );
+#endif
+    return threadCounts;
+}
+
+//! Restore the state the benchmark started from.
+void ParallelBenchmark::resetState() const {
+    scenario->getManageStateVariables()->restoreState( mInitialState );
+}
+
+/*!
+ * \brief Time each of the measurements once.
+ * \param aPeriod The model period to calculate.
+ * \param aNumThreads The number of threads which are allowed.
+ * \param aRepeat The repetition of the measurements.
+ * \param aSolutionInfoParamParser The solution parameters used to set up the
+ *                                 solvable markets.
+ */
+void ParallelBenchmark::runMeasurements( const int aPeriod, const int aNumThreads, const int aRepeat,
+                                         const SolutionInfoParamParser* aSolutionInfoParamParser )
+{
+    resetState();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    mWorld->calc( aPeriod );
+    addMeasurement( "world-calc-ordering", aNumThreads, aRepeat, secondsSince( start ) );
+    
+#if GCAM_PARALLEL_ENABLED
+    resetState();
+    start = chrono::steady_clock::now();
+    mWorld->calc( aPeriod, mWorld->getGlobalFlowGraph() );
+    addMeasurement( "world-calc-flow-graph", aNumThreads, aRepeat, secondsSince( start ) );
+#endif
+    
+    // The solvable markets depend on the state so set them up from the start
+    // of the period as the solver would.
+    resetState();
+    SolutionInfoSet solutionSet( mMarketplace );
+    solutionSet.init( aPeriod, DEFAULT_SOLUTION_TOLERANCE, DEFAULT_SOLUTION_FLOOR, aSolutionInfoParamParser );
+    const size_t numSolvable = solutionSet.getNumSolvable();
+    if( numSolvable == 0 ) {
+        return;
+    }
+    
+    {
+        LogEDFun edFun( solutionSet, mWorld, mMarketplace, aPeriod, true );
+        boost::numeric::ublas::vector<double> x( numSolvable ), fx( numSolvable );
+        const vector<SolutionInfo>& solvable = solutionSet.getSolvableSet();
+        for( size_t i = 0; i < numSolvable; ++i ) {
+            x[ i ] = log( max( solvable[ i ].getPrice(), util::getTinyNumber() ) );
+        }
+        edFun.scaleInitInputs( x );
+        edFun( x, fx );
+        boost::numeric::ublas::matrix<double> jacobian( numSolvable, numSolvable );
+        start = chrono::steady_clock::now();
+        fdjac( edFun, x, fx, jacobian, true );
+        addMeasurement( "fdjac", aNumThreads, aRepeat, secondsSince( start ) );
+    }
+    
+    resetState();
+    SolutionInfoSet broydenSet( mMarketplace );
+    broydenSet.init( aPeriod, DEFAULT_SOLUTION_TOLERANCE, DEFAULT_SOLUTION_FLOOR, aSolutionInfoParamParser );
+    LogBroyden broyden( mMarketplace, mWorld, mWorld->getCalcCounter(), 1 );
+    broyden.init();
+    start = chrono::steady_clock::now();
+    broyden.solve( broydenSet, aPeriod );
+    addMeasurement( "broyden", aNumThreads, aRepeat, secondsSince( start ) );
+}
+
+/*!
+ * \brief Record a measurement.
+ * \param aName The name of what was timed.
+ * \param aNumThreads The number of threads which were allowed.
+ * \param aRepeat The repetition of this measurement.
+ * \param aSeconds The wall clock time in seconds.
+ */
+void ParallelBenchmark::addMeasurement( const string& aName, const int aNumThreads, const int aRepeat,
+                                        const double aSeconds )
+{
+    Measurement measurement = { aName, aNumThreads, aRepeat, aSeconds };
+    mMeasurements.push_back( measurement );
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Benchmark " << aName << " threads: " << aNumThreads << " repeat: " << aRepeat
+            << " seconds: " << aSeconds << endl;
+}
+
+/*!
+ * \brief Write the measurements as CSV to the file benchmark-output.
+ * \param aPeriod The model period which was calculated.
+ */
+void ParallelBenchmark::writeResults( const int aPeriod ) const {
+    const string fileName = Configuration::getInstance()->getFile( "benchmark-output", "benchmark.csv", false );
+    ofstream results( fileName.c_str() );
+    if( !results.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open benchmark output file: " << fileName << endl;
+        return;
+    }
+    
+    results << "period,measurement,threads,repeat,seconds" << endl;
+    results.precision( 9 );
+    for( const auto& measurement : mMeasurements ) {
+        results << aPeriod << ',' << measurement.mName << ',' << measurement.mNumThreads << ','
+                << measurement.mRepeat << ',' << measurement.mSeconds << endl;
+    }
+}
@@ -120,6 +120,8 @@ public:
     virtual void completeInit( const std::string& aRegionName );
     virtual bool isApplicable( const std::string& aRegion ) const;
     virtual void setConstraint( const std::vector<double>& aConstraint );
+    virtual bool updateFixedTaxes( const std::string& aRegionName,
+                                   const std::vector<double>& aFixedTaxes );
 protected:
     
     // Define data such that introspection utilities can process the data from this
@@ -79,6 +79,8 @@ public:
     virtual void completeInit( const std::string& aRegionName );
     virtual bool isApplicable( const std::string& aRegion ) const;
     virtual void setConstraint( const std::vector<double>& aConstraint );
+    virtual bool updateFixedTaxes( const std::string& aRegionName,
+                                   const std::vector<double>& aFixedTaxes );
 protected:
     
     DEFINE_DATA(
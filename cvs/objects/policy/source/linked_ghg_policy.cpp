@@ -279,3 +279,14 @@ bool LinkedGHGPolicy::isApplicable( const string& aRegion ) const {
 void LinkedGHGPolicy::setConstraint( const vector<double>& aConstraint ){
     assert( false );
 }
+
+/*!
+ * \brief Linked policies do not set a price themselves so can not take a fixed
+ *        tax and must be replaced instead.
+ * \return False.
+ */
+bool LinkedGHGPolicy::updateFixedTaxes( const string& aRegionName,
+                                        const vector<double>& aFixedTaxes )
+{
+    return false;
+}
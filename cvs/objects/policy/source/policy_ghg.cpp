@@ -279,6 +279,38 @@ bool GHGPolicy::isApplicable( const string& aRegion ) const {
     return mMarket == "global" || mMarket == aRegion;
 }
 
+/*!
+* \brief Replace the fixed taxes of an already initialized policy in place.
+* \details This avoids replacing the policy and reinitializing its market when
+*          only the tax path changes, e.g. for each trial of a target finder.
+*          The update is only possible if this policy is a fixed tax in every
+*          period and the new taxes are given for every period, in which case
+*          the market set up by completeInit does not change except for the
+*          prices.  Otherwise the caller must replace the policy.
+* \param aRegionName The region in which the policy was initialized.
+* \param aFixedTaxes The new fixed taxes by period.
+* \return Whether the taxes could be updated in place.
+*/
+bool GHGPolicy::updateFixedTaxes( const string& aRegionName,
+                                  const vector<double>& aFixedTaxes )
+{
+    assert( aFixedTaxes.size() == mFixedTax.size() );
+
+    if( std::find( mFixedTax.begin(), mFixedTax.end(), -1 ) != mFixedTax.end() ||
+        std::find( aFixedTaxes.begin(), aFixedTaxes.end(), -1 ) != aFixedTaxes.end() )
+    {
+        return false;
+    }
+
+    std::copy( aFixedTaxes.begin(), aFixedTaxes.end(), mFixedTax.begin() );
+    objects::PeriodVector<Value> taxPrices;
+    for( unsigned int i = 0; i < mFixedTax.size(); ++i ) {
+        taxPrices[ i ] = mFixedTax[ i ];
+    }
+    scenario->getMarketplace()->setPriceVector( mName, aRegionName, taxPrices );
+    return true;
+}
+
 /*!
 * \brief Set the mConstraint to the vector passed in.
 * \param aConstraint new mConstraint vector
@@ -44,6 +44,8 @@
 * \author Pralit Patel
 */
 
+#include <memory>
+#include <sstream>
 #include "util/base/include/default_visitor.h"
 #include "util/base/include/auto_file.h"
 
@@ -52,6 +54,22 @@
 * \brief A visitor which writes basic model results to a CSV file.
 * \details This is very useful when running a very large batch file
 *          and would only be intrested in looking at a few select results.
+*          Each scenario's row is assembled in memory and written and flushed
+*          in one piece once writeDidScenarioSolve is called so that the file
+*          holds every completed scenario even if the batch does not finish.
+*          When writing to the configured file an index of the byte offset at
+*          which each scenario's row starts can also be written to the file
+*          configured by batchCSVIndexFile to allow random access.
+*
+*          If the configuration value batch-delta-output is set the rows are
+*          delta encoded to reduce the size of large batches. The first
+*          scenario written is the reference and its row is written in full.
+*          In the row of every later scenario a value which is within the
+*          relative tolerance batch-delta-tolerance of the reference value in
+*          the same column is left empty, the scenario name is always
+*          written. The full row is reconstructed by replacing each empty
+*          value with the value from the first row after the header, see
+*          decodeDeltaRow.
 * \author Pralit Patel
 */
 
@@ -59,10 +77,23 @@ class BatchCSVOutputter : public DefaultVisitor {
 public:
     BatchCSVOutputter();
 
+    explicit BatchCSVOutputter( const std::string& aFileName );
+
+    explicit BatchCSVOutputter( std::ostream& aStream );
+
     ~BatchCSVOutputter();
 
     void writeDidScenarioSolve( bool aDidSolve );
 
+    static bool isDeltaOutput();
+
+    static std::string encodeDeltaRow( const std::string& aReferenceRow,
+                                       const std::string& aRow,
+                                       const double aTolerance );
+
+    static std::string decodeDeltaRow( const std::string& aReferenceRow,
+                                       const std::string& aRow );
+
     //! IVisitor methods
     void startVisitScenario( const Scenario* aScenario, const int aPeriod );
 
@@ -77,5 +108,31 @@ private:
 
     //! If this is the first scenario to be written
     bool mIsFirstScenario;
+
+    //! The row currently being written
+    std::ostringstream mRow;
+
+    //! The number of bytes written to mFile so far
+    std::streamoff mBytesWritten;
+
+    //! The name of the scenario currently being written
+    std::string mScenarioName;
+
+    //! The offset into mFile at which the current scenario's row starts
+    std::streamoff mScenarioOffset;
+
+    //! The file to write the scenario offsets to if one is configured
+    std::auto_ptr<AutoOutputFile> mIndexFile;
+
+    //! Whether rows after the first are delta encoded against it
+    bool mIsDeltaOutput;
+
+    //! The relative tolerance within which values match the reference
+    double mDeltaTolerance;
+
+    //! The full row of the reference scenario, without the newline
+    std::string mReferenceRow;
+
+    void writeRow();
 };
 #endif // _BATCH_CSV_OUTPUTTER_H_
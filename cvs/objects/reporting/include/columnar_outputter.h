@@ -0,0 +1,240 @@
+#ifndef _COLUMNAR_OUTPUTTER_H_
+#define _COLUMNAR_OUTPUTTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file columnar_outputter.h
+ * \ingroup Objects
+ * \brief ColumnarOutputter class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "util/base/include/default_visitor.h"
+
+class Technology;
+
+/*! 
+ * \ingroup Objects
+ * \brief A visitor which writes the commonly queried model results as typed
+ *        column arrays which can be read directly by analysis tools.
+ * \details The results are collected into long format tables, one row per
+ *          value, and written when finish is called.  The tables are:
+ *          - outputs: physical output by technology and output.
+ *          - inputs: physical demand by technology and input.
+ *          - prices: price, supply and demand by market.
+ *          - emissions: emissions by technology and gas.
+ *          - land: land allocation by land leaf.
+ *
+ *          Each table is written as a NumPy .npz archive, which is a zip file
+ *          with one .npy array per column, to the file given by the
+ *          configuration file key columnar-output with the table name
+ *          appended, e.g. columnar-output-outputs.npz.  Year and vintage
+ *          columns are 32 bit integers and values are 64 bit reals.  Name
+ *          columns such as region, sector and technology are dictionary
+ *          encoded: the column holds 32 bit codes which index the byte
+ *          strings in a companion column with the suffix "-levels". These
+ *          may be read for example in Python with:
+ *          \code
+ *          z = numpy.load( "columnar-output-outputs.npz" )
+ *          region = pandas.Categorical.from_codes( z[ "region" ], z[ "region-levels" ].astype( str ) )
+ *          \endcode
+ */
+class ColumnarOutputter : public DefaultVisitor {
+public:
+    ColumnarOutputter();
+
+    ~ColumnarOutputter();
+
+    virtual void finish() const;
+
+    std::vector<std::string> getFileNames() const;
+
+    //! IVisitor methods
+    virtual void startVisitRegion( const Region* aRegion, const int aPeriod );
+
+    virtual void endVisitRegion( const Region* aRegion, const int aPeriod );
+
+    virtual void startVisitResource( const AResource* aResource, const int aPeriod );
+
+    virtual void endVisitResource( const AResource* aResource, const int aPeriod );
+
+    virtual void startVisitSubResource( const SubResource* aSubResource, const int aPeriod );
+
+    virtual void endVisitSubResource( const SubResource* aSubResource, const int aPeriod );
+
+    virtual void startVisitSubRenewableResource( const SubRenewableResource* aSubResource, const int aPeriod );
+
+    virtual void endVisitSubRenewableResource( const SubRenewableResource* aSubResource, const int aPeriod );
+
+    virtual void startVisitSector( const Sector* aSector, const int aPeriod );
+
+    virtual void endVisitSector( const Sector* aSector, const int aPeriod );
+
+    virtual void startVisitSubsector( const Subsector* aSubsector, const int aPeriod );
+
+    virtual void endVisitSubsector( const Subsector* aSubsector, const int aPeriod );
+
+    virtual void startVisitNestingSubsector( const NestingSubsector* aSubsector, const int aPeriod );
+
+    virtual void endVisitNestingSubsector( const NestingSubsector* aSubsector, const int aPeriod );
+
+    virtual void startVisitTechnology( const Technology* aTechnology, const int aPeriod );
+
+    virtual void endVisitTechnology( const Technology* aTechnology, const int aPeriod );
+
+    virtual void startVisitMiniCAMInput( const MiniCAMInput* aInput, const int aPeriod );
+
+    virtual void startVisitOutput( const IOutput* aOutput, const int aPeriod );
+
+    virtual void startVisitGHG( const AGHG* aGHG, const int aPeriod );
+
+    virtual void startVisitMarket( const Market* aMarket, const int aPeriod );
+
+    virtual void startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod );
+
+private:
+    /*!
+     * \brief A table of results stored by column.
+     * \details Rows are added by setting a value in each column and then
+     *          calling endRow.  String values are stored as codes into the
+     *          column's dictionary.
+     */
+    class ColumnTable {
+    public:
+        //! The type of the values in a column.
+        enum ColumnType {
+            //! Strings, stored as codes into a dictionary.
+            DICTIONARY,
+
+            //! 32 bit integers.
+            INTEGER,
+
+            //! 64 bit reals.
+            REAL
+        };
+
+        explicit ColumnTable( const std::string& aName );
+
+        size_t addColumn( const std::string& aName, const ColumnType aType );
+
+        void setString( const size_t aColumn, const std::string& aValue );
+
+        void setInt( const size_t aColumn, const int aValue );
+
+        void setReal( const size_t aColumn, const double aValue );
+
+        void endRow();
+
+        const std::string& getName() const;
+
+        bool write( const std::string& aFileName ) const;
+
+    private:
+        //! The values in a single column.
+        struct Column {
+            //! The name of the column.
+            std::string mName;
+
+            //! The type of the values.
+            ColumnType mType;
+
+            //! The values of an INTEGER column or the codes of a DICTIONARY column.
+            std::vector<int> mInts;
+
+            //! The values of a REAL column.
+            std::vector<double> mReals;
+
+            //! The dictionary of a DICTIONARY column in code order.
+            std::vector<std::string> mLevels;
+
+            //! Map from a dictionary string to its code.
+            std::map<std::string, int> mCodes;
+        };
+
+        //! The name of the table.
+        std::string mName;
+
+        //! The columns of the table.
+        std::vector<Column> mColumns;
+    };
+
+    //! The name of the current region.
+    std::string mCurrentRegion;
+
+    //! The name of the current sector or resource.
+    std::string mCurrentSector;
+
+    //! The input unit of the current sector.
+    std::string mCurrentInputUnit;
+
+    //! The output unit of the current sector or resource.
+    std::string mCurrentOutputUnit;
+
+    //! The names of the subsectors currently being visited, innermost last.
+    std::vector<std::string> mSubsectorStack;
+
+    //! The technology currently being visited.
+    const Technology* mCurrentTechnology;
+
+    //! Physical output by technology.
+    ColumnTable mOutputs;
+
+    //! Physical demand by technology.
+    ColumnTable mInputs;
+
+    //! Market prices, supplies and demands.
+    ColumnTable mPrices;
+
+    //! Emissions by technology.
+    ColumnTable mEmissions;
+
+    //! Land allocation by land leaf.
+    ColumnTable mLand;
+
+    void addTechnologyColumns( ColumnTable& aTable );
+
+    void setTechnologyColumns( ColumnTable& aTable );
+
+    const std::string& getCurrentSubsector() const;
+};
+
+#endif // _COLUMNAR_OUTPUTTER_H_
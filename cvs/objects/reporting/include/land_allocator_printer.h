@@ -56,7 +56,9 @@ class ALandAllocatorItem;
 *          the constructor argument. The graph file must be post-processed by the dot processor to
 *          create a viewable graph. The graph printer currently will create nodes for each node in
 *          the land allocator, and links between parents and children.  Internal nodes are outputted
-*          as circles, leaf nodes are outputted as boxes.
+*          as circles, leaf nodes are outputted as boxes.  The output can be
+*          restricted to the subtree under a single land node which is useful
+*          for very large land allocators.
 * \author Jim Naslund
 */
 class LandAllocatorPrinter : public DefaultVisitor {
@@ -71,6 +73,7 @@ public:
     void startVisitLandNode( const LandNode * aLandNode, const int aPeriod );
     void endVisitLandNode( const LandNode * aLandNode, const int aPeriod );
     void startVisitLandLeaf( const LandLeaf * aLandLeaf, const int aPeriod );
+    void setNodeToPrint( const std::string& aNodeName );
     void openGraph() const;
     void closeGraph() const;
     static void printToFile( const std::string& aRegion,
@@ -98,6 +101,16 @@ private:
     //! Whether or not to only print a certain region
     bool mPrintSpecificRegion;
 
+    //! The name of the land node at the root of the subtree to print, empty
+    //! to print the entire land allocator
+    std::string mNodeToPrint;
+
+    //! The depth of the current node below the root of the subtree being
+    //! printed or -1 if not currently inside of it
+    int mSubtreeDepth;
+
+    bool shouldPrint() const;
+
     void printNode( const ALandAllocatorItem* aLandItem,
                     const int aPeriod, const bool aIsLeaf ) const;
 
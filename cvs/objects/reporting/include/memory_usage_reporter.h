@@ -0,0 +1,122 @@
+#ifndef _MEMORY_USAGE_REPORTER_H_
+#define _MEMORY_USAGE_REPORTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file memory_usage_reporter.h
+ * \ingroup Objects
+ * \brief MemoryUsageReporter class header file.
+ */
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "util/base/include/default_visitor.h"
+
+/*! 
+ * \ingroup Objects
+ * \brief A visitor which reports an estimate of the memory used by each part
+ *        of the model.
+ * \details The model tree is visited for all periods and the objects found
+ *          are counted by category and by region.  The bytes given for each
+ *          category are estimated from the size of the objects themselves,
+ *          along with the yearly arrays of the carbon calculations, and so
+ *          leave out most of what the objects hold on the heap.  The exact
+ *          totals of what is allocated through the ObjectPool, the state
+ *          data of the current period, and the memory held by the XML parser
+ *          are reported alongside to account for the rest.
+ *
+ *          The report is only made if the configuration flag
+ *          log-memory-usage is set, using Scenario::logMemoryUsage after
+ *          completeInit and at the end of each period.
+ */
+class MemoryUsageReporter : public DefaultVisitor {
+public:
+    MemoryUsageReporter();
+
+    static bool isEnabled();
+
+    void setStateBytes( const size_t aStateBytes );
+
+    void printReport( std::ostream& aOut, const std::string& aTitle ) const;
+
+    virtual void startVisitRegion( const Region* aRegion, const int aPeriod );
+    virtual void startVisitSector( const Sector* aSector, const int aPeriod );
+    virtual void startVisitResource( const AResource* aResource, const int aPeriod );
+    virtual void startVisitSubsector( const Subsector* aSubsector, const int aPeriod );
+    virtual void startVisitTechnology( const Technology* aTechnology, const int aPeriod );
+    virtual void startVisitMiniCAMInput( const MiniCAMInput* aInput, const int aPeriod );
+    virtual void startVisitNodeInput( const NodeInput* aNodeInput, const int aPeriod );
+    virtual void startVisitOutput( const IOutput* aOutput, const int aPeriod );
+    virtual void startVisitGHG( const AGHG* aGHG, const int aPeriod );
+    virtual void startVisitLandNode( const LandNode* aLandNode, const int aPeriod );
+    virtual void startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod );
+    virtual void startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc, const int aPeriod );
+    virtual void startVisitMarket( const Market* aMarket, const int aPeriod );
+private:
+    //! The categories which objects are counted in.
+    enum Category {
+        REGION,
+        SECTOR,
+        TECHNOLOGY,
+        LAND,
+        MARKET,
+        NUM_CATEGORIES
+    };
+
+    void add( const Category aCategory, const size_t aBytes );
+
+    //! The number of objects found in each category.
+    std::vector<size_t> mNumObjects;
+
+    //! The estimated bytes of the objects found in each category.
+    std::vector<size_t> mNumBytes;
+
+    //! The estimated bytes of the objects found in each region.
+    std::map<std::string, size_t> mRegionBytes;
+
+    //! The region currently being visited, if any.
+    std::string mCurrentRegion;
+
+    //! The bytes of state data for the current period.
+    size_t mStateBytes;
+};
+
+#endif // _MEMORY_USAGE_REPORTER_H_
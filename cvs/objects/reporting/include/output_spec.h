@@ -0,0 +1,110 @@
+#ifndef _OUTPUT_SPEC_H_
+#define _OUTPUT_SPEC_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file output_spec.h
+ * \ingroup Objects
+ * \brief OutputSpec class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+
+/*! 
+ * \ingroup Objects
+ * \brief The set of element paths which an outputter needs to write.
+ * \details The specification is a list of paths, one per line, of element
+ *          types separated by slashes, for instance:
+ *          \code
+ *          region/sector/subsector/technology
+ *          region/resource[@name='crude oil']
+ *          marketplace/market
+ *          \endcode
+ *          An element type may be qualified with a name, in which case only
+ *          the element with that name matches.  Blank lines and lines
+ *          starting with # are ignored.  An element is selected if it is on
+ *          one of the paths or is contained in the last element of one of the
+ *          paths, so everything in the subtree of the last element is
+ *          selected.
+ *
+ *          The outputter calls enter as it starts each element and leave as
+ *          it finishes it and skips any element for which enter returns
+ *          false, along with its subtree.
+ */
+class OutputSpec {
+public:
+    OutputSpec();
+
+    bool readFile( const std::string& aFileName );
+
+    void addPath( const std::string& aPath );
+
+    bool enter( const std::string& aType, const std::string& aName );
+
+    void leave();
+
+    bool isSelected() const;
+
+private:
+    //! A node in the tree of paths.
+    struct Node {
+        Node();
+
+        //! The index in mNodes of each child keyed by the element type and
+        //! optionally name.
+        std::map<std::string, int> mChildren;
+
+        //! Whether this node ends a path so that its whole subtree is selected.
+        bool mSelectsSubtree;
+    };
+
+    //! The tree of paths, the first node is the root.
+    std::vector<Node> mNodes;
+
+    //! The node for each element currently entered, or -1 if it was not selected.
+    std::vector<int> mPath;
+
+    static std::string createKey( const std::string& aType, const std::string& aName );
+
+    int findChild( const int aParent, const std::string& aKey ) const;
+};
+
+#endif // _OUTPUT_SPEC_H_
@@ -0,0 +1,111 @@
+#ifndef _PERFORMANCE_REPORT_H_
+#define _PERFORMANCE_REPORT_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file performance_report.h
+ * \ingroup Objects
+ * \brief PerformanceReport class header file.
+ */
+
+#include <string>
+#include <memory>
+#include <chrono>
+#include <boost/core/noncopyable.hpp>
+
+class AutoOutputFile;
+
+/*! 
+ * \ingroup Objects
+ * \brief Writes the time, model evaluations, solver iterations and peak
+ *        memory of each phase of a model run.
+ * \details A CSV row is written to the file given by the configuration
+ *          performanceReportFileName as each phase finishes: reading the
+ *          inputs, completeInit, each period and the solve within it, and
+ *          writing the output. Each row has the scenario name, phase, period
+ *          or -1 if the phase is not for a period, wall clock seconds, the
+ *          model evaluations and solver iterations during the phase and the
+ *          peak resident set size of the process so far in kilobytes, which is
+ *          zero where it is not available. The file is flushed after each row
+ *          so that a run which fails still reports the phases it finished.
+ *
+ *          The report is meant to be read by tools which track performance
+ *          between versions, such as util/testing-framework. It is only
+ *          written if the configuration log-performance-report is set.
+ */
+class PerformanceReport : private boost::noncopyable {
+public:
+    static PerformanceReport& getInstance();
+
+    ~PerformanceReport();
+
+    //! Whether the configuration log-performance-report is set.
+    bool isEnabled() const {
+        return mIsEnabled;
+    }
+
+    //! Count an iteration of a solver component.
+    void countSolverIteration() {
+        ++mNumSolverIterations;
+    }
+
+    //! Get the number of solver iterations counted so far.
+    int getNumSolverIterations() const {
+        return mNumSolverIterations;
+    }
+
+    void recordPhase( const std::string& aPhase, const int aPeriod,
+                      const std::chrono::steady_clock::time_point& aStart,
+                      const int aNumEvaluations, const int aNumSolverIterations );
+
+    static long getPeakRSSKilobytes();
+
+private:
+    PerformanceReport();
+
+    //! Whether the report should be written.
+    const bool mIsEnabled;
+
+    //! The number of solver iterations counted so far.
+    int mNumSolverIterations;
+
+    //! The output file, opened when the first phase is recorded.
+    std::auto_ptr<AutoOutputFile> mFile;
+};
+
+#endif // _PERFORMANCE_REPORT_H_
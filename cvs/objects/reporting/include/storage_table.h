@@ -49,12 +49,15 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 /*! 
 * \ingroup Objects
 * \brief A datastructure which stores in a row column format which is referenced by the column and row names.
-* \details This is a sparse table as all columns do not have to contain the same rows. SWAP. For this reason the columns
-* can be iterated by the rows cannot.
+* \details Rows and columns are assigned dense indices the first time their labels
+*          are seen so that each lookup is a search in an index map rather than a
+*          linear scan, and each row stores its values densely by column index.
+*          Columns which a row has not been given a value for read as zero.
 * \author Josh Lurz
 * \todo Fix handling of total row so that a consumer of this class must request it.
 */
@@ -73,29 +76,28 @@ public:
     const std::vector<std::string> getColLabels() const;
 private:
     int getRowIndex( const std::string& aRow ) const;
+    int getColIndex( const std::string& aCol ) const;
+    double& getItem( const std::string& aRow, const std::string& aCol, int& aRowIndex );
     const static int NO_ITEM_FOUND = -1;
     std::vector<std::string> mColLabels;
-    //! Structure for each Item
-    struct Item {
-        explicit Item( const std::string& aLabel );
-        std::string label;
-        double value;
-    };
 
-    //! Structure for each Column.
+    //! Structure for each Row.
     struct Row {
         explicit Row( const std::string& aLabel );
-        int getColIndex( const std::string& aCol ) const;
         std::string label;
-        std::vector<Item> data;
+        //! Values indexed by the column index, may be shorter than the number of columns.
+        std::vector<double> data;
         double total;
     };
-    //! Structure for the internal storage.
-    struct InternalTable {
-        std::string label;
-        std::vector<Row> rows;
-    };
-	InternalTable mInternalTable; //!< The internal storage.
+    //! The rows in the order they were added.
+    std::vector<Row> mRows;
+
+    //! Map of row label to index in mRows.
+    std::map<std::string, int> mRowIndices;
+
+    //! Map of column label to index in each row's data which includes columns
+    //! which were only added through a value.
+    std::map<std::string, int> mColIndices;
 };
 
 #endif // _STORAGE_TABLE_H_
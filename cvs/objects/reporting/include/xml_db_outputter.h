@@ -52,13 +52,27 @@
 
 #if( __HAVE_JAVA__ )
 #include <jni.h>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <boost/iostreams/concepts.hpp>
 #endif
 
+class OutputSpec;
+class XMLDBWriterClient;
+
 /*!
 * \ingroup Objects
 * \brief A visitor which writes model results to an XML database.
-* \details
+* \details If the configuration file xmldb-output-spec is enabled only the
+*          elements it selects are written (see OutputSpec).  The element
+*          types checked against it are region, resource, subresource, sector,
+*          subsector, technology, marketplace and market.  Whole subtrees
+*          which are not selected are skipped without being visited.  Regions
+*          themselves are always written, and any other element is written
+*          when its closest checked ancestor is.
 * \author Josh Lurz
 */
 
@@ -73,6 +87,8 @@ public:
     void finish() const;
     void finalizeAndClose();
 
+    virtual bool shouldVisitChildren() const;
+
     void startVisitScenario( const Scenario* aScenario, const int aPeriod );
     void endVisitScenario( const Scenario* aScenario, const int aPeriod );
 
@@ -271,6 +287,17 @@ private:
     //! Subsector nesting depth output to help querying
     int mSubsectorDepth;
 
+    //! The elements to write, or null to write everything.
+    std::auto_ptr<OutputSpec> mOutputSpec;
+
+    //! The connection to a separate writer process if xmldb-writer-port is
+    //! set, in which case Java is not started in the model process.
+    std::auto_ptr<XMLDBWriterClient> mWriterClient;
+
+    static bool useWriterProcess();
+
+    static std::string getDBLocation();
+
 #if( __HAVE_JAVA__ )
     /*!
      * \brief Contains all objects necessary to interact with Java.
@@ -301,6 +328,66 @@ private:
     const std::auto_ptr<JNIContainer> mJNIContainer;
 
     static std::auto_ptr<JNIContainer> createContainer( const bool aTestingOnly );
+
+    /*!
+     * \brief Sends the XML to Java from a background thread so that the model
+     *        does not wait on the database.
+     * \details The data written is collected into chunks which are queued for a
+     *          writer thread, attached to the Java VM, to pass on to the database.
+     *          Once all of the data has been written the writer thread also calls
+     *          the Java finish method, which waits for the database to complete
+     *          processing.  The number of chunks waiting to be written is limited,
+     *          so if the database falls behind the model waits for it rather
+     *          than using a large amount of memory.
+     */
+    class AsyncJavaWriter {
+    public:
+        AsyncJavaWriter( const JNIContainer* aJNIContainer );
+        ~AsyncJavaWriter();
+
+        void write( const char* aData, std::streamsize aLength );
+
+        void finish();
+
+        void wait();
+    private:
+        //! The size of the chunks sent to Java, which matches the Java side buffer.
+        static const size_t CHUNK_SIZE = 1024 * 1024;
+
+        //! The maximum number of chunks which may be waiting to be sent.
+        static const size_t MAX_PENDING_CHUNKS = 64;
+
+        //! A weak pointer to the JNIContainer with the Java objects to write to.
+        const JNIContainer* mJNIContainer;
+
+        //! Data which has been written but not yet queued.
+        std::string mCurrentChunk;
+
+        //! Chunks of data waiting to be sent to Java.
+        std::deque<std::string> mPendingChunks;
+
+        //! Whether all of the data has been written.
+        bool mIsFinished;
+
+        //! Protects mPendingChunks and mIsFinished.
+        std::mutex mMutex;
+
+        //! Signals that a chunk has been queued or that writing is finished.
+        std::condition_variable mHasChunks;
+
+        //! Signals that a chunk has been taken off of the queue.
+        std::condition_variable mHasSpace;
+
+        //! The thread sending data to Java.
+        std::thread mThread;
+
+        void queueChunk();
+
+        void run();
+    };
+
+    //! Sends the data to Java in the background if xmldb-async-write is set.
+    std::auto_ptr<AsyncJavaWriter> mAsyncWriter;
 #endif
     static const std::string createContainerName( const std::string& aScenarioName );
 
@@ -322,6 +409,10 @@ private:
         const int aYear );
 
     bool isTechnologyOperating( const int aPeriod );
+
+    bool startElement( const std::string& aType, const std::string& aName );
+
+    bool endElement();
     
     std::iostream* popBufferStack();
     
@@ -344,7 +435,7 @@ private:
      */
     class SendToJavaIOSink : public boost::iostreams::sink {
     public:
-        SendToJavaIOSink( const JNIContainer* aJNIContainer );
+        SendToJavaIOSink( const JNIContainer* aJNIContainer, AsyncJavaWriter* aAsyncWriter );
         virtual ~SendToJavaIOSink();
         
         // boost::iostreams::sink methods
@@ -353,6 +444,10 @@ private:
         //! A weak pointer to the JNIContainer to communicate with Java
         const JNIContainer* mJNIContainer;
 
+        //! A weak pointer to the writer the data is handed to if it is sent
+        //! to Java in the background, otherwise null.
+        AsyncJavaWriter* mAsyncWriter;
+
         //! A JNI method ID to the Java method that will receive the data.
         jmethodID mReceiveDataMID;
 
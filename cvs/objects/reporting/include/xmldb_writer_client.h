@@ -0,0 +1,128 @@
+#ifndef _XMLDB_WRITER_CLIENT_H_
+#define _XMLDB_WRITER_CLIENT_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file xmldb_writer_client.h
+ * \ingroup Objects
+ * \brief XMLDBWriterClient class header file.
+ */
+
+#include <string>
+#include <boost/core/noncopyable.hpp>
+#include <boost/iostreams/concepts.hpp>
+
+/*! 
+ * \ingroup Objects
+ * \brief Sends XML database output to a writer process over a socket.
+ * \details The writer process, XMLDBWriterServer in XMLDBDriver.jar, runs the
+ *          XMLDBDriver on behalf of the model so that the model process does
+ *          not need to start a Java VM.  A writer may serve several model
+ *          processes at once, each connection writing its own document.
+ *
+ *          Each message is a one byte type followed by the length of the
+ *          payload as a four byte big endian integer and then the payload:
+ *          - 'O' opens the document, the payload is the database location
+ *            and the document name separated by a null character.
+ *          - 'D' is a chunk of the document.
+ *          - 'A' appends data to the finished document, the payload is the
+ *            XPath location and the data separated by a null character.
+ *          - 'F' signals the document is complete.
+ *          - 'C' runs any final processing and closes the database.
+ *          The writer replies to every message except 'D' with a single byte
+ *          which is 1 if it succeeded and 0 otherwise.
+ *
+ *          Data is collected into chunks before it is sent so that the writer
+ *          is not sent many small messages.
+ */
+class XMLDBWriterClient : private boost::noncopyable {
+public:
+    XMLDBWriterClient();
+    ~XMLDBWriterClient();
+
+    bool connect( const std::string& aHost, const int aPort,
+                  const std::string& aDBLocation, const std::string& aDocName );
+
+    bool isConnected() const;
+
+    void write( const char* aData, const std::streamsize aLength );
+
+    bool appendData( const std::string& aData, const std::string& aLocation );
+
+    bool finish();
+
+    bool finalizeAndClose();
+
+    /*!
+     * \brief A boost IO sink which passes the data written to it to a
+     *        XMLDBWriterClient.
+     */
+    class Sink : public boost::iostreams::sink {
+    public:
+        Sink( XMLDBWriterClient* aClient );
+
+        std::streamsize write( const char* aData, std::streamsize aLength );
+    private:
+        //! A weak pointer to the client to send the data to.
+        XMLDBWriterClient* mClient;
+    };
+
+private:
+    //! The size of the chunks of the document sent to the writer, which
+    //! matches the buffer used by XMLDBDriver.
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+
+    //! The socket connected to the writer, or -1 if there is no connection.
+    int mSocket;
+
+    //! Data which has been written but not yet sent.
+    std::string mCurrentChunk;
+
+    bool sendMessage( const char aType, const char* aData, const size_t aLength );
+
+    bool sendMessage( const char aType, const std::string& aFirst, const std::string& aSecond );
+
+    bool receiveStatus();
+
+    bool sendChunk();
+
+    void close();
+};
+
+#endif // _XMLDB_WRITER_CLIENT_H_
@@ -38,13 +38,13 @@
 * \details This source file contains the definition for the startVisit and endVisit methods
 *          for each class that the visitor visits.  Values will be written directly to the
 *          file specified by the configuration paramater batchCSVOutputFile.
-* \todo Figure out why I need a string to output doubles/chars to an AutoOutputFile.
 * \author Pralit Patel
 */
 
 #include "util/base/include/definitions.h"
 
 #include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
 #include "util/base/include/model_time.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/market.h"
@@ -52,6 +52,9 @@
 #include "climate/include/iclimate_model.h"
 
 #include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
 
 #include "reporting/include/batch_csv_outputter.h"
 
@@ -64,7 +67,46 @@ using namespace std;
 */
 BatchCSVOutputter::BatchCSVOutputter():
 mFile( "batchCSVOutputFile", "batch-csv-out.csv" ),
-mIsFirstScenario(true)
+mIsFirstScenario(true),
+mBytesWritten(0),
+mScenarioOffset(0),
+mIsDeltaOutput( isDeltaOutput() ),
+mDeltaTolerance( Configuration::getInstance()->getDouble( "batch-delta-tolerance", 0, false ) )
+{
+    // only write an index if one was requested since it is a new file
+    const string INDEX_FILE_KEY = "batchCSVIndexFile";
+    if( mFile.shouldWrite() &&
+        !Configuration::getInstance()->getFile( INDEX_FILE_KEY, "", false ).empty() )
+    {
+        mIndexFile.reset( new AutoOutputFile( INDEX_FILE_KEY, "batch-csv-index.csv" ) );
+        **mIndexFile << "Scenario,Offset" << endl;
+    }
+}
+
+/*! \brief Constructor which writes to the given file instead of the configured one.
+ * \param aFileName The name of the file to write.
+*/
+BatchCSVOutputter::BatchCSVOutputter( const string& aFileName ):
+mFile( aFileName ),
+mIsFirstScenario(true),
+mBytesWritten(0),
+mScenarioOffset(0),
+mIsDeltaOutput(false),
+mDeltaTolerance(0)
+{
+}
+
+/*! \brief Constructor which writes to the given stream, for instance to send
+ *         the results to another process.
+ * \param aStream The stream to write to.
+*/
+BatchCSVOutputter::BatchCSVOutputter( ostream& aStream ):
+mFile( aStream ),
+mIsFirstScenario(true),
+mBytesWritten(0),
+mScenarioOffset(0),
+mIsDeltaOutput(false),
+mDeltaTolerance(0)
 {
 }
 
@@ -81,18 +123,18 @@ void BatchCSVOutputter::startVisitScenario( const Scenario* aScenario, const int
     // we can not put this in the constructor because we will not have a model time
     // a that point
     if( mIsFirstScenario ) {
-        mFile << "Scenario" << ',';
+        mRow << "Scenario" << ',';
         const Modeltime* modeltime = aScenario->getModeltime();
 
         for( int period = 0; period < modeltime->getmaxper(); ++period ) {
             // TODO: hard coding CO2
             const int year = modeltime->getper_to_yr( period );
-            mFile << year << ' '<< "CO2 Price" << ',';
+            mRow << year << ' '<< "CO2 Price" << ',';
         }
         for( int period = 0; period < modeltime->getmaxper(); ++period ) {
             // TODO: hard coding CO2
             const int year = modeltime->getper_to_yr( period );
-            mFile << year << ' '<< "CO2 Emissions" << ',';
+            mRow << year << ' '<< "CO2 Emissions" << ',';
         }
 
         int outputInterval = Configuration::getInstance()->getInt( "climateOutputInterval",
@@ -105,25 +147,28 @@ void BatchCSVOutputter::startVisitScenario( const Scenario* aScenario, const int
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Concentration" << ',';
+            mRow << year << ' '<< "CO2 Concentration" << ',';
         }
         for( int year = scenario->getModeltime()->getStartYear();
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Radiative Forcing" << ',';
+            mRow << year << ' '<< "CO2 Radiative Forcing" << ',';
         }
         for( int year = scenario->getModeltime()->getStartYear();
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Temperature Change" << ',';
+            mRow << year << ' '<< "CO2 Temperature Change" << ',';
         }
-        mFile << "Solved" << endl;
+        mRow << "Solved" << '\n';
+        writeRow();
     }
     mIsFirstScenario = false;
 
-    mFile << aScenario->getName() << ',';
+    mScenarioName = aScenario->getName();
+    mScenarioOffset = mBytesWritten;
+    mRow << mScenarioName << ',';
     // TODO: perhaps write some date/time or something
 }
 
@@ -132,10 +177,10 @@ void BatchCSVOutputter::startVisitMarket( const Market* aMarket, const int aPeri
         /*!
          * \warninng This is assuming the periods will be visited in appropriate order.
          */
-        mFile << "" << aMarket->getPrice() << ',';
+        mRow << aMarket->getPrice() << ',';
         
         // would this be wrong if it didn't solve?
-        //mFile << "" << aMarket->getDemand() << ',';
+        //mRow << aMarket->getDemand() << ',';
     }
 }
 
@@ -143,7 +188,7 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
     const Modeltime* modeltime = scenario->getModeltime();
     for( int period = 0; period < modeltime->getmaxper(); ++period ) {
         const int year = modeltime->getper_to_yr( period );
-        mFile << "" << aClimateModel->getEmissions( "CO2", year ) << ',';
+        mRow << aClimateModel->getEmissions( "CO2", year ) << ',';
     }
     
     int outputInterval
@@ -157,17 +202,17 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getConcentration( "CO2", year ) << ',';
+        mRow << aClimateModel->getConcentration( "CO2", year ) << ',';
     }
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getForcing( "CO2", year) << ',';
+        mRow << aClimateModel->getForcing( "CO2", year) << ',';
     }
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getTemperature( year ) << ',';
+        mRow << aClimateModel->getTemperature( year ) << ',';
     }
 }
 
@@ -176,5 +221,126 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
  * \param aDidSolve Whether the current scenario solved.
  */
 void BatchCSVOutputter::writeDidScenarioSolve( bool aDidSolve ) {
-    mFile << aDidSolve << endl;
+    mRow << aDidSolve;
+    if( mIsDeltaOutput ) {
+        if( mReferenceRow.empty() ) {
+            mReferenceRow = mRow.str();
+        }
+        else {
+            const string row = encodeDeltaRow( mReferenceRow, mRow.str(), mDeltaTolerance );
+            mRow.str( "" );
+            mRow << row;
+        }
+    }
+    mRow << '\n';
+    writeRow();
+    (*mFile).flush();
+
+    if( mIndexFile.get() ) {
+        **mIndexFile << mScenarioName << ',' << mScenarioOffset << endl;
+    }
+}
+
+/*!
+ * \brief Write out the current row in one piece and keep track of the offset
+ *        into the file.
+ */
+void BatchCSVOutputter::writeRow() {
+    const string row = mRow.str();
+    (*mFile).write( row.data(), row.size() );
+    mBytesWritten += row.size();
+    mRow.str( "" );
+}
+
+/*!
+ * \brief Get whether batch results should be delta encoded against the first
+ *        scenario.
+ * \return Whether the configuration value batch-delta-output is set.
+ */
+bool BatchCSVOutputter::isDeltaOutput() {
+    return Configuration::getInstance()->getBool( "batch-delta-output", false, false );
+}
+
+/*!
+ * \brief Split a CSV row into its values.
+ * \param aRow The row without the newline.
+ * \return The values in the row.
+ */
+static vector<string> splitRow( const string& aRow ) {
+    vector<string> values;
+    string::size_type start = 0;
+    while( true ) {
+        const string::size_type end = aRow.find( ',', start );
+        values.push_back( aRow.substr( start, end - start ) );
+        if( end == string::npos ) {
+            break;
+        }
+        start = end + 1;
+    }
+    return values;
+}
+
+/*!
+ * \brief Delta encode a row of results against the reference row.
+ * \details Values which are the same as the reference value in the same column
+ *          or, if both are numbers, differ from it by no more than the
+ *          tolerance relative to the reference value are left empty. The first
+ *          column, the scenario name, and any columns beyond the end of the
+ *          reference row are always written.
+ * \param aReferenceRow The full row of the reference scenario.
+ * \param aRow The full row to encode.
+ * \param aTolerance The relative tolerance.
+ * \return The encoded row.
+ */
+string BatchCSVOutputter::encodeDeltaRow( const string& aReferenceRow,
+                                          const string& aRow,
+                                          const double aTolerance )
+{
+    const vector<string> reference = splitRow( aReferenceRow );
+    const vector<string> values = splitRow( aRow );
+    string encoded = values[ 0 ];
+    for( size_t i = 1; i < values.size(); ++i ) {
+        encoded += ',';
+        if( i >= reference.size() || values[ i ].empty() ) {
+            encoded += values[ i ];
+            continue;
+        }
+        bool isSame = values[ i ] == reference[ i ];
+        if( !isSame ) {
+            char* valueEnd = 0;
+            char* referenceEnd = 0;
+            const double value = strtod( values[ i ].c_str(), &valueEnd );
+            const double referenceValue = strtod( reference[ i ].c_str(), &referenceEnd );
+            isSame = *valueEnd == '\0' && *referenceEnd == '\0'
+                && valueEnd != values[ i ].c_str() && referenceEnd != reference[ i ].c_str()
+                && util::isValidNumber( value ) && util::isValidNumber( referenceValue )
+                && fabs( value - referenceValue ) <= aTolerance * fabs( referenceValue );
+        }
+        if( !isSame ) {
+            encoded += values[ i ];
+        }
+    }
+    return encoded;
+}
+
+/*!
+ * \brief Reconstruct the full row of results from a delta encoded row.
+ * \details Each empty value is replaced by the reference value in the same
+ *          column. Values within the tolerance of the reference are
+ *          reconstructed as the reference value.
+ * \param aReferenceRow The full row of the reference scenario.
+ * \param aRow The delta encoded row.
+ * \return The full row.
+ */
+string BatchCSVOutputter::decodeDeltaRow( const string& aReferenceRow,
+                                          const string& aRow )
+{
+    const vector<string> reference = splitRow( aReferenceRow );
+    const vector<string> values = splitRow( aRow );
+    string decoded = values[ 0 ];
+    for( size_t i = 1; i < values.size(); ++i ) {
+        decoded += ',';
+        decoded += values[ i ].empty() && i < reference.size() ? reference[ i ] : values[ i ];
+    }
+    return decoded;
 }
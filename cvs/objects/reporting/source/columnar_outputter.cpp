@@ -0,0 +1,661 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+
+/*! 
+ * \file columnar_outputter.cpp
+ * \ingroup Objects
+ * \brief The ColumnarOutputter class source file for writing results as
+ *        typed column arrays.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include <fstream>
+#include <boost/crc.hpp>
+
+#include "reporting/include/columnar_outputter.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+#include "containers/include/scenario.h"
+#include "containers/include/region.h"
+#include "containers/include/iinfo.h"
+#include "resources/include/aresource.h"
+#include "resources/include/subresource.h"
+#include "resources/include/renewable_subresource.h"
+#include "sectors/include/sector.h"
+#include "sectors/include/subsector.h"
+#include "sectors/include/nesting_subsector.h"
+#include "technologies/include/technology.h"
+#include "technologies/include/ioutput.h"
+#include "functions/include/minicam_input.h"
+#include "emissions/include/aghg.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/market.h"
+#include "land_allocator/include/land_leaf.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+namespace {
+    //! Columns shared by all of the technology tables.
+    enum TechnologyColumn {
+        REGION,
+        SECTOR,
+        SUBSECTOR,
+        TECHNOLOGY,
+        VINTAGE,
+        NUM_TECHNOLOGY_COLUMNS
+    };
+
+    //! Columns of the outputs table after the technology columns.
+    enum OutputColumn {
+        OUTPUT = NUM_TECHNOLOGY_COLUMNS,
+        OUTPUT_YEAR,
+        OUTPUT_VALUE,
+        OUTPUT_UNIT
+    };
+
+    //! Columns of the inputs table after the technology columns.
+    enum InputColumn {
+        INPUT = NUM_TECHNOLOGY_COLUMNS,
+        INPUT_YEAR,
+        INPUT_VALUE,
+        INPUT_UNIT
+    };
+
+    //! Columns of the emissions table after the technology columns.
+    enum EmissionsColumn {
+        GHG = NUM_TECHNOLOGY_COLUMNS,
+        GHG_YEAR,
+        GHG_VALUE,
+        GHG_UNIT
+    };
+
+    //! Columns of the prices table.
+    enum PriceColumn {
+        MARKET,
+        MARKET_REGION,
+        MARKET_GOOD,
+        MARKET_YEAR,
+        MARKET_PRICE,
+        MARKET_SUPPLY,
+        MARKET_DEMAND
+    };
+
+    //! Columns of the land table.
+    enum LandColumn {
+        LAND_REGION,
+        LAND_LEAF,
+        LAND_YEAR,
+        LAND_ALLOCATION
+    };
+
+    /*!
+     * \brief Append an unsigned integer to a buffer in little endian byte order
+     *        as required by the zip format.
+     * \param aValue The value to append.
+     * \param aNumBytes The number of bytes to write.
+     * \param aBuffer The buffer to append to.
+     */
+    void appendLittleEndian( const unsigned int aValue, const int aNumBytes, string& aBuffer ) {
+        for( int i = 0; i < aNumBytes; ++i ) {
+            aBuffer.push_back( static_cast<char>( ( aValue >> ( 8 * i ) ) & 0xFF ) );
+        }
+    }
+
+    /*!
+     * \brief Create a .npy array.
+     * \details The .npy format is a short text header describing the type and
+     *          shape of the array followed by the raw values.
+     * \param aDescr The NumPy type description, e.g. "<f8".
+     * \param aLength The number of elements.
+     * \param aData The raw values.
+     * \param aDataSize The size of aData in bytes.
+     * \return The contents of the .npy file.
+     */
+    string createNpyArray( const string& aDescr, const size_t aLength,
+                           const void* aData, const size_t aDataSize )
+    {
+        string header = "{'descr': '" + aDescr + "', 'fortran_order': False, 'shape': ("
+            + util::toString( aLength ) + ",), }";
+        // The magic string, version and header length take 10 bytes and the
+        // header is padded with spaces and a newline to align the data.
+        const size_t PREFIX_SIZE = 10;
+        const size_t ALIGNMENT = 64;
+        header.append( ALIGNMENT - ( PREFIX_SIZE + header.size() + 1 ) % ALIGNMENT, ' ' );
+        header.push_back( '\n' );
+
+        string npy( "\x93NUMPY\x01\x00", 8 );
+        appendLittleEndian( static_cast<unsigned int>( header.size() ), 2, npy );
+        npy.append( header );
+        npy.append( static_cast<const char*>( aData ), aDataSize );
+        return npy;
+    }
+
+    //! The byte order character of this machine in a NumPy type description.
+    char getByteOrder() {
+        const int one = 1;
+        return *reinterpret_cast<const char*>( &one ) == 1 ? '<' : '>';
+    }
+}
+
+/*! \brief Constructor
+*/
+ColumnarOutputter::ColumnarOutputter():
+mCurrentTechnology( 0 ),
+mOutputs( "outputs" ),
+mInputs( "inputs" ),
+mPrices( "prices" ),
+mEmissions( "emissions" ),
+mLand( "land" )
+{
+    addTechnologyColumns( mOutputs );
+    mOutputs.addColumn( "output", ColumnTable::DICTIONARY );
+    mOutputs.addColumn( "year", ColumnTable::INTEGER );
+    mOutputs.addColumn( "value", ColumnTable::REAL );
+    mOutputs.addColumn( "unit", ColumnTable::DICTIONARY );
+
+    addTechnologyColumns( mInputs );
+    mInputs.addColumn( "input", ColumnTable::DICTIONARY );
+    mInputs.addColumn( "year", ColumnTable::INTEGER );
+    mInputs.addColumn( "value", ColumnTable::REAL );
+    mInputs.addColumn( "unit", ColumnTable::DICTIONARY );
+
+    addTechnologyColumns( mEmissions );
+    mEmissions.addColumn( "ghg", ColumnTable::DICTIONARY );
+    mEmissions.addColumn( "year", ColumnTable::INTEGER );
+    mEmissions.addColumn( "value", ColumnTable::REAL );
+    mEmissions.addColumn( "unit", ColumnTable::DICTIONARY );
+
+    mPrices.addColumn( "market", ColumnTable::DICTIONARY );
+    mPrices.addColumn( "region", ColumnTable::DICTIONARY );
+    mPrices.addColumn( "good", ColumnTable::DICTIONARY );
+    mPrices.addColumn( "year", ColumnTable::INTEGER );
+    mPrices.addColumn( "price", ColumnTable::REAL );
+    mPrices.addColumn( "supply", ColumnTable::REAL );
+    mPrices.addColumn( "demand", ColumnTable::REAL );
+
+    mLand.addColumn( "region", ColumnTable::DICTIONARY );
+    mLand.addColumn( "land-leaf", ColumnTable::DICTIONARY );
+    mLand.addColumn( "year", ColumnTable::INTEGER );
+    mLand.addColumn( "value", ColumnTable::REAL );
+}
+
+/*!
+ * \brief Destructor
+ */
+ColumnarOutputter::~ColumnarOutputter(){
+}
+
+/*!
+ * \brief Write each of the tables to a file.
+ * \details The file names are the value of the configuration file key
+ *          columnar-output with a dash and the table name appended.
+ */
+void ColumnarOutputter::finish() const {
+    const vector<string> fileNames = getFileNames();
+    const ColumnTable* tables[] = { &mOutputs, &mInputs, &mPrices, &mEmissions, &mLand };
+    for( size_t i = 0; i < sizeof( tables ) / sizeof( tables[ 0 ] ); ++i ) {
+        const string& fileName = fileNames[ i ];
+        if( !tables[ i ]->write( fileName ) ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Could not write columnar output to " << fileName << endl;
+        }
+    }
+}
+
+/*!
+ * \brief Get the names of the files finish will write, one per table.
+ * \return The file names in the order outputs, inputs, prices, emissions, land.
+ */
+vector<string> ColumnarOutputter::getFileNames() const {
+    const Configuration* conf = Configuration::getInstance();
+    const string prefix = conf->getFile( "columnar-output", "columnar-output", false );
+    const bool appendScenario = conf->shouldAppendScnToFile( "columnar-output" );
+
+    const ColumnTable* tables[] = { &mOutputs, &mInputs, &mPrices, &mEmissions, &mLand };
+    vector<string> fileNames;
+    for( size_t i = 0; i < sizeof( tables ) / sizeof( tables[ 0 ] ); ++i ) {
+        string fileName = prefix + "-" + tables[ i ]->getName() + ".npz";
+        if( appendScenario ) {
+            fileName = util::appendScenarioToFileName( fileName );
+        }
+        fileNames.push_back( fileName );
+    }
+    return fileNames;
+}
+
+void ColumnarOutputter::startVisitRegion( const Region* aRegion, const int aPeriod ) {
+    mCurrentRegion = aRegion->getName();
+}
+
+void ColumnarOutputter::endVisitRegion( const Region* aRegion, const int aPeriod ) {
+    mCurrentRegion.clear();
+}
+
+void ColumnarOutputter::startVisitResource( const AResource* aResource, const int aPeriod ) {
+    mCurrentSector = aResource->getName();
+    mCurrentOutputUnit = aResource->mOutputUnit;
+    mCurrentInputUnit.clear();
+}
+
+void ColumnarOutputter::endVisitResource( const AResource* aResource, const int aPeriod ) {
+    mCurrentSector.clear();
+    mCurrentOutputUnit.clear();
+}
+
+void ColumnarOutputter::startVisitSubResource( const SubResource* aSubResource, const int aPeriod ) {
+    mSubsectorStack.push_back( aSubResource->getName() );
+}
+
+void ColumnarOutputter::endVisitSubResource( const SubResource* aSubResource, const int aPeriod ) {
+    mSubsectorStack.pop_back();
+}
+
+void ColumnarOutputter::startVisitSubRenewableResource( const SubRenewableResource* aSubResource,
+                                                        const int aPeriod )
+{
+    startVisitSubResource( aSubResource, aPeriod );
+}
+
+void ColumnarOutputter::endVisitSubRenewableResource( const SubRenewableResource* aSubResource,
+                                                      const int aPeriod )
+{
+    endVisitSubResource( aSubResource, aPeriod );
+}
+
+void ColumnarOutputter::startVisitSector( const Sector* aSector, const int aPeriod ) {
+    mCurrentSector = aSector->getName();
+    mCurrentOutputUnit = aSector->mOutputUnit;
+    mCurrentInputUnit = aSector->mInputUnit;
+}
+
+void ColumnarOutputter::endVisitSector( const Sector* aSector, const int aPeriod ) {
+    mCurrentSector.clear();
+    mCurrentOutputUnit.clear();
+    mCurrentInputUnit.clear();
+}
+
+void ColumnarOutputter::startVisitSubsector( const Subsector* aSubsector, const int aPeriod ) {
+    mSubsectorStack.push_back( aSubsector->getName() );
+}
+
+void ColumnarOutputter::endVisitSubsector( const Subsector* aSubsector, const int aPeriod ) {
+    mSubsectorStack.pop_back();
+}
+
+void ColumnarOutputter::startVisitNestingSubsector( const NestingSubsector* aSubsector, const int aPeriod ) {
+    startVisitSubsector( aSubsector, aPeriod );
+}
+
+void ColumnarOutputter::endVisitNestingSubsector( const NestingSubsector* aSubsector, const int aPeriod ) {
+    endVisitSubsector( aSubsector, aPeriod );
+}
+
+void ColumnarOutputter::startVisitTechnology( const Technology* aTechnology, const int aPeriod ) {
+    mCurrentTechnology = aTechnology;
+}
+
+void ColumnarOutputter::endVisitTechnology( const Technology* aTechnology, const int aPeriod ) {
+    mCurrentTechnology = 0;
+}
+
+void ColumnarOutputter::startVisitMiniCAMInput( const MiniCAMInput* aInput, const int aPeriod ) {
+    if( !mCurrentTechnology ) {
+        return;
+    }
+
+    // Energy inputs are measured in the units of the market for the good,
+    // all others in the input units of the sector.
+    string unit = mCurrentInputUnit;
+    if( aInput->hasTypeFlag( IInput::ENERGY ) ) {
+        const IInfo* marketInfo = scenario->getMarketplace()->getMarketInfo( aInput->getName(),
+                                                                            mCurrentRegion, 0, false );
+        if( marketInfo ) {
+            const string& marketUnit = marketInfo->getString( "output-unit", false );
+            if( !marketUnit.empty() ) {
+                unit = marketUnit;
+            }
+        }
+    }
+
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int maxPer = aPeriod == -1 ? modeltime->getmaxper() - 1 : aPeriod;
+    for( int per = 0; per <= maxPer; ++per ) {
+        if( aPeriod != -1 && !mCurrentTechnology->isOperating( per ) ) {
+            continue;
+        }
+        // Avoid writing zeros to save space.
+        const double currValue = aInput->getPhysicalDemand( per );
+        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+            setTechnologyColumns( mInputs );
+            mInputs.setString( INPUT, aInput->getName() );
+            mInputs.setInt( INPUT_YEAR, modeltime->getper_to_yr( per ) );
+            mInputs.setReal( INPUT_VALUE, currValue );
+            mInputs.setString( INPUT_UNIT, unit );
+            mInputs.endRow();
+        }
+    }
+}
+
+void ColumnarOutputter::startVisitOutput( const IOutput* aOutput, const int aPeriod ) {
+    if( !mCurrentTechnology ) {
+        return;
+    }
+
+    // Avoid the expensive units lookup when the good is the same as the
+    // current sector.
+    const string unit = aOutput->getName() == mCurrentSector ? mCurrentOutputUnit
+        : aOutput->getOutputUnits( mCurrentRegion );
+
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int maxPer = aPeriod == -1 ? modeltime->getmaxper() - 1 : aPeriod;
+    for( int per = 0; per <= maxPer; ++per ) {
+        if( aPeriod != -1 && !mCurrentTechnology->isOperating( per ) ) {
+            continue;
+        }
+        const double currValue = aOutput->getPhysicalOutput( per );
+        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+            setTechnologyColumns( mOutputs );
+            mOutputs.setString( OUTPUT, aOutput->getName() );
+            mOutputs.setInt( OUTPUT_YEAR, modeltime->getper_to_yr( per ) );
+            mOutputs.setReal( OUTPUT_VALUE, currValue );
+            mOutputs.setString( OUTPUT_UNIT, unit );
+            mOutputs.endRow();
+        }
+    }
+}
+
+void ColumnarOutputter::startVisitGHG( const AGHG* aGHG, const int aPeriod ) {
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int maxPer = aPeriod == -1 ? modeltime->getmaxper() - 1 : aPeriod;
+    for( int per = 0; per <= maxPer; ++per ) {
+        if( aPeriod != -1 && mCurrentTechnology && !mCurrentTechnology->isOperating( per ) ) {
+            continue;
+        }
+        const double currValue = aGHG->getEmission( per );
+        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+            setTechnologyColumns( mEmissions );
+            mEmissions.setString( GHG, aGHG->getName() );
+            mEmissions.setInt( GHG_YEAR, modeltime->getper_to_yr( per ) );
+            mEmissions.setReal( GHG_VALUE, currValue );
+            mEmissions.setString( GHG_UNIT, aGHG->mEmissionsUnit );
+            mEmissions.endRow();
+        }
+    }
+}
+
+void ColumnarOutputter::startVisitMarket( const Market* aMarket, const int aPeriod ) {
+    mPrices.setString( MARKET, aMarket->getName() );
+    mPrices.setString( MARKET_REGION, aMarket->getRegionName() );
+    mPrices.setString( MARKET_GOOD, aMarket->getGoodName() );
+    mPrices.setInt( MARKET_YEAR, aMarket->getYear() );
+    mPrices.setReal( MARKET_PRICE, aMarket->getPrice() );
+    mPrices.setReal( MARKET_SUPPLY, aMarket->getRawSupply() );
+    mPrices.setReal( MARKET_DEMAND, aMarket->getRawDemand() );
+    mPrices.endRow();
+}
+
+void ColumnarOutputter::startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod ) {
+    // Note this is the total land allocation, not the land harvested in a
+    // given year.
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( int per = 0; per < modeltime->getmaxper(); ++per ) {
+        mLand.setString( LAND_REGION, mCurrentRegion );
+        mLand.setString( LAND_LEAF, aLandLeaf->getName() );
+        mLand.setInt( LAND_YEAR, modeltime->getper_to_yr( per ) );
+        mLand.setReal( LAND_ALLOCATION, aLandLeaf->getLandAllocation( aLandLeaf->getName(), per ) );
+        mLand.endRow();
+    }
+}
+
+/*!
+ * \brief Add the columns which identify a technology to a table.
+ * \param aTable The table to add the columns to, which must have no columns yet.
+ */
+void ColumnarOutputter::addTechnologyColumns( ColumnTable& aTable ) {
+    aTable.addColumn( "region", ColumnTable::DICTIONARY );
+    aTable.addColumn( "sector", ColumnTable::DICTIONARY );
+    aTable.addColumn( "subsector", ColumnTable::DICTIONARY );
+    aTable.addColumn( "technology", ColumnTable::DICTIONARY );
+    aTable.addColumn( "vintage", ColumnTable::INTEGER );
+}
+
+/*!
+ * \brief Set the columns which identify the current technology for the next row
+ *        of a table.
+ * \details Emissions may be reported outside of a technology in which case
+ *          the technology is left blank.
+ * \param aTable The table to set the columns in.
+ */
+void ColumnarOutputter::setTechnologyColumns( ColumnTable& aTable ) {
+    aTable.setString( REGION, mCurrentRegion );
+    aTable.setString( SECTOR, mCurrentSector );
+    aTable.setString( SUBSECTOR, getCurrentSubsector() );
+    aTable.setString( TECHNOLOGY, mCurrentTechnology ? mCurrentTechnology->getName() : "" );
+    aTable.setInt( VINTAGE, mCurrentTechnology ? mCurrentTechnology->getYear() : 0 );
+}
+
+//! Get the name of the innermost subsector being visited, or an empty string.
+const string& ColumnarOutputter::getCurrentSubsector() const {
+    static const string EMPTY;
+    return mSubsectorStack.empty() ? EMPTY : mSubsectorStack.back();
+}
+
+/*!
+ * \brief Constructor
+ * \param aName The name of the table.
+ */
+ColumnarOutputter::ColumnTable::ColumnTable( const string& aName ):
+mName( aName )
+{
+}
+
+/*!
+ * \brief Add a column to the table.
+ * \pre No rows have been added.
+ * \param aName The name of the column.
+ * \param aType The type of the values in the column.
+ * \return The index of the column.
+ */
+size_t ColumnarOutputter::ColumnTable::addColumn( const string& aName, const ColumnType aType ) {
+    Column column;
+    column.mName = aName;
+    column.mType = aType;
+    mColumns.push_back( column );
+    return mColumns.size() - 1;
+}
+
+/*!
+ * \brief Set the value of a DICTIONARY column in the current row.
+ * \param aColumn The index of the column.
+ * \param aValue The value, which is added to the dictionary if it is new.
+ */
+void ColumnarOutputter::ColumnTable::setString( const size_t aColumn, const string& aValue ) {
+    Column& column = mColumns[ aColumn ];
+    assert( column.mType == DICTIONARY );
+    map<string, int>::const_iterator iter = column.mCodes.find( aValue );
+    if( iter == column.mCodes.end() ) {
+        const int code = static_cast<int>( column.mLevels.size() );
+        iter = column.mCodes.insert( make_pair( aValue, code ) ).first;
+        column.mLevels.push_back( aValue );
+    }
+    column.mInts.push_back( iter->second );
+}
+
+/*!
+ * \brief Set the value of an INTEGER column in the current row.
+ * \param aColumn The index of the column.
+ * \param aValue The value.
+ */
+void ColumnarOutputter::ColumnTable::setInt( const size_t aColumn, const int aValue ) {
+    assert( mColumns[ aColumn ].mType == INTEGER );
+    mColumns[ aColumn ].mInts.push_back( aValue );
+}
+
+/*!
+ * \brief Set the value of a REAL column in the current row.
+ * \param aColumn The index of the column.
+ * \param aValue The value.
+ */
+void ColumnarOutputter::ColumnTable::setReal( const size_t aColumn, const double aValue ) {
+    assert( mColumns[ aColumn ].mType == REAL );
+    mColumns[ aColumn ].mReals.push_back( aValue );
+}
+
+/*!
+ * \brief Finish the current row.
+ * \details Every column must have been set exactly once since the last row.
+ */
+void ColumnarOutputter::ColumnTable::endRow() {
+#ifndef NDEBUG
+    for( size_t i = 1; i < mColumns.size(); ++i ) {
+        assert( mColumns[ i ].mInts.size() + mColumns[ i ].mReals.size() ==
+                mColumns[ 0 ].mInts.size() + mColumns[ 0 ].mReals.size() );
+    }
+#endif
+}
+
+const string& ColumnarOutputter::ColumnTable::getName() const {
+    return mName;
+}
+
+/*!
+ * \brief Write the table to a NumPy .npz file.
+ * \details The .npz file is an uncompressed zip archive with a .npy array for
+ *          each column, plus an array of fixed width byte strings holding the
+ *          dictionary of each DICTIONARY column.
+ * \param aFileName The name of the file to write.
+ * \return Whether the file was written successfully.
+ */
+bool ColumnarOutputter::ColumnTable::write( const string& aFileName ) const {
+    ofstream file( aFileName.c_str(), ios::out | ios::binary );
+    if( !file ) {
+        return false;
+    }
+
+    // Create the arrays for each column.
+    const string byteOrder( 1, getByteOrder() );
+    vector<pair<string, string> > arrays;
+    for( vector<Column>::const_iterator column = mColumns.begin(); column != mColumns.end(); ++column ) {
+        if( column->mType == REAL ) {
+            arrays.push_back( make_pair( column->mName, createNpyArray( byteOrder + "f8", column->mReals.size(),
+                column->mReals.empty() ? 0 : &column->mReals[ 0 ], column->mReals.size() * sizeof( double ) ) ) );
+        }
+        else {
+            arrays.push_back( make_pair( column->mName, createNpyArray( byteOrder + "i4", column->mInts.size(),
+                column->mInts.empty() ? 0 : &column->mInts[ 0 ], column->mInts.size() * sizeof( int ) ) ) );
+        }
+        if( column->mType == DICTIONARY ) {
+            // Store the levels as fixed width byte strings padded with nulls.
+            size_t width = 1;
+            for( size_t i = 0; i < column->mLevels.size(); ++i ) {
+                width = max( width, column->mLevels[ i ].size() );
+            }
+            string levels( width * column->mLevels.size(), '\0' );
+            for( size_t i = 0; i < column->mLevels.size(); ++i ) {
+                levels.replace( i * width, column->mLevels[ i ].size(), column->mLevels[ i ] );
+            }
+            arrays.push_back( make_pair( column->mName + "-levels",
+                createNpyArray( "|S" + util::toString( width ), column->mLevels.size(),
+                                levels.data(), levels.size() ) ) );
+        }
+    }
+
+    // Write the zip archive: each array with a local file header, then the
+    // central directory and its end record.  The arrays are stored without
+    // compression.
+    string centralDirectory;
+    unsigned int offset = 0;
+    for( size_t i = 0; i < arrays.size(); ++i ) {
+        const string name = arrays[ i ].first + ".npy";
+        const string& data = arrays[ i ].second;
+        boost::crc_32_type crc;
+        crc.process_bytes( data.data(), data.size() );
+        const unsigned int size = static_cast<unsigned int>( data.size() );
+
+        // The fields shared by the local header and the central directory:
+        // version needed, flags, method, time, date (1980-01-01), crc and sizes.
+        string common;
+        appendLittleEndian( 20, 2, common );
+        appendLittleEndian( 0, 2, common );
+        appendLittleEndian( 0, 2, common );
+        appendLittleEndian( 0, 2, common );
+        appendLittleEndian( 0x21, 2, common );
+        appendLittleEndian( crc.checksum(), 4, common );
+        appendLittleEndian( size, 4, common );
+        appendLittleEndian( size, 4, common );
+        appendLittleEndian( static_cast<unsigned int>( name.size() ), 2, common );
+        appendLittleEndian( 0, 2, common );
+
+        string localHeader;
+        appendLittleEndian( 0x04034b50, 4, localHeader );
+        localHeader.append( common );
+        localHeader.append( name );
+        file.write( localHeader.data(), localHeader.size() );
+        file.write( data.data(), data.size() );
+
+        appendLittleEndian( 0x02014b50, 4, centralDirectory );
+        appendLittleEndian( 20, 2, centralDirectory );
+        centralDirectory.append( common );
+        // Comment length, disk number, internal and external attributes.
+        appendLittleEndian( 0, 2, centralDirectory );
+        appendLittleEndian( 0, 2, centralDirectory );
+        appendLittleEndian( 0, 2, centralDirectory );
+        appendLittleEndian( 0, 4, centralDirectory );
+        appendLittleEndian( offset, 4, centralDirectory );
+        centralDirectory.append( name );
+
+        offset += static_cast<unsigned int>( localHeader.size() ) + size;
+    }
+
+    string endRecord;
+    appendLittleEndian( 0x06054b50, 4, endRecord );
+    appendLittleEndian( 0, 2, endRecord );
+    appendLittleEndian( 0, 2, endRecord );
+    appendLittleEndian( static_cast<unsigned int>( arrays.size() ), 2, endRecord );
+    appendLittleEndian( static_cast<unsigned int>( arrays.size() ), 2, endRecord );
+    appendLittleEndian( static_cast<unsigned int>( centralDirectory.size() ), 4, endRecord );
+    appendLittleEndian( offset, 4, endRecord );
+    appendLittleEndian( 0, 2, endRecord );
+    file.write( centralDirectory.data(), centralDirectory.size() );
+    file.write( endRecord.data(), endRecord.size() );
+
+    return file.good();
+}
@@ -81,7 +81,7 @@ void GraphPrinter::startVisitRegion( const Region* aRegion, const int aPeriod ){
     if( aRegion->getName() == mRegionToPrint ){
         mCorrectRegion = true;
         // Print the graph header.
-        mFile << "digraph " << util::replaceSpaces( aRegion->getName() ) << " {" << endl;
+        mFile << "digraph " << util::replaceSpaces( aRegion->getName() ) << " {\n";
     }
     else {
         // Don't print this region.
@@ -98,7 +98,7 @@ void GraphPrinter::startVisitRegion( const Region* aRegion, const int aPeriod ){
 void GraphPrinter::endVisitRegion( const Region* aRegion, const int aPeriod ){
     if( mCorrectRegion ){
         // Now close the graph.
-        mFile << "}" << endl << endl;
+        mFile << "}\n\n";
     }
 }
 
@@ -116,7 +116,7 @@ void GraphPrinter::startVisitResource( const AResource* aResource, const int aPe
 
     // Output a node with the resource label and styling.
     mFile << "\t" << util::replaceSpaces( aResource->getName() ) << "[label=\"" << aResource->getName() 
-            << "\", shape=box, style=filled, color=indianred1 ];" << endl;
+            << "\", shape=box, style=filled, color=indianred1 ];\n";
 }
 
 /*! \brief Add the sector to a dependency graph.
@@ -136,7 +136,7 @@ void GraphPrinter::startVisitSector( const Sector* aSector, const int aPeriod ){
     mCurrSectorName = util::replaceSpaces( aSector->getName() );
 
     // Write out a node with a label.
-    mFile << "\t" << mCurrSectorName << "[label=\"" << aSector->getName() << "\"];" << endl;
+    mFile << "\t" << mCurrSectorName << "[label=\"" << aSector->getName() << "\"];\n";
 }
 
 /*! \brief Visits the demand sector.
@@ -152,7 +152,7 @@ void GraphPrinter::startVisitFinalDemand( const AFinalDemand* aDemandSector, con
     }
     // output sector coloring here.
    mFile << "\t" << util::replaceSpaces( aDemandSector->getName() )
-           << " [style=filled, color=steelblue1 ];" << endl;
+           << " [style=filled, color=steelblue1 ];\n";
 }
 
 /*! \brief Add the technology to the graph.
@@ -68,11 +68,33 @@ mCorrectRegion( false ),
 mRegionToPrint( aRegionToPrint ),
 mNumNodes( 0 ),
 mPrintValues( aPrintValues ),
-mPrintSpecificRegion( aPrintSpecificRegion )
+mPrintSpecificRegion( aPrintSpecificRegion ),
+mSubtreeDepth( -1 )
 {
     // Imbue the output stream with the default locale from the user's machine.
     // This is done so thousands separators will be outputted.
     mFile.imbue( locale( "" ) );
+
+    // Only the land allocator is printed.
+    skipContent( IVisitor::SUBSECTORS | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
+}
+
+/*!
+ * \brief Only print the subtree under the land node with the given name.
+ * \param aNodeName The name of the land node to print from, or empty
+ *                  to print the entire land allocator.
+ */
+void LandAllocatorPrinter::setNodeToPrint( const string& aNodeName ) {
+    mNodeToPrint = aNodeName;
+}
+
+/*!
+ * \brief Whether the item currently being visited should be printed.
+ * \return True if in the region to print and within the subtree to print.
+ */
+bool LandAllocatorPrinter::shouldPrint() const {
+    return ( !mPrintSpecificRegion || mCorrectRegion ) &&
+           ( mNodeToPrint.empty() || mSubtreeDepth >= 0 );
 }
 
 /*!
@@ -86,7 +108,7 @@ void LandAllocatorPrinter::startVisitRegion( const Region* aRegion, const int aP
     if( aRegion->getName() == mRegionToPrint ){
         mCorrectRegion = true;
         // Print the graph header.
-        mFile << "digraph " << util::replaceSpaces( aRegion->getName() ) << " {" << endl;
+        mFile << "digraph " << util::replaceSpaces( aRegion->getName() ) << " {\n";
     }
     else {
         // Don't print this region.
@@ -103,7 +125,7 @@ void LandAllocatorPrinter::startVisitRegion( const Region* aRegion, const int aP
 void LandAllocatorPrinter::endVisitRegion( const Region* aRegion, const int aPeriod ){
     if( mCorrectRegion ){
         // Now close the graph.
-        mFile << "}" << endl << endl;
+        mFile << "}\n\n";
     }
 }
 
@@ -115,7 +137,14 @@ void LandAllocatorPrinter::endVisitRegion( const Region* aRegion, const int aPer
  * \param aPeriod Period for which to visit.
  */
 void LandAllocatorPrinter::startVisitLandNode( const LandNode *aLandNode, const int aPeriod ){
-    if( mPrintSpecificRegion && !mCorrectRegion ){
+    // Keep track of whether we are inside of the subtree to print.
+    if( mSubtreeDepth >= 0 ) {
+        ++mSubtreeDepth;
+    }
+    else if( !mNodeToPrint.empty() && aLandNode->getName() == mNodeToPrint ) {
+        mSubtreeDepth = 0;
+    }
+    if( !shouldPrint() ){
         return;
     }
 
@@ -137,7 +166,11 @@ void LandAllocatorPrinter::startVisitLandNode( const LandNode *aLandNode, const
  * \param aPeriod Period for which to end visiting.
  */
 void LandAllocatorPrinter::endVisitLandNode( const LandNode *aLandNode, const int aPeriod ){
-    if( mPrintSpecificRegion && !mCorrectRegion ){
+    const bool printed = shouldPrint();
+    if( mSubtreeDepth >= 0 ) {
+        --mSubtreeDepth;
+    }
+    if( !printed ){
         return;
     }
     mParent.pop();
@@ -150,7 +183,7 @@ void LandAllocatorPrinter::endVisitLandNode( const LandNode *aLandNode, const in
  * \param aPeriod Period for which to visit.
  */
 void LandAllocatorPrinter::startVisitLandLeaf( const LandLeaf *aLandLeaf, const int aPeriod ){
-    if( mPrintSpecificRegion && !mCorrectRegion ){
+    if( !shouldPrint() ){
         return;
     }
     printNode( aLandLeaf, aPeriod, true );
@@ -178,7 +211,7 @@ void LandAllocatorPrinter::printNode( const ALandAllocatorItem* aLandItem,
     if( aIsLeaf ){
         mFile << ", shape=box";
     }
-    mFile << "];" << endl;
+    mFile << "];\n";
 }
 
 /*!
@@ -188,7 +221,7 @@ void LandAllocatorPrinter::printNode( const ALandAllocatorItem* aLandItem,
  */
 void LandAllocatorPrinter::printParentChildRelationship( const ALandAllocatorItem* aLandItem ) const{
     mFile << "\t" << mParent.top() << "->" 
-          << util::replaceSpaces( makeNameFromLabel( aLandItem->getName() ) ) << ";" << endl;
+          << util::replaceSpaces( makeNameFromLabel( aLandItem->getName() ) ) << ";\n";
 }
 
 /*!
@@ -208,7 +241,7 @@ string LandAllocatorPrinter::makeNameFromLabel( const string& aName ) const{
  *          inside a land allocator object.
  */
 void LandAllocatorPrinter::openGraph() const {
-    mFile << "digraph la {" << endl;
+    mFile << "digraph la {\n";
 }
 
 /*!
@@ -218,7 +251,7 @@ void LandAllocatorPrinter::openGraph() const {
  *          inside a land allocator object.
  */
 void LandAllocatorPrinter::closeGraph() const {
-    mFile << "}" << endl << endl;
+    mFile << "}\n\n";
 }
 
 /*!
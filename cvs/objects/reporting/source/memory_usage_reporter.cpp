@@ -0,0 +1,209 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file memory_usage_reporter.cpp
+ * \ingroup Objects
+ * \brief The MemoryUsageReporter class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <iomanip>
+
+#include "reporting/include/memory_usage_reporter.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/object_pool.h"
+#include "util/base/include/xml_memory_manager.h"
+#include "util/base/include/model_time.h"
+#include "containers/include/scenario.h"
+#include "containers/include/region_minicam.h"
+#include "sectors/include/sector.h"
+#include "sectors/include/subsector.h"
+#include "resources/include/aresource.h"
+#include "technologies/include/technology.h"
+#include "technologies/include/primary_output.h"
+#include "functions/include/minicam_input.h"
+#include "functions/include/node_input.h"
+#include "emissions/include/aghg.h"
+#include "land_allocator/include/land_node.h"
+#include "land_allocator/include/land_leaf.h"
+#include "ccarbon_model/include/asimple_carbon_calc.h"
+#include "ccarbon_model/include/carbon_model_utils.h"
+#include "marketplace/include/market.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+namespace {
+    //! The names of the categories in the order of MemoryUsageReporter::Category.
+    const char* CATEGORY_NAMES[] = { "regions", "sectors and resources", "technology vintages",
+                                     "land and carbon", "markets" };
+
+    //! Convert bytes to megabytes for printing.
+    double toMB( const size_t aBytes ) {
+        return static_cast<double>( aBytes ) / ( 1024.0 * 1024.0 );
+    }
+}
+
+//! Constructor
+MemoryUsageReporter::MemoryUsageReporter():
+mNumObjects( NUM_CATEGORIES, 0 ),
+mNumBytes( NUM_CATEGORIES, 0 ),
+mStateBytes( 0 )
+{
+}
+
+/*!
+ * \brief Whether memory usage should be reported.
+ * \return The value of the configuration flag log-memory-usage.
+ */
+bool MemoryUsageReporter::isEnabled() {
+    const static bool logMemoryUsage = Configuration::getInstance()->getBool( "log-memory-usage", false, false );
+    return logMemoryUsage;
+}
+
+/*!
+ * \brief Set the bytes of state data to include in the report.
+ * \param aStateBytes The bytes used by the ManageStateVariables, if any.
+ */
+void MemoryUsageReporter::setStateBytes( const size_t aStateBytes ) {
+    mStateBytes = aStateBytes;
+}
+
+/*!
+ * \brief Write the report.
+ * \param aOut The stream to which to write.
+ * \param aTitle A description of when the report was made.
+ */
+void MemoryUsageReporter::printReport( ostream& aOut, const string& aTitle ) const {
+    const ios_base::fmtflags flags = aOut.flags();
+    const streamsize precision = aOut.precision();
+    aOut << fixed << setprecision( 1 );
+    aOut << "Memory usage " << aTitle << " (MB):" << endl;
+
+    size_t totalBytes = 0;
+    for( int i = 0; i < NUM_CATEGORIES; ++i ) {
+        aOut << "    " << CATEGORY_NAMES[ i ] << ": " << toMB( mNumBytes[ i ] )
+             << " estimated in " << mNumObjects[ i ] << " objects" << endl;
+        totalBytes += mNumBytes[ i ];
+    }
+    aOut << "    total estimated: " << toMB( totalBytes ) << endl;
+
+    const ObjectPool& pool = ObjectPool::getInstance();
+    aOut << "    object pool: " << toMB( pool.getBytesInUse() ) << " in use, "
+         << toMB( pool.getBytesReserved() ) << " reserved" << endl;
+    aOut << "    state data: " << toMB( mStateBytes ) << endl;
+
+    const XMLMemoryManager& xmlMemory = XMLMemoryManager::getInstance();
+    aOut << "    XML parser and DOM buffers: " << toMB( xmlMemory.getBytesInUse() ) << " in use, "
+         << toMB( xmlMemory.getPeakBytes() ) << " peak" << endl;
+
+    aOut << "    estimated by region:" << endl;
+    for( map<string, size_t>::const_iterator iter = mRegionBytes.begin(); iter != mRegionBytes.end(); ++iter ) {
+        aOut << "        " << iter->first << ": " << toMB( iter->second ) << endl;
+    }
+    aOut.flags( flags );
+    aOut.precision( precision );
+}
+
+/*!
+ * \brief Count an object.
+ * \param aCategory The category of the object.
+ * \param aBytes The estimated bytes of the object.
+ */
+void MemoryUsageReporter::add( const Category aCategory, const size_t aBytes ) {
+    ++mNumObjects[ aCategory ];
+    mNumBytes[ aCategory ] += aBytes;
+    if( !mCurrentRegion.empty() ) {
+        mRegionBytes[ mCurrentRegion ] += aBytes;
+    }
+}
+
+void MemoryUsageReporter::startVisitRegion( const Region* aRegion, const int aPeriod ) {
+    // The land allocator is visited after the region visit ends so the
+    // current region is kept until the next region starts.
+    mCurrentRegion = aRegion->getName();
+    add( REGION, sizeof( RegionMiniCAM ) );
+}
+
+void MemoryUsageReporter::startVisitSector( const Sector* aSector, const int aPeriod ) {
+    add( SECTOR, sizeof( Sector ) );
+}
+
+void MemoryUsageReporter::startVisitResource( const AResource* aResource, const int aPeriod ) {
+    add( SECTOR, sizeof( AResource ) );
+}
+
+void MemoryUsageReporter::startVisitSubsector( const Subsector* aSubsector, const int aPeriod ) {
+    add( SECTOR, sizeof( Subsector ) );
+}
+
+void MemoryUsageReporter::startVisitTechnology( const Technology* aTechnology, const int aPeriod ) {
+    add( TECHNOLOGY, sizeof( Technology ) );
+}
+
+void MemoryUsageReporter::startVisitMiniCAMInput( const MiniCAMInput* aInput, const int aPeriod ) {
+    add( TECHNOLOGY, sizeof( MiniCAMInput ) );
+}
+
+void MemoryUsageReporter::startVisitNodeInput( const NodeInput* aNodeInput, const int aPeriod ) {
+    add( TECHNOLOGY, sizeof( NodeInput ) );
+}
+
+void MemoryUsageReporter::startVisitOutput( const IOutput* aOutput, const int aPeriod ) {
+    add( TECHNOLOGY, sizeof( PrimaryOutput ) );
+}
+
+void MemoryUsageReporter::startVisitGHG( const AGHG* aGHG, const int aPeriod ) {
+    add( TECHNOLOGY, sizeof( AGHG ) );
+}
+
+void MemoryUsageReporter::startVisitLandNode( const LandNode* aLandNode, const int aPeriod ) {
+    add( LAND, sizeof( LandNode ) );
+}
+
+void MemoryUsageReporter::startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod ) {
+    add( LAND, sizeof( LandLeaf ) );
+}
+
+void MemoryUsageReporter::startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc, const int aPeriod ) {
+    // Only the simple carbon calculations are visited, each of which keeps
+    // three yearly emissions arrays and a yearly carbon stock.
+    const size_t numYears = CarbonModelUtils::getEndYear() - scenario->getModeltime()->getStartYear() + 1;
+    add( LAND, sizeof( ASimpleCarbonCalc ) + numYears * ( 3 * sizeof( double ) + sizeof( Value ) ) );
+}
+
+void MemoryUsageReporter::startVisitMarket( const Market* aMarket, const int aPeriod ) {
+    add( MARKET, sizeof( Market ) );
+}
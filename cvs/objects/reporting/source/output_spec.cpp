@@ -0,0 +1,191 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+
+/*! 
+ * \file output_spec.cpp
+ * \ingroup Objects
+ * \brief OutputSpec class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include <fstream>
+
+#include "reporting/include/output_spec.h"
+
+using namespace std;
+
+OutputSpec::Node::Node():
+mSelectsSubtree( false )
+{
+}
+
+/*!
+ * \brief Constructor which creates an empty specification which selects nothing.
+ */
+OutputSpec::OutputSpec():
+mNodes( 1 )
+{
+}
+
+/*!
+ * \brief Read the paths from a file.
+ * \param aFileName The file with one path per line.
+ * \return Whether the file could be read.
+ */
+bool OutputSpec::readFile( const string& aFileName ) {
+    ifstream file( aFileName.c_str() );
+    if( !file ) {
+        return false;
+    }
+    string line;
+    while( getline( file, line ) ) {
+        // Trim white space including a carriage return left by a Windows
+        // line ending.
+        const size_t start = line.find_first_not_of( " \t\r" );
+        if( start == string::npos || line[ start ] == '#' ) {
+            continue;
+        }
+        const size_t end = line.find_last_not_of( " \t\r" );
+        addPath( line.substr( start, end - start + 1 ) );
+    }
+    return true;
+}
+
+/*!
+ * \brief Add a path to the specification.
+ * \param aPath Element types separated by slashes, each optionally qualified
+ *        with a name as type[@name='name'].
+ */
+void OutputSpec::addPath( const string& aPath ) {
+    int node = 0;
+    size_t start = 0;
+    while( start < aPath.size() ) {
+        size_t end = start;
+        // Find the next separator which is not inside a name qualifier.
+        bool inQualifier = false;
+        while( end < aPath.size() && ( inQualifier || aPath[ end ] != '/' ) ) {
+            if( aPath[ end ] == '[' || aPath[ end ] == ']' ) {
+                inQualifier = aPath[ end ] == '[';
+            }
+            ++end;
+        }
+        const string step = aPath.substr( start, end - start );
+        start = end + 1;
+        if( step.empty() ) {
+            continue;
+        }
+
+        string type = step;
+        string name;
+        const size_t qualifier = step.find( '[' );
+        if( qualifier != string::npos ) {
+            type = step.substr( 0, qualifier );
+            const size_t nameStart = step.find_first_of( "'\"", qualifier );
+            const size_t nameEnd = nameStart == string::npos ? string::npos
+                : step.find( step[ nameStart ], nameStart + 1 );
+            if( nameEnd != string::npos ) {
+                name = step.substr( nameStart + 1, nameEnd - nameStart - 1 );
+            }
+        }
+
+        const string key = createKey( type, name );
+        int child = findChild( node, key );
+        if( child == -1 ) {
+            child = static_cast<int>( mNodes.size() );
+            mNodes.push_back( Node() );
+            mNodes[ node ].mChildren[ key ] = child;
+        }
+        node = child;
+    }
+    mNodes[ node ].mSelectsSubtree = true;
+}
+
+/*!
+ * \brief Start an element.
+ * \param aType The type of the element.
+ * \param aName The name of the element.
+ * \return Whether the element is selected.
+ */
+bool OutputSpec::enter( const string& aType, const string& aName ) {
+    const int parent = mPath.empty() ? 0 : mPath.back();
+    int next = -1;
+    if( parent != -1 ) {
+        if( mNodes[ parent ].mSelectsSubtree ) {
+            next = parent;
+        }
+        else {
+            next = findChild( parent, createKey( aType, aName ) );
+            if( next == -1 ) {
+                next = findChild( parent, createKey( aType, "" ) );
+            }
+        }
+    }
+    mPath.push_back( next );
+    return next != -1;
+}
+
+/*!
+ * \brief Finish the element most recently started.
+ */
+void OutputSpec::leave() {
+    mPath.pop_back();
+}
+
+/*!
+ * \brief Whether the element most recently started, and not yet finished, is
+ *        selected.
+ * \return Whether the current element is selected, true if no element has
+ *         been started.
+ */
+bool OutputSpec::isSelected() const {
+    return mPath.empty() || mPath.back() != -1;
+}
+
+//! Create the key used to find the node for an element type and name.
+string OutputSpec::createKey( const string& aType, const string& aName ) {
+    return aName.empty() ? aType : aType + "[" + aName + "]";
+}
+
+/*!
+ * \brief Find a child of a node.
+ * \param aParent The index of the parent node.
+ * \param aKey The key of the child.
+ * \return The index of the child or -1 if there is none.
+ */
+int OutputSpec::findChild( const int aParent, const string& aKey ) const {
+    map<string, int>::const_iterator iter = mNodes[ aParent ].mChildren.find( aKey );
+    return iter == mNodes[ aParent ].mChildren.end() ? -1 : iter->second;
+}
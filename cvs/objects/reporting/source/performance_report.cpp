@@ -0,0 +1,123 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file performance_report.cpp
+ * \ingroup Objects
+ * \brief PerformanceReport class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "reporting/include/performance_report.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/auto_file.h"
+#include "util/base/include/configuration.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+PerformanceReport::PerformanceReport()
+:mIsEnabled( Configuration::getInstance()->getBool( "log-performance-report", false, false ) ),
+mNumSolverIterations( 0 )
+{
+}
+
+//! Destructor, needed here where AutoOutputFile is complete.
+PerformanceReport::~PerformanceReport() {
+}
+
+/*!
+ * \brief Get the single instance of the report.
+ * \details The instance is created on first use which must be after the
+ *          configuration is read.
+ * \return The report.
+ */
+PerformanceReport& PerformanceReport::getInstance() {
+    static PerformanceReport report;
+    return report;
+}
+
+/*!
+ * \brief Write the row for a phase which has finished.
+ * \param aPhase The name of the phase.
+ * \param aPeriod The period of the phase or -1 if it is not for a period.
+ * \param aStart The time the phase started.
+ * \param aNumEvaluations The number of model evaluations during the phase.
+ * \param aNumSolverIterations The number of solver iterations during the phase.
+ */
+void PerformanceReport::recordPhase( const string& aPhase, const int aPeriod,
+                                     const chrono::steady_clock::time_point& aStart,
+                                     const int aNumEvaluations, const int aNumSolverIterations )
+{
+    if( !mIsEnabled ) {
+        return;
+    }
+    const chrono::duration<double> seconds = chrono::steady_clock::now() - aStart;
+
+    if( !mFile.get() ) {
+        mFile.reset( new AutoOutputFile( "performanceReportFileName", "performance-report.csv" ) );
+        **mFile << "scenario,phase,period,seconds,model-evals,solver-iterations,peak-rss-kb" << endl;
+    }
+    **mFile << ( scenario ? scenario->getName() : "" ) << ',' << aPhase << ',' << aPeriod << ','
+            << seconds.count() << ',' << aNumEvaluations << ',' << aNumSolverIterations << ','
+            << getPeakRSSKilobytes() << endl;
+}
+
+/*!
+ * \brief Get the peak resident set size of the process.
+ * \return The peak resident set size in kilobytes or zero if it is not
+ *         available on this platform.
+ */
+long PerformanceReport::getPeakRSSKilobytes() {
+#if !defined(_WIN32)
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) != 0 ) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // Reported in bytes rather than kilobytes.
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
@@ -56,12 +56,13 @@ StorageTable::StorageTable(){
 //! Clear the data in the table. 
 // This does not clear column labels.
 void StorageTable::clear() {
-    mInternalTable.rows.clear();
+    mRows.clear();
+    mRowIndices.clear();
 }
 
 //! Return if the table has any rows.
 bool StorageTable::isEmpty() const {
-    return mInternalTable.rows.empty();
+    return mRows.empty();
 }
 
 /*! \brief Add a column label to the list of columns.
@@ -88,58 +89,19 @@ void StorageTable::addToType( const int aRow, const string& aCol, const double a
 
 //! Add to the value for the table specified by the account type key. 
 void StorageTable::addToType( const string& aRow, const string& aCol, const double aValue ){
-    // Find the correct column.
-    int rowIndex = getRowIndex( aRow );
-    
-    // If the row does not exist insert one on the end.
-    if( rowIndex == NO_ITEM_FOUND ){
-        mInternalTable.rows.push_back( Row( aRow ) );
-        // Set the row index to the new row so we can add the value.
-        rowIndex = static_cast<int>( mInternalTable.rows.size() ) - 1;
-    }
-
-    // Find the column index.
-    int colIndex = mInternalTable.rows[ rowIndex ].getColIndex( aCol );
-
-    // If the column does not exist add it onto the end of the row.
-    if( colIndex == NO_ITEM_FOUND ){
-        mInternalTable.rows[ rowIndex ].data.push_back( Item( aCol ) );
-        // Set the col index to the new col so we can add the value.
-        colIndex = static_cast<int>( mInternalTable.rows[ rowIndex ].data.size() ) - 1;
-    }
-    // Add the value to the correct position.
-    mInternalTable.rows[ rowIndex ].data[ colIndex ].value += aValue;
+    int rowIndex;
+    getItem( aRow, aCol, rowIndex ) += aValue;
     // Add to the total.
-    mInternalTable.rows[ rowIndex ].total += aValue;
+    mRows[ rowIndex ].total += aValue;
 }
 
 //! set the value for the table specified by the account type key.
-// This function should be replaced with a clear row and then use addToType.
-// Right now it is massive copy-paste.
+// Note that this does not update the row total.
 void StorageTable::setType( const string& aRow, const string& aCol,
                               const double aValue )
 {
- 	// Find the correct column.
-    int rowIndex = getRowIndex( aRow );
-    
-    // If the row does not exist insert one on the end.
-    if( rowIndex == NO_ITEM_FOUND ){
-        mInternalTable.rows.push_back( Row( aRow ) );
-        // Set the row index to the new row so we can add the value.
-        rowIndex = static_cast<int>( mInternalTable.rows.size() ) - 1;
-    }
-
-    // Find the column index.
-    int colIndex = mInternalTable.rows[ rowIndex ].getColIndex( aCol );
-
-    // If the column does not exist add it onto the end of the row.
-    if( colIndex == NO_ITEM_FOUND ){
-        mInternalTable.rows[ rowIndex ].data.push_back( Item( aCol ) );
-        // Set the col index to the new col so we can add the value.
-        colIndex = static_cast<int>( mInternalTable.rows[ rowIndex ].data.size() ) - 1;
-    }
-    // Add the value to the correct position.
-    mInternalTable.rows[ rowIndex ].data[ colIndex ].value = aValue;
+    int rowIndex;
+    getItem( aRow, aCol, rowIndex ) = aValue;
 }
 
 //! Get the value for the table specified by the account type key. 
@@ -148,12 +110,12 @@ double StorageTable::getValue( const string& aRow, const string& aCol ) const {
     if( rowIndex != NO_ITEM_FOUND ){
         // Special case total here.
         if( aCol == "Total" ){
-            return mInternalTable.rows[ rowIndex ].total;
+            return mRows[ rowIndex ].total;
         }
         // Find the correct column.
-        const int colIndex = mInternalTable.rows[ rowIndex ].getColIndex( aCol );
-        if( colIndex != NO_ITEM_FOUND ){
-            return mInternalTable.rows[ rowIndex ].data[ colIndex ].value;
+        const int colIndex = getColIndex( aCol );
+        if( colIndex != NO_ITEM_FOUND && colIndex < static_cast<int>( mRows[ rowIndex ].data.size() ) ){
+            return mRows[ rowIndex ].data[ colIndex ];
         }
     }
     // Is this an error?
@@ -163,10 +125,11 @@ double StorageTable::getValue( const string& aRow, const string& aCol ) const {
 //! Get the list of all row labels in order.
 const vector<string> StorageTable::getRowLabels() const {
     vector<string> rowLabels;
+    rowLabels.reserve( mRows.size() );
 
     // Loop through the rows and add the label for each to the vector.
-    for( unsigned int row = 0; row < mInternalTable.rows.size(); ++row ){
-        rowLabels.push_back( mInternalTable.rows[ row ].label );
+    for( unsigned int row = 0; row < mRows.size(); ++row ){
+        rowLabels.push_back( mRows[ row ].label );
     }
 
     // Return the list of row labels.
@@ -190,20 +153,46 @@ const vector<string> StorageTable::getColLabels() const {
 * \author Josh Lurz
 */
 int StorageTable::getRowIndex( const string& aRow ) const {
-    // Search the vector.
-    for( unsigned int row = 0; row < mInternalTable.rows.size(); ++row ){
-        if( mInternalTable.rows[ row ].label == aRow ){ // The row label matches the search label.
-            return row;
-        }
-    }
-    // The index does not exist.
-    return NO_ITEM_FOUND;
+    map<string, int>::const_iterator iter = mRowIndices.find( aRow );
+    return iter != mRowIndices.end() ? iter->second : NO_ITEM_FOUND;
 }
 
-//! Constructor for the Item.
-StorageTable::Item::Item( const string& aLabel ):
-label( aLabel ),
-value( 0 ){
+/*! \brief Get the column index for a given string which represents a column label.
+* \param aCol The column label string.
+* \return The index of the column, NO_ITEM_FOUND if it is not found.
+*/
+int StorageTable::getColIndex( const string& aCol ) const {
+    map<string, int>::const_iterator iter = mColIndices.find( aCol );
+    return iter != mColIndices.end() ? iter->second : NO_ITEM_FOUND;
+}
+
+/*! \brief Get a reference to the value at the given row and column, adding
+*          either if they do not exist yet.
+* \param aRow The row label.
+* \param aCol The column label.
+* \param aRowIndex Set to the index of the row.
+* \return A reference to the value.
+*/
+double& StorageTable::getItem( const string& aRow, const string& aCol, int& aRowIndex ) {
+    // If the row does not exist insert one on the end.
+    map<string, int>::iterator rowIter = mRowIndices.find( aRow );
+    if( rowIter == mRowIndices.end() ){
+        rowIter = mRowIndices.insert( make_pair( aRow, static_cast<int>( mRows.size() ) ) ).first;
+        mRows.push_back( Row( aRow ) );
+    }
+    aRowIndex = rowIter->second;
+
+    // If the column does not exist give it the next index.
+    map<string, int>::iterator colIter = mColIndices.find( aCol );
+    if( colIter == mColIndices.end() ){
+        colIter = mColIndices.insert( make_pair( aCol, static_cast<int>( mColIndices.size() ) ) ).first;
+    }
+
+    vector<double>& data = mRows[ aRowIndex ].data;
+    if( colIter->second >= static_cast<int>( data.size() ) ){
+        data.resize( colIter->second + 1, 0.0 );
+    }
+    return data[ colIter->second ];
 }
 
 //! Constructor for a Row
@@ -211,15 +200,3 @@ StorageTable::Row::Row( const string& aLabel ):
 label( aLabel ),
 total( 0 ){
 }
-
-//! Get the index of a column within a row.
-int StorageTable::Row::getColIndex( const string& aCol ) const {
-    // Search the vector.
-    for( unsigned int col = 0; col < data.size(); ++col ){
-        if( data[ col ].label == aCol ){ // The column label matches the search label.
-            return col;
-        }
-    }
-    // The index does not exist.
-    return NO_ITEM_FOUND;
-}
@@ -82,6 +82,7 @@
 #include "ccarbon_model/include/icarbon_calc.h"
 #include "ccarbon_model/include/land_carbon_densities.h"
 #include "util/base/include/atom.h"
+#include "util/base/include/tracepoints.h"
 #include "land_allocator/include/land_node.h"
 #include "technologies/include/ioutput.h"
 #include "technologies/include/base_technology.h"
@@ -109,6 +110,7 @@
 #include "land_allocator/include/land_use_history.h"
 #include "ccarbon_model/include/carbon_model_utils.h"
 #include "util/base/include/version.h"
+#include "reporting/include/output_spec.h"
 #include "consumers/include/gcam_consumer.h"
 #include "functions/include/building_node_input.h"
 #include "functions/include/building_service_input.h"
@@ -136,6 +138,7 @@
 #include <boost/math/tr1.hpp>
 
 #include "reporting/include/xml_db_outputter.h"
+#include "reporting/include/xmldb_writer_client.h"
 
 extern Scenario* scenario; // for modeltime
 
@@ -188,6 +191,20 @@ mSubsectorDepth( 0 )
 ,mJNIContainer( createContainer( false ) )
 #endif
 {
+    // Read the paths of the elements to write if only some are needed.
+    const Configuration* conf = Configuration::getInstance();
+    if( conf->shouldWriteFile( "xmldb-output-spec", false ) ) {
+        const string specFile = conf->getFile( "xmldb-output-spec" );
+        mOutputSpec.reset( new OutputSpec() );
+        if( !mOutputSpec->readFile( specFile ) ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not read the XML database output specification " << specFile
+                    << ", writing all results." << endl;
+            mOutputSpec.reset( 0 );
+        }
+    }
+
 #if( DEBUG_XML_DB )
     // Have data written to mBuffer go to the debug_db file as well.
     file_sink debugDBSink( "debug_db.xml" );
@@ -196,13 +213,37 @@ mSubsectorDepth( 0 )
     mBuffer.push( teeDebugFilter );
 #endif
 
+    // Send the data to a separate writer process if one is configured.
+    if( useWriterProcess() && conf->shouldWriteFile( "xmldb-location" ) ) {
+        mWriterClient.reset( new XMLDBWriterClient() );
+        if( !mWriterClient->connect( conf->getString( "xmldb-writer-host", "localhost", false ),
+                                     conf->getInt( "xmldb-writer-port", 0, false ),
+                                     getDBLocation(), createContainerName( scenario->getName() ) ) )
+        {
+            // An error message will have been printed by connect.
+            mWriterClient.reset( 0 );
+        }
+    }
+
+    if( mWriterClient.get() ) {
+        XMLDBWriterClient::Sink sendToWriterSink( mWriterClient.get() );
+        mBuffer.push( sendToWriterSink );
+    }
+    else {
 #if( __HAVE_JAVA__ )
-    // Set Java as the sink of data for mBuffer.
-    SendToJavaIOSink sendToJavaSink( mJNIContainer.get() );
-    mBuffer.push( sendToJavaSink );
+        // Optionally hand the data to a background thread to send to Java so that
+        // the model can move on while the database is written.
+        if( mJNIContainer.get() && Configuration::getInstance()->getBool( "xmldb-async-write", false, false ) ) {
+            mAsyncWriter.reset( new AsyncJavaWriter( mJNIContainer.get() ) );
+        }
+
+        // Set Java as the sink of data for mBuffer.
+        SendToJavaIOSink sendToJavaSink( mJNIContainer.get(), mAsyncWriter.get() );
+        mBuffer.push( sendToJavaSink );
 #else
-    mBuffer.push( null_sink() );
+        mBuffer.push( null_sink() );
 #endif
+    }
 }
 
 /*!
@@ -225,6 +266,10 @@ XMLDBOutputter::~XMLDBOutputter(){
  * \return True if it appears writing to the datbase would have been successful.
  */
 bool XMLDBOutputter::checkJavaWorking() {
+    // Java is not needed in the model process if a writer process is used.
+    if( useWriterProcess() ) {
+        return true;
+    }
 #if( __HAVE_JAVA__ )
     auto_ptr<JNIContainer> testContainer = createContainer( true );
     // if we get back a null container then some error occured
@@ -246,12 +291,29 @@ void XMLDBOutputter::finish() const {
     // Close mBuffer so that no more data can be written.
     close( mBuffer, ios_base::out );
 
+    if( mWriterClient.get() ) {
+        // The writer process waits until the database is done processing all
+        // data before replying.
+        if( !mWriterClient->finish() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::SEVERE );
+            mainLog << "The XML database writer failed to store the results." << endl;
+        }
+        return;
+    }
+
 #if( __HAVE_JAVA__ )
     if( !mJNIContainer.get() ) {
         // Failed to start Java, just return as an appropriate error message would
         // have already been given.
         return;
     }
+    if( mAsyncWriter.get() ) {
+        // The writer thread will call finish once it has sent all of the data,
+        // and finalizeAndClose waits for that.
+        mAsyncWriter->finish();
+        return;
+    }
     // First we need to look up the appropriate "finish" Java method with no
     // arguments and void return: "()V" then call it.
     jmethodID finishMID = mJNIContainer->mJavaEnv->GetMethodID( mJNIContainer->mWriteDBClass, "finish", "()V" );
@@ -275,7 +337,17 @@ void XMLDBOutputter::finish() const {
  *          It may potentially run queries if configured then close the database.
  */
 void XMLDBOutputter::finalizeAndClose() {
+    if( mWriterClient.get() ) {
+        mWriterClient->finalizeAndClose();
+        return;
+    }
+
 #if( __HAVE_JAVA__ )
+    // Ensure the data has all been written if it was sent in the background.
+    if( mAsyncWriter.get() ) {
+        mAsyncWriter->wait();
+    }
+
     // Call finalizeAndClose on the XMLDBDriver if it was successfully opened in the first place.
     if( mJNIContainer.get() ) {
         // First we need to look up the appropriate "finalizeAndClose" Java method with no
@@ -310,9 +382,10 @@ auto_ptr<XMLDBOutputter::JNIContainer> XMLDBOutputter::createContainer( const bo
     // Create a Java instance.
     auto_ptr<JNIContainer> jniContainer( new JNIContainer );
 
-    // Ensure the user wants this output
+    // Ensure the user wants this output, and that it is not being sent to a
+    // separate writer process instead.
     const Configuration* conf = Configuration::getInstance();
-    if( !conf->shouldWriteFile( "xmldb-location" ) ) {
+    if( !conf->shouldWriteFile( "xmldb-location" ) || useWriterProcess() ) {
         jniContainer.reset( 0 );
         return jniContainer;
     }
@@ -385,13 +458,7 @@ auto_ptr<XMLDBOutputter::JNIContainer> XMLDBOutputter::createContainer( const bo
     }
 
     // Get the location to open the environment.
-    string xmldbContainerName = conf->getFile( "xmldb-location", "database_basexdb" );
-    if( conf->shouldAppendScnToFile( "xmldb-location") ) {
-        // note that util::appendScenarioToFileName searches for a '.' between which to insert
-        // the scenario name however a '.' is not a valid character in a BaseX DB name so we
-        // will just append it to the end.
-        xmldbContainerName = xmldbContainerName.append( scenario->getName() );
-    }
+    const string xmldbContainerName = getDBLocation();
     const string docName = createContainerName( scenario->getName() );
 
     // Convert the C++ string to a Java String so that they can be passed to the constructor.
@@ -413,6 +480,33 @@ auto_ptr<XMLDBOutputter::JNIContainer> XMLDBOutputter::createContainer( const bo
 }
 #endif
 
+/*!
+ * \brief Whether the output is sent to a separate writer process.
+ * \details A writer process, which may be shared by several model processes,
+ *          is used if xmldb-writer-port is set.  The model process then does
+ *          not need to start Java.
+ * \return True if the output is sent to a writer process.
+ */
+bool XMLDBOutputter::useWriterProcess() {
+    return Configuration::getInstance()->getInt( "xmldb-writer-port", 0, false ) > 0;
+}
+
+/*!
+ * \brief Get the location of the database to write to.
+ * \return The xmldb-location, with the scenario name appended if configured.
+ */
+string XMLDBOutputter::getDBLocation() {
+    const Configuration* conf = Configuration::getInstance();
+    string xmldbContainerName = conf->getFile( "xmldb-location", "database_basexdb" );
+    if( conf->shouldAppendScnToFile( "xmldb-location") ) {
+        // note that util::appendScenarioToFileName searches for a '.' between which to insert
+        // the scenario name however a '.' is not a valid character in a BaseX DB name so we
+        // will just append it to the end.
+        xmldbContainerName = xmldbContainerName.append( scenario->getName() );
+    }
+    return xmldbContainerName;
+}
+
 /*! \brief Create a unique name for the container given a scenario name.
 * \param aScenarioName Name of the scenario.
 * \return A unique container name.
@@ -433,6 +527,7 @@ const string XMLDBOutputter::createContainerName( const string& aScenarioName ){
 * \return Whether the data was added successfully.
 */
 bool XMLDBOutputter::appendData( const string& aData, const string& aLocation ) {
+    GCAM_TRACE_SCOPE( xmldb_append, aData.size(), aLocation.size() );
     // Check that both data and a location have been set.
     if( aData.empty() || aLocation.empty() ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -448,6 +543,10 @@ bool XMLDBOutputter::appendData( const string& aData, const string& aLocation )
         return false;
     }
 
+    if( mWriterClient.get() ) {
+        return mWriterClient->appendData( aData, aLocation );
+    }
+
 #if( __HAVE_JAVA__ )
     // Check if creating the container failed.
     if( !mJNIContainer.get() ){
@@ -455,6 +554,11 @@ bool XMLDBOutputter::appendData( const string& aData, const string& aLocation )
         return false;
     }
 
+    // The document must be completely written before it can be appended to.
+    if( mAsyncWriter.get() ) {
+        mAsyncWriter->wait();
+    }
+
     // Find the appendData method for the class which takes two string arguments:
     // "(Ljava/lang/String;Ljava/lang/String;)Z".  The arguments are the data, and
     // an XPath which gives the location after which to insert the data.  It will
@@ -522,6 +626,9 @@ void XMLDBOutputter::endVisitRegion( const Region* aRegion,
 }
 
 void XMLDBOutputter::startVisitRegionMiniCAM( const RegionMiniCAM* aRegionMiniCAM, const int aPeriod ) {
+    // Regions are always written even if nothing in them is selected.
+    startElement( Region::getXMLNameStatic(), aRegionMiniCAM->getName() );
+
     // Store the region's GDP object.
     assert( !mGDP );
     mGDP = aRegionMiniCAM->mGDP;
@@ -541,9 +648,13 @@ void XMLDBOutputter::endVisitRegionMiniCAM( const RegionMiniCAM* aRegionMiniCAM,
 
     // Write the closing region tag.
     XMLWriteClosingTag( aRegionMiniCAM->getXMLName(), mBuffer, mTabs.get() );
+    endElement();
 }
 
 void XMLDBOutputter::startVisitRegionCGE( const RegionCGE* aRegionCGE, const int aPeriod ) {
+    // Regions are always written even if nothing in them is selected.
+    startElement( Region::getXMLNameStatic(), aRegionCGE->getName() );
+
        // Write the opening region tag and the type of the base class.
     XMLWriteOpeningTag( aRegionCGE->getXMLName(), mBuffer, mTabs.get(),
         aRegionCGE->getName(), 0, Region::getXMLNameStatic() );
@@ -556,11 +667,16 @@ void XMLDBOutputter::endVisitRegionCGE( const RegionCGE* aRegionCGE, const int a
 
     // Write the closing region tag.
     XMLWriteClosingTag( aRegionCGE->getXMLName(), mBuffer, mTabs.get() );
+    endElement();
 }
 
 void XMLDBOutputter::startVisitResource( const AResource* aResource,
                                          const int aPeriod )
 {
+    if( !startElement( "resource", aResource->getName() ) ) {
+        return;
+    }
+
     // Write the opening resource tag and the type of the base class.
     XMLWriteOpeningTag( aResource->getXMLName(), mBuffer, mTabs.get(),
         aResource->getName(), 0, "resource" );
@@ -586,6 +702,10 @@ void XMLDBOutputter::startVisitResource( const AResource* aResource,
 void XMLDBOutputter::endVisitResource( const AResource* aResource,
                                        const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing resource tag.
     XMLWriteClosingTag( aResource->getXMLName(), mBuffer, mTabs.get() );
     // Clear the current resource.
@@ -596,6 +716,10 @@ void XMLDBOutputter::endVisitResource( const AResource* aResource,
 void XMLDBOutputter::startVisitSubResource( const SubResource* aSubResource,
                                             const int aPeriod )
 {
+    if( !startElement( "subresource", aSubResource->getName() ) ) {
+        return;
+    }
+
     // Write the opening subresource tag and the type of the base class.
     XMLWriteOpeningTag( aSubResource->getXMLName(), mBuffer, mTabs.get(),
         aSubResource->getName(), 0, "subresource" );
@@ -611,6 +735,10 @@ void XMLDBOutputter::startVisitSubResource( const SubResource* aSubResource,
 void XMLDBOutputter::endVisitSubResource( const SubResource* aSubResource,
                                           const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing subresource tag.
     XMLWriteClosingTag( aSubResource->getXMLName(), mBuffer, mTabs.get() );
 }
@@ -628,6 +756,10 @@ void XMLDBOutputter::endVisitReserveSubResource( const ReserveSubResource* aSubR
 void XMLDBOutputter::startVisitSubRenewableResource( const SubRenewableResource* aSubResource,
                                                      const int aPeriod )
 {
+    if( !startElement( "subresource", aSubResource->getName() ) ) {
+        return;
+    }
+
     // Write the opening subresource tag and the type of the base class.
     XMLWriteOpeningTag( aSubResource->getXMLNameStatic(), mBuffer, mTabs.get(),
                        aSubResource->getName(), 0, "subresource" );
@@ -644,6 +776,10 @@ void XMLDBOutputter::startVisitSubRenewableResource( const SubRenewableResource*
 void XMLDBOutputter::endVisitSubRenewableResource( const SubRenewableResource* aSubResource,
                                                         const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing subresource tag.
     XMLWriteClosingTag( aSubResource->getXMLNameStatic(), mBuffer, mTabs.get() );
 }
@@ -677,6 +813,10 @@ void XMLDBOutputter::endVisitGrade( const Grade* aGrade, const int aPeriod ){
 }
 
 void XMLDBOutputter::startVisitSector( const Sector* aSector, const int aPeriod ){
+    if( !startElement( "sector", aSector->getName() ) ) {
+        return;
+    }
+
     // Store the sector name and units.
     mCurrentSector = aSector->getName();
     mCurrentPriceUnit = aSector->mPriceUnit;
@@ -704,6 +844,10 @@ void XMLDBOutputter::startVisitSector( const Sector* aSector, const int aPeriod
 }
 
 void XMLDBOutputter::endVisitSector( const Sector* aSector, const int aPeriod ){
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing sector tag.
     XMLWriteClosingTag( aSector->getXMLName(), mBuffer, mTabs.get() );
 
@@ -717,6 +861,10 @@ void XMLDBOutputter::endVisitSector( const Sector* aSector, const int aPeriod ){
 void XMLDBOutputter::startVisitSubsector( const Subsector* aSubsector,
                                           const int aPeriod )
 {
+    if( !startElement( "subsector", aSubsector->getName() ) ) {
+        return;
+    }
+
     // Write the opening subsector tag and the type of the base class.
     map<string, string> attrs;
     attrs["name"] = aSubsector->getName();
@@ -747,6 +895,10 @@ void XMLDBOutputter::startVisitSubsector( const Subsector* aSubsector,
 void XMLDBOutputter::endVisitSubsector( const Subsector* aSubsector,
                                         const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     --mSubsectorDepth;
     // Write the closing subsector tag.
     XMLWriteClosingTag( aSubsector->getXMLName(), mBuffer, mTabs.get() );
@@ -764,6 +916,11 @@ void XMLDBOutputter::endVisitNestingSubsector( const NestingSubsector* aSubsecto
 }
 
 void XMLDBOutputter::startVisitTranSubsector( const TranSubsector* aTranSubsector, const int aPeriod ) {
+    // The subsector may have been skipped by startVisitSubsector.
+    if( !shouldVisitChildren() ) {
+        return;
+    }
+
     const Modeltime* modeltime = scenario->getModeltime();
     for( int i = 0; i < modeltime->getmaxper(); ++i ){
         double currValue = aTranSubsector->mSpeed[ i ];
@@ -823,6 +980,10 @@ void XMLDBOutputter::endVisitBaseTechnology( const BaseTechnology* aBaseTech, co
  * \param aPeriod 
  */
 void XMLDBOutputter::startVisitTechnology( const Technology* aTechnology, const int aPeriod ){
+    if( !startElement( "technology", aTechnology->getName() ) ) {
+        return;
+    }
+
     // Store the pointer to the current technology so that children of technology can access 
     // information on current technology.
     mCurrentTechnology = aTechnology;
@@ -869,6 +1030,10 @@ void XMLDBOutputter::startVisitTechnology( const Technology* aTechnology, const
 void XMLDBOutputter::endVisitTechnology( const Technology* aTechnology,
                                          const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     // Clear the stored technology information.
     mCurrentTechnology = 0; // reset technology pointer to null
     fill( mCurrIndirectEmissions.begin(), mCurrIndirectEmissions.end(), 0.0 );
@@ -1211,6 +1376,10 @@ void XMLDBOutputter::endVisitGHG( const AGHG* aGHG, const int aPeriod ){
 void XMLDBOutputter::startVisitMarketplace( const Marketplace* aMarketplace,
                                             const int aPeriod )
 {
+    if( !startElement( "marketplace", "" ) ) {
+        return;
+    }
+
     // Write the opening marketplace tag.
     XMLWriteOpeningTag( Marketplace::getXMLNameStatic(), mBuffer, mTabs.get() );
 }
@@ -1218,6 +1387,10 @@ void XMLDBOutputter::startVisitMarketplace( const Marketplace* aMarketplace,
 void XMLDBOutputter::endVisitMarketplace( const Marketplace* aMarketplace,
                                           const int aPeriod )
 {
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing marketplace tag.
     XMLWriteClosingTag( Marketplace::getXMLNameStatic(), mBuffer, mTabs.get() );
     mCurrentMarket.clear();
@@ -1229,6 +1402,10 @@ void XMLDBOutputter::endVisitMarketplace( const Marketplace* aMarketplace,
 void XMLDBOutputter::startVisitMarket( const Market* aMarket,
                                        const int aPeriod )
 {
+    if( !startElement( "market", aMarket->getName() ) ) {
+        return;
+    }
+
     // Write the opening market tag.
     XMLWriteOpeningTag( Market::getXMLNameStatic(), mBuffer, mTabs.get(),
                         aMarket->getName(), aMarket->getYear() );
@@ -1265,6 +1442,10 @@ void XMLDBOutputter::startVisitMarket( const Market* aMarket,
 }
 
 void XMLDBOutputter::endVisitMarket( const Market* aMarket, const int aPeriod ){
+    if( !endElement() ) {
+        return;
+    }
+
     // Write the closing market tag.
     XMLWriteClosingTag( Market::getXMLNameStatic(), mBuffer, mTabs.get() );
 }
@@ -2025,6 +2206,40 @@ void XMLDBOutputter::endVisitBuildingServiceInput( const BuildingServiceInput* a
     endVisitInput( aBuildingServiceInput, aPeriod );
 }
 
+/*!
+ * \brief Write a single item with a unit and optional year attribute.
+ * \details This writes the same output as XMLWriteElementWithAttributes with
+ *          a unit and year attribute map but avoids building the map and
+ *          converting the year to a string for each of the very many items
+ *          written to the database.
+ * \param aValue Value to write.
+ * \param aName Element name.
+ * \param aOut Stream to write to.
+ * \param aTabs Tabs object.
+ * \param aUnit Unit of the item.
+ * \param aWriteYear Whether to write the year attribute.
+ * \param aYear Year of the value.
+ */
+static void writeUnitYearElement( const double aValue,
+                                  const string& aName,
+                                  ostream& aOut,
+                                  const Tabs* aTabs,
+                                  const string& aUnit,
+                                  const bool aWriteYear,
+                                  const int aYear )
+{
+    aTabs->writeTabs( aOut );
+    aOut << '<' << aName << " unit=\"" << aUnit << '"';
+    if( aWriteYear ){
+        aOut << " year=\"";
+        XMLWriteValue( aYear, aOut );
+        aOut << '"';
+    }
+    aOut << '>';
+    XMLWriteValue( aValue, aOut );
+    aOut << "</" << aName << ">\n";
+}
+
 /*!
  * \brief Write a single item to the string stream buffer.
  * \details Helper function which writes a single value, with an element
@@ -2041,19 +2256,15 @@ void XMLDBOutputter::writeItemToBuffer( const double aValue,
                                         const int aPeriod,
                                         const string& aUnit )
 {
-    map<string, string> attributeMap;
-    attributeMap[ "unit" ] = aUnit;
     int year = 0;
     
     // Do not write out year if aPeriod = -1.
     if( aPeriod != -1 ){
         const Modeltime* modeltime = scenario->getModeltime();
         year = modeltime->getper_to_yr( aPeriod );
-        attributeMap[ "year" ] = util::toString( year );
     }
 
-    XMLWriteElementWithAttributes( aValue, aName, out, tabs,
-                                   attributeMap );
+    writeUnitYearElement( aValue, aName, out, tabs, aUnit, aPeriod != -1, year );
 }
 
 /*!
@@ -2092,14 +2303,7 @@ void XMLDBOutputter::writeItemUsingYear( const string& aName,
                                          const double aValue,
                                          const int aYear )
 {
-    map<string, string> attributeMap;
-    attributeMap[ "unit" ] = aUnit;
-
-    if( aYear != 0 ){
-        attributeMap[ "year" ] = util::toString( aYear );
-    }
-    XMLWriteElementWithAttributes( aValue, aName, mBuffer, mTabs.get(),
-                                   attributeMap );
+    writeUnitYearElement( aValue, aName, mBuffer, mTabs.get(), aUnit, aYear != 0, aYear );
 }
 
 /**
@@ -2111,6 +2315,38 @@ bool XMLDBOutputter::isTechnologyOperating( const int aPeriod ){
     return mCurrentTechnology->isOperating( aPeriod );
 }
 
+/*!
+ * \brief Whether the children of the element just started need to be visited.
+ * \return False if the element was not selected by the output specification.
+ */
+bool XMLDBOutputter::shouldVisitChildren() const {
+    return !mOutputSpec.get() || mOutputSpec->isSelected();
+}
+
+/*!
+ * \brief Start an element which may be skipped by the output specification.
+ * \details Every call must be matched with a call to endElement.
+ * \param aType The type of the element.
+ * \param aName The name of the element.
+ * \return Whether the element should be written.
+ */
+bool XMLDBOutputter::startElement( const string& aType, const string& aName ) {
+    return !mOutputSpec.get() || mOutputSpec->enter( aType, aName );
+}
+
+/*!
+ * \brief Finish an element started with startElement.
+ * \return Whether the element was written.
+ */
+bool XMLDBOutputter::endElement() {
+    if( !mOutputSpec.get() ) {
+        return true;
+    }
+    const bool wasSelected = mOutputSpec->isSelected();
+    mOutputSpec->leave();
+    return wasSelected;
+}
+
 /**
  * \brief Pops the buffer off of the top of the stack and returns it.
  * \details A convience method so that the pop can be in one line instead of two.
@@ -2174,8 +2410,10 @@ map<string, string> XMLDBOutputter::decomposeLandName( string aLandName ) {
  * \param aJNIContainer A weak pointer to the container which holds the Java VM
  *                      references.  May be null if it did not initialize properly.
  */
-XMLDBOutputter::SendToJavaIOSink::SendToJavaIOSink( const JNIContainer* aJNIContainer )
+XMLDBOutputter::SendToJavaIOSink::SendToJavaIOSink( const JNIContainer* aJNIContainer,
+                                                    AsyncJavaWriter* aAsyncWriter )
 :mJNIContainer( aJNIContainer ),
+mAsyncWriter( aAsyncWriter ),
 // Get the receiveDataFromGCAM method from the write DB class with arguments of a byte
 // array "[B", an integer "I", and a return type of bool "Z" 
 mReceiveDataMID( aJNIContainer ? aJNIContainer->mJavaEnv->GetMethodID( aJNIContainer->mWriteDBClass, "receiveDataFromGCAM", "([BI)Z") : 0 ),
@@ -2204,6 +2442,10 @@ XMLDBOutputter::SendToJavaIOSink::~SendToJavaIOSink() {
  *          will be set and no more data will be sent.
  */
 streamsize XMLDBOutputter::SendToJavaIOSink::write( const char *aData, std::streamsize aLength ) {
+    if( mAsyncWriter ) {
+        mAsyncWriter->write( aData, aLength );
+        return aLength;
+    }
     streamsize offset = 0;
     const jbyte* jniData = reinterpret_cast<const jbyte*>( aData );
     while( !mErrorFlag && offset < aLength ) {
@@ -2215,4 +2457,138 @@ streamsize XMLDBOutputter::SendToJavaIOSink::write( const char *aData, std::stre
     }
     return offset;
 }
+
+/*!
+ * \brief Constructor which starts the writer thread.
+ * \param aJNIContainer The JNIContainer with the Java objects to write to.
+ */
+XMLDBOutputter::AsyncJavaWriter::AsyncJavaWriter( const JNIContainer* aJNIContainer ):
+mJNIContainer( aJNIContainer ),
+mIsFinished( false )
+{
+    mThread = thread( &AsyncJavaWriter::run, this );
+}
+
+/*!
+ * \brief Destructor which waits for all of the data to be written.
+ */
+XMLDBOutputter::AsyncJavaWriter::~AsyncJavaWriter() {
+    finish();
+    wait();
+}
+
+/*!
+ * \brief Add data to be sent to Java.
+ * \details The data is collected into chunks of the same size as the Java
+ *          receive buffer which are then queued for the writer thread.  If too
+ *          many chunks are already waiting this waits for the writer thread to
+ *          catch up.
+ * \param aData The data to send.
+ * \param aLength The number of chars to send.
+ */
+void XMLDBOutputter::AsyncJavaWriter::write( const char* aData, streamsize aLength ) {
+    mCurrentChunk.append( aData, aLength );
+    if( mCurrentChunk.size() >= CHUNK_SIZE ) {
+        queueChunk();
+    }
+}
+
+/*!
+ * \brief Signal that all of the data has been written.
+ * \details The writer thread will send any remaining data and then call the
+ *          Java finish method.  This returns without waiting for it.
+ */
+void XMLDBOutputter::AsyncJavaWriter::finish() {
+    if( !mCurrentChunk.empty() ) {
+        queueChunk();
+    }
+    {
+        lock_guard<mutex> lock( mMutex );
+        mIsFinished = true;
+    }
+    mHasChunks.notify_one();
+}
+
+/*!
+ * \brief Wait for the writer thread to send all of the data and for the
+ *        database to process it.
+ * \pre finish has been called.
+ */
+void XMLDBOutputter::AsyncJavaWriter::wait() {
+    if( mThread.joinable() ) {
+        mThread.join();
+    }
+}
+
+//! Queue the current chunk, waiting for space on the queue if necessary.
+void XMLDBOutputter::AsyncJavaWriter::queueChunk() {
+    {
+        unique_lock<mutex> lock( mMutex );
+        mHasSpace.wait( lock, [this] { return mPendingChunks.size() < MAX_PENDING_CHUNKS; } );
+        mPendingChunks.push_back( string() );
+        mPendingChunks.back().swap( mCurrentChunk );
+    }
+    mHasChunks.notify_one();
+    mCurrentChunk.reserve( CHUNK_SIZE );
+}
+
+/*!
+ * \brief The writer thread which sends the queued chunks to Java and then
+ *        calls the Java finish method.
+ * \details JNI environments can not be shared between threads so this
+ *          thread attaches itself to the Java VM for its own environment.  The
+ *          class and instance references in the JNIContainer are global
+ *          references and so may be used from any thread.  If an error occurs
+ *          the rest of the data is discarded, as with SendToJavaIOSink.
+ */
+void XMLDBOutputter::AsyncJavaWriter::run() {
+    JNIEnv* javaEnv = 0;
+    JNIContainer::mJavaVM->AttachCurrentThread( (void**)&javaEnv, 0 );
+    jmethodID receiveDataMID = javaEnv ? javaEnv->GetMethodID( mJNIContainer->mWriteDBClass,
+        "receiveDataFromGCAM", "([BI)Z" ) : 0;
+    jbyteArray jniBuffer = receiveDataMID ? javaEnv->NewByteArray( CHUNK_SIZE ) : 0;
+    bool errorFlag = !jniBuffer;
+
+    string chunk;
+    while( true ) {
+        {
+            unique_lock<mutex> lock( mMutex );
+            mHasChunks.wait( lock, [this] { return !mPendingChunks.empty() || mIsFinished; } );
+            if( mPendingChunks.empty() ) {
+                break;
+            }
+            chunk.swap( mPendingChunks.front() );
+            mPendingChunks.pop_front();
+        }
+        mHasSpace.notify_one();
+
+        const jbyte* jniData = reinterpret_cast<const jbyte*>( chunk.data() );
+        const streamsize length = chunk.size();
+        for( streamsize offset = 0; !errorFlag && offset < length; offset += CHUNK_SIZE ) {
+            const streamsize numRead = min( length - offset, static_cast<streamsize>( CHUNK_SIZE ) );
+            javaEnv->SetByteArrayRegion( jniBuffer, 0, numRead, jniData + offset );
+            errorFlag = javaEnv->CallBooleanMethod( mJNIContainer->mWriteDBInstance,
+                receiveDataMID, jniBuffer, numRead );
+        }
+        chunk.clear();
+    }
+
+    if( javaEnv ) {
+        // The java method will wait until the database is done processing all
+        // data before returning.
+        jmethodID finishMID = javaEnv->GetMethodID( mJNIContainer->mWriteDBClass, "finish", "()V" );
+        if( finishMID ) {
+            javaEnv->CallVoidMethod( mJNIContainer->mWriteDBInstance, finishMID );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::SEVERE );
+            mainLog << "Failed to find JNI method: finish" << endl;
+        }
+        if( jniBuffer ) {
+            javaEnv->DeleteLocalRef( jniBuffer );
+        }
+        JNIContainer::mJavaVM->DetachCurrentThread();
+    }
+}
 #endif
@@ -0,0 +1,291 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+
+/*! 
+ * \file xmldb_writer_client.cpp
+ * \ingroup Objects
+ * \brief XMLDBWriterClient class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include <cstring>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+#include "reporting/include/xmldb_writer_client.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+#if defined(MSG_NOSIGNAL)
+// Report a closed connection as an error rather than raising SIGPIPE.
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+//! Constructor which does not connect to a writer.
+XMLDBWriterClient::XMLDBWriterClient():
+mSocket( -1 )
+{
+}
+
+//! Destructor which closes the connection if it is still open.
+XMLDBWriterClient::~XMLDBWriterClient() {
+    close();
+}
+
+/*!
+ * \brief Connect to a writer process and open the document to write.
+ * \param aHost The host the writer is running on.
+ * \param aPort The port the writer is listening on.
+ * \param aDBLocation The location of the database to write to.
+ * \param aDocName A unique document name to store the output in.
+ * \return Whether the writer was reached and opened the document.
+ */
+bool XMLDBWriterClient::connect( const string& aHost, const int aPort,
+                                 const string& aDBLocation, const string& aDocName )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if !defined(_WIN32)
+    addrinfo hints;
+    memset( &hints, 0, sizeof( hints ) );
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = 0;
+    if( getaddrinfo( aHost.c_str(), util::toString( aPort ).c_str(), &hints, &addresses ) != 0 ) {
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Could not resolve the XML database writer host " << aHost << "." << endl;
+        return false;
+    }
+    for( addrinfo* curr = addresses; curr && mSocket == -1; curr = curr->ai_next ) {
+        mSocket = socket( curr->ai_family, curr->ai_socktype, curr->ai_protocol );
+        if( mSocket != -1 && ::connect( mSocket, curr->ai_addr, curr->ai_addrlen ) != 0 ) {
+            ::close( mSocket );
+            mSocket = -1;
+        }
+    }
+    freeaddrinfo( addresses );
+#endif
+    if( mSocket == -1 ) {
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Could not connect to the XML database writer at " << aHost << ":" << aPort << "." << endl;
+        return false;
+    }
+
+    if( !sendMessage( 'O', aDBLocation, aDocName ) || !receiveStatus() ) {
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "The XML database writer could not open " << aDBLocation << "." << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Whether there is an open connection to the writer.
+ * \details The connection is closed if any error occurs.
+ * \return True if the writer is connected.
+ */
+bool XMLDBWriterClient::isConnected() const {
+    return mSocket != -1;
+}
+
+/*!
+ * \brief Add data to the document.
+ * \details The data is sent once a full chunk has been collected.  Data is
+ *          ignored once the connection has been closed by an error.
+ * \param aData The data to add.
+ * \param aLength The number of chars of aData to add.
+ */
+void XMLDBWriterClient::write( const char* aData, const streamsize aLength ) {
+    streamsize offset = 0;
+    while( isConnected() && offset < aLength ) {
+        const size_t numToCopy = min( static_cast<size_t>( aLength - offset ),
+                                      CHUNK_SIZE - mCurrentChunk.size() );
+        mCurrentChunk.append( aData + offset, numToCopy );
+        offset += numToCopy;
+        if( mCurrentChunk.size() == CHUNK_SIZE ) {
+            sendChunk();
+        }
+    }
+}
+
+/*!
+ * \brief Append data after the given location in the finished document.
+ * \param aData The XML data to insert.
+ * \param aLocation An XPath that describes where to insert the data after.
+ * \return Whether the data was appended.
+ */
+bool XMLDBWriterClient::appendData( const string& aData, const string& aLocation ) {
+    return isConnected() && sendMessage( 'A', aLocation, aData ) && receiveStatus();
+}
+
+/*!
+ * \brief Send any remaining data and wait for the writer to store the document.
+ * \return Whether the document was stored.
+ */
+bool XMLDBWriterClient::finish() {
+    return sendChunk() && sendMessage( 'F', 0, 0 ) && receiveStatus();
+}
+
+/*!
+ * \brief Have the writer run any final processing and close the database.
+ * \details The connection is closed afterwards.
+ * \return Whether the database was closed successfully.
+ */
+bool XMLDBWriterClient::finalizeAndClose() {
+    const bool success = isConnected() && sendMessage( 'C', 0, 0 ) && receiveStatus();
+    close();
+    return success;
+}
+
+/*!
+ * \brief Send a message to the writer.
+ * \details The connection is closed if the message could not be sent.
+ * \param aType The type of the message.
+ * \param aData The payload.
+ * \param aLength The length of the payload.
+ * \return Whether the message was sent.
+ */
+bool XMLDBWriterClient::sendMessage( const char aType, const char* aData, const size_t aLength ) {
+#if !defined(_WIN32)
+    unsigned char header[ 5 ];
+    header[ 0 ] = static_cast<unsigned char>( aType );
+    header[ 1 ] = static_cast<unsigned char>( ( aLength >> 24 ) & 0xFF );
+    header[ 2 ] = static_cast<unsigned char>( ( aLength >> 16 ) & 0xFF );
+    header[ 3 ] = static_cast<unsigned char>( ( aLength >> 8 ) & 0xFF );
+    header[ 4 ] = static_cast<unsigned char>( aLength & 0xFF );
+
+    const char* buffers[] = { reinterpret_cast<const char*>( header ), aData };
+    const size_t lengths[] = { sizeof( header ), aLength };
+    for( int i = 0; i < 2 && isConnected(); ++i ) {
+        size_t offset = 0;
+        while( offset < lengths[ i ] ) {
+            const ssize_t numSent = send( mSocket, buffers[ i ] + offset, lengths[ i ] - offset, SEND_FLAGS );
+            if( numSent <= 0 ) {
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::SEVERE );
+                mainLog << "Lost the connection to the XML database writer." << endl;
+                close();
+                return false;
+            }
+            offset += numSent;
+        }
+    }
+#endif
+    return isConnected();
+}
+
+/*!
+ * \brief Send a message with a payload of two strings separated by a null
+ *        character.
+ * \param aType The type of the message.
+ * \param aFirst The first string.
+ * \param aSecond The second string.
+ * \return Whether the message was sent.
+ */
+bool XMLDBWriterClient::sendMessage( const char aType, const string& aFirst, const string& aSecond ) {
+    string payload = aFirst;
+    payload.push_back( '\0' );
+    payload.append( aSecond );
+    return sendMessage( aType, payload.data(), payload.size() );
+}
+
+/*!
+ * \brief Wait for the status reply from the writer.
+ * \return True if the writer replied that the last message succeeded.
+ */
+bool XMLDBWriterClient::receiveStatus() {
+    char status = 0;
+#if !defined(_WIN32)
+    if( isConnected() && recv( mSocket, &status, 1, 0 ) != 1 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Lost the connection to the XML database writer." << endl;
+        close();
+    }
+#endif
+    return status == 1;
+}
+
+/*!
+ * \brief Send the data collected so far as a chunk of the document.
+ * \return Whether the data was sent.
+ */
+bool XMLDBWriterClient::sendChunk() {
+    bool success = mCurrentChunk.empty() ? isConnected() :
+        sendMessage( 'D', mCurrentChunk.data(), mCurrentChunk.size() );
+    mCurrentChunk.clear();
+    return success;
+}
+
+//! Close the connection to the writer.
+void XMLDBWriterClient::close() {
+#if !defined(_WIN32)
+    if( mSocket != -1 ) {
+        ::close( mSocket );
+    }
+#endif
+    mSocket = -1;
+}
+
+/*!
+ * \brief Constructor.
+ * \param aClient The client to send the data to.
+ */
+XMLDBWriterClient::Sink::Sink( XMLDBWriterClient* aClient ):
+mClient( aClient )
+{
+}
+
+/*!
+ * \brief Pass the data on to the client.
+ * \param aData The data which was written.
+ * \param aLength How many chars of aData were written.
+ * \return The number of chars consumed which is always aLength.
+ */
+streamsize XMLDBWriterClient::Sink::write( const char* aData, streamsize aLength ) {
+    mClient->write( aData, aLength );
+    return aLength;
+}
@@ -67,6 +67,7 @@ class UnlimitedResource;
 */
 class AResource: public INamed, public IVisitable, private boost::noncopyable {
     friend class XMLDBOutputter;
+    friend class ColumnarOutputter;
 public:
     virtual ~AResource();
 
@@ -69,6 +69,8 @@ public:
     static const std::string& getXMLNameStatic( void );
     virtual void completeInit( const std::string& aRegionName, const std::string& aResourceName,
                                const IInfo* aSectorInfo );
+    virtual void initCalc( const std::string& aRegionName, const std::string& aResourceName,
+                           const IInfo* aResourceInfo, const int aPeriod );
     virtual void cumulsupply( const std::string& aRegionName, const std::string& aResourceName,
                               double aPrice, int aPeriod );
     virtual void annualsupply( const std::string& aRegionName, const std::string& aResourceName,
@@ -100,6 +102,18 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "subResourceCapacityFactor", mSubResourceCapacityFactor, double )
     )
 
+    //! The period for which mCachedSupplyFraction was calculated, or -1 if
+    //! it has not been calculated since the last initCalc.
+    int mCachedSupplyPeriod;
+
+    //! The effective price at which mCachedSupplyFraction was calculated.
+    double mCachedSupplyPrice;
+
+    //! The fraction available from the last supply curve evaluation.
+    double mCachedSupplyFraction;
+
+    double calcFractionAvailable( const double aEffectivePrice ) const;
+
     virtual const std::string& getXMLName() const;
     virtual bool XMLDerivedClassParse( const std::string& nodeName, const xercesc::DOMNode* node );
 };
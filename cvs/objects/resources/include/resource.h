@@ -54,6 +54,9 @@
 
 // Forward declaration.
 class SubResource;
+namespace objects {
+    class Atom;
+}
 
 /*! 
 * \ingroup Objects
@@ -113,6 +116,12 @@ protected:
     //! Vector of object meta info to pass to the market
     object_meta_info_vector_type mObjectMetaInfo;
 
+    //! The Atom of the resource name, set in completeInit for market lookups.
+    const objects::Atom* mNameAtom;
+
+    //! The Atom of the region name, set in completeInit for market lookups.
+    const objects::Atom* mRegionAtom;
+
     virtual bool XMLDerivedClassParse( const std::string& aNodeName,
                                        const xercesc::DOMNode* aNode );
     virtual const std::string& getXMLName() const;
@@ -112,6 +112,14 @@ protected :
    // TODO: is this really necessary?
    ObjECTS::TCostCurve<> mCostCurve;
 
+   //! The price scale of the price exponent term, five times the current mid
+   //! price, which is fixed for a period.
+   double mPriceExponentScale;
+
+   //! The price at which supply reaches 99% of the maximum which only depends
+   //! on the input mid price and curve exponent.
+   double mHighestPrice;
+
    // Documentation is inherited.
    virtual const std::string& getXMLName() const;
 
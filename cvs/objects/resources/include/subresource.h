@@ -45,6 +45,7 @@
 * \author Sonny Kim
 */
 #include <memory>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include <boost/core/noncopyable.hpp>
 
@@ -152,6 +153,23 @@ protected:
     
     //!< The subsector's information store.
     std::auto_ptr<IInfo> mSubresourceInfo;
+
+    //! Grade costs for the period last initialized, in grade order, so that
+    //! the supply calculations do not need to visit each Grade.
+    std::vector<double> mGradeCost;
+
+    //! Grade availability in the same order as mGradeCost.
+    std::vector<double> mGradeAvail;
+
+    //! Running sum of mGradeAvail.
+    std::vector<double> mCumulGradeAvail;
+
+    //! Whether mGradeCost is non-decreasing which allows a binary search.
+    bool mIsGradeCostSorted;
+
+    void compileGrades( const int aPeriod );
+
+    size_t findGradeAtPrice( const double aPrice ) const;
 };
 
 #endif // _SUBRESOURCE_H_
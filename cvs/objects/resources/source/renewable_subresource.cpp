@@ -63,7 +63,10 @@ extern Scenario* scenario;
 SubRenewableResource::SubRenewableResource(void):
 mMaxAnnualSubResource( 0.0 ),
 mGdpSupplyElasticity( 0 ),
-mSubResourceVariance( 0 )
+mSubResourceVariance( 0 ),
+mCachedSupplyPeriod( -1 ),
+mCachedSupplyPrice( 0 ),
+mCachedSupplyFraction( 0 )
 {
 }
 
@@ -130,6 +133,21 @@ void SubRenewableResource::completeInit( const string& aRegionName, const string
     }
 }
 
+/*! \brief Perform any initializations needed for each period.
+* \param aRegionName Region name.
+* \param aResourceName Resource name.
+* \param aResourceInfo The resource information object.
+* \param aPeriod Model period.
+*/
+void SubRenewableResource::initCalc( const string& aRegionName, const string& aResourceName,
+                                     const IInfo* aResourceInfo, const int aPeriod )
+{
+    SubResource::initCalc( aRegionName, aResourceName, aResourceInfo, aPeriod );
+
+    // The grade costs have been recompiled so the cached supply is stale.
+    mCachedSupplyPeriod = -1;
+}
+
 //! Cumulative Production
 /*! Cumulative production Is not needed for renewable resources. But still do
 *   any preliminary calculations that need to be done before calculating
@@ -144,6 +162,53 @@ void SubRenewableResource::cumulsupply( const string& aRegionName, const string&
     // subresource.
 }
 
+/*!
+ * \brief Interpolate the fraction of the maximum subresource available at a
+ *        price from the grade cost curve compiled for the current period.
+ * \param aEffectivePrice The price net of the price adder and technology cost.
+ * \return The fraction of the maximum subresource available.
+ */
+double SubRenewableResource::calcFractionAvailable( const double aEffectivePrice ) const {
+    double fractionAvailable = -1;
+
+    // Find the first point on the cost curve at or above the current price.
+    const size_t numGrades = mGradeCost.size();
+    const size_t i = findGradeAtPrice( aEffectivePrice );
+    if( i < numGrades ) {
+        if( i == 0 ) {
+            // Below the bottom of the supply curve which means the fraction
+            // available is zero.
+            fractionAvailable = 0;
+        }
+        else {
+            // Determine the cost and available for the previous
+            // point. 
+            double prevGradeCost = mGradeCost[ i - 1 ];
+            double prevGradeAvailable = mGradeAvail[ i - 1 ];
+
+            // This should not be able to happen because the above search
+            // would have stopped at the previous point.
+            assert( mGradeCost[ i ] > prevGradeCost );
+            double gradeFraction = ( aEffectivePrice - prevGradeCost )
+                / ( mGradeCost[ i ] - prevGradeCost );
+            // compute production as fraction of total possible
+            fractionAvailable = prevGradeAvailable + gradeFraction
+                * ( mGradeAvail[ i ] - prevGradeAvailable ); 
+        }
+    }
+
+    // If the fraction available has not been set there is not a point with a
+    // cost greater than the price. This means the price is above the curve.
+    if( fractionAvailable == -1 ){
+        // Calculate the total fraction of the max subresource to use. Note that
+        // the max fraction available can be more than 100 percent.
+        double maxFraction = mGradeAvail[ numGrades - 1 ];
+        fractionAvailable = maxFraction;
+    }
+
+    return fractionAvailable;
+}
+
 //! calculate annual supply 
 /*! Annual production (supply) is placed into variable (into variable annualprod[]).
 * For renewable resources interprets parameters as a cost curve.
@@ -156,45 +221,17 @@ void SubRenewableResource::annualsupply( const string& aRegionName, const string
 {
     ITechnology* currTech = mTechnology->getNewVintageTechnology( aPeriod );
     currTech->calcCost( aRegionName, aResourceName, aPeriod );
-    double fractionAvailable = -1;
     const double effectivePrice = aPrice + mPriceAdder[ aPeriod ] - currTech->getCost( aPeriod );
 
-    // Move up the cost curve until a point is found above the current price.
-    for ( unsigned int i = 0; i < mGrade.size(); ++i ) {
-        if( effectivePrice <= mGrade[ i ]->getCost( aPeriod ) ) {
-            if( i == 0 ) {
-                // Below the bottom of the supply curve which means the fraction
-                // available is zero.
-                fractionAvailable = 0;
-            }
-            else {
-                // Determine the cost and available for the previous
-                // point. 
-                double prevGradeCost = mGrade[ i - 1 ]->getCost( aPeriod );
-                double prevGradeAvailable = mGrade[ i - 1 ]->getAvail();
-
-                // This should not be able to happen because the above if
-                // statement would fail.
-                assert( mGrade[ i ]->getCost( aPeriod ) > prevGradeCost );
-                double gradeFraction = ( effectivePrice - prevGradeCost )
-                    / ( mGrade[ i ]->getCost( aPeriod ) - prevGradeCost );
-                // compute production as fraction of total possible
-                fractionAvailable = prevGradeAvailable + gradeFraction
-                    * ( mGrade[ i ]->getAvail() - prevGradeAvailable ); 
-            }
-
-            break;
-        }
-    }
-
-    // If the fraction available has not been set there is not a point with a
-    // cost greater than the price. This means the price is above the curve.
-    if( fractionAvailable == -1 ){
-        // Calculate the total fraction of the max subresource to use. Note that
-        // the max fraction available can be more than 100 percent.
-        double maxFraction = mGrade[ mGrade.size() - 1 ]->getAvail();
-        fractionAvailable = maxFraction;
+    // The supply curve is fixed for the period so re-evaluating at the price
+    // of the previous call, which is common while the solver perturbs other
+    // markets, can reuse the previous result.
+    if( aPeriod != mCachedSupplyPeriod || effectivePrice != mCachedSupplyPrice ) {
+        mCachedSupplyFraction = calcFractionAvailable( effectivePrice );
+        mCachedSupplyPrice = effectivePrice;
+        mCachedSupplyPeriod = aPeriod;
     }
+    const double fractionAvailable = mCachedSupplyFraction;
 
     // Calculate the amount of resource expansion due to GDP increase.
     double resourceSupplyIncrease = pow( aGdp->getApproxGDP( aPeriod ) / aGdp->getApproxGDP( 0 ),
@@ -258,10 +295,12 @@ void SubRenewableResource::accept( IVisitor* aVisitor, const int aPeriod ) const
     aVisitor->startVisitSubRenewableResource( this, aPeriod );
     
     // Update the output container for the subresources.
-    for( unsigned int i = 0; i < mGrade.size(); ++i ){
-        mGrade[ i ]->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBRESOURCE_CONTENTS ) ) {
+        for( unsigned int i = 0; i < mGrade.size(); ++i ){
+            mGrade[ i ]->accept( aVisitor, aPeriod );
+        }
+        mTechnology->accept( aVisitor, aPeriod );
     }
-    mTechnology->accept( aVisitor, aPeriod );
     
     aVisitor->endVisitSubRenewableResource( this, aPeriod );
 }
@@ -170,12 +170,14 @@ void ReserveSubResource::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitReserveSubResource( this, aPeriod );
 
     // Update the output container for the subresources.
-    for( unsigned int i = 0; i < mGrade.size(); ++i ){
-        mGrade[ i ]->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBRESOURCE_CONTENTS ) ) {
+        for( unsigned int i = 0; i < mGrade.size(); ++i ){
+            mGrade[ i ]->accept( aVisitor, aPeriod );
+        }
+
+        mTechnology->accept( aVisitor, aPeriod );
     }
     
-    mTechnology->accept( aVisitor, aPeriod );
-    
     aVisitor->endVisitReserveSubResource( this, aPeriod );
 }
 
@@ -64,6 +64,8 @@
 #include "containers/include/info_factory.h"
 #include "containers/include/iinfo.h"
 #include "sectors/include/sector_utils.h"
+#include "util/base/include/atom.h"
+#include "util/base/include/atom_registry.h"
 
 
 using namespace std;
@@ -77,7 +79,9 @@ mObjectMetaInfo(),
 mResourcePrice( Value( 0.0 ) ),
 mAvailable( Value( 0.0 ) ),
 mAnnualProd( Value( 0.0 ) ),
-mCumulProd( Value( 0.0 ) )
+mCumulProd( Value( 0.0 ) ),
+mNameAtom( 0 ),
+mRegionAtom( 0 )
 {
 }
 
@@ -250,6 +254,12 @@ void Resource::completeInit( const string& aRegionName, const IInfo* aRegionInfo
     if ( mPriceUnit.empty() ) {
         mPriceUnit = "1975$/GJ"; 
     }
+    // Intern the names so that the resource market is found by Atom while the
+    // model is calculated.
+    objects::AtomRegistry* atomRegistry = objects::AtomRegistry::getInstance();
+    mNameAtom = atomRegistry->getAtom( mName );
+    mRegionAtom = atomRegistry->getAtom( aRegionName );
+
     // Allocate the resource info.
     mResourceInfo.reset( InfoFactory::constructInfo( aRegionInfo, aRegionName + "-" + mName ) );
     // Set output and price unit of resource into the resource info.
@@ -311,7 +321,8 @@ void Resource::postCalc( const string& aRegionName, const int aPeriod ) {
         mSubResource[i]->postCalc( aRegionName, mName, aPeriod);
     }
     // Reset initial resource prices to solved prices
-    mResourcePrice[ aPeriod ] = scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    assert( mRegionAtom->getID() == aRegionName );
+    mResourcePrice[ aPeriod ] = scenario->getMarketplace()->getPrice( mNameAtom, mRegionAtom, aPeriod, true );
 }
 
 //! Create markets
@@ -367,7 +378,8 @@ void Resource::calcSupply( const string& aRegionName, const GDP* aGDP, const int
     // This code is moved down from Region
     Marketplace* marketplace = scenario->getMarketplace();
 
-    double price = marketplace->getPrice( mName, aRegionName, aPeriod );
+    assert( mRegionAtom->getID() == aRegionName );
+    double price = marketplace->getPrice( mNameAtom, mRegionAtom, aPeriod );
     
     // calculate annual supply
     annualsupply( aRegionName, aPeriod, aGDP, price );
@@ -423,8 +435,10 @@ void Resource::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitResource( this, aPeriod );
 
     // Update the output container for the subresources.
-    for( unsigned int i = 0; i < mSubResource.size(); ++i ){
-        mSubResource[ i ]->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBRESOURCES ) ) {
+        for( unsigned int i = 0; i < mSubResource.size(); ++i ){
+            mSubResource[ i ]->accept( aVisitor, aPeriod );
+        }
     }
 
     aVisitor->endVisitResource( this, aPeriod );
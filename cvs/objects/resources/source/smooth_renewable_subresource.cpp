@@ -66,6 +66,8 @@ SmoothRenewableSubresource::SmoothRenewableSubresource(void)
 {
     mPriceExponent = 0.01;
     mMidPrice = 0;
+    mPriceExponentScale = 0;
+    mHighestPrice = 0;
 }
 
 // Destructor: SmoothRenewableSubresource
@@ -125,6 +127,11 @@ void SmoothRenewableSubresource::completeInit( const std::string& aRegionName, c
       mainLog << "Invalid input parameter(s) to " << getXMLNameStatic() << std::endl;
       exit( -1 );
    }
+
+   // The top of the curve solves pow( p, e ) = 99 * pow( mid, e ) which does
+   // not change so calculate it once.
+   double curveExp = mCostCurve.getCurveExponent();
+   mHighestPrice = pow( 99.0 * pow( mMidPrice, curveExp ), 1.0 / curveExp );
 }
 
 /*! \brief Perform any initializations needed for each period.
@@ -153,6 +160,7 @@ void SmoothRenewableSubresource::initCalc(const std::string& aRegionName, const
     }
 
     mCostCurve.setMidprice( mMidPrice / mCumulativeTechChange[ aPeriod ] );
+    mPriceExponentScale = 5.0 * mCostCurve.getMidprice();
 
 }
 
@@ -172,12 +180,12 @@ void SmoothRenewableSubresource::annualsupply( const std::string& aRegionName, c
     // The factor of 5 below is arbitary, but was chosen so as to not change results signifiantly.
     // The equation below changes max resource value (using default  mPriceExponent) by 1% at 2 * mid-price.
     if( effectivePrice > 0 ) {
-        fractionAvailable *= std::pow( ( 1 + ( effectivePrice / ( 5.0 * mCostCurve.getMidprice() ) ) ), mPriceExponent );
+        fractionAvailable *= std::pow( ( 1 + ( effectivePrice / mPriceExponentScale ) ), mPriceExponent );
     }
     else {
         // if effectivePrice <0, avoid NaN by using the first two terms in the
         // series expansion of the above.
-        fractionAvailable *= 1.0 + mPriceExponent * effectivePrice / ( 5.0 * mCostCurve.getMidprice() );
+        fractionAvailable *= 1.0 + mPriceExponent * effectivePrice / mPriceExponentScale;
         // If the result is negative, clamp it to zero.
         if( fractionAvailable < 0.0 ) {
             fractionAvailable = 0.0;
@@ -221,15 +229,9 @@ double SmoothRenewableSubresource::getHighestPrice( const int aPeriod ) const{
     // form.  Instead, we'll take the point at which the supply is 99%
     // of maximum.
 
-    // TODO: add a member variable for the top price and calculate the
-    // elasticity condition when the object is set up.  We don't
-    // provide for changing the mid-price or exponent, so it only
-    // needs to be calculated once.
-
-    double curveExp = mCostCurve.getCurveExponent();
-    double value = pow( 99.0 * pow( mMidPrice, curveExp ), 1.0 / curveExp );
-
-    return value;
+    // This only depends on input parameters so it is calculated once
+    // in completeInit.
+    return mHighestPrice;
 }
 
 // end of smooth_renewable_subresource.cpp 
@@ -43,6 +43,7 @@
 #include <string>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -73,7 +74,8 @@ mCumulProd( Value( 0.0 ) ),
 mCumulativeTechChange( 1.0 ),
 mEffectivePrice( Value( -1.0 ) ),
 mCalProduction( -1.0 ),
-mTechnology( 0 )
+mTechnology( 0 ),
+mIsGradeCostSorted( true )
 {
 }
 
@@ -234,6 +236,7 @@ void SubResource::initCalc( const string& aRegionName, const string& aResourceNa
         // Determine cost
         mGrade[gr]->calcCost( mCumulativeTechChange[ aPeriod ], aPeriod );
     }
+    compileGrades( aPeriod );
 
     // Fill price added after it is calibrated.  This will interpolate to any
     // price adders read in the future or just copy forward if there is nothing
@@ -345,48 +348,78 @@ void SubResource::cumulsupply( const string& aRegionName, const string& aResourc
     mEffectivePrice[ aPeriod ] = aPrice + mPriceAdder[ aPeriod ] - currTech->getCost( aPeriod );
     
     double prevCumul = aPeriod != 0 ? mCumulProd[ aPeriod - 1 ] : 0.0;
+    const double effectivePrice = mEffectivePrice[ aPeriod ];
+    const size_t numGrades = mGradeCost.size();
 
     // Case 1
     // if market price is less than cost of first grade, then zero cumulative
     // production
-    if ( mEffectivePrice[ aPeriod ] <= mGrade[0]->getCost( aPeriod )) {
+    if ( numGrades == 0 || effectivePrice <= mGradeCost[ 0 ] ) {
         mCumulProd[ aPeriod ] = prevCumul;
     }
     
+    // Case 3
+    // if market price greater than the cost of the last grade, then
+    // cumulative production is the amount in all grades
+    else if ( effectivePrice > mGradeCost[ numGrades - 1 ] ) {
+        mCumulProd[ aPeriod ] = mCumulGradeAvail[ numGrades - 1 ];
+    }
+
     // Case 2
     // if market price is in between cost of first and last grade, then calculate
     // cumulative production in between those grades
-    if ( mEffectivePrice[ aPeriod ] > mGrade[0]->getCost( aPeriod ) && mEffectivePrice[ aPeriod ] <= mGrade[ mGrade.size() - 1 ]->getCost( aPeriod )) {
-        mCumulProd[ aPeriod ] = 0;
-        int i = 0;
-        int iL = 0;
-        int iU = 0;
-        while ( mGrade[ i ]->getCost( aPeriod ) < mEffectivePrice[ aPeriod ] ) {
-            iL=i; i++; iU=i;
-        }
+    else {
+        const size_t iU = findGradeAtPrice( effectivePrice );
+        const size_t iL = iU - 1;
         // add subrsrcs up to the lower grade
-        for ( i = 0; i <= iL; i++ ) {
-            mCumulProd[ aPeriod ] += Value( mGrade[i]->getAvail() );
-        }
+        mCumulProd[ aPeriod ] = mCumulGradeAvail[ iL ];
         // price must reach upper grade cost to produce all of lower grade
-        double slope = mGrade[iL]->getAvail()
-            / ( mGrade[iU]->getCost( aPeriod ) - mGrade[iL]->getCost( aPeriod ) );
-        mCumulProd[ aPeriod ] -= Value( slope * ( mGrade[iU]->getCost( aPeriod ) - mEffectivePrice[ aPeriod ] ) );
-    }
-    
-    // Case 3
-    // if market price greater than the cost of the last grade, then
-    // cumulative production is the amount in all grades
-    if ( mEffectivePrice[ aPeriod ] > mGrade[ mGrade.size() - 1 ]->getCost( aPeriod ) ) {
-        mCumulProd[ aPeriod ] = 0;
-        for ( unsigned int i = 0; i < mGrade.size(); i++ ) {
-            mCumulProd[ aPeriod ] += Value( mGrade[i]->getAvail() );
-        }
+        double slope = mGradeAvail[ iL ] / ( mGradeCost[ iU ] - mGradeCost[ iL ] );
+        mCumulProd[ aPeriod ] -= Value( slope * ( mGradeCost[ iU ] - effectivePrice ) );
     }
     
     mCumulProd[ aPeriod ] = std::max( mCumulProd[ aPeriod ].get(), prevCumul );
 }
 
+/*!
+ * \brief Copy the grade costs and availability for a period into contiguous
+ *        arrays.
+ * \details The supply functions are called every iteration while the grades
+ *          only change in initCalc so the per grade values are gathered once
+ *          here along with the cumulative availability.
+ * \param aPeriod Model period for which grade costs have been calculated.
+ */
+void SubResource::compileGrades( const int aPeriod ) {
+    const size_t numGrades = mGrade.size();
+    mGradeCost.resize( numGrades );
+    mGradeAvail.resize( numGrades );
+    mCumulGradeAvail.resize( numGrades );
+    double cumulAvail = 0.0;
+    for( size_t i = 0; i < numGrades; ++i ) {
+        mGradeCost[ i ] = mGrade[ i ]->getCost( aPeriod );
+        mGradeAvail[ i ] = mGrade[ i ]->getAvail();
+        cumulAvail += mGradeAvail[ i ];
+        mCumulGradeAvail[ i ] = cumulAvail;
+    }
+    mIsGradeCostSorted = std::is_sorted( mGradeCost.begin(), mGradeCost.end() );
+}
+
+/*!
+ * \brief Find the first grade whose cost is at least the given price.
+ * \details Grades are read in order of increasing cost in which case a binary
+ *          search is used, otherwise the grades are scanned in order.
+ * \param aPrice The price to search for.
+ * \return The index of the first grade with a cost greater than or equal to
+ *         aPrice, or the number of grades if there is none.
+ */
+size_t SubResource::findGradeAtPrice( const double aPrice ) const {
+    vector<double>::const_iterator gradeIter = mIsGradeCostSorted ?
+        std::lower_bound( mGradeCost.begin(), mGradeCost.end(), aPrice ) :
+        std::find_if( mGradeCost.begin(), mGradeCost.end(),
+                      [aPrice]( const double aCost ) { return aCost >= aPrice; } );
+    return gradeIter - mGradeCost.begin();
+}
+
 double SubResource::getCumulProd( const int aPeriod ) const {
     return mCumulProd[ aPeriod ];
 }
@@ -449,10 +482,12 @@ void SubResource::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitSubResource( this, aPeriod );
 
     // Update the output container for the subresources.
-    for( unsigned int i = 0; i < mGrade.size(); ++i ){
-        mGrade[ i ]->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBRESOURCE_CONTENTS ) ) {
+        for( unsigned int i = 0; i < mGrade.size(); ++i ){
+            mGrade[ i ]->accept( aVisitor, aPeriod );
+        }
+        mTechnology->accept( aVisitor, aPeriod );
     }
-    mTechnology->accept( aVisitor, aPeriod );
     
     aVisitor->endVisitSubResource( this, aPeriod );
 }
@@ -62,6 +62,8 @@ public:
     static const std::string& getXMLNameStatic();
 
     virtual double calcShare( const IDiscreteChoice* aChoiceFun, const GDP* aGDP, const int aPeriod ) const;
+    virtual bool getShareInputs( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                 double& aPrice, double& aLogShareAdjustment ) const;
     
     virtual void interpolateShareWeights( const int aPeriod );
 protected:
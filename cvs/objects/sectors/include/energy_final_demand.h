@@ -53,6 +53,7 @@
 // Forward declarations
 class GDP;
 class Demographic;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -107,12 +108,17 @@ protected:
         // TODO: Remove this function once construction is cleanly implemented.
         virtual bool isPerCapitaBased() const = 0;
 
-        virtual double calcDemand( const Demographic* aDemographics,
-                                   const GDP* aGDP,
-                                   const double aPriceElasticity,
-                                   const double aIncomeElasticity,
-                                   const double aPriceRatio,
-                                   const int aPeriod ) const = 0;
+        /*!
+         * \brief Calculate the growth in demand due to income (and population
+         *        if per capita based) since the previous period.
+         * \details This does not depend on prices so that it can be computed
+         *          once per period, the price response is applied by
+         *          calcMacroScaler.
+         */
+        virtual double calcIncomeScaler( const Demographic* aDemographics,
+                                         const GDP* aGDP,
+                                         const double aIncomeElasticity,
+                                         const int aPeriod ) const = 0;
     };
 
     class PerCapitaGDPDemandFunction: public IDemandFunction {
@@ -121,12 +127,10 @@ protected:
             return true;
         }
 
-        virtual double calcDemand( const Demographic* aDemographics,
-                                   const GDP* aGDP,
-                                   const double aPriceElasticity,
-                                   const double aIncomeElasticity,
-                                   const double aPriceRatio,
-                                   const int aPeriod ) const;
+        virtual double calcIncomeScaler( const Demographic* aDemographics,
+                                         const GDP* aGDP,
+                                         const double aIncomeElasticity,
+                                         const int aPeriod ) const;
     };
 
     class TotalGDPDemandFunction: public IDemandFunction {
@@ -135,12 +139,10 @@ protected:
             return false;
         }
 
-        virtual double calcDemand( const Demographic* aDemographics,
-                                   const GDP* aGDP,
-                                   const double aPriceElasticity,
-                                   const double aIncomeElasticity,
-                                   const double aPriceRatio,
-                                   const int aPeriod ) const;
+        virtual double calcIncomeScaler( const Demographic* aDemographics,
+                                         const GDP* aGDP,
+                                         const double aIncomeElasticity,
+                                         const int aPeriod ) const;
     };
 
     // TODO: get rid of this?  Would have to move AEEI out into EnergyFinalDemand.
@@ -207,6 +209,18 @@ protected:
 
     //! Object responsible for consuming final energy.
     std::auto_ptr<FinalEnergyConsumer> mFinalEnergyConsumer;
+
+    //! The market of the service for the period of mCachedPeriod.
+    std::auto_ptr<CachedMarket> mCachedMarket;
+
+    //! The period for which mIncomeScaler and mBasePrice were computed, -1 if none.
+    int mCachedPeriod;
+
+    //! Income (and population) scaler of the service demand in mCachedPeriod.
+    double mIncomeScaler;
+
+    //! Service price in the base period of the price ratio for mCachedPeriod.
+    double mBasePrice;
     
     virtual double calcFinalDemand( const std::string& aRegionName,
                                     const Demographic* aDemographics,
@@ -58,6 +58,24 @@ class WindBackupCalculator;
 class CapacityLimitBackupCalculator;
 class CSPBackupCalculator;
 
+/*!
+ * \ingroup Objects
+ * \brief The trial values from the marketplace which a backup calculation
+ *        depends on.
+ * \details These are read once per calculation by the IntermittentTechnology,
+ *          through markets it locates in initCalc, and are then shared by all
+ *          of the backup calculator methods it calls for that calculation
+ *          rather than each method looking the markets up by name.
+ */
+struct BackupInputs {
+    //! The trial share of the intermittent technology in the output of the
+    //! electricity sector, or -1 if there is no trial market in the period.
+    double mTrialShare;
+
+    //! The variance of the intermittent resource.
+    double mResourceVariance;
+};
+
 /*!
  * \ingroup Objects
  * \brief Interface which defines methods for calculating an average and
@@ -88,51 +106,33 @@ public:
      * \brief Compute backup required for the marginal unit of energy output.
      * \details Compute backup required per resource energy output on the margin
      *          (since energy output is what the modeled market is based on).
-     * \param aSector The name of the sector which requires backup capacity.
-     * \param aElectricSector The name of the electricity sector into which the
-     *        sector having a backup amount calculated for will feed.
-     * \param aResource The name of the resource the sector consumes.
-     * \param aRegion Name of the containing region.
+     * \param aInputs The trial values the backup depends on.
      * \param aReserveMargin Reserve margin for the electricity sector.
      * \param aAverageGridCapacityFactor The average electricity grid capacity
      *        factor.
-     * \param aPeriod Model period.
      * \return Reserve capacity per marginal intermittent electricity resource
      *         output.
      */
-    virtual double getMarginalBackupCapacity( const std::string& aSector,
-                                              const std::string& aElectricSector,
-                                              const std::string& aResource,
-                                              const std::string& aRegion,
+    virtual double getMarginalBackupCapacity( const BackupInputs& aInputs,
                                               const double aTechCapacityFactor,
                                               const double aReserveMargin,
-                                              const double aAverageGridCapacityFactor,
-                                              const int aPeriod ) const = 0;
+                                              const double aAverageGridCapacityFactor ) const = 0;
 
     /*!
      * \brief Compute the average backup required per unit for the intermittent
      *        subsector.
      * \details Computes the average quantity of backup capacity required per
      *          unit of energy output.
-     * \param aSector The name of the sector which requires backup capacity.
-     * \param aElectricSector The name of the electricity sector into which the
-     *        sector having a backup amount calculated for will feed.
-     * \param aResource The name of the resource the sector consumes.
-     * \param aRegion Name of the containing region.
+     * \param aInputs The trial values the backup depends on.
      * \param aReserveMargin Reserve margin for the electricity sector.
      * \param aAverageGridCapacityFactor The average electricity grid capacity
      *        factor.
-     * \param aPeriod Model period.
      * \return The average backup capacity required per unit of output.
      */
-    virtual double getAverageBackupCapacity( const std::string& aSector,
-                                             const std::string& aElectricSector,
-                                             const std::string& aResource,
-                                             const std::string& aRegion,
+    virtual double getAverageBackupCapacity( const BackupInputs& aInputs,
                                              const double aTechCapacityFactor,
                                              const double aReserveMargin,
-                                             const double aAverageGridCapacityFactor,
-                                             const int aPeriod ) const = 0;
+                                             const double aAverageGridCapacityFactor ) const = 0;
     
 protected:
     
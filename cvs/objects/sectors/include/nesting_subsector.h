@@ -53,6 +53,16 @@
 * \details This class allows infinite nesting of subsectors so users can set up
 *          logit competitions that best suite the sector without worrying about
 *          the number of levels of nesting it creates.
+*
+*          Unless the configuration bool "flatten-nesting-subsectors" is turned
+*          off, a nest at the top of a sector which contains other nests
+*          compiles the whole tree into an array of nests in initCalc.  Prices
+*          and shares are then calculated in a single pass from the deepest nests
+*          up and demand is passed down in a single pass rather than each nest
+*          recalculating the prices of all of the nests below it whenever its
+*          own price or shares are needed.  The results are the same as the
+*          recursive calculation, which remains in use for nested nests and when
+*          the flag is off.
 * \author Pralit Patel
 */
 
@@ -74,7 +84,37 @@ protected:
 
     )
     
-    const std::vector<double> calcChildShares( const GDP* aGDP, const int aPeriod ) const;
+    //! A nest in the compiled tree of a top level nest.
+    struct FlatNest {
+        //! The nest.
+        const NestingSubsector* mNest;
+
+        //! For each child subsector the index of its FlatNest, or -1 if it is
+        //! not a nest.
+        std::vector<int> mChildNests;
+
+        //! The position of the shares of the children in the array of all
+        //! shares.
+        size_t mShareOffset;
+    };
+
+    //! The nests in this tree in depth first order starting with this one,
+    //! empty if the tree is not flattened.
+    std::vector<FlatNest> mFlatNests;
+
+    //! The subsectors which are not nests in the order setOutput reaches them,
+    //! as the index of the containing FlatNest and the child index within it.
+    std::vector<std::pair<int, int> > mFlatLeaves;
+
+    //! The total number of child subsectors of all nests in the tree.
+    size_t mNumFlatShares;
+
+    void calcChildShares( const GDP* aGDP, const int aPeriod, double* aShares ) const;
+    void compileFlatNests();
+    int addFlatNest( const NestingSubsector* aNest );
+    void calcFlatPrices( const GDP* aGDP, const int aPeriod, double* aNestPrices, double* aShares ) const;
+    double calcNestPrice( const FlatNest& aNode, const double* aNestPrices, const GDP* aGDP,
+                          const int aPeriod, double* aShares ) const;
     virtual bool getCalibrationStatus( const int aPeriod ) const;
     virtual bool XMLDerivedClassParse( const std::string& nodeName, const xercesc::DOMNode* curr );
     virtual const std::string& getXMLName() const;
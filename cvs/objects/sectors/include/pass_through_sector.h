@@ -43,9 +43,12 @@
  * \author Pralit Patel
  */
 #include <string>
+#include <memory>
 #include "sectors/include/supply_sector.h"
 #include "containers/include/iactivity.h"
 
+class CachedMarket;
+
 /*!
  * \ingroup Objects
  * \brief This class represents a pass-through supply sector.
@@ -56,9 +59,11 @@ class PassThroughSector: public SupplySector
     friend class CalcFixedOutputActivity;
 public:
     explicit PassThroughSector( const std::string& aRegionName );
-    virtual ~PassThroughSector(){};
+    virtual ~PassThroughSector();
     static const std::string& getXMLNameStatic();
 
+    static std::string getFixedOutputMarketName( const std::string& aSectorName );
+
     virtual void completeInit( const IInfo* aRegionInfo,
                                ILandAllocator* aLandAllocator );
 
@@ -93,6 +98,17 @@ protected:
     )
 
 private:
+    //! The name of the market which passes the fixed output on.
+    std::string mFixedOutputMarketName;
+
+    //! The market which passes the fixed output to the pass-through technologies
+    //! for the current period, located in initCalc.
+    std::auto_ptr<CachedMarket> mFixedOutputMarket;
+
+    //! The market of the marginal revenue sector for the current period, located
+    //! in initCalc.
+    std::auto_ptr<CachedMarket> mMarginalRevenueCachedMarket;
+
     void setFixedDemandsToMarket( const int aPeriod ) const;
 };
 
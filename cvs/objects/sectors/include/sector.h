@@ -70,6 +70,9 @@ class NationalAccount;
 class ILandAllocator;
 class AGHG;
 class IDiscreteChoice;
+namespace objects {
+    class Atom;
+}
 
 // Need to forward declare the subclasses as well.
 class SupplySector;
@@ -95,6 +98,7 @@ class Sector: public IVisitable,
 {
     // TODO: Remove the need for these.
     friend class XMLDBOutputter;
+    friend class ColumnarOutputter;
     friend class CalibrateShareWeightVisitor;
 protected:
     
@@ -147,12 +151,18 @@ protected:
     typedef std::vector<object_meta_info_type> object_meta_info_vector_type;
     object_meta_info_vector_type mObjectMetaInfo; //!< Vector of object meta info to pass to mSectorInfo
 
+    //! The Atom of the sector name, set in completeInit for market lookups.
+    const objects::Atom* mNameAtom;
+
+    //! The Atom of the region name, set in completeInit for market lookups.
+    const objects::Atom* mRegionAtom;
+
     virtual void toDebugXMLDerived( const int period, std::ostream& aOut, Tabs* aTabs ) const = 0;
     virtual bool XMLDerivedClassParse( const std::string& nodeName, const xercesc::DOMNode* curr ) = 0;
     virtual const std::string& getXMLName() const = 0;
     
     virtual double getFixedOutput( const int aPeriod ) const;
-    const std::vector<double> calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const;
+    void calcSubsectorShares( const GDP* aGDP, const int aPeriod, double* aShares ) const;
 
     bool outputsAllFixed( const int period ) const;
     
@@ -52,6 +52,9 @@
 #include "util/base/include/time_vector.h"
 
 class IInfo;
+namespace objects {
+    class Atom;
+}
 
 /*! 
  * \ingroup Objects
@@ -75,11 +78,22 @@ public:
                                   const std::string& aSectorName,
                                   const int aPeriod );
 
+    static void addToTrialDemand( const objects::Atom* aRegionName,
+                                  const objects::Atom* aSectorName,
+                                  const Value& aSupply,
+                                  const int aPeriod );
+
+    static double getTrialSupply( const objects::Atom* aRegionName,
+                                  const objects::Atom* aSectorName,
+                                  const int aPeriod );
+
     static double calcFixedOutputScaleFactor( const double aMarketDemand,
                                               const double aFixedOutput );
 
     static double normalizeShares( std::vector<double>& aShares );
     static std::pair<double, double> normalizeLogShares( std::vector<double> & alogShares );
+    static std::pair<double, double> normalizeLogShares( double* aLogShares, const size_t aNumShares,
+                                                         const bool aUseFastMath = false );
 
     static double calcPriceRatio( const std::string& aRegionName,
                                   const std::string& aSectorName,
@@ -138,6 +152,9 @@ public:
 protected:
 
     static HashMap<std::string, std::string> sTrialMarketNames;
+
+    //! The trial market name Atoms keyed by the sector name Atoms.
+    static HashMap<const objects::Atom*, const objects::Atom*> sTrialMarketAtoms;
 };
 
 #endif // _SECTOR_UTILS_H_
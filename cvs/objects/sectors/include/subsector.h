@@ -165,7 +165,10 @@ protected:
     virtual void toDebugXMLDerived( const int period, std::ostream& out, Tabs* tabs ) const {};
     void parseBaseTechHelper( const xercesc::DOMNode* curr, BaseTechnology* aNewTech );
     
-    virtual const std::vector<double> calcTechShares ( const GDP* gdp, const int period ) const;
+    virtual void calcTechShares( const GDP* aGDP, const int aPeriod, double* aShares ) const;
+
+    void getShareInputsAtPrice( const double aSubsectorPrice, const GDP* aGDP, const int aPeriod,
+                                double& aShareWeight, double& aPrice, double& aLogShareAdjustment ) const;
     
     void clear();
     void clearInterpolationRules();
@@ -198,6 +201,13 @@ public:
     virtual void calcCost( const int aPeriod );
 
     virtual double calcShare( const IDiscreteChoice* aChoiceFn, const GDP* aGDP, const int aPeriod) const;
+    virtual bool getShareInputs( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                 double& aPrice, double& aLogShareAdjustment ) const;
+    static std::pair<double, double> calcSubsectorShares( const std::vector<Subsector*>& aSubsectors,
+                                                          const IDiscreteChoice* aChoiceFn,
+                                                          const GDP* aGDP,
+                                                          const int aPeriod,
+                                                          double* aShares );
     virtual double getShareWeight( const int period ) const;
 
     virtual void setOutput( const double aVariableDemand,
@@ -135,7 +135,7 @@ void AgSupplySector::completeInit( const IInfo* aRegionInfo,
 * \return The sector price.
 */
 double AgSupplySector::getPrice( const GDP* aGDP, const int aPeriod ) const {
-    return scenario->getMarketplace()->getPrice( mName, mRegionName, aPeriod, true );
+    return scenario->getMarketplace()->getPrice( mNameAtom, mRegionAtom, aPeriod, true );
 }
 
 /*! \brief Get the XML node name for output to XML.
@@ -92,6 +92,13 @@ double AgSupplySubsector::calcShare( const IDiscreteChoice* aChoiceFn, const GDP
     return 1;
 }
 
+bool AgSupplySubsector::getShareInputs( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                        double& aPrice, double& aLogShareAdjustment ) const
+{
+    // The share is not from the discrete choice function, see calcShare.
+    return false;
+}
+
 void AgSupplySubsector::interpolateShareWeights( const int aPeriod ) {
     // ag sectors do not require share-weigts so do nothing
 }
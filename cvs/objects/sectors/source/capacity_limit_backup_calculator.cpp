@@ -153,31 +153,19 @@ void CapacityLimitBackupCalculator::initCalc( const IInfo* aTechInfo ) {
     // No information needs to be passed in
 }
 
-double CapacityLimitBackupCalculator::getMarginalBackupCapacity( const string& aSector,
-                                                                 const string& aElectricSector,
-                                                                 const string& aResource,
-                                                                 const string& aRegion,
+double CapacityLimitBackupCalculator::getMarginalBackupCapacity( const BackupInputs& aInputs,
                                                                  const double aTechCapacityFactor,
                                                                  const double aReserveMargin,
-                                                                 const double aAverageGridCapacityFactor,
-                                                                 const int aPeriod ) const
+                                                                 const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
-    assert( !aSector.empty() );
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
     assert( aReserveMargin >= 0 );
     assert( aAverageGridCapacityFactor > 0 );
 
-    double marginalBackup = getMarginalBackupCapacityFraction( aSector,
-                                                               aElectricSector,
-                                                               aResource,
-                                                               aRegion,
+    double marginalBackup = getMarginalBackupCapacityFraction( aInputs,
                                                                aTechCapacityFactor,
                                                                aReserveMargin,
-                                                               aAverageGridCapacityFactor,
-                                                               aPeriod );
+                                                               aAverageGridCapacityFactor );
  
 
     // This is confusing but mathematically correct.  The marginal backupCapacityFraction is in units of 
@@ -189,23 +177,16 @@ double CapacityLimitBackupCalculator::getMarginalBackupCapacity( const string& a
     return SectorUtils::convertEnergyToCapacity( aTechCapacityFactor, marginalBackup );
 }
 
-double CapacityLimitBackupCalculator::getAverageBackupCapacity( const string& aSector,
-                                                                const string& aElectricSector,
-                                                                const string& aResource,
-                                                                const string& aRegion,
+double CapacityLimitBackupCalculator::getAverageBackupCapacity( const BackupInputs& aInputs,
                                                                 const double aTechCapacityFactor,
                                                                 const double aReserveMargin,
-                                                                const double aAverageGridCapacityFactor,
-                                                                const int aPeriod ) const
+                                                                const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
     assert( aReserveMargin >= 0 );
     assert( aAverageGridCapacityFactor > 0 );
 
-    double renewElecShare = std::min( SectorUtils::getTrialSupply( aRegion, aSector, aPeriod ), 1.0 );
+    double renewElecShare = std::min( aInputs.mTrialShare, 1.0 );
 
     // No backup required for zero share.
     if( renewElecShare < util::getVerySmallNumber() ){
@@ -246,35 +227,22 @@ double CapacityLimitBackupCalculator::getAverageBackupCapacity( const string& aS
  *          output is what the modeled market is based on). Convert intermittent
  *          resource output back to energy using the resource capacity factor.
  *          This is the cost of operating reserve or backup capacity.
- * \param aSector The name of the sector which requires backup capacity.
- * \param aElectricSector The name of the electricity sector into which the
- *        sector having a backup amount calculated for will feed.
- * \param aResource The name of the resource the sector consumes.
- * \param aRegion Name of the containing region.
+ * \param aInputs The trial values the backup depends on.
  * \param aReserveMargin Reserve margin for the electricity sector.
  * \param aAverageGridCapacityFactor The average electricity grid capacity
  *        factor.
- * \param aPeriod Model period.
  * \return Reserve capacity per intermittent electricity resource output
  *         (GW/EJ).
  */
-double CapacityLimitBackupCalculator::getMarginalBackupCapacityFraction( const string& aSector,
-                                                                         const string& aElectricSector,
-                                                                         const string& aResource,
-                                                                         const string& aRegion,
+double CapacityLimitBackupCalculator::getMarginalBackupCapacityFraction( const BackupInputs& aInputs,
                                                                          const double aTechCapacityFactor,
                                                                          const double aReserveMargin,
-                                                                         const double aAverageGridCapacityFactor,
-                                                                         const int aPeriod ) const
+                                                                         const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
     assert( aAverageGridCapacityFactor >= 0 && aAverageGridCapacityFactor <= 1 );
-    assert( !aSector.empty() );
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
 
-    double renewElecShare = std::min( SectorUtils::getTrialSupply( aRegion, aSector, aPeriod ), 1.0 );
+    double renewElecShare = std::min( aInputs.mTrialShare, 1.0 );
     
     // No backup required for zero share.
     if( renewElecShare < util::getVerySmallNumber() ){
@@ -306,29 +274,20 @@ double CapacityLimitBackupCalculator::getMarginalBackupCapacityFraction( const s
  *          the electricity sector. This is determined using trial values for
  *          the intermittent sector and electricity sector production. The
  *          production is converted to capacity using constant capacity factors.
- * \param aSector The name of the sector which requires backup capacity.
- * \param aElectricSector The name of the electricity sector into which the
- *        sector having a backup amount calculated for will feed.
- * \param aResource The name of the resource the sector consumes.
- * \param aRegion Name of the containing region.
+ * \param aInputs The trial values the backup depends on.
  * \param aReserveMargin Reserve margin for the electricity sector.
  * \param aAverageGridCapacityFactor The average electricity grid capacity
  *        factor.
- * \param aPeriod Model period.
  * \return Share of the intermittent resource within within the electricity
  *         sector.
  */
-double CapacityLimitBackupCalculator::calcIntermittentShare( const string& aSector,
-                                                             const string& aElectricSector,
-                                                             const string& aResource,
-                                                             const string& aRegion,
+double CapacityLimitBackupCalculator::calcIntermittentShare( const BackupInputs& aInputs,
                                                              const double aTechCapacityFactor,
                                                              const double aReserveMargin,
-                                                             const double aAverageGridCapacityFactor,
-                                                             const int aPeriod ) const
+                                                             const double aAverageGridCapacityFactor ) const
 {
 
-    double capacityShare = std::min( std::max( SectorUtils::getTrialSupply( aRegion, aSector, aPeriod ), 0.0 ), 1.0 ) *
+    double capacityShare = std::min( std::max( aInputs.mTrialShare, 0.0 ), 1.0 ) *
                            aAverageGridCapacityFactor / aTechCapacityFactor;
     return capacityShare;
 }
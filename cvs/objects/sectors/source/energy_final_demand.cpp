@@ -53,6 +53,7 @@
 #include "containers/include/gdp.h"
 #include "containers/include/iinfo.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "demographics/include/demographic.h"
 #include "sectors/include/energy_final_demand.h"
 #include "sectors/include/sector_utils.h"
@@ -65,7 +66,10 @@ extern Scenario* scenario;
 /*! \brief Constructor.
 * \author Sonny Kim, Steve Smith, Josh Lurz
 */
-EnergyFinalDemand::EnergyFinalDemand()
+EnergyFinalDemand::EnergyFinalDemand():
+mCachedPeriod( -1 ),
+mIncomeScaler( 1 ),
+mBasePrice( 0 )
 {
 }
 
@@ -255,6 +259,17 @@ void EnergyFinalDemand::initCalc( const string& aRegionName,
                                   const Demographic* aDemographics,
                                   const int aPeriod )
 {
+    // GDP and population are fixed for the period by the time this is called
+    // as is the price of the previous period, so the parts of the macro scaler
+    // which depend on them are computed once here instead of every evaluation.
+    Marketplace* marketplace = scenario->getMarketplace();
+    mCachedMarket = marketplace->locateMarket( mName, aRegionName, aPeriod );
+    mIncomeScaler = mDemandFunction->calcIncomeScaler( aDemographics, aGDP,
+                                                       mIncomeElasticity[ aPeriod ],
+                                                       aPeriod );
+    // Prices before 1990 are not valid so the price ratio is 1 through period 1.
+    mBasePrice = aPeriod > 1 ? marketplace->getPrice( mName, aRegionName, aPeriod - 1 ) : 0;
+    mCachedPeriod = aPeriod;
 }
 
 /*! \brief Set the final demand for service into the marketplace after 
@@ -276,8 +291,12 @@ void EnergyFinalDemand::setFinalDemand( const string& aRegionName,
 {
     calcFinalDemand( aRegionName, aDemographics, aGDP, aPeriod );
     // Set the service demand into the marketplace.
-    Marketplace* marketplace = scenario->getMarketplace();
-    marketplace->addToDemand( mName, aRegionName, mServiceDemands[ aPeriod ], aPeriod );
+    if( mCachedMarket.get() && mCachedMarket->isForPeriod( aPeriod ) ) {
+        mCachedMarket->addToDemand( mName, aRegionName, mServiceDemands[ aPeriod ], aPeriod );
+    }
+    else {
+        scenario->getMarketplace()->addToDemand( mName, aRegionName, mServiceDemands[ aPeriod ], aPeriod );
+    }
 }
 
 /*! \brief Set the final demand for service using the aggrgate sector energy service 
@@ -347,19 +366,28 @@ double EnergyFinalDemand::calcMacroScaler( const string& aRegionName,
                                            const GDP* aGDP,
                                            const int aPeriod ) const
 {
-    int previousPeriod = 0;
-    if( aPeriod > 0 ){
-        previousPeriod = aPeriod - 1;
+    double priceRatio;
+    double incomeScaler;
+    if( aPeriod == mCachedPeriod && mCachedMarket.get() && mCachedMarket->isForPeriod( aPeriod ) ) {
+        // Only the current price changes during the solution of the period.
+        priceRatio = aPeriod > 1 ? mCachedMarket->getPrice( mName, aRegionName, aPeriod ) / mBasePrice : 1;
+        incomeScaler = mIncomeScaler;
+    }
+    else {
+        int previousPeriod = 0;
+        if( aPeriod > 0 ){
+            previousPeriod = aPeriod - 1;
+        }
+        priceRatio = SectorUtils::calcPriceRatio( aRegionName, mName, previousPeriod, aPeriod );
+        incomeScaler = mDemandFunction->calcIncomeScaler( aDemographics, aGDP,
+                                                          mIncomeElasticity[ aPeriod ],
+                                                          aPeriod );
     }
-
-    const double priceRatio = SectorUtils::calcPriceRatio( aRegionName, mName,
-                                                     previousPeriod, aPeriod );
     const double cappedPriceRatio = max( priceRatio, SectorUtils::getDemandPriceThreshold() );
 
-    double macroScaler = mDemandFunction->calcDemand( aDemographics,
-                                                      aGDP, mPriceElasticity[ aPeriod ],
-                                                      mIncomeElasticity[ aPeriod ], cappedPriceRatio,
-                                                      aPeriod );
+    //! \pre cappedPriceRatio > 0 which the price threshold guarantees.
+    double macroScaler = mPriceElasticity[ aPeriod ] != 0 ?
+        pow( cappedPriceRatio, mPriceElasticity[ aPeriod ] ) * incomeScaler : incomeScaler;
     // May need to make an adjustment in case of negative prices.
     if( priceRatio < cappedPriceRatio && mPriceElasticity[ aPeriod ] != 0 ) {
         macroScaler = SectorUtils::adjustDemandForNegativePrice( macroScaler, priceRatio );
@@ -413,15 +441,14 @@ EnergyFinalDemand::FinalEnergyConsumer::FinalEnergyConsumer( const string& aFina
     mTFEMarketName = SectorUtils::createTFEMarketName( aFinalDemandName );
 }
 
-double EnergyFinalDemand::PerCapitaGDPDemandFunction::calcDemand(
+double EnergyFinalDemand::PerCapitaGDPDemandFunction::calcIncomeScaler(
                                                            const Demographic* aDemographics,
                                                            const GDP* aGDP,
-                                                           const double aPriceElasticity,
                                                            const double aIncomeElasticity,
-                                                           const double aPriceRatio,
                                                            const int aPeriod ) const
 {
-    // If perCapitaBased, service_demand = B * P^r * GDPperCap^r * Population.
+    // If perCapitaBased, service_demand = B * P^r * GDPperCap^r * Population
+    // where the price term is applied by calcMacroScaler.
     // All ratios are based on previous period values.
     if( aPeriod == 0 ){
         // No changes in price, income and population scales.
@@ -433,24 +460,16 @@ double EnergyFinalDemand::PerCapitaGDPDemandFunction::calcDemand(
     double populationRatio = aDemographics->getTotal( aPeriod )
                            / aDemographics->getTotal( aPeriod - 1);
 
-    //! \pre aPriceRatio > 0.  Prices calculated by
-    //! calcMacroScaler will automatically meet this
-    //! condition.
-    double macroEconomicScaler = pow( aPriceRatio, aPriceElasticity )
-                         * pow( GDPperCapRatio, aIncomeElasticity )
-                         * populationRatio;
-
-    return macroEconomicScaler;
+    return pow( GDPperCapRatio, aIncomeElasticity ) * populationRatio;
 }
 
-double EnergyFinalDemand::TotalGDPDemandFunction::calcDemand( const Demographic* aDemographics,
+double EnergyFinalDemand::TotalGDPDemandFunction::calcIncomeScaler( const Demographic* aDemographics,
                                                        const GDP* aGDP,
-                                                       const double aPriceElasticity,
                                                        const double aIncomeElasticity,
-                                                       const double aPriceRatio,
                                                        const int aPeriod ) const
 {
-    // If not perCapitaBased, service_demand = B * P^r * GDP^r
+    // If not perCapitaBased, service_demand = B * P^r * GDP^r where the price
+    // term is applied by calcMacroScaler.
     // Demand based on price changes and scale of GDP 
     if( aPeriod == 0 ){
         // No changes in price and income.
@@ -461,14 +480,7 @@ double EnergyFinalDemand::TotalGDPDemandFunction::calcDemand( const Demographic*
     double GDPRatio = aGDP->getGDP( aPeriod )
                     / aGDP->getGDP( aPeriod - 1 );
 
-
-    //! \pre aPriceRatio > 0.  Prices calculated by
-    //! calcMacroScaler will automatically meet this
-    //! condition.
-    double macroEconomicScaler = pow( aPriceRatio , aPriceElasticity ) 
-                               * pow( GDPRatio, aIncomeElasticity );
-
-    return macroEconomicScaler;
+    return pow( GDPRatio, aIncomeElasticity );
 }
 
 const string& EnergyFinalDemand::FinalEnergyConsumer::getXMLNameStatic() {
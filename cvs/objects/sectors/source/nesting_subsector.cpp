@@ -52,6 +52,7 @@
 #include "sectors/include/tran_subsector.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/ivisitor.h"
+#include "util/base/include/scratch_array.h"
 #include "sectors/include/sector_utils.h"
 #include "functions/include/idiscrete_choice.hpp"
 
@@ -69,7 +70,8 @@ extern Scenario* scenario;
 */
 NestingSubsector::NestingSubsector( const string& aRegionName, const string& aSectorName, const int aDepth ):
     Subsector( aRegionName, aSectorName ),
-    mNestingDepth( aDepth )
+    mNestingDepth( aDepth ),
+    mNumFlatShares( 0 )
 {
 }
 
@@ -180,9 +182,137 @@ void NestingSubsector::initCalc( NationalAccount* aNationalAccount,
     for( auto subsector : mSubsectors ) {
         subsector->initCalc( aNationalAccount, aDemographics, aMoreSectorInfo, aPeriod );
     }
+    // only the nest at the top of the tree is flattened, those below it are
+    // reached through it
+    if( mNestingDepth == 0 ) {
+        compileFlatNests();
+    }
     Subsector::initCalc( aNationalAccount, aDemographics, aMoreSectorInfo, aPeriod );
 }
 
+/*!
+ * \brief Compile the tree of nests below this one into mFlatNests.
+ * \details Nothing is compiled if the configuration has turned flattening off
+ *          or if there are no nests below this one, in which case the
+ *          recursive calculation is used.
+ */
+void NestingSubsector::compileFlatNests() {
+    mFlatNests.clear();
+    mFlatLeaves.clear();
+    mNumFlatShares = 0;
+    bool hasNests = false;
+    for( auto subsector : mSubsectors ) {
+        hasNests |= dynamic_cast<const NestingSubsector*>( subsector ) != 0;
+    }
+    if( hasNests && Configuration::getInstance()->getBool( "flatten-nesting-subsectors", true, false ) ) {
+        addFlatNest( this );
+    }
+}
+
+/*!
+ * \brief Add a nest and, depth first, all of the nests below it to mFlatNests.
+ * \param aNest The nest to add.
+ * \return The index of the nest in mFlatNests.
+ */
+int NestingSubsector::addFlatNest( const NestingSubsector* aNest ) {
+    const int index = static_cast<int>( mFlatNests.size() );
+    FlatNest node;
+    node.mNest = aNest;
+    node.mChildNests.assign( aNest->mSubsectors.size(), -1 );
+    node.mShareOffset = mNumFlatShares;
+    mFlatNests.push_back( node );
+    mNumFlatShares += aNest->mSubsectors.size();
+    for( size_t i = 0; i < aNest->mSubsectors.size(); ++i ) {
+        const NestingSubsector* childNest = dynamic_cast<const NestingSubsector*>( aNest->mSubsectors[ i ] );
+        if( childNest ) {
+            const int childIndex = addFlatNest( childNest );
+            mFlatNests[ index ].mChildNests[ i ] = childIndex;
+        }
+        else {
+            mFlatLeaves.push_back( make_pair( index, static_cast<int>( i ) ) );
+        }
+    }
+    return index;
+}
+
+/*!
+ * \brief Calculate the price and child shares of every nest in the flattened
+ *        tree.
+ * \details Nests come after the nest containing them in mFlatNests so going
+ *          through them in reverse the prices of the nested nests are known by
+ *          the time the nest containing them needs them.
+ * \param aGDP The GDP object in case of fuel preference elasticity is used.
+ * \param aPeriod model period
+ * \param aNestPrices Will hold the price of each nest, as getPrice would return.
+ * \param aShares Will hold the child shares of each nest, starting at its
+ *        mShareOffset.
+ */
+void NestingSubsector::calcFlatPrices( const GDP* aGDP, const int aPeriod, double* aNestPrices, double* aShares ) const {
+    for( int k = static_cast<int>( mFlatNests.size() ) - 1; k >= 0; --k ) {
+        const FlatNest& node = mFlatNests[ k ];
+        aNestPrices[ k ] = node.mNest->calcNestPrice( node, aNestPrices, aGDP, aPeriod,
+                                                      aShares + node.mShareOffset );
+    }
+}
+
+/*!
+ * \brief Calculate the child shares and the price of this nest given the
+ *        prices of the nests it contains.
+ * \details This gives the same shares as calcChildShares and the same price as
+ *          getPrice.
+ * \param aNode The FlatNest of this nest.
+ * \param aNestPrices The prices of the nests in the flattened tree, those
+ *        below this nest must already be set.
+ * \param aGDP The GDP object in case of fuel preference elasticity is used.
+ * \param aPeriod model period
+ * \param aShares Will hold the subsector shares, one per child subsector.
+ * \return The price of this nest.
+ */
+double NestingSubsector::calcNestPrice( const FlatNest& aNode, const double* aNestPrices, const GDP* aGDP,
+                                        const int aPeriod, double* aShares ) const
+{
+    const size_t numSubsectors = mSubsectors.size();
+    ScratchArray childPrices( numSubsectors );
+    for( size_t i = 0; i < numSubsectors; ++i ) {
+        childPrices[ i ] = aNode.mChildNests[ i ] >= 0 ? aNestPrices[ aNode.mChildNests[ i ] ] :
+            mSubsectors[ i ]->getPrice( aGDP, aPeriod );
+    }
+
+    ScratchArray shareInputs( 3 * numSubsectors );
+    double* shareWeights = shareInputs.data();
+    double* prices = shareWeights + numSubsectors;
+    double* logShareAdjustments = prices + numSubsectors;
+    bool hasShareInputs = true;
+    for( size_t i = 0; i < numSubsectors && hasShareInputs; ++i ) {
+        if( aNode.mChildNests[ i ] >= 0 ) {
+            static_cast<const NestingSubsector*>( mSubsectors[ i ] )->getShareInputsAtPrice(
+                childPrices[ i ], aGDP, aPeriod, shareWeights[ i ], prices[ i ], logShareAdjustments[ i ] );
+        }
+        else {
+            hasShareInputs = mSubsectors[ i ]->getShareInputs( aGDP, aPeriod, shareWeights[ i ],
+                                                               prices[ i ], logShareAdjustments[ i ] );
+        }
+    }
+    // If a child calculates its own share, or the shares underflowed, fall back
+    // to the recursive calculation which handles those cases.
+    if( !hasShareInputs ||
+        ( mDiscreteChoiceModel->calcShares( shareWeights, prices, logShareAdjustments,
+                                            aShares, numSubsectors, aPeriod ).first == 0.0 &&
+          !allOutputFixed( aPeriod ) ) )
+    {
+        calcChildShares( aGDP, aPeriod, aShares );
+    }
+
+    double subsectorPrice = 0.0;
+    double sharesum = 0.0;
+    for( size_t i = 0; i < numSubsectors; ++i ) {
+        subsectorPrice += aShares[ i ] * childPrices[ i ];
+        sharesum += aShares[ i ];
+    }
+    // see getPrice for why a NaN is returned
+    return sharesum < util::getSmallNumber() ? numeric_limits<double>::signaling_NaN() : subsectorPrice;
+}
+
 /*!
  * \brief calculate child subsector shares within this nest 
  *
@@ -190,17 +320,13 @@ void NestingSubsector::initCalc( NationalAccount* aNationalAccount,
  *
  * \param aGDP The GDP object in case of fuel preference elasticity is used.
  * \param aPeriod model period
- * \return A vector of subsector shares.
+ * \param aShares Will hold the subsector shares, one per child subsector.
 */
-const vector<double> NestingSubsector::calcChildShares( const GDP* aGDP, const int aPeriod ) const {
-    // Calculate unnormalized shares.
-    vector<double> subsecShares( mSubsectors.size() );
-    for( unsigned int i = 0; i < mSubsectors.size(); ++i ){
-        subsecShares[ i ] = mSubsectors[ i ]->calcShare( mDiscreteChoiceModel, aGDP, aPeriod );
-    }
-
-    // Normalize the shares.  After normalization they will be true shares, not log(shares).
-    pair<double, double> shareSum = SectorUtils::normalizeLogShares( subsecShares );
+void NestingSubsector::calcChildShares( const GDP* aGDP, const int aPeriod, double* aShares ) const {
+    // Calculate the shares.  These will be true shares, not log(shares).
+    double* subsecShares = aShares;
+    pair<double, double> shareSum = Subsector::calcSubsectorShares( mSubsectors, mDiscreteChoiceModel,
+                                                                    aGDP, aPeriod, subsecShares );
     if( shareSum.first == 0.0 && !allOutputFixed( aPeriod ) ){
         // This should no longer happen, but it's still technically possible.
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -225,9 +351,6 @@ const vector<double> NestingSubsector::calcChildShares( const GDP* aGDP, const i
         }
         subsecShares[ minPriceIndex ] = 1.0;        // ... except the lowest price
     }
-    /*! \post There is one share per subsector. */
-    assert( subsecShares.size() == subsec.size() );
-    return subsecShares;
 }
 
 /*! \brief Returns the subsector price.
@@ -238,9 +361,17 @@ const vector<double> NestingSubsector::calcChildShares( const GDP* aGDP, const i
 * \param aPeriod Model period
 */
 double NestingSubsector::getPrice( const GDP* aGDP, const int aPeriod ) const {
+    if( !mFlatNests.empty() ) {
+        ScratchArray nestPrices( mFlatNests.size() );
+        ScratchArray shares( mNumFlatShares );
+        calcFlatPrices( aGDP, aPeriod, nestPrices.data(), shares.data() );
+        return nestPrices[ 0 ];
+    }
+
     double subsectorPrice = 0.0; // initialize to 0 for summing
     double sharesum = 0.0;
-    const vector<double>& techShares = calcChildShares( aGDP, aPeriod );
+    ScratchArray techShares( mSubsectors.size() );
+    calcChildShares( aGDP, aPeriod, techShares.data() );
     for ( unsigned int i = 0; i < mSubsectors.size(); ++i ) {
         double currCost = mSubsectors[i]->getPrice( aGDP, aPeriod );
         // calculate weighted average price for Subsector.
@@ -301,7 +432,30 @@ double NestingSubsector::getAverageFuelPrice( const GDP* aGDP, const int aPeriod
     // current period's are unknown.
     const int sharePeriod = ( aPeriod == 0 ) ? aPeriod : aPeriod - 1;
 
-    const vector<double>& techShares = calcChildShares( aGDP, sharePeriod );
+    if( !mFlatNests.empty() ) {
+        ScratchArray nestValues( mFlatNests.size() );
+        ScratchArray shares( mNumFlatShares );
+        calcFlatPrices( aGDP, sharePeriod, nestValues.data(), shares.data() );
+        // The prices of the nests are replaced by their fuel prices, again from
+        // the deepest nests up.
+        for( int k = static_cast<int>( mFlatNests.size() ) - 1; k >= 0; --k ) {
+            const FlatNest& node = mFlatNests[ k ];
+            double nestFuelPrice = 0;
+            for( size_t i = 0; i < node.mChildNests.size(); ++i ) {
+                const double childFuelPrice = node.mChildNests[ i ] >= 0 ? nestValues[ node.mChildNests[ i ] ] :
+                    node.mNest->mSubsectors[ i ]->getAverageFuelPrice( aGDP, aPeriod );
+                nestFuelPrice += shares[ node.mShareOffset + i ] * childFuelPrice;
+            }
+            nestValues[ k ] = nestFuelPrice;
+        }
+        fuelPrice = nestValues[ 0 ];
+        /*! \post Fuel price must be positive. */
+        assert( fuelPrice >= 0 );
+        return fuelPrice;
+    }
+
+    ScratchArray techShares( mSubsectors.size() );
+    calcChildShares( aGDP, sharePeriod, techShares.data() );
     for ( unsigned int i = 0; i < mSubsectors.size(); ++i) {
         // calculate weighted average price of fuel only
         // subsector shares are based on total cost
@@ -361,7 +515,32 @@ void NestingSubsector::setOutput( const double aSubsectorVariableDemand,
                            const int aPeriod )
 
 {
-    const vector<double>& subsecShares = calcChildShares( aGDP, aPeriod );
+    if( !mFlatNests.empty() ) {
+        ScratchArray nestValues( mFlatNests.size() );
+        ScratchArray shares( mNumFlatShares );
+        calcFlatPrices( aGDP, aPeriod, nestValues.data(), shares.data() );
+        // The prices of the nests are replaced by their demands, from this nest
+        // down, and then the rest of the subsectors are given their demand in
+        // the same order as the recursive calculation would.
+        nestValues[ 0 ] = aSubsectorVariableDemand;
+        for( size_t k = 0; k < mFlatNests.size(); ++k ) {
+            const FlatNest& node = mFlatNests[ k ];
+            for( size_t i = 0; i < node.mChildNests.size(); ++i ) {
+                if( node.mChildNests[ i ] >= 0 ) {
+                    nestValues[ node.mChildNests[ i ] ] = shares[ node.mShareOffset + i ] * nestValues[ k ];
+                }
+            }
+        }
+        for( auto leaf : mFlatLeaves ) {
+            const FlatNest& node = mFlatNests[ leaf.first ];
+            node.mNest->mSubsectors[ leaf.second ]->setOutput( shares[ node.mShareOffset + leaf.second ] * nestValues[ leaf.first ],
+                                                               aFixedOutputScaleFactor, aGDP, aPeriod );
+        }
+        return;
+    }
+
+    ScratchArray subsecShares( mSubsectors.size() );
+    calcChildShares( aGDP, aPeriod, subsecShares.data() );
     for( size_t i = 0; i < mSubsectors.size(); ++i ) {
         mSubsectors[i]->setOutput( subsecShares[i] * aSubsectorVariableDemand,
                 aFixedOutputScaleFactor, aGDP, aPeriod );
@@ -487,8 +666,10 @@ void NestingSubsector::postCalc( const int aPeriod ) {
 void NestingSubsector::accept( IVisitor* aVisitor, const int period ) const {
     aVisitor->startVisitNestingSubsector( this, period );
     
-    for( auto subsector : mSubsectors ) {
-        subsector->accept( aVisitor, period );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBSECTORS ) ) {
+        for( auto subsector : mSubsectors ) {
+            subsector->accept( aVisitor, period );
+        }
     }
             
     aVisitor->endVisitNestingSubsector( this, period );
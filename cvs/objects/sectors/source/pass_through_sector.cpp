@@ -48,6 +48,7 @@
 #include "util/base/include/xml_helper.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "containers/include/market_dependency_finder.h"
 #include "containers/include/iinfo.h"
 #include "util/logger/include/ilogger.h"
@@ -65,6 +66,19 @@ SupplySector( aRegionName )
 {
 }
 
+PassThroughSector::~PassThroughSector() {
+}
+
+/*!
+ * \brief The name of the unsolved trial market which passes the fixed output
+ *        of a pass-through sector to the technologies which use it.
+ * \param aSectorName The name of the pass-through sector.
+ * \return The name of the market.
+ */
+string PassThroughSector::getFixedOutputMarketName( const string& aSectorName ) {
+    return aSectorName + "-fixed-output";
+}
+
 const string& PassThroughSector::getXMLNameStatic() {
     const static string XML_NAME = "pass-through-sector";
     return XML_NAME;
@@ -114,7 +128,8 @@ void PassThroughSector::completeInit( const IInfo* aRegionInfo,
 
     // Add dependencies for a calc item to gather up the fixed demands from this
     // pass through sector and make that available for the downstream sector
-    const string fixedDemandActivityName = mName + "-fixed-output";
+    mFixedOutputMarketName = getFixedOutputMarketName( mName );
+    const string& fixedDemandActivityName = mFixedOutputMarketName;
     MarketDependencyFinder* depFinder = scenario->getMarketplace()->getDependencyFinder();
 
     // Ensure we gather the fixed demands after we calculate prices / before we
@@ -153,11 +168,21 @@ void PassThroughSector::initCalc( NationalAccount* aNationalAccount,
                                   const int aPeriod )
 {
     SupplySector::initCalc( aNationalAccount, aDemographics, aPeriod );
+
+    // Locate the markets used when calculating the fixed output so that each
+    // model evaluation does not need to search for them by name.
+    Marketplace* marketplace = scenario->getMarketplace();
+    mFixedOutputMarket = marketplace->locateMarket( mFixedOutputMarketName, mRegionName, aPeriod );
+    mMarginalRevenueCachedMarket = marketplace->locateMarket( mMarginalRevenueSector, mMarginalRevenueMarket, aPeriod );
 }
 
 double PassThroughSector::getFixedOutput( const int aPeriod ) const {
-    const double marginalRevenue = scenario->getMarketplace()->getPrice( mMarginalRevenueSector,
-        mMarginalRevenueMarket, aPeriod );
+    // Use the cached market during the calculation of the current period, other
+    // periods (i.e. reporting) need to go through the marketplace.
+    const double marginalRevenue =
+        mMarginalRevenueCachedMarket.get() && mMarginalRevenueCachedMarket->isForPeriod( aPeriod ) ?
+        mMarginalRevenueCachedMarket->getPrice( mMarginalRevenueSector, mMarginalRevenueMarket, aPeriod ) :
+        scenario->getMarketplace()->getPrice( mMarginalRevenueSector, mMarginalRevenueMarket, aPeriod );
     double totalfixedOutput = 0;
     for( CSubsectorIterator subSecIter = mSubsectors.begin(); subSecIter != mSubsectors.end(); subSecIter++ ) {
         totalfixedOutput += (*subSecIter)->getFixedOutput( aPeriod, marginalRevenue );
@@ -173,13 +198,14 @@ double PassThroughSector::getFixedOutput( const int aPeriod ) const {
 void PassThroughSector::setFixedDemandsToMarket( const int aPeriod ) const {
     const_cast<PassThroughSector*>( this )->mLastCalcFixedOutput = getFixedOutput( aPeriod );
 
-    const string fixedDemandActivityName = mName + "-fixed-output";
-    Marketplace* marketplace = scenario->getMarketplace();
+    // This is only called from the flow graph for the period being calculated in
+    // which case the market was located in initCalc.
+    const string& fixedDemandActivityName = mFixedOutputMarketName;
     // set the fixed out to both sides of the equation (supply=price for trial markets)
     // so the solver doesn't complain it is "unsolved"
-    marketplace->addToDemand( fixedDemandActivityName, mRegionName,
-                              const_cast<PassThroughSector*>( this )->mLastCalcFixedOutput, aPeriod );
-    marketplace->setPrice( fixedDemandActivityName, mRegionName, mLastCalcFixedOutput, aPeriod );
+    mFixedOutputMarket->addToDemand( fixedDemandActivityName, mRegionName,
+                                     const_cast<PassThroughSector*>( this )->mLastCalcFixedOutput, aPeriod );
+    mFixedOutputMarket->setPrice( fixedDemandActivityName, mRegionName, mLastCalcFixedOutput, aPeriod );
 }
 
 CalcFixedOutputActivity::CalcFixedOutputActivity( const PassThroughSector* aSector ):
@@ -196,6 +222,6 @@ void CalcFixedOutputActivity::calc( const int aPeriod ) {
 }
 
 string CalcFixedOutputActivity::getDescription() const {
-    return mSector->mRegionName + " " + mSector->getName() + "-fixed-output";
+    return mSector->mRegionName + " " + PassThroughSector::getFixedOutputMarketName( mSector->getName() );
 }
 
@@ -66,11 +66,13 @@
 #include "util/logger/include/logger.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/ivisitor.h"
+#include "util/base/include/scratch_array.h"
 #include "sectors/include/tran_subsector.h"
 #include "sectors/include/sector_utils.h"
 #include "functions/include/idiscrete_choice.hpp"
 #include "functions/include/discrete_choice_factory.hpp"
 #include "containers/include/market_dependency_finder.h"
+#include "util/base/include/atom_registry.h"
 
 using namespace std;
 using namespace xercesc;
@@ -85,7 +87,9 @@ extern Scenario* scenario;
 * \author Sonny Kim, Steve Smith, Josh Lurz
 */
 Sector::Sector( const string& aRegionName )
-    :mObjectMetaInfo()
+    :mObjectMetaInfo(),
+    mNameAtom( 0 ),
+    mRegionAtom( 0 )
 {
     mRegionName = aRegionName;
     mDiscreteChoiceModel = 0;
@@ -272,6 +276,12 @@ void Sector::completeInit( const IInfo* aRegionInfo, ILandAllocator* aLandAlloca
         abort();
     }
 
+    // Intern the names so that the sector's markets are found by Atom while
+    // the model is calculated.
+    objects::AtomRegistry* atomRegistry = objects::AtomRegistry::getInstance();
+    mNameAtom = atomRegistry->getAtom( mName );
+    mRegionAtom = atomRegistry->getAtom( mRegionName );
+
     // Allocate the sector info.
     // Do not reset if mSectorInfo contains information from derived sector classes.
     // This assumes that info from derived sector contains region info (parent).
@@ -369,17 +379,14 @@ void Sector::calcCosts( const int aPeriod ){
 *          here as they do not have a share of the new investment.
 * \param aGDP Regional GDP container.
 * \param aPeriod Model period.
-* \return A vector of normalized shares, one per subsector, ordered by subsector.
+* \param aShares Will hold the normalized shares, one per subsector, ordered by
+*                subsector.
 */
-const vector<double> Sector::calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const {
-    // Calculate unnormalized shares.
-    vector<double> subsecShares( mSubsectors.size() );
-    for( unsigned int i = 0; i < mSubsectors.size(); ++i ){
-        subsecShares[ i ] = mSubsectors[ i ]->calcShare( mDiscreteChoiceModel, aGDP, aPeriod );
-    }
-
-    // Normalize the shares.  After normalization they will be true shares, not log(shares).
-    pair<double, double> shareSum = SectorUtils::normalizeLogShares( subsecShares );
+void Sector::calcSubsectorShares( const GDP* aGDP, const int aPeriod, double* aShares ) const {
+    // Calculate the shares.  These will be true shares, not log(shares).
+    double* subsecShares = aShares;
+    pair<double, double> shareSum = Subsector::calcSubsectorShares( mSubsectors, mDiscreteChoiceModel,
+                                                                    aGDP, aPeriod, subsecShares );
     if( shareSum.first == 0.0 && !outputsAllFixed( aPeriod ) ){
         // This should no longer happen, but it's still technically possible.
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -404,9 +411,6 @@ const vector<double> Sector::calcSubsectorShares( const GDP* aGDP, const int aPe
         }
         subsecShares[ minPriceIndex ] = 1.0;        // ... except the lowest price
     }
-    /*! \post There is one share per subsector. */
-    assert( subsecShares.size() == subsec.size() );
-    return subsecShares;
 }
 
 /*! \brief Calculate and return weighted average price of subsectors.
@@ -417,7 +421,8 @@ const vector<double> Sector::calcSubsectorShares( const GDP* aGDP, const int aPe
 * \return Weighted sector price.
 */
 double Sector::getPrice( const GDP* aGDP, const int aPeriod ) const {
-    const vector<double>& subsecShares = calcSubsectorShares( aGDP, aPeriod );
+    ScratchArray subsecShares( mSubsectors.size() );
+    calcSubsectorShares( aGDP, aPeriod, subsecShares.data() );
     double sectorPrice = 0;
     double sumSubsecShares = 0;
     for ( unsigned int i = 0; i < mSubsectors.size(); ++i ){
@@ -488,7 +493,7 @@ bool Sector::outputsAllFixed( const int period ) const {
  * \return Total fixed output.
  */
 double Sector::getFixedOutput( const int aPeriod ) const {
-    const double sectorPrice = scenario->getMarketplace()->getPrice( mName, mRegionName, aPeriod );
+    const double sectorPrice = scenario->getMarketplace()->getPrice( mNameAtom, mRegionAtom, aPeriod );
     double totalfixedOutput = 0;
     for ( unsigned int i = 0; i < mSubsectors.size(); ++i ){
         totalfixedOutput += mSubsectors[ i ]->getFixedOutput( aPeriod, sectorPrice );
@@ -540,14 +545,16 @@ void Sector::postCalc( const int aPeriod ){
     }
     // Set member price vector to solved market prices
     if( aPeriod > 0 ){
-        mPrice[ aPeriod ] = scenario->getMarketplace()->getPrice( mName, mRegionName, aPeriod, true );
+        mPrice[ aPeriod ] = scenario->getMarketplace()->getPrice( mNameAtom, mRegionAtom, aPeriod, true );
     }
 }
 
 void Sector::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitSector( this, aPeriod );
-    for( unsigned int i = 0; i < mSubsectors.size(); i++ ) {
-        mSubsectors[ i ]->accept( aVisitor, aPeriod );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::SUBSECTORS ) ) {
+        for( unsigned int i = 0; i < mSubsectors.size(); i++ ) {
+            mSubsectors[ i ]->accept( aVisitor, aPeriod );
+        }
     }
     
     aVisitor->endVisitSector( this, aPeriod );
@@ -51,14 +51,19 @@
 #include "util/base/include/model_time.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/util.h"
+#include "util/base/include/fast_math.h"
+#include "util/base/include/atom.h"
+#include "util/base/include/atom_registry.h"
 
 using namespace std;
 
 extern Scenario* scenario; // for marketplace and modeltime.
 
 HashMap<std::string, std::string> SectorUtils::sTrialMarketNames;
+HashMap<const objects::Atom*, const objects::Atom*> SectorUtils::sTrialMarketAtoms;
 
 typedef HashMap<string, string>::const_iterator NameIterator;
+typedef HashMap<const objects::Atom*, const objects::Atom*>::const_iterator AtomIterator;
 
 /*!
  * \brief Create a trial market for the supply of a given good.
@@ -83,6 +88,9 @@ bool SectorUtils::createTrialSupplyMarket( const string& aRegionName,
     // Add the trial market name to the cached list of trial names.
     const string trialName = getTrialMarketName( aSectorName );
     sTrialMarketNames.insert( make_pair( aSectorName, trialName ) );
+    objects::AtomRegistry* atomRegistry = objects::AtomRegistry::getInstance();
+    sTrialMarketAtoms.insert( make_pair( atomRegistry->getAtom( aSectorName ),
+                                         atomRegistry->getAtom( trialName ) ) );
 
     // Create the additional market.
     Marketplace* marketplace = scenario->getMarketplace();
@@ -174,6 +182,71 @@ double SectorUtils::getTrialSupply( const string& aRegionName,
     return max( trialPrice, 0.0 );
 }
 
+/*!
+ * \brief Set the trial value of supply for a given sector given the Atoms of
+ *        the region and sector names.
+ * \details The same as addToTrialDemand for the names but neither finding the
+ *          trial market name nor the market compares strings.
+ * \param aRegionName Atom of the region of the market.
+ * \param aSectorName Atom of the name of the sector.
+ * \param aSupply Known value of supply for the iteration.
+ * \param aPeriod Model period.
+ */
+void SectorUtils::addToTrialDemand( const objects::Atom* aRegionName,
+                                    const objects::Atom* aSectorName,
+                                    const Value& aSupply,
+                                    const int aPeriod )
+{
+    // Market is not created until period 1.
+    if( aPeriod == 0 ){
+        return;
+    }
+
+    // Locate the trial market name.
+    AtomIterator trialName = sTrialMarketAtoms.find( aSectorName );
+    
+    // Check if the market existed.
+    assert( trialName != sTrialMarketAtoms.end() );
+
+    scenario->getMarketplace()->addToDemand( trialName->second, aRegionName, aSupply,
+                                             aPeriod, true );
+}
+
+/*!
+ * \brief Get the trial value of supply for a given sector given the Atoms of
+ *        the region and sector names.
+ * \details The same as getTrialSupply for the names but neither finding the
+ *          trial market name nor the market compares strings.
+ * \param aRegionName Atom of the region of the market.
+ * \param aSectorName Atom of the name of the sector.
+ * \param aPeriod Model period.
+ * \return Trial value of supply, -1 if the market does not exist.
+ */
+double SectorUtils::getTrialSupply( const objects::Atom* aRegionName,
+                                    const objects::Atom* aSectorName,
+                                    const int aPeriod )
+{
+    // Market is not created yet in period 0.
+    if( aPeriod == 0 ){
+        return -1;
+    }
+
+    // Locate the trial market name.
+    AtomIterator trialName = sTrialMarketAtoms.find( aSectorName );
+    
+    // Check if the market existed.
+    if( trialName == sTrialMarketAtoms.end() ){
+        return -1;
+    }
+
+    double trialPrice = scenario->getMarketplace()->getPrice( trialName->second,
+                                                              aRegionName, aPeriod );
+    
+    // The market should have existed if the trial market name search succeeded.
+    assert( trialPrice != Marketplace::NO_MARKET_PRICE );
+    return max( trialPrice, 0.0 );
+}
+
 /*!
  * \brief Calculate the scale factor used to reduce fixed output.
  * \details Calculates the scaling factor applied to fixed output in the sector
@@ -216,16 +289,37 @@ double SectorUtils::calcFixedOutputScaleFactor( const double aMarketDemand,
  *         calculations using these values in a numerically stable way.
  */
 pair<double, double> SectorUtils::normalizeLogShares( vector<double>& alogShares ){
+    return normalizeLogShares( alogShares.data(), alogShares.size() );
+}
+
+/*!
+ * \brief Normalize an array of log shares.
+ * \details The same as normalizeLogShares for a vector, for callers which keep
+ *          the shares in their own storage.  Each share is exponentiated only
+ *          once and the passes over the array are kept separate and free of
+ *          branches so that the compiler may vectorize them.
+ * \param aLogShares An array of logs of unnormalized shares on input, normalized
+ *                   shares (not logs) on output.
+ * \param aNumShares The number of shares in the array.
+ * \param aUseFastMath Whether to exponentiate with FastMath rather than libm.
+ * \return The unnormalized sum of the shares and a log(adjustment factor) that
+ *         has been factored out of the sum.
+ */
+pair<double, double> SectorUtils::normalizeLogShares( double* aLogShares, const size_t aNumShares,
+                                                      const bool aUseFastMath )
+{
     // find the log of the largest unnormalized share
-    double lfac = *max_element(alogShares.begin(), alogShares.end());
-    double sum = 0.0;
+    double lfac = -numeric_limits<double>::infinity();
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        lfac = max( lfac, aLogShares[ i ] );
+    }
     
     // check for all zero prices
     if( lfac == -numeric_limits<double>::infinity() ) {
         // In this case, set all shares to zero and return.
         // This is arguably wrong, but the rest of the code seems to expect it.
-        for( size_t i = 0; i < alogShares.size(); ++i ) {
-            alogShares[ i ] = 0.0;
+        for( size_t i = 0; i < aNumShares; ++i ) {
+            aLogShares[ i ] = 0.0;
         }
         return make_pair( 0.0, 0.0 );
     }
@@ -233,23 +327,36 @@ pair<double, double> SectorUtils::normalizeLogShares( vector<double>& alogShares
     // in theory we could check for lfac == +Inf here, but in light of how the log
     // shares are calculated, it would seem like that can't happen.
 
-    // rescale and get normalization sum
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] -= lfac;
-        sum += exp( alogShares[ i ] );
+    // rescale, unlog, and get normalization sum
+    if( aUseFastMath ) {
+        for( size_t i = 0; i < aNumShares; ++i ) {
+            aLogShares[ i ] = FastMath::exp( aLogShares[ i ] - lfac );
+        }
     }
-    double unnormAdjustedSum = sum;
-    double norm = log( sum );
-    sum = 0.0;                               // double check the normalization
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] = exp( alogShares[ i ] - norm );   // divide by norm constant and unlog
-        sum += alogShares[ i ];                      // accumulate sum of normalized shares 
-                                                     //   (should be 1.0 when we're done.)
+    else {
+        for( size_t i = 0; i < aNumShares; ++i ) {
+            aLogShares[ i ] = exp( aLogShares[ i ] - lfac );
+        }
     }
-    
-    // In actuality, this rescaling scheme should eliminate the problem of
-    // failed normalizations, but we'll allow for the possibility anyhow.
-    assert( sum < numeric_limits<double>::min() || util::isEqual( sum, 1.0 ) );
+    double unnormAdjustedSum = 0.0;
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        unnormAdjustedSum += aLogShares[ i ];
+    }
+
+    // the largest share is exp( 0 ) so the sum is at least one and the
+    // normalization can not fail
+    const double norm = 1.0 / unnormAdjustedSum;
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        aLogShares[ i ] *= norm;
+    }
+
+#ifndef NDEBUG
+    double sum = 0.0;                        // double check the normalization
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        sum += aLogShares[ i ];
+    }
+    assert( util::isEqual( sum, 1.0 ) );
+#endif
 
     return make_pair( unnormAdjustedSum, lfac );
 }
@@ -75,6 +75,7 @@
 #include "sectors/include/sector_utils.h"
 #include "investment/include/investment_utils.h"
 #include "util/base/include/interpolation_rule.h"
+#include "util/base/include/scratch_array.h"
 #include "functions/include/idiscrete_choice.hpp"
 #include "functions/include/discrete_choice_factory.hpp"
 
@@ -373,6 +374,11 @@ void Subsector::completeInit( const IInfo* aSectorInfo,
     }
 
     mSubsectorInfo.reset( InfoFactory::constructInfo( aSectorInfo, mRegionName + "-" + mSectorName + "-" + mName ) );
+
+    // Resolve the share weight interpolation rules to model periods.
+    for( CInterpRuleIterator ruleIt = mShareWeightInterpRules.begin(); ruleIt != mShareWeightInterpRules.end(); ++ruleIt ) {
+        (*ruleIt)->completeInit();
+    }
     
     for( unsigned int i = 0; i < baseTechs.size(); i++) {
         baseTechs[i]->completeInit( mRegionName, mSectorName, mName );
@@ -510,7 +516,8 @@ void Subsector::initCalc( NationalAccount* aNationalAccount,
 double Subsector::getPrice( const GDP* aGDP, const int aPeriod ) const {
     double subsectorPrice = 0.0; // initialize to 0 for summing
     double sharesum = 0.0;
-    const vector<double>& techShares = calcTechShares( aGDP, aPeriod );
+    ScratchArray techShares( mTechContainers.size() );
+    calcTechShares( aGDP, aPeriod, techShares.data() );
     for ( unsigned int i = 0; i < mTechContainers.size(); ++i ) {
         double currCost = mTechContainers[i]->getNewVintageTechnology(aPeriod)->getCost( aPeriod );
         // calculate weighted average price for Subsector.
@@ -571,7 +578,8 @@ double Subsector::getAverageFuelPrice( const GDP* aGDP, const int aPeriod ) cons
     // current period's are unknown.
     const int sharePeriod = ( aPeriod == 0 ) ? aPeriod : aPeriod - 1;
 
-    const vector<double>& techShares = calcTechShares( aGDP, sharePeriod );
+    ScratchArray techShares( mTechContainers.size() );
+    calcTechShares( aGDP, sharePeriod, techShares.data() );
     for ( unsigned int i = 0; i < mTechContainers.size(); ++i) {
         // calculate weighted average price of fuel only
         // Technology shares are based on total cost
@@ -589,12 +597,30 @@ double Subsector::getAverageFuelPrice( const GDP* aGDP, const int aPeriod ) cons
 * \author Marshall Wise, Josh Lurz
 * \param mRegionName region name
 * \param period model period
-* \return A vector of technology shares.
+* \param aShares Will hold the technology shares, one per technology.
 */
-const vector<double> Subsector::calcTechShares( const GDP* aGDP, const int aPeriod ) const {
-    vector<double> logTechShares ( mTechContainers.size() ); 
+void Subsector::calcTechShares( const GDP* aGDP, const int aPeriod, double* aShares ) const {
+    const size_t numTechs = mTechContainers.size();
+    double* logTechShares = aShares;
+
+    // Calculate all of the shares at once if each technology shares by the
+    // discrete choice function.
+    ScratchArray shareInputs( 3 * numTechs );
+    double* shareWeights = shareInputs.data();
+    double* costs = shareWeights + numTechs;
+    double* logShareAdjustments = costs + numTechs;
+    bool hasShareInputs = true;
+    for( unsigned int i = 0; i < numTechs && hasShareInputs; ++i ){
+        hasShareInputs = mTechContainers[ i ]->getNewVintageTechnology( aPeriod )->
+            getShareInputs( aGDP, aPeriod, shareWeights[ i ], costs[ i ], logShareAdjustments[ i ] );
+    }
+    if( hasShareInputs ) {
+        mDiscreteChoiceModel->calcShares( shareWeights, costs, logShareAdjustments,
+                                          logTechShares, numTechs, aPeriod );
+        return;
+    }
 
-    for( unsigned int i = 0; i < mTechContainers.size(); ++i ){
+    for( unsigned int i = 0; i < numTechs; ++i ){
         // determine shares based on Technology costs
         double lts = mTechContainers[ i ]->getNewVintageTechnology( aPeriod )->
             calcShare( mDiscreteChoiceModel, aGDP, aPeriod );
@@ -605,9 +631,7 @@ const vector<double> Subsector::calcTechShares( const GDP* aGDP, const int aPeri
     }
     // Normalize technology shares.  After normalization they will be
     // shares, not log(shares).
-    SectorUtils::normalizeLogShares( logTechShares );
-
-    return logTechShares;
+    SectorUtils::normalizeLogShares( logTechShares, numTechs );
 }
 
 /*!
@@ -628,6 +652,99 @@ void Subsector::calcCost( const int aPeriod ){
     }
 }
 
+/*!
+ * \brief Get the terms from which the discrete choice function calculates the
+ *        unnormalized subsector share.
+ * \details This allows the containing sector to calculate the shares of all of
+ *          its subsectors at once, see calcSubsectorShares.  The share is the
+ *          same as calcShare would give: a subsector without a valid price is
+ *          given a share weight of zero and the fuel preference elasticity is
+ *          returned as the log share adjustment.
+ * \param aGDP gdp object
+ * \param aPeriod model period
+ * \param aShareWeight The share weight.
+ * \param aPrice The price to share on.
+ * \param aLogShareAdjustment A term to add to the log of the unnormalized share.
+ * \return Whether the share is given by these terms, if not calcShare must be
+ *         used instead.
+ */
+bool Subsector::getShareInputs( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                double& aPrice, double& aLogShareAdjustment ) const
+{
+    getShareInputsAtPrice( getPrice( aGDP, aPeriod ), aGDP, aPeriod, aShareWeight,
+                           aPrice, aLogShareAdjustment );
+    return true;
+}
+
+/*!
+ * \brief Get the terms from which the discrete choice function calculates the
+ *        unnormalized subsector share given the subsector price.
+ * \details This is getShareInputs for a price which has already been
+ *          calculated, as a NestingSubsector does for its nested subsectors.
+ * \param aSubsectorPrice The price of the subsector, as getPrice would return.
+ * \param aGDP gdp object
+ * \param aPeriod model period
+ * \param aShareWeight The share weight.
+ * \param aPrice The price to share on.
+ * \param aLogShareAdjustment A term to add to the log of the unnormalized share.
+ */
+void Subsector::getShareInputsAtPrice( const double aSubsectorPrice, const GDP* aGDP, const int aPeriod,
+                                       double& aShareWeight, double& aPrice, double& aLogShareAdjustment ) const
+{
+    aPrice = aSubsectorPrice;
+    aShareWeight = mShareWeights[ aPeriod ];
+    if( boost::math::isnan( aPrice ) ) {
+        // Check for a NaN sentinel value.  If we find it, set the
+        // subsector's share to zero.
+        aPrice = 0.0;
+        aShareWeight = 0.0;
+    }
+
+    double scaledGdpPerCapita = aGDP->getBestScaledGDPperCap( aPeriod );
+    assert( scaledGdpPerCapita > 0.0 );
+    aLogShareAdjustment = mFuelPrefElasticity[ aPeriod ] * log( scaledGdpPerCapita );
+}
+
+/*!
+ * \brief Calculate the normalized shares of a set of subsectors.
+ * \details The shares are calculated all at once by the discrete choice
+ *          function if each subsector shares by it, otherwise each subsector's
+ *          calcShare is used.
+ * \param aSubsectors The subsectors competing for a share.
+ * \param aChoiceFn The discrete choice function of the containing sector or nest.
+ * \param aGDP gdp object
+ * \param aPeriod model period
+ * \param aShares Will hold the normalized shares, one per subsector.
+ * \return The unnormalized sum of the shares and the log factor that was
+ *         factored out of it as returned by SectorUtils::normalizeLogShares.
+ */
+pair<double, double> Subsector::calcSubsectorShares( const vector<Subsector*>& aSubsectors,
+                                                     const IDiscreteChoice* aChoiceFn,
+                                                     const GDP* aGDP,
+                                                     const int aPeriod,
+                                                     double* aShares )
+{
+    const size_t numSubsectors = aSubsectors.size();
+    ScratchArray shareInputs( 3 * numSubsectors );
+    double* shareWeights = shareInputs.data();
+    double* prices = shareWeights + numSubsectors;
+    double* logShareAdjustments = prices + numSubsectors;
+    bool hasShareInputs = true;
+    for( unsigned int i = 0; i < numSubsectors && hasShareInputs; ++i ){
+        hasShareInputs = aSubsectors[ i ]->getShareInputs( aGDP, aPeriod, shareWeights[ i ],
+                                                           prices[ i ], logShareAdjustments[ i ] );
+    }
+    if( hasShareInputs ) {
+        return aChoiceFn->calcShares( shareWeights, prices, logShareAdjustments,
+                                      aShares, numSubsectors, aPeriod );
+    }
+
+    for( unsigned int i = 0; i < numSubsectors; ++i ){
+        aShares[ i ] = aSubsectors[ i ]->calcShare( aChoiceFn, aGDP, aPeriod );
+    }
+    return SectorUtils::normalizeLogShares( aShares, numSubsectors );
+}
+
 /*! \brief calculate Subsector unnormalized shares 
  * \details Calculates the unormalized share using the discrete choice function
  *          set in the Sector nested above.
@@ -759,7 +876,8 @@ void Subsector::setOutput( const double aSubsectorVariableDemand,
     assert( util::isValidNumber( aSubsectorVariableDemand ) && aSubsectorVariableDemand >= 0 );
     
     // Calculate the technology shares.
-    const vector<double>& shares = calcTechShares( aGDP, aPeriod );
+    ScratchArray shares( mTechContainers.size() );
+    calcTechShares( aGDP, aPeriod, shares.data() );
     for( TechIterator techIter = mTechContainers.begin(); techIter != mTechContainers.end(); ++techIter ) {
         ITechnologyContainer::TechRangeIterator vintageIter = (*techIter)->getVintageBegin( aPeriod );
         
@@ -1042,11 +1160,11 @@ double Subsector::getCapitalOutputRatio( const IDistributor* aDistributor,
 * \param aPeriod Period to operate in.
 */
 void Subsector::operate( NationalAccount& aNationalAccount, const Demographic* aDemographic, const MoreSectorInfo* aMoreSectorInfo, const bool isNewVintageMode, const int aPeriod ){
-    const Modeltime* modeltime = scenario->getModeltime();
+    const int currYear = scenario->getModeltime()->getper_to_yr( aPeriod );
     typedef vector<BaseTechnology*>::iterator BaseTechIterator;
     for( BaseTechIterator currTech = baseTechs.begin(); currTech != baseTechs.end(); ++currTech ){
         // SHK only operate for technology vintages up to current period
-        if ( (*currTech)->getYear() <= modeltime->getper_to_yr( aPeriod ) ){
+        if ( (*currTech)->getYear() <= currYear ){
             (*currTech)->operate( aNationalAccount, aDemographic, aMoreSectorInfo, mRegionName, mSectorName, isNewVintageMode, aPeriod );
         }
     }
@@ -1086,6 +1204,10 @@ void Subsector::postCalc( const int aPeriod ){
 
 void Subsector::accept( IVisitor* aVisitor, const int period ) const {
     aVisitor->startVisitSubsector( this, period );
+    if( !aVisitor->shouldVisitChildren() || !aVisitor->visitsContent( IVisitor::TECHNOLOGIES ) ) {
+        aVisitor->endVisitSubsector( this, period );
+        return;
+    }
     const Modeltime* modeltime = scenario->getModeltime();
     if( period == -1 ){
         // Output all techs.
@@ -53,6 +53,7 @@
 #include "util/logger/include/ilogger.h"
 #include "marketplace/include/imarket_type.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/scratch_array.h"
 #include "containers/include/iinfo.h"
 #include "sectors/include/sector_utils.h"
 
@@ -273,7 +274,8 @@ void SupplySector::supply( const GDP* aGDP, const int aPeriod ) {
 
 	// Calculate the demand for new investment.
 	double newInvestment = max( marketDemand - fixedOutput, 0.0 );
-	const vector<double>& subsecShares = calcSubsectorShares( aGDP, aPeriod );
+	ScratchArray subsecShares( mSubsectors.size() );
+	calcSubsectorShares( aGDP, aPeriod, subsecShares.data() );
 
 	// This is where subsector and technology outputs are set
 	for( unsigned int i = 0; i < mSubsectors.size(); ++i ){
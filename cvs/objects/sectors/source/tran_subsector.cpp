@@ -296,8 +296,10 @@ void TranSubsector::accept( IVisitor* aVisitor, const int period ) const {
     aVisitor->startVisitSubsector( this, period );
     aVisitor->startVisitTranSubsector( this, period );
 
-    for( CTechIterator techIter = mTechContainers.begin(); techIter != mTechContainers.end(); ++techIter ) {
-        (*techIter)->accept( aVisitor, period );
+    if( aVisitor->shouldVisitChildren() && aVisitor->visitsContent( IVisitor::TECHNOLOGIES ) ) {
+        for( CTechIterator techIter = mTechContainers.begin(); techIter != mTechContainers.end(); ++techIter ) {
+            (*techIter)->accept( aVisitor, period );
+        }
     }
 	
     aVisitor->endVisitTranSubsector( this,  period );
@@ -100,31 +100,19 @@ void WindBackupCalculator::initCalc( const IInfo* aTechInfo ) {
     // No information needs to be passed in
 }
 
-double WindBackupCalculator::getAverageBackupCapacity( const string& aSector,
-                                                       const string& aElectricSector,
-                                                       const string& aResource,
-                                                       const string& aRegion,
+double WindBackupCalculator::getAverageBackupCapacity( const BackupInputs& aInputs,
                                                        const double aTechCapacityFactor,
                                                        const double aReserveMargin,
-                                                       const double aAverageGridCapacityFactor,
-                                                       const int aPeriod ) const
+                                                       const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
-    assert( !aSector.empty() );
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
     assert( aReserveMargin >= 0 );
     assert( aAverageGridCapacityFactor > 0 );
     
-    double backupFraction = getBackupCapacityFraction( aSector,
-                                                       aElectricSector,
-                                                       aResource,
-                                                       aRegion,
+    double backupFraction = getBackupCapacityFraction( aInputs,
                                                        aTechCapacityFactor,
                                                        aReserveMargin,
-                                                       aAverageGridCapacityFactor,
-                                                       aPeriod );
+                                                       aAverageGridCapacityFactor );
     
     // This is confusing but mathematically correct.  The backupCapacityFraction is in units of 
     // GW per GW.  The denominator (intermittent sector capacity GW) needs to be converted to energy,
@@ -135,20 +123,12 @@ double WindBackupCalculator::getAverageBackupCapacity( const string& aSector,
     return backupFraction;
 }
 
-double WindBackupCalculator::getMarginalBackupCapacity( const string& aSector,
-                                                        const string& aElectricSector,
-                                                        const string& aResource,
-                                                        const string& aRegion,
+double WindBackupCalculator::getMarginalBackupCapacity( const BackupInputs& aInputs,
                                                         const double aTechCapacityFactor,
                                                         const double aReserveMargin,
-                                                        const double aAverageGridCapacityFactor,
-                                                        const int aPeriod ) const
+                                                        const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
-    assert( !aSector.empty() );
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
     assert( aReserveMargin >= 0 );
     assert( aAverageGridCapacityFactor > 0 );
     
@@ -156,8 +136,8 @@ double WindBackupCalculator::getMarginalBackupCapacity( const string& aSector,
     const double HOURS_PER_YEAR = 8760;
     const double UC = 1 / (EJ_PER_GWH * HOURS_PER_YEAR); // [GWe/EJ]
 
-    double variance = SectorUtils::getVariance( aResource, aRegion, aPeriod );
-    double trialCapacityShare = SectorUtils::getTrialSupply( aRegion, aSector, aPeriod )
+    double variance = aInputs.mResourceVariance;
+    double trialCapacityShare = aInputs.mTrialShare
                               * ( aAverageGridCapacityFactor / aTechCapacityFactor );
     
     // Compute terms for Winds operating reserve due to intermittency formula
@@ -180,32 +160,19 @@ double WindBackupCalculator::getMarginalBackupCapacity( const string& aSector,
  *          intermittent capacity, then convert to backup capacity as fraction
  *          of wind resource output in energy terms, since that is what the
  *          model and market are based on.
- * \param aSector The name of the sector which requires backup capacity.
- * \param aElectricSector The name of the electricity sector into which the
- *        sector having a backup amount calculated for will feed.
- * \param aResource The name of the resource the sector consumes.
- * \param aRegion Name of the containing region.
+ * \param aInputs The trial values the backup depends on.
  * \param aReserveMargin Reserve margin for the electricity sector.
  * \param aAverageGridCapacityFactor The average electricity grid capacity
  *        factor.
- * \param aPeriod Model period.
  * \return Percent of reserve capacity per unit of intermittent capacity (e.g.,
  *         GW/GW).
  */
-double WindBackupCalculator::getBackupCapacityFraction( const string& aSector,
-                                                        const string& aElectricSector,
-                                                        const string& aResource,
-                                                        const string& aRegion,
+double WindBackupCalculator::getBackupCapacityFraction( const BackupInputs& aInputs,
                                                         const double aTechCapacityFactor,
                                                         const double aReserveMargin,
-                                                        const double aAverageGridCapacityFactor,
-                                                        const int aPeriod ) const
+                                                        const double aAverageGridCapacityFactor ) const
 {
     // Preconditions
-    assert( !aSector.empty() );
-    assert( !aElectricSector.empty() );
-    assert( !aResource.empty() );
-    assert( !aRegion.empty() );
     assert( aReserveMargin >= 0 );
     assert( aAverageGridCapacityFactor > 0 );
 
@@ -213,8 +180,8 @@ double WindBackupCalculator::getBackupCapacityFraction( const string& aSector,
     const double HOURS_PER_YEAR = 8760;
     const double UC = 1 / (EJ_PER_GWH * HOURS_PER_YEAR); // [GWe/EJ]
 
-    double variance = SectorUtils::getVariance( aResource, aRegion, aPeriod );
-    double trialCapacityShare = SectorUtils::getTrialSupply( aRegion, aSector, aPeriod )
+    double variance = aInputs.mResourceVariance;
+    double trialCapacityShare = aInputs.mTrialShare
                               * ( aAverageGridCapacityFactor / aTechCapacityFactor );
 
     // Compute terms for Winds operating reserve due to intermittency formula
@@ -68,6 +68,9 @@ public:
     virtual void init();
     virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
     virtual const std::string& getXMLName() const;
+    virtual bool isBracketing() const {
+        return true;
+    }
 
     // IParsable methods
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
@@ -84,6 +87,10 @@ protected:
 
     //! Max iterations for bracketing
     unsigned int mMaxBracketIterations;
+
+    //! Whether to bracket each market independently, holding the others fixed,
+    //! which allows the searches to run concurrently.
+    bool mUseIndependentBracket;
     
     //! A filter which will be used to determine which SolutionInfos this solver component
     //! will work on.
@@ -68,6 +68,9 @@ public:
     virtual void init();
     virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
     virtual const std::string& getXMLName() const;
+    virtual bool isBracketing() const {
+        return true;
+    }
     
     // IParsable methods
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
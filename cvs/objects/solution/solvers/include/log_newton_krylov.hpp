@@ -0,0 +1,160 @@
+#ifndef LOG_NEWTON_KRYLOV_HPP_
+#define LOG_NEWTON_KRYLOV_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file log_newton_krylov.hpp
+* \ingroup objects
+* \brief Header file for the Jacobian-free Newton-Krylov solver component
+*/
+#include <string>
+#include <boost/numeric/ublas/vector.hpp>
+#include "solution/solvers/include/solver_component.h"
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/functor.hpp"
+
+#define UBLAS boost::numeric::ublas
+
+class CalcCounter; 
+class Marketplace;
+class World;
+class SolutionInfoSet;
+
+/*! 
+* \ingroup Objects 
+* \brief A SolverComponent based on a Jacobian-free Newton-Krylov
+*        algorithm, using logarithmic values.
+* \details Each Newton step is found by solving J*dx = -F with
+*          restarted GMRES.  The Jacobian is never formed; GMRES only
+*          needs the products J*v, which are approximated with a
+*          directional finite difference (F(x+h*v) - F(x)) / h, one
+*          model evaluation apiece.  The step is then globalized with
+*          the same backtracking line search as the other log-space
+*          solvers.  Since the cost of an iteration scales with the
+*          number of Krylov vectors rather than with the number of
+*          markets, this is intended for configurations with too many
+*          solvable markets for a dense finite difference Jacobian.
+*
+*          The tolerance on the linear solve follows a forcing term:
+*          GMRES stops when ||J*dx + F|| <= eta*||F||.  With
+*          adaptive-forcing eta is chosen by the Eisenstat-Walker
+*          formula, so early steps are solved loosely and the
+*          tolerance tightens as F converges.
+*
+*          <b>XML specification for LogNewtonKrylov</b>
+*          - XML name: \c log-newton-krylov-solver-component
+*          - Contained by: UserConfigurableSolver
+*          - Parsing inherited from class: None
+*          - Elements:
+*              - \c max-iterations mMaxIter
+*              - \c ftol mFTOL
+*              - \c krylov-dimension mKrylovDim
+*              - \c max-restarts mMaxRestarts
+*              - \c forcing-term mEta
+*              - \c adaptive-forcing mAdaptiveForcing
+*              - \c linear-price / \c log-price mLogPricep
+*              - \c solution-info-filter (or any filter element) mSolutionInfoFilter
+*/
+class LogNewtonKrylov: public SolverComponent {
+public:
+    LogNewtonKrylov( Marketplace* mktplc, World* world, CalcCounter* ccounter, int itmax=250,
+                     double ftol=1.0e-4 ) : SolverComponent(mktplc,world,ccounter),
+                                            mMaxIter(itmax), mFTOL(ftol), mKrylovDim(30),
+                                            mMaxRestarts(2), mEta(0.1), mAdaptiveForcing(false),
+                                            mLogPricep(true) {}
+    virtual ~LogNewtonKrylov() {}
+    
+    // SolverComponent methods
+    virtual void init() {
+        if(!mSolutionInfoFilter.get())
+            mSolutionInfoFilter.reset(new SolvableNRSolutionInfoFilter());
+    }
+    virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
+    virtual const std::string& getXMLName() const {return SOLVER_NAME;}
+    
+    // IParsable methods
+    virtual bool XMLParse( const xercesc::DOMNode* aNode );
+
+    static const std::string & getXMLNameStatic(void) {return SOLVER_NAME;}
+  
+protected:
+    int nksolve(VecFVec<double,double> &F, UBLAS::vector<double> &x,
+                UBLAS::vector<double> &fx, int &neval);
+    int gmres(VecFVec<double,double> &F, const UBLAS::vector<double> &x,
+              const UBLAS::vector<double> &fx, const double aEta,
+              UBLAS::vector<double> &dx, double &aResid, int &neval);
+    void jacvec(VecFVec<double,double> &F, const UBLAS::vector<double> &x,
+                const UBLAS::vector<double> &fx, const UBLAS::vector<double> &v,
+                UBLAS::vector<double> &jv, int &neval);
+
+    //! Max iterations for the Newton algorithm 
+    unsigned int mMaxIter;
+  
+    //! Tolerance for convergence test in root-finding algorithm. 
+    //! \warning The SolutionInfo class has its own convergence
+    //!          tolerance, which it uses to flag certain markets as
+    //!          unsolved.
+    double mFTOL;
+
+    //! Number of Krylov vectors GMRES builds before restarting
+    unsigned int mKrylovDim;
+
+    //! Number of GMRES restarts allowed per Newton step
+    unsigned int mMaxRestarts;
+
+    //! Forcing term: relative residual required of the linear solve
+    //! (the initial value when adaptive forcing is on)
+    double mEta;
+
+    //! flag indicating whether the forcing term should be updated with
+    //! the Eisenstat-Walker formula
+    bool mAdaptiveForcing;
+  
+    //! A filter which will be used to determine which SolutionInfos with solver component
+    //! will work on.
+    std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
+
+    bool mLogPricep;              //<! flag indicating whether we should work in price or log-price 
+
+private:
+    static std::string SOLVER_NAME;
+};
+
+#undef UBLAS
+
+#endif // LOG_NEWTON_KRYLOV_HPP_
@@ -94,6 +94,14 @@ protected:
     //! The default allowed jump in price for newton raphson, this may be overriden by a SolutionInfo
     double mDefaultMaxPriceChange;
     
+    //! The most iterations to take with one factorization of the derivatives
+    //! (chord method), 1 to recalculate them every iteration.
+    unsigned int mChordIterations;
+    
+    //! The ratio of the residual norm after a chord iteration to before it
+    //! above which the derivatives are recalculated for the next iteration.
+    double mChordRefreshRatio;
+    
     //! A filter which will be used to determine which SolutionInfos with solver component
     //! will work on.
     std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
@@ -46,6 +46,8 @@
  */
 
 #include <string>
+#include <vector>
+#include <map>
 #include <boost/numeric/ublas/matrix.hpp>
 #include "solution/util/include/solvable_nr_solution_info_filter.h"
 #include "solution/util/include/edfun.hpp"
@@ -83,7 +85,10 @@ public:
   LogBroyden(Marketplace *mktplc, World *world, CalcCounter *ccounter, int itmax=250,
              double ftol=1.0e-4) :
       SolverComponent(mktplc,world,ccounter), mMaxIter( itmax ), mFTOL( ftol ),
-      mLogPricep( true ) {}
+      mLogPricep( true ), mUseColumnGroups( false ), mUseJacobianCache( false ),
+      mMaxLUUpdates( 20 ), mSpeculativeSteps( 0 ), mIncrementalCalcThreshold( -1.0 ),
+      mBlockTriangular( false ), mMixedPrecision( false ), mSparseLU( false ),
+      mAdaptiveSteps( false ), mReducedAccuracyTol( -1.0 ), mSkipJacobianCache( false ) {}
   virtual ~LogBroyden() {}
 
   // SolverComponent methods
@@ -93,12 +98,17 @@ public:
   }
   virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
   virtual const std::string& getXMLName() const {return SOLVER_NAME;}
+  //! Compute the initial Jacobian afresh in the next solve rather than
+  //! seeding it from the cache.
+  virtual void clearCachedState() {mSkipJacobianCache = true;}
   
   // IParsable methods
   virtual bool XMLParse( const xercesc::DOMNode* aNode );
   
   static const std::string & getXMLNameStatic( void ) {return SOLVER_NAME;}
 
+  static void releaseCachedJacobians( const int aPeriod );
+
 protected:
   //! Perform the Broyden's method iterations.
   int bsolve(VecFVec<double,double> &F, UBLAS::vector<double> &x, UBLAS::vector<double> &fx,
@@ -107,6 +117,15 @@ protected:
   void reportVec(const std::string &aname, const UBLAS::vector<double> &av, const std::vector<int> &amktids,
                  const std::vector<bool> &aissolvable);
   void reportPSD(UBLAS::vector<double> &arptvec, const std::vector<int> &amktids, const std::vector<bool> &aissolvable);
+  //! Seed the initial Jacobian from the store of previously converged Jacobians.
+  bool loadCachedJacobian(const int aPeriod, const std::vector<std::string> &aMktNames,
+                          const LogEDFun &aF, UBMATRIX &aJ) const;
+  //! Save a converged Jacobian into the store for reuse in later periods or scenarios.
+  void saveCachedJacobian(const int aPeriod, const std::vector<std::string> &aMktNames,
+                          const LogEDFun &aF, const UBMATRIX &aJ) const;
+  //! Switch the model back to full accuracy and evaluate F(x) again if it was reduced.
+  bool restoreFullAccuracy(VecFVec<double,double> &F, const UBLAS::vector<double> &x,
+                           UBLAS::vector<double> &fx, int &neval);
 
   //! Maximum number of main-loop iterations for the root-finding algorithm
   unsigned int mMaxIter;
@@ -125,11 +144,65 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price
 
+  //! flag indicating whether finite-difference Jacobians should perturb
+  //! structurally independent groups of markets together
+  bool mUseColumnGroups;
+
+  //! flag indicating whether the initial Jacobian should be seeded from the
+  //! store of converged Jacobians rather than computed from scratch
+  bool mUseJacobianCache;
+
+  //! Maximum number of Broyden updates applied to the L-U factorization of
+  //! B before it is factored from scratch (0 to refactor every iteration)
+  unsigned int mMaxLUUpdates;
+
+  //! Number of step lengths to try concurrently when the line search has to
+  //! backtrack (0 or 1 to backtrack serially)
+  unsigned int mSpeculativeSteps;
+
+  //! Smallest price change for which a full evaluation recalculates the
+  //! dependencies of a market, with the other activities left as they were
+  //! (negative to always recalculate the entire model)
+  double mIncrementalCalcThreshold;
+
+  //! flag indicating whether the linear solve should first permute the
+  //! Jacobian to block triangular form and factor only the diagonal blocks
+  bool mBlockTriangular;
+
+  //! flag indicating whether the Jacobian should be factored in single
+  //! precision with the step refined to double precision
+  bool mMixedPrecision;
+
+  //! flag indicating whether the Jacobian should be factored in sparse form
+  //! when it is sparse enough
+  bool mSparseLU;
+
+  //! flag indicating whether each market should use its own finite
+  //! difference step, learned from its previous Jacobian columns
+  bool mAdaptiveSteps;
+
+  //! Largest |F(x)| for which the model is evaluated at full accuracy.  Above
+  //! it activities may approximate expensive refinements (negative to always
+  //! evaluate at full accuracy).
+  double mReducedAccuracyTol;
+
+  //! flag set by clearCachedState to compute the initial Jacobian of the
+  //! next solve by finite differences even if the cache is in use
+  bool mSkipJacobianCache;
+
   // These next two have to be class variables because we sometimes
   // have multiple logbroyden solvers operating.
   static int mLastPer;                 //<! used to detect when the period has changed, so we can reset mPerIter.
   static int mPerIter;                 //<! total iteration count within the period
 
+  //! The store of converged Jacobians keyed by the names of the solvable markets
+  //! (plus the price mode) and then by period.  The Jacobians are stored without
+  //! the input and output scaling of the period they were taken in.  This is
+  //! static so that it persists across periods and across scenarios run in the
+  //! same process.
+  typedef std::map<int, UBMATRIX> PeriodJacobianMap;
+  static std::map<std::vector<std::string>, PeriodJacobianMap> sJacobianStore;
+
 private:
   static std::string SOLVER_NAME;
 };
@@ -81,7 +81,10 @@ class LogNRbt: public SolverComponent {
 public:
     LogNRbt( Marketplace* mktplc, World* world, CalcCounter* ccounter, int itmax=250,
              double ftol=1.0e-7 ) : SolverComponent(mktplc,world,ccounter),
-                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true) {}
+                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true),
+                                    mSpeculativeSteps(0), mIncrementalCalcThreshold(-1.0),
+                                    mBlockTriangular(false), mMixedPrecision(false),
+                                    mSparseLU(false), mAdaptiveSteps(false) {}
     virtual ~LogNRbt() {}
     
     // SolverComponent methods
@@ -129,6 +132,31 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price 
 
+    //! Number of step lengths to try concurrently when the line search has to
+    //! backtrack (0 or 1 to backtrack serially)
+    unsigned int mSpeculativeSteps;
+
+    //! Smallest price change for which a full evaluation recalculates the
+    //! dependencies of a market, with the other activities left as they were
+    //! (negative to always recalculate the entire model)
+    double mIncrementalCalcThreshold;
+
+    //! flag indicating whether the linear solve should first permute the
+    //! Jacobian to block triangular form and factor only the diagonal blocks
+    bool mBlockTriangular;
+
+    //! flag indicating whether the Jacobian should be factored in single
+    //! precision with the step refined to double precision
+    bool mMixedPrecision;
+
+    //! flag indicating whether the Jacobian should be factored in sparse form
+    //! when it is sparse enough
+    bool mSparseLU;
+
+    //! flag indicating whether each market should use its own finite
+    //! difference step, learned from its previous Jacobian columns
+    bool mAdaptiveSteps;
+
 private:
     static std::string SOLVER_NAME;
 };
@@ -46,10 +46,12 @@
 * \author Robert Link
 */
 #include <string>
+#include <vector>
 
 class CalcCounter; 
 class Marketplace;
 class World;
+class SolutionInfo;
 class SolutionInfoSet;
 class ISolutionInfoFilter;
 
@@ -70,6 +72,9 @@ class ISolutionInfoFilter;
 *             until supply changes (probably a decrease) by at least 10% of
 *             its original value, or until demand > supply
 *
+*          Optionally the response of each market to its own price can then
+*          be probed, which is used to take a single damped step towards
+*          clearing each market and to set the demand normalization.
 *
 * \author Robert Link
 */
@@ -94,11 +99,19 @@ protected:
 
     double mLargePrice;         // default = 1e6
     double mFTOL;                // default = getSmallNumber()
+
+    //! Whether to probe the own price response of each market after the heuristics.
+    bool mProbeResponse;         // default = false
+    //! The relative price change to use when probing.
+    double mProbeDelta;          // default = 1e-4
+    //! The largest relative price change a probed step may make.
+    double mProbeMaxStep;        // default = 0.5
     
     //! A filter which will be used to determine which SolutionInfos this solver component
     //! will work on.
     std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
     
+    void probeResponses( std::vector<SolutionInfo>& aSolvable, const int aPeriod );
 };
 
 #endif // _PRECONDITIONER_HPP_
@@ -79,7 +79,8 @@ public:
         FAILURE_SINGULAR_MATRIX,
         FAILURE_ZERO_GRADIENT,
         FAILURE_POOR_PROGRESS,
-        FAILURE_UNKNOWN
+        FAILURE_UNKNOWN,
+        FAILURE_OVER_BUDGET
     };
    SolverComponent( Marketplace* marketplaceIn, World* worldIn, CalcCounter* calcCounterIn );
    virtual ~SolverComponent();
@@ -90,10 +91,26 @@ public:
 
    virtual const std::string& getXMLName() const = 0;
 
+   /*!
+    * \brief Discard any state cached between calls to solve, such as a
+    *        Jacobian, so that the next call starts afresh.
+    * \details The default implementation has no cached state.
+    */
+   virtual void clearCachedState() {}
+
+   /*!
+    * \brief Whether the component only takes bracketing (bisection) steps,
+    *        which are slow but robust, rather than Newton type steps.
+    */
+   virtual bool isBracketing() const {
+       return false;
+   }
+
 protected:
    Marketplace* marketplace; //<! The marketplace to solve. 
    World* world; //<! World to call calc on.
    CalcCounter* calcCounter; //<! Tracks the number of calls to world.calc
+   int mPeriod; //<! The period being solved, set by startMethod.
    
    //! A structure used to track maximum relative excess demand over many
    //! iterations.
@@ -111,7 +128,7 @@ protected:
    std::vector<IterationInfo> mPastIters;
    void addIteration( const std::string& aSolName, const double aRED );
    bool isImproving( const unsigned int aNumIter ) const;
-   void startMethod();
+   void startMethod( const int aPeriod );
 };
 
 #endif // _SOLVER_COMPONENT_H_
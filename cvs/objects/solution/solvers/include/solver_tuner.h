@@ -0,0 +1,202 @@
+#ifndef _SOLVER_TUNER_H_
+#define _SOLVER_TUNER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solver_tuner.h
+ * \ingroup Objects
+ * \brief SolverTuner class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+
+#include "util/base/include/iparsable.h"
+#include "util/base/include/state_snapshot.h"
+
+class World;
+class Marketplace;
+class Modeltime;
+class SolutionInfoParamParser;
+
+/*!
+ * \ingroup Objects
+ * \brief Searches the parameters of the solver configuration for the settings
+ *        which solve selected periods in the fewest model evaluations.
+ * \details The tuner is read from the configuration file solver-tuning-config
+ *          which has the form:
+ *          \code
+ *          <solver-tuning>
+ *              <telemetry-file>run1/solver-telemetry.csv</telemetry-file>
+ *              <num-periods>3</num-periods>
+ *              <year>2050</year>
+ *              <passes>2</passes>
+ *              <parameter component="broyden-solver-component" name="ftol">
+ *                  <value>1.0e-4</value>
+ *                  <value>1.0e-3</value>
+ *              </parameter>
+ *              <parameter name="max-model-calcs">
+ *                  <value>1500</value>
+ *              </parameter>
+ *          </solver-tuning>
+ *          \endcode
+ *          The periods tuned are those given by year plus the num-periods
+ *          periods which took the most model evaluations summed over the
+ *          solver telemetry files of earlier runs.  Each parameter names a
+ *          child element of the solver, or if component is given of the first
+ *          solver component of that name, and the values to try for it.  The
+ *          name enabled with the value 0 drops the component.
+ *
+ *          When the Scenario reaches a tuned period it calls run before the
+ *          period is solved.  Starting each time from the state the period
+ *          starts from, the solver from solver-config for that period is run
+ *          with one parameter at a time changed to each of its values, keeping
+ *          any change which solves in fewer evaluations, for the given number
+ *          of passes over the parameters.  The state is then restored so the
+ *          period solves as it would have otherwise.  To replay only the tuned
+ *          periods the run may be started from restart files with
+ *          restart-period.
+ *
+ *          After each tuned period the file solver-tuning-output is written as
+ *          a complete solver configuration: the solvers of solver-config with
+ *          the tuned solver for each tuned period added in year order, which
+ *          fills out until the next solver.
+ */
+class SolverTuner : public IParsable {
+public:
+    SolverTuner( World* aWorld, Marketplace* aMarketplace );
+    
+    ~SolverTuner();
+    
+    // IParsable methods
+    virtual bool XMLParse( const xercesc::DOMNode* aNode );
+    
+    void init( const Modeltime* aModeltime );
+    
+    bool shouldTune( const int aPeriod ) const;
+    
+    //! Whether a trial solve is in progress.
+    bool isRunning() const {
+        return mIsRunning;
+    }
+    
+    void run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser );
+    
+private:
+    //! A solver parameter to search over.
+    struct Parameter {
+        //! The solver component the parameter belongs to, or empty for the solver.
+        std::string mComponent;
+        
+        //! The name of the parameter element.
+        std::string mName;
+        
+        //! The values to try.
+        std::vector<std::string> mValues;
+    };
+    
+    //! The chosen settings for a tuned period.
+    struct TunedPeriod {
+        //! The model period.
+        int mPeriod;
+        
+        //! The index of the value chosen for each parameter, or -1 to keep the
+        //! setting of solver-config.
+        std::vector<int> mChoices;
+        
+        //! The model evaluations to solve with solver-config.
+        int mBaseEvaluations;
+        
+        //! The model evaluations to solve with the chosen settings.
+        int mEvaluations;
+    };
+    
+    //! The world to calculate.
+    World* mWorld;
+    
+    //! The marketplace to solve.
+    Marketplace* mMarketplace;
+    
+    //! The model time used to convert between periods and years.
+    const Modeltime* mModeltime;
+    
+    //! Solver telemetry files from which to choose the periods to tune.
+    std::vector<std::string> mTelemetryFiles;
+    
+    //! The number of periods with the most evaluations in the telemetry to tune.
+    int mNumPeriods;
+    
+    //! Years which should be tuned regardless of the telemetry.
+    std::vector<int> mYears;
+    
+    //! The maximum number of passes over the parameters.
+    int mNumPasses;
+    
+    //! The parameters to search over.
+    std::vector<Parameter> mParameters;
+    
+    //! The periods which will be tuned.
+    std::vector<int> mPeriods;
+    
+    //! The results of the periods tuned so far.
+    std::vector<TunedPeriod> mResults;
+    
+    //! The parsed solver-config which the trial solvers are made from.
+    xercesc::DOMDocument* mSolverConfig;
+    
+    //! The state the period being tuned starts from.
+    StateSnapshot mInitialState;
+    
+    //! Whether a trial solve is in progress.
+    bool mIsRunning;
+    
+    void selectPeriodsFromTelemetry();
+    
+    const xercesc::DOMNode* findSolverNode( const int aPeriod ) const;
+    
+    xercesc::DOMNode* createSolverNode( const int aPeriod, const std::vector<int>& aChoices ) const;
+    
+    int evaluate( const int aPeriod, const std::vector<int>& aChoices,
+                  const SolutionInfoParamParser* aSolutionInfoParamParser, bool& aSolved );
+    
+    void writeResults() const;
+};
+
+#endif // _SOLVER_TUNER_H_
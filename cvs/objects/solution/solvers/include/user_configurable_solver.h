@@ -74,10 +74,27 @@ class SolutionInfoParamParser;
  *                      The tolerance used for checking calibrated values when calibrating.
  *              - \c max-model-calcs int UserConfigurableSolver::mMaxModelCalcs
  *                      The maximum total number of iterations to try to find a solution.
+ *              - \c freeze-converged-iterations unsigned int UserConfigurableSolver::mFreezeIterations
+ *                      The number of consecutive solver component calls a market must stay
+ *                      well within tolerance before it is frozen out of the solvable set.
+ *                      Frozen markets are reactivated if they drift out of tolerance.  The
+ *                      default of 0 disables freezing.
+ *              - \c freeze-converged-fraction double UserConfigurableSolver::mFreezeFraction
+ *                      The fraction of the solution tolerance below which a market is
+ *                      considered well within tolerance.  Defaults to 0.1.
  *              - \c (any SolverComponent) vector<SolverComponent*> UserConfigurableSolver::mSolverComponents
  *                      Can be any solver component contained in SolverComponentFactory, each one
  *                      being added in order to the list of solver components to use.
  *
+ *          When a SolveBudget is configured each solver component is given an
+ *          equal share of what remains of the period's budget each time it is
+ *          called.  If a component runs over its share without solving the
+ *          model the solver escalates: first it clears the state the components
+ *          have cached so that they start afresh (e.g. with a finite difference
+ *          Jacobian), then it only calls the bracketing components and finally
+ *          it gives up so that Scenario::solve may try the retry solver.  It
+ *          also gives up as soon as the budget for the whole period is spent.
+ *
  * \author Pralit Patel
  */
 class UserConfigurableSolver: public Solver {
@@ -94,6 +111,22 @@ public:
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
     
 private:
+    //! The strategies tried in turn when a solver component runs over its
+    //! share of the solve budget.
+    enum Escalation {
+        //! Call every solver component as configured.
+        NONE,
+        //! Clear the cached state of the solver components and call them again.
+        FRESH_JACOBIAN,
+        //! Only call the bracketing solver components.
+        BRACKETING_ONLY,
+        //! Stop and report that the period did not solve.
+        GIVE_UP
+    };
+
+    Escalation escalate( const Escalation aCurrent, const SolverComponent* aComponent,
+                         const int aPeriod ) const;
+
     //! In order list of solver components to use when trying to solve.
     std::vector<SolverComponent*> mSolverComponents;
     
@@ -108,6 +141,14 @@ private:
     
     //! Max total solution iterations
     int mMaxModelCalcs;
+    
+    //! Number of consecutive solver component calls a market must stay well
+    //! within tolerance before it is frozen out of the solvable set (0 to disable)
+    unsigned int mFreezeIterations;
+    
+    //! Fraction of the solution tolerance which counts as well within tolerance
+    //! for freezing converged markets
+    double mFreezeFraction;
 };
 
 #endif // _USER_CONFIGURABLE_SOLVER_H_
@@ -57,6 +57,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solve_budget.h"
 
 #include "util/base/include/timer.h"
 
@@ -68,7 +69,8 @@ BisectAll::BisectAll( Marketplace* marketplaceIn, World* worldIn, CalcCounter* c
 mMaxIterations( 30 ),
 mDefaultBracketInterval( 0.4 ),
 mBracketTolerance( 1.0e-8 ),
-mMaxBracketIterations( 40 )
+mMaxBracketIterations( 40 ),
+mUseIndependentBracket( false )
 {
 }
 
@@ -118,6 +120,9 @@ bool BisectAll::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "max-bracket-iterations" ) {
             mMaxBracketIterations = XMLHelper<unsigned int>::getValue( curr );
         }
+        else if( nodeName == "independent-bracket" ) {
+            mUseIndependentBracket = XMLHelper<bool>::getValue( curr );
+        }
         else if( nodeName == "solution-info-filter" ) {
             mSolutionInfoFilter.reset(
                 SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
@@ -174,12 +179,18 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
     
     // need to do bracketing first, does this need to be before or after startMethod?
     aSolutionSet.resetBrackets();
-    solverLog << "Solution set before Bracket: " << endl << aSolutionSet << endl;
+    GCAM_SOLVER_LOG( solverLog, ILogger::NOTICE ) << "Solution set before Bracket: " << endl << aSolutionSet << endl;
     // Currently attempts to bracket but does not necessarily bracket all markets.
-    SolverLibrary::bracket( marketplace, world, mDefaultBracketInterval, mMaxBracketIterations,
-                            aSolutionSet, calcCounter, mSolutionInfoFilter.get(), aPeriod );
+    if( mUseIndependentBracket ) {
+        SolverLibrary::bracketIndependent( marketplace, world, mDefaultBracketInterval, mMaxBracketIterations,
+                                           aSolutionSet, calcCounter, mSolutionInfoFilter.get(), aPeriod );
+    }
+    else {
+        SolverLibrary::bracket( marketplace, world, mDefaultBracketInterval, mMaxBracketIterations,
+                                aSolutionSet, calcCounter, mSolutionInfoFilter.get(), aPeriod );
+    }
     
-    startMethod();
+    startMethod( aPeriod );
     ReturnCode code = ORIGINAL_STATE; // code that reports success 1 or failure 0
     
     worstMarketLog << "Policy All, X, XL, XR, ED, EDL, EDR, RED, bracketed, supply, demand" << endl;
@@ -201,7 +212,9 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
     do {
         solverLog.setLevel( ILogger::NOTICE );
         solverLog << "BisectionAll " << numIterations << endl;
-        aSolutionSet.printMarketInfo( "Bisect All", calcCounter->getPeriodCount(), singleLog );
+        if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+            aSolutionSet.printMarketInfo( "Bisect All", calcCounter->getPeriodCount(), singleLog );
+        }
 
         // Since bisection is called after bracketing, the current price and ED will be the
         // one of the brackets.
@@ -234,7 +247,7 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
         aSolutionSet.updateSolvable( mSolutionInfoFilter.get() );
 
         // Print solution set information to solver log.
-        solverLog << aSolutionSet << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::NOTICE ) << aSolutionSet << endl;
 
         // Move brackets, both price and ED, after solving mid-point.  This ensures that
         // both price and ED for each bracket is valid and up to date.
@@ -260,10 +273,16 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
         }
     } // end do loop        
     while ( ++numIterations <= mMaxIterations 
-            && !aSolutionSet.isAllSolved() && !areAllBracketsEqual( aSolutionSet ) );
+            && !aSolutionSet.isAllSolved() && !areAllBracketsEqual( aSolutionSet )
+            && !SolveBudget::getInstance().isComponentOverBudget() );
 
     // Set the return code. 
     code = ( aSolutionSet.isAllSolved() ? SUCCESS : FAILURE_ITER_MAX_REACHED ); // report success, or failure
+    if( code != SUCCESS && SolveBudget::getInstance().isComponentOverBudget() ) {
+        code = FAILURE_OVER_BUDGET;
+        solverLog.setLevel( ILogger::NOTICE );
+        solverLog << "Exiting BisectionAll because the solve budget is exhausted." << endl;
+    }
 
     bisectTimer.stop();
     
@@ -56,6 +56,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solve_budget.h"
 
 using namespace std;
 using namespace xercesc;
@@ -140,7 +141,7 @@ SolverComponent::ReturnCode BisectOne::solve( SolutionInfoSet& aSolutionSet, con
         return SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( aPeriod );
 
     // Setup logging.
     ILogger& solverLog = ILogger::getLogger( "solver_log" );
@@ -162,7 +163,9 @@ SolverComponent::ReturnCode BisectOne::solve( SolutionInfoSet& aSolutionSet, con
                                aSolutionSet, worstSol, calcCounter, mSolutionInfoFilter.get(), aPeriod );
     unsigned int numIterations = 0;
     do {
-        aSolutionSet.printMarketInfo( "Bisect One on " + worstSol->getName(), calcCounter->getPeriodCount(), singleLog );
+        if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+            aSolutionSet.printMarketInfo( "Bisect One on " + worstSol->getName(), calcCounter->getPeriodCount(), singleLog );
+        }
 
         // Move the right price bracket in if Supply > Demand
         if ( worstSol->getED() < 0 ) {
@@ -185,9 +188,13 @@ SolverComponent::ReturnCode BisectOne::solve( SolutionInfoSet& aSolutionSet, con
         solverLog << "BisectOneWorst-MaxRelED: " << *worstSol << endl;
     } // end do loop        
     while ( ( ++numIterations < mMaxIterations ) &&
-              !worstSol->isSolved() );
+              !worstSol->isSolved() && !SolveBudget::getInstance().isComponentOverBudget() );
     // Report results.
     solverLog.setLevel( ILogger::NOTICE );
+    if( !worstSol->isSolved() && SolveBudget::getInstance().isComponentOverBudget() ) {
+        solverLog << "Exiting BisectOne because the solve budget is exhausted." << endl;
+        return aSolutionSet.isAllSolved() ? SUCCESS : FAILURE_OVER_BUDGET;
+    }
     if( numIterations >= mMaxIterations ){
         solverLog << "Exiting BisectOne due to reaching max iterations." << endl;
     }
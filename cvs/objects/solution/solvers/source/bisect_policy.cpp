@@ -57,6 +57,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solve_budget.h"
 
 using namespace std;
 using namespace xercesc;
@@ -136,7 +137,7 @@ bool BisectPolicy::XMLParse( const DOMNode* aNode ) {
 * \param aPeriod Model period.
 */
 SolverComponent::ReturnCode BisectPolicy::solve( SolutionInfoSet& aSolutionSet, const int aPeriod ) {
-    startMethod();
+    startMethod( aPeriod );
 
     // If all markets are solved, then return with success code.
     if( aSolutionSet.isAllSolved() ){
@@ -166,7 +167,9 @@ SolverComponent::ReturnCode BisectPolicy::solve( SolutionInfoSet& aSolutionSet,
                                    aSolutionSet, worstSol, calcCounter, mSolutionInfoFilter.get(), aPeriod );
         if( !worstSol->isSolved() ){
             do {
-                aSolutionSet.printMarketInfo( "BisectPolicy on " + worstSol->getName(), calcCounter->getPeriodCount(), singleLog );
+                if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+                    aSolutionSet.printMarketInfo( "BisectPolicy on " + worstSol->getName(), calcCounter->getPeriodCount(), singleLog );
+                }
 
                 // Move the right price bracket in if Supply > Demand
                 if ( worstSol->getED() < 0 ) {
@@ -195,11 +198,16 @@ SolverComponent::ReturnCode BisectPolicy::solve( SolutionInfoSet& aSolutionSet,
             } // end do loop        
             while ( isImproving( MAX_ITER_NO_IMPROVEMENT ) &&
                 ( ++numIterations < mMaxIterations ) &&
-                !worstSol->isWithinTolerance() );
+                !worstSol->isWithinTolerance() &&
+                !SolveBudget::getInstance().isComponentOverBudget() );
         }
     }
     // Report results.
     solverLog.setLevel( ILogger::NOTICE );
+    if( !aSolutionSet.isAllSolved() && SolveBudget::getInstance().isComponentOverBudget() ) {
+        solverLog << "Exiting BisectPolicy because the solve budget is exhausted." << endl;
+        return FAILURE_OVER_BUDGET;
+    }
     if( numIterations >= mMaxIterations ){
         solverLog << "Exiting BisectPolicy due to reaching max iterations." << endl;
     }
@@ -166,7 +166,9 @@ bool BisectPolicyNRSolver::solve( const int aPeriod, const SolutionInfoParamPars
 
     ILogger& singleLog = ILogger::getLogger( "single_market_log" );
     mainLog.setLevel( ILogger::DEBUG );
-    sol.printMarketInfo( "Begin Solve", mCalcCounter->getPeriodCount(), singleLog );
+    if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+        sol.printMarketInfo( "Begin Solve", mCalcCounter->getPeriodCount(), singleLog );
+    }
     
     // if no markets to solve, break out of solution.
     if ( sol.getNumSolvable() == 0 ){
@@ -187,7 +189,7 @@ bool BisectPolicyNRSolver::solve( const int aPeriod, const SolutionInfoParamPars
     solverLog << "Solution Information Initialized: Left and Right values are the same." << endl;
     
     solverLog.setLevel( ILogger::DEBUG );
-    solverLog << sol << endl;
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
 
     // Loop is done at least once.
     do {
@@ -195,7 +197,7 @@ bool BisectPolicyNRSolver::solve( const int aPeriod, const SolutionInfoParamPars
         solverLog << "Solution() loop. N: " << mCalcCounter->getPeriodCount() << endl;
         solverLog.setLevel( ILogger::DEBUG );
         solverLog << "Solution before BisectPolicy: " << endl;
-        solverLog << sol << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
         
         // Bisect the policy market or the worst market if the policy market is non-existant.
         sol.unsetBisectedFlag();
@@ -203,14 +205,14 @@ bool BisectPolicyNRSolver::solve( const int aPeriod, const SolutionInfoParamPars
 
         solverLog.setLevel( ILogger::DEBUG );
         solverLog << "Solution before NewtonRaphson: " << endl;
-        solverLog << sol << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
 
         // Call mLogNewtonRaphson. Ignore return code because it may have skipped singular markets.
         mLogNewtonRaphson->solve( sol, aPeriod );
 
         solverLog.setLevel( ILogger::DEBUG );
         solverLog << "After NewtonRaphson " << mCalcCounter->getPeriodCount() << endl;
-        solverLog << sol << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
 
         if( !sol.isAllSolved() ){
             unsigned int count = 0;
@@ -225,14 +227,14 @@ bool BisectPolicyNRSolver::solve( const int aPeriod, const SolutionInfoParamPars
 
         solverLog.setLevel( ILogger::DEBUG );
         solverLog << "Solution before NewtonRaphson: " << endl;
-        solverLog << sol << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
         if( !sol.isAllSolved() ){
             // Call mLogNewtonRaphson. Ignore return code because it may have skipped singular markets.
             mLogNewtonRaphson->solve( sol, aPeriod );
         }
         solverLog.setLevel( ILogger::DEBUG );
         solverLog << "After NewtonRaphson " << mCalcCounter->getPeriodCount() << endl;
-        solverLog << sol << endl;
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << sol << endl;
     // Determine if the model has solved. 
     } while ( !sol.isAllSolved() && mCalcCounter->getPeriodCount() < mMaxModelCalcs );
     
@@ -0,0 +1,478 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file log_newton_krylov.cpp
+* \ingroup objects
+* \brief LogNewtonKrylov (Jacobian-free Newton-Krylov) class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+
+#include "solution/solvers/include/solver_component.h"
+#include "solution/solvers/include/log_newton_krylov.hpp"
+#include "solution/util/include/calc_counter.h"
+#include "marketplace/include/marketplace.h"
+#include "containers/include/world.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/solution_info.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/xml_helper.h"
+#include "solution/util/include/solution_info_filter_factory.h"
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+
+#include "solution/util/include/functor-subs.hpp"
+#include "solution/util/include/linesearch.hpp"
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/ublas-helpers.hpp"
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+
+#include "util/base/include/timer.h"
+
+using namespace std;
+using namespace xercesc;
+
+std::string LogNewtonKrylov::SOLVER_NAME = "log-newton-krylov-solver-component";
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+namespace {
+  // helper functions for the std::transform algorithm
+  double SI2lgprice (const SolutionInfo &si) {return log(si.getPrice());}
+  double SI2price (const SolutionInfo &si) {return si.getPrice();}
+}
+
+bool LogNewtonKrylov::XMLParse( const DOMNode* aNode ) {
+    // assume we were passed a valid node.
+    assert( aNode );
+    
+    // get the children of the node.
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    
+    // loop through the children
+    for ( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        DOMNode* curr = nodeList->item( i );
+        string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+        
+        if( nodeName == "#text" ) {
+            continue;
+        }
+        else if( nodeName == "max-iterations" ) {
+            mMaxIter = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "ftol" ) {
+            mFTOL = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "krylov-dimension" ) {
+            mKrylovDim = max( XMLHelper<unsigned int>::getValue( curr ), 1u );
+        }
+        else if( nodeName == "max-restarts" ) {
+            mMaxRestarts = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "forcing-term" ) {
+            mEta = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "adaptive-forcing" ) {
+            mAdaptiveForcing = true;
+        }
+        else if( nodeName == "solution-info-filter" ) {
+            mSolutionInfoFilter.reset(
+                SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
+        }
+        else if(nodeName == "linear-price") {
+          mLogPricep = false;
+        }
+        else if(nodeName == "log-price") {
+          mLogPricep = true;    // not strictly necessary, as this is the default.
+        } 
+        else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
+            mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing "
+                << getXMLName() << "." << endl;
+        }
+    }
+    return true;
+}
+
+/*! \brief Jacobian-free Newton-Krylov solver in log-log space
+ * \details Attempts to solve the selected markets using Newton's
+ *          method with the linear system for each step solved by
+ *          GMRES, working in log-log space like LogNRbt.  Most of the
+ *          work is done by nksolve(); this function sets up the
+ *          structures necessary to call it and translates the result.
+ * \param solnset An initial set of SolutionInfo objects representing all markets which can be filtered.
+ * \param period Model period.
+ * \return A status code to indicate if the algorithm was successful or not.
+ */
+SolverComponent::ReturnCode LogNewtonKrylov::solve( SolutionInfoSet& solnset, int period ) {
+    ReturnCode code = SolverComponent::ORIGINAL_STATE;
+
+    // If all markets are solved, then return with success code.
+    if( solnset.isAllSolved() ){
+        return code = SolverComponent::SUCCESS;
+    }
+
+    startMethod( period );
+    
+    // Update the solution vector for the correct markets to solve.
+    // Need to update solvable status before starting solution (Ignore return code)
+    solnset.updateSolvable( mSolutionInfoFilter.get() );
+
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << "Beginning Newton-Krylov solution for period " << period
+              << ".  Solving " << solnset.getNumSolvable() << " markets.\n";
+    ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
+    worstMarketLog.setLevel( ILogger::DEBUG );
+    
+    size_t nsolv = solnset.getNumSolvable(); 
+    if( nsolv == 0 ){
+        solverLog << "No markets were assigned to this solver.  Exiting." << endl;
+        return SUCCESS;
+    }
+
+    Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
+    solverTimer.start();
+    
+    UBVECTOR x(nsolv), fx(nsolv);
+    int neval = 0;
+
+    // set our initial x from the solutionInfoSet
+    std::vector<SolutionInfo> smkts(solnset.getSolvableSet());
+    if(mLogPricep)
+      std::transform(smkts.begin(), smkts.end(), x.begin(), SI2lgprice);
+    else
+      std::transform(smkts.begin(), smkts.end(), x.begin(), SI2price);
+
+    // This is the closure that will evaluate the ED function
+    LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+
+    // scale the initial guess for use in F
+    F.scaleInitInputs(x);
+    
+    // Call F(x), store the result in fx
+    F(x,fx);
+    ++neval;
+
+    solverLog.setLevel(ILogger::DEBUG);
+    solverLog << "Initial guess:\n" << x << "\nInitial F(x):\n" << fx << "\n";
+
+    // call the solver
+    int nkstatus = nksolve(F, x, fx, neval);
+
+    solverTimer.stop();
+
+    solverLog.setLevel(ILogger::NOTICE);
+    solverLog << "Newton-Krylov solver:  neval= " << neval << "\nResult:  ";
+    if(nkstatus == 0) {
+        solverLog << "NK solution success.\n";
+        code = SUCCESS;
+    }
+    else if(nkstatus == -1) {
+        code = FAILURE_ITER_MAX_REACHED;
+        solverLog << "NK solution failed: Iteration max reached.\n";
+    }
+    else if(nkstatus == -3) {
+        code = FAILURE_ZERO_GRADIENT;
+        solverLog << "NK solution failed:  Encountered zero gradient in F*F.\n";
+    }
+    else if(nkstatus == -4) {
+        code = FAILURE_POOR_PROGRESS;
+        solverLog << "NK solution failed:  line search failure.\n";
+    }
+    else {
+        code = FAILURE_UNKNOWN;
+        solverLog << "NK solution failed for unknown reason.\n";
+    }
+    if(!solnset.isAllSolved()) {
+        solverLog << "The following markets were not solved:\n";
+        solnset.printUnsolved(solverLog);
+    }
+
+    const SolutionInfo* maxred = solnset.getWorstSolutionInfo();
+    addIteration(maxred->getName(), maxred->getRelativeED());
+    worstMarketLog << "###NK-end:  " << *maxred << endl;
+
+    solverLog << endl;
+    return code;
+}
+
+/*!
+ * \brief Newton iterations with GMRES for the linear step.
+ * \param F The excess demand function.
+ * \param x On input the initial guess, on output the last iterate.
+ * \param fx On input F( x ), on output F at the last iterate.
+ * \param neval Running count of function evaluations.
+ * \return 0 on success, -1 if the iteration max was reached, -3 for a
+ *         zero gradient, and -4 for a line search failure.
+ */
+int LogNewtonKrylov::nksolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
+                             int &neval)
+{
+  using boost::numeric::ublas::inner_prod;
+  using boost::numeric::ublas::norm_2;
+  using boost::numeric::ublas::norm_inf;
+
+  ILogger &solverLog = ILogger::getLogger("solver_log");
+  solverLog.setLevel(ILogger::DEBUG);
+
+  const double FTINY = mFTOL*mFTOL;
+  const double ETAMAX = 0.9;    // largest forcing term allowed by the adaptive update
+  UBVECTOR dx(F.narg());
+  UBVECTOR xnew(F.narg());
+  UBVECTOR jdx(F.nrtn());
+  UBVECTOR gx(F.narg());
+
+  // We create a functor that computes f(x) = F(x)*F(x).  It also
+  // stores the value of F that it produces as an intermediate.
+  FdotF<double,double> fnorm(F);
+  double f0 = inner_prod(fx,fx);
+  if(norm_inf(fx) <= mFTOL || f0 < FTINY) {
+    return 0;
+  }
+
+  double eta = std::min(mEta, ETAMAX);
+  for(unsigned int iter=0; iter<mMaxIter; ++iter) {
+    solverLog << "NK iter= " << iter << "\tneval= " << neval << "\teta= " << eta << "\n";
+
+    double resid = 0.0;
+    int nlin = gmres(F, x, fx, eta, dx, resid, neval);
+    solverLog << "GMRES:  iterations= " << nlin << "  relative residual= "
+              << resid / sqrt(f0) << "\n";
+
+    // The line search needs the directional derivative of F*F along
+    // dx, fx^T * J * dx (using the same scaling as the other
+    // solvers).  Rather than trusting the GMRES residual, spend one
+    // more evaluation to compute it directly.  The line search only
+    // uses the gradient through its inner product with dx, so any
+    // vector with the right projection onto dx will do.
+    jacvec(F, x, fx, dx, jdx, neval);
+    double g0dx = inner_prod(fx, jdx);
+    double dx2 = inner_prod(dx, dx);
+    if(dx2 <= 0.0 || fabs(g0dx) / (f0+FTINY) < mFTOL*mFTOL) {
+      solverLog << "**** zero step or gradient.  Returning.\n";
+      return -3;
+    }
+    gx = (g0dx / dx2) * dx;
+
+    double fnew;
+    int lserr = linesearch(fnorm, x, f0, gx, dx, xnew, fnew, neval, &solverLog);
+    if(lserr != 0) {
+      // make a relaxed convergence test, as in the other solvers
+      if(f0/fx.size() < mFTOL) {
+        return 0;
+      }
+      solverLog << "linesearch failure\n";
+      return -4;
+    }
+
+    // Eisenstat-Walker choice 2: eta = gamma*(||F_new|| / ||F_old||)^2,
+    // safeguarded so that it does not fall too fast
+    if(mAdaptiveForcing) {
+      const double gamma = 0.9;
+      double etanew = gamma * fnew / f0;
+      double etasafe = gamma * eta * eta;
+      if(etasafe > 0.1) {
+        etanew = std::max(etanew, etasafe);
+      }
+      eta = std::min(etanew, ETAMAX);
+    }
+
+    f0 = fnew;
+    x  = xnew;
+    fnorm.lastF(fx);            // get the last value of big-F
+    solverLog << "\nxnew: " << xnew << "\nfxnew: " << fx << "\n";
+
+    // test for convergence
+    double maxval = norm_inf(fx);
+    solverLog << "Convergence test maxval: " << maxval << "\n";
+    if(maxval <= mFTOL) {
+      solverLog << "Solution successful.\n";
+      return 0;                 // SUCCESS 
+    }
+  }
+
+  solverLog << "\n****************Maximum solver iterations exceeded.\nlastx: " << x
+            << "\nlastF: " << fx << "\n";
+  return -1;
+}
+
+/*!
+ * \brief Approximate the product of the Jacobian of F at x with a vector.
+ * \details Uses the one-sided difference (F(x+h*v) - F(x)) / h with h
+ *          scaled so that the perturbation is roughly the square root of
+ *          machine precision relative to x.
+ * \param F The excess demand function.
+ * \param x Point at which the Jacobian is taken.
+ * \param fx F( x ).
+ * \param v The vector to multiply.
+ * \param jv Output J*v.
+ * \param neval Running count of function evaluations.
+ */
+void LogNewtonKrylov::jacvec(VecFVec<double,double> &F, const UBVECTOR &x, const UBVECTOR &fx,
+                             const UBVECTOR &v, UBVECTOR &jv, int &neval)
+{
+  using boost::numeric::ublas::norm_2;
+  const double EPS = 1.0e-7;    // approximately sqrt(double epsilon), as in fdjac
+  double vnorm = norm_2(v);
+  if(vnorm == 0.0) {
+    jv = boost::numeric::ublas::zero_vector<double>(fx.size());
+    return;
+  }
+  double h = EPS * (1.0 + norm_2(x)) / vnorm;
+  UBVECTOR xh(x + h*v);
+  F(xh, jv);
+  ++neval;
+  jv = (jv - fx) / h;
+}
+
+/*!
+ * \brief Solve J*dx = -F( x ) with restarted GMRES.
+ * \details Arnoldi with modified Gram-Schmidt and Givens rotations, as
+ *          in Saad & Schultz (1986).  The initial guess is dx = 0.
+ * \param F The excess demand function.
+ * \param x Point at which the Jacobian is taken.
+ * \param fx F( x ).
+ * \param aEta Relative residual tolerance.
+ * \param dx Output the approximate Newton step.
+ * \param aResid Output the norm of the final residual.
+ * \param neval Running count of function evaluations.
+ * \return The total number of GMRES iterations.
+ */
+int LogNewtonKrylov::gmres(VecFVec<double,double> &F, const UBVECTOR &x, const UBVECTOR &fx,
+                           const double aEta, UBVECTOR &dx, double &aResid, int &neval)
+{
+  using boost::numeric::ublas::inner_prod;
+  using boost::numeric::ublas::norm_2;
+
+  const int n = fx.size();
+  const int m = std::min<int>(mKrylovDim, n);
+  const double bnorm = norm_2(fx);
+  const double tol = aEta * bnorm;
+
+  dx = boost::numeric::ublas::zero_vector<double>(n);
+  UBVECTOR r(-1.0*fx);          // residual for dx = 0
+  aResid = bnorm;
+  int totiter = 0;
+
+  std::vector<UBVECTOR> V(m+1, UBVECTOR(n));
+  boost::numeric::ublas::matrix<double> H(m+1, m);
+  UBVECTOR cs(m), sn(m), g(m+1), w(n), y(m);
+
+  for(unsigned int cycle=0; cycle<=mMaxRestarts && aResid > tol; ++cycle) {
+    double beta = norm_2(r);
+    if(beta == 0.0) {
+      break;
+    }
+    V[0] = r / beta;
+    H.clear();
+    g.clear();
+    g[0] = beta;
+
+    int k = 0;
+    for(; k<m; ++k) {
+      jacvec(F, x, fx, V[k], w, neval);
+      for(int i=0; i<=k; ++i) {
+        H(i,k) = inner_prod(w, V[i]);
+        w -= H(i,k) * V[i];
+      }
+      const double hnext = norm_2(w);
+      H(k+1,k) = hnext;
+      if(hnext > 0.0) {
+        V[k+1] = w / hnext;
+      }
+
+      // apply the previous rotations to the new column, then compute
+      // the rotation that eliminates the subdiagonal
+      for(int i=0; i<k; ++i) {
+        double tmp = cs[i]*H(i,k) + sn[i]*H(i+1,k);
+        H(i+1,k) = -sn[i]*H(i,k) + cs[i]*H(i+1,k);
+        H(i,k) = tmp;
+      }
+      double denom = sqrt(H(k,k)*H(k,k) + H(k+1,k)*H(k+1,k));
+      if(denom == 0.0) {
+        // breakdown with a singular Hessenberg matrix; use what we have
+        break;
+      }
+      cs[k] = H(k,k) / denom;
+      sn[k] = H(k+1,k) / denom;
+      H(k,k) = denom;
+      H(k+1,k) = 0.0;
+      g[k+1] = -sn[k]*g[k];
+      g[k] = cs[k]*g[k];
+
+      ++totiter;
+      aResid = fabs(g[k+1]);
+      if(aResid <= tol || hnext == 0.0) {
+        // converged, or the Krylov space is invariant and the
+        // solution is exact
+        ++k;
+        break;
+      }
+    }
+
+    // back substitution for the least squares coefficients, then
+    // update the solution and the residual
+    for(int i=k-1; i>=0; --i) {
+      double sum = g[i];
+      for(int j=i+1; j<k; ++j) {
+        sum -= H(i,j)*y[j];
+      }
+      y[i] = sum / H(i,i);
+    }
+    for(int i=0; i<k; ++i) {
+      dx += y[i] * V[i];
+    }
+    if(aResid > tol && cycle < mMaxRestarts) {
+      // recompute the true residual for the restart
+      jacvec(F, x, fx, dx, w, neval);
+      r = -1.0*fx - w;
+      aResid = norm_2(r);
+    }
+  }
+
+  return totiter;
+}
@@ -40,6 +40,8 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <cmath>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -57,17 +59,100 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/solve_budget.h"
+#include "solution/util/include/functor.hpp"
+#include "solution/util/include/fdjac.hpp"
+#include "solution/util/include/edfun.hpp"
 
 using namespace std;
 using namespace xercesc;
 
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+namespace {
+    /*!
+     * \brief Calculate the norm of the residual the Newton step is taken on.
+     * \details This is the sum of squares of the log of demand less the log of
+     *          supply of each solvable market, as in calculateNewPricesLogNR.
+     * \param aSolutionSet The solution set.
+     * \return The squared norm of the residual.
+     */
+    double calcResidualNorm( const SolutionInfoSet& aSolutionSet ) {
+        double norm = 0;
+        for( unsigned int i = 0; i < aSolutionSet.getNumSolvable(); ++i ) {
+            const double residual = log( max( aSolutionSet.getSolvable( i ).getDemand(), util::getSmallNumber() ) )
+                - log( max( aSolutionSet.getSolvable( i ).getSupply(), util::getSmallNumber() ) );
+            norm += residual * residual;
+        }
+        return norm;
+    }
+
+    /*!
+     * \brief The residual of SolverLibrary::calculateNewPricesLogNR as a
+     *        function of the log of the prices, so that fdjac can take its
+     *        Jacobian.
+     * \details The model is evaluated by LogEDFun, which also takes care of
+     *          resetting the state for each partial derivative.  The log of
+     *          demand less the log of supply of each solvable market is then
+     *          read back rather than the (scaled and corrected) output of
+     *          LogEDFun.
+     */
+    class LogNRResidual : public VecFVec<double, double> {
+    public:
+        LogNRResidual( LogEDFun& aF, const SolutionInfoSet& aSolutionSet, const double aDeltaPrice ):
+        mF( aF ),
+        mSolutionSet( aSolutionSet ),
+        mDeltaPrice( aDeltaPrice )
+        {
+            na = aF.narg();
+            nr = aF.nrtn();
+            mdiagnostic = false;
+        }
+
+        virtual void operator()( const UBVECTOR& aX, UBVECTOR& aFX, const int aPartj = -1 ) {
+            // Partial derivatives may be evaluated concurrently so the output
+            // of LogEDFun can not be kept in a member.
+            UBVECTOR edfx( nr );
+            mF( aX, edfx, aPartj );
+            for( int i = 0; i < nr; ++i ) {
+                aFX[ i ] = log( max( mSolutionSet.getSolvable( i ).getDemand(), util::getSmallNumber() ) )
+                    - log( max( mSolutionSet.getSolvable( i ).getSupply(), util::getSmallNumber() ) );
+            }
+        }
+
+        virtual void partial( int aIndex ) {
+            mF.partial( aIndex );
+        }
+
+        virtual double partialSize( int aIndex ) const {
+            return mF.partialSize( aIndex );
+        }
+
+        virtual double stepSize( const int aIndex, const double aX ) const {
+            return mDeltaPrice * ( fabs( aX ) + 1.0e-6 );
+        }
+
+    private:
+        //! The function which evaluates the model.
+        LogEDFun& mF;
+
+        //! The solution set the residual is read from.
+        const SolutionInfoSet& mSolutionSet;
+
+        //! The finite difference step relative to the log price.
+        const double mDeltaPrice;
+    };
+}
+
 //! Default Constructor. Constructs the base class. 
 LogNewtonRaphson::LogNewtonRaphson( Marketplace* aMarketplace,
                                     World* aWorld, CalcCounter* aCalcCounter ):
 SolverComponent( aMarketplace, aWorld, aCalcCounter ),
 mDefaultDeltaPrice( 1e-6 ),
 mMaxIterations( 4 ),
-mDefaultMaxPriceChange( 1.2 )
+mDefaultMaxPriceChange( 1.2 ),
+mChordIterations( 1 ),
+mChordRefreshRatio( 0.5 )
 {
 }
 
@@ -118,6 +203,12 @@ bool LogNewtonRaphson::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "max-price-change" ) {
             mDefaultMaxPriceChange = XMLHelper<double>::getValue( curr );
         }
+        else if( nodeName == "chord-iterations" ) {
+            mChordIterations = max( XMLHelper<unsigned int>::getValue( curr ), 1u );
+        }
+        else if( nodeName == "chord-refresh-ratio" ) {
+            mChordRefreshRatio = XMLHelper<double>::getValue( curr );
+        }
         else if( nodeName == "solution-info-filter" ) {
             mSolutionInfoFilter.reset(
                 SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
@@ -141,6 +232,12 @@ bool LogNewtonRaphson::XMLParse( const DOMNode* aNode ) {
 *          changes produced to minimize the risk of this algorithm diverging.
 * \author Sonny Kim, Josh Lurz, Steve Smith
 * \warning Unless stated otherwise, ED values are normalized (i.e., that 10 == 10% difference). -- TODO: Is this still true?
+*          With chord-iterations greater than one the factorized derivatives are
+*          kept for up to that many iterations (the Shamanskii variant of the
+*          chord method).  They are recalculated sooner if an iteration does not
+*          reduce the squared norm of the log residual by at least the factor
+*          chord-refresh-ratio, if the set of solvable markets changes or if the
+*          step from stale derivatives fails to give valid prices.
 * \param aSolutionSet An initial set of SolutionInfo objects representing all markets which can be filtered.
 * \param aPeriod Model period.
 * \return A status code to indicate if the algorithm was successful or not.
@@ -154,7 +251,7 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
         return code = SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( aPeriod );
     
     // TODO: is the following necessary
     // Update the solution vector for the correct markets to solve.
@@ -174,8 +271,10 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
         return SUCCESS; // Need a new code here.
     }
 
-    solverLog << "Initial market state:" << endl;
-    solverLog << aSolutionSet << endl;
+    if( GCAM_SOLVER_LOG_ENABLED( solverLog, ILogger::NOTICE ) ) {
+        solverLog << "Initial market state:" << endl;
+        solverLog << aSolutionSet << endl;
+    }
     
     // Setup the solution matrices.
     size_t currSize = aSolutionSet.getNumSolvable();
@@ -184,19 +283,33 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
 
     unsigned int number_of_NR_iteration = 1;
     bool success = true;
+    // Whether the factorized derivatives must be recalculated and the number of
+    // iterations they have been used for.
+    bool needDerivatives = true;
+    unsigned int chordAge = 0;
     do {
         singleLog.setLevel( ILogger::DEBUG );
-        aSolutionSet.printMarketInfo( "Begin logNR", calcCounter->getPeriodCount(), singleLog );
+        if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+            aSolutionSet.printMarketInfo( "Begin logNR", calcCounter->getPeriodCount(), singleLog );
+        }
 
         solverLog.setLevel(ILogger::DEBUG);
         int itnum = number_of_NR_iteration - 1;
         solverLog << "****************Iteration " << itnum << "\n";
         
         // Calculate derivatives 
-        code = calculateDerivatives( aSolutionSet, JF, permMatrix, aPeriod );
-        if ( code != SUCCESS ) {
-            return code;
-        } 
+        if( needDerivatives || chordAge >= mChordIterations ) {
+            code = calculateDerivatives( aSolutionSet, JF, permMatrix, aPeriod );
+            if ( code != SUCCESS ) {
+                return code;
+            }
+            needDerivatives = false;
+            chordAge = 0;
+        }
+        else {
+            solverLog << "Reusing derivatives from " << chordAge << " iterations ago." << endl;
+        }
+        const double residualBefore = mChordIterations > 1 ? calcResidualNorm( aSolutionSet ) : 0;
         // Calculate new prices
         if( SolverLibrary::calculateNewPricesLogNR( aSolutionSet, JF, permMatrix, mDefaultMaxPriceChange ) ){
             // Call world.calc and update supplies and demands. 
@@ -211,16 +324,33 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
             worstMarketLog.setLevel( ILogger::NOTICE );
             worstMarketLog << "NR-maxRelED: " << *currWorstSol << endl;
             solverLog.setLevel( ILogger::DEBUG );
-            solverLog << "Solution after " << number_of_NR_iteration << " iterations in NewtonRhapson: " << endl;
-            solverLog << aSolutionSet << endl;
+            if( GCAM_SOLVER_LOG_ENABLED( solverLog, ILogger::DEBUG ) ) {
+                solverLog << "Solution after " << number_of_NR_iteration << " iterations in NewtonRhapson: " << endl;
+                solverLog << aSolutionSet << endl;
+            }
+
+            ++chordAge;
+            if( mChordIterations > 1 &&
+                calcResidualNorm( aSolutionSet ) > mChordRefreshRatio * residualBefore )
+            {
+                // Convergence has slowed too much to keep using these derivatives.
+                needDerivatives = true;
+            }
 
             if( aSolutionSet.updateSolvable( mSolutionInfoFilter.get() ) != SolutionInfoSet::UNCHANGED ){
                 size_t newSize = aSolutionSet.getNumSolvable();
                 JF.resize( newSize, newSize );
                 permMatrix.resize( newSize );
+                needDerivatives = true;
             }
 
-            aSolutionSet.printMarketInfo( "NR routine ", calcCounter->getPeriodCount(), singleLog );
+            if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+                aSolutionSet.printMarketInfo( "NR routine ", calcCounter->getPeriodCount(), singleLog );
+            }
+        }
+        else if( chordAge > 0 ) {
+            // The derivatives were stale, try again from new ones.
+            needDerivatives = true;
         }
         else {
             success = false;
@@ -228,13 +358,18 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
         ++number_of_NR_iteration;
     } // end do loop    
     while ( success && number_of_NR_iteration <= mMaxIterations &&
-            !aSolutionSet.isAllSolved() );
+            !aSolutionSet.isAllSolved() && !SolveBudget::getInstance().isComponentOverBudget() );
     
     // reset the derivatives regardless of if we were successful
     resetDerivatives();
 
     // Update the return code. 
     code = ( aSolutionSet.isAllSolved() ? SUCCESS : FAILURE_ITER_MAX_REACHED );
+    if( code != SUCCESS && SolveBudget::getInstance().isComponentOverBudget() ) {
+        code = FAILURE_OVER_BUDGET;
+        solverLog.setLevel( ILogger::NOTICE );
+        solverLog << "Exiting Newton-Raphson because the solve budget is exhausted." << endl;
+    }
 
     // Print if we exited NR because it had solved all the markets.
     solverLog.setLevel( ILogger::NOTICE );
@@ -258,7 +393,9 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
 
 /*!
  * \brief Calculate derivatives and invert them so that they may be used to calculate new prices.
- * \details We will rely on the solver library to calculate derivatives.  The returned JF will not
+ * \details The derivatives of the log of demand less the log of supply with
+ *          respect to the log of the prices are calculated by fdjac with the
+ *          model evaluated by LogEDFun.  The returned JF will not
  *          actually be inverted rather it will use LU factorization which is computationally less
  *          intensive than calculating inverse.  Note that SolverLibrary::calculateNewPricesLogNR
  *          has also been modified to expect the factorized derivative rather than the inverse.
@@ -270,22 +407,28 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
  * \return A return code to indicate if the derivative calculation as well as the factorization was
  *         successful.  It is very important that this value be checked since if it failed JF will
  *         have garbage in it.
- * \see SolverLibrary::derivatives
+ * \see fdjac
  */
 SolverComponent::ReturnCode LogNewtonRaphson::calculateDerivatives( SolutionInfoSet& aSolutionSet, Matrix& JF, PermutationMatrix& aPermMatrix, int aPeriod ) {
-    // Calculate derivatives.
-    SolverLibrary::derivatives( marketplace, world, aSolutionSet, mDefaultDeltaPrice, aPeriod );
+    const size_t currSize = aSolutionSet.getNumSolvable();
+    LogEDFun F( aSolutionSet, world, marketplace, aPeriod, true );
+    LogNRResidual residual( F, aSolutionSet, mDefaultDeltaPrice );
+    UBVECTOR x( currSize );
+    for( size_t i = 0; i < currSize; ++i ) {
+        x[ i ] = log( max( aSolutionSet.getSolvable( i ).getPrice(), util::getSmallNumber() ) );
+    }
+
+    // Calculate derivatives.  This evaluates the model at x first, so the
+    // state is left at x.
+    Matrix J( currSize, currSize );
+    fdjac( residual, x, J, true );
     ILogger& solverLog = ILogger::getLogger( "solver_log" );
     solverLog.setLevel( ILogger::NOTICE );
     solverLog << "Derivatives calculated" << endl;
-    size_t currSize = aSolutionSet.getNumSolvable();
-    // we need to keep track of these since if luFactorizeMatrix fails we can reconstruct
-    // what JF was
-    Matrix JFDM( currSize, currSize );
-    Matrix JFSM( currSize, currSize );
-    
-    // Update the JF, JFDM, and JFSM matrices
-    SolverLibrary::updateMatrices( aSolutionSet, JFSM, JFDM, JF );
+
+    // JF is the derivative of supply less demand.  J is kept since if
+    // luFactorizeMatrix fails we need it to reconstruct what JF was.
+    JF = -J;
     
     if( SolverLibrary::luFactorizeMatrix( JF, aPermMatrix ) ) {
         // print the derivative matrix to help the user understand why it was singular
@@ -301,7 +444,7 @@ SolverComponent::ReturnCode LogNewtonRaphson::calculateDerivatives( SolutionInfo
             for( int col = 0; col < aSolutionSet.getNumSolvable(); ++col ) {
                 // we need to recalculate JF since luFactorizeMatrix will not necessarily
                 // return it with the rows properly ordered when there is a singularity
-                solverLog << JFSM( row , col ) - JFDM( row , col ) << ',';
+                solverLog << -J( row , col ) << ',';
             }
             solverLog << endl;
         }
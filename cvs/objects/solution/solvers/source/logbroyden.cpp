@@ -68,6 +68,9 @@
 #include "solution/util/include/ublas-helpers.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "solution/util/include/jacobian-precondition.hpp"
+#include "solution/util/include/linear_solver.hpp"
+#include "solution/util/include/solver_telemetry.h"
+#include "solution/util/include/solve_budget.h"
 
 #if USE_LAPACK
 #include <boost/numeric/bindings/traits/ublas_vector.hpp>
@@ -127,6 +130,7 @@ namespace {
 
 int LogBroyden::mLastPer = 0;
 int LogBroyden::mPerIter = 0;
+std::map<std::vector<std::string>, LogBroyden::PeriodJacobianMap> LogBroyden::sJacobianStore;
 
 bool LogBroyden::XMLParse( const DOMNode* aNode ) {
     // assume we were passed a valid node.
@@ -159,6 +163,45 @@ bool LogBroyden::XMLParse( const DOMNode* aNode ) {
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
         }
+        else if(nodeName == "jacobian-column-groups") {
+          mUseColumnGroups = true;
+        }
+        else if(nodeName == "jacobian-cache") {
+          mUseJacobianCache = true;
+        }
+        else if(nodeName == "max-lu-updates") {
+          mMaxLUUpdates = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if(nodeName == "speculative-linesearch") {
+          mSpeculativeSteps = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if(nodeName == "block-triangular") {
+          mBlockTriangular = true;
+        }
+        else if(nodeName == "mixed-precision") {
+          mMixedPrecision = true;
+        }
+        else if(nodeName == "sparse-lu") {
+          mSparseLU = true;
+        }
+        else if(nodeName == "adaptive-fd-steps") {
+          mAdaptiveSteps = true;
+        }
+        else if(nodeName == "reduced-accuracy-tolerance") {
+          mReducedAccuracyTol = XMLHelper<double>::getValue( curr );
+        }
+        else if(nodeName == "incremental-calc-threshold") {
+          mIncrementalCalcThreshold = XMLHelper<double>::getValue( curr );
+          if( mIncrementalCalcThreshold > 0.0 ) {
+              // Skipping markets whose prices moved a little would return F at
+              // stale prices, so only exact skipping is supported.
+              ILogger& mainLog = ILogger::getLogger( "main_log" );
+              mainLog.setLevel( ILogger::WARNING );
+              mainLog << "incremental-calc-threshold " << mIncrementalCalcThreshold
+                      << " is treated as 0, only unchanged prices are skipped." << std::endl;
+              mIncrementalCalcThreshold = 0.0;
+          }
+        }
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
         }
@@ -209,7 +252,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
         return code = SolverComponent::SUCCESS;
     }
     
-    startMethod();
+    startMethod( period );
     if(period != mLastPer) {
         // reset our internal counters
         mPerIter = 0;
@@ -242,15 +285,17 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
         return SUCCESS;
     }
     
-    solverLog << "Initial market state:\nmkt    \tprice   \tsupply  \tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
-    for(size_t i=0; i<solvables.size(); ++i) {
-        solverLog << std::setw( 8 ) << i << "\t"
-                  << std::setw( 8 ) << solvables[i].getPrice() << "\t"
-                  << std::setw( 8 ) << solvables[i].getSupply() << "\t"
-                  << std::setw( 8 ) << solvables[i].getDemand()
-                  << "\t\t" << solvables[i].getName() << "\n"; 
-    } 
+    if( GCAM_SOLVER_LOG_ENABLED( solverLog, ILogger::NOTICE ) ) {
+        solverLog << "Initial market state:\nmkt    \tprice   \tsupply  \tdemand\n";
+        const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
+        for(size_t i=0; i<solvables.size(); ++i) {
+            solverLog << std::setw( 8 ) << i << "\t"
+                      << std::setw( 8 ) << solvables[i].getPrice() << "\t"
+                      << std::setw( 8 ) << solvables[i].getSupply() << "\t"
+                      << std::setw( 8 ) << solvables[i].getDemand()
+                      << "\t\t" << solvables[i].getName() << "\n"; 
+        }
+    }
 
     Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
     solverTimer.start();
@@ -270,6 +315,9 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     
     // This is the closure that will evaluate the ED function
     LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+    F.setColumnGrouping( mUseColumnGroups );
+    F.setIncrementalCalc( mIncrementalCalcThreshold );
+    F.setAdaptiveSteps( mAdaptiveSteps );
     // check the assumptions:  narg==nrtn==nsolv
     if(F.narg() != nsolv || F.nrtn() != nsolv) {
       solverLog.setLevel(ILogger::SEVERE);
@@ -283,19 +331,40 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     // scale the initial guess for use in the solver algorithm
     F.scaleInitInputs( x );
     
+    // Start from a reduced accuracy model if asked to, bsolve switches back
+    // to full accuracy as it approaches the solution.
+    if( mReducedAccuracyTol > mFTOL ) {
+        world->setEvalAccuracy( World::REDUCED_ACCURACY );
+    }
+    
     // Call F( x ), store the result in fx
     F(x,fx);
 
     solverLog.setLevel(ILogger::DEBUG);
-    solverLog << "Initial guess:\n" << x << "\nInitial F( x ):\n" << fx << "\n";
-    solnset.printMarketInfo("Broyden-initial", calcCounter->getPeriodCount(), singleLog);
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "Initial guess:\n" << x << "\nInitial F( x ):\n" << fx << "\n";
+    if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+        solnset.printMarketInfo("Broyden-initial", calcCounter->getPeriodCount(), singleLog);
+    }
 
     // Precondition the x values to avoid singular columns in the Jacobian
     solverLog.setLevel(ILogger::DEBUG);
     UBMATRIX J(F.narg(), F.nrtn());
-    fdjac(F, x, fx, J, true);
+    std::vector<std::string> mktNames( nsolv );
+    for(size_t i=0; i<nsolv; ++i) {
+        mktNames[i] = smkts[i].getName();
+    }
+    const bool skipCache = mSkipJacobianCache;
+    mSkipJacobianCache = false;
+    if( mUseJacobianCache && !skipCache && loadCachedJacobian( period, mktNames, F, J ) ) {
+        solverLog << ">>>> Main loop jacobian seeded from cache.\n";
+    }
+    else {
+        SolverTelemetry::PhaseTimer fdjacTimer( SolverTelemetry::FDJAC );
+        fdjac(F, x, fx, J, true);
+        fdjacTimer.stop();
+        solverLog << ">>>> Main loop jacobian called.\n";
+    }
 
-    solverLog << ">>>> Main loop jacobian called.\n";
     int pcfail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
 
     if( pcfail ) {
@@ -304,13 +373,18 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
       solverLog.setLevel(ILogger::DEBUG);
     }
     else {
-      solverLog << "Revised guess:\n" << x << "\nRevised F( x ):\n" << fx << "\n";
+      GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "Revised guess:\n" << x << "\nRevised F( x ):\n" << fx << "\n";
+    }
+    if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+        solnset.printMarketInfo("Broyden-preconditioned", calcCounter->getPeriodCount(), singleLog);
     }
-    solnset.printMarketInfo("Broyden-preconditioned", calcCounter->getPeriodCount(), singleLog);
     cSolInfo = &solnset;        // make available for log outputs
 
     // call the solver
     int bstatus = bsolve(F, x, fx, J, neval);
+    // Leave the model state as calculated at full accuracy regardless of how
+    // bsolve finished.
+    restoreFullAccuracy(F, x, fx, neval);
     mPerIter++;                 // increment the iteration count.  This should produce a visible gap in the trace plots.
 
     solverTimer.stop(); 
@@ -320,6 +394,9 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     if(bstatus == 0) {
         solverLog << "Broyden solution success.\n";
         code = SUCCESS;
+        if( mUseJacobianCache ) {
+            saveCachedJacobian( period, mktNames, F, J );
+        }
     }
     else if(bstatus == -1) {
         code = FAILURE_ITER_MAX_REACHED;
@@ -333,6 +410,10 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
         code = FAILURE_POOR_PROGRESS;
         solverLog << "Broyden solution failed:  repeated poor progress.\n";
     }
+    else if(bstatus == -5) {
+        code = FAILURE_OVER_BUDGET;
+        solverLog << "Broyden solution failed:  solve budget exhausted.\n";
+    }
     else if(bstatus > 0) {
         code = FAILURE_SINGULAR_MATRIX;
         int singrow = bstatus-1; // L-U decomp returns row number as 1..N numbering
@@ -360,8 +441,10 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
       worstMarketLog << "###Broyden-end-linearPrice:  " << *maxred << std::endl;
     }
 
-    solnset.printMarketInfo("Broyden-end ", calcCounter->getPeriodCount(), singleLog);
-    singleLog << std::endl;
+    if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+        solnset.printMarketInfo("Broyden-end ", calcCounter->getPeriodCount(), singleLog);
+        singleLog << std::endl;
+    }
 
     return code;
 }
@@ -369,11 +452,6 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
 int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
                        UBMATRIX & B, int &neval)
 {
-#if !USE_LAPACK
-  using boost::numeric::ublas::permutation_matrix;
-  using boost::numeric::ublas::lu_factorize;
-  using boost::numeric::ublas::lu_substitute;
-#endif
   using boost::numeric::ublas::axpy_prod;
   using boost::numeric::ublas::inner_prod;
   int nrow = B.size1(), ncol = B.size2();
@@ -382,9 +460,12 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 #if USE_LAPACK
   UBMATRIX Usv(nrow,ncol),VTsv(ncol,ncol);
   UBVECTOR Ssv( ncol );
-#else
-  permutation_matrix<int> p(F.narg()); // permutation vector for pivoting in L-U decomposition
 #endif
+  LinearSolver lusolver;        // L-U factorization of the Jacobian
+  bool luValid = false;         // flag indicating whether lusolver is a factorization of the current B
+  lusolver.setBlockTriangular(mBlockTriangular);
+  lusolver.setMixedPrecision(mMixedPrecision);
+  lusolver.setSparse(mSparseLU);
 
   UBMATRIX Btmp(nrow, ncol);
   ILogger &solverLog = ILogger::getLogger("solver_log");
@@ -412,6 +493,9 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
   UBVECTOR rptvec_all(mktids_all.size());
   
   F(x,fx);
+  if(world->getEvalAccuracy() == World::REDUCED_ACCURACY && norm_inf(fx) <= mReducedAccuracyTol) {
+    restoreFullAccuracy(F, x, fx, neval);
+  }
 
   solverLog.setLevel(ILogger::DEBUG);
   
@@ -443,6 +527,9 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
   // stores the value of F that it produces as an intermediate.
   FdotF<double,double> fnorm( F );
   double f0 = inner_prod(fx,fx); // already have a value of F on input, so no need to call fnorm yet
+  if(f0 < FTINY && restoreFullAccuracy(F, x, fx, neval)) {
+    f0 = inner_prod(fx,fx);
+  }
   if(f0 < FTINY) {
     // Guard against F=0 since it can cause a NaN in our solver.  This
     // is a more stringent test than our regular convergence test
@@ -451,11 +538,17 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 
   bool lsfail = false;        // flag indicating whether we have had a line-search failure
   for(int iter=0; iter<mMaxIter; ++iter) {
+    if( SolveBudget::getInstance().isComponentOverBudget() ) {
+      solverLog << "Broyden iter= " << iter << " stopping, solve budget exhausted.\n";
+      return -5;
+    }
     // log some debug info
     
     solverLog << "Broyden iter= " << iter << "\tneval= " << neval << "\n";
     solverLog << "Internal iteration count ( mPerIter )= " << mPerIter << "\n";
-    cSolInfo->printMarketInfo("Broyden ", calcCounter->getPeriodCount(), singleLog);
+    if( GCAM_SOLVER_LOG_ENABLED( singleLog, ILogger::DEBUG ) ) {
+        cSolInfo->printMarketInfo("Broyden ", calcCounter->getPeriodCount(), singleLog);
+    }
     for(int j=0;j<F.narg();++j) {
       // double bjj= B(j,j);
       // jdiag[j] = bjj;
@@ -465,7 +558,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     double jdmax=0.0, jdmin=0.0;
     int jdjmax=0, jdjmin=0;
     locate_vector_minmax(jdiag, jdmax, jdmin, jdjmax, jdjmin);
-    solverLog << "diag( B ):\n" << jdiag << "\n";
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "diag( B ):\n" << jdiag << "\n";
     solverLog << "maxval= " << jdmax << " jmax= " << jdjmax << "  "
               << "minval= " << jdmin << "  jmin= " << jdjmin << "\n";
     
@@ -484,6 +577,36 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     }
 
     Btmp = B;                   // save the jacobian approximant
+
+    // Try the L-U fast path first.  The factorization goes to a
+    // separate workspace, so B is left intact.  Fall back to the more
+    // expensive (but more robust) solvers below only if the Jacobian
+    // is singular or badly conditioned.  If the factorization from a
+    // previous iteration has been kept current with the Broyden
+    // updates, reuse it rather than factoring B again.
+    SolverTelemetry::PhaseTimer linearSolveTimer( SolverTelemetry::LINEAR_SOLVE );
+    int sing = 0;
+    if(luValid) {
+      solverLog << "Reusing L-U with " << lusolver.getNumUpdates() << " rank-one updates\n";
+    }
+    else {
+      sing = lusolver.factorize(B);
+      solverLog << "L-U (" << LinearSolver::getBackendName() << ") sing= " << sing
+                << "  rcond= " << lusolver.getRCond() << "  blocks= " << lusolver.getNumBlocks()
+                << "  max block= " << lusolver.getMaxBlockSize()
+                << "  factor nnz= " << lusolver.getFactorNonzeros() << "\n";
+    }
+    luValid = sing == 0 && lusolver.isWellConditioned();
+    if(luValid) {
+      dx = -1.0*fx;
+      // fails only if mixed precision refinement stalled and B turned out
+      // to be ill-conditioned in double precision too
+      luValid = lusolver.solve(dx);       // solve dx = J^-1 F
+    }
+    if(luValid) {
+      GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "dx: " << dx << "\n";
+    }
+    else {
 #if USE_LAPACK /* Solve using SVD */
     int ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
                                                        B,           // input matrix
@@ -501,61 +624,43 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     dx = -1.0*fx; 
     int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
 
-    solverLog << "\nIteration " << iter << "\nf0= " << f0
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "\nIteration " << iter << "\nf0= " << f0
               << "\tnsing= " << nsing
               << "\nx: " << x << "\nF( x ): " << fx << "\ndx: " << dx << "\n";
 
 #else /* No USE_LAPACK.  Solve using L-U decomposition */
-    int itrial = 0;
-    /* If the L-U decomposition fails the first time around, we will
-       invoke the jacobian preconditioner and try again.  If it fails
-       a second time, we bail out */
-    do {
-      for(size_t i=0; i<p.size(); ++i) {
-        p[i] = i;
+    /* If the L-U decomposition failed, we will invoke the jacobian
+       preconditioner and try again.  If it fails a second time, we
+       bail out.  A factorization that is merely ill-conditioned is
+       used as is, since there is nothing better to fall back on. */
+    if(sing>0) {
+      solverLog << "Salvaging Jacobian.\n";
+      int fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
+      f0 = inner_prod(fx,fx);
+
+      // log the diagonal of the new jacobian
+      for(int j=0; j<F.narg(); ++j) {
+          jdiag[j] = B(j,j); 
       }
-      int sing = lu_factorize(B,p);
-      if(sing>0) {
-        int fail=1;
-        B = Btmp;           // restore Jacobian
-        if(itrial == 0) {
-            solverLog << "Salvaging Jacobian.\n";
-            fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
-            f0 = inner_prod(fx,fx);
-
-            // log the diagonal of the new jacobian
-            for(int j=0; j<F.narg(); ++j) {
-                jdiag[j] = B(j,j); 
-            }
-            solverLog << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
+      GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
 
-        }
-        
-        if( fail ) {
-            solverLog.setLevel(ILogger::WARNING);
-            solverLog << "Singular Jacobian:\n" << B << "\n";
-            return sing;
-        }
+      if(!fail) {
+        sing = lusolver.factorize(B);
       }
-      else {
-        // L-U decomp was successful.  Continue with the next phase of the algorithm.
-        break;
+      if(fail || sing>0) {
+        solverLog.setLevel(ILogger::WARNING);
+        solverLog << "Singular Jacobian:\n" << B << "\n";
+        return fail ? fail : sing;
       }
-    } while(++itrial < 2);
+    }
     
-    // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
+    // lusolver now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
     dx = -1.0*fx;
-    try {
-      lu_substitute(B,p,dx);    // solve dx = J^-1 F
-    }
-    catch (const boost::numeric::ublas::internal_logic &err) {
-      // This error seems to be thrown when the Jacobian is
-      // ill-conditioned.  We let it go because often the solver will
-      // muddle through to a solution.  If not, then it will
-      // eventually stop with a genuinely singular matrix.
-    }
-    solverLog << "dx: " << dx << "\n"; 
+    lusolver.solve(dx);         // solve dx = J^-1 F
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "dx: " << dx << "\n"; 
 #endif /* USE_LAPACK */
+    }
+    linearSolveTimer.stop();
 
     // log the proposal step
     solverLog << "Proposal step magnitude dxmag= " << sqrt(inner_prod(dx,dx)) << "\n\n";
@@ -565,7 +670,9 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     // dx now holds the newton step.  Execute the line search along
     // that direction.
     double fnew;
-    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval, &solverLog);
+    SolverTelemetry::PhaseTimer lineSearchTimer( SolverTelemetry::LINE_SEARCH );
+    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval, &solverLog, mSpeculativeSteps);
+    lineSearchTimer.stop();
 
     if(lserr != 0) {
       // line search failed.  There are a couple of things that could
@@ -580,15 +687,18 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
         // call fdjac such that it re-calculates the model at x as linesearch will
         // have left off on some other price vector thus we could have bad state
         // data from which we calculate derivatives
+        SolverTelemetry::PhaseTimer fdjacTimer( SolverTelemetry::FDJAC );
         fdjac(F,x,B);
+        fdjacTimer.stop();
         neval += x.size();
         ageB = 0;  // reset the age on B
+        luValid = false;
 
         // Log the diagonal of the new jacobian after the failed line search
         for(int j=0; j<F.narg(); ++j) {
             jdiag[j] = B(j,j);
         }
-        solverLog << "New Jacobian: diag( B )=\n" << jdiag << "\n";
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "New Jacobian: diag( B )=\n" << jdiag << "\n";
         static_cast<LogEDFun&>(F).setSlope(jdiag);
 
         // start the next iteration *without* updating x
@@ -600,9 +710,18 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       // generating very tiny dx values.  Make a relaxed convergence
       // test and return if we have a "close enough" solution.
       double msf = f0/fx.size();
+      if(msf < mFTOL && restoreFullAccuracy(F, x, fx, neval)) {
+        // The model was at reduced accuracy so this is not the solution yet.
+        f0 = inner_prod(fx,fx);
+        B = Btmp;
+        luValid = false;
+        lsfail = false;
+        continue;
+      }
       if(msf < mFTOL) {
         // basically, we're letting ourselves converge to the sqrt of
         // our intended tolerance.
+        B = Btmp;               // hand back the approximant rather than its factorization
         return 0;
       }
 
@@ -626,10 +745,11 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     double lambda = fabs(dx[0]) > 0.0 ? xstep[0] / dx[0] : 0.0;
     solverLog << "################Return from linesearch\nfold= " << f0 << "\tfnew= " << fnew
               << "\tlambda= " << lambda << "\n";
+    SolverTelemetry::getInstance().setStepLength( lambda );
 
     UBVECTOR fxnew(fx.size());
     fnorm.lastF( fxnew );            // get the last value of big-F
-    solverLog << "\nxnew: " << xnew << "\nfxnew: " << fxnew << "\n";
+    GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "\nxnew: " << xnew << "\nfxnew: " << fxnew << "\n";
     UBVECTOR fxstep(fxnew -fx); // change in F( x ).  We will need this for the secant update
 
     // log the worst market info
@@ -656,10 +776,21 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     solverLog << "Convergence test maxval: " << maxval << "  imaxval= " << imaxval << "\n";
     solverLog << "\tx[i]= " << xnew[imaxval] << "  dx[i]= " << dx[imaxval] << "  xstep[i]= "
               << xstep[imaxval] << "\n";
+    if(world->getEvalAccuracy() == World::REDUCED_ACCURACY && maxval <= mReducedAccuracyTol) {
+      // Close enough to the solution that the full accuracy model is needed.
+      // The secant update is skipped as F itself has changed.
+      x = xnew;
+      restoreFullAccuracy(F, x, fx, neval);
+      f0 = inner_prod(fx,fx);
+      B = Btmp;
+      luValid = false;
+      continue;
+    }
     if(maxval <= mFTOL) {
       solverLog << "Solution successful.\n";
       x = xnew;
       fx = fxnew;
+      B = Btmp;                 // hand back the approximant rather than its factorization
       return 0;                 // SUCCESS 
     }
 
@@ -696,6 +827,15 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       fxstep /= dx2;
       B += outer_prod(fxstep, xstep);
       ageB++;                // increment the age of B
+
+      // apply the same update to the factorization, unless it has
+      // accumulated enough updates that it is time to start fresh
+      if(luValid && lusolver.getNumUpdates() < mMaxLUUpdates) {
+        luValid = lusolver.rankOneUpdate(fxstep, xstep);
+      }
+      else {
+        luValid = false;
+      }
     }
     else {
       // Progress using the Broyden formula is anemic.  This usually
@@ -705,16 +845,19 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
         solverLog << "Insufficient progress with Broyden formula.  Resetting the Jacobian.\n(f0= " << f0 << ", fnew= " << fnew << ")\n";
         // just in case call fdjac such that it re-calculates the model at xnew
         // otherwise we could have bad state data from which we calculate derivatives
+        SolverTelemetry::PhaseTimer fdjacTimer( SolverTelemetry::FDJAC );
         fdjac(F,xnew,B);
+        fdjacTimer.stop();
         neval += x.size();
         ageB = 0;
+        luValid = false;
 
         // Log the results of the Jacobian reset
         for(int j=0; j<F.narg(); ++j) {
             jdiag[j] = B(j,j);
         }
             
-        solverLog << "New Jacobian:  diag( B )=\n" << jdiag << "\n";
+        GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "New Jacobian:  diag( B )=\n" << jdiag << "\n";
         static_cast<LogEDFun&>(F).setSlope(jdiag);
         
       }
@@ -728,12 +871,14 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     }
 
     // log the data trace before we do the update
-    reportVec("x", xnew, mktids_solv, issolvable_solv);
-    reportVec("fx", fxnew, mktids_solv, issolvable_solv);
-    reportVec("deltax", xnew-x, mktids_solv, issolvable_solv);    // xstep may have been modified above
-    reportVec("deltafx", fxnew-fx, mktids_solv, issolvable_solv); // fxstep definitely modified above
-    reportVec("diagB", jdiag, mktids_solv, issolvable_solv);
-    reportPSD(rptvec_all, mktids_all, issolvable_all);                // report price, supply, and demand.  
+    if( GCAM_SOLVER_LOG_ENABLED( ILogger::getLogger( "solver-data-log" ), ILogger::DEBUG ) ) {
+      reportVec("x", xnew, mktids_solv, issolvable_solv);
+      reportVec("fx", fxnew, mktids_solv, issolvable_solv);
+      reportVec("deltax", xnew-x, mktids_solv, issolvable_solv);    // xstep may have been modified above
+      reportVec("deltafx", fxnew-fx, mktids_solv, issolvable_solv); // fxstep definitely modified above
+      reportVec("diagB", jdiag, mktids_solv, issolvable_solv);
+      reportPSD(rptvec_all, mktids_all, issolvable_all);                // report price, supply, and demand.  
+    }
     mPerIter++;
 
     // update x, fx, f0 for next iteration
@@ -745,11 +890,137 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 
   // if we get here, then we didn't converge in the number of
   // iterations allowed us.  Return an error code
-  solverLog << "\n****************Maximum solver iterations exceeded.\nlastx: " << x
+  GCAM_SOLVER_LOG( solverLog, ILogger::DEBUG ) << "\n****************Maximum solver iterations exceeded.\nlastx: " << x
             << "\nlastF: " << fx << "\n";
   return -1;
 }
 
+/*!
+ * \brief Look up a previously converged Jacobian to use as the initial approximant.
+ * \details The store is keyed by the names of the solvable markets and the price
+ *          mode since market serial numbers are reassigned each period.  An entry
+ *          for the same period (for instance from an earlier scenario in a batch)
+ *          is preferred; otherwise the entry for the most recent earlier period is
+ *          used.  The entry is stored unscaled and is scaled by the input and
+ *          output scales of aF, which change with the forecasts each period.  The
+ *          seeded Jacobian is only an approximation; should it fail to give a
+ *          descent direction bsolve will recompute it with fdjac.
+ * \param aPeriod The current model period.
+ * \param aMktNames The names of the solvable markets in the order of the solution vector.
+ * \param aF The function being solved, for its scaling.
+ * \param aJ The matrix to seed.
+ * \return True if a suitable Jacobian was found and copied into aJ.
+ */
+bool LogBroyden::loadCachedJacobian(const int aPeriod, const std::vector<std::string> &aMktNames,
+                                    const LogEDFun &aF, UBMATRIX &aJ) const
+{
+    std::vector<std::string> key( aMktNames );
+    key.push_back( mLogPricep ? "log-price" : "linear-price" );
+    std::map<std::vector<std::string>, PeriodJacobianMap>::const_iterator storeIt = sJacobianStore.find( key );
+    if( storeIt == sJacobianStore.end() ) {
+        return false;
+    }
+
+    // find the entry for this period or the closest one before it
+    PeriodJacobianMap::const_iterator perIt = storeIt->second.upper_bound( aPeriod );
+    if( perIt == storeIt->second.begin() ) {
+        return false;
+    }
+    --perIt;
+    if( perIt->second.size1() != aJ.size1() || perIt->second.size2() != aJ.size2() ) {
+        return false;
+    }
+
+    const UBVECTOR& xscl = aF.getInputScale();
+    const UBVECTOR& fxscl = aF.getOutputScale();
+    for( size_t i = 0; i < aJ.size1(); ++i ) {
+        for( size_t j = 0; j < aJ.size2(); ++j ) {
+            aJ( i, j ) = perIt->second( i, j ) * fxscl[ i ] * xscl[ j ];
+        }
+    }
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << "Using cached Jacobian from period " << perIt->first << " for period " << aPeriod << std::endl;
+    return true;
+}
+
+/*!
+ * \brief Switch the model back to full accuracy.
+ * \details If the world is being evaluated at reduced accuracy it is set back
+ *          to full accuracy and F(x) is evaluated again with a full model
+ *          calculation so that no activity is left with its approximate
+ *          results.
+ * \param F The function being solved.
+ * \param x The current point.
+ * \param fx Set to F(x) at full accuracy.
+ * \param neval The count of evaluations, incremented if F is evaluated.
+ * \return Whether the accuracy was reduced, and so F evaluated again.
+ */
+bool LogBroyden::restoreFullAccuracy(VecFVec<double,double> &F, const UBVECTOR &x, UBVECTOR &fx, int &neval)
+{
+  if(world->getEvalAccuracy() == World::FULL_ACCURACY) {
+    return false;
+  }
+  world->setEvalAccuracy(World::FULL_ACCURACY);
+  static_cast<LogEDFun&>(F).resetIncrementalCalc();
+  F(x,fx);
+  ++neval;
+  ILogger& solverLog = ILogger::getLogger("solver_log");
+  solverLog.setLevel(ILogger::NOTICE);
+  solverLog << "Switched to full accuracy model evaluation, max |F(x)|= " << norm_inf(fx) << "\n";
+  solverLog.setLevel(ILogger::DEBUG);
+  return true;
+}
+
+/*!
+ * \brief Save a converged Jacobian for reuse.
+ * \details The scaling of aF is taken out so that the entry can be used with
+ *          the scaling of another period.
+ * \param aPeriod The current model period.
+ * \param aMktNames The names of the solvable markets in the order of the solution vector.
+ * \param aF The function being solved, for its scaling.
+ * \param aJ The Jacobian approximant from the converged solution.
+ */
+void LogBroyden::saveCachedJacobian(const int aPeriod, const std::vector<std::string> &aMktNames,
+                                    const LogEDFun &aF, const UBMATRIX &aJ) const
+{
+    std::vector<std::string> key( aMktNames );
+    key.push_back( mLogPricep ? "log-price" : "linear-price" );
+    const UBVECTOR& xscl = aF.getInputScale();
+    const UBVECTOR& fxscl = aF.getOutputScale();
+    UBMATRIX& stored = sJacobianStore[ key ][ aPeriod ];
+    stored.resize( aJ.size1(), aJ.size2(), false );
+    for( size_t i = 0; i < aJ.size1(); ++i ) {
+        for( size_t j = 0; j < aJ.size2(); ++j ) {
+            const double scale = fxscl[ i ] * xscl[ j ];
+            stored( i, j ) = scale != 0.0 ? aJ( i, j ) / scale : 0.0;
+        }
+    }
+}
+
+/*!
+ * \brief Drop the stored Jacobians which can no longer be chosen as a seed.
+ * \details Once aPeriod has been solved, later periods only seed from the
+ *          most recent entry of each key, so the entries for earlier periods
+ *          are removed as long as a newer one remains.  Note this gives up
+ *          seeding the same period of a later scenario in a batch from an
+ *          earlier one.
+ * \param aPeriod The period which has just finished.
+ */
+void LogBroyden::releaseCachedJacobians( const int aPeriod )
+{
+    typedef std::map<std::vector<std::string>, PeriodJacobianMap>::iterator StoreIterator;
+    for( StoreIterator storeIt = sJacobianStore.begin(); storeIt != sJacobianStore.end(); ++storeIt ) {
+        PeriodJacobianMap& periodJacobians = storeIt->second;
+        PeriodJacobianMap::iterator keepIt = periodJacobians.upper_bound( aPeriod );
+        if( keepIt != periodJacobians.begin() ) {
+            // keep the latest up to aPeriod
+            --keepIt;
+        }
+        periodJacobians.erase( periodJacobians.begin(), keepIt );
+    }
+}
+
 /*! \brief Write a vector into the solver data log
  *
  *  \details We write the solver data log in "long" format; i.e., with
@@ -797,8 +1068,8 @@ void LogBroyden::reportPSD(UBVECTOR &arptvec, const std::vector<int> &amktids, c
         return;
     }
 
-    std::vector<SolutionInfo> solvable = cSolInfo->getSolvableSet();
-    std::vector<SolutionInfo> unsolvable = cSolInfo->getUnsolvableSet();
+    const std::vector<SolutionInfo>& solvable = cSolInfo->getSolvableSet();
+    const std::vector<SolutionInfo>& unsolvable = cSolInfo->getUnsolvableSet();
 
     unsigned int i;
     unsigned int j;
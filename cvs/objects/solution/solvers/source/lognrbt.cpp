@@ -65,7 +65,9 @@
 #include "solution/util/include/edfun.hpp"
 #include "solution/util/include/ublas-helpers.hpp"
 #include "solution/util/include/jacobian-precondition.hpp" 
+#include "solution/util/include/linear_solver.hpp"
 #include "util/base/include/fltcmp.hpp"
+#include "solution/util/include/solve_budget.h"
 
 #if USE_LAPACK
 #include <boost/numeric/bindings/traits/ublas_vector.hpp>
@@ -131,6 +133,33 @@ bool LogNRbt::XMLParse( const DOMNode* aNode ) {
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
         } 
+        else if(nodeName == "speculative-linesearch") {
+          mSpeculativeSteps = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if(nodeName == "block-triangular") {
+          mBlockTriangular = true;
+        }
+        else if(nodeName == "mixed-precision") {
+          mMixedPrecision = true;
+        }
+        else if(nodeName == "sparse-lu") {
+          mSparseLU = true;
+        }
+        else if(nodeName == "adaptive-fd-steps") {
+          mAdaptiveSteps = true;
+        }
+        else if(nodeName == "incremental-calc-threshold") {
+          mIncrementalCalcThreshold = XMLHelper<double>::getValue( curr );
+          if( mIncrementalCalcThreshold > 0.0 ) {
+              // Skipping markets whose prices moved a little would return F at
+              // stale prices, so only exact skipping is supported.
+              ILogger& mainLog = ILogger::getLogger( "main_log" );
+              mainLog.setLevel( ILogger::WARNING );
+              mainLog << "incremental-calc-threshold " << mIncrementalCalcThreshold
+                      << " is treated as 0, only unchanged prices are skipped." << std::endl;
+              mIncrementalCalcThreshold = 0.0;
+          }
+        }
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
         }
@@ -168,7 +197,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
         return code = SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( period );
     
     // Update the solution vector for the correct markets to solve.
     // Need to update solvable status before starting solution (Ignore return code)
@@ -190,7 +219,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     }
     
     solverLog << "Initial market state:\nmkt\tprice\tsupply\tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
+    const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
     for(size_t i=0; i<solvables.size(); ++i) {
       solverLog << i << "\t" << solvables[i].getPrice()
                 << "\t" << solvables[i].getSupply()
@@ -213,6 +242,8 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
 
     // This is the closure that will evaluate the ED function
     LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+    F.setIncrementalCalc( mIncrementalCalcThreshold );
+    F.setAdaptiveSteps( mAdaptiveSteps );
 
     // scale the initial guess for use in F
     F.scaleInitInputs(x);
@@ -257,6 +288,10 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
         code = FAILURE_ZERO_GRADIENT;
         solverLog << "NR solution failed:  Encountered zero gradient in F*F.\n";
     }
+    else if(nrstatus == -5) {
+        code = FAILURE_OVER_BUDGET;
+        solverLog << "NR solution failed:  solve budget exhausted.\n";
+    }
     else if(nrstatus > 0) {
         code = FAILURE_SINGULAR_MATRIX;
         solverLog << "NR solution failed:  Encountered singular matrix (# singular components = " << nrstatus << ").\n";
@@ -278,11 +313,6 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
 int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMATRIX &J,
                      int &neval)
 {
-#if !USE_LAPACK
-  using boost::numeric::ublas::permutation_matrix;
-  using boost::numeric::ublas::lu_factorize;
-  using boost::numeric::ublas::lu_substitute;
-#endif
   using boost::numeric::ublas::axpy_prod;
   using boost::numeric::ublas::inner_prod;
   int nrow = J.size1(), ncol = J.size2();
@@ -292,9 +322,11 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
   UBVECTOR Ssv(ncol);
   int singcount = 0;
   const int scmax = nrow/2;
-#else
-  permutation_matrix<int> p(F.narg()); // permutation vector for pivoting in L-U decomposition
 #endif
+  LinearSolver lusolver;        // L-U factorization of the Jacobian
+  lusolver.setBlockTriangular(mBlockTriangular);
+  lusolver.setMixedPrecision(mMixedPrecision);
+  lusolver.setSparse(mSparseLU);
   UBMATRIX Jtmp(nrow, ncol);
   
 
@@ -326,6 +358,10 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
     return 0;
   
   for(int iter=0; iter<mMaxIter; ++iter) {
+    if( SolveBudget::getInstance().isComponentOverBudget() ) {
+      solverLog << "NR iter= " << iter << " stopping, solve budget exhausted.\n";
+      return -5;
+    }
     solverLog << "NR iter= " << iter << "\tneval= " << neval << "\n";
     axpy_prod(fx,J,gx);         // compute the gradient of F*F (= fx^T * J == J^T * fx)
     // axpy_prod clears gx on entry, so we don't have to do it.
@@ -341,6 +377,26 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
 
     Jtmp = J;                   // save the Jacobian, since gesvd destroys it.
 
+    // Try the L-U fast path first; the SVD and the preconditioner are
+    // only needed when the Jacobian is singular or badly conditioned.
+    int sing = lusolver.factorize(J);
+    solverLog << "L-U (" << LinearSolver::getBackendName() << ") sing= " << sing
+              << "  rcond= " << lusolver.getRCond() << "  blocks= " << lusolver.getNumBlocks()
+              << "  max block= " << lusolver.getMaxBlockSize()
+              << "  factor nnz= " << lusolver.getFactorNonzeros() << "\n";
+    bool luOK = sing == 0 && lusolver.isWellConditioned();
+    if(luOK) {
+      dx = -1.0*fx;
+      // fails only if mixed precision refinement stalled and J turned out
+      // to be ill-conditioned in double precision too
+      luOK = lusolver.solve(dx);       // solve dx = J^-1 F
+    }
+    if(luOK) {
+#if USE_LAPACK
+      singcount = 0;
+#endif
+    }
+    else {
 #if USE_LAPACK
     int ierr =
       boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
@@ -395,47 +451,31 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
     else
       singcount = 0;
 #else  /* No USE_LAPACK.  Use L-U decomposition to do the solution. */
-    int itrial = 0;
-    /* If the L-U decomposition fails the first time around, we will
-       invoke the jacobian preconditioner and try again.  If it fails
-       a second time, we bail out */
-    do {
-      for(size_t i=0; i<p.size(); ++i) p[i] = i;
-      int sing = lu_factorize(J,p);
-      if(sing>0) {
-        int fail=1;
-        if(itrial == 0)
-          fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
-        
-        if(fail) {
-          solverLog.setLevel(ILogger::WARNING);
-          solverLog << "Singular Jacobian:\n" << Jtmp << "\n";
-          return sing;
-        }
+    /* If the L-U decomposition failed, we will invoke the jacobian
+       preconditioner and try again.  If it fails a second time, we
+       bail out.  An ill-conditioned factorization is used as is. */
+    if(sing>0) {
+      int fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
+      if(!fail) {
+        sing = lusolver.factorize(J);
       }
-      else {
-        // L-U decomp was successful.  Continue with the next phase of the algorithm.
-        break;
+      if(fail || sing>0) {
+        solverLog.setLevel(ILogger::WARNING);
+        solverLog << "Singular Jacobian:\n" << Jtmp << "\n";
+        return fail ? fail : sing;
       }
-    } while(++itrial < 2);
+    }
     
-    // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
+    // lusolver now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
     dx = -1.0*fx;
-    try {
-      lu_substitute(J,p,dx);    // solve dx = J^-1 F
-    }
-    catch (const boost::numeric::ublas::internal_logic &err) {
-      // This error seems to be thrown when the Jacobian is
-      // ill-conditioned.  We let it go because often the solver will
-      // muddle through to a solution.  If not, then it will
-      // eventually stop with a genuinely singular matrix.
-    }
+    lusolver.solve(dx);         // solve dx = J^-1 F
 #endif /* USE_LAPACK */
+    }
     
     // dx now holds the newton step.  Execute the line search along
     // that direction.
     double fnew;
-    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval);
+    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval, 0, mSpeculativeSteps);
 
     if(lserr != 0) {
       // line search failed.  This means that the descent direction
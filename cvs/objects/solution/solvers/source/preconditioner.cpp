@@ -60,10 +60,19 @@
 #include "solution/util/include/solvable_solution_info_filter.h"
 
 #include "util/base/include/timer.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/manage_state_variables.hpp"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#endif
 
 using namespace std;
 using namespace xercesc;
 
+extern Scenario* scenario;
+
 //! Default Constructor. Constructs the base class. 
 Preconditioner::Preconditioner( Marketplace* marketplaceIn, World* worldIn, CalcCounter* calcCounterIn ) :
   SolverComponent( marketplaceIn, worldIn, calcCounterIn ),
@@ -71,7 +80,10 @@ Preconditioner::Preconditioner( Marketplace* marketplaceIn, World* worldIn, Calc
   mPriceIncreaseFac(0.25),
   mPriceDecreaseFac(0.1),
   mLargePrice(1.0e6),
-  mFTOL(util::getSmallNumber())
+  mFTOL(util::getSmallNumber()),
+  mProbeResponse(false),
+  mProbeDelta(1.0e-4),
+  mProbeMaxStep(0.5)
 {
 }
 
@@ -124,6 +136,15 @@ bool Preconditioner::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "ftol") {
             mFTOL = XMLHelper<double>::getValue(curr);
         }
+        else if( nodeName == "probe-response" ) {
+            mProbeResponse = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "probe-delta" ) {
+            mProbeDelta = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "probe-max-step" ) {
+            mProbeMaxStep = XMLHelper<double>::getValue( curr );
+        }
         else if( nodeName == "solution-info-filter" ) {
             mSolutionInfoFilter.reset(
                 SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
@@ -188,7 +209,7 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     solverLog << "Solution set before Preconditioning: " << endl << aSolutionSet << endl;
     
     
-    startMethod();
+    startMethod( aPeriod );
     
     worstMarketLog << "Market Name, X, XL, XR, ED, EDL, EDR, RED, bracketed, supply, demand" << endl;
     solverLog << "Preconditioning routine starting" << endl; 
@@ -437,6 +458,13 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     addIteration(maxred->getName(), maxred->getRelativeED());
     worstMarketLog << "###Preconditioner-" << pass << ": " << *maxred << std::endl; 
     } // end of loop over two passes
+
+    if( mProbeResponse ) {
+        probeResponses( solvable, aPeriod );
+        maxred = aSolutionSet.getWorstSolutionInfo();
+        addIteration(maxred->getName(), maxred->getRelativeED());
+        worstMarketLog << "###Preconditioner-probe: " << *maxred << std::endl;
+    }
     bisectTimer.stop();
 
     maxred = aSolutionSet.getWorstSolutionInfo();
@@ -453,3 +481,108 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     return SUCCESS;
 }
 
+/*!
+ * \brief Probe the response of each market's excess demand to its own price.
+ * \details Each market's price is perturbed by the relative probe delta in its
+ *          own "scratch" state and only the activities which depend on that
+ *          market are recalculated, using the partial derivative machinery.
+ *          The probes are independent so they are handed out across threads
+ *          when GCAM_PARALLEL_ENABLED.  For each market where excess demand
+ *          decreases with price we then take a single step towards clearing
+ *          it, limited to the probe max step, and set the demand normalization
+ *          such that the scaled own price derivative is close to -1.  Tax and
+ *          subsidy markets are constraints with known scales so are left out.
+ * \param aSolvable The solvable markets, these have already been preconditioned.
+ * \param aPeriod Model period.
+ */
+void Preconditioner::probeResponses( vector<SolutionInfo>& aSolvable, const int aPeriod ) {
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+
+    const size_t nmkt = aSolvable.size();
+    vector<double> slope( nmkt, 0.0 );
+    // Tax and subsidy markets would not be adjusted so are not probed.
+    vector<size_t> probed;
+    for( size_t i = 0; i < nmkt; ++i ) {
+        const IMarketType::Type type = aSolvable[ i ].getType();
+        if( type != IMarketType::TAX && type != IMarketType::SUBSIDY ) {
+            probed.push_back( i );
+        }
+    }
+    solverLog << "Probing own price responses of " << probed.size() << " markets.\n";
+
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    stateVars->setPartialDeriv( true );
+    marketplace->mIsDerivativeCalc = true;
+    auto probeMarket = [&]( size_t aProbe ) {
+        const size_t index = probed[ aProbe ];
+        SolutionInfo& currSol = aSolvable[ index ];
+        stateVars->copyState();
+        const double oldprice = currSol.getPrice();
+        const double olded = currSol.getED();
+        double scale = std::max( fabs( oldprice ), fabs( currSol.getForecastPrice() ) );
+        if( scale == 0.0 ) {
+            scale = 1.0;
+        }
+        const double dp = mProbeDelta * scale;
+        currSol.setPrice( oldprice + dp );
+        world->calc( aPeriod, currSol.getDependencies() );
+        slope[ index ] = ( currSol.getED() - olded ) / dp;
+    };
+#if !GCAM_PARALLEL_ENABLED
+    for( size_t i = 0; i < probed.size(); ++i ) {
+        probeMarket( i );
+    }
+#else
+    tbb::task_arena& threadPool = stateVars->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute([&](){
+        tg.run([&](){
+            tbb::parallel_for( size_t(0), probed.size(), probeMarket );
+        });
+    });
+    threadPool.execute([&tg](){ tg.wait(); });
+#endif
+    marketplace->mIsDerivativeCalc = false;
+    stateVars->setPartialDeriv( false );
+
+    solverLog << "pold    \tpnew    \tED      \tdED/dp  \tName\n";
+    int nchg = 0;
+    for( size_t i = 0; i < nmkt; ++i ) {
+        SolutionInfo& currSol = aSolvable[ i ];
+        const IMarketType::Type type = currSol.getType();
+        const double oldprice = currSol.getPrice();
+        const double ed = currSol.getED();
+        double newprice = oldprice;
+        if( slope[ i ] < 0.0 && util::isValidNumber( slope[ i ] ) &&
+            type != IMarketType::TAX && type != IMarketType::SUBSIDY )
+        {
+            double scale = std::max( fabs( oldprice ), fabs( currSol.getForecastPrice() ) );
+            if( scale == 0.0 ) {
+                scale = 1.0;
+            }
+            if( currSol.getRelativeED() >= mFTOL ) {
+                const double maxStep = mProbeMaxStep * scale;
+                const double step = std::max( -maxStep, std::min( maxStep, -ed / slope[ i ] ) );
+                newprice = oldprice + step;
+                currSol.setPrice( newprice );
+                ++nchg;
+            }
+            currSol.setForecastDemand( -slope[ i ] * scale );
+        }
+        solverLog << std::setw(8) << oldprice << "\t"
+                  << std::setw(8) << newprice << "\t"
+                  << std::setw(8) << ed << "\t"
+                  << std::setw(8) << slope[ i ] << "\t"
+                  << currSol.getName() << "\n";
+    }
+
+    if( nchg > 0 ) {
+        marketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+        world->calc(aPeriod, world->getGlobalFlowGraph());
+#else
+        world->calc(aPeriod);
+#endif
+    }
+}
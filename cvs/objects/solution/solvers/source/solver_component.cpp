@@ -45,6 +45,10 @@
 
 #include "solution/solvers/include/solver_component.h"
 #include "solution/util/include/calc_counter.h"
+#include "solution/util/include/activity_profiler.h"
+#include "solution/util/include/solver_telemetry.h"
+#include "reporting/include/performance_report.h"
+#include "containers/include/world.h"
 
 using namespace std;
 
@@ -55,7 +59,7 @@ using namespace std;
 * \param worldIn The world which will be used for solving.
 * \param calcCounterIn A pointer to the object which tracks calls to world.calc()
 */
-SolverComponent::SolverComponent( Marketplace* marketplaceIn, World* worldIn, CalcCounter* calcCounterIn ): marketplace( marketplaceIn ), world( worldIn ), calcCounter( calcCounterIn ){
+SolverComponent::SolverComponent( Marketplace* marketplaceIn, World* worldIn, CalcCounter* calcCounterIn ): marketplace( marketplaceIn ), world( worldIn ), calcCounter( calcCounterIn ), mPeriod( -1 ){
 }
 
 //! Default Destructor.
@@ -69,6 +73,9 @@ SolverComponent::IterationInfo::IterationInfo( const std::string& aName, const d
 //! Add a solution iteration to the stack.
 void SolverComponent::addIteration( const std::string& aSolName, const double aRED ){
     mPastIters.push_back( IterationInfo( aSolName, aRED ) );
+    PerformanceReport::getInstance().countSolverIteration();
+    SolverTelemetry::getInstance().recordIteration( getXMLName(), mPeriod, mPastIters.size(),
+                                                    calcCounter->getPeriodCount(), aSolName, aRED );
 }
 
 //! Check for improvement over the last n iterations
@@ -94,9 +101,14 @@ bool SolverComponent::isImproving( const unsigned int aNumIter ) const {
     return( static_cast<double>( numBetter ) / ( aNumIter - 1 ) > 0.25 );
 }
 
-void SolverComponent::startMethod(){
+void SolverComponent::startMethod( const int aPeriod ){
+    mPeriod = aPeriod;
     // Set the current calculation method.  
     calcCounter->setCurrentMethod( getXMLName() );
+    ActivityProfiler* profiler = world->getActivityProfiler();
+    if( profiler ) {
+        profiler->setCurrentComponent( getXMLName() );
+    }
     // Clear the stack.
     mPastIters.clear();
 }
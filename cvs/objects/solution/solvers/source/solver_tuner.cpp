@@ -0,0 +1,483 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solver_tuner.cpp
+ * \ingroup Objects
+ * \brief SolverTuner class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <xercesc/dom/DOMNodeList.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMImplementation.hpp>
+#include <xercesc/dom/DOMLSSerializer.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#include "solution/solvers/include/solver_tuner.h"
+#include "solution/solvers/include/solver.h"
+#include "solution/solvers/include/solver_factory.h"
+#include "solution/util/include/calc_counter.h"
+#include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/configuration.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+extern Scenario* scenario;
+
+namespace {
+    //! Holds a string transcoded for use in the DOM.
+    class DOMString {
+    public:
+        explicit DOMString( const string& aString ):mString( XMLString::transcode( aString.c_str() ) ) {
+        }
+        
+        ~DOMString() {
+            XMLString::release( &mString );
+        }
+        
+        const XMLCh* get() const {
+            return mString;
+        }
+        
+    private:
+        XMLCh* mString;
+    };
+    
+    //! Get the first child element of aNode with the given name, or null if there is none.
+    DOMNode* findChild( DOMNode* aNode, const string& aName ) {
+        DOMNodeList* nodeList = aNode->getChildNodes();
+        for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+            DOMNode* curr = nodeList->item( i );
+            if( curr->getNodeType() == DOMNode::ELEMENT_NODE &&
+                XMLHelper<string>::safeTranscode( curr->getNodeName() ) == aName )
+            {
+                return curr;
+            }
+        }
+        return 0;
+    }
+    
+    //! Write a node as XML text.
+    string serialize( const DOMNode* aNode ) {
+        DOMLSSerializer* serializer = DOMImplementation::getImplementation()->createLSSerializer();
+        XMLCh* text = serializer->writeToString( aNode );
+        const string ret = XMLHelper<string>::safeTranscode( text );
+        XMLString::release( &text );
+        serializer->release();
+        return ret;
+    }
+}
+
+/*!
+ * \brief Constructor.
+ * \param aWorld The world to calculate.
+ * \param aMarketplace The marketplace to solve.
+ */
+SolverTuner::SolverTuner( World* aWorld, Marketplace* aMarketplace ):
+mWorld( aWorld ),
+mMarketplace( aMarketplace ),
+mModeltime( 0 ),
+mNumPeriods( 0 ),
+mNumPasses( 1 ),
+mSolverConfig( 0 ),
+mIsRunning( false )
+{
+}
+
+//! Destructor.
+SolverTuner::~SolverTuner() {
+    if( mSolverConfig ) {
+        mSolverConfig->release();
+    }
+}
+
+bool SolverTuner::XMLParse( const DOMNode* aNode ) {
+    // assume we were passed a valid node.
+    assert( aNode );
+    
+    // get the children of the node.
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    
+    // loop through the children
+    for ( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        DOMNode* curr = nodeList->item( i );
+        string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+        
+        if( nodeName == "#text" || nodeName == "#comment" ) {
+            continue;
+        }
+        else if( nodeName == "telemetry-file" ) {
+            mTelemetryFiles.push_back( XMLHelper<string>::getValue( curr ) );
+        }
+        else if( nodeName == "num-periods" ) {
+            mNumPeriods = XMLHelper<int>::getValue( curr );
+        }
+        else if( nodeName == "year" ) {
+            mYears.push_back( XMLHelper<int>::getValue( curr ) );
+        }
+        else if( nodeName == "passes" ) {
+            mNumPasses = max( XMLHelper<int>::getValue( curr ), 1 );
+        }
+        else if( nodeName == "parameter" ) {
+            Parameter parameter;
+            parameter.mComponent = XMLHelper<string>::getAttr( curr, "component" );
+            parameter.mName = XMLHelper<string>::getAttr( curr, "name" );
+            DOMNodeList* valueList = curr->getChildNodes();
+            for( unsigned int j = 0; j < valueList->getLength(); ++j ) {
+                DOMNode* valueNode = valueList->item( j );
+                if( XMLHelper<string>::safeTranscode( valueNode->getNodeName() ) == "value" ) {
+                    parameter.mValues.push_back( XMLHelper<string>::getValue( valueNode ) );
+                }
+            }
+            mParameters.push_back( parameter );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing solver-tuning." << endl;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Read the solver configuration and choose the periods to tune.
+ * \param aModeltime The model time.
+ */
+void SolverTuner::init( const Modeltime* aModeltime ) {
+    mModeltime = aModeltime;
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const string solverConfigFile = Configuration::getInstance()->getFile( "solver-config", "", false );
+    if( solverConfigFile.empty() ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Solver tuning requires a solver-config to tune, no periods will be tuned." << endl;
+        return;
+    }
+    mSolverConfig = XMLHelper<void>::readDocument( solverConfigFile, false );
+    if( !mSolverConfig ) {
+        return;
+    }
+    
+    selectPeriodsFromTelemetry();
+    for( auto year : mYears ) {
+        mPeriods.push_back( mModeltime->getyr_to_per( year ) );
+    }
+    sort( mPeriods.begin(), mPeriods.end() );
+    mPeriods.erase( unique( mPeriods.begin(), mPeriods.end() ), mPeriods.end() );
+    
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Solver tuning will be done in years:";
+    for( auto period : mPeriods ) {
+        mainLog << ' ' << mModeltime->getper_to_yr( period );
+    }
+    mainLog << endl;
+}
+
+/*!
+ * \brief Add the periods with the most model evaluations in the solver
+ *        telemetry files to the periods to tune.
+ * \details The model evaluations recorded in the telemetry count up during a
+ *          period so the largest value in a file is the total for the period.
+ *          These are summed over the files.
+ */
+void SolverTuner::selectPeriodsFromTelemetry() {
+    map<int, double> totalEvaluations;
+    for( const auto& fileName : mTelemetryFiles ) {
+        ifstream telemetry( fileName.c_str() );
+        if( !telemetry.is_open() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not open solver telemetry file: " << fileName << endl;
+            continue;
+        }
+        map<int, int> fileEvaluations;
+        string line;
+        // Skip the header.
+        getline( telemetry, line );
+        while( getline( telemetry, line ) ) {
+            // The leading columns are period, component, iteration, model-evals.
+            istringstream row( line );
+            string period, component, iteration, evaluations;
+            if( getline( row, period, ',' ) && getline( row, component, ',' ) &&
+                getline( row, iteration, ',' ) && getline( row, evaluations, ',' ) )
+            {
+                int& periodEvaluations = fileEvaluations[ atoi( period.c_str() ) ];
+                periodEvaluations = max( periodEvaluations, atoi( evaluations.c_str() ) );
+            }
+        }
+        for( const auto& periodEvaluations : fileEvaluations ) {
+            totalEvaluations[ periodEvaluations.first ] += periodEvaluations.second;
+        }
+    }
+    
+    vector<pair<double, int> > byEvaluations;
+    for( const auto& periodEvaluations : totalEvaluations ) {
+        byEvaluations.push_back( make_pair( periodEvaluations.second, periodEvaluations.first ) );
+    }
+    sort( byEvaluations.rbegin(), byEvaluations.rend() );
+    for( int i = 0; i < mNumPeriods && i < static_cast<int>( byEvaluations.size() ); ++i ) {
+        mPeriods.push_back( byEvaluations[ i ].second );
+    }
+}
+
+/*!
+ * \brief Whether a period should be tuned.
+ * \param aPeriod The model period.
+ * \return True if the period was selected and can be tuned.
+ */
+bool SolverTuner::shouldTune( const int aPeriod ) const {
+    return mSolverConfig && find( mPeriods.begin(), mPeriods.end(), aPeriod ) != mPeriods.end();
+}
+
+/*!
+ * \brief Find the solver in solver-config which the Scenario uses for a period.
+ * \details As when the Scenario parses solvers the last one given for the
+ *          period, or filled out to it, is used.
+ * \param aPeriod The model period.
+ * \return The solver node or null if there is none.
+ */
+const DOMNode* SolverTuner::findSolverNode( const int aPeriod ) const {
+    const DOMNode* solverNode = 0;
+    DOMNodeList* nodeList = mSolverConfig->getDocumentElement()->getChildNodes();
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+        const DOMNode* curr = nodeList->item( i );
+        if( !SolverFactory::hasSolver( XMLHelper<string>::safeTranscode( curr->getNodeName() ) ) ) {
+            continue;
+        }
+        const int period = mModeltime->getyr_to_per( XMLHelper<int>::getAttr( curr, "year" ) );
+        if( period == aPeriod || ( period < aPeriod && XMLHelper<bool>::getAttr( curr, "fillout" ) ) ) {
+            solverNode = curr;
+        }
+    }
+    return solverNode;
+}
+
+/*!
+ * \brief Create a copy of the solver for a period with parameters changed.
+ * \param aPeriod The model period.
+ * \param aChoices The index of the value to use for each parameter, or -1 to
+ *                 leave it unchanged.
+ * \return The new solver node which the caller must release, or null if there
+ *         is no solver for the period.
+ */
+DOMNode* SolverTuner::createSolverNode( const int aPeriod, const vector<int>& aChoices ) const {
+    const DOMNode* baseNode = findSolverNode( aPeriod );
+    if( !baseNode ) {
+        return 0;
+    }
+    DOMNode* solverNode = baseNode->cloneNode( true );
+    for( size_t i = 0; i < mParameters.size(); ++i ) {
+        if( aChoices[ i ] < 0 ) {
+            continue;
+        }
+        const Parameter& parameter = mParameters[ i ];
+        const string& value = parameter.mValues[ aChoices[ i ] ];
+        DOMNode* parent = parameter.mComponent.empty() ? solverNode : findChild( solverNode, parameter.mComponent );
+        if( !parent ) {
+            continue;
+        }
+        if( parameter.mName == "enabled" ) {
+            if( value == "0" && parent != solverNode ) {
+                solverNode->removeChild( parent )->release();
+            }
+            continue;
+        }
+        DOMNode* child = findChild( parent, parameter.mName );
+        if( !child ) {
+            child = parent->appendChild( mSolverConfig->createElement( DOMString( parameter.mName ).get() ) );
+        }
+        child->setTextContent( DOMString( value ).get() );
+    }
+    return solverNode;
+}
+
+/*!
+ * \brief Solve the period from its initial state with a trial solver.
+ * \param aPeriod The model period.
+ * \param aChoices The parameter values to use.
+ * \param aSolutionInfoParamParser The solution parameters for the solvable markets.
+ * \param aSolved Set to whether the trial solver solved the period.
+ * \return The number of model evaluations used.
+ */
+int SolverTuner::evaluate( const int aPeriod, const vector<int>& aChoices,
+                           const SolutionInfoParamParser* aSolutionInfoParamParser, bool& aSolved )
+{
+    scenario->getManageStateVariables()->restoreState( mInitialState );
+    mWorld->getCalcCounter()->startNewPeriod();
+    
+    DOMNode* solverNode = createSolverNode( aPeriod, aChoices );
+    auto_ptr<Solver> solver( SolverFactory::createAndParseSolver(
+        XMLHelper<string>::safeTranscode( solverNode->getNodeName() ), mMarketplace, mWorld, solverNode ) );
+    solverNode->release();
+    aSolved = false;
+    if( !solver.get() ) {
+        return 0;
+    }
+    solver->init();
+    
+    mIsRunning = true;
+    aSolved = solver->solve( aPeriod, aSolutionInfoParamParser );
+    mIsRunning = false;
+    const int evaluations = mWorld->getCalcCounter()->getPeriodCount();
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Solver tuning trial:";
+    for( size_t i = 0; i < mParameters.size(); ++i ) {
+        if( aChoices[ i ] >= 0 ) {
+            mainLog << ' ' << mParameters[ i ].mComponent << ( mParameters[ i ].mComponent.empty() ? "" : "/" )
+                    << mParameters[ i ].mName << '=' << mParameters[ i ].mValues[ aChoices[ i ] ];
+        }
+    }
+    mainLog << " solved: " << aSolved << " evaluations: " << evaluations << endl;
+    return evaluations;
+}
+
+/*!
+ * \brief Search the parameter values for the period and write the results.
+ * \details The model must be initialized for aPeriod, including the
+ *          ManageStateVariables, and is left in the same state it was given.
+ * \param aPeriod The model period to tune.
+ * \param aSolutionInfoParamParser The solution parameters for the solvable markets.
+ */
+void SolverTuner::run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    if( !findSolverNode( aPeriod ) ) {
+        mainLog << "No solver in solver-config to tune in period " << aPeriod << endl;
+        return;
+    }
+    mainLog << "Tuning the solver in period " << aPeriod << endl;
+    
+    scenario->getManageStateVariables()->saveState( mInitialState, false );
+    
+    TunedPeriod result;
+    result.mPeriod = aPeriod;
+    result.mChoices.assign( mParameters.size(), -1 );
+    bool bestSolved;
+    result.mBaseEvaluations = evaluate( aPeriod, result.mChoices, aSolutionInfoParamParser, bestSolved );
+    result.mEvaluations = result.mBaseEvaluations;
+    
+    // Search one parameter at a time keeping any improvement.  A trial which
+    // solves is always better than one which does not.
+    for( int pass = 0; pass < mNumPasses; ++pass ) {
+        bool improved = false;
+        for( size_t i = 0; i < mParameters.size(); ++i ) {
+            for( int value = 0; value < static_cast<int>( mParameters[ i ].mValues.size() ); ++value ) {
+                if( value == result.mChoices[ i ] ) {
+                    continue;
+                }
+                vector<int> trial = result.mChoices;
+                trial[ i ] = value;
+                bool solved;
+                const int evaluations = evaluate( aPeriod, trial, aSolutionInfoParamParser, solved );
+                if( ( solved && !bestSolved ) || ( solved == bestSolved && evaluations < result.mEvaluations ) ) {
+                    result.mChoices = trial;
+                    result.mEvaluations = evaluations;
+                    bestSolved = solved;
+                    improved = true;
+                }
+            }
+        }
+        if( !improved ) {
+            break;
+        }
+    }
+    
+    // Leave the model as we found it so the period solves as it would have.
+    scenario->getManageStateVariables()->restoreState( mInitialState );
+    mWorld->getCalcCounter()->startNewPeriod();
+    
+    mainLog << "Solver tuning in period " << aPeriod << " reduced evaluations from "
+            << result.mBaseEvaluations << " to " << result.mEvaluations << endl;
+    mResults.push_back( result );
+    writeResults();
+}
+
+/*!
+ * \brief Write the solver configuration with the tuned solvers to the file
+ *        solver-tuning-output.
+ */
+void SolverTuner::writeResults() const {
+    // Keep the solvers in year order so that each fills out until the next.
+    vector<pair<int, string> > solvers;
+    DOMNodeList* nodeList = mSolverConfig->getDocumentElement()->getChildNodes();
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+        const DOMNode* curr = nodeList->item( i );
+        if( SolverFactory::hasSolver( XMLHelper<string>::safeTranscode( curr->getNodeName() ) ) ) {
+            solvers.push_back( make_pair( XMLHelper<int>::getAttr( curr, "year" ), serialize( curr ) ) );
+        }
+    }
+    for( const auto& result : mResults ) {
+        DOMNode* solverNode = createSolverNode( result.mPeriod, result.mChoices );
+        const int year = mModeltime->getper_to_yr( result.mPeriod );
+        DOMElement* solverElement = static_cast<DOMElement*>( solverNode );
+        solverElement->setAttribute( DOMString( "year" ).get(), DOMString( util::toString( year ) ).get() );
+        solverElement->setAttribute( DOMString( "fillout" ).get(), DOMString( "1" ).get() );
+        solvers.push_back( make_pair( year, "<!-- tuned: model evaluations " + util::toString( result.mBaseEvaluations )
+                                      + " -> " + util::toString( result.mEvaluations ) + " -->\n    "
+                                      + serialize( solverNode ) ) );
+        solverNode->release();
+    }
+    stable_sort( solvers.begin(), solvers.end(),
+                 []( const pair<int, string>& aLHS, const pair<int, string>& aRHS ) {
+                     return aLHS.first < aRHS.first;
+                 } );
+    
+    const string fileName = Configuration::getInstance()->getFile( "solver-tuning-output", "solver-tuning.xml", false );
+    ofstream output( fileName.c_str() );
+    if( !output.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open solver tuning output file: " << fileName << endl;
+        return;
+    }
+    output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl << "<scenario>" << endl;
+    for( const auto& solver : solvers ) {
+        output << "    " << solver.second << endl;
+    }
+    output << "</scenario>" << endl;
+}
@@ -46,6 +46,7 @@
 
 #include "solution/solvers/include/user_configurable_solver.h"
 #include "containers/include/world.h"
+#include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
 #include "solution/solvers/include/solver_component.h"
 #include "solution/solvers/include/solver_component_factory.h"
@@ -53,6 +54,7 @@
 #include "util/base/include/configuration.h"
 #include "util/logger/include/ilogger.h"
 #include "solution/util/include/calc_counter.h"
+#include "solution/util/include/solve_budget.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/util.h"
 #include "util/base/include/auto_file.h"
@@ -60,6 +62,8 @@
 using namespace std;
 using namespace xercesc;
 
+extern Scenario* scenario;
+
 // typedefs
 typedef vector<SolverComponent*>::iterator SolverComponentIterator;
 typedef vector<SolverComponent*>::const_iterator CSolverComponentIterator;
@@ -70,7 +74,9 @@ UserConfigurableSolver::UserConfigurableSolver( Marketplace* aMarketplace, World
     mDefaultSolutionTolerance( 0.001),
     mDefaultSolutionFloor( 0.0001 ),
     mCalibrationTolerance( 0.01 ),
-    mMaxModelCalcs( 2000 )
+    mMaxModelCalcs( 2000 ),
+    mFreezeIterations( 0 ),
+    mFreezeFraction( 0.1 )
 {
     // get the calc counter from the world
     mCalcCounter = world->getCalcCounter();
@@ -116,6 +122,12 @@ bool UserConfigurableSolver::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "max-model-calcs" ) {
             mMaxModelCalcs = XMLHelper<int>::getValue( curr );
         }
+        else if( nodeName == "freeze-converged-iterations" ) {
+            mFreezeIterations = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "freeze-converged-fraction" ) {
+            mFreezeFraction = XMLHelper<double>::getValue( curr );
+        }
         else if( SolverComponentFactory::hasSolverComponent( nodeName ) ) {
             SolverComponent* tempSolverComponent = SolverComponentFactory::createAndParseSolverComponent( nodeName,
                                                                                                           marketplace,
@@ -174,6 +186,7 @@ bool UserConfigurableSolver::solve( const int aPeriod, const SolutionInfoParamPa
     // This will fetch the markets to solve and update the prices, supplies and demands.
     SolutionInfoSet solution_set( marketplace );
     solution_set.init( aPeriod, mDefaultSolutionTolerance, mDefaultSolutionFloor, aSolutionInfoParamParser ); // determines solvable and unsolvable markets
+    solution_set.setConvergenceFreezing( mFreezeIterations, mFreezeFraction );
     
     mainLog << "Starting Solution. Solving for " << solution_set.getNumSolvable()
         << " markets." << endl;
@@ -208,24 +221,52 @@ bool UserConfigurableSolver::solve( const int aPeriod, const SolutionInfoParamPa
         (*it)->init();
     }
     
+    SolveBudget& budget = SolveBudget::getInstance();
+    Escalation escalation = NONE;
+    
     // Loop is done at least once.
     do {
         solverLog.setLevel( ILogger::NOTICE );
         solverLog << "Solution() loop. N: " << mCalcCounter->getPeriodCount() << endl;
         solverLog.setLevel( ILogger::DEBUG );
         
+        // Count the components which will be called in this pass so that each
+        // gets an equal share of the remaining budget.
+        int numRemaining = 0;
+        for( SolverComponentIterator it = mSolverComponents.begin(); it != mSolverComponents.end(); ++it ) {
+            if( escalation != BRACKETING_ONLY || (*it)->isBracketing() ) {
+                ++numRemaining;
+            }
+        }
+        
         // try each solver component in the order they were read
         for( SolverComponentIterator it = mSolverComponents.begin(); it != mSolverComponents.end(); ++it ) {
+            if( escalation == BRACKETING_ONLY && !(*it)->isBracketing() ) {
+                continue;
+            }
+            if( budget.isEnabled() ) {
+                budget.startComponent( 1.0 / numRemaining-- );
+            }
             // Note we are not checking the return code here since even if a solver component was able to
             // solve successfully it is not necessarily working on the entire solution set.
             solverLog << "\n%%%%%%%%%%%%%%%%Solution Set State:\n" << solution_set
                       << "\n%%%%%%%%%%%%%%%%\n";
-            (*it)->solve( solution_set, aPeriod );
+            SolverComponent::ReturnCode code = (*it)->solve( solution_set, aPeriod );
+            scenario->notifySolveProgress( aPeriod, solution_set.getMaxRelativeExcessDemand() );
+            
+            // The exception is running out of budget, which changes the strategy
+            // for the rest of the period.
+            if( code == SolverComponent::FAILURE_OVER_BUDGET && !solution_set.isAllSolved() ) {
+                escalation = escalate( escalation, *it, aPeriod );
+                break;
+            }
         }
+        budget.endComponent();
         
         // Determine if the model has solved. 
     } while ( !solution_set.isAllSolved() &&
-              mCalcCounter->getPeriodCount() < mMaxModelCalcs );
+              mCalcCounter->getPeriodCount() < mMaxModelCalcs &&
+              escalation != GIVE_UP );
     
     if( conf->getBool( "CalibrationActive" )
             && !world->isAllCalibrated( aPeriod, mCalibrationTolerance, true ) ) {
@@ -234,6 +275,11 @@ bool UserConfigurableSolver::solve( const int aPeriod, const SolutionInfoParamPa
         mainLog << "Model did not calibrate successfully in period " << aPeriod << endl;
     }
     
+#if MARKETPLACE_PROFILING
+    // log which markets the model calls for this period used the most
+    marketplace->logProfile( aPeriod );
+#endif
+    
     // Determine whether the solver was successful at solving the model.
     if( solution_set.isAllSolved() ){
         mainLog.setLevel( ILogger::NOTICE );
@@ -270,3 +316,48 @@ bool UserConfigurableSolver::solve( const int aPeriod, const SolutionInfoParamPa
 
     return false;
 }
+
+/*!
+ * \brief Choose the next strategy after a solver component ran over its share
+ *        of the solve budget and prepare the solver components for it.
+ * \param aCurrent The current strategy.
+ * \param aComponent The solver component which ran over budget.
+ * \param aPeriod The period being solved.
+ * \return The next strategy.
+ */
+UserConfigurableSolver::Escalation UserConfigurableSolver::escalate( const Escalation aCurrent,
+                                                                    const SolverComponent* aComponent,
+                                                                    const int aPeriod ) const
+{
+    const SolveBudget& budget = SolveBudget::getInstance();
+    Escalation next = GIVE_UP;
+    if( !budget.isPeriodOverBudget() ) {
+        if( aCurrent == NONE ) {
+            next = FRESH_JACOBIAN;
+        }
+        else if( aCurrent == FRESH_JACOBIAN ) {
+            // Only bracket if there is something to bracket with, otherwise
+            // there would be nothing left to call.
+            for( CSolverComponentIterator it = mSolverComponents.begin(); it != mSolverComponents.end(); ++it ) {
+                if( (*it)->isBracketing() ) {
+                    next = BRACKETING_ONLY;
+                    break;
+                }
+            }
+        }
+    }
+
+    if( next == FRESH_JACOBIAN ) {
+        for( CSolverComponentIterator it = mSolverComponents.begin(); it != mSolverComponents.end(); ++it ) {
+            (*it)->clearCachedState();
+        }
+        budget.recordDecision( aComponent->getXMLName(), aPeriod, "over budget, restarting with fresh Jacobians" );
+    }
+    else if( next == BRACKETING_ONLY ) {
+        budget.recordDecision( aComponent->getXMLName(), aPeriod, "over budget, switching to bracketing solvers" );
+    }
+    else {
+        budget.recordDecision( aComponent->getXMLName(), aPeriod, "over budget, giving up" );
+    }
+    return next;
+}
@@ -0,0 +1,213 @@
+#ifndef _ACTIVITY_PROFILER_H_
+#define _ACTIVITY_PROFILER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file activity_profiler.h
+ * \ingroup Solution
+ * \brief The header file for the ActivityProfiler class.
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <boost/core/noncopyable.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/enumerable_thread_specific.h>
+#endif
+
+class IActivity;
+class AutoOutputFile;
+
+/*!
+ * \ingroup Solution
+ * \brief Counts and times the calculation of each IActivity.
+ * \details Where the CalcCounter counts calls to World::calc the profiler
+ *          breaks the work down by activity (the region, sector, resource and
+ *          land allocator calculations of the global ordering), by solver
+ *          component, as given by CalcCounter::setCurrentMethod, and by
+ *          whether the calculation was a full model calculation or part of a
+ *          partial derivative.
+ *
+ *          Each thread accumulates into its own counters without locking.
+ *          They are merged at the end of each period by endPeriod which
+ *          writes a row for each activity that was calculated to the CSV
+ *          file given by the configuration activityProfileFileName and the
+ *          JSON file given by activityProfileJSONFileName.  If the
+ *          configuration profile-activities-trace is also set each
+ *          calculation is recorded as an event in the Chrome trace format,
+ *          viewable in chrome://tracing, in activityTraceFileName.
+ *
+ *          The profiler is only created, by World::completeInit, if the
+ *          configuration profile-activities is set.
+ */
+class ActivityProfiler : private boost::noncopyable {
+public:
+    ActivityProfiler( const std::vector<IActivity*>& aGlobalOrdering );
+
+    ~ActivityProfiler();
+
+    static bool isEnabled();
+
+    void setCurrentComponent( const std::string& aComponentName );
+
+    /*!
+     * \brief Get the index of an activity in the global ordering.
+     * \param aActivity The activity.
+     * \return The index, or -1 if it is not in the global ordering.
+     */
+    int getActivityIndex( const IActivity* aActivity ) const {
+        std::unordered_map<const IActivity*, int>::const_iterator iter = mActivityIndices.find( aActivity );
+        return iter != mActivityIndices.end() ? iter->second : -1;
+    }
+
+    void calc( IActivity* aActivity, const int aIndex, const int aPeriod );
+
+    void endPeriod( const int aPeriod );
+
+private:
+    //! The calculations are split into full model calculations and partial derivatives.
+    enum CalcType {
+        FULL,
+        PARTIAL,
+        NUM_CALC_TYPES
+    };
+
+    //! The counts and time for one activity and solver component.
+    struct ActivityStats {
+        ActivityStats();
+
+        //! The number of calculations of each CalcType.
+        unsigned long mNumCalcs[ NUM_CALC_TYPES ];
+
+        //! The total time in seconds of the calculations of each CalcType.
+        double mSeconds[ NUM_CALC_TYPES ];
+    };
+
+    //! A calculation recorded for the trace.
+    struct TraceEvent {
+        //! The index of the activity.
+        int mActivity;
+
+        //! The index of the solver component.
+        int mComponent;
+
+        //! The type of calculation.
+        CalcType mType;
+
+        //! The start of the calculation in microseconds since the profiler was created.
+        double mStart;
+
+        //! The duration of the calculation in microseconds.
+        double mDuration;
+    };
+
+    //! The counters for a single thread.
+    struct ThreadProfile {
+        ThreadProfile();
+
+        //! A number identifying the thread in the trace, or -1 if not yet assigned.
+        int mThreadId;
+
+        //! The stats by solver component then activity, each component being
+        //! mNumActivities long.
+        std::vector<ActivityStats> mStats;
+
+        //! The calculations recorded since the last endPeriod when tracing.
+        std::vector<TraceEvent> mEvents;
+    };
+
+    ThreadProfile& getThreadProfile();
+
+    void mergeProfile( ThreadProfile& aProfile, std::vector<ActivityStats>& aMerged, const int aPeriod );
+
+    void writeTrace( const ThreadProfile& aProfile, const int aPeriod );
+
+    //! The global ordering of activities being profiled.
+    const std::vector<IActivity*>& mGlobalOrdering;
+
+    //! The number of activities in the global ordering.
+    const size_t mNumActivities;
+
+    //! The index in the global ordering of each activity.
+    std::unordered_map<const IActivity*, int> mActivityIndices;
+
+    //! The names of the solver components seen so far.
+    std::vector<std::string> mComponentNames;
+
+    //! The index of the solver component which is currently calculating.
+    std::atomic<int> mCurrentComponent;
+
+    //! The next number to assign to a thread.
+    std::atomic<int> mNextThreadId;
+
+    //! Whether to record the trace.
+    const bool mIsTracing;
+
+    //! The time the profiler was created which the trace is relative to.
+    const std::chrono::steady_clock::time_point mStartTime;
+
+#if GCAM_PARALLEL_ENABLED
+    //! The counters of each thread.
+    tbb::enumerable_thread_specific<ThreadProfile> mThreadProfiles;
+#else
+    //! The counters of the only thread.
+    ThreadProfile mThreadProfile;
+#endif
+
+    //! The CSV output opened when the first period ends.
+    std::auto_ptr<AutoOutputFile> mCSVFile;
+
+    //! The JSON output opened when the first period ends.
+    std::auto_ptr<AutoOutputFile> mJSONFile;
+
+    //! The trace output opened when the first period ends if tracing.
+    std::auto_ptr<AutoOutputFile> mTraceFile;
+
+    //! Whether any period has been written to the JSON output.
+    bool mHasJSONPeriods;
+
+    //! Whether any trace event has been written.
+    bool mHasTraceEvents;
+};
+
+#endif // _ACTIVITY_PROFILER_H_
@@ -71,6 +71,8 @@ public:
     // ISolutionInfoFilter methods
     virtual bool acceptSolutionInfo( const SolutionInfo& aSolutionInfo ) const;
     
+    virtual bool isInvariantInPeriod() const;
+    
     // IParsable methods
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
 };
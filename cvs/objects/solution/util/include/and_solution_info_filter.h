@@ -48,6 +48,7 @@
 #include <vector>
 
 #include "solution/util/include/isolution_info_filter.h"
+#include "solution/util/include/solution_info_filter_cache.h"
 
 class SolutionInfo;
 
@@ -80,12 +81,24 @@ public:
     // ISolutionInfoFilter methods
     virtual bool acceptSolutionInfo( const SolutionInfo& aSolutionInfo ) const;
     
+    virtual bool isInvariantInPeriod() const;
+    
     // IParsable methods
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
     
 private:
     //! The vector of contained filters to be anded
     std::vector<ISolutionInfoFilter*> mFilters;
+    
+    //! The number of filters at the front of mFilters which are invariant
+    //! in a period
+    size_t mNumInvariant;
+    
+    //! The cached result of the invariant filters
+    SolutionInfoFilterCache mInvariantCache;
+    
+    bool acceptRange( const SolutionInfo& aSolutionInfo, const size_t aBegin,
+                      const size_t aEnd ) const;
 };
 
 #endif // _AND_SOLUTION_INFO_FILTER_H_
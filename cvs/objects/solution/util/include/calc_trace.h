@@ -0,0 +1,207 @@
+#ifndef _CALC_TRACE_H_
+#define _CALC_TRACE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file calc_trace.h
+ * \ingroup Solution
+ * \brief The header file for the CalcTrace and CalcTraceReplay classes.
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <boost/core/noncopyable.hpp>
+
+class IActivity;
+class World;
+class ManageStateVariables;
+
+/*!
+ * \ingroup Solution
+ * \brief Records the model evaluations the solver asks World::calc for
+ *        during a period so that they can be replayed without the solver.
+ * \details When the configuration calc-trace-period is set to a period the
+ *          Scenario starts a trace as it begins to solve that period and
+ *          stops it when the solvers are done.  The trace is written, as it
+ *          is recorded, to the binary file calcTraceFileName and holds:
+ *            - The active state the solve starts from.
+ *            - For each call to World::calc the market prices, demands and
+ *              supplies it started from, whether it was a partial
+ *              derivative (Marketplace::mIsDerivativeCalc and whether the
+ *              "scratch" state was in use), whether the flow graph was used
+ *              and, unless it was the whole global ordering, the calc list
+ *              as indices into the global ordering.  The market values are
+ *              written as the changes since the previous call.
+ *            - The points at which an incremental calculation in "scratch"
+ *              state was committed to the "base" state and at which the
+ *              state was restored to the start to retry with another solver.
+ *
+ *          Calls from threads calculating partial derivatives concurrently
+ *          are serialized in the order they arrive.  CalcTraceReplay reads
+ *          the file back.
+ */
+class CalcTrace : private boost::noncopyable {
+    friend class CalcTraceReplay;
+public:
+    CalcTrace( const int aPeriod, const std::vector<IActivity*>& aGlobalOrdering );
+
+    ~CalcTrace();
+
+    static bool isTracePeriod( const int aPeriod );
+
+    void recordCalc( const std::vector<IActivity*>* aCalcList, const bool aUsesFlowGraph );
+
+    void recordCommit();
+
+    void recordRestore();
+
+private:
+    //! The kinds of events in a trace.
+    enum EventType {
+        CALC = 0,
+        COMMIT = 1,
+        RESTORE = 2
+    };
+
+    //! The flags of a CALC event.
+    enum CalcFlags {
+        DERIVATIVE_CALC = 1,
+        SCRATCH_STATE = 2,
+        FLOW_GRAPH = 4,
+        FULL_MODEL = 8
+    };
+
+    //! Identifies the file as a trace in this format.
+    static const char FILE_MAGIC[ 8 ];
+
+    template<typename T>
+    void write( const T& aValue ) {
+        mFile.write( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+    }
+
+    //! The file the trace is written to, not open if the trace could not be started.
+    std::ofstream mFile;
+
+    //! Guards the file and mLastMarketState against concurrent calls.
+    std::mutex mMutex;
+
+    //! The index in the global ordering of each activity.
+    std::unordered_map<const IActivity*, unsigned int> mActivityIndices;
+
+    //! The market prices, demands and supplies as of the last CALC event.
+    std::vector<double> mLastMarketState;
+
+    //! The number of CALC events recorded.
+    size_t mNumCalcs;
+};
+
+/*!
+ * \ingroup Solution
+ * \brief Drives World::calc with the sequence of evaluations recorded by a
+ *        CalcTrace.
+ * \details The trace must be replayed on the same model, calculated up to
+ *          and initialized for the traced period, with the state of that
+ *          period being managed: the number of markets, activities and
+ *          active state values are checked against the trace.  Each replay
+ *          restores the state the solve started from and then, for each
+ *          recorded evaluation, sets the partial derivative flags, resets
+ *          the "scratch" state if it is in use, restores the market values
+ *          and calls World::calc on the same calc list.  The recorded
+ *          commits and restores are repeated as well so every replay does
+ *          the same work regardless of any change in the solvers.
+ */
+class CalcTraceReplay : private boost::noncopyable {
+public:
+    CalcTraceReplay();
+
+    bool load( const std::string& aFileName, World* aWorld );
+
+    //! The period which was traced.
+    int getPeriod() const {
+        return mPeriod;
+    }
+
+    //! The number of calls to World::calc in the trace.
+    size_t getNumCalcs() const {
+        return mNumCalcs;
+    }
+
+    bool isCompatible( const ManageStateVariables* aStateVars ) const;
+
+    void replay( ManageStateVariables* aStateVars ) const;
+
+private:
+    //! A recorded event.
+    struct Event {
+        //! The CalcTrace::EventType.
+        unsigned char mType;
+
+        //! The CalcTrace::CalcFlags of a CALC event.
+        unsigned char mFlags;
+
+        //! The market values which changed since the previous CALC event by
+        //! their index in the market blocks.
+        std::vector<std::pair<unsigned int, double> > mMarketChanges;
+
+        //! The activities to calculate if not the whole global ordering.
+        std::vector<IActivity*> mCalcList;
+    };
+
+    //! The world to calculate.
+    World* mWorld;
+
+    //! The period which was traced.
+    int mPeriod;
+
+    //! The number of markets in each market block.
+    size_t mNumMarkets;
+
+    //! The number of calls to World::calc in the trace.
+    size_t mNumCalcs;
+
+    //! The active state the solve started from.
+    std::vector<double> mInitialState;
+
+    //! The events in the order they were recorded.
+    std::vector<Event> mEvents;
+};
+
+#endif // _CALC_TRACE_H_
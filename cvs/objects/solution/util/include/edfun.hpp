@@ -44,6 +44,8 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <string>
+#include <utility>
 #include "marketplace/include/marketplace.h"
 #include "containers/include/world.h"
 #include "solution/util/include/solution_info_set.h"
@@ -97,6 +99,59 @@ class LogEDFun : public VecFVec<double,double>
 
   // diagnostic variables
   std::vector<double> mstate;
+
+  //! Flag indicating whether partial derivatives may be evaluated in column groups
+  bool mUseColumnGroups;
+  //! Structurally independent groups of columns (lazily computed)
+  std::vector<std::vector<int> > mColumnGroups;
+  //! The rows that may be affected by perturbing each column
+  std::vector<std::vector<int> > mAffectedRows;
+  //! The ordered list of activities to calculate for each column group
+  std::vector<std::vector<IActivity*> > mGroupCalcLists;
+
+  //! Zero to evaluate only the dependencies of changed prices, negative to always do a full evaluation
+  double mIncrementalThreshold;
+  //! The unscaled inputs which are currently set in the "base" state
+  UBVECTOR<double> mLastX;
+  //! The position of each activity in the global ordering (lazily computed)
+  std::map<IActivity*, int> mOrderIndex;
+
+  /*!
+   * \brief What has been learned about the finite difference step of a market.
+   * \details The relative step starts at BASE_STEP.  A difference that is lost
+   *          in the noise of the market's response raises both the noise
+   *          estimate and the step.  Otherwise the change in the derivative
+   *          between Jacobians taken at different prices gives an estimate of
+   *          the curvature, from which the step that balances truncation and
+   *          noise error, 2*sqrt(noise/curvature), is taken.
+   */
+  struct FDStep {
+    FDStep():mRelStep(BASE_STEP), mNoise(0.0), mCurvature(0.0), mLastPeriod(-1), mLastX(0.0), mLastDeriv(0.0) {}
+    //! The step relative to the magnitude of the input
+    double mRelStep;
+    //! Estimate of the noise in the market's (scaled) excess demand
+    double mNoise;
+    //! Estimate of the magnitude of the second derivative of the excess demand
+    double mCurvature;
+    //! The period of the last reliable derivative, or -1 if there is none
+    int mLastPeriod;
+    //! The input at which the last reliable derivative was taken
+    double mLastX;
+    //! The last reliable diagonal derivative
+    double mLastDeriv;
+  };
+  //! The step state of each market if adaptive steps are used, otherwise empty
+  std::vector<FDStep*> mSteps;
+  //! The step state by market name and price mode.  This is static so that it
+  //! persists across periods and across scenarios run in the same process.
+  static std::map<std::pair<std::string, bool>, FDStep> sStepStore;
+
+  void setPrices(const UBVECTOR<double> &x);
+  bool incrementalCalc(const UBVECTOR<double> &x);
+  const std::map<IActivity*, int>& getOrderIndex();
+  void collectOutputs(const UBVECTOR<double> &x, UBVECTOR<double> &fx);
+  double supplyCorrection(const int i, const double x, const double s) const;
+  double modelPrice(const double x) const {return mLogPricep ? (x > ARGMAX ? PMAX : exp(x)) : x;}
 public:
   LogEDFun(SolutionInfoSet &sisin, World *w, Marketplace *m, int per, bool aLogPricep=true);
   
@@ -104,14 +159,38 @@ public:
   virtual void operator()(const UBVECTOR<double> &x, UBVECTOR<double> &fx, const int partj=-1);
   virtual void partial(int ip);
   virtual double partialSize(int ip) const;
+  virtual bool columnGroups(std::vector<std::vector<int> > &aGroups,
+                            std::vector<std::vector<int> > &aAffectedRows);
+  virtual void evalGroup(const UBVECTOR<double> &x, UBVECTOR<double> &fx, const int aGroup);
+  virtual bool analyticColumn(const UBVECTOR<double> &ax, const UBVECTOR<double> &fx, const int j,
+                              const double h, UBVECTOR<double> &col);
+  virtual bool evalConcurrent(const std::vector<UBVECTOR<double> > &ax,
+                              std::vector<UBVECTOR<double> > &fx);
+  virtual double stepSize(const int j, const double xj) const;
+  virtual bool checkColumn(const int j, const double xj, const double h, const double fj, const double fjh);
+  void setColumnGrouping(const bool aUseColumnGroups);
+  void setAdaptiveSteps(const bool aAdaptiveSteps);
+  void setIncrementalCalc(const double aThreshold);
+  void resetIncrementalCalc();
   void scaleInitInputs(UBVECTOR<double> &ax);
   void setSlope(UBVECTOR<double> &adx);
+  //! The scale of the inputs: the model inputs are the inputs times these.
+  const UBVECTOR<double>& getInputScale() const {return mxscl;}
+  //! The scale of the outputs: the outputs are the model outputs times these.
+  const UBVECTOR<double>& getOutputScale() const {return mfxscl;}
 
   // Constants to protect against overflow: 
   static const double PMAX;            //!< Greatest allowable price
   static const double ARGMAX;          //!< log of greatest allowable price
   //! smallest value allowed for rescaling x values
   static const double MINXSCL;
+  //! largest fraction of the global ordering worth recalculating incrementally
+  static const double INCREMENTAL_MAX_FRACTION;
+  //! relative finite difference step used until a market's own is learned
+  static const double BASE_STEP;
+  //! bounds on the relative finite difference step of a market
+  static const double MIN_STEP;
+  static const double MAX_STEP;
 
 protected:
   // scale factors for input and output
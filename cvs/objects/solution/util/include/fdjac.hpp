@@ -57,39 +57,54 @@
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/task_group.h>
 #include <tbb/parallel_for_each.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 #endif
 
 #include "util/base/include/timer.h"
+#include "util/base/include/tracepoints.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/manage_state_variables.hpp"
 
 extern Scenario* scenario;
 
 /*!
- * Compute a single column in a Jacobian matrix.  We have broken this
- * out from the fdjac subroutine so that we can easily test a single
- * column for nonsingularity without duplicating any code.
+ * Compute a single column in a Jacobian matrix using caller supplied
+ * workspace.  xx must hold a copy of x on entry and is restored on
+ * exit, so that a caller computing many columns only needs to set up
+ * the workspace once.  heps is the step relative to x[j], or 0 to use
+ * the step chosen by F.  Returns false if F found the column to be
+ * unreliable, in which case it should be computed again.
  */
 template<class FTYPE,class MTRAIT>
-inline void jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
-                  const UBLAS::vector<FTYPE> &fx, int j, 
-                  UBLAS::matrix<FTYPE,MTRAIT> &J,
-                  bool usepartial=true, std::ostream *diagnostic=NULL) {
-  const FTYPE heps = 1.0e-6;
+inline bool jacol_ws(VecFVec<FTYPE,FTYPE> &F, UBLAS::vector<FTYPE> &xx,
+                     UBLAS::vector<FTYPE> &fxx, const UBLAS::vector<FTYPE> &fx, int j,
+                     UBLAS::matrix<FTYPE,MTRAIT> &J,
+                     bool usepartial=true, std::ostream *diagnostic=NULL,
+                     const FTYPE heps=0.0) {
   const FTYPE TINY = 1.0e-6;
-  UBLAS::vector<FTYPE> xx(x); // temporary, so we can respect the const on x
-  UBLAS::vector<FTYPE> fxx(fx.size());        // hold the values of F(xx)
   FTYPE t = xx[j];            // store the old value
-  FTYPE h = heps * (fabs(t)+TINY);
+  FTYPE h = heps > 0.0 ? heps * (fabs(t)+TINY) : F.stepSize(j, t);
   
   xx[j] = t+h;
   h     = xx[j]-t; // reduce roundoff error, since (t+h)-t is not
                    // necessarily identical to the original h
+  xx[j] = t;
+  // the function may be able to tell us the column without an evaluation
+  if(F.analyticColumn(xx, fx, j, h, fxx)) {
+    for(size_t i=0; i<fxx.size(); ++i) {
+      J(i,j) = fxx[i];
+    }
+    return true;
+  }
+  xx[j] = t+h;
   if(diagnostic) {
       (*diagnostic) << "j= " << j << "\th= " << h << "\nxx:\n" << xx << "\n";
   } 
+  GCAM_TRACE_BEGIN(fdjac_column, j, usepartial);
   if(usepartial) {F.partial(j);}    // hint to the function that this is a partial derivative calculation
     F(xx,fxx, usepartial ? j : -1);       // eval the function
+  GCAM_TRACE_END(fdjac_column, j, usepartial);
   xx[j] = t;       // restore the old value
   
   if(diagnostic) {
@@ -101,6 +116,135 @@ inline void jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
   for(size_t i=0; i<fxx.size(); ++i) {
     J(i,j) = (fxx[i] - fx[i]) * hinv;
   } 
+  return F.checkColumn(j, t, h, fx[j], fxx[j]);
+}
+
+/*!
+ * Compute a single column in a Jacobian matrix.  We have broken this
+ * out from the fdjac subroutine so that we can easily test a single
+ * column for nonsingularity without duplicating any code.
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                  const UBLAS::vector<FTYPE> &fx, int j, 
+                  UBLAS::matrix<FTYPE,MTRAIT> &J,
+                  bool usepartial=true, std::ostream *diagnostic=NULL) {
+  UBLAS::vector<FTYPE> xx(x); // temporary, so we can respect the const on x
+  UBLAS::vector<FTYPE> fxx(fx.size());        // hold the values of F(xx)
+  jacol_ws(F, xx, fxx, fx, j, J, usepartial, diagnostic);
+}
+
+/*!
+ * Compute the contiguous block of columns [aBegin, aEnd) of a Jacobian
+ * matrix.  The workspace is set up once for the whole block, which
+ * is how the parallel version of fdjac hands out work so that the
+ * per-task overhead is paid once per block rather than once per
+ * column.  Columns found to be unreliable are flagged in aRedo.
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacblock(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                     const UBLAS::vector<FTYPE> &fx, const size_t aBegin, const size_t aEnd,
+                     UBLAS::matrix<FTYPE,MTRAIT> &J, std::vector<char> &aRedo,
+                     bool usepartial=true, std::ostream *diagnostic=NULL) {
+  UBLAS::vector<FTYPE> xx(x);
+  UBLAS::vector<FTYPE> fxx(fx.size());
+  for(size_t j=aBegin; j<aEnd; ++j) {
+    aRedo[j] = !jacol_ws(F, xx, fxx, fx, j, J, usepartial, diagnostic);
+  }
+}
+
+
+/*!
+ * Compute all of the columns in a single group of structurally
+ * independent columns with one function evaluation.  Each column in
+ * the group gets its own step size.  Only the rows that the function
+ * reported as affected by a column are filled in; all other entries
+ * in the column are zero by construction.  Columns the function can
+ * supply analytically are not perturbed, and if that covers the whole
+ * group the function evaluation is skipped entirely.  Columns found to
+ * be unreliable are flagged in aRedo.
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacgroup(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                     const UBLAS::vector<FTYPE> &fx, const int aGroup,
+                     const std::vector<int> &aCols,
+                     const std::vector<std::vector<int> > &aAffectedRows,
+                     UBLAS::matrix<FTYPE,MTRAIT> &J, std::vector<char> &aRedo) {
+  UBLAS::vector<FTYPE> xx(x);
+  UBLAS::vector<FTYPE> fxx(fx.size());
+  UBLAS::vector<FTYPE> h(aCols.size());
+  std::vector<bool> analytic(aCols.size(), false);
+  int firstPerturbed = -1;
+
+  for(size_t k=0; k<aCols.size(); ++k) {
+    int j = aCols[k];
+    FTYPE t = xx[j];
+    // compute the step size as in jacol; use fxx as scratch for
+    // any column the function can supply
+    h[k] = (t + F.stepSize(j, t)) - t;
+    if(F.analyticColumn(x, fx, j, h[k], fxx)) {
+      analytic[k] = true;
+      for(size_t i=0; i<fxx.size(); ++i) {
+        J(i,j) = fxx[i];
+      }
+    }
+    else {
+      xx[j] = t + h[k];
+      if(firstPerturbed < 0) {
+        firstPerturbed = j;
+      }
+    }
+  }
+  if(firstPerturbed < 0) {
+    return;
+  }
+
+  F.partial(firstPerturbed);    // hint to the function that this is a partial derivative calculation
+  F.evalGroup(xx,fxx,aGroup);
+
+  for(size_t k=0; k<aCols.size(); ++k) {
+    if(analytic[k]) {
+      continue;
+    }
+    int j = aCols[k];
+    FTYPE hinv = 1.0/h[k];
+    for(size_t i=0; i<fxx.size(); ++i) {
+      J(i,j) = 0.0;
+    }
+    const std::vector<int> &rows = aAffectedRows[j];
+    for(size_t r=0; r<rows.size(); ++r) {
+      J(rows[r],j) = (fxx[rows[r]] - fx[rows[r]]) * hinv;
+    }
+    // no other column in the group affects row j
+    aRedo[j] = !F.checkColumn(j, x[j], h[k], fx[j], fxx[j]);
+  }
+}
+
+/*!
+ * Compute again, one at a time, the columns of a Jacobian matrix that
+ * were flagged as unreliable, with the steps F has since revised.  A
+ * column may be retried up to MAXPASS times, after which it is kept as
+ * it is.
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacredo(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                    const UBLAS::vector<FTYPE> &fx, UBLAS::matrix<FTYPE,MTRAIT> &J,
+                    std::vector<char> &aRedo, bool usepartial=true) {
+  const int MAXPASS = 3;
+  UBLAS::vector<FTYPE> xx(x);
+  UBLAS::vector<FTYPE> fxx(fx.size());
+  for(int pass=0; pass<MAXPASS; ++pass) {
+    bool anyRedo = false;
+    for(size_t j=0; j<aRedo.size(); ++j) {
+      if(aRedo[j]) {
+        aRedo[j] = !jacol_ws(F, xx, fxx, fx, j, J, usepartial, NULL);
+        anyRedo = anyRedo || aRedo[j];
+      }
+    }
+    if(!anyRedo) {
+      break;
+    }
+  }
 }
 
 
@@ -150,23 +294,58 @@ void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
   Timer& jacTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::JACOBIAN );
   jacTimer.start();
     if(usepartial) { scenario->getManageStateVariables()->setPartialDeriv(true); }
-  
+
+  // If the function can tell us which columns are structurally
+  // independent we can perturb an entire group of them with each
+  // model evaluation.
+  std::vector<std::vector<int> > groups, affectedRows;
+  if(usepartial && F.columnGroups(groups, affectedRows)) {
+    if(diagnostic) {
+      (*diagnostic) << "fdjac: " << x.size() << " columns in " << groups.size() << " groups\n";
+    }
+    std::vector<char> redo(x.size(), 0);
 #if !GCAM_PARALLEL_ENABLED
-  for(size_t j=0; j<x.size(); ++j) {
-    jacol(F, x, fx, j, J, usepartial, diagnostic);
+    for(size_t g=0; g<groups.size(); ++g) {
+      jacgroup(F, x, fx, g, groups[g], affectedRows, J, redo);
+    }
+#else
+    tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute([&](){
+        tg.run([&](){
+            tbb::parallel_for( size_t(0), groups.size(), [&]( size_t g ) {
+                jacgroup(F, x, fx, g, groups[g], affectedRows, J, redo);
+            });
+        });
+    });
+    threadPool.execute([&tg](){ tg.wait(); });
+#endif
+    jacredo(F, x, fx, J, redo);
+    F.partial(-1);
+    jacTimer.stop();
+    return;
   }
+  
+  std::vector<char> redo(x.size(), 0);
+#if !GCAM_PARALLEL_ENABLED
+  jacblock(F, x, fx, 0, x.size(), J, redo, usepartial, diagnostic);
 #else
+    // hand out the columns in contiguous blocks; the partitioner picks the
+    // block size to balance the load across the threads
     tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
     tbb::task_group tg;
     threadPool.execute([&](){
         tg.run([&](){
-            tbb::parallel_for_each( x, [&]( const FTYPE& j ) {
-                jacol(F, x, fx, (&j - &x[0]), J, usepartial, 0/*diagnostic*/);
+            tbb::parallel_for( tbb::blocked_range<size_t>( 0, x.size() ),
+                               [&]( const tbb::blocked_range<size_t>& aRange ) {
+                jacblock(F, x, fx, aRange.begin(), aRange.end(), J, redo, usepartial, 0/*diagnostic*/);
             });
         });
     });
     threadPool.execute([&tg](){ tg.wait(); });
 #endif
+    // recompute only the columns that were found to be unreliable
+    jacredo(F, x, fx, J, redo, usepartial);
     if(usepartial) { F.partial(-1); }
 
   jacTimer.stop();
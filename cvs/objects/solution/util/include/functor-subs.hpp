@@ -66,6 +66,19 @@ public:
     F(x,lstF);
     return inner_prod(lstF,lstF);
   }
+  //! Concurrent evaluation if F supports it.  lastF is not modified.
+  virtual bool evalConcurrent(const std::vector<UBLAS::vector<Ta> > &aArgs,
+                              std::vector<Tr> &aRvals) {
+    std::vector<UBLAS::vector<Tr> > fvals;
+    if(!F.evalConcurrent(aArgs, fvals)) {
+      return false;
+    }
+    aRvals.resize(fvals.size());
+    for(size_t k=0; k<fvals.size(); ++k) {
+      aRvals[k] = inner_prod(fvals[k],fvals[k]);
+    }
+    return true;
+  }
   virtual void prn_diagnostic(std::ostream *out) {
     int ifmax=0;
     double fmax=fabs(lstF[0]);
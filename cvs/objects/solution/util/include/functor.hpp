@@ -45,6 +45,8 @@
  */
 
 #include <iostream>
+#include <vector>
+#include <cmath>
 #include <boost/numeric/ublas/vector.hpp> 
 
 #define UBVECTOR boost::numeric::ublas::vector
@@ -110,6 +112,96 @@ public:
    * derivative.
    */
   virtual double partialSize(int ip) const {return 1.0;}
+  /*!
+   * Partition the columns of the Jacobian into structurally independent groups
+   *
+   * Two columns are structurally independent if no element of the
+   * return vector depends on both of the corresponding input
+   * elements.  All of the columns in a group can therefore be
+   * perturbed together in a single function evaluation.  The default
+   * implementation has no structural information and declines.
+   *
+   * \param[out] aGroups: The input indices in each group.
+   * \param[out] aAffectedRows: For each input index, the indices of the
+   *             return vector that may change when it is perturbed.
+   * \return True if a grouping was provided, false otherwise.
+   */
+  virtual bool columnGroups(std::vector<std::vector<int> > &aGroups,
+                            std::vector<std::vector<int> > &aAffectedRows) {return false;}
+  /*!
+   * Evaluate the function for a perturbation of all of the inputs in one column group
+   *
+   * The caller must have already signaled the partial derivative with
+   * partial() using any member of the group.  The default
+   * implementation just does a full evaluation.
+   *
+   * \param aGroup: Index into the groups returned by columnGroups.
+   */
+  virtual void evalGroup(const UBVECTOR<Ta> &arg, UBVECTOR<Tr> &rval, const int aGroup) {(*this)(arg,rval);}
+  /*!
+   * Supply a column of the Jacobian without evaluating the function
+   *
+   * Implementations that know the partial derivatives for an input
+   * analytically (at least in some regime) may fill in the column
+   * directly.  The result should be what a finite difference with
+   * the given step would produce.  The default implementation
+   * declines.
+   *
+   * \param[in] arg: The point at which the Jacobian is being computed.
+   * \param[in] rval: The function value at arg.
+   * \param[in] j: The input index of the column.
+   * \param[in] h: The finite difference step for input j.
+   * \param[out] col: The column of the Jacobian.
+   * \return True if the column was supplied, false otherwise.
+   */
+  virtual bool analyticColumn(const UBVECTOR<Ta> &arg, const UBVECTOR<Tr> &rval, const int j,
+                              const Ta h, UBVECTOR<Tr> &col) {return false;}
+  /*!
+   * Choose the finite difference step for an input
+   *
+   * The default implementation uses the same relative step for every
+   * input.  Implementations that learn how noisy and how curved each
+   * input's response is may choose a step for each one.
+   *
+   * \param j: The input index of the column.
+   * \param xj: The value of input j at which the Jacobian is being computed.
+   * \return The step to take in input j.
+   */
+  virtual Ta stepSize(const int j, const Ta xj) const {return 1.0e-6 * (fabs(xj)+1.0e-6);}
+  /*!
+   * Check a finite difference column of the Jacobian
+   *
+   * Called by fdjac with the diagonal element of the function at the
+   * unperturbed and perturbed points for every column it computes by
+   * finite differences.  Implementations may use these to revise the
+   * step stepSize will return.  The default implementation accepts
+   * every column.
+   *
+   * \param j: The input index of the column.
+   * \param xj: The value of input j at which the Jacobian is being computed.
+   * \param h: The step taken in input j.
+   * \param fj: Element j of the function at the unperturbed point.
+   * \param fjh: Element j of the function at the perturbed point.
+   * \return False if the column is unreliable and should be computed
+   *         again with the (revised) step from stepSize.
+   */
+  virtual bool checkColumn(const int j, const Ta xj, const Ta h, const Tr fj, const Tr fjh) {return true;}
+  /*!
+   * Evaluate the function at several points at once
+   *
+   * Implementations that can evaluate independent points
+   * concurrently (e.g., each in its own scratch copy of the model
+   * state) may override this.  The evaluations must not disturb the
+   * state left by the last regular call, so a caller that wants to
+   * continue from one of the points must evaluate it again normally.
+   * The default implementation declines.
+   *
+   * \param[in] aArgs: The argument vectors.
+   * \param[out] aRvals: The return vectors, one per argument.
+   * \return True if the points were evaluated, false otherwise.
+   */
+  virtual bool evalConcurrent(const std::vector<UBVECTOR<Ta> > &aArgs,
+                              std::vector<UBVECTOR<Tr> > &aRvals) {return false;}
   /*!
    * Turns on implementation-defined diagnostics (default is no-op)
    */
@@ -154,6 +246,13 @@ public:
    * Returns the length of the argument vector required by the function
    */
   int narg() const {return na;}
+  /*!
+   * Evaluate the function at several points at once (see
+   * VecFVec::evalConcurrent).  The default implementation declines.
+   * \return True if the points were evaluated, false otherwise.
+   */
+  virtual bool evalConcurrent(const std::vector<UBVECTOR<Ta> > &aArgs,
+                              std::vector<Tr> &aRvals) {return false;}
   //! diagnostic output does nothing by default
   virtual void prn_diagnostic(std::ostream *out) {}
 };
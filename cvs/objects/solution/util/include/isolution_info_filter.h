@@ -67,6 +67,19 @@ public:
      * \return True if the SolutionInfo should be included, false otherwise.
      */
     virtual bool acceptSolutionInfo( const SolutionInfo& aSolutionInfo ) const = 0;
+    
+    /*!
+     * \brief Whether the result of this filter for a market can not change
+     *        during a period.
+     * \details Filters which only look at fixed attributes of a market such
+     *          as its name or type may return true which allows composite
+     *          filters to cache their result.  Filters which depend on prices,
+     *          supplies, or demands must return false.
+     * \return True if the result of acceptSolutionInfo is fixed for a period.
+     */
+    virtual bool isInvariantInPeriod() const {
+        return false;
+    }
 };
 
 // Inline function definitions.
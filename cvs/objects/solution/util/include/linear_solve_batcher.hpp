@@ -0,0 +1,161 @@
+#ifndef _LINEAR_SOLVE_BATCHER_HPP_
+#define _LINEAR_SOLVE_BATCHER_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+ * @file linear_solve_batcher.hpp
+ * @ingroup Solution
+ * @brief Factors a batch of LU decompositions together on a GPU
+ */
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+
+#ifndef USE_CUBLAS
+#define USE_CUBLAS 0
+#endif
+
+#if USE_CUBLAS
+#include <cublas_v2.h>
+#endif
+
+/*!
+ * @class LinearSolveBatcher
+ * @brief Factors many independent dense matrices with one batched GPU routine.
+ * @details A block triangular factorization of the market Jacobian leaves
+ *          many diagonal blocks, typically of a few sizes, which are each too
+ *          small to keep a GPU busy.  LinearSolver hands all of those of a
+ *          factorization to factorize at once, which dispatches those of the
+ *          same dimension as a single cublasDgetrfBatched call.  The caller
+ *          does not wait for any other factorization to join the batch.
+ *
+ *          Batching is only enabled if the model was built with USE_CUBLAS,
+ *          the configuration batch-linear-solves is set and a device could
+ *          be initialized.  Matrices smaller than linear-solve-batch-min-size
+ *          are not worth the transfer and are not batched.  If the device
+ *          fails at any point batching is turned off and the matrices of the
+ *          failed batch, and every one after, are factored by the CPU backend
+ *          of LinearSolver.
+ */
+class LinearSolveBatcher : private boost::noncopyable {
+public:
+    //! A matrix to factor as part of a batch.
+    struct Matrix {
+        //! The column major matrix, overwritten by its factors.
+        double* mLU;
+
+        //! The 1-based row interchanges in the LAPACK convention.
+        int* mPivots;
+
+        //! The dimension of the matrix.
+        int mN;
+
+        //! The LAPACK style info returned for the matrix.
+        int mInfo;
+
+        //! Whether the matrix was factored, false if it must be done on the CPU.
+        bool mIsFactored;
+    };
+
+    static LinearSolveBatcher& getInstance();
+
+    ~LinearSolveBatcher();
+
+    /*!
+     * \brief Whether factorizations of the given dimension should be batched.
+     * \param aN The dimension of the matrix.
+     * \return True if batching is enabled and the matrix is large enough.
+     */
+    bool shouldBatch( const int aN ) const {
+        return mIsEnabled && aN >= mMinSize;
+    }
+
+    void factorize( std::vector<Matrix>& aBatch );
+
+private:
+    LinearSolveBatcher();
+
+    bool factorizeOnDevice( const std::vector<Matrix*>& aGroup );
+
+    //! Whether batching is enabled, cleared if the device fails.
+    std::atomic<bool> mIsEnabled;
+
+    //! The smallest dimension of matrix which is batched.
+    const int mMinSize;
+
+#if USE_CUBLAS
+    bool reserveDevice( const size_t aBatchSize, const size_t aN );
+
+    //! Serializes the use of the device by batches dispatched concurrently.
+    std::mutex mDeviceMutex;
+
+    //! The cuBLAS library handle.
+    cublasHandle_t mHandle;
+
+    //! The matrices of a batch, one after the other, on the device.
+    double* mDeviceLU;
+
+    //! The device pointers to each matrix in mDeviceLU, on the device.
+    double** mDevicePointers;
+
+    //! The row interchanges of each matrix on the device.
+    int* mDevicePivots;
+
+    //! The info of each matrix on the device.
+    int* mDeviceInfo;
+
+    //! The number of doubles allocated in mDeviceLU.
+    size_t mDeviceLUSize;
+
+    //! The number of matrices mDevicePointers and mDeviceInfo have room for.
+    size_t mDeviceBatchSize;
+
+    //! The number of ints allocated in mDevicePivots.
+    size_t mDevicePivotsSize;
+
+    //! Host staging for the matrices of a batch.
+    std::vector<double> mHostLU;
+
+    //! Host staging for the row interchanges of a batch.
+    std::vector<int> mHostPivots;
+#endif
+};
+
+#endif // _LINEAR_SOLVE_BATCHER_HPP_
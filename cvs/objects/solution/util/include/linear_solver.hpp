@@ -0,0 +1,328 @@
+#ifndef LINEAR_SOLVER_HPP_
+#define LINEAR_SOLVER_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+*
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+*
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+*
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * @file linear_solver.hpp
+ * @ingroup Solution
+ * @brief Dense LU solver for the Newton/Broyden step with a selectable backend
+ */
+
+#include <vector>
+#include <cassert>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include "util/base/include/tracepoints.h"
+
+#ifndef USE_EIGEN
+#define USE_EIGEN 0
+#endif
+
+/*!
+ * @class LinearSolver
+ * @brief LU factorization and back substitution for a square dense matrix
+ * @details The factorization is done by the backend selected at compile
+ *          time: LAPACK dgetrf/dgetrs when USE_LAPACK is set (this also
+ *          covers MKL, which supplies the same symbols), Eigen's partial
+ *          pivot LU when USE_EIGEN is set, and a built-in partial pivot
+ *          LU otherwise.  The factors are kept in column major order with
+ *          0-based LAPACK style row interchanges so that all backends
+ *          leave the object in the same state.
+ *
+ *          Along with the factors we keep an estimate of the reciprocal
+ *          condition number, which the solvers use to decide whether the
+ *          LU step can be trusted or whether to fall back to the (much
+ *          more expensive) SVD solve.
+ *
+ *          Rank-one changes to the matrix, such as a Broyden secant
+ *          update, can be applied to an existing factorization with
+ *          rankOneUpdate.  These are kept in product form and applied
+ *          with the Sherman-Morrison formula in solve, so that each
+ *          update and solve costs O(n^2) rather than the O(n^3) of a new
+ *          factorization.
+ *
+ *          With the configuration batch-linear-solves, and a build with
+ *           USE_CUBLAS, the double precision factorization of large enough
+ *          matrices is done on the GPU by LinearSolveBatcher.  In block
+ *          triangular form all of the large enough diagonal blocks are
+ *          handed over together so that those of the same size are factored
+ *          in a single batched call.  The other backends remain the fallback
+ *          for any matrix the GPU could not factor.
+ *
+ *          With setMixedPrecision large matrices are factored in single
+ *          precision and each solve is refined to double precision accuracy
+ *          with residuals computed against the double precision matrix,
+ *          falling back to a double precision factorization if the matrix
+ *          is too ill-conditioned for refinement to converge.
+ *
+ *          Optionally the matrix can be permuted to block lower triangular
+ *          form before it is factored.  The diagonal blocks are the strongly
+ *          connected components of the graph of nonzero entries (row i
+ *          depends on column j if A(i,j) != 0), which for the market
+ *          Jacobian are groups of markets whose prices and excess demands
+ *          feed back on one another.  Only the diagonal blocks need to be
+ *          factored, each independently of the others, and the solve
+ *          proceeds block by block in topological order.  When the markets
+ *          split into many small blocks (e.g. regional markets that do not
+ *          trade) this replaces one large O(n^3) factorization with many
+ *          small ones.
+ *
+ *          With setSparse matrices which are sparse enough are factored with
+ *          a left-looking (Gilbert-Peierls) sparse LU in compressed column
+ *          form, after a minimum degree ordering of the pattern of A+A^T to
+ *          limit the fill.  Combined with block triangular form this is the
+ *          scheme used by KLU.  The sparse factors take the place of the dense
+ *          ones, so a matrix with a few nonzeros per row costs close to
+ *          O(nnz) to factor and store rather than O(n^3) and O(n^2).  Dense
+ *          matrices, or those with an ordering that would fill in too much,
+ *          are factored densely as usual.
+ */
+class LinearSolver {
+public:
+    LinearSolver();
+
+    void setBlockTriangular( const bool aUseBlocks );
+
+    void setMixedPrecision( const bool aMixedPrecision );
+
+    void setSparse( const bool aSparse );
+
+    //! Whether the last factorization is held in sparse form.
+    bool isSparse() const {
+        return mIsSparse;
+    }
+
+    size_t getFactorNonzeros() const;
+
+    //! Whether the last factorization is (still) in single precision.
+    bool isSinglePrecision() const {
+        return mIsSinglePrecision;
+    }
+
+    //! Number of diagonal blocks in the last factorization (1 unless block triangular).
+    size_t getNumBlocks() const {
+        return mUseBlocks ? mBlocks.size() : 1;
+    }
+
+    size_t getMaxBlockSize() const;
+
+    /*!
+     * \brief Factorize the matrix A = P*L*U.
+     * \param aA The square matrix to factor.  It is not modified.
+     * \return 0 on success, otherwise the 1-based index of the first zero
+     *         pivot, in which case the factorization is unusable.
+     */
+    template <class MT>
+    int factorize( const MT& aA ) {
+        GCAM_TRACE_SCOPE( linear_factorize, aA.size1(), 0 );
+        setMatrix( aA );
+        return factorizeLU();
+    }
+
+    bool solve( boost::numeric::ublas::vector<double>& aB );
+
+    bool rankOneUpdate( const boost::numeric::ublas::vector<double>& aU,
+                        const boost::numeric::ublas::vector<double>& aV );
+
+    //! Number of rank-one updates applied since the last factorization.
+    size_t getNumUpdates() const {
+        return mUpdateV.size();
+    }
+
+    //! Estimate of the reciprocal condition number of the last factored matrix.
+    double getRCond() const {
+        return mRCond;
+    }
+
+    bool isWellConditioned() const;
+
+    /*!
+     * \brief Copy the factors out in the layout used by boost::numeric::ublas::lu_factorize.
+     * \details Rank-one updates are not reflected in the factors.  This
+     *          is not available for a block triangular, a single precision
+     *          or a sparse factorization.
+     * \param aLU Matrix which will hold L (unit diagonal, not stored) and U.
+     * \param aPerm Permutation which will hold the row interchanges.
+     */
+    template <class MT, class PT>
+    void getFactors( MT& aLU, PT& aPerm ) const {
+        assert( !mUseBlocks && !mIsSinglePrecision && !mIsSparse );
+        aLU.resize( mN, mN, false );
+        for( size_t i = 0; i < mN; ++i ) {
+            aPerm[ i ] = mPivots[ i ];
+            for( size_t j = 0; j < mN; ++j ) {
+                aLU( i, j ) = mLU[ j * mN + i ];
+            }
+        }
+    }
+
+    static const char* getBackendName();
+
+    //! Reciprocal condition number below which the LU step is considered unreliable.
+    static const double RCOND_THRESHOLD;
+
+    static const double MIXED_RCOND_THRESHOLD;
+
+    static const double SPARSE_MAX_DENSITY;
+
+    static const double SPARSE_PIVOT_TOLERANCE;
+
+private:
+    //! Copy aA into mLU, column major, in place of any previous factorization.
+    template <class MT>
+    void setMatrix( const MT& aA ) {
+        mN = aA.size1();
+        clearUpdates();
+        mLU.resize( mN * mN );
+        for( size_t j = 0; j < mN; ++j ) {
+            for( size_t i = 0; i < mN; ++i ) {
+                mLU[ j * mN + i ] = aA( i, j );
+            }
+        }
+    }
+
+    int factorizeLU();
+
+    int factorizeDouble();
+
+    double getNorm1() const;
+
+    double estimateRCond( const double aNorm1 ) const;
+
+    int finishBatched( const int aInfo, const double aNorm1 );
+
+    int factorizeBlocks();
+
+    int factorizeSparse();
+
+    bool orderMinimumDegree( std::vector<int>& aOrder ) const;
+
+    void solveSparse( boost::numeric::ublas::vector<double>& aB ) const;
+
+    bool solveLU( boost::numeric::ublas::vector<double>& aB );
+
+    bool solveRefined( boost::numeric::ublas::vector<double>& aB );
+
+    void clearUpdates();
+
+    //! Dimension of the factored matrix.
+    size_t mN;
+
+    //! LU factors stored column major.
+    std::vector<double> mLU;
+
+    //! Row interchanges: row i was swapped with row mPivots[ i ] (0-based).
+    std::vector<int> mPivots;
+
+    //! Estimate of the reciprocal condition number.
+    double mRCond;
+
+    //! Whether to factor the matrix in block triangular form.
+    bool mUseBlocks;
+
+    //! Whether to try a single precision factorization with iterative refinement.
+    bool mMixedPrecision;
+
+    //! Whether the current factors are the single precision ones in mLUSingle.
+    bool mIsSinglePrecision;
+
+    //! Single precision LU factors stored column major.
+    std::vector<float> mLUSingle;
+
+    //! The unfactored matrix, column major, kept for the refinement residuals.
+    std::vector<double> mA;
+
+    //! Infinity norm of mA.
+    double mNormInf;
+
+    //! Whether to try a sparse factorization.
+    bool mSparse;
+
+    //! Whether the current factors are the sparse ones.
+    bool mIsSparse;
+
+    //! The unfactored matrix in compressed column form, only while factoring.
+    std::vector<int> mAColPtr;
+    std::vector<int> mARowIdx;
+    std::vector<double> mAValues;
+
+    //! Column order of the sparse factorization: column k of L*U is column
+    //! mColOrder[ k ] of A.
+    std::vector<int> mColOrder;
+
+    //! Row order of the sparse factorization: row i of A is row mRowPos[ i ]
+    //! of L*U.
+    std::vector<int> mRowPos;
+
+    //! Unit lower triangular factor in compressed column form, the diagonal
+    //! stored first in each column.
+    std::vector<int> mLColPtr;
+    std::vector<int> mLRowIdx;
+    std::vector<double> mLValues;
+
+    //! Upper triangular factor in compressed column form, the diagonal stored
+    //! last in each column.
+    std::vector<int> mUColPtr;
+    std::vector<int> mURowIdx;
+    std::vector<double> mUValues;
+
+    //! The original indices of the rows/columns in each diagonal block, in solution order.
+    std::vector<std::vector<int> > mBlockIndices;
+
+    //! The factorization of each diagonal block.
+    std::vector<LinearSolver> mBlocks;
+
+    //! For each block the entries coupling it to earlier blocks as
+    //! (local row, original column, value).
+    struct Coupling {
+        int mRow;
+        int mCol;
+        double mValue;
+    };
+    std::vector<std::vector<Coupling> > mCouplings;
+
+    //! For each rank-one update u*v^T, the solution z of B*z = u prior to the update.
+    std::vector<boost::numeric::ublas::vector<double> > mUpdateZ;
+
+    //! For each rank-one update u*v^T, the vector v.
+    std::vector<boost::numeric::ublas::vector<double> > mUpdateV;
+
+    //! For each rank-one update, the Sherman-Morrison denominator 1 + v^T*z.
+    std::vector<double> mUpdateDenom;
+};
+
+#endif // LINEAR_SOLVER_HPP_
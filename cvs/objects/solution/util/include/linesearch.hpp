@@ -44,13 +44,72 @@
  */
 
 #include "util/base/include/util.h"
+#include "util/base/include/tracepoints.h"
 #include "functor.hpp"
 #include <boost/numeric/ublas/vector.hpp>
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 #define UBLAS boost::numeric::ublas
 
+/*!
+ * Backtracking phase of linesearch() with several step lengths tried
+ * at once.  The candidates lambda, lambda/2, lambda/4, ... (down to
+ * lmin) are evaluated concurrently with f.evalConcurrent, and the
+ * candidate with the lowest f among those passing the sufficient
+ * decrease test is taken.  If none pass, we continue below the
+ * smallest candidate.  The chosen point is evaluated once more with a
+ * regular call so that the caller sees the same state it would after
+ * a serial search.
+ * \return 0= success, 1= fail, -1= f does not support concurrent
+ *         evaluation (nothing was evaluated)
+ */
+template <class FTYPE>
+int linesearch_speculative(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
+                           FTYPE f0, FTYPE g0dx, const UBLAS::vector<FTYPE> &dx,
+                           FTYPE lambda, FTYPE lmin, FTYPE lseps, int nspec,
+                           UBLAS::vector<FTYPE> &x, FTYPE &fx, int &neval,
+                           std::ostream *solverlog)
+{
+  std::vector<FTYPE> lambdas;
+  std::vector<UBLAS::vector<FTYPE> > xs;
+  std::vector<FTYPE> fxs;
+  while(lambda > lmin) {
+    lambdas.clear();
+    xs.clear();
+    for(FTYPE l = lambda; l > lmin && int(lambdas.size()) < nspec; l *= 0.5) {
+      lambdas.push_back(l);
+      xs.push_back(x0 + l*dx);
+    }
+    GCAM_TRACE_BEGIN(linesearch_step, neval, xs.size());
+    if(!f.evalConcurrent(xs, fxs)) {
+      GCAM_TRACE_END(linesearch_step, neval, 0);
+      return -1;
+    }
+    GCAM_TRACE_END(linesearch_step, neval, xs.size());
+    neval += xs.size();
+
+    int best = -1;
+    for(size_t k=0; k<lambdas.size(); ++k) {
+      if(solverlog) {
+        (*solverlog) << "\tlambda = " << lambdas[k] << "  fx = " << fxs[k] << " (speculative)\n";
+      }
+      if(fxs[k] <= f0 + lseps*lambdas[k]*g0dx && (best < 0 || fxs[k] < fxs[best])) {
+        best = k;
+      }
+    }
+    if(best >= 0) {
+      x  = xs[best];
+      fx = f(x);
+      neval++;
+      return 0;
+    }
+    lambda = 0.5*lambdas.back();
+  }
+  return 1;
+}
+
 /*!
  * Perform a line search for use in multidimensional root finders.  This is NOT a 1-D
  * minimization routine!
@@ -66,6 +125,11 @@
  * \param[inout]neval: number of function evaluations. The subroutine
  * adds whatever value is passed in, allowing the caller to keep a
  * running total.
+ * \param[in] solverlog: (optional) stream for diagnostic output
+ * \param[in] nspec: (optional) if greater than 1 and f supports
+ * concurrent evaluation, backtrack by trying this many step lengths at
+ * a time (see linesearch_speculative).  The full step is always tried
+ * alone first since it usually succeeds.
  * \return : 0= success, anything else= fail
  *
  */
@@ -73,7 +137,7 @@ template <class FTYPE>
 int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
                FTYPE f0, const UBLAS::vector<FTYPE> &g0,
                const UBLAS::vector<FTYPE> &dx, UBLAS::vector<FTYPE> &x,
-               FTYPE &fx, int &neval, std::ostream *solverlog = 0)
+               FTYPE &fx, int &neval, std::ostream *solverlog = 0, int nspec = 0)
 {
   const FTYPE lseps = 1.0e-7;   // part of the definition of "sufficient" decrease
   const FTYPE TOLX = 1.0e-6;    // tolerance for x values
@@ -111,7 +175,9 @@ int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
   
   while(lambda > lmin) {
     x  = x0 + lambda*dx;
+    GCAM_TRACE_BEGIN(linesearch_step, neval, 1);
     fx = f(x);
+    GCAM_TRACE_END(linesearch_step, neval, 1);
     neval++;
 
     if(solverlog) {
@@ -146,6 +212,15 @@ int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
       lambda = 0.5*lambda;
 
     lambda = std::max(tl0, std::min(tl1,lambda));
+
+    if(nspec > 1) {
+      int status = linesearch_speculative(f, x0, f0, g0dx, dx, lambda, lmin, lseps, nspec,
+                                          x, fx, neval, solverlog);
+      if(status >= 0) {
+        return status;
+      }
+      nspec = 0;                // not supported; carry on serially
+    }
   }
   
   // If we get here, then the line search failed.  Depending on the
@@ -0,0 +1,176 @@
+#ifndef _SENSITIVITY_ANALYZER_H_
+#define _SENSITIVITY_ANALYZER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file sensitivity_analyzer.h
+ * \ingroup Solution
+ * \brief SensitivityAnalyzer class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <xercesc/dom/DOMNode.hpp>
+
+#include "util/base/include/iparsable.h"
+
+class World;
+class Marketplace;
+class Modeltime;
+class SolutionInfoParamParser;
+
+/*!
+ * \ingroup Solution
+ * \brief Calculates the sensitivity of the solved prices, and of selected
+ *        outputs, to tagged parameters from the Jacobian at the solution.
+ * \details At a solution the excess demands F( x, s ) of the solvable markets
+ *          are zero, where x are the log prices and s scales a parameter
+ *          (s = 1 being its value as read in).  By the implicit function
+ *          theorem the change in the solution with the parameter is the
+ *          solution of J * dx/ds = -dF/ds, where J is the Jacobian of F with
+ *          respect to x.  J is calculated by finite differences at the
+ *          solution and factored once, and dF/ds for each parameter takes two
+ *          model evaluations at the solved prices with the parameter scaled by
+ *          1 + step and 1 - step.  An output is then evaluated twice more
+ *          along the tangent of the solution, at x +/- step * dx/ds with the
+ *          parameter scaled to match, which gives its total derivative
+ *          without a column of the Jacobian for each output.  This replaces a
+ *          pair of complete scenario runs per parameter, but is only a local,
+ *          linear estimate: it does not capture a change in which markets are
+ *          solvable or a switch between regimes of the model.
+ *
+ *          The analyzer is read from the configuration file sensitivity-config
+ *          which has the form:
+ *          \code
+ *          <sensitivity-analysis>
+ *              <step>0.01</step>
+ *              <year>2020</year>
+ *              <year>2050</year>
+ *              <parameter name="usa-ag-elasticity" path="world/region[NamedFilter,StringEquals,USA]/..."/>
+ *              <output name="usa-co2" path="world/region[NamedFilter,StringEquals,USA]/..."/>
+ *          </sensitivity-analysis>
+ *          \endcode
+ *          Each path is a GCAMFusion search path, as understood by
+ *          parseFilterString, from the Scenario.  A parameter scales every
+ *          Value or double Data it matches together, and so as with the
+ *          EnsembleRunner only parameters which are used in calcs take effect.
+ *          An output is the sum of the Value or double Data it matches, where
+ *          a match of a whole period vector gives its value in the current
+ *          period.  The step is the relative change in the parameters, the
+ *          default is 0.01.  If no year is given every period which solves is
+ *          analyzed.
+ *
+ *          The Scenario calls run once a period has solved and the state of
+ *          the period is left as it was solved.  The sensitivities are written
+ *          as CSV to the file sensitivity-output with the columns year,
+ *          parameter, type (market or output), name, value, derivative and
+ *          elasticity, where derivative is the change in the value for a unit
+ *          relative change in the parameter, d value / d s, and elasticity is
+ *          derivative / value.
+ */
+class SensitivityAnalyzer : public IParsable {
+public:
+    SensitivityAnalyzer( World* aWorld, Marketplace* aMarketplace );
+    
+    ~SensitivityAnalyzer();
+    
+    // IParsable methods
+    virtual bool XMLParse( const xercesc::DOMNode* aNode );
+    
+    void init( const Modeltime* aModeltime );
+    
+    bool shouldAnalyze( const int aPeriod ) const;
+    
+    void run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser );
+    
+private:
+    //! A parameter or output named by a search path.
+    struct Tagged {
+        //! The name to report it by.
+        std::string mName;
+        
+        //! The GCAMFusion search path to it.
+        std::string mPath;
+    };
+    
+    //! The sensitivity of one market or output to one parameter.
+    struct Sensitivity {
+        //! Whether this is a market, otherwise it is an output.
+        bool mIsMarket;
+        
+        //! The name of the market or output.
+        std::string mName;
+        
+        //! The value at the solution.
+        double mValue;
+        
+        //! The change in the value for a unit relative change in the parameter.
+        double mDerivative;
+    };
+    
+    //! The world to calculate.
+    World* mWorld;
+    
+    //! The marketplace to calculate.
+    Marketplace* mMarketplace;
+    
+    //! The relative change in the parameters for the finite differences.
+    double mStep;
+    
+    //! The years to analyze, or empty for all.
+    std::vector<int> mYears;
+    
+    //! The periods to analyze, set from mYears in init.
+    std::vector<int> mPeriods;
+    
+    //! The parameters to calculate the sensitivities to.
+    std::vector<Tagged> mParameters;
+    
+    //! The outputs to calculate the sensitivities of.
+    std::vector<Tagged> mOutputs;
+    
+    //! Whether the output file has been started by this run.
+    bool mHasWritten;
+    
+    void writeResults( const int aPeriod, const std::string& aParameter,
+                       const std::vector<Sensitivity>& aSensitivities );
+};
+
+#endif // _SENSITIVITY_ANALYZER_H_
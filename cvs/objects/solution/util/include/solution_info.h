@@ -107,6 +107,8 @@ public:
     void expandBracket( const double aAdjFactor );
     double getRelativeED() const;
     bool isWithinTolerance() const;
+    double getSolutionTolerance() const;
+    double getSolutionFloor() const;
     bool shouldSolve( const bool isNR ) const;
     void calcDemandElas( const SolutionInfoSet& solvableMarkets );
     void calcSupplyElas( const SolutionInfoSet& solvableMarkets );
@@ -124,6 +126,9 @@ public:
     void setBisectedFlag();
     void unsetBisectedFlag();
     bool hasBisected() const;
+    bool isFrozen() const;
+    void setFrozen( const bool aIsFrozen );
+    unsigned int updateConvergedCount( const double aFraction );
     const std::vector<const objects::Atom*>& getContainedRegions() const;
     const std::vector<IActivity*>& getDependencies() const;
 
@@ -135,6 +140,7 @@ public:
     void setForecastDemand( const double aDemand );
     double getCorrectionSlope() const;
     void setCorrectionSlope( const double aSlope );
+    bool isPriceChangeHidden( const double aPrice, const double aNewPrice ) const;
 
     int getSerialNumber( void ) const;
     
@@ -161,6 +167,12 @@ public:
 private:
     bool bracketed; //!< Bracketed or unbracketed.
     bool mBisected;
+    //! Whether this market has been frozen, i.e. removed from the solvable set
+    //! because it has stayed well within tolerance.
+    bool mFrozen;
+    //! The number of consecutive solvable set updates in which this market has
+    //! been well within tolerance.
+    unsigned int mConvergedCount;
     Market* linkedMarket; //!< Linked market. 
     double XL;      //!< left bracket
     double XR;      //!< right bracket
@@ -0,0 +1,103 @@
+#ifndef _SOLUTION_INFO_FILTER_CACHE_H_
+#define _SOLUTION_INFO_FILTER_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solution_info_filter_cache.h  
+ * \ingroup Objects
+ * \brief Header file for the SolutionInfoFilterCache class.
+ */
+#include <vector>
+#include "solution/util/include/solution_info.h"
+
+class IInfo;
+
+/*!
+ * \ingroup Objects
+ * \brief Remembers the result of a filter whose answer for a market does not
+ *        change during a period.
+ * \details Results are stored by the market serial number and tagged with the
+ *          market info of the period's market so that they are recomputed
+ *          when a new period's market is seen.  Composite filters use this
+ *          to evaluate their period invariant children once per market per
+ *          period leaving only the price and supply dependent filters to be
+ *          evaluated on each update of the solvable set.
+ * \see ISolutionInfoFilter::isInvariantInPeriod
+ */
+class SolutionInfoFilterCache {
+public:
+    /*!
+     * \brief Get the cached result for a SolutionInfo, calculating it if needed.
+     * \param aSolutionInfo The SolutionInfo to test.
+     * \param aCalc A functor taking no arguments which calculates the result.
+     * \return The result for aSolutionInfo.
+     */
+    template<typename CalcType>
+    bool accept( const SolutionInfo& aSolutionInfo, CalcType aCalc ) const {
+        const int index = aSolutionInfo.getSerialNumber();
+        if( index < 0 ) {
+            // serial numbers have not been assigned, nothing to key on
+            return aCalc();
+        }
+        if( index >= static_cast<int>( mEntries.size() ) ) {
+            mEntries.resize( index + 1 );
+        }
+        Entry& entry = mEntries[ index ];
+        const IInfo* marketInfo = aSolutionInfo.getMarketInfo();
+        if( entry.mMarketInfo != marketInfo ) {
+            entry.mMarketInfo = marketInfo;
+            entry.mAccept = aCalc();
+        }
+        return entry.mAccept;
+    }
+
+private:
+    //! A cached result.
+    struct Entry {
+        Entry():mMarketInfo( 0 ), mAccept( false ) {}
+        //! The market info of the market the result is for.
+        const IInfo* mMarketInfo;
+        //! The cached result.
+        bool mAccept;
+    };
+
+    //! The cached results indexed by market serial number.
+    mutable std::vector<Entry> mEntries;
+};
+
+#endif // _SOLUTION_INFO_FILTER_CACHE_H_
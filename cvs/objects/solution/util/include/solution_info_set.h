@@ -84,6 +84,8 @@ public:
     void init( const unsigned int aPeriod, const double aDefaultSolutionTolerance, const double aDefaultSolutionFloor,
                const SolutionInfoParamParser* aSolutionInfoParamParser );
     UpdateCode updateSolvable( const ISolutionInfoFilter* aSolutionInfoFilter );
+    void setConvergenceFreezing( const unsigned int aFreezeIterations, const double aFreezeFraction );
+    unsigned int getNumFrozen() const;
     void updateElasticities();
     void resetBrackets();
     bool checkAndResetBrackets();
@@ -101,11 +103,12 @@ public:
     unsigned int getNumTotal() const;
     const SolutionInfo& getSolvable( unsigned int index ) const;
     SolutionInfo& getUnsolved( unsigned int index );
+    void getUnsolvedIndices( std::vector<unsigned int>& aIndices ) const;
     SolutionInfo& getSolvable( unsigned int index );
     const SolutionInfo& getAny( unsigned int index ) const;
     SolutionInfo& getAny( unsigned int index );
-    std::vector<SolutionInfo> getSolvableSet() const;
-    std::vector<SolutionInfo> getUnsolvableSet() const;
+    const std::vector<SolutionInfo>& getSolvableSet() const;
+    const std::vector<SolutionInfo>& getUnsolvableSet() const;
     std::vector<SolutionInfo> getSolvedSet() const;
     std::vector<SolutionInfo> getUnsolvedSet() const;
     bool isAllSolved();
@@ -123,8 +126,28 @@ private:
     unsigned int period;
     Marketplace* marketplace;
     std::vector<SolutionInfo> solvable;
-    std::vector<SolutionInfo> unsolved; // solvable markets that are not currently solved
     std::vector<SolutionInfo> unsolvable;
+    //! Number of consecutive updates a market must be well within tolerance
+    //! before it is frozen out of the solvable set (0 to disable freezing)
+    unsigned int mFreezeIterations;
+    //! Fraction of the solution tolerance a market must be below to count as
+    //! well within tolerance
+    double mFreezeFraction;
+    //! The marketplace's restriction on the markets which may be solved when
+    //! the set was initialized, or null if there is none.
+    const ISolutionInfoFilter* mRestriction;
+    //! Scratch storage for calcRelativeEDs, which holds the excess demand,
+    //! demand, solution floor, solution tolerance and relative excess demand
+    //! of each market in the set last evaluated.
+    mutable std::vector<double> mExcessDemands;
+    mutable std::vector<double> mDemands;
+    mutable std::vector<double> mSolutionFloors;
+    mutable std::vector<double> mSolutionTolerances;
+    mutable std::vector<double> mRelativeEDs;
+    UpdateCode updateFrozen( const ISolutionInfoFilter* aSolutionInfoFilter );
+    bool isAccepted( const ISolutionInfoFilter* aSolutionInfoFilter, const SolutionInfo& aSolutionInfo ) const;
+    void calcRelativeEDs( const std::vector<SolutionInfo>& aSet ) const;
+    bool isAllSolved( const std::vector<SolutionInfo>& aSet ) const;
     void print( std::ostream& out ) const;
 };
 
@@ -0,0 +1,128 @@
+#ifndef _SOLVE_BUDGET_H_
+#define _SOLVE_BUDGET_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solve_budget.h
+ * \ingroup Solution
+ * \brief The header file for the SolveBudget class.
+ */
+
+#include <string>
+#include <chrono>
+#include <boost/core/noncopyable.hpp>
+
+class CalcCounter;
+
+/*!
+ * \ingroup Solution
+ * \brief Limits the wall clock time and model evaluations spent solving a
+ *        period.
+ * \details The budget for each period is set by the configuration values
+ *          period-solve-seconds and period-solve-evaluations, either of which
+ *          may be zero (the default) for no limit.  Scenario::solve starts the
+ *          budget of a period before any solver runs.
+ *
+ *          The UserConfigurableSolver gives each solver component it calls a
+ *          share of what remains of the period's budget with startComponent.
+ *          Solver components check isComponentOverBudget once per iteration
+ *          and return SolverComponent::FAILURE_OVER_BUDGET when it is true, at
+ *          which point the solver escalates to its next strategy.  A component
+ *          is therefore only ever over its share by at most one iteration.
+ *
+ *          The budget decisions are written to the solver telemetry.
+ */
+class SolveBudget : private boost::noncopyable {
+public:
+    static SolveBudget& getInstance();
+
+    //! Whether either a time or an evaluation limit is configured.
+    bool isEnabled() const {
+        return mPeriodSeconds > 0 || mPeriodEvaluations > 0;
+    }
+
+    void startPeriod( const CalcCounter* aCalcCounter, const double aFraction );
+
+    void extendPeriod( const double aFraction );
+
+    bool isPeriodOverBudget() const;
+
+    void startComponent( const double aShare );
+
+    void endComponent();
+
+    bool isComponentOverBudget() const;
+
+    void recordDecision( const std::string& aComponentName, const int aPeriod,
+                         const std::string& aDecision ) const;
+
+private:
+    SolveBudget();
+
+    double getElapsedSeconds() const;
+
+    double getEvaluations() const;
+
+    //! The time budget for a period in seconds, or zero for no limit.
+    const double mPeriodSeconds;
+
+    //! The model evaluation budget for a period, or zero for no limit.
+    const double mPeriodEvaluations;
+
+    //! The counter of model evaluations.
+    const CalcCounter* mCalcCounter;
+
+    //! When the current period started.
+    std::chrono::steady_clock::time_point mStart;
+
+    //! The evaluation count when the current period started.
+    double mStartEvaluations;
+
+    //! The fraction of the period's budget which may currently be used.
+    double mFraction;
+
+    //! The seconds since the start of the period at which the current
+    //! component is over its share, or zero if no component is running.
+    double mComponentSeconds;
+
+    //! The evaluations since the start of the period at which the current
+    //! component is over its share.
+    double mComponentEvaluations;
+};
+
+#endif // _SOLVE_BUDGET_H_
@@ -76,6 +76,9 @@ public:
     // Some of these still might go.
    static double getRelativeED( const double excessDemand, const double demand, const double excessDemandFloor );
 
+   static void getRelativeEDs( const std::vector<double>& aExcessDemands, const std::vector<double>& aDemands,
+                               const std::vector<double>& aExcessDemandFloors, std::vector<double>& aRelativeEDs );
+
    static bool isWithinTolerance( const double excessDemand, const double demand, const double solutionTolerance,
        const double excessDemandSolutionFloor );
 
@@ -97,7 +100,13 @@ public:
                         const unsigned int aMaxIterations, SolutionInfoSet& aSolSet, CalcCounter* aCalcCounter,
                         const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod );
 
+   static bool bracketIndependent( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
+                                   const unsigned int aMaxIterations, SolutionInfoSet& aSolSet, CalcCounter* aCalcCounter,
+                                   const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod );
+
 private:
+   static void stepBracket( SolutionInfo* aSol, const double aBracketInterval, const double aLowerBound );
+
     //! A function object to compare to values and see if they are approximately equal. 
     struct ApproxEqual : public std::unary_function<double, bool> {
         const double compareValue; //!< A value to compare the argument value against.
@@ -0,0 +1,173 @@
+#ifndef _SOLVER_TELEMETRY_H_
+#define _SOLVER_TELEMETRY_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solver_telemetry.h
+ * \ingroup Solution
+ * \brief The header file for the SolverTelemetry class.
+ */
+
+#include <string>
+#include <memory>
+#include <chrono>
+#include <boost/core/noncopyable.hpp>
+
+class AutoOutputFile;
+
+/*!
+ * \ingroup Solution
+ * \brief Writes one line per solver iteration describing the progress
+ *        towards convergence.
+ * \details Each time a solver component records an iteration with
+ *          SolverComponent::addIteration a row is written to the CSV file
+ *          given by the configuration solverTelemetryFileName with the
+ *          period, solver component, iteration number, the number of model
+ *          evaluations so far in the period, the worst market and its
+ *          relative excess demand, the step length taken and the time spent
+ *          since the previous iteration in each of the phases of a Newton
+ *          type step: the finite difference Jacobian, the linear solve and
+ *          the line search.  Solvers which do not have a phase, or do not
+ *          take a step along a search direction, leave the time as zero and
+ *          the step length empty.
+ *
+ *          Decisions made because a period ran over its SolveBudget are
+ *          written as rows with an iteration of -1 and the decision in place
+ *          of the worst market.
+ *
+ *          The stream is written without flushing each line and the phase
+ *          times are a pair of clock reads per phase so that the telemetry
+ *          is cheap enough to leave on for production runs.  It is only
+ *          written if the configuration log-solver-telemetry is set.
+ */
+class SolverTelemetry : private boost::noncopyable {
+public:
+    //! The phases of a solver iteration which are timed.
+    enum Phase {
+        FDJAC,
+        LINEAR_SOLVE,
+        LINE_SEARCH,
+        NUM_PHASES
+    };
+
+    /*!
+     * \brief Adds the time until it is stopped or destroyed to a phase.
+     * \details This does nothing if the telemetry is not enabled.
+     */
+    class PhaseTimer : private boost::noncopyable {
+    public:
+        explicit PhaseTimer( const Phase aPhase )
+            :mPhase( aPhase ),
+            mIsRunning( SolverTelemetry::getInstance().isEnabled() )
+        {
+            if( mIsRunning ) {
+                mStart = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~PhaseTimer() {
+            stop();
+        }
+
+        //! Stop timing, subsequent calls have no effect.
+        void stop() {
+            if( mIsRunning ) {
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+                SolverTelemetry::getInstance().mPhaseSeconds[ mPhase ] += elapsed.count();
+                mIsRunning = false;
+            }
+        }
+
+    private:
+        //! The phase being timed.
+        const Phase mPhase;
+
+        //! Whether the timer has been started and not yet stopped.
+        bool mIsRunning;
+
+        //! The time the timer was started.
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    static SolverTelemetry& getInstance();
+
+    ~SolverTelemetry();
+
+    //! Whether the configuration log-solver-telemetry is set.
+    bool isEnabled() const {
+        return mIsEnabled;
+    }
+
+    /*!
+     * \brief Set the step length taken in the current iteration.
+     * \param aStepLength The fraction of the full step which was taken.
+     */
+    void setStepLength( const double aStepLength ) {
+        mStepLength = aStepLength;
+        mHasStepLength = true;
+    }
+
+    void recordIteration( const std::string& aComponentName, const int aPeriod,
+                          const int aIteration, const int aNumEvaluations,
+                          const std::string& aWorstMarket, const double aRelativeED );
+
+    void recordBudgetDecision( const std::string& aComponentName, const int aPeriod,
+                               const int aNumEvaluations, const std::string& aDecision );
+
+private:
+    SolverTelemetry();
+
+    void openFile();
+
+    //! Whether telemetry should be written.
+    const bool mIsEnabled;
+
+    //! The seconds spent in each phase since the last iteration was recorded.
+    double mPhaseSeconds[ NUM_PHASES ];
+
+    //! The step length set for the current iteration.
+    double mStepLength;
+
+    //! Whether a step length was set for the current iteration.
+    bool mHasStepLength;
+
+    //! The output file, opened when the first iteration is recorded.
+    std::auto_ptr<AutoOutputFile> mFile;
+};
+
+#endif // _SOLVER_TELEMETRY_H_
@@ -0,0 +1,305 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file activity_profiler.cpp
+ * \ingroup Solution
+ * \brief ActivityProfiler class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <algorithm>
+
+#include "solution/util/include/activity_profiler.h"
+#include "containers/include/iactivity.h"
+#include "marketplace/include/marketplace.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/auto_file.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    //! The names of the calculation types as written to the output.
+    const char* CALC_TYPE_NAMES[] = { "full", "partial" };
+
+    /*!
+     * \brief Escape a string to be written as a JSON string.
+     * \param aString The string to escape.
+     * \return The escaped string without the enclosing quotes.
+     */
+    string jsonEscape( const string& aString ) {
+        string escaped;
+        escaped.reserve( aString.size() );
+        for( string::const_iterator iter = aString.begin(); iter != aString.end(); ++iter ) {
+            if( *iter == '"' || *iter == '\\' ) {
+                escaped += '\\';
+            }
+            escaped += *iter;
+        }
+        return escaped;
+    }
+}
+
+ActivityProfiler::ActivityStats::ActivityStats() {
+    for( int type = 0; type < NUM_CALC_TYPES; ++type ) {
+        mNumCalcs[ type ] = 0;
+        mSeconds[ type ] = 0;
+    }
+}
+
+ActivityProfiler::ThreadProfile::ThreadProfile():
+mThreadId( -1 )
+{
+}
+
+/*!
+ * \brief Constructor.
+ * \param aGlobalOrdering The global ordering of the activities to profile
+ *        which must outlive the profiler.
+ */
+ActivityProfiler::ActivityProfiler( const vector<IActivity*>& aGlobalOrdering ):
+mGlobalOrdering( aGlobalOrdering ),
+mNumActivities( aGlobalOrdering.size() ),
+mCurrentComponent( 0 ),
+mNextThreadId( 0 ),
+mIsTracing( Configuration::getInstance()->getBool( "profile-activities-trace", false, false ) ),
+mStartTime( chrono::steady_clock::now() ),
+mHasJSONPeriods( false ),
+mHasTraceEvents( false )
+{
+    for( size_t i = 0; i < mNumActivities; ++i ) {
+        mActivityIndices[ mGlobalOrdering[ i ] ] = static_cast<int>( i );
+    }
+    // Calculations made before any solver component starts, such as the
+    // initial calculation of each period.
+    mComponentNames.push_back( "none" );
+}
+
+//! Destructor which closes the JSON and trace outputs.
+ActivityProfiler::~ActivityProfiler() {
+    if( mJSONFile.get() ) {
+        **mJSONFile << endl << "]" << endl;
+    }
+    if( mTraceFile.get() ) {
+        **mTraceFile << endl << "]}" << endl;
+    }
+}
+
+/*!
+ * \brief Whether activities should be profiled.
+ * \return The value of the configuration flag profile-activities.
+ */
+bool ActivityProfiler::isEnabled() {
+    const static bool profileActivities = Configuration::getInstance()->getBool( "profile-activities", false, false );
+    return profileActivities;
+}
+
+/*!
+ * \brief Set the solver component to which calculations are attributed.
+ * \details This must not be called while the model is being calculated.
+ * \param aComponentName The name of the solver component.
+ */
+void ActivityProfiler::setCurrentComponent( const string& aComponentName ) {
+    vector<string>::const_iterator iter = find( mComponentNames.begin(), mComponentNames.end(), aComponentName );
+    if( iter == mComponentNames.end() ) {
+        iter = mComponentNames.insert( mComponentNames.end(), aComponentName );
+    }
+    mCurrentComponent.store( static_cast<int>( iter - mComponentNames.begin() ), memory_order_relaxed );
+}
+
+/*!
+ * \brief Calculate an activity while measuring it.
+ * \details This may be called from any thread concurrently.
+ * \param aActivity The activity to calculate.
+ * \param aIndex The index of the activity in the global ordering, or -1 if it
+ *        is not in it in which case it is calculated without being measured.
+ * \param aPeriod The model period to calculate.
+ */
+void ActivityProfiler::calc( IActivity* aActivity, const int aIndex, const int aPeriod ) {
+    if( aIndex < 0 ) {
+        aActivity->calc( aPeriod );
+        return;
+    }
+    const CalcType type = Marketplace::mIsDerivativeCalc ? PARTIAL : FULL;
+    const int component = mCurrentComponent.load( memory_order_relaxed );
+    ThreadProfile& profile = getThreadProfile();
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    aActivity->calc( aPeriod );
+    const chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    const size_t statsIndex = component * mNumActivities + aIndex;
+    if( profile.mStats.size() <= statsIndex ) {
+        profile.mStats.resize( ( component + 1 ) * mNumActivities );
+    }
+    ActivityStats& stats = profile.mStats[ statsIndex ];
+    ++stats.mNumCalcs[ type ];
+    stats.mSeconds[ type ] += chrono::duration<double>( end - start ).count();
+
+    if( mIsTracing ) {
+        TraceEvent event;
+        event.mActivity = aIndex;
+        event.mComponent = component;
+        event.mType = type;
+        event.mStart = chrono::duration<double, micro>( start - mStartTime ).count();
+        event.mDuration = chrono::duration<double, micro>( end - start ).count();
+        profile.mEvents.push_back( event );
+    }
+}
+
+/*!
+ * \brief Get the counters of the calling thread.
+ * \return The thread's counters.
+ */
+ActivityProfiler::ThreadProfile& ActivityProfiler::getThreadProfile() {
+#if GCAM_PARALLEL_ENABLED
+    ThreadProfile& profile = mThreadProfiles.local();
+#else
+    ThreadProfile& profile = mThreadProfile;
+#endif
+    if( profile.mThreadId < 0 ) {
+        profile.mThreadId = mNextThreadId++;
+    }
+    return profile;
+}
+
+/*!
+ * \brief Merge the counters of all threads for the period and write them out.
+ * \details The counters are reset for the next period.  This must not be
+ *          called while the model is being calculated.
+ * \param aPeriod The model period which has ended.
+ */
+void ActivityProfiler::endPeriod( const int aPeriod ) {
+    if( !mCSVFile.get() ) {
+        mCSVFile.reset( new AutoOutputFile( "activityProfileFileName", "activity-profile.csv" ) );
+        **mCSVFile << "period,component,activity,full-calcs,full-seconds,partial-calcs,partial-seconds" << endl;
+        mJSONFile.reset( new AutoOutputFile( "activityProfileJSONFileName", "activity-profile.json" ) );
+        **mJSONFile << "[";
+        if( mIsTracing ) {
+            mTraceFile.reset( new AutoOutputFile( "activityTraceFileName", "activity-trace.json" ) );
+            **mTraceFile << "{\"traceEvents\":[";
+        }
+    }
+
+    vector<ActivityStats> merged;
+#if GCAM_PARALLEL_ENABLED
+    for( tbb::enumerable_thread_specific<ThreadProfile>::iterator profileIter = mThreadProfiles.begin();
+         profileIter != mThreadProfiles.end(); ++profileIter )
+    {
+        mergeProfile( *profileIter, merged, aPeriod );
+    }
+#else
+    mergeProfile( mThreadProfile, merged, aPeriod );
+#endif
+
+    ostream& csvFile = **mCSVFile;
+    ostream& jsonFile = **mJSONFile;
+    jsonFile << ( mHasJSONPeriods ? "," : "" ) << endl << "{\"period\":" << aPeriod << ",\"activities\":[";
+    mHasJSONPeriods = true;
+
+    double totalSeconds[ NUM_CALC_TYPES ] = { 0, 0 };
+    unsigned long totalCalcs[ NUM_CALC_TYPES ] = { 0, 0 };
+    bool isFirst = true;
+    for( size_t i = 0; i < merged.size(); ++i ) {
+        const ActivityStats& stats = merged[ i ];
+        if( stats.mNumCalcs[ FULL ] == 0 && stats.mNumCalcs[ PARTIAL ] == 0 ) {
+            continue;
+        }
+        const string& component = mComponentNames[ i / mNumActivities ];
+        const string activity = mGlobalOrdering[ i % mNumActivities ]->getDescription();
+        csvFile << aPeriod << "," << component << "," << activity;
+        jsonFile << ( isFirst ? "" : "," ) << endl
+                 << "{\"component\":\"" << jsonEscape( component ) << "\",\"activity\":\"" << jsonEscape( activity ) << "\"";
+        isFirst = false;
+        for( int type = 0; type < NUM_CALC_TYPES; ++type ) {
+            csvFile << "," << stats.mNumCalcs[ type ] << "," << stats.mSeconds[ type ];
+            jsonFile << ",\"" << CALC_TYPE_NAMES[ type ] << "-calcs\":" << stats.mNumCalcs[ type ]
+                     << ",\"" << CALC_TYPE_NAMES[ type ] << "-seconds\":" << stats.mSeconds[ type ];
+            totalSeconds[ type ] += stats.mSeconds[ type ];
+            totalCalcs[ type ] += stats.mNumCalcs[ type ];
+        }
+        csvFile << endl;
+        jsonFile << "}";
+    }
+    jsonFile << "]}";
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Activity profile for period " << aPeriod << ": " << totalCalcs[ FULL ] << " full calcs in "
+            << totalSeconds[ FULL ] << " seconds, " << totalCalcs[ PARTIAL ] << " partial derivative calcs in "
+            << totalSeconds[ PARTIAL ] << " seconds." << endl;
+}
+
+/*!
+ * \brief Add the counters of a thread to the merged counters and reset them.
+ * \details The events the thread recorded are written to the trace.
+ * \param aProfile The counters of the thread.
+ * \param aMerged The merged counters of all threads.
+ * \param aPeriod The model period the counters were recorded in.
+ */
+void ActivityProfiler::mergeProfile( ThreadProfile& aProfile, vector<ActivityStats>& aMerged, const int aPeriod ) {
+    if( aMerged.size() < aProfile.mStats.size() ) {
+        aMerged.resize( aProfile.mStats.size() );
+    }
+    for( size_t i = 0; i < aProfile.mStats.size(); ++i ) {
+        for( int type = 0; type < NUM_CALC_TYPES; ++type ) {
+            aMerged[ i ].mNumCalcs[ type ] += aProfile.mStats[ i ].mNumCalcs[ type ];
+            aMerged[ i ].mSeconds[ type ] += aProfile.mStats[ i ].mSeconds[ type ];
+        }
+    }
+    aProfile.mStats.assign( aProfile.mStats.size(), ActivityStats() );
+    writeTrace( aProfile, aPeriod );
+    aProfile.mEvents.clear();
+}
+
+/*!
+ * \brief Write the events recorded by a thread to the trace.
+ * \param aProfile The counters of the thread.
+ * \param aPeriod The model period the events were recorded in.
+ */
+void ActivityProfiler::writeTrace( const ThreadProfile& aProfile, const int aPeriod ) {
+    if( !mTraceFile.get() ) {
+        return;
+    }
+    ostream& traceFile = **mTraceFile;
+    for( vector<TraceEvent>::const_iterator iter = aProfile.mEvents.begin(); iter != aProfile.mEvents.end(); ++iter ) {
+        traceFile << ( mHasTraceEvents ? "," : "" ) << endl
+                  << "{\"name\":\"" << jsonEscape( mGlobalOrdering[ iter->mActivity ]->getDescription() )
+                  << "\",\"cat\":\"" << CALC_TYPE_NAMES[ iter->mType ] << "\",\"ph\":\"X\",\"ts\":" << iter->mStart
+                  << ",\"dur\":" << iter->mDuration << ",\"pid\":0,\"tid\":" << aProfile.mThreadId
+                  << ",\"args\":{\"period\":" << aPeriod << ",\"component\":\""
+                  << jsonEscape( mComponentNames[ iter->mComponent ] ) << "\"}}";
+        mHasTraceEvents = true;
+    }
+}
@@ -93,3 +93,7 @@ bool AllSolutionInfoFilter::XMLParse( const DOMNode* aNode ) {
 bool AllSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aSolutionInfo ) const {
     return true;
 }
+
+bool AllSolutionInfoFilter::isInvariantInPeriod() const {
+    return true;
+}
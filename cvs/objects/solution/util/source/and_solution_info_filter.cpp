@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -53,7 +54,9 @@ using namespace xercesc;
 
 typedef vector<ISolutionInfoFilter*>::const_iterator CSolutionInfoFilterIterator;
 
-AndSolutionInfoFilter::AndSolutionInfoFilter() {
+AndSolutionInfoFilter::AndSolutionInfoFilter():
+mNumInvariant( 0 )
+{
 }
 
 AndSolutionInfoFilter::~AndSolutionInfoFilter() {
@@ -98,13 +101,43 @@ bool AndSolutionInfoFilter::XMLParse( const DOMNode* aNode ) {
                 << getXMLNameStatic() << "." << endl;
         }
     }
+    
+    // Move the filters which can not change during a period to the front so that
+    // their combined result can be cached.
+    vector<ISolutionInfoFilter*>::iterator firstVariant =
+        stable_partition( mFilters.begin(), mFilters.end(),
+                          []( const ISolutionInfoFilter* aFilter ) { return aFilter->isInvariantInPeriod(); } );
+    mNumInvariant = firstVariant - mFilters.begin();
     return true;
 }
 
 bool AndSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aSolutionInfo ) const {
-    for( CSolutionInfoFilterIterator currFilter = mFilters.begin(); currFilter != mFilters.end(); ++currFilter ) {
+    if( mNumInvariant > 0 &&
+        !mInvariantCache.accept( aSolutionInfo, [this, &aSolutionInfo]() {
+            return acceptRange( aSolutionInfo, 0, mNumInvariant ); } ) )
+    {
+        return false;
+    }
+    return acceptRange( aSolutionInfo, mNumInvariant, mFilters.size() );
+}
+
+bool AndSolutionInfoFilter::isInvariantInPeriod() const {
+    return mNumInvariant == mFilters.size();
+}
+
+/*!
+ * \brief And together the filters in the range [aBegin, aEnd) of mFilters.
+ * \param aSolutionInfo The SolutionInfo to test.
+ * \param aBegin The index of the first filter to use.
+ * \param aEnd One past the index of the last filter to use.
+ * \return True if all filters in the range accept aSolutionInfo.
+ */
+bool AndSolutionInfoFilter::acceptRange( const SolutionInfo& aSolutionInfo, const size_t aBegin,
+                                         const size_t aEnd ) const
+{
+    for( size_t i = aBegin; i < aEnd; ++i ) {
         // if any filter returns false the and is false
-        if( !(*currFilter)->acceptSolutionInfo( aSolutionInfo ) ) {
+        if( !mFilters[ i ]->acceptSolutionInfo( aSolutionInfo ) ) {
             return false;
         }
     }
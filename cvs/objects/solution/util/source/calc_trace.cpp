@@ -0,0 +1,417 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file calc_trace.cpp
+ * \ingroup Solution
+ * \brief CalcTrace and CalcTraceReplay class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cstring>
+#include <cassert>
+#include <stdint.h>
+
+#include "solution/util/include/calc_trace.h"
+#include "containers/include/world.h"
+#include "containers/include/iactivity.h"
+#include "containers/include/scenario.h"
+#include "marketplace/include/marketplace.h"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/state_snapshot.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+const char CalcTrace::FILE_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'C', 'T', '0', '1' };
+
+namespace {
+    /*!
+     * \brief Read a value written by CalcTrace.
+     * \param aFile The file to read from.
+     * \param aValue The value to read into.
+     * \return Whether the value could be read.
+     */
+    template<typename T>
+    bool readValue( istream& aFile, T& aValue ) {
+        return static_cast<bool>( aFile.read( reinterpret_cast<char*>( &aValue ), sizeof( T ) ) );
+    }
+}
+
+/*!
+ * \brief Constructor which opens the trace file and writes the state the
+ *        trace starts from.
+ * \details If the market values are not stored in the market blocks of the
+ *          state, or the file could not be opened, an error is logged and
+ *          nothing is recorded.
+ * \param aPeriod The period being traced.
+ * \param aGlobalOrdering The global ordering calc lists are recorded against.
+ */
+CalcTrace::CalcTrace( const int aPeriod, const vector<IActivity*>& aGlobalOrdering )
+:mNumCalcs( 0 )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    if( !stateVars || !stateVars->hasMarketState( aPeriod ) ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not trace period " << aPeriod
+                << " as its market state is not being managed." << endl;
+        return;
+    }
+
+    const string fileName = Configuration::getInstance()->getFile( "calcTraceFileName", "calc-trace.bin", false );
+    mFile.open( fileName.c_str(), ios::out | ios::binary );
+    if( !mFile.is_open() ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open calc trace file: " << fileName << endl;
+        return;
+    }
+
+    for( size_t i = 0; i < aGlobalOrdering.size(); ++i ) {
+        mActivityIndices[ aGlobalOrdering[ i ] ] = static_cast<unsigned int>( i );
+    }
+
+    StateSnapshot initialState;
+    stateVars->saveState( initialState, false );
+    vector<double> state( initialState.size() );
+    if( !state.empty() ) {
+        initialState.restore( &state[ 0 ] );
+    }
+    const size_t numMarketValues = ManageStateVariables::NUM_MARKET_STATES * stateVars->getNumMarkets();
+    mLastMarketState.assign( state.begin(), state.begin() + numMarketValues );
+
+    mFile.write( FILE_MAGIC, sizeof( FILE_MAGIC ) );
+    write( static_cast<int32_t>( aPeriod ) );
+    write( static_cast<uint64_t>( stateVars->getNumMarkets() ) );
+    write( static_cast<uint64_t>( aGlobalOrdering.size() ) );
+    write( static_cast<uint64_t>( state.size() ) );
+    if( !state.empty() ) {
+        mFile.write( reinterpret_cast<const char*>( &state[ 0 ] ), state.size() * sizeof( double ) );
+    }
+
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Tracing the model evaluations of period " << aPeriod << " to " << fileName << endl;
+}
+
+//! Destructor which closes the trace file.
+CalcTrace::~CalcTrace() {
+    if( mFile.is_open() ) {
+        mFile.close();
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Traced " << mNumCalcs << " model evaluations." << endl;
+    }
+}
+
+/*!
+ * \brief Whether the configuration calc-trace-period selects a period.
+ * \param aPeriod The model period.
+ * \return True if the evaluations of aPeriod should be traced.
+ */
+bool CalcTrace::isTracePeriod( const int aPeriod ) {
+    return Configuration::getInstance()->getInt( "calc-trace-period", -1, false ) == aPeriod;
+}
+
+/*!
+ * \brief Record a call to World::calc before it calculates.
+ * \details This is called from the thread doing the calculation so the
+ *          market values recorded are those of the state it is using.
+ * \param aCalcList The activities to calculate, or null if the whole
+ *        global ordering is calculated.
+ * \param aUsesFlowGraph Whether the calculation uses the flow graph.
+ */
+void CalcTrace::recordCalc( const vector<IActivity*>* aCalcList, const bool aUsesFlowGraph ) {
+    if( !mFile.is_open() ) {
+        return;
+    }
+    const ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    const double* marketState = stateVars->getMarketState( ManageStateVariables::MARKET_PRICE );
+    unsigned char flags = 0;
+    if( Marketplace::mIsDerivativeCalc ) {
+        flags |= DERIVATIVE_CALC;
+    }
+    if( stateVars->isPartialDeriv() ) {
+        flags |= SCRATCH_STATE;
+    }
+    if( aUsesFlowGraph ) {
+        flags |= FLOW_GRAPH;
+    }
+    if( !aCalcList ) {
+        flags |= FULL_MODEL;
+    }
+
+    lock_guard<mutex> lock( mMutex );
+    write( static_cast<uint8_t>( CALC ) );
+    write( static_cast<uint8_t>( flags ) );
+    uint32_t numChanged = 0;
+    for( size_t i = 0; i < mLastMarketState.size(); ++i ) {
+        if( marketState[ i ] != mLastMarketState[ i ] ) {
+            ++numChanged;
+        }
+    }
+    write( numChanged );
+    for( size_t i = 0; i < mLastMarketState.size(); ++i ) {
+        if( marketState[ i ] != mLastMarketState[ i ] ) {
+            write( static_cast<uint32_t>( i ) );
+            write( marketState[ i ] );
+            mLastMarketState[ i ] = marketState[ i ];
+        }
+    }
+    if( aCalcList ) {
+        write( static_cast<uint32_t>( aCalcList->size() ) );
+        for( vector<IActivity*>::const_iterator it = aCalcList->begin(); it != aCalcList->end(); ++it ) {
+            assert( mActivityIndices.find( *it ) != mActivityIndices.end() );
+            write( mActivityIndices.find( *it )->second );
+        }
+    }
+    ++mNumCalcs;
+}
+
+/*!
+ * \brief Record that the "scratch" state of the calling thread was committed
+ *        to the "base" state.
+ */
+void CalcTrace::recordCommit() {
+    if( mFile.is_open() ) {
+        lock_guard<mutex> lock( mMutex );
+        write( static_cast<uint8_t>( COMMIT ) );
+    }
+}
+
+/*!
+ * \brief Record that the state was restored to the one the trace started from.
+ */
+void CalcTrace::recordRestore() {
+    if( mFile.is_open() ) {
+        lock_guard<mutex> lock( mMutex );
+        write( static_cast<uint8_t>( RESTORE ) );
+    }
+}
+
+CalcTraceReplay::CalcTraceReplay()
+:mWorld( 0 ),
+mPeriod( -1 ),
+mNumMarkets( 0 ),
+mNumCalcs( 0 )
+{
+}
+
+/*!
+ * \brief Read a trace written by CalcTrace.
+ * \details The calc lists are resolved against the global ordering of the
+ *          world so the world must be set up as it was when the trace was
+ *          recorded.
+ * \param aFileName The trace file.
+ * \param aWorld The world to replay the trace on.
+ * \return Whether the trace was read, otherwise an error is logged.
+ */
+bool CalcTraceReplay::load( const string& aFileName, World* aWorld ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::ERROR );
+    ifstream file( aFileName.c_str(), ios::in | ios::binary );
+    char magic[ sizeof( CalcTrace::FILE_MAGIC ) ];
+    if( !file.read( magic, sizeof( magic ) ) ||
+        memcmp( magic, CalcTrace::FILE_MAGIC, sizeof( magic ) ) != 0 )
+    {
+        mainLog << "Could not read calc trace file: " << aFileName << endl;
+        return false;
+    }
+
+    const vector<IActivity*>& globalOrdering = aWorld->getGlobalOrdering();
+    int32_t period;
+    uint64_t numMarkets;
+    uint64_t numActivities;
+    uint64_t numStateValues;
+    if( !readValue( file, period ) || !readValue( file, numMarkets ) ||
+        !readValue( file, numActivities ) || !readValue( file, numStateValues ) )
+    {
+        mainLog << "Calc trace file " << aFileName << " is truncated." << endl;
+        return false;
+    }
+    if( numActivities != globalOrdering.size() ) {
+        mainLog << "Calc trace file " << aFileName << " has " << numActivities
+                << " activities but the model has " << globalOrdering.size() << "." << endl;
+        return false;
+    }
+    mInitialState.resize( numStateValues );
+    if( numStateValues > 0 &&
+        !file.read( reinterpret_cast<char*>( &mInitialState[ 0 ] ), numStateValues * sizeof( double ) ) )
+    {
+        mainLog << "Calc trace file " << aFileName << " is truncated." << endl;
+        return false;
+    }
+
+    mWorld = aWorld;
+    mPeriod = period;
+    mNumMarkets = numMarkets;
+    mNumCalcs = 0;
+    mEvents.clear();
+    const size_t numMarketValues = ManageStateVariables::NUM_MARKET_STATES * mNumMarkets;
+    uint8_t type;
+    while( readValue( file, type ) ) {
+        Event event;
+        event.mType = type;
+        event.mFlags = 0;
+        bool isValid = type == CalcTrace::CALC || type == CalcTrace::COMMIT || type == CalcTrace::RESTORE;
+        if( isValid && type == CalcTrace::CALC ) {
+            uint32_t numChanged;
+            isValid = readValue( file, event.mFlags ) && readValue( file, numChanged );
+            for( uint32_t i = 0; isValid && i < numChanged; ++i ) {
+                pair<uint32_t, double> change;
+                isValid = readValue( file, change.first ) && readValue( file, change.second ) &&
+                          change.first < numMarketValues;
+                event.mMarketChanges.push_back( change );
+            }
+            if( isValid && !( event.mFlags & CalcTrace::FULL_MODEL ) ) {
+                uint32_t numToCalc;
+                isValid = readValue( file, numToCalc );
+                event.mCalcList.reserve( numToCalc );
+                for( uint32_t i = 0; isValid && i < numToCalc; ++i ) {
+                    uint32_t index;
+                    isValid = readValue( file, index ) && index < globalOrdering.size();
+                    if( isValid ) {
+                        event.mCalcList.push_back( globalOrdering[ index ] );
+                    }
+                }
+            }
+            ++mNumCalcs;
+        }
+        if( !isValid ) {
+            mainLog << "Calc trace file " << aFileName << " is invalid after " << mEvents.size()
+                    << " events." << endl;
+            mWorld = 0;
+            return false;
+        }
+        mEvents.push_back( event );
+    }
+    return true;
+}
+
+/*!
+ * \brief Check that the state being managed matches that of the trace.
+ * \param aStateVars The state of the traced period.
+ * \return Whether the trace can be replayed into the state, otherwise an
+ *         error is logged.
+ */
+bool CalcTraceReplay::isCompatible( const ManageStateVariables* aStateVars ) const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::ERROR );
+    if( !mWorld ) {
+        mainLog << "No calc trace has been loaded." << endl;
+        return false;
+    }
+    if( !aStateVars->hasMarketState( mPeriod ) || aStateVars->getNumMarkets() != mNumMarkets ) {
+        mainLog << "The market state of period " << mPeriod << " does not match the calc trace." << endl;
+        return false;
+    }
+    StateSnapshot currentState;
+    aStateVars->saveState( currentState, false );
+    if( currentState.size() != mInitialState.size() ) {
+        mainLog << "The model has " << currentState.size() << " state values in period " << mPeriod
+                << " but the calc trace has " << mInitialState.size() << "." << endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Replay the trace.
+ * \details The state is left as of the end of the trace with partial
+ *          derivatives turned off.
+ * \param aStateVars The state of the traced period.
+ * \pre isCompatible( aStateVars ) is true.
+ */
+void CalcTraceReplay::replay( ManageStateVariables* aStateVars ) const {
+    assert( isCompatible( aStateVars ) );
+    StateSnapshot initialState;
+    if( !mInitialState.empty() ) {
+        initialState.save( &mInitialState[ 0 ], mInitialState.size() );
+    }
+    aStateVars->setPartialDeriv( false );
+    Marketplace::mIsDerivativeCalc = false;
+    aStateVars->restoreState( initialState );
+
+    const size_t numMarketValues = ManageStateVariables::NUM_MARKET_STATES * mNumMarkets;
+    vector<double> marketState( mInitialState.begin(), mInitialState.begin() + numMarketValues );
+    StateSnapshot marketSnapshot;
+    bool isScratchState = false;
+    for( vector<Event>::const_iterator event = mEvents.begin(); event != mEvents.end(); ++event ) {
+        if( event->mType == CalcTrace::COMMIT ) {
+            aStateVars->commitState();
+            continue;
+        }
+        if( event->mType == CalcTrace::RESTORE ) {
+            aStateVars->setPartialDeriv( false );
+            isScratchState = false;
+            aStateVars->restoreState( initialState );
+            marketState.assign( mInitialState.begin(), mInitialState.begin() + numMarketValues );
+            continue;
+        }
+
+        const bool useScratchState = ( event->mFlags & CalcTrace::SCRATCH_STATE ) != 0;
+        if( useScratchState != isScratchState ) {
+            aStateVars->setPartialDeriv( useScratchState );
+            isScratchState = useScratchState;
+        }
+        if( isScratchState ) {
+            // The solvers reset the "scratch" state before each partial derivative.
+            aStateVars->copyState();
+        }
+        Marketplace::mIsDerivativeCalc = ( event->mFlags & CalcTrace::DERIVATIVE_CALC ) != 0;
+        for( vector<pair<unsigned int, double> >::const_iterator change = event->mMarketChanges.begin();
+             change != event->mMarketChanges.end(); ++change )
+        {
+            marketState[ change->first ] = change->second;
+        }
+        // All of the market values are restored since the "scratch" state was
+        // just reset from the base state which may differ from the recording.
+        if( numMarketValues > 0 ) {
+            marketSnapshot.save( &marketState[ 0 ], numMarketValues );
+            aStateVars->restoreState( marketSnapshot );
+        }
+
+        const bool isFullModel = ( event->mFlags & CalcTrace::FULL_MODEL ) != 0;
+#if GCAM_PARALLEL_ENABLED
+        if( event->mFlags & CalcTrace::FLOW_GRAPH ) {
+            mWorld->calc( mPeriod, mWorld->getGlobalFlowGraph(), isFullModel ? 0 : &event->mCalcList );
+            continue;
+        }
+#endif
+        mWorld->calc( mPeriod, isFullModel ? mWorld->getGlobalOrdering() : event->mCalcList );
+    }
+    aStateVars->setPartialDeriv( false );
+    Marketplace::mIsDerivativeCalc = false;
+}
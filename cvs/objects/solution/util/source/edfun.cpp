@@ -33,8 +33,10 @@
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
+#include <map>
 #include <set>
 #include <vector>
+#include <limits>
 #include "solution/util/include/edfun.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "containers/include/iactivity.h"
@@ -42,9 +44,15 @@
 #include "util/logger/include/ilogger.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/manage_state_variables.hpp"
+#include "solution/util/include/calc_trace.h"
 
 #include "util/base/include/timer.h"
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#endif
+
 #define UBVECTOR boost::numeric::ublas::vector 
 
 extern Scenario* scenario;
@@ -52,6 +60,12 @@ extern Scenario* scenario;
 const double LogEDFun::PMAX = 1.0e24;
 const double LogEDFun::ARGMAX = 55.262042; // log(PMAX)
 const double LogEDFun::MINXSCL = 1.0e-5;
+const double LogEDFun::INCREMENTAL_MAX_FRACTION = 0.5;
+const double LogEDFun::BASE_STEP = 1.0e-6;
+const double LogEDFun::MIN_STEP = 1.0e-8;
+const double LogEDFun::MAX_STEP = 1.0e-2;
+
+std::map<std::pair<std::string, bool>, LogEDFun::FDStep> LogEDFun::sStepStore;
 
 // constructor
 LogEDFun::LogEDFun(SolutionInfoSet &sisin,
@@ -60,6 +74,8 @@ LogEDFun::LogEDFun(SolutionInfoSet &sisin,
     solnset(sisin),
     world(w), mktplc(m), period(per),
     mLogPricep(aLogPricep),
+    mUseColumnGroups(false),
+    mIncrementalThreshold(-1.0),
     slope(mkts.size(), 1.0)
 {
     na=nr=mkts.size();
@@ -210,33 +226,21 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
    **** point.
    ****/
   
-  if(partj < 0) {               // not a partial derivative calculation
+  if(partj < 0 && mIncrementalThreshold >= 0.0 && incrementalCalc(x)) {
+    // Only the activities downstream of the changed prices were
+    // recalculated.  Proceed to part 3 below.
+    edfunMiscTimer.stop();
+    edfunPreTimer.stop();
+  }
+  else if(partj < 0) {          // not a partial derivative calculation
     /****
      * 1A Set the model inputs using the solutionInfo objects (full eval version)
      ****/
 
     mktplc->nullSuppliesAndDemands(period);
 
-    /* set prices into the marketplace. If the inputs are log-prices,
-       we have to exp() them first*/
-    if(mLogPricep) {
-      /***** In part 3 we make some exceptions for certain market
-       ***** types.  Perhaps we should consider doing that here too.
-       ***** E.g., we could make the inputs for price and demand
-       ***** markets always linear.
-       *****/
-      for(size_t i=0; i<x.size(); ++i) {
-        if(x[i] > ARGMAX)
-          mkts[i].setPrice(PMAX);
-        else
-          mkts[i].setPrice(exp(x[i])); // input vector = log(price)
-      }
-    }
-    else {
-      for(size_t i=0; i<x.size(); ++i) {
-        mkts[i].setPrice(x[i]); // input vector = price
-      }
-    }
+    setPrices(x);
+    mLastX = x;
     edfunMiscTimer.stop();
     edfunPreTimer.stop(); 
 
@@ -270,26 +274,18 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
                 << "\t" << mkts[partj].getName() << "\n";
     }
     
-    // In theory the loop over markets is unnecessary, and we need
-    // only to set mkts[partj].  We should try that sometime.
+    // During a partial calc only the price of the partj'th element should
+    // change and the rest were reset from stored values.  In theory
+    // those reset prices are the same as in x however there may be some
+    // slight differences due to roundoff error.  Setting just the one
+    // price saves a pass over all of the markets for every column.
     if(mLogPricep) {            
-      /***** In part 3 we make some exceptions for certain market
-       ***** types.  Perhaps we should consider doing that here too.
-       ***** E.g., we could make the inputs for price and demand
-       ***** markets always linear.
-       *****/
-      for(size_t i=0; i<x.size(); ++i) {
-        if(x[i] > ARGMAX)
-          mkts[i].setPrice(PMAX);
-        else
-          mkts[i].setPrice(exp(x[i])); // input vector = log(price)
-      }
+      if(x[partj] > ARGMAX)
+        mkts[partj].setPrice(PMAX);
+      else
+        mkts[partj].setPrice(exp(x[partj])); // input vector = log(price)
     }
     else {
-        // During a partial calc only the price of the partj'th element should
-        // change and the rest were reset from stored values.  In theory
-        // those reset prices are the same as in x however there may be some
-        // slight differences due to roundoff error.
         mkts[partj].setPrice(x[partj]);
     }
 
@@ -319,8 +315,202 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
     }
   }
 
-  
+
   edfunMiscTimer.start();
+  collectOutputs(x, fx);
+  edfunMiscTimer.stop();
+}
+
+/*!
+ * \brief Set the prices of all of the solvable markets.
+ * \param x The unscaled inputs.  If the inputs are log-prices we have to
+ *          exp() them first.
+ */
+void LogEDFun::setPrices(const UBVECTOR<double> &x)
+{
+  if(mLogPricep) {
+    /***** In part 3 we make some exceptions for certain market
+     ***** types.  Perhaps we should consider doing that here too.
+     ***** E.g., we could make the inputs for price and demand
+     ***** markets always linear.
+     *****/
+    for(size_t i=0; i<x.size(); ++i) {
+      if(x[i] > ARGMAX)
+        mkts[i].setPrice(PMAX);
+      else
+        mkts[i].setPrice(exp(x[i])); // input vector = log(price)
+    }
+  }
+  else {
+    for(size_t i=0; i<x.size(); ++i) {
+      mkts[i].setPrice(x[i]); // input vector = price
+    }
+  }
+}
+
+/*!
+ * \brief Evaluate the model by recalculating only the activities which
+ *        depend on prices that have changed.
+ * \details Late in a solution typically only a few prices move between
+ *          evaluations, yet a full evaluation recalculates every activity.
+ *          Instead we compare the new prices to the ones currently set in the
+ *          "base" state and recalculate only the union of the dependencies of
+ *          the markets whose prices changed at all.  We use the partial
+ *          derivative machinery to do it: the "scratch" state is reset from
+ *          the "base" state, so that the activities which are recalculated
+ *          only add the changes to their supplies and demands, then the result
+ *          is committed as the new "base" state.  Since every activity that
+ *          depends on a changed price is recalculated the result is the same
+ *          as a full evaluation at x, which the Broyden update and the line
+ *          search rely on.
+ * \param x The unscaled inputs.
+ * \return True if the evaluation was done, false if a full evaluation is
+ *         required instead (the first evaluation, or when so many activities
+ *         would need to be recalculated that it is not worth it).
+ */
+bool LogEDFun::incrementalCalc(const UBVECTOR<double> &x)
+{
+  if(mLastX.size() != x.size()) {
+    return false;
+  }
+
+  std::vector<int> changed;
+  for(size_t i=0; i<x.size(); ++i) {
+    if(x[i] != mLastX[i]) {
+      changed.push_back(i);
+    }
+  }
+  if(changed.empty()) {
+    // the "base" state is already up to date
+    return true;
+  }
+
+  // merge the dependencies of the changed markets keeping the global order
+  const std::map<IActivity*, int>& orderIndex = getOrderIndex();
+  const std::vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+  std::set<int> calcIndices;
+  for(size_t k=0; k<changed.size(); ++k) {
+    const std::vector<IActivity*>& deps = mkts[changed[k]].getDependencies();
+    for(size_t d=0; d<deps.size(); ++d) {
+      calcIndices.insert(orderIndex.find(deps[d])->second);
+    }
+  }
+  if(calcIndices.size() > INCREMENTAL_MAX_FRACTION * globalOrdering.size()) {
+    return false;
+  }
+  std::vector<IActivity*> calcList;
+  calcList.reserve(calcIndices.size());
+  for(std::set<int>::const_iterator it = calcIndices.begin(); it != calcIndices.end(); ++it) {
+    calcList.push_back(globalOrdering[*it]);
+  }
+
+  ManageStateVariables* stateVars = scenario->getManageStateVariables();
+  stateVars->setPartialDeriv(true);
+  stateVars->copyState();
+  mktplc->mIsDerivativeCalc = true;
+  for(size_t k=0; k<changed.size(); ++k) {
+    const int j = changed[k];
+    if(mLogPricep) {
+      mkts[j].setPrice(x[j] > ARGMAX ? PMAX : exp(x[j]));
+    }
+    else {
+      mkts[j].setPrice(x[j]);
+    }
+    mLastX[j] = x[j];
+  }
+
+  Timer& evalPartTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_PART );
+  evalPartTimer.start();
+  // Note this runs in serial even when GCAM_PARALLEL_ENABLED since all of
+  // the calculations must be done in the calling thread's "scratch" state.
+  world->calc(period, calcList);
+  evalPartTimer.stop();
+
+  stateVars->commitState();
+  if(world->getCalcTrace()) {
+    world->getCalcTrace()->recordCommit();
+  }
+  partial(-1);
+  return true;
+}
+
+/*!
+ * \brief Get the position of each activity in the global ordering.
+ * \details This allows the dependencies of several markets to be merged
+ *          into a single list which respects the global ordering.  The map is
+ *          built on first use and reused for the life of this object.
+ * \return A map from each activity to its index in the global ordering.
+ */
+const std::map<IActivity*, int>& LogEDFun::getOrderIndex()
+{
+  if(mOrderIndex.empty()) {
+    const std::vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+    for(size_t k=0; k<globalOrdering.size(); ++k) {
+      mOrderIndex[globalOrdering[k]] = k;
+    }
+  }
+  return mOrderIndex;
+}
+
+/*!
+ * \brief Evaluate the model at several independent points concurrently.
+ * \details Each point is a full model evaluation run in a "scratch" state
+ *          using the partial derivative machinery: the scratch state is
+ *          reset from the "base" state, all solvable prices are set, and
+ *          the entire global ordering is recalculated so that all of the
+ *          supplies and demands reflect the new prices.  The "base" state
+ *          is never touched, so a caller which decides to move to one of
+ *          these points must evaluate it again normally.  This is only
+ *          supported with GCAM_PARALLEL_ENABLED since otherwise there is a
+ *          single scratch state and nothing to gain.
+ * \param ax The scaled inputs for each point.
+ * \param fx The output vector for each point.
+ * \return True if the points were evaluated.
+ */
+bool LogEDFun::evalConcurrent(const std::vector<UBVECTOR<double> > &ax,
+                              std::vector<UBVECTOR<double> > &fx)
+{
+#if !GCAM_PARALLEL_ENABLED
+  return false;
+#else
+  ManageStateVariables* stateVars = scenario->getManageStateVariables();
+  const std::vector<IActivity*>& allNodes = world->getGlobalOrdering();
+  fx.assign(ax.size(), UBVECTOR<double>(nr));
+
+  Timer& evalPartTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_PART );
+  evalPartTimer.start();
+  stateVars->setPartialDeriv(true);
+  mktplc->mIsDerivativeCalc = true;
+  tbb::task_arena& threadPool = stateVars->mThreadPool;
+  tbb::task_group tg;
+  threadPool.execute([&](){
+      tg.run([&](){
+          tbb::parallel_for( size_t(0), ax.size(), [&]( size_t k ) {
+              stateVars->copyState();
+              UBVECTOR<double> x(ax[k].size());
+              for(unsigned int i=0; i<x.size(); ++i)
+                  x[i] = ax[k][i]*mxscl[i];
+              setPrices(x);
+              world->calc(period, allNodes);
+              collectOutputs(x, fx[k]);
+          });
+      });
+  });
+  threadPool.execute([&tg](){ tg.wait(); });
+  partial(-1);
+  evalPartTimer.stop();
+  return true;
+#endif
+}
+
+/*!
+ * \brief Collect the supplies and demands that result from a model evaluation
+ *        and convert them into the scaled output vector.
+ * \param x The unscaled inputs that were used for the model evaluation.
+ * \param fx The output vector to fill in.
+ */
+void LogEDFun::collectOutputs(const UBVECTOR<double> &x, UBVECTOR<double> &fx)
+{
   Timer& edfunPostTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_POST );
   edfunPostTimer.start();
 
@@ -340,7 +530,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
       double s = std::max(mkts[i].getSupply(), TINY);
       double p0 = mkts[i].getLowerBoundSupplyPrice();
       double p  = x[i]>=ARGMAX ? PMAX : exp(x[i]);
-      double c  = std::max(0.0, p0-p);
+      double c  = supplyCorrection(i, x[i], s);
       double fxi = log(d/s);
       if(c>0.0) {
         ILogger &solverlog = ILogger::getLogger("solver_log");
@@ -364,7 +554,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
         // if the supply was indeed zero.  If the actual lower bound price is significantly
         // different than the estimated this may generate a discontinuity.
         double p0 = mkts[i].getLowerBoundSupplyPrice();
-        double c = s == 0 ? std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]) * slope[i] : 0;
+        double c = supplyCorrection(i, x[i], s);
         // give difference as a fraction of demand
         fx[i] = d - s + c;          // == d-(s-c); i.e., the correction subtracts from supply
         if(c>0.0) {
@@ -389,7 +579,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
         // zero) below which the policy is considered non-binding in which case the correction
         // is essentially adding extra demand to meet the constraint.
         double p0 = mkts[i].getLowerBoundSupplyPrice();
-        double c = std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]) * slope[i];
+        double c = supplyCorrection(i, x[i], s);
         // give difference as a fraction of demand
         fx[i] = d - s + c;          // == d-(s-c); i.e., the correction subtracts from supply
         if(c>0.0) {
@@ -412,7 +602,348 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
       fx[i] *= mfxscl[i];
   
   edfunPostTimer.stop();
+}
+
+/*!
+ * \brief Calculate the (unscaled) supply correction which collectOutputs adds
+ *        to output i for prices below the supply curve lower bound.
+ * \details The correction depends only on the input and, for normal markets,
+ *          on whether there was any supply.  Constraint markets only get a
+ *          correction when using linear prices.
+ * \param i The index of the market.
+ * \param x The unscaled input for market i.
+ * \param s The supply in market i.
+ * \return The supply correction.
+ */
+double LogEDFun::supplyCorrection(const int i, const double x, const double s) const
+{
+  const IMarketType::Type type = mkts[i].getType();
+  const double p0 = mkts[i].getLowerBoundSupplyPrice();
+  if(mLogPricep && type == IMarketType::NORMAL) {
+    return std::max(0.0, p0-(x>=ARGMAX ? PMAX : exp(x)));
+  }
+  else if(type == IMarketType::NORMAL) {
+    return s == 0 ? std::max(0.0, (p0-x)/mfxscl[i]/mxscl[i]) * slope[i] : 0;
+  }
+  else if(!mLogPricep && ( type == IMarketType::RES || type == IMarketType::TAX
+                          || type == IMarketType::SUBSIDY ) )
+  {
+    return std::max(0.0, (p0-x)/mfxscl[i]/mxscl[i]) * slope[i];
+  }
+  return 0.0;
+}
+
+/*!
+ * \brief Fill in a Jacobian column without a model evaluation when the market
+ *        can tell us that the model will not see the perturbation.
+ * \details This is typically the case for constraint markets which are not
+ *          binding since the price the model sees is capped at the lower bound.
+ *          No supplies or demands change so the only nonzero entry is from the
+ *          supply correction on the diagonal.  This uses only the market
+ *          structure so it is safe to call concurrently.
+ * \param ax The scaled inputs.
+ * \param fx The outputs at ax.
+ * \param j The input to perturb.
+ * \param h The (scaled) finite difference step.
+ * \param col The column of the Jacobian.
+ * \return True if the column was supplied.
+ */
+bool LogEDFun::analyticColumn(const UBVECTOR<double> &ax, const UBVECTOR<double> &fx, const int j,
+                              const double h, UBVECTOR<double> &col)
+{
+  const double x = ax[j]*mxscl[j];
+  const double xh = (ax[j]+h)*mxscl[j];
+  if(!mkts[j].isPriceChangeHidden(modelPrice(x), modelPrice(xh))) {
+    return false;
+  }
+
+  for(size_t i=0; i<col.size(); ++i) {
+    col[i] = 0.0;
+  }
+  // supply only gates the correction for normal markets which do not give
+  // this hint
+  col[j] = (supplyCorrection(j, xh, 0.0) - supplyCorrection(j, x, 0.0)) * mfxscl[j] / h;
+  return true;
+}
 
+/*!
+ * \brief Get the finite difference step for a market.
+ * \details With adaptive steps this is the step learned for the market,
+ *          otherwise BASE_STEP relative to the input as in the default.
+ * \param j The index of the market.
+ * \param xj The (scaled) input of the market.
+ * \return The step to take in input j.
+ */
+double LogEDFun::stepSize(const int j, const double xj) const
+{
+  const double TINY = 1.0e-6;
+  return (mSteps.empty() ? BASE_STEP : mSteps[j]->mRelStep) * (fabs(xj)+TINY);
+}
+
+/*!
+ * \brief Learn from a finite difference column and check that it is usable.
+ * \details A change in the market's own excess demand no bigger than its
+ *          noise means the step was too small to see past it, or fell within
+ *          a flat part of the supply or demand curves.  The step is raised
+ *          and the column is rejected so that fdjac takes it again.
+ *          Otherwise the derivative is compared with the last reliable one
+ *          in the same period.  If that was taken at (nearly) the same price
+ *          the difference is noise and updates the noise estimate, if not it
+ *          updates the curvature estimate.  The step is then moved towards
+ *          2*sqrt(noise/curvature), which minimizes the error of a forward
+ *          difference.  The step changes by
+ *          at most a factor of 10 at a time and stays within MIN_STEP and
+ *          MAX_STEP.  This is only called from fdjac, which computes each
+ *          column in a single task, so the state of a market is only ever
+ *          touched by one thread at a time.
+ * \param j The index of the market.
+ * \param xj The (scaled) input of the market.
+ * \param h The step which was taken.
+ * \param fj The market's output at xj.
+ * \param fjh The market's output at xj+h.
+ * \return False if the column should be taken again with a revised step.
+ */
+bool LogEDFun::checkColumn(const int j, const double xj, const double h, const double fj, const double fjh)
+{
+  if(mSteps.empty()) {
+    return true;
+  }
+  FDStep& step = *mSteps[j];
+  // the excess demand can not be known better than its rounding error
+  const double roundoff = 10.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(fabs(fj), fabs(fjh)));
+  const double noise = std::max(step.mNoise, roundoff);
+  const double diff = fjh - fj;
+  if(!util::isValidNumber(diff) || fabs(diff) <= noise) {
+    // The difference can not be told from noise so the step must go up.
+    const double oldStep = step.mRelStep;
+    step.mRelStep = std::min(MAX_STEP, 10.0 * step.mRelStep);
+    return step.mRelStep == oldStep;
+  }
+
+  const double deriv = diff / h;
+  if(step.mLastPeriod == period) {
+    const double dx = fabs(xj - step.mLastX);
+    if(dx > 4.0 * fabs(h)) {
+      const double curvature = fabs(deriv - step.mLastDeriv) / dx;
+      step.mCurvature = step.mCurvature > 0.0 ? 0.5 * (step.mCurvature + curvature) : curvature;
+    }
+    else {
+      // the error of a forward difference due to noise e is about 2e/h
+      const double sampleNoise = 0.5 * fabs(deriv - step.mLastDeriv) * fabs(h);
+      step.mNoise = step.mNoise > 0.0 ? 0.5 * (step.mNoise + sampleNoise) : sampleNoise;
+    }
+  }
+  step.mLastPeriod = period;
+  step.mLastX = xj;
+  step.mLastDeriv = deriv;
+
+  if(step.mCurvature > 0.0) {
+    const double TINY = 1.0e-6;
+    const double optimal = 2.0 * sqrt(std::max(step.mNoise, roundoff) / step.mCurvature) / (fabs(xj)+TINY);
+    step.mRelStep = std::max(MIN_STEP, std::min(MAX_STEP,
+        std::max(0.1 * step.mRelStep, std::min(10.0 * step.mRelStep, optimal))));
+  }
+  return true;
+}
+
+/*!
+ * \brief Switch on per market finite difference steps.
+ * \details When set each market uses the step learned for it in previous
+ *          Jacobians, including those of earlier periods and scenarios, and
+ *          the columns found to be unreliable are taken again with a revised
+ *          step.  Otherwise every market uses BASE_STEP.
+ * \param aAdaptiveSteps Flag to enable or disable adaptive steps.
+ */
+void LogEDFun::setAdaptiveSteps(const bool aAdaptiveSteps)
+{
+  mSteps.clear();
+  if(aAdaptiveSteps) {
+    mSteps.resize(mkts.size());
+    for(size_t i=0; i<mkts.size(); ++i) {
+      mSteps[i] = &sStepStore[std::make_pair(mkts[i].getName(), mLogPricep)];
+    }
+  }
+}
+
+/*!
+ * \brief Switch on grouped evaluation of partial derivatives.
+ * \details When set, columnGroups will partition the solvable markets into
+ *          groups whose dependencies do not touch any common market so that
+ *          fdjac can perturb an entire group with a single model evaluation.
+ * \param aUseColumnGroups Flag to enable or disable grouping.
+ */
+void LogEDFun::setColumnGrouping(const bool aUseColumnGroups)
+{
+    mUseColumnGroups = aUseColumnGroups;
+}
+
+/*!
+ * \brief Set whether full evaluations may recalculate only the activities
+ *        downstream of the prices which changed.
+ * \details Only the dependencies of markets whose prices changed are skipped
+ *          (see incrementalCalc) so that F is always exact.  A threshold below
+ *          which changed prices could be ignored is not supported.
+ * \param aThreshold Zero (or any non-negative value) to evaluate incrementally,
+ *        or a negative value to always do a full evaluation.
+ */
+void LogEDFun::setIncrementalCalc(const double aThreshold)
+{
+    mIncrementalThreshold = aThreshold < 0.0 ? -1.0 : 0.0;
+}
+
+/*!
+ * \brief Make the next full evaluation recalculate the entire model.
+ * \details This is needed when something other than the prices, such as the
+ *          accuracy of the model evaluation, has changed since the "base"
+ *          state was calculated.
+ */
+void LogEDFun::resetIncrementalCalc()
+{
+    mLastX.resize(0);
+}
+
+/*!
+ * \brief Partition the Jacobian columns using the market dependency structure.
+ * \details The activities that must be recalculated when the price of a market
+ *          changes include both the consumers of that good and its supplier.
+ *          Therefore a perturbation in the price of market j can only change
+ *          the supply or demand of market i if the dependencies of i and j share
+ *          an activity.  We use that to build the pattern of rows each column
+ *          may affect and then greedily color the columns so that no two columns
+ *          in the same group share an affected row.  The calc list for each group
+ *          is the union of the dependencies of its members in global order.
+ *          The result is computed once and reused for the life of this object.
+ * \param aGroups The column indices in each group.
+ * \param aAffectedRows The rows which may be affected by each column.
+ * \return True if grouping is enabled, false otherwise.
+ */
+bool LogEDFun::columnGroups(std::vector<std::vector<int> > &aGroups,
+                            std::vector<std::vector<int> > &aAffectedRows)
+{
+    if(!mUseColumnGroups) {
+        return false;
+    }
+
+    if(mColumnGroups.empty() && na > 0) {
+        // Index each activity's position in the global ordering and invert the
+        // market dependencies so we can find which markets each activity touches.
+        const std::vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+        std::map<IActivity*, int> orderIndex = getOrderIndex();
+        std::vector<std::vector<int> > activityToMkts(globalOrdering.size());
+        for(int i=0; i<na; ++i) {
+            const std::vector<IActivity*>& deps = mkts[i].getDependencies();
+            for(size_t k=0; k<deps.size(); ++k) {
+                activityToMkts[orderIndex[deps[k]]].push_back(i);
+            }
+        }
+
+        mAffectedRows.assign(na, std::vector<int>());
+        for(int j=0; j<na; ++j) {
+            std::set<int> rows;
+            rows.insert(j);
+            const std::vector<IActivity*>& deps = mkts[j].getDependencies();
+            for(size_t k=0; k<deps.size(); ++k) {
+                const std::vector<int>& touched = activityToMkts[orderIndex[deps[k]]];
+                rows.insert(touched.begin(), touched.end());
+            }
+            mAffectedRows[j].assign(rows.begin(), rows.end());
+        }
+
+        // Greedy coloring: give each column the lowest color not already used
+        // by a column that affects any of the same rows.
+        std::vector<std::set<int> > rowColors(nr);
+        std::vector<int> color(na);
+        int ncolor = 0;
+        for(int j=0; j<na; ++j) {
+            std::set<int> forbidden;
+            for(size_t r=0; r<mAffectedRows[j].size(); ++r) {
+                const std::set<int>& used = rowColors[mAffectedRows[j][r]];
+                forbidden.insert(used.begin(), used.end());
+            }
+            int c = 0;
+            while(forbidden.find(c) != forbidden.end()) {
+                ++c;
+            }
+            color[j] = c;
+            ncolor = std::max(ncolor, c+1);
+            for(size_t r=0; r<mAffectedRows[j].size(); ++r) {
+                rowColors[mAffectedRows[j][r]].insert(c);
+            }
+        }
+
+        mColumnGroups.assign(ncolor, std::vector<int>());
+        for(int j=0; j<na; ++j) {
+            mColumnGroups[color[j]].push_back(j);
+        }
+
+        // Merge the dependencies for each group keeping the global order.
+        mGroupCalcLists.assign(ncolor, std::vector<IActivity*>());
+        for(int g=0; g<ncolor; ++g) {
+            std::set<int> calcIndices;
+            for(size_t k=0; k<mColumnGroups[g].size(); ++k) {
+                const std::vector<IActivity*>& deps = mkts[mColumnGroups[g][k]].getDependencies();
+                for(size_t d=0; d<deps.size(); ++d) {
+                    calcIndices.insert(orderIndex[deps[d]]);
+                }
+            }
+            for(std::set<int>::const_iterator it = calcIndices.begin(); it != calcIndices.end(); ++it) {
+                mGroupCalcLists[g].push_back(globalOrdering[*it]);
+            }
+        }
+
+        ILogger& solverLog = ILogger::getLogger("solver_log");
+        solverLog.setLevel(ILogger::NOTICE);
+        solverLog << "Jacobian column grouping: " << na << " columns in "
+                  << ncolor << " groups." << std::endl;
+    }
+
+    aGroups = mColumnGroups;
+    aAffectedRows = mAffectedRows;
+    return true;
+}
+
+/*!
+ * \brief Evaluate the model with the prices of all markets in a column group
+ *        perturbed at once.
+ * \details This follows the partial derivative version of operator() except
+ *          that the activities to recalculate are the union of the dependencies
+ *          of every market in the group.  It is only valid after columnGroups
+ *          has been called and partial() has set up the scratch state.
+ * \param ax The scaled inputs.
+ * \param fx The output vector.
+ * \param aGroup The index of the column group being evaluated.
+ */
+void LogEDFun::evalGroup(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, const int aGroup)
+{
+  assert(aGroup >= 0 && aGroup < mColumnGroups.size());
+
+  Timer& edfunMiscTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_MISC );
+  edfunMiscTimer.start();
+
+  UBVECTOR<double> x(ax.size());
+  for(unsigned int i=0; i<x.size(); ++i)
+      x[i] = ax[i]*mxscl[i];
+
+  mktplc->mIsDerivativeCalc = true;
+  const std::vector<int>& cols = mColumnGroups[aGroup];
+  for(size_t k=0; k<cols.size(); ++k) {
+    int j = cols[k];
+    if(mLogPricep) {
+      mkts[j].setPrice(x[j] > ARGMAX ? PMAX : exp(x[j]));
+    }
+    else {
+      mkts[j].setPrice(x[j]);
+    }
+  }
+  edfunMiscTimer.stop();
+
+  Timer& evalPartTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_PART );
+  evalPartTimer.start();
+  world->calc(period, mGroupCalcLists[aGroup]);
+  evalPartTimer.stop();
+
+  edfunMiscTimer.start();
+  collectOutputs(x, fx);
   edfunMiscTimer.stop();
 }
 
@@ -98,3 +98,7 @@ bool HasMarketFlagSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aS
     assert( !mMarketInfoKey.empty() );
     return aSolutionInfo.getMarketInfo()->getBoolean( mMarketInfoKey, false );
 }
+
+bool HasMarketFlagSolutionInfoFilter::isInvariantInPeriod() const {
+    return true;
+}
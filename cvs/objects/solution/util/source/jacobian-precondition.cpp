@@ -46,6 +46,7 @@
 #include "solution/util/include/jacobian-precondition.hpp"
 
 #include "util/base/include/timer.h"
+#include "util/base/include/configuration.h"
 
 #if USE_LAPACK
 #define UBMATRIX boost::numeric::ublas::matrix<double,boost::numeric::ublas::column_major>
@@ -64,6 +65,11 @@ int jacobian_precondition(UBVECTOR &x, UBVECTOR &fx, UBMATRIX &J, VecFVec<double
   const double JPCLOGINCR = 1.0;   // corresponds to an e-fold increase in price if x is a log-price.  This must always be >0
   const double JPCLINEARFAC = 2.0; // This must always be >1.
   const int ITMAX = 50;
+  const double JPCWIDESTEP = 1.0e-3; // relative step used to retry a singular column
+  // Whether to first check if a tiny diagonal is just noise from the small
+  // finite difference step before searching for a new price.
+  const static bool retryWideStep =
+    Configuration::getInstance()->getBool( "jacobian-precondition-wide-step", false, false );
   int fail = 0;
   int change = 0;
   int ncol = (int) x.size();
@@ -93,6 +99,25 @@ int jacobian_precondition(UBVECTOR &x, UBVECTOR &fx, UBMATRIX &J, VecFVec<double
                       << std::endl;
     }
     
+    if(diagval < JPCMIN && fabs(fx[j]) > FTOL && retryWideStep) {
+        // The small step fdjac uses may have fallen entirely within a
+        // flat or kinked part of the supply or demand curves.  A single
+        // partial evaluation with a wider step is much cheaper than the
+        // price search below, which would also force the entire
+        // Jacobian to be recalculated.  If it finds a usable derivative
+        // the new column is kept and the price left alone.  As in fdjac
+        // the partial evaluation is done in the scratch state and the
+        // base state restored for full evaluations afterwards.
+        UBVECTOR xx(x),fxw(fx.size());
+        scenario->getManageStateVariables()->setPartialDeriv(true);
+        jacol_ws(F, xx, fxw, fx, j, J, true, NULL, JPCWIDESTEP);
+        F.partial(-1);
+        diagval = fabs(J(j,j));
+        if(diagnostic) {
+          (*diagnostic) << "	j= " << j << "  wide step J(j,j) = " << J(j,j) << std::endl;
+        }
+    }
+
     if(diagval < JPCMIN && fabs(fx[j]) > FTOL) {
         // Tiny derivative on the diagonal, which will likely cause
         // the Jacobian to be singular.  If fx[j] is nearly zero,
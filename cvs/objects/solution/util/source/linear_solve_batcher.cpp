@@ -0,0 +1,237 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+ * \file linear_solve_batcher.cpp
+ * \ingroup Solution
+ * \brief LinearSolveBatcher class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <map>
+
+#include "solution/util/include/linear_solve_batcher.hpp"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+#if USE_CUBLAS
+#include <cuda_runtime.h>
+#endif
+
+using namespace std;
+
+/*!
+ * \brief Constructor which reads the configuration and initializes the device.
+ * \details This must not be called until the configuration has been read.
+ */
+LinearSolveBatcher::LinearSolveBatcher()
+:mIsEnabled( false ),
+mMinSize( Configuration::getInstance()->getInt( "linear-solve-batch-min-size", 16, false ) )
+#if USE_CUBLAS
+,
+mHandle( 0 ),
+mDeviceLU( 0 ),
+mDevicePointers( 0 ),
+mDevicePivots( 0 ),
+mDeviceInfo( 0 ),
+mDeviceLUSize( 0 ),
+mDeviceBatchSize( 0 ),
+mDevicePivotsSize( 0 )
+#endif
+{
+    if( !Configuration::getInstance()->getBool( "batch-linear-solves", false, false ) ) {
+        return;
+    }
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if USE_CUBLAS
+    if( cublasCreate( &mHandle ) != CUBLAS_STATUS_SUCCESS ) {
+        mHandle = 0;
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not initialize cuBLAS, batch-linear-solves will be ignored." << endl;
+        return;
+    }
+    mIsEnabled = true;
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Batching LU factorizations of diagonal blocks of at least " << mMinSize << " markets on the GPU." << endl;
+#else
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Batched linear solves require building with USE_CUBLAS, batch-linear-solves will be ignored." << endl;
+#endif
+}
+
+//! Destructor which releases the device.
+LinearSolveBatcher::~LinearSolveBatcher() {
+#if USE_CUBLAS
+    cudaFree( mDeviceLU );
+    cudaFree( mDevicePointers );
+    cudaFree( mDevicePivots );
+    cudaFree( mDeviceInfo );
+    if( mHandle ) {
+        cublasDestroy( mHandle );
+    }
+#endif
+}
+
+/*!
+ * \brief Get the single instance of the batcher.
+ * \details The instance is created on first use which must be after the
+ *          configuration is read.
+ * \return The batcher.
+ */
+LinearSolveBatcher& LinearSolveBatcher::getInstance() {
+    static LinearSolveBatcher batcher;
+    return batcher;
+}
+
+/*!
+ * \brief Factor a batch of matrices, grouped by dimension.
+ * \details The results are in the LAPACK dgetrf convention.  Any matrix which
+ *          could not be factored on the device is left unchanged with
+ *          mIsFactored false for the caller to factor.
+ * \param aBatch The matrices to factor.
+ */
+void LinearSolveBatcher::factorize( vector<Matrix>& aBatch ) {
+    map<int, vector<Matrix*> > groups;
+    for( vector<Matrix>::iterator it = aBatch.begin(); it != aBatch.end(); ++it ) {
+        it->mInfo = 0;
+        it->mIsFactored = false;
+        groups[ it->mN ].push_back( &*it );
+    }
+    for( map<int, vector<Matrix*> >::const_iterator group = groups.begin(); group != groups.end(); ++group ) {
+        if( !mIsEnabled || !factorizeOnDevice( group->second ) ) {
+            // Leave the matrices unfactored for the CPU.
+            continue;
+        }
+        for( vector<Matrix*>::const_iterator it = group->second.begin(); it != group->second.end(); ++it ) {
+            ( *it )->mIsFactored = true;
+        }
+    }
+}
+
+/*!
+ * \brief Factor matrices of the same dimension with cublasDgetrfBatched.
+ * \details On any device error batching is turned off for the rest of the
+ *          run.  The matrices are only written to once all of the results
+ *          have been copied back.
+ * \param aGroup The matrices to factor, all of the same dimension.
+ * \return Whether the matrices were factored.
+ */
+bool LinearSolveBatcher::factorizeOnDevice( const vector<Matrix*>& aGroup ) {
+#if USE_CUBLAS
+    lock_guard<mutex> deviceLock( mDeviceMutex );
+    const int n = aGroup.front()->mN;
+    const size_t matrixSize = static_cast<size_t>( n ) * n;
+    const size_t batchSize = aGroup.size();
+
+    bool success = reserveDevice( batchSize, n );
+    mHostLU.resize( batchSize * matrixSize );
+    mHostPivots.resize( batchSize * n );
+    vector<double*> pointers( batchSize );
+    vector<int> info( batchSize );
+    for( size_t k = 0; success && k < batchSize; ++k ) {
+        copy( aGroup[ k ]->mLU, aGroup[ k ]->mLU + matrixSize, mHostLU.begin() + k * matrixSize );
+        pointers[ k ] = mDeviceLU + k * matrixSize;
+    }
+
+    success = success &&
+        cudaMemcpy( mDeviceLU, &mHostLU[ 0 ], mHostLU.size() * sizeof( double ), cudaMemcpyHostToDevice ) == cudaSuccess &&
+        cudaMemcpy( mDevicePointers, &pointers[ 0 ], batchSize * sizeof( double* ), cudaMemcpyHostToDevice ) == cudaSuccess &&
+        cublasDgetrfBatched( mHandle, n, mDevicePointers, n, mDevicePivots, mDeviceInfo,
+                             static_cast<int>( batchSize ) ) == CUBLAS_STATUS_SUCCESS &&
+        cudaMemcpy( &mHostLU[ 0 ], mDeviceLU, mHostLU.size() * sizeof( double ), cudaMemcpyDeviceToHost ) == cudaSuccess &&
+        cudaMemcpy( &mHostPivots[ 0 ], mDevicePivots, mHostPivots.size() * sizeof( int ), cudaMemcpyDeviceToHost ) == cudaSuccess &&
+        cudaMemcpy( &info[ 0 ], mDeviceInfo, batchSize * sizeof( int ), cudaMemcpyDeviceToHost ) == cudaSuccess;
+    if( !success ) {
+        mIsEnabled = false;
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The batched LU factorization on the GPU failed, falling back to the CPU." << endl;
+        return false;
+    }
+
+    for( size_t k = 0; k < batchSize; ++k ) {
+        copy( mHostLU.begin() + k * matrixSize, mHostLU.begin() + ( k + 1 ) * matrixSize, aGroup[ k ]->mLU );
+        copy( mHostPivots.begin() + k * n, mHostPivots.begin() + ( k + 1 ) * n, aGroup[ k ]->mPivots );
+        aGroup[ k ]->mInfo = info[ k ];
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if USE_CUBLAS
+/*!
+ * \brief Make sure the device buffers can hold a batch.
+ * \details The buffers only grow so that a run allocates them a few times.
+ * \param aBatchSize The number of matrices.
+ * \param aN The dimension of the matrices.
+ * \return Whether the buffers could be allocated.
+ */
+bool LinearSolveBatcher::reserveDevice( const size_t aBatchSize, const size_t aN ) {
+    const size_t luSize = aBatchSize * aN * aN;
+    if( luSize > mDeviceLUSize ) {
+        cudaFree( mDeviceLU );
+        mDeviceLU = 0;
+        mDeviceLUSize = 0;
+        if( cudaMalloc( reinterpret_cast<void**>( &mDeviceLU ), luSize * sizeof( double ) ) != cudaSuccess ) {
+            return false;
+        }
+        mDeviceLUSize = luSize;
+    }
+    if( aBatchSize > mDeviceBatchSize ) {
+        cudaFree( mDevicePointers );
+        cudaFree( mDeviceInfo );
+        mDevicePointers = 0;
+        mDeviceInfo = 0;
+        mDeviceBatchSize = 0;
+        if( cudaMalloc( reinterpret_cast<void**>( &mDevicePointers ), aBatchSize * sizeof( double* ) ) != cudaSuccess ||
+            cudaMalloc( reinterpret_cast<void**>( &mDeviceInfo ), aBatchSize * sizeof( int ) ) != cudaSuccess )
+        {
+            return false;
+        }
+        mDeviceBatchSize = aBatchSize;
+    }
+    const size_t pivotsSize = aBatchSize * aN;
+    if( pivotsSize > mDevicePivotsSize ) {
+        cudaFree( mDevicePivots );
+        mDevicePivots = 0;
+        mDevicePivotsSize = 0;
+        if( cudaMalloc( reinterpret_cast<void**>( &mDevicePivots ), pivotsSize * sizeof( int ) ) != cudaSuccess ) {
+            return false;
+        }
+        mDevicePivotsSize = pivotsSize;
+    }
+    return true;
+}
+#endif
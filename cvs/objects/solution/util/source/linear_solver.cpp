@@ -0,0 +1,1173 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+*
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+*
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+*
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file linear_solver.cpp
+ * \ingroup Solution
+ * \brief LinearSolver class source file.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <iterator>
+
+#include "solution/util/include/linear_solver.hpp"
+#include "solution/util/include/linear_solve_batcher.hpp"
+#include "util/base/include/definitions.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#endif
+
+#if USE_LAPACK
+// LAPACK (or MKL) Fortran entry points
+extern "C" {
+    void dgetrf_( const int* m, const int* n, double* a, const int* lda, int* ipiv, int* info );
+    void dgetrs_( const char* trans, const int* n, const int* nrhs, const double* a, const int* lda,
+                  const int* ipiv, double* b, const int* ldb, int* info );
+    void dgecon_( const char* norm, const int* n, const double* a, const int* lda, const double* anorm,
+                  double* rcond, double* work, int* iwork, int* info );
+    void sgetrf_( const int* m, const int* n, float* a, const int* lda, int* ipiv, int* info );
+    void sgetrs_( const char* trans, const int* n, const int* nrhs, const float* a, const int* lda,
+                  const int* ipiv, float* b, const int* ldb, int* info );
+}
+#elif USE_EIGEN
+#include <Eigen/Dense>
+#endif
+
+using namespace std;
+
+const double LinearSolver::RCOND_THRESHOLD = 1.0e-12;
+
+/*!
+ * \brief Reciprocal condition number below which a single precision
+ *        factorization is not used.
+ * \details Iterative refinement converges at a rate of about
+ *          cond(A) * FLT_EPSILON per step, so it is only worthwhile well
+ *          below 1 / FLT_EPSILON.
+ */
+const double LinearSolver::MIXED_RCOND_THRESHOLD = 1.0e-4;
+
+/*!
+ * \brief Largest fraction of nonzero entries, in the matrix or in the factors
+ *        predicted by its ordering, for which the sparse factorization is used.
+ * \details Past this the indexing overhead of the sparse factors costs more
+ *          than the arithmetic they save.
+ */
+const double LinearSolver::SPARSE_MAX_DENSITY = 0.2;
+
+/*!
+ * \brief Threshold partial pivoting tolerance of the sparse factorization.
+ * \details The diagonal entry is kept as the pivot, preserving the fill
+ *          reducing ordering, unless it is smaller than this fraction of the
+ *          largest candidate in its column.  This is KLU's default.
+ */
+const double LinearSolver::SPARSE_PIVOT_TOLERANCE = 1.0e-3;
+
+namespace {
+    //! Maximum number of refinement steps before giving up on the single precision factors.
+    const int MAX_REFINEMENT_STEPS = 30;
+
+    /*!
+     * \brief Right-looking LU with partial pivoting of a column major single
+     *        precision matrix, as in the built-in double precision backend.
+     * \param aLU The matrix on input, the factors on output.
+     * \param aN The dimension.
+     * \param aPivots The 0-based row interchanges.
+     * \param aRCond The ratio of the extreme pivots.
+     * \return 0 on success or the 1-based index of the first zero pivot.
+     */
+    int factorizeSingle( float* aLU, const int aN, int* aPivots, double& aRCond ) {
+        aRCond = 0.0;
+#if USE_LAPACK
+        int info = 0;
+        sgetrf_( &aN, &aN, aLU, &aN, aPivots, &info );
+        for( int i = 0; i < aN; ++i ) {
+            --aPivots[ i ];
+        }
+        if( info != 0 ) {
+            return info < 0 ? 1 : info;
+        }
+#else
+        for( int k = 0; k < aN; ++k ) {
+            float* colk = &aLU[ k * aN ];
+            int p = k;
+            for( int i = k + 1; i < aN; ++i ) {
+                if( fabs( colk[ i ] ) > fabs( colk[ p ] ) ) {
+                    p = i;
+                }
+            }
+            aPivots[ k ] = p;
+            if( colk[ p ] == 0.0f ) {
+                return k + 1;
+            }
+            if( p != k ) {
+                for( int j = 0; j < aN; ++j ) {
+                    swap( aLU[ j * aN + k ], aLU[ j * aN + p ] );
+                }
+            }
+            const float pivot = colk[ k ];
+            for( int i = k + 1; i < aN; ++i ) {
+                colk[ i ] /= pivot;
+            }
+            for( int j = k + 1; j < aN; ++j ) {
+                float* colj = &aLU[ j * aN ];
+                const float ukj = colj[ k ];
+                if( ukj != 0.0f ) {
+                    for( int i = k + 1; i < aN; ++i ) {
+                        colj[ i ] -= colk[ i ] * ukj;
+                    }
+                }
+            }
+        }
+#endif
+        double umax = 0.0;
+        double umin = 0.0;
+        for( int k = 0; k < aN; ++k ) {
+            const double pivot = fabs( aLU[ k * aN + k ] );
+            umax = k == 0 ? pivot : max( umax, pivot );
+            umin = k == 0 ? pivot : min( umin, pivot );
+        }
+        aRCond = umax > 0.0 ? umin / umax : 0.0;
+        return 0;
+    }
+
+    /*!
+     * \brief Solve with single precision factors from factorizeSingle.
+     * \param aLU The factors.
+     * \param aPivots The 0-based row interchanges.
+     * \param aN The dimension.
+     * \param aB On input the right hand side, on output the solution.
+     */
+    void solveSingle( const float* aLU, const int* aPivots, const int aN, vector<float>& aB ) {
+#if USE_LAPACK
+        vector<int> ipiv( aPivots, aPivots + aN );
+        for( int i = 0; i < aN; ++i ) {
+            ++ipiv[ i ];
+        }
+        const char trans = 'N';
+        const int nrhs = 1;
+        int info = 0;
+        sgetrs_( &trans, &aN, &nrhs, aLU, &aN, &ipiv[ 0 ], &aB[ 0 ], &aN, &info );
+#else
+        for( int i = 0; i < aN; ++i ) {
+            if( aPivots[ i ] != i ) {
+                swap( aB[ i ], aB[ aPivots[ i ] ] );
+            }
+        }
+        for( int j = 0; j < aN; ++j ) {
+            const float bj = aB[ j ];
+            if( bj != 0.0f ) {
+                const float* colj = &aLU[ j * aN ];
+                for( int i = j + 1; i < aN; ++i ) {
+                    aB[ i ] -= colj[ i ] * bj;
+                }
+            }
+        }
+        for( int j = aN - 1; j >= 0; --j ) {
+            const float* colj = &aLU[ j * aN ];
+            aB[ j ] /= colj[ j ];
+            const float bj = aB[ j ];
+            for( int i = 0; i < j; ++i ) {
+                aB[ i ] -= colj[ i ] * bj;
+            }
+        }
+#endif
+    }
+}
+
+LinearSolver::LinearSolver():
+mN( 0 ),
+mRCond( 0.0 ),
+mUseBlocks( false ),
+mMixedPrecision( false ),
+mIsSinglePrecision( false ),
+mNormInf( 0.0 ),
+mSparse( false ),
+mIsSparse( false )
+{
+}
+
+/*!
+ * \brief Set whether subsequent factorizations use block triangular form.
+ * \param aUseBlocks True to decompose the matrix into its strongly connected
+ *        blocks before factoring.
+ */
+void LinearSolver::setBlockTriangular( const bool aUseBlocks ) {
+    mUseBlocks = aUseBlocks;
+}
+
+/*!
+ * \brief Set whether subsequent factorizations are done in single precision
+ *        with the solution refined in double precision.
+ * \details This is meant for large systems, where the factorization
+ *          dominates and single precision halves the memory traffic (and
+ *          on most hardware doubles the arithmetic rate).  When the single
+ *          precision factors are too ill-conditioned, or refinement stalls
+ *          during a solve, the matrix is factored in double precision as
+ *          usual.  With block triangular form the setting applies to each
+ *          of the diagonal blocks.
+ * \param aMixedPrecision True to factor in single precision when possible.
+ */
+void LinearSolver::setMixedPrecision( const bool aMixedPrecision ) {
+    mMixedPrecision = aMixedPrecision;
+}
+
+/*!
+ * \brief Set whether subsequent factorizations are done in sparse form when
+ *        the matrix is sparse enough.
+ * \details With block triangular form the setting applies to each of the
+ *          diagonal blocks.  The sparse factorization takes precedence over
+ *          mixed precision.
+ * \param aSparse True to use the sparse factorization when possible.
+ */
+void LinearSolver::setSparse( const bool aSparse ) {
+    mSparse = aSparse;
+}
+
+//! Number of entries stored in the factors of the last factorization.
+size_t LinearSolver::getFactorNonzeros() const {
+    if( mUseBlocks ) {
+        size_t nonzeros = 0;
+        for( size_t k = 0; k < mBlocks.size(); ++k ) {
+            nonzeros += mBlocks[ k ].getFactorNonzeros();
+        }
+        return nonzeros;
+    }
+    if( mIsSparse ) {
+        // the unit diagonal of L is stored but is not counted
+        return mLValues.size() + mUValues.size() - mN;
+    }
+    return mN * mN;
+}
+
+//! Size of the largest diagonal block in the last factorization.
+size_t LinearSolver::getMaxBlockSize() const {
+    if( !mUseBlocks ) {
+        return mN;
+    }
+    size_t maxSize = 0;
+    for( size_t k = 0; k < mBlockIndices.size(); ++k ) {
+        maxSize = max( maxSize, mBlockIndices[ k ].size() );
+    }
+    return maxSize;
+}
+
+//! Name of the backend selected at compile time, for logging.
+const char* LinearSolver::getBackendName() {
+#if USE_LAPACK
+    return "lapack";
+#elif USE_EIGEN
+    return "eigen";
+#else
+    return "builtin";
+#endif
+}
+
+/*!
+ * \brief Whether the last factorization may be used for a Newton step.
+ * \return True if the condition estimate is above RCOND_THRESHOLD.
+ */
+bool LinearSolver::isWellConditioned() const {
+    return mRCond > RCOND_THRESHOLD;
+}
+
+/*!
+ * \brief Factor mLU in place using the selected backend.
+ * \return 0 on success or the 1-based index of the first zero pivot.
+ */
+int LinearSolver::factorizeLU() {
+    const int n = mN;
+    mPivots.resize( mN );
+    mRCond = 0.0;
+    mIsSinglePrecision = false;
+    mIsSparse = false;
+    mA.clear();
+    mLUSingle.clear();
+    if( n == 0 ) {
+        return 0;
+    }
+    if( mUseBlocks ) {
+        return factorizeBlocks();
+    }
+
+    if( mSparse ) {
+        const int sing = factorizeSparse();
+        if( sing >= 0 ) {
+            return sing;
+        }
+    }
+
+    if( mMixedPrecision ) {
+        // The double precision matrix is kept for the refinement residuals
+        // and in case we need to fall back to factoring it.
+        mLUSingle.assign( mLU.begin(), mLU.end() );
+        double rcond = 0.0;
+        if( factorizeSingle( &mLUSingle[ 0 ], n, &mPivots[ 0 ], rcond ) == 0 && rcond > MIXED_RCOND_THRESHOLD ) {
+            mA.swap( mLU );
+            mNormInf = 0.0;
+            for( int i = 0; i < n; ++i ) {
+                double rowsum = 0.0;
+                for( int j = 0; j < n; ++j ) {
+                    rowsum += fabs( mA[ j * n + i ] );
+                }
+                mNormInf = max( mNormInf, rowsum );
+            }
+            mIsSinglePrecision = true;
+            mRCond = rcond;
+            return 0;
+        }
+        mLUSingle.clear();
+    }
+    return factorizeDouble();
+}
+
+/*!
+ * \brief Factor mLU in place in double precision using the selected backend.
+ * \return 0 on success or the 1-based index of the first zero pivot.
+ */
+int LinearSolver::factorizeDouble() {
+    const int n = mN;
+    // A large matrix may be factored on the GPU, which leaves it alone if it
+    // can not be done.
+    LinearSolveBatcher& batcher = LinearSolveBatcher::getInstance();
+    if( batcher.shouldBatch( n ) ) {
+        const double anorm = getNorm1();
+        vector<LinearSolveBatcher::Matrix> batch( 1 );
+        batch[ 0 ].mLU = &mLU[ 0 ];
+        batch[ 0 ].mPivots = &mPivots[ 0 ];
+        batch[ 0 ].mN = n;
+        batcher.factorize( batch );
+        if( batch[ 0 ].mIsFactored ) {
+            return finishBatched( batch[ 0 ].mInfo, anorm );
+        }
+    }
+
+#if USE_LAPACK
+    // the 1-norm of A is needed by dgecon and must be taken before the
+    // factorization overwrites it
+    double anorm = 0.0;
+    for( int j = 0; j < n; ++j ) {
+        double colsum = 0.0;
+        for( int i = 0; i < n; ++i ) {
+            colsum += fabs( mLU[ j * n + i ] );
+        }
+        anorm = max( anorm, colsum );
+    }
+    int info = 0;
+    dgetrf_( &n, &n, &mLU[ 0 ], &n, &mPivots[ 0 ], &info );
+    // convert the 1-based pivots to 0-based row indices
+    for( int i = 0; i < n; ++i ) {
+        --mPivots[ i ];
+    }
+    if( info != 0 ) {
+        return info < 0 ? 1 : info;
+    }
+    vector<double> work( 4 * n );
+    vector<int> iwork( n );
+    const char norm = '1';
+    dgecon_( &norm, &n, &mLU[ 0 ], &n, &anorm, &mRCond, &work[ 0 ], &iwork[ 0 ], &info );
+    return 0;
+#elif USE_EIGEN
+    Eigen::Map<Eigen::MatrixXd> A( &mLU[ 0 ], n, n );
+    Eigen::PartialPivLU<Eigen::MatrixXd> lu( A );
+    A = lu.matrixLU();
+    mRCond = lu.rcond();
+
+    // Eigen reports P such that P*A = L*U; turn it into the sequence of
+    // row interchanges that produces the same ordering
+    const Eigen::PartialPivLU<Eigen::MatrixXd>::PermutationType::IndicesType& idx =
+        lu.permutationP().indices();
+    vector<int> target( n ), cur( n ), where( n );
+    for( int i = 0; i < n; ++i ) {
+        target[ idx[ i ] ] = i;
+        cur[ i ] = i;
+        where[ i ] = i;
+    }
+    for( int i = 0; i < n; ++i ) {
+        int k = where[ target[ i ] ];
+        mPivots[ i ] = k;
+        int rowi = cur[ i ];
+        cur[ i ] = cur[ k ];
+        cur[ k ] = rowi;
+        where[ cur[ i ] ] = i;
+        where[ cur[ k ] ] = k;
+    }
+    for( int i = 0; i < n; ++i ) {
+        if( mLU[ i * n + i ] == 0.0 ) {
+            mRCond = 0.0;
+            return i + 1;
+        }
+    }
+    return 0;
+#else
+    // right-looking LU with partial pivoting on the column major array
+    double umax = 0.0;
+    double umin = 0.0;
+    for( int k = 0; k < n; ++k ) {
+        double* colk = &mLU[ k * n ];
+        int p = k;
+        for( int i = k + 1; i < n; ++i ) {
+            if( fabs( colk[ i ] ) > fabs( colk[ p ] ) ) {
+                p = i;
+            }
+        }
+        mPivots[ k ] = p;
+        if( colk[ p ] == 0.0 ) {
+            return k + 1;
+        }
+        if( p != k ) {
+            for( int j = 0; j < n; ++j ) {
+                swap( mLU[ j * n + k ], mLU[ j * n + p ] );
+            }
+        }
+        const double pivot = colk[ k ];
+        for( int i = k + 1; i < n; ++i ) {
+            colk[ i ] /= pivot;
+        }
+        for( int j = k + 1; j < n; ++j ) {
+            double* colj = &mLU[ j * n ];
+            const double ukj = colj[ k ];
+            if( ukj != 0.0 ) {
+                for( int i = k + 1; i < n; ++i ) {
+                    colj[ i ] -= colk[ i ] * ukj;
+                }
+            }
+        }
+        umax = k == 0 ? fabs( pivot ) : max( umax, fabs( pivot ) );
+        umin = k == 0 ? fabs( pivot ) : min( umin, fabs( pivot ) );
+    }
+    // ratio of the extreme pivots; cheap, and good enough to tell a
+    // usable Jacobian from a nearly singular one
+    mRCond = umin / umax;
+    return 0;
+#endif
+}
+
+/*!
+ * \brief The 1-norm of mLU, before it is factored.
+ * \return The largest absolute column sum.
+ */
+double LinearSolver::getNorm1() const {
+    double anorm = 0.0;
+    for( size_t j = 0; j < mN; ++j ) {
+        double colsum = 0.0;
+        for( size_t i = 0; i < mN; ++i ) {
+            colsum += fabs( mLU[ j * mN + i ] );
+        }
+        anorm = max( anorm, colsum );
+    }
+    return anorm;
+}
+
+/*!
+ * \brief Estimate the reciprocal condition number from the factors in mLU.
+ * \details With LAPACK this is dgecon, otherwise the ratio of the extreme
+ *          pivots as in the built-in factorization.
+ * \param aNorm1 The 1-norm of the matrix before it was factored.
+ * \return The estimate.
+ */
+double LinearSolver::estimateRCond( const double aNorm1 ) const {
+    const int n = mN;
+#if USE_LAPACK
+    double rcond = 0.0;
+    int info = 0;
+    vector<double> work( 4 * n );
+    vector<int> iwork( n );
+    const char norm = '1';
+    dgecon_( &norm, &n, &mLU[ 0 ], &n, &aNorm1, &rcond, &work[ 0 ], &iwork[ 0 ], &info );
+    return rcond;
+#else
+    double umax = 0.0;
+    double umin = 0.0;
+    for( int k = 0; k < n; ++k ) {
+        const double pivot = fabs( mLU[ k * n + k ] );
+        umax = k == 0 ? pivot : max( umax, pivot );
+        umin = k == 0 ? pivot : min( umin, pivot );
+    }
+    return umax > 0.0 ? umin / umax : 0.0;
+#endif
+}
+
+/*!
+ * \brief Complete a factorization of mLU done by LinearSolveBatcher.
+ * \details The batcher leaves the pivots 1-based, as dgetrf does.
+ * \param aInfo The LAPACK style info of the factorization.
+ * \param aNorm1 The 1-norm of the matrix before it was factored.
+ * \return 0 on success or the 1-based index of the first zero pivot.
+ */
+int LinearSolver::finishBatched( const int aInfo, const double aNorm1 ) {
+    for( size_t i = 0; i < mN; ++i ) {
+        --mPivots[ i ];
+    }
+    if( aInfo != 0 ) {
+        mRCond = 0.0;
+        return aInfo < 0 ? 1 : aInfo;
+    }
+    mRCond = estimateRCond( aNorm1 );
+    return 0;
+}
+
+/*!
+ * \brief Permute mLU, which still holds the unfactored matrix, to block lower
+ *        triangular form and factor the diagonal blocks.
+ * \details The blocks are the strongly connected components of the graph with
+ *          an edge i -> j for every nonzero A(i,j), found with Tarjan's
+ *          algorithm.  Tarjan's algorithm completes a component only after
+ *          every component reachable from it, so taking the blocks in the
+ *          order they are found lets each one be solved using only solutions
+ *          from earlier blocks.  The unfactored matrix is kept so that the
+ *          coupling entries are available for the solve.  The condition
+ *          estimate is the smallest of those of the diagonal blocks.
+ * \return 0 on success or the 1-based (original) index of a zero pivot.
+ */
+int LinearSolver::factorizeBlocks() {
+    const int n = mN;
+    mBlockIndices.clear();
+    mBlocks.clear();
+    mCouplings.clear();
+
+    // Iterative version of Tarjan's strongly connected components algorithm.
+    const int UNVISITED = -1;
+    vector<int> index( n, UNVISITED ), lowlink( n, 0 ), component( n, -1 );
+    vector<bool> onStack( n, false );
+    vector<int> sccStack;
+    vector<pair<int, int> > callStack; // (vertex, next column to examine)
+    int nextIndex = 0;
+    for( int root = 0; root < n; ++root ) {
+        if( index[ root ] != UNVISITED ) {
+            continue;
+        }
+        callStack.push_back( make_pair( root, 0 ) );
+        while( !callStack.empty() ) {
+            const int v = callStack.back().first;
+            int& j = callStack.back().second;
+            if( j == 0 ) {
+                index[ v ] = lowlink[ v ] = nextIndex++;
+                sccStack.push_back( v );
+                onStack[ v ] = true;
+            }
+            bool descended = false;
+            for( ; j < n; ++j ) {
+                if( j == v || mLU[ j * n + v ] == 0.0 ) {
+                    continue;
+                }
+                if( index[ j ] == UNVISITED ) {
+                    ++j;
+                    callStack.push_back( make_pair( j - 1, 0 ) );
+                    descended = true;
+                    break;
+                }
+                else if( onStack[ j ] ) {
+                    lowlink[ v ] = min( lowlink[ v ], index[ j ] );
+                }
+            }
+            if( descended ) {
+                continue;
+            }
+            if( lowlink[ v ] == index[ v ] ) {
+                vector<int> block;
+                int w;
+                do {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[ w ] = false;
+                    component[ w ] = mBlockIndices.size();
+                    block.push_back( w );
+                } while( w != v );
+                sort( block.begin(), block.end() );
+                mBlockIndices.push_back( block );
+            }
+            callStack.pop_back();
+            if( !callStack.empty() ) {
+                const int parent = callStack.back().first;
+                lowlink[ parent ] = min( lowlink[ parent ], lowlink[ v ] );
+            }
+        }
+    }
+
+    // Gather the diagonal blocks and the entries coupling each block to the
+    // earlier ones.
+    const size_t nblocks = mBlockIndices.size();
+    vector<boost::numeric::ublas::matrix<double> > blockMatrices( nblocks );
+    mCouplings.resize( nblocks );
+    for( size_t k = 0; k < nblocks; ++k ) {
+        const vector<int>& idx = mBlockIndices[ k ];
+        const size_t m = idx.size();
+        blockMatrices[ k ] = boost::numeric::ublas::zero_matrix<double>( m, m );
+        for( size_t r = 0; r < m; ++r ) {
+            for( int j = 0; j < n; ++j ) {
+                const double aij = mLU[ j * n + idx[ r ] ];
+                if( aij == 0.0 ) {
+                    continue;
+                }
+                if( component[ j ] == static_cast<int>( k ) ) {
+                    const size_t c = lower_bound( idx.begin(), idx.end(), j ) - idx.begin();
+                    blockMatrices[ k ]( r, c ) = aij;
+                }
+                else {
+                    Coupling coupling = { static_cast<int>( r ), j, aij };
+                    mCouplings[ k ].push_back( coupling );
+                }
+            }
+        }
+    }
+
+    // The diagonal blocks are independent of one another so they can be
+    // factored concurrently.
+    mBlocks.resize( nblocks );
+    for( size_t k = 0; k < nblocks; ++k ) {
+        mBlocks[ k ].setMixedPrecision( mMixedPrecision );
+        mBlocks[ k ].setSparse( mSparse );
+    }
+    vector<int> blockSing( nblocks, 0 );
+
+    // Blocks which are large enough are factored together on the GPU, in a
+    // single batched call for each block size.  The single precision and
+    // sparse factorizations have no GPU equivalent so those blocks are left
+    // to the CPU.
+    vector<bool> isFactored( nblocks, false );
+    LinearSolveBatcher& batcher = LinearSolveBatcher::getInstance();
+    if( !mMixedPrecision && !mSparse ) {
+        vector<LinearSolveBatcher::Matrix> batch;
+        vector<size_t> batchBlocks;
+        vector<double> batchNorms;
+        for( size_t k = 0; k < nblocks; ++k ) {
+            if( !batcher.shouldBatch( blockMatrices[ k ].size1() ) ) {
+                continue;
+            }
+            LinearSolver& block = mBlocks[ k ];
+            block.setMatrix( blockMatrices[ k ] );
+            block.mPivots.resize( block.mN );
+            LinearSolveBatcher::Matrix matrix = { &block.mLU[ 0 ], &block.mPivots[ 0 ],
+                                                  static_cast<int>( block.mN ), 0, false };
+            batch.push_back( matrix );
+            batchBlocks.push_back( k );
+            batchNorms.push_back( block.getNorm1() );
+        }
+        if( !batch.empty() ) {
+            batcher.factorize( batch );
+        }
+        for( size_t b = 0; b < batch.size(); ++b ) {
+            if( batch[ b ].mIsFactored ) {
+                const size_t k = batchBlocks[ b ];
+                blockSing[ k ] = mBlocks[ k ].finishBatched( batch[ b ].mInfo, batchNorms[ b ] );
+                isFactored[ k ] = true;
+            }
+        }
+    }
+
+#if GCAM_PARALLEL_ENABLED
+    tbb::parallel_for( size_t( 0 ), nblocks, [&]( size_t k ) {
+        if( !isFactored[ k ] ) {
+            blockSing[ k ] = mBlocks[ k ].factorize( blockMatrices[ k ] );
+        }
+    } );
+#else
+    for( size_t k = 0; k < nblocks; ++k ) {
+        if( !isFactored[ k ] ) {
+            blockSing[ k ] = mBlocks[ k ].factorize( blockMatrices[ k ] );
+        }
+    }
+#endif
+
+    mRCond = 1.0;
+    for( size_t k = 0; k < nblocks; ++k ) {
+        if( blockSing[ k ] != 0 ) {
+            mRCond = 0.0;
+            return mBlockIndices[ k ][ blockSing[ k ] - 1 ] + 1;
+        }
+        mRCond = min( mRCond, mBlocks[ k ].getRCond() );
+    }
+    return 0;
+}
+
+/*!
+ * \brief Factor mLU, which still holds the unfactored matrix, in sparse form.
+ * \details The columns are taken in a minimum degree order of the pattern of
+ *          A+A^T and each column of L and U is computed in turn by a sparse
+ *          triangular solve with the columns of L found so far (the
+ *          left-looking algorithm of Gilbert and Peierls).  The rows which
+ *          can be nonzero in the solve are found beforehand by a depth first
+ *          search of the graph of L, so that the work is proportional to the
+ *          arithmetic rather than to n.  The row of each pivot is chosen by
+ *          threshold partial pivoting with a preference for the diagonal.
+ *          On success the dense matrix is released.
+ * \return 0 on success, the 1-based index of a zero pivot, or -1 if the
+ *         matrix is too dense to be worth factoring in sparse form, in which
+ *         case mLU is left as it was.
+ */
+int LinearSolver::factorizeSparse() {
+    const int n = mN;
+    mAColPtr.assign( n + 1, 0 );
+    mARowIdx.clear();
+    mAValues.clear();
+    for( int j = 0; j < n; ++j ) {
+        for( int i = 0; i < n; ++i ) {
+            const double aij = mLU[ j * n + i ];
+            if( aij != 0.0 ) {
+                mARowIdx.push_back( i );
+                mAValues.push_back( aij );
+            }
+        }
+        mAColPtr[ j + 1 ] = mARowIdx.size();
+    }
+    if( mARowIdx.size() > SPARSE_MAX_DENSITY * n * n || !orderMinimumDegree( mColOrder ) ) {
+        vector<int>().swap( mAColPtr );
+        vector<int>().swap( mARowIdx );
+        vector<double>().swap( mAValues );
+        return -1;
+    }
+
+    mRowPos.assign( n, -1 );
+    mLColPtr.assign( n + 1, 0 );
+    mUColPtr.assign( n + 1, 0 );
+    mLRowIdx.clear();
+    mLValues.clear();
+    mURowIdx.clear();
+    mUValues.clear();
+    vector<double> x( n, 0.0 );
+    // reach[ top .. n-1 ] holds the rows of x which may be nonzero in the
+    // order they must be eliminated; stamp marks the rows visited in column k
+    vector<int> reach( n ), stamp( n, -1 ), dfsStack( n ), dfsNext( n );
+    double umax = 0.0;
+    double umin = 0.0;
+    for( int k = 0; k < n; ++k ) {
+        mLColPtr[ k ] = mLRowIdx.size();
+        mUColPtr[ k ] = mURowIdx.size();
+        const int col = mColOrder[ k ];
+
+        // Depth first search from each nonzero of A(:,col) in the graph with
+        // an edge from each pivot row to the other rows of its column of L.
+        int top = n;
+        for( int p = mAColPtr[ col ]; p < mAColPtr[ col + 1 ]; ++p ) {
+            if( stamp[ mARowIdx[ p ] ] == k ) {
+                continue;
+            }
+            int head = 0;
+            dfsStack[ 0 ] = mARowIdx[ p ];
+            while( head >= 0 ) {
+                const int j = dfsStack[ head ];
+                const int jcol = mRowPos[ j ];
+                if( stamp[ j ] != k ) {
+                    stamp[ j ] = k;
+                    dfsNext[ head ] = jcol < 0 ? 0 : mLColPtr[ jcol ] + 1;
+                }
+                const int end = jcol < 0 ? 0 : mLColPtr[ jcol + 1 ];
+                bool done = true;
+                while( dfsNext[ head ] < end ) {
+                    const int i = mLRowIdx[ dfsNext[ head ]++ ];
+                    if( stamp[ i ] != k ) {
+                        dfsStack[ ++head ] = i;
+                        done = false;
+                        break;
+                    }
+                }
+                if( done ) {
+                    --head;
+                    reach[ --top ] = j;
+                }
+            }
+        }
+
+        // x = L \ A(:,col), L having unit diagonal
+        for( int p = mAColPtr[ col ]; p < mAColPtr[ col + 1 ]; ++p ) {
+            x[ mARowIdx[ p ] ] = mAValues[ p ];
+        }
+        for( int p = top; p < n; ++p ) {
+            const int j = reach[ p ];
+            const int jcol = mRowPos[ j ];
+            if( jcol < 0 ) {
+                continue;
+            }
+            const double xj = x[ j ];
+            for( int q = mLColPtr[ jcol ] + 1; q < mLColPtr[ jcol + 1 ]; ++q ) {
+                x[ mLRowIdx[ q ] ] -= mLValues[ q ] * xj;
+            }
+        }
+
+        // The entries in pivot rows belong to U, the largest of the others
+        // is the candidate pivot.
+        int ipiv = -1;
+        double amax = 0.0;
+        for( int p = top; p < n; ++p ) {
+            const int i = reach[ p ];
+            if( mRowPos[ i ] < 0 ) {
+                if( fabs( x[ i ] ) > amax ) {
+                    amax = fabs( x[ i ] );
+                    ipiv = i;
+                }
+            }
+            else {
+                mURowIdx.push_back( mRowPos[ i ] );
+                mUValues.push_back( x[ i ] );
+            }
+        }
+        if( ipiv == -1 || amax == 0.0 ) {
+            mRCond = 0.0;
+            return col + 1;
+        }
+        if( mRowPos[ col ] < 0 && fabs( x[ col ] ) >= SPARSE_PIVOT_TOLERANCE * amax ) {
+            ipiv = col;
+        }
+        const double pivot = x[ ipiv ];
+        mURowIdx.push_back( k );
+        mUValues.push_back( pivot );
+        mRowPos[ ipiv ] = k;
+        mLRowIdx.push_back( ipiv );
+        mLValues.push_back( 1.0 );
+        for( int p = top; p < n; ++p ) {
+            const int i = reach[ p ];
+            if( mRowPos[ i ] < 0 ) {
+                mLRowIdx.push_back( i );
+                mLValues.push_back( x[ i ] / pivot );
+            }
+            x[ i ] = 0.0;
+        }
+        umax = k == 0 ? fabs( pivot ) : max( umax, fabs( pivot ) );
+        umin = k == 0 ? fabs( pivot ) : min( umin, fabs( pivot ) );
+    }
+    mLColPtr[ n ] = mLRowIdx.size();
+    mUColPtr[ n ] = mURowIdx.size();
+    // L was built with the original row indices since the final position of
+    // a row is only known once it is chosen as a pivot
+    for( size_t p = 0; p < mLRowIdx.size(); ++p ) {
+        mLRowIdx[ p ] = mRowPos[ mLRowIdx[ p ] ];
+    }
+
+    mRCond = umin / umax;
+    mIsSparse = true;
+    vector<int>().swap( mAColPtr );
+    vector<int>().swap( mARowIdx );
+    vector<double>().swap( mAValues );
+    vector<double>().swap( mLU );
+    return 0;
+}
+
+/*!
+ * \brief Find a minimum degree ordering of the pattern of A+A^T.
+ * \details The elimination graph is kept explicitly, eliminating a vertex
+ *          joining all of its neighbors, with ties broken by the lower index
+ *          so the ordering is reproducible.  The ordering is abandoned once
+ *          the predicted fill shows the factors would be too dense to gain
+ *          from the sparse factorization.
+ * \param aOrder Will hold the vertices in elimination order.
+ * \return False if the ordering was abandoned.
+ */
+bool LinearSolver::orderMinimumDegree( vector<int>& aOrder ) const {
+    const int n = mN;
+    vector<vector<int> > adjacent( n );
+    for( int j = 0; j < n; ++j ) {
+        for( int p = mAColPtr[ j ]; p < mAColPtr[ j + 1 ]; ++p ) {
+            const int i = mARowIdx[ p ];
+            if( i != j ) {
+                adjacent[ i ].push_back( j );
+                adjacent[ j ].push_back( i );
+            }
+        }
+    }
+    set<pair<size_t, int> > byDegree;
+    for( int i = 0; i < n; ++i ) {
+        sort( adjacent[ i ].begin(), adjacent[ i ].end() );
+        adjacent[ i ].erase( unique( adjacent[ i ].begin(), adjacent[ i ].end() ), adjacent[ i ].end() );
+        byDegree.insert( make_pair( adjacent[ i ].size(), i ) );
+    }
+
+    const double maxFill = SPARSE_MAX_DENSITY * n * n / 2.0;
+    double fill = 0.0;
+    aOrder.clear();
+    vector<int> merged;
+    while( !byDegree.empty() ) {
+        const int v = byDegree.begin()->second;
+        byDegree.erase( byDegree.begin() );
+        aOrder.push_back( v );
+        const vector<int>& clique = adjacent[ v ];
+        fill += clique.size();
+        if( fill > maxFill ) {
+            return false;
+        }
+        for( size_t c = 0; c < clique.size(); ++c ) {
+            const int u = clique[ c ];
+            vector<int>& adjU = adjacent[ u ];
+            byDegree.erase( make_pair( adjU.size(), u ) );
+            merged.clear();
+            set_union( adjU.begin(), adjU.end(), clique.begin(), clique.end(), back_inserter( merged ) );
+            merged.erase( remove_if( merged.begin(), merged.end(), [u, v]( int w ) { return w == u || w == v; } ),
+                          merged.end() );
+            adjU.swap( merged );
+            byDegree.insert( make_pair( adjU.size(), u ) );
+        }
+        vector<int>().swap( adjacent[ v ] );
+    }
+    return true;
+}
+
+/*!
+ * \brief Solve with the sparse L and U factors.
+ * \param aB On input the right hand side b, on output the solution x.
+ */
+void LinearSolver::solveSparse( boost::numeric::ublas::vector<double>& aB ) const {
+    const int n = mN;
+    vector<double> x( n );
+    for( int i = 0; i < n; ++i ) {
+        x[ mRowPos[ i ] ] = aB[ i ];
+    }
+    for( int j = 0; j < n; ++j ) {
+        const double xj = x[ j ];
+        if( xj != 0.0 ) {
+            for( int p = mLColPtr[ j ] + 1; p < mLColPtr[ j + 1 ]; ++p ) {
+                x[ mLRowIdx[ p ] ] -= mLValues[ p ] * xj;
+            }
+        }
+    }
+    for( int j = n - 1; j >= 0; --j ) {
+        x[ j ] /= mUValues[ mUColPtr[ j + 1 ] - 1 ];
+        const double xj = x[ j ];
+        if( xj != 0.0 ) {
+            for( int p = mUColPtr[ j ]; p < mUColPtr[ j + 1 ] - 1; ++p ) {
+                x[ mURowIdx[ p ] ] -= mUValues[ p ] * xj;
+            }
+        }
+    }
+    for( int k = 0; k < n; ++k ) {
+        aB[ mColOrder[ k ] ] = x[ k ];
+    }
+}
+
+/*!
+ * \brief Solve A*x = b using the stored factorization.
+ * \details Any rank-one updates applied since the factorization are
+ *          accounted for, so A is the updated matrix.
+ * \param aB On input the right hand side b, on output the solution x.
+ * \return False if single precision refinement stalled and the double
+ *         precision factorization it fell back to is not well conditioned,
+ *         in which case aB is left unusable.
+ */
+bool LinearSolver::solve( boost::numeric::ublas::vector<double>& aB ) {
+    GCAM_TRACE_SCOPE( linear_solve, mN, mUpdateV.size() );
+    if( !solveLU( aB ) ) {
+        return false;
+    }
+    // (B + u*v^T)^-1 * b = B^-1*b - z * (v^T * B^-1*b) / (1 + v^T*z), with z = B^-1*u
+    for( size_t k = 0; k < mUpdateV.size(); ++k ) {
+        const double coef = boost::numeric::ublas::inner_prod( mUpdateV[ k ], aB ) / mUpdateDenom[ k ];
+        aB -= coef * mUpdateZ[ k ];
+    }
+    return true;
+}
+
+/*!
+ * \brief Apply the rank-one change A <- A + u*v^T to the factorization.
+ * \details The update is rejected, leaving the factorization unchanged,
+ *          if it would make the matrix (nearly) singular.  The caller
+ *          should then refactor the updated matrix from scratch.
+ * \param aU The column vector u.
+ * \param aV The row vector v.
+ * \return True if the update was applied.
+ */
+bool LinearSolver::rankOneUpdate( const boost::numeric::ublas::vector<double>& aU,
+                                  const boost::numeric::ublas::vector<double>& aV )
+{
+    using boost::numeric::ublas::inner_prod;
+    using boost::numeric::ublas::norm_2;
+
+    boost::numeric::ublas::vector<double> z( aU );
+    if( !solve( z ) ) {
+        return false;
+    }
+    const double denom = 1.0 + inner_prod( aV, z );
+    const double UPDATE_TOL = 1.0e-8;
+    if( !( fabs( denom ) > UPDATE_TOL * ( 1.0 + norm_2( aV ) * norm_2( z ) ) ) ) {
+        return false;
+    }
+    mUpdateZ.push_back( z );
+    mUpdateV.push_back( aV );
+    mUpdateDenom.push_back( denom );
+    return true;
+}
+
+//! Forget any rank-one updates.
+void LinearSolver::clearUpdates() {
+    mUpdateZ.clear();
+    mUpdateV.clear();
+    mUpdateDenom.clear();
+}
+
+/*!
+ * \brief Solve with the L and U factors only, ignoring any rank-one updates.
+ * \param aB On input the right hand side b, on output the solution x.
+ * \return False if the solve failed, see solve.
+ */
+bool LinearSolver::solveLU( boost::numeric::ublas::vector<double>& aB ) {
+    const int n = mN;
+    if( n == 0 ) {
+        return true;
+    }
+    if( mUseBlocks ) {
+        // Each block's rows only use the solution from earlier blocks, which
+        // have already overwritten their part of aB.
+        for( size_t k = 0; k < mBlocks.size(); ++k ) {
+            const vector<int>& idx = mBlockIndices[ k ];
+            boost::numeric::ublas::vector<double> rhs( idx.size() );
+            for( size_t r = 0; r < idx.size(); ++r ) {
+                rhs[ r ] = aB[ idx[ r ] ];
+            }
+            const vector<Coupling>& couplings = mCouplings[ k ];
+            for( size_t c = 0; c < couplings.size(); ++c ) {
+                rhs[ couplings[ c ].mRow ] -= couplings[ c ].mValue * aB[ couplings[ c ].mCol ];
+            }
+            if( !mBlocks[ k ].solve( rhs ) ) {
+                return false;
+            }
+            for( size_t r = 0; r < idx.size(); ++r ) {
+                aB[ idx[ r ] ] = rhs[ r ];
+            }
+        }
+        return true;
+    }
+    if( mIsSparse ) {
+        solveSparse( aB );
+        return true;
+    }
+    if( mIsSinglePrecision ) {
+        return solveRefined( aB );
+    }
+#if USE_LAPACK
+    vector<double> b( aB.begin(), aB.end() );
+    vector<int> ipiv( n );
+    for( int i = 0; i < n; ++i ) {
+        ipiv[ i ] = mPivots[ i ] + 1;
+    }
+    const char trans = 'N';
+    const int nrhs = 1;
+    int info = 0;
+    dgetrs_( &trans, &n, &nrhs, &mLU[ 0 ], &n, &ipiv[ 0 ], &b[ 0 ], &n, &info );
+    copy( b.begin(), b.end(), aB.begin() );
+#else
+    for( int i = 0; i < n; ++i ) {
+        if( mPivots[ i ] != i ) {
+            swap( aB[ i ], aB[ mPivots[ i ] ] );
+        }
+    }
+    // forward substitution with the unit lower triangle
+    for( int j = 0; j < n; ++j ) {
+        const double bj = aB[ j ];
+        if( bj != 0.0 ) {
+            const double* colj = &mLU[ j * n ];
+            for( int i = j + 1; i < n; ++i ) {
+                aB[ i ] -= colj[ i ] * bj;
+            }
+        }
+    }
+    // back substitution with the upper triangle
+    for( int j = n - 1; j >= 0; --j ) {
+        const double* colj = &mLU[ j * n ];
+        aB[ j ] /= colj[ j ];
+        const double bj = aB[ j ];
+        for( int i = 0; i < j; ++i ) {
+            aB[ i ] -= colj[ i ] * bj;
+        }
+    }
+#endif
+    return true;
+}
+
+/*!
+ * \brief Solve with the single precision factors, refining the solution.
+ * \details Each step computes the residual r = b - A*x in double precision
+ *          and corrects x by the single precision solution of A*d = r.  As
+ *          in LAPACK's dsgesv the solution is accepted once the residual is
+ *          as small as a double precision factorization would leave, i.e.
+ *          ||r|| <= ||x|| * ||A|| * eps * sqrt(n) in the infinity norm.  If
+ *          the residual stops shrinking first the matrix is factored in
+ *          double precision and solved with that instead, which is then
+ *          used for the rest of the life of the factorization.
+ * \param aB On input the right hand side b, on output the solution x.
+ * \return False if the fall back factorization is not well conditioned.
+ */
+bool LinearSolver::solveRefined( boost::numeric::ublas::vector<double>& aB ) {
+    const int n = mN;
+    const double tol = mNormInf * numeric_limits<double>::epsilon() * sqrt( static_cast<double>( n ) );
+    vector<double> x( n ), r( n );
+    vector<float> d( aB.begin(), aB.end() );
+    solveSingle( &mLUSingle[ 0 ], &mPivots[ 0 ], n, d );
+    copy( d.begin(), d.end(), x.begin() );
+    double lastRNorm = numeric_limits<double>::infinity();
+    for( int step = 0; step < MAX_REFINEMENT_STEPS; ++step ) {
+        copy( aB.begin(), aB.end(), r.begin() );
+        double xnorm = 0.0;
+        for( int j = 0; j < n; ++j ) {
+            const double xj = x[ j ];
+            xnorm = max( xnorm, fabs( xj ) );
+            if( xj != 0.0 ) {
+                const double* colj = &mA[ j * n ];
+                for( int i = 0; i < n; ++i ) {
+                    r[ i ] -= colj[ i ] * xj;
+                }
+            }
+        }
+        double rnorm = 0.0;
+        for( int i = 0; i < n; ++i ) {
+            rnorm = max( rnorm, fabs( r[ i ] ) );
+        }
+        if( rnorm <= xnorm * tol ) {
+            copy( x.begin(), x.end(), aB.begin() );
+            return true;
+        }
+        if( !( rnorm < 0.5 * lastRNorm ) ) {
+            break;
+        }
+        lastRNorm = rnorm;
+        // scale the residual so that it is representable in single precision
+        const double scale = 1.0 / rnorm;
+        for( int i = 0; i < n; ++i ) {
+            d[ i ] = static_cast<float>( r[ i ] * scale );
+        }
+        solveSingle( &mLUSingle[ 0 ], &mPivots[ 0 ], n, d );
+        for( int i = 0; i < n; ++i ) {
+            x[ i ] += rnorm * d[ i ];
+        }
+    }
+
+    // Refinement stalled, the single precision factors are too inaccurate
+    // for this matrix.
+    mIsSinglePrecision = false;
+    mLUSingle.clear();
+    mLU.swap( mA );
+    mA.clear();
+    if( factorizeDouble() != 0 || !isWellConditioned() ) {
+        return false;
+    }
+    return solveLU( aB );
+}
@@ -98,3 +98,7 @@ bool MarketNameSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aSolu
     
     return mAcceptMarketName == aSolutionInfo.getName();
 }
+
+bool MarketNameSolutionInfoFilter::isInvariantInPeriod() const {
+    return true;
+}
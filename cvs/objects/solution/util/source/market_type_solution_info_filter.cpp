@@ -132,3 +132,7 @@ IMarketType::Type MarketTypeSolutionInfoFilter::getMarketTypeFromString( const s
         << getXMLNameStatic() << "." << endl;
     return IMarketType::END;
 }
+
+bool MarketTypeSolutionInfoFilter::isInvariantInPeriod() const {
+    return true;
+}
@@ -111,3 +111,7 @@ bool NotSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aSolutionInf
     // return the opposite of the wrapped filter
     return !mWrappedFilter->acceptSolutionInfo( aSolutionInfo );
 }
+
+bool NotSolutionInfoFilter::isInvariantInPeriod() const {
+    return mWrappedFilter && mWrappedFilter->isInvariantInPeriod();
+}
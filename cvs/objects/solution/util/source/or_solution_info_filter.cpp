@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -53,7 +54,9 @@ using namespace xercesc;
 
 typedef vector<ISolutionInfoFilter*>::const_iterator CSolutionInfoFilterIterator;
 
-OrSolutionInfoFilter::OrSolutionInfoFilter() {
+OrSolutionInfoFilter::OrSolutionInfoFilter():
+mNumInvariant( 0 )
+{
 }
 
 OrSolutionInfoFilter::~OrSolutionInfoFilter() {
@@ -98,6 +101,13 @@ bool OrSolutionInfoFilter::XMLParse( const DOMNode* aNode ) {
                 << getXMLNameStatic() << "." << endl;
         }
     }
+    
+    // Move the filters which can not change during a period to the front so that
+    // their combined result can be cached.
+    vector<ISolutionInfoFilter*>::iterator firstVariant =
+        stable_partition( mFilters.begin(), mFilters.end(),
+                          []( const ISolutionInfoFilter* aFilter ) { return aFilter->isInvariantInPeriod(); } );
+    mNumInvariant = firstVariant - mFilters.begin();
     return true;
 }
 
@@ -107,9 +117,32 @@ bool OrSolutionInfoFilter::acceptSolutionInfo( const SolutionInfo& aSolutionInfo
         return true;
     }
     
-    for( CSolutionInfoFilterIterator currFilter = mFilters.begin(); currFilter != mFilters.end(); ++currFilter ) {
+    if( mNumInvariant > 0 &&
+        mInvariantCache.accept( aSolutionInfo, [this, &aSolutionInfo]() {
+            return acceptRange( aSolutionInfo, 0, mNumInvariant ); } ) )
+    {
+        return true;
+    }
+    return acceptRange( aSolutionInfo, mNumInvariant, mFilters.size() );
+}
+
+bool OrSolutionInfoFilter::isInvariantInPeriod() const {
+    return mNumInvariant == mFilters.size();
+}
+
+/*!
+ * \brief Or together the filters in the range [aBegin, aEnd) of mFilters.
+ * \param aSolutionInfo The SolutionInfo to test.
+ * \param aBegin The index of the first filter to use.
+ * \param aEnd One past the index of the last filter to use.
+ * \return True if any filter in the range accepts aSolutionInfo.
+ */
+bool OrSolutionInfoFilter::acceptRange( const SolutionInfo& aSolutionInfo, const size_t aBegin,
+                                        const size_t aEnd ) const
+{
+    for( size_t i = aBegin; i < aEnd; ++i ) {
         // if any filter returns true the or is true
-        if( (*currFilter)->acceptSolutionInfo( aSolutionInfo ) ) {
+        if( mFilters[ i ]->acceptSolutionInfo( aSolutionInfo ) ) {
             return true;
         }
     }
@@ -0,0 +1,382 @@
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file sensitivity_analyzer.cpp
+ * \ingroup Solution
+ * \brief SensitivityAnalyzer class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+
+#include "solution/util/include/sensitivity_analyzer.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/fdjac.hpp"
+#include "solution/util/include/linear_solver.hpp"
+#include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "marketplace/include/marketplace.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/configuration.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/util.h"
+#include "util/base/include/value.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+extern Scenario* scenario;
+
+namespace {
+    //! The default solution tolerance, as in UserConfigurableSolver.
+    const double DEFAULT_SOLUTION_TOLERANCE = 0.001;
+    
+    //! The default solution floor, as in UserConfigurableSolver.
+    const double DEFAULT_SOLUTION_FLOOR = 0.0001;
+    
+    /*!
+     * \brief The Data matched by the search path of a parameter, which are
+     *        scaled together.
+     */
+    class ScaledParameter {
+    public:
+        ScaledParameter( const string& aPath ):mValueQuery( aPath ), mDoubleQuery( aPath ) {
+            for( Value* value : mValueQuery.find( scenario ) ) {
+                mValues.push_back( make_pair( value, static_cast<double>( *value ) ) );
+            }
+            for( double* value : mDoubleQuery.find( scenario ) ) {
+                mDoubles.push_back( make_pair( value, *value ) );
+            }
+        }
+        
+        //! Put back the original values.
+        ~ScaledParameter() {
+            scale( 1 );
+        }
+        
+        //! Whether the path matched any Data.
+        bool isFound() const {
+            return !mValues.empty() || !mDoubles.empty();
+        }
+        
+        //! Set each matched Data to its original value times aFactor.
+        void scale( const double aFactor ) {
+            for( const auto& value : mValues ) {
+                *value.first = value.second * aFactor;
+            }
+            for( const auto& value : mDoubles ) {
+                *value.first = value.second * aFactor;
+            }
+        }
+        
+    private:
+        GCAMFusionQuery<Value> mValueQuery;
+        GCAMFusionQuery<double> mDoubleQuery;
+        
+        //! The matched Data and their original values.
+        vector<pair<Value*, double> > mValues;
+        vector<pair<double*, double> > mDoubles;
+    };
+    
+    //! The Data matched by the search path of an output.
+    class OutputQuery {
+    public:
+        OutputQuery( const string& aPath ):mValues( aPath ), mDoubles( aPath ), mVectors( aPath ) {
+        }
+        
+        /*!
+         * \brief The sum of the matched Data in the current state.
+         * \param aPeriod The period to use from matches of a whole period vector.
+         * \return The value of the output.
+         */
+        double evaluate( const int aPeriod ) {
+            double sum = 0;
+            for( Value* value : mValues.find( scenario ) ) {
+                sum += *value;
+            }
+            for( double* value : mDoubles.find( scenario ) ) {
+                sum += *value;
+            }
+            for( objects::PeriodVector<Value>* values : mVectors.find( scenario ) ) {
+                sum += (*values)[ aPeriod ];
+            }
+            return sum;
+        }
+        
+    private:
+        GCAMFusionQuery<Value> mValues;
+        GCAMFusionQuery<double> mDoubles;
+        GCAMFusionQuery<objects::PeriodVector<Value> > mVectors;
+    };
+}
+
+SensitivityAnalyzer::SensitivityAnalyzer( World* aWorld, Marketplace* aMarketplace ):
+mWorld( aWorld ),
+mMarketplace( aMarketplace ),
+mStep( 0.01 ),
+mHasWritten( false )
+{
+}
+
+SensitivityAnalyzer::~SensitivityAnalyzer() {
+}
+
+bool SensitivityAnalyzer::XMLParse( const DOMNode* aNode ) {
+    // assume we were passed a valid node.
+    assert( aNode );
+    
+    // get the children of the node.
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    
+    // loop through the children
+    bool success = true;
+    for ( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        DOMNode* curr = nodeList->item( i );
+        string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+        
+        if( nodeName == "#text" || nodeName == "#comment" ) {
+            continue;
+        }
+        else if( nodeName == "step" ) {
+            const double step = XMLHelper<double>::getValue( curr );
+            if( step > 0 && step < 1 ) {
+                mStep = step;
+            }
+            else {
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::WARNING );
+                mainLog << "Ignoring sensitivity step " << step << " which is not between 0 and 1." << endl;
+            }
+        }
+        else if( nodeName == "year" ) {
+            mYears.push_back( XMLHelper<int>::getValue( curr ) );
+        }
+        else if( nodeName == "parameter" || nodeName == "output" ) {
+            Tagged tagged;
+            tagged.mPath = XMLHelper<string>::getAttr( curr, "path" );
+            tagged.mName = XMLHelper<string>::getAttr( curr, XMLHelper<void>::name() );
+            if( tagged.mName.empty() ) {
+                tagged.mName = tagged.mPath;
+            }
+            ( nodeName == "parameter" ? mParameters : mOutputs ).push_back( tagged );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing sensitivity-analysis." << endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+/*!
+ * \brief Convert the years to analyze into model periods.
+ * \param aModeltime The model time.
+ */
+void SensitivityAnalyzer::init( const Modeltime* aModeltime ) {
+    mPeriods.clear();
+    for( int year : mYears ) {
+        if( aModeltime->isModelYear( year ) ) {
+            mPeriods.push_back( aModeltime->getyr_to_per( year ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Sensitivity year " << year << " is not a model year." << endl;
+        }
+    }
+}
+
+/*!
+ * \brief Whether the sensitivities should be calculated in a period.
+ * \param aPeriod The model period which has solved.
+ * \return True if there are parameters and the period was asked for.
+ */
+bool SensitivityAnalyzer::shouldAnalyze( const int aPeriod ) const {
+    return !mParameters.empty() &&
+        ( mYears.empty() || find( mPeriods.begin(), mPeriods.end(), aPeriod ) != mPeriods.end() );
+}
+
+/*!
+ * \brief Calculate and write the sensitivities to each parameter in a solved
+ *        period.
+ * \details The model is left in the state it was solved in.
+ * \param aPeriod The model period which has solved.
+ * \param aSolutionInfoParamParser The solution parameters used to set up the
+ *                                 solvable markets.
+ */
+void SensitivityAnalyzer::run( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Calculating the sensitivities to " << mParameters.size() << " parameters in period "
+            << aPeriod << endl;
+    
+    SolutionInfoSet solutionSet( mMarketplace );
+    solutionSet.init( aPeriod, DEFAULT_SOLUTION_TOLERANCE, DEFAULT_SOLUTION_FLOOR, aSolutionInfoParamParser );
+    const size_t numSolvable = solutionSet.getNumSolvable();
+    const vector<SolutionInfo>& solvable = solutionSet.getSolvableSet();
+    
+    // Evaluate at the solution so that the outputs are up to date.
+    LogEDFun edFun( solutionSet, mWorld, mMarketplace, aPeriod, true );
+    boost::numeric::ublas::vector<double> x( numSolvable ), fx( numSolvable );
+    vector<double> prices( numSolvable );
+    for( size_t i = 0; i < numSolvable; ++i ) {
+        prices[ i ] = solvable[ i ].getPrice();
+        x[ i ] = log( max( prices[ i ], util::getTinyNumber() ) );
+    }
+    edFun.scaleInitInputs( x );
+    edFun( x, fx );
+    
+    vector<unique_ptr<OutputQuery> > outputs;
+    vector<double> outputValues;
+    for( const Tagged& output : mOutputs ) {
+        outputs.push_back( unique_ptr<OutputQuery>( new OutputQuery( output.mPath ) ) );
+        outputValues.push_back( outputs.back()->evaluate( aPeriod ) );
+    }
+    
+    // The Jacobian is the same for every parameter so factor it once.
+    LinearSolver luSolver;
+    bool canSolve = true;
+    if( numSolvable > 0 ) {
+        boost::numeric::ublas::matrix<double> jacobian( numSolvable, numSolvable );
+        fdjac( edFun, x, fx, jacobian, true );
+        canSolve = luSolver.factorize( jacobian ) == 0;
+        if( !canSolve || !luSolver.isWellConditioned() ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "The Jacobian in period " << aPeriod << " is "
+                    << ( canSolve ? "ill-conditioned (rcond = " + util::toString( luSolver.getRCond() ) + ")"
+                                  : "singular" )
+                    << ", the price sensitivities are unreliable." << endl;
+        }
+    }
+    
+    boost::numeric::ublas::vector<double> fPlus( numSolvable ), fMinus( numSolvable );
+    for( const Tagged& parameter : mParameters ) {
+        ScaledParameter scaled( parameter.mPath );
+        if( !scaled.isFound() ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "No parameters found for " << parameter.mPath << " in the sensitivity analysis." << endl;
+            continue;
+        }
+        
+        // dx/ds solves J * dx/ds = -dF/ds, by a central difference in s at the
+        // solved prices.
+        scaled.scale( 1 + mStep );
+        edFun( x, fPlus );
+        scaled.scale( 1 - mStep );
+        edFun( x, fMinus );
+        boost::numeric::ublas::vector<double> dx = ( fMinus - fPlus ) / ( 2 * mStep );
+        if( numSolvable > 0 && ( !canSolve || !luSolver.solve( dx ) ) ) {
+            dx.clear();
+        }
+        
+        vector<Sensitivity> sensitivities;
+        for( size_t i = 0; i < numSolvable; ++i ) {
+            // The inputs are log prices which are not scaled.
+            const Sensitivity sensitivity = { true, solvable[ i ].getName(), prices[ i ], prices[ i ] * dx[ i ] };
+            sensitivities.push_back( sensitivity );
+        }
+        
+        // The total derivative of the outputs is along the tangent to the
+        // solution.
+        if( !outputs.empty() ) {
+            vector<double> outputPlus( outputs.size() );
+            scaled.scale( 1 + mStep );
+            edFun( x + mStep * dx, fPlus );
+            for( size_t i = 0; i < outputs.size(); ++i ) {
+                outputPlus[ i ] = outputs[ i ]->evaluate( aPeriod );
+            }
+            scaled.scale( 1 - mStep );
+            edFun( x - mStep * dx, fMinus );
+            for( size_t i = 0; i < outputs.size(); ++i ) {
+                const Sensitivity sensitivity = { false, mOutputs[ i ].mName, outputValues[ i ],
+                    ( outputPlus[ i ] - outputs[ i ]->evaluate( aPeriod ) ) / ( 2 * mStep ) };
+                sensitivities.push_back( sensitivity );
+            }
+        }
+        scaled.scale( 1 );
+        writeResults( aPeriod, parameter.mName, sensitivities );
+    }
+    
+    // Leave the model as it was solved.
+    edFun( x, fx );
+}
+
+/*!
+ * \brief Write the sensitivities to a parameter as CSV to the file
+ *        sensitivity-output.
+ * \details The file is started over with the first parameter written by this
+ *          run and appended to after that.
+ * \param aPeriod The model period.
+ * \param aParameter The name of the parameter.
+ * \param aSensitivities The sensitivities to the parameter.
+ */
+void SensitivityAnalyzer::writeResults( const int aPeriod, const string& aParameter,
+                                        const vector<Sensitivity>& aSensitivities )
+{
+    const string fileName = Configuration::getInstance()->getFile( "sensitivity-output", "sensitivity.csv", false );
+    ofstream results( fileName.c_str(), mHasWritten ? ios::app : ios::trunc );
+    if( !results.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open sensitivity output file: " << fileName << endl;
+        return;
+    }
+    
+    if( !mHasWritten ) {
+        results << "year,parameter,type,name,value,derivative,elasticity" << endl;
+        mHasWritten = true;
+    }
+    const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
+    results.precision( 9 );
+    for( const Sensitivity& sensitivity : aSensitivities ) {
+        results << year << ',' << aParameter << ',' << ( sensitivity.mIsMarket ? "market" : "output" ) << ','
+                << sensitivity.mName << ',' << sensitivity.mValue << ',' << sensitivity.mDerivative << ','
+                << ( sensitivity.mValue != 0 ? sensitivity.mDerivative / sensitivity.mValue : 0 ) << endl;
+    }
+}
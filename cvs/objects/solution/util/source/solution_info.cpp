@@ -60,6 +60,8 @@ SolutionInfo::SolutionInfo( Market* aLinkedMarket, const vector<IActivity*>& aDe
 :
 bracketed( false ),
 mBisected( false ),
+mFrozen( false ),
+mConvergedCount( 0 ),
 linkedMarket( aLinkedMarket ),
 XL( 0 ),
 XR( 0 ),
@@ -278,6 +280,16 @@ bool SolutionInfo::isWithinTolerance() const {
     return ( getRelativeED() < mSolutionTolerance );
 }
 
+//! Get the market specific relative excess demand below which the market is solved.
+double SolutionInfo::getSolutionTolerance() const {
+    return mSolutionTolerance;
+}
+
+//! Get the market specific absolute excess demand below which the market is solved.
+double SolutionInfo::getSolutionFloor() const {
+    return mSolutionFloor;
+}
+
 //! Determine whether a SolutionInfo is solvable for the current method.
 bool SolutionInfo::shouldSolve( const bool isNR ) const {
     return isNR ? linkedMarket->shouldSolveNR() : linkedMarket->shouldSolve();
@@ -526,6 +538,40 @@ void SolutionInfo::unsetBisectedFlag(){
 bool SolutionInfo::hasBisected() const {
     return mBisected;
 }
+
+//! Return whether this market is currently frozen out of the solvable set.
+bool SolutionInfo::isFrozen() const {
+    return mFrozen;
+}
+
+/*!
+ * \brief Set whether this market is frozen out of the solvable set.
+ * \details Changing the frozen state also resets the count of consecutive
+ *          updates the market has been well within tolerance.
+ * \param aIsFrozen The new frozen state.
+ */
+void SolutionInfo::setFrozen( const bool aIsFrozen ) {
+    mFrozen = aIsFrozen;
+    mConvergedCount = 0;
+}
+
+/*!
+ * \brief Update the count of consecutive checks for which this market has
+ *        been well within its solution tolerance.
+ * \param aFraction The fraction of the solution tolerance the relative excess
+ *        demand must be below to count as well within tolerance.
+ * \return The updated count, which is zero if the market is not well within
+ *         tolerance.
+ */
+unsigned int SolutionInfo::updateConvergedCount( const double aFraction ) {
+    if( getRelativeED() < aFraction * mSolutionTolerance ) {
+        ++mConvergedCount;
+    }
+    else {
+        mConvergedCount = 0;
+    }
+    return mConvergedCount;
+}
 //! Print out information from the SolutionInfo to an output stream.
 void SolutionInfo::print( ostream& aOut ) const {
 
@@ -644,6 +690,15 @@ void SolutionInfo::setCorrectionSlope(const double aSlope) {
     linkedMarket->getMarketInfo()->setDouble( SLOPE_KEY, aSlope );
 }
 
+/*!
+ * \brief Determine if the model would see no change in price when the solver
+ *        moves the price of this market from aPrice to aNewPrice.
+ * \see Market::isPriceChangeHidden
+ */
+bool SolutionInfo::isPriceChangeHidden( const double aPrice, const double aNewPrice ) const {
+    return linkedMarket->isPriceChangeHidden( aPrice, aNewPrice );
+}
+
 int SolutionInfo::getSerialNumber( void ) const
 {
     return linkedMarket->getSerialNumber();
@@ -40,9 +40,11 @@
 #include "util/base/include/definitions.h"
 #include <cassert>
 #include <algorithm>
+#include <stdexcept>
 #include "util/base/include/util.h"
 #include "solution/util/include/solution_info_set.h"
 #include "solution/util/include/solution_info.h"
+#include "solution/util/include/solver_library.h"
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/supply_demand_curve.h"
 #include "util/base/include/configuration.h"
@@ -57,14 +59,20 @@ using namespace std;
 //! Constructor
 SolutionInfoSet::SolutionInfoSet( Marketplace* aMarketplace ):
 period( 0 ),
-marketplace( aMarketplace )
+marketplace( aMarketplace ),
+mFreezeIterations( 0 ),
+mFreezeFraction( 0.1 ),
+mRestriction( 0 )
 {
     /*!\pre Marketplace is not null. */
     assert( aMarketplace );
 }
 
 //! Constructor for new solution set
-SolutionInfoSet::SolutionInfoSet( const vector<SolutionInfo> aSolutionSet ): solvable( aSolutionSet )
+SolutionInfoSet::SolutionInfoSet( const vector<SolutionInfo> aSolutionSet ): solvable( aSolutionSet ),
+mFreezeIterations( 0 ),
+mFreezeFraction( 0.1 ),
+mRestriction( 0 )
 {
 }
 
@@ -83,6 +91,7 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
 {
     assert( aPeriod >= 0 );
     this->period = aPeriod;
+    mRestriction = marketplace->getSolveRestriction();
 
     // Print a debugging log message.
     ILogger& solverLog = ILogger::getLogger( "solver_log" );
@@ -92,6 +101,11 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
     // Request the markets to solve from the marketplace. 
     vector<Market*> marketsToSolve = marketplace->getMarketsToSolve( period );
 
+    // Reserve room for every market in both sets so that moving markets
+    // between them in updateSolvable never reallocates.
+    solvable.reserve( marketsToSolve.size() );
+    unsolvable.reserve( marketsToSolve.size() );
+
     // Create and initialize a SolutionInfo object for each market.
     typedef vector<Market*>::const_iterator ConstMarketIterator;
     MarketDependencyFinder* depFinder = marketplace->getDependencyFinder();
@@ -100,28 +114,35 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
         const int marketNumber = iter - marketsToSolve.begin();
         const vector<IActivity*> partialList = isSolvable ? depFinder->getOrdering( marketNumber ) : vector<IActivity*>();
 #if GCAM_PARALLEL_ENABLED
-        // TODO: As it turns out the extra time generating these graphs does not typically
-        // get paid back in terms of time saved while calculating partial derivatives.  At
-        // least in a single scenario run.  We need to come up with some methodology to figure
-        // out when it is beneficial to do this or not until then we are not generating any.
+        // The extra time generating these graphs does not typically get paid back in
+        // terms of time saved while calculating partial derivatives, at least in a single
+        // scenario run, so they are only used if they were created along with the global
+        // graph which may read them from the grain cache of a previous run.
         SolutionInfo currInfo( *iter, partialList, 
-               /*isSolvable ? depFinder->getFlowGraph( marketNumber ) :*/ 0 );
+               isSolvable && depFinder->hasPartialFlowGraphs() ? depFinder->getFlowGraph( marketNumber ) : 0 );
 #else
         SolutionInfo currInfo( *iter, partialList );
 #endif
         currInfo.init( aDefaultSolutionTolerance, aDefaultSolutionFloor,
                        aSolutionInfoParamParser->getSolutionInfoValuesForMarket( (*iter)->getGoodName(), (*iter)->getRegionName(),
                                                                                  currInfo.getTypeName(), period ) );
-        if( currInfo.shouldSolve( false ) ){
-            solvable.push_back( currInfo );
+        if( currInfo.shouldSolve( false ) && ( !mRestriction || mRestriction->acceptSolutionInfo( currInfo ) ) ){
+            solvable.push_back( std::move( currInfo ) );
         }
         else {
-            unsolvable.push_back( currInfo );
+            unsolvable.push_back( std::move( currInfo ) );
         }
     }
 }
 
-//! Update which markets are currently being solved.
+/*!
+ * \brief Update which markets are currently being solved.
+ * \details Markets are moved between the solvable and unsolvable sets in a
+ *          single pass over each set which keeps the order of the markets and
+ *          moves, rather than copies, each SolutionInfo.
+ * \param aSolutionInfoFilter The filter for the solver doing the update.
+ * \return Whether markets were added, removed, both or neither.
+ */
 SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfoFilter* aSolutionInfoFilter ) {
     /*! \pre The updateFromMarkets has been called. */
     // Code which indicates whether markets were added, removed, both or neither. 
@@ -132,37 +153,36 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
     solverLog << "Updating the solvable set." << endl;
 
     // Iterate through the solvable markets and determine if any are now unsolvable.
-    for( SetIterator iter = solvable.begin(); iter != solvable.end(); ){
+    size_t numKept = 0;
+    for( size_t i = 0; i < solvable.size(); ++i ){
         // If it should not be solved for the current method, move it to the unsolvable vector.
-        if( !aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            unsolvable.push_back( *iter );
-
+        if( !isAccepted( aSolutionInfoFilter, solvable[ i ] ) ){
             // Print a debugging log message.
-            solverLog << iter->getName() << " was removed from the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = solvable.erase( iter );
+            solverLog << solvable[ i ].getName() << " was removed from the solvable set." << endl;
+            unsolvable.push_back( std::move( solvable[ i ] ) );
 
             // Update the return code.
             code = REMOVED;
         }
-        else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+        else {
+            if( numKept != i ){
+                solvable[ numKept ] = std::move( solvable[ i ] );
+            }
+            ++numKept;
         }
     }
+    solvable.erase( solvable.begin() + numKept, solvable.end() );
 
     // Loop through the unsolvable set to see if they should be added to the solved. 
     // This will double check markets that were just added, slightly inefficient.
-    for( SetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ){
+    numKept = 0;
+    for( size_t i = 0; i < unsolvable.size(); ++i ){
         // If it should be solved for the current method, move it to the solvable vector.
-        if( aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            solvable.push_back( *iter );
+        // Frozen markets are left out until updateFrozen reactivates them.
+        if( !unsolvable[ i ].isFrozen() && isAccepted( aSolutionInfoFilter, unsolvable[ i ] ) ){
             // Print a debugging log message.
-            solverLog << iter->getName() << " was added to the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = unsolvable.erase( iter );
+            solverLog << unsolvable[ i ].getName() << " was added to the solvable set." << endl;
+            solvable.push_back( std::move( unsolvable[ i ] ) );
 
             // Update return code.
             if( code == UNCHANGED || ADDED ){
@@ -172,14 +192,125 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
                 code = ADDED_AND_REMOVED;
             }
         }
-        else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+        else {
+            if( numKept != i ){
+                unsolvable[ numKept ] = std::move( unsolvable[ i ] );
+            }
+            ++numKept;
+        }
+    }
+    unsolvable.erase( unsolvable.begin() + numKept, unsolvable.end() );
+
+    if( mFreezeIterations > 0 ) {
+        UpdateCode frozenCode = updateFrozen( aSolutionInfoFilter );
+        if( frozenCode != UNCHANGED ) {
+            code = code == UNCHANGED || code == frozenCode ? frozenCode : ADDED_AND_REMOVED;
+        }
+    }
+    return code;
+}
+
+/*!
+ * \brief Freeze markets which have converged and reactivate frozen markets
+ *        which have drifted out of tolerance.
+ * \details A solvable market whose relative excess demand has been below
+ *          mFreezeFraction of its tolerance for mFreezeIterations consecutive
+ *          updates is moved to the unsolvable set and flagged as frozen so
+ *          that the solvers no longer spend Jacobian columns or linear solves
+ *          on it.  The model still calculates its supply and demand, so a
+ *          frozen market which is no longer solved is moved back into the
+ *          solvable set, provided the filter still accepts it.  Note that
+ *          isAllSolved checks the unsolvable set too so a frozen market can
+ *          not be left unsolved.
+ * \param aSolutionInfoFilter The filter for the solver doing the update.
+ * \return Whether markets were added, removed, both or neither.
+ */
+SolutionInfoSet::UpdateCode SolutionInfoSet::updateFrozen( const ISolutionInfoFilter* aSolutionInfoFilter ) {
+    UpdateCode code( UNCHANGED );
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::DEBUG );
+
+    size_t numKept = 0;
+    for( size_t i = 0; i < unsolvable.size(); ++i ){
+        SolutionInfo& curr = unsolvable[ i ];
+        if( curr.isFrozen() && !curr.isSolved() ) {
+            curr.setFrozen( false );
+            if( isAccepted( aSolutionInfoFilter, curr ) ) {
+                solverLog << curr.getName() << " was reactivated into the solvable set." << endl;
+                solvable.push_back( std::move( curr ) );
+                code = ADDED;
+                continue;
+            }
+        }
+        if( numKept != i ) {
+            unsolvable[ numKept ] = std::move( curr );
+        }
+        ++numKept;
+    }
+    unsolvable.erase( unsolvable.begin() + numKept, unsolvable.end() );
+
+    // Markets which were just reactivated have had their count reset and so
+    // will not be frozen again immediately.
+    numKept = 0;
+    for( size_t i = 0; i < solvable.size(); ++i ){
+        SolutionInfo& curr = solvable[ i ];
+        if( curr.updateConvergedCount( mFreezeFraction ) >= mFreezeIterations ) {
+            solverLog << curr.getName() << " was frozen out of the solvable set." << endl;
+            curr.setFrozen( true );
+            unsolvable.push_back( std::move( curr ) );
+            code = code == UNCHANGED ? REMOVED : ADDED_AND_REMOVED;
+        }
+        else {
+            if( numKept != i ) {
+                solvable[ numKept ] = std::move( curr );
+            }
+            ++numKept;
         }
     }
+    solvable.erase( solvable.begin() + numKept, solvable.end() );
     return code;
 }
 
+/*!
+ * \brief Check whether a market may be solved by a solver.
+ * \details A market must be accepted by both the solver's filter and the
+ *          marketplace's restriction, if there was one when the set was
+ *          initialized.
+ * \param aSolutionInfoFilter The filter for the solver doing the update.
+ * \param aSolutionInfo The market to check.
+ * \return Whether the market may be solved.
+ */
+bool SolutionInfoSet::isAccepted( const ISolutionInfoFilter* aSolutionInfoFilter, const SolutionInfo& aSolutionInfo ) const {
+    return aSolutionInfoFilter->acceptSolutionInfo( aSolutionInfo ) &&
+        ( !mRestriction || mRestriction->acceptSolutionInfo( aSolutionInfo ) );
+}
+
+/*!
+ * \brief Enable freezing of converged markets.
+ * \details When enabled each call to updateSolvable will freeze markets that
+ *          have stayed well within tolerance and reactivate any frozen market
+ *          which has drifted out of tolerance.
+ * \param aFreezeIterations The number of consecutive updates a market must be
+ *        well within tolerance before it is frozen, or 0 to disable freezing.
+ * \param aFreezeFraction The fraction of the solution tolerance a market's
+ *        relative excess demand must be below to be well within tolerance.
+ */
+void SolutionInfoSet::setConvergenceFreezing( const unsigned int aFreezeIterations, const double aFreezeFraction ) {
+    mFreezeIterations = aFreezeIterations;
+    mFreezeFraction = aFreezeFraction;
+}
+
+//! Get the number of markets currently frozen out of the solvable set.
+unsigned int SolutionInfoSet::getNumFrozen() const {
+    unsigned int numFrozen = 0;
+    for( ConstSetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ++iter ){
+        if( iter->isFrozen() ) {
+            ++numFrozen;
+        }
+    }
+    return numFrozen;
+}
+
 //! Update the elasticities for all the markets.
 void SolutionInfoSet::updateElasticities() {
     for( SetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ){
@@ -212,27 +343,52 @@ void SolutionInfoSet::resetBrackets(){
     }
 }
 
+/*!
+ * \brief Calculate the excess demand and relative excess demand of every
+ *        market in a set in one pass.
+ * \details The supplies and demands are read from the markets once and stored
+ *          contiguously in the scratch vectors along with the solution floor
+ *          and tolerance of each market.  The relative excess demands are then
+ *          computed for all markets at once by SolverLibrary::getRelativeEDs.
+ *          The results are left in the scratch vectors, indexed in the same
+ *          order as aSet.  Callers which look at several markets' excess
+ *          demands should use this rather than asking each SolutionInfo, which
+ *          reads the market demand twice for every relative excess demand.
+ * \param aSet The set of markets to evaluate.
+ */
+void SolutionInfoSet::calcRelativeEDs( const vector<SolutionInfo>& aSet ) const {
+    const size_t size = aSet.size();
+    mExcessDemands.resize( size );
+    mDemands.resize( size );
+    mSolutionFloors.resize( size );
+    mSolutionTolerances.resize( size );
+    for( size_t i = 0; i < size; ++i ) {
+        const double demand = aSet[ i ].getDemand();
+        mDemands[ i ] = demand;
+        mExcessDemands[ i ] = demand - aSet[ i ].getSupply();
+        mSolutionFloors[ i ] = aSet[ i ].getSolutionFloor();
+        mSolutionTolerances[ i ] = aSet[ i ].getSolutionTolerance();
+    }
+    SolverLibrary::getRelativeEDs( mExcessDemands, mDemands, mSolutionFloors, mRelativeEDs );
+}
+
 //! Find the maximum relative excess demand.
 double SolutionInfoSet::getMaxRelativeExcessDemand() const {
+    calcRelativeEDs( solvable );
     double largest = -1;
-    for ( ConstSetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ) {
-        const double relativeED = iter->getRelativeED();
-
-        if ( relativeED > largest ) {
-            largest = relativeED;
-        }
+    for( size_t i = 0; i < mRelativeEDs.size(); ++i ) {
+        largest = mRelativeEDs[ i ] > largest ? mRelativeEDs[ i ] : largest;
     }
     return largest;
 }
 
 //! Find the maximum absolute excess demand.
 double SolutionInfoSet::getMaxAbsoluteExcessDemand() const {
+    calcRelativeEDs( solvable );
     double largest = -1;
-    for ( ConstSetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ) {
-        const double absoluteExcessDemand = fabs( iter->getED() );
-        if( absoluteExcessDemand > largest ){
-            largest = absoluteExcessDemand;
-        }
+    for( size_t i = 0; i < mExcessDemands.size(); ++i ) {
+        const double absoluteExcessDemand = fabs( mExcessDemands[ i ] );
+        largest = absoluteExcessDemand > largest ? absoluteExcessDemand : largest;
     }
     return largest;
 }
@@ -244,22 +400,20 @@ double SolutionInfoSet::getMaxAbsoluteExcessDemand() const {
 * \return The SolutionInfo with the largest relative excess demand. 
 */
 SolutionInfo* SolutionInfoSet::getWorstSolutionInfo( bool aIgnoreBisected )  {
+    calcRelativeEDs( solvable );
 
-    SetIterator worstMarket = solvable.begin();
+    size_t worstMarket = 0;
     double largest = -1;
-
-    for ( SetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ) {
-        if( aIgnoreBisected && iter->hasBisected() ){
+    for( size_t i = 0; i < solvable.size(); ++i ) {
+        if( aIgnoreBisected && solvable[ i ].hasBisected() ){
             continue;
         }
-        double relativeED = iter->getRelativeED();
-        
-        if ( relativeED > largest ) {
-            worstMarket = iter;
-            largest = relativeED;
+        if( mRelativeEDs[ i ] > largest ) {
+            worstMarket = i;
+            largest = mRelativeEDs[ i ];
         }
     }
-    return &*worstMarket;
+    return &*( solvable.begin() + worstMarket );
 }
 
 const SolutionInfo* SolutionInfoSet::getWorstSolutionInfo( bool aIgnoreBisected ) const {
@@ -310,17 +464,7 @@ SolutionInfo* SolutionInfoSet::getPolicyOrWorstSolutionInfo() {
         }
     }
 
-    double largest = -1;
-    SetIterator worstMarket = solvable.begin();
-    for ( SetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ) {
-        const double relativeED = iter->getRelativeED();
-
-        if ( relativeED > largest ) {
-            worstMarket = iter;
-            largest = relativeED;
-        }
-    }
-    return &*worstMarket;
+    return getWorstSolutionInfo( false );
 }
 /*! \brief Find the policy solution info.
 * \author Josh Lurz, Sonny Kim
@@ -388,13 +532,19 @@ const SolutionInfo& SolutionInfoSet::getSolvable( unsigned int index ) const {
     return solvable.at( index );
 }
 
-//! Get the solvable set (may not be solved).
-vector<SolutionInfo> SolutionInfoSet::getSolvableSet() const{
+/*!
+ * \brief Get the solvable set (may not be solved).
+ * \details The set is only valid until the next call to updateSolvable.
+ */
+const vector<SolutionInfo>& SolutionInfoSet::getSolvableSet() const{
     return solvable;
 }
 
-//! Get the unsolvable set
-vector<SolutionInfo> SolutionInfoSet::getUnsolvableSet() const {
+/*!
+ * \brief Get the unsolvable set
+ * \details The set is only valid until the next call to updateSolvable.
+ */
+const vector<SolutionInfo>& SolutionInfoSet::getUnsolvableSet() const {
     return unsolvable;
 }
 
@@ -419,18 +569,42 @@ vector<SolutionInfo> SolutionInfoSet::getSolvedSet() const{
     return solvedSet;
 }
 
-//! Const getter which references the unsolved vector.
+/*!
+ * \brief Get a solvable market which is not solved.
+ * \param index The index of the market among the unsolved solvable markets,
+ *        in the order of getUnsolvedIndices.
+ * \return The market, which is held in the solvable set.
+ */
 SolutionInfo& SolutionInfoSet::getUnsolved( unsigned int index ) {
-    unsolved.clear();
     for( SetIterator curr = solvable.begin(); curr != solvable.end(); ++curr ){
-        if( !curr->isSolved() ){
-            unsolved.push_back( *curr );
+        if( !curr->isSolved() && index-- == 0 ){
+            return *curr;
+        }
+    }
+    throw out_of_range( "SolutionInfoSet::getUnsolved" );
+}
+
+/*!
+ * \brief Get the indices in the solvable set of the markets which are not
+ *        solved.
+ * \details This is a view of the unsolved markets which, unlike
+ *          getUnsolvedSet, does not copy them.
+ * \param aIndices Vector which will hold the indices, for use with
+ *        getSolvable.  It is cleared first so that the caller may reuse it.
+ */
+void SolutionInfoSet::getUnsolvedIndices( vector<unsigned int>& aIndices ) const {
+    aIndices.clear();
+    for( unsigned int i = 0; i < solvable.size(); ++i ){
+        if( !solvable[ i ].isSolved() ){
+            aIndices.push_back( i );
         }
     }
-    return unsolved.at( index );
 }
  
-//! Get the unsolved set.
+/*!
+ * \brief Get a copy of the unsolved set, from which a new SolutionInfoSet may
+ *        be made.
+ */
 vector<SolutionInfo> SolutionInfoSet::getUnsolvedSet() const {
     vector<SolutionInfo> unsolvedSet;
     for( ConstSetIterator currInfo = solvable.begin(); currInfo != solvable.end(); ++currInfo ){
@@ -481,16 +655,25 @@ bool SolutionInfoSet::hasSingularUnsolved(){
 }
 //! Check if every SolutionInfo is solved. Gets information from the markets.
 bool SolutionInfoSet::isAllSolved(){
-    // Check solvable first
-    for( SetIterator curr = solvable.begin(); curr != solvable.end(); ++curr ){
-        if( !curr->isSolved() ){
-            return false;
-        }
-    }
-    
-    // Check unsolvable as well, they should have cleared
-    for( SetIterator curr = unsolvable.begin(); curr != unsolvable.end(); ++curr ){
-        if( !curr->isSolved() ){
+    // Check solvable first, then unsolvable as well, they should have cleared
+    return isAllSolved( solvable ) && isAllSolved( unsolvable );
+}
+
+/*!
+ * \brief Check if every SolutionInfo in a set is solved.
+ * \details The tolerance test is done for the whole set from the batch
+ *          relative excess demands.  Only markets which fail it need to be
+ *          asked whether they meet a special solution condition.  Markets
+ *          excluded by the marketplace's restriction on solvable markets are
+ *          not checked since no solver may solve them.
+ * \param aSet The set of markets to check.
+ * \return Whether every market in the set is solved.
+ */
+bool SolutionInfoSet::isAllSolved( const vector<SolutionInfo>& aSet ) const {
+    calcRelativeEDs( aSet );
+    for( size_t i = 0; i < aSet.size(); ++i ) {
+        if( !( mRelativeEDs[ i ] < mSolutionTolerances[ i ] ) && !aSet[ i ].isSolved() &&
+            ( !mRestriction || mRestriction->acceptSolutionInfo( aSet[ i ] ) ) ){
             return false;
         }
     }
@@ -0,0 +1,177 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solve_budget.cpp
+ * \ingroup Solution
+ * \brief SolveBudget class source file.
+ */
+
+
+#include "util/base/include/definitions.h"
+#include <algorithm>
+
+#include "solution/util/include/solve_budget.h"
+#include "solution/util/include/solver_telemetry.h"
+#include "solution/util/include/calc_counter.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+SolveBudget::SolveBudget()
+:mPeriodSeconds( max( Configuration::getInstance()->getDouble( "period-solve-seconds", 0, false ), 0.0 ) ),
+mPeriodEvaluations( max( Configuration::getInstance()->getInt( "period-solve-evaluations", 0, false ), 0 ) ),
+mCalcCounter( 0 ),
+mStartEvaluations( 0 ),
+mFraction( 1 ),
+mComponentSeconds( 0 ),
+mComponentEvaluations( 0 )
+{
+}
+
+/*!
+ * \brief Get the single instance of the budget.
+ * \details The instance is created on first use which must be after the
+ *          configuration is read.
+ * \return The budget.
+ */
+SolveBudget& SolveBudget::getInstance() {
+    static SolveBudget budget;
+    return budget;
+}
+
+/*!
+ * \brief Start the budget of a period.
+ * \param aCalcCounter The counter of model evaluations.
+ * \param aFraction The fraction of the period's budget which may be used until
+ *        extendPeriod is called.
+ */
+void SolveBudget::startPeriod( const CalcCounter* aCalcCounter, const double aFraction ) {
+    mCalcCounter = aCalcCounter;
+    mStart = chrono::steady_clock::now();
+    mStartEvaluations = 0;
+    mStartEvaluations = getEvaluations();
+    mFraction = aFraction;
+    mComponentSeconds = 0;
+    mComponentEvaluations = 0;
+}
+
+/*!
+ * \brief Change the fraction of the period's budget which may be used.
+ * \details This is used to give the retry solver what remains of the budget
+ *          after the first solver has used its fraction.
+ * \param aFraction The fraction of the budget, measured from the start of the
+ *        period.
+ */
+void SolveBudget::extendPeriod( const double aFraction ) {
+    mFraction = aFraction;
+}
+
+/*!
+ * \brief Whether the period has used the fraction of its budget it has been
+ *        given.
+ * \return True if the period is over budget, always false if no limit is set.
+ */
+bool SolveBudget::isPeriodOverBudget() const {
+    return ( mPeriodSeconds > 0 && getElapsedSeconds() >= mFraction * mPeriodSeconds ) ||
+           ( mPeriodEvaluations > 0 && getEvaluations() >= mFraction * mPeriodEvaluations );
+}
+
+/*!
+ * \brief Start the budget of a solver component.
+ * \param aShare The share of what remains of the period's budget which the
+ *        component may use.
+ */
+void SolveBudget::startComponent( const double aShare ) {
+    const double elapsed = getElapsedSeconds();
+    const double evaluations = getEvaluations();
+    mComponentSeconds = elapsed + aShare * max( mFraction * mPeriodSeconds - elapsed, 0.0 );
+    mComponentEvaluations = evaluations + aShare * max( mFraction * mPeriodEvaluations - evaluations, 0.0 );
+}
+
+/*!
+ * \brief End the budget of a solver component so that components called
+ *        outside of a UserConfigurableSolver are only limited by the period.
+ */
+void SolveBudget::endComponent() {
+    mComponentSeconds = 0;
+    mComponentEvaluations = 0;
+}
+
+/*!
+ * \brief Whether the running solver component has used its share of the
+ *        budget, or the period has used all of its budget.
+ * \return True if the component should stop, always false if no limit is set.
+ */
+bool SolveBudget::isComponentOverBudget() const {
+    if( !isEnabled() ) {
+        return false;
+    }
+    if( mComponentSeconds > 0 || mComponentEvaluations > 0 ) {
+        return ( mPeriodSeconds > 0 && getElapsedSeconds() >= mComponentSeconds ) ||
+               ( mPeriodEvaluations > 0 && getEvaluations() >= mComponentEvaluations );
+    }
+    return isPeriodOverBudget();
+}
+
+/*!
+ * \brief Record a decision made because of the budget in the solver log and
+ *        the solver telemetry.
+ * \param aComponentName The solver making the decision.
+ * \param aPeriod The period being solved.
+ * \param aDecision A description of the decision.
+ */
+void SolveBudget::recordDecision( const string& aComponentName, const int aPeriod,
+                                  const string& aDecision ) const
+{
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << aComponentName << " in period " << aPeriod << ": " << aDecision
+              << " after " << getElapsedSeconds() << " seconds and " << getEvaluations()
+              << " model evaluations." << endl;
+
+    SolverTelemetry::getInstance().recordBudgetDecision( aComponentName, aPeriod,
+        static_cast<int>( getEvaluations() ), aDecision );
+}
+
+//! Seconds since the start of the period.
+double SolveBudget::getElapsedSeconds() const {
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - mStart;
+    return elapsed.count();
+}
+
+//! Model evaluations since the start of the period.
+double SolveBudget::getEvaluations() const {
+    return mCalcCounter ? mCalcCounter->getTotalCount() - mStartEvaluations : 0;
+}
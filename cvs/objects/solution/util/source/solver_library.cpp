@@ -61,13 +61,23 @@
 #include "solution/util/include/calc_counter.h"
 #include "util/logger/include/ilogger.h"
 #include "solution/util/include/ublas-helpers.hpp"
+#include "solution/util/include/linear_solver.hpp"
 #include "containers/include/iactivity.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 #include "solution/util/include/edfun.hpp"
 #include "solution/util/include/functor-subs.hpp"
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
+extern Scenario* scenario;
+
 #define NO_REGIONAL_DERIVATIVES 0
 
 /*! \brief Calculate and return a relative excess demand.
@@ -104,6 +114,41 @@ double SolverLibrary::getRelativeED( const double excessDemand, const double dem
     return retValue;
 }
 
+/*! \brief Calculate the relative excess demands of a set of markets at once.
+* \details Performs the same calculation as getRelativeED for each market.
+*          The loop has no calls and its only conditionals are selects so
+*          that the compiler can vectorize it over the contiguous arrays
+*          (GCC needs -fno-trapping-math to turn the selects into blends).
+* \param aExcessDemands The excess demand of each market.
+* \param aDemands The demand of each market.
+* \param aExcessDemandFloors Value of ED below which each market should be
+*        considered solved.
+* \param aRelativeEDs Return vector which will be set to the relative excess
+*        demand of each market.
+*/
+void SolverLibrary::getRelativeEDs( const vector<double>& aExcessDemands, const vector<double>& aDemands,
+                                    const vector<double>& aExcessDemandFloors, vector<double>& aRelativeEDs )
+{
+    const size_t size = aExcessDemands.size();
+    assert( aDemands.size() == size && aExcessDemandFloors.size() == size );
+    aRelativeEDs.resize( size );
+
+    const double* excessDemands = size > 0 ? &aExcessDemands[ 0 ] : 0;
+    const double* demands = size > 0 ? &aDemands[ 0 ] : 0;
+    const double* floors = size > 0 ? &aExcessDemandFloors[ 0 ] : 0;
+    double* relativeEDs = size > 0 ? &aRelativeEDs[ 0 ] : 0;
+    const double smallNumber = util::getSmallNumber();
+    for( size_t i = 0; i < size; ++i ) {
+        const double absExcessDemand = fabs( excessDemands[ i ] );
+        // Avoid dividing by a zero demand.
+        const double tempDemand = std::max( fabs( demands[ i ] ), smallNumber );
+        // Always divide, the demand is positive, so that the floor check is a
+        // select.
+        const double ratio = absExcessDemand / tempDemand;
+        relativeEDs[ i ] = absExcessDemand < floors[ i ] ? 0.0 : ratio;
+    }
+}
+
 /*! \brief Determine whether a market is within the solution tolerance.
 * \author Josh Lurz
 * \details This function determines if a market is solved to within the solution tolerance. It does this by checking if the
@@ -296,15 +341,17 @@ bool SolverLibrary::calculateNewPricesLogNR( SolutionInfoSet& aSolutionSet, Matr
  *          is singular in which case the contents of the matrix and permutation matrix will be garbage.
  */
 bool SolverLibrary::luFactorizeMatrix( Matrix& aInputMatrix, PermutationMatrix& aPermMatrix ) {
-    using namespace boost::numeric::ublas;
-    
-    // need to reset the permutation matrix
-    PermutationMatrix tempPerm( aInputMatrix.size1() );
-    aPermMatrix.assign( tempPerm );
-    
-    // do the LU-factorization, the return value is the singular row + 1
-    // and so if the return value is 0 there were no singularities
-    return lu_factorize( aInputMatrix, aPermMatrix ) != 0;
+    // do the LU-factorization with the configured backend, the return value
+    // is the singular row + 1 and so if the return value is 0 there were no
+    // singularities
+    LinearSolver luSolver;
+    if( luSolver.factorize( aInputMatrix ) != 0 ) {
+        return true;
+    }
+
+    // hand the factors back in the layout expected by lu_substitute
+    luSolver.getFactors( aInputMatrix, aPermMatrix );
+    return false;
 }
 
 /*! \brief Bracket a set of markets.
@@ -543,54 +590,7 @@ bool SolverLibrary::bracketOne( Marketplace* aMarketplace, World* aWorld, const
                                  aCalcCounter->getPeriodCount(),
                                  singleLog );
 
-        // If ED at X and L are the same sign.
-        if ( util::sign( aSol->getED() ) == util::sign( aSol->getEDLeft() ) ) {
-            // If Supply > Demand at point X.
-            if ( aSol->getED() < 0 ) {
-                aSol->moveRightBracketToX();
-                if( !aSol->isCurrentlyBracketed() ){
-                    aSol->decreaseX( bracketInterval, LOWER_BOUND );
-                }
-                else {
-                    aSol->setBracketed();
-                }
-            }
-            else { // If Supply <= Demand. Price needs to increase.
-                aSol->moveLeftBracketToX();
-                if( !aSol->isCurrentlyBracketed() ){
-                    aSol->increaseX( bracketInterval, LOWER_BOUND );
-                }
-                else {
-                    aSol->setBracketed();
-                }
-            }
-        }
-        else {  // ED at X and R are the same sign.
-            if ( aSol->getED() < 0 ) { // If Supply > Demand at X.
-                aSol->moveRightBracketToX();
-                if( !aSol->isCurrentlyBracketed() ){
-                    aSol->decreaseX( bracketInterval, LOWER_BOUND );
-                }
-                else {
-                    aSol->setBracketed();
-                }
-            }
-            else { // If Supply <= Demand at X. Prices need to increase.
-                aSol->moveLeftBracketToX();
-                if( !aSol->isCurrentlyBracketed() ){
-                    aSol->increaseX( bracketInterval, LOWER_BOUND );
-                }
-                else {
-                    aSol->setBracketed();
-                }
-            }
-        }
-        // Check if the market is actually solved.
-        if( aSol->isSolved() ){
-            aSol->setBracketed();
-            aSol->moveLeftBracketToX();
-            aSol->moveRightBracketToX();
-        }
+        stepBracket( aSol, bracketInterval, LOWER_BOUND );
 
         aMarketplace->nullSuppliesAndDemands( aPeriod );
         aWorld->calc( aPeriod );
@@ -609,6 +609,192 @@ bool SolverLibrary::bracketOne( Marketplace* aMarketplace, World* aWorld, const
     return aSol->isBracketed();
 }
 
+/*!
+ * \brief Take a single bracketing step for one market.
+ * \details Moves the left or right bracket to the current trial value depending
+ *          on the sign of the excess demand and, if the market is still not
+ *          bracketed, expands the trial value by the bracket interval.
+ * \param aSol The solution info to step.
+ * \param aBracketInterval The multiplier to use to expand the trial value.
+ * \param aLowerBound The smallest trial value which may be set.
+ */
+void SolverLibrary::stepBracket( SolutionInfo* aSol, const double aBracketInterval, const double aLowerBound ) {
+    // If ED at X and L are the same sign.
+    if ( util::sign( aSol->getED() ) == util::sign( aSol->getEDLeft() ) ) {
+        // If Supply > Demand at point X.
+        if ( aSol->getED() < 0 ) {
+            aSol->moveRightBracketToX();
+            if( !aSol->isCurrentlyBracketed() ){
+                aSol->decreaseX( aBracketInterval, aLowerBound );
+            }
+            else {
+                aSol->setBracketed();
+            }
+        }
+        else { // If Supply <= Demand. Price needs to increase.
+            aSol->moveLeftBracketToX();
+            if( !aSol->isCurrentlyBracketed() ){
+                aSol->increaseX( aBracketInterval, aLowerBound );
+            }
+            else {
+                aSol->setBracketed();
+            }
+        }
+    }
+    else {  // ED at X and R are the same sign.
+        if ( aSol->getED() < 0 ) { // If Supply > Demand at X.
+            aSol->moveRightBracketToX();
+            if( !aSol->isCurrentlyBracketed() ){
+                aSol->decreaseX( aBracketInterval, aLowerBound );
+            }
+            else {
+                aSol->setBracketed();
+            }
+        }
+        else { // If Supply <= Demand at X. Prices need to increase.
+            aSol->moveLeftBracketToX();
+            if( !aSol->isCurrentlyBracketed() ){
+                aSol->increaseX( aBracketInterval, aLowerBound );
+            }
+            else {
+                aSol->setBracketed();
+            }
+        }
+    }
+    // Check if the market is actually solved.
+    if( aSol->isSolved() ){
+        aSol->setBracketed();
+        aSol->moveLeftBracketToX();
+        aSol->moveRightBracketToX();
+    }
+}
+
+/*!
+ * \brief Bracket each unbracketed market independently and concurrently.
+ * \details Each market is bracketed as in bracketOne, holding the prices of
+ *          all other markets fixed, however the trial evaluations only
+ *          recalculate the activities which depend on that market and are
+ *          carried out in the "scratch" state using the partial derivative
+ *          machinery.  Since the markets do not share any state during the
+ *          search they are handed out to separate threads when
+ *          GCAM_PARALLEL_ENABLED.  Once all searches are done the markets are
+ *          moved to the trial values at which they stopped and a full model
+ *          evaluation brings the "base" state up to date.
+ * \param aMarketplace Marketplace reference.
+ * \param aWorld World reference.
+ * \param aDefaultBracketInterval The default bracket interval by which trial values are moved
+ *                                which may be overriden by a SolutionInfo.
+ * \param aMaxIterations The maximum iterations allowed to find a bracket for each market.
+ * \param aSolutionSet Vector of market solution information
+ * \param aCalcCounter The calculation counter.
+ * \param aSolutionInfoFilter The filter for the solvable markets.
+ * \param aPeriod Model period
+ * \return Whether bracketing of all markets completed successfully.
+ */
+bool SolverLibrary::bracketIndependent( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
+                                        const unsigned int aMaxIterations, SolutionInfoSet& aSolutionSet,
+                                        CalcCounter* aCalcCounter, const ISolutionInfoFilter* aSolutionInfoFilter,
+                                        const int aPeriod )
+{
+    static const double LOWER_BOUND = util::getSmallNumber();
+
+    // Make sure the markets are up to date before starting.
+    aMarketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+    aWorld->calc( aPeriod, aWorld->getGlobalFlowGraph() );
+#else
+    aWorld->calc( aPeriod );
+#endif
+    aSolutionSet.updateSolvable( aSolutionInfoFilter );
+    if( aSolutionSet.isAllBracketed() ){
+        return true;
+    }
+    aSolutionSet.resetBrackets();
+
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << "Entering independent bracketing" << endl;
+
+    vector<SolutionInfo*> toBracket;
+    for( int i = 0; i < aSolutionSet.getNumSolvable(); ++i ) {
+        SolutionInfo& currSol = aSolutionSet.getSolvable( i );
+        if( currSol.isSolved() ) {
+            currSol.setBracketed();
+            currSol.moveLeftBracketToX();
+            currSol.moveRightBracketToX();
+        }
+        else {
+            toBracket.push_back( &currSol );
+        }
+    }
+    if( toBracket.empty() ) {
+        solverLog << "Exiting bracketing early as all solvable markets are solved." << endl;
+        return true;
+    }
+
+    // The trial value each search stopped at, these are kept aside since the
+    // prices set in the "scratch" state are lost once we leave partial mode.
+    vector<double> finalPrices( toBracket.size() );
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    stateVars->setPartialDeriv( true );
+    aMarketplace->mIsDerivativeCalc = true;
+    auto bracketMarket = [&]( size_t aIndex ) {
+        SolutionInfo* currSol = toBracket[ aIndex ];
+        const double bracketInterval = currSol->getBracketInterval( aDefaultBracketInterval );
+        // Start from the "base" state so that ED is the value at the initial price.
+        stateVars->copyState();
+        unsigned int numIterations = 0;
+        do {
+            stepBracket( currSol, bracketInterval, LOWER_BOUND );
+            // Reset the "scratch" state before each trial since the partial
+            // derivative calc accumulates differences from the "base" state.
+            const double trialPrice = currSol->getPrice();
+            stateVars->copyState();
+            currSol->setPrice( trialPrice );
+            aWorld->calc( aPeriod, currSol->getDependencies() );
+        } while( ++numIterations < aMaxIterations && !currSol->isBracketed() );
+        finalPrices[ aIndex ] = currSol->getPrice();
+    };
+#if !GCAM_PARALLEL_ENABLED
+    for( size_t i = 0; i < toBracket.size(); ++i ) {
+        bracketMarket( i );
+    }
+#else
+    tbb::task_arena& threadPool = stateVars->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute([&](){
+        tg.run([&](){
+            tbb::parallel_for( size_t(0), toBracket.size(), bracketMarket );
+        });
+    });
+    threadPool.execute([&tg](){ tg.wait(); });
+#endif
+    aMarketplace->mIsDerivativeCalc = false;
+    stateVars->setPartialDeriv( false );
+
+    // Move all of the markets to where their searches ended and bring the
+    // "base" state up to date.
+    for( size_t i = 0; i < toBracket.size(); ++i ) {
+        toBracket[ i ]->setPrice( finalPrices[ i ] );
+    }
+    aMarketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+    aWorld->calc( aPeriod, aWorld->getGlobalFlowGraph() );
+#else
+    aWorld->calc( aPeriod );
+#endif
+    aSolutionSet.updateSolvable( aSolutionInfoFilter );
+
+    solverLog.setLevel( ILogger::DEBUG );
+    solverLog << "Solution Info Set before leaving independent bracketing: " << endl;
+    solverLog << aSolutionSet << endl;
+
+    ILogger& singleLog = ILogger::getLogger( "single_market_log" );
+    aSolutionSet.printMarketInfo( "End Independent Bracketing Attempt", aCalcCounter->getPeriodCount(), singleLog );
+
+    return aSolutionSet.isAllBracketed();
+}
+
 /*! \brief Store the current prices in the solver set in a vector.
 * \param aSolutionSet Solution set.
 * \return Vector of prices currently in the solver set.
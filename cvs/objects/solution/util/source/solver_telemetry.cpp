@@ -0,0 +1,139 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file solver_telemetry.cpp
+ * \ingroup Solution
+ * \brief SolverTelemetry class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+
+#include "solution/util/include/solver_telemetry.h"
+#include "util/base/include/auto_file.h"
+#include "util/base/include/configuration.h"
+
+using namespace std;
+
+SolverTelemetry::SolverTelemetry()
+:mIsEnabled( Configuration::getInstance()->getBool( "log-solver-telemetry", false, false ) ),
+mStepLength( 0 ),
+mHasStepLength( false )
+{
+    for( int i = 0; i < NUM_PHASES; ++i ) {
+        mPhaseSeconds[ i ] = 0;
+    }
+}
+
+//! Destructor, needed here where AutoOutputFile is complete.
+SolverTelemetry::~SolverTelemetry() {
+}
+
+/*!
+ * \brief Get the single instance of the telemetry.
+ * \details The instance is created on first use which must be after the
+ *          configuration is read.
+ * \return The telemetry.
+ */
+SolverTelemetry& SolverTelemetry::getInstance() {
+    static SolverTelemetry telemetry;
+    return telemetry;
+}
+
+/*!
+ * \brief Write a row for an iteration and reset the phase times and step
+ *        length for the next one.
+ * \param aComponentName The name of the solver component.
+ * \param aPeriod The period being solved.
+ * \param aIteration The iteration number within the solver component.
+ * \param aNumEvaluations The number of model evaluations in the period so far.
+ * \param aWorstMarket The name of the market with the largest relative
+ *        excess demand.
+ * \param aRelativeED The relative excess demand of the worst market.
+ */
+void SolverTelemetry::recordIteration( const string& aComponentName, const int aPeriod,
+                                       const int aIteration, const int aNumEvaluations,
+                                       const string& aWorstMarket, const double aRelativeED )
+{
+    if( !mIsEnabled ) {
+        return;
+    }
+
+    openFile();
+
+    // Market names can contain commas so quote them.
+    **mFile << aPeriod << ',' << aComponentName << ',' << aIteration << ','
+            << aNumEvaluations << ',' << aRelativeED << ",\"" << aWorstMarket << "\",";
+    if( mHasStepLength ) {
+        **mFile << mStepLength;
+    }
+    for( int i = 0; i < NUM_PHASES; ++i ) {
+        **mFile << ',' << mPhaseSeconds[ i ];
+        mPhaseSeconds[ i ] = 0;
+    }
+    // Avoid endl which would flush the file for every iteration.
+    **mFile << '\n';
+    mHasStepLength = false;
+}
+
+/*!
+ * \brief Write a row for a decision made because of the solve budget.
+ * \details The row has an iteration of -1, no excess demand and the decision
+ *          in the worst market column.  The phase times are left to be
+ *          written with the next iteration.
+ * \param aComponentName The name of the solver making the decision.
+ * \param aPeriod The period being solved.
+ * \param aNumEvaluations The number of model evaluations in the period so far.
+ * \param aDecision A description of the decision.
+ */
+void SolverTelemetry::recordBudgetDecision( const string& aComponentName, const int aPeriod,
+                                            const int aNumEvaluations, const string& aDecision )
+{
+    if( !mIsEnabled ) {
+        return;
+    }
+
+    openFile();
+    **mFile << aPeriod << ',' << aComponentName << ",-1," << aNumEvaluations
+            << ",,\"" << aDecision << "\",,,," << '\n';
+}
+
+//! Open the output file and write the header if it is not already open.
+void SolverTelemetry::openFile() {
+    if( !mFile.get() ) {
+        mFile.reset( new AutoOutputFile( "solverTelemetryFileName", "solver-telemetry.csv" ) );
+        **mFile << "period,component,iteration,model-evals,max-relative-ed,worst-market,"
+                << "step-length,fdjac-seconds,linear-solve-seconds,linesearch-seconds" << endl;
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef _CLIMATE_SURROGATE_SOLVER_H_
+#define _CLIMATE_SURROGATE_SOLVER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file climate_surrogate_solver.h
+ * \ingroup Objects
+ * \brief The ClimateSurrogateSolver class header file.
+ */
+
+#include <vector>
+#include <string>
+#include "target_finder/include/itarget_solver.h"
+
+class ITarget;
+class IClimateModel;
+
+/*! \brief Object which proposes trial prices for a climate target by running
+ *         the climate model alone on emissions estimated from earlier trials.
+ * \details After each full model trial the emissions of the taxed gas which
+ *          were passed to the climate model are recorded along with the trial
+ *          price. Once two trials at different prices are known the emissions
+ *          in each period are linearly interpolated (or extrapolated) in the
+ *          log of the price between them, as the Secanter does for the status,
+ *          or in the price itself when one of the prices is zero. The target is then solved against the climate
+ *          model alone using these emissions, which is cheap compared to a
+ *          full model run, and the solution is returned as the next trial to
+ *          confirm with the full model. Emissions of the other gases are left
+ *          as they were in the last full trial.
+ *
+ *          The proposal is limited to halving or doubling the range of the
+ *          two trials it was fit from. If the climate model does not know the
+ *          gas, or the climate only solution fails, a secant step between the
+ *          last two trials is used instead. As for the other target solvers a
+ *          positive status means the price is too low and a negative status
+ *          that it is too high.
+ */
+class ClimateSurrogateSolver : public ITargetSolver {
+public:
+    ClimateSurrogateSolver( const ITarget* aTarget,
+                            IClimateModel* aClimateModel,
+                            const std::string& aGasName,
+                            const int aFirstPeriod,
+                            const double aTolerance,
+                            const double aInitialPrice,
+                            const double aInitialValue,
+                            const double aInitialPriceChange,
+                            const int aYear );
+
+    // ITargetSolver methods
+    std::pair<double, bool> getNextValue();
+
+    unsigned int getIterations() const;
+private:
+    //! A completed full model trial.
+    struct Trial {
+        //! The trial price.
+        double mPrice;
+
+        //! The target status of the trial.
+        double mValue;
+
+        //! The emissions of the gas by period starting from mFirstPeriod.
+        std::vector<double> mEmissions;
+    };
+
+    //! The target.
+    const ITarget* mTarget;
+
+    //! The climate model to run on its own.
+    IClimateModel* mClimateModel;
+
+    //! The name of the gas whose emissions respond to the price.
+    const std::string mGasName;
+
+    //! The first period in which emissions respond to the price.
+    const int mFirstPeriod;
+
+    //! The tolerance of the target.
+    const double mTolerance;
+
+    //! Year in which to check the target.
+    const int mYear;
+
+    //! The price of the trial currently being run by the full model.
+    double mCurrentPrice;
+
+    //! The last two trials which completed, the most recent last.
+    std::vector<Trial> mTrials;
+
+    //! Whether the climate model accepts emissions for the gas.
+    bool mIsSurrogateValid;
+
+    //! The current number of trial values returned.
+    unsigned int mIterations;
+
+    void addTrial( const double aPrice, const double aValue );
+
+    void setEmissions( const double aPrice );
+
+    bool solveSurrogate( double& aPrice );
+
+    double getSecantPrice() const;
+};
+
+#endif // _CLIMATE_SURROGATE_SOLVER_H_
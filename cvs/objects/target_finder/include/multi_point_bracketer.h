@@ -0,0 +1,117 @@
+#ifndef _MULTI_POINT_BRACKETER_H_
+#define _MULTI_POINT_BRACKETER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file multi_point_bracketer.h
+ * \ingroup Objects
+ * \brief The MultiPointBracketer class header file.
+ */
+
+#include <vector>
+#include <utility>
+
+/*! \brief Object which searches for the price which meets a target by
+ *         evaluating several trial prices at once.
+ * \details Each iteration produces a set of trial prices which are evaluated
+ *          together, for instance in parallel, and the status of each is
+ *          then passed back. As for the other target solvers a positive
+ *          status means the price is too low and a negative status that it
+ *          is too high.
+ *
+ *          Until the solution is bracketed the trial prices grow (or shrink)
+ *          geometrically from the best known price, with the rate of growth
+ *          increasing each iteration. Prices at which the status could not be
+ *          calculated limit the growth. Once the solution is bracketed the
+ *          trial prices are the secant estimate of the solution, using the
+ *          log of the price as for the Secanter, along with points equally
+ *          spaced across the bracket, so that every iteration reduces the
+ *          bracket by at least a factor of the number of points.
+ */
+class MultiPointBracketer {
+public:
+    MultiPointBracketer( const double aTolerance,
+                         const double aInitialPrice,
+                         const double aInitialValue,
+                         const double aInitialPriceChange,
+                         const unsigned int aNumPoints );
+
+    const std::vector<double>& getTrialPrices() const;
+
+    void setTrialValues( const std::vector<double>& aValues );
+
+    bool isSolved() const;
+
+    double getSolution() const;
+
+    unsigned int getIterations() const;
+private:
+    //! The tolerance of the target.
+    const double mTolerance;
+
+    //! The number of trial prices in each iteration.
+    const unsigned int mNumPoints;
+
+    //! The factor by which trial prices grow until the solution is bracketed.
+    double mGrowth;
+
+    //! The highest price known to be too low and its status.
+    std::pair<double, double> mLower;
+
+    //! The lowest price known to be too high and its status.
+    std::pair<double, double> mUpper;
+
+    //! The lowest price at which the status could not be calculated.
+    double mLowestFailedPrice;
+
+    //! The best solution found and its status.
+    std::pair<double, double> mSolution;
+
+    //! The trial prices of the current iteration.
+    std::vector<double> mTrialPrices;
+
+    //! The number of iterations performed.
+    unsigned int mIterations;
+
+    void createTrialPrices();
+
+    void printState() const;
+};
+
+#endif // _MULTI_POINT_BRACKETER_H_
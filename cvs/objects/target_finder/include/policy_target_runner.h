@@ -46,6 +46,7 @@
 
 #include <memory>
 #include <vector>
+#include <functional>
 #include "containers/include/iscenario_runner.h"
 #include "util/base/include/value.h"
 
@@ -110,6 +111,17 @@ class Modeltime;
  *                   (optional) Set the initial target year to the value of the
  *                   year attribute or the last model year if that attribute is
  *                   not specified.
+ *              - \c parallel-trials PolicyTargetRunner::mParallelTrials
+ *                   (optional) The number of trial taxes to run at once, each
+ *                   in a separate process, using a MultiPointBracketer. The
+ *                   default is 0 which runs a single trial at a time using a
+ *                   Secanter.
+ *              - \c climate-surrogate PolicyTargetRunner::mUseClimateSurrogate
+ *                   (optional) Whether to propose each trial tax by solving the
+ *                   target with the climate model alone, using emissions
+ *                   interpolated from earlier trials, with a
+ *                   ClimateSurrogateSolver. This only applies when trials are
+ *                   run one at a time. The default is false.
  *
  * \author Josh Lurz
  * \author Pralit Patel
@@ -189,6 +201,10 @@ private:
     //! Unique identifier for each scenario run dispatched.  Used to
     //! help identify output from a particular run in log files.
     unsigned int mRunID;
+
+    //! Whether the trial tax has been set into all regions so that further
+    //! trials may just update the tax path.
+    bool mHasSetTrialTaxes;
     
     //! The number of periods to forward look when trying to stay on target
     //! which my change by period
@@ -202,6 +218,12 @@ private:
     //! solve.
     double mMaxTax;
 
+    //! The number of trial taxes to run at once, each in a separate process.
+    unsigned int mParallelTrials;
+
+    //! Whether to propose trial taxes from the climate model alone.
+    bool mUseClimateSurrogate;
+
     void
         calculateHotellingPath( const double aIntialTax,
                                 const double aHotellingRate,
@@ -232,6 +254,17 @@ private:
                            const int aFirstSkippedPeriod,
                            const int aPeriod,
                            Timer& aTimer );
+
+    bool solveWithParallelTrials( const std::function<bool( const double )>& aRunTrial,
+                                  const ITarget* aPolicyTarget,
+                                  const int aYear,
+                                  const double aInitialTax,
+                                  const double aInitialStatus,
+                                  const double aInitialTaxChange,
+                                  const unsigned int aLimitIterations,
+                                  const double aTolerance,
+                                  bool& aRunSuccess,
+                                  unsigned int& aIterations );
     PolicyTargetRunner();
     static const std::string& getXMLNameStatic();
     void logRunID();
@@ -0,0 +1,286 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file climate_surrogate_solver.cpp
+ * \ingroup Objects
+ * \brief ClimateSurrogateSolver class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+#include <algorithm>
+#include "util/logger/include/ilogger.h"
+#include "target_finder/include/climate_surrogate_solver.h"
+#include "target_finder/include/itarget.h"
+#include "climate/include/iclimate_model.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+/*!
+ * \brief Construct the ClimateSurrogateSolver.
+ * \details The climate model must currently hold the results of a full model
+ *          run at the initial price, which becomes the first known trial.
+ * \param aTarget The policy target.
+ * \param aClimateModel The climate model which the target is measured by.
+ * \param aGasName The name of the taxed gas.
+ * \param aFirstPeriod The first period in which the price applies.
+ * \param aTolerance Solution tolerance.
+ * \param aInitialPrice The price of the last full model run.
+ * \param aInitialValue The solution status of the initial price.
+ * \param aInitialPriceChange A percentage change from the initial price to
+ *                            come up with the second trial, as for the
+ *                            Secanter.
+ * \param aYear Year to check the solution status in.
+ */
+ClimateSurrogateSolver::ClimateSurrogateSolver( const ITarget* aTarget,
+                                                IClimateModel* aClimateModel,
+                                                const string& aGasName,
+                                                const int aFirstPeriod,
+                                                const double aTolerance,
+                                                const double aInitialPrice,
+                                                const double aInitialValue,
+                                                const double aInitialPriceChange,
+                                                const int aYear ) :
+mTarget( aTarget ),
+mClimateModel( aClimateModel ),
+mGasName( aGasName ),
+mFirstPeriod( max( aFirstPeriod, 1 ) ),
+mTolerance( aTolerance ),
+mYear( aYear ),
+mCurrentPrice( aInitialPrice ),
+mIsSurrogateValid( true ),
+mIterations( 0 )
+{
+    addTrial( aInitialPrice, aInitialValue );
+    if( fabs( aInitialValue ) < mTolerance ) {
+        // Already at the solution
+        mCurrentPrice = aInitialPrice;
+    }
+    else if( aInitialPrice == 0 ) {
+        mCurrentPrice = aInitialPriceChange + 1;
+    }
+    else if( aInitialValue > 0 ) {
+        mCurrentPrice = aInitialPrice * ( aInitialPriceChange + 1 );
+    }
+    else {
+        mCurrentPrice = aInitialPrice / ( aInitialPriceChange + 1 );
+    }
+}
+
+/*! \brief Get the next trial value and check for solution.
+ * \details Checks if the last full model trial solved the target, otherwise
+ *          records it and proposes the next trial from the climate model
+ *          alone.
+ * \return A pair representing the next trial value and whether the target is
+ *         solved.
+ */
+pair<double, bool> ClimateSurrogateSolver::getNextValue() {
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    if( mIterations++ == 0 ) {
+        // The second trial has not been run yet, unless the initial price
+        // was already the solution.
+        return make_pair( mCurrentPrice, fabs( mTrials.back().mValue ) < mTolerance );
+    }
+
+    const double value = mTarget->getStatus( mYear );
+    targetLog << "Current trial status is " << value << endl;
+    if( fabs( value ) < mTolerance ) {
+        targetLog << "Found solution at " << mCurrentPrice << endl;
+        return make_pair( mCurrentPrice, true );
+    }
+
+    double nextPrice;
+    if( std::isnan( value ) ) {
+        // The climate model failed, likely due to failure to solve, so back
+        // track towards the last trial which worked.
+        nextPrice = ( mCurrentPrice + mTrials.back().mPrice ) / 2.0;
+    }
+    else {
+        addTrial( mCurrentPrice, value );
+        if( !mIsSurrogateValid || !solveSurrogate( nextPrice ) ) {
+            nextPrice = getSecantPrice();
+            targetLog << "Using a secant step to " << nextPrice << endl;
+        }
+    }
+    mCurrentPrice = max( nextPrice, 0.0 );
+    return make_pair( mCurrentPrice, false );
+}
+
+/*! \brief Get the current number of iterations performed.
+ * \return The current number of iterations performed.
+ */
+unsigned int ClimateSurrogateSolver::getIterations() const {
+    return mIterations;
+}
+
+/*!
+ * \brief Record a completed full model trial along with the emissions the
+ *        climate model holds for it.
+ * \details Only the last two trials at different prices are kept.
+ * \param aPrice The trial price.
+ * \param aValue The target status of the trial.
+ */
+void ClimateSurrogateSolver::addTrial( const double aPrice, const double aValue ) {
+    if( !mTrials.empty() && mTrials.back().mPrice == aPrice ) {
+        mTrials.pop_back();
+    }
+    Trial trial;
+    trial.mPrice = aPrice;
+    trial.mValue = aValue;
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( int period = mFirstPeriod; period < modeltime->getmaxper(); ++period ) {
+        trial.mEmissions.push_back( mClimateModel->getEmissions( mGasName, modeltime->getper_to_yr( period ) ) );
+    }
+    mTrials.push_back( trial );
+    if( mTrials.size() > 2 ) {
+        mTrials.erase( mTrials.begin() );
+    }
+}
+
+/*!
+ * \brief Set the emissions of the gas in the climate model to those
+ *        interpolated between the last two trials at a price.
+ * \details The interpolation is in the log of the price unless one of the
+ *          prices is zero.
+ * \param aPrice The price to estimate the emissions for.
+ */
+void ClimateSurrogateSolver::setEmissions( const double aPrice ) {
+    const Trial& first = mTrials.front();
+    const Trial& last = mTrials.back();
+    const double weight = first.mPrice > 0 && last.mPrice > 0 && aPrice > 0 ?
+        log( aPrice / first.mPrice ) / log( last.mPrice / first.mPrice ) :
+        ( aPrice - first.mPrice ) / ( last.mPrice - first.mPrice );
+    for( size_t i = 0; i < last.mEmissions.size(); ++i ) {
+        const double emissions = first.mEmissions[ i ] + weight * ( last.mEmissions[ i ] - first.mEmissions[ i ] );
+        if( !mClimateModel->setEmissions( mGasName, mFirstPeriod + static_cast<int>( i ), emissions ) ) {
+            mIsSurrogateValid = false;
+        }
+    }
+}
+
+/*!
+ * \brief Solve the target using the climate model alone.
+ * \details The secant method is run on the target status of the climate model
+ *          with the interpolated emissions, starting from the last two trials.
+ *          Afterwards the emissions of the last trial are restored and the
+ *          climate model is run again so that its results are those of the
+ *          last full model trial.
+ * \param aPrice The price which the climate model alone found.
+ * \return Whether a price could be found.
+ */
+bool ClimateSurrogateSolver::solveSurrogate( double& aPrice ) {
+    // The number of climate model runs to allow for each proposal.
+    const unsigned int MAX_CLIMATE_RUNS = 20;
+
+    if( mTrials.size() < 2 ) {
+        return false;
+    }
+    const double lowerBound = 0.5 * min( mTrials.front().mPrice, mTrials.back().mPrice );
+    const double upperBound = 2.0 * max( mTrials.front().mPrice, mTrials.back().mPrice );
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+
+    pair<double, double> prev( mTrials.front().mPrice, mTrials.front().mValue );
+    pair<double, double> curr( mTrials.back().mPrice, mTrials.back().mValue );
+    pair<double, double> best = curr;
+    bool success = false;
+    for( unsigned int run = 0; run < MAX_CLIMATE_RUNS && mIsSurrogateValid; ++run ) {
+        if( curr.second == prev.second ) {
+            break;
+        }
+        double price = curr.first - curr.second * ( curr.first - prev.first ) / ( curr.second - prev.second );
+        price = min( max( price, lowerBound ), upperBound );
+        setEmissions( price );
+        if( !mIsSurrogateValid || mClimateModel->runModel() != IClimateModel::SUCCESS ) {
+            break;
+        }
+        const double value = mTarget->getStatus( mYear );
+        if( !util::isValidNumber( value ) ) {
+            break;
+        }
+        targetLog << "Climate only trial " << run << ": (" << price << ", " << value << ")" << endl;
+        prev = curr;
+        curr = make_pair( price, value );
+        if( !success || fabs( value ) < fabs( best.second ) ) {
+            best = curr;
+            success = true;
+        }
+        if( fabs( value ) < mTolerance / 2 ) {
+            break;
+        }
+    }
+
+    if( !mIsSurrogateValid ) {
+        targetLog.setLevel( ILogger::WARNING );
+        targetLog << "The climate model does not accept emissions of " << mGasName
+                  << ", no longer using it to propose trials." << endl;
+    }
+
+    // Put back the results of the last full model trial.
+    setEmissions( mTrials.back().mPrice );
+    mClimateModel->runModel();
+
+    if( success ) {
+        targetLog.setLevel( ILogger::DEBUG );
+        targetLog << "Climate model proposed " << best.first << " with status " << best.second << endl;
+        aPrice = best.first;
+    }
+    return success;
+}
+
+/*!
+ * \brief The secant estimate of the solution from the last two trials.
+ * \details The step is limited to halving or doubling the last price. With
+ *          only one trial the price is doubled or halved towards the solution.
+ * \return The next trial price.
+ */
+double ClimateSurrogateSolver::getSecantPrice() const {
+    const Trial& last = mTrials.back();
+    const double lowerBound = 0.5 * last.mPrice;
+    const double upperBound = last.mPrice > 0 ? 2.0 * last.mPrice : 1.0;
+    if( mTrials.size() < 2 || last.mValue == mTrials.front().mValue ) {
+        return last.mValue > 0 ? upperBound : lowerBound;
+    }
+    const Trial& first = mTrials.front();
+    const double price = last.mPrice - last.mValue * ( last.mPrice - first.mPrice ) / ( last.mValue - first.mValue );
+    return min( max( price, lowerBound ), upperBound );
+}
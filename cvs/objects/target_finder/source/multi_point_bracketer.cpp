@@ -0,0 +1,230 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file multi_point_bracketer.cpp
+ * \ingroup Objects
+ * \brief MultiPointBracketer class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+#include <algorithm>
+#include "util/logger/include/ilogger.h"
+#include "target_finder/include/multi_point_bracketer.h"
+#include "target_finder/include/itarget_solver.h"
+
+using namespace std;
+
+/*!
+ * \brief Construct the MultiPointBracketer.
+ * \param aTolerance Solution tolerance.
+ * \param aInitialPrice A price which has already been evaluated.
+ * \param aInitialValue The solution status of the initial price.
+ * \param aInitialPriceChange The percentage change from the initial price to
+ *                            the first trial price.
+ * \param aNumPoints The number of trial prices to evaluate in each iteration.
+ */
+MultiPointBracketer::MultiPointBracketer( const double aTolerance,
+                                          const double aInitialPrice,
+                                          const double aInitialValue,
+                                          const double aInitialPriceChange,
+                                          const unsigned int aNumPoints ) :
+mTolerance( aTolerance ),
+mNumPoints( max( aNumPoints, 1u ) ),
+mGrowth( 1 + max( aInitialPriceChange, 0.01 ) ),
+mLower( ITargetSolver::undefined(), ITargetSolver::undefined() ),
+mUpper( ITargetSolver::undefined(), ITargetSolver::undefined() ),
+mLowestFailedPrice( ITargetSolver::undefined() ),
+mSolution( ITargetSolver::undefined(), ITargetSolver::undefined() ),
+mIterations( 0 )
+{
+    if( fabs( aInitialValue ) < mTolerance ) {
+        // Already at the solution
+        mSolution = make_pair( aInitialPrice, aInitialValue );
+    }
+    else if( aInitialValue > 0 ) {
+        mLower = make_pair( aInitialPrice, aInitialValue );
+    }
+    else {
+        mUpper = make_pair( aInitialPrice, aInitialValue );
+    }
+    createTrialPrices();
+}
+
+/*!
+ * \brief Get the prices to evaluate in the current iteration.
+ * \return The trial prices, which are empty once the solution is found.
+ */
+const vector<double>& MultiPointBracketer::getTrialPrices() const {
+    return mTrialPrices;
+}
+
+/*!
+ * \brief Set the status of each of the trial prices and create the next set.
+ * \param aValues The status of each trial price, which may be NaN if it could
+ *        not be calculated.
+ */
+void MultiPointBracketer::setTrialValues( const vector<double>& aValues ) {
+    ++mIterations;
+    const bool wasBracketed = mLower.first != ITargetSolver::undefined() && mUpper.first != ITargetSolver::undefined();
+    for( size_t i = 0; i < mTrialPrices.size() && i < aValues.size(); ++i ) {
+        const double price = mTrialPrices[ i ];
+        const double value = aValues[ i ];
+        if( std::isnan( value ) ) {
+            if( mLowestFailedPrice == ITargetSolver::undefined() || price < mLowestFailedPrice ) {
+                mLowestFailedPrice = price;
+            }
+        }
+        else if( fabs( value ) < mTolerance ) {
+            if( mSolution.first == ITargetSolver::undefined() || fabs( value ) < fabs( mSolution.second ) ) {
+                mSolution = make_pair( price, value );
+            }
+        }
+        else if( value > 0 ) {
+            if( mLower.first == ITargetSolver::undefined() || price > mLower.first ) {
+                mLower = make_pair( price, value );
+            }
+        }
+        else if( mUpper.first == ITargetSolver::undefined() || price < mUpper.first ) {
+            mUpper = make_pair( price, value );
+        }
+    }
+
+    // Grow faster while the solution has not been bracketed.
+    if( !wasBracketed ) {
+        mGrowth *= mGrowth;
+    }
+
+    // The bracket can not be narrowed any further, take the closer end.
+    if( !isSolved() && mLower.first != ITargetSolver::undefined() && mUpper.first != ITargetSolver::undefined() &&
+        mUpper.first - mLower.first <= 1e-8 * mUpper.first )
+    {
+        ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+        targetLog.setLevel( ILogger::WARNING );
+        targetLog << "Bracket has collapsed without meeting the tolerance." << endl;
+        mSolution = fabs( mLower.second ) < fabs( mUpper.second ) ? mLower : mUpper;
+    }
+    createTrialPrices();
+    printState();
+}
+
+/*!
+ * \brief Whether a price which meets the target has been found.
+ * \return Whether the target is solved.
+ */
+bool MultiPointBracketer::isSolved() const {
+    return mSolution.first != ITargetSolver::undefined();
+}
+
+/*!
+ * \brief Get the price which meets the target.
+ * \pre isSolved is true.
+ * \return The solution price.
+ */
+double MultiPointBracketer::getSolution() const {
+    return mSolution.first;
+}
+
+/*! \brief Get the current number of iterations performed.
+ * \return The current number of iterations performed.
+ */
+unsigned int MultiPointBracketer::getIterations() const {
+    return mIterations;
+}
+
+//! Create the trial prices for the next iteration.
+void MultiPointBracketer::createTrialPrices() {
+    mTrialPrices.clear();
+    if( isSolved() ) {
+        return;
+    }
+
+    const bool hasLower = mLower.first != ITargetSolver::undefined();
+    const bool hasUpper = mUpper.first != ITargetSolver::undefined();
+    if( hasLower && hasUpper ) {
+        // The fraction of the way across the bracket of the secant estimate.
+        const bool useLog = mLower.first > 0;
+        const double low = useLog ? log( mLower.first ) : mLower.first;
+        const double high = useLog ? log( mUpper.first ) : mUpper.first;
+        const double secant = mLower.second / ( mLower.second - mUpper.second );
+        vector<double> fractions( 1, secant );
+        for( unsigned int point = 1; point < mNumPoints; ++point ) {
+            fractions.push_back( static_cast<double>( point ) / mNumPoints );
+        }
+        sort( fractions.begin(), fractions.end() );
+        for( size_t i = 0; i < fractions.size(); ++i ) {
+            const double price = low + ( high - low ) * fractions[ i ];
+            mTrialPrices.push_back( useLog ? exp( price ) : price );
+        }
+        mTrialPrices.erase( unique( mTrialPrices.begin(), mTrialPrices.end() ), mTrialPrices.end() );
+    }
+    else if( hasLower ) {
+        // Raise the price, but only up to a price at which the status could not
+        // be calculated.
+        const double base = mLower.first > 0 ? mLower.first : 1;
+        const bool isLimited = mLowestFailedPrice != ITargetSolver::undefined() && mLowestFailedPrice > mLower.first;
+        const double growth = isLimited ? pow( mLowestFailedPrice / base, 1.0 / ( mNumPoints + 1 ) ) : mGrowth;
+        double price = base;
+        for( unsigned int point = 0; point < mNumPoints; ++point ) {
+            price *= growth;
+            mTrialPrices.push_back( price );
+        }
+    }
+    else {
+        double price = mUpper.first;
+        for( unsigned int point = 0; point < mNumPoints; ++point ) {
+            price /= mGrowth;
+            mTrialPrices.push_back( price );
+        }
+    }
+}
+
+//! Print the current state of the search.
+void MultiPointBracketer::printState() const {
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    if( isSolved() ) {
+        targetLog << "Found solution. The solution is: (" << mSolution.first << ", "
+                  << mSolution.second << ")" << endl;
+        return;
+    }
+    targetLog << "Attempting to solve target. Iteration: " << mIterations
+              << " The bracket is: (" << mLower.first << ", " << mLower.second << "); ("
+              << mUpper.first << ", " << mUpper.second << ") Next trials:";
+    for( size_t i = 0; i < mTrialPrices.size(); ++i ) {
+        targetLog << ' ' << mTrialPrices[ i ];
+    }
+    targetLog << endl;
+}
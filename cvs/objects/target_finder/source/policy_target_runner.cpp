@@ -42,6 +42,9 @@
 #include <cassert>
 #include <string>
 #include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <limits>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/xml_helper.h"
@@ -50,6 +53,8 @@
 #include "target_finder/include/itarget_solver.h"
 #include "target_finder/include/bisecter.h"
 #include "target_finder/include/secanter.h"
+#include "target_finder/include/multi_point_bracketer.h"
+#include "target_finder/include/climate_surrogate_solver.h"
 #include "target_finder/include/itarget.h"
 #include "containers/include/scenario_runner_factory.h"
 #include "util/base/include/configuration.h"
@@ -57,6 +62,7 @@
 #include "containers/include/single_scenario_runner.h"
 #include "containers/include/total_policy_cost_calculator.h"
 #include "util/base/include/model_time.h"
+#include "util/base/include/process_pool.h"
 #include "containers/include/scenario.h"
 #include "policy/include/policy_ghg.h"
 #include "util/base/include/util.h"
@@ -75,9 +81,12 @@ mMaxIterations( 100 ),
 mInitialTargetYear( ITarget::getUseMaxTargetYearFlag() ),
 mHasParsedConfig( false ),
 mRunID( 0 ),
+mHasSetTrialTaxes( false ),
 mNumForwardLooking( 0 ),
 mNumBackwardsLook( 0 ),
-mMaxTax( 4999 )
+mMaxTax( 4999 ),
+mParallelTrials( 0 ),
+mUseClimateSurrogate( false )
 {
 }
 
@@ -163,6 +172,12 @@ bool PolicyTargetRunner::XMLParse( const xercesc::DOMNode* aRoot ){
         else if( nodeName == "initial-tax-guess" ) {
             mInitialTaxGuess = XMLHelper<double>::getValue( curr );
         }
+        else if( nodeName == "parallel-trials" ) {
+            mParallelTrials = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "climate-surrogate" ) {
+            mUseClimateSurrogate = XMLHelper<bool>::getValue( curr );
+        }
         // Handle unknown nodes.
         else {
             ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -233,6 +248,13 @@ bool PolicyTargetRunner::setupScenarios( Timer& aTimer,
         mTolerance = 0.01;
     }
     
+    if( mParallelTrials > 1 && !ProcessPool::isAvailable() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Target trials can not be run in separate processes in this build of GCAM." << endl;
+        mParallelTrials = 0;
+    }
+    
     if( mInitialTargetYear == 0 ) {
         // If the overshoot tag was read in but without a year attribute then
         // we can now set the year to tbe the last model year.
@@ -410,36 +432,11 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     
     // Increment is 1+ this number, which is used to increase the initial trial price
     const double INCREASE_INCREMENT = mInitialTaxGuess - 1;
-    auto_ptr<ITargetSolver> solver;
-    
-    solver.reset( new Secanter( aPolicyTarget,
-                       aTolerance,
-                       initialTax,
-                       aPolicyTarget->getStatus( mInitialTargetYear ),
-                       INCREASE_INCREMENT,
-                       mInitialTargetYear ) );
-    
-
-    while( solver->getIterations() < aLimitIterations ) {
-        pair<double, bool> trial = solver->getNextValue();
-
-        // Check for solution.
-        if( trial.second ){
-            break;
-        }
-        
-        if( !util::isValidNumber( trial.first ) ) {
-            targetLog.setLevel( ILogger::ERROR );
-            targetLog << "Failed due to invalid trial price generated by solver." << endl;
-            return false;
-        }
-
-        
-        targetLog << "Iteration " << solver->getIterations() << " trial value = "
-                  << trial.first << endl;
 
+    // Run the scenario at the trial initial tax.
+    auto runTrial = [&]( const double aTrialTax ) {
         // Set the trial tax.
-        calculateHotellingPath( trial.first,
+        calculateHotellingPath( aTrialTax,
                                          mPathDiscountRate,
                                          getInternalScenario()->getModeltime(),
                                          mFirstTaxYear,
@@ -454,12 +451,69 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
         // Run the scenario at the trial tax.
         // TODO: If the run failed to solve then the target status may be unreliable.
         logRunID();
-        success = mSingleScenario->runScenarios( finalModelPeriod, false, aTimer );
+        const bool runSuccess = mSingleScenario->runScenarios( finalModelPeriod, false, aTimer );
+
+        targetLog << "Scenario run complete.  Return status = " << runSuccess << endl;
+        return runSuccess;
+    };
 
-        targetLog << "Scenario run complete.  Return status = " << success << endl;
+    unsigned int iterations = 0;
+    if( mParallelTrials > 1 ) {
+        if( !solveWithParallelTrials( runTrial, aPolicyTarget, mInitialTargetYear, initialTax,
+                                      aPolicyTarget->getStatus( mInitialTargetYear ), INCREASE_INCREMENT,
+                                      aLimitIterations, aTolerance, success, iterations ) )
+        {
+            return false;
+        }
     }
+    else {
+        auto_ptr<ITargetSolver> solver;
+        
+        if( mUseClimateSurrogate ) {
+            solver.reset( new ClimateSurrogateSolver( aPolicyTarget,
+                                                      getInternalScenario()->getClimateModel(),
+                                                      mTaxName,
+                                                      firstTaxPeriod,
+                                                      aTolerance,
+                                                      initialTax,
+                                                      aPolicyTarget->getStatus( mInitialTargetYear ),
+                                                      INCREASE_INCREMENT,
+                                                      mInitialTargetYear ) );
+        }
+        else {
+            solver.reset( new Secanter( aPolicyTarget,
+                               aTolerance,
+                               initialTax,
+                               aPolicyTarget->getStatus( mInitialTargetYear ),
+                               INCREASE_INCREMENT,
+                               mInitialTargetYear ) );
+        }
+        
 
-    if( solver->getIterations() >= aLimitIterations ){
+        while( solver->getIterations() < aLimitIterations ) {
+            pair<double, bool> trial = solver->getNextValue();
+
+            // Check for solution.
+            if( trial.second ){
+                break;
+            }
+            
+            if( !util::isValidNumber( trial.first ) ) {
+                targetLog.setLevel( ILogger::ERROR );
+                targetLog << "Failed due to invalid trial price generated by solver." << endl;
+                return false;
+            }
+
+            
+            targetLog << "Iteration " << solver->getIterations() << " trial value = "
+                      << trial.first << endl;
+
+            success = runTrial( trial.first );
+        }
+        iterations = solver->getIterations();
+    }
+
+    if( iterations >= aLimitIterations ){
         targetLog.setLevel( ILogger::ERROR );
         targetLog << "Exiting target finding search as the iterations limit was"
                   << " reached." << endl;
@@ -488,7 +542,7 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     if( success ) {
         targetLog.setLevel( ILogger::NOTICE );
         targetLog << "Target value was found by search algorithm in "
-                  << solver->getIterations() << " iterations." << endl;
+                  << iterations << " iterations." << endl;
     }
     return success;
 }
@@ -527,38 +581,11 @@ bool PolicyTargetRunner::solveFutureTarget( vector<double>& aTaxes,
     logRunID();
     bool success = mSingleScenario->runScenarios( aPeriod, false, aTimer );
 
-    // Construct a solver which has an initial trial equal to the current tax.
-    const Modeltime* modeltime = getInternalScenario()->getModeltime();
-    int currYear = modeltime->getper_to_yr( aPeriod );
-    auto_ptr<ITargetSolver> solver;
-    /* Note that the following code is left commented out incase a user wanted
-     to use the bisection routine rather then the secant.
-     solver.reset( new Bisecter( aPolicyTarget,
-                       aTolerance,
-                       0,
-                       MAX_SOLVABLE_TAX, // Maximum tax
-                       aTaxes[ aPeriod ],
-                       4.0, // Note the hard coded value is the initial bracket interval
-                       currYear ) );*/
-    solver.reset( new Secanter( aPolicyTarget,
-                       aTolerance,
-                       aTaxes[ aPeriod ],
-                       aPolicyTarget->getStatus( currYear ),
-                       0.2, // Note the hard coded value is the initial percent change
-                            // for the second initial guess.
-                       currYear ) );
-
-    while( solver->getIterations() < aLimitIterations ){
-        pair<double, bool> trial = solver->getNextValue();
-        
-        // Check for solution.
-        if( trial.second ){
-            break;
-        }
-
+    // Run the scenario with the trial tax in the current period.
+    auto runTrial = [&]( const double aTrialTax ) {
         // Replace the current periods tax with the calculated tax.
         assert( static_cast<unsigned int>( aPeriod ) < aTaxes.size() );
-        aTaxes[ aPeriod ] = trial.first;
+        aTaxes[ aPeriod ] = aTrialTax;
 
         // Set the trial taxes.
         setTrialTaxes( aTaxes );
@@ -566,10 +593,67 @@ bool PolicyTargetRunner::solveFutureTarget( vector<double>& aTaxes,
         // Run the base scenario.
         // TODO: If the run failed to solve then the target status may be unreliable.
         logRunID();
-        success = mSingleScenario->runScenarios( aPeriod, false, aTimer );
+        return mSingleScenario->runScenarios( aPeriod, false, aTimer );
+    };
+
+    // Construct a solver which has an initial trial equal to the current tax.
+    const Modeltime* modeltime = getInternalScenario()->getModeltime();
+    int currYear = modeltime->getper_to_yr( aPeriod );
+    unsigned int iterations = 0;
+    if( mParallelTrials > 1 ) {
+        if( !solveWithParallelTrials( runTrial, aPolicyTarget, currYear, aTaxes[ aPeriod ],
+                                      aPolicyTarget->getStatus( currYear ), 0.2,
+                                      aLimitIterations, aTolerance, success, iterations ) )
+        {
+            return false;
+        }
     }
+    else {
+        auto_ptr<ITargetSolver> solver;
+        /* Note that the following code is left commented out incase a user wanted
+         to use the bisection routine rather then the secant.
+         solver.reset( new Bisecter( aPolicyTarget,
+                           aTolerance,
+                           0,
+                           MAX_SOLVABLE_TAX, // Maximum tax
+                           aTaxes[ aPeriod ],
+                           4.0, // Note the hard coded value is the initial bracket interval
+                           currYear ) );*/
+        if( mUseClimateSurrogate ) {
+            solver.reset( new ClimateSurrogateSolver( aPolicyTarget,
+                                                      getInternalScenario()->getClimateModel(),
+                                                      mTaxName,
+                                                      aPeriod,
+                                                      aTolerance,
+                                                      aTaxes[ aPeriod ],
+                                                      aPolicyTarget->getStatus( currYear ),
+                                                      0.2,
+                                                      currYear ) );
+        }
+        else {
+            solver.reset( new Secanter( aPolicyTarget,
+                               aTolerance,
+                               aTaxes[ aPeriod ],
+                               aPolicyTarget->getStatus( currYear ),
+                               0.2, // Note the hard coded value is the initial percent change
+                                    // for the second initial guess.
+                               currYear ) );
+        }
 
-    if( solver->getIterations() >= aLimitIterations ){
+        while( solver->getIterations() < aLimitIterations ){
+            pair<double, bool> trial = solver->getNextValue();
+            
+            // Check for solution.
+            if( trial.second ){
+                break;
+            }
+
+            success = runTrial( trial.first );
+        }
+        iterations = solver->getIterations();
+    }
+
+    if( iterations >= aLimitIterations ){
         targetLog.setLevel( ILogger::ERROR );
         targetLog << "Exiting target finding search as the iterations limit " 
                   << "was reached." << endl;
@@ -582,11 +666,91 @@ bool PolicyTargetRunner::solveFutureTarget( vector<double>& aTaxes,
     else {
         targetLog.setLevel( ILogger::NOTICE );
         targetLog << "Target value was found by search algorithm in "
-                  << solver->getIterations() << " iterations." << endl;
+                  << iterations << " iterations." << endl;
     }
     return success;
 }
 
+/*!
+ * \brief Solve a target by running several trials at once.
+ * \details Each iteration of a MultiPointBracketer gives a set of trial taxes
+ *          which are each run in a separate process started from the current
+ *          state of the scenario. Once the target is met the solution is run
+ *          again in this process so that the scenario is left in the solved
+ *          state, as it is when the trials are run one at a time.
+ * \param aRunTrial Function which sets up and runs the scenario at a trial tax
+ *        and returns whether the run solved.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \param aYear Year in which to check the target.
+ * \param aInitialTax The tax of the current state of the scenario.
+ * \param aInitialStatus The status of the target at the initial tax.
+ * \param aInitialTaxChange The percentage change from the initial tax for the
+ *        first trials.
+ * \param aLimitIterations The maximum number of iterations to perform.
+ * \param aTolerance The tolerance of the solution.
+ * \param aRunSuccess Set to whether the run of the solution solved.
+ * \param aIterations Set to the number of iterations performed.
+ * \return False if the taxes could not be evaluated, otherwise true.
+ */
+bool PolicyTargetRunner::solveWithParallelTrials( const function<bool( const double )>& aRunTrial,
+                                                  const ITarget* aPolicyTarget,
+                                                  const int aYear,
+                                                  const double aInitialTax,
+                                                  const double aInitialStatus,
+                                                  const double aInitialTaxChange,
+                                                  const unsigned int aLimitIterations,
+                                                  const double aTolerance,
+                                                  bool& aRunSuccess,
+                                                  unsigned int& aIterations )
+{
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    MultiPointBracketer solver( aTolerance, aInitialTax, aInitialStatus, aInitialTaxChange, mParallelTrials );
+    while( !solver.isSolved() && solver.getIterations() < aLimitIterations ) {
+        const vector<double>& trialTaxes = solver.getTrialPrices();
+        for( size_t i = 0; i < trialTaxes.size(); ++i ) {
+            if( !util::isValidNumber( trialTaxes[ i ] ) ) {
+                targetLog.setLevel( ILogger::ERROR );
+                targetLog << "Failed due to invalid trial price generated by solver." << endl;
+                return false;
+            }
+        }
+        targetLog.setLevel( ILogger::NOTICE );
+        targetLog << "Iteration " << solver.getIterations() << " running "
+                  << trialTaxes.size() << " trials at once." << endl;
+
+        const vector<ProcessPool::Result> results = ProcessPool::run( trialTaxes.size(), mParallelTrials, "target-trial",
+            [&]( const int aTrial, string& aOutput ) {
+                const bool runSuccess = aRunTrial( trialTaxes[ aTrial ] );
+                stringstream status;
+                status << setprecision( numeric_limits<double>::digits10 + 2 )
+                       << aPolicyTarget->getStatus( aYear );
+                aOutput = status.str();
+                return runSuccess;
+            } );
+
+        // Trials which did not complete are treated as those for which the
+        // status could not be calculated.
+        vector<double> statuses( trialTaxes.size(), numeric_limits<double>::quiet_NaN() );
+        for( size_t i = 0; i < results.size(); ++i ) {
+            istringstream status( results[ i ].mOutput );
+            if( results[ i ].mCompleted && !( status >> statuses[ i ] ) ) {
+                statuses[ i ] = numeric_limits<double>::quiet_NaN();
+            }
+            targetLog << "Trial value = " << trialTaxes[ i ] << " status = " << statuses[ i ] << endl;
+        }
+        solver.setTrialValues( statuses );
+    }
+    aIterations = solver.getIterations();
+
+    if( solver.isSolved() ) {
+        targetLog.setLevel( ILogger::NOTICE );
+        targetLog << "Running the solution " << solver.getSolution() << "." << endl;
+        aRunSuccess = aRunTrial( solver.getSolution() );
+    }
+    return true;
+}
+
 /*!
  * \brief Solve a target for a year past the target year skipping in-between model
  *        periods.
@@ -800,10 +964,19 @@ PolicyTargetRunner::calculateHotellingPath( const double aInitialTax,
  *        for each model period.
  */
 void PolicyTargetRunner::setTrialTaxes( const vector<double> aTaxes ) {
+    // After the first trial the tax already exists in every region so just
+    // update the tax path in place.
+    if( mHasSetTrialTaxes &&
+        mSingleScenario->getInternalScenario()->updateFixedTaxes( mTaxName, aTaxes ) )
+    {
+        return;
+    }
+
     // Set the fixed taxes into the world. The world will clone this tax object,
     // this object retains ownership of the original.
     GHGPolicy tax( mTaxName, "global", aTaxes );
     mSingleScenario->getInternalScenario()->setTax( &tax );
+    mHasSetTrialTaxes = true;
 }
 
 /*!
@@ -45,9 +45,11 @@
  */
 
 #include <string>
+#include <memory>
 #include <xercesc/dom/DOMNode.hpp>
 
 class Tabs;
+class CachedMarket;
 
 #include "technologies/include/ioutput.h"
 #include "util/base/include/value.h"
@@ -207,6 +209,10 @@ protected:
         //! the current region is assumed.
         DEFINE_VARIABLE( SIMPLE, "market-name", mMarketName, std::string )
     )
+    
+    //! A pre-located market which has been cached from the marketplace to add
+    //! supply to and get the price from.
+    std::auto_ptr<CachedMarket> mCachedMarket;
 };
 
 #endif // _FRACTIONAL_SECONDARY_OUTPUT_H_
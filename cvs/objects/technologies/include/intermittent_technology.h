@@ -51,6 +51,7 @@
 #include "sectors/include/ibackup_calculator.h"
 
 class IInfo;
+class CachedMarket;
 /*
  * \ingroup Objects
  * \brief A Technology which represents production from an intermittent
@@ -177,11 +178,24 @@ protected:
     
     //! Info object used to pass parameter information into backup calculators.
     std::auto_ptr<IInfo> mIntermittTechInfo;
+
+    //! The trial share market located in initCalc for fast access.
+    std::auto_ptr<CachedMarket> mTrialMarket;
+
+    //! Name of the good of the trial share market.
+    std::string mTrialMarketGoodName;
+
+    //! The electricity sector market located in initCalc for fast access.
+    std::auto_ptr<CachedMarket> mElectricMarket;
+
+    //! The resource market located in initCalc for fast access.
+    std::auto_ptr<CachedMarket> mResourceMarket;
     
     void copy( const IntermittentTechnology& aOther );
 
     void setCoefficients( const std::string& aRegionName,
                           const std::string& aSectorName,
+                          const BackupInputs& aInputs,
                           const int aPeriod );
 
     virtual double getResourceToEnergyRatio( const std::string& aRegionName,
@@ -192,24 +206,23 @@ protected:
                                              const std::string& aSectorName,
                                              const int aPeriod ) const;
 
-    double getMarginalBackupCapCost( const std::string& aRegionName,
-                                     const std::string& aSectorName,
-                                     const int aPeriod ) const;
+    double getMarginalBackupCapCost( const BackupInputs& aInputs ) const;
+
+    BackupInputs getBackupInputs( const std::string& aRegionName,
+                                  const int aPeriod ) const;
 
     void initializeInputLocations( const std::string& aRegionName,
                                    const std::string& aSectorName,
                                    const int aPeriod );
 
-    double getMarginalBackupCapacity( const std::string& aRegionName,
-                                      const std::string& aSectorName,
-                                      const int aPeriod ) const;
+    double getMarginalBackupCapacity( const BackupInputs& aInputs ) const;
 
-    double getAverageBackupCapacity( const std::string& aRegionName,
-                                     const std::string& aSectorName,
-                                     const int aPeriod ) const;
+    double getAverageBackupCapacity( const BackupInputs& aInputs ) const;
 
     double calcEnergyFromBackup() const;
 
+    virtual bool canReuseCost() const;
+
     virtual bool XMLDerivedClassParse( const std::string& aNodeName,
                                        const xercesc::DOMNode* aCurr );
 
@@ -58,6 +58,7 @@ class ILandAllocator;
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/iparsable.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/object_pool.h"
 
 // Need to forward declare the subclasses as well.
 class PrimaryOutput;
@@ -82,7 +83,7 @@ class GenericOutput;
 *          and quantity calculations.
 * \author Josh Lurz
 */
-class IOutput : public INamed, private boost::noncopyable {
+class IOutput : public INamed, public PooledObject, private boost::noncopyable {
 public:
     /*! 
      * \brief Constructor.
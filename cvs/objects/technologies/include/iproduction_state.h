@@ -104,6 +104,21 @@ public:
                                    const std::vector<IShutdownDecider*>& aShutdownDeciders,
                                    const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Do any calculations for the period which do not depend on
+     *        prices, before the Technology is calculated for the period.
+     * \param aRegionName Region name.
+     * \param aSectorName Sector name.
+     * \param aShutdownDeciders Set of objects responsible for determining how
+     *        much capital to depreciate or shutdown, which must be the same
+     *        as is passed to calcProduction.
+     * \param aPeriod Model period.
+     */
+    virtual void initCalc( const std::string& aRegionName,
+                           const std::string& aSectorName,
+                           const std::vector<IShutdownDecider*>& aShutdownDeciders,
+                           const int aPeriod ) = 0;
+
     /*
      * \brief Set the quantity of output in the initial period of the
      *        technology.
@@ -113,6 +113,17 @@ public:
                                      const int aInitialTechYear,
                                      const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Whether the coefficient depends on the profit rate of the
+     *        Technology.
+     * \details Coefficients which are not profit dependent depend only on the
+     *          age of the vintage in the period, and so are calculated once
+     *          per period by the production state rather than each time the
+     *          Technology is calculated.
+     * \return Whether the coefficient depends on the profit rate.
+     */
+    virtual bool isProfitDependent() const = 0;
+
     /*!
      * \brief Return a constant to represent a state where the profit rate has
      *        not yet been calculated.
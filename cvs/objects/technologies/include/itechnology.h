@@ -54,6 +54,7 @@
 #include "util/base/include/istandard_component.h"
 #include "util/base/include/value.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/object_pool.h"
 
 // Forward declaration
 class AGHG;
@@ -104,7 +105,7 @@ struct PreviousPeriodInfo {
 *
 * \author Pralit Patel
 */
-class ITechnology: public IYeared, public IParsedComponent, private boost::noncopyable
+class ITechnology: public IYeared, public IParsedComponent, public PooledObject, private boost::noncopyable
 {
 public:
     virtual ITechnology* clone() const = 0;
@@ -145,6 +146,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP* aGDP,
                               int aPeriod ) const = 0;
+
+    virtual bool getShareInputs( const GDP* aGDP,
+                                 const int aPeriod,
+                                 double& aShareWeight,
+                                 double& aCost,
+                                 double& aLogShareAdjustment ) const = 0;
     
     virtual void calcCost( const std::string& aRegionName,
                            const std::string& aSectorName,
@@ -45,6 +45,8 @@
  * \author Pralit Patel
  */
 
+#include <vector>
+#include <utility>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
@@ -157,9 +159,11 @@ public:
      */
     virtual const ITechnology* getNewVintageTechnology( const int aPeriod ) const = 0;
     
-    // Typedef some iterators to abstract away syntax
-    typedef std::map<int, ITechnology*>::const_reverse_iterator CTechRangeIterator;
-    typedef std::map<int, ITechnology*>::reverse_iterator TechRangeIterator;
+    // Typedef some iterators to abstract away syntax.  The vintages are iterated
+    // over as a contiguous list of year and technology pairs ordered by year.
+    typedef std::vector<std::pair<int, ITechnology*> > VintageList;
+    typedef VintageList::const_reverse_iterator CTechRangeIterator;
+    typedef VintageList::reverse_iterator TechRangeIterator;
     
     /*!
      * \brief Get an iterator which can be used to iterate over all potentially
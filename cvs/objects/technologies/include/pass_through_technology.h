@@ -44,7 +44,9 @@
  * \author Pralit Patel
  */
 class IVisitor;
+class CachedMarket;
 
+#include <memory>
 #include "technologies/include/technology.h"
 
 /*!
@@ -76,6 +78,13 @@ public:
                                const IInfo* aSubsectorIInfo,
                                ILandAllocator* aLandAllocator );
 
+    virtual void initCalc( const std::string& aRegionName,
+                           const std::string& aSectorName,
+                           const IInfo* aSubsectorInfo,
+                           const Demographic* aDemographics,
+                           PreviousPeriodInfo& aPrevPeriodInfo,
+                           const int aPeriod );
+
     virtual void production( const std::string& aRegionName,
                              const std::string& aSectorName,
                              double aVariableDemand,
@@ -113,6 +122,13 @@ protected:
         DEFINE_VARIABLE( SIMPLE | STATE, "pass-through-fixed-output", mPassThroughFixedOutput, Value )
     )
     
+    //! The name of the market which holds the fixed output of mPassThroughSectorName.
+    std::string mFixedOutputMarketName;
+
+    //! The market which holds the fixed output for the current period, located
+    //! in initCalc.
+    std::auto_ptr<CachedMarket> mFixedOutputMarket;
+
     void copy( const PassThroughTechnology& aOther );
 };
 
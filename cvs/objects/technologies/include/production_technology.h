@@ -57,6 +57,7 @@ class MoreSectorInfo;
 class IVisitor;
 class IExpectedProfitRateCalculator;
 class IShutdownDecider;
+class ProfitShutdownDecider;
 
 /*! 
  * \ingroup Objects
@@ -218,6 +219,10 @@ private:
     //! The period for which all cached values stored in mCachedValues are valid for.
     int mValidCachePeriod;
 
+    //! The period in which this vintage was new investment, from which old
+    //! vintages are shutdown.
+    int mNewVintagePeriod;
+
     int lifeTime; //!< nameplate lifetime of the technology
     int delayedInvestTime; //!< number of years between initial investment and first operation
     int maxLifeTime; //!< maximum allowable lifetime
@@ -240,6 +245,8 @@ private:
     double calcShutdownCoef( const std::string& aRegionName,
                              const std::string& aSectorName,
                              const int aPeriod ) const;
+
+    static const ProfitShutdownDecider& getShutdownDecider();
 };
 
 /*! \brief Return whether a technology is available to go online.
@@ -106,6 +106,8 @@ public:
                                      const std::string& aSectorName,
                                      const int aInitialTechYear,
                                      const int aPeriod ) const;
+
+    virtual bool isProfitDependent() const;
 protected:
     ProfitShutdownDecider();
     
@@ -130,6 +132,10 @@ protected:
         //! Parameter for profitRate at which 50% of is shutdown.
         DEFINE_VARIABLE( SIMPLE, "median-shutdown-point", mMedianShutdownPoint, double )
     )
+
+    //! (median-shutdown-point + 1)^steepness, which only changes when the
+    //! parameters are parsed.
+    double mMidPointToSteepness;
 };
 
 #endif // _PROFIT_SHUTDOWN_DECIDER_H_
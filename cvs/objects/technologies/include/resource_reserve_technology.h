@@ -143,6 +143,12 @@ protected:
         //! by each model period.
         DEFINE_VARIABLE( ARRAY, "cumulative-production", mCumulProd, objects::TechVintageVector<Value> ),
         
+        //! The annual production each period is limited to by the buildup and
+        //! decline phases and by the remaining reserve.  This only depends on
+        //! production in earlier periods so it is set in postCalc for the next
+        //! period rather than when that period is calculated.
+        DEFINE_VARIABLE( ARRAY, "depletion-output", mDepletionOutput, objects::TechVintageVector<Value> ),
+        
         //! A parameter which can phase in annual production over the given number of years.
         DEFINE_VARIABLE( SIMPLE, "buildup-years", mBuildupYears, int ),
     
@@ -156,6 +162,7 @@ protected:
 	virtual const std::string& getXMLName() const;
     void copy( const ResourceReserveTechnology& aOther );
     virtual void setProductionState( const int aPeriod );
+    double calcDepletionOutput( const int aPeriod ) const;
 };
 
 #endif // _RESOURCE_RESERVE_TECHNOLOGY_H_
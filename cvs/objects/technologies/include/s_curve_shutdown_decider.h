@@ -103,6 +103,8 @@ public:
                                      const std::string& aSectorName,
                                      const int aInstallationYear,
                                      const int aPeriod ) const;
+
+    virtual bool isProfitDependent() const;
 protected:
     
     // Define data such that introspection utilities can process the data from this
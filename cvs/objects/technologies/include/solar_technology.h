@@ -236,6 +236,17 @@ protected :
        DEFINE_VARIABLE( SIMPLE, "no-sun-days", mNoSunDays, double )
     )
     
+    //! Total annual irradiance of the resource in mIrradiancePeriod.
+    double mTotalAnnualIrradiance;
+
+    //! The outage fraction used to amortize the costs, which is fixed.
+    double mOutageFraction;
+
+    //! The period for which mTotalAnnualIrradiance was looked up.
+    int mIrradiancePeriod;
+
+    double getTotalAnnualIrradiance( const std::string& aRegionName, const int aPeriod );
+
     void copy( const SolarTechnology& aOther );
 
    virtual const std::string& getTechCostName( ) const;
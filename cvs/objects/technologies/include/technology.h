@@ -55,8 +55,10 @@
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/value.h"
 #include "functions/include/ifunction.h" // For TechChange struct.
+#include "functions/include/minicam_leontief_production_function.h"
 #include "technologies/include/itechnology.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/market_price_stamps.h"
 
 // Forward declaration
 class AGHG;
@@ -196,6 +198,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP* aGDP,
                               int aPeriod ) const;
+
+    virtual bool getShareInputs( const GDP* aGDP,
+                                 const int aPeriod,
+                                 double& aShareWeight,
+                                 double& aCost,
+                                 double& aLogShareAdjustment ) const;
     
     virtual void calcCost( const std::string& aRegionName,
                            const std::string& aSectorName,
@@ -354,10 +362,18 @@ protected:
     //! Production function for the technology.
     const IFunction* mProductionFunction;
 
+    //! The inputs tagged with their types if the production function is the
+    //! MiniCAM Leontief function, used to avoid virtual calls to the inputs.
+    MinicamLeontiefProductionFunction::TypedInputs mTypedInputs;
+
     //! The current marginal revenue.  TODO: cleaner solution for getting
     //! this information to the profit shutdown decider.
     mutable double mMarginalRevenue;
 
+    //! The last cost calculated along with the market prices it was calculated
+    //! from so that it can be reused until one of them changes.
+    MarketPriceStamps mCostPriceStamps;
+
     static double getFixedOutputDefault();
 
     virtual void setProductionState( const int aPeriod );
@@ -381,6 +397,8 @@ protected:
     virtual double calcSecondaryValue( const std::string& aRegionName,
                                        const int aPeriod ) const;
 
+    virtual bool canReuseCost() const;
+
     bool hasNoInputOrOutput( const int aPeriod ) const;
 
     virtual const IFunction* getProductionFunction() const;
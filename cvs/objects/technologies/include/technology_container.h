@@ -176,6 +176,10 @@ private:
     //! map will not necessarily be addressed by this vector.
     objects::PeriodVector<ITechnology*> mVintagesByPeriod;
     
+    //! The technologies in mVintages copied into a contiguous list so that
+    //! iterating over the vintages of a period does not have to walk the map.
+    VintageList mVintageList;
+    
     // Some typedefs to make using interpolation rules more readable.
     typedef std::vector<InterpolationRule*>::const_iterator CInterpRuleIterator;
     
@@ -183,13 +187,15 @@ private:
     //! the operating technologies in that period.
     int mCachedVintageRangePeriod;
 
-    //! The cached begin iterator returned in getVintageBegin if the period matches
-    //! mCachedVintageRangePeriod.
-    TechRangeIterator mCachedTechRangeBegin;
-
-    //! The cached begin iterator returned in getVintageEnd if the period matches
-    //! mCachedVintageRangePeriod.
-    TechRangeIterator mCachedTechRangeEnd;
+    //! The vintages iterated over by getVintageBegin and getVintageEnd if the
+    //! period matches mCachedVintageRangePeriod.  These are the most recent
+    //! vintage, which is always included, followed by the vintages which are
+    //! operating in that period so that retired vintages are skipped entirely.
+    VintageList mActiveVintages;
+    
+    //! The last period the run will calculate if interpolated vintages after it
+    //! were not created, otherwise -1.
+    int mLastVintagePeriod;
     
     bool createAndParseVintage( const xercesc::DOMNode* aNode, const std::string& aTechType );
     
@@ -198,6 +204,8 @@ private:
     void clearInterpolationRules();
     
     void interpolateVintage( const int aYear, CVintageIterator aPrevTech, CVintageIterator aNextTech );
+    
+    void updateVintageList();
 };
 
 #endif // _TECHNOLOGY_CONTAINER_H_
@@ -74,6 +74,11 @@ public:
                                    const std::vector<IShutdownDecider*>& aShutdownDeciders,
                                    const int aPeriod ) const;
 
+    virtual void initCalc( const std::string& aRegionName,
+                           const std::string& aSectorName,
+                           const std::vector<IShutdownDecider*>& aShutdownDeciders,
+                           const int aPeriod );
+
     virtual void setBaseOutput( const double aBaseOutput,
                                 const int aBaseYear );
 
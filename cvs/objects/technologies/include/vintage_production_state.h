@@ -79,6 +79,11 @@ public:
                                    const std::vector<IShutdownDecider*>& aShutdownDeciders,
                                    const int aPeriod ) const;
 
+    virtual void initCalc( const std::string& aRegionName,
+                           const std::string& aSectorName,
+                           const std::vector<IShutdownDecider*>& aShutdownDeciders,
+                           const int aPeriod );
+
     virtual void setBaseOutput( const double aBaseOutput,
                                 const int aBaseYear );
 
@@ -100,6 +105,17 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "initial-year", mInitialYear, int )
     )
 
+    //! The period for which mAgeShutdownCoef was calculated, or -1 if it
+    //! has not been.
+    int mAgeShutdownPeriod;
+
+    //! The product of the coefficients of the shutdown deciders which only
+    //! depend on the age of the vintage, calculated in initCalc.
+    double mAgeShutdownCoef;
+
+    //! Whether any of the shutdown deciders depend on the profit rate.
+    bool mHasProfitShutdown;
+
     /*
      * \brief Get the static name of this object.
      * \return The static name of this object.
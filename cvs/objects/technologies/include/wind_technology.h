@@ -272,6 +272,12 @@ protected :
     
    //! Wind Power Variance
    mutable double mWindPowerVariance;
+
+   //! The period for which mRealizedTurbineOutput, mWindCapacityFactor and
+   //! mWindPowerVariance were calculated.
+   int mTurbineOutputPeriod;
+
+   void calcWindCapacityFactor( const std::string& aRegionName, const int aPeriod );
     
     void copy( const WindTechnology& aOther );
 
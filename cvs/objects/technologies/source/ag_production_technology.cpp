@@ -243,7 +243,9 @@ void AgProductionTechnology::initCalc( const string& aRegionName,
     // If yield is GCal/kHa and prices are $/GCal, then rental rate is $/kHa
     // And this is what is now passed in ($/kHa)
     double profitRate = calcProfitRate( aRegionName, aSectorName, aPeriod );
-    mLandAllocator->setProfitRate( aRegionName, mName, profitRate, aPeriod );
+    if( mProductLeaf ) {
+        mProductLeaf->setProfitRate( aRegionName, mName, profitRate, aPeriod );
+    }
 
     // TODO: it may be useful to inform the solver about the minimum price required
     // to have some supply however we can not know that information for sure due to
@@ -260,7 +262,16 @@ void AgProductionTechnology::completeInit( const std::string& aRegionName,
 {
     // Store away the land allocator.
     mLandAllocator = aLandAllocator;
+    // Resolve the land leaf once so that the profit rate and land allocation
+    // which are exchanged every iteration do not need to search the land
+    // allocator by name.
     mProductLeaf = aLandAllocator->findProductLeaf( mName );
+    if( !mProductLeaf ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not find a land leaf for " << mName
+                << " in region " << aRegionName << "." << endl;
+    }
  
     // Send "pointer to the land allocator" to each of the secondary outputs, e.g, residue biomass
     if ( mOutputs.size() ) {
@@ -386,6 +397,16 @@ double AgProductionTechnology::calcShare( const IDiscreteChoice* aChoiceFn,
     return 0.0;
 }
 
+bool AgProductionTechnology::getShareInputs( const GDP* aGDP,
+                                             const int aPeriod,
+                                             double& aShareWeight,
+                                             double& aCost,
+                                             double& aLogShareAdjustment ) const
+{
+    // The share is not from the discrete choice function, see calcShare.
+    return false;
+}
+
 
 /* agTechnologies are not shared on cost, so this calCost method is overwritten
    by a calculation of technology profit which is passed to the land allocator
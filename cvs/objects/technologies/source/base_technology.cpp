@@ -292,7 +292,7 @@ void BaseTechnology::initCalc( const MoreSectorInfo* aMoreSectorInfo, const stri
                                const Demographic* aDemographics, const double aCapitalStock, const int aPeriod )
 {
     for( CGHGIterator ghg = mGhgs.begin(); ghg != mGhgs.end(); ++ghg ){
-        (*ghg)->initCalc( aRegionName, 0, aPeriod );
+        (*ghg)->initCalc( aRegionName, mLeafInputs, 0, aPeriod );
     }
     
     // Initialize the inputs.
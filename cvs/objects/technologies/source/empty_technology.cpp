@@ -113,6 +113,19 @@ double EmptyTechnology::calcShare( const IDiscreteChoice* aChoiceFn,
     return -numeric_limits<double>::infinity();
 }
 
+bool EmptyTechnology::getShareInputs( const GDP* aGDP,
+                                      const int aPeriod,
+                                      double& aShareWeight,
+                                      double& aCost,
+                                      double& aLogShareAdjustment ) const
+{
+    // No share is signaled by a zero share weight.
+    aShareWeight = 0.0;
+    aCost = 0.0;
+    aLogShareAdjustment = 0.0;
+    return true;
+}
+
 double EmptyTechnology::getFixedOutput( const string& aRegionName,
                                   const string& aSectorName,
                                   const bool aHasRequiredInput,
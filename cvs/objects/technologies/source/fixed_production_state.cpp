@@ -91,6 +91,13 @@ double FixedProductionState::calcProduction( const string& aRegionName,
     return mFixedOutput * aFixedOutputScaleFactor;
 }
 
+void FixedProductionState::initCalc( const string& aRegionName,
+                                     const string& aSectorName,
+                                     const vector<IShutdownDecider*>& aShutdownDeciders,
+                                     const int aPeriod )
+{
+}
+
 void FixedProductionState::setBaseOutput( const double aBaseOutput, const int aBaseYear ){
     assert( aBaseOutput >= 0 );
     mFixedOutput.set( aBaseOutput );
@@ -58,6 +58,7 @@
 #include "functions/include/non_energy_input.h"
 #include "technologies/include/iproduction_state.h"
 #include "containers/include/market_dependency_finder.h"
+#include "marketplace/include/cached_market.h"
 
 using namespace std;
 using namespace xercesc;
@@ -313,6 +314,18 @@ void IntermittentTechnology::initCalc( const string& aRegionName,
                                               aRegionName, 0, 1, aPeriod );
     }
     initializeInputLocations( aRegionName, aSectorName, aPeriod );
+
+    // Locate the markets the backup calculation reads each iteration so that
+    // the trial values do not need to be searched for by name.
+    Marketplace* marketplace = scenario->getMarketplace();
+    mTrialMarketGoodName = SectorUtils::getTrialMarketName( mTrialMarketName );
+    if( mBackupCalculator ) {
+        mTrialMarket = marketplace->locateMarket( mTrialMarketGoodName, aRegionName, aPeriod );
+    }
+    mElectricMarket = marketplace->locateMarket( mElectricSectorName, mElectricSectorMarket, aPeriod );
+    if( mResourceInput != mInputs.end() ) {
+        mResourceMarket = marketplace->locateMarket( ( *mResourceInput )->getName(), aRegionName, aPeriod );
+    }
 }
 
 void IntermittentTechnology::postCalc( const string& aRegionName,
@@ -344,7 +357,9 @@ void IntermittentTechnology::production( const string& aRegionName,
     
     // For the trial intermittent technology market, set the trial supply amount to
     // the ratio of intermittent-technology output to the electricity output.
-    double dependentSectorOutput = scenario->getMarketplace()->getDemand( mElectricSectorName, mElectricSectorMarket, aPeriod );
+    double dependentSectorOutput = mElectricMarket.get() && mElectricMarket->isForPeriod( aPeriod ) ?
+        mElectricMarket->getDemand( mElectricSectorName, mElectricSectorMarket, aPeriod ) :
+        scenario->getMarketplace()->getDemand( mElectricSectorName, mElectricSectorMarket, aPeriod );
 
     if ( dependentSectorOutput > 0 ){
         mIntermitOutTechRatio = std::min( getOutput( aPeriod ) / dependentSectorOutput, 1.0 );
@@ -361,18 +376,19 @@ void IntermittentTechnology::production( const string& aRegionName,
 /*! \brief Set tech shares based on backup energy needs for an intermittent
 *          resource.
 * \author Marshall Wise
+* \param aInputs The trial values the backup depends on.
 * \param aPeriod Model period.
 */
 void IntermittentTechnology::setCoefficients( const string& aRegionName,
                                               const string& aSectorName,
+                                              const BackupInputs& aInputs,
                                               const int aPeriod )
 {
     // Convert backup capacity per unit of resource energy to energy required
     // (in EJ) per unit of resource energy (in EJ) using backup capacity factor.
     // Based on average backup capacity as this is multiplied by sector output
     // to get total backup electricity.
-    double backupEnergyFraction = getAverageBackupCapacity( aRegionName, aSectorName,
-                                  aPeriod ) * calcEnergyFromBackup();
+    double backupEnergyFraction = getAverageBackupCapacity( aInputs ) * calcEnergyFromBackup();
 
     /*! \invariant Backup energy fraction must be positive. */
     assert( util::isValidNumber( backupEnergyFraction ) &&
@@ -421,14 +437,18 @@ void IntermittentTechnology::calcCost( const string& aRegionName,
                                        const string& aSectorName,
                                        const int aPeriod )
 {
+    // Read the trial values once and share them between the marginal and
+    // average backup calculations.
+    const BackupInputs inputs = getBackupInputs( aRegionName, aPeriod );
+
     // Set marginal cost for backup to the input object set asside for this
     ( *mBackupCapCostInput )->setPrice( aRegionName, 
-                              getMarginalBackupCapCost( aRegionName, mTrialMarketName, aPeriod ), 
+                              getMarginalBackupCapCost( inputs ), 
                               aPeriod );
    
     // Set the coefficients for energy and backup in the production function.
     // Must call this after costs for backup capital and technology have been set.
-    setCoefficients( aRegionName, mTrialMarketName, aPeriod );
+    setCoefficients( aRegionName, mTrialMarketName, inputs, aPeriod );
 
     // Calculate the base technology cost. This will use the standard leontief
     // production function with updated coefficients for the fuel and the
@@ -436,21 +456,67 @@ void IntermittentTechnology::calcCost( const string& aRegionName,
     Technology::calcCost( aRegionName, aSectorName, aPeriod );
 }
 
+/*!
+ * \brief Intermittent technologies set the backup cost and coefficients of
+ *        their inputs from the trial values before each cost calculation so the
+ *        cost can not be reused when market prices are unchanged.
+ * \return False.
+ */
+bool IntermittentTechnology::canReuseCost() const {
+    return false;
+}
+
+/*!
+ * \brief Get the trial values the backup calculation depends on.
+ * \details Reads the trial share and resource variance through the markets
+ *          located in initCalc, falling back to searching the marketplace if
+ *          they were located for a different period.
+ * \param aRegionName Region name.
+ * \param aPeriod Model period.
+ * \return The trial share, -1 if there is no trial market, and the resource
+ *         variance.
+ */
+BackupInputs IntermittentTechnology::getBackupInputs( const string& aRegionName,
+                                                      const int aPeriod ) const
+{
+    BackupInputs inputs;
+    // Market is not created yet in period 0.
+    inputs.mTrialShare = -1;
+    if( mBackupCalculator && aPeriod > 0 ) {
+        double trialPrice = mTrialMarket.get() && mTrialMarket->isForPeriod( aPeriod ) ?
+            mTrialMarket->getPrice( mTrialMarketGoodName, aRegionName, aPeriod, false ) :
+            scenario->getMarketplace()->getPrice( mTrialMarketGoodName, aRegionName, aPeriod, false );
+        if( trialPrice != Marketplace::NO_MARKET_PRICE ) {
+            inputs.mTrialShare = max( trialPrice, 0.0 );
+        }
+    }
+
+    inputs.mResourceVariance = 0;
+    if( mResourceInput != mInputs.end() ) {
+        const string& resourceName = ( *mResourceInput )->getName();
+        const IInfo* resourceInfo = mResourceMarket.get() && mResourceMarket->isForPeriod( aPeriod ) ?
+            mResourceMarket->getMarketInfo( resourceName, aRegionName, aPeriod, false ) :
+            scenario->getMarketplace()->getMarketInfo( resourceName, aRegionName, aPeriod, false );
+        if( resourceInfo ) {
+            inputs.mResourceVariance = resourceInfo->getDouble( "resourceVariance", true );
+        }
+    }
+
+    assert( inputs.mResourceVariance >= 0 );
+    return inputs;
+}
+
 /*! \brief Returns marginal cost for backup capacity
 * \author Marshall Wise, Steve Smith
-* \param aSectorName Sector name.
-* \param aRegionName Region name.
-* \param aPeriod Model period.
+* \param aInputs The trial values the backup depends on.
 */
-double IntermittentTechnology::getMarginalBackupCapCost( const string& aRegionName,
-                                                         const string& aSectorName,
-                                                         const int aPeriod ) const
+double IntermittentTechnology::getMarginalBackupCapCost( const BackupInputs& aInputs ) const
 {
     // Add per unit cost of backup capacity to subsector price backup capacity
     // is in GW/EJ, so have to convert to kW/GJ (multiply numerator by 1E6 and
     // denominator by 1E9 to get * 1/1000) to make consistent with market price
     // which is in $/GJ. BackupCost is in $/kw/yr.
-    double backupCost = getMarginalBackupCapacity( aRegionName, aSectorName, aPeriod )
+    double backupCost = getMarginalBackupCapacity( aInputs )
                         / 1000 * mBackupCapitalCost;   
    return backupCost;
 }
@@ -461,18 +527,14 @@ double IntermittentTechnology::getMarginalBackupCapCost( const string& aRegionNa
  *          capacity per unit output. If a backup calculator was not read-in,
  *          this is assumed to be zero. 
  * \author Marshall Wise, Steve Smith, Sonny Kim
- * \param aPeriod Model period.
+ * \param aInputs The trial values the backup depends on.
  * \return Marginal backup capacity per unit of energy output.
  */
-double IntermittentTechnology::getMarginalBackupCapacity( const string& aRegionName,
-                                                          const string& aSectorName,
-                                                          const int aPeriod ) const {
+double IntermittentTechnology::getMarginalBackupCapacity( const BackupInputs& aInputs ) const {
     double backupCapacity = 0;
     if( mBackupCalculator && mResourceInput != mInputs.end() ){
-        const string& resourceName = ( *mResourceInput )->getName();
-        backupCapacity = mBackupCalculator->getMarginalBackupCapacity( aSectorName,
-                         mElectricSectorName, resourceName, aRegionName,
-                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor, aPeriod );
+        backupCapacity = mBackupCalculator->getMarginalBackupCapacity( aInputs,
+                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor );
     }
 
     /*! \post Backup capacity is a valid number and positive. */
@@ -487,19 +549,15 @@ double IntermittentTechnology::getMarginalBackupCapacity( const string& aRegionN
  *          capacity per unit output. If a backup calculator was not read-in,
  *          this is assumed to be zero.
  * \author Marshall Wise, Steve Smith, Sonny Kim
- * \param aPeriod Model period.
+ * \param aInputs The trial values the backup depends on.
  * \return Average backup capacity per unit output.
  */
-double IntermittentTechnology::getAverageBackupCapacity( const string& aRegionName,
-                                                         const string& aSectorName,
-                                                         const int aPeriod ) const
+double IntermittentTechnology::getAverageBackupCapacity( const BackupInputs& aInputs ) const
 {
     double backupCapacity = 0;
     if( mBackupCalculator ){
-        const string& resourceName = ( *mResourceInput )->getName();
-        backupCapacity = mBackupCalculator->getAverageBackupCapacity( aSectorName,
-                         mElectricSectorName, resourceName, aRegionName,
-                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor, aPeriod );
+        backupCapacity = mBackupCalculator->getAverageBackupCapacity( aInputs,
+                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor );
     }
 
     /*! \post Backup capacity is a valid number and positive. */
@@ -45,6 +45,8 @@
 #include "technologies/include/pass_through_technology.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
+#include "sectors/include/pass_through_sector.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/xml_helper.h"
 #include "containers/include/market_dependency_finder.h"
@@ -74,6 +76,7 @@ void PassThroughTechnology::copy( const PassThroughTechnology& aOther ) {
     mPassThroughSectorName = aOther.mPassThroughSectorName;
     mPassThroughMarketName = aOther.mPassThroughMarketName;
     mPassThroughFixedOutput = aOther.mPassThroughFixedOutput;
+    mFixedOutputMarketName = aOther.mFixedOutputMarketName;
 }
 
 const string& PassThroughTechnology::getXMLNameStatic() {
@@ -124,7 +127,8 @@ void PassThroughTechnology::completeInit( const string& aRegionName,
 
     // Add dependencies for a calc item to gather up the fixed demands from this
     // pass through sector and make that available for the downstream sector
-    const string fixedDemandActivityName = mPassThroughSectorName + "-fixed-output";
+    mFixedOutputMarketName = PassThroughSector::getFixedOutputMarketName( mPassThroughSectorName );
+    const string& fixedDemandActivityName = mFixedOutputMarketName;
     MarketDependencyFinder* depFinder = scenario->getMarketplace()->getDependencyFinder();
 
     // Ensure we gather the fixed demands after we calculate prices / before we
@@ -132,6 +136,20 @@ void PassThroughTechnology::completeInit( const string& aRegionName,
     depFinder->addDependency( fixedDemandActivityName, mPassThroughMarketName, aSectorName, aRegionName );
 }
 
+void PassThroughTechnology::initCalc( const string& aRegionName,
+                                      const string& aSectorName,
+                                      const IInfo* aSubsectorInfo,
+                                      const Demographic* aDemographics,
+                                      PreviousPeriodInfo& aPrevPeriodInfo,
+                                      const int aPeriod )
+{
+    Technology::initCalc( aRegionName, aSectorName, aSubsectorInfo, aDemographics, aPrevPeriodInfo, aPeriod );
+
+    // Locate the market with the fixed output so that each model evaluation does
+    // not need to search for it by name.
+    mFixedOutputMarket = scenario->getMarketplace()->locateMarket( mFixedOutputMarketName, mPassThroughMarketName, aPeriod );
+}
+
 void PassThroughTechnology::production( const string& aRegionName,
                                         const string& aSectorName,
                                         double aVariableDemand,
@@ -154,8 +172,12 @@ double PassThroughTechnology::getFixedOutput( const string& aRegionName,
 {
     // Retrieve the fixed output from the pass-through sector which will store this
     // information in a unsolved trial market.
-    const string fixedDemandActivityName = mPassThroughSectorName + "-fixed-output";
-    const_cast<PassThroughTechnology*>( this )->mPassThroughFixedOutput = scenario->getMarketplace()->getPrice( fixedDemandActivityName, mPassThroughMarketName, aPeriod );
+    // Use the cached market during the calculation of the current period, other
+    // periods (i.e. reporting) need to go through the marketplace.
+    const_cast<PassThroughTechnology*>( this )->mPassThroughFixedOutput =
+        mFixedOutputMarket.get() && mFixedOutputMarket->isForPeriod( aPeriod ) ?
+        mFixedOutputMarket->getPrice( mFixedOutputMarketName, mPassThroughMarketName, aPeriod ) :
+        scenario->getMarketplace()->getPrice( mFixedOutputMarketName, mPassThroughMarketName, aPeriod );
     return mPassThroughFixedOutput;
 }
 
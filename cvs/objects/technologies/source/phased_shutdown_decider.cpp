@@ -140,6 +140,10 @@ void PhasedShutdownDecider::toDebugXML( const int aPeriod,
     XMLWriteClosingTag( getXMLNameStatic(), aOut, aTabs );
 }
 
+bool PhasedShutdownDecider::isProfitDependent() const {
+    return false;
+}
+
 double PhasedShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aFuncInfo,
                                                 const double aCalculatedProfitRate,
                                                 const string& aRegionName,
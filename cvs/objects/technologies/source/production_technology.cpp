@@ -92,6 +92,7 @@ ProductionTechnology::ProductionTechnology() {
     mFixedInvestment = -1;
     mParentTechType = 0;
     mValidCachePeriod = -1;
+    mNewVintagePeriod = -1;
 }
 
 //! Destructor
@@ -232,6 +233,9 @@ void ProductionTechnology::initCalc( const MoreSectorInfo* aMoreSectorInfo, cons
     mCachedValues[ AVAILABLE ] = calcIsAvailable( aPeriod );
     mCachedValues[ RETIRED ] = calcIsRetired( aPeriod );
     mCachedValues[ NEW_INVESTMENT ] = calcIsNewInvestment( aPeriod );
+    const Modeltime* modelTime = scenario->getModeltime();
+    mNewVintagePeriod = year <= modelTime->getStartYear() ? modelTime->getBasePeriod() :
+        modelTime->getyr_to_per( year );
 
     // calculate coefficients in the base period for techs that are the initial year
     if ( aPeriod == BASE_PERIOD && isInitialYear() ) {
@@ -352,9 +356,7 @@ void ProductionTechnology::operate( NationalAccount& aNationalAccount, const Dem
                 double shutdownCoef = calcShutdownCoef( aRegionName, aSectorName, aPeriod );
                 // need to shutdown from the maximum capacity which can be found from the
                 // output of the new investment year
-                int newVintagePeriod = year <= modelTime->getStartYear() ? modelTime->getBasePeriod() :
-                    modelTime->getyr_to_per( year );
-                primaryOutput = mOutputs[ 0 ]->getPhysicalOutput( newVintagePeriod ) * shutdownCoef;
+                primaryOutput = mOutputs[ 0 ]->getPhysicalOutput( mNewVintagePeriod ) * shutdownCoef;
             }
             assert( primaryOutput >= 0 );
             
@@ -874,24 +876,12 @@ double ProductionTechnology::calcShutdownCoef( const string& aRegionName,
     }
     mNestedInputRoot->setPricePaid( mNestedInputRoot->getPricePaid( aRegionName, aPeriod )
         - outputEmissTaxAdj, aPeriod );
-    // Could optimize by storing the shutdown coef.
     // Create the structure of info for the production function.
     // TODO: figure out what I want to do about this
     ProductionFunctionInfo prodFunc = { mLeafInputs, mNestedInputRoot->getFunction(), 0,
         mNestedInputRoot->getCoefficient( aPeriod ), mCapitalStock, mNestedInputRoot };
 
-    // Create a new shutdown decider.
-    // TODO: this should be a member of the class so that the user can override the
-    // paramaters from XML
-    ProfitShutdownDecider shutdownDecider;
-    // TODO: these parameters are arbitrary
-    // allow 100% shutdown
-    shutdownDecider.mMaxShutdown = 1;
-    // 50% shutdown when variable costs are above price recieved by 20%
-    shutdownDecider.mMedianShutdownPoint = -0.2;
-    // tuning parameter for how quickly we shutdown
-    shutdownDecider.mSteepness = 10;
-    double shutdownCoef = shutdownDecider.calcShutdownCoef( &prodFunc,
+    double shutdownCoef = getShutdownDecider().calcShutdownCoef( &prodFunc,
                                                             IShutdownDecider::getUncalculatedProfitRateConstant(), 
                                                             aRegionName,
                                                             aSectorName,
@@ -900,6 +890,30 @@ double ProductionTechnology::calcShutdownCoef( const string& aRegionName,
     return shutdownCoef;
 }
 
+/*! \brief Get the shutdown decider used for old vintages.
+* \details The decider has the same parameters for every vintage so it is only
+*          created once rather than for each vintage in every iteration.
+* \return The shutdown decider.
+*/
+const ProfitShutdownDecider& ProductionTechnology::getShutdownDecider() {
+    // TODO: this should be a member of the class so that the user can override the
+    // paramaters from XML
+    struct DeciderInit {
+        ProfitShutdownDecider mDecider;
+        DeciderInit() {
+            // TODO: these parameters are arbitrary
+            // allow 100% shutdown
+            mDecider.mMaxShutdown = 1;
+            // 50% shutdown when variable costs are above price recieved by 20%
+            mDecider.mMedianShutdownPoint = -0.2;
+            // tuning parameter for how quickly we shutdown
+            mDecider.mSteepness = 10;
+        }
+    };
+    static const DeciderInit sInit;
+    return sInit.mDecider;
+}
+
 /*! \brief Calculate dynamically whether a technology is new investment for the
 *          current period.
 * \param aPeriod The current period.
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <cmath>
 #include "technologies/include/profit_shutdown_decider.h"
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -57,6 +58,7 @@ ProfitShutdownDecider::ProfitShutdownDecider()
     mMaxShutdown = 1.0;
     mSteepness = 6.0;
     mMedianShutdownPoint = -0.1;
+    mMidPointToSteepness = pow( mMedianShutdownPoint + 1, mSteepness );
 }
 
 ProfitShutdownDecider::~ProfitShutdownDecider() {
@@ -73,6 +75,7 @@ void ProfitShutdownDecider::copy( const ProfitShutdownDecider& aOther ) {
     mMaxShutdown = aOther.mMaxShutdown;
     mSteepness = aOther.mSteepness;
     mMedianShutdownPoint = aOther.mMedianShutdownPoint;
+    mMidPointToSteepness = aOther.mMidPointToSteepness;
 }
 
 bool ProfitShutdownDecider::isSameType( const std::string& aType ) const {
@@ -133,6 +136,7 @@ bool ProfitShutdownDecider::XMLParse( const xercesc::DOMNode* node ){
                     << getXMLNameStatic() << endl;
         }
     }
+    mMidPointToSteepness = pow( mMedianShutdownPoint + 1, mSteepness );
     
     return true;
 }
@@ -145,6 +149,10 @@ void ProfitShutdownDecider::toDebugXML( const int aPeriod, ostream& aOut, Tabs*
     XMLWriteClosingTag( getXMLNameStatic(), aOut, aTabs );
 }
 
+bool ProfitShutdownDecider::isProfitDependent() const {
+    return true;
+}
+
 double ProfitShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aFuncInfo,
                                                 const double aCalculatedProfitRate,
                                                 const string& aRegionName,
@@ -185,9 +193,8 @@ double ProfitShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aF
        
         // Compute Shutdown factor using logistic S-curve.  ScaleFactor that is returned
         // is actually the fraction not shut down, so it is 1.0 - the shutdown fraction.
-        const double midPointToSteepness = pow( mMedianShutdownPoint + 1, mSteepness );
-        scaleFactor = 1.0 - mMaxShutdown * ( midPointToSteepness / 
-                      ( midPointToSteepness + pow( profitRate + 1, mSteepness ) ) );
+        scaleFactor = 1.0 - mMaxShutdown * ( mMidPointToSteepness / 
+                      ( mMidPointToSteepness + pow( profitRate + 1, mSteepness ) ) );
     }
 
     // Scale factor is between 0 and 1.
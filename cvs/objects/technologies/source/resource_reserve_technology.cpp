@@ -209,15 +209,39 @@ void ResourceReserveTechnology::setProductionState( const int aPeriod ) {
     const Modeltime* modeltime = scenario->getModeltime();
     const int currYear = modeltime->getper_to_yr( aPeriod );
     
-    double annualAvgProd = mTotalReserve / mAvgProdLifetime;
-    double productionPhaseScaler;
-    bool active = true;
+    double initialOutput;
     if( mYear >= currYear || mTotalReserve == 0.0 || ( mYear + mLifetimeYears ) <= currYear ) {
         // variable, retired, or future production
-        productionPhaseScaler = 1.0;
-        active = false;
+        initialOutput = mTotalReserve / mAvgProdLifetime;
     }
-    else if((currYear - mYear) < mBuildupYears) {
+    else {
+        // the depletion schedule is normally set when the previous period is
+        // finalized in postCalc
+        initialOutput = mDepletionOutput[ aPeriod ].isInited() ?
+            mDepletionOutput[ aPeriod ] : calcDepletionOutput( aPeriod );
+    }
+    
+    mProductionState[ aPeriod ] =
+        ProductionStateFactory::create( mYear, mLifetimeYears, mFixedOutput,
+                                   initialOutput, aPeriod ).release();
+}
+
+/*!
+ * \brief Calculate the annual production of an operating vintage in a period
+ *        given the buildup and decline phases and the remaining reserve.
+ * \details The production is based on the cumulative production and output of
+ *          the previous period, which no longer change once that period has
+ *          been finalized.
+ * \param aPeriod The model period, which must be after the investment period.
+ * \return The annual production the vintage is limited to in aPeriod.
+ */
+double ResourceReserveTechnology::calcDepletionOutput( const int aPeriod ) const {
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int currYear = modeltime->getper_to_yr( aPeriod );
+    
+    double annualAvgProd = mTotalReserve / mAvgProdLifetime;
+    double productionPhaseScaler;
+    if((currYear - mYear) < mBuildupYears) {
         // phase in production linearly if we are within the buildup years
         productionPhaseScaler = (currYear - mYear + 1) / mBuildupYears;
     }
@@ -231,22 +255,15 @@ void ResourceReserveTechnology::setProductionState( const int aPeriod ) {
         productionPhaseScaler = 1.0;
     }
 
-    double initialOutput = annualAvgProd * productionPhaseScaler;
-    if( active ) {
-        // guard against producing more than the total reserve by backing out the
-        // annual production that would depelete the rest of the reserve and
-        // only producing the that amount if it is less that the adjusted average
-        // annual production
-        double maxAvail = std::max(
-                                   (( mTotalReserve - mCumulProd[ aPeriod - 1 ]) - modeltime->gettimestep(aPeriod) * mOutputs[0]->getPhysicalOutput(aPeriod - 1)) * 2 /
-                                   modeltime->gettimestep( aPeriod) + mOutputs[0]->getPhysicalOutput( aPeriod - 1),
-                                   0.0);
-        initialOutput = std::min(initialOutput, maxAvail);
-    }
-    
-    mProductionState[ aPeriod ] =
-        ProductionStateFactory::create( mYear, mLifetimeYears, mFixedOutput,
-                                   initialOutput, aPeriod ).release();
+    // guard against producing more than the total reserve by backing out the
+    // annual production that would depelete the rest of the reserve and
+    // only producing the that amount if it is less that the adjusted average
+    // annual production
+    double maxAvail = std::max(
+                               (( mTotalReserve - mCumulProd[ aPeriod - 1 ]) - modeltime->gettimestep(aPeriod) * mOutputs[0]->getPhysicalOutput(aPeriod - 1)) * 2 /
+                               modeltime->gettimestep( aPeriod) + mOutputs[0]->getPhysicalOutput( aPeriod - 1),
+                               0.0);
+    return std::min(annualAvgProd * productionPhaseScaler, maxAvail);
 }
 
 /*!
@@ -340,4 +357,13 @@ void ResourceReserveTechnology::postCalc( const string& aRegionName, const int a
         double periodCumulProd = prevProd * timeStep + 0.5 * ( currProd - prevProd) * timeStep;
         mCumulProd[ aPeriod ] = aPeriod > 0 ? mCumulProd[ aPeriod - 1 ] + periodCumulProd : 0.0;
     }
+    
+    // production in this period is now fixed so we can set the depletion schedule
+    // for the next period if the vintage will still be operating
+    const int nextPeriod = aPeriod + 1;
+    if( nextPeriod < modeltime->getmaxper() && mTotalReserve != 0.0 &&
+        ( mYear + mLifetimeYears ) > modeltime->getper_to_yr( nextPeriod ) )
+    {
+        mDepletionOutput[ nextPeriod ] = calcDepletionOutput( nextPeriod );
+    }
 }
@@ -86,6 +86,13 @@ double RetiredProductionState::calcProduction( const string& aRegionName,
     return 0;
 }
 
+void RetiredProductionState::initCalc( const string& aRegionName,
+                                       const string& aSectorName,
+                                       const vector<IShutdownDecider*>& aShutdownDeciders,
+                                       const int aPeriod )
+{
+}
+
 void RetiredProductionState::setBaseOutput( const double aBaseOutput,
                                             const int aPeriod )
 {
@@ -146,6 +146,10 @@ void S_CurveShutdownDecider::toDebugXML( const int aPeriod,
     XMLWriteClosingTag( getXMLNameStatic(), aOut, aTabs );
 }
 
+bool S_CurveShutdownDecider::isProfitDependent() const {
+    return false;
+}
+
 double S_CurveShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aFuncInfo,
                                                 const double aCalculatedProfitRate,
                                                 const string& aRegionName,
@@ -98,6 +98,9 @@ SolarTechnology::SolarTechnology(
     mMaxLoss = 0.55;
     mEfficiencyLossExponent = 3.0;
     mMaxSectorLoadServed = 0.15;
+    mTotalAnnualIrradiance = DEFAULT_TOTAL_ANNUAL_IRRADIANCE;
+    mOutageFraction = 0;
+    mIrradiancePeriod = -1;
 }
 
 // Destructor: SolarTechnology ***********************************************
@@ -119,6 +122,7 @@ void SolarTechnology::copy( const SolarTechnology& aOther ) {
     mSectorName = aOther.mSectorName;
     mSolarFieldFraction = aOther.mSolarFieldFraction;
     mSolarFieldArea = aOther.mSolarFieldArea;
+    mIrradiancePeriod = -1;
 }
 
 // SolarTechnology::calcCost *************************************************
@@ -140,19 +144,12 @@ void SolarTechnology::calcCost(
 
    // Get marketplace and calculate costs
    Marketplace*       pMarketplace = scenario->getMarketplace();
-   const IInfo*       pInfo        = pMarketplace->getMarketInfo( ( *mResourceInput )->getName(), aRegionName, aPeriod, true );
 
-   double totalAnnualIrradiance = pInfo->hasValue( mTotalAnnualIrradianceKey ) ? pInfo->getDouble( mTotalAnnualIrradianceKey, true ) : DEFAULT_TOTAL_ANNUAL_IRRADIANCE;
+   double totalAnnualIrradiance = getTotalAnnualIrradiance( aRegionName, aPeriod );
    double dConnect              = pMarketplace->getPrice( ( *mResourceInput )->getName(), aRegionName, aPeriod );
    double CSPEfficiency         = getSolarEfficiency( aPeriod );
+   double outageFraction        = mOutageFraction;
 
-   // Outage Fraction -- amount of time plant is not operating either on solar or backup mode
-   // This is equal to the amount of time required for scheduled maintenance plus unscheduled outages
-   // All other times plant is operating in solar or hybrid mode, so all costs are amortized over the remaining time
-   double nonRandomMaintenance = 1 - mRandomMaintenanceFraction;
-   double outageFraction         = mScheduledMaintenance +
-                                   mPlantAvailability * ( 1 - mScheduledMaintenance * nonRandomMaintenance ); 
-                                   
    if( !mProductionState[ aPeriod ]->isNewInvestment() ||
        mFixedOutput != IProductionState::fixedOutputDefault() )
    {
@@ -210,11 +207,7 @@ double SolarTechnology::calcResourceArea(
  */
    static const double conversionFact = kWhrtoGJ * 1e-3;
 
-   // Set market demand for km^2
-   Marketplace*       pMarketplace = scenario->getMarketplace();
-   const IInfo*       pInfo        = pMarketplace->getMarketInfo( ( *mResourceInput )->getName(), aRegionName, aPeriod, true );
-
-   double totalAnnualIrradiance = pInfo->hasValue( mTotalAnnualIrradianceKey ) ? pInfo->getDouble( mTotalAnnualIrradianceKey, true ) : DEFAULT_TOTAL_ANNUAL_IRRADIANCE;
+   double totalAnnualIrradiance = getTotalAnnualIrradiance( aRegionName, aPeriod );
    double CSPGeneration         = aVariableDemand;
    double CSPEfficiency         = getSolarEfficiency( aPeriod );
 
@@ -227,6 +220,24 @@ double SolarTechnology::calcResourceArea(
    return resourceArea;
 }
 
+// SolarTechnology::getTotalAnnualIrradiance ********************************
+
+/*! \brief Return the total annual irradiance of the resource.
+*  The irradiance does not change within a period so it is only looked up in
+*  the market info once per period.
+* \param aRegionName the region name
+* \param aPeriod Model period.
+*/
+double SolarTechnology::getTotalAnnualIrradiance( const std::string& aRegionName, const int aPeriod )
+{
+   if( mIrradiancePeriod != aPeriod ) {
+      const IInfo* pInfo = scenario->getMarketplace()->getMarketInfo( ( *mResourceInput )->getName(), aRegionName, aPeriod, true );
+      mTotalAnnualIrradiance = pInfo->hasValue( mTotalAnnualIrradianceKey ) ? pInfo->getDouble( mTotalAnnualIrradianceKey, true ) : DEFAULT_TOTAL_ANNUAL_IRRADIANCE;
+      mIrradiancePeriod = aPeriod;
+   }
+   return mTotalAnnualIrradiance;
+}
+
 // SolarTechnology::calcShare ************************************************
 
 // SolarTechnology::clone ****************************************************
@@ -388,6 +399,21 @@ void SolarTechnology::initCalc(
       mNoSunDays = 0;
    }
 
+   // The irradiance may differ if the period is calculated again, e.g. by a
+   // later scenario of a batch.
+   mIrradiancePeriod = -1;
+   if ( pInfo )
+   {
+      getTotalAnnualIrradiance( aRegionName, aPeriod );
+   }
+
+   // Outage Fraction -- amount of time plant is not operating either on solar or backup mode
+   // This is equal to the amount of time required for scheduled maintenance plus unscheduled outages
+   // All other times plant is operating in solar or hybrid mode, so all costs are amortized over the remaining time
+   double nonRandomMaintenance = 1 - mRandomMaintenanceFraction;
+   mOutageFraction = mScheduledMaintenance +
+                        mPlantAvailability * ( 1 - mScheduledMaintenance * nonRandomMaintenance ); 
+
    // Put variables into an info object so can be passed into backup calculator
    mIntermittTechInfo->setDouble( "max-sector-load-served", mMaxSectorLoadServed );
    mIntermittTechInfo->setDouble( "no-sun-days", mNoSunDays );
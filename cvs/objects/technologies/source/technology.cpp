@@ -142,6 +142,13 @@ void Technology::copy( const Technology& techIn ) {
     mAlphaZero = techIn.mAlphaZero;
     mCapacityFactor = techIn.mCapacityFactor;
 
+    // Size the containers up front since a copy is made for every
+    // interpolated vintage.
+    mInputs.reserve( mInputs.size() + techIn.mInputs.size() );
+    mGHG.reserve( mGHG.size() + techIn.mGHG.size() );
+    mShutdownDeciders.reserve( mShutdownDeciders.size() + techIn.mShutdownDeciders.size() );
+    mOutputs.reserve( mOutputs.size() + techIn.mOutputs.size() );
+
     // Copy the input vector.
     for( vector<IInput*>::const_iterator iter = techIn.mInputs.begin(); iter != techIn.mInputs.end(); ++iter ) {
         mInputs.push_back( ( *iter )->clone() );
@@ -592,6 +599,10 @@ void Technology::initCalc( const string& aRegionName,
     // Setup the technology production state which represents how the technology
     // decides to produce output.
     setProductionState( aPeriod );
+    mProductionState[ aPeriod ]->initCalc( aRegionName, aSectorName, mShutdownDeciders, aPeriod );
+
+    // Parameters of the cost may change in a new period.
+    mCostPriceStamps.clear();
     
     if( !aPrevPeriodInfo.mIsFirstTech && !aPrevPeriodInfo.mInputs ){
         // The first period technology, which is not necessarily in the base year should
@@ -621,7 +632,7 @@ void Technology::initCalc( const string& aRegionName,
     mTechnologyInfo->setInteger( "initial-tech-period", scenario->getModeltime()->getyr_to_per( mYear ) );
 
     for( unsigned int i = 0; i < mGHG.size(); i++ ) {
-        mGHG[ i ]->initCalc( aRegionName, mTechnologyInfo.get(), aPeriod );
+        mGHG[ i ]->initCalc( aRegionName, mInputs, mTechnologyInfo.get(), aPeriod );
     }
 
     // Initialize the inputs.
@@ -635,6 +646,15 @@ void Technology::initCalc( const string& aRegionName,
         mCaptureComponent->adjustInputs( aRegionName, mInputs, aPeriod );
     }
 
+    // Tag the inputs by type if the Leontief production function calculates
+    // the costs and demands so it can call the common input types directly.
+    if( dynamic_cast<const MinicamLeontiefProductionFunction*>( mProductionFunction ) ) {
+        mTypedInputs.init( mInputs );
+    }
+    else {
+        mTypedInputs.clear();
+    }
+
     for( unsigned int i = 0; i < mOutputs.size(); ++i ) {
         mOutputs[ i ]->initCalc( aRegionName, aSectorName, aPeriod );
     }
@@ -820,6 +840,53 @@ double Technology::calcShare( const IDiscreteChoice* aChoiceFn,
     return logshare;
 }
 
+/*!
+ * \brief Get the terms from which the discrete choice function calculates the
+ *        unnormalized technology share.
+ * \details This allows the subsector to calculate the shares of all of its
+ *          technologies at once with IDiscreteChoice::calcShares.  The share
+ *          is the same as calcShare would give: a technology which should not
+ *          receive a share is given a share weight of zero and the fuel
+ *          preference elasticity is returned as the log share adjustment.
+ * \param aGDP Regional GDP container.
+ * \param aPeriod Model period.
+ * \param aShareWeight The share weight.
+ * \param aCost The cost to share on.
+ * \param aLogShareAdjustment A term to add to the log of the unnormalized share.
+ * \return Whether the share is given by these terms, if not calcShare must be
+ *         used instead.
+ * \sa Technology::calcShare()
+ */
+bool Technology::getShareInputs( const GDP* aGDP,
+                                 const int aPeriod,
+                                 double& aShareWeight,
+                                 double& aCost,
+                                 double& aLogShareAdjustment ) const
+{
+    aShareWeight = 0.0;
+    aCost = 0.0;
+    aLogShareAdjustment = 0.0;
+
+    // A Technology which is not operating does not have a share, nor do
+    // vintages and fixed output technologies.
+    if( !mProductionState[ aPeriod ] || !mProductionState[ aPeriod ]->isOperating() ||
+        !mProductionState[ aPeriod ]->isNewInvestment() ||
+        mFixedOutput != IProductionState::fixedOutputDefault() )
+    {
+        return true;
+    }
+
+    aShareWeight = mShareWeight;
+    aCost = getCost( aPeriod );
+    const double fuelPrefElasticity = calcFuelPrefElasticity( aPeriod );
+    if( fuelPrefElasticity != 0 ) {
+        double scaledGdpPerCapita = aGDP->getBestScaledGDPperCap( aPeriod );
+        assert( scaledGdpPerCapita > 0.0 );
+        aLogShareAdjustment = fuelPrefElasticity * log( scaledGdpPerCapita );
+    }
+    return true;
+}
+
 /*! \brief Return true if technology is fixed for no output or input
 * 
 * returns true if this technology is set to never produce output or input
@@ -946,8 +1013,14 @@ void Technology::production( const string& aRegionName,
                                                      aPeriod );
 
     // Calculate input demand.
-    mProductionFunction->calcDemand( mInputs, primaryOutput, aRegionName, aSectorName,
-                                     1, aPeriod, 0, mAlphaZero );
+    if( mTypedInputs.isInitFor( mInputs ) ) {
+        static_cast<const MinicamLeontiefProductionFunction*>( mProductionFunction )->calcDemand(
+            mTypedInputs, primaryOutput, aRegionName, aPeriod, mAlphaZero );
+    }
+    else {
+        mProductionFunction->calcDemand( mInputs, primaryOutput, aRegionName, aSectorName,
+                                         1, aPeriod, 0, mAlphaZero );
+    }
 
     calcEmissionsAndOutputs( aRegionName, primaryOutput, aGDP, aPeriod );
 }
@@ -1191,8 +1264,10 @@ double Technology::getTotalInputCost( const string& aRegionName,
 {
     /*! \pre The technology must have a production function. */
     assert( mProductionFunction );
-    double cost = mProductionFunction->calcCosts( mInputs, aRegionName,
-                                                  mAlphaZero, aPeriod );
+    double cost = mTypedInputs.isInitFor( mInputs ) ?
+        static_cast<const MinicamLeontiefProductionFunction*>( mProductionFunction )->calcCosts(
+            mTypedInputs, aRegionName, mAlphaZero, aPeriod ) :
+        mProductionFunction->calcCosts( mInputs, aRegionName, mAlphaZero, aPeriod );
     assert( cost >= 0 );
     return cost;
 }
@@ -1328,14 +1403,31 @@ void Technology::calcCost( const string& aRegionName,
     // Note that attempted to retrieve a cost when the technology is not
     // operating will cause an abort.
     if( mProductionState[ aPeriod ]->isOperating() ) {
+        // The cost can be reused if none of the market prices it was last
+        // calculated from have changed, which is the case for most
+        // technologies while the solver perturbs the prices of unrelated markets.
+        const static bool reuseCosts = Configuration::getInstance()->getBool( "reuse-technology-costs", true, false );
+        const bool canReuse = reuseCosts && canReuseCost();
+        double cost;
+        if( canReuse && mCostPriceStamps.getValue( aPeriod, cost ) ) {
+            // Avoid flagging the state as changed if the cost is already set.
+            if( mCosts[ aPeriod ] != cost ) {
+                mCosts[ aPeriod ] = cost;
+            }
+            return;
+        }
+
         // Note we now allow costs in any sector to be <= 0.  If,
         // however, you are using the relative cost logit, costs will be
         // clamped on the low end for market share purposes (not for
         // other purposes, though).
-        
-        double cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
+        MarketPriceStamps::Recorder priceRecorder;
+        cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
             * mPMultiplier -
             calcSecondaryValue( aRegionName, aPeriod );
+        if( canReuse ) {
+            priceRecorder.store( mCostPriceStamps, aPeriod, cost );
+        }
 
         mCosts[ aPeriod ] = cost;
         
@@ -1343,6 +1435,25 @@ void Technology::calcCost( const string& aRegionName,
     } 
 }
 
+/*!
+ * \brief Whether the cost calculated by calcCost depends only on the market
+ *        prices read while calculating it and parameters which are constant
+ *        within a period, so that it can be reused while the prices are unchanged.
+ * \details This is not the case if the value of any GHG depends on other
+ *          state, such as the reductions of emissions controls.  Subclasses
+ *          which change their inputs before calculating the cost should
+ *          override this to return false.
+ * \return Whether the value of every GHG is set by the market prices.
+ */
+bool Technology::canReuseCost() const {
+    for( auto ghg : mGHG ) {
+        if( !ghg->isGHGValueSetByPrices() ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /*!
 * \brief Get the total cost of the technology for a period.
 * \details Returns the previously calculated cost for a period.
@@ -1600,6 +1711,10 @@ const IInfo* Technology::getTechInfo() const
 
 void Technology::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitTechnology( this, aPeriod );
+    if( !aVisitor->shouldVisitChildren() || !aVisitor->visitsContent( IVisitor::TECHNOLOGY_CONTENTS ) ) {
+        aVisitor->endVisitTechnology( this, aPeriod );
+        return;
+    }
     acceptDerived( aVisitor, aPeriod );
 
     for( unsigned int i = 0; i < mOutputs.size(); ++i ) {
@@ -40,9 +40,11 @@
 #include "util/base/include/definitions.h"
 #include <string>
 #include <cassert>
+#include <algorithm>
 #include <xercesc/dom/DOMNodeList.hpp>
 
 #include "util/base/include/util.h"
+#include "util/base/include/configuration.h"
 #include "technologies/include/technology_container.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/interpolation_rule.h"
@@ -68,12 +70,20 @@ extern Scenario* scenario;
 using namespace std;
 using namespace xercesc;
 
+namespace {
+    //! Whether a vintage in the vintage list is from before the given year.
+    bool isBeforeYear( const ITechnologyContainer::VintageList::value_type& aVintage, const int aYear ) {
+        return aVintage.first < aYear;
+    }
+}
+
 //! Constructor
 TechnologyContainer::TechnologyContainer()
 {
     mInitialAvailableYear = -1;
     mFinalAvailableYear = -1;
     mCachedVintageRangePeriod = -1;
+    mLastVintagePeriod = -1;
 }
 
 //! Destructor
@@ -82,6 +92,7 @@ TechnologyContainer::~TechnologyContainer() {
         delete ( *vintageIt ).second;
     }
     mVintages.clear();
+    mVintageList.clear();
     
     // just in case null out the period vector as well
     for( int period = 0; period < mVintagesByPeriod.size(); ++period ) {
@@ -313,6 +324,11 @@ void TechnologyContainer::completeInit( const string& aRegionName,
                                         const IInfo* aSubsecInfo,
                                         ILandAllocator* aLandAllocator )
 {
+    // Resolve the share weight interpolation rules to model periods.
+    for( CInterpRuleIterator ruleIter = mShareWeightInterpRules.begin(); ruleIter != mShareWeightInterpRules.end(); ++ruleIter ) {
+        ( *ruleIter )->completeInit();
+    }
+
     // Setup the period to vintage vector with the parsed technologies.  Also check
     // for technologies that are not in the initial year to final year range if
     // specified.
@@ -357,6 +373,14 @@ void TechnologyContainer::completeInit( const string& aRegionName,
         }
     }
     
+    // When the run is configured to stop before the end of the horizon the
+    // vintages that would be interpolated for the periods after it are never
+    // calculated, so optionally avoid creating them at all.  Parsed vintages
+    // are always kept as they may be the targets of interpolations.
+    const int stopPeriod = util::getConfigRunPeriod( "stop" );
+    mLastVintagePeriod = Configuration::getInstance()->getBool( "defer-unreached-vintages", false, false )
+        && stopPeriod >= 0 && stopPeriod < modeltime->getmaxper() - 1 ? stopPeriod : -1;
+
     // Finish filling the vintages by period vector with empty technologies or
     // interpolate for missing years.
     for( int period = 0; period < mVintagesByPeriod.size(); ++period ) {
@@ -376,6 +400,15 @@ void TechnologyContainer::completeInit( const string& aRegionName,
                 abort();
             }
             
+            if( mLastVintagePeriod != -1 && period > mLastVintagePeriod ) {
+                // Hold the place of the vintage that is not created.  It is still
+                // recorded as interpolated so that share-weight interpolation for
+                // the periods before it is unchanged.
+                mVintagesByPeriod[ period ] = EmptyTechnology::getInstance();
+                mInterpolatedTechYears.push_back( year );
+                continue;
+            }
+            
             // We can interpolate a technology to fill this year.
             CVintageIterator tempPrevTech, prevTech;
             tempPrevTech = prevTech = mVintages.lower_bound( 
@@ -388,6 +421,7 @@ void TechnologyContainer::completeInit( const string& aRegionName,
     
     // Now that all interpolated technologies have been created we can call
     // completeInit.
+    updateVintageList();
     for( VintageIterator vintageIt = mVintages.begin(); vintageIt != mVintages.end(); ++vintageIt ) {
         // call complete init for all vintages, even those that are not a model year
         ( *vintageIt ).second->completeInit( aRegionName, aSectorName, aSubsectorName,
@@ -399,6 +433,14 @@ void TechnologyContainer::initCalc( const string& aRegionName, const string& aSe
                                     const IInfo* aSubsecInfo, const Demographic* aDemographic,
                                     const int aPeriod )
 {
+    if( mLastVintagePeriod != -1 && aPeriod > mLastVintagePeriod ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Technology " << mName << " in " << aRegionName << " " << aSectorName
+                << " has no vintages for period " << aPeriod << " since the run was configured to stop in period "
+                << mLastVintagePeriod << ", turn off defer-unreached-vintages to run past it." << endl;
+        abort();
+    }
     
     // Pass forward any emissions information
     if( aPeriod > 0 && mVintagesByPeriod[ aPeriod - 1 ] != EmptyTechnology::getInstance()
@@ -415,6 +457,9 @@ void TechnologyContainer::initCalc( const string& aRegionName, const string& aSe
         mVintagesByPeriod[ aPeriod ]->initTechVintageVector();
     }
     
+    // Make sure the list of vintages reflects any technologies added since.
+    updateVintageList();
+    
     // Initialize the previous period info as having no input set and
     // cumulative Hicks neutral, energy of 1 and it is the first tech.
     PreviousPeriodInfo prevPeriodInfo = { 0, 1, true };
@@ -431,24 +476,21 @@ void TechnologyContainer::initCalc( const string& aRegionName, const string& aSe
     // interpolate technology share weights
     interpolateShareWeights( aPeriod );
     
-    // Cache the first and last technologies to those that are operating in this period
-    // to avoid iterating over more technologies than necessary.  We must be careful to
-    // check all past vintages in case the operating technologies are not contiguous.
+    // Cache the technologies which are operating in this period to avoid iterating
+    // over retired vintages, which by the later periods are most of them.  The
+    // most recent vintage is always kept first as callers pass it the variable
+    // output.  The list is kept in year order to be iterated over in reverse.
     mCachedVintageRangePeriod = -1;
-    mCachedTechRangeBegin = getVintageBegin( aPeriod );
-    mCachedTechRangeEnd = mVintages.rend();
-    for( TechRangeIterator it = mCachedTechRangeBegin; it != mVintages.rend(); ++it ) {
-        if( mCachedTechRangeEnd != mVintages.rend() && (*it).second->isOperating( aPeriod ) ) {
-            // We found a vintage that is still operating so we must reset the end
-            // iterator and keep looking for an earlier end point.
-            mCachedTechRangeEnd = mVintages.rend();
-        }
-        else if( mCachedTechRangeEnd == mVintages.rend() && !(*it).second->isOperating( aPeriod ) ) {
-            // We have found a vintage that is no longer operating.  This could
-            // potentially be our end iterator provided we don't find and earlier
-            // vintage that is still operating.
-            mCachedTechRangeEnd = it;
+    mActiveVintages.clear();
+    TechRangeIterator beginIter = getVintageBegin( aPeriod );
+    if( beginIter != mVintageList.rend() ) {
+        for( TechRangeIterator it = beginIter + 1; it != mVintageList.rend(); ++it ) {
+            if( (*it).second->isOperating( aPeriod ) ) {
+                mActiveVintages.push_back( *it );
+            }
         }
+        reverse( mActiveVintages.begin(), mActiveVintages.end() );
+        mActiveVintages.push_back( *beginIter );
     }
     mCachedVintageRangePeriod = aPeriod;
 }
@@ -471,7 +513,7 @@ ITechnologyContainer::TechRangeIterator TechnologyContainer::getVintageBegin( co
     // If the given period matches the cached period then we can use the cached
     // begin iterator and avoid having to find it.
     if( aPeriod == mCachedVintageRangePeriod ) {
-        return mCachedTechRangeBegin;
+        return mActiveVintages.rbegin();
     }
     const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
     
@@ -479,12 +521,16 @@ ITechnologyContainer::TechRangeIterator TechnologyContainer::getVintageBegin( co
     // then make sure that it is not > year and is not beyond the final investment
     // year.  In those cases decrease the iterator to make sure we don't go include
     // a technology beyond aPeriod.
-    VintageIterator vintageIter = mVintages.lower_bound( year );
-    if( vintageIter == mVintages.end() ) {
+    VintageList::iterator vintageIter = lower_bound( mVintageList.begin(), mVintageList.end(),
+                                                  year, isBeforeYear );
+    if( vintageIter == mVintageList.end() ) {
+        if( mVintageList.empty() ) {
+            return mVintageList.rend();
+        }
         --vintageIter;
     }
     else if( ( *vintageIter ).first > year ) {
-        return mVintages.rend();
+        return mVintageList.rend();
     }
     
     // Converting a forward iterator to a reverse in not completely intuitive.  We
@@ -496,7 +542,7 @@ ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageBegin( c
     // If the given period matches the cached period then we can use the cached
     // begin iterator and avoid having to find it.
     if( aPeriod == mCachedVintageRangePeriod ) {
-        return mCachedTechRangeBegin;
+        return mActiveVintages.rbegin();
     }
     const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
     
@@ -504,12 +550,16 @@ ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageBegin( c
     // then make sure that it is not > year and is not beyond the final investment
     // year.  In those cases decrease the iterator to make sure we don't go include
     // a technology beyond aPeriod.
-    CVintageIterator vintageIter = mVintages.lower_bound( year );
-    if( vintageIter == mVintages.end() ) {
+    VintageList::const_iterator vintageIter = lower_bound( mVintageList.begin(), mVintageList.end(),
+                                                  year, isBeforeYear );
+    if( vintageIter == mVintageList.end() ) {
+        if( mVintageList.empty() ) {
+            return mVintageList.rend();
+        }
         --vintageIter;
     }
     else if( ( *vintageIter ).first > year ) {
-        return mVintages.rend();
+        return mVintageList.rend();
     }
     
     // Converting a forward iterator to a reverse in not completely intuitive.  We
@@ -520,13 +570,30 @@ ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageBegin( c
 ITechnologyContainer::TechRangeIterator TechnologyContainer::getVintageEnd( const int aPeriod ) {
     // If the given period matches the cached period then we can use the cached
     // end iterator and avoid iterating over unnecessary technologies.
-    return aPeriod == mCachedVintageRangePeriod ? mCachedTechRangeEnd : mVintages.rend();
+    return aPeriod == mCachedVintageRangePeriod ? mActiveVintages.rend() : mVintageList.rend();
 }
 
 ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageEnd( const int aPeriod ) const {
     // If the given period matches the cached period then we can use the cached
     // end iterator and avoid iterating over unnecessary technologies.
-    return aPeriod == mCachedVintageRangePeriod ? static_cast<CTechRangeIterator>( mCachedTechRangeEnd ) : mVintages.rend();
+    return aPeriod == mCachedVintageRangePeriod ? mActiveVintages.rend() : mVintageList.rend();
+}
+
+/*!
+ * \brief Copy the vintages from mVintages into the contiguous mVintageList.
+ * \details The list is only rebuilt if the vintages have changed, in which
+ *          case any cached vintage range is no longer valid.
+ */
+void TechnologyContainer::updateVintageList() {
+    bool isCurrent = mVintageList.size() == mVintages.size();
+    VintageList::const_iterator listIter = mVintageList.begin();
+    for( CVintageIterator vintageIt = mVintages.begin(); isCurrent && vintageIt != mVintages.end(); ++vintageIt, ++listIter ) {
+        isCurrent = ( *listIter ).first == ( *vintageIt ).first && ( *listIter ).second == ( *vintageIt ).second;
+    }
+    if( !isCurrent ) {
+        mVintageList.assign( mVintages.begin(), mVintages.end() );
+        mCachedVintageRangePeriod = -1;
+    }
 }
 
 /*!
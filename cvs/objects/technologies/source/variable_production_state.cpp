@@ -87,6 +87,13 @@ double VariableProductionState::calcProduction( const string& aRegionName,
     return aVariableOutput;
 }
 
+void VariableProductionState::initCalc( const string& aRegionName,
+                                        const string& aSectorName,
+                                        const vector<IShutdownDecider*>& aShutdownDeciders,
+                                        const int aPeriod )
+{
+}
+
 void VariableProductionState::setBaseOutput( const double aBaseOutput,
                                              const int aPeriod )
 {
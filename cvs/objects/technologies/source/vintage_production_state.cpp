@@ -47,7 +47,10 @@
 
 using namespace std;
 
-VintageProductionState::VintageProductionState()
+VintageProductionState::VintageProductionState():
+mAgeShutdownPeriod( -1 ),
+mAgeShutdownCoef( 1 ),
+mHasProfitShutdown( true )
 {
     mInitialYear = -1;
 }
@@ -56,6 +59,9 @@ VintageProductionState* VintageProductionState::clone() const {
     VintageProductionState* clone = new VintageProductionState();
     clone->mBaseOutput = mBaseOutput;
     clone->mInitialYear = mInitialYear;
+    clone->mAgeShutdownPeriod = mAgeShutdownPeriod;
+    clone->mAgeShutdownCoef = mAgeShutdownCoef;
+    clone->mHasProfitShutdown = mHasProfitShutdown;
     return clone;
 }
 
@@ -133,17 +139,61 @@ double VintageProductionState::calcShutdownCoefficient( const string& aRegionNam
         return shutdownCoef;
     }
 
+    // The deciders which only depend on the age of the vintage were
+    // tabulated by initCalc.
+    const bool isTabulated = mAgeShutdownPeriod == aPeriod;
+    if( isTabulated ){
+        shutdownCoef = mAgeShutdownCoef;
+        if( !mHasProfitShutdown ){
+            return shutdownCoef;
+        }
+    }
+
     double marginalProfit = aMarginalProfitCalc->calcShortTermMarginalProfit( aRegionName,
         aSectorName,
         aPeriod );
 
     for( unsigned int i = 0; i < aShutdownDeciders.size(); ++i ){
-        shutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, marginalProfit, aRegionName,
-            aSectorName, mInitialYear, aPeriod );
+        if( !isTabulated || aShutdownDeciders[ i ]->isProfitDependent() ){
+            shutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, marginalProfit, aRegionName,
+                aSectorName, mInitialYear, aPeriod );
+        }
     }
     return shutdownCoef;
 }
 
+/*!
+ * \brief Calculate the part of the shutdown coefficient which depends only on
+ *        the age of the vintage.
+ * \details The phased and s-curve shutdown deciders depend only on the
+ *          initial year of the vintage and the period, so their product is
+ *          calculated once here rather than each time the Technology is
+ *          calculated.  This also lets calcShutdownCoefficient skip the
+ *          marginal profit calculation when no shutdown decider needs it.
+ * \param aRegionName Region name.
+ * \param aSectorName Sector name.
+ * \param aShutdownDeciders Set of shutdown decision makers.
+ * \param aPeriod Model period.
+ */
+void VintageProductionState::initCalc( const string& aRegionName,
+                                       const string& aSectorName,
+                                       const vector<IShutdownDecider*>& aShutdownDeciders,
+                                       const int aPeriod )
+{
+    mAgeShutdownCoef = 1;
+    mHasProfitShutdown = false;
+    for( unsigned int i = 0; i < aShutdownDeciders.size(); ++i ){
+        if( aShutdownDeciders[ i ]->isProfitDependent() ){
+            mHasProfitShutdown = true;
+        }
+        else {
+            mAgeShutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, 0, aRegionName,
+                aSectorName, mInitialYear, aPeriod );
+        }
+    }
+    mAgeShutdownPeriod = aPeriod;
+}
+
 void VintageProductionState::setBaseOutput( const double aBaseOutput,
                                            const int aBaseYear )
 {
@@ -120,6 +120,7 @@ WindTechnology::WindTechnology(
     mTurbineRating = -1;
     mWindCapacityFactor = -1;
     mWindFarmLoss = -1;
+    mTurbineOutputPeriod = -1;
 }
 
 // Destructor: WindTechnology **********************************************
@@ -145,6 +146,7 @@ void WindTechnology::copy( const WindTechnology& aOther ) {
     mTurbineRating = aOther.mTurbineRating;
     mWindCapacityFactor = aOther.mWindCapacityFactor;
     mWindFarmLoss = aOther.mWindFarmLoss;
+    mTurbineOutputPeriod = -1;
 }
 
 // WindTechnology::calcCost ************************************************
@@ -162,16 +164,12 @@ void WindTechnology::calcCost(
    // Var to hold capital and operating costs
    double totalTechCapOMCost = 0;
 
+   // Equations 3 and 4 only depend on the wind resource, and so are only
+   // calculated once per period.
+   calcWindCapacityFactor( aRegionName, aPeriod );
+
    // Get marketplace and calculate costs
    Marketplace*       pMarketplace = scenario->getMarketplace();
-   const IInfo*       pInfo        = pMarketplace->getMarketInfo( ( *mResourceInput )->getName(), aRegionName, aPeriod, true );
-
-   // Equation 4:
-   mRealizedTurbineOutput = calcRealizedTurbineOutput( pInfo );
-
-   // Equation 3:
-   // WindCapacityFactor = RealizedTurbineOutput / TurbineRating
-   mWindCapacityFactor = mRealizedTurbineOutput / mTurbineRating;
 
    // Equation 6:
    // CConnect = FCR * DConnect * ( gridConnectionCost / ( WindCapacityFactor * 1000.0 * kWhrtoGJ * 24 * 365 * 1 ) )
@@ -264,6 +262,34 @@ double WindTechnology::calcResourceArea(
    double             aVariableDemand,
    const int          aPeriod )
 {
+   // Equations 3 and 4.
+   calcWindCapacityFactor( aRegionName, aPeriod );
+
+   // Equation 7:
+   // WindGeneration / ( kWhrtoGJ * 10^-9 ) = TurbineDensity * ResourceArea * WindCapacityFactor * 1000 * 24 * 365
+   // ResourceArea = ( WindGeneration / ( kWhrtoGJ * 10^-9 ) ) / ( TurbineDensity * WindCapacityFactor * 1000 * 24 * 365 )
+   double windGeneration = aVariableDemand;
+   double resourceArea = ( windGeneration / ( kWhrtoGJ * 1.0e-9 ) ) / ( mTurbineDensity * mWindCapacityFactor * 1000.0 * 24.0 * 365.0 );
+
+   return resourceArea;
+}
+
+// WindTechnology::calcWindCapacityFactor *********************************
+
+/*! Calculate the realized turbine output, wind capacity factor and wind power
+ *  variance for a period.
+ *  These only depend on the properties of the turbine and of the wind resource
+ *  which do not change within a period, so they are calculated once per period
+ *  rather than in every calcCost.
+ *  \param aRegionName the region name
+ *  \param aPeriod the period
+ */
+void WindTechnology::calcWindCapacityFactor( const std::string& aRegionName, const int aPeriod )
+{
+   if( mTurbineOutputPeriod == aPeriod ) {
+      return;
+   }
+
    // Get info object for this resource 
    Marketplace*       pMarketplace = scenario->getMarketplace();
    const IInfo*       pInfo        = pMarketplace->getMarketInfo( ( *mResourceInput )->getName(), aRegionName, aPeriod, true );
@@ -275,13 +301,7 @@ double WindTechnology::calcResourceArea(
    // WindCapacityFactor = RealizedTurbineOutput / TurbineRating
    mWindCapacityFactor = mRealizedTurbineOutput / mTurbineRating;
 
-   // Equation 7:
-   // WindGeneration / ( kWhrtoGJ * 10^-9 ) = TurbineDensity * ResourceArea * WindCapacityFactor * 1000 * 24 * 365
-   // ResourceArea = ( WindGeneration / ( kWhrtoGJ * 10^-9 ) ) / ( TurbineDensity * WindCapacityFactor * 1000 * 24 * 365 )
-   double windGeneration = aVariableDemand;
-   double resourceArea = ( windGeneration / ( kWhrtoGJ * 1.0e-9 ) ) / ( mTurbineDensity * mWindCapacityFactor * 1000.0 * 24.0 * 365.0 );
-
-   return resourceArea;
+   mTurbineOutputPeriod = aPeriod;
 }
 
 /*! \brief Return amount of resource needed per unit of energy output.
@@ -519,6 +539,13 @@ void WindTechnology::initCalc(
       mainLog.setLevel( ILogger::ERROR );
       mainLog << msg << std::endl;
    }
+   else
+   {
+      // The period may be calculated again, e.g. by a later scenario of a
+      // batch with a different wind resource, so always start fresh here.
+      mTurbineOutputPeriod = -1;
+      calcWindCapacityFactor( aRegionName, aPeriod );
+   }
 }
 
 // WindTechnology::production **********************************************
@@ -76,7 +76,9 @@ namespace objects {
     *          of their constructors. Registered atoms are kept for the entire
     *          lifetime of the model. They may be fetched using the findAtom
     *          function which searches the internal hashmap to find the requested
-    *          Atom.
+    *          Atom. The getAtom function additionally creates the Atom if it does
+    *          not exist yet, which allows repeated names read from the input
+    *          files to share a single copy of the string.
     * \author Josh Lurz
     */
     class AtomRegistry: boost::noncopyable {
@@ -85,6 +87,7 @@ namespace objects {
 		~AtomRegistry();
 		static AtomRegistry* getInstance();
 		const Atom* findAtom( const std::string& aID ) const;
+		const Atom* getAtom( const std::string& aID );
 	private:
 		AtomRegistry();
 		bool registerAtom( Atom* aAtom );
@@ -103,6 +103,16 @@ public:
         util::checkIsOpen( fileBuffer, aFileName );
     }
 
+    /*! \brief Write to an existing stream instead of a file.
+    * \details The stream is flushed but not closed on destruction.
+    * \param aStream The stream to write to.
+    */
+    explicit AutoOutputFile( std::ostream& aStream )
+        :mShouldWrite( true )
+    {
+        mWrappedFile.push( aStream );
+    }
+
     /*! \brief Destructor which closes the internal file stream.*/
     ~AutoOutputFile(){
         close( mWrappedFile );
@@ -0,0 +1,112 @@
+#ifndef _BACKGROUND_TASK_QUEUE_H_
+#define _BACKGROUND_TASK_QUEUE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file background_task_queue.h
+ * \ingroup Objects
+ * \brief The BackgroundTaskQueue class header file.
+ */
+
+#include <deque>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <boost/core/noncopyable.hpp>
+
+/*!
+ * \ingroup Objects
+ * \brief Runs tasks one at a time, in the order they were added, on a
+ *        background thread.
+ * \details This is used for side effects such as writing output which the
+ *          calculations that follow do not depend on, so that they can overlap
+ *          with those calculations.  A task must only use data which will not
+ *          be changed until wait is called, which is the barrier before
+ *          anything that does depend on the tasks.  Only a few tasks may be
+ *          waiting at once so that the data they hold can not pile up; adding
+ *          more waits for the earlier ones to finish.
+ *
+ *          The thread is started when the first task is added and stopped,
+ *          once all tasks have finished, when the queue is destroyed.  If a
+ *          task throws an exception the remaining tasks are still run and the
+ *          exception is rethrown by the next call to wait.
+ */
+class BackgroundTaskQueue : private boost::noncopyable {
+public:
+    BackgroundTaskQueue();
+
+    ~BackgroundTaskQueue();
+
+    void push( const std::function<void()>& aTask );
+
+    void wait();
+
+private:
+    //! The number of tasks which may be waiting to run.
+    static const size_t MAX_PENDING_TASKS = 2;
+
+    //! The tasks waiting to run.
+    std::deque<std::function<void()> > mTasks;
+
+    //! Whether a task is currently running.
+    bool mIsRunning;
+
+    //! Whether the queue is being destroyed and the thread should exit.
+    bool mIsClosing;
+
+    //! The first exception thrown by a task since the last wait.
+    std::exception_ptr mException;
+
+    //! Protects all of the members above.
+    std::mutex mMutex;
+
+    //! Signals that a task has been added or that the queue is closing.
+    std::condition_variable mHasTasks;
+
+    //! Signals that a task has finished.
+    std::condition_variable mTaskFinished;
+
+    //! The thread running the tasks.
+    std::thread mThread;
+
+    void run();
+};
+
+#endif // _BACKGROUND_TASK_QUEUE_H_
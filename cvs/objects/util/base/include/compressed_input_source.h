@@ -0,0 +1,111 @@
+#ifndef _COMPRESSED_INPUT_SOURCE_H_
+#define _COMPRESSED_INPUT_SOURCE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file compressed_input_source.h
+ * \ingroup util
+ * \brief CompressedInputSource class header file.
+ */
+
+#include <string>
+#include <xercesc/sax/InputSource.hpp>
+
+#ifndef USE_ZLIB
+#define USE_ZLIB 0
+#endif
+
+#ifndef USE_ZSTD
+#define USE_ZSTD 0
+#endif
+
+/*!
+ * \ingroup util
+ * \brief An XML input source which decompresses a gzip or zstd compressed
+ *        file as the parser reads it.
+ * \details The file is read and decompressed in blocks by a background thread
+ *          into a short queue which the parser drains, so that reading from
+ *          (slow, shared) storage and decompressing overlap with parsing and
+ *          the uncompressed document is never held in memory or written to
+ *          disk.  Files are recognized as compressed by the extensions .gz
+ *          and .zst.  Reading gzip files requires GCAM to be built with
+ *          USE_ZLIB and zstd files with USE_ZSTD.
+ */
+class CompressedInputSource : public xercesc::InputSource {
+public:
+    //! The compression formats which may be read.
+    enum Format {
+        NONE,
+        GZIP,
+        ZSTD
+    };
+
+    CompressedInputSource( const std::string& aFileName, const Format aFormat );
+
+    virtual xercesc::BinInputStream* makeStream() const;
+
+    static Format getFormat( const std::string& aFileName );
+
+    /*!
+     * \brief Parse a file, decompressing it first if it is compressed.
+     * \details Exceptions thrown by the parser are passed on to the caller.
+     * \param aParser The parser, which may be a XercesDOMParser or a
+     *        SAX2XMLReader.
+     * \param aFileName The name of the file to parse.
+     */
+    template<class ParserT>
+    static void parse( ParserT& aParser, const std::string& aFileName ) {
+        const Format format = getFormat( aFileName );
+        if( format == NONE ) {
+            aParser.parse( aFileName.c_str() );
+        }
+        else {
+            CompressedInputSource source( aFileName, format );
+            aParser.parse( source );
+        }
+    }
+
+private:
+    //! The name of the compressed file.
+    const std::string mFileName;
+
+    //! The compression format of the file.
+    const Format mFormat;
+};
+
+#endif // _COMPRESSED_INPUT_SOURCE_H_
@@ -50,10 +50,12 @@
 #include <xercesc/dom/DOMNode.hpp>
 #include <map>
 #include <list>
+#include <vector>
 #include <memory>
 #include "util/base/include/iparsable.h"
 
 class Tabs;
+class AConfigurationSetting;
 
 /*! 
 * \ingroup Objects
@@ -76,6 +78,7 @@ public:
 	static Configuration* getInstance();
 	bool XMLParse( const xercesc::DOMNode* tempnode );
 	void toDebugXML( std::ostream& out, Tabs* tabs ) const;
+    void writeSettings( std::ostream& aOut ) const;
 	const std::string& getFile( const std::string& key, const std::string& defaultValue = "", const bool mustExist = true ) const;
 	bool shouldWriteFile( const std::string& key, const bool defaultValue = true, const bool mustExist = false ) const;
 	bool shouldAppendScnToFile( const std::string& key, const bool defaultValue = false, const bool mustExist = false ) const;
@@ -84,6 +87,7 @@ public:
 	int getInt( const std::string& key, const int defaultValue = 0, const bool mustExist = true ) const;
 	double getDouble( const std::string& key, const double defaultValue = 0, const bool mustExist = true ) const;
     const std::list<std::string>& getScenarioComponents() const;
+    static void registerSetting( AConfigurationSetting* aSetting );
 private:
     const std::string mLogFile; //!< The name of the log to use.
     static std::auto_ptr<Configuration> gInstance; //!< The static instance of the Configuration class.
@@ -100,6 +104,8 @@ private:
     std::list<std::string> scenarioComponents; //!< An ordered list of add-on files. 
 	Configuration();
 
+    static std::vector<AConfigurationSetting*>& getRegisteredSettings();
+
 	//! Private undefined constructor to prevent a programmer from creating a second object.
 	Configuration( const Configuration& );
 
@@ -0,0 +1,133 @@
+#ifndef _CONFIGURATION_SETTING_H_
+#define _CONFIGURATION_SETTING_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file configuration_setting.h
+* \ingroup Objects
+* \brief The ConfigurationSetting class header file.
+*/
+
+#include <string>
+#include "util/base/include/configuration.h"
+
+/*!
+* \ingroup Objects
+* \brief A configuration value of a fixed type which is looked up once.
+* \details Settings are declared at namespace scope in the file which uses them
+*          and register themselves with the Configuration when constructed.
+*          The Configuration loads every registered setting at the end of
+*          parsing so that reading the value later is a plain member access
+*          rather than a string map lookup, and a setting which must exist but
+*          is missing, e.g. due to a misspelled key, is reported at startup
+*          rather than the first time it happens to be used.  Until the
+*          configuration is parsed the value is the default.
+*/
+class AConfigurationSetting {
+public:
+    virtual ~AConfigurationSetting() {}
+
+    /*!
+     * \brief Look up the value of this setting.
+     * \param aConf The parsed configuration.
+     */
+    virtual void load( const Configuration* aConf ) = 0;
+
+protected:
+    AConfigurationSetting( const char* aKey, const bool aMustExist )
+        :mKey( aKey ), mMustExist( aMustExist )
+    {
+        Configuration::registerSetting( this );
+    }
+
+    //! The name of the setting in the configuration file.
+    const std::string mKey;
+
+    //! Whether to warn if the setting is not in the configuration file.
+    const bool mMustExist;
+};
+
+/*!
+* \ingroup Objects
+* \brief A typed configuration value.
+* \details T may be bool, int, double or std::string which are read from the
+*          Bools, Ints, Doubles and Strings sections of the configuration.
+* \sa AConfigurationSetting
+*/
+template<typename T>
+class ConfigurationSetting : public AConfigurationSetting {
+public:
+    ConfigurationSetting( const char* aKey, const T& aDefault, const bool aMustExist = false )
+        :AConfigurationSetting( aKey, aMustExist ), mDefault( aDefault ), mValue( aDefault )
+    {
+    }
+
+    virtual void load( const Configuration* aConf ) {
+        mValue = getValue( aConf, mDefault );
+    }
+
+    //! Get the value of the setting.
+    const T& get() const {
+        return mValue;
+    }
+
+private:
+    //! The value to use if the setting is not in the configuration file.
+    const T mDefault;
+
+    //! The current value.
+    T mValue;
+
+    bool getValue( const Configuration* aConf, const bool aDefault ) const {
+        return aConf->getBool( mKey, aDefault, mMustExist );
+    }
+
+    int getValue( const Configuration* aConf, const int aDefault ) const {
+        return aConf->getInt( mKey, aDefault, mMustExist );
+    }
+
+    double getValue( const Configuration* aConf, const double aDefault ) const {
+        return aConf->getDouble( mKey, aDefault, mMustExist );
+    }
+
+    std::string getValue( const Configuration* aConf, const std::string& aDefault ) const {
+        return aConf->getString( mKey, aDefault, mMustExist );
+    }
+};
+
+#endif // _CONFIGURATION_SETTING_H_
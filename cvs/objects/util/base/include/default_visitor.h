@@ -54,8 +54,11 @@
 */
 class DefaultVisitor : public IVisitor {
 public:
+    DefaultVisitor():mSkippedContent( 0 ){}
     virtual ~DefaultVisitor(){}
     virtual void finish() const {}
+    virtual bool shouldVisitChildren() const { return true; }
+    virtual bool visitsContent( const VisitContent aContent ) const { return ( mSkippedContent & aContent ) == 0; }
     virtual void startVisitScenario( const Scenario* aScenario, const int aPeriod ){}
     virtual void endVisitScenario( const Scenario* aScenario, const int aPeriod ){}
 
@@ -241,6 +244,17 @@ public:
 
     virtual void startVisitNoEmissCarbonCalc( const NoEmissCarbonCalc* aNoEmissCarbonCalc, const int aPeriod ){}
     virtual void endVisitNoEmissCarbonCalc( const NoEmissCarbonCalc* aNoEmissCarbonCalc, const int aPeriod ){}
+protected:
+    /*!
+     * \brief Declare parts of the tree which this visitor does not need.
+     * \details Derived classes call this from their constructor.
+     * \param aContent A combination of IVisitor::VisitContent flags.
+     */
+    void skipContent( const int aContent ) { mSkippedContent |= aContent; }
+
+private:
+    //! The IVisitor::VisitContent flags of the parts of the tree to skip.
+    int mSkippedContent;
 };
 
 #endif // _DEFAULT_VISITOR_H_
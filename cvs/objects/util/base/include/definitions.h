@@ -67,6 +67,18 @@
 #define USE_HECTOR 1
 #endif
 
+//! A flag which turns on or off the compilation of the Marketplace call counters
+//! and timers.
+#ifndef MARKETPLACE_PROFILING
+#define MARKETPLACE_PROFILING 0
+#endif
+
+//! A flag which turns on or off the compilation of the audit of which Values
+//! are written while the model is calculated, see ManageStateVariables.
+#ifndef STATE_AUDIT
+#define STATE_AUDIT 0
+#endif
+
 // This allows for memory leak debugging.
 #if defined(_MSC_VER)
 #   ifdef _DEBUG
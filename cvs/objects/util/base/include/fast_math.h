@@ -0,0 +1,230 @@
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file fast_math.h
+ * \ingroup util
+ * \brief FastMath class header file.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <boost/cstdint.hpp>
+
+/*!
+ * \ingroup util
+ * \brief Replacements for the libm exp, log and pow with a fixed accuracy
+ *        which the discrete choice and CES functions may use instead of
+ *        the libm versions.
+ * \details The functions are written without branches or table lookups so
+ *          that the compiler can inline them and vectorize the loops which
+ *          call them, such as the array versions below.  They are only used
+ *          when enabled with the Bools configuration value
+ *          use-fast-math-kernels, which is read once so that the choice can
+ *          not change during a solution.  Their results are deterministic
+ *          and do not depend on compiler flags such as -ffast-math.
+ *
+ *          Accuracy for finite arguments, relative to the correctly rounded
+ *          result:
+ *          - exp: within 2 ulp.  Results below exp( -708 ), about 3.3e-308,
+ *            are returned as zero rather than as subnormal numbers.
+ *          - log: within 2 ulp, including subnormal arguments.
+ *          - pow: calculated as exp( y * log( x ) ) for positive x, so the
+ *            error of the log is scaled by y * log( x ) and the result is
+ *            within about 2 + |y * log( x )| ulp.  Negative and non-finite
+ *            bases and non-finite exponents are passed to libm.
+ *
+ *          Infinite and NaN arguments give the same results as libm.
+ */
+class FastMath {
+public:
+    static bool isEnabled();
+
+    static double exp( const double aX );
+
+    static double log( const double aX );
+
+    static double pow( const double aBase, const double aExponent );
+
+    static void exp( const double* aX, double* aResult, const size_t aSize );
+
+    static void log( const double* aX, double* aResult, const size_t aSize );
+};
+
+/*!
+ * \ingroup util
+ * \brief The libm functions with the same interface as FastMath so that code
+ *        may be written once as a template over the two.
+ */
+struct StdMath {
+    static double exp( const double aX ) {
+        return std::exp( aX );
+    }
+
+    static double log( const double aX ) {
+        return std::log( aX );
+    }
+
+    static double pow( const double aBase, const double aExponent ) {
+        return std::pow( aBase, aExponent );
+    }
+};
+
+/*!
+ * \brief Calculate e raised to a power.
+ * \details The argument is reduced to x = n * ln( 2 ) + r with |r| <= ln( 2 ) / 2
+ *          and e^r is calculated from its Taylor series to the r^13 term, which
+ *          is truncated well below double precision.  Scaling by 2^n is done
+ *          by building the exponent bits directly.
+ * \param aX The power.
+ * \return e^aX.
+ */
+inline double FastMath::exp( const double aX ) {
+    const double LOG2E = 1.44269504088896340736;
+    // ln( 2 ) split so that n * LN2_HI is exact
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    // adding this rounds to the nearest integer and leaves it in the low bits
+    const double SHIFT = 6755399441055744.0;
+    const double MIN_ARG = -708.0;
+    const double MAX_ARG = 709.782712893384;
+
+    // clamp so that 2^n stays a normal number, out of range values are
+    // fixed up at the end
+    const double x = aX < MIN_ARG ? MIN_ARG : ( aX > MAX_ARG ? MAX_ARG : aX );
+    const double t = x * LOG2E + SHIFT;
+    const double n = t - SHIFT;
+    const double r = ( x - n * LN2_HI ) - n * LN2_LO;
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // The low bits of t hold n, build 2^( n - 1 ) from them and multiply
+    // by 2 separately so that n = 1024 does not overflow the exponent.
+    boost::uint64_t scaleBits;
+    std::memcpy( &scaleBits, &t, sizeof( scaleBits ) );
+    scaleBits = ( scaleBits + 1022 ) << 52;
+    double scale;
+    std::memcpy( &scale, &scaleBits, sizeof( scale ) );
+    const double ret = p * scale * 2.0;
+
+    return aX < MIN_ARG ? 0.0 :
+        ( aX > MAX_ARG ? std::numeric_limits<double>::infinity() :
+        // NaN
+        ( aX != aX ? aX : ret ) );
+}
+
+/*!
+ * \brief Calculate the natural log.
+ * \details The argument is split into x = 2^e * m with sqrt( 1/2 ) < m <= sqrt( 2 )
+ *          and log( m ) is calculated from the series 2 * atanh( s ) with
+ *          s = ( m - 1 ) / ( m + 1 ), which converges quickly since |s| < 0.172.
+ * \param aX The argument.
+ * \return log( aX ).
+ */
+inline double FastMath::log( const double aX ) {
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double SQRT2 = 1.41421356237309504880;
+    const double TWO52 = 4503599627370496.0;
+
+    // scale subnormal arguments into the normal range
+    const bool isSubnormal = aX < std::numeric_limits<double>::min();
+    const double x = isSubnormal ? aX * TWO52 : aX;
+    boost::uint64_t bits;
+    std::memcpy( &bits, &x, sizeof( bits ) );
+    double e = static_cast<double>( static_cast<int>( bits >> 52 ) - 1023 ) - ( isSubnormal ? 52.0 : 0.0 );
+    const boost::uint64_t mantissaBits = ( bits & 0x000fffffffffffffULL ) | 0x3ff0000000000000ULL;
+    double m;
+    std::memcpy( &m, &mantissaBits, sizeof( m ) );
+    const bool isLarge = m > SQRT2;
+    m = isLarge ? m * 0.5 : m;
+    e = isLarge ? e + 1.0 : e;
+
+    const double s = ( m - 1.0 ) / ( m + 1.0 );
+    const double s2 = s * s;
+    double p = 1.0 / 19.0;
+    p = p * s2 + 1.0 / 17.0;
+    p = p * s2 + 1.0 / 15.0;
+    p = p * s2 + 1.0 / 13.0;
+    p = p * s2 + 1.0 / 11.0;
+    p = p * s2 + 1.0 / 9.0;
+    p = p * s2 + 1.0 / 7.0;
+    p = p * s2 + 1.0 / 5.0;
+    p = p * s2 + 1.0 / 3.0;
+    // keep the leading term apart so that it is not rounded with the rest
+    const double logM = 2.0 * s + 2.0 * s * s2 * p;
+    const double ret = e * LN2_HI + ( logM + e * LN2_LO );
+
+    return aX > 0.0 && aX <= std::numeric_limits<double>::max() ? ret :
+        ( aX == 0.0 ? -std::numeric_limits<double>::infinity() :
+        // infinity stays infinity, negative numbers and NaN give NaN
+        ( aX > 0.0 ? aX : std::numeric_limits<double>::quiet_NaN() ) );
+}
+
+/*!
+ * \brief Raise a number to a power.
+ * \param aBase The base.
+ * \param aExponent The exponent.
+ * \return aBase^aExponent.
+ */
+inline double FastMath::pow( const double aBase, const double aExponent ) {
+    if( !( aBase > 0.0 && aBase <= std::numeric_limits<double>::max() ) ||
+        !( std::fabs( aExponent ) <= std::numeric_limits<double>::max() ) )
+    {
+        return std::pow( aBase, aExponent );
+    }
+    return exp( aExponent * log( aBase ) );
+}
+
+#endif // _FAST_MATH_H_
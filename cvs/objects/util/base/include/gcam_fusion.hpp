@@ -869,6 +869,11 @@ struct FilterStep {
 FilterStep* parseFilterStepStr( const std::string& aFilterStepStr );
 std::vector<FilterStep*> parseFilterString( const std::string& aFilterStr );
 
+// helper functions to track when the GCAM object tree may have changed so that
+// the results of a GCAMFusionQuery are no longer valid
+unsigned int getFusionTreeGeneration();
+void markFusionTreeChanged();
+
 /*!
  * \brief The GCAMFusion object is used to search any Data member at any level of
  *        the GCAM hierarchical nesting structure.  Such an object gives a foundation
@@ -1131,4 +1136,121 @@ class GCAMFusion {
     int mCurrStep;
 };
 
+/*!
+ * \brief A GCAMFusion search for a fixed path whose results are kept so that
+ *        repeating it is proportional to the number of matches rather than a
+ *        search of the GCAM object tree.
+ * \details The search string is parsed once into FilterSteps.  The first call
+ *          to find runs the GCAMFusion search and resolves the matches into a
+ *          flat list of pointers, each subsequent call just returns that list
+ *          until the tree changes, as signaled by markFusionTreeChanged (which
+ *          the Scenario calls when objects may have been created), the query is
+ *          run from a different container, or invalidate is called.
+ *
+ *          Only the matches of type T are kept.  For a CONTAINER match the
+ *          pointer to the container object itself is kept, otherwise the address
+ *          of the matched Data is kept so that it may be read or modified.  Note
+ *          the matched Data is the same regardless of the period so the pointers
+ *          are valid as long as the objects which contain them are.
+ *
+ *          For example to get all of the Sectors in the USA:
+ *          GCAMFusionQuery<Sector> usaSectors( "world/region[NamedFilter,StringEquals,USA]/sector" );
+ *          for( Sector* sector : usaSectors.find( scenario ) ) { ... }
+ * \tparam T The type of the matches to keep.
+ */
+template<typename T>
+class GCAMFusionQuery {
+public:
+    /*!
+     * \brief Constructor which parses the search string.
+     * \param aFilterStr The search string as understood by parseFilterString.
+     */
+    GCAMFusionQuery( const std::string& aFilterStr ):mFilterSteps( parseFilterString( aFilterStr ) ),
+    mContainer( 0 ), mGeneration( 0 ), mIsValid( false )
+    {
+    }
+    
+    //! Destructor which frees the FilterSteps.
+    ~GCAMFusionQuery() {
+        for( auto filterStep : mFilterSteps ) {
+            delete filterStep;
+        }
+    }
+    
+    /*!
+     * \brief Get the matches of the search starting from the given container.
+     * \param aContainer Any CONTAINER object from which the search starts.
+     * \return The pointers to each match of type T in the order GCAMFusion found
+     *         them.  The list is valid until the next call to find.
+     */
+    template<typename ContainerType>
+    const std::vector<T*>& find( ContainerType* aContainer ) {
+        if( !mIsValid || mContainer != aContainer || mGeneration != getFusionTreeGeneration() ) {
+            mResults.clear();
+            Collector collector( mResults );
+            GCAMFusion<Collector> search( collector, mFilterSteps );
+            search.startFilter( aContainer );
+            mContainer = aContainer;
+            mGeneration = getFusionTreeGeneration();
+            mIsValid = true;
+        }
+        return mResults;
+    }
+    
+    //! Force the next call to find to run the search again.
+    void invalidate() {
+        mIsValid = false;
+    }
+    
+private:
+    /*!
+     * \brief The GCAMFusion callback which resolves each match of type T into a
+     *        pointer.
+     */
+    struct Collector {
+        Collector( std::vector<T*>& aResults ):mResults( aResults ) {}
+        
+        template<typename DataType>
+        void processData( DataType& aData ) {
+            add( aData, typename boost::is_convertible<DataType, T*>::type(),
+                 typename boost::is_convertible<DataType*, T*>::type() );
+        }
+        
+        // A CONTAINER match is given as a (copy of the) pointer to the container.
+        template<typename DataType, typename IsData>
+        void add( DataType& aData, boost::true_type, IsData ) {
+            mResults.push_back( aData );
+        }
+        
+        // Any other match is given by reference.
+        template<typename DataType>
+        void add( DataType& aData, boost::false_type, boost::true_type ) {
+            mResults.push_back( &aData );
+        }
+        
+        // Matches of any other type are not kept.
+        template<typename DataType>
+        void add( DataType& aData, boost::false_type, boost::false_type ) {
+        }
+        
+        //! The list to which the matches are added.
+        std::vector<T*>& mResults;
+    };
+    
+    //! The parsed search string.
+    std::vector<FilterStep*> mFilterSteps;
+    
+    //! The pointers to each match found in the last search.
+    std::vector<T*> mResults;
+    
+    //! The container the last search was started from.
+    const void* mContainer;
+    
+    //! The value of getFusionTreeGeneration when the last search was run.
+    unsigned int mGeneration;
+    
+    //! Whether mResults may be used.
+    bool mIsValid;
+};
+
 #endif // _GCAM_FUSION_H_
@@ -45,11 +45,12 @@
 */
 #include <string>
 #include <vector>
-#include <memory>
+#include <deque>
+#include <cstring>
+#include <cassert>
 
 #include "util/base/include/atom.h"
 #include <boost/functional/hash/hash.hpp>
-#include <boost/shared_ptr.hpp>
 
 //! Turn on hash map tuning. This imposes a slight overhead.
 #define TUNING_STATS 0
@@ -60,6 +61,39 @@
 #if TUNING_STATS
 #include <iostream>
 #endif
+
+/*!
+* \ingroup Objects
+* \brief The hash function used by the HashMap.
+* \details Strings are hashed by their contents so that a std::string and a
+*          character array holding the same characters hash to the same value.
+*          This allows a map keyed on strings to be searched with a string
+*          literal without constructing a temporary std::string.  All other
+*          key types use boost::hash.
+*/
+struct HashMapHash {
+    size_t operator()( const std::string& aKey ) const {
+        return hashChars( aKey.data(), aKey.size() );
+    }
+
+    size_t operator()( const char* aKey ) const {
+        return hashChars( aKey, strlen( aKey ) );
+    }
+
+    size_t operator()( char* aKey ) const {
+        return hashChars( aKey, strlen( aKey ) );
+    }
+
+    template<class T>
+    size_t operator()( const T& aKey ) const {
+        return boost::hash<T>()( aKey );
+    }
+
+    static size_t hashChars( const char* aChars, const size_t aLength ) {
+        return boost::hash_range( aChars, aChars + aLength );
+    }
+};
+
 /*!
 * \ingroup Objects
 * \brief A template object which implements a mapping of key to value using a
@@ -70,158 +104,147 @@
 *          key into a pseudo-random value distributed over the range of the
 *          internal storage array. If the hash function converts two distinct
 *          keys into the same value, a collision occurs which the map must
-*          handle. The hash map is implemented as a list of buckets, accessed by
-*          an integer index. Each bucket can contain a single key-value pairing,
-*          or a chain of pairings implemented as a linked list. If there are no
-*          collisions, then each bucket only contains a single key-value pair.
-*          When a collision does occur, the collided values are placed in the
-*          bucket's chain. As a result of this design, access to a value given a
-*          key can occur in constant time unless there is a collision on the
-*          key. To minimize collisions, the hashmap automatically increases its
-*          size to prevent the map from reaching over 40 percent of its
-*          capacity.
+*          handle.
+*
+*          The map uses open addressing with Robin Hood probing.  The slot
+*          array is a flat power of two sized vector in which each slot holds
+*          the full hash of its key and the index of the key-value pair in the
+*          entry storage.  A lookup walks consecutive slots starting at the
+*          hash position, only comparing keys when the stored hashes match, and
+*          stops as soon as it reaches a slot which is closer to its own home
+*          position than the key being searched for would be.  This keeps
+*          probe sequences short and contiguous in memory, and the stored
+*          hashes mean that growing the slot array never rehashes a key.  The
+*          slot array is grown when it becomes more than 80 percent full.
+*
+*          The key-value pairs themselves are kept in insertion order in a
+*          deque which is never reordered.  References to values therefore
+*          remain valid when other keys are inserted, which callers such as
+*          Info rely on.  Iterators do not, since inserting into a deque
+*          invalidates them.  Iteration is in insertion order.
+*
+*          The find functions are templated on the type of the key searched
+*          for, which must be hashable by HashMapHash consistently with Key
+*          and comparable with Key.  For string keys this allows searching
+*          with a const char*.  A hash computed once with getHash may also be
+*          passed to find to avoid rehashing a key which is looked up in
+*          several maps.
 * \note This is not currently a complete map implementation, it only allows for
-*       getting and setting individual values. There is currently not a way to
-*       iterate over the key-value set or remove keys from the map.
+*       getting, setting and iterating over individual values. There is
+*       currently not a way to remove keys from the map.
 * \note The Value type is required to implement the no-argument constructor.
 *       This condition must be true for standard library containers as well.
-* \note Do not use auto_ptrs as Values as they may be accidentally deleted during
-*       resizes. This is true of standard library containers as well.
+* \note Do not use auto_ptrs as Values as they may be accidentally deleted
+*       when copied into the map. This is true of standard library containers
+*       as well.
 * \author Josh Lurz
 */
 
 template <class Key, class Value>
 class HashMap {
 private:
-	// Forward declare the Item so the interface is easier to read.
-	struct Item;
-
-    //! Typedef which defines the type of a pair containing pointer to an Item
-    //! and it's position in the bucket vector.
-    typedef std::pair<Item*,size_t> ItemPair;
-    typedef std::pair<const Item*, size_t> CItemPair;
+    //! The storage type of the key-value pairs.
+    typedef std::deque<std::pair<Key, Value> > EntryList;
 public:
-	/*! \brief Constant iterator to a HashMap. */
-	class const_iterator {
-	public:
-        const_iterator();
-		explicit const_iterator( const Item* aCurrentItem,
-                                 const size_t aBucketPosition,
-                                 const HashMap* aParent );
-
-		bool operator==( const const_iterator& aOther ) const;
-		bool operator!=( const const_iterator& aOther ) const;
-		const std::pair<Key, Value>* operator->() const;
-		const std::pair<Key, Value>& operator*() const;
-        const_iterator& operator++();    // prefix ++
-        const_iterator operator++(int); // postfix ++
-	protected:
-        //! The current item at which the iterator is pointing and it's bucket
-        //! spot.
-        CItemPair mCurrentItem;
-
-        //! Pointer to the parent hashmap of the iterator.
-        const HashMap* mParent;
-	};
-
-	/*! \brief Mutable iterator to a HashMap.
-	*/
-    class iterator: public const_iterator {
-	public:
-        iterator();
-		explicit iterator( Item* aCurrentItem,
-                           const size_t aBucketPosition,
-                           const HashMap* aParent );
-
-		bool operator==( const iterator& aOther ) const;
-		bool operator!=( const iterator& aOther ) const;
-		std::pair<Key, Value>* operator->();
-		std::pair<Key, Value>& operator*();
-        iterator& operator++();    // prefix ++
-        iterator operator++(int); // postfix ++
-	};
-	
-	explicit HashMap( const size_t aSize = DEFAULT_SIZE );
-	~HashMap();
+    /*! \brief Mutable iterator to a HashMap. */
+    typedef typename EntryList::iterator iterator;
+
+    /*! \brief Constant iterator to a HashMap. */
+    typedef typename EntryList::const_iterator const_iterator;
+
+    explicit HashMap( const size_t aSize = DEFAULT_SIZE );
+    ~HashMap();
     bool empty() const;
     size_t size() const;
-	std::pair<iterator, bool> insert( const std::pair<Key, Value> aKeyValuePair );
+    std::pair<iterator, bool> insert( const std::pair<Key, Value> aKeyValuePair );
     Value& operator[]( const Key& aKey );
-	const_iterator find( const Key& aKey ) const;
-	iterator find( const Key& aKey );
-	const_iterator begin() const;
-	iterator begin();
-	const_iterator end() const;
-	iterator end();
+
+    template<class K>
+    const_iterator find( const K& aKey ) const;
+
+    template<class K>
+    iterator find( const K& aKey );
+
+    template<class K>
+    const_iterator find( const K& aKey, const size_t aHash ) const;
+
+    template<class K>
+    iterator find( const K& aKey, const size_t aHash );
+
+    const_iterator begin() const;
+    iterator begin();
+    const_iterator end() const;
+    iterator end();
+
+    /*! \brief Calculate the hash of a key as used by the map.
+    * \param aKey The key to hash.
+    * \return The hash of the key.
+    */
+    template<class K>
+    static size_t getHash( const K& aKey ) {
+        return HashMapHash()( aKey );
+    }
 private:
-	void resize( const size_t aNewSize );
-    
-    CItemPair getFirstItem() const;
-    CItemPair getNextItem( const CItemPair& aItemPair ) const;
-    
-    ItemPair getFirstItem();
-    ItemPair getNextItem( const ItemPair& aItemPair );
-
-	//! The internal storage for the buckets.
-	std::vector<boost::shared_ptr<Item> > mBuckets;
-
-	//! Current size of the storage vector, which is greater than the number of
-    //! values.
-	size_t mSize;
-
-	//! Number of entries.
-	size_t mNumEntries;
-
-	//! The hashmap's hash function
-	boost::hash<Key> mHashFunction;
-
-	/*! \brief An item stores a key value pairing together.
-	* \details The Item structure stores the key value pairing, along with a
-	*          pointer to the next item in the bucket to allow chaining.
+    /*! \brief A slot in the open addressed table.
+    * \details An empty slot has an mEntry of zero, otherwise mEntry is one
+    *          more than the index of the key-value pair in the entry storage.
     */
-	struct Item {
-		inline Item( const std::pair<Key, Value>& aKeyValuePair );
-		/*! \brief The key value pair.
-        */
-		std::pair<Key, Value> mKeyValuePair;
-
-		/*! \brief A pointer to the next Item in the bucket, null if it is the
-		*          last item in the bucket.
-		* \note The use of a smart pointer allows for an entire chain to be
-        *       deleted by deleting the head of the chain, which induces a
-        *       cascading deletion.
-        */
-		boost::shared_ptr<Item> mNext;
-	};
+    struct Slot {
+        //! The full hash of the key.
+        size_t mHash;
+
+        //! One more than the index of the entry, zero if the slot is empty.
+        size_t mEntry;
+    };
+
+    template<class K>
+    size_t findEntry( const K& aKey, const size_t aHash ) const;
+
+    void placeSlot( Slot aSlot );
+
+    size_t getProbeDistance( const size_t aPosition, const size_t aHash ) const;
+
+    void resize( const size_t aNewSize );
+
+    //! The open addressed slot array, which has a power of two size.
+    std::vector<Slot> mSlots;
+
+    //! The mask which reduces a hash to a position in the slot array.
+    size_t mMask;
+
+    //! The key-value pairs in insertion order.
+    EntryList mEntries;
 
 #if( TUNING_STATS )
-	//! Number of collisions if TUNING_STATS is on.
-	unsigned int mNumCollisions;
+    //! Number of collisions if TUNING_STATS is on.
+    unsigned int mNumCollisions;
 
-	//! Number of resizes if TUNING_STATS is on.
-	unsigned int mNumResizes;
+    //! Number of resizes if TUNING_STATS is on.
+    unsigned int mNumResizes;
 #endif
 };
 
 /*! \brief Constructor
-* \details Construct a hashmap with a specified size.
-* \param aSize The initial size of the map. The map may grow from this size if
-*        enough entries are added.
+* \details Construct a hashmap with room for a specified number of entries.
+* \param aSize The number of entries for which to initially allocate space.
+*        The map may grow from this size if enough entries are added.
 */
 template <class Key, class Value>
 HashMap<Key, Value>::HashMap( const size_t aSize ):
-mBuckets( aSize ), mSize( aSize ), mNumEntries( 0 )
+mMask( 0 )
 #if( TUNING_STATS )
 , mNumCollisions( 0 ),
 mNumResizes( 0 )
 #endif
 {
+    // Leave enough room that aSize entries do not exceed the capacity
+    // threshold.
+    resize( aSize + aSize / 4 + 1 );
 }
 
 /*! \brief Destructor
-* \details All memory deallocation is performed by the smart pointers, the
-*          destructor is only responsible for printing hash map statistics(if
-*          TUNING_STATS is compiled on).
+* \details The destructor is only responsible for printing hash map
+*          statistics(if TUNING_STATS is compiled on).
 * \warning Deleting the map will not delete any allocated memory the user
 *          specified as a value, which is congruent to how standard library
 *          containers are implemented.
@@ -229,11 +252,11 @@ mNumResizes( 0 )
 template <class Key, class Value>
 HashMap<Key, Value>::~HashMap(){
 #if( TUNING_STATS )
-	std::cout << "Hashmap stats - Size: " << static_cast<unsigned int>( mSize ) 
-		<< " Number of entries: " << static_cast<unsigned int>( mNumEntries )
-		<< " Collisions: " << mNumCollisions << " Percent full : " 
-		<< static_cast<double>( mNumEntries ) / mSize * 100 
-		<< " Number of resizes: " << mNumResizes << std::endl;
+    std::cout << "Hashmap stats - Size: " << static_cast<unsigned int>( mSlots.size() ) 
+        << " Number of entries: " << static_cast<unsigned int>( mEntries.size() )
+        << " Collisions: " << mNumCollisions << " Percent full : " 
+        << static_cast<double>( mEntries.size() ) / mSlots.size() * 100 
+        << " Number of resizes: " << mNumResizes << std::endl;
 #endif
 }
 
@@ -243,7 +266,7 @@ HashMap<Key, Value>::~HashMap(){
 template <class Key, class Value>
 bool
 HashMap<Key, Value>::empty() const {
-    return mNumEntries == 0;
+    return mEntries.empty();
 }
 
 /*! \brief Return the number of items in the hashmap.
@@ -252,18 +275,14 @@ HashMap<Key, Value>::empty() const {
 template <class Key, class Value>
 size_t
 HashMap<Key, Value>::size() const {
-    return mNumEntries;
+    return mEntries.size();
 }
 
 /*! \brief Insert a key-value pair to the map.
 * \details This function takes a key value pairing and adds it to the hashmap.
-*          To do this, it first calls the hash function on the key to determine
-*          which bucket the item should reside in. If the bucket is currently
-*          empty, the item is added as the first item in the bucket. Otherwise
-*          the linked list is traversed to see if the item already exists. If it
-*          does, the value is updated and the function will return true.
-*          Otherwise an item is added to the end of the list for this key-value
-*          pairing.
+*          If the key already exists the value is updated and the function will
+*          return false. Otherwise the pair is appended to the entry storage
+*          and a slot for it is placed in the slot array.
 * \param aKeyValuePair The key value pair to add to the hashmap.
 * \return A pair consisting of the iterator where the value was found and a bool
 *         representing whether the insert was a new value.
@@ -271,93 +290,36 @@ HashMap<Key, Value>::size() const {
 template <class Key, class Value>
 std::pair<typename HashMap<Key, Value>::iterator, bool>
 HashMap<Key, Value>::insert( const std::pair<Key, Value> aKeyValuePair ){
-	// First find the hash value and use the modulo function to reduce it to
-	// within the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKeyValuePair.first ) % mSize;
-
-	// We now know which bucket to either add the value to or update. Begin the
-    // search.
-	Item* curr = mBuckets[ bucketSpot ].get();
-	Item* prev = 0;   
-
-	// If the head of the chain is null, avoid attempting to search. Keep
-	// searching until we find the correct Item or the end of the chain. Track
-	// the previous position in the chain so that we can add to the end if the
-	// key is not found.
-	bool update = false;
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKeyValuePair.first ){
-			// Stop the search here as this is the postion to update.
-			update = true;
-			break;
-		}
-
-		// Move to the next item in the chain, which may be null.
-		prev = curr;
-
-		/*! \invariant Ensure that a pointer is not being assigned a reference
-        *              to itself. 
-        */
-		assert( curr != curr->mNext.get() );
-
-		curr = curr->mNext.get();
-	}
-
-	// If we found a spot to update, curr will not be null as the loop will have
-	// been exited by the successful match. Update the value and return that the
-	// value existed.
-	if( update ){
-		curr->mKeyValuePair.second = aKeyValuePair.second;
-		return std::make_pair( iterator( curr, bucketSpot, this ), false );
-	}
-
-	// We are not updating, so a new value must be added.
-	boost::shared_ptr<Item> newValue( new Item( aKeyValuePair ) );
-	++mNumEntries;
-
-	// Add the entry as the first item in the bucket if there is not a previous
-    // pairing.
-	if( !prev ){
-		mBuckets[ bucketSpot ] = newValue;
-	}
-	else {
-		/*! \invariant Ensure that a loop is not created. */
-		assert( prev != newValue.get() );
-
-		// Add the new item to the end of the chain.
-		prev->mNext = newValue;
-#if( TUNING_STATS )
-		// Record the collision.
-		++mNumCollisions;
-#endif
-	}
-	// The ratio of entries to the maximum size of the map at which to increase
-	// the map size. This is currently a low threshold as the maps are adjusted
-    // for performance not size. This may need to be adjusted for small maps.
-	const double CAPACITY_THRESHHOLD = 0.4;
-
-	// The multiple of the current size to which to set the new size.
-	const unsigned int RESIZE_MULTIPLE = 3;
-
-	// An additional size increment which helps performance for small maps where
-    // resizing by the above factor would not be enough.
-	const unsigned int ADDITIONAL_INCREMENT = 5;
-
-	// Check if the size of the bucket vector should be increased for
-	// performance. This should be done if the ratio of full to total buckets
-	// exceeds CAPACITY_THRESHHOLD.
-	if( static_cast<double>( mNumEntries ) / mSize > CAPACITY_THRESHHOLD ){
-		// Resize to three times the number of current entries plus several
-		// extra to handle small hashmaps. The bucket was empty, so add it as
-		// the first value.
+    const size_t hash = getHash( aKeyValuePair.first );
+    const size_t entry = findEntry( aKeyValuePair.first, hash );
+
+    // If we found the key update the value and return that the value existed.
+    if( entry != 0 ){
+        iterator curr = mEntries.begin() + ( entry - 1 );
+        curr->second = aKeyValuePair.second;
+        return std::make_pair( curr, false );
+    }
+
+    // The ratio of entries to the size of the slot array at which to increase
+    // the size. Robin Hood probing keeps probe sequences short up to fairly
+    // high loads.
+    const double CAPACITY_THRESHHOLD = 0.8;
+
+    // Grow the slot array before adding if the new entry would exceed the
+    // threshold.
+    if( static_cast<double>( mEntries.size() + 1 ) > CAPACITY_THRESHHOLD * mSlots.size() ){
 #if( TUNING_STATS )
-		++mNumResizes;
+        ++mNumResizes;
 #endif
-		resize( mNumEntries * RESIZE_MULTIPLE + ADDITIONAL_INCREMENT );
-	}
-	// Return that an add and not an update occurred.
-	return std::make_pair( iterator( newValue.get(), bucketSpot, this ), true );
+        resize( mSlots.size() * 2 );
+    }
+
+    mEntries.push_back( aKeyValuePair );
+    Slot newSlot = { hash, mEntries.size() };
+    placeSlot( newSlot );
+
+    // Return that an add and not an update occurred.
+    return std::make_pair( mEntries.end() - 1, true );
 }
 
 /*!
@@ -372,8 +334,7 @@ template <class Key, class Value>
 Value&
 HashMap<Key, Value>::operator[]( const Key& aKey ){
     // Check if the key already exists.
-    typedef typename HashMap<Key, Value>::iterator hashMapIterator;
-    hashMapIterator currValue = find( aKey );
+    iterator currValue = find( aKey );
 
     // Return the value if it already exists.
     if( currValue != end() ){
@@ -381,510 +342,199 @@ HashMap<Key, Value>::operator[]( const Key& aKey ){
     }
 
     // Insert the default value.
-    std::pair<iterator, bool> newPair = insert( make_pair( aKey, Value() ) );
+    std::pair<iterator, bool> newPair = insert( std::make_pair( aKey, Value() ) );
     assert( newPair.second );
-
-    // The first value in the iterator is a pair<Key, Value&>, so return the
-    // first->second.
     return newPair.first->second;
 }
 
 /*! \brief Returns a mutable iterator for a given key.
-* \details
 * \param aKey Key for which to return the value.
 * \return An iterator to the requested value or the end iterator if the key was
 *         not found.
 */
 template <class Key, class Value>
+template <class K>
 typename HashMap<Key, Value>::iterator
-HashMap<Key, Value>::find( const Key& aKey ){
-	// First find the hash value and use the modulus function to reduce it to
-	// within the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKey ) % mSize;
-
-	// We now know which bucket the key resides in if it exists.
-	Item* curr = mBuckets[ bucketSpot ].get();
-
-	// Keep searching until we find the correct Item or the end of the chain.
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKey ){
-			return iterator( curr, bucketSpot, this );
-		}
-		// Move to the next item in the chain, which may be null.
-		curr = curr->mNext.get();
-	}
-	// Return the end iterator is the key was not found.
-	return end();
+HashMap<Key, Value>::find( const K& aKey ){
+    return find( aKey, getHash( aKey ) );
 }
 
 /*! \brief Returns an immutable value for a given key.
-* \details
 * \param aKey Key for which to return the value.
 * \return A constant iterator to the result or the end iterator if the key is
 *         not found.
 */
 template <class Key, class Value>
+template <class K>
 typename HashMap<Key, Value>::const_iterator
-HashMap<Key, Value>::find( const Key& aKey ) const {
-	// First find the hash value and use the mod function to reduce it to within
-	// the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKey ) % mSize;
-
-	// We now know which bucket the key resides in if it exists.
-	const Item* curr = mBuckets[ bucketSpot ].get();
-
-	// Keep searching until we find the correct Item or the end of the chain.
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKey ){
-			return const_iterator( curr, bucketSpot, this );
-		}
-		// Move to the next item in the chain, which may be null.
-		curr = curr->mNext.get();
-	}
-	// Return the end iterator is the key was not found.
-	return end();
+HashMap<Key, Value>::find( const K& aKey ) const {
+    return find( aKey, getHash( aKey ) );
+}
+
+/*! \brief Returns a mutable iterator for a given key and its hash.
+* \param aKey Key for which to return the value.
+* \param aHash The hash of the key as returned by getHash.
+* \return An iterator to the requested value or the end iterator if the key was
+*         not found.
+*/
+template <class Key, class Value>
+template <class K>
+typename HashMap<Key, Value>::iterator
+HashMap<Key, Value>::find( const K& aKey, const size_t aHash ){
+    const size_t entry = findEntry( aKey, aHash );
+    return entry != 0 ? mEntries.begin() + ( entry - 1 ) : mEntries.end();
+}
+
+/*! \brief Returns an immutable value for a given key and its hash.
+* \param aKey Key for which to return the value.
+* \param aHash The hash of the key as returned by getHash.
+* \return A constant iterator to the result or the end iterator if the key is
+*         not found.
+*/
+template <class Key, class Value>
+template <class K>
+typename HashMap<Key, Value>::const_iterator
+HashMap<Key, Value>::find( const K& aKey, const size_t aHash ) const {
+    const size_t entry = findEntry( aKey, aHash );
+    return entry != 0 ? mEntries.begin() + ( entry - 1 ) : mEntries.end();
 }
 
 /*! \brief Return the begin iterator.
-* \details
 * \return The begin iterator.
 */
 template<class Key, class Value>
 typename HashMap<Key, Value>::iterator
 HashMap<Key, Value>::begin() {
-    ItemPair itemPair = getFirstItem();
-	return iterator( itemPair.first, itemPair.second, this );
+    return mEntries.begin();
 }
 
 /*! \brief Return the constant begin iterator.
-* \details
 * \return The constant begin iterator.
 */
 template<class Key, class Value>
 typename HashMap<Key, Value>::const_iterator
 HashMap<Key, Value>::begin() const {
-    CItemPair itemPair = getFirstItem();
-	return const_iterator( itemPair.first, itemPair.second, this );
+    return mEntries.begin();
 }
 
 /*! \brief Return the end iterator.
-* \details
 * \return The end iterator.
 */
 template<class Key, class Value>
 typename HashMap<Key, Value>::iterator
 HashMap<Key, Value>::end() {
-	return iterator( 0, 0, 0 );
+    return mEntries.end();
 }
 
 /*! \brief Return the constant end iterator.
-* \details
 * \return The constant end iterator.
 */
 template<class Key, class Value>
 typename HashMap<Key, Value>::const_iterator
 HashMap<Key, Value>::end() const {
-	return const_iterator( 0, 0, 0 );
+    return mEntries.end();
 }
 
-/*! \brief Resize the bucket vector. 
-* \details To resize the vector, the function first walks the hashmap to store
-*          the list of all items in the map. It then resizes the bucket vector
-*          and reinserts all the values into the map.
-* \warning This operation is very slow as it requires rehashing all entries.
-* \param aNewSize New size of the bucket vector.
+/*! \brief Search the slot array for a key.
+* \details Walks the slots starting at the home position of the hash. The
+*          search ends at an empty slot or at a slot whose entry is closer to
+*          its own home position than the key would be at this point, since
+*          Robin Hood placement would have put the key there.
+* \param aKey The key to search for.
+* \param aHash The hash of the key.
+* \return One more than the index of the entry, or zero if the key is not in
+*         the map.
 */
 template<class Key, class Value>
-void HashMap<Key, Value>::resize( const size_t aNewSize ){
-	// Check if the new and old size are the same to avoid resizing.
-	if( aNewSize == mSize ){
-		return;
-	}
-
-	// Walk the hashmap and create a list of all items in the tree. Create a
-	// temporary vector to hold all the entries.
-	std::vector<boost::shared_ptr<Item> > temporaryList;
-
-	// Iterate over the buckets.
-	for( unsigned int i = 0; i < mSize; ++i ){
-		// Set a pointer to the first item in the bucket.
-		boost::shared_ptr<Item> curr = mBuckets[ i ];
-		// Add all items in the chain to the temporary list.
-		while( curr.get() ){
-			temporaryList.push_back( curr );
-			
-			/*! \invariant Ensure that no pointer refers to itself. */
-			assert( curr.get() != curr->mNext.get() );
-
-			// Move to the next item in the chain.
-			curr = curr->mNext;
-		}
-	}
-	// Check that the temporary list contains all entries.
-	assert( temporaryList.size() == mNumEntries );
-
-	// Resize the bucket vector.
-	mSize = aNewSize;
-	// Clear the bucket vector before resizing so all pointers are null, not
-	// pointing at old values.
-	mBuckets.clear();
-	mBuckets.resize( mSize );
-
-#if( TUNING_STATS )
-	// Reset the collision count.
-	mNumCollisions = 0;
-#endif
-	// Now add each item back to the list. Can't use the add function as we
-	// already have allocated items and we don't want to change the count of the
-	// number of entries.
-	for( unsigned int i = 0; i < temporaryList.size(); ++i ){
-		/*! \invariant Every position in the temporary list has a valid pointer. */
-		assert( temporaryList[ i ].get() );
-		
-		/*! \invariant There is a second reference to the item pointed to by the
-        *              next pointer. 
-        */
-		assert( !temporaryList[ i ]->mNext.unique() );
-		
-		// Clear out the next pointer as it is no longer valid. The temporary
-		// list is holding a reference to all items in the list, so this cannot
-        // cause a deallocation.
-		temporaryList[ i ]->mNext.reset();
-
-		// Add a single item to the map. Find the hash value and use the mod
-        // function to reduce it to within the size of the bucket vector.
-		const size_t bucketSpot = mHashFunction( temporaryList[ i ]->mKeyValuePair.first ) % mSize;
-
-		// We now know which bucket the key resides in if it exists.
-		Item* curr = mBuckets[ bucketSpot ].get();
-
-		// If the spot is null, add this item as the head of the bucket's chain.
-		if( !curr ){
-			mBuckets[ bucketSpot ] = temporaryList[ i ];
-		}
-		// Otherwise we need to search for the end of the current bucket's
-        // chain.
-		else {
-			while( curr->mNext.get() ){
-				/*! \invariant Ensure that no pointer refers to itself. */
-				assert( curr != curr->mNext.get() );
-				
-				curr = curr->mNext.get();
-			}
-			// Curr now points to the last item in the chain, add the current
-			// item as the end of the chain.
-			/*! \invariant Ensure that no pointer refers to itself. */
-			assert( curr != temporaryList[ i ].get() );
-
-			curr->mNext = temporaryList[ i ];
-#if( TUNING_STATS )
-			// Record the collision.
-			++mNumCollisions;
-#endif
-		}
-	}
-}
-
-/*! \brief Find the first item in the hashmap.
-* \details This function is used to initialize the constant begin iterator. It
-*          returns a pair containing a constant pointer to the first item and
-*          the position of the item in the bucket vector.
-* \return A pair containing a constant pointer to the first item and its
-*         position in the bucket vector. If the vector is empty this will return
-*         a pair containing null and zero.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::CItemPair
-HashMap<Key, Value>::getFirstItem() const {
-    // Check for empty hashmap first to avoid a slow unsuccessful search.
-    if( empty() ){
-        return CItemPair( static_cast<Item*>( 0 ), 0 );
-    }
-
-    // Search starting at the beginning of the bucket vector to find the first
-    // item.
-    for( unsigned int i = 0; i < mBuckets.size(); i++ ){
-        if( mBuckets[ i ] ){
-            return CItemPair( mBuckets[ i ].get() , i );
+template<class K>
+size_t HashMap<Key, Value>::findEntry( const K& aKey, const size_t aHash ) const {
+    size_t position = aHash & mMask;
+    for( size_t distance = 0; ; ++distance ){
+        const Slot& curr = mSlots[ position ];
+        if( curr.mEntry == 0 || getProbeDistance( position, curr.mHash ) < distance ){
+            return 0;
         }
-    }
-
-    /*! \post An item must have been found because this function initially
-    *         checks for an empty list. 
-    */
-    assert( false );
-    
-    // Make the compiler happy.
-    return CItemPair( static_cast<Item*>( 0 ), 0 );
-}
-
-/*! \brief Return the next item in the hashmap.
-* \details This function is used by the iterator to find the next value in the
-*          hashmap.
-* \param aItemPair A pair containing the current item and its bucket position.
-* \return A pair containing the next item and its bucket position or the end
-*         iterator if it was the last item.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::CItemPair
-HashMap<Key, Value>::getNextItem( const CItemPair& aItemPair ) const {
-    // First check if there is a next item in the current item's chain.
-    if( aItemPair.first->mNext ){
-        // Return a pair containing the next item and the current bucket spot
-        // since the item is in the same chain.
-        return CItemPair( aItemPair.first->mNext.get(), aItemPair.second );
-    }
-
-    // Otherwise search forward in the bucket vector starting at the current position.
-    for( size_t i = aItemPair.second + 1; i < mBuckets.size(); ++i ){
-        // If there is an item at this bucket position return it.
-        if( mBuckets[ i ] ){
-            return CItemPair( mBuckets[ i ].get(), i );
+        if( curr.mHash == aHash && mEntries[ curr.mEntry - 1 ].first == aKey ){
+            return curr.mEntry;
         }
+        position = ( position + 1 ) & mMask;
     }
-
-    // The end of the bucket vector was reached so there is not a next item.
-    return CItemPair( static_cast<Item*>( 0 ), 0 );
 }
 
-/*! \brief Find the first item in the hashmap.
-* \details This function is used to initialize the begin iterator. It returns a
-*          pair containing a pointer to the first item and the position of the
-*          item in the bucket vector.
-* \return A pair containing a pointer to the first item and its position in the
-*         bucket vector. If the vector is empty this will return a pair
-*         containing null and zero.
+/*! \brief Place a slot for a new entry in the slot array.
+* \details Walks the slots from the home position of the new slot and swaps it
+*          with any slot which is closer to its home position, continuing with
+*          the displaced slot, until an empty slot is reached. The slot array
+*          must have at least one empty slot.
+* \param aSlot The slot to place.
 */
 template<class Key, class Value>
-typename HashMap<Key, Value>::ItemPair HashMap<Key, Value>::getFirstItem() {
-    // Check for empty hashmap first to avoid a slow unsuccessful search.
-    if( empty() ){
-        return ItemPair( static_cast<Item*>( 0 ), 0 );
-    }
-
-    // Search starting at the beginning of the bucket vector to find the first
-    // item.
-    for( unsigned int i = 0; i < mBuckets.size(); i++ ){
-        if( mBuckets[ i ] ){
-            return ItemPair( mBuckets[ i ].get(), i );
+void HashMap<Key, Value>::placeSlot( Slot aSlot ){
+    size_t position = aSlot.mHash & mMask;
+    for( size_t distance = 0; ; ++distance ){
+        Slot& curr = mSlots[ position ];
+        if( curr.mEntry == 0 ){
+            curr = aSlot;
+            return;
         }
-    }
-
-    /*! \post An item must have been found because this function initially
-    *         checks for an empty list. 
-    */
-    assert( false );
-    
-    // Make the compiler happy.
-    return ItemPair( static_cast<Item*>( 0 ), 0 );
-}
-
-/*! \brief Return the next item in the hashmap.
-* \details This function is used by the iterator to find the next value in the
-*          hashmap.
-* \param aItemPair A pair containing the current item and its bucket position.
-* \return A pair containing the next item and its bucket position or the end
-*         iterator if it was the last item.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::ItemPair
-HashMap<Key, Value>::getNextItem( const ItemPair& aItemPair ) {
-    // First check if there is a next item in the current item's chain.
-    if( aItemPair.first->mNext ){
-        // Return a pair containing the next item and the current bucket spot
-        // since the item is in the same chain.
-        return ItemPair( aItemPair.first->mNext, aItemPair.second );
-    }
-
-    // Otherwise search forward in the bucket vector starting at the current position.
-    for( size_t i = aItemPair.second + 1; i < mBuckets.size(); ++i ){
-        // If there is an item at this bucket position return it.
-        if( mBuckets[ i ] ){
-            return ItemPair( mBuckets[ i ], i );
+#if( TUNING_STATS )
+        // Record the collision.
+        ++mNumCollisions;
+#endif
+        const size_t currDistance = getProbeDistance( position, curr.mHash );
+        if( currDistance < distance ){
+            std::swap( curr, aSlot );
+            distance = currDistance;
         }
+        position = ( position + 1 ) & mMask;
     }
-
-    // The end of the bucket vector was reached so there is not a next item.
-    return end();
-}
-
-// ItemPair getNextItem( const ItemPair& aItemPair );
-/*! \brief Item structure constructor.
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-HashMap<Key, Value>::Item::Item( const std::pair<Key, Value>& aKeyValuePair ):
-mKeyValuePair( aKeyValuePair ){
 }
 
-/*! \brief iterator constructor which sets the internal pointer to null.
+/*! \brief Return how far a position is from the home position of a hash.
+* \param aPosition A position in the slot array.
+* \param aHash The hash stored at the position.
+* \return The number of slots between the home position and aPosition.
 */
 template<class Key, class Value>
-HashMap<Key, Value>::iterator::iterator(){}
-
-/*! \brief iterator constructor.
-* \param aCurrentItem The current Item.
-* \param aBucketPosition The position of the Item in the bucket vector.
-* \param aParent A pointer to the parent hashmap.
-*/
-template<class Key, class Value>
-HashMap<Key, Value>::iterator::iterator( Item* aCurrentItem,
-                                         const size_t aBucketPosition,
-                                         const HashMap* aParent ):
-const_iterator( aCurrentItem, aBucketPosition, aParent ){
-}
-
-/*! \brief Equals operator
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-bool HashMap<Key, Value>::iterator::operator ==( const typename HashMap<Key, Value>::iterator& aOther ) const {
-    return const_iterator::operator==( aOther );
-}
-
-/*! \brief Not-equals operator
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-bool HashMap<Key, Value>::iterator::operator !=( const typename HashMap<Key, Value>::iterator& aOther ) const {
-	return !( *this == aOther );
-}
-
-/*! \brief Pointer dereference operator
-* \return A pointer to the key value pair.
-*/
-template<class Key, class Value>
-std::pair<Key, Value>* HashMap<Key, Value>::iterator::operator->(){
-	/*! \pre The current item pointer must be non-null. */
-	assert( const_iterator::mCurrentItem.first != 0 );
-
-    // The mCurrentItem is inherited from const_iterator and must be cast so
-    // that the return value is mutable.
-	return const_cast<std::pair<Key, Value>*>( &const_iterator::mCurrentItem.first->mKeyValuePair );
-}
-
-/*! \brief Dereference operator
-* \return A reference to the key value pair.
-*/
-template<class Key, class Value>
-std::pair<Key, Value>& HashMap<Key, Value>::iterator::operator*() {
-	/*! \pre The current item pointer must be non-null. */
-	assert( const_iterator::mCurrentItem.first != 0 );
-
-    // The mCurrentItem is inherited from const_iterator and must be cast so
-    // that the return value is mutable.
-	return const_cast<std::pair<Key, Value>&>( const_iterator::mCurrentItem.first->mKeyValuePair );
-}
-
-/*! \brief Prefix increment operator.
-* \return The incremented iterator.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::iterator&
-HashMap<Key, Value>::iterator::operator++(){
-    /*! \pre Need a non-null parent hashmap. */
-    assert( const_iterator::mParent );
-
-    const_iterator::mCurrentItem = const_iterator::mParent->getNextItem( const_iterator::mCurrentItem );
-    return *this;
-}
-
-/*! \brief Postfix increment operator.
-* \return The iterator before it is incremented.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::iterator
-HashMap<Key, Value>::iterator::operator++ (int){
-   iterator curr = *this;
-   ++(*this);
-   return curr;
- }
-
-/*! \brief const_iterator constructor which sets the internal pointer to null.
-*/
-template<class Key, class Value>
-HashMap<Key, Value>::const_iterator::const_iterator():
-mCurrentItem( 0, 0 ),
-mParent( 0 ){}
-
-/*! \brief const_iterator constructor.
-* \param aCurrentItem The current Item.
-* \param aBucketPosition The position of the current Item within the bucket
-*        vector.
-*/
-template<class Key, class Value>
-HashMap<Key, Value>::const_iterator::const_iterator( const Item* aCurrentItem,
-                                                     const size_t aBucketPosition,
-                                                     const HashMap* aParent )
-:mCurrentItem( aCurrentItem, aBucketPosition ),
-mParent( aParent ){
-}
-
-/*! \brief Equals operator
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-bool HashMap<Key, Value>::const_iterator::operator ==( const typename HashMap<Key, Value>::const_iterator& aOther ) const {
-	return ( mCurrentItem == aOther.mCurrentItem );
-}
-
-/*! \brief Not-equals operator
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-bool HashMap<Key, Value>::const_iterator::operator !=( const typename HashMap<Key, Value>::const_iterator& aOther ) const {
-	return !( *this == aOther );
-}
-
-/*! \brief Pointer dereference operator
-* \return A pointer to the key value pair.
-*/
-template<class Key, class Value>
-const std::pair<Key, Value>* HashMap<Key, Value>::const_iterator::operator->() const {
-	/*! \pre The current item pointer must be non-null. */
-	assert( mCurrentItem.first != 0 );
-	return &mCurrentItem.first->mKeyValuePair;
+size_t HashMap<Key, Value>::getProbeDistance( const size_t aPosition,
+                                              const size_t aHash ) const
+{
+    return ( aPosition - ( aHash & mMask ) ) & mMask;
 }
 
-/*! \brief Prefix increment operator.
-* \return The incremented iterator.
+/*! \brief Resize the slot array. 
+* \details The new size is rounded up to a power of two which can hold at
+*          least aNewSize entries. The stored hashes are used to place the
+*          slots of the existing entries, so no key is rehashed and the entry
+*          storage is not touched.
+* \param aNewSize The minimum number of slots.
 */
 template<class Key, class Value>
-typename HashMap<Key, Value>::const_iterator&
-HashMap<Key, Value>::const_iterator::operator++(){
-    /*! \pre Need a non-null parent hashmap. */
-    assert( mParent );
+void HashMap<Key, Value>::resize( const size_t aNewSize ){
+    // Find the smallest power of two which is at least the requested size.
+    size_t newSize = 8;
+    while( newSize < aNewSize ){
+        newSize *= 2;
+    }
+    // Check if the new and old size are the same to avoid resizing.
+    if( newSize == mSlots.size() ){
+        return;
+    }
 
-    mCurrentItem = mParent->getNextItem( mCurrentItem );
-    return *this;
-}
+    std::vector<Slot> oldSlots( newSize );
+    // The new slots are value initialized, which marks them all as empty.
+    oldSlots.swap( mSlots );
+    mMask = newSize - 1;
 
-/*! \brief Postfix increment operator.
-* \return The iterator before it is incremented.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::const_iterator
-HashMap<Key, Value>::const_iterator::operator++ (int){
-   const_iterator curr = *this;
-   ++(*this);
-   return curr;
- }
-
-/*! \brief Dereference operator
-* \return A reference to the key value pair.
-*/
-template<class Key, class Value>
-const std::pair<Key, Value>& HashMap<Key, Value>::const_iterator::operator*() const {
-	/*! \pre The current item pointer must be non-null. */
-	assert( mCurrentItem.first != 0 );
-	return mCurrentItem.first->mKeyValuePair;
+#if( TUNING_STATS )
+    // Reset the collision count.
+    mNumCollisions = 0;
+#endif
+    for( size_t i = 0; i < oldSlots.size(); ++i ){
+        if( oldSlots[ i ].mEntry != 0 ){
+            placeSlot( oldSlots[ i ] );
+        }
+    }
 }
 
 #endif // _HASH_MAP_H_
@@ -0,0 +1,127 @@
+#ifndef _INPUT_IMAGE_H_
+#define _INPUT_IMAGE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file input_image.h
+ * \ingroup util
+ * \brief InputImage class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <set>
+
+class IParsable;
+
+/*!
+ * \ingroup util
+ * \brief Saves a set of XML input files in a pre-compiled binary image which
+ *        can be loaded much faster than reading the XML again.
+ * \details Many runs are started from the same reference inputs with only a
+ *          policy file changing.  Running gcam with --compile-inputs reads the
+ *          base input file and the scenario components listed in the
+ *          configuration, validating them once, and saves them to the file
+ *          input-image.  Element names, attributes and text are stored in a
+ *          string table which the image's element records refer to by index
+ *          so repeated names and values are stored once.
+ *
+ *          When input-image is set in a later run the image is mapped into
+ *          memory and its elements passed by an XMLChunkBuilder to the
+ *          Scenario a region at a time, with no tokenizing or validation of
+ *          the XML.  Only the leading run of input files which match those in
+ *          the image, and have not been modified since it was compiled, are
+ *          taken from it.  The remaining files, such as a policy file, are
+ *          parsed as XML as usual.  An image for a different version, or a
+ *          missing image, is ignored with a warning.
+ *
+ *          The parsed input rather than the completely initialized Scenario is
+ *          saved since the add-on files must be parsed before completeInit.
+ *
+ *          An image may also be compiled into memory with compileShared, which
+ *          the BatchRunner uses so that the inputs shared by all of its
+ *          scenarios are only read once for the whole batch.
+ *
+ *          With attachNodeShared the inputs are instead shared by every
+ *          process on a node which reads the same files.  The image is kept in
+ *          a named POSIX shared memory segment identified by a hash of the
+ *          contents of the files.  The first process to ask for a segment
+ *          compiles and publishes it while the others wait for it, then all of
+ *          them map it read-only so that a single copy of the image is kept in
+ *          memory and the XML is read and validated only once.  The segments
+ *          outlive the processes so that later runs may attach to them as
+ *          well, and are removed by deleting /dev/shm/gcam-inputs-*.
+ */
+class InputImage {
+public:
+    static bool compile( const std::string& aImageFile,
+                         const std::vector<std::string>& aXMLFiles,
+                         const bool aValidate );
+
+    static bool load( const std::string& aImageFile,
+                      const std::vector<std::string>& aXMLFiles,
+                      IParsable* aModelElement,
+                      const std::set<std::string>& aContainerNames,
+                      size_t& aNumLoaded );
+
+    static bool compileShared( const std::vector<std::string>& aXMLFiles,
+                               const bool aValidate );
+
+    static bool loadShared( const std::vector<std::string>& aXMLFiles,
+                            IParsable* aModelElement,
+                            const std::set<std::string>& aContainerNames,
+                            size_t& aNumLoaded );
+
+    static bool attachNodeShared( const std::vector<std::string>& aXMLFiles,
+                                  const bool aValidate );
+
+    static bool hasShared();
+
+    static void releaseShared();
+
+private:
+    static bool loadData( const char* aData,
+                          const size_t aSize,
+                          const std::string& aImageName,
+                          const std::vector<std::string>& aXMLFiles,
+                          IParsable* aModelElement,
+                          const std::set<std::string>& aContainerNames,
+                          size_t& aNumLoaded );
+};
+
+#endif // _INPUT_IMAGE_H_
@@ -0,0 +1,109 @@
+#ifndef _INPUT_PREFETCHER_H_
+#define _INPUT_PREFETCHER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file input_prefetcher.h
+ * \ingroup util
+ * \brief The InputPrefetcher class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+
+#include "util/base/include/background_task_queue.h"
+
+/*!
+ * \ingroup util
+ * \brief Reads XML input files into DOM documents on a background thread so
+ *        that they are ready by the time a scenario parses them.
+ * \details The BatchRunner uses this to read the varying input files of the
+ *          next scenario while the current one is being solved.  The files are
+ *          read by start and the documents are taken, once wait has returned,
+ *          by SingleScenarioRunner with takeDocument in place of reading the
+ *          file itself.  A document is only used if it was read with the same
+ *          validation setting that the scenario would use, otherwise the file
+ *          is read again as usual.
+ *
+ *          The XML platform is kept initialized while documents are being read
+ *          or held since the scenarios terminate it once they have parsed their
+ *          inputs.  Any documents which were not taken are released when the
+ *          next files are started or the prefetcher is destroyed.
+ */
+class InputPrefetcher : private boost::noncopyable {
+public:
+    InputPrefetcher();
+
+    ~InputPrefetcher();
+
+    void start( const std::vector<std::string>& aXMLFiles,
+                const std::vector<bool>& aValidate );
+
+    void wait();
+
+    static xercesc::DOMDocument* takeDocument( const std::string& aXMLFile,
+                                               const bool aValidate );
+
+private:
+    //! A document which has been read ahead.
+    struct Document {
+        //! The file the document was read from.
+        std::string mXMLFile;
+
+        //! Whether the file was validated when it was read.
+        bool mValidate;
+
+        //! The document, null once it has been taken.
+        xercesc::DOMDocument* mDocument;
+    };
+
+    //! The thread reading the documents.
+    BackgroundTaskQueue mQueue;
+
+    //! Whether this holds an initialization of the XML platform.
+    bool mIsPlatformHeld;
+
+    void release();
+
+    static std::vector<Document>& getDocuments();
+};
+
+#endif // _INPUT_PREFETCHER_H_
@@ -139,6 +139,8 @@ public:
     InterpolationRule* clone() const;
     
     static const std::string& getXMLNameStatic();
+
+    void completeInit();
     
     void applyInterpolations( objects::PeriodVector<Value>& aValuesToInterpolate,
         const objects::PeriodVector<Value>& aParsedValues ) const;
@@ -182,6 +184,14 @@ protected:
     //! Flag to check if the interpolation function is fixed in which
     //! case we enable the hack to set the value in the from-year as well
     bool mIsFixedFunction;
+
+    //! The period before the first period to interpolate, resolved from
+    //! mFromYear in completeInit.
+    int mFromPeriod;
+
+    //! The period after the last period to interpolate, resolved from
+    //! mToYear in completeInit.
+    int mToPeriod;
     
     //! Internal variable to save apply-to attribute so it can be written out to the debug file
     std::string mApplyTo;
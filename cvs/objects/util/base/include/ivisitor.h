@@ -128,6 +128,51 @@ public:
     inline virtual ~IVisitor();
     virtual void finish() const = 0;
 
+    /*!
+     * \brief Whether the visitor needs the children of the object whose
+     *        startVisit method was just called.
+     * \details Classes with large subtrees check this after calling startVisit
+     *          for themselves and only pass the visitor on to their children if
+     *          it returns true.  They always call endVisit.
+     * \return Whether the children should be visited.
+     */
+    virtual bool shouldVisitChildren() const = 0;
+
+    /*!
+     * \brief The parts of the tree which a visitor can declare it does not
+     *        need to visit.
+     * \details These are the children of the classes which check
+     *          shouldVisitChildren.  A visitor which only handles a few types,
+     *          say sectors and subsectors, can skip the much larger parts of
+     *          the tree below them.  The ancestors of the objects which are
+     *          visited are always visited so that context such as the current
+     *          region or sector is still available.
+     */
+    enum VisitContent {
+        //! The markets of the marketplace.
+        MARKETS = 1 << 0,
+        //! The subsectors of sectors and nesting subsectors.
+        SUBSECTORS = 1 << 1,
+        //! The technologies of subsectors.
+        TECHNOLOGIES = 1 << 2,
+        //! The inputs, outputs and GHGs of technologies.
+        TECHNOLOGY_CONTENTS = 1 << 3,
+        //! The subresources of resources.
+        SUBRESOURCES = 1 << 4,
+        //! The grades and technology of subresources.
+        SUBRESOURCE_CONTENTS = 1 << 5
+    };
+
+    /*!
+     * \brief Whether the visitor needs a part of the tree.
+     * \details This is checked along with shouldVisitChildren by the classes
+     *          which contain the given content.  Unlike shouldVisitChildren
+     *          the answer may not depend on the object being visited.
+     * \param aContent The part of the tree.
+     * \return Whether it should be visited.
+     */
+    virtual bool visitsContent( const VisitContent aContent ) const = 0;
+
     virtual void startVisitScenario( const Scenario* aScenario, const int aPeriod ) = 0;
     virtual void endVisitScenario( const Scenario* aScenario, const int aPeriod ) = 0;
     virtual void startVisitWorld( const World* aWorld, const int aPeriod ) = 0;
@@ -45,13 +45,21 @@
 
 #include <cassert>
 #include <forward_list>
+#include <memory>
 #include <string>
+#include <vector>
 #include "util/base/include/definitions.h"
 
 class Value;
+class StateSnapshot;
+class ITechnology;
+class Market;
+class Scenario;
 
 #if GCAM_PARALLEL_ENABLED
+#include <atomic>
 #include <tbb/task_arena.h>
+#include <tbb/enumerable_thread_specific.h>
 #endif
 
 /*!
@@ -67,6 +75,23 @@ class Value;
  *          developers do not need to worry about any of this.  All they have to do
  *          is ensure they appropriately tag their STATE Data.
  *
+ *          When compiled with STATE_AUDIT every write to a Value is recorded
+ *          to find Data which is tagged STATE but never written while the
+ *          model is calculated, and so could be dropped from the state, and
+ *          Data which is not tagged STATE but is written while a partial
+ *          derivative is calculated, which is a thread safety bug.  The
+ *          totals by container type and Data name are written to the file
+ *          state-audit-report at the end of each period.  Only writes through
+ *          Value are seen, not those to plain doubles.
+ *
+ *          Each restart file which is written also serves as a checkpoint: a
+ *          small checkpoint file next to the restart files records the last
+ *          period whose restart file was completely written.  When the model
+ *          is run with --resume the restart files up to that period are used
+ *          as if configured with restart-period, so a run which was stopped
+ *          replays the earlier periods from their saved state, rebuilding the
+ *          history which is not STATE along the way, and solves from there.
+ *
  * \author Pralit Patel
  */
 class ManageStateVariables {
@@ -76,17 +101,74 @@ public:
     
     void copyState();
     
+    void commitState();
+    
     void setPartialDeriv( const bool aIsPartialDeriv );
     
+    bool isPartialDeriv() const;
+    
+    /*!
+     * \brief The blocks of per market state which are stored contiguously at the
+     *        front of each state slot.
+     * \details Each block has one entry per market indexed by the market serial
+     *          number (less one) and the demand and supply blocks are adjacent so
+     *          that they can be cleared in a single sweep.
+     */
+    enum MarketStateType {
+        MARKET_PRICE = 0,
+        MARKET_DEMAND = 1,
+        MARKET_SUPPLY = 2,
+        NUM_MARKET_STATES = 3
+    };
+    
+    /*!
+     * \brief Whether the market blocks are available for the given period.
+     * \param aPeriod The model period.
+     * \return True if the market prices, demands, and supplies of aPeriod are
+     *         stored in the market blocks.
+     */
+    bool hasMarketState( const int aPeriod ) const {
+        return mNumMarkets > 0 && aPeriod == mPeriodToCollect;
+    }
+    
+    //! The number of entries in each market block.
+    size_t getNumMarkets() const {
+        return mNumMarkets;
+    }
+    
+    double* getMarketState( const MarketStateType aType ) const;
+    
+    size_t getNumBytes() const;
+    
+    bool saveState( StateSnapshot& aSnapshot, const bool aMarketsOnly ) const;
+    
+    void restoreState( const StateSnapshot& aSnapshot ) const;
+    
+    static void finishRestartFiles();
+    
+    static std::string getRestartFileName( const int aPeriod );
+    
+    static std::string getCheckpointFileName();
+    
+    static void setResume( const bool aResume );
+    
+    static void clearStateIndex();
+    
 #if GCAM_PARALLEL_ENABLED
     //! A tbb task arena which is the closest tbb comes to a thread pool which we
     //! will insist parallel calculations use so that we can ensure that we have
     //! appropriately sized and allocated a slot in mStateData for each thread to
     //! have as "scratch" space for it's computations.
+    //! Its size may be set with the configuration parallel-num-threads.
     tbb::task_arena mThreadPool;
 #endif
     
 private:
+    //! The number of states which are allocated: the "base" state and one
+    //! "scratch" state for each thread which may compute a partial derivative.
+    int mNumStates;
+    
+
     //! The actual home of all state data.  This is a two dimensional array where
     //! the first is by state the second is for each GCAM Data marketed as STATE.
     //! Note the first state is the "base" state and the rest are "scratch" for
@@ -94,7 +176,9 @@ private:
     //! "scratch" space is copied over by the "base" state.  Without GCAM_PARALLEL_ENABLED
     //! only a single "scratch" state will be allocated, when it is enabled there
     //! will be as many as the max_concurrency the thread pool allows on the system
-    //! running the code.
+    //! running the code, or as many as configured by parallel-num-threads.  When
+    //! GCAM_PARALLEL_ENABLED the "scratch" states are allocated by the first
+    //! thread to use them so that their memory is local to that thread.
     double** mStateData;
     
     //! The period this state was collected for.
@@ -112,6 +196,34 @@ private:
     //! be changed during World.calc( mPeriodToCollect ).
     size_t mNumCollected;
     
+    //! The number of markets in each of the market blocks at the front of the
+    //! state, or zero if the market state could not be laid out that way.
+    size_t mNumMarkets;
+    
+    //! The number of pages of state values which are tracked for changes.
+    size_t mNumPages;
+    
+    //! The number of doubles allocated ahead of each state to hold its page
+    //! change flags, one byte per page.
+    size_t mHeaderSize;
+    
+    //! For each state whether it is known to match the "base" state in all but
+    //! the pages flagged as changed.  Until then copyState must copy all of it.
+    std::vector<unsigned char> mIsSynced;
+    
+    //! The memory mapped restart file which holds the "base" state if it was
+    //! loaded that way, otherwise null.
+    void* mMappedRestart;
+    
+    //! The size in bytes of mMappedRestart.
+    size_t mMappedRestartSize;
+    
+    //! Whether the "base" state was loaded from a restart file.
+    bool mIsRestarted;
+    
+    //! Whether to resume from the last checkpoint, set by --resume.
+    static bool sResume;
+    
     //! The list of individual Values flagged as STATE that could possibly be
     //! changed during World.calc( mPeriodToCollect ).  We store them in a list
     //! since searching via GCAMFusion is a relatively expensive operation and we
@@ -121,11 +233,113 @@ private:
     //! - When we are done with this period copy the "base" state back into each Value.
     std::forward_list<Value*> mStateValues;
     
+    /*!
+     * \brief An entry in the index of Data flagged STATE found by GCAMFusion.
+     * \details Every STATE Data is recorded along with the Technology and Market
+     *          that contain it, if any, so that which values are active can be
+     *          decided for any period without searching again.  Each Technology
+     *          also gets an entry, ahead of those of its Data, so that it can be
+     *          searched again on its own.
+     */
+    struct StateIndexEntry {
+        //! The kinds of entries.
+        enum EntryType {
+            TECHNOLOGY,
+            SINGLE,
+            PERIOD_VECTOR,
+            TECH_VINTAGE_VECTOR,
+            YEAR_VECTOR
+        };
+        
+        //! The kind of this entry which determines the type of mData.
+        EntryType mType;
+        
+        //! The Data found, or null for a TECHNOLOGY entry.
+        void* mData;
+        
+        //! The Technology which contains the Data, or null if none.
+        ITechnology* mTechnology;
+        
+        //! The Market which contains the Data, or null if none.
+        Market* mMarket;
+        
+        //! For a TECHNOLOGY entry whether it was operating when it was last searched.
+        bool mWasOperating;
+    };
+    
+    //! The index of all Data flagged STATE which is kept between periods when
+    //! cache-state-search is set.
+    static std::vector<StateIndexEntry> sStateIndex;
+    
+    //! The Scenario which sStateIndex was built for.
+    static const Scenario* sStateIndexScenario;
+    
+#if GCAM_PARALLEL_ENABLED
+    friend class Value;
+    
+    //! For each thread the "scratch" state it last used so that it can be given
+    //! the same one, which was allocated local to it, in each partial derivative.
+    mutable tbb::enumerable_thread_specific<int> mThreadState;
+    
+    //! For each state whether it has been assigned to a thread in the current
+    //! partial derivative.
+    std::vector<std::atomic<int> > mIsAssigned;
+    
+    //! For each state whether it was last used by some thread.
+    std::vector<std::atomic<int> > mHasOwner;
+    
+    class ThreadPinner;
+    
+    //! Pins the worker threads of mThreadPool to CPUs if parallel-pin-threads
+    //! is set.
+    std::auto_ptr<ThreadPinner> mThreadPinner;
+    
+    static int getThreadPoolSize();
+    
+    double* assignThreadState();
+#endif
+    
+    void allocateState( const int aStateIndex );
+    
+    int getResumePeriod() const;
+    
     void collectState();
     
+    void buildStateIndex();
+    
+    void updateStateIndex();
+    
+    void addIndexedState( const StateIndexEntry& aEntry );
+    
+    double* getCurrentState() const;
+    
+    double* getScratchState() const;
+    
+    int getStateIndex( const double* aState ) const;
+    
+    unsigned char* getChangedPages( double* aState ) const;
+    
+    void markChanged( double* aState, const size_t aNumValues ) const;
+    
+    void copyChangedPages( double* aTo, const double* aFrom, const unsigned char* aChangedPages ) const;
+    
+    void layoutMarketState();
+    
+#if STATE_AUDIT
+    void startStateAudit();
+    
+    void finishStateAudit() const;
+#endif
+    
     void resetState();
     
-    std::string getRestartFileName() const;
+    size_t getStructureHash() const;
+    
+    size_t getChecksum( const double* aState ) const;
+    
+    size_t getRestartDataOffset() const;
+    
+    bool mapRestartFile( const std::string& aFileName );
     
     void loadRestartFile();
     
@@ -136,19 +350,20 @@ private:
      *        for data flagged STATE.
      * \details In addition to handling the processData call back we also are
      *          interested in the push/pop filter steps, particularly for Technology
-     *          and MarketContainer to avoid collecting Data in a Technology or
-     *          Market that is going to be inactive during mPeriodToCollect.
+     *          and Market to record which of them the Data is in so that Data in a
+     *          Technology or Market that is inactive during a period can be skipped.
      */
     struct DoCollect {
-        //! A reference to the containing class where each collected state data
-        //! will be added.
-        ManageStateVariables* mParentClass;
+        //! The index to which each state data found will be added.
+        std::vector<StateIndexEntry>* mIndex = 0;
+        
+        //! The Technology currently being searched, if any.
+        ITechnology* mCurrTechnology = 0;
         
-        //! A state variable while processing GCAMFusion which when set indicates
-        //! we are in a Technology or MarketContainer that is inactive in the
-        //! current period.  This flag gets reset when the corresponding popFilterStep
-        //! is found.
-        bool mIgnoreCurrValue = false;
+        //! The Market currently being searched, if any.
+        Market* mCurrMarket = 0;
+        
+        void addEntry( const StateIndexEntry::EntryType aType, void* aData );
         
         // Templated callbacks for GCAMFusion
         template<typename DataType>
@@ -158,6 +373,9 @@ private:
         template<typename DataType>
         void popFilterStep( const DataType& aData );
     };
+    
+    template<typename ContainerType>
+    static void searchState( ContainerType* aContainer, DoCollect& aDoCollect );
 };
 
 #endif // _MANAGE_STATE_VARIABLES_H_
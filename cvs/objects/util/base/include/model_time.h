@@ -47,6 +47,7 @@
 
 #include <vector>
 #include <map>
+#include <cassert>
 #include "util/base/include/iparsable.h"
 
 class Tabs;
@@ -82,8 +83,10 @@ private:
     //! Model period to year.
     std::vector<int> mPeriodToYear;
 
-    //! Year to model period map object.
-    std::map<int,int> mYearToPeriod;
+    //! Year to model period indexed by the year offset from the start year.
+    //! Every year from the start year to the end year is included, with
+    //! years between model years mapped to the period of the next model year.
+    std::vector<int> mYearToPeriod;
     
     //! Debugging flag to make sure the modeltime params have been
     //! set before attempting to get the modeltime attributes.
@@ -91,6 +94,9 @@ private:
 
     // member functions
     void initMembers( const std::map<int, int>& aYearToTimeStep );
+
+    int invalidPeriod( const int aPeriod ) const;
+    int invalidYear( const int aYear ) const;
     
     //! Private constructor to prevent creating a Modeltime.
     Modeltime();
@@ -133,4 +139,38 @@ public:
 
 };
 
+/*!
+* \brief Convert a period into a year.
+* \details Converts the period into a year if it is valid. If it is not a valid
+*          year the function will print a warning and return 0.
+* \param aPeriod Model period.
+* \return The first year of the period, 0 if the year is invalid.
+*/
+inline int Modeltime::getper_to_yr( const int aPeriod ) const {
+    assert( mIsInitialized );
+
+    if( aPeriod >= 0 && aPeriod < static_cast<int>( mPeriodToYear.size() ) ){
+        return mPeriodToYear[ aPeriod ];
+    }
+    return invalidPeriod( aPeriod );
+}
+
+/*!
+* \brief Convert a year to a period.
+* \details Years between model years are converted to the period of the next
+*          model year. If the year is outside of the model years the function
+*          will print a warning and return 0.
+* \param aYear The year to convert.
+* \return The period containing the year, 0 if the year is invalid.
+*/
+inline int Modeltime::getyr_to_per( const int aYear ) const {
+    assert( mIsInitialized );
+
+    const int offset = aYear - mStartYear;
+    if( offset >= 0 && offset < static_cast<int>( mYearToPeriod.size() ) ){
+        return mYearToPeriod[ offset ];
+    }
+    return invalidYear( aYear );
+}
+
 #endif // _MODEL_TIME_H_
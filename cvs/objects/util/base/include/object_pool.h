@@ -0,0 +1,152 @@
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+ * \file object_pool.h
+ * \ingroup util
+ * \brief ObjectPool and PooledObject class header file.
+ */
+
+#include <cstddef>
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+/*!
+ * \ingroup util
+ * \brief A pool from which the many small objects that make up the model
+ *        tree are allocated.
+ * \details Objects are grouped by size, rounded up to SIZE_GRANULARITY, and
+ *          each size is carved from large chunks in allocation order so that
+ *          the objects created together while parsing and completing the
+ *          initialization of a region, such as its technologies and their
+ *          inputs, outputs and GHGs, lie next to each other rather than being
+ *          scattered across the heap.  Freed objects go on a free list per
+ *          size to be reused by the next allocation of that size.  Objects
+ *          larger than MAX_POOLED_SIZE are passed through to the global
+ *          operator new.
+ *
+ *          The chunks are only returned in one step by releaseIfUnused once
+ *          every pooled object has been deleted, such as when a scenario is
+ *          cleaned up.  Until then they are kept to be reused by the next
+ *          scenario of a batch.
+ */
+class ObjectPool : private boost::noncopyable {
+public:
+    static ObjectPool& getInstance();
+
+    void* allocate( const std::size_t aSize );
+
+    void deallocate( void* aPtr, const std::size_t aSize );
+
+    bool releaseIfUnused();
+
+    std::size_t getBytesInUse() const;
+
+    std::size_t getBytesReserved() const;
+
+    //! Sizes are rounded up to a multiple of this which also sets the alignment.
+    static const std::size_t SIZE_GRANULARITY = 16;
+
+    //! The largest object which is allocated from the pool.
+    static const std::size_t MAX_POOLED_SIZE = 2048;
+
+    //! The size in bytes of each chunk that is carved into objects.
+    static const std::size_t CHUNK_SIZE = 64 * 1024;
+
+private:
+    ObjectPool();
+
+    //! The number of distinct object sizes.
+    static const std::size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / SIZE_GRANULARITY;
+
+    //! A free object which links to the next one free of the same size.
+    struct FreeSlot {
+        FreeSlot* mNext;
+    };
+
+    //! The head of the free list for each size class.
+    FreeSlot* mFreeList[ NUM_SIZE_CLASSES ];
+
+    //! The next unused position in the current chunk for each size class.
+    char* mChunkPos[ NUM_SIZE_CLASSES ];
+
+    //! The end of the current chunk for each size class.
+    char* mChunkEnd[ NUM_SIZE_CLASSES ];
+
+    //! All chunks allocated so that they can be released together.
+    std::vector<char*> mChunks;
+
+    //! The number of pooled objects currently allocated.
+    std::size_t mNumAllocated;
+
+    //! The bytes currently allocated to pooled objects, rounded up to their slot size.
+    std::size_t mPooledBytes;
+
+    //! The bytes currently allocated to objects too large to be pooled.
+    std::size_t mLargeBytes;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Objects may be created or deleted by worker threads.
+    mutable tbb::spin_mutex mMutex;
+#endif
+};
+
+/*!
+ * \ingroup util
+ * \brief A base class which makes a class, and all classes derived from it,
+ *        allocate from the ObjectPool.
+ * \details Deleting through a base pointer passes the size of the most
+ *          derived object to operator delete so long as the destructor is
+ *          virtual, which is the case for every class that uses this.
+ */
+class PooledObject {
+public:
+    static void* operator new( std::size_t aSize ) {
+        return ObjectPool::getInstance().allocate( aSize );
+    }
+
+    static void operator delete( void* aPtr, std::size_t aSize ) {
+        ObjectPool::getInstance().deallocate( aPtr, aSize );
+    }
+};
+
+#endif // _OBJECT_POOL_H_
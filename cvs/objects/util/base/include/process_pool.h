@@ -0,0 +1,107 @@
+#ifndef _PROCESS_POOL_H_
+#define _PROCESS_POOL_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file process_pool.h
+ * \ingroup util
+ * \brief ProcessPool class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+
+/*!
+ * \ingroup util
+ * \brief Runs a set of tasks concurrently, each in a child process forked
+ *        from this one.
+ * \details Each child starts with a copy of the complete state of this
+ *          process, typically a solved Scenario, so tasks such as trial runs
+ *          of the model at different taxes can run at the same time without
+ *          the model needing to support more than one Scenario per process.
+ *          A task sends its results back as a string, and a task which
+ *          crashes is reported as not completed without affecting the others
+ *          or this process. The state of this process is never changed by a
+ *          task.
+ *
+ *          Each child writes its logs to separate files by appending the name
+ *          of the pool and the task number to the log file names, where the
+ *          logger supports it.
+ *
+ *          Forking is only available on POSIX systems and when GCAM is not
+ *          built with GCAM_PARALLEL_ENABLED, since the threads of a parallel
+ *          build can not be copied into the child processes.
+ */
+class ProcessPool {
+public:
+    //! The result of a single task.
+    struct Result {
+        Result():mCompleted( false ), mSuccess( false ){}
+
+        //! Whether the task ran to completion.
+        bool mCompleted;
+
+        //! The value returned by the task.
+        bool mSuccess;
+
+        //! The output of the task.
+        std::string mOutput;
+    };
+
+    /*!
+     * \brief A task to run in a child process.
+     * \details The first argument is the index of the task and the second the
+     *          output to send back. The return value is reported in
+     *          Result::mSuccess.
+     */
+    typedef std::function<bool( const int, std::string& )> Task;
+
+    static bool isAvailable();
+
+    static std::vector<Result> run( const int aNumTasks,
+                                    const int aNumWorkers,
+                                    const std::string& aName,
+                                    const Task& aTask );
+private:
+    //! Private undefined constructor to prevent creating a ProcessPool.
+    ProcessPool();
+};
+
+#endif // _PROCESS_POOL_H_
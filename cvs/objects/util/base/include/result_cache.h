@@ -0,0 +1,101 @@
+#ifndef _RESULT_CACHE_H_
+#define _RESULT_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file result_cache.h
+ * \ingroup util
+ * \brief ResultCache class header file.
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*!
+ * \ingroup util
+ * \brief A directory of the outputs of previous scenario runs, each stored
+ *        under a key computed from everything which went into the run.
+ * \details The key is a 64 bit FNV-1a hash of the values added with addFile
+ *          and addValue, which should cover the contents of all of the input
+ *          files and any settings which affect the results. If the outputs
+ *          for a key have already been stored they may be restored in place of
+ *          running the scenario again.
+ *
+ *          The outputs for a key are kept in a sub-directory of the cache
+ *          directory named by the key, holding a copy of each output file or
+ *          directory and a manifest of the paths they were copied from. The
+ *          sub-directory is first filled under a name unique to this process
+ *          and then renamed into place so that a partially published set of
+ *          outputs is never seen, even when several runs share a cache.
+ *          Outputs are copied rather than linked since files such as restart
+ *          files are rewritten in place by later runs.
+ *
+ *          The cache is only available on POSIX systems.
+ */
+class ResultCache {
+public:
+    explicit ResultCache( const std::string& aCacheDir );
+
+    static bool isAvailable();
+
+    bool addFile( const std::string& aFileName );
+
+    void addValue( const std::string& aValue );
+
+    std::string getKey() const;
+
+    bool isStored() const;
+
+    bool restore() const;
+
+    bool publish( const std::vector<std::string>& aOutputs ) const;
+
+private:
+    void addBytes( const char* aBytes, const size_t aSize );
+
+    std::string getEntryDir() const;
+
+    //! The directory holding the outputs for every key.
+    const std::string mCacheDir;
+
+    //! The hash of everything added so far.
+    uint64_t mHash;
+};
+
+#endif // _RESULT_CACHE_H_
@@ -0,0 +1,109 @@
+#ifndef _SCRATCH_ARRAY_H_
+#define _SCRATCH_ARRAY_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file scratch_array.h
+ * \ingroup util
+ * \brief ScratchArray class header file.
+ */
+
+#include <cstddef>
+#include <boost/core/noncopyable.hpp>
+
+/*!
+ * \ingroup util
+ * \brief A temporary array of doubles taken from storage kept by the calling
+ *        thread so that short lived arrays, such as the shares calculated
+ *        during World::calc, do not need to be allocated on the heap.
+ * \details Each thread keeps a stack of blocks of memory from which arrays are
+ *          taken in order and returned when they go out of scope.  Arrays may
+ *          be nested, as when the shares of a sector are held while the shares
+ *          of its subsectors are calculated, but must be destroyed in the
+ *          reverse order they were created, which is guaranteed when they are
+ *          only used as local variables.  Blocks are only added, never moved,
+ *          so the memory of an array stays valid while others are taken and
+ *          once the stack has grown to the deepest nesting no further heap
+ *          allocations are made.
+ *
+ *          The values of a new array are not initialized.
+ */
+class ScratchArray : private boost::noncopyable {
+public:
+    explicit ScratchArray( const size_t aSize );
+
+    ~ScratchArray();
+
+    //! The first value of the array.
+    double* data() {
+        return mData;
+    }
+
+    //! The first value of the array.
+    const double* data() const {
+        return mData;
+    }
+
+    //! The number of values in the array.
+    size_t size() const {
+        return mSize;
+    }
+
+    double& operator[]( const size_t aIndex ) {
+        return mData[ aIndex ];
+    }
+
+    const double& operator[]( const size_t aIndex ) const {
+        return mData[ aIndex ];
+    }
+
+private:
+    //! The values of the array.
+    double* mData;
+
+    //! The number of values in the array.
+    size_t mSize;
+
+    //! The block of the thread's stack which was in use before this array was taken.
+    size_t mPrevBlock;
+
+    //! The position in that block before this array was taken.
+    size_t mPrevOffset;
+};
+
+#endif // _SCRATCH_ARRAY_H_
@@ -0,0 +1,99 @@
+#ifndef _STATE_SNAPSHOT_H_
+#define _STATE_SNAPSHOT_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file state_snapshot.h
+ * \ingroup util
+ * \brief StateSnapshot class header file.
+ */
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+/*!
+ * \ingroup util
+ * \brief A saved copy of an array of state data which can later be restored.
+ * \details The data is stored in fixed size pages which are shared between
+ *          copies of a snapshot.  Copying a snapshot only copies the page
+ *          pointers, so many candidate states can be kept alive at once for
+ *          little cost.  Pages are never modified once they may be shared:
+ *          saving into a snapshot keeps any page whose contents have not
+ *          changed, overwrites a page in place only when no other snapshot
+ *          refers to it, and otherwise allocates a fresh page.  Repeatedly
+ *          saving a state of which only a small part changes between saves
+ *          therefore only copies the changed pages.
+ *
+ *          ManageStateVariables uses this to save and restore the active state
+ *          and the market prices, supplies and demands stored at the front of
+ *          it.
+ */
+class StateSnapshot {
+public:
+    StateSnapshot();
+
+    void save( const double* aData, const size_t aSize );
+
+    void restore( double* aData ) const;
+
+    //! The number of values saved in the snapshot.
+    size_t size() const {
+        return mSize;
+    }
+
+    //! Whether a state has been saved in the snapshot.
+    bool empty() const {
+        return mSize == 0;
+    }
+
+    //! The number of values stored in each page.
+    static const size_t PAGE_SIZE = 512;
+
+private:
+    //! Type of a single page of saved values.
+    typedef std::vector<double> Page;
+
+    //! The pages which hold the saved values in order.  All pages are
+    //! PAGE_SIZE long except possibly the last.
+    std::vector<boost::shared_ptr<Page> > mPages;
+
+    //! The number of values saved.
+    size_t mSize;
+};
+
+#endif // _STATE_SNAPSHOT_H_
@@ -46,6 +46,7 @@
 #include "util/base/include/model_time.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/util.h"
+#include "util/base/include/object_pool.h"
 
 extern Scenario* scenario;
 
@@ -61,6 +62,38 @@ class TechVectorParseHelper;
 namespace objects {
     // Need to inject the util namespace into the objects namespace.
     
+    /*!
+     * \brief Allocate the array backing a time vector from the ObjectPool.
+     * \details Period and vintage vectors are small, fixed size members of
+     *          nearly every model component.  Taking their arrays from the
+     *          pool rather than the heap saves an allocation each, and since
+     *          arrays of the same size are carved from the same chunk in the
+     *          order they are created the vectors of a component end up next
+     *          to each other.
+     * \param aSize The number of elements.
+     * \param aDefaultValue The value to which to initialize each element.
+     * \return The array.
+     */
+    template<class T>
+    T* allocateTimeArray( const size_t aSize, const T& aDefaultValue ) {
+        T* data = static_cast<T*>( ObjectPool::getInstance().allocate( std::max( aSize, size_t( 1 ) ) * sizeof( T ) ) );
+        std::uninitialized_fill( data, data + aSize, aDefaultValue );
+        return data;
+    }
+    
+    /*!
+     * \brief Destroy and return an array created by allocateTimeArray.
+     * \param aData The array.
+     * \param aSize The number of elements it was allocated with.
+     */
+    template<class T>
+    void deallocateTimeArray( T* aData, const size_t aSize ) {
+        for( size_t i = 0; i < aSize; ++i ) {
+            aData[ i ].~T();
+        }
+        ObjectPool::getInstance().deallocate( aData, std::max( aSize, size_t( 1 ) ) * sizeof( T ) );
+    }
+    
     /*!
      * \brief Base class of vectors indexed by year or period.
      * \details Provides common code for year and period vectors.
@@ -135,7 +168,8 @@ namespace objects {
         typedef TimeVectorBaseIter<T const> const_iterator;
 
 
-        TimeVectorBase( const unsigned int aSize, const T aDefaultValue );
+        TimeVectorBase( const unsigned int aSize, const T aDefaultValue,
+                        const bool aIsPooled = false );
         virtual ~TimeVectorBase();
         TimeVectorBase( const TimeVectorBase& aOther );
         TimeVectorBase& operator=( const TimeVectorBase& aOther );
@@ -161,10 +195,17 @@ namespace objects {
         T* mData;
 
         //! Size of the array.
-        size_t mSize;
+        unsigned int mSize;
+
+        //! Whether the array was allocated from the ObjectPool.  Vectors which
+        //! are created as temporaries during calc, which are typically
+        //! YearVectors, use the heap instead so that worker threads do not
+        //! contend for the pool.
+        bool mIsPooled;
     private:
         void init( const unsigned int aSize,
-                   const T aDefaultValue );
+                   const T aDefaultValue,
+                   const bool aIsPooled );
 
         void clear();
     };
@@ -175,12 +216,14 @@ namespace objects {
      * \param aSize Size of the TimeVectorBase. The size is immutable once
      *              constructed.
      * \param aDefaultValue Default for all values.
+     * \param aIsPooled Whether to allocate the array from the ObjectPool.
      */
     template<class T>
         TimeVectorBase<T>::TimeVectorBase( const unsigned int aSize,
-                                           const T aDefaultValue )
+                                           const T aDefaultValue,
+                                           const bool aIsPooled )
     {
-            init( aSize, aDefaultValue );
+            init( aSize, aDefaultValue, aIsPooled );
     }
 
     /*!
@@ -196,7 +239,12 @@ namespace objects {
      */
    template<class T>
        void TimeVectorBase<T>::clear(){
-            delete[] mData;
+            if( mIsPooled ) {
+                deallocateTimeArray( mData, mSize );
+            }
+            else {
+                delete[] mData;
+            }
        }
 
    /*! 
@@ -204,16 +252,24 @@ namespace objects {
      * \param aSize Size of the TimeVectorBase. The size is immutable once
      *              constructed.
      * \param aDefaultValue Default for all values.
+     * \param aIsPooled Whether to allocate the array from the ObjectPool.
     */
    template<class T>
        void TimeVectorBase<T>::init( const unsigned int aSize,
-                                     const T aDefaultValue )
+                                     const T aDefaultValue,
+                                     const bool aIsPooled )
    {
            mSize = aSize;
-           mData = new T[ mSize ];
+           mIsPooled = aIsPooled;
+           if( mIsPooled ) {
+               mData = allocateTimeArray( mSize, aDefaultValue );
+           }
+           else {
+               mData = new T[ mSize ];
 
-           // Initialize the data to the default value.
-           std::uninitialized_fill( &mData[ 0 ], &mData[ 0 ] + mSize, aDefaultValue );
+               // Initialize the data to the default value.
+               std::uninitialized_fill( &mData[ 0 ], &mData[ 0 ] + mSize, aDefaultValue );
+           }
     }
 
     /*!
@@ -222,7 +278,7 @@ namespace objects {
      */
     template<class T>
         TimeVectorBase<T>::TimeVectorBase( const TimeVectorBase<T>& aOther ){
-            init( aOther.mSize, T() );
+            init( aOther.mSize, T(), aOther.mIsPooled );
             std::copy( aOther.begin(), aOther.end(), begin() );
         }
 
@@ -237,7 +293,7 @@ namespace objects {
             // Check for self-assignment.
             if( this != &aOther ){
                 clear();
-                init( aOther.size(), T() );
+                init( aOther.size(), T(), mIsPooled );
                 std::copy( aOther.begin(), aOther.end(), begin() );
             }
             return *this;
@@ -553,7 +609,7 @@ namespace objects {
     template<class T>
         PeriodVector<T>::PeriodVector( const T aDefaultValue )
         :TimeVectorBase<T>( scenario->getModeltime()->getmaxper(),
-                            aDefaultValue )
+                            aDefaultValue, true )
     {
     }
 
@@ -753,12 +809,10 @@ namespace objects {
     TechVintageVector<T>::TechVintageVector( const unsigned int aStartPeriod,
                                              const unsigned int aSize,
                                              const T aDefaultValue ):
-    mData( new T[ aSize ] ),
+    mData( allocateTimeArray( aSize, aDefaultValue ) ),
     mStartPeriod( aStartPeriod ),
     mSize( aSize )
     {
-        // Initialize the data to the default value.
-        std::uninitialized_fill( &mData[ 0 ], &mData[ 0 ] + mSize, aDefaultValue );
     }
     
     /*!
@@ -775,7 +829,7 @@ namespace objects {
     template<class T>
     void TechVintageVector<T>::clear(){
         if( isInitialized() ) {
-            delete[] mData;
+            deallocateTimeArray( mData, mSize );
         }
     }
     
@@ -794,7 +848,7 @@ namespace objects {
     mSize( aOther.mSize )
     {
         if( aOther.isInitialized() ) {
-            mData = new T[ mSize ];
+            mData = allocateTimeArray( mSize, T() );
             std::copy( aOther.begin(), aOther.end(), &mData[ 0 ] );
         }
     }
@@ -821,7 +875,7 @@ namespace objects {
                 clear();
                 mStartPeriod = aOther.mStartPeriod;
                 mSize = aOther.mSize;
-                mData = new T[ mSize ];
+                mData = allocateTimeArray( mSize, T() );
                 std::copy( aOther.begin(), aOther.end(), &mData[ 0 ] );
             }
         }
@@ -0,0 +1,181 @@
+#ifndef _TRACEPOINTS_H_
+#define _TRACEPOINTS_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file tracepoints.h
+ * \ingroup Objects
+ * \brief Static tracepoints for profiling the model with external tools.
+ * \details Tracepoints mark the start and end of the phases of a model run
+ *          which usually matter for performance, such as the calculation of
+ *          an activity or a finite difference column of the Jacobian, so that
+ *          tools such as perf, bpftrace or VTune can build a timeline from a
+ *          running model.  Two backends may be compiled in:
+ *
+ *          - USE_USDT: SystemTap/DTrace style probes from sys/sdt.h in the
+ *            provider "gcam".  Each probe is a single nop until a tool attaches
+ *            to it, e.g. bpftrace -e 'usdt:./gcam.exe:gcam:activity_calc_begin'.
+ *            A scope named X has the probes X_begin and X_end.
+ *          - USE_ITT: Intel ITT tasks in the domain "gcam", visible in VTune.
+ *            Each call is a check of a global flag unless the collector is
+ *            attached.
+ *
+ *          Each tracepoint has two integer arguments, for instance an index
+ *          and the model period, which must be cheap to evaluate since they
+ *          are evaluated even when no tool is attached.  With neither backend
+ *          the macros expand to nothing at all.
+ */
+
+#include <stdint.h>
+
+#ifndef USE_USDT
+#define USE_USDT 0
+#endif
+
+#ifndef USE_ITT
+#define USE_ITT 0
+#endif
+
+#if USE_USDT
+#include <sys/sdt.h>
+#endif
+
+#if USE_ITT
+#include <ittnotify.h>
+
+namespace gcam_trace {
+    //! The ITT domain of all of the GCAM tracepoints.
+    inline __itt_domain* getDomain() {
+        static __itt_domain* domain = __itt_domain_create( "gcam" );
+        return domain;
+    }
+
+    //! Start an ITT task and attach the tracepoint arguments to it.
+    inline void beginTask( __itt_string_handle* aName, const long long aArg1, const long long aArg2 ) {
+        __itt_task_begin( getDomain(), __itt_null, __itt_null, aName );
+        long long args[] = { aArg1, aArg2 };
+        __itt_metadata_add( getDomain(), __itt_null, aName, __itt_metadata_s64, 2, args );
+    }
+}
+
+#define GCAM_ITT_BEGIN( aName, aArg1, aArg2 ) \
+    do { \
+        static __itt_string_handle* gcamTraceName = __itt_string_handle_create( #aName ); \
+        gcam_trace::beginTask( gcamTraceName, static_cast<long long>( aArg1 ), static_cast<long long>( aArg2 ) ); \
+    } while( false )
+#define GCAM_ITT_END( aName ) __itt_task_end( gcam_trace::getDomain() )
+#define GCAM_ITT_EVENT( aName, aArg1, aArg2 ) \
+    do { \
+        GCAM_ITT_BEGIN( aName, aArg1, aArg2 ); \
+        GCAM_ITT_END( aName ); \
+    } while( false )
+#else
+#define GCAM_ITT_BEGIN( aName, aArg1, aArg2 ) do {} while( false )
+#define GCAM_ITT_END( aName ) do {} while( false )
+#define GCAM_ITT_EVENT( aName, aArg1, aArg2 ) do {} while( false )
+#endif
+
+#if USE_USDT
+#define GCAM_USDT_PROBE( aName, aArg1, aArg2 ) \
+    DTRACE_PROBE2( gcam, aName, static_cast<long long>( aArg1 ), static_cast<long long>( aArg2 ) )
+#else
+#define GCAM_USDT_PROBE( aName, aArg1, aArg2 ) do {} while( false )
+#endif
+
+//! Whether any tracepoint backend is compiled in.
+#define GCAM_TRACEPOINTS_ENABLED ( USE_USDT || USE_ITT )
+
+/*!
+ * \brief Mark the start of a traced region.
+ * \details Each GCAM_TRACE_BEGIN must be matched by a GCAM_TRACE_END of the same
+ *          name on the same thread.
+ */
+#define GCAM_TRACE_BEGIN( aName, aArg1, aArg2 ) \
+    do { \
+        GCAM_USDT_PROBE( aName##_begin, aArg1, aArg2 ); \
+        GCAM_ITT_BEGIN( aName, aArg1, aArg2 ); \
+    } while( false )
+
+//! Mark the end of a traced region started with GCAM_TRACE_BEGIN.
+#define GCAM_TRACE_END( aName, aArg1, aArg2 ) \
+    do { \
+        GCAM_ITT_END( aName ); \
+        GCAM_USDT_PROBE( aName##_end, aArg1, aArg2 ); \
+    } while( false )
+
+//! Mark a single point in time.
+#define GCAM_TRACE_EVENT( aName, aArg1, aArg2 ) \
+    do { \
+        GCAM_USDT_PROBE( aName, aArg1, aArg2 ); \
+        GCAM_ITT_EVENT( aName, aArg1, aArg2 ); \
+    } while( false )
+
+/*!
+ * \brief Trace the rest of the enclosing scope.
+ * \details The region ends, with the same arguments, when the scope is left by
+ *          any path including an exception.  Only one scope of a given name may
+ *          be traced in the same C++ scope.
+ */
+/*!
+ * \brief Associate a label with an id used as a tracepoint argument.
+ * \details This is a USDT probe only, with the label as a third (string)
+ *          argument, so that a tool can name the ids in other tracepoints. The
+ *          label is not evaluated unless a backend is compiled in.
+ */
+#if USE_USDT
+#define GCAM_TRACE_LABEL( aName, aId, aArg2, aLabel ) \
+    DTRACE_PROBE3( gcam, aName, static_cast<long long>( aId ), static_cast<long long>( aArg2 ), ( aLabel ) )
+#else
+#define GCAM_TRACE_LABEL( aName, aId, aArg2, aLabel ) do {} while( false )
+#endif
+
+//! Convert a pointer to an integer id which may be used as a tracepoint argument.
+#define GCAM_TRACE_ID( aPointer ) reinterpret_cast<intptr_t>( aPointer )
+
+#if GCAM_TRACEPOINTS_ENABLED
+#define GCAM_TRACE_SCOPE( aName, aArg1, aArg2 ) \
+    GCAM_TRACE_BEGIN( aName, aArg1, aArg2 ); \
+    struct GcamTraceScope_##aName { \
+        long long mArg1; \
+        long long mArg2; \
+        ~GcamTraceScope_##aName() { GCAM_TRACE_END( aName, mArg1, mArg2 ); } \
+    } gcamTraceScope_##aName = { static_cast<long long>( aArg1 ), static_cast<long long>( aArg2 ) }
+#else
+#define GCAM_TRACE_SCOPE( aName, aArg1, aArg2 ) do {} while( false )
+#endif
+
+#endif // _TRACEPOINTS_H_
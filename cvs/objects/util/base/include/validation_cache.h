@@ -0,0 +1,98 @@
+#ifndef _VALIDATION_CACHE_H_
+#define _VALIDATION_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file validation_cache.h
+ * \ingroup util
+ * \brief ValidationCache class header file.
+ */
+
+#include <string>
+#include <set>
+#include <map>
+
+/*!
+ * \ingroup util
+ * \brief Decides which XML input files need schema validation by remembering
+ *        those which have already passed it.
+ * \details A file is identified by the same content hash used by ResultCache
+ *          over its contents and the configured schema version, so a file
+ *          which is edited, or read with a changed schema, is validated
+ *          again. The hashes of the files which were read successfully with
+ *          validation on are appended to the cache file, one per line, and
+ *          later runs skip validating them.
+ *
+ *          Note that validation errors are not fatal to a parse in GCAM, only
+ *          errors in the well-formedness of the file are, so what is recorded is
+ *          only that the file has been read with validation once.
+ *
+ *          The hashes are found serially before files are read and recorded
+ *          after they have been parsed, so the cache needs no locking.
+ */
+class ValidationCache {
+public:
+    ValidationCache( const bool aValidate, const std::string& aCacheFile,
+                     const std::string& aSchemaVersion, const bool aForceValidation );
+
+    bool shouldValidate( const std::string& aXMLFile );
+
+    void setValidated( const std::string& aXMLFile );
+
+private:
+    //! Whether input files are to be validated at all.
+    const bool mValidate;
+
+    //! The file listing the hashes of validated files, empty to not cache.
+    const std::string mCacheFile;
+
+    //! The schema version which is included in each hash.
+    const std::string mSchemaVersion;
+
+    //! Whether to validate every file regardless of the cache.
+    const bool mForceValidation;
+
+    //! The hashes of the files which have been validated.
+    std::set<std::string> mValidatedKeys;
+
+    //! The hashes of the files to be validated which are recorded once they
+    //! have been read successfully, by file name.
+    std::map<std::string, std::string> mPendingKeys;
+};
+
+#endif // _VALIDATION_CACHE_H_
@@ -48,9 +48,7 @@
 #include <cassert>
 #include "util/base/include/util.h"
 
-#if GCAM_PARALLEL_ENABLED
-#include <tbb/enumerable_thread_specific.h>
-#endif
+class ManageStateVariables;
 
 /*! 
  * \ingroup Objects
@@ -118,41 +116,81 @@ private:
     void print( std::ostream& aOutputStream ) const;
     std::istream& read( std::istream& aIStream );
 
+    // Note the instance members are ordered largest first so that a Value
+    // packs into 16 bytes rather than padding out to 24.  Value is the
+    // element type of most PeriodVector/TechVintageVector members so this
+    // adds up.
     //! The actual underly value of this class.
     double mValue;
+    //! The index into sCentralValue that contains the data for this instance.
+    unsigned int mCentralValueIndex;
     //! A flag to indicate if this Value has been set to any value besides the default.
     bool mIsInit;
-#if !GCAM_PARALLEL_ENABLED
-    typedef double* CentralValueType;
-#else
-    // When GCAM_PARALLEL_ENABLED each worker thread will have it's own slot of
-    // state assigned to it.  Note it is important that we use tbb::ets_key_per_instance
-    // which as it uses up a finite resource certainly qualifies as a performance
-    // critical use.
-    typedef tbb::enumerable_thread_specific<double*, tbb::cache_aligned_allocator<double*>, tbb::ets_key_per_instance> CentralValueType;
-#endif
+    //! A flag to indicate if this instance of Value has been identified as active
+    //! state.  If so it can assume that mCentralValueIndex has been appropriately
+    //! set and mValue gets copied in/out of sBaseCentralValue at the appropriate
+    //! time.
+    bool mIsStateCopy;
     //! A static reference into ManageStateVariables::mStateData only used if mIsStateCopy
     //! is true.  Note we make this field static so that we can quickly swap state
     //! between a "base" state or some "scratch" value from a central location.
-    static CentralValueType sCentralValue;
+    //! When GCAM_PARALLEL_ENABLED this is the state used by all threads unless
+    //! sThreadStateSource is set.
+    static double* sCentralValue;
+#if GCAM_PARALLEL_ENABLED
+    // When GCAM_PARALLEL_ENABLED each worker thread will have it's own slot of
+    // state assigned to it.  The slot is cached in a plain thread local pointer
+    // which is only refreshed when the central state changes, as flagged by
+    // sCentralValueVersion, so a read of state is a compare on a thread local
+    // and an index rather than a lookup in a thread specific table.
+    
+    //! If set each thread is assigned its own "scratch" state by this object
+    //! instead of using sCentralValue.
+    static ManageStateVariables* sThreadStateSource;
+    //! Incremented each time sCentralValue or sThreadStateSource change so that
+    //! each thread knows to refresh tCentralValue.
+    static unsigned int sCentralValueVersion;
+    //! The state the calling thread is currently using.
+    static thread_local double* tCentralValue;
+    //! The sCentralValueVersion at which tCentralValue was set.
+    static thread_local unsigned int tCentralValueVersion;
+    
+    static double* assignCentralValue();
+#endif
+    static double* getCentralValue();
     //! A static reference into the "base" state of ManageStateVariables::mStateData
     //! mostly for convenience.
     static double* sBaseCentralValue;
-    //! The index into sCentralValue that contains the data for this instance.
-    unsigned int mCentralValueIndex;
-    //! A flag to indicate if this instance of Value has been identified as active
-    //! state.  If so it can assume that mCentralValueIndex has been appropriately
-    //! set and mValue gets copied in/out of sBaseCentralValue at the appropriate
-    //! time.
-    bool mIsStateCopy;
+    //! The log base 2 of the number of state values in a page.  Each state
+    //! keeps a flag per page, just before the first value, which is set when a
+    //! value in the page is changed so that ManageStateVariables only has to
+    //! reset the changed pages.
+    static const unsigned int STATE_PAGE_SHIFT = 6;
     
 #if DEBUG_STATE
     void doStateCheck() const;
+#endif
+#if STATE_AUDIT
+    void auditWrite() const;
 #endif
     double& getInternal();
     const double& getInternal() const;
 };
 
+static_assert( sizeof( Value ) <= 2 * sizeof( double ), "Value should pack into two doubles" );
+
+/*!
+ * \brief Get the state the calling thread should read and write.
+ * \return A pointer to the first of the active state values.
+ */
+inline double* Value::getCentralValue() {
+#if !GCAM_PARALLEL_ENABLED
+    return sCentralValue;
+#else
+    return tCentralValueVersion == sCentralValueVersion ? tCentralValue : assignCentralValue();
+#endif
+}
+
 inline Value::Value(): mValue( 0 ), mIsInit( false ), mIsStateCopy( false ){
 }
 
@@ -180,17 +218,27 @@ inline void Value::init( const double aNewValue ){
 /*!
  * \brief An accessor method to get at the actual data held in this class.
  * \details This method will appropriately get the value locally or the centrally
- *          managed state if the mIsStateCopy flag is set.
+ *          managed state if the mIsStateCopy flag is set.  It is only used to
+ *          change the value so it also flags the page of managed state as changed.
  * \return A reference the the appropriate value represented by this class.
  */
 inline double& Value::getInternal() {
-    return mIsStateCopy ?
-#if !GCAM_PARALLEL_ENABLED
-        sCentralValue[mCentralValueIndex]
-#else
-        sCentralValue.local()[mCentralValueIndex]
+#if STATE_AUDIT
+    auditWrite();
 #endif
-        : mValue;
+    if( !mIsStateCopy ) {
+        return mValue;
+    }
+    double* state = getCentralValue();
+    // The caller may change the value so flag its page as changed.  The flag for
+    // page i is the i-th byte before the start of the state.  It is only stored
+    // the first time so that threads writing to the same page in a parallel
+    // calc do not keep writing to, and sharing the cache line of, the flags.
+    unsigned char& pageFlag = reinterpret_cast<unsigned char*>( state )[ -1 - static_cast<long>( mCentralValueIndex >> STATE_PAGE_SHIFT ) ];
+    if( !pageFlag ) {
+        pageFlag = 1;
+    }
+    return state[ mCentralValueIndex ];
 }
 
 /*!
@@ -200,13 +248,7 @@ inline double& Value::getInternal() {
  * \return A const reference the the appropriate value represented by this class.
  */
 inline const double& Value::getInternal() const {
-    return mIsStateCopy ?
-#if !GCAM_PARALLEL_ENABLED
-        sCentralValue[mCentralValueIndex]
-#else
-        sCentralValue.local()[mCentralValueIndex]
-#endif
-        : mValue;
+    return mIsStateCopy ? getCentralValue()[mCentralValueIndex] : mValue;
 }
 
 //! Set the value.
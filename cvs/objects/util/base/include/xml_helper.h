@@ -69,6 +69,8 @@
 #include <cassert>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
 #include <typeinfo>
 
@@ -82,6 +84,7 @@
 #include <xercesc/dom/DOMImplementation.hpp>
 #include <xercesc/sax/HandlerBase.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLUni.hpp>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -103,6 +106,8 @@
 #include "util/base/include/iparsable.h"
 #include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
+#include "util/base/include/xml_memory_manager.h"
+#include "util/base/include/compressed_input_source.h"
 
 /*!
  * \ingroup Objects
@@ -147,17 +152,17 @@ public:
     * \return void
     */
    void writeTabs( std::ostream& out ) const {
-      if ( mUseTabs ) {
-         for ( int i = 0; i != mNumTabs; ++i ) {
-            out << "\t";
-         }
-      }
-      else if ( mTabWidth ) {
-         std::string::size_type  n = mTabWidth * mNumTabs;
-         if ( n ) {
-            std::string spaces( n, ' ' );
-            out << spaces;
-         }
+      // Write the indent in blocks rather than a character or a temporary
+      // string at a time since this is called for every line of output.
+      static const char TAB_BLOCK[] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+      static const char SPACE_BLOCK[] = "                                ";
+      const char* block = mUseTabs ? TAB_BLOCK : SPACE_BLOCK;
+      const std::streamsize blockSize = mUseTabs ? sizeof( TAB_BLOCK ) - 1 : sizeof( SPACE_BLOCK ) - 1;
+      std::streamsize n = mUseTabs ? mNumTabs : mTabWidth * mNumTabs;
+      while( n > 0 ) {
+         const std::streamsize chunk = n < blockSize ? n : blockSize;
+         out.write( block, chunk );
+         n -= chunk;
       }
    }
 };
@@ -191,7 +196,8 @@ public:
                                        const Modeltime* aModeltime );
 
    static int getNodePeriod ( const xercesc::DOMNode* node, const Modeltime* modeltime );
-   static bool parseXML( const std::string& aXMLFile, IParsable* aModelElement );
+   static bool parseXML( const std::string& aXMLFile, IParsable* aModelElement, const bool aValidate = true );
+   static xercesc::DOMDocument* readDocument( const std::string& aXMLFile, const bool aValidate );
    static const std::string& text();
    static const std::string& name();
    static void cleanupParser();
@@ -317,7 +323,7 @@ void TechVectorParseHelper<T>::initializeVector( const unsigned int aStartPeriod
         aTechVec.mSize = aSize;
         // Note an unititialized TechVintageVector will not have allocated any
         // memory for mData so we do not need to worry about freeing that here
-        aTechVec.mData = new T[ aSize ];
+        aTechVec.mData = objects::allocateTimeArray( aSize, T() );
         
         // Attempt to copy in data from temporary storage
         TechVectorParseHelper<T>* currTVParseHelper = boost::fusion::at_key<T>( sTechVectorParseHelperMap );
@@ -712,6 +718,74 @@ std::string XMLHelper<T>::safeTranscode( const XMLCh* toTranscode ) {
    return retString;
 }
 
+/*!
+ * \brief Write a value to an XML output stream.
+ * \details The generic version simply uses the stream operator. Overloads for
+ *          the numeric types that make up nearly all of the output format
+ *          directly into a stack buffer which avoids the overhead of the
+ *          locale aware stream formatting machinery.
+ * \param aValue Value to write.
+ * \param aOut Stream to write to.
+ */
+template<class T>
+inline void XMLWriteValue( const T& aValue, std::ostream& aOut ) {
+    aOut << aValue;
+}
+
+/*!
+ * \brief Write an integer to an XML output stream.
+ * \param aValue Value to write.
+ * \param aOut Stream to write to.
+ */
+inline void XMLWriteValue( const int aValue, std::ostream& aOut ) {
+    if( aOut.width() != 0 || ( aOut.flags() & ( std::ios_base::basefield | std::ios_base::showpos ) )
+        != std::ios_base::dec )
+    {
+        aOut << aValue;
+        return;
+    }
+    char buffer[ 16 ];
+    char* end = buffer + sizeof( buffer );
+    char* curr = end;
+    // Work with the negative value so that the most negative int is handled.
+    int remaining = aValue < 0 ? aValue : -aValue;
+    do {
+        *--curr = static_cast<char>( '0' - remaining % 10 );
+        remaining /= 10;
+    } while( remaining != 0 );
+    if( aValue < 0 ) {
+        *--curr = '-';
+    }
+    aOut.write( curr, end - curr );
+}
+
+/*!
+ * \brief Write a double to an XML output stream.
+ * \details The value is formatted exactly as the stream operator would with
+ *          the default float field, using the precision of the stream. If
+ *          the stream has any other formatting flags set the stream operator
+ *          is used instead.
+ * \param aValue Value to write.
+ * \param aOut Stream to write to.
+ */
+inline void XMLWriteValue( const double aValue, std::ostream& aOut ) {
+    const std::ios_base::fmtflags SPECIAL_FLAGS = std::ios_base::floatfield | std::ios_base::showpoint
+        | std::ios_base::showpos | std::ios_base::uppercase;
+    if( aOut.width() != 0 || ( aOut.flags() & SPECIAL_FLAGS ) ) {
+        aOut << aValue;
+        return;
+    }
+    char buffer[ 64 ];
+    const int precision = static_cast<int>( std::min( aOut.precision(), std::streamsize( 40 ) ) );
+    const int length = snprintf( buffer, sizeof( buffer ), "%.*g", precision, aValue );
+    if( length > 0 && length < static_cast<int>( sizeof( buffer ) ) ) {
+        aOut.write( buffer, length );
+    }
+    else {
+        aOut << aValue;
+    }
+}
+
 //! Function to write the argument element to xml in proper format.
 /*!
 * This function is used to write a single element containing a single value and an optional year to the output stream
@@ -725,7 +799,7 @@ std::string XMLHelper<T>::safeTranscode( const XMLCh* toTranscode ) {
 * \param fillout Optional attribute which specifies the value should be applied to all following time periods.
 */
 template<class T>
-void XMLWriteElement( const T value, const std::string elementName, std::ostream& out, const Tabs* tabs, const int year = 0, const std::string name = "", const bool fillout = false ) {
+void XMLWriteElement( const T value, const std::string& elementName, std::ostream& out, const Tabs* tabs, const int year = 0, const std::string& name = "", const bool fillout = false ) {
 
    tabs->writeTabs( out );
 
@@ -736,16 +810,18 @@ void XMLWriteElement( const T value, const std::string elementName, std::ostream
    }
 
    if( year != 0 ){
-      out << " year=\"" << year << "\"";
+      out << " year=\"";
+      XMLWriteValue( year, out );
+      out << '"';
    }
    if( fillout ){
-       out << " fillout=\"" << 1 << "\"";
+       out << " fillout=\"1\"";
    }
-   out << ">";
+   out << '>';
 
-   out << value;
+   XMLWriteValue( value, out );
 
-   out << "</" << elementName << ">" << std::endl;
+   out << "</" << elementName << ">\n";
 }
 //! Function to write the argument element to xml with a integer attribute in proper format.
 /*!
@@ -758,9 +834,9 @@ void XMLWriteElement( const T value, const std::string elementName, std::ostream
 * \param aAttrs Map of attribute name to attribute value.
 */
 template<class T, class U>
-void XMLWriteElementWithAttributes( const T value, const std::string elementName,
+void XMLWriteElementWithAttributes( const T value, const std::string& elementName,
                                    std::ostream& out, const Tabs* tabs,
-                                   const std::map<std::string, U> aAttrs )
+                                   const std::map<std::string, U>& aAttrs )
 {
     tabs->writeTabs( out );
     out << "<" << elementName;
@@ -768,7 +844,9 @@ void XMLWriteElementWithAttributes( const T value, const std::string elementName
     for( MapIterator entry = aAttrs.begin(); entry != aAttrs.end(); ++entry ){
         out << " " << entry->first <<"=\"" << entry->second << "\"";
     }
-    out << ">" << value << "</" << elementName << ">" << std::endl;
+    out << '>';
+    XMLWriteValue( value, out );
+    out << "</" << elementName << ">\n";
 }
 
 /*! \brief Write an element XML tag.
@@ -793,7 +871,7 @@ inline void XMLWriteElementTag( const std::string& elementName, std::ostream& ou
 	   out << " " << tagType << "=\"" << typeName << "\"";
 		   
    }
-   out << ">" << std::endl;
+   out << ">\n";
    tabs->increaseIndent();
 }
 
@@ -809,8 +887,7 @@ inline void XMLWriteCloseElementTag( std::string& elementName, std::ostream& out
 {
     tabs->decreaseIndent();
     tabs->writeTabs( out );
-    out << "</" << elementName;
-    out << ">" << std::endl;
+    out << "</" << elementName << ">\n";
 }
 
 /*! \brief Write an opening XML tag.
@@ -832,7 +909,9 @@ inline void XMLWriteOpeningTag( const std::string& elementName, std::ostream& ou
     out << "<" << elementName;
 
     if( year ){
-        out << " year=\"" << year << "\"";
+        out << " year=\"";
+        XMLWriteValue( year, out );
+        out << '"';
     }
     if ( name != "" ){
         out << " name=\"" << name << "\"";
@@ -840,7 +919,7 @@ inline void XMLWriteOpeningTag( const std::string& elementName, std::ostream& ou
     if( type != "" ){
         out << " type=\"" << type << "\"";
     }
-    out << ">" << std::endl;
+    out << ">\n";
     tabs->increaseIndent();
 }
 
@@ -861,7 +940,7 @@ inline void XMLWriteOpeningTag( const std::string& aElementName, std::ostream& a
     for( auto iter = aAttrs.begin(); iter != aAttrs.end(); ++iter ) {
         aOut << " " << (*iter).first << "=\"" << (*iter).second << "\"";
     }
-    aOut << ">" << std::endl;
+    aOut << ">\n";
     aTabs->increaseIndent();
 }
 
@@ -877,8 +956,7 @@ inline void XMLWriteClosingTag( const std::string& elementName, std::ostream& ou
 
     tabs->decreaseIndent();
     tabs->writeTabs( out );
-    out << "</" << elementName;
-    out << ">" << std::endl;
+    out << "</" << elementName << ">\n";
 }
 
 //! Function to write the argument element to xml in proper format if it is not equal to the default value for the element..
@@ -895,7 +973,7 @@ inline void XMLWriteClosingTag( const std::string& elementName, std::ostream& ou
 * \param fillout Optional boolean whether to add the fillout attribute with a true value.
 */
 template<class T>
-void XMLWriteElementCheckDefault( const T value, const std::string elementName, std::ostream& out, const Tabs* tabs, const T defaultValue = T(), const int year = 0, const std::string name = "", const bool fillout = false ) {
+void XMLWriteElementCheckDefault( const T value, const std::string& elementName, std::ostream& out, const Tabs* tabs, const T defaultValue = T(), const int year = 0, const std::string& name = "", const bool fillout = false ) {
    if( !util::isEqual( value, defaultValue ) ) {
        XMLWriteElement( value, elementName, out, tabs, year, name, fillout );
    }
@@ -1051,21 +1129,28 @@ void XMLWriteVector( const objects::PeriodVector<T>& aOutputVector,
 * \brief Function to parse an XML file, returning a pointer to the root.
 *
 * This is a very simple function which calls the parse function and handles the exceptions which it may throw.
-* It also takes care of fetching the document and its root element.
+* It also takes care of fetching the document and its root element.  Files
+* ending in .gz or .zst are decompressed as they are read, see
+* CompressedInputSource.
 * \param aXMLFile The name of the file to parse.
 * \param aModelElement Element to call XMLParse on.
+* \param aValidate Whether to validate the file against its schema.
 * \return Whether parsing was successful.
 */
 
 template <class T>
-bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelElement ) {
-    // Track the number of active parses to avoid destroying a document that causes other
-    // documents to be parsed before its own parsing was complete.
+bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelElement, const bool aValidate ) {
+    // Track the number of active parses to avoid discarding the grammars of a
+    // document that causes other documents to be parsed before its own parsing
+    // was complete.
     static unsigned int numParses = 0;
     ++numParses;
     xercesc::XercesDOMParser* parser = XMLHelper<T>::getParser();
+    // Set on every parse since the parser is shared by all files.
+    parser->setValidationScheme( aValidate ? xercesc::XercesDOMParser::Val_Always : xercesc::XercesDOMParser::Val_Never );
+    parser->setDoSchema( aValidate );
     try {
-        parser->parse( aXMLFile.c_str() );
+        CompressedInputSource::parse( *parser, aXMLFile );
     } catch ( const xercesc::XMLException& toCatch ) {
         std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
         std::cout << "ERROR: XML Read Exception message is:" << std::endl << message << std::endl;
@@ -1083,7 +1168,12 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
         return false;
     }
 
-    bool success = aModelElement->XMLParse( parser->getDocument()->getDocumentElement() );
+    // Take ownership of the document so that it can be released as soon as it
+    // has been parsed into the model rather than being kept in the parser's
+    // document pool until all active parses are complete.
+    xercesc::DOMDocument* document = parser->adoptDocument();
+    bool success = aModelElement->XMLParse( document->getDocumentElement() );
+    document->release();
     // Cleanup parser memory if there are no active parses.
     if( --numParses == 0 ){
         parser->resetDocumentPool();
@@ -1092,6 +1182,46 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
     return success;
 }
 
+/*!
+* \brief Read an XML file into a DOM document using a parser of its own.
+* \details Unlike parseXML this does not use the shared parser, so several
+*          files may be read at once from different threads.
+* \param aXMLFile The name of the file to read.
+* \param aValidate Whether to validate the file against its schema.
+* \return The document which the caller must release, or null if the file
+*         could not be read.
+*/
+template <class T>
+xercesc::DOMDocument* XMLHelper<T>::readDocument( const std::string& aXMLFile, const bool aValidate ) {
+    xercesc::XercesDOMParser parser;
+    parser.setValidationScheme( aValidate ? xercesc::XercesDOMParser::Val_Always : xercesc::XercesDOMParser::Val_Never );
+    parser.setDoNamespaces( false );
+    parser.setDoSchema( aValidate );
+    parser.setCreateCommentNodes( false ); // No comment nodes
+    parser.setIncludeIgnorableWhitespace( false ); // No text nodes
+    xercesc::HandlerBase errorHandler;
+    parser.setErrorHandler( &errorHandler );
+    try {
+        CompressedInputSource::parse( parser, aXMLFile );
+    } catch ( const xercesc::XMLException& toCatch ) {
+        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
+        std::cout << "ERROR: XML Read Exception in " << aXMLFile << " message is:" << std::endl << message << std::endl;
+        return 0;
+    } catch ( const xercesc::DOMException& toCatch ) {
+        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.msg );
+        std::cout << "ERROR: XML Read Exception in " << aXMLFile << " message is:" << std::endl << message << std::endl;
+        return 0;
+    } catch ( const xercesc::SAXException& toCatch ){
+        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
+        std::cout << "ERROR: XML Read Exception in " << aXMLFile << " message is:" << std::endl << message << std::endl;
+        return 0;
+    } catch (...) {
+        std::cout << "ERROR:Unexpected XML Read Exception in " << aXMLFile << std::endl;
+        return 0;
+    }
+    return parser.adoptDocument();
+}
+
 /*! \brief Function which initializes the XML Platform and creates an instance
 * of an error handler and parser.
 * \note Logs are not initialized yet so they cannot be used.
@@ -1100,8 +1230,10 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
 template<class T>
 void XMLHelper<T>::initParser() {
     try {
-        // Initialize the Xerces platform.
-        xercesc::XMLPlatformUtils::Initialize();
+        // Initialize the Xerces platform.  All of its memory is allocated
+        // through the XMLMemoryManager so that it can be reported.
+        xercesc::XMLPlatformUtils::Initialize( xercesc::XMLUni::fgXercescDefaultLocale, 0, 0,
+                                               &XMLMemoryManager::getInstance() );
     } catch ( const xercesc::XMLException& toCatch ) {
         std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
         std::cout << "Severe error during XML Platform initialization: "<< std::endl << message << std::endl;
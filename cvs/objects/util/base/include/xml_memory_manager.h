@@ -0,0 +1,93 @@
+#ifndef _XML_MEMORY_MANAGER_H_
+#define _XML_MEMORY_MANAGER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file xml_memory_manager.h
+ * \ingroup util
+ * \brief XMLMemoryManager class header file.
+ */
+
+#include <cstddef>
+#include <atomic>
+#include <xercesc/framework/MemoryManager.hpp>
+
+/*!
+ * \ingroup util
+ * \brief A Xerces memory manager which keeps count of the memory Xerces
+ *        allocates.
+ * \details This is installed when the XML platform is initialized so that the
+ *          memory held by the parser and the DOM buffers it builds can be
+ *          reported along with that of the model.  Each allocation is preceded
+ *          by a small header recording its size, since Xerces does not pass
+ *          the size back when it deallocates.
+ */
+class XMLMemoryManager : public xercesc::MemoryManager {
+public:
+    static XMLMemoryManager& getInstance();
+
+    virtual xercesc::MemoryManager* getExceptionMemoryManager();
+
+    virtual void* allocate( XMLSize_t aSize );
+
+    virtual void deallocate( void* aPtr );
+
+    //! The bytes currently allocated by Xerces.
+    std::size_t getBytesInUse() const {
+        return mBytesInUse;
+    }
+
+    //! The most bytes that were allocated at once by Xerces.
+    std::size_t getPeakBytes() const {
+        return mPeakBytes;
+    }
+
+private:
+    XMLMemoryManager();
+
+    //! Space reserved ahead of each allocation which keeps it suitably aligned.
+    static const std::size_t HEADER_SIZE = 16;
+
+    //! The bytes currently allocated.
+    std::atomic<std::size_t> mBytesInUse;
+
+    //! The high water mark of mBytesInUse.
+    std::atomic<std::size_t> mPeakBytes;
+};
+
+#endif // _XML_MEMORY_MANAGER_H_
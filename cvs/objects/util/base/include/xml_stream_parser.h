@@ -0,0 +1,162 @@
+#ifndef _XML_STREAM_PARSER_H_
+#define _XML_STREAM_PARSER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file xml_stream_parser.h
+ * \ingroup util
+ * \brief XMLStreamParser class header file.
+ */
+
+#include <string>
+#include <set>
+#include <vector>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+
+class IParsable;
+
+/*!
+ * \ingroup util
+ * \brief Builds the DOM for an XML file one top level element at a time from
+ *        a stream of elements and hands each piece to the model.
+ * \details Each child of the root element, or of one of the given container
+ *          elements, is built into its own small document along with a copy
+ *          of its ancestors, including their attributes.  XMLParse is called
+ *          on that document's root when the child is complete and the
+ *          document is then released.  See XMLStreamParser, which feeds this
+ *          from a SAX reader, and InputImage, which feeds it from a
+ *          pre-compiled image.
+ */
+class XMLChunkBuilder {
+public:
+    //! The name and value of each attribute of an element.
+    typedef std::vector<std::pair<const XMLCh*, const XMLCh*> > AttributeList;
+    
+    XMLChunkBuilder( const std::string& aXMLFile, IParsable* aModelElement,
+                     const std::set<std::string>& aContainerNames );
+    
+    ~XMLChunkBuilder();
+    
+    void startElement( const XMLCh* const aName, const AttributeList& aAttrs );
+    
+    void endElement();
+    
+    void characters( const XMLCh* const aChars, const XMLSize_t aLength );
+    
+    //! Whether every call to XMLParse succeeded.
+    bool getSuccess() const {
+        return mSuccess;
+    }
+
+private:
+    typedef std::basic_string<XMLCh> XMLString_t;
+    
+    //! An element above the pieces which are parsed.
+    struct Ancestor {
+        XMLString_t mName;
+        std::vector<std::pair<XMLString_t, XMLString_t> > mAttrs;
+        bool mHasChildren;
+    };
+    
+    //! The model element to parse each piece into.
+    IParsable* mModelElement;
+    
+    //! Names of the elements whose children are parsed one at a time.
+    const std::set<std::string>& mContainerNames;
+    
+    //! The name of the file to set on each document for error messages.
+    XMLCh* mDocumentURI;
+    
+    //! The root and any containers currently open.
+    std::vector<Ancestor> mAncestors;
+    
+    //! The document for the piece currently being read, if any.
+    xercesc::DOMDocument* mChunk;
+    
+    //! The top element of the current piece.
+    xercesc::DOMElement* mChunkTop;
+    
+    //! The element currently being read.
+    xercesc::DOMElement* mCurrent;
+    
+    //! Text read for mCurrent which has not been added yet.
+    XMLString_t mText;
+    
+    //! Whether every call to XMLParse succeeded.
+    bool mSuccess;
+    
+    xercesc::DOMElement* createChunk( const size_t aNumAncestors );
+    
+    xercesc::DOMElement* createElement( const XMLCh* const aName, const AttributeList& aAttrs );
+    
+    void flushText();
+    
+    void releaseChunk();
+};
+
+/*!
+ * \ingroup util
+ * \brief Parses an XML file with a streaming SAX reader, handing it to the
+ *        model a piece at a time.
+ * \details XMLHelper::parseXML builds the DOM for an entire file before any
+ *          of it is given to the model which, for the full set of input files,
+ *          takes several GB at peak.  Here the file is read with a SAX2 reader
+ *          and only the DOM for one top level element is kept at a time.  Each
+ *          child of the root element, or of one of the given container
+ *          elements (such as world), is built by an XMLChunkBuilder into its
+ *          own small document which is handed to XMLParse and then released
+ *          before the reader continues.
+ *
+ *          Since the model's XMLParse routines already merge repeated elements
+ *          (that is how add-on files work) this gives the same result as
+ *          parsing the whole file at once, while the model's parse handlers
+ *          remain unchanged.  A root or container which has no children is
+ *          still handed to XMLParse on its own.
+ *
+ *          Validation against the schema is optional since it is one of the
+ *          larger costs of reading the input files.
+ */
+class XMLStreamParser {
+public:
+    static bool parseXML( const std::string& aXMLFile, IParsable* aModelElement,
+                          const std::set<std::string>& aContainerNames,
+                          const bool aValidate );
+};
+
+#endif // _XML_STREAM_PARSER_H_
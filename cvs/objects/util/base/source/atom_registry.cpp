@@ -89,6 +89,23 @@ namespace objects {
 		return ( iter != mAtoms->end() ) ? iter->second.get() : 0;
 	}
 
+	/*! \brief Get the atom for a name, creating it if it does not exist.
+	* \details This allows a name which is repeated throughout the input to be
+	*          stored once and shared.  The registry manages the memory of a
+	*          newly created Atom.
+	* \param aID The string identifier of the atom.
+	* \return The unique atom with the ID aID.
+	*/
+	const objects::Atom* AtomRegistry::getAtom( const string& aID ) {
+		const Atom* atom = findAtom( aID );
+		if( !atom ) {
+			atom = new Atom( aID );
+		}
+		/*! \invariant The ID of the atom is the requested ID. */
+		assert( atom->getID() == aID );
+		return atom;
+	}
+
 	/*! \brief Register an atom with the Atom registry so that it can be fetched
 	*          throughout the model and automatically deallocated.
 	* \details This method registers an Atom with the registry. The atom list is
@@ -0,0 +1,126 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file background_task_queue.cpp
+ * \ingroup Objects
+ * \brief BackgroundTaskQueue class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include "util/base/include/background_task_queue.h"
+
+using namespace std;
+
+//! Constructor, the thread is not started until a task is added.
+BackgroundTaskQueue::BackgroundTaskQueue():
+mIsRunning( false ),
+mIsClosing( false )
+{
+}
+
+//! Destructor which waits for all tasks to finish.
+BackgroundTaskQueue::~BackgroundTaskQueue() {
+    if( mThread.joinable() ) {
+        {
+            lock_guard<mutex> lock( mMutex );
+            mIsClosing = true;
+        }
+        mHasTasks.notify_one();
+        mThread.join();
+    }
+}
+
+/*!
+ * \brief Add a task to run after all of those already added.
+ * \details This waits if too many tasks are already waiting to run.
+ * \param aTask The task.
+ */
+void BackgroundTaskQueue::push( const function<void()>& aTask ) {
+    unique_lock<mutex> lock( mMutex );
+    if( !mThread.joinable() ) {
+        mThread = thread( &BackgroundTaskQueue::run, this );
+    }
+    mTaskFinished.wait( lock, [this]{ return mTasks.size() < MAX_PENDING_TASKS; } );
+    mTasks.push_back( aTask );
+    mHasTasks.notify_one();
+}
+
+/*!
+ * \brief Wait for all of the tasks which have been added to finish.
+ * \details If any of them threw an exception the first is rethrown.
+ */
+void BackgroundTaskQueue::wait() {
+    unique_lock<mutex> lock( mMutex );
+    mTaskFinished.wait( lock, [this]{ return mTasks.empty() && !mIsRunning; } );
+    if( mException ) {
+        exception_ptr taskException = mException;
+        mException = exception_ptr();
+        rethrow_exception( taskException );
+    }
+}
+
+//! The loop run by the background thread.
+void BackgroundTaskQueue::run() {
+    unique_lock<mutex> lock( mMutex );
+    while( true ) {
+        mHasTasks.wait( lock, [this]{ return mIsClosing || !mTasks.empty(); } );
+        if( mTasks.empty() ) {
+            // Only get here when closing with nothing left to do.
+            break;
+        }
+        function<void()> task;
+        task.swap( mTasks.front() );
+        mTasks.pop_front();
+        mIsRunning = true;
+        lock.unlock();
+
+        try {
+            task();
+        }
+        catch( ... ) {
+            lock.lock();
+            if( !mException ) {
+                mException = current_exception();
+            }
+            lock.unlock();
+        }
+        // Release anything the task holds before reporting it has finished.
+        task = function<void()>();
+
+        lock.lock();
+        mIsRunning = false;
+        mTaskFinished.notify_all();
+    }
+}
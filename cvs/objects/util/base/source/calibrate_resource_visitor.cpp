@@ -65,6 +65,8 @@ extern Scenario* scenario;
 CalibrateResourceVisitor::CalibrateResourceVisitor( const string& aRegionName )
 :mCurrentRegionName( aRegionName )
 {
+    // Only resources and subresources are calibrated.
+    skipContent( IVisitor::SUBSECTORS | IVisitor::SUBRESOURCE_CONTENTS | IVisitor::MARKETS );
 }
 
 void CalibrateResourceVisitor::startVisitResource( const AResource* aResource,
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <vector>
 #include <boost/math/tr1.hpp>
 
 #include "util/base/include/calibrate_share_weight_visitor.h"
@@ -64,6 +65,8 @@ extern Scenario* scenario;
 CalibrateShareWeightVisitor::CalibrateShareWeightVisitor( const string& aRegionName, const GDP* aGDP )
 :mCurrentRegionName( aRegionName ), mGDP( aGDP )
 {
+    // Only sectors and subsectors are calibrated.
+    skipContent( IVisitor::TECHNOLOGIES | IVisitor::SUBRESOURCES | IVisitor::MARKETS );
 }
 
 /*!
@@ -90,6 +93,16 @@ CalibrateShareWeightVisitor::CalibrateShareWeightVisitor( const string& aRegionN
 template<typename ContainerType>
 void CalibrateShareWeightVisitor::calibrateShareWeights( const ContainerType* aContainer, const int aPeriod ) const
 {
+    // Look up what is needed from each child once, the cost of a Subsector in
+    // particular requires calculating the shares of its technologies.
+    struct ChildInfo {
+        double mCalValue;
+        double mCost;
+        double mFuelPrefElasticity;
+    };
+    auto childrenVec = getChildren( aContainer, aPeriod );
+    vector<ChildInfo> childInfo( childrenVec.size() );
+    
     // Find out if we need to do calibration, make sure we do not have a mix of calibrated/non-calibrated
     // children, and figure out the largest child to make the other children anchored by it.
     int anchorIndex = -1;
@@ -97,10 +110,12 @@ void CalibrateShareWeightVisitor::calibrateShareWeights( const ContainerType* aC
     double maxCalValue = 0;
     int numCalChildren = 0;
     double totalCalValue = 0;
-    auto childrenVec = getChildren( aContainer, aPeriod );
     for( int childIndex = 0; childIndex < childrenVec.size(); ++childIndex ) {
         double currCalValue = getCalValue( childrenVec[ childIndex ], aPeriod );
         bool isAvail = isAvailable( childrenVec[ childIndex ], aPeriod );
+        childInfo[ childIndex ].mCalValue = currCalValue;
+        childInfo[ childIndex ].mCost = getCost( childrenVec[ childIndex ], aPeriod );
+        childInfo[ childIndex ].mFuelPrefElasticity = getFuelPrefElasticity( childrenVec[ childIndex ], aPeriod );
         
         // check if the child is calibrated
         if( hasCalValues && currCalValue <= 0 && isAvail ) {
@@ -144,9 +159,9 @@ void CalibrateShareWeightVisitor::calibrateShareWeights( const ContainerType* aC
     // parse a value.
     double baseCost = 0;
     for( int childIndex = 0; childIndex < childrenVec.size(); ++childIndex ) {
-        double currCost = getCost( childrenVec[ childIndex ], aPeriod );
+        double currCost = childInfo[ childIndex ].mCost;
         if( !boost::math::isnan( currCost )  && currCost > baseCost &&
-           ( ( hasCalValues && getCalValue( childrenVec[ childIndex ], aPeriod ) > 0 ) || !hasCalValues ) )
+           ( ( hasCalValues && childInfo[ childIndex ].mCalValue > 0 ) || !hasCalValues ) )
         {
             baseCost = currCost;
         }
@@ -166,23 +181,20 @@ void CalibrateShareWeightVisitor::calibrateShareWeights( const ContainerType* aC
         // we should have found a child to have share weights anchored
         assert( anchorIndex != -1 );
         const double scaledGdpPerCapita = mGDP->getBestScaledGDPperCap( aPeriod );
-        const double anchorCost = getCost( childrenVec[ anchorIndex ], aPeriod );
-        const double anchorShare = ( getCalValue( childrenVec[ anchorIndex ], aPeriod )
-                                    / totalCalValue ) / pow( scaledGdpPerCapita, getFuelPrefElasticity( childrenVec[ anchorIndex ], aPeriod ) );
+        const double anchorCost = childInfo[ anchorIndex ].mCost;
+        const double anchorShare = ( childInfo[ anchorIndex ].mCalValue / totalCalValue )
+                                    / pow( scaledGdpPerCapita, childInfo[ anchorIndex ].mFuelPrefElasticity );
         assert( anchorShare > 0 );
         
         for( int childIndex = 0; childIndex < childrenVec.size(); ++childIndex ) {
-            auto currChild = childrenVec[ childIndex ];
-            double currShare = ( getCalValue( currChild, aPeriod ) / totalCalValue )
-                / pow( scaledGdpPerCapita, getFuelPrefElasticity( currChild, aPeriod ) );
+            double currShare = ( childInfo[ childIndex ].mCalValue / totalCalValue )
+                / pow( scaledGdpPerCapita, childInfo[ childIndex ].mFuelPrefElasticity );
             
             // only set the share weight for valid children
             if( currShare > 0 ) {
-                double currCost = getCost( currChild, aPeriod );
-                
-                double currShareWeight = choiceFn->calcShareWeight( currShare, currCost,
+                double currShareWeight = choiceFn->calcShareWeight( currShare, childInfo[ childIndex ].mCost,
                                                                     anchorShare, anchorCost, aPeriod );
-                setShareWeight( currChild, currShareWeight, aPeriod );
+                setShareWeight( childrenVec[ childIndex ], currShareWeight, aPeriod );
             }
         }
     }
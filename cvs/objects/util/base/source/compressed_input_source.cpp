@@ -0,0 +1,415 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file compressed_input_source.cpp
+ * \ingroup util
+ * \brief CompressedInputSource class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <xercesc/util/BinInputStream.hpp>
+
+#include "util/base/include/compressed_input_source.h"
+
+#if USE_ZLIB
+#include <zlib.h>
+#endif
+
+#if USE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    //! The size of the blocks read from the file and of the decompressed chunks.
+    const size_t BLOCK_SIZE = 1024 * 1024;
+
+    //! The number of decompressed chunks the reader thread may get ahead of
+    //! the parser.
+    const size_t MAX_CHUNKS = 8;
+
+    /*!
+     * \brief A stream of the decompressed contents of a file, which are
+     *        produced by a background thread.
+     */
+    class DecompressingInputStream : public BinInputStream {
+    public:
+        DecompressingInputStream( const string& aFileName, FILE* aFile,
+                                  const CompressedInputSource::Format aFormat );
+        virtual ~DecompressingInputStream();
+        virtual XMLFilePos curPos() const;
+        virtual XMLSize_t readBytes( XMLByte* const aToFill, const XMLSize_t aMaxToRead );
+        virtual const XMLCh* getContentType() const;
+    private:
+        void run();
+        bool decompressGzip();
+        bool decompressZstd();
+        bool push( vector<XMLByte>& aChunk );
+
+        //! The name of the file, for error messages.
+        const string mFileName;
+
+        //! The open compressed file.
+        FILE* mFile;
+
+        //! The compression format of the file.
+        const CompressedInputSource::Format mFormat;
+
+        //! Decompressed chunks waiting to be read by the parser.
+        deque<vector<XMLByte> > mChunks;
+
+        //! The chunk being read by the parser.
+        vector<XMLByte> mCurrent;
+
+        //! The position of the parser in mCurrent.
+        size_t mCurrentPos;
+
+        //! The number of bytes read by the parser.
+        XMLFilePos mPos;
+
+        //! Whether the reader thread has decompressed the whole file.
+        bool mIsDone;
+
+        //! Whether the stream is being destroyed and the reader thread should exit.
+        bool mIsClosing;
+
+        //! Protects mChunks, mIsDone and mIsClosing.
+        mutex mMutex;
+
+        //! Signals that a chunk is available or that the reader thread is done.
+        condition_variable mHasChunk;
+
+        //! Signals that there is space in mChunks or that the stream is closing.
+        condition_variable mHasSpace;
+
+        //! The reader thread.
+        thread mThread;
+    };
+
+    DecompressingInputStream::DecompressingInputStream( const string& aFileName, FILE* aFile,
+                                                        const CompressedInputSource::Format aFormat )
+    :mFileName( aFileName ),
+    mFile( aFile ),
+    mFormat( aFormat ),
+    mCurrentPos( 0 ),
+    mPos( 0 ),
+    mIsDone( false ),
+    mIsClosing( false )
+    {
+        mThread = thread( &DecompressingInputStream::run, this );
+    }
+
+    //! Destructor which stops the reader thread if the parse ended early.
+    DecompressingInputStream::~DecompressingInputStream() {
+        {
+            lock_guard<mutex> lock( mMutex );
+            mIsClosing = true;
+        }
+        mHasSpace.notify_one();
+        mThread.join();
+        fclose( mFile );
+    }
+
+    XMLFilePos DecompressingInputStream::curPos() const {
+        return mPos;
+    }
+
+    /*!
+     * \brief Copy decompressed data to the parser.
+     * \details This waits for the reader thread only if no data is available.
+     * \param aToFill The buffer to fill.
+     * \param aMaxToRead The size of the buffer.
+     * \return The number of bytes copied, zero at the end of the file.
+     */
+    XMLSize_t DecompressingInputStream::readBytes( XMLByte* const aToFill, const XMLSize_t aMaxToRead ) {
+        XMLSize_t filled = 0;
+        while( filled < aMaxToRead ) {
+            if( mCurrentPos == mCurrent.size() ) {
+                unique_lock<mutex> lock( mMutex );
+                // Give the parser what we have rather than waiting for more.
+                if( filled > 0 && mChunks.empty() ) {
+                    break;
+                }
+                mHasChunk.wait( lock, [this]{ return !mChunks.empty() || mIsDone; } );
+                if( mChunks.empty() ) {
+                    break;
+                }
+                mCurrent.swap( mChunks.front() );
+                mChunks.pop_front();
+                mCurrentPos = 0;
+                mHasSpace.notify_one();
+            }
+            const size_t count = min( static_cast<size_t>( aMaxToRead - filled ), mCurrent.size() - mCurrentPos );
+            memcpy( aToFill + filled, &mCurrent[ mCurrentPos ], count );
+            mCurrentPos += count;
+            filled += count;
+        }
+        mPos += filled;
+        return filled;
+    }
+
+    //! The content type is not known.
+    const XMLCh* DecompressingInputStream::getContentType() const {
+        return 0;
+    }
+
+    //! The loop run by the reader thread.
+    void DecompressingInputStream::run() {
+        if( mFormat == CompressedInputSource::GZIP ) {
+            decompressGzip();
+        }
+        else {
+            decompressZstd();
+        }
+        {
+            lock_guard<mutex> lock( mMutex );
+            mIsDone = true;
+        }
+        mHasChunk.notify_one();
+    }
+
+    /*!
+     * \brief Queue a decompressed chunk for the parser, waiting for space if the
+     *        queue is full.
+     * \param aChunk The chunk, which is left empty.
+     * \return False if the stream is closing and decompression should stop.
+     */
+    bool DecompressingInputStream::push( vector<XMLByte>& aChunk ) {
+        unique_lock<mutex> lock( mMutex );
+        mHasSpace.wait( lock, [this]{ return mChunks.size() < MAX_CHUNKS || mIsClosing; } );
+        if( mIsClosing ) {
+            return false;
+        }
+        mChunks.push_back( vector<XMLByte>() );
+        mChunks.back().swap( aChunk );
+        mHasChunk.notify_one();
+        return true;
+    }
+
+    /*!
+     * \brief Decompress a gzip file, which may consist of several concatenated
+     *        members.
+     * \details An error, including a truncated file, is reported and ends the
+     *          stream early which causes the parse to fail.
+     * \return Whether the whole file was decompressed.
+     */
+    bool DecompressingInputStream::decompressGzip() {
+#if USE_ZLIB
+        z_stream stream;
+        memset( &stream, 0, sizeof( stream ) );
+        // Adding 32 to the window bits accepts either a gzip or a zlib header.
+        if( inflateInit2( &stream, 15 + 32 ) != Z_OK ) {
+            cout << "ERROR: Could not start decompressing " << mFileName << endl;
+            return false;
+        }
+        vector<Bytef> input( BLOCK_SIZE );
+        vector<XMLByte> output( BLOCK_SIZE );
+        bool success = true;
+        bool isMemberEnd = false;
+        bool isOutputFull = false;
+        while( success ) {
+            // Only read more once zlib has written out everything it can from
+            // the input it has.
+            if( stream.avail_in == 0 && !isOutputFull ) {
+                stream.avail_in = static_cast<uInt>( fread( &input[ 0 ], 1, input.size(), mFile ) );
+                stream.next_in = &input[ 0 ];
+                if( stream.avail_in == 0 ) {
+                    break;
+                }
+            }
+            stream.next_out = &output[ 0 ];
+            stream.avail_out = static_cast<uInt>( output.size() );
+            const uInt availableInput = stream.avail_in;
+            const int status = inflate( &stream, Z_NO_FLUSH );
+            isOutputFull = stream.avail_out == 0;
+            const size_t produced = output.size() - stream.avail_out;
+            if( status == Z_STREAM_END ) {
+                isMemberEnd = true;
+                inflateReset( &stream );
+            }
+            else if( status == Z_OK || ( status == Z_BUF_ERROR && stream.avail_in == 0 ) ) {
+                isMemberEnd = isMemberEnd && produced == 0 && availableInput == stream.avail_in;
+            }
+            else {
+                cout << "ERROR: Could not decompress " << mFileName << ": "
+                     << ( stream.msg ? stream.msg : "unknown error" ) << endl;
+                success = false;
+            }
+            if( produced > 0 ) {
+                output.resize( produced );
+                success = push( output ) && success;
+                output.resize( BLOCK_SIZE );
+            }
+        }
+        if( success && !isMemberEnd ) {
+            cout << "ERROR: " << mFileName << " ended before the end of the compressed data." << endl;
+            success = false;
+        }
+        inflateEnd( &stream );
+        return success;
+#else
+        return false;
+#endif
+    }
+
+    /*!
+     * \brief Decompress a zstd file, which may consist of several frames.
+     * \details An error, including a truncated file, is reported and ends the
+     *          stream early which causes the parse to fail.
+     * \return Whether the whole file was decompressed.
+     */
+    bool DecompressingInputStream::decompressZstd() {
+#if USE_ZSTD
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        if( !stream || ZSTD_isError( ZSTD_initDStream( stream ) ) ) {
+            cout << "ERROR: Could not start decompressing " << mFileName << endl;
+            ZSTD_freeDStream( stream );
+            return false;
+        }
+        vector<char> inputData( BLOCK_SIZE );
+        vector<XMLByte> output( BLOCK_SIZE );
+        ZSTD_inBuffer input = { &inputData[ 0 ], 0, 0 };
+        bool success = true;
+        bool isFrameEnd = true;
+        bool isOutputFull = false;
+        while( success ) {
+            // Only read more once zstd has written out everything it can from
+            // the input it has.
+            if( input.pos == input.size && !isOutputFull ) {
+                input.size = fread( &inputData[ 0 ], 1, inputData.size(), mFile );
+                input.pos = 0;
+                if( input.size == 0 ) {
+                    break;
+                }
+            }
+            ZSTD_outBuffer outBuffer = { &output[ 0 ], output.size(), 0 };
+            const size_t result = ZSTD_decompressStream( stream, &outBuffer, &input );
+            if( ZSTD_isError( result ) ) {
+                cout << "ERROR: Could not decompress " << mFileName << ": "
+                     << ZSTD_getErrorName( result ) << endl;
+                success = false;
+                break;
+            }
+            // A result of zero means a frame was completely decoded and flushed.
+            isFrameEnd = result == 0;
+            isOutputFull = outBuffer.pos == outBuffer.size;
+            if( outBuffer.pos > 0 ) {
+                output.resize( outBuffer.pos );
+                success = push( output );
+                output.resize( BLOCK_SIZE );
+            }
+        }
+        if( success && !isFrameEnd ) {
+            cout << "ERROR: " << mFileName << " ended before the end of the compressed data." << endl;
+            success = false;
+        }
+        ZSTD_freeDStream( stream );
+        return success;
+#else
+        return false;
+#endif
+    }
+}
+
+/*!
+ * \brief Constructor.
+ * \param aFileName The name of the compressed file, which is also used as the
+ *        system id to report errors and to locate the schema.
+ * \param aFormat The compression format of the file.
+ */
+CompressedInputSource::CompressedInputSource( const string& aFileName, const Format aFormat )
+:InputSource( aFileName.c_str() ),
+mFileName( aFileName ),
+mFormat( aFormat )
+{
+}
+
+/*!
+ * \brief Open the file and start decompressing it.
+ * \return The stream of decompressed data which the parser will delete, or
+ *         null if the file can not be read which the parser reports.
+ */
+BinInputStream* CompressedInputSource::makeStream() const {
+#if !USE_ZLIB
+    if( mFormat == GZIP ) {
+        cout << "ERROR: GCAM was built without USE_ZLIB, " << mFileName << " can not be read." << endl;
+        return 0;
+    }
+#endif
+#if !USE_ZSTD
+    if( mFormat == ZSTD ) {
+        cout << "ERROR: GCAM was built without USE_ZSTD, " << mFileName << " can not be read." << endl;
+        return 0;
+    }
+#endif
+    FILE* file = fopen( mFileName.c_str(), "rb" );
+    if( !file ) {
+        return 0;
+    }
+    return new DecompressingInputStream( mFileName, file, mFormat );
+}
+
+/*!
+ * \brief Determine the compression format of a file from its extension.
+ * \param aFileName The name of the file.
+ * \return GZIP for .gz files, ZSTD for .zst files and otherwise NONE.
+ */
+CompressedInputSource::Format CompressedInputSource::getFormat( const string& aFileName ) {
+    const string gzExtension = ".gz";
+    const string zstdExtension = ".zst";
+    if( aFileName.size() > gzExtension.size() &&
+        aFileName.compare( aFileName.size() - gzExtension.size(), gzExtension.size(), gzExtension ) == 0 )
+    {
+        return GZIP;
+    }
+    if( aFileName.size() > zstdExtension.size() &&
+        aFileName.compare( aFileName.size() - zstdExtension.size(), zstdExtension.size(), zstdExtension ) == 0 )
+    {
+        return ZSTD;
+    }
+    return NONE;
+}
@@ -46,6 +46,7 @@
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/configuration.h"
+#include "util/base/include/configuration_setting.h"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
 
@@ -127,9 +128,40 @@ bool Configuration::XMLParse( const DOMNode* root ) {
             }
 		} // for ( int j = 0;...
 	} // for ( int i = 0;...
+
+    // Now that all of the values are known load the typed settings.
+    const vector<AConfigurationSetting*>& settings = getRegisteredSettings();
+    for( vector<AConfigurationSetting*>::const_iterator it = settings.begin(); it != settings.end(); ++it ) {
+        (*it)->load( this );
+    }
     return true;
 }
 
+/*! \brief Register a typed setting to be loaded when the configuration is parsed.
+* \details This is called by the constructor of each ConfigurationSetting which
+*          are typically static objects so it may be called during static
+*          initialization.  If the configuration has already been parsed the
+*          setting is loaded immediately.
+* \param aSetting The setting to register.
+*/
+void Configuration::registerSetting( AConfigurationSetting* aSetting ) {
+    getRegisteredSettings().push_back( aSetting );
+    if( gInstance.get() ) {
+        aSetting->load( gInstance.get() );
+    }
+}
+
+/*! \brief Get the list of registered typed settings.
+* \details The list is a function local static so that it is constructed before
+*          any setting registers itself regardless of static initialization
+*          order.
+* \return The registered settings.
+*/
+vector<AConfigurationSetting*>& Configuration::getRegisteredSettings() {
+    static vector<AConfigurationSetting*> sSettings;
+    return sSettings;
+}
+
 //! Print the internal variables to XML output.
 void Configuration::toDebugXML( ostream& out, Tabs* tabs ) const {
 		
@@ -187,6 +219,31 @@ void Configuration::toDebugXML( ostream& out, Tabs* tabs ) const {
     XMLWriteClosingTag( "Configuration", out, tabs );
 }
 
+/*!
+ * \brief Write the values of the Strings, Bools, Ints and Doubles sections, one
+ *        per line, for comparing the settings of two runs.
+ * \details The Files and ScenarioComponents sections are not included since
+ *          they name files rather than hold the values themselves. Doubles are
+ *          written with full precision.
+ * \param aOut Stream to write to.
+ */
+void Configuration::writeSettings( ostream& aOut ) const {
+    for( map<string, string>::const_iterator stringIter = stringMap.begin(); stringIter != stringMap.end(); ++stringIter ) {
+        aOut << "string " << stringIter->first << "=" << stringIter->second << endl;
+    }
+    for( map<string, bool>::const_iterator boolIter = boolMap.begin(); boolIter != boolMap.end(); ++boolIter ) {
+        aOut << "bool " << boolIter->first << "=" << boolIter->second << endl;
+    }
+    for( map<string, int>::const_iterator intIter = intMap.begin(); intIter != intMap.end(); ++intIter ) {
+        aOut << "int " << intIter->first << "=" << intIter->second << endl;
+    }
+    const streamsize precision = aOut.precision( 17 );
+    for( map<string, double>::const_iterator doubleIter = doubleMap.begin(); doubleIter != doubleMap.end(); ++doubleIter ) {
+        aOut << "double " << doubleIter->first << "=" << doubleIter->second << endl;
+    }
+    aOut.precision( precision );
+}
+
 /*! 
 * \brief Fetch a filename from the Configuration object.
 * 
@@ -0,0 +1,80 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+
+/*! 
+ * \file fast_math.cpp
+ * \ingroup util
+ * \brief FastMath class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include "util/base/include/fast_math.h"
+#include "util/base/include/configuration.h"
+
+/*!
+ * \brief Whether the fast math functions should be used in place of libm.
+ * \details Set by the Bools configuration value use-fast-math-kernels.  The
+ *          value is read on the first call and kept for the rest of the run.
+ * \return Whether the fast math functions are enabled.
+ */
+bool FastMath::isEnabled() {
+    const static bool isEnabled = Configuration::getInstance()->getBool( "use-fast-math-kernels", false, false );
+    return isEnabled;
+}
+
+/*!
+ * \brief Calculate e raised to each of an array of powers.
+ * \param aX The powers.
+ * \param aResult The array to fill in, which may be the same as aX.
+ * \param aSize The number of values.
+ */
+void FastMath::exp( const double* aX, double* aResult, const size_t aSize ) {
+    for( size_t i = 0; i < aSize; ++i ) {
+        aResult[ i ] = exp( aX[ i ] );
+    }
+}
+
+/*!
+ * \brief Calculate the natural log of each of an array of values.
+ * \param aX The values.
+ * \param aResult The array to fill in, which may be the same as aX.
+ * \param aSize The number of values.
+ */
+void FastMath::log( const double* aX, double* aResult, const size_t aSize ) {
+    for( size_t i = 0; i < aSize; ++i ) {
+        aResult[ i ] = log( aX[ i ] );
+    }
+}
@@ -132,3 +132,26 @@ std::vector<FilterStep*> parseFilterString( const std::string& aFilterStr ) {
     }
     return filterSteps;
 }
+
+namespace {
+    //! A counter which is incremented each time the GCAM object tree may have changed.
+    unsigned int gFusionTreeGeneration = 0;
+}
+
+/*!
+ * \brief Get a value which identifies the current shape of the GCAM object tree.
+ * \details A GCAMFusionQuery may keep its results for as long as this value stays
+ *          the same.
+ * \return The current generation of the GCAM object tree.
+ */
+unsigned int getFusionTreeGeneration() {
+    return gFusionTreeGeneration;
+}
+
+/*!
+ * \brief Signal that objects may have been created or removed in the GCAM object
+ *        tree so that all GCAMFusionQuery results must be searched again.
+ */
+void markFusionTreeChanged() {
+    ++gFusionTreeGeneration;
+}
@@ -0,0 +1,823 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file input_image.cpp
+ * \ingroup util
+ * \brief InputImage class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNamedNodeMap.hpp>
+#include <xercesc/dom/DOMAttr.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GCAM_MMAP_IMAGE 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define GCAM_MMAP_IMAGE 0
+#endif
+
+#include "util/base/include/input_image.h"
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/result_cache.h"
+#include "util/base/include/version.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    typedef basic_string<XMLCh> XMLString_t;
+    
+    //! Identifies a file as an input image.
+    const char IMAGE_MAGIC[ 8 ] = "GCAMIMG";
+    
+    //! The version of the image layout, which must be incremented whenever the
+    //! layout changes.
+    const uint32_t IMAGE_VERSION = 1;
+    
+    //! The kinds of element records.
+    enum RecordType {
+        START_ELEMENT = 1,
+        TEXT,
+        END_ELEMENT
+    };
+    
+    //! The header at the start of an image.
+    struct ImageHeader {
+        char mMagic[ 8 ];
+        uint32_t mVersion;
+        uint32_t mNumFiles;
+        uint64_t mNumStrings;
+        //! Byte offset of the first ImageFileEntry.
+        uint64_t mFilesOffset;
+        //! Byte offset of the string table.
+        uint64_t mStringsOffset;
+        //! Byte offset of the element records.
+        uint64_t mRecordsOffset;
+        //! The number of element record words.
+        uint64_t mRecordsSize;
+    };
+    
+    //! The description of each input file saved in an image.
+    struct ImageFileEntry {
+        //! The string index of the file name.
+        uint32_t mName;
+        uint32_t mPadding;
+        //! The size of the file when the image was compiled.
+        uint64_t mFileSize;
+        //! The modification time of the file when the image was compiled.
+        int64_t mFileModified;
+        //! The range of element record words for the file.
+        uint64_t mRecordsBegin;
+        uint64_t mRecordsEnd;
+    };
+    
+    /*!
+     * \brief Get the size and modification time of a file.
+     * \return Whether the file exists.
+     */
+    bool getFileStamp( const string& aFileName, uint64_t& aFileSize, int64_t& aFileModified ) {
+        struct stat fileStat;
+        if( stat( aFileName.c_str(), &fileStat ) != 0 ) {
+            return false;
+        }
+        aFileSize = fileStat.st_size;
+        aFileModified = fileStat.st_mtime;
+        return true;
+    }
+    
+    /*!
+     * \brief Collects the string table and element records for an image.
+     */
+    class ImageWriter {
+    public:
+        //! Add the elements of a document read from aFileName.
+        void addFile( const string& aFileName, const DOMDocument* aDocument ) {
+            ImageFileEntry entry;
+            memset( &entry, 0, sizeof( entry ) );
+            XMLCh* name = XMLString::transcode( aFileName.c_str() );
+            entry.mName = intern( name );
+            XMLString::release( &name );
+            getFileStamp( aFileName, entry.mFileSize, entry.mFileModified );
+            entry.mRecordsBegin = mRecords.size();
+            addElement( aDocument->getDocumentElement() );
+            entry.mRecordsEnd = mRecords.size();
+            mFiles.push_back( entry );
+        }
+        
+        //! Write the image to aImageFile.
+        bool write( const string& aImageFile ) const {
+            ofstream out( aImageFile.c_str(), ios::out | ios::binary );
+            if( !out.is_open() ) {
+                return false;
+            }
+            return write( out );
+        }
+        
+        //! Write the image to a stream opened in binary mode.
+        bool write( ostream& out ) const {
+            ImageHeader header;
+            memset( &header, 0, sizeof( header ) );
+            memcpy( header.mMagic, IMAGE_MAGIC, sizeof( header.mMagic ) );
+            header.mVersion = IMAGE_VERSION;
+            header.mNumFiles = mFiles.size();
+            header.mNumStrings = mStrings.size();
+            header.mFilesOffset = sizeof( ImageHeader );
+            header.mStringsOffset = header.mFilesOffset + mFiles.size() * sizeof( ImageFileEntry );
+            uint64_t stringsSize = 0;
+            for( const auto& str : mStrings ) {
+                stringsSize += getStringSize( str );
+            }
+            header.mRecordsOffset = header.mStringsOffset + stringsSize;
+            header.mRecordsSize = mRecords.size();
+            
+            out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+            if( !mFiles.empty() ) {
+                out.write( reinterpret_cast<const char*>( &mFiles[ 0 ] ), mFiles.size() * sizeof( ImageFileEntry ) );
+            }
+            const char padding[ sizeof( uint32_t ) ] = { 0 };
+            for( const auto& str : mStrings ) {
+                const uint32_t length = str.size();
+                out.write( reinterpret_cast<const char*>( &length ), sizeof( length ) );
+                out.write( reinterpret_cast<const char*>( str.c_str() ), ( length + 1 ) * sizeof( XMLCh ) );
+                out.write( padding, getStringSize( str ) - sizeof( length ) - ( length + 1 ) * sizeof( XMLCh ) );
+            }
+            if( !mRecords.empty() ) {
+                out.write( reinterpret_cast<const char*>( &mRecords[ 0 ] ), mRecords.size() * sizeof( uint32_t ) );
+            }
+            return out.good();
+        }
+        
+    private:
+        //! The index of each string in the table.
+        map<XMLString_t, uint32_t> mStringIndex;
+        
+        //! The string table.
+        vector<XMLString_t> mStrings;
+        
+        //! The element records.
+        vector<uint32_t> mRecords;
+        
+        //! The files which have been added.
+        vector<ImageFileEntry> mFiles;
+        
+        //! The number of bytes a string takes in the table, including its
+        //! length, null terminator and padding to keep the table aligned.
+        static uint64_t getStringSize( const XMLString_t& aString ) {
+            const uint64_t size = sizeof( uint32_t ) + ( aString.size() + 1 ) * sizeof( XMLCh );
+            return ( size + sizeof( uint32_t ) - 1 ) / sizeof( uint32_t ) * sizeof( uint32_t );
+        }
+        
+        //! Get the index of a string, adding it to the table if needed.
+        uint32_t intern( const XMLCh* aString ) {
+            const XMLString_t str( aString );
+            auto iter = mStringIndex.find( str );
+            if( iter != mStringIndex.end() ) {
+                return iter->second;
+            }
+            const uint32_t index = mStrings.size();
+            mStrings.push_back( str );
+            mStringIndex[ str ] = index;
+            return index;
+        }
+        
+        //! Add the records for an element and its children.
+        void addElement( const DOMNode* aNode ) {
+            mRecords.push_back( START_ELEMENT );
+            mRecords.push_back( intern( aNode->getNodeName() ) );
+            const DOMNamedNodeMap* attrs = aNode->getAttributes();
+            const XMLSize_t numAttrs = attrs ? attrs->getLength() : 0;
+            mRecords.push_back( numAttrs );
+            for( XMLSize_t i = 0; i < numAttrs; ++i ) {
+                const DOMAttr* attr = static_cast<const DOMAttr*>( attrs->item( i ) );
+                mRecords.push_back( intern( attr->getName() ) );
+                mRecords.push_back( intern( attr->getValue() ) );
+            }
+            for( const DOMNode* child = aNode->getFirstChild(); child; child = child->getNextSibling() ) {
+                if( child->getNodeType() == DOMNode::ELEMENT_NODE ) {
+                    addElement( child );
+                }
+                else if( ( child->getNodeType() == DOMNode::TEXT_NODE ||
+                           child->getNodeType() == DOMNode::CDATA_SECTION_NODE ) &&
+                         !XMLString::isAllWhiteSpace( child->getNodeValue() ) )
+                {
+                    mRecords.push_back( TEXT );
+                    mRecords.push_back( intern( child->getNodeValue() ) );
+                }
+            }
+            mRecords.push_back( END_ELEMENT );
+        }
+    };
+    
+    /*!
+     * \brief The contents of an image file, mapped into memory where possible.
+     */
+    class MappedImage {
+    public:
+        MappedImage():
+        mData( 0 ),
+        mSize( 0 )
+        {
+        }
+        
+        ~MappedImage() {
+#if GCAM_MMAP_IMAGE
+            if( mData ) {
+                munmap( mData, mSize );
+            }
+#endif
+        }
+        
+        //! Map or read aImageFile, returning whether it could be opened.
+        bool open( const string& aImageFile ) {
+#if GCAM_MMAP_IMAGE
+            const int fd = ::open( aImageFile.c_str(), O_RDONLY );
+            if( fd < 0 ) {
+                return false;
+            }
+            struct stat fileStat;
+            if( fstat( fd, &fileStat ) != 0 || fileStat.st_size == 0 ) {
+                ::close( fd );
+                return false;
+            }
+            void* map = mmap( 0, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close( fd );
+            if( map == MAP_FAILED ) {
+                return false;
+            }
+            mData = static_cast<char*>( map );
+            mSize = fileStat.st_size;
+#else
+            ifstream in( aImageFile.c_str(), ios::in | ios::binary );
+            if( !in.is_open() ) {
+                return false;
+            }
+            mBuffer.assign( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+            mData = mBuffer.empty() ? 0 : &mBuffer[ 0 ];
+            mSize = mBuffer.size();
+#endif
+            return mData != 0;
+        }
+        
+        //! The start of the image.
+        const char* getData() const {
+            return mData;
+        }
+        
+        //! The size of the image in bytes.
+        size_t getSize() const {
+            return mSize;
+        }
+        
+    private:
+        //! The image contents.
+        char* mData;
+        
+        //! The size of the image in bytes.
+        size_t mSize;
+        
+#if !GCAM_MMAP_IMAGE
+        //! Storage for the image when it can not be mapped.
+        vector<char> mBuffer;
+#endif
+    };
+    
+    //! An image kept in memory to be shared by the scenarios of a batch.
+    string gSharedImage;
+    
+    //! The start and size of the shared image, either gSharedImage or a
+    //! mapped shared memory segment.
+    const char* gSharedData = 0;
+    size_t gSharedSize = 0;
+    
+    //! Identifies a shared memory segment holding an input image.
+    const char SEGMENT_MAGIC[ 8 ] = "GCAMSHM";
+    
+    //! The states of a shared memory segment.
+    enum SegmentState {
+        SEGMENT_PENDING = 0,
+        SEGMENT_READY,
+        SEGMENT_FAILED
+    };
+    
+    //! The header at the start of a shared memory segment, followed by the
+    //! image.  A newly created segment is zero filled, and so pending.
+    struct SegmentHeader {
+        char mMagic[ 8 ];
+        atomic<uint32_t> mState;
+        uint32_t mPadding;
+        //! The size of the image in bytes, set before the segment is ready.
+        uint64_t mImageSize;
+    };
+    
+    //! The number of seconds to wait for another process to publish a
+    //! segment before reading the inputs in this process instead.
+    const int SEGMENT_WAIT_SECONDS = 1800;
+    
+#if GCAM_MMAP_IMAGE
+    //! The mapping of the shared memory segment holding the shared image.
+    void* gSegment = 0;
+    size_t gSegmentSize = 0;
+    
+    /*!
+     * \brief Use the image in a mapped segment as the shared image.
+     * \param aSegment The read-only mapping of the segment.
+     * \param aSize The size of the mapping.
+     */
+    void useSegment( void* aSegment, const size_t aSize ) {
+        string().swap( gSharedImage );
+        gSegment = aSegment;
+        gSegmentSize = aSize;
+        gSharedData = static_cast<const char*>( aSegment ) + sizeof( SegmentHeader );
+        gSharedSize = static_cast<const SegmentHeader*>( aSegment )->mImageSize;
+    }
+    
+    /*!
+     * \brief Wait for another process to publish the image in a segment and then
+     *        map it.
+     * \param aFD The segment opened read-only, which is closed.
+     * \return Whether the segment was mapped.
+     */
+    bool attachSegment( const int aFD ) {
+        const chrono::steady_clock::time_point giveUp =
+            chrono::steady_clock::now() + chrono::seconds( SEGMENT_WAIT_SECONDS );
+        bool mapped = false;
+        while( !mapped && chrono::steady_clock::now() < giveUp ) {
+            struct stat segmentStat;
+            if( fstat( aFD, &segmentStat ) != 0 ) {
+                break;
+            }
+            if( static_cast<size_t>( segmentStat.st_size ) >= sizeof( SegmentHeader ) ) {
+                void* map = mmap( 0, sizeof( SegmentHeader ), PROT_READ, MAP_SHARED, aFD, 0 );
+                if( map == MAP_FAILED ) {
+                    break;
+                }
+                const SegmentHeader* header = static_cast<const SegmentHeader*>( map );
+                const uint32_t state = header->mState.load( memory_order_acquire );
+                const size_t size = sizeof( SegmentHeader ) + header->mImageSize;
+                munmap( map, sizeof( SegmentHeader ) );
+                if( state == SEGMENT_FAILED ) {
+                    break;
+                }
+                if( state == SEGMENT_READY ) {
+                    map = mmap( 0, size, PROT_READ, MAP_SHARED, aFD, 0 );
+                    if( map == MAP_FAILED ||
+                        memcmp( static_cast<const SegmentHeader*>( map )->mMagic, SEGMENT_MAGIC,
+                                sizeof( SEGMENT_MAGIC ) ) != 0 )
+                    {
+                        if( map != MAP_FAILED ) {
+                            munmap( map, size );
+                        }
+                        break;
+                    }
+                    useSegment( map, size );
+                    mapped = true;
+                    continue;
+                }
+            }
+            this_thread::sleep_for( chrono::milliseconds( 100 ) );
+        }
+        ::close( aFD );
+        return mapped;
+    }
+#endif
+}
+
+/*!
+ * \brief Read XML files and save them to an input image.
+ * \param aXMLFiles The XML files in the order they are parsed into the Scenario.
+ * \param aValidate Whether to validate the files against their schema.
+ * \param aWriter The writer to add the files to.
+ * \return Whether all of the files were read.
+ */
+static bool readFiles( const vector<string>& aXMLFiles, const bool aValidate, ImageWriter& aWriter ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    for( const auto& fileName : aXMLFiles ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Compiling " << fileName << " into input image." << endl;
+        DOMDocument* document = XMLHelper<void>::readDocument( fileName, aValidate );
+        if( !document ) {
+            return false;
+        }
+        aWriter.addFile( fileName, document );
+        document->release();
+    }
+    return true;
+}
+
+/*!
+ * \brief Read XML files and save them to an input image.
+ * \param aImageFile The name of the image file to write.
+ * \param aXMLFiles The XML files in the order they are parsed into the Scenario.
+ * \param aValidate Whether to validate the files against their schema.
+ * \return Whether all of the files were read and the image written.
+ */
+bool InputImage::compile( const string& aImageFile, const vector<string>& aXMLFiles,
+                          const bool aValidate )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    ImageWriter writer;
+    if( !readFiles( aXMLFiles, aValidate, writer ) ) {
+        return false;
+    }
+    
+    if( !writer.write( aImageFile ) ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not write input image " << aImageFile << endl;
+        return false;
+    }
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Wrote input image " << aImageFile << " with " << aXMLFiles.size() << " files." << endl;
+    return true;
+}
+
+/*!
+ * \brief Parse the leading input files which are saved in an image from the
+ *        image.
+ * \details The files are taken from the image for as long as the file names
+ *          match those given, in order, and the files have not changed since
+ *          the image was compiled.  A missing or incompatible image is not an
+ *          error, in which case no files are loaded from it.
+ * \param aImageFile The name of the image file.
+ * \param aXMLFiles The XML files in the order they are to be parsed.
+ * \param aModelElement Element to call XMLParse on for each piece.
+ * \param aContainerNames The names of elements directly below the root whose
+ *                        children should each be parsed separately.
+ * \param aNumLoaded [out] The number of the leading files in aXMLFiles which
+ *                   were parsed from the image.
+ * \return Whether the files loaded from the image were parsed successfully.
+ */
+bool InputImage::load( const string& aImageFile, const vector<string>& aXMLFiles,
+                       IParsable* aModelElement, const set<string>& aContainerNames,
+                       size_t& aNumLoaded )
+{
+    aNumLoaded = 0;
+    MappedImage image;
+    if( !image.open( aImageFile ) ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not use input image " << aImageFile << ", it is missing or from a different version." << endl;
+        return true;
+    }
+    return loadData( image.getData(), image.getSize(), aImageFile, aXMLFiles,
+                     aModelElement, aContainerNames, aNumLoaded );
+}
+
+/*!
+ * \brief Read XML files and keep them in an input image in memory.
+ * \details This is used to read the inputs shared by a batch of scenarios
+ *          only once. The image replaces any previous shared image and is
+ *          kept until releaseShared is called.
+ * \param aXMLFiles The XML files in the order they are parsed into the Scenario.
+ * \param aValidate Whether to validate the files against their schema.
+ * \return Whether all of the files were read.
+ */
+bool InputImage::compileShared( const vector<string>& aXMLFiles, const bool aValidate ) {
+    releaseShared();
+    ImageWriter writer;
+    if( !readFiles( aXMLFiles, aValidate, writer ) ) {
+        return false;
+    }
+    ostringstream out( ios::out | ios::binary );
+    if( !writer.write( out ) ) {
+        return false;
+    }
+    gSharedImage = out.str();
+    gSharedData = gSharedImage.data();
+    gSharedSize = gSharedImage.size();
+    return true;
+}
+
+/*!
+ * \brief Parse the leading input files which are saved in the shared image.
+ * \details This behaves as load does for an image file. If there is no
+ *          shared image no files are loaded.
+ * \param aXMLFiles The XML files in the order they are to be parsed.
+ * \param aModelElement Element to call XMLParse on for each piece.
+ * \param aContainerNames The names of elements directly below the root whose
+ *                        children should each be parsed separately.
+ * \param aNumLoaded [out] The number of the leading files in aXMLFiles which
+ *                   were parsed from the image.
+ * \return Whether the files loaded from the image were parsed successfully.
+ */
+bool InputImage::loadShared( const vector<string>& aXMLFiles, IParsable* aModelElement,
+                             const set<string>& aContainerNames, size_t& aNumLoaded )
+{
+    aNumLoaded = 0;
+    if( !gSharedData ) {
+        return true;
+    }
+    return loadData( gSharedData, gSharedSize, "shared input image", aXMLFiles,
+                     aModelElement, aContainerNames, aNumLoaded );
+}
+
+/*!
+ * \brief Share the input image of XML files with the other processes on the
+ *        node which read the same files.
+ * \details The image is attached from the shared memory segment for the
+ *          contents of the files, and the validation setting, if another
+ *          process has published it.  Otherwise this process reads the files
+ *          and publishes the segment for the others.  If shared memory can not
+ *          be used the image is compiled into memory as compileShared does.
+ *          The image replaces any previous shared image and is kept until
+ *          releaseShared is called, which unmaps but does not remove the
+ *          segment.
+ * \param aXMLFiles The XML files in the order they are parsed into the Scenario.
+ * \param aValidate Whether to validate the files against their schema.
+ * \return Whether the image is available.
+ */
+bool InputImage::attachNodeShared( const vector<string>& aXMLFiles, const bool aValidate ) {
+    releaseShared();
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if GCAM_MMAP_IMAGE
+    ResultCache hasher( "" );
+    ostringstream settings;
+    settings << __ObjECTS_VER__ << "_" << __REVISION_NUMBER__ << "_" << IMAGE_VERSION << "_" << aValidate;
+    hasher.addValue( settings.str() );
+    for( const auto& fileName : aXMLFiles ) {
+        hasher.addValue( fileName );
+        if( !hasher.addFile( fileName ) ) {
+            return compileShared( aXMLFiles, aValidate );
+        }
+    }
+    const string segmentName = "/gcam-inputs-" + hasher.getKey();
+
+    // Exactly one process succeeds in creating the segment, and is the one to
+    // publish the image.
+    int fd = shm_open( segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600 );
+    if( fd < 0 ) {
+        if( errno == EEXIST ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Attaching to the shared input image " << segmentName << "." << endl;
+            fd = shm_open( segmentName.c_str(), O_RDONLY, 0 );
+            if( fd >= 0 && attachSegment( fd ) ) {
+                return true;
+            }
+        }
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not attach to the shared input image " << segmentName
+                << ", the inputs will be read by this process." << endl;
+        return compileShared( aXMLFiles, aValidate );
+    }
+
+    // The segment is pending until the image has been copied into it.
+    bool published = false;
+    void* headerMap = ftruncate( fd, sizeof( SegmentHeader ) ) == 0 ?
+        mmap( 0, sizeof( SegmentHeader ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) : MAP_FAILED;
+    const bool compiled = compileShared( aXMLFiles, aValidate );
+    if( compiled && headerMap != MAP_FAILED ) {
+        const size_t size = sizeof( SegmentHeader ) + gSharedImage.size();
+        void* map = ftruncate( fd, size ) == 0 ?
+            mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) : MAP_FAILED;
+        if( map != MAP_FAILED ) {
+            SegmentHeader* header = static_cast<SegmentHeader*>( map );
+            memcpy( header->mMagic, SEGMENT_MAGIC, sizeof( SEGMENT_MAGIC ) );
+            header->mImageSize = gSharedImage.size();
+            memcpy( static_cast<char*>( map ) + sizeof( SegmentHeader ), gSharedImage.data(), gSharedImage.size() );
+            if( mprotect( map, size, PROT_READ ) == 0 ) {
+                // the mapping of the image is now read-only
+                static_cast<SegmentHeader*>( headerMap )->mState.store( SEGMENT_READY, memory_order_release );
+                useSegment( map, size );
+                published = true;
+            }
+            else {
+                munmap( map, size );
+            }
+        }
+    }
+    if( !published ) {
+        // Let any waiting processes know to read the inputs themselves.
+        if( headerMap != MAP_FAILED ) {
+            static_cast<SegmentHeader*>( headerMap )->mState.store( SEGMENT_FAILED, memory_order_release );
+        }
+        shm_unlink( segmentName.c_str() );
+    }
+    if( headerMap != MAP_FAILED ) {
+        munmap( headerMap, sizeof( SegmentHeader ) );
+    }
+    ::close( fd );
+    if( published ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Published the shared input image " << segmentName << "." << endl;
+    }
+    else if( compiled ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not publish the shared input image " << segmentName
+                << ", it is only used by this process." << endl;
+    }
+    return compiled;
+#else
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Input images can not be shared between processes on this platform." << endl;
+    return compileShared( aXMLFiles, aValidate );
+#endif
+}
+
+//! Whether an image is being shared in memory.
+bool InputImage::hasShared() {
+    return gSharedData != 0;
+}
+
+//! Free the shared image.
+void InputImage::releaseShared() {
+    string().swap( gSharedImage );
+#if GCAM_MMAP_IMAGE
+    if( gSegment ) {
+        munmap( gSegment, gSegmentSize );
+        gSegment = 0;
+        gSegmentSize = 0;
+    }
+#endif
+    gSharedData = 0;
+    gSharedSize = 0;
+}
+
+/*!
+ * \brief Parse the leading input files from an image in memory.
+ * \param aData The start of the image.
+ * \param aSize The size of the image.
+ * \param aImageName The name of the image to use in messages.
+ * \param aXMLFiles The XML files in the order they are to be parsed.
+ * \param aModelElement Element to call XMLParse on for each piece.
+ * \param aContainerNames The names of elements directly below the root whose
+ *                        children should each be parsed separately.
+ * \param aNumLoaded [out] The number of the leading files in aXMLFiles which
+ *                   were parsed from the image.
+ * \return Whether the files loaded from the image were parsed successfully.
+ */
+bool InputImage::loadData( const char* aData, const size_t aSize, const string& aImageName,
+                           const vector<string>& aXMLFiles, IParsable* aModelElement,
+                           const set<string>& aContainerNames, size_t& aNumLoaded )
+{
+    aNumLoaded = 0;
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const ImageHeader* header = 0;
+    if( aData && aSize >= sizeof( ImageHeader ) ) {
+        header = reinterpret_cast<const ImageHeader*>( aData );
+    }
+    if( !header || memcmp( header->mMagic, IMAGE_MAGIC, sizeof( header->mMagic ) ) != 0 ||
+        header->mVersion != IMAGE_VERSION ||
+        header->mFilesOffset + header->mNumFiles * sizeof( ImageFileEntry ) > header->mStringsOffset ||
+        header->mStringsOffset > header->mRecordsOffset ||
+        header->mRecordsOffset + header->mRecordsSize * sizeof( uint32_t ) > aSize )
+    {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not use input image " << aImageName << ", it is missing or from a different version." << endl;
+        return true;
+    }
+    
+    // Find the start of each string in the table.
+    vector<const XMLCh*> strings( header->mNumStrings );
+    vector<uint32_t> lengths( header->mNumStrings );
+    const char* curr = aData + header->mStringsOffset;
+    const char* stringsEnd = aData + header->mRecordsOffset;
+    for( uint64_t i = 0; i < header->mNumStrings; ++i ) {
+        uint32_t length;
+        if( curr + sizeof( length ) > stringsEnd ) {
+            break;
+        }
+        memcpy( &length, curr, sizeof( length ) );
+        const uint64_t size = ( sizeof( length ) + ( length + 1 ) * sizeof( XMLCh ) + sizeof( uint32_t ) - 1 )
+            / sizeof( uint32_t ) * sizeof( uint32_t );
+        if( curr + size > stringsEnd ) {
+            break;
+        }
+        lengths[ i ] = length;
+        strings[ i ] = reinterpret_cast<const XMLCh*>( curr + sizeof( length ) );
+        curr += size;
+    }
+    
+    const ImageFileEntry* files = reinterpret_cast<const ImageFileEntry*>( aData + header->mFilesOffset );
+    const uint32_t* records = reinterpret_cast<const uint32_t*>( aData + header->mRecordsOffset );
+    XMLChunkBuilder::AttributeList attrs;
+    for( ; aNumLoaded < header->mNumFiles && aNumLoaded < aXMLFiles.size(); ++aNumLoaded ) {
+        const ImageFileEntry& entry = files[ aNumLoaded ];
+        const string& fileName = aXMLFiles[ aNumLoaded ];
+        uint64_t fileSize;
+        int64_t fileModified;
+        if( entry.mName >= header->mNumStrings || !strings[ entry.mName ] ||
+            XMLHelper<string>::safeTranscode( strings[ entry.mName ] ) != fileName ||
+            !getFileStamp( fileName, fileSize, fileModified ) ||
+            fileSize != entry.mFileSize || fileModified != entry.mFileModified )
+        {
+            break;
+        }
+        if( entry.mRecordsBegin > entry.mRecordsEnd || entry.mRecordsEnd > header->mRecordsSize ) {
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Input image " << aImageName << " is corrupt." << endl;
+            return false;
+        }
+        
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Loading " << fileName << " from input image." << endl;
+        XMLChunkBuilder builder( fileName, aModelElement, aContainerNames );
+        const uint32_t* rec = records + entry.mRecordsBegin;
+        const uint32_t* recEnd = records + entry.mRecordsEnd;
+        // Read the string index from the next record, flagging if the image
+        // is corrupt.
+        bool isValid = true;
+        auto nextString = [&]() -> const XMLCh* {
+            if( rec >= recEnd || *rec >= header->mNumStrings || !strings[ *rec ] ) {
+                isValid = false;
+                return 0;
+            }
+            return strings[ *rec++ ];
+        };
+        int depth = 0;
+        while( isValid && rec < recEnd ) {
+            const uint32_t type = *rec++;
+            if( type == START_ELEMENT ) {
+                const XMLCh* name = nextString();
+                const uint32_t numAttrs = rec < recEnd ? *rec++ : 0;
+                attrs.clear();
+                for( uint32_t i = 0; isValid && i < numAttrs; ++i ) {
+                    const XMLCh* attrName = nextString();
+                    const XMLCh* attrValue = nextString();
+                    attrs.push_back( make_pair( attrName, attrValue ) );
+                }
+                if( isValid ) {
+                    builder.startElement( name, attrs );
+                    ++depth;
+                }
+            }
+            else if( type == TEXT && rec < recEnd && *rec < header->mNumStrings && depth > 0 ) {
+                const uint32_t index = *rec;
+                const XMLCh* text = nextString();
+                if( isValid ) {
+                    builder.characters( text, lengths[ index ] );
+                }
+            }
+            else if( type == END_ELEMENT && depth > 0 ) {
+                builder.endElement();
+                --depth;
+            }
+            else {
+                isValid = false;
+            }
+        }
+        if( !isValid || depth != 0 ) {
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Input image " << aImageName << " is corrupt." << endl;
+            return false;
+        }
+        if( !builder.getSuccess() ) {
+            return false;
+        }
+    }
+    
+    if( aNumLoaded < aXMLFiles.size() && aNumLoaded < header->mNumFiles ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Input image " << aImageName << " does not match " << aXMLFiles[ aNumLoaded ]
+                << ", it and the files after it will be parsed as XML." << endl;
+    }
+    return true;
+}
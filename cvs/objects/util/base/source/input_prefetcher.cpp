@@ -0,0 +1,151 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file input_prefetcher.cpp
+ * \ingroup util
+ * \brief InputPrefetcher class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include "util/base/include/input_prefetcher.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/xml_memory_manager.h"
+
+using namespace std;
+using namespace xercesc;
+
+//! Constructor.
+InputPrefetcher::InputPrefetcher():
+mIsPlatformHeld( false )
+{
+}
+
+//! Destructor which waits for any reading to finish and releases the documents.
+InputPrefetcher::~InputPrefetcher() {
+    try {
+        wait();
+    } catch( ... ) {
+        // The reading failed and there is nothing left to report it to.
+    }
+    release();
+}
+
+/*!
+ * \brief Start reading a set of files on the background thread.
+ * \details This waits for any files which were started before and releases
+ *          their documents which were not taken.  The XML platform is
+ *          initialized here, on the calling thread, since it may not be
+ *          initialized or terminated concurrently with anything else.
+ * \param aXMLFiles The files to read.
+ * \param aValidate Whether to validate each file.
+ */
+void InputPrefetcher::start( const vector<string>& aXMLFiles,
+                             const vector<bool>& aValidate )
+{
+    wait();
+    release();
+    if( aXMLFiles.empty() ) {
+        return;
+    }
+
+    XMLPlatformUtils::Initialize( XMLUni::fgXercescDefaultLocale, 0, 0,
+                                  &XMLMemoryManager::getInstance() );
+    mIsPlatformHeld = true;
+    vector<Document>& documents = getDocuments();
+    documents.resize( aXMLFiles.size() );
+    for( size_t i = 0; i < aXMLFiles.size(); ++i ) {
+        documents[ i ].mXMLFile = aXMLFiles[ i ];
+        documents[ i ].mValidate = aValidate[ i ];
+        documents[ i ].mDocument = 0;
+    }
+    // The documents are not used until wait is called so the task may fill
+    // them in without any locking.
+    mQueue.push( [&documents]() {
+        for( size_t i = 0; i < documents.size(); ++i ) {
+            documents[ i ].mDocument = XMLHelper<void>::readDocument( documents[ i ].mXMLFile,
+                                                                      documents[ i ].mValidate );
+        }
+    } );
+}
+
+/*!
+ * \brief Wait for the files which have been started to be read.
+ * \details This must be called before any documents are taken.
+ */
+void InputPrefetcher::wait() {
+    mQueue.wait();
+}
+
+/*!
+ * \brief Take the document read ahead for a file.
+ * \param aXMLFile The file to be read.
+ * \param aValidate Whether the file should be validated.
+ * \return The document, which the caller must release, or null if the file was
+ *         not read ahead with the same validation setting.
+ */
+DOMDocument* InputPrefetcher::takeDocument( const string& aXMLFile, const bool aValidate ) {
+    vector<Document>& documents = getDocuments();
+    for( vector<Document>::iterator curr = documents.begin(); curr != documents.end(); ++curr ) {
+        if( curr->mDocument && curr->mXMLFile == aXMLFile && curr->mValidate == aValidate ) {
+            DOMDocument* document = curr->mDocument;
+            curr->mDocument = 0;
+            return document;
+        }
+    }
+    return 0;
+}
+
+//! Release the documents which were not taken and the XML platform.
+void InputPrefetcher::release() {
+    vector<Document>& documents = getDocuments();
+    for( vector<Document>::iterator curr = documents.begin(); curr != documents.end(); ++curr ) {
+        if( curr->mDocument ) {
+            curr->mDocument->release();
+        }
+    }
+    documents.clear();
+    if( mIsPlatformHeld ) {
+        XMLPlatformUtils::Terminate();
+        mIsPlatformHeld = false;
+    }
+}
+
+//! Get the documents which have been read ahead.
+vector<InputPrefetcher::Document>& InputPrefetcher::getDocuments() {
+    static vector<Document> documents;
+    return documents;
+}
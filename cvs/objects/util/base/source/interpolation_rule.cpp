@@ -66,6 +66,8 @@ InterpolationRule::InterpolationRule()
     mWarnWhenOverwritting = false;
     mIsFixedFunction = false;
     mInterpolationFunction = 0;
+    mFromPeriod = -1;
+    mToPeriod = -1;
 }
 
 InterpolationRule::~InterpolationRule() {
@@ -87,6 +89,8 @@ void InterpolationRule::copy( const InterpolationRule& aOther ) {
     mOverwritePolicy = aOther.mOverwritePolicy;
     mWarnWhenOverwritting = aOther.mWarnWhenOverwritting;
     mIsFixedFunction = aOther.mIsFixedFunction;
+    mFromPeriod = aOther.mFromPeriod;
+    mToPeriod = aOther.mToPeriod;
     
     delete mInterpolationFunction;
     mInterpolationFunction = aOther.mInterpolationFunction ? aOther.mInterpolationFunction->clone() : 0;
@@ -220,21 +224,14 @@ void InterpolationRule::toDebugXML( const int aPeriod, std::ostream& aOut, Tabs*
 }
 
 /*!
- * \brief Perform any potential interpolations according to the parsed rules.
- * \details Apply interpolations for any years that are with in the ranged
- *          defined by this rule by calling the interpolation function contained
- *          in this rule.  The overwrite policy will determine the behavoir when
- *          trying to interpolate a value which has already been set in
- *          aValuesToInterpolate.  If the overwrite policy is set to INTERPOLATED
- *          then aParsedValues will be utilized to determine how a value was set.
- * \param aValuesToInterpolate The period vector which contains values which may
- *                             need to be interpolated.
- * \param aParsedValues The period vector which contains the original values which
- *                      were parsed.
+ * \brief Resolve the years this rule applies to into model periods.
+ * \details The from-year and to-year only depend on the model time so the
+ *          periods which bracket the interpolation are found, and the parsed
+ *          rule checked, once after parsing rather than each time the rule is
+ *          applied.  Checks which depend on the values being interpolated are
+ *          left to applyInterpolations.
  */
-void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInterpolate,
-                                             const PeriodVector<Value>& aParsedValues ) const
-{
+void InterpolationRule::completeInit() {
     // perform error checking before attempting interpolations
     if( !mInterpolationFunction ) {
         // abort no interpolation function set
@@ -256,15 +253,6 @@ void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInter
         // the left bracket is a model year so the fromPer can be converted
         // directly
         fromPer = modeltime->getyr_to_per( mFromYear );
-        if( !mFromValue.isInited() && !aValuesToInterpolate[ fromPer ].isInited() ) {
-            // if we were to get the from-value from the given period vector
-            // then it should have been set already
-            // abort from-value has not been set
-            ILogger& mainLog = ILogger::getLogger( "main_log" );
-            mainLog.setLevel( ILogger::ERROR );
-            mainLog << "Could not find a value to interpolate from." << endl;
-            exit( 1 );
-        }
     }
     else {
         if( !mFromValue.isInited() ) {
@@ -297,16 +285,6 @@ void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInter
         // the right bracket is a model year so the toPer can be converted
         // directly
         toPer = modeltime->getyr_to_per( mToYear );
-
-        if( !mIsFixedFunction && !mToValue.isInited() && !aValuesToInterpolate[ toPer ].isInited() ) {
-            // if we were to get the to-value from the given period vector
-            // then it should have been set already
-            // abort to-value has not been set
-            ILogger& mainLog = ILogger::getLogger( "main_log" );
-            mainLog.setLevel( ILogger::ERROR );
-            mainLog << "Could not find a value to interpolate to." << endl;
-            exit( 1 );
-        }
     }
     else {
         if( !mToValue.isInited() && !mIsFixedFunction ) {
@@ -334,6 +312,56 @@ void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInter
         ++toPer;
     }
 
+    mFromPeriod = fromPer;
+    mToPeriod = toPer;
+}
+
+/*!
+ * \brief Perform any potential interpolations according to the parsed rules.
+ * \details Apply interpolations for any years that are with in the ranged
+ *          defined by this rule by calling the interpolation function contained
+ *          in this rule.  The overwrite policy will determine the behavoir when
+ *          trying to interpolate a value which has already been set in
+ *          aValuesToInterpolate.  If the overwrite policy is set to INTERPOLATED
+ *          then aParsedValues will be utilized to determine how a value was set.
+ * \pre completeInit has been called.
+ * \param aValuesToInterpolate The period vector which contains values which may
+ *                             need to be interpolated.
+ * \param aParsedValues The period vector which contains the original values which
+ *                      were parsed.
+ */
+void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInterpolate,
+                                             const PeriodVector<Value>& aParsedValues ) const
+{
+    /*! \pre The periods have been resolved by completeInit. */
+    assert( mToPeriod != -1 );
+
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int fromPer = mFromPeriod;
+    int toPer = mToPeriod;
+    if( modeltime->isModelYear( mFromYear ) && !mFromValue.isInited()
+        && !aValuesToInterpolate[ fromPer ].isInited() )
+    {
+        // if we were to get the from-value from the given period vector
+        // then it should have been set already
+        // abort from-value has not been set
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not find a value to interpolate from." << endl;
+        exit( 1 );
+    }
+    if( modeltime->isModelYear( mToYear ) && !mIsFixedFunction && !mToValue.isInited()
+        && !aValuesToInterpolate[ toPer ].isInited() )
+    {
+        // if we were to get the to-value from the given period vector
+        // then it should have been set already
+        // abort to-value has not been set
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not find a value to interpolate to." << endl;
+        exit( 1 );
+    }
+
     // all error checking has occured so we can set the left and right brackets
     // and perform any interpolations
     XYDataPoint leftBracket( mFromYear, mFromValue.isInited() ? mFromValue : aValuesToInterpolate[ fromPer ] );
@@ -38,20 +38,62 @@
  * \author Pralit Patel
  */
 
+// Observing only the threads of our own task arena is a preview feature in some
+// versions of TBB.
+#define TBB_PREVIEW_LOCAL_OBSERVER 1
+
+#include <cstdio>
 #include <cstring>
+#include <cstdint>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <iterator>
+#include <unordered_set>
+#include <thread>
+#include <boost/functional/hash.hpp>
 
 #include "util/base/include/manage_state_variables.hpp"
 #include "util/base/include/value.h"
+#include "util/base/include/state_snapshot.h"
 #include "containers/include/scenario.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/market_container.h"
+#include "marketplace/include/market.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/tracepoints.h"
 #include "util/base/include/gcam_fusion.hpp"
 #include "util/base/include/gcam_data_containers.h"
 
 #if GCAM_PARALLEL_ENABLED
-#include <tbb/concurrent_queue.h>
 #include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#endif
+
+#if STATE_AUDIT
+#include <atomic>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <typeinfo>
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GCAM_MMAP_RESTART 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define GCAM_MMAP_RESTART 0
 #endif
 
 using namespace std;
@@ -61,65 +103,287 @@ extern Scenario* scenario;
 // Note we must static initialize static class member variables in a cpp file and
 // since Value is header only and these particular fields are just as related to
 // ManageStateVariables it seems appropriate to initialize them to NULL here.
-Value::CentralValueType Value::sCentralValue( (double*)0 );
+double* Value::sCentralValue( 0 );
 double* Value::sBaseCentralValue( 0 );
-
 #if GCAM_PARALLEL_ENABLED
-#define NUM_STATES tbb::task_scheduler_init::default_num_threads()+1
-#else
-#define NUM_STATES 2
-#endif
+ManageStateVariables* Value::sThreadStateSource( 0 );
+unsigned int Value::sCentralValueVersion( 1 );
+thread_local double* Value::tCentralValue( 0 );
+thread_local unsigned int Value::tCentralValueVersion( 0 );
 
-#if GCAM_PARALLEL_ENABLED
 /*!
- * \brief A helper functor to assign a state slot in ManageStateVariables::mStateData
- *        to each worker thread in ManageStateVariables::mThreadPool.  This functor
- *        will get called the first time a new thread accesses the thread local
- *        storage Value::sCentralValue that provides access to mStateData by thread
- *        from with in the Value class.
+ * \brief Refresh the state the calling thread uses after the central state has
+ *        changed.
+ * \details This gets called the first time a thread reads or writes state after
+ *          ManageStateVariables::setPartialDeriv.  If partial derivatives are
+ *          being calculated the thread gets a unique slot of "scratch" state
+ *          otherwise it uses sCentralValue.
+ * \return The state the calling thread should use.
  */
-struct AssignThreadStateFun {
-    //! A reference to ManageStateVariables::mStateData.
-    double** mArr;
+double* Value::assignCentralValue() {
+    tCentralValue = sThreadStateSource ? sThreadStateSource->assignThreadState() : sCentralValue;
+    tCentralValueVersion = sCentralValueVersion;
+    return tCentralValue;
+}
+#endif
+
+#if STATE_AUDIT
+namespace {
+    //! The labels of the Data found by the audit, as container type and Data
+    //! name, along with whether the Data is flagged STATE.
+    vector<pair<string, bool> > gAuditLabels;
+    
+    //! The index into gAuditLabels of each label.
+    map<pair<string, bool>, size_t> gAuditLabelIndex;
+    
+    //! The Values of each Data found by the audit by the address of the first
+    //! one, to the address past the last one and the index of its label.
+    map<const Value*, pair<const Value*, size_t> > gAuditRanges;
+    
+    //! For each active state value the index of its label, or -1 if unknown.
+    vector<int> gAuditStateLabels;
+    
+    //! For each active state value its value in the "base" state when the
+    //! period started.
+    vector<double> gAuditInitialState;
+    
+    //! For each active state value whether it has been written in the period.
+    unique_ptr<atomic<unsigned char>[]> gAuditWritten;
+    
+    //! Whether partial derivatives are currently being calculated.
+    atomic<bool> gAuditIsPartialDeriv( false );
     
-    //! The maximum number of states that have been allocated in mStateData.
-    const int mMaxStates;
+    //! Guards gAuditPartialDerivWrites.
+    mutex gAuditMutex;
     
-    //! A thread safe queue that will have as values each index into mStateData
-    //! and as each new thread consumes it's next value implies that thread gets
-    //! assigned that state slot.
-    tbb::concurrent_queue<int> mThreadStateIndex;
+    //! The number of writes to each Value which is not active state while
+    //! partial derivatives were calculated in the period.
+    map<const Value*, size_t> gAuditPartialDerivWrites;
     
-    //! Constructor
-    AssignThreadStateFun( double** aArr, const int aMaxStates ):mArr( aArr ), mMaxStates( aMaxStates ) {
-        // initialize the state index slots starting from 1 as 0 is always the
-        // "base" state.
-        for( int i = 1; i < mMaxStates; ++i ) {
-            mThreadStateIndex.push( i );
+    //! The totals for a label over all periods.
+    struct AuditTotals {
+        //! The number of active state values.
+        size_t mCollected = 0;
+        //! The number of active state values which were written.
+        size_t mWritten = 0;
+        //! The number of active state values which ended the period changed.
+        size_t mChanged = 0;
+        //! The number of writes while partial derivatives were calculated to
+        //! Values which were not active state.
+        size_t mPartialDerivWrites = 0;
+    };
+    
+    //! The totals by label index.
+    map<size_t, AuditTotals> gAuditTotals;
+    
+    //! Find the index of the label of the Data holding a Value, or -1.
+    int findAuditLabel( const Value* aValue ) {
+        auto iter = gAuditRanges.upper_bound( aValue );
+        if( iter == gAuditRanges.begin() ) {
+            return -1;
         }
+        --iter;
+        return aValue < iter->second.first ? static_cast<int>( iter->second.second ) : -1;
     }
     
     /*!
-     * \brief The functor that gets called when a new thread accesses the thread local
-     *        storage Value::sCentralValue for the first time.  It will assign a unique
-     *        slot into ManageStateVariables::sCentralValue for this thread to use
-     *        for the duration of it's calculations.
-     * \return The unique slot of state that this thread can be guaranteed to use
-     *         free from interference from any other thread.
+     * \brief A GCAMFusion callback which records the Values of every Data of
+     *        each container searched, along with a label for them.
      */
-    double* operator()() {
-        int nextState;
-        bool gotState = mThreadStateIndex.try_pop( nextState );
-        if( !gotState ) {
-            ILogger& mainLog = ILogger::getLogger( "main_log" );
-            mainLog.setLevel( ILogger::SEVERE );
-            mainLog << "Failed to get an unused state to assign to a worker thread." << endl;
-            abort();
+    struct AuditLabeler {
+        //! The type of the container whose Data is being recorded.
+        string mContainerType;
+        
+        //! Whether the Data being recorded is flagged STATE.
+        bool mIsState = false;
+        
+        void addValues( const Value* aBegin, const size_t aSize, const char* aDataName ) {
+            if( aSize == 0 ) {
+                return;
+            }
+            const pair<string, bool> label( mContainerType + "/" + aDataName, mIsState );
+            auto labelIter = gAuditLabelIndex.find( label );
+            if( labelIter == gAuditLabelIndex.end() ) {
+                labelIter = gAuditLabelIndex.insert( make_pair( label, gAuditLabels.size() ) ).first;
+                gAuditLabels.push_back( label );
+            }
+            gAuditRanges[ aBegin ] = make_pair( aBegin + aSize, labelIter->second );
         }
         
-        return mArr[ nextState ];
+        template<typename DataType>
+        void addData( DataType& aData, const char* aDataName ) {
+            // not a Value
+        }
+        void addData( Value& aData, const char* aDataName ) {
+            addValues( &aData, 1, aDataName );
+        }
+        void addData( objects::PeriodVector<Value>& aData, const char* aDataName ) {
+            addValues( &*aData.begin(), aData.size(), aDataName );
+        }
+        void addData( objects::TechVintageVector<Value>& aData, const char* aDataName ) {
+            // the vector is not allocated until its technology is initialized
+            if( static_cast<int>( aData.getStartPeriod() ) >= 0 ) {
+                addValues( &*aData.begin(), aData.size(), aDataName );
+            }
+        }
+        void addData( objects::YearVector<Value>& aData, const char* aDataName ) {
+            addValues( &*aData.begin(), aData.size(), aDataName );
+        }
+        void addData( vector<Value>& aData, const char* aDataName ) {
+            addValues( aData.empty() ? 0 : &aData[ 0 ], aData.size(), aDataName );
+        }
+        
+        template<typename DataVectorType>
+        void processDataVector( DataVectorType aDataVector ) {
+            boost::fusion::for_each( aDataVector, [this] ( auto& aData ) {
+                this->mIsState = aData.hasDataFlag( DataFlags::STATE );
+                this->addData( aData.mData, aData.mDataName );
+            } );
+        }
+        
+        // Templated callbacks for GCAMFusion
+        template<typename DataType>
+        void processData( DataType& aData ) {
+        }
+        template<typename DataType>
+        void pushFilterStep( const DataType& aContainer ) {
+            if( !aContainer ) {
+                return;
+            }
+            using ContainerType = typename boost::remove_pointer<DataType>::type;
+            const char* typeName = typeid( *aContainer ).name();
+#if defined(__GNUC__)
+            int status = 0;
+            char* demangled = abi::__cxa_demangle( typeName, 0, 0, &status );
+            mContainerType = status == 0 && demangled ? demangled : typeName;
+            free( demangled );
+#else
+            mContainerType = typeName;
+#endif
+            ExpandDataVector<typename ContainerType::SubClassFamilyVector> getDataVector;
+            aContainer->doDataExpansion( getDataVector );
+            getDataVector.getFullDataVector( *this );
+        }
+        template<typename DataType>
+        void popFilterStep( const DataType& aContainer ) {
+        }
+    };
+}
+#endif
+
+vector<ManageStateVariables::StateIndexEntry> ManageStateVariables::sStateIndex;
+const Scenario* ManageStateVariables::sStateIndexScenario = 0;
+bool ManageStateVariables::sResume = false;
+
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief A task scheduler observer which pins each worker thread which enters
+ *        ManageStateVariables::mThreadPool to a CPU.
+ * \details Together with allocating each "scratch" state from the thread which
+ *          uses it this keeps a worker and its state on the same NUMA node for
+ *          the duration of the period.  The CPUs are those the process is allowed
+ *          to run on, handed out in order starting from the second so the main
+ *          thread, which is not pinned, is not doubled up with the first worker.
+ *          Pinning is only supported on Linux.
+ */
+class ManageStateVariables::ThreadPinner : public tbb::task_scheduler_observer {
+public:
+    ThreadPinner( tbb::task_arena& aArena ):tbb::task_scheduler_observer( aArena ), mNextCPU( 1 ) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO( &allowed );
+        if( sched_getaffinity( 0, sizeof( allowed ), &allowed ) == 0 ) {
+            for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+                if( CPU_ISSET( cpu, &allowed ) ) {
+                    mCPUs.push_back( cpu );
+                }
+            }
+        }
+#endif
+        if( mCPUs.empty() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Pinning threads is not supported on this platform, parallel-pin-threads will be ignored." << endl;
+        }
+        else {
+            observe( true );
+        }
     }
+    
+    virtual ~ThreadPinner() {
+        observe( false );
+    }
+    
+    virtual void on_scheduler_entry( bool aIsWorker ) {
+#if defined(__linux__)
+        // A worker may enter the arena many times but only needs to be pinned once.
+        static thread_local bool isPinned = false;
+        if( !aIsWorker || isPinned ) {
+            return;
+        }
+        cpu_set_t cpuSet;
+        CPU_ZERO( &cpuSet );
+        CPU_SET( mCPUs[ mNextCPU++ % mCPUs.size() ], &cpuSet );
+        isPinned = pthread_setaffinity_np( pthread_self(), sizeof( cpuSet ), &cpuSet ) == 0;
+#endif
+    }
+    
+private:
+    //! The CPUs the process is allowed to run on.
+    vector<int> mCPUs;
+    
+    //! The index into mCPUs to pin the next worker to.
+    atomic<size_t> mNextCPU;
 };
+
+/*!
+ * \brief The number of threads to allocate in mThreadPool.
+ * \details This is the configuration parallel-num-threads if set or otherwise
+ *          the number of threads TBB would use by default on this machine.
+ * \return The size of the thread pool.
+ */
+int ManageStateVariables::getThreadPoolSize() {
+    const int numThreads = Configuration::getInstance()->getInt( "parallel-num-threads", 0, false );
+    return numThreads > 0 ? numThreads : tbb::task_scheduler_init::default_num_threads();
+}
+
+/*!
+ * \brief Assign a "scratch" state to the calling thread for the current partial
+ *        derivative.
+ * \details A thread is given back the state it used last if it is still free so
+ *          that it keeps working with memory it allocated, and so is local to it,
+ *          otherwise it prefers one no other thread has used.  A state which has
+ *          not been used yet is allocated now by the thread which will use it.
+ * \return The unique slot of state that this thread can be guaranteed to use
+ *         free from interference from any other thread.
+ */
+double* ManageStateVariables::assignThreadState() {
+    int& threadState = mThreadState.local();
+    int stateIndex = -1;
+    if( threadState > 0 && mIsAssigned[ threadState ].exchange( 1 ) == 0 ) {
+        stateIndex = threadState;
+    }
+    for( int pass = 0; pass < 2 && stateIndex == -1; ++pass ) {
+        for( int stateInd = 1; stateInd < mNumStates && stateIndex == -1; ++stateInd ) {
+            if( ( pass == 1 || mHasOwner[ stateInd ] == 0 ) && mIsAssigned[ stateInd ].exchange( 1 ) == 0 ) {
+                stateIndex = stateInd;
+            }
+        }
+    }
+    if( stateIndex == -1 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Failed to get an unused state to assign to a worker thread." << endl;
+        abort();
+    }
+    
+    threadState = stateIndex;
+    mHasOwner[ stateIndex ] = 1;
+    if( !mStateData[ stateIndex ] ) {
+        allocateState( stateIndex );
+    }
+    return mStateData[ stateIndex ];
+}
 #endif
 
 /*!
@@ -130,17 +394,39 @@ struct AssignThreadStateFun {
  */
 ManageStateVariables::ManageStateVariables( const int aPeriod ):
 #if !GCAM_PARALLEL_ENABLED
-mStateData( new double*[ NUM_STATES ] ),
+mNumStates( 2 ),
 #else
-mThreadPool(),
-mStateData( new double*[ NUM_STATES ] ),
+mThreadPool( getThreadPoolSize() ),
+mNumStates( getThreadPoolSize() + 1 ),
 #endif
+mStateData( new double*[ mNumStates ]() ),
 mPeriodToCollect( aPeriod ),
 mYearToCollect( scenario->getModeltime()->getper_to_yr( aPeriod ) ),
 mCCStartYear( mYearToCollect - scenario->getModeltime()->gettimestep( aPeriod ) + 1 ),
-mNumCollected( 0 )
+mNumCollected( 0 ),
+mNumMarkets( 0 ),
+mNumPages( 0 ),
+mHeaderSize( 0 ),
+mIsSynced( mNumStates, 0 ),
+mMappedRestart( 0 ),
+mMappedRestartSize( 0 ),
+mIsRestarted( false )
+#if GCAM_PARALLEL_ENABLED
+,
+mThreadState( 0 ),
+mIsAssigned( mNumStates ),
+mHasOwner( mNumStates )
+#endif
 {
+#if GCAM_PARALLEL_ENABLED
+    if( Configuration::getInstance()->getBool( "parallel-pin-threads", false, false ) ) {
+        mThreadPinner.reset( new ThreadPinner( mThreadPool ) );
+    }
+#endif
     collectState();
+#if STATE_AUDIT
+    startStateAudit();
+#endif
 }
 
 /*!
@@ -149,14 +435,21 @@ mNumCollected( 0 )
  */
 ManageStateVariables::~ManageStateVariables() {
     resetState();
-    for( size_t stateInd = 0; stateInd < NUM_STATES; ++stateInd ) {
-        delete[] mStateData[ stateInd ];
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        if( stateInd == 0 && mMappedRestart ) {
+#if GCAM_MMAP_RESTART
+            munmap( mMappedRestart, mMappedRestartSize );
+#endif
+        }
+        else if( mStateData[ stateInd ] ) {
+            delete[] ( mStateData[ stateInd ] - mHeaderSize );
+        }
     }
     delete[] mStateData;
-#if !GCAM_PARALLEL_ENABLED
     Value::sCentralValue = 0;
-#else
-    Value::sCentralValue.clear();
+#if GCAM_PARALLEL_ENABLED
+    Value::sThreadStateSource = 0;
+    ++Value::sCentralValueVersion;
 #endif
     Value::sBaseCentralValue = 0;
 }
@@ -167,31 +460,46 @@ ManageStateVariables::~ManageStateVariables() {
  *        actual value set in the individual Value objects before being collected.
  */
 void ManageStateVariables::collectState() {
-    // Set up the GCAM Fusion steps as well as the callback struct that will handle
-    // the results from the search.
-    DoCollect doCollectProc;
-    doCollectProc.mParentClass = this;
-    // Note an empty string for the data name indicates match any name.  The first
-    // step that does not match any name nor value indicates a "descendant" step
-    // allowing for GCAM fusion to search at any depth to find Data of any name
-    // but with the STATE flag set.
-    vector<FilterStep*> collectStateSteps( 2, 0 );
-    collectStateSteps[ 0 ] = new FilterStep( "" );
-    collectStateSteps[ 1 ] = new FilterStep( "", DataFlags::STATE );
-    // DoCollect will handle all fusion callbacks thus their template boolean parameter
-    // are set to true.
-    GCAMFusion<DoCollect, true, true, true> gatherState( doCollectProc, collectStateSteps );
-    gatherState.startFilter( scenario );
+    // Searching the entire scenario is relatively expensive so if configured we
+    // keep the index of the Data flagged STATE from the last period and only
+    // search again the Technologies which have started operating since.
+    const bool useCache = Configuration::getInstance()->getBool( "cache-state-search", false, false );
+    if( !useCache || sStateIndexScenario != scenario || sStateIndex.empty() ) {
+        buildStateIndex();
+    }
+    else {
+        updateStateIndex();
+    }
+    
+    for( const auto& entry : sStateIndex ) {
+        addIndexedState( entry );
+    }
+    if( !useCache ) {
+        clearStateIndex();
+    }
+    
+    // Move the market prices, demands, and supplies to the front of the state.
+    layoutMarketState();
     
-    // DoCollect has now gathered all active state into the mStateValues list to
+    // We have now gathered all active state into the mStateValues list to
     // allow faster/easier processing for the remaining tasks at hand.
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::DEBUG );
     mainLog << "Number of active state values: " << mNumCollected << endl;
-    // Allocate space for each active state value for each state slot.
-    for( size_t stateInd = 0; stateInd < NUM_STATES; ++stateInd ) {
-        mStateData[ stateInd ] = new double[ mNumCollected ];
+    // Allocate space for each active state value for each state slot preceded
+    // by the flags used to track which pages of it have been changed.
+    const size_t pageSize = size_t( 1 ) << Value::STATE_PAGE_SHIFT;
+    mNumPages = ( mNumCollected + pageSize - 1 ) / pageSize;
+    mHeaderSize = ( mNumPages + sizeof( double ) - 1 ) / sizeof( double );
+#if !GCAM_PARALLEL_ENABLED
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        allocateState( stateInd );
     }
+#else
+    // Only the "base" state is allocated here, the "scratch" states are allocated
+    // by the first thread to use them in assignThreadState.
+    allocateState( 0 );
+#endif
     
     // We can now initialize the static Value references into mStateData for fast
     // access from within each Value object.
@@ -219,9 +527,35 @@ void ManageStateVariables::collectState() {
         newRestartPeriod = -1;
     }
     
+    // when resuming carry on from the last checkpoint if it is further along
+    const int resumePeriod = getResumePeriod();
+    if( resumePeriod > newRestartPeriod ) {
+        newRestartPeriod = resumePeriod;
+    }
+    
     if( newRestartPeriod != -1 && mPeriodToCollect < newRestartPeriod ) {
         loadRestartFile();
     }
+}
+
+/*!
+ * \brief Search for all Data flagged STATE within a container.
+ * \param aContainer The container to search.
+ * \param aDoCollect The callback struct which records the Data found.
+ */
+template<typename ContainerType>
+void ManageStateVariables::searchState( ContainerType* aContainer, DoCollect& aDoCollect ) {
+    // Note an empty string for the data name indicates match any name.  The first
+    // step that does not match any name nor value indicates a "descendant" step
+    // allowing for GCAM fusion to search at any depth to find Data of any name
+    // but with the STATE flag set.
+    vector<FilterStep*> collectStateSteps( 2, 0 );
+    collectStateSteps[ 0 ] = new FilterStep( "" );
+    collectStateSteps[ 1 ] = new FilterStep( "", DataFlags::STATE );
+    // DoCollect will handle all fusion callbacks thus their template boolean parameter
+    // are set to true.
+    GCAMFusion<DoCollect, true, true, true> gatherState( aDoCollect, collectStateSteps );
+    gatherState.startFilter( aContainer );
     
     // clean up GCAMFusion related memory
     for( auto filterStep : collectStateSteps ) {
@@ -229,6 +563,136 @@ void ManageStateVariables::collectState() {
     }
 }
 
+/*!
+ * \brief Search the entire scenario to build sStateIndex from scratch.
+ */
+void ManageStateVariables::buildStateIndex() {
+    sStateIndex.clear();
+    DoCollect doCollectProc;
+    doCollectProc.mIndex = &sStateIndex;
+    searchState( scenario, doCollectProc );
+    
+    // Technologies which are not operating yet may still create Data, for instance
+    // emissions copied forward from the previous vintage, by the time they do.
+    for( auto& entry : sStateIndex ) {
+        if( entry.mType == StateIndexEntry::TECHNOLOGY ) {
+            entry.mWasOperating = entry.mTechnology->isOperating( mPeriodToCollect );
+        }
+    }
+    sStateIndexScenario = scenario;
+}
+
+/*!
+ * \brief Update sStateIndex from the last period for this one.
+ * \details Each Technology which has started operating since it was last searched
+ *          is searched again and its entries replaced in place.  Keeping the
+ *          entries in the same order as a full search ensures the state is laid
+ *          out the same, and so restart files are interchangeable, whether or not
+ *          the index was kept.  The rest of the scenario is assumed not to gain
+ *          or lose Data flagged STATE between periods.
+ */
+void ManageStateVariables::updateStateIndex() {
+    vector<StateIndexEntry> updatedIndex;
+    updatedIndex.reserve( sStateIndex.size() );
+    for( auto entryIter = sStateIndex.begin(); entryIter != sStateIndex.end(); ) {
+        updatedIndex.push_back( *entryIter );
+        const StateIndexEntry& entry = *entryIter++;
+        if( entry.mType != StateIndexEntry::TECHNOLOGY || entry.mWasOperating ||
+            !entry.mTechnology->isOperating( mPeriodToCollect ) )
+        {
+            continue;
+        }
+        
+        // Replace the entries of this Technology with those found searching it again.
+        updatedIndex.back().mWasOperating = true;
+        while( entryIter != sStateIndex.end() && entryIter->mType != StateIndexEntry::TECHNOLOGY &&
+               entryIter->mTechnology == entry.mTechnology )
+        {
+            ++entryIter;
+        }
+        DoCollect doCollectProc;
+        doCollectProc.mIndex = &updatedIndex;
+        doCollectProc.mCurrTechnology = entry.mTechnology;
+        doCollectProc.mCurrMarket = entry.mMarket;
+        searchState( entry.mTechnology, doCollectProc );
+    }
+    sStateIndex.swap( updatedIndex );
+    
+#if DEBUG_STATE
+    // Check the index against a full search.
+    vector<StateIndexEntry> fullIndex;
+    DoCollect doCollectProc;
+    doCollectProc.mIndex = &fullIndex;
+    searchState( scenario, doCollectProc );
+    bool isSame = fullIndex.size() == sStateIndex.size();
+    for( size_t i = 0; isSame && i < fullIndex.size(); ++i ) {
+        isSame = fullIndex[ i ].mData == sStateIndex[ i ].mData;
+    }
+    if( !isSame ) {
+        cout << "Cached state index does not match a full search" << endl;
+        abort();
+    }
+#endif
+}
+
+/*!
+ * \brief Add the Values of an index entry which are active in mPeriodToCollect
+ *        to mStateValues.
+ * \param aEntry The index entry.
+ */
+void ManageStateVariables::addIndexedState( const StateIndexEntry& aEntry ) {
+    // Ignore any data set within a Technology that is not operating in the current
+    // model period or within a Market which is not for the current model year.
+    if( aEntry.mType == StateIndexEntry::TECHNOLOGY ||
+        ( aEntry.mTechnology && !aEntry.mTechnology->isOperating( mPeriodToCollect ) ) ||
+        ( aEntry.mMarket && aEntry.mMarket->getYear() != mYearToCollect ) )
+    {
+        return;
+    }
+    
+    switch( aEntry.mType ) {
+        case StateIndexEntry::SINGLE:
+            // Any SINGLE value that is tagged is considered active.
+            mStateValues.push_front( static_cast<Value*>( aEntry.mData ) );
+            ++mNumCollected;
+            break;
+        case StateIndexEntry::PERIOD_VECTOR:
+            // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
+            // considered active.
+            mStateValues.push_front( &( *static_cast<objects::PeriodVector<Value>*>( aEntry.mData ) )[ mPeriodToCollect ] );
+            ++mNumCollected;
+            break;
+        case StateIndexEntry::TECH_VINTAGE_VECTOR:
+            // Note, skipping Technologies which are not operating takes care of
+            // out of bounds here
+            mStateValues.push_front( &( *static_cast<objects::TechVintageVector<Value>*>( aEntry.mData ) )[ mPeriodToCollect ] );
+            ++mNumCollected;
+            break;
+        case StateIndexEntry::YEAR_VECTOR: {
+            // When a year vector is tagged we only need to worry about values in the current
+            // timestep (already calculated the years ahead of time in the interest of speed
+            // to be from [mCCStartYear, mYearToCollect])
+            objects::YearVector<Value>& data = *static_cast<objects::YearVector<Value>*>( aEntry.mData );
+            for( int year = std::max( mCCStartYear, data.getStartYear() ); year <= mYearToCollect; ++year ) {
+                mStateValues.push_front( &data[ year ] );
+                ++mNumCollected;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/*!
+ * \brief Release the index of Data flagged STATE kept between periods.
+ * \details This must be called when the Scenario it was built for is deleted.
+ */
+void ManageStateVariables::clearStateIndex() {
+    vector<StateIndexEntry>().swap( sStateIndex );
+    sStateIndexScenario = 0;
+}
+
 /*!
  * \brief Copy the "base" state back into each corresponding Value object before
  *        we move on from this model period and release the state memory.
@@ -238,6 +702,9 @@ void ManageStateVariables::resetState() {
         saveRestartFile();
     }
     
+#if STATE_AUDIT
+    finishStateAudit();
+#endif
 #if DEBUG_STATE
     unsigned int count = 0;
 #endif
@@ -254,19 +721,322 @@ void ManageStateVariables::resetState() {
     }
 }
 
+/*!
+ * \brief Arrange for the market state to be stored contiguously at the front of
+ *        each state slot.
+ * \details The order of mStateValues determines the index of each Value in
+ *          mStateData.  The market prices, demands, and supplies found by
+ *          GCAMFusion are scattered through the list in the order the markets are
+ *          visited.  Here we pull them out and put them at the front of the list
+ *          in blocks of price, demand, and supply each ordered by market serial
+ *          number so that the marketplace can process them with simple linear
+ *          sweeps rather than visiting each market.  If the serial numbers were
+ *          not assigned for this period, or any market state was not collected,
+ *          the original order is kept and mNumMarkets is left at zero.
+ * \note Restart files store the state in this order.
+ */
+void ManageStateVariables::layoutMarketState() {
+    const vector<MarketContainer*>& markets = scenario->getMarketplace()->mMarkets;
+    const size_t numMarkets = markets.size();
+    vector<Value*> marketValues( NUM_MARKET_STATES * numMarkets, 0 );
+    for( auto market : markets ) {
+        const int serialNumber = market->getSerialNumber() - 1;
+        if( serialNumber < 0 || serialNumber >= static_cast<int>( numMarkets ) ||
+            marketValues[ serialNumber ] )
+        {
+            return;
+        }
+        Market* currMarket = market->getMarket( mPeriodToCollect );
+        marketValues[ MARKET_PRICE * numMarkets + serialNumber ] = &currMarket->mPrice;
+        marketValues[ MARKET_DEMAND * numMarkets + serialNumber ] = &currMarket->mDemand;
+        marketValues[ MARKET_SUPPLY * numMarkets + serialNumber ] = &currMarket->mSupply;
+    }
+    
+    const unordered_set<Value*> isMarketValue( marketValues.begin(), marketValues.end() );
+    vector<Value*> orderedValues( marketValues );
+    orderedValues.reserve( mNumCollected );
+    for( auto currValue : mStateValues ) {
+        if( isMarketValue.find( currValue ) == isMarketValue.end() ) {
+            orderedValues.push_back( currValue );
+        }
+    }
+    if( orderedValues.size() != mNumCollected ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        mainLog << "Could not find all market state, market state will not be contiguous." << endl;
+        return;
+    }
+    
+    mStateValues.assign( orderedValues.begin(), orderedValues.end() );
+    mNumMarkets = numMarkets;
+}
+
+/*!
+ * \brief Get the given block of market state in the current state.
+ * \details The current state is whichever the Value objects are currently
+ *          reading and writing: the "base" state, or when calculating partial
+ *          derivatives the "scratch" space assigned to the calling thread.
+ * \param aType The block of market state to get.
+ * \return A pointer to the first of getNumMarkets() entries indexed by market
+ *         serial number less one.
+ * \pre hasMarketState( aPeriod ) is true for the period being calculated.
+ */
+double* ManageStateVariables::getMarketState( const MarketStateType aType ) const {
+    assert( mNumMarkets > 0 );
+    return getCurrentState() + aType * mNumMarkets;
+}
+
+/*!
+ * \brief Get the number of bytes used to hold the state.
+ * \details This includes the "base" state and any "scratch" states which
+ *          have been allocated, the list of Values they are collected from,
+ *          and the index of Data flagged STATE if it is being kept.
+ * \return The bytes used.
+ */
+size_t ManageStateVariables::getNumBytes() const {
+    size_t numBytes = mNumStates * sizeof( double* );
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        if( stateInd == 0 && mMappedRestart ) {
+            numBytes += mMappedRestartSize;
+        }
+        else if( mStateData[ stateInd ] ) {
+            numBytes += ( mHeaderSize + mNumCollected ) * sizeof( double );
+        }
+    }
+    // Each node of the forward list holds the pointer and the link.
+    numBytes += std::distance( mStateValues.begin(), mStateValues.end() ) * 2 * sizeof( Value* );
+    numBytes += sStateIndex.capacity() * sizeof( StateIndexEntry );
+    return numBytes;
+}
+
+/*!
+ * \brief Save the current state into a snapshot.
+ * \details Either all of the active state or only the market blocks, which are
+ *          at the front of it, are saved.  The snapshot only copies the pages
+ *          which differ from what it already holds so repeatedly saving into
+ *          the same snapshot is cheap when little has changed.
+ * \param aSnapshot The snapshot into which to save the state.
+ * \param aMarketsOnly Whether to only save the market prices, demands, and
+ *        supplies.
+ * \return True if the state was saved, false if only the markets were
+ *         requested but the market state is not stored in market blocks.
+ */
+bool ManageStateVariables::saveState( StateSnapshot& aSnapshot, const bool aMarketsOnly ) const {
+    if( aMarketsOnly && mNumMarkets == 0 ) {
+        return false;
+    }
+    aSnapshot.save( getCurrentState(), aMarketsOnly ? NUM_MARKET_STATES * mNumMarkets : mNumCollected );
+    return true;
+}
+
+/*!
+ * \brief Restore a snapshot taken with saveState into the current state.
+ * \details A snapshot of only the market blocks leaves the rest of the state
+ *          untouched.
+ * \param aSnapshot A snapshot saved from this object.
+ */
+void ManageStateVariables::restoreState( const StateSnapshot& aSnapshot ) const {
+    /*!
+     * \pre The snapshot can not be larger than the state it is restored into.
+     */
+    assert( aSnapshot.size() <= mNumCollected );
+    double* state = getCurrentState();
+    aSnapshot.restore( state );
+    markChanged( state, aSnapshot.size() );
+}
+
+/*!
+ * \brief Get the current state.
+ * \details The current state is whichever the Value objects are currently
+ *          reading and writing: the "base" state, or when calculating partial
+ *          derivatives the "scratch" space assigned to the calling thread.
+ * \return A pointer to the first of the active state values.
+ */
+double* ManageStateVariables::getCurrentState() const {
+    return Value::getCentralValue();
+}
+
+/*!
+ * \brief Allocate a state preceded by the flags used to track which pages of it
+ *        have been changed.
+ * \details The values are left uninitialized, and so the memory untouched until
+ *          the state is first copied into by the thread which uses it, and the
+ *          state is not synced with the "base" state.
+ * \param aStateIndex The index into mStateData of the state to allocate.
+ */
+void ManageStateVariables::allocateState( const int aStateIndex ) {
+    mStateData[ aStateIndex ] = new double[ mHeaderSize + mNumCollected ] + mHeaderSize;
+    memset( getChangedPages( mStateData[ aStateIndex ] ), 0, mHeaderSize * sizeof( double ) );
+    mIsSynced[ aStateIndex ] = 0;
+}
+
+/*!
+ * \brief Get the "scratch" space which copyState and commitState work with.
+ * \details Note when GCAM_PARALLEL_ENABLED this is the one assigned to the
+ *          calling thread via Value::getCentralValue.
+ * \return A pointer to the first of the "scratch" state values.
+ */
+double* ManageStateVariables::getScratchState() const {
+#if !GCAM_PARALLEL_ENABLED
+    return mStateData[1];
+#else
+    return Value::getCentralValue();
+#endif
+}
+
+/*!
+ * \brief Find the index into mStateData of a state.
+ * \details When GCAM_PARALLEL_ENABLED the "scratch" states may be allocated
+ *          by other threads at the same time so rather than searching for it we
+ *          use the state assigned to the calling thread.
+ * \param aState A pointer to the first value of the state.
+ * \return The index of the state, or -1 if it is not one of ours.
+ */
+int ManageStateVariables::getStateIndex( const double* aState ) const {
+#if GCAM_PARALLEL_ENABLED
+    if( aState == mStateData[0] ) {
+        return 0;
+    }
+    const int threadState = mThreadState.local();
+    return threadState > 0 && mStateData[ threadState ] == aState ? threadState : -1;
+#else
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        if( mStateData[ stateInd ] == aState ) {
+            return stateInd;
+        }
+    }
+    return -1;
+#endif
+}
+
+/*!
+ * \brief Get the page change flags of a state.
+ * \details The flags are stored in the mHeaderSize doubles just before the
+ *          first value of the state with the flag for page i in the i-th byte
+ *          before the first value, which is where Value sets it.
+ * \param aState A pointer to the first value of the state.
+ * \return A pointer to the start of the flags.
+ */
+unsigned char* ManageStateVariables::getChangedPages( double* aState ) const {
+    return reinterpret_cast<unsigned char*>( aState - mHeaderSize );
+}
+
+/*!
+ * \brief Flag the pages holding the first aNumValues of a state as changed.
+ * \details This is needed when the values are changed other than through
+ *          Value, such as when restoring a snapshot.
+ * \param aState A pointer to the first value of the state.
+ * \param aNumValues The number of values from the start of the state which
+ *                   may have changed.
+ */
+void ManageStateVariables::markChanged( double* aState, const size_t aNumValues ) const {
+    const size_t numPages = ( aNumValues + ( size_t( 1 ) << Value::STATE_PAGE_SHIFT ) - 1 ) >> Value::STATE_PAGE_SHIFT;
+    unsigned char* firstValue = reinterpret_cast<unsigned char*>( aState );
+    for( size_t page = 0; page < numPages; ++page ) {
+        firstValue[ -1 - static_cast<long>( page ) ] = 1;
+    }
+}
+
+/*!
+ * \brief Copy the pages flagged as changed from one state to another.
+ * \details The market blocks are always copied as they are set directly, for
+ *          instance to null the supplies and demands, rather than through Value.
+ *          The flags are scanned a word at a time as typically few are set.
+ * \param aTo The state to copy into.
+ * \param aFrom The state to copy from.
+ * \param aChangedPages The page change flags which select what to copy.
+ */
+void ManageStateVariables::copyChangedPages( double* aTo, const double* aFrom,
+                                             const unsigned char* aChangedPages ) const
+{
+    memcpy( aTo, aFrom, sizeof( double ) * NUM_MARKET_STATES * mNumMarkets );
+    
+    const size_t pageSize = size_t( 1 ) << Value::STATE_PAGE_SHIFT;
+    const size_t headerBytes = mHeaderSize * sizeof( double );
+    for( size_t word = 0; word < mHeaderSize; ++word ) {
+        uint64_t flags;
+        memcpy( &flags, aChangedPages + word * sizeof( uint64_t ), sizeof( uint64_t ) );
+        if( flags == 0 ) {
+            continue;
+        }
+        for( size_t byte = word * sizeof( uint64_t ); byte < ( word + 1 ) * sizeof( uint64_t ); ++byte ) {
+            const size_t page = headerBytes - 1 - byte;
+            if( aChangedPages[ byte ] && page < mNumPages ) {
+                const size_t begin = page * pageSize;
+                const size_t end = min( begin + pageSize, mNumCollected );
+                memcpy( aTo + begin, aFrom + begin, sizeof( double ) * ( end - begin ) );
+            }
+        }
+    }
+}
+
 /*!
  * \brief Copies the "base" state over the "scratch" space.
  * \details This method is typically called before starting a partial derivative
  *          calculation which will make changes in the "scratch" space.  Note when
  *          GCAM_PARALLEL_ENABLED the appropriate "scratch" space to reset is identified
- *          as the one assigned to the calling thread via the thread local Value::sCentralValue.
+ *          as the one assigned to the calling thread via Value::getCentralValue.
+ *          Each Value flags the page it is in as changed when it is set so, once
+ *          a "scratch" space has been copied in full, only the pages changed since
+ *          need to be copied.  That makes resetting after a partial derivative,
+ *          which typically only touches the state downstream of one market,
+ *          proportional to what it touched rather than to all of the state.
  */
 void ManageStateVariables::copyState() {
-#if !GCAM_PARALLEL_ENABLED
-    memcpy( mStateData[1], mStateData[0], (sizeof( double)) * mNumCollected );
-#else
-    memcpy( Value::sCentralValue.local(), mStateData[0], (sizeof( double)) * mNumCollected );
-#endif
+    double* state = getScratchState();
+    const int stateIndex = getStateIndex( state );
+    if( stateIndex <= 0 ) {
+        // The "base" state is already a copy of itself.
+        return;
+    }
+    
+    unsigned char* changedPages = getChangedPages( state );
+    if( mIsSynced[ stateIndex ] ) {
+        copyChangedPages( state, mStateData[0], changedPages );
+    }
+    else {
+        memcpy( state, mStateData[0], (sizeof( double)) * mNumCollected );
+        mIsSynced[ stateIndex ] = 1;
+    }
+    memset( changedPages, 0, mHeaderSize * sizeof( double ) );
+}
+
+/*!
+ * \brief Copies the "scratch" space over the "base" state.
+ * \details This is the reverse of copyState and allows a calculation that was
+ *          carried out in the "scratch" space, such as an incremental model
+ *          evaluation which only recalculated some activities, to be kept as
+ *          the new "base" state.  Note when GCAM_PARALLEL_ENABLED the "scratch"
+ *          space which is committed is the one assigned to the calling thread.
+ *          The pages which are copied are flagged as changed in the other
+ *          "scratch" spaces so that they are reset by their next copyState.
+ */
+void ManageStateVariables::commitState() {
+    double* state = getScratchState();
+    const int stateIndex = getStateIndex( state );
+    if( stateIndex <= 0 ) {
+        return;
+    }
+    
+    unsigned char* changedPages = getChangedPages( state );
+    const size_t headerBytes = mHeaderSize * sizeof( double );
+    if( mIsSynced[ stateIndex ] ) {
+        copyChangedPages( mStateData[0], state, changedPages );
+        for( int stateInd = 1; stateInd < mNumStates; ++stateInd ) {
+            if( stateInd != stateIndex && mIsSynced[ stateInd ] ) {
+                unsigned char* otherChangedPages = getChangedPages( mStateData[ stateInd ] );
+                for( size_t byte = 0; byte < headerBytes; ++byte ) {
+                    otherChangedPages[ byte ] |= changedPages[ byte ];
+                }
+            }
+        }
+    }
+    else {
+        memcpy( mStateData[0], state, (sizeof( double)) * mNumCollected );
+        mIsSynced.assign( mNumStates, 0 );
+        mIsSynced[ stateIndex ] = 1;
+    }
+    memset( changedPages, 0, headerBytes );
 }
 
 /*!
@@ -277,50 +1047,355 @@ void ManageStateVariables::copyState() {
  *                        derivative or not as set from the solution algorithm.
  */
 void ManageStateVariables::setPartialDeriv( const bool aIsPartialDeriv ) {
+#if STATE_AUDIT
+    gAuditIsPartialDeriv = aIsPartialDeriv;
+#endif
+    if( aIsPartialDeriv && mHeaderSize > 0 ) {
+        // The pages of the "base" state changed since the last partial derivative
+        // no longer match in the "scratch" spaces and so must be reset as well.
+        unsigned char* baseChangedPages = getChangedPages( mStateData[0] );
+        const size_t headerBytes = mHeaderSize * sizeof( double );
+        for( int stateInd = 1; stateInd < mNumStates; ++stateInd ) {
+            if( mIsSynced[ stateInd ] ) {
+                unsigned char* changedPages = getChangedPages( mStateData[ stateInd ] );
+                for( size_t byte = 0; byte < headerBytes; ++byte ) {
+                    changedPages[ byte ] |= baseChangedPages[ byte ];
+                }
+            }
+        }
+        memset( baseChangedPages, 0, headerBytes );
+    }
 #if !GCAM_PARALLEL_ENABLED
     Value::sCentralValue = mStateData[ aIsPartialDeriv ? 1 : 0 ];
 #else
+    Value::sCentralValue = mStateData[0];
     if( !aIsPartialDeriv ) {
-        // Initialize the thread local storage to always access the "base" state.
-        Value::sCentralValue = Value::CentralValueType( mStateData[0] );
+        // All threads access the "base" state.
+        Value::sThreadStateSource = 0;
     }
     else {
-        // Use the AssignThreadStateFun helper functor to uniquely assign a state
-        // slot to each worker thread.
-        Value::sCentralValue = Value::CentralValueType( AssignThreadStateFun( mStateData, NUM_STATES ) );
+        // Each thread will call assignThreadState the next time it accesses state
+        // to uniquely assign a state slot to it.
+        for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+            mIsAssigned[ stateInd ] = 0;
+        }
+        Value::sThreadStateSource = this;
     }
+    // Flag to all threads that they must refresh the state they use.
+    ++Value::sCentralValueVersion;
+#endif
+}
+
+/*!
+ * \brief Whether the "scratch" spaces are in use as set by setPartialDeriv.
+ * \return True if partial derivatives are being calculated.
+ */
+bool ManageStateVariables::isPartialDeriv() const {
+#if !GCAM_PARALLEL_ENABLED
+    return Value::sCentralValue != mStateData[0];
+#else
+    return Value::sThreadStateSource != 0;
 #endif
 }
 
 /*!
  * \brief Generate the appropriate restart file name to use.
- * \details This method will append the model period this instance was created
- *          with to the base name as set in the Configuration.  It will also also
- *          follow the <Files> convetion, specificially obey append-scenario-name, when
- *          it generates the file name.
+ * \details This method will append the model period to the base name as set
+ *          in the Configuration.  It will also also follow the <Files> convetion,
+ *          specificially obey append-scenario-name, when it generates the file name.
+ * \param aPeriod The model period the restart file is for.
  * \return The correct filename to use for restarts
  */
-string ManageStateVariables::getRestartFileName() const {
+string ManageStateVariables::getRestartFileName( const int aPeriod ) {
     Configuration* conf = Configuration::getInstance();
     const string fileName = conf->getFile( "restart", "restart/restart" );
     const string scnAppend = conf->shouldAppendScnToFile( "restart" ) ? "." + scenario->getName() : "";
-    const string period = util::toString( mPeriodToCollect );
+    const string period = util::toString( aPeriod );
     return fileName + scnAppend + "." + period;
 }
 
+/*!
+ * \brief Generate the name of the checkpoint file which records the last period
+ *        with a complete restart file.
+ * \details The file is kept next to the restart files and follows the same
+ *          <Files> conventions.
+ * \return The checkpoint file name.
+ */
+string ManageStateVariables::getCheckpointFileName() {
+    Configuration* conf = Configuration::getInstance();
+    const string fileName = conf->getFile( "restart", "restart/restart" );
+    const string scnAppend = conf->shouldAppendScnToFile( "restart" ) ? "." + scenario->getName() : "";
+    return fileName + scnAppend + ".checkpoint";
+}
+
+/*!
+ * \brief Set whether to resume from the last checkpoint.
+ * \details This is set from the --resume command line argument.
+ * \param aResume Whether to resume.
+ * \sa ManageStateVariables::getResumePeriod
+ */
+void ManageStateVariables::setResume( const bool aResume ) {
+    sResume = aResume;
+}
+
+namespace {
+    //! The version of the restart file format written by saveRestartFile.
+    const uint32_t RESTART_VERSION = 2;
+    
+    //! The identifier at the start of each restart file.
+    const char RESTART_MAGIC[ 8 ] = "GCAMRST";
+    
+    //! The alignment of the state values within a restart file.
+    const size_t RESTART_ALIGNMENT = 64;
+    
+    /*!
+     * \brief The header at the start of a restart file.
+     * \details The state values follow at mDataOffset which leaves room ahead of
+     *          them for the page change flags so that the file can be mapped
+     *          and used in place as the "base" state.  Restart files written
+     *          before the header was introduced start directly with the number
+     *          of states and are still read.
+     */
+    struct RestartHeader {
+        char mMagic[ 8 ];
+        uint32_t mVersion;
+        int32_t mPeriod;
+        uint64_t mNumStates;
+        uint64_t mStructureHash;
+        uint64_t mChecksum;
+        uint64_t mDataOffset;
+    };
+    
+    /*!
+     * \brief A restart file which is being written by a background thread.
+     * \details Only one may be pending at a time and it is always waited on before
+     *          the program exits.
+     */
+    struct PendingRestartFile {
+        thread mWriter;
+        string mFileName;
+        bool mSuccess;
+        
+        ~PendingRestartFile() {
+            if( mWriter.joinable() ) {
+                mWriter.join();
+            }
+        }
+    };
+    
+    PendingRestartFile gPendingRestartFile;
+    
+    //! The identifier on the first line of a checkpoint file.
+    const char CHECKPOINT_MAGIC[] = "GCAMCHK 1";
+    
+    /*!
+     * \brief Write a file so that it is never seen partially written.
+     * \details The contents are written to a temporary file which is then
+     *          renamed over the file, so a run which is stopped while writing
+     *          leaves the previous file intact.  This also leaves a restart file
+     *          which is memory mapped as the "base" state untouched.
+     * \param aFileName The name of the file to write.
+     * \param aContents The full contents of the file.
+     * \param aSize The size of aContents in bytes.
+     * \return Whether the file was successfully written.
+     */
+    bool replaceFile( const string& aFileName, const char* aContents, const size_t aSize ) {
+        const string tempFileName = aFileName + ".tmp";
+        fstream file( tempFileName.c_str(), ios_base::out | ios_base::trunc | ios_base::binary );
+        file.write( aContents, aSize );
+        file.close();
+        if( file.fail() ) {
+            remove( tempFileName.c_str() );
+            return false;
+        }
+        return rename( tempFileName.c_str(), aFileName.c_str() ) == 0;
+    }
+    
+    /*!
+     * \brief Write the contents of a restart file to disk.
+     * \details If a checkpoint file is given it is updated to record the period
+     *          of the restart file once that has been written.
+     * \param aFileName The name of the file to write.
+     * \param aContents The full contents of the file.
+     * \param aCheckpointFileName The name of the checkpoint file or empty to not
+     *                            update it.
+     * \param aCheckpoint The contents of the checkpoint file.
+     * \param aSuccess Set to whether the files were successfully written.
+     */
+    void writeRestartFile( const string aFileName, const vector<char> aContents,
+                           const string aCheckpointFileName, const string aCheckpoint, bool* aSuccess )
+    {
+        *aSuccess = replaceFile( aFileName, aContents.data(), aContents.size() ) &&
+            ( aCheckpointFileName.empty() ||
+              replaceFile( aCheckpointFileName, aCheckpoint.data(), aCheckpoint.size() ) );
+    }
+    
+    void restartError( const string& aFileName, const string& aError ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Restart file: " << aFileName << " " << aError << endl;
+        abort();
+    }
+}
+
+/*!
+ * \brief Wait for the last restart file to finish being written.
+ * \details saveRestartFile writes in the background so that the next period can
+ *          start right away.  This must be called before the restart files are
+ *          used, which the Scenario does when it is done.  It is an error if the
+ *          file could not be written.
+ */
+void ManageStateVariables::finishRestartFiles() {
+    if( gPendingRestartFile.mWriter.joinable() ) {
+        gPendingRestartFile.mWriter.join();
+        if( !gPendingRestartFile.mSuccess ) {
+            restartError( gPendingRestartFile.mFileName, "could not be written." );
+        }
+    }
+}
+
+/*!
+ * \brief A hash of the structure of the state which must match for a restart
+ *        file to be used.
+ * \details This covers the number of values collected and the names of the
+ *          markets in the order they are laid out at the front of the state.
+ *          It can not detect every change to the scenario but catches the
+ *          common case of restarting with a different set of markets.
+ * \return The structure hash.
+ */
+size_t ManageStateVariables::getStructureHash() const {
+    size_t hash = 0;
+    boost::hash_combine( hash, mNumCollected );
+    boost::hash_combine( hash, mNumMarkets );
+    boost::hash_combine( hash, mPeriodToCollect );
+    if( mNumMarkets > 0 ) {
+        for( auto market : scenario->getMarketplace()->mMarkets ) {
+            boost::hash_combine( hash, market->getSerialNumber() );
+            boost::hash_combine( hash, market->getName() );
+            boost::hash_combine( hash, market->getRegionName() );
+        }
+    }
+    return hash;
+}
+
+/*!
+ * \brief A checksum of the state values to detect a corrupt restart file.
+ * \param aState The state values to check.
+ * \return The FNV-1a hash of the state values taken a value at a time.
+ */
+size_t ManageStateVariables::getChecksum( const double* aState ) const {
+    uint64_t checksum = 14695981039346656037ULL;
+    for( size_t i = 0; i < mNumCollected; ++i ) {
+        uint64_t bits;
+        memcpy( &bits, aState + i, sizeof( bits ) );
+        checksum = ( checksum ^ bits ) * 1099511628211ULL;
+    }
+    return static_cast<size_t>( checksum );
+}
+
+/*!
+ * \brief The offset in a restart file at which the state values start.
+ * \details This leaves room after the RestartHeader for the page change flags
+ *          which precede the values of each state in memory.
+ * \return The offset in bytes.
+ */
+size_t ManageStateVariables::getRestartDataOffset() const {
+    const size_t minOffset = sizeof( RestartHeader ) + mHeaderSize * sizeof( double );
+    return ( minOffset + RESTART_ALIGNMENT - 1 ) / RESTART_ALIGNMENT * RESTART_ALIGNMENT;
+}
+
+/*!
+ * \brief Attempt to memory map a restart file to use directly as the "base" state.
+ * \details The file is mapped privately so the values may be changed in memory
+ *          without changing the file.  This is only possible for files in the
+ *          current format with enough room for the page change flags ahead of
+ *          the values, otherwise the file is left to be read by loadRestartFile.
+ * \param aFileName The name of the restart file.
+ * \return Whether the file was mapped and is now the "base" state.
+ */
+bool ManageStateVariables::mapRestartFile( const string& aFileName ) {
+#if GCAM_MMAP_RESTART
+    const int fd = open( aFileName.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        return false;
+    }
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 || static_cast<size_t>( fileStat.st_size ) < sizeof( RestartHeader ) ) {
+        close( fd );
+        return false;
+    }
+    const size_t fileSize = fileStat.st_size;
+    void* map = mmap( 0, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( map == MAP_FAILED ) {
+        return false;
+    }
+    
+    const RestartHeader* header = static_cast<const RestartHeader*>( map );
+    const size_t dataOffset = header->mDataOffset;
+    if( memcmp( header->mMagic, RESTART_MAGIC, sizeof( RESTART_MAGIC ) ) != 0 ||
+        header->mVersion != RESTART_VERSION ||
+        header->mPeriod != mPeriodToCollect ||
+        dataOffset < sizeof( RestartHeader ) + mHeaderSize * sizeof( double ) ||
+        dataOffset % sizeof( double ) != 0 ||
+        header->mNumStates != mNumCollected ||
+        fileSize != dataOffset + sizeof( double ) * mNumCollected )
+    {
+        // Let loadRestartFile read and report on the file.
+        munmap( map, fileSize );
+        return false;
+    }
+    
+    double* state = reinterpret_cast<double*>( static_cast<char*>( map ) + dataOffset );
+    if( header->mStructureHash != getStructureHash() || header->mChecksum != getChecksum( state ) ) {
+        munmap( map, fileSize );
+        return false;
+    }
+    
+    // The mapping replaces the allocated "base" state.
+    delete[] ( mStateData[0] - mHeaderSize );
+    mStateData[0] = state;
+    memset( getChangedPages( state ), 0, mHeaderSize * sizeof( double ) );
+    mMappedRestart = map;
+    mMappedRestartSize = fileSize;
+    return true;
+#else
+    return false;
+#endif
+}
+
 /*!
  * \brief Load a restart file from disk directly into the "base" state.
- * \warning Very little error checking is done to ensure the state read in was generated
- *          from the exact same scenario.  All we can do in terms of error checking is
- *          check that the size of the data coming in is exactly the same size as mNumCollected.
+ * \details Where possible the file is memory mapped and used as the "base" state
+ *          in place.  Otherwise the state values are read into the allocated
+ *          "base" state.  The header is checked to ensure the file was written
+ *          for the same number of values and the same structure of state and
+ *          that the values are intact.  Files written in the older format which
+ *          only start with the number of values are still accepted.
+ * \warning The structure hash can not detect every difference in the scenario
+ *          which generated the restart file.
  * \sa ManageStateVariables::getRestartFileName
  * \sa ManageStateVariables::saveRestartFile
  */
 void ManageStateVariables::loadRestartFile() {
-    // read from the appropriate file which is in binary format
-    const string restartFileName = getRestartFileName();
-    fstream restartFile( restartFileName.c_str(), ios_base::in | ios_base::binary );
+    GCAM_TRACE_SCOPE( restart_load, mPeriodToCollect, 0 );
+    // make sure a file being written is done before trying to read one
+    finishRestartFiles();
     
+    const string restartFileName = getRestartFileName( mPeriodToCollect );
+    mIsRestarted = true;
+    
+    // none of the "scratch" states match the new "base" state
+    mIsSynced.assign( mNumStates, 0 );
+    
+    if( mapRestartFile( restartFileName ) ) {
+        // point the Value classes at the new "base" state
+        setPartialDeriv( false );
+        Value::sBaseCentralValue = mStateData[0];
+        return;
+    }
+    
+    fstream restartFile( restartFileName.c_str(), ios_base::in | ios_base::binary );
     if( !restartFile.is_open() ) {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::SEVERE );
@@ -328,30 +1403,48 @@ void ManageStateVariables::loadRestartFile() {
         abort();
     }
     
+    RestartHeader header;
+    restartFile.read( reinterpret_cast<char*>( &header ), sizeof( RestartHeader ) );
+    const bool hasHeader = restartFile.gcount() == sizeof( RestartHeader ) &&
+        memcmp( header.mMagic, RESTART_MAGIC, sizeof( RESTART_MAGIC ) ) == 0;
     size_t numStatesInRestart;
-    restartFile.read( reinterpret_cast<char*>( &numStatesInRestart ), sizeof( size_t ) );
+    if( hasHeader ) {
+        if( header.mVersion != RESTART_VERSION ) {
+            restartError( restartFileName, "has unsupported version " + util::toString( header.mVersion ) + "." );
+        }
+        if( header.mPeriod != mPeriodToCollect ) {
+            restartError( restartFileName, "is for period " + util::toString( header.mPeriod ) +
+                          ", expected: " + util::toString( mPeriodToCollect ) );
+        }
+        if( header.mStructureHash != getStructureHash() ) {
+            restartError( restartFileName, "was written for a different structure of state." );
+        }
+        numStatesInRestart = header.mNumStates;
+        restartFile.seekg( header.mDataOffset );
+    }
+    else {
+        // the older format which starts with just the number of states
+        restartFile.clear();
+        restartFile.seekg( 0 );
+        restartFile.read( reinterpret_cast<char*>( &numStatesInRestart ), sizeof( size_t ) );
+    }
     if( numStatesInRestart != mNumCollected ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " differs in size, read: " << numStatesInRestart
-                << ", expected: " << mNumCollected << endl;
-        abort();
+        restartError( restartFileName, "differs in size, read: " + util::toString( numStatesInRestart ) +
+                      ", expected: " + util::toString( mNumCollected ) );
     }
     
     // read the binary data directly into the "base" state
     restartFile.read( reinterpret_cast<char*>( mStateData[0] ), sizeof( double ) * numStatesInRestart );
     if( !restartFile ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " has fewer states than expected, read: " << static_cast<size_t>( (restartFile.gcount() - sizeof(size_t)) / sizeof(double))
-                << ", expected: " << numStatesInRestart << endl;
-        abort();
+        restartError( restartFileName, "has fewer states than expected, read: " +
+                      util::toString( static_cast<size_t>( restartFile.gcount() / sizeof( double ) ) ) +
+                      ", expected: " + util::toString( numStatesInRestart ) );
     }
     if( restartFile.peek() != EOF ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " has more states than expected: " << numStatesInRestart << endl;
-        abort();
+        restartError( restartFileName, "has more states than expected: " + util::toString( numStatesInRestart ) );
+    }
+    if( hasHeader && header.mChecksum != getChecksum( mStateData[0] ) ) {
+        restartError( restartFileName, "is corrupt, the checksum does not match." );
     }
 
     restartFile.close();
@@ -359,35 +1452,93 @@ void ManageStateVariables::loadRestartFile() {
 
 /*!
  * \brief Dump the contents of the "base" state array into a binary restart file.
- * \details The first value written is mNumCollected (size written: size_t) to help with do some error checking
- *          when we try to read it back in.  Then we just write the entire content of mStateData[0]
- *          (size written: double * mNumCollected).
+ * \details The file starts with a RestartHeader which records the period, the
+ *          number of values, the structure hash and a checksum of the values to
+ *          help with error checking when we try to read it back in.  Then we
+ *          write the entire content of mStateData[0] at the data offset given
+ *          in the header.  The contents are copied and written by a background
+ *          thread so that the next period can start while it is written.
  * \sa ManageStateVariables::getRestartFileName
+ * \sa ManageStateVariables::finishRestartFiles
  */
 void ManageStateVariables::saveRestartFile() {
-    const string restartFileName = getRestartFileName();
+    GCAM_TRACE_SCOPE( restart_save, mPeriodToCollect, 0 );
+    // only one file is written at a time
+    finishRestartFiles();
+    
+    const string restartFileName = getRestartFileName( mPeriodToCollect );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::DEBUG );
-    mainLog << "Writing restart file: " << restartFileName << "... ";
-    fstream restartFile( restartFileName.c_str(), ios_base::out | ios_base::trunc | ios_base::binary );
+    mainLog << "Writing restart file: " << restartFileName << endl;
     
-    if( !restartFile.is_open() ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Could not open restart file: " << restartFileName << " for write." << endl;
-        abort();
-    }
+    RestartHeader header;
+    memset( &header, 0, sizeof( RestartHeader ) );
+    memcpy( header.mMagic, RESTART_MAGIC, sizeof( RESTART_MAGIC ) );
+    header.mVersion = RESTART_VERSION;
+    header.mPeriod = mPeriodToCollect;
+    header.mNumStates = mNumCollected;
+    header.mStructureHash = getStructureHash();
+    header.mChecksum = getChecksum( mStateData[0] );
+    header.mDataOffset = getRestartDataOffset();
     
-    // first write the total number of entries that should be expected to help with error
-    // checking on read in
-    restartFile.write( reinterpret_cast<char*>( &mNumCollected ), sizeof( size_t ) );
+    vector<char> contents( header.mDataOffset + sizeof( double ) * mNumCollected, 0 );
+    memcpy( contents.data(), &header, sizeof( RestartHeader ) );
+    memcpy( contents.data() + header.mDataOffset, mStateData[0], sizeof( double ) * mNumCollected );
     
-    // write the entire contents of the "base" state
-    restartFile.write( reinterpret_cast<char*>( mStateData[0] ), sizeof( double ) * mNumCollected );
+    // A period which was itself loaded from a restart file is being replayed and
+    // the checkpoint is already at least as far along.
+    const string checkpointFileName = mIsRestarted ? "" : getCheckpointFileName();
+    ostringstream checkpoint;
+    checkpoint << CHECKPOINT_MAGIC << '\n' << scenario->getName() << '\n' << mPeriodToCollect << '\n';
     
-    restartFile.close();
+    gPendingRestartFile.mFileName = restartFileName;
+    gPendingRestartFile.mSuccess = false;
+    gPendingRestartFile.mWriter = thread( writeRestartFile, restartFileName, std::move( contents ),
+                                          checkpointFileName, checkpoint.str(),
+                                          &gPendingRestartFile.mSuccess );
+}
+
+/*!
+ * \brief Get the period up to which restart files are used when resuming from the
+ *        last checkpoint.
+ * \details The checkpoint file records the scenario name and the last period
+ *          whose restart file was completely written.  A checkpoint for a
+ *          different scenario, which may happen when the scenario name is not
+ *          appended to the restart files, is ignored.
+ * \return The first period which will not be loaded from a restart file, or -1
+ *         if not resuming or there is no usable checkpoint.
+ * \sa ManageStateVariables::setResume
+ */
+int ManageStateVariables::getResumePeriod() const {
+    if( !sResume ) {
+        return -1;
+    }
     
-    mainLog << "Done." << endl;
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    // only report on the checkpoint once per scenario
+    mainLog.setLevel( mPeriodToCollect == 0 ? ILogger::NOTICE : ILogger::DEBUG );
+    const string checkpointFileName = getCheckpointFileName();
+    ifstream checkpointFile( checkpointFileName.c_str() );
+    string magic;
+    string scenarioName;
+    int period = -1;
+    if( !checkpointFile.is_open() ) {
+        mainLog << "No checkpoint " << checkpointFileName << " to resume from, running all periods." << endl;
+        return -1;
+    }
+    if( !getline( checkpointFile, magic ) || magic != CHECKPOINT_MAGIC ||
+        !getline( checkpointFile, scenarioName ) || !( checkpointFile >> period ) || period < 0 )
+    {
+        mainLog << "Checkpoint " << checkpointFileName << " could not be read, running all periods." << endl;
+        return -1;
+    }
+    if( scenarioName != scenario->getName() ) {
+        mainLog << "Checkpoint " << checkpointFileName << " is for scenario " << scenarioName
+                << ", running all periods." << endl;
+        return -1;
+    }
+    mainLog << "Resuming from the checkpoint of period " << period << "." << endl;
+    return period + 1;
 }
 
 #if DEBUG_STATE
@@ -402,6 +1553,122 @@ void Value::doStateCheck() const {
 }
 #endif
 
+#if STATE_AUDIT
+/*!
+ * \brief Record a write to this Value for the state audit.
+ * \details Writes to active state are flagged by state index.  Writes to other
+ *          Values are only of interest while partial derivatives are
+ *          calculated, when they are shared by the threads calculating them.
+ */
+void Value::auditWrite() const {
+    if( mIsStateCopy ) {
+        gAuditWritten[ mCentralValueIndex ].store( 1, memory_order_relaxed );
+    }
+    else if( gAuditIsPartialDeriv ) {
+        lock_guard<mutex> lock( gAuditMutex );
+        ++gAuditPartialDerivWrites[ this ];
+    }
+}
+
+/*!
+ * \brief Label each active state value and clear the record of writes for the
+ *        period.
+ * \details The labels come from a search of every container for its Data
+ *          which hold Values, which also labels those which are not STATE so
+ *          that writes to them can be reported.
+ */
+void ManageStateVariables::startStateAudit() {
+    gAuditRanges.clear();
+    vector<FilterStep*> auditSteps( 2, 0 );
+    auditSteps[ 0 ] = new FilterStep( "" );
+    auditSteps[ 1 ] = new FilterStep( "", DataFlags::STATE );
+    AuditLabeler labeler;
+    GCAMFusion<AuditLabeler, true, true, true> labelData( labeler, auditSteps );
+    labelData.startFilter( scenario );
+    for( auto filterStep : auditSteps ) {
+        delete filterStep;
+    }
+    
+    gAuditStateLabels.assign( mNumCollected, -1 );
+    for( auto currValue : mStateValues ) {
+        gAuditStateLabels[ currValue->mCentralValueIndex ] = findAuditLabel( currValue );
+    }
+    gAuditInitialState.assign( mStateData[ 0 ], mStateData[ 0 ] + mNumCollected );
+    gAuditWritten.reset( new atomic<unsigned char>[ mNumCollected ] );
+    for( size_t i = 0; i < mNumCollected; ++i ) {
+        gAuditWritten[ i ] = 0;
+    }
+    gAuditPartialDerivWrites.clear();
+}
+
+/*!
+ * \brief Add the writes of the period to the totals and write the report.
+ * \details The report lists for each container type and Data name holding
+ *          Values how many were active state, written and changed over all
+ *          periods so far, and how many writes happened to Values which were
+ *          not active state while partial derivatives were calculated.  STATE
+ *          Data which is never written and other Data which is written during
+ *          partial derivatives are flagged.
+ */
+void ManageStateVariables::finishStateAudit() const {
+    const size_t UNKNOWN = numeric_limits<size_t>::max();
+    for( size_t i = 0; i < mNumCollected; ++i ) {
+        const int label = gAuditStateLabels[ i ];
+        AuditTotals& totals = gAuditTotals[ label < 0 ? UNKNOWN : label ];
+        ++totals.mCollected;
+        if( gAuditWritten[ i ] ) {
+            ++totals.mWritten;
+        }
+        if( mStateData[ 0 ][ i ] != gAuditInitialState[ i ] ) {
+            ++totals.mChanged;
+        }
+    }
+    for( const auto& write : gAuditPartialDerivWrites ) {
+        const int label = findAuditLabel( write.first );
+        gAuditTotals[ label < 0 ? UNKNOWN : label ].mPartialDerivWrites += write.second;
+    }
+    gAuditPartialDerivWrites.clear();
+    gAuditWritten.reset();
+    
+    const string reportFile = Configuration::getInstance()->getFile( "state-audit-report", "state-audit.csv", false );
+    ofstream report( reportFile.c_str() );
+    if( !report.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the state audit report " << reportFile << endl;
+        return;
+    }
+    report << "data,flag,active-state,written,changed,partial-derivative-writes,finding" << endl;
+    for( const auto& entry : gAuditTotals ) {
+        const bool isKnown = entry.first != UNKNOWN;
+        const bool isState = isKnown && gAuditLabels[ entry.first ].second;
+        const AuditTotals& totals = entry.second;
+        report << ( isKnown ? gAuditLabels[ entry.first ].first : "unknown" ) << ','
+               << ( isState ? "STATE" : "" ) << ','
+               << totals.mCollected << ',' << totals.mWritten << ',' << totals.mChanged << ','
+               << totals.mPartialDerivWrites << ',';
+        if( isState && totals.mCollected > 0 && totals.mWritten == 0 ) {
+            report << "never-written";
+        }
+        else if( totals.mPartialDerivWrites > 0 ) {
+            report << "missing-state";
+        }
+        report << endl;
+    }
+}
+#endif
+
+/*!
+ * \brief Record a state Data found by GCAMFusion along with the Technology and
+ *        Market it is in.
+ * \param aType The kind of Data found.
+ * \param aData The Data found.
+ */
+void ManageStateVariables::DoCollect::addEntry( const StateIndexEntry::EntryType aType, void* aData ) {
+    StateIndexEntry entry = { aType, aData, mCurrTechnology, mCurrMarket, false };
+    mIndex->push_back( entry );
+}
+
 template<typename DataType>
 void ManageStateVariables::DoCollect::processData( DataType& aData ) {
 #if DEBUG_STATE
@@ -413,47 +1680,22 @@ void ManageStateVariables::DoCollect::processData( DataType& aData ) {
 
 template<>
 void ManageStateVariables::DoCollect::processData<Value>( Value& aData ) {
-    // Any SINGLE value that is tagged is considered active so long as it is not
-    // contained in a retired technology for instance.
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData );
-        ++mParentClass->mNumCollected;
-    }
+    addEntry( StateIndexEntry::SINGLE, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::PeriodVector<Value> >( objects::PeriodVector<Value>& aData ) {
-    // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
-    // considered active.
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData[ mParentClass->mPeriodToCollect ] );
-        ++mParentClass->mNumCollected;
-    }
+    addEntry( StateIndexEntry::PERIOD_VECTOR, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::TechVintageVector<Value> >( objects::TechVintageVector<Value>& aData ) {
-    // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
-    // considered active.
-    
-    // Note, mIgnoreCurrValue should take care of out of bounds here
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData[ mParentClass->mPeriodToCollect ] );
-        ++mParentClass->mNumCollected;
-    }
+    addEntry( StateIndexEntry::TECH_VINTAGE_VECTOR, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::YearVector<Value> >( objects::YearVector<Value>& aData ) {
-    // When a year vector is tagged we only need to worry about values in the current
-    // timestep (already calculated the years ahead of time in the interest of speed
-    // to be from [mCCStartYear, mYearToCollect])
-    if( !mIgnoreCurrValue ) {
-        for( int year = std::max( mParentClass->mCCStartYear, aData.getStartYear() ); year <= mParentClass->mYearToCollect; ++year ) {
-            mParentClass->mStateValues.push_front( &aData[ year ] );
-            ++mParentClass->mNumCollected;
-        }
-    }
+    addEntry( StateIndexEntry::YEAR_VECTOR, &aData );
 }
 
 template<typename DataType>
@@ -469,30 +1711,27 @@ void ManageStateVariables::DoCollect::popFilterStep( const DataType& aData ) {
 
 template<>
 void ManageStateVariables::DoCollect::pushFilterStep<ITechnology*>( ITechnology* const& aData ) {
-    // Ignore any data set within a Technology that is not operating in the current
-    // model period.
-    if( !aData->isOperating( mParentClass->mPeriodToCollect ) ) {
-        mIgnoreCurrValue = true;
-    }
+    // Record the Technology so that it may be searched again on its own and so
+    // that its Data can be ignored in periods it is not operating.
+    mCurrTechnology = aData;
+    addEntry( StateIndexEntry::TECHNOLOGY, 0 );
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<ITechnology*>( ITechnology* const& aData ) {
-    // Moving out of the current Technology so reset the ignore flag.
-    mIgnoreCurrValue = false;
+    // Moving out of the current Technology.
+    mCurrTechnology = 0;
 }
 
 template<>
 void ManageStateVariables::DoCollect::pushFilterStep<Market*>( Market* const& aData ) {
-    // Ignore any data set within a Market which is not for the current model year.
-    if( aData->getYear() != mParentClass->mYearToCollect ) {
-        mIgnoreCurrValue = true;
-    }
+    // Record the Market so that its Data can be ignored in periods other than its year.
+    mCurrMarket = aData;
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<Market*>( Market* const& aData ) {
-    // Moving out of the current Market so reset the ignore flag.
-    mIgnoreCurrValue = false;
+    // Moving out of the current Market.
+    mCurrMarket = 0;
 }
 
@@ -237,6 +237,7 @@ void Modeltime::initMembers( const map<int, int>& aYearToTimeStep ) {
     
     // start processing not to say no more errors are possible however
     mMaxPeriod = 0;
+    mYearToPeriod.assign( mEndYear - mStartYear + 1, 0 );
     // the timesteps are shifted by one and so the time step in period 0 does not make sense
     // note that the 15 is arbitrary here but a valid timestep is necessary for period 0
     mPeriodToTimeStep.push_back( 15 );
@@ -255,19 +256,19 @@ void Modeltime::initMembers( const map<int, int>& aYearToTimeStep ) {
             int offsetYear = currYear + periodOffset * currTimeStep;
             mPeriodToYear.push_back( offsetYear );
             mPeriodToTimeStep.push_back( currTimeStep );
-            mYearToPeriod[ offsetYear ] = mMaxPeriod++;
+            mYearToPeriod[ offsetYear - mStartYear ] = mMaxPeriod++;
         }
     }
     
     // add info for the end year
     mPeriodToYear.push_back( mEndYear );
-    mYearToPeriod[ mEndYear ] = mMaxPeriod++;
+    mYearToPeriod[ mEndYear - mStartYear ] = mMaxPeriod++;
     
     // Fill non-model years in 1 year timesteps into the year to period map with the period of the next
     // model year. Required for the carbon box model.
     for( int currPeriod = 1; currPeriod < mMaxPeriod; ++currPeriod ) {
         for( int inBetweenYear = mPeriodToYear[ currPeriod - 1 ] + 1; inBetweenYear < mPeriodToYear[ currPeriod ]; ++inBetweenYear ) {
-            mYearToPeriod[ inBetweenYear ] = currPeriod;
+            mYearToPeriod[ inBetweenYear - mStartYear ] = currPeriod;
         }
     }
     
@@ -297,38 +298,27 @@ int Modeltime::getEndYear() const {
 }
 
 /*!
-* \brief Convert a period into a year.
-* \details Converts the period into a year if it is valid. If it is not a valid
-*          year the function will print a warning and return 0.
-* \param aPeriod Model period.
-* \return The first year of the period, 0 if the year is invalid.
+* \brief Report an invalid period passed to getper_to_yr.
+* \param aPeriod The invalid period.
+* \return 0 which is the year returned for an invalid period.
 */
-int Modeltime::getper_to_yr( const int aPeriod ) const {
-    assert( mIsInitialized );
-    
-    if( aPeriod >= 0 && aPeriod < static_cast<int>( mPeriodToYear.size() ) ){
-        return mPeriodToYear[ aPeriod ];
-    }
-
+int Modeltime::invalidPeriod( const int aPeriod ) const {
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::ERROR );
     mainLog << "Invalid period " << aPeriod << " passed to Modeltime::getper_to_yr." << endl;
     return 0;
 }
 
-//! Convert a year to a period.
-int Modeltime::getyr_to_per( const int aYear ) const {
-    assert( mIsInitialized );
-    
-    map<int,int>::const_iterator iter = mYearToPeriod.find( aYear );
-    // Check for an invalid time period.
-    if( iter == mYearToPeriod.end() ){
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::ERROR );
-        mainLog << "Invalid year: " << aYear << " passed to Modeltime::getyr_to_per. " << endl;
-        return 0;
-    }
-    return iter->second; 
+/*!
+* \brief Report an invalid year passed to getyr_to_per.
+* \param aYear The invalid year.
+* \return 0 which is the period returned for an invalid year.
+*/
+int Modeltime::invalidYear( const int aYear ) const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::ERROR );
+    mainLog << "Invalid year: " << aYear << " passed to Modeltime::getyr_to_per. " << endl;
+    return 0;
 }
 
 /*!
@@ -339,13 +329,13 @@ int Modeltime::getyr_to_per( const int aYear ) const {
 bool Modeltime::isModelYear( const int aYear ) const {
     assert( mIsInitialized );
     
-    // Note that simply checking the year to period map will not work as intended.
-    // This is due to values being filled into the mYearToPeriod map for in between
+    // Note that simply checking the year to period table will not work as intended.
+    // This is due to values being filled into the mYearToPeriod table for in between
     // years.  A work around is to convert the year to a period and back again to
     // make sure that year is the same as aYear.
-    map<int, int>::const_iterator lookupYearIter = mYearToPeriod.find( aYear );
-    return lookupYearIter != mYearToPeriod.end()
-        && mPeriodToYear[ (*lookupYearIter).second ] == aYear;
+    const int offset = aYear - mStartYear;
+    return offset >= 0 && offset < static_cast<int>( mYearToPeriod.size() )
+        && mPeriodToYear[ mYearToPeriod[ offset ] ] == aYear;
 }
 
 /*!
@@ -0,0 +1,188 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file object_pool.cpp
+ * \ingroup util
+ * \brief ObjectPool class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <new>
+
+#include "util/base/include/object_pool.h"
+
+using namespace std;
+
+/*!
+ * \brief Get the single instance of the pool.
+ * \details The pool is intentionally never destroyed so that objects which
+ *          are deleted during static destruction can still be returned to it.
+ * \return The object pool.
+ */
+ObjectPool& ObjectPool::getInstance() {
+    static ObjectPool* sInstance = new ObjectPool();
+    return *sInstance;
+}
+
+ObjectPool::ObjectPool():
+mNumAllocated( 0 ),
+mPooledBytes( 0 ),
+mLargeBytes( 0 )
+{
+    for( size_t i = 0; i < NUM_SIZE_CLASSES; ++i ) {
+        mFreeList[ i ] = 0;
+        mChunkPos[ i ] = 0;
+        mChunkEnd[ i ] = 0;
+    }
+}
+
+/*!
+ * \brief Allocate memory for an object.
+ * \param aSize The size of the object.
+ * \return Memory for the object suitably aligned.
+ */
+void* ObjectPool::allocate( const size_t aSize ) {
+    if( aSize > MAX_POOLED_SIZE ) {
+        void* ret = ::operator new( aSize );
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+        mLargeBytes += aSize;
+        return ret;
+    }
+    const size_t sizeClass = ( aSize + SIZE_GRANULARITY - 1 ) / SIZE_GRANULARITY - 1;
+    const size_t slotSize = ( sizeClass + 1 ) * SIZE_GRANULARITY;
+
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    ++mNumAllocated;
+    mPooledBytes += slotSize;
+    FreeSlot* slot = mFreeList[ sizeClass ];
+    if( slot ) {
+        mFreeList[ sizeClass ] = slot->mNext;
+        return slot;
+    }
+    if( mChunkPos[ sizeClass ] == mChunkEnd[ sizeClass ] ) {
+        char* chunk = new char[ CHUNK_SIZE ];
+        mChunks.push_back( chunk );
+        mChunkPos[ sizeClass ] = chunk;
+        mChunkEnd[ sizeClass ] = chunk + ( CHUNK_SIZE / slotSize ) * slotSize;
+    }
+    void* ret = mChunkPos[ sizeClass ];
+    mChunkPos[ sizeClass ] += slotSize;
+    return ret;
+}
+
+/*!
+ * \brief Return the memory of an object to the pool.
+ * \param aPtr The memory returned by allocate.
+ * \param aSize The size of the object which must be the same as was allocated.
+ */
+void ObjectPool::deallocate( void* aPtr, const size_t aSize ) {
+    if( !aPtr ) {
+        return;
+    }
+    if( aSize > MAX_POOLED_SIZE ) {
+        ::operator delete( aPtr );
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+        mLargeBytes -= aSize;
+        return;
+    }
+    const size_t sizeClass = ( aSize + SIZE_GRANULARITY - 1 ) / SIZE_GRANULARITY - 1;
+
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    --mNumAllocated;
+    mPooledBytes -= ( sizeClass + 1 ) * SIZE_GRANULARITY;
+    FreeSlot* slot = static_cast<FreeSlot*>( aPtr );
+    slot->mNext = mFreeList[ sizeClass ];
+    mFreeList[ sizeClass ] = slot;
+}
+
+/*!
+ * \brief Release all of the memory held by the pool if no pooled objects
+ *        remain.
+ * \details This frees the chunks in one step rather than the objects one at a
+ *          time.  If any pooled object is still alive nothing is released.
+ * \return Whether the memory was released.
+ */
+bool ObjectPool::releaseIfUnused() {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    if( mNumAllocated != 0 ) {
+        return false;
+    }
+    for( size_t i = 0; i < mChunks.size(); ++i ) {
+        delete[] mChunks[ i ];
+    }
+    mChunks.clear();
+    for( size_t i = 0; i < NUM_SIZE_CLASSES; ++i ) {
+        mFreeList[ i ] = 0;
+        mChunkPos[ i ] = 0;
+        mChunkEnd[ i ] = 0;
+    }
+    return true;
+}
+
+/*!
+ * \brief Get the number of bytes allocated to objects which are alive.
+ * \details Pooled objects are counted at the size of their slot.  Objects
+ *          which were too large to be pooled are included at their size.
+ * \return The bytes in use.
+ */
+size_t ObjectPool::getBytesInUse() const {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    return mPooledBytes + mLargeBytes;
+}
+
+/*!
+ * \brief Get the number of bytes the pool holds from the heap.
+ * \details This is the size of all chunks, including the free slots and the
+ *          parts not yet carved, plus the objects too large to be pooled.
+ * \return The bytes reserved.
+ */
+size_t ObjectPool::getBytesReserved() const {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    return mChunks.size() * CHUNK_SIZE + mLargeBytes;
+}
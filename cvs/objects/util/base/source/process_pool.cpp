@@ -0,0 +1,177 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file process_pool.cpp
+ * \ingroup util
+ * \brief ProcessPool class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#if ( defined(__unix__) || defined(__APPLE__) ) && !GCAM_PARALLEL_ENABLED
+#define GCAM_PROCESS_POOL 1
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#define GCAM_PROCESS_POOL 0
+#endif
+
+#include "util/base/include/process_pool.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/logger_factory.h"
+
+using namespace std;
+
+/*!
+ * \brief Whether tasks can be run in child processes in this build.
+ * \return Whether run may be called.
+ */
+bool ProcessPool::isAvailable(){
+    return GCAM_PROCESS_POOL;
+}
+
+/*!
+ * \brief Run the tasks, a limited number at a time.
+ * \details Tasks are started in order of their index. This returns once all
+ *          of them have finished. If this is not available none of the tasks
+ *          are run.
+ * \param aNumTasks The number of tasks.
+ * \param aNumWorkers The maximum number of tasks to run at once.
+ * \param aName A name for the tasks used to name the logs of the children.
+ * \param aTask The task to run for each index.
+ * \return The result of each task, by index.
+ */
+vector<ProcessPool::Result> ProcessPool::run( const int aNumTasks,
+                                              const int aNumWorkers,
+                                              const string& aName,
+                                              const Task& aTask )
+{
+    vector<Result> results( aNumTasks );
+#if GCAM_PROCESS_POOL
+    //! A task running in a child process.
+    struct RunningTask {
+        //! The index of the task.
+        int mTask;
+
+        //! The child process.
+        pid_t mPid;
+
+        //! The pipe from which the output is read.
+        int mPipe;
+    };
+
+    vector<RunningTask> running;
+    int nextTask = 0;
+    while( nextTask < aNumTasks || !running.empty() ){
+        // Start tasks until all workers are busy.
+        while( nextTask < aNumTasks && running.size() < static_cast<size_t>( max( aNumWorkers, 1 ) ) ){
+            RunningTask task;
+            task.mTask = nextTask++;
+            int fds[ 2 ];
+            if( pipe( fds ) != 0 ){
+                continue;
+            }
+            LoggerFactory::beforeFork();
+            task.mPid = fork();
+            if( task.mPid == 0 ){
+                close( fds[ 0 ] );
+                LoggerFactory::afterFork( aName + "-" + util::toString( task.mTask ) );
+                string output;
+                const bool success = aTask( task.mTask, output );
+                for( size_t written = 0; written < output.size(); ){
+                    const ssize_t count = write( fds[ 1 ], output.data() + written, output.size() - written );
+                    if( count < 0 && errno != EINTR ){
+                        break;
+                    }
+                    written += max( count, static_cast<ssize_t>( 0 ) );
+                }
+                close( fds[ 1 ] );
+                LoggerFactory::cleanUp();
+                cout.flush();
+                _exit( success ? 0 : 1 );
+            }
+            LoggerFactory::afterFork( "" );
+            close( fds[ 1 ] );
+            if( task.mPid < 0 ){
+                close( fds[ 0 ] );
+                continue;
+            }
+            task.mPipe = fds[ 0 ];
+            running.push_back( task );
+        }
+        if( running.empty() ){
+            continue;
+        }
+
+        // Read the output of any task which has sent some.
+        vector<pollfd> pollFds( running.size() );
+        for( size_t i = 0; i < running.size(); ++i ){
+            pollFds[ i ].fd = running[ i ].mPipe;
+            pollFds[ i ].events = POLLIN;
+            pollFds[ i ].revents = 0;
+        }
+        if( poll( &pollFds[ 0 ], pollFds.size(), -1 ) < 0 ){
+            continue;
+        }
+        for( size_t i = running.size(); i-- > 0; ){
+            if( !pollFds[ i ].revents ){
+                continue;
+            }
+            Result& result = results[ running[ i ].mTask ];
+            char buffer[ 4096 ];
+            const ssize_t count = read( running[ i ].mPipe, buffer, sizeof( buffer ) );
+            if( count > 0 ){
+                result.mOutput.append( buffer, count );
+                continue;
+            }
+            if( count < 0 && errno == EINTR ){
+                continue;
+            }
+
+            // The task has finished.
+            close( running[ i ].mPipe );
+            int exitStatus = 0;
+            while( waitpid( running[ i ].mPid, &exitStatus, 0 ) < 0 && errno == EINTR ){
+            }
+            result.mCompleted = WIFEXITED( exitStatus ) && WEXITSTATUS( exitStatus ) <= 1;
+            result.mSuccess = result.mCompleted && WEXITSTATUS( exitStatus ) == 0;
+            running.erase( running.begin() + i );
+        }
+    }
+#endif
+    return results;
+}
@@ -0,0 +1,303 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file result_cache.cpp
+ * \ingroup util
+ * \brief ResultCache class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#if defined(__unix__) || defined(__APPLE__)
+#define GCAM_RESULT_CACHE 1
+#include <cstdio>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#define GCAM_RESULT_CACHE 0
+#endif
+
+#include "util/base/include/result_cache.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+namespace {
+    //! The name of the file listing the outputs stored for a key.
+    const string MANIFEST_NAME = "manifest";
+
+#if GCAM_RESULT_CACHE
+    /*!
+     * \brief Remove a file or a directory and everything in it.
+     * \param aPath The path to remove, which need not exist.
+     */
+    void removePath( const string& aPath ) {
+        struct stat pathStat;
+        if( lstat( aPath.c_str(), &pathStat ) != 0 ) {
+            return;
+        }
+        if( S_ISDIR( pathStat.st_mode ) ) {
+            DIR* dir = opendir( aPath.c_str() );
+            if( dir ) {
+                for( dirent* entry = readdir( dir ); entry; entry = readdir( dir ) ) {
+                    const string name = entry->d_name;
+                    if( name != "." && name != ".." ) {
+                        removePath( aPath + "/" + name );
+                    }
+                }
+                closedir( dir );
+            }
+            rmdir( aPath.c_str() );
+        }
+        else {
+            unlink( aPath.c_str() );
+        }
+    }
+
+    /*!
+     * \brief Create any missing directories leading to a path.
+     * \param aPath The path whose parent directories to create.
+     */
+    void createParentDirs( const string& aPath ) {
+        for( size_t pos = aPath.find( '/', 1 ); pos != string::npos; pos = aPath.find( '/', pos + 1 ) ) {
+            mkdir( aPath.substr( 0, pos ).c_str(), 0777 );
+        }
+    }
+
+    /*!
+     * \brief Copy a file or a directory and everything in it.
+     * \param aFrom The path to copy.
+     * \param aTo The path to create, which must not already exist.
+     * \return Whether everything was copied.
+     */
+    bool copyPath( const string& aFrom, const string& aTo ) {
+        struct stat pathStat;
+        if( stat( aFrom.c_str(), &pathStat ) != 0 ) {
+            return false;
+        }
+        if( S_ISDIR( pathStat.st_mode ) ) {
+            DIR* dir = opendir( aFrom.c_str() );
+            if( !dir || mkdir( aTo.c_str(), 0777 ) != 0 ) {
+                if( dir ) {
+                    closedir( dir );
+                }
+                return false;
+            }
+            bool success = true;
+            for( dirent* entry = readdir( dir ); entry && success; entry = readdir( dir ) ) {
+                const string name = entry->d_name;
+                if( name != "." && name != ".." ) {
+                    success = copyPath( aFrom + "/" + name, aTo + "/" + name );
+                }
+            }
+            closedir( dir );
+            return success;
+        }
+        ifstream in( aFrom.c_str(), ios::binary );
+        ofstream out( aTo.c_str(), ios::binary | ios::trunc );
+        if( !in || !out ) {
+            return false;
+        }
+        if( pathStat.st_size > 0 ) {
+            out << in.rdbuf();
+        }
+        out.close();
+        return !out.fail();
+    }
+#endif
+}
+
+/*!
+ * \brief Constructor.
+ * \param aCacheDir The directory holding the stored outputs, which is created
+ *        when outputs are first published.
+ */
+ResultCache::ResultCache( const string& aCacheDir ):
+mCacheDir( aCacheDir ),
+mHash( 14695981039346656037ULL )
+{
+}
+
+/*!
+ * \brief Whether outputs can be stored and restored in this build.
+ * \return Whether the cache is available.
+ */
+bool ResultCache::isAvailable() {
+    return GCAM_RESULT_CACHE;
+}
+
+/*!
+ * \brief Add the contents of a file to the key.
+ * \param aFileName The file to read.
+ * \return Whether the file could be read. If not the key should not be used.
+ */
+bool ResultCache::addFile( const string& aFileName ) {
+    ifstream in( aFileName.c_str(), ios::binary );
+    if( !in ) {
+        return false;
+    }
+    char buffer[ 65536 ];
+    uint64_t size = 0;
+    while( in.read( buffer, sizeof( buffer ) ) || in.gcount() > 0 ) {
+        addBytes( buffer, static_cast<size_t>( in.gcount() ) );
+        size += in.gcount();
+    }
+    // Include the size so that the end of one file can not be mistaken for
+    // the start of the next.
+    addBytes( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+    return !in.bad();
+}
+
+/*!
+ * \brief Add a value, such as a setting, to the key.
+ * \param aValue The value.
+ */
+void ResultCache::addValue( const string& aValue ) {
+    addBytes( aValue.data(), aValue.size() );
+    const uint64_t size = aValue.size();
+    addBytes( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+}
+
+/*!
+ * \brief Get the key for everything added so far.
+ * \return The key as 16 hexadecimal digits.
+ */
+string ResultCache::getKey() const {
+    ostringstream key;
+    key << hex << setw( 16 ) << setfill( '0' ) << mHash;
+    return key.str();
+}
+
+/*!
+ * \brief Whether outputs have been stored for the current key.
+ * \return Whether restore may be called.
+ */
+bool ResultCache::isStored() const {
+    ifstream manifest( ( getEntryDir() + "/" + MANIFEST_NAME ).c_str() );
+    return GCAM_RESULT_CACHE && manifest.good();
+}
+
+/*!
+ * \brief Copy the outputs stored for the current key back to the paths they
+ *        were published from, replacing anything already there.
+ * \return Whether all of the outputs were restored.
+ */
+bool ResultCache::restore() const {
+#if GCAM_RESULT_CACHE
+    const string entryDir = getEntryDir();
+    ifstream manifest( ( entryDir + "/" + MANIFEST_NAME ).c_str() );
+    if( !manifest ) {
+        return false;
+    }
+    bool success = true;
+    string output;
+    for( int index = 0; getline( manifest, output ); ++index ) {
+        removePath( output );
+        createParentDirs( output );
+        success = copyPath( entryDir + "/" + util::toString( index ), output ) && success;
+    }
+    return success;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Store copies of the outputs under the current key.
+ * \details Outputs which do not exist are skipped. If outputs have already been
+ *          stored for the key, for instance by another run sharing the cache,
+ *          those are kept.
+ * \param aOutputs The paths of the output files or directories.
+ * \return Whether the outputs are stored for the key.
+ */
+bool ResultCache::publish( const vector<string>& aOutputs ) const {
+#if GCAM_RESULT_CACHE
+    const string entryDir = getEntryDir();
+    createParentDirs( entryDir );
+    const string tempDir = entryDir + ".tmp-" + util::toString( static_cast<int>( getpid() ) );
+    removePath( tempDir );
+    if( mkdir( tempDir.c_str(), 0777 ) != 0 ) {
+        return false;
+    }
+
+    bool success = true;
+    ostringstream manifest;
+    int index = 0;
+    for( vector<string>::const_iterator output = aOutputs.begin(); output != aOutputs.end() && success; ++output ) {
+        struct stat outputStat;
+        if( stat( output->c_str(), &outputStat ) == 0 ) {
+            success = copyPath( *output, tempDir + "/" + util::toString( index++ ) );
+            manifest << *output << endl;
+        }
+    }
+    if( success ) {
+        // The manifest is written last so that its presence marks a complete
+        // set of outputs.
+        ofstream manifestFile( ( tempDir + "/" + MANIFEST_NAME ).c_str() );
+        manifestFile << manifest.str();
+        manifestFile.close();
+        success = !manifestFile.fail() && rename( tempDir.c_str(), entryDir.c_str() ) == 0;
+    }
+    if( !success ) {
+        removePath( tempDir );
+    }
+    return success || isStored();
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Update the hash with some bytes.
+ * \param aBytes The bytes to add.
+ * \param aSize The number of bytes.
+ */
+void ResultCache::addBytes( const char* aBytes, const size_t aSize ) {
+    for( size_t i = 0; i < aSize; ++i ) {
+        mHash = ( mHash ^ static_cast<unsigned char>( aBytes[ i ] ) ) * 1099511628211ULL;
+    }
+}
+
+/*!
+ * \brief Get the directory holding the outputs for the current key.
+ * \return The directory path.
+ */
+string ResultCache::getEntryDir() const {
+    return mCacheDir + "/" + getKey();
+}
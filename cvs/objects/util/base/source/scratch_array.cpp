@@ -0,0 +1,114 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file scratch_array.cpp
+ * \ingroup util
+ * \brief ScratchArray class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include "util/base/include/scratch_array.h"
+
+using namespace std;
+
+namespace {
+    //! The size of the first block of a thread's stack.
+    const size_t MIN_BLOCK_SIZE = 4096;
+
+    //! The memory from which a thread takes its scratch arrays.
+    struct ScratchStack {
+        ScratchStack():mBlock( 0 ), mOffset( 0 ){}
+
+        //! The blocks of memory, each larger than the last.
+        vector<unique_ptr<double[]> > mBlocks;
+
+        //! The size of each block.
+        vector<size_t> mBlockSizes;
+
+        //! The block arrays are currently taken from.
+        size_t mBlock;
+
+        //! The position of the next free value in the current block.
+        size_t mOffset;
+    };
+
+    //! The scratch stack of the calling thread.
+    ScratchStack& getStack() {
+        static thread_local ScratchStack stack;
+        return stack;
+    }
+}
+
+/*!
+ * \brief Constructor which takes an array from the calling thread's stack.
+ * \param aSize The number of values in the array.
+ */
+ScratchArray::ScratchArray( const size_t aSize ):
+mSize( aSize )
+{
+    ScratchStack& stack = getStack();
+    mPrevBlock = stack.mBlock;
+    mPrevOffset = stack.mOffset;
+
+    // Move on to the next block large enough to hold the array if it does not
+    // fit in the rest of the current one, adding a block if there is none.
+    if( stack.mBlocks.empty() || stack.mOffset + aSize > stack.mBlockSizes[ stack.mBlock ] ) {
+        size_t block = stack.mBlocks.empty() ? 0 : stack.mBlock + 1;
+        while( block < stack.mBlocks.size() && stack.mBlockSizes[ block ] < aSize ) {
+            ++block;
+        }
+        if( block == stack.mBlocks.size() ) {
+            const size_t blockSize = max( max( aSize, MIN_BLOCK_SIZE ),
+                                          stack.mBlockSizes.empty() ? 0 : 2 * stack.mBlockSizes.back() );
+            stack.mBlocks.push_back( unique_ptr<double[]>( new double[ blockSize ] ) );
+            stack.mBlockSizes.push_back( blockSize );
+        }
+        stack.mBlock = block;
+        stack.mOffset = 0;
+    }
+    mData = stack.mBlocks[ stack.mBlock ].get() + stack.mOffset;
+    stack.mOffset += aSize;
+}
+
+//! Destructor which returns the array to the calling thread's stack.
+ScratchArray::~ScratchArray() {
+    ScratchStack& stack = getStack();
+    stack.mBlock = mPrevBlock;
+    stack.mOffset = mPrevOffset;
+}
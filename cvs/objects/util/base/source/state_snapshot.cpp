@@ -0,0 +1,97 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file state_snapshot.cpp
+ * \ingroup util
+ * \brief StateSnapshot class source file.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+
+#include "util/base/include/state_snapshot.h"
+
+using namespace std;
+
+const size_t StateSnapshot::PAGE_SIZE;
+
+//! Constructor which creates an empty snapshot.
+StateSnapshot::StateSnapshot():
+mSize( 0 )
+{
+}
+
+/*!
+ * \brief Save an array of state data into the snapshot.
+ * \details Any state previously saved is replaced.  Pages of the previous
+ *          state which hold the same values are kept as they are, which also
+ *          keeps them shared with any copies of this snapshot.
+ * \param aData The data to save.
+ * \param aSize The number of values in aData.
+ */
+void StateSnapshot::save( const double* aData, const size_t aSize ) {
+    const size_t numPages = ( aSize + PAGE_SIZE - 1 ) / PAGE_SIZE;
+    mPages.resize( numPages );
+    mSize = aSize;
+    for( size_t page = 0; page < numPages; ++page ) {
+        const double* pageData = aData + page * PAGE_SIZE;
+        const size_t pageSize = min( PAGE_SIZE, aSize - page * PAGE_SIZE );
+        boost::shared_ptr<Page>& currPage = mPages[ page ];
+        if( currPage.get() && currPage->size() == pageSize ) {
+            if( memcmp( &( *currPage )[ 0 ], pageData, pageSize * sizeof( double ) ) == 0 ) {
+                // Unchanged, keep sharing it.
+                continue;
+            }
+            if( currPage.unique() ) {
+                // Not shared so it is safe to update in place.
+                memcpy( &( *currPage )[ 0 ], pageData, pageSize * sizeof( double ) );
+                continue;
+            }
+        }
+        currPage.reset( new Page( pageData, pageData + pageSize ) );
+    }
+}
+
+/*!
+ * \brief Copy the saved state back into an array of state data.
+ * \param aData The array into which to restore the data, which must be able
+ *        to hold size() values.
+ */
+void StateSnapshot::restore( double* aData ) const {
+    for( size_t page = 0; page < mPages.size(); ++page ) {
+        const Page& currPage = *mPages[ page ];
+        memcpy( aData + page * PAGE_SIZE, &currPage[ 0 ], currPage.size() * sizeof( double ) );
+    }
+}
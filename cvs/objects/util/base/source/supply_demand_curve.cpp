@@ -54,6 +54,11 @@
 
 extern Scenario* scenario;
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#endif
+
 using namespace std;
 
 //! Constructor
@@ -76,7 +81,7 @@ SupplyDemandCurve::~SupplyDemandCurve() {
 * create SupplyDemandPoints for. It then saves the original marketplace information, and perturbs the price
 * as specified by the price ratios. Using this new perturbed price, it call World::Calc to determine supply and 
 * demand for the given market. It saves that point for printing later, and continues to perform this process 
-* for each price. Finally it restores the original market information.
+* for each price, concurrently when GCAM is built with TBB. Finally it restores the original market information.
 *
 * \param aPrices The vector of prices at which to to calculate.
 * \param aSolnSet The solution set to interact with markets through.
@@ -115,17 +120,38 @@ void SupplyDemandCurve::calculatePoints( const std::vector<double>& aPrices, Sol
     // Have the state manage save the current state as a "clean" state.
     scenario->getManageStateVariables()->setPartialDeriv(true);
     
-    // iterate through the prices and determine supply and demand.
-    for ( int i = 0; i < numPrices; i++ ) {
+    // Each point is a partial derivative style evaluation of just this
+    // market's dependencies, which gets its own scratch copy of the state
+    // so that, as with the Jacobian columns, the points can be calculated
+    // concurrently.
+    vector<SupplyDemandPoint*> points( numPrices );
+    auto calcPoint = [&]( const int i ) {
+        UBVECTOR xx( x );
+        UBVECTOR fxx( nsolv );
         F.partial(mMarketNumber);
         
-        x[ mMarketNumber ] = aPrices[ i ] * scalingFactor;
+        xx[ mMarketNumber ] = aPrices[ i ] * scalingFactor;
         
-        F(x, fx, mMarketNumber);
+        F(xx, fxx, mMarketNumber);
         
         SolutionInfo s = aSolnSet.getSolvable( mMarketNumber );
-        mPoints.push_back( new SupplyDemandPoint( s.getPrice(), s.getDemand(), s.getSupply(), fx[ mMarketNumber ] ) );
+        points[ i ] = new SupplyDemandPoint( s.getPrice(), s.getDemand(), s.getSupply(), fxx[ mMarketNumber ] );
+    };
+#if !GCAM_PARALLEL_ENABLED
+    for ( int i = 0; i < numPrices; i++ ) {
+        calcPoint( i );
     }
+#else
+    tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute([&](){
+        tg.run([&](){
+            tbb::parallel_for( 0, numPrices, calcPoint );
+        });
+    });
+    threadPool.execute([&tg](){ tg.wait(); });
+#endif
+    mPoints.insert( mPoints.end(), points.begin(), points.end() );
     
     // restore state information for summary.
     F.partial(-1);
@@ -43,6 +43,7 @@
 #include "containers/include/scenario.h"
 #include "util/base/include/model_time.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/configuration_setting.h"
 #include "util/logger/include/ilogger.h"
 
 #include <string>
@@ -276,6 +277,14 @@ void printTime( const time_t& aTime, ostream& aOut ){
 #endif
     }
 
+namespace {
+    //! The run period settings which are known to be used by getConfigRunPeriod.
+    const ConfigurationSetting<int> gRestartPeriod( "restart-period", -1 );
+    const ConfigurationSetting<int> gRestartYear( "restart-year", -1 );
+    const ConfigurationSetting<int> gStopPeriod( "stop-period", -1 );
+    const ConfigurationSetting<int> gStopYear( "stop-year", -1 );
+}
+
 /*!
  * \brief Gets the appropriate value to pass to runScenarios by checking the configuration for
  *        a stop/restart -period or -year.
@@ -297,8 +306,20 @@ int getConfigRunPeriod( const string aKey ) {
     mainLog.setLevel( ILogger::WARNING );
     
     // Get the run period and year, defaulting to -1 which indicates not set.
-    const int configPeriod = Configuration::getInstance()->getInt( aKey + "-period", -1, false );
-    const int configYear = Configuration::getInstance()->getInt( aKey + "-year", -1, false );
+    int configPeriod;
+    int configYear;
+    if( aKey == "restart" ) {
+        configPeriod = gRestartPeriod.get();
+        configYear = gRestartYear.get();
+    }
+    else if( aKey == "stop" ) {
+        configPeriod = gStopPeriod.get();
+        configYear = gStopYear.get();
+    }
+    else {
+        configPeriod = Configuration::getInstance()->getInt( aKey + "-period", -1, false );
+        configYear = Configuration::getInstance()->getInt( aKey + "-year", -1, false );
+    }
     
     // Get the model time, note getting it this way is safer then through the scenario
     // object as this method could potentially be called before a scenario is initialized.
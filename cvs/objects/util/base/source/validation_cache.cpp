@@ -0,0 +1,121 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file validation_cache.cpp
+ * \ingroup util
+ * \brief ValidationCache class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+
+#include "util/base/include/validation_cache.h"
+#include "util/base/include/result_cache.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+/*!
+ * \brief Constructor which reads the hashes of the files validated by
+ *        earlier runs.
+ * \param aValidate Whether input files are to be validated at all.
+ * \param aCacheFile The file listing the hashes of validated files, empty to
+ *        validate every file without recording them.
+ * \param aSchemaVersion The version of the schemas the files are validated
+ *        against.
+ * \param aForceValidation Whether to validate every file even if it has
+ *        already been validated.
+ */
+ValidationCache::ValidationCache( const bool aValidate, const string& aCacheFile,
+                                  const string& aSchemaVersion, const bool aForceValidation ):
+mValidate( aValidate ),
+mCacheFile( aCacheFile ),
+mSchemaVersion( aSchemaVersion ),
+mForceValidation( aForceValidation )
+{
+    if( !mValidate || mCacheFile.empty() ) {
+        return;
+    }
+    ifstream in( mCacheFile.c_str() );
+    string key;
+    while( in >> key ) {
+        mValidatedKeys.insert( key );
+    }
+}
+
+/*!
+ * \brief Whether a file should be validated when it is read.
+ * \details If it should and the cache is in use, the hash of the file is kept
+ *          to be recorded by setValidated.
+ * \param aXMLFile The file about to be read.
+ * \return Whether to validate the file.
+ */
+bool ValidationCache::shouldValidate( const string& aXMLFile ) {
+    if( !mValidate || mCacheFile.empty() ) {
+        return mValidate;
+    }
+
+    ResultCache hasher( "" );
+    if( !hasher.addFile( aXMLFile ) ) {
+        // Let the parser report the problem reading the file.
+        return true;
+    }
+    hasher.addValue( mSchemaVersion );
+    const string key = hasher.getKey();
+    if( !mForceValidation && mValidatedKeys.find( key ) != mValidatedKeys.end() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        mainLog << "Skipping validation of " << aXMLFile << " which has already been validated." << endl;
+        return false;
+    }
+    mPendingKeys[ aXMLFile ] = key;
+    return true;
+}
+
+/*!
+ * \brief Record that a file was read successfully with validation on.
+ * \details Does nothing unless shouldValidate returned true for the file.
+ * \param aXMLFile The file which was read.
+ */
+void ValidationCache::setValidated( const string& aXMLFile ) {
+    map<string, string>::iterator pendingIt = mPendingKeys.find( aXMLFile );
+    if( pendingIt == mPendingKeys.end() ) {
+        return;
+    }
+    if( mValidatedKeys.insert( pendingIt->second ).second ) {
+        ofstream out( mCacheFile.c_str(), ios::app );
+        out << pendingIt->second << '\n';
+    }
+    mPendingKeys.erase( pendingIt );
+}
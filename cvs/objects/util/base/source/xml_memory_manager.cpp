@@ -0,0 +1,101 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file xml_memory_manager.cpp
+ * \ingroup util
+ * \brief XMLMemoryManager class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <new>
+#include <xercesc/util/OutOfMemoryException.hpp>
+
+#include "util/base/include/xml_memory_manager.h"
+
+using namespace std;
+
+/*!
+ * \brief Get the single instance of the memory manager.
+ * \details Xerces may use the memory manager until the platform is
+ *          terminated so it is intentionally never destroyed.
+ * \return The memory manager.
+ */
+XMLMemoryManager& XMLMemoryManager::getInstance() {
+    static XMLMemoryManager* sInstance = new XMLMemoryManager();
+    return *sInstance;
+}
+
+XMLMemoryManager::XMLMemoryManager():
+mBytesInUse( 0 ),
+mPeakBytes( 0 )
+{
+}
+
+xercesc::MemoryManager* XMLMemoryManager::getExceptionMemoryManager() {
+    return this;
+}
+
+/*!
+ * \brief Allocate memory for Xerces.
+ * \param aSize The number of bytes requested.
+ * \return The memory.
+ * \throw xercesc::OutOfMemoryException if the memory could not be allocated as
+ *        Xerces expects.
+ */
+void* XMLMemoryManager::allocate( XMLSize_t aSize ) {
+    char* block = static_cast<char*>( ::operator new( aSize + HEADER_SIZE, nothrow ) );
+    if( !block ) {
+        throw xercesc::OutOfMemoryException();
+    }
+    *reinterpret_cast<size_t*>( block ) = aSize;
+
+    const size_t inUse = mBytesInUse += aSize;
+    size_t peak = mPeakBytes;
+    while( inUse > peak && !mPeakBytes.compare_exchange_weak( peak, inUse ) ) {
+    }
+    return block + HEADER_SIZE;
+}
+
+/*!
+ * \brief Return memory allocated by allocate.
+ * \param aPtr The memory to return which may be null.
+ */
+void XMLMemoryManager::deallocate( void* aPtr ) {
+    if( !aPtr ) {
+        return;
+    }
+    char* block = static_cast<char*>( aPtr ) - HEADER_SIZE;
+    mBytesInUse -= *reinterpret_cast<size_t*>( block );
+    ::operator delete( block );
+}
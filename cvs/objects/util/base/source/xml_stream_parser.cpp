@@ -0,0 +1,298 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file xml_stream_parser.cpp
+ * \ingroup util
+ * \brief XMLStreamParser class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <iostream>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMImplementation.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/iparsable.h"
+#include "util/base/include/compressed_input_source.h"
+
+using namespace std;
+using namespace xercesc;
+
+/*!
+ * \brief Constructor.
+ * \param aXMLFile The name of the file being read, for error messages.
+ * \param aModelElement Element to call XMLParse on for each piece.
+ * \param aContainerNames The names of elements directly below the root whose
+ *                        children should each be parsed separately.
+ */
+XMLChunkBuilder::XMLChunkBuilder( const string& aXMLFile, IParsable* aModelElement,
+                                  const set<string>& aContainerNames ):
+mModelElement( aModelElement ),
+mContainerNames( aContainerNames ),
+mDocumentURI( 0 ),
+mChunk( 0 ),
+mChunkTop( 0 ),
+mCurrent( 0 ),
+mSuccess( true )
+{
+    mDocumentURI = XMLString::transcode( aXMLFile.c_str() );
+}
+
+//! Destructor.
+XMLChunkBuilder::~XMLChunkBuilder() {
+    releaseChunk();
+    XMLString::release( &mDocumentURI );
+}
+
+/*!
+ * \brief Start a new element.
+ * \param aName The element name.
+ * \param aAttrs The attributes of the element, which need only be valid
+ *               during the call.
+ */
+void XMLChunkBuilder::startElement( const XMLCh* const aName, const AttributeList& aAttrs ) {
+    if( mChunk ) {
+        flushText();
+        DOMElement* element = createElement( aName, aAttrs );
+        mCurrent->appendChild( element );
+        mCurrent = element;
+        return;
+    }
+    
+    if( !mAncestors.empty() ) {
+        mAncestors.back().mHasChildren = true;
+    }
+    
+    const string name = XMLHelper<string>::safeTranscode( aName );
+    if( mAncestors.empty() || mContainerNames.find( name ) != mContainerNames.end() ) {
+        // Keep a copy of the element to add to each piece parsed below it.
+        Ancestor ancestor;
+        ancestor.mName = aName;
+        for( auto& attr : aAttrs ) {
+            ancestor.mAttrs.push_back( make_pair( XMLString_t( attr.first ), XMLString_t( attr.second ) ) );
+        }
+        ancestor.mHasChildren = false;
+        mAncestors.push_back( ancestor );
+    }
+    else {
+        DOMElement* parent = createChunk( mAncestors.size() );
+        mChunkTop = createElement( aName, aAttrs );
+        parent->appendChild( mChunkTop );
+        mCurrent = mChunkTop;
+    }
+}
+
+/*!
+ * \brief End the current element, parsing the piece it completes if any.
+ */
+void XMLChunkBuilder::endElement() {
+    if( mChunk ) {
+        flushText();
+        if( mCurrent == mChunkTop ) {
+            mSuccess &= mModelElement->XMLParse( mChunk->getDocumentElement() );
+            releaseChunk();
+        }
+        else {
+            mCurrent = static_cast<DOMElement*>( mCurrent->getParentNode() );
+        }
+        return;
+    }
+    
+    // Make sure an empty root or container still gets parsed.
+    if( !mAncestors.back().mHasChildren ) {
+        createChunk( mAncestors.size() );
+        mSuccess &= mModelElement->XMLParse( mChunk->getDocumentElement() );
+        releaseChunk();
+    }
+    mAncestors.pop_back();
+}
+
+/*!
+ * \brief Add text to the current element.
+ * \details Text outside of the pieces belongs to the root or a container
+ *          which do not have text content and so is ignored.
+ * \param aChars The text, which need not be null terminated.
+ * \param aLength The number of characters.
+ */
+void XMLChunkBuilder::characters( const XMLCh* const aChars, const XMLSize_t aLength ) {
+    if( mChunk ) {
+        mText.append( aChars, aLength );
+    }
+}
+
+/*!
+ * \brief Create a new document containing copies of the first
+ *        aNumAncestors ancestors.
+ * \return The innermost ancestor.
+ */
+DOMElement* XMLChunkBuilder::createChunk( const size_t aNumAncestors ) {
+    mChunk = DOMImplementation::getImplementation()->createDocument();
+    mChunk->setDocumentURI( mDocumentURI );
+    DOMNode* parent = mChunk;
+    for( size_t i = 0; i < aNumAncestors; ++i ) {
+        DOMElement* element = mChunk->createElement( mAncestors[ i ].mName.c_str() );
+        for( auto& attr : mAncestors[ i ].mAttrs ) {
+            element->setAttribute( attr.first.c_str(), attr.second.c_str() );
+        }
+        parent->appendChild( element );
+        parent = element;
+    }
+    return static_cast<DOMElement*>( parent );
+}
+
+//! Create an element in the current document.
+DOMElement* XMLChunkBuilder::createElement( const XMLCh* const aName, const AttributeList& aAttrs ) {
+    DOMElement* element = mChunk->createElement( aName );
+    for( auto& attr : aAttrs ) {
+        element->setAttribute( attr.first, attr.second );
+    }
+    return element;
+}
+
+//! Add any text read to the current element, skipping whitespace between
+//! elements as the DOM parser does.
+void XMLChunkBuilder::flushText() {
+    if( !mText.empty() && !XMLString::isAllWhiteSpace( mText.c_str() ) ) {
+        mCurrent->appendChild( mChunk->createTextNode( mText.c_str() ) );
+    }
+    mText.clear();
+}
+
+//! Free the memory of the current piece.
+void XMLChunkBuilder::releaseChunk() {
+    if( mChunk ) {
+        mChunk->release();
+        mChunk = 0;
+    }
+    mChunkTop = 0;
+    mCurrent = 0;
+    mText.clear();
+}
+
+namespace {
+    /*!
+     * \brief SAX2 content handler which passes the elements read on to an
+     *        XMLChunkBuilder.
+     */
+    class StreamingHandler : public DefaultHandler {
+    public:
+        StreamingHandler( XMLChunkBuilder& aBuilder ):
+        mBuilder( aBuilder )
+        {
+        }
+        
+        virtual void startElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                   const XMLCh* const aQName, const Attributes& aAttrs )
+        {
+            mAttrs.clear();
+            for( XMLSize_t i = 0; i < aAttrs.getLength(); ++i ) {
+                mAttrs.push_back( make_pair( aAttrs.getQName( i ), aAttrs.getValue( i ) ) );
+            }
+            mBuilder.startElement( aQName, mAttrs );
+        }
+        
+        virtual void endElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                 const XMLCh* const aQName )
+        {
+            mBuilder.endElement();
+        }
+        
+        virtual void characters( const XMLCh* const aChars, const XMLSize_t aLength ) {
+            mBuilder.characters( aChars, aLength );
+        }
+        
+        virtual void fatalError( const SAXParseException& aException ) {
+            throw aException;
+        }
+        
+    private:
+        //! The builder to pass the elements to.
+        XMLChunkBuilder& mBuilder;
+        
+        //! Storage for the attributes of the element being started.
+        XMLChunkBuilder::AttributeList mAttrs;
+    };
+}
+
+/*!
+ * \brief Parse an XML file one top level element at a time.
+ * \details The XML platform must already have been initialized, which
+ *          happens when the configuration is parsed.
+ * \param aXMLFile The name of the file to parse.
+ * \param aModelElement Element to call XMLParse on for each piece.
+ * \param aContainerNames The names of elements directly below the root whose
+ *                        children should each be parsed separately.
+ * \param aValidate Whether to validate the file against its schema.
+ * \return Whether parsing was successful.
+ */
+bool XMLStreamParser::parseXML( const string& aXMLFile, IParsable* aModelElement,
+                                const set<string>& aContainerNames,
+                                const bool aValidate )
+{
+    auto_ptr<SAX2XMLReader> reader( XMLReaderFactory::createXMLReader() );
+    reader->setFeature( XMLUni::fgSAX2CoreNameSpaces, false );
+    reader->setFeature( XMLUni::fgSAX2CoreValidation, aValidate );
+    reader->setFeature( XMLUni::fgXercesSchema, aValidate );
+    reader->setFeature( XMLUni::fgXercesDynamic, false );
+    
+    XMLChunkBuilder builder( aXMLFile, aModelElement, aContainerNames );
+    StreamingHandler handler( builder );
+    reader->setContentHandler( &handler );
+    reader->setErrorHandler( &handler );
+    try {
+        CompressedInputSource::parse( *reader, aXMLFile );
+    } catch ( const XMLException& toCatch ) {
+        string message = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+        cout << "ERROR: XML Read Exception message is:" << endl << message << endl;
+        return false;
+    } catch ( const SAXException& toCatch ){
+        string message = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+        cout << "ERROR: XML Read Exception message is:" << endl << message << endl;
+        return false;
+    } catch (...) {
+        cout << "ERROR:Unexpected XML Read Exception." << endl;
+        return false;
+    }
+    return builder.getSuccess();
+}
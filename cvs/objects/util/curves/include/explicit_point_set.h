@@ -116,5 +116,19 @@ protected:
     DataPoint* findY( const double yValue );
     void print( std::ostream& out, const double lowDomain = -DBL_MAX, const double highDomain = DBL_MAX,
         const double lowRange = -DBL_MAX, const double highRange = DBL_MAX, const int minPoints = 0 ) const;
+    void updateSortedPoints();
+    int findSortedX( const double xValue ) const;
+
+    //! The x values of the points sorted in increasing order, with points
+    //! with equal x kept in the order they were added.  This is rebuilt
+    //! whenever the points change so that lookups by x, which are done by
+    //! PointSetCurve for every evaluation, are a binary search.
+    std::vector<double> mSortedX;
+
+    //! The y values of the points in the same order as mSortedX.
+    std::vector<double> mSortedY;
+
+    //! The index into points of each point in the same order as mSortedX.
+    std::vector<unsigned int> mSortedIndex;
 };
 #endif // _EXPLICIT_POINT_SET_H_
@@ -69,7 +69,13 @@
  *                         fitting procedures to compute an
  *                         interpolated y-value for an input x.  For
  *                         convenience, this function is aliased to
- *                         operator(). 
+ *                         operator().  A second version evaluates
+ *                         a whole vector of x values at once.
+ *
+ *          Once fit, the polynomial for each segment is stored as
+ *          coefficients of powers of (x - x[i]) so that an
+ *          evaluation is a binary search for the segment followed by
+ *          a Horner evaluation. 
  * \note In theory one might want to fit a "mixed" spline; i.e., one
  *       with a natural boundary condition at one end and a specified
  *       derivative at the other.  It wouldn't be too hard to add a
@@ -83,10 +89,23 @@ class Spline {
     std::vector<double> y;
     //! y'' values (computed in fit()
     std::vector<double> ypp;
+    //! coefficients of (x-x[i]), (x-x[i])^2, and (x-x[i])^3 for
+    //! segment i (computed in fit())
+    std::vector<double> c1, c2, c3;
 
     //! portion of the fitting procedure that is common to natural and
     //  boundary fits.
     void fit_internal(std::vector<double> &u);
+    //! compute the segment polynomials from ypp
+    void compute_coefficients();
+    //! find the segment containing an x-value
+    int find_segment(double ax) const;
+    //! evaluate the polynomial for a segment
+    double eval_segment(int i, double ax) const
+    {
+        double t = ax - x[i];
+        return y[i] + t*(c1[i] + t*(c2[i] + t*c3[i]));
+    }
     //! write an error to main_log and abort
     void log_and_abort(const std::string &msg) const;
 
@@ -102,6 +121,7 @@ public:
     void fit_boundary(const std::vector<double> &ax, const std::vector<double> &ay,
                       double yp0, double ypn);
     double interpolate(double ax) const;
+    void interpolate(const std::vector<double> &ax, std::vector<double> &ay) const;
     //! alias for interpolate
     double operator()(double ax) const {return interpolate(ax);}
     //! minimum allowable x-value
@@ -111,7 +131,7 @@ public:
     //! indicate whether or not the spline is valid
     bool isValid(void) const {return x.size() >= 2;}
     //! clear the fitted values.  After this the spline will be invalid
-    void clear(void) {x.clear(); y.clear(); ypp.clear();}
+    void clear(void) {x.clear(); y.clear(); ypp.clear(); c1.clear(); c2.clear(); c3.clear();}
 };
 
 
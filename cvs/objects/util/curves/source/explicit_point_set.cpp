@@ -83,6 +83,8 @@ void ExplicitPointSet::clear() {
     for( DataPointIterator delIter = points.begin(); delIter != points.end(); ++delIter ){
         delete *delIter;
     }
+    points.clear();
+    updateSortedPoints();
 }
 
 //! Helper function which copies into a new object.
@@ -91,6 +93,7 @@ void ExplicitPointSet::copy( const ExplicitPointSet& rhs ){
     for( unsigned int i = 0; i < rhs.points.size(); ++i ){
         points.push_back( rhs.points[ i ]->clone() );
     }
+    updateSortedPoints();
 }
 
 //! Static function to return the name of the XML element associated with this object.
@@ -117,6 +120,7 @@ bool ExplicitPointSet::addPoint( DataPoint* pointIn ) {
     
     if( !foundPoint ){
         points.push_back( pointIn );
+        updateSortedPoints();
     }
     
     return !foundPoint;
@@ -140,6 +144,7 @@ bool ExplicitPointSet::setY( const double xValue, const double yValue ){
     // If the point was found.
     if( point ){
         point->setY( yValue );
+        updateSortedPoints();
     }
     return ( point != 0 );
 }
@@ -150,6 +155,7 @@ bool ExplicitPointSet::setX( const double yValue, const double xValue ){
     // If the point was found.
     if( point ){
         point->setX( xValue );
+        updateSortedPoints();
     }
     return ( point != 0 );
 }
@@ -162,6 +168,7 @@ bool ExplicitPointSet::removePointFindX( const double xValue ){
 		assert( delIter != points.end() );
 		delete point;
 		points.erase( delIter );
+        updateSortedPoints();
     }
 
     return ( point != 0 );
@@ -175,6 +182,7 @@ bool ExplicitPointSet::removePointFindY( const double yValue ){
         assert( delIter != points.end() );
 		delete point;
 		points.erase( delIter );
+        updateSortedPoints();
     }
 
     return ( point != 0 );
@@ -185,13 +193,12 @@ bool ExplicitPointSet::removePointFindY( const double yValue ){
 * \author Josh Lurz
 */
 double ExplicitPointSet::getMaxX() const {
-	DataPointConstIterator maxPoint = max_element( points.begin(), points.end(), DataPoint::LesserX() );
-	if( maxPoint != points.end() ){
-		return (*maxPoint)->getX();
-	}
+    if( !mSortedX.empty() ){
+        return mSortedX.back();
+    }
 
-	// There are no points, return the negative error code.
-	return -DBL_MAX;
+    // There are no points, return the negative error code.
+    return -DBL_MAX;
 }
 
 /*! \brief Return the maximum Y value in this point set.
@@ -199,13 +206,13 @@ double ExplicitPointSet::getMaxX() const {
 * \author Josh Lurz
 */
 double ExplicitPointSet::getMaxY() const {
-DataPointConstIterator maxPoint = max_element( points.begin(), points.end(), DataPoint::LesserX() );
-if( maxPoint != points.end() ){
-    return (*maxPoint)->getY();
-}
- 
-// There are no points, return the negative error code.
-return -DBL_MAX;
+    if( !mSortedX.empty() ){
+        // This is the y of the first point added with the maximum x.
+        return mSortedY[ lower_bound( mSortedX.begin(), mSortedX.end(), mSortedX.back() ) - mSortedX.begin() ];
+    }
+
+    // There are no points, return the negative error code.
+    return -DBL_MAX;
 }
 
 /*! \brief Return the minimum X value in this point set.
@@ -213,13 +220,12 @@ return -DBL_MAX;
 * \author Josh Lurz
 */
 double ExplicitPointSet::getMinX() const {
-DataPointConstIterator minPoint = min_element( points.begin(), points.end(), DataPoint::LesserX() );
-if( minPoint != points.end() ){
-    return (*minPoint)->getX();
-}
- 
-// There are no points, return the positive error code.
-return DBL_MAX;
+    if( !mSortedX.empty() ){
+        return mSortedX.front();
+    }
+
+    // There are no points, return the positive error code.
+    return DBL_MAX;
 }
 
 /*! \brief Return the minimum Y value in this point set.
@@ -227,28 +233,25 @@ return DBL_MAX;
 * \author Josh Lurz
 */
 double ExplicitPointSet::getMinY() const {
-DataPointConstIterator minPoint = min_element( points.begin(), points.end(), DataPoint::LesserX() );
-if( minPoint != points.end() ){
-    return (*minPoint)->getY();
-}
- 
-// There are no points, return the positive error code.
-return DBL_MAX;
+    if( !mSortedX.empty() ){
+        // This is the y of the first point added with the minimum x.
+        return mSortedY.front();
+    }
+
+    // There are no points, return the positive error code.
+    return DBL_MAX;
 }
 
 //! Return a vector of pairs of x y coordinates sorted in increasing x order.
 ExplicitPointSet::SortedPairVector ExplicitPointSet::getSortedPairs( const double lowDomain, const double highDomain, const int minPoints ) const {
-    // Create a copy of the points as this is a const function.
-    vector<DataPoint*> pointsCopy = points;
-    sort( pointsCopy.begin(), pointsCopy.end(), DataPoint::LesserX() );
-
-    // Now create a vector of std::pairs to return. This is due to the superclass being unaware of the underlying representation.
+    // Create a vector of std::pairs to return. This is due to the superclass being unaware of the underlying representation.
     vector<pair<double,double> > sortedPoints;
-    for( DataPointConstIterator iter = pointsCopy.begin(); iter != pointsCopy.end(); iter++ ){
+    sortedPoints.reserve( mSortedX.size() );
+    for( size_t i = 0; i < mSortedX.size(); ++i ){
         // Check if it is within the requested domain. 
-        if( ( (*iter)->getX() >= lowDomain ) && ( (*iter)->getX() <= highDomain ) ){
+        if( ( mSortedX[ i ] >= lowDomain ) && ( mSortedX[ i ] <= highDomain ) ){
             // add the point.
-            sortedPoints.push_back( pair<double,double>( (*iter)->getX(), (*iter)->getY() ) );
+            sortedPoints.push_back( pair<double,double>( mSortedX[ i ], mSortedY[ i ] ) );
         }
     }
     return sortedPoints;
@@ -266,26 +269,14 @@ bool ExplicitPointSet::containsY( const double y ) const {
  
 //! Determines the x coordinate of the nearest point below x.
 double ExplicitPointSet::getNearestXBelow( const double x ) const {
-    double closestX = -DBL_MAX;
-    for( DataPointConstIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
-        double currX = ( *pointsIter )->getX();
-        if( ( currX < x ) && currX > closestX ){
-            closestX = currX;
-        }
-    }
-    return closestX;
+    vector<double>::const_iterator above = lower_bound( mSortedX.begin(), mSortedX.end(), x );
+    return above != mSortedX.begin() ? *( above - 1 ) : -DBL_MAX;
 }
 
 //! Determines the x coordinate of the nearest point above x.
 double ExplicitPointSet::getNearestXAbove( const double x ) const {
-    double closestX = DBL_MAX;
-    for( DataPointConstIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
-        double currX = ( *pointsIter )->getX();
-        if( ( currX > x ) && currX < closestX ){
-            closestX = currX;
-        }
-    }
-    return closestX;
+    vector<double>::const_iterator above = upper_bound( mSortedX.begin(), mSortedX.end(), x );
+    return above != mSortedX.end() ? *above : DBL_MAX;
 }
 
 //! Determines the y coordinate of the nearest point below y.
@@ -359,32 +350,70 @@ void ExplicitPointSet::invertAxises(){
     for( DataPointIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
         ( *pointsIter )->invertAxises();
     }
+    updateSortedPoints();
 }
 
 //! Const helper function which returns the point with a given x value.
 const DataPoint* ExplicitPointSet::findX( const double xValue ) const {
-    DataPoint* retValue = 0;
-    for( DataPointConstIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
-        if( util::isEqual( xValue, ( *pointsIter )->getX() ) ){
-            retValue = *pointsIter;
-            break;
-        }
-    }
-    return retValue;
+    const int sortedPos = findSortedX( xValue );
+    return sortedPos != -1 ? points[ mSortedIndex[ sortedPos ] ] : 0;
 }
 
 //! Non-Const helper function which returns the point with a given x value.
 DataPoint* ExplicitPointSet::findX( const double xValue ) {
-    DataPoint* retValue = 0;
-    for( DataPointIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
-        if( util::isEqual( xValue, ( *pointsIter )->getX() ) ){
-            retValue = *pointsIter;
-            break;
+    const int sortedPos = findSortedX( xValue );
+    return sortedPos != -1 ? points[ mSortedIndex[ sortedPos ] ] : 0;
+}
+
+/*!
+ * \brief Find the position in the sorted points of the point with a given x
+ *        value.
+ * \details The x values are compared with util::isEqual and if more than one
+ *          point matches the one which was added first is returned, the same
+ *          as a search through the points in order would find.
+ * \param xValue The x value to find.
+ * \return The position in mSortedX of the point or -1 if there is none.
+ */
+int ExplicitPointSet::findSortedX( const double xValue ) const {
+    // Only points within a small window around xValue can match.  The window
+    // is made wider than the tolerance of isEqual so that rounding in the
+    // bounds can not exclude a match.
+    const double window = 2 * 1E-10;
+    int retValue = -1;
+    for( vector<double>::const_iterator iter = lower_bound( mSortedX.begin(), mSortedX.end(), xValue - window );
+         iter != mSortedX.end() && *iter <= xValue + window; ++iter )
+    {
+        const int sortedPos = static_cast<int>( iter - mSortedX.begin() );
+        if( util::isEqual( xValue, *iter ) &&
+            ( retValue == -1 || mSortedIndex[ sortedPos ] < mSortedIndex[ retValue ] ) )
+        {
+            retValue = sortedPos;
         }
     }
     return retValue;
 }
 
+/*!
+ * \brief Rebuild the points sorted by x.
+ * \details This must be called whenever a point is added, removed or changed.
+ */
+void ExplicitPointSet::updateSortedPoints() {
+    mSortedIndex.resize( points.size() );
+    for( unsigned int i = 0; i < points.size(); ++i ){
+        mSortedIndex[ i ] = i;
+    }
+    stable_sort( mSortedIndex.begin(), mSortedIndex.end(),
+                 [this]( const unsigned int aLHS, const unsigned int aRHS ) {
+                     return points[ aLHS ]->getX() < points[ aRHS ]->getX();
+                 } );
+    mSortedX.resize( points.size() );
+    mSortedY.resize( points.size() );
+    for( size_t i = 0; i < mSortedIndex.size(); ++i ){
+        mSortedX[ i ] = points[ mSortedIndex[ i ] ]->getX();
+        mSortedY[ i ] = points[ mSortedIndex[ i ] ]->getY();
+    }
+}
+
 //! Const helper function which returns the point with a given y value.
 const DataPoint* ExplicitPointSet::findY( const double yValue ) const {
     DataPoint* retValue = 0;
@@ -33,6 +33,7 @@
 #include "util/curves/include/spline.hpp"
 #include "util/logger/include/ilogger.h"
 #include <stdlib.h>
+#include <algorithm>
 
 
 
@@ -137,6 +138,41 @@ void Spline::fit_internal(std::vector<double> &u)
         ypp[i] = ypp[i]*ypp[i+1]+u[i];
     }
 
+    compute_coefficients();
+}
+
+/*!
+ * \brief Convert the second derivatives into a polynomial for each segment
+ * \details In terms of t = x - x[i] the spline on segment i is
+ *          y[i] + c1[i]*t + c2[i]*t^2 + c3[i]*t^3.  The x values must be
+ *          strictly ascending, which we check here once rather than on
+ *          every evaluation.  (The fit itself is not meaningful
+ *          otherwise.)
+ */
+void Spline::compute_coefficients()
+{
+    int nseg = x.size()-1;
+    c1.resize(nseg);
+    c2.resize(nseg);
+    c3.resize(nseg);
+    for(int i=0; i<nseg; ++i) {
+        double dx = x[i+1]-x[i];
+        if(dx <= 0.0)
+            log_and_abort("x values must be strictly ascending.");
+        c1[i] = (y[i+1]-y[i])/dx - dx*(2.0*ypp[i] + ypp[i+1])/6.0;
+        c2[i] = 0.5*ypp[i];
+        c3[i] = (ypp[i+1]-ypp[i])/(6.0*dx);
+    }
+}
+
+/*!
+ * \brief Find the segment i such that x[i] <= ax < x[i+1]
+ * \details The last point of the table belongs to the last segment.
+ */
+int Spline::find_segment(double ax) const
+{
+    // only the interior points need to be searched
+    return std::upper_bound(x.begin()+1, x.end()-1, ax) - x.begin() - 1;
 }
 
 
@@ -153,31 +189,32 @@ double Spline::interpolate(double ax) const
     if(ax < x[0] || ax > x[n-1])
         log_and_abort("x-value out of range!");
 
-    int ilo = 0;
-    int ihi = n-1;
-
-    // bisection search
-    while(ihi-ilo > 1) {
-        int i = (ihi+ilo)/2;
+    return eval_segment(find_segment(ax), ax);
+}
 
-        if(x[i] > ax)
-            ihi = i;
-        else
-            ilo = i;
+/*!
+ * \brief Evaluate a spline interpolation at a vector of x values
+ * \details The same restrictions apply as for a single value.  The
+ *          segment of each value is checked first against the segment
+ *          of the previous value, so a sorted (or mostly sorted) list
+ *          of x values mostly avoids the search.
+ * \param ax The x values.
+ * \param ay Vector to hold the interpolated y values, resized to match ax.
+ */
+void Spline::interpolate(const std::vector<double> &ax, std::vector<double> &ay) const
+{
+    int n = x.size();
+    ay.resize(ax.size());
+    int iseg = 0;
+    for(size_t j=0; j<ax.size(); ++j) {
+        double xj = ax[j];
+        if(xj < x[0] || xj > x[n-1])
+            log_and_abort("x-value out of range!");
+
+        if(xj < x[iseg] || (xj >= x[iseg+1] && iseg < n-2))
+            iseg = find_segment(xj);
+        ay[j] = eval_segment(iseg, xj);
     }
-
-    double dx = x[ihi]-x[ilo];
-    if(dx <= 0.0)
-        log_and_abort("x values must be strictly ascending.");
-    double dxi = 1.0/dx;
-
-    double a = (x[ihi]-ax)*dxi;
-    double b = (ax-x[ilo])*dxi;
-
-    double val = a*y[ilo]+b*y[ihi] + // this is the linear interpolation term
-        ((a*a*a-a)*ypp[ilo] + (b*b*b-b)*ypp[ihi])*dx*dx/6.0; // second derivative correction
-
-    return val;
 }
 
 /*!
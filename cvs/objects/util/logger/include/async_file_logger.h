@@ -0,0 +1,156 @@
+#ifndef _ASYNC_FILE_LOGGER_H_
+#define _ASYNC_FILE_LOGGER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file async_file_logger.h
+* \ingroup Objects
+* \brief The AsyncFileLogger class header file.
+*/
+
+#include <string>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "util/logger/include/logger.h"
+
+#ifndef USE_ZLIB
+#define USE_ZLIB 0
+#endif
+
+#if USE_ZLIB
+#include <zlib.h>
+#endif
+
+/*! 
+* \ingroup Objects
+* \brief A Logger which writes plain text messages from a background thread.
+* \details This Logger is intended for very verbose logs such as the solver
+*          logs. Messages are formatted exactly as the PlainTextLogger would
+*          format them but are only appended to a pending buffer by the thread
+*          writing the message. A background thread writes the pending buffer
+*          to the file in large blocks, optionally gzip compressing it, so
+*          that the model does not wait on file IO.
+*
+*          The following elements may be given in addition to those read by all
+*          Loggers:
+*          - compression: "gzip" to compress the log, which requires GCAM to be
+*            built with USE_ZLIB, or "none" (the default).
+*          - maxFileSize: Size in megabytes of the (uncompressed) log at which
+*            it is rotated. Zero, the default, disables rotation.
+*          - maxFiles: The number of rotated logs to keep, named FileName.1 up
+*            to FileName.maxFiles with 1 the most recent.
+*
+* \warning Since AsyncFileLoggers can only be created by the LoggerFactory, public functions not in the Logger interface will be unusable.
+*/
+
+class AsyncFileLogger: public Logger {
+    friend class LoggerFactory;
+public:
+    virtual ~AsyncFileLogger();
+    void open( const char[] = 0 );
+    void close();
+    void logCompleteMessage( const std::string& aMessage );
+    virtual void beforeFork();
+    virtual void afterFork( const std::string& aChildName );
+protected:
+    virtual bool XMLDerivedClassParse( const std::string& aNodeName, const xercesc::DOMNode* aNode );
+private:
+    //! The amount of pending data at which the writer thread is woken up.
+    static const size_t FLUSH_SIZE = 256 * 1024;
+
+    //! The amount of pending data at which messages wait for the writer thread.
+    static const size_t MAX_PENDING_SIZE = 64 * 1024 * 1024;
+
+    //! Whether to gzip compress the log.
+    bool mCompress;
+
+    //! Size in bytes at which to rotate the log, or zero to never rotate.
+    size_t mMaxFileSize;
+
+    //! The number of rotated logs to keep.
+    int mMaxFiles;
+
+    //! The open log file if it is not compressed.
+    FILE* mLogFile;
+
+#if USE_ZLIB
+    //! The open log file if it is compressed.
+    gzFile mCompressedLogFile;
+#endif
+
+    //! The number of uncompressed bytes written to the current file.
+    size_t mBytesWritten;
+
+    //! Messages waiting to be written.
+    std::string mPending;
+
+    //! Whether the logger is closing and the writer thread should exit.
+    bool mIsClosing;
+
+    //! Protects mPending and mIsClosing.
+    std::mutex mMutex;
+
+    //! Signals that there is data to write or that the logger is closing.
+    std::condition_variable mHasData;
+
+    //! Signals that the writer thread has taken the pending data.
+    std::condition_variable mHasSpace;
+
+    //! The thread writing to the file.
+    std::thread mThread;
+
+    AsyncFileLogger( const std::string& aLoggerName = "" );
+
+    void openFile();
+
+    void startWriter();
+
+    void stopWriter();
+
+    void closeFile();
+
+    void rotate();
+
+    void writeToFile( const std::string& aData );
+
+    void run();
+};
+
+#endif // _ASYNC_FILE_LOGGER_H_
@@ -77,7 +77,62 @@ public:
     virtual WarningLevel setLevel( const WarningLevel newLevel ) = 0;
     virtual bool wouldPrint(ILogger::WarningLevel aLevel) const =0;
     static ILogger& getLogger( const std::string& aLoggerName );
+
+    //! Set the warning level and return the logger so that it can be written to.
+    ILogger& withLevel( const WarningLevel aLevel ) {
+        setLevel( aLevel );
+        return *this;
+    }
 };
 
+/*!
+ * \brief The lowest warning level of log messages written with GCAM_LOG which
+ *        are compiled in.
+ * \details Messages below this level are removed by the compiler. This
+ *          defaults to DEBUG (0) so that no messages are removed.
+ */
+#ifndef GCAM_LOG_MIN_LEVEL
+#define GCAM_LOG_MIN_LEVEL 0
+#endif
+
+/*!
+ * \brief The lowest warning level of solver log messages written with
+ *        GCAM_SOLVER_LOG which are compiled in.
+ * \details The solvers write a great deal of debugging output from their inner
+ *          loops, so this may be raised separately, for instance to NOTICE (1)
+ *          to remove all of the solver debugging output from a release build.
+ */
+#ifndef GCAM_SOLVER_LOG_MIN_LEVEL
+#define GCAM_SOLVER_LOG_MIN_LEVEL GCAM_LOG_MIN_LEVEL
+#endif
+
+/*!
+ * \brief Whether a message at the given level to the given logger would be
+ *        printed, taking into account the compiled in minimum level.
+ */
+#define GCAM_LOG_ENABLED_MIN( aMinLevel, aLogger, aLevel ) \
+    ( ( aLevel ) >= ( aMinLevel ) && ( aLogger ).wouldPrint( aLevel ) )
+
+#define GCAM_LOG_ENABLED( aLogger, aLevel ) GCAM_LOG_ENABLED_MIN( GCAM_LOG_MIN_LEVEL, aLogger, aLevel )
+
+#define GCAM_SOLVER_LOG_ENABLED( aLogger, aLevel ) GCAM_LOG_ENABLED_MIN( GCAM_SOLVER_LOG_MIN_LEVEL, aLogger, aLevel )
+
+/*!
+ * \brief Write a message to a logger at the given level.
+ * \details This sets the warning level of the logger and evaluates to the
+ *          logger, so it is used like the logger itself:
+ *          GCAM_LOG( mainLog, ILogger::DEBUG ) << "x= " << x << endl;
+ *          Unlike writing to the logger directly, the values being written
+ *          are not evaluated or formatted at all unless the message would be
+ *          printed. Note that the level of the logger is then left unchanged.
+ */
+#define GCAM_LOG_MIN( aMinLevel, aLogger, aLevel ) \
+    if( !GCAM_LOG_ENABLED_MIN( aMinLevel, aLogger, aLevel ) ) {} \
+    else ( aLogger ).withLevel( aLevel )
+
+#define GCAM_LOG( aLogger, aLevel ) GCAM_LOG_MIN( GCAM_LOG_MIN_LEVEL, aLogger, aLevel )
+
+#define GCAM_SOLVER_LOG( aLogger, aLevel ) GCAM_LOG_MIN( GCAM_SOLVER_LOG_MIN_LEVEL, aLogger, aLevel )
+
 #endif // _ILOGGER_H_
 
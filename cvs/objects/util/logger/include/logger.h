@@ -54,6 +54,7 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/spin_mutex.h>
+#include <tbb/enumerable_thread_specific.h>
 #endif
 
 // Forward definition of the Logger class.
@@ -65,7 +66,8 @@ class Tabs;
 * \brief This is an overridden streambuffer class used by the Logger class.
 * 
 * This is a very simple class which contains a pointer to its parent Logger.
-* When the streambuf receives a character it passes it to its parent stream for processing.
+* When the streambuf receives a character or a block of characters it passes
+* them to its parent stream for processing.
 *
 * \author Josh Lurz
 * \warning Overriding the iostream class is somewhat difficult so this class may be somewhat esoteric.
@@ -78,6 +80,7 @@ class PassToParentStreamBuf: std::streambuf {
 public:
     PassToParentStreamBuf();
     int overflow( int ch );
+    std::streamsize xsputn( const char* aData, std::streamsize aCount );
     int underflow( int ch );
     void setParent( Logger* parentIn );
     void toDebugXML( std::ostream& out ) const;
@@ -112,7 +115,22 @@ public:
     virtual ~Logger(); //!< Virtual destructor.
     virtual void open( const char[] = 0 ) = 0; //!< Pure virtual function called to begin logging.
     int receiveCharFromUnderStream( int ch ); //!< Pure virtual function called to complete the log and clean up.
+    void receiveFromUnderStream( const char* aData, std::streamsize aCount );
     virtual void close() = 0;
+
+    /*!
+     * \brief Prepare for the process to be forked.
+     * \details Loggers which use threads must stop them since threads
+     *          are not copied into the child process.
+     */
+    virtual void beforeFork() {}
+
+    /*!
+     * \brief Resume logging after the process was forked.
+     * \param aChildName A name for the child process which may be used to
+     *        give it separate log files, or empty in the parent process.
+     */
+    virtual void afterFork( const std::string& aChildName ) {}
     ILogger::WarningLevel setLevel( const ILogger::WarningLevel newLevel );
     bool wouldPrint(ILogger::WarningLevel aLevel) const;
     void toDebugXML( std::ostream& out, Tabs* tabs ) const;
@@ -141,6 +159,16 @@ protected:
 	//! Defines whether to print the warning level.
     bool mPrintLogWarningLevel;
     Logger( const std::string& aFileName = "" );
+
+    /*!
+     * \brief Parse an XML element specific to a derived logger.
+     * \param aNodeName The name of the element.
+     * \param aNode The element to parse.
+     * \return Whether the element was recognized.
+     */
+    virtual bool XMLDerivedClassParse( const std::string& aNodeName, const xercesc::DOMNode* aNode ) {
+        return false;
+    }
     
 	//! Log a message with the given warning level.
     virtual void logCompleteMessage( const std::string& aMessage ) = 0;
@@ -148,16 +176,24 @@ protected:
     static void parseHeader( std::string& aHeader );
     static const std::string& convertLevelToString( ILogger::WarningLevel aLevel );
 private:
-	 //! Buffer which contains characters waiting to be printed.
-    std::stringstream mBuf;
 #if GCAM_PARALLEL_ENABLED
-    tbb::spin_mutex mMutex;  //<! mutex protecting mBuf
+    //! Buffer for each thread which contains the part of the current line
+    //! received so far, so that threads do not need to lock for each character
+    //! or mix their lines together.
+    tbb::enumerable_thread_specific<std::string> mBuf;
+
+    tbb::spin_mutex mMutex;  //<! mutex protecting the output of complete lines
+#else
+	 //! Buffer which contains characters waiting to be printed.
+    std::string mBuf;
 #endif
 
 	 //! Underlying ofstream
     PassToParentStreamBuf mUnderStream;
 
     void XMLParse( const xercesc::DOMNode* node );
+    void updateStreamState();
+    void completeLine( const std::string& aLine );
     static const std::string getTimeString();
     static const std::string getDateString();
 };
@@ -69,10 +69,12 @@ public:
     static Logger& getLogger( const std::string& aLogName );
     static void toDebugXML( std::ostream& aOut, Tabs* aTabs );
     static void logNewScenarioStarting( const std::string& aScenarioName );
+    static void beforeFork();
+    static void afterFork( const std::string& aChildName );
+    static void cleanUp();
 private:
     static std::map<std::string,Logger*> mLoggers; //!< Map of logger names to loggers.
     static void XMLParse( const xercesc::DOMNode* aRoot );
-    static void cleanUp();
     //! Private undefined constructor to prevent creating a LoggerFactory.
     LoggerFactory();
     //! Private undefined copy constructor to prevent  copying a LoggerFactory.
@@ -0,0 +1,311 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+* \file async_file_logger.cpp
+* \ingroup Objects
+* \brief AsyncFileLogger class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <xercesc/dom/DOMNode.hpp>
+#include "util/logger/include/async_file_logger.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+using namespace xercesc;
+
+//! Constructor
+AsyncFileLogger::AsyncFileLogger( const string& aLoggerName ):Logger( aLoggerName ),
+mCompress( false ),
+mMaxFileSize( 0 ),
+mMaxFiles( 0 ),
+mLogFile( 0 ),
+#if USE_ZLIB
+mCompressedLogFile( 0 ),
+#endif
+mBytesWritten( 0 ),
+mIsClosing( false )
+{
+}
+
+//! Destructor
+AsyncFileLogger::~AsyncFileLogger(){
+    close();
+}
+
+bool AsyncFileLogger::XMLDerivedClassParse( const string& aNodeName, const DOMNode* aNode ){
+    if( aNodeName == "compression" ){
+        const string compression = XMLHelper<string>::getValue( aNode );
+        mCompress = compression == "gzip";
+        if( !mCompress && compression != "none" ){
+            cout << "Unknown log compression " << compression << ", the log will not be compressed." << endl;
+        }
+    }
+    else if( aNodeName == "maxFileSize" ){
+        mMaxFileSize = static_cast<size_t>( XMLHelper<double>::getValue( aNode ) * 1024 * 1024 );
+    }
+    else if( aNodeName == "maxFiles" ){
+        mMaxFiles = XMLHelper<int>::getValue( aNode );
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+//! Tells the logger to begin logging.
+void AsyncFileLogger::open( const char[] ){
+    if( mFileName.empty() ) { // set a default value
+        cout << "Using default log file name." << endl;
+        mFileName = "log.txt";
+    }
+
+#if !USE_ZLIB
+    if( mCompress ){
+        cout << "GCAM was built without USE_ZLIB, " << mFileName << " will not be compressed." << endl;
+        mCompress = false;
+    }
+#endif
+    const string gzExtension = ".gz";
+    if( mCompress && ( mFileName.size() < gzExtension.size() ||
+        mFileName.compare( mFileName.size() - gzExtension.size(), gzExtension.size(), gzExtension ) != 0 ) )
+    {
+        mFileName += ".gz";
+    }
+
+    openFile();
+
+    // Print the header message
+    if( !mHeaderMessage.empty() ){
+        parseHeader( mHeaderMessage );
+        writeToFile( mHeaderMessage + "\n\n" );
+    }
+
+    startWriter();
+}
+
+//! Tells the logger to finish logging, waiting for all messages to be written.
+void AsyncFileLogger::close(){
+    stopWriter();
+    closeFile();
+}
+
+/*!
+ * \brief Stop the writer thread so that the process may be forked.
+ * \details All pending messages are written first. Messages logged until
+ *          afterFork is called are kept pending.
+ */
+void AsyncFileLogger::beforeFork(){
+    stopWriter();
+}
+
+/*!
+ * \brief Restart the writer thread after a fork.
+ * \details The child process writes to a log of its own, named by appending
+ *          the given child name to the file name, so that it does not write
+ *          into the log of the parent. The file handles inherited from the
+ *          parent are abandoned rather than closed so that nothing buffered
+ *          in them is written twice.
+ * \param aChildName The name of the child process, or empty in the parent.
+ */
+void AsyncFileLogger::afterFork( const string& aChildName ){
+    if( !aChildName.empty() ){
+        mLogFile = 0;
+#if USE_ZLIB
+        mCompressedLogFile = 0;
+#endif
+        const string gzExtension = ".gz";
+        const bool hasGzExtension = mCompress && mFileName.size() >= gzExtension.size();
+        if( hasGzExtension ){
+            mFileName.erase( mFileName.size() - gzExtension.size() );
+        }
+        mFileName += "." + aChildName;
+        if( hasGzExtension ){
+            mFileName += gzExtension;
+        }
+        openFile();
+    }
+    startWriter();
+}
+
+//! Queues a single message to be written.
+void AsyncFileLogger::logCompleteMessage( const string& aMessage ){
+    // Decide whether to print the message
+    if ( mCurrentWarningLevel >= mMinLogWarningLevel ){
+        unique_lock<mutex> lock( mMutex );
+        // Don't let the pending messages grow without bound if the writer
+        // can not keep up.
+        if( mThread.joinable() ){
+            mHasSpace.wait( lock, [this]{ return mPending.size() < MAX_PENDING_SIZE || mIsClosing; } );
+        }
+
+        // Print the warning level
+        if ( mPrintLogWarningLevel || mCurrentWarningLevel >= ILogger::ERROR ) {
+            mPending += convertLevelToString( mCurrentWarningLevel );
+            mPending += ':';
+        }
+        mPending += aMessage;
+        mPending += '\n';
+
+        if( mPending.size() >= FLUSH_SIZE ){
+            mHasData.notify_one();
+        }
+    }
+}
+
+//! Open the log file, replacing any existing file.
+void AsyncFileLogger::openFile(){
+    mBytesWritten = 0;
+#if USE_ZLIB
+    if( mCompress ){
+        mCompressedLogFile = gzopen( mFileName.c_str(), "wb" );
+        if( !mCompressedLogFile ){
+            cout << "Could not open log file " << mFileName << endl;
+        }
+        return;
+    }
+#endif
+    mLogFile = fopen( mFileName.c_str(), "wb" );
+    if( !mLogFile ){
+        cout << "Could not open log file " << mFileName << endl;
+    }
+}
+
+//! Close the log file if it is open.
+void AsyncFileLogger::closeFile(){
+#if USE_ZLIB
+    if( mCompressedLogFile ){
+        gzclose( mCompressedLogFile );
+        mCompressedLogFile = 0;
+    }
+#endif
+    if( mLogFile ){
+        fclose( mLogFile );
+        mLogFile = 0;
+    }
+}
+
+/*!
+ * \brief Start a new log file, keeping up to mMaxFiles previous files.
+ * \details The previous files are named by appending .1 (the most recent)
+ *          through .mMaxFiles to the file name.
+ */
+void AsyncFileLogger::rotate(){
+    closeFile();
+    const string& fileName = mFileName;
+    if( mMaxFiles > 0 ){
+        std::remove( ( fileName + "." + util::toString( mMaxFiles ) ).c_str() );
+        for( int i = mMaxFiles - 1; i > 0; --i ){
+            std::rename( ( fileName + "." + util::toString( i ) ).c_str(),
+                         ( fileName + "." + util::toString( i + 1 ) ).c_str() );
+        }
+        std::rename( fileName.c_str(), ( fileName + ".1" ).c_str() );
+    }
+    openFile();
+}
+
+/*!
+ * \brief Write a block of complete messages to the log file.
+ * \details The file is rotated first if the block would take it over the
+ *          maximum size.
+ * \param aData The data to write.
+ */
+void AsyncFileLogger::writeToFile( const string& aData ){
+    if( mMaxFileSize > 0 && mBytesWritten > 0 && mBytesWritten + aData.size() > mMaxFileSize ){
+        rotate();
+    }
+    mBytesWritten += aData.size();
+#if USE_ZLIB
+    if( mCompressedLogFile ){
+        gzwrite( mCompressedLogFile, aData.data(), static_cast<unsigned int>( aData.size() ) );
+        return;
+    }
+#endif
+    if( mLogFile ){
+        fwrite( aData.data(), 1, aData.size(), mLogFile );
+        fflush( mLogFile );
+    }
+}
+
+//! Start the writer thread.
+void AsyncFileLogger::startWriter(){
+    mIsClosing = false;
+    mThread = thread( &AsyncFileLogger::run, this );
+}
+
+//! Stop the writer thread, waiting for it to write all pending messages.
+void AsyncFileLogger::stopWriter(){
+    if( mThread.joinable() ){
+        {
+            lock_guard<mutex> lock( mMutex );
+            mIsClosing = true;
+        }
+        mHasData.notify_one();
+        mThread.join();
+    }
+}
+
+/*!
+ * \brief The loop run by the writer thread.
+ * \details The thread waits until enough data has accumulated (or a short time
+ *          has passed) then takes all of the pending data and writes it
+ *          without holding the lock.
+ */
+void AsyncFileLogger::run(){
+    string data;
+    unique_lock<mutex> lock( mMutex );
+    while( true ){
+        mHasData.wait_for( lock, chrono::seconds( 1 ),
+                           [this]{ return mIsClosing || mPending.size() >= FLUSH_SIZE; } );
+        if( mPending.empty() ){
+            if( mIsClosing ){
+                break;
+            }
+            continue;
+        }
+        data.swap( mPending );
+        mHasSpace.notify_all();
+        lock.unlock();
+
+        writeToFile( data );
+        data.clear();
+
+        lock.lock();
+    }
+}
@@ -46,6 +46,7 @@
 #include <sstream>
 #include <cassert>
 #include <ctime>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/logger/include/logger.h"
@@ -66,6 +67,14 @@ int PassToParentStreamBuf::overflow( int aChar ){
 	return mParent->receiveCharFromUnderStream( aChar );
 }
 
+//! Overriding xsputn function which passes a block of characters to its parent.
+streamsize PassToParentStreamBuf::xsputn( const char* aData, streamsize aCount ){
+	/*! \pre Make sure the parent is not null. */
+	assert( mParent );
+	mParent->receiveFromUnderStream( aData, aCount );
+	return aCount;
+}
+
 //! Overriding underflow function which should not be reached because this is a write-only stream.
 int PassToParentStreamBuf::underflow( int aChar ){
 	/*! \pre This function should never be called. */
@@ -103,9 +112,24 @@ ILogger::WarningLevel Logger::setLevel( const ILogger::WarningLevel aLevel ){
     // doesn't actually solve the race condition.
     ILogger::WarningLevel oldLevel = mCurrentWarningLevel;
     mCurrentWarningLevel = aLevel;
+    updateStreamState();
     return oldLevel;
 }
 
+/*! \brief Enable or disable the stream for the current warning level.
+ *  \details When messages at the current warning level would not be printed
+ *           the stream is put in a failed state so that values written to it
+ *           are not even formatted.
+ */
+void Logger::updateStreamState() {
+    if( wouldPrint( mCurrentWarningLevel ) ) {
+        clear();
+    }
+    else {
+        setstate( ios_base::badbit );
+    }
+}
+
 /*! \brief Test whether the logger will produce output at a specified logging level
  *  \details This function allows us to skip preparing expensive
  *           logging output if we know it won't even be printed.
@@ -117,29 +141,51 @@ bool Logger::wouldPrint(ILogger::WarningLevel aLevel) const
 
 //! Receive a single character from the underlying stream and buffer it, printing the buffer it is a newline.
 int Logger::receiveCharFromUnderStream( int ch ) {
-    // Only receive the character or print to the screen if it needed.
-    if( mCurrentWarningLevel >= mMinLogWarningLevel || mCurrentWarningLevel >= mMinToScreenWarningLevel ){
-        // only really need to lock the mutex if we're going to do something.
+    const char c = static_cast<char>( ch );
+    receiveFromUnderStream( &c, 1 );
+    return ch;
+}
+
+/*! \brief Receive a block of characters from the underlying stream.
+ *  \details The characters are buffered for the calling thread and each time
+ *           a newline is reached the buffered line is printed.
+ *  \param aData The characters.
+ *  \param aCount The number of characters.
+ */
+void Logger::receiveFromUnderStream( const char* aData, streamsize aCount ) {
+    // Only receive the characters or print to the screen if it needed.
+    if( !wouldPrint( mCurrentWarningLevel ) ){
+        return;
+    }
 #if GCAM_PARALLEL_ENABLED
-        tbb::spin_mutex::scoped_lock lck( mMutex );
+    string& buffer = mBuf.local();
+#else
+    string& buffer = mBuf;
 #endif
-        if( ch == '\n' ){
-            string tempString( mBuf.str() );
-            logCompleteMessage( tempString );
-            printToScreenIfConfigured( tempString );
-
-            // reset the stringstream buffer
-            mBuf.clear();       // Clear error flags, if any.
-            mBuf.str(std::string()); // clear out the data in the buffer.
-       }
-        else {
-            // The functions that perform the output will add the
-            // newline, so we only want to insert non-newline
-            // characters.
-            mBuf << ( char )ch;
+    const char* end = aData + aCount;
+    while( aData != end ){
+        // The functions that perform the output will add the
+        // newline, so we only want to insert non-newline
+        // characters.
+        const char* newline = find( aData, end, '\n' );
+        buffer.append( aData, newline );
+        if( newline == end ){
+            break;
         }
+        completeLine( buffer );
+        buffer.clear();
+        aData = newline + 1;
     }
-    return ch;
+}
+
+//! Print a complete line to the log and the screen.
+void Logger::completeLine( const string& aLine ) {
+    // only really need to lock the mutex if we're going to do something.
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lck( mMutex );
+#endif
+    logCompleteMessage( aLine );
+    printToScreenIfConfigured( aLine );
 }
 
 //! Print the message to the screen if the Logger is configured to.
@@ -184,7 +230,11 @@ void Logger::XMLParse( const DOMNode* aNode ){
 		else if ( nodeName == "headerMessage" ) {
 			mHeaderMessage = XMLHelper<string>::getValue( curr );
 		}
+		else {
+			XMLDerivedClassParse( nodeName, curr );
+		}
 	}
+	updateStreamState();
 }
 
 void Logger::toDebugXML( ostream& out, Tabs* tabs ) const {
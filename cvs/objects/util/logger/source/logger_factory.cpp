@@ -53,6 +53,7 @@
 // Logger subclass headers.
 #include "util/logger/include/plain_text_logger.h"
 #include "util/logger/include/xml_logger.h"
+#include "util/logger/include/async_file_logger.h"
 
 using namespace std;
 using namespace xercesc;
@@ -84,6 +85,9 @@ void LoggerFactory::XMLParse( const DOMNode* aRoot ){
 			else if( loggerType == "XMLLogger" ){
 				newLogger = new XMLLogger();
 			}
+			else if( loggerType == "AsyncFileLogger" ){
+				newLogger = new AsyncFileLogger();
+			}
 			else {
                 cerr << "Unknown Logger Type: " << loggerType << endl;
                 return;
@@ -117,12 +121,17 @@ Logger& LoggerFactory::getLogger( const string& aLoggerName ) {
 	}
 }
 
-//! Cleans up the logger.
+/*!
+ * \brief Cleans up the loggers.
+ * \details This is called by the LoggerFactoryWrapper at the end of the model,
+ *          and otherwise only by processes about to exit.
+ */
 void LoggerFactory::cleanUp() {
 	for( map<string,Logger*>::iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); logIter++ ){
 		logIter->second->close();
 		delete logIter->second;
 	}
+    mLoggers.clear();
 }
 
 /*! \brief Writes out the LoggerFactory to an XML file. 
@@ -152,3 +161,26 @@ void LoggerFactory::logNewScenarioStarting( const string& aScenarioName ) {
     }
 }
 
+
+/*!
+ * \brief Prepare all loggers for the process to be forked.
+ * \details This must be called immediately before forking, and afterFork
+ *          must be called in both processes once the fork is complete.
+ */
+void LoggerFactory::beforeFork() {
+    cout.flush();
+	for( map<string,Logger*>::const_iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+        logIter->second->beforeFork();
+    }
+}
+
+/*!
+ * \brief Resume logging in all loggers after the process was forked.
+ * \param aChildName A name for the child process used to give it separate log
+ *        files where necessary, or empty in the parent process.
+ */
+void LoggerFactory::afterFork( const string& aChildName ) {
+	for( map<string,Logger*>::const_iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+        logIter->second->afterFork( aChildName );
+    }
+}
@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+"""End-to-end performance regression harness for GCAM.
+
+Runs each configuration of a suite with the model's performance report
+enabled, collects the wall time, model evaluations, solver iterations and
+peak resident set size of each phase of the run (reading the inputs,
+completeInit, each period and its solve, writing the output), compares them
+against stored baselines and writes a JSON report of the results.
+
+The exit status is 0 if every run finished and no metric regressed beyond its
+threshold, 1 if a metric regressed and 2 if a run failed.
+
+See README.md for the format of the suite, baseline and report files.
+"""
+
+import argparse
+import csv
+import datetime
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+import xml.etree.ElementTree as ElementTree
+
+REPORT_SCHEMA_VERSION = 1
+
+# The metrics of each phase and of the run as a whole.
+METRICS = ("seconds", "model-evals", "solver-iterations", "peak-rss-kb")
+
+DEFAULT_THRESHOLDS = {
+    "seconds": 0.10,
+    "model-evals": 0.02,
+    "solver-iterations": 0.02,
+    "peak-rss-kb": 0.10,
+}
+
+# Increases smaller than these are never regressions, so that the timing of
+# short phases does not raise false alarms.
+DEFAULT_FLOORS = {
+    "seconds": 1.0,
+    "model-evals": 0,
+    "solver-iterations": 0,
+    "peak-rss-kb": 16384,
+}
+
+
+def set_config_value(root, section, name, value, attributes=None):
+    """Set a value in a section of a GCAM configuration, adding it if needed."""
+    section_node = root.find(section)
+    if section_node is None:
+        section_node = ElementTree.SubElement(root, section)
+    for node in section_node.findall("Value"):
+        if node.get("name") == name:
+            break
+    else:
+        node = ElementTree.SubElement(section_node, "Value", {"name": name})
+    node.text = str(value)
+    for attribute, attribute_value in (attributes or {}).items():
+        node.set(attribute, attribute_value)
+
+
+def write_run_configuration(exe_dir, run, report_path):
+    """Write the configuration of a run with the performance report enabled.
+
+    The configuration is written next to the original in the exe directory
+    since the paths in it are relative to the directory the model runs in.
+    """
+    tree = ElementTree.parse(os.path.join(exe_dir, run["configuration"]))
+    root = tree.getroot()
+    for section, values in run.get("overrides", {}).items():
+        for name, value in values.items():
+            set_config_value(root, section, name, value)
+    set_config_value(root, "Bools", "log-performance-report", 1)
+    # Files are only written if flagged to be and the harness needs the name
+    # unchanged.
+    set_config_value(root, "Files", "performanceReportFileName", report_path,
+                     {"write-output": "1", "append-scenario-name": "0"})
+    path = os.path.join(exe_dir, "perf-harness-" + run["name"] + ".xml")
+    tree.write(path, encoding="UTF-8", xml_declaration=True)
+    return path
+
+
+def run_model(gcam, exe_dir, config_path, log_path):
+    """Run the model and return its exit code, wall time and peak RSS in KB."""
+    start = time.monotonic()
+    with open(log_path, "w") as log:
+        process = subprocess.Popen([gcam, "-C", os.path.basename(config_path)],
+                                   cwd=exe_dir, stdout=log, stderr=subprocess.STDOUT)
+        peak_rss_kb = 0
+        if hasattr(os, "wait4"):
+            _, status, usage = os.wait4(process.pid, 0)
+            process.returncode = os.waitstatus_to_exitcode(status) \
+                if hasattr(os, "waitstatus_to_exitcode") else status >> 8
+            # ru_maxrss is in bytes on macOS and kilobytes elsewhere.
+            peak_rss_kb = usage.ru_maxrss // 1024 if sys.platform == "darwin" else usage.ru_maxrss
+        else:
+            process.wait()
+    return process.returncode, time.monotonic() - start, peak_rss_kb
+
+
+def read_performance_report(path):
+    """Read the phases from the performance report written by the model.
+
+    Phases for a period are named like "solve-3".  Batch runs write a row per
+    scenario, in which case the phases of every scenario are summed.
+    """
+    phases = {}
+    if not os.path.exists(path):
+        return phases
+    with open(path, newline="") as report:
+        for row in csv.DictReader(report):
+            name = row["phase"]
+            if int(row["period"]) >= 0:
+                name += "-" + row["period"]
+            phase = phases.setdefault(name, dict.fromkeys(METRICS, 0))
+            phase["seconds"] += float(row["seconds"])
+            phase["model-evals"] += int(row["model-evals"])
+            phase["solver-iterations"] += int(row["solver-iterations"])
+            phase["peak-rss-kb"] = max(phase["peak-rss-kb"], int(row["peak-rss-kb"]))
+    return phases
+
+
+def summarize(phases, wall_seconds, peak_rss_kb):
+    """Compute the metrics of a whole run from its phases."""
+    periods = [phase for name, phase in phases.items() if name.startswith("period-")]
+    return {
+        "seconds": wall_seconds,
+        "model-evals": sum(phase["model-evals"] for phase in periods),
+        "solver-iterations": sum(phase["solver-iterations"] for phase in periods),
+        "peak-rss-kb": max([peak_rss_kb] + [phase["peak-rss-kb"] for phase in phases.values()]),
+    }
+
+
+def compare(metrics, baseline, thresholds, floors):
+    """Compare the metrics of a run with its baseline.
+
+    Returns a comparison for each metric of the run and of each phase present
+    in both, flagging those which increased by more than both the threshold
+    and the floor.
+    """
+    comparisons = []
+
+    def add(phase, current, base):
+        for metric in METRICS:
+            if metric not in current or metric not in base:
+                continue
+            value = current[metric]
+            base_value = base[metric]
+            increase = value - base_value
+            ratio = value / base_value if base_value else None
+            regression = increase > floors[metric] and increase > thresholds[metric] * base_value
+            comparisons.append({
+                "phase": phase,
+                "metric": metric,
+                "baseline": base_value,
+                "value": value,
+                "ratio": ratio,
+                "regression": regression,
+            })
+
+    add("total", metrics["total"], baseline["total"])
+    for name, phase in metrics["phases"].items():
+        if name in baseline["phases"]:
+            add(name, phase, baseline["phases"][name])
+    return comparisons
+
+
+def git_revision(path):
+    """Get the git revision of the model source, if it is available."""
+    try:
+        return subprocess.check_output(["git", "rev-parse", "HEAD"], cwd=path,
+                                       stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    repo = os.path.normpath(os.path.join(here, "..", ".."))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--suite", default=os.path.join(here, "perf_suite.json"),
+                        help="the suite of runs (default: %(default)s)")
+    parser.add_argument("--exe-dir", default=os.path.join(repo, "exe"),
+                        help="the directory the model is run in (default: %(default)s)")
+    parser.add_argument("--gcam", default=None,
+                        help="the model executable (default: gcam.exe in the exe directory)")
+    parser.add_argument("--baseline-dir", default=os.path.join(here, "baselines"),
+                        help="the directory of the baselines (default: %(default)s)")
+    parser.add_argument("--output", default=None,
+                        help="the JSON report to write (default: perf-report-<time>.json in the output directory)")
+    parser.add_argument("--runs", nargs="*", default=None,
+                        help="only run these runs of the suite")
+    parser.add_argument("--update-baselines", action="store_true",
+                        help="store the results as the new baselines")
+    args = parser.parse_args()
+
+    with open(args.suite) as suite_file:
+        suite = json.load(suite_file)
+    thresholds = dict(DEFAULT_THRESHOLDS, **suite.get("thresholds", {}))
+    floors = dict(DEFAULT_FLOORS, **suite.get("floors", {}))
+    exe_dir = os.path.abspath(args.exe_dir)
+    gcam = os.path.abspath(args.gcam) if args.gcam else os.path.join(exe_dir, "gcam.exe")
+    output_dir = os.path.join(repo, "output", "perf-harness")
+    os.makedirs(output_dir, exist_ok=True)
+    created = datetime.datetime.now(datetime.timezone.utc)
+    report_path = args.output or os.path.join(
+        output_dir, "perf-report-" + created.strftime("%Y%m%dT%H%M%SZ") + ".json")
+
+    report = {
+        "schema-version": REPORT_SCHEMA_VERSION,
+        "created": created.isoformat(),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "git-revision": git_revision(repo),
+        "suite": os.path.abspath(args.suite),
+        "thresholds": thresholds,
+        "floors": floors,
+        "runs": [],
+    }
+    any_failed = False
+    any_regressed = False
+    for run in suite["runs"]:
+        if args.runs is not None and run["name"] not in args.runs:
+            continue
+        if not os.path.exists(os.path.join(exe_dir, run["configuration"])):
+            if run.get("optional", False):
+                print("Skipping %s, %s does not exist." % (run["name"], run["configuration"]))
+                continue
+            print("Configuration %s of %s does not exist." % (run["configuration"], run["name"]))
+            any_failed = True
+            continue
+
+        print("Running %s with %s" % (run["name"], run["configuration"]))
+        performance_path = os.path.join(output_dir, run["name"] + "-performance.csv")
+        if os.path.exists(performance_path):
+            os.remove(performance_path)
+        config_path = write_run_configuration(exe_dir, run, performance_path)
+        try:
+            exit_code, wall_seconds, peak_rss_kb = run_model(
+                gcam, exe_dir, config_path, os.path.join(output_dir, run["name"] + ".log"))
+        finally:
+            os.remove(config_path)
+
+        phases = read_performance_report(performance_path)
+        metrics = {"total": summarize(phases, wall_seconds, peak_rss_kb), "phases": phases}
+        result = {
+            "name": run["name"],
+            "configuration": run["configuration"],
+            "exit-code": exit_code,
+            "metrics": metrics,
+            "comparisons": [],
+        }
+        if exit_code != 0:
+            print("  %s exited with %d" % (run["name"], exit_code))
+            any_failed = True
+
+        baseline_path = os.path.join(args.baseline_dir, run["name"] + ".json")
+        if os.path.exists(baseline_path):
+            with open(baseline_path) as baseline_file:
+                baseline = json.load(baseline_file)
+            result["baseline-revision"] = baseline.get("git-revision")
+            result["comparisons"] = compare(metrics, baseline["metrics"], thresholds, floors)
+            for comparison in result["comparisons"]:
+                if comparison["regression"]:
+                    any_regressed = True
+                    print("  REGRESSION %s %s: %s -> %s" % (comparison["phase"], comparison["metric"],
+                                                           comparison["baseline"], comparison["value"]))
+        else:
+            print("  No baseline for %s" % run["name"])
+
+        if args.update_baselines and exit_code == 0:
+            os.makedirs(args.baseline_dir, exist_ok=True)
+            with open(baseline_path, "w") as baseline_file:
+                json.dump({"git-revision": report["git-revision"], "created": report["created"],
+                           "metrics": metrics}, baseline_file, indent=2, sort_keys=True)
+        report["runs"].append(result)
+
+    report["regressions"] = sum(1 for run in report["runs"]
+                                for comparison in run["comparisons"] if comparison["regression"])
+    report["failed"] = any_failed
+    with open(report_path, "w") as report_file:
+        json.dump(report, report_file, indent=2, sort_keys=True)
+    print("Wrote %s" % report_path)
+    return 2 if any_failed else 1 if any_regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())